@@ -0,0 +1,354 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark of the Relax compile pipeline and of the Relax VM on a corpus of models.
+
+Each model goes through import, legalization, FuseOps, FuseTIR, the MetaSchedule database
+(with --database), build and export, then runs in the VM. The per-stage compile time and peak
+host memory, the per-pass profiles, the executable load time, the p50/p99 latency and the
+memory high-water of the VM allocator are reported as JSON, one record per model.
+see README.md for the usage of this script.
+"""
+import argparse
+import json
+import resource
+import sys
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relax
+from tvm.contrib.utils import tempdir
+from tvm.ir.instrument import PassProfilingInstrument
+from tvm.relax.testing import relay_translator
+from tvm.relax.transform import OperatorLegalizer
+from tvm.relay import testing as relay_testing
+
+
+def _peak_rss_mb():
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # The peak resident set size is in bytes on macOS, in KB elsewhere.
+    return peak / (1 << 20) if sys.platform == "darwin" else peak / (1 << 10)
+
+
+def _var(name, shape, dtype="float32"):
+    return relax.Var(name, shape, relax.DynTensorType(len(shape), dtype))
+
+
+class _Weights:
+    """The weights of a model built with the block builder, kept as function inputs so that
+    the compile time does not depend on binding large constants."""
+
+    def __init__(self):
+        self.vars = []
+
+    def __call__(self, name, shape):
+        var = _var(name, shape)
+        self.vars.append(var)
+        return var
+
+
+def _attention_block(bb, x, weights, prefix, batch, seq_len, hidden, num_heads, causal_mask):
+    head_dim = hidden // num_heads
+
+    def heads(name):
+        proj = bb.emit(relax.op.nn.matmul(x, weights(prefix + name, [hidden, hidden])))
+        return bb.emit(relax.op.reshape(proj, [batch, seq_len, num_heads, head_dim]))
+
+    attn = bb.emit(
+        relax.op.nn.attention(heads("wq"), heads("wk"), heads("wv"), causal_mask=causal_mask)
+    )
+    attn = bb.emit(relax.op.reshape(attn, [batch, seq_len, hidden]))
+    return bb.emit(relax.op.nn.matmul(attn, weights(prefix + "wo", [hidden, hidden])))
+
+
+def get_bert(batch_size, seq_len=128, hidden=768, num_heads=12, num_layers=12):
+    """BERT-base encoder layers, without the embeddings and the biases."""
+    bb = relax.BlockBuilder()
+    weights = _Weights()
+    x = _var("x", [batch_size, seq_len, hidden])
+    with bb.function("main"):
+        with bb.dataflow():
+            h = x
+            for i in range(num_layers):
+                p = "l%d_" % i
+                attn = _attention_block(
+                    bb, h, weights, p, batch_size, seq_len, hidden, num_heads, None
+                )
+                h = bb.emit(relax.op.add(h, attn))
+                h = bb.emit(
+                    relax.op.nn.layer_norm(
+                        h, weights(p + "ln1_g", [hidden]), weights(p + "ln1_b", [hidden])
+                    )
+                )
+                ffn = bb.emit(relax.op.nn.matmul(h, weights(p + "w1", [hidden, 4 * hidden])))
+                ffn = bb.emit(relax.op.nn.gelu(ffn))
+                ffn = bb.emit(relax.op.nn.matmul(ffn, weights(p + "w2", [4 * hidden, hidden])))
+                h = bb.emit(relax.op.add(h, ffn))
+                h = bb.emit(
+                    relax.op.nn.layer_norm(
+                        h, weights(p + "ln2_g", [hidden]), weights(p + "ln2_b", [hidden])
+                    )
+                )
+            out = bb.emit_output(h)
+        bb.emit_func_output(out, [x] + weights.vars)
+    return bb.get(), [x] + weights.vars
+
+
+def get_llama_block(batch_size, seq_len=128, hidden=4096, num_heads=32, intermediate=11008):
+    """A LLaMA-7B decoder layer on a prompt, without the rotary embedding."""
+    bb = relax.BlockBuilder()
+    weights = _Weights()
+    x = _var("x", [batch_size, seq_len, hidden])
+    with bb.function("main"):
+        with bb.dataflow():
+            h = bb.emit(relax.op.nn.rms_norm(x, weights("norm1", [hidden])))
+            attn = _attention_block(
+                bb, h, weights, "", batch_size, seq_len, hidden, num_heads, "BottomRight"
+            )
+            h = bb.emit(relax.op.add(x, attn))
+            n = bb.emit(relax.op.nn.rms_norm(h, weights("norm2", [hidden])))
+            gate = bb.emit(relax.op.nn.matmul(n, weights("w_gate", [hidden, intermediate])))
+            up = bb.emit(relax.op.nn.matmul(n, weights("w_up", [hidden, intermediate])))
+            act = bb.emit(relax.op.multiply(relax.op.nn.silu(gate), up))
+            down = bb.emit(relax.op.nn.matmul(act, weights("w_down", [intermediate, hidden])))
+            out = bb.emit_output(relax.op.add(h, down))
+        bb.emit_func_output(out, [x] + weights.vars)
+    return bb.get(), [x] + weights.vars
+
+
+def get_resnet(batch_size, target):
+    """ResNet-50 from the Relay workload, with the weights bound as constants."""
+    net, params = relay_testing.resnet.get_workload(num_layers=50, batch_size=batch_size)
+    mod = relay_translator.from_relay(net["main"], target, params)
+    return mod, [_var("data", [batch_size, 3, 224, 224])]
+
+
+def get_unet(batch_size):
+    """The layout of the Stable Diffusion UNet, down and up blocks of residual blocks with
+    self-attention on 64x64 latents, imported from PyTorch. The time and text conditioning
+    are left out."""
+    # pylint: disable=import-outside-toplevel
+    import torch
+    from torch import nn
+
+    from tvm.relax.frontend import TorchFXTranslator
+
+    class ResBlock(nn.Module):
+        def __init__(self, in_channels, out_channels):
+            super().__init__()
+            self.norm1 = nn.GroupNorm(32, in_channels)
+            self.conv1 = nn.Conv2d(in_channels, out_channels, 3, padding=1)
+            self.norm2 = nn.GroupNorm(32, out_channels)
+            self.conv2 = nn.Conv2d(out_channels, out_channels, 3, padding=1)
+            self.act = nn.SiLU()
+            self.skip = nn.Conv2d(in_channels, out_channels, 1)
+
+        def forward(self, x):
+            h = self.conv1(self.act(self.norm1(x)))
+            h = self.conv2(self.act(self.norm2(h)))
+            return self.skip(x) + h
+
+    class SelfAttention(nn.Module):
+        def __init__(self, channels):
+            super().__init__()
+            self.norm = nn.GroupNorm(32, channels)
+            self.qkv = nn.Linear(channels, 3 * channels)
+            self.out = nn.Linear(channels, channels)
+            self.scale = channels**-0.5
+
+        def forward(self, x):
+            n, c, h, w = x.shape
+            t = self.norm(x).reshape(n, c, h * w).permute(0, 2, 1)
+            q, k, v = self.qkv(t).split(c, dim=-1)
+            scores = torch.matmul(q, k.transpose(1, 2)) * self.scale
+            attn = torch.matmul(torch.softmax(scores, dim=-1), v)
+            return x + self.out(attn).permute(0, 2, 1).reshape(n, c, h, w)
+
+    class UNet(nn.Module):
+        def __init__(self, channels=(320, 640, 1280)):
+            super().__init__()
+            self.conv_in = nn.Conv2d(4, channels[0], 3, padding=1)
+            self.down = nn.ModuleList()
+            self.downsample = nn.ModuleList()
+            prev = channels[0]
+            for ch in channels:
+                self.down.append(nn.ModuleList([ResBlock(prev, ch), SelfAttention(ch)]))
+                self.downsample.append(nn.Conv2d(ch, ch, 3, 2, 1))
+                prev = ch
+            self.mid = nn.ModuleList([ResBlock(prev, prev), SelfAttention(prev)])
+            self.up = nn.ModuleList()
+            for ch in reversed(channels):
+                self.up.append(nn.ModuleList([ResBlock(prev + ch, ch), SelfAttention(ch)]))
+                prev = ch
+            self.norm_out = nn.GroupNorm(32, channels[0])
+            self.act_out = nn.SiLU()
+            self.conv_out = nn.Conv2d(channels[0], 4, 3, padding=1)
+
+        def forward(self, x):
+            h = self.conv_in(x)
+            skips = []
+            for i, (res, attn) in enumerate(self.down):
+                h = attn(res(h))
+                skips.append(h)
+                # The innermost block keeps its resolution.
+                if i < len(self.down) - 1:
+                    h = self.downsample[i](h)
+            h = self.mid[1](self.mid[0](h))
+            for i, (res, attn) in enumerate(self.up):
+                if i > 0:
+                    h = torch.nn.functional.interpolate(h, scale_factor=2.0, mode="nearest")
+                h = attn(res(torch.cat([h, skips.pop()], dim=1)))
+            return self.conv_out(self.act_out(self.norm_out(h)))
+
+    shape = (batch_size, 4, 64, 64)
+    mod = TorchFXTranslator().from_pytorch(UNet().eval(), {"x": (shape, "float32")})
+    return mod, [_var("x", list(shape))]
+
+
+MODELS = ["bert", "resnet-50", "llama-block", "unet"]
+
+
+def get_model(name, batch_size, target):
+    """Get a model of the corpus, and the variables of the inputs of its main function."""
+    if name == "bert":
+        return get_bert(batch_size)
+    if name == "resnet-50":
+        return get_resnet(batch_size, target)
+    if name == "llama-block":
+        return get_llama_block(batch_size)
+    if name == "unet":
+        return get_unet(batch_size)
+    raise ValueError("Unsupported model: %s" % name)
+
+
+def _random_input(var, dev):
+    shape = [int(dim) for dim in var.shape_]
+    return tvm.nd.array(np.random.uniform(-1, 1, shape).astype("float32"), dev)
+
+
+def benchmark(name, target, dev, args):
+    """Compile and run a model, returning its record."""
+    record = {"model": name, "target": str(target), "batch_size": args.batch_size, "stages": {}}
+    profiling = PassProfilingInstrument(count_nodes=args.count_nodes)
+
+    def stage(stage_name, func, *func_args):
+        rss_start = _peak_rss_mb()
+        start = time.perf_counter()
+        result = func(*func_args)
+        record["stages"][stage_name] = {
+            "time_s": time.perf_counter() - start,
+            "peak_rss_delta_mb": _peak_rss_mb() - rss_start,
+        }
+        return result
+
+    mod, inputs = stage("import", get_model, name, args.batch_size, target)
+    with target, tvm.transform.PassContext(opt_level=3, instruments=[profiling]):
+        mod = stage("legalize", lambda m: OperatorLegalizer(m).transform(), mod)
+        mod = stage(
+            "fuse_ops",
+            tvm.transform.Sequential(
+                [relax.transform.AnnotateTIROpPattern(), relax.transform.FuseOps()], "FuseOps"
+            ),
+            mod,
+        )
+        mod = stage("fuse_tir", relax.transform.FuseTIR(), mod)
+        if args.database:
+            mod = stage(
+                "meta_schedule_apply",
+                relax.transform.MetaScheduleApplyDatabase(args.database),
+                mod,
+            )
+        ex = stage("build", relax.vm.build, mod, target)
+        record["passes"] = profiling.render()
+        if args.chrome_trace:
+            with open("%s.%s.json" % (args.chrome_trace, name), "w") as outfile:
+                outfile.write(profiling.render_chrome_trace())
+    record["peak_compile_rss_mb"] = _peak_rss_mb()
+
+    temp = tempdir()
+    path = temp.relpath("%s.so" % name)
+    stage("export", ex.mod.export_library, path)
+    start = time.perf_counter()
+    ex = relax.vm.Executable(tvm.runtime.load_module(path))
+    vm = relax.VirtualMachine(ex, dev)
+    record["load_time_s"] = time.perf_counter() - start
+
+    vm_args = [_random_input(var, dev) for var in inputs]
+    for _ in range(args.warmup):
+        vm["main"](*vm_args)
+    dev.sync()
+    latencies = []
+    for _ in range(args.repeat):
+        start = time.perf_counter()
+        vm["main"](*vm_args)
+        dev.sync()
+        latencies.append((time.perf_counter() - start) * 1000)
+    record["latency_ms"] = {
+        "p50": float(np.percentile(latencies, 50)),
+        "p99": float(np.percentile(latencies, 99)),
+        "mean": float(np.mean(latencies)),
+    }
+    record["runtime_memory"] = relax.VirtualMachine.memory_stats(dev)
+    record["peak_rss_mb"] = _peak_rss_mb()
+    return record
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--model", type=str, choices=MODELS + ["all"], default="all", help="The model to run."
+    )
+    parser.add_argument("--target", type=str, default="llvm", help="The compilation target.")
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument(
+        "--database",
+        type=str,
+        default=None,
+        help="The MetaSchedule work directory of the tuning records to apply. "
+        "Required for the GPU targets.",
+    )
+    parser.add_argument("--warmup", type=int, default=3)
+    parser.add_argument("--repeat", type=int, default=50)
+    parser.add_argument(
+        "--no-count-nodes",
+        dest="count_nodes",
+        action="store_false",
+        help="Do not count the IR nodes around each pass.",
+    )
+    parser.add_argument(
+        "--chrome-trace",
+        type=str,
+        default=None,
+        help="The prefix of the Chrome traces of the passes, written per model.",
+    )
+    parser.add_argument("--output", type=str, default=None, help="The JSON file of the records.")
+    args = parser.parse_args()
+
+    target = tvm.target.Target(args.target)
+    dev = tvm.device(target.kind.name, 0)
+    records = []
+    for name in MODELS if args.model == "all" else [args.model]:
+        # Each model runs in the same process, so the peak memory only grows across the records.
+        records.append(benchmark(name, target, dev, args))
+        print("%-12s done" % name, file=sys.stderr)
+    result = json.dumps(records, indent=2)
+    if args.output:
+        with open(args.output, "w") as outfile:
+            outfile.write(result)
+    else:
+        print(result)
@@ -114,7 +114,7 @@ set(USE_STACKVM_RUNTIME OFF)
 # Whether enable tiny embedded graph executor.
 set(USE_GRAPH_EXECUTOR ON)
 
-# Whether enable tiny graph executor with CUDA Graph
+# Whether enable tiny graph executor with CUDA Graph, or with HIP Graph on ROCm
 set(USE_GRAPH_EXECUTOR_CUDA_GRAPH OFF)
 
 # Whether enable pipeline executor.
@@ -220,6 +220,9 @@ set(USE_MPS OFF)
 # Whether use rocBlas
 set(USE_ROCBLAS OFF)
 
+# Whether use hipBLASLt
+set(USE_HIPBLASLT OFF)
+
 # Whether use contrib sort
 set(USE_SORT ON)
 
@@ -300,6 +303,13 @@ set(USE_THRUST OFF)
 # Whether use cuRAND
 set(USE_CURAND OFF)
 
+# Whether use NCCL for the collectives of the relax VM on CUDA
+# Possible values:
+# - ON: enable NCCL with cmake's auto search
+# - OFF: disable NCCL
+# - /path/to/nccl: use specific path to NCCL
+set(USE_NCCL OFF)
+
 # Whether to build the TensorFlow TVMDSOOp module
 set(USE_TF_TVMDSOOP OFF)
 
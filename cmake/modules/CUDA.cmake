@@ -31,6 +31,8 @@ if(USE_CUDA)
   message(STATUS "Build with CUDA ${CUDA_VERSION} support")
   tvm_file_glob(GLOB RUNTIME_CUDA_SRCS src/runtime/cuda/*.cc)
   list(APPEND RUNTIME_SRCS ${RUNTIME_CUDA_SRCS})
+  tvm_file_glob(GLOB RUNTIME_RELAX_VM_CUDA_SRCS src/runtime/relax_vm/cuda/*.cc)
+  list(APPEND RUNTIME_SRCS ${RUNTIME_RELAX_VM_CUDA_SRCS})
   list(APPEND COMPILER_SRCS src/target/opt/build_cuda_on.cc)
 
   list(APPEND TVM_LINKER_LIBS ${CUDA_NVRTC_LIBRARY})
@@ -81,6 +83,22 @@ if(USE_CUDA)
     list(APPEND RUNTIME_SRCS ${CONTRIB_CURAND_SRC_CU})
   endif(USE_CURAND)
 
+  if(USE_NCCL)
+    message(STATUS "Build with NCCL support")
+    if(IS_DIRECTORY ${USE_NCCL})
+      include_directories(SYSTEM ${USE_NCCL}/include)
+      find_library(NCCL_LIBRARY nccl HINTS ${USE_NCCL}/lib ${USE_NCCL}/lib64)
+    else()
+      find_library(NCCL_LIBRARY nccl)
+    endif()
+    if(NOT NCCL_LIBRARY)
+      message(FATAL_ERROR "Cannot find NCCL, USE_NCCL=" ${USE_NCCL})
+    endif()
+    tvm_file_glob(GLOB CONTRIB_NCCL_SRCS src/runtime/contrib/nccl/*.cc)
+    list(APPEND RUNTIME_SRCS ${CONTRIB_NCCL_SRCS})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${NCCL_LIBRARY})
+  endif(USE_NCCL)
+
   if(USE_GRAPH_EXECUTOR_CUDA_GRAPH)
     if(NOT USE_GRAPH_EXECUTOR)
       message(FATAL_ERROR "CUDA Graph is only supported by graph executor, please set USE_GRAPH_EXECUTOR=ON")
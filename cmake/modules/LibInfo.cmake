@@ -76,6 +76,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_HEXAGON_SDK="${USE_HEXAGON_SDK}"
     TVM_INFO_USE_HEXAGON_GTEST="${USE_HEXAGON_GTEST}"
     TVM_INFO_USE_HEXAGON_EXTERNAL_LIBS="${USE_HEXAGON_EXTERNAL_LIBS}"
+    TVM_INFO_USE_HIPBLASLT="${USE_HIPBLASLT}"
     TVM_INFO_USE_IOS_RPC="${USE_IOS_RPC}"
     TVM_INFO_USE_KHRONOS_SPIRV="${USE_KHRONOS_SPIRV}"
     TVM_INFO_USE_LIBBACKTRACE="${USE_LIBBACKTRACE}"
@@ -87,6 +88,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_MIOPEN="${USE_MIOPEN}"
     TVM_INFO_USE_MKL="${USE_MKL}"
     TVM_INFO_USE_MSVC_MT="${USE_MSVC_MT}"
+    TVM_INFO_USE_NCCL="${USE_NCCL}"
     TVM_INFO_USE_NNPACK="${USE_NNPACK}"
     TVM_INFO_USE_OPENCL="${USE_OPENCL}"
     TVM_INFO_USE_OPENCL_GTEST="${USE_OPENCL_GTEST}"
@@ -33,6 +33,8 @@ if(USE_ROCM)
   message(STATUS "Build with ROCM support")
   tvm_file_glob(GLOB RUNTIME_ROCM_SRCS src/runtime/rocm/*.cc)
   list(APPEND RUNTIME_SRCS ${RUNTIME_ROCM_SRCS})
+  tvm_file_glob(GLOB RUNTIME_VM_ROCM_SRCS src/runtime/relax_vm/rocm/*.cc)
+  list(APPEND RUNTIME_SRCS ${RUNTIME_VM_ROCM_SRCS})
   list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_HIPHCC_LIBRARY})
   if (ROCM_HSA_LIBRARY)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_HSA_LIBRARY})
@@ -52,6 +54,25 @@ if(USE_ROCM)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_ROCBLAS_LIBRARY})
   endif(USE_ROCBLAS)
 
+  if(USE_HIPBLASLT)
+    message(STATUS "Build with hipBLASLt support")
+    if(NOT ROCM_HIPBLASLT_LIBRARY)
+      message(FATAL_ERROR "Cannot find hipBLASLt, USE_HIPBLASLT=" ${USE_HIPBLASLT})
+    endif()
+    tvm_file_glob(GLOB HIPBLASLT_CONTRIB_SRCS src/runtime/contrib/hipblaslt/*.cc)
+    list(APPEND RUNTIME_SRCS ${HIPBLASLT_CONTRIB_SRCS})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_HIPBLASLT_LIBRARY})
+  endif(USE_HIPBLASLT)
+
+  if(USE_GRAPH_EXECUTOR_CUDA_GRAPH)
+    if(NOT USE_GRAPH_EXECUTOR)
+      message(FATAL_ERROR "HIP Graph is only supported by graph executor, please set USE_GRAPH_EXECUTOR=ON")
+    endif()
+    message(STATUS "Build with Graph executor with HIP Graph support...")
+    tvm_file_glob(GLOB RUNTIME_HIP_GRAPH_SRCS src/runtime/graph_executor/hip_graph/*.cc)
+    list(APPEND RUNTIME_SRCS ${RUNTIME_HIP_GRAPH_SRCS})
+  endif()
+
   if(USE_THRUST)
     message(STATUS "Build with rocThrust support")
     # We need to override CXX to hipcc. This is required by rocthrust
@@ -612,3 +612,60 @@ func TestArrayCopySliceFloat64(t *testing.T) {
         }
     }
 }
+
+// Exchange an array through DLPack, sharing its memory.
+func TestArrayDLPack(t *testing.T) {
+    arr, err := Empty([]int64{2, 3}, "float32")
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    dltensor, err := arr.ToDLPack()
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    shared, err := FromDLPack(dltensor)
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    if shared.GetNdim() != 2 || shared.GetShape()[1] != 3 || shared.GetDType() != "float32" {
+        t.Errorf("Expected a float32 Array of shape [2 3], but got %v %v\n",
+                 shared.GetDType(), shared.GetShape())
+        return
+    }
+
+    data := []float32{1, 2, 3, 4, 5, 6}
+    err = arr.CopyFrom(data)
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    ret, err := shared.AsSlice()
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    dataRet := ret.([]float32)
+    for i := range data {
+        if data[i] != dataRet[i] {
+            t.Errorf("Data expected: %v Got :%v\n", data, dataRet)
+            return
+        }
+    }
+
+    // An unconsumed tensor is deleted explicitly.
+    dltensor, err = arr.ToDLPack()
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    DLManagedTensorDelete(dltensor)
+
+    _, err = FromDLPack(nil)
+    if err == nil {
+        t.Error("Expected err for nil DLManagedTensor, but didn't got !!")
+        return
+    }
+}
@@ -324,6 +324,12 @@ func Empty(shape []int64, args ...interface{}) (parray *Array, err error) {
     if err != nil {
         return
     }
+    parray = newArrayHandle(newArray)
+    return
+}
+
+// newArrayHandle wraps a native Array handle, which is released when it is garbage collected.
+func newArrayHandle(newArray uintptr) (parray *Array) {
     handle := new(Array)
     *handle = Array(newArray)
 
@@ -336,6 +342,53 @@ func Empty(shape []int64, args ...interface{}) (parray *Array, err error) {
     return
 }
 
+// FromDLPack creates an Array sharing the memory of a DLManagedTensor, without a copy.
+//
+// `dltensor` is the pointer to the DLManagedTensor, whose ownership is transferred to the Array:
+// its deleter is called when the Array is released.
+//
+// returns pointer to Array on successful execution and error if any.
+func FromDLPack(dltensor unsafe.Pointer) (parray *Array, err error) {
+    if dltensor == nil {
+        err = errors.New("Invalid nil DLManagedTensor")
+        return
+    }
+    var newArray uintptr
+    ret := C.TVMArrayFromDLPack((*C.DLManagedTensor)(dltensor),
+                                (*C.TVMArrayHandle)(unsafe.Pointer(&newArray)))
+    if ret != 0 {
+        err = errors.New(getTVMLastError())
+        return
+    }
+    parray = newArrayHandle(newArray)
+    return
+}
+
+// ToDLPack exports the Array as a DLManagedTensor sharing its memory, without a copy.
+//
+// The DLManagedTensor holds its own reference to the memory, which its deleter releases, so that
+// it stays valid after the Array is released. Its ownership is transferred to the consumer, or it
+// must be released with DLManagedTensorDelete.
+//
+// returns the pointer to the DLManagedTensor and error if any.
+func (parray Array) ToDLPack() (retVal unsafe.Pointer, err error) {
+    var dltensor *C.DLManagedTensor
+    ret := C.TVMArrayToDLPack((C.TVMArrayHandle)(unsafe.Pointer(parray.nativeCPtr())), &dltensor)
+    if ret != 0 {
+        err = errors.New(getTVMLastError())
+        return
+    }
+    retVal = unsafe.Pointer(dltensor)
+    return
+}
+
+// DLManagedTensorDelete calls the deleter of a DLManagedTensor no consumer has taken.
+//
+// `dltensor` is the pointer to the DLManagedTensor.
+func DLManagedTensorDelete(dltensor unsafe.Pointer) {
+    C.TVMDLManagedTensorCallDeleter((*C.DLManagedTensor)(dltensor))
+}
+
 // nativeTVMArrayFree is used to release the Array.
 //
 // `parray` is the Array handle.
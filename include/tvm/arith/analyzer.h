@@ -494,6 +494,10 @@ class ConstraintContext {
   PrimExpr constraint_;
   /*! \brief function to be called in recovery */
   std::vector<std::function<void()>> recovery_functions_;
+  /*! \brief The epoch of the analyzer out of the scope, restored on exit. */
+  uint64_t outer_epoch_{0};
+  /*! \brief The epoch of the analyzer in the scope. */
+  uint64_t inner_epoch_{0};
 };
 
 /*!
@@ -675,6 +679,51 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+
+  /*!
+   * \brief Start a new epoch of the analyzer, as the information on the variables changed.
+   *
+   *  The results of Simplify are memoized for the epoch they are computed in. The sub-analyzers
+   *  start a new epoch as they are updated, and a ConstraintContext starts one on entry, then
+   *  goes back to the previous epoch on exit when nothing else changed in the scope.
+   */
+  void NewEpoch() { epoch_ = ++num_epochs_; }
+  /*! \return The current epoch of the analyzer. */
+  uint64_t epoch() const { return epoch_; }
+
+  /*! \brief The number of the Simplify calls found in the memo. */
+  int64_t simplify_memo_hits{0};
+  /*! \brief The number of the Simplify calls computed anew. */
+  int64_t simplify_memo_misses{0};
+
+ private:
+  friend class ConstraintContext;
+  /*! \brief The key of a memoized Simplify result. */
+  struct SimplifyMemoKey {
+    const Object* expr;
+    uint64_t epoch;
+    int steps;
+    bool operator==(const SimplifyMemoKey& other) const {
+      return expr == other.expr && epoch == other.epoch && steps == other.steps;
+    }
+  };
+  struct SimplifyMemoKeyHash {
+    size_t operator()(const SimplifyMemoKey& key) const {
+      size_t hash = std::hash<const Object*>()(key.expr);
+      hash ^= std::hash<uint64_t>()(key.epoch) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      return hash ^ (static_cast<size_t>(key.steps) << 1);
+    }
+  };
+  /*! \brief The current epoch. */
+  uint64_t epoch_{0};
+  /*! \brief The number of the epochs started. */
+  uint64_t num_epochs_{0};
+  /*!
+   * \brief The memoized results of Simplify, which hold the expressions they are keyed by so that
+   *  their addresses are not reused.
+   */
+  std::unordered_map<SimplifyMemoKey, std::pair<PrimExpr, PrimExpr>, SimplifyMemoKeyHash>
+      simplify_memo_;
 };
 
 }  // namespace arith
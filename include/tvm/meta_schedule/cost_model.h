@@ -21,6 +21,7 @@
 #define TVM_META_SCHEDULE_COST_MODEL_H_
 
 #include <tvm/meta_schedule/arg_info.h>
+#include <tvm/meta_schedule/feature_extractor.h>
 #include <tvm/meta_schedule/measure_candidate.h>
 #include <tvm/meta_schedule/runner.h>
 #include <tvm/node/reflection.h>
@@ -28,6 +29,7 @@
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
+#include <tvm/support/random_engine.h>
 #include <tvm/tir/schedule/schedule.h>
 
 #include <vector>
@@ -165,6 +167,39 @@ class CostModel : public runtime::ObjectRef {
                                        PyCostModelNode::FUpdate f_update,    //
                                        PyCostModelNode::FPredict f_predict,  //
                                        PyCostModelNode::FAsString f_as_string);
+  /*!
+   * \brief Create a gradient-boosted decision trees cost model, which is trained and predicts
+   * natively, and grows upon its trees on each update rather than retraining from scratch.
+   * \param extractor The feature extractor.
+   * \param num_warmup_samples The number of samples before which the predictions are random.
+   * \param num_trees_per_update The number of trees grown by each update.
+   * \param max_num_trees The maximum number of trees, beyond which the model is retrained.
+   * \param max_depth The maximum depth of the trees.
+   * \param learning_rate The learning rate, i.e. the shrinkage of each tree.
+   * \param min_child_weight The minimum sum of the hessians of a child of a split.
+   * \param reg_lambda The L2 regularization on the leaf values.
+   * \param max_bin The maximum number of histogram bins of each feature, at most 256.
+   * \param seed The random seed of the predictions before the warmup.
+   * \return The cost model created.
+   */
+  TVM_DLL static CostModel GBDTModel(FeatureExtractor extractor, int num_warmup_samples,
+                                     int num_trees_per_update, int max_num_trees, int max_depth,
+                                     double learning_rate, double min_child_weight,
+                                     double reg_lambda, int max_bin,
+                                     support::LinearCongruentialEngine::TRandState seed);
+  /*!
+   * \brief Create an analytical cost model, which bounds the running time of the candidates by
+   * their FLOPs and memory traffic against the roofline of the target.
+   * \param peak_flops The peak floating point operations per second of the target.
+   * \param bandwidth The peak bytes per second of each storage scope, the others are not bound.
+   * \param num_cores The number of parallel units of the target.
+   * \param base_model The learned model blended in as it is updated, if any.
+   * \param num_warmup_samples The number of samples after which only the learned model is used.
+   * \return The cost model created.
+   */
+  TVM_DLL static CostModel RooflineModel(double peak_flops, Map<String, FloatImm> bandwidth,
+                                         int num_cores, Optional<CostModel> base_model,
+                                         int num_warmup_samples);
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CostModel, ObjectRef, CostModelNode);
 };
 
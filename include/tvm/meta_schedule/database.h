@@ -472,6 +472,17 @@ class Database : public runtime::ObjectRef {
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
                                        bool allow_missing, String mod_eq_name = "structural");
+  /*!
+   * \brief Create a database on the indexed append-only logs, which opens by reading the indices
+   * only, parses the tuning records on demand, and can be appended by multiple tuners at the same
+   * time.
+   * \param path The path prefix of the logs.
+   * \param num_shards The number of shards of the tuning record log, if it is new.
+   * \param allow_missing Whether to create new logs when the given path is not found.
+   * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   */
+  TVM_DLL static Database IndexedDatabase(String path, int num_shards, bool allow_missing,
+                                          String mod_eq_name = "structural");
   /*!
    * \brief A database composed of multiple databases, allowing users to guide IR rewriting using
    * combined knowledge of those databases. To each query, it returns the best record among all the
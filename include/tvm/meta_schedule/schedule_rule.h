@@ -214,11 +214,36 @@ class ScheduleRule : public runtime::ObjectRef {
    * \param max_innermost_factor The maximum size of the innermost factor. NullOpt means no limit
    * \param reuse_read Data reuse configuration for reading. NullOpt means no reuse.
    * \param reuse_write Data reuse configuration for writing. NullOpt means no reuse.
+   * \param use_software_pipeline Whether to pipeline the read caches with the computation, the
+   * copies of the next iteration running asynchronously.
    * \return The schedule rule created
    */
   TVM_DLL static ScheduleRule MultiLevelTilingWideVector(
       String structure, Integer vector_length_in_bits, Optional<Integer> max_innermost_factor,
-      Optional<Map<String, ObjectRef>> reuse_read, Optional<Map<String, ObjectRef>> reuse_write);
+      Optional<Map<String, ObjectRef>> reuse_read, Optional<Map<String, ObjectRef>> reuse_write,
+      bool use_software_pipeline = false);
+
+  /*!
+   * \brief Extension of MultiLevelTiling with split-K for the reductions of a few outputs, which
+   * splits the reduction into a sampled number of partitions, multi-level tiles the partial sums
+   * of the partitions and adds them up in an epilogue. The schedules without split-K are kept.
+   * \param split_factors The candidates of the number of partitions of the reduction.
+   * \param max_spatial_extent The maximum spatial extent of a block to be split.
+   * \param min_reduction_extent The minimum reduction extent of a block to be split.
+   * \param structure The tiling structure. 'SSSRRSRS' is recommended.
+   * \param tile_binds For each level of tiles, which thread axis it is bound to.
+   * \param max_innermost_factor The maximum size of the innermost factor. NullOpt means no limit
+   * \param vector_load_lens The length of vector lane in vectorized cooperative fetching.
+   * NullOpt means disable vectorization
+   * \param reuse_read Data reuse configuration for reading. NullOpt means no reuse.
+   * \param reuse_write Data reuse configuration for writing. NullOpt means no reuse.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule MultiLevelTilingSplitK(
+      Array<Integer> split_factors, int64_t max_spatial_extent, int64_t min_reduction_extent,
+      String structure, Optional<Array<String>> tile_binds, Optional<Integer> max_innermost_factor,
+      Optional<Array<Integer>> vector_load_lens, Optional<Map<String, ObjectRef>> reuse_read,
+      Optional<Map<String, ObjectRef>> reuse_write);
 
   /*!
    * \brief Create a rule: add-rfactor to some blocks if needed
@@ -232,11 +257,22 @@ class ScheduleRule : public runtime::ObjectRef {
                                          Optional<Integer> max_innermost_factor);
   /*!
    * \brief Create a schedule rule which applies cross-thread reduction to some reduction blocks
-   * correspondingly when needed
+   * correspondingly when needed. On CUDA, a long reduction of a few rows is also tried across the
+   * blocks of a grid in one kernel.
    * \param thread_extents Candidates of thread axis extent (values are required to be positive).
    * \return The schedule rule created
    */
   TVM_DLL static ScheduleRule CrossThreadReduction(Array<Integer> thread_extents);
+  /*!
+   * \brief Create a schedule rule which schedules the GEMV-like reductions for the memory
+   * bandwidth: each row is reduced by the threadIdx.x lanes with the vectorized loads of up to 128
+   * bits into registers, and a few rows are bound to threadIdx.y of a thread block. The block
+   * scheduled is annotated so that the rules after this one skip it.
+   * \param thread_extents Candidates of the number of threadIdx.x lanes reducing a row.
+   * \param rows_per_block Candidates of the number of rows of a thread block.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule GEMV(Array<Integer> thread_extents, Array<Integer> rows_per_block);
   /*!
    * \brief A rule that randomly select a compute-at location for a free block
    * \return The schedule rule created
@@ -285,6 +321,11 @@ class ScheduleRule : public runtime::ObjectRef {
 
   /*! \brief Create default schedule rules for LLVM */
   TVM_DLL static Array<ScheduleRule, void> DefaultLLVM();
+  /*!
+   * \brief Create default schedule rules for LLVM targets with wide vectors, e.g. SVE or RVV
+   * \param vector_length_in_bits The length of a vector register in bits.
+   */
+  TVM_DLL static Array<ScheduleRule, void> DefaultLLVMWideVector(int vector_length_in_bits);
   /*! \brief Create default schedule rules for x86 VNNI */
   TVM_DLL static Array<ScheduleRule, void> DefaultVNNI();
   /*! \brief Create default schedule rules for CUDA */
@@ -205,15 +205,19 @@ class SearchStrategy : public runtime::ObjectRef {
    * \param genetic_mutate_prob The probability of mutation.
    * \param genetic_max_fail_count The maximum number to try evolving the given trace.
    * \param eps_greedy The ratio to select samples in a greedy fashion via their predicted score.
+   * \param num_warm_start_workloads The number of the workloads of the same computation but of the
+   * nearest shapes in the database to warm start from, by pretraining the cost model on their
+   * records and seeding the initial population with their best traces. Zero means no warm start.
    */
-  TVM_DLL static SearchStrategy EvolutionarySearch(int population_size,         //
-                                                   double init_measured_ratio,  //
-                                                   int init_min_unmeasured,     //
-                                                   int max_fail_count,          //
-                                                   int genetic_num_iters,       //
-                                                   double genetic_mutate_prob,  //
-                                                   int genetic_max_fail_count,  //
-                                                   double eps_greedy);
+  TVM_DLL static SearchStrategy EvolutionarySearch(int population_size,           //
+                                                   double init_measured_ratio,    //
+                                                   int init_min_unmeasured,       //
+                                                   int max_fail_count,            //
+                                                   int genetic_num_iters,         //
+                                                   double genetic_mutate_prob,    //
+                                                   int genetic_max_fail_count,    //
+                                                   double eps_greedy,             //
+                                                   int num_warm_start_workloads);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(SearchStrategy, ObjectRef, SearchStrategyNode);
 };
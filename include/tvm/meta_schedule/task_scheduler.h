@@ -31,6 +31,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/support/random_engine.h>
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -60,6 +61,32 @@ class TaskRecordNode : public runtime::Object {
   /*! \brief Packed functions to fetch the runner results asynchronously. */
   Optional<Array<RunnerFuture>> runner_futures = NullOpt;
 
+  /*! \brief A batch sent to the builder and the runner while an earlier one is still running. */
+  struct PendingBatch {
+    Array<MeasureCandidate> measure_candidates;
+    Array<BuilderResult> builder_results;
+    Array<RunnerFuture> runner_futures;
+  };
+  /*!
+   * \brief The batches sent after the one above, in the order they are sent, which is promoted to
+   * the fields above once the batch ahead of it is joined.
+   */
+  std::deque<PendingBatch> pending_batches;
+
+  /*! \brief The number of batches sent to the runner but not joined yet. */
+  int NumInFlightBatches() const {
+    return runner_futures.defined() ? 1 + static_cast<int>(pending_batches.size()) : 0;
+  }
+  /*! \brief The number of trials sent to the runner but not joined yet. */
+  int NumInFlightTrials() const {
+    if (!runner_futures.defined()) return 0;
+    int n = runner_futures.value().size();
+    for (const PendingBatch& batch : pending_batches) {
+      n += batch.runner_futures.size();
+    }
+    return n;
+  }
+
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("ctx", &ctx);
     v->Visit("task_weight", &task_weight);
@@ -71,6 +98,7 @@ class TaskRecordNode : public runtime::Object {
     v->Visit("measure_candidates", &measure_candidates);
     v->Visit("builder_results", &builder_results);
     v->Visit("runner_futures", &runner_futures);
+    // `pending_batches` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.TaskRecord";
@@ -139,6 +167,8 @@ class TaskSchedulerNode : public runtime::Object {
   Optional<CostModel> cost_model_;
   /*! \brief The number of remaining tasks to be tuned. */
   int remaining_tasks_;
+  /*! \brief The max number of batches of a task in flight at the same time. */
+  int pipeline_depth_ = 1;
 
   /*! \brief The default destructor. */
   virtual ~TaskSchedulerNode() = default;
@@ -150,6 +180,7 @@ class TaskSchedulerNode : public runtime::Object {
     v->Visit("database_", &database_);
     v->Visit("cost_model_", &cost_model_);
     v->Visit("remaining_tasks_", &remaining_tasks_);
+    v->Visit("pipeline_depth_", &pipeline_depth_);
   }
 
   /*!
@@ -175,6 +206,10 @@ class TaskSchedulerNode : public runtime::Object {
    * \param measure_callbacks The callbacks to be called after each measurement
    * \param database The database used in tuning
    * \param cost_model The cost model used in tuning
+   * \param pipeline_depth The max number of batches of a task in flight at the same time. With a
+   * depth larger than 1, the next batch of a task is generated and built while the previous ones
+   * are being measured, and the results are fed back to the cost model batch by batch as they
+   * arrive.
    */
   virtual void Tune(Array<TuneContext> tasks,                  //
                     Array<FloatImm> task_weights,              //
@@ -185,12 +220,20 @@ class TaskSchedulerNode : public runtime::Object {
                     Runner runner,                             //
                     Array<MeasureCallback> measure_callbacks,  //
                     Optional<Database> database,               //
-                    Optional<CostModel> cost_model);
+                    Optional<CostModel> cost_model,            //
+                    int pipeline_depth);
   /*!
    * \brief Terminate a task
    * \param task_id The id of the task to be terminated
    */
   void TerminateTask(int task_id);
+  /*!
+   * \brief Join the running batches of a task, oldest first, until at most `max_in_flight` of
+   * them are left running.
+   * \param task_id The task id to be joined.
+   * \param max_in_flight The number of batches allowed to keep running.
+   */
+  void JoinRunningTaskUntil(int task_id, int max_in_flight);
   /*!
    * \brief Touch the task and update its status
    * \param task_id The task id to be checked.
@@ -228,7 +271,8 @@ class PyTaskSchedulerNode : public TaskSchedulerNode {
                                               Runner runner,                             //
                                               Array<MeasureCallback> measure_callbacks,  //
                                               Optional<Database> database,               //
-                                              Optional<CostModel> cost_model)>;
+                                              Optional<CostModel> cost_model,            //
+                                              int pipeline_depth)>;
 
   /*! \brief The packed function to the `NextTaskId` function. */
   FNextTaskId f_next_task_id;
@@ -249,7 +293,7 @@ class PyTaskSchedulerNode : public TaskSchedulerNode {
   void Tune(Array<TuneContext> tasks, Array<FloatImm> task_weights, int max_trials_global,
             int max_trials_per_task, int num_trials_per_iter, Builder builder, Runner runner,
             Array<MeasureCallback> measure_callbacks, Optional<Database> database,
-            Optional<CostModel> cost_model) final;
+            Optional<CostModel> cost_model, int pipeline_depth) final;
 
   static constexpr const char* _type_key = "meta_schedule.PyTaskScheduler";
   TVM_DECLARE_FINAL_OBJECT_INFO(PyTaskSchedulerNode, TaskSchedulerNode);
@@ -47,5 +47,26 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief Save the node as well as all the nodes it depends on in the binary IR format.
+ *
+ *  The file holds the graph of the nodes, with their strings interned, followed by the payloads of
+ *  the NDArrays out of line, aligned as NDArray requires. Unlike JSON, the format is not upgraded
+ *  across TVM versions, and is meant to cache IR rather than to exchange it.
+ *
+ * \param node The node.
+ * \param file_name The file to save to.
+ */
+TVM_DLL void SaveBinaryFile(const runtime::ObjectRef& node, const std::string& file_name);
+
+/*!
+ * \brief Load a node saved in the binary IR format.
+ * \param file_name The file to load from.
+ * \return The node.
+ * \note The file is mapped in memory, and the loaded NDArrays are copy-on-write views of the
+ *  mapping rather than copies.
+ */
+TVM_DLL runtime::ObjectRef LoadBinaryFile(const std::string& file_name);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file tvm/node/structural_memo.h
+ * \brief A scoped memo of the structural hashes and equalities of objects.
+ */
+#ifndef TVM_NODE_STRUCTURAL_MEMO_H_
+#define TVM_NODE_STRUCTURAL_MEMO_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/optional.h>
+#include <tvm/runtime/object.h>
+#include <tvm/support/with.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace tvm {
+
+/*!
+ * \brief The memo of the StructuralHash and StructuralEqual called in its scope.
+ *
+ *  Passes and tuning databases hash and compare the same large IRModules over and over, each call
+ *  walking the whole graph. Within the scope of a memo, the results of the top-level calls are
+ *  looked up by the addresses of their operands, and only computed on a miss.
+ *
+ *  The memo keeps references to its operands, which keeps them alive and, as an expression with
+ *  more than one reference is copied on write rather than mutated, keeps them unchanged. An
+ *  IRModule is mutated in place by Add, Update and Remove, so the memo also keeps the function,
+ *  type definition and attribute maps of a module operand, which are copied on write, and a
+ *  lookup misses once any of them was replaced. Arrays and maps may hold modules mutated in place
+ *  and are never memoized. The memo is freed on exit of the scope.
+ *
+ * \code
+ *
+ *  StructuralMemo memo;
+ *  {
+ *    With<StructuralMemo> scope(memo);
+ *    // The second call is a lookup.
+ *    StructuralHash()(mod);
+ *    StructuralHash()(mod);
+ *  }
+ *
+ * \endcode
+ *
+ * \note The scope is per thread. A memo may be entered by several threads at once.
+ */
+class StructuralMemoNode : public Object {
+ public:
+  /*!
+   * \brief Look up the structural hash of an object.
+   * \param object The object.
+   * \param map_free_vars Whether the free variables are mapped.
+   * \param hash_value The hash, set on a hit.
+   * \return Whether the hash is in the memo.
+   */
+  bool LookupHash(const ObjectRef& object, bool map_free_vars, size_t* hash_value);
+  /*! \brief Record the structural hash of an object. */
+  void SetHash(const ObjectRef& object, bool map_free_vars, size_t hash_value);
+  /*!
+   * \brief Look up the structural equality of two objects.
+   * \param lhs The left operand.
+   * \param rhs The right operand.
+   * \param map_free_vars Whether the free variables are mapped.
+   * \param equal The equality, set on a hit.
+   * \return Whether the equality is in the memo.
+   */
+  bool LookupEqual(const ObjectRef& lhs, const ObjectRef& rhs, bool map_free_vars, bool* equal);
+  /*! \brief Record the structural equality of two objects. */
+  void SetEqual(const ObjectRef& lhs, const ObjectRef& rhs, bool map_free_vars, bool equal);
+  /*! \return The number of the lookups that hit the memo. */
+  int64_t NumHits();
+
+  static constexpr const char* _type_key = "StructuralMemo";
+  TVM_DECLARE_FINAL_OBJECT_INFO(StructuralMemoNode, Object);
+
+ private:
+  struct PairHash {
+    size_t operator()(const std::pair<const Object*, const Object*>& key) const {
+      return std::hash<const Object*>()(key.first) ^ (std::hash<const Object*>()(key.second) << 1);
+    }
+  };
+  /*! \brief A memoized operand, with the fields which may be replaced in place. */
+  struct Operand {
+    ObjectRef object;
+    Array<ObjectRef> fields;
+  };
+  /*! \brief The mutex guarding the memo. */
+  std::mutex mutex_;
+  /*! \brief The hashes, with the free variables mapped or not. */
+  std::unordered_map<const Object*, std::pair<Operand, size_t>> hashes_[2];
+  /*! \brief The equalities, with the free variables mapped or not. */
+  std::unordered_map<std::pair<const Object*, const Object*>,
+                     std::pair<std::pair<Operand, Operand>, bool>, PairHash>
+      equals_[2];
+  /*! \brief The number of the lookups that hit the memo. */
+  int64_t num_hits_{0};
+};
+
+/*!
+ * \brief Managed reference to StructuralMemoNode.
+ * \sa StructuralMemoNode
+ */
+class StructuralMemo : public ObjectRef {
+ public:
+  /*! \brief Create an empty memo. */
+  TVM_DLL StructuralMemo();
+  /*!
+   * \brief The memo of the innermost scope on this thread.
+   * \return The memo, or NullOpt outside of any scope.
+   */
+  TVM_DLL static Optional<StructuralMemo> Current();
+
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(StructuralMemo, ObjectRef, StructuralMemoNode);
+  class Internal;
+
+ private:
+  // The entry of a memo scope.
+  TVM_DLL void EnterWithScope();
+  // The exit of a memo scope.
+  TVM_DLL void ExitWithScope();
+  // Classes to get the Python `with` like syntax.
+  friend class Internal;
+  friend class With<StructuralMemo>;
+};
+
+}  // namespace tvm
+
+#endif  // TVM_NODE_STRUCTURAL_MEMO_H_
@@ -28,9 +28,13 @@
 #include <tvm/ir/module.h>
 #include <tvm/relax/expr.h>
 #include <tvm/relay/op_attr_types.h>
+#include <tvm/support/with.h>
 #include <tvm/tir/function.h>
 
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace tvm {
 namespace relax {
@@ -189,6 +193,93 @@ TVM_DLL Function RemoveAllUnused(const Function fn);
  */
 TVM_DLL Expr DeriveFuncRetShape(Array<Var> args, Expr body);
 
+/*!
+ * \brief The manager of the analysis results of the functions across the passes of a pipeline.
+ * The results of a function are cached by its identity, as a function a pass does not change is
+ * kept as the same object, so that only the functions a pass changed are analyzed again.
+ *
+ * Within its scope, WellFormed, FunctionUseDef and DataflowBlockUseDef reuse its results.
+ */
+class AnalysisManagerNode : public Object {
+ public:
+  /*!
+   * \brief Check if the IRModule is well formed, checking again only the functions not given
+   * to the manager before. The GlobalVars and the params shared across the functions are checked
+   * against the whole module each time.
+   * \param m the IRModule to check.
+   * \param diag_ctx the diagnostic context.
+   * \return true if the IRModule is well formed, false if not.
+   */
+  TVM_DLL bool WellFormed(const IRModule& m, Optional<DiagnosticContext> diag_ctx = NullOpt);
+
+  /*! \brief The cached use-def chain of variables inside a function, see FunctionUseDef. */
+  TVM_DLL std::pair<Map<Var, Array<Var>>, Array<Var>> FunctionUseDef(const Function& fn);
+
+  /*! \brief The cached use-def chain of variables inside a dataflow block. */
+  TVM_DLL Map<Var, Array<Var>> DataflowBlockUseDef(const DataflowBlock& dfb);
+
+  /*!
+   * \brief Drop the results of the functions which are not in the IRModule, i.e. the functions
+   * a pass changed or removed, and of their dataflow blocks.
+   * \param m the IRModule after the pass.
+   */
+  TVM_DLL void Invalidate(const IRModule& m);
+
+  /*! \brief The number of functions with cached results. */
+  size_t NumCachedFunctions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return functions_.size();
+  }
+
+  void VisitAttrs(AttrVisitor* v) {}
+
+  static constexpr const char* _type_key = "relax.analysis.AnalysisManager";
+  TVM_DECLARE_FINAL_OBJECT_INFO(AnalysisManagerNode, Object);
+
+ private:
+  /*! \brief The cached results of a function. */
+  struct FunctionEntry {
+    /*! \brief Whether the checks local to the function have passed. */
+    bool well_formed = false;
+    /*! \brief The GlobalVars the function uses, which must be defined in the module. */
+    std::vector<GlobalVar> global_vars;
+    /*! \brief The params of the function and of its local functions, with their functions. */
+    std::vector<std::pair<Var, Function>> params;
+    /*! \brief Whether the use-def chain is computed. */
+    bool has_use_def = false;
+    /*! \brief The use-def chain of the function. */
+    std::pair<Map<Var, Array<Var>>, Array<Var>> use_def;
+  };
+
+  /*! \brief The mutex guarding the caches. */
+  mutable std::mutex mutex_;
+  /*! \brief The cached results of the functions. */
+  std::unordered_map<Function, FunctionEntry, ObjectPtrHash, ObjectPtrEqual> functions_;
+  /*! \brief The cached use-def chains of the dataflow blocks. */
+  std::unordered_map<DataflowBlock, Map<Var, Array<Var>>, ObjectPtrHash, ObjectPtrEqual> blocks_;
+};
+
+/*!
+ * \brief Managed reference to AnalysisManagerNode.
+ * \sa AnalysisManagerNode
+ */
+class AnalysisManager : public ObjectRef {
+ public:
+  TVM_DLL AnalysisManager();
+
+  /*! \return The innermost analysis manager in scope, if any. */
+  TVM_DLL static Optional<AnalysisManager> Current();
+
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(AnalysisManager, ObjectRef,
+                                                    AnalysisManagerNode);
+
+ private:
+  friend class AnalysisManagerInternal;
+  friend class With<AnalysisManager>;
+  TVM_DLL void EnterWithScope();
+  TVM_DLL void ExitWithScope();
+};
+
 }  // namespace relax
 }  // namespace tvm
 
@@ -54,6 +54,20 @@ struct MemAllocStorageAttrs : public tvm::AttrsNode<MemAllocStorageAttrs> {
   }
 };
 
+/*!
+ * \brief Attributes for copying a tensor onto another device.
+ */
+struct DeviceCopyAttrs : public tvm::AttrsNode<DeviceCopyAttrs> {
+  int64_t dst_device_index;
+
+  TVM_DECLARE_ATTRS(DeviceCopyAttrs, "relax.attrs.DeviceCopyAttrs") {
+    TVM_ATTR_FIELD(dst_device_index)
+        .describe(
+            "The index of the device to copy the tensor onto in the device list of the VM. "
+            "Index -1 is reserved for the host device.");
+  }
+};
+
 /*!
  * \brief Attributes for allocating tensor in memory planning.
  */
@@ -92,6 +106,7 @@ struct AllocTensorAttrs : public tvm::AttrsNode<AllocTensorAttrs> {
 struct VMAllocStorageAttrs : public tvm::AttrsNode<VMAllocStorageAttrs> {
   DataType dtype;
   int64_t runtime_device_index;
+  std::string storage_scope;
 
   TVM_DECLARE_ATTRS(VMAllocStorageAttrs, "relax.attrs.VMAllocStorageAttrs") {
     TVM_ATTR_FIELD(dtype)
@@ -102,6 +117,9 @@ struct VMAllocStorageAttrs : public tvm::AttrsNode<VMAllocStorageAttrs> {
             "The device index indicating on which device the tensor is to be allocated at runtime. "
             "Index -1 is reserved for the host device.")
         .set_default(-1);
+    TVM_ATTR_FIELD(storage_scope)
+        .describe("The storage scope of the storage to allocate, e.g. \"global.vtcm\".")
+        .set_default("global");
   }
 };
 
@@ -120,6 +138,31 @@ struct VMAllocTensorAttrs : public tvm::AttrsNode<VMAllocTensorAttrs> {
   }
 };
 
+/*!
+ * \brief Attributes for allocating an output tensor of a function on Relax VM.
+ */
+struct VMAllocOutputAttrs : public tvm::AttrsNode<VMAllocOutputAttrs> {
+  int output_index;
+  DataType dtype;
+  int64_t runtime_device_index;
+
+  TVM_DECLARE_ATTRS(VMAllocOutputAttrs, "relax.attrs.VMAllocOutputAttrs") {
+    TVM_ATTR_FIELD(output_index)
+        .describe(
+            "The index of the tensor in the function output, which is 0 if the output is not a "
+            "tuple.")
+        .set_default(0);
+    TVM_ATTR_FIELD(dtype)
+        .describe("The dtype of the tensor to allocate.")
+        .set_default(DataType::Float(32, 1));
+    TVM_ATTR_FIELD(runtime_device_index)
+        .describe(
+            "The device index indicating on which device the tensor is to be allocated at runtime. "
+            "Index -1 is reserved for the host device.")
+        .set_default(-1);
+  }
+};
+
 }  // namespace relax
 }  // namespace tvm
 #endif  // TVM_RELAX_ATTRS_MEMORY_H_
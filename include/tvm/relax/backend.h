@@ -37,6 +37,15 @@ namespace transform {
  */
 TVM_DLL Pass VMMemoryLower();
 
+/*!
+ * \brief Spread the independent kernel calls over a pool of device streams, and order the
+ * dependent ones with VM stream synchronization builtins. The number of streams is read from the
+ * `relax.VMStreamAssign.num_streams` pass config, the pass is a no-op for a single stream.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass VMStreamAssign();
+
 /*!
  * \brief Lower the shape expression in relax to VM shape heap and TIR functions.
  *
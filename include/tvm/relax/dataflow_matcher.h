@@ -45,6 +45,36 @@ namespace relax {
  */
 bool MatchExpr(DFPattern pattern, Expr expr, Optional<runtime::Map<Var, Expr>> var2val = NullOpt);
 
+/**
+ * \brief Match each binding of a DataflowBlock with a set of patterns in one traversal.
+ * \note The patterns are indexed by the operator and the arity of the calls their roots can match,
+ * so that each binding is only matched with the patterns which may match it, rather than with all
+ * of them. The patterns are tried in their order, e.g. of priority in a pattern table.
+ *
+ * \param patterns The patterns to match, in their order of priority.
+ * \param dfb The DataflowBlock whose bindings are matched.
+ * \return The mapping from each matched binding var to the index of the first pattern it matches.
+ */
+TVM_DLL Map<Var, Integer> MatchBindings(const Array<DFPattern>& patterns, const DataflowBlock& dfb);
+
+/**
+ * \brief Rewrite the bindings of the DataflowBlocks of a function with a set of rules, until none
+ * of them applies.
+ * \note The bindings are matched as in MatchBindings. When a binding is rewritten, only the binding
+ * and its users within the depth of the patterns are matched again, rather than the whole function.
+ * The new values are normalized on their own, and each block is emitted once at the fixpoint,
+ * without the dataflow vars left unused.
+ *
+ * \param patterns The patterns of the rules, in their order of priority.
+ * \param rewriters The rewriter of each pattern, called with the matched value and the mapping from
+ * the (sub-)patterns to the expressions they match. It returns the new value of the binding, or
+ * the matched value to decline the rewrite.
+ * \param func The function to rewrite.
+ * \return The rewritten function.
+ */
+TVM_DLL Function RewriteBindings(const Array<DFPattern>& patterns,
+                                 const Array<PackedFunc>& rewriters, const Function& func);
+
 /**
  * \brief Match a sub-graph in a DataflowBlock with a graph of patterns and return the mapping.
  * \note This algorithm returns the first matched sub-graph. Use `start_hint` to specify the
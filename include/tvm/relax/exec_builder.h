@@ -78,6 +78,33 @@ class ExecBuilderNode : public Object {
    * \param false_offset The program counter offset for the false branch.
    */
   void EmitIf(vm::RegName cond, vm::Index false_offset);
+  /*!
+   * \brief Emit a MakeTuple instruction.
+   * \param fields The fields of the tuple.
+   * \param dst The destination register.
+   */
+  void EmitTuple(std::vector<vm::Instruction::Arg> fields, vm::RegName dst);
+  /*!
+   * \brief Emit a TupleGetItem instruction.
+   * \param tuple The register containing the tuple.
+   * \param field_index The index of the field.
+   * \param dst The destination register.
+   */
+  void EmitTupleGetItem(vm::RegName tuple, vm::Index field_index, vm::RegName dst);
+  /*!
+   * \brief Emit a ShapeOf instruction.
+   * \param tensor The register containing the tensor.
+   * \param dst The destination register.
+   */
+  void EmitShapeOf(vm::RegName tensor, vm::RegName dst);
+  /*!
+   * \brief Emit an InvokeClosure instruction.
+   * \param closure The register containing the closure.
+   * \param args The arguments of the call, without the free variables of the closure.
+   * \param dst The destination register.
+   */
+  void EmitInvokeClosure(vm::RegName closure, std::vector<vm::Instruction::Arg> args,
+                         vm::RegName dst);
   /*!
    * \brief Emit a constant value to the constant pool.
    * \param obj The constant value to be emitted
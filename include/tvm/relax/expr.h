@@ -796,6 +796,11 @@ constexpr const char* kCodegen = "Codegen";
 constexpr const char* kComposite = "Composite";
 /*! \brief Indicate the function was created by the Pattern Partitioning Pass. */
 constexpr const char* kPartitionedFromPattern = "PartitionedFromPattern";
+/*!
+ * \brief The number of the leading parameters of the function which are its runtime inputs. The
+ * remaining parameters are the weights.
+ */
+constexpr const char* kNumInput = "num_input";
 }  // namespace attr
 
 /*! \brief The extern function, which can represent packed function. */
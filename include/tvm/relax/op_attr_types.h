@@ -80,6 +80,21 @@ using FCallPacked = String;
 using FTVMCompute = runtime::TypedPackedFunc<Array<te::Tensor>(
     const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type)>;
 
+/*!
+ * \brief The legalization of an operator into TE, from which LegalizeOps generates the PrimFunc
+ *  called by call_tir in place of the operator.
+ *
+ * \param attrs The attribute of the operator.
+ * \param inputs The placeholders of the tensor arguments.
+ * \return The output tensors, or an empty array to leave the call to the Python legalizer, e.g.
+ *  for the attributes not supported.
+ *
+ * \note The result of a legalization depends only on the operator, its attributes and the shapes
+ *  and dtypes of its arguments, so that it is computed once for the calls that agree on them.
+ */
+using FLegalize = runtime::TypedPackedFunc<Array<te::Tensor>(const Attrs& attrs,
+                                                             const Array<te::Tensor>& inputs)>;
+
 /*! \brief Attributes used in MaxPool2d operator */
 struct MaxPool2DAttrs : public tvm::AttrsNode<MaxPool2DAttrs> {
   Array<PrimExpr> pool_size;
@@ -584,6 +599,108 @@ struct MatmulAttrs : public tvm::AttrsNode<MatmulAttrs> {
   }
 };  // struct MatmulAttrs
 
+/*! \brief Attributes for grouped matmul operator */
+struct GroupedMatmulAttrs : public tvm::AttrsNode<GroupedMatmulAttrs> {
+  bool transpose_w;
+  DataType out_dtype;
+
+  TVM_DECLARE_ATTRS(GroupedMatmulAttrs, "relax.attrs.GroupedMatmulAttrs") {
+    TVM_ATTR_FIELD(transpose_w)
+        .set_default(false)
+        .describe("Whether the weights of the groups are given of shape (num_groups, n, k).");
+    TVM_ATTR_FIELD(out_dtype).describe("The data type of the output tensor");
+  }
+};  // struct GroupedMatmulAttrs
+
+/*! \brief Attributes for attention operator */
+struct AttentionAttrs : public tvm::AttrsNode<AttentionAttrs> {
+  Optional<FloatImm> scale;
+  String causal_mask;
+  double dropout_rate;
+  int seed;
+
+  TVM_DECLARE_ATTRS(AttentionAttrs, "relax.attrs.AttentionAttrs") {
+    TVM_ATTR_FIELD(scale)
+        .set_default(Optional<FloatImm>{NullOpt})
+        .describe("The scale of the scores, by default 1 / sqrt(head_dim).");
+    TVM_ATTR_FIELD(causal_mask)
+        .set_default("")
+        .describe(
+            "The causal mask of the scores, none if empty. With TopLeft, the query i attends to "
+            "the keys up to i. With BottomRight, the last query attends to all the keys.");
+    TVM_ATTR_FIELD(dropout_rate)
+        .set_default(0.0)
+        .describe("Fraction of the attention probabilities that gets dropped out.");
+    TVM_ATTR_FIELD(seed).set_default(0).describe("The seed of the dropout mask.");
+  }
+};  // struct AttentionAttrs
+
+/*! \brief Attributes for the fused normalization operators */
+struct FusedNormAttrs : public tvm::AttrsNode<FusedNormAttrs> {
+  Array<Integer> axis;
+  double epsilon;
+  DataType out_dtype;
+
+  TVM_DECLARE_ATTRS(FusedNormAttrs, "relax.attrs.FusedNormAttrs") {
+    TVM_ATTR_FIELD(axis)
+        .set_default(Array<Integer>{Integer(-1)})
+        .describe("The normalized axes, which are the trailing axes of the data.");
+    TVM_ATTR_FIELD(epsilon)
+        .describe("Small float added to variance to avoid dividing by zero")
+        .set_default(1e-5);
+    TVM_ATTR_FIELD(out_dtype).describe(
+        "The data type of the normalized output, by default the data type of the data.");
+  }
+};  // struct FusedNormAttrs
+
+/*! \brief Attributes for the weight-only quantization operators */
+struct WeightQuantizeAttrs : public tvm::AttrsNode<WeightQuantizeAttrs> {
+  int bits;
+  int group_size;
+  DataType out_dtype;
+
+  TVM_DECLARE_ATTRS(WeightQuantizeAttrs, "relax.attrs.WeightQuantizeAttrs") {
+    TVM_ATTR_FIELD(bits).set_default(8).describe(
+        "The bits of the quantized weights, 8 or 4. The weights are packed in uint8, from the "
+        "low bits, with an offset of 2^(bits - 1).");
+    TVM_ATTR_FIELD(group_size)
+        .set_default(128)
+        .describe("The number of consecutive weights of a row sharing a scale.");
+    TVM_ATTR_FIELD(out_dtype).describe("The data type of the output tensor");
+  }
+};  // struct WeightQuantizeAttrs
+
+/*! \brief Attributes for allreduce operator */
+struct AllReduceAttrs : public tvm::AttrsNode<AllReduceAttrs> {
+  String op_type;
+
+  TVM_DECLARE_ATTRS(AllReduceAttrs, "relax.attrs.AllReduceAttrs") {
+    TVM_ATTR_FIELD(op_type).set_default("sum").describe(
+        "The reduction across the workers, one of sum, prod, min and max.");
+  }
+};  // struct AllReduceAttrs
+
+/*! \brief Attributes for allgather operator */
+struct AllGatherAttrs : public tvm::AttrsNode<AllGatherAttrs> {
+  int num_workers;
+
+  TVM_DECLARE_ATTRS(AllGatherAttrs, "relax.attrs.AllGatherAttrs") {
+    TVM_ATTR_FIELD(num_workers).describe("The number of workers in the group.");
+  }
+};  // struct AllGatherAttrs
+
+/*! \brief Attributes for reduce_scatter operator */
+struct ReduceScatterAttrs : public tvm::AttrsNode<ReduceScatterAttrs> {
+  int num_workers;
+  String op_type;
+
+  TVM_DECLARE_ATTRS(ReduceScatterAttrs, "relax.attrs.ReduceScatterAttrs") {
+    TVM_ATTR_FIELD(num_workers).describe("The number of workers in the group.");
+    TVM_ATTR_FIELD(op_type).set_default("sum").describe(
+        "The reduction across the workers, one of sum, prod, min and max.");
+  }
+};  // struct ReduceScatterAttrs
+
 }  // namespace relax
 }  // namespace tvm
 #endif  // TVM_RELAX_OP_ATTR_TYPES_H_
@@ -86,6 +86,16 @@ TVM_DLL Pass FMARewrite();
  */
 TVM_DLL Pass LambdaLift();
 
+/*!
+ * \brief Replace the invocations of the closures whose lifted function is known at compile time
+ * with direct calls of the function, the captured variables passed as trailing arguments.
+ *
+ * \return The Pass.
+ * \note The closures made in the function, or by a global function only making the closure of
+ * its parameters, are known. The others, e.g. the parameters, are still invoked.
+ */
+TVM_DLL Pass SpecializeClosures();
+
 /*!
  * \brief Transform all dataflow structure to non-dataflow version.
  *
@@ -100,6 +110,24 @@ TVM_DLL Pass ToNonDataflow();
  */
 TVM_DLL Pass CallTIRRewrite();
 
+/*!
+ * \brief Let the elementwise kernels write their output to an input which dies at the kernel,
+ * instead of a fresh allocation. Applies after CallTIRRewrite.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass InplaceElementwise();
+
+/*!
+ * \brief Recompute the activations of the dataflow blocks near their late uses, until the bytes
+ * of the tensors live together in a block fit a memory budget. Applies before ToNonDataflow.
+ *
+ * \param memory_budget The budget in bytes, or -1 for the config
+ * "relax.CheckpointActivations.memory_budget", without which the pass does nothing.
+ * \return The Pass.
+ */
+TVM_DLL Pass CheckpointActivations(int64_t memory_budget = -1);
+
 /*!
  * \brief Attach global_symbol to Relax functions and TIR Primfuncs for codegen.
  *
@@ -135,7 +163,20 @@ TVM_DLL Pass Normalize();
 TVM_DLL Pass BindParams(String name, Map<String, runtime::NDArray> params);
 
 /*!
- * \brief Fold constant expressions.
+ * \brief Specialize a function with symbolic shapes to the shapes of its arguments. The symbolic
+ * dims of the parameters and of their match_shape are bound to the given dims, and each call_tir
+ * whose arguments and outputs get static shapes calls a copy of its PrimFunc specialized to them.
+ *
+ * \param func_name The name of the function to specialize.
+ * \param shapes The ShapeTuple of each argument, or None to leave an argument symbolic.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass SpecializeShapes(String func_name, Array<ObjectRef> shapes);
+
+/*!
+ * \brief Fold constant expressions. The large outputs are evaluated on the
+ * "relax.FoldConstant.device_target" pass config target if it is set.
  *
  * \return The Pass.
  */
@@ -159,9 +200,13 @@ TVM_DLL Pass AnnotateTIROpPattern();
  * A follow-up pass named "FuseTIR" will generate a TIR PrimFunc for each grouped function.
  * \param fuse_opt_level The level of fuse optimization.
  *        -1 indicates that the level will be inferred from pass context.
+ * \param fusion_policy The optional function deciding whether to commit each fusion allowed by
+ *        the op patterns, given the bindings of the group the fusion would create. It returns
+ *        true to commit the fusion.
  * \return The Pass.
  */
-TVM_DLL Pass FuseOps(int fuse_opt_level = -1);
+TVM_DLL Pass FuseOps(int fuse_opt_level = -1,
+                     Optional<runtime::PackedFunc> fusion_policy = NullOpt);
 
 /*!
  * \brief Fuse relax sub-function into a larger TIR function if possible.
@@ -171,6 +216,23 @@ TVM_DLL Pass FuseOps(int fuse_opt_level = -1);
  */
 TVM_DLL Pass FuseTIR();
 
+/*!
+ * \brief Merge the TIR PrimFuncs which are structurally equal regardless of their names, and
+ * redirect the calls to the merged ones. The PrimFunc of the smallest name is kept.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass DeduplicatePrimFuncs();
+
+/*!
+ * \brief Lift the transformations of the weights of each function with the attribute
+ * "num_input", such as their layout rewrites, into a function "<name>_transform_params". The
+ * function then takes the transformed weights in place of the weights, so that the transformations
+ * run once ahead of the deployment rather than on each call.
+ * \return The Pass.
+ */
+TVM_DLL Pass LiftTransformParams();
+
 /*!
  * \brief Remove unused global relax functions in a IRModule.
  * \param entry_functions list of entry functions
@@ -196,12 +258,55 @@ TVM_DLL Pass RunCodegen(Optional<Array<runtime::String>> target_codegens,
  */
 TVM_DLL Pass SplitCutlass();
 
+/*!
+ * \brief Rewrite the dense and matmul calls of constant weights into weight-only quantized dense
+ * calls, whose weights are quantized by groups. Applies after BindParams, and the quantization of
+ * the weights is folded by FoldConstant after the op legalizer.
+ *
+ * \param bits The bits of the quantized weights, 8 or 4.
+ * \param group_size The number of consecutive weights of a row sharing a scale.
+ * \return The Pass.
+ */
+TVM_DLL Pass QuantizeWeights(int bits = 8, int group_size = 128);
+
+/*!
+ * \brief Rewrite the dense and matmul calls of constant float16 weights into 2:4 structured sparse
+ * dense calls, which run on the sparse tensor cores. Applies after BindParams, and the packing of
+ * the weights is folded by FoldConstant after the op legalizer.
+ *
+ * \param prune Whether to prune the weights to the 2 of largest magnitude of each group of 4 of a
+ * row, or to rewrite only the weights which are already 2:4 sparse.
+ * \return The Pass.
+ */
+TVM_DLL Pass SparsifyWeights(bool prune = false);
+
+/*!
+ * \brief Legalize the calls of the operators with FLegalize into call_tir of the PrimFuncs of
+ * their TE compute. The calls of the same operator, attributes, shapes and dtypes share one
+ * PrimFunc, which is built once.
+ * \return The Pass.
+ */
+TVM_DLL Pass LegalizeOps();
+
 /*!
  * \brief Automatic mixed precision pass.
  *
+ * \param out_dtype The output (accumulation) dtype of the ops computed in low precision.
+ * \param low_precision_dtype The low precision dtype, e.g. "float16" or "bfloat16".
+ * \param always_ops The ops always computed in low precision, regardless of their registered
+ * conversion category.
+ * \param never_ops The ops never computed in low precision, regardless of their registered
+ * conversion category.
+ * \param op_out_dtypes The output dtype of the ops whose output dtype differs from out_dtype.
  * \return The Pass.
+ *
+ * \note Each tensor is casted at most once to each dtype.
  */
-TVM_DLL Pass ToMixedPrecision();
+TVM_DLL Pass ToMixedPrecision(const runtime::String& out_dtype,
+                              const runtime::String& low_precision_dtype = "float16",
+                              Array<runtime::String> always_ops = {},
+                              Array<runtime::String> never_ops = {},
+                              Map<runtime::String, runtime::String> op_out_dtypes = {});
 
 }  // namespace transform
 }  // namespace relax
@@ -361,6 +361,16 @@ class DatabaseNode : public runtime::Object {
    */
   virtual Array<TuningRecord> GetTopK(const meta_schedule::Workload& workload, const Target& target,
                                       int top_k) = 0;
+  /*!
+   * \brief Get the tuning record of a trace with the same knobs and decisions from the database,
+   *  which memoizes the traces already evaluated from the same input IRModule.
+   * \param workload The workload of the input IRModule of the trace.
+   * \param target Target to be searched for.
+   * \param trace The trace to be searched for.
+   * \return The tuning record of the trace if exists.
+   */
+  virtual Optional<TuningRecord> GetTuningRecord(const meta_schedule::Workload& workload,
+                                                 const Target& target, const Trace& trace) = 0;
   /*!
    * \brief Get the measurement record of given workload and target from the database.
    * \param workload The workload to be searched for.
@@ -389,6 +399,14 @@ class Database : public runtime::ObjectRef {
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
                                        String path_measurement_record, bool allow_missing);
+  /*!
+   * \brief Create a database on the indexed append-only logs, which opens without loading the
+   * records, and can be appended by multiple tuners at the same time.
+   * \param path The path prefix of the logs.
+   * \param num_shards The number of shards of the record logs, if they are new.
+   * \param allow_missing Whether to create new logs when the given path is not found.
+   */
+  TVM_DLL static Database IndexedDatabase(String path, int num_shards, bool allow_missing);
   TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(Database, runtime::ObjectRef, DatabaseNode);
 };
 
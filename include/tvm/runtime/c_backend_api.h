@@ -166,6 +166,44 @@ TVM_DLL int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv);
  */
 TVM_DLL int TVMBackendRunOnce(void** handle, int (*f)(void*), void* cdata, int nbytes);
 
+/*!
+ * \brief Backend function to set an argument of a packed call to an item of an AnyList, an array
+ *  of TVMRetValue such as the register file of the Relax VM.
+ *
+ * \param anylist The AnyList.
+ * \param index The index of the item.
+ * \param args The values of the arguments of the packed call.
+ * \param type_codes The type codes of the arguments of the packed call.
+ * \param arg_offset The index of the argument to set.
+ * \return 0 when no error is thrown, -1 when failure happens
+ * \note The argument borrows the item, which must outlive the packed call.
+ */
+TVM_DLL int TVMBackendAnyListSetPackedArg(void* anylist, int index, TVMValue* args, int* type_codes,
+                                          int arg_offset);
+
+/*!
+ * \brief Backend function to reset an item of an AnyList, releasing the object it holds.
+ *
+ * \param anylist The AnyList.
+ * \param index The index of the item.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendAnyListResetItem(void* anylist, int index);
+
+/*!
+ * \brief Backend function to move the return value of a packed call into an item of an AnyList.
+ *
+ * \param anylist The AnyList.
+ * \param index The index of the item.
+ * \param args The values of the arguments of the packed call, followed by its return value.
+ * \param type_codes The type codes of the arguments of the packed call, followed by the one of its
+ *  return value.
+ * \param ret_offset The index of the return value.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendAnyListMoveFromPackedReturn(void* anylist, int index, TVMValue* args,
+                                                  int* type_codes, int ret_offset);
+
 #ifdef __cplusplus
 }  // TVM_EXTERN_C
 #endif
@@ -24,6 +24,7 @@
 #ifndef TVM_RUNTIME_CONTAINER_SHAPE_TUPLE_H_
 #define TVM_RUNTIME_CONTAINER_SHAPE_TUPLE_H_
 
+#include <iterator>
 #include <utility>
 #include <vector>
 
@@ -86,16 +87,19 @@ class ShapeTuple : public ObjectRef {
   /*!
    * \brief Construct an empty shape tuple.
    */
-  ShapeTuple() : ShapeTuple(std::vector<index_type>()) {}
+  ShapeTuple() : ShapeTuple(Make(0, [](index_type*) {})) {}
 
   /*!
-   * \brief Constructor from iterator
+   * \brief Constructor from iterator, storing the elements inline.
    * \param begin begin of iterator
    * \param end end of iterator
    * \tparam IterType The type of iterator
    */
   template <typename IterType>
-  ShapeTuple(IterType begin, IterType end) : ShapeTuple(std::vector<index_type>(begin, end)) {}
+  ShapeTuple(IterType begin, IterType end)
+      : ShapeTuple(Make(std::distance(begin, end), [&begin, &end](index_type* data) {
+          for (; begin != end; ++begin) *data++ = static_cast<index_type>(*begin);
+        })) {}
 
   /*!
    * \brief constructor from initializer list
@@ -113,6 +117,17 @@ class ShapeTuple : public ObjectRef {
    */
   ShapeTuple(std::vector<index_type> shape);  // NOLINT(*)
 
+  /*!
+   * \brief Make a shape tuple storing its elements inline, in the same allocation as the object,
+   *  without building a temporary std::vector.
+   * \param size The size of the shape tuple.
+   * \param fill The callback writing the elements, called with the pointer to the elements.
+   * \tparam FFill The type of the callback.
+   * \return The shape tuple.
+   */
+  template <typename FFill>
+  static ShapeTuple Make(size_t size, FFill fill);
+
   /*!
    * \brief Return the data pointer
    *
@@ -163,8 +178,17 @@ class ShapeTuple : public ObjectRef {
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(ShapeTuple, ObjectRef, ShapeTupleObj);
 };
 
+template <typename FFill>
+inline ShapeTuple ShapeTuple::Make(size_t size, FFill fill) {
+  auto ptr = SmallObjAllocator().make_inplace_array<ShapeTupleObj, index_type>(size);
+  ptr->size = size;
+  ptr->data = reinterpret_cast<index_type*>(ptr.get() + 1);
+  fill(ptr->data);
+  return ShapeTuple(std::move(ptr));
+}
+
 inline ShapeTuple::ShapeTuple(std::vector<index_type> shape) {
-  auto ptr = make_object<ShapeTupleObj::FromStd>(std::move(shape));
+  auto ptr = SmallObjAllocator().make_object<ShapeTupleObj::FromStd>(std::move(shape));
   ptr->size = ptr->data_container.size();
   ptr->data = ptr->data_container.data();
   data_ = std::move(ptr);
@@ -54,6 +54,59 @@ typedef struct TVMGraphExecutorGraphAttr {
   uint32_t shape_count;
 } TVMGraphExecutorGraphAttr;
 
+/*! \brief An operator of a precomputed execution plan. */
+typedef struct TVMGraphExecutorPlanOp {
+  /*! \brief The name of the function in the module. */
+  const char* func_name;
+  /*! \brief The offset in `args` of the entry ids of the arguments, the inputs then the outputs. */
+  uint32_t args_offset;
+  /*! \brief The number of arguments. */
+  uint32_t args_count;
+  /*! \brief Whether the arguments are flattened to 1-D. */
+  uint32_t flatten_data;
+} TVMGraphExecutorPlanOp;
+
+/*! \brief A data entry of a precomputed execution plan. */
+typedef struct TVMGraphExecutorPlanEntry {
+  /*! \brief The storage the entry is a view of. */
+  uint32_t storage_id;
+  /*! \brief The offset of the shape in `shapes`. */
+  uint32_t shape_offset;
+  /*! \brief The number of dimensions. */
+  uint32_t ndim;
+  /*! \brief The data type. */
+  DLDataType dtype;
+} TVMGraphExecutorPlanEntry;
+
+/*!
+ * \brief A graph execution plan precomputed from the graph JSON at compile time, and emitted as
+ *  constant C arrays by `tvm.micro.generate_graph_executor_plan`, so that the executor neither
+ *  parses the JSON nor copies the graph at boot.
+ */
+typedef struct TVMGraphExecutorPlan {
+  /*! \brief The operators, in the order of execution. */
+  const TVMGraphExecutorPlanOp* ops;
+  uint32_t ops_count;
+  /*! \brief The entry ids of the arguments of the operators. */
+  const uint32_t* args;
+  uint32_t args_count;
+  /*! \brief The data entries. */
+  const TVMGraphExecutorPlanEntry* entries;
+  uint32_t entries_count;
+  /*! \brief The shapes of the data entries. */
+  const int64_t* shapes;
+  /*! \brief The size in bytes of each storage. */
+  const uint32_t* storage_sizes;
+  uint32_t storage_count;
+  /*! \brief The names and the entry ids of the inputs, including the params. */
+  const char* const* input_names;
+  const uint32_t* input_entries;
+  uint32_t inputs_count;
+  /*! \brief The entry ids of the outputs. */
+  const uint32_t* output_entries;
+  uint32_t outputs_count;
+} TVMGraphExecutorPlan;
+
 typedef struct TVMGraphExecutor TVMGraphExecutor;
 
 // public functions
@@ -69,13 +122,28 @@ typedef struct TVMGraphExecutor TVMGraphExecutor;
 int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
                             const DLDevice* devices, TVMGraphExecutor** executor);
 
+/*!
+ * \brief Allocate a new GraphExecutor with TVMPlatformMemoryAllocate and initialize it from a
+ *  precomputed execution plan, which must outlive it.
+ *
+ * \param plan The execution plan.
+ * \param module_handle TVM Module that exposes the functions to call.
+ * \param devices runtime execution device.
+ * \param executor Pointer which receives a pointer to the newly-created instance.
+ * \return 0 if successful.
+ */
+int TVMGraphExecutor_CreateFromPlan(const TVMGraphExecutorPlan* plan,
+                                    TVMModuleHandle module_handle, const DLDevice* devices,
+                                    TVMGraphExecutor** executor);
+
 int TVMGraphExecutor_GetInputIndex(TVMGraphExecutor* executor, const char* name);
 
 /*!
  * \brief get number of input tensors allocated.
+ * \param executor The graph executor.
  * \return integer number of tensors available to use.
  */
-int TVMGraphExecutor_GetNumInputs();
+int TVMGraphExecutor_GetNumInputs(TVMGraphExecutor* executor);
 
 /*!
  * \brief set input to the graph based on name.
@@ -87,9 +155,10 @@ void TVMGraphExecutor_SetInput(TVMGraphExecutor* executor, const char* name, DLT
 
 /*!
  * \brief get number of output tensors allocated.
+ * \param executor The graph executor.
  * \return integer number of output tensors allocated.
  */
-int TVMGraphExecutor_GetNumOutputs();
+int TVMGraphExecutor_GetNumOutputs(TVMGraphExecutor* executor);
 
 /*!
  * \brief Return NDArray for given output index.
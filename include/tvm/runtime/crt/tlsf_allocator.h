@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/crt/tlsf_allocator.h
+ * \brief A two-level segregated fit (TLSF) dynamic memory allocator for microcontrollers.
+ *
+ * Allocations and frees take constant time, and the free neighbours of a freed block are merged
+ * with it at once, so that the pool does not fragment over long runs of graph executors created
+ * and destroyed in any order.
+ */
+
+#ifndef TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/page_allocator.h>
+
+/*! \brief Usage statistics of a TLSF memory manager, in bytes. */
+typedef struct TLSFMemoryManagerStats {
+  /*! \brief The bytes of the pool available to the allocations, headers included. */
+  size_t pool_bytes;
+  /*! \brief The bytes taken by the live allocations, headers included. */
+  size_t used_bytes;
+  /*! \brief The largest used_bytes since the creation of the manager. */
+  size_t peak_used_bytes;
+  /*! \brief The bytes of the largest free block, without its header. */
+  size_t largest_free_bytes;
+} TLSFMemoryManagerStats;
+
+/*!
+ * \brief Create a TLSF memory manager over a memory pool.
+ *
+ * The state of the manager is kept at the beginning of the pool.
+ *
+ * \param manager Pointer, initialized with the new MemoryManager.
+ * \param memory_pool Pointer to the global memory pool used by the CRT.
+ * \param memory_pool_size_bytes Size of `memory_pool`, in bytes.
+ * \return kTvmErrorNoError on success, kTvmErrorPlatformNoMemory if the pool is too small.
+ */
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** manager, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes);
+
+/*!
+ * \brief Get the usage statistics of a TLSF memory manager.
+ *
+ * \param manager A manager created by TLSFMemoryManagerCreate.
+ * \param stats Pointer, filled with the statistics.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t TLSFMemoryManagerGetStats(MemoryManagerInterface* manager,
+                                          TLSFMemoryManagerStats* stats);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
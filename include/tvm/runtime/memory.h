@@ -25,7 +25,10 @@
 
 #include <tvm/runtime/object.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -47,7 +50,6 @@ inline ObjectPtr<T> make_object(Args&&... args);
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
 
 /*!
@@ -191,6 +193,166 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+#ifndef TVM_RUNTIME_SMALL_OBJECT_POOL
+#define TVM_RUNTIME_SMALL_OBJECT_POOL 1
+#endif
+
+/*!
+ * \brief Allocator recycling the blocks of the small objects in thread-local free lists, one per
+ *  size class, for the objects created and destroyed at a high rate (e.g. the tensors, shapes and
+ *  tuples of the VM). Set TVM_RUNTIME_SMALL_OBJECT_POOL to 0 to allocate them with new/delete.
+ *
+ *  The blocks come from the global heap, so an object can be freed by a thread other than the
+ *  one creating it, and the free lists of a thread go back to the heap when it exits.
+ */
+class SmallObjAllocator : public ObjAllocatorBase<SmallObjAllocator> {
+ public:
+  /*! \brief The number of size classes, of 32, 64, 128 and 256 bytes. */
+  static constexpr int kNumSizeClasses = 4;
+  /*! \brief The max number of free blocks kept by a thread in a size class. */
+  static constexpr uint32_t kMaxFreeBlocks = 256;
+
+  /*! \return The size class of a block, kNumSizeClasses when the block is not pooled. */
+  static constexpr int SizeClass(size_t size) {
+    return size <= 32 ? 0 : size <= 64 ? 1 : size <= 128 ? 2 : size <= 256 ? 3 : kNumSizeClasses;
+  }
+
+  /*!
+   * \brief Allocate a block, aligned for any fundamental type.
+   * \param size The size of the block.
+   */
+  static void* Alloc(size_t size) {
+#if TVM_RUNTIME_SMALL_OBJECT_POOL
+    int size_class = SizeClass(size);
+    if (size_class == kNumSizeClasses) return ::operator new(size);
+    FreeLists& lists = ThreadFreeLists();
+    void* block = lists.heads[size_class];
+    if (block == nullptr) return ::operator new(size_t(32) << size_class);
+    lists.heads[size_class] = *static_cast<void**>(block);
+    --lists.lengths[size_class];
+    return block;
+#else
+    return ::operator new(size);
+#endif
+  }
+
+  /*!
+   * \brief Free a block.
+   * \param block The block returned by Alloc.
+   * \param size The size the block was allocated with.
+   */
+  static void Free(void* block, size_t size) {
+#if TVM_RUNTIME_SMALL_OBJECT_POOL
+    int size_class = SizeClass(size);
+    FreeLists& lists = ThreadFreeLists();
+    if (size_class == kNumSizeClasses || lists.lengths[size_class] == kMaxFreeBlocks ||
+        lists.exited) {
+      ::operator delete(block);
+      return;
+    }
+    if (!lists.registered) RegisterThreadExit(&lists);
+    *static_cast<void**>(block) = lists.heads[size_class];
+    lists.heads[size_class] = block;
+    ++lists.lengths[size_class];
+#else
+    ::operator delete(block);
+#endif
+  }
+
+  template <typename T>
+  class Handler {
+   public:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned object");
+
+    template <typename... Args>
+    static T* New(SmallObjAllocator*, Args&&... args) {
+      void* data = Alloc(sizeof(T));
+      new (data) T(std::forward<Args>(args)...);
+      return static_cast<T*>(data);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      Free(tptr, sizeof(T));
+    }
+  };
+
+  // The size of an array is kept in a header before it, read back by the deleter.
+  template <typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    static_assert(alignof(ArrayType) <= alignof(std::max_align_t), "over-aligned object");
+    // for now only support elements that aligns with array header.
+    static_assert(alignof(ArrayType) % alignof(ElemType) == 0 &&
+                      sizeof(ArrayType) % alignof(ElemType) == 0,
+                  "element alignment constraint");
+
+    template <typename... Args>
+    static ArrayType* New(SmallObjAllocator*, size_t num_elems, Args&&... args) {
+      size_t size = kHeaderSize + sizeof(ArrayType) + num_elems * sizeof(ElemType);
+      char* data = static_cast<char*>(Alloc(size));
+      *reinterpret_cast<size_t*>(data) = size;
+      new (data + kHeaderSize) ArrayType(std::forward<Args>(args)...);
+      return reinterpret_cast<ArrayType*>(data + kHeaderSize);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      char* data = reinterpret_cast<char*>(tptr) - kHeaderSize;
+      Free(data, *reinterpret_cast<size_t*>(data));
+    }
+  };
+
+ private:
+  /*!
+   * \brief The free lists of a thread, the blocks linked through their first word. Trivially
+   *  destructible, so that it stays valid for the objects freed at the exit of the thread.
+   */
+  struct FreeLists {
+    void* heads[kNumSizeClasses];
+    uint32_t lengths[kNumSizeClasses];
+    /*! \brief Whether the exit of the thread frees the blocks. */
+    bool registered;
+    /*! \brief Whether the blocks were freed, the blocks freed after go back to the heap. */
+    bool exited;
+  };
+
+  /*! \brief Free the blocks of a thread at its exit. */
+  struct ThreadExit {
+    FreeLists* lists;
+    ~ThreadExit() {
+      for (int i = 0; i < kNumSizeClasses; ++i) {
+        while (void* block = lists->heads[i]) {
+          lists->heads[i] = *static_cast<void**>(block);
+          ::operator delete(block);
+        }
+        lists->lengths[i] = 0;
+      }
+      lists->exited = true;
+    }
+  };
+
+  static FreeLists& ThreadFreeLists() {
+    static thread_local FreeLists lists{};
+    return lists;
+  }
+
+  static void RegisterThreadExit(FreeLists* lists) {
+    static thread_local ThreadExit thread_exit{lists};
+    lists->registered = true;
+  }
+};
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
   return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
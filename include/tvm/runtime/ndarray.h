@@ -115,6 +115,23 @@ class NDArray : public ObjectRef {
    * \note The copy always triggers a TVMSynchronize.
    */
   TVM_DLL void CopyToBytes(void* data, size_t nbytes) const;
+  /*!
+   * \brief Copy data content from another array on a stream, without waiting for the copy.
+   * \param other The source array to be copied from.
+   * \param stream The stream of the device doing the copy, i.e. the one which is not the host.
+   * \note The work of the other streams is ordered after the copy with
+   *  DeviceAPI::SyncStreamFromTo, and the host waits for it with DeviceAPI::StreamSync.
+   *  Both arrays are to be kept alive until then. Copying from host memory overlaps the
+   *  work of the device only if the memory is page-locked, e.g. from the kPinnedHost allocator.
+   */
+  inline void CopyFromAsync(const NDArray& other, TVMStreamHandle stream);
+  /*!
+   * \brief Copy data content into another array on a stream, without waiting for the copy.
+   * \param other The target array to be copied to.
+   * \param stream The stream of the device doing the copy, i.e. the one which is not the host.
+   * \note See CopyFromAsync for the synchronization.
+   */
+  inline void CopyToAsync(const NDArray& other, TVMStreamHandle stream) const;
   /*!
    * \brief Copy the data to another device.
    * \param dev The target device.
@@ -406,6 +423,18 @@ inline void NDArray::CopyTo(const NDArray& other) const {
   CopyFromTo(&(get_mutable()->dl_tensor), &(other.get_mutable()->dl_tensor));
 }
 
+inline void NDArray::CopyFromAsync(const NDArray& other, TVMStreamHandle stream) {
+  ICHECK(data_ != nullptr);
+  ICHECK(other.data_ != nullptr);
+  CopyFromTo(&(other.get_mutable()->dl_tensor), &(get_mutable()->dl_tensor), stream);
+}
+
+inline void NDArray::CopyToAsync(const NDArray& other, TVMStreamHandle stream) const {
+  ICHECK(data_ != nullptr);
+  ICHECK(other.data_ != nullptr);
+  CopyFromTo(&(get_mutable()->dl_tensor), &(other.get_mutable()->dl_tensor), stream);
+}
+
 inline NDArray NDArray::CopyTo(const Device& dev) const {
   ICHECK(data_ != nullptr);
   const DLTensor* dptr = operator->();
@@ -31,6 +31,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -425,6 +426,85 @@ class Profiler {
   std::unordered_map<String, ObjectRef> configuration_;
 };
 
+/*!
+ * \brief A histogram of durations, which any number of threads record into and read from at the
+ * same time without locks.
+ *
+ * The buckets are log-scaled with four per power of two of the nanoseconds, so that a percentile
+ * is off by at most 25% from the true one.
+ */
+class LatencyHistogram {
+ public:
+  /*! \brief The number of buckets, covering every duration that fits in 64 bits. */
+  static constexpr int kNumBuckets = 256;
+
+  LatencyHistogram() { Reset(); }
+  /*!
+   * \brief Record a duration.
+   * \param nanos The duration in nanoseconds.
+   */
+  void Record(int64_t nanos);
+  /*! \brief Clear the recorded durations. */
+  void Reset();
+  /*! \brief The number of recorded durations. */
+  int64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  /*! \brief The mean of the recorded durations in nanoseconds, or 0 if there is none. */
+  double MeanNanos() const;
+  /*! \brief The max of the recorded durations in nanoseconds. */
+  int64_t MaxNanos() const { return max_.load(std::memory_order_relaxed); }
+  /*!
+   * \brief Estimate a percentile of the recorded durations.
+   * \param quantile The quantile of the percentile, between 0 and 1, e.g. 0.99 for p99.
+   * \return The upper bound of the bucket of the percentile in nanoseconds, or 0 if there is none.
+   */
+  int64_t PercentileNanos(double quantile) const;
+
+ private:
+  static int BucketOf(uint64_t nanos);
+  static uint64_t BucketUpperBound(int bucket);
+
+  std::atomic<uint64_t> buckets_[kNumBuckets];
+  std::atomic<int64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<int64_t> max_;
+};
+
+/*!
+ * \brief The timers of sampled regions, which are read into their histograms only once the
+ * regions have had time to finish, so that timing them never waits for the device.
+ *
+ * The device specific timers, e.g. those of CUDA, record events on the device instead of
+ * synchronizing it. Reading a timer is deferred to the next `Flush`, by which time its events
+ * have completed in the common case.
+ */
+class DeferredTimers {
+ public:
+  /*!
+   * \brief Start a timer.
+   * \param dev The device to time.
+   * \return The started timer, to be stopped and passed to `Add`.
+   */
+  Timer Start(Device dev);
+  /*!
+   * \brief Add a stopped timer, to be recorded into a histogram by the next `Flush`.
+   * \param timer The stopped timer.
+   * \param histogram The histogram to record into.
+   */
+  void Add(Timer timer, LatencyHistogram* histogram) {
+    pending_.emplace_back(std::move(timer), histogram);
+  }
+  /*! \brief Record the pending timers into their histograms. */
+  void Flush();
+  /*! \brief Whether there is no pending timer. */
+  bool empty() const { return pending_.empty(); }
+
+ private:
+  /*! \brief The timer factory of each device type, looked up once. */
+  std::unordered_map<int, const PackedFunc*> factories_;
+  /*! \brief The pending timers and their histograms. */
+  std::vector<std::pair<Timer, LatencyHistogram*>> pending_;
+};
+
 /* \brief A duration in time. */
 class DurationNode : public Object {
  public:
@@ -307,6 +307,9 @@ class Registry {
    * \param name The name of the function.
    * \return pointer to the registered function,
    *   nullptr if it does not exist.
+   * \note The pointer stays valid until the program exits, so callers on a hot path can look
+   *  the function up once and keep the pointer. It does not see the functions registered later
+   *  under the same name with override.
    */
   TVM_DLL static const PackedFunc* Get(const std::string& name);  // NOLINT(*)
   /*!
@@ -52,12 +52,20 @@ using Index = ExecWord;
  *
  * The opcode is used to implement instruction
  * as a tagged union.
+ *
+ * The tuple, shape and closure instructions run in the interpreter without going through the
+ * packed function table. MakeTuple and InvokeClosure keep their operands in the `num_args`
+ * and `args` of Call, the closure being the first argument of InvokeClosure.
  */
 enum class Opcode {
   Call = 1U,
   Ret = 2U,
   Goto = 3U,
   If = 4U,
+  MakeTuple = 5U,
+  TupleGetItem = 6U,
+  ShapeOf = 7U,
+  InvokeClosure = 8U,
 };
 
 /*! \brief A single virtual machine instruction.
@@ -142,6 +150,16 @@ struct Instruction {
       /*! \brief The program counter offset for the false branch. */
       Index false_offset;
     };
+    struct /* TupleGetItem */ {
+      /*! \brief The register containing the tuple. */
+      RegName tuple;
+      /*! \brief The index of the field. */
+      Index field_index;
+    };
+    struct /* ShapeOf */ {
+      /*! \brief The register containing the tensor. */
+      RegName tensor;
+    };
   };
   /*!
    * \brief Construct a Call instruction.
@@ -171,6 +189,37 @@ struct Instruction {
    * \return The If instruction.
    */
   static Instruction If(RegName cond, Index false_offset);
+  /*!
+   * \brief Construct a MakeTuple instruction.
+   * \param num_fields The number of fields.
+   * \param fields The fields of the tuple.
+   * \param dst The destination register.
+   * \return The MakeTuple instruction.
+   */
+  static Instruction MakeTuple(Index num_fields, Arg* fields, RegName dst);
+  /*!
+   * \brief Construct a TupleGetItem instruction.
+   * \param tuple The register containing the tuple.
+   * \param field_index The index of the field.
+   * \param dst The destination register.
+   * \return The TupleGetItem instruction.
+   */
+  static Instruction TupleGetItem(RegName tuple, Index field_index, RegName dst);
+  /*!
+   * \brief Construct a ShapeOf instruction.
+   * \param tensor The register containing the tensor.
+   * \param dst The destination register.
+   * \return The ShapeOf instruction.
+   */
+  static Instruction ShapeOf(RegName tensor, RegName dst);
+  /*!
+   * \brief Construct an InvokeClosure instruction.
+   * \param num_args The number of arguments, including the closure.
+   * \param args The closure, followed by the arguments of the call.
+   * \param dst The destination register.
+   * \return The InvokeClosure instruction.
+   */
+  static Instruction InvokeClosure(Index num_args, Arg* args, RegName dst);
 };
 
 }  // namespace relax_vm
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/relax_vm/ccl.h
+ * \brief The collective communication among the VMs running the shards of a model.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_CCL_H_
+#define TVM_RUNTIME_RELAX_VM_CCL_H_
+
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The reduction of the reducing collectives. */
+enum class ReduceKind : int {
+  kSum = 0,
+  kProd = 1,
+  kMin = 2,
+  kMax = 3,
+};
+
+/*!
+ * \brief Parse the name of a reduction, one of "sum", "prod", "min" and "max".
+ * \param name The name.
+ * \return The reduction.
+ */
+ReduceKind ParseReduceKind(const std::string& name);
+
+/*!
+ * \brief A communicator of a group of workers, each running a VM on a device of its own.
+ *
+ *  Every worker of the group calls the same collectives in the same order, each with a tensor of
+ *  the same dtype and shape on its device. The collectives are ordered on the default stream of
+ *  the device, like the kernels.
+ */
+class CommunicatorObj : public Object {
+ public:
+  /*! \brief The number of workers in the group. */
+  int world_size;
+  /*! \brief The rank of this worker in the group. */
+  int rank;
+  /*! \brief The device of this worker. */
+  Device device;
+
+  /*!
+   * \brief Reduce the tensors of all the workers, and hand the result to every one of them.
+   * \param send The tensor of this worker.
+   * \param recv The result, of the same shape as send.
+   * \param kind The reduction.
+   */
+  virtual void AllReduce(const DLTensor* send, DLTensor* recv, ReduceKind kind) = 0;
+  /*!
+   * \brief Concatenate the tensors of all the workers in the order of their ranks.
+   * \param send The tensor of this worker.
+   * \param recv The result, world_size times as large as send.
+   */
+  virtual void AllGather(const DLTensor* send, DLTensor* recv) = 0;
+  /*!
+   * \brief Reduce the tensors of all the workers, and hand the i-th part of the result to rank i.
+   * \param send The tensor of this worker.
+   * \param recv The part of this worker, world_size times smaller than send.
+   * \param kind The reduction.
+   */
+  virtual void ReduceScatter(const DLTensor* send, DLTensor* recv, ReduceKind kind) = 0;
+
+  static constexpr const char* _type_key = "relax.vm.Communicator";
+  TVM_DECLARE_BASE_OBJECT_INFO(CommunicatorObj, Object);
+};
+
+/*! \brief Managed reference to CommunicatorObj. */
+class Communicator : public ObjectRef {
+ public:
+  /*!
+   * \brief Join a group of workers in this process.
+   * \param group The name of the group, shared by its workers.
+   * \param world_size The number of workers in the group.
+   * \param rank The rank of this worker.
+   * \param device The device of this worker.
+   * \return The communicator, which returns once all the workers have joined.
+   * \note The communicators on a device type are created by the global function
+   *  "vm.ccl.create_communicator.<device name>", e.g. NCCL on CUDA.
+   */
+  static Communicator Create(const std::string& group, int world_size, int rank, Device device);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(Communicator, ObjectRef, CommunicatorObj);
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_CCL_H_
@@ -24,17 +24,25 @@
 #define TVM_RUNTIME_RELAX_VM_EXECUTABLE_H_
 
 #include <tvm/runtime/container/closure.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/registry.h>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "./bytecode.h"
 
 namespace tvm {
 namespace runtime {
+
+class MappedFile;
+
 namespace relax_vm {
 
 /*!
@@ -62,6 +70,21 @@ class VMClosure : public Closure {
   TVM_DEFINE_OBJECT_REF_METHODS(VMClosure, Closure, VMClosureObj);
 };
 
+/*!
+ * \brief The device memory planned for the activations of a VM function on one device.
+ *
+ * The storages of the function are those its memory plan already reuses the tensors in, so
+ * their sum is the peak of the activations of the function, apart from the functions it calls.
+ */
+struct VMMemoryFootprint {
+  /*! \brief The runtime device index of the storages. */
+  Index device_index;
+  /*! \brief The total bytes of the storages and outputs of statically known size. */
+  int64_t static_bytes{0};
+  /*! \brief The number of storages and outputs whose size is only known at runtime. */
+  int64_t num_dynamic_allocs{0};
+};
+
 /*!
  * \brief A representation of a Relax function in the VM.
  *
@@ -79,6 +102,8 @@ struct VMFunction {
   Index register_file_size;
   /*! \brief The function parameter names.*/
   std::vector<std::string> param_names;
+  /*! \brief The planned activation memory of the function, for each device it allocates on. */
+  std::vector<VMMemoryFootprint> memory;
 };
 
 /*!
@@ -146,8 +171,26 @@ class Executable : public runtime::ModuleNode {
    * \brief Load Executable from the file.
    * \param file_name The path of the file that load the executable from.
    * \return The loaded executable, in the form of a `runtime::Module`.
+   * \note The files written by SaveToFile keep the NDArray constants in a page-aligned blob.
+   *  The blob is mapped in memory and the constants view the mapping without being copied.
    */
   static Module LoadFromFile(const std::string& file_name);
+  /*!
+   * \brief Get the constant pool with its NDArray constants resident on the given device.
+   * \param dev The device.
+   * \return The constant pool, shared read-only by every VM running the executable on the device.
+   * \note Thread-safe. The constants are copied to each device only once.
+   */
+  std::shared_ptr<const std::vector<TVMRetValue>> GetDeviceConstants(Device dev);
+  /*!
+   * \brief Get the memory the executable is planned to need, without loading it on any device.
+   * \param func_name The function whose activations are reported, or empty for the max over
+   *  all the functions.
+   * \return The "device_index", "activation_bytes" and "num_dynamic_allocs" of each device, in
+   *  the same order, and the total "constant_bytes" and the "workspace_bytes", or -1 when the
+   *  workspace is unknown, each as a ShapeTuple.
+   */
+  Map<String, ShapeTuple> GetMemoryFootprint(const std::string& func_name) const;
 
   /*! \brief The virtual machine's function table. */
   std::vector<VMFunction> global_funcs;
@@ -166,6 +209,11 @@ class Executable : public runtime::ModuleNode {
   std::vector<Index> instr_offset;
   /*! \brief The byte data of instruction. */
   std::vector<ExecWord> instr_data;
+  /*!
+   * \brief The bytes of the largest workspace of the kernels, for their intermediate buffers,
+   *  or -1 when unknown.
+   */
+  int64_t workspace_bytes{-1};
 
   virtual ~Executable() {}
 
@@ -177,11 +225,19 @@ class Executable : public runtime::ModuleNode {
    * \param strm The input stream.
    */
   void SaveGlobalSection(dmlc::Stream* strm);
+  /*!
+   * \brief Save the executable sections.
+   * \param blob When set, the NDArray constants are appended to it to be saved in the constant
+   *  blob, and the constant section only refers to them.
+   * \return The serialized sections.
+   */
+  std::string SaveSections(std::vector<NDArray>* blob);
   /*!
    * \brief Save the constant pool.
    * \param strm The input stream.
+   * \param blob When set, the NDArray constants are appended to it instead of written inline.
    */
-  void SaveConstantSection(dmlc::Stream* strm);
+  void SaveConstantSection(dmlc::Stream* strm, std::vector<NDArray>* blob = nullptr);
   /*!
    * \brief Save the instructions.
    * \param strm The input stream.
@@ -192,16 +248,33 @@ class Executable : public runtime::ModuleNode {
    * \param strm The input stream.
    */
   void SavePackedFuncNames(dmlc::Stream* strm);
+  /*!
+   * \brief Save the planned memory of the functions and the workspace.
+   * \param strm The input stream.
+   */
+  void SaveMemorySection(dmlc::Stream* strm);
   /*!
    * \brief Load the globals.
    * \param strm The input stream.
    */
   void LoadGlobalSection(dmlc::Stream* strm);
+  /*!
+   * \brief Load the executable sections.
+   * \param strm The input stream.
+   * \param file The mapped file holding the constant blob, if any.
+   * \param blob_offset The offset of the constant blob in the file.
+   * \return The loaded executable, in the form of a `runtime::Module`.
+   */
+  static Module LoadSections(dmlc::Stream* strm, const std::shared_ptr<MappedFile>& file,
+                             uint64_t blob_offset);
   /*!
    * \brief Load the constant pool.
    * \param strm The input stream.
+   * \param file The mapped file holding the constant blob, if any.
+   * \param blob_offset The offset of the constant blob in the file.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(dmlc::Stream* strm, const std::shared_ptr<MappedFile>& file = nullptr,
+                           uint64_t blob_offset = 0);
   /*!
    * \brief Load the instructions.
    * \param strm The input stream.
@@ -212,6 +285,16 @@ class Executable : public runtime::ModuleNode {
    * \param strm The input stream.
    */
   void LoadPackedFuncNames(dmlc::Stream* strm);
+  /*!
+   * \brief Load the planned memory of the functions and the workspace, if saved.
+   * \param strm The input stream.
+   */
+  void LoadMemorySection(dmlc::Stream* strm);
+
+  /*! \brief Guards device_constants_. */
+  std::mutex device_constants_mutex_;
+  /*! \brief The constant pool copied to each device it has been requested for. */
+  std::vector<std::pair<Device, std::shared_ptr<const std::vector<TVMRetValue>>>> device_constants_;
 };
 
 }  // namespace relax_vm
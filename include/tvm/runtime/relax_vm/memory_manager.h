@@ -25,11 +25,14 @@
 #define TVM_RUNTIME_RELAX_VM_MEMORY_MANAGER_H_
 
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/string.h>
 #include <tvm/runtime/ndarray.h>
 
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -44,11 +47,24 @@ struct Buffer {
   size_t size{0};
   /*! \brief The device of the allocated buffers. */
   Device device;
+  /*! \brief The storage scope of the block, e.g. "global.vtcm" on Hexagon. */
+  std::string scope{"global"};
 };
 
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kSizeClass,
+  /*!
+   * \brief A pooled allocator of the page-locked host memory staging the transfers to a device,
+   *  which the device copies asynchronously. See MemoryManager::PinnedHostDevice.
+   */
+  kPinnedHost,
+  /*!
+   * \brief An allocator of the memory of a storage scope other than "global" of a device, e.g. the
+   *  VTCM of Hexagon. See MemoryManager::GetOrCreateScopedAllocator.
+   */
+  kScoped,
 };
 
 class Allocator {
@@ -75,6 +91,19 @@ class Allocator {
    *  \param buffer The buffer to free.
    */
   virtual void Free(const Buffer& buffer) = 0;
+  /*! \brief Return the usage statistics of the allocator, empty if it keeps none. */
+  virtual Map<String, ObjectRef> Stats() const { return {}; }
+  /*!
+   * \brief Reserve the memory the allocator has needed so far in one arena, and serve all the
+   *  later allocations from it, failing instead of allocating from the device when it runs out.
+   */
+  virtual void Freeze() {
+    LOG(FATAL) << "ValueError: The allocator of type " << type_ << " cannot be frozen";
+  }
+  /*! \brief Release the arena of a frozen allocator, and allocate from the device again. */
+  virtual void Unfreeze() {
+    LOG(FATAL) << "ValueError: The allocator of type " << type_ << " cannot be frozen";
+  }
 
  private:
   AllocatorType type_;
@@ -90,12 +119,28 @@ class MemoryManager {
    * \return The memory allocator.
    */
   static Allocator* GetOrCreateAllocator(Device dev, AllocatorType type);
+  /*!
+   * \brief Get the host device of the page-locked memory staging the transfers to a device, on
+   *  which the kPinnedHost allocator of the device is created.
+   * \param dev The TVM device, a CUDA device or the CPU, whose memory is the host memory.
+   * \return The host device.
+   */
+  static Device PinnedHostDevice(Device dev);
+  /*!
+   * \brief Get or create the allocator of a storage scope of a device, which allocates through
+   *  the device API with the scope, e.g. from the VTCM pool for "global.vtcm" on Hexagon.
+   * \param dev The TVM device
+   * \param scope The storage scope, other than "global".
+   * \return The memory allocator.
+   */
+  static Allocator* GetOrCreateScopedAllocator(Device dev, const std::string& scope);
   /*!
    * \brief Get an allocator given the device.
    * \param dev The TVM device
+   * \param scope The storage scope of the allocator.
    * \return The memory allocator.
    */
-  static Allocator* GetAllocator(Device dev);
+  static Allocator* GetAllocator(Device dev, const std::string& scope = "global");
 
  private:
   MemoryManager() {}
@@ -103,6 +148,9 @@ class MemoryManager {
  private:
   std::mutex mutex_;
   std::unordered_map<Device, std::unique_ptr<Allocator>> allocators_;
+  /*! \brief The allocators of the storage scopes other than "global", by device and scope. */
+  std::unordered_map<Device, std::unordered_map<std::string, std::unique_ptr<Allocator>>>
+      scoped_allocators_;
 };
 
 /*! \brief An object representing a storage allocation. */
@@ -118,7 +166,7 @@ class StorageObj : public Object {
   static void Deleter(Object* ptr);
 
   ~StorageObj() {
-    auto alloc = MemoryManager::Global()->GetAllocator(buffer.device);
+    auto alloc = MemoryManager::Global()->GetAllocator(buffer.device, buffer.scope);
     alloc->Free(buffer);
   }
 
@@ -23,11 +23,19 @@
 #ifndef TVM_RUNTIME_RELAX_VM_VM_H_
 #define TVM_RUNTIME_RELAX_VM_VM_H_
 
+#include <tvm/runtime/profiling.h>
+
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "./bytecode.h"
+#include "./ccl.h"
 #include "./executable.h"
 #include "./memory_manager.h"
 
@@ -35,6 +43,8 @@ namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
+class ConstantPager;
+
 /*!
  * \brief The register type.
  */
@@ -54,6 +64,8 @@ struct VMFrame {
   std::vector<RegType> register_file;
   /*! \brief Register in caller's frame to put return value */
   RegName caller_return_register;
+  /*! \brief The index of the function running in the frame. */
+  Index func_index{-1};
   // The following fields are used for PackedFunc call within
   // a single function scope. The space is reused across multiple
   // packed func calls to increase cache locality and avoid re-allocation
@@ -64,6 +76,79 @@ struct VMFrame {
 
   VMFrame(Index pc, Index register_file_size)
       : return_pc(pc), register_file(register_file_size), caller_return_register(0) {}
+
+  /*!
+   * \brief Reset a recycled frame for a new call.
+   * \param pc The return program counter.
+   * \param register_file_size The register file size of the callee.
+   * \note The capacity of the register file and argument stacks is kept,
+   *  so reusing a frame does not allocate in the steady state.
+   */
+  void Reset(Index pc, Index register_file_size) {
+    return_pc = pc;
+    caller_return_register = 0;
+    register_file.resize(register_file_size);
+  }
+
+  /*! \brief Release the values held by the frame while keeping its storage. */
+  void Clear() { register_file.clear(); }
+};
+
+/*!
+ * \brief The prebuilt argument stack of a Call instruction.
+ *
+ * Immediates, constant pool entries and the VM handle do not change
+ * between calls, so they are set once when the VM is initialized.
+ * Only the register-sourced arguments are patched at runtime.
+ */
+struct CallArgTemplate {
+  /*! \brief The argument values, with register-sourced slots left unset. */
+  std::vector<TVMValue> values;
+  /*! \brief The argument tcodes, with register-sourced slots left unset. */
+  std::vector<int> tcodes;
+  /*! \brief The (argument index, register name) pairs patched on every call. */
+  std::vector<std::pair<Index, RegName>> reg_args;
+  /*! \brief The (argument index, constant index) pairs of the paged constants, patched too. */
+  std::vector<std::pair<Index, Index>> const_args;
+};
+
+/*!
+ * \brief An instruction decoded ahead of time from the executable bytecode.
+ *
+ * The VM decodes the whole instruction stream once when the executable
+ * is loaded, so that the dispatch loop does not need to rebuild an
+ * Instruction from the flat bytecode words on every step.
+ */
+struct DecodedInstruction : public Instruction {
+  /*!
+   * \brief The callee of a Call instruction, pointing into the VM function table.
+   * \note The function table entry is populated lazily on the first call.
+   */
+  PackedFunc* func{nullptr};
+  /*!
+   * \brief The prebuilt argument stack of a Call instruction.
+   * \note It is nullptr until the VM is initialized with the constant pool.
+   */
+  const CallArgTemplate* arg_template{nullptr};
+
+  DecodedInstruction() = default;
+  explicit DecodedInstruction(const Instruction& instr) : Instruction(instr) {}
+};
+
+/*!
+ * \brief The configuration and the latency histograms of the sampling profiler.
+ * \note Shared by the execution contexts of a VM, which record into the histograms at the same
+ *  time without locks.
+ */
+struct SamplingState {
+  /*! \brief The fraction of the top-level invocations timed. */
+  double invocation_rate;
+  /*! \brief Time every `call_stride`-th call instruction of a timed invocation. */
+  int64_t call_stride;
+  /*! \brief The latencies of the VM functions, indexed by function index. */
+  std::unique_ptr<profiling::LatencyHistogram[]> function_latency;
+  /*! \brief The latencies of the callees of the call instructions, indexed by callee index. */
+  std::unique_ptr<profiling::LatencyHistogram[]> call_latency;
 };
 
 /*!
@@ -83,6 +168,7 @@ class VirtualMachine : public runtime::ModuleNode {
    * \brief Initialize the virtual machine for a set of devices.
    * \param devices The set of TVM devices.
    * \param alloc_types The allocator types for each device.
+   * \note Must run after the executable has been loaded.
    */
   void Init(const std::vector<Device>& devices, const std::vector<AllocatorType>& alloc_types);
   /*!
@@ -90,6 +176,14 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param exec The executable.
    */
   void LoadExecutable(ObjectPtr<Executable> exec);
+  /*!
+   * \brief Create a new execution context of the loaded executable on the same devices.
+   * \return The new virtual machine.
+   * \note The context shares the executable, the device constant pool and the memory allocators
+   *  with this VM, and only owns its call frames and registers. A VirtualMachine must not be
+   *  used by several threads at a time, so give each serving thread a context of its own.
+   */
+  ObjectPtr<VirtualMachine> CreateContext();
   /*!
    * \brief Get a PackedFunc from module.
    *
@@ -109,7 +203,9 @@ class VirtualMachine : public runtime::ModuleNode {
    */
   PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
 
-  ~VirtualMachine() {}
+  VirtualMachine();
+
+  ~VirtualMachine();
 
   const char* type_key() const final { return "relax.VirtualMachine"; }
 
@@ -119,6 +215,63 @@ class VirtualMachine : public runtime::ModuleNode {
   std::vector<Allocator*> allocators;
   /*! \brief Runtime physical device list. */
   std::vector<Device> devices;
+  /*!
+   * \brief The communicator of the group of workers running the shards of the model, created on
+   *  the first device at initialization if the VM is configured by `set_ccl_config`.
+   */
+  Communicator communicator;
+  /*!
+   * \brief When set, the storage allocated by the VM is appended to it.
+   * \note Used to keep the buffers referred to by a captured CUDA graph alive,
+   *  so that they are not handed out again by a pooled allocator.
+   */
+  std::vector<ObjectRef>* storage_recorder{nullptr};
+  /*!
+   * \brief Get a stream of the stream pool of a device.
+   * \param device_index The index of the device in the device list.
+   * \param stream_index The index of the stream in the pool of the device.
+   * \return The stream handle. Stream 0 is always the default stream of the device.
+   * \note Streams other than the default one are created on first use.
+   */
+  TVMStreamHandle GetStream(Index device_index, Index stream_index);
+  /*!
+   * \brief Read the condition of an If.
+   * \param cond The condition, an int kept on the host or a scalar tensor on any device.
+   * \return The condition as an int.
+   * \note A condition on a device is read back into a host buffer reused across the reads, through
+   *  page-locked memory when the device supports it, which waits for the default stream only.
+   */
+  int64_t ReadCondition(const RegType& cond);
+  /*!
+   * \brief Get the buffer bound to an output of the function running in the current frame.
+   * \param output_index The index of the tensor in the function output.
+   * \return The buffer bound by `set_output_zero_copy`, or NDArray(nullptr) if there is none.
+   */
+  NDArray GetBoundOutput(Index output_index) const;
+  /*!
+   * \brief Copy a tensor onto a device of the VM, directly between the devices if both are GPUs.
+   * \param src The tensor.
+   * \param device_index The index of the target device in the device list.
+   * \return The tensor on the target device, which is src itself if it is there already.
+   * \note The copies of the constants are kept, so that a constant is only copied onto the device
+   *  consuming it once.
+   */
+  NDArray CopyToDevice(const NDArray& src, Index device_index);
+  /*!
+   * \brief Copy the host constants into memory of this VM, e.g. of a replica per NUMA node.
+   * \param constants The constant pool of the executable on the host.
+   * \return The pool with the copies of the NDArray constants.
+   * \note The copies are allocated and written by the workers of the thread pool of the VM, so
+   *  that their pages are placed on the NUMA nodes of the CPUs of the pool.
+   */
+  std::shared_ptr<const std::vector<TVMRetValue>> ReplicateConstants(
+      const std::vector<TVMRetValue>& constants);
+  /*!
+   * \brief Get the kernel of a vm.call_tir_dyn call site.
+   * \param func_name The name of the kernel, a constant of the call site.
+   * \return The kernel, looked up by name on the first call of the call site only.
+   */
+  const PackedFunc& GetCallTIRDynKernel(const String& func_name);
 
  protected:
   /*!
@@ -150,6 +303,36 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param func_index The function index.
    */
   inline void PrepareFuncTable(Index func_index);
+  /*!
+   * \brief Decode the instruction stream of the loaded executable into instrs_.
+   * \note The decoded Call instructions point into func_table_, which
+   *  is sized to hold every packed function of the executable.
+   */
+  void PredecodeInstructions();
+  /*!
+   * \brief Look up a packed function by name.
+   * \param func_name The name of the function.
+   * \param allow_missing Whether to return nullptr instead of failing when it is not found.
+   * \return The function.
+   */
+  PackedFunc ResolvePackedFunc(const std::string& func_name, bool allow_missing);
+  /*!
+   * \brief Eagerly resolve every packed function referenced by the executable,
+   *  so that no string lookup happens on the first call.
+   * \note Functions that cannot be found are left for lazy resolution,
+   *  which reports the error only if they are actually called.
+   */
+  void ResolveFuncTable();
+  /*!
+   * \brief Build the argument template of every Call instruction.
+   * \note Must run after the constant pool has been copied to the devices.
+   */
+  void PrepareCallArgTemplates();
+  /*!
+   * \brief Prefetch the paged constants of the calls following an instruction.
+   * \param pc The program counter of the instruction.
+   */
+  void PrefetchConstants(Index pc);
   /*!
    * \brief Invoke a VM function.
    * \param fidx The function index.
@@ -157,20 +340,97 @@ class VirtualMachine : public runtime::ModuleNode {
    * \return The object representing the result.
    */
   RegType Invoke(Index fidx, const std::vector<RegType>& args);
+  /*!
+   * \brief Invoke a VM function with packed arguments.
+   * \param fidx The function index.
+   * \param args The arguments to the function.
+   * \return The object representing the result.
+   * \note Unlike the vector version, this does not materialize an argument vector.
+   */
+  RegType Invoke(Index fidx, TVMArgs args);
+  /*!
+   * \brief Run a VM function whose frame is pushed, timing it if it is a sampled invocation.
+   * \param fidx The function index.
+   */
+  void RunFunction(Index fidx);
+  /*!
+   * \brief Push the frame of a VM function invocation and set up the caller info.
+   * \param fidx The function index.
+   * \param num_args The number of arguments provided to the function.
+   * \return The new frame, whose first num_args registers receive the arguments.
+   */
+  VMFrame* PushInvokeFrame(Index fidx, size_t num_args);
   /*!
    * \brief Read a VM register and cast it to int64_t.
-   * \param reg The register to read from.
+   * \param reg The register to read from, an int or a scalar tensor.
    * \return The read scalar.
    */
-  int64_t LoadScalarInt(RegName reg) const;
+  int64_t LoadScalarInt(RegName reg);
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
+  /*!
+   * \brief Run the native code of a compiled VM function whose frame is pushed, in place of its
+   *  instructions, then return from the frame like the Ret instruction does.
+   * \param gf_idx The function index.
+   */
+  void RunNative(Index gf_idx);
   /*!
    * \brief Run call instruction.
    * \param curr_frame The current frame.
    * \param inst The call instruction.
    */
-  inline void RunInstrCall(VMFrame* curr_frame, Instruction inst);
+  inline void RunInstrCall(VMFrame* curr_frame, const DecodedInstruction& inst);
+  /*!
+   * \brief Run a MakeTuple, TupleGetItem or ShapeOf instruction in place.
+   * \param curr_frame The current frame.
+   * \param inst The instruction.
+   */
+  inline void RunInstrTupleOrShape(VMFrame* curr_frame, const DecodedInstruction& inst);
+  /*!
+   * \brief Run an InvokeClosure instruction, which runs the VM function of the closure in a new
+   *  frame without going through a packed function.
+   * \param curr_frame The current frame.
+   * \param inst The InvokeClosure instruction.
+   */
+  void RunInstrInvokeClosure(VMFrame* curr_frame, const DecodedInstruction& inst);
+  /*!
+   * \brief Read the value of an instruction argument.
+   * \param frame The current frame.
+   * \param arg The argument, a register, an immediate or a constant.
+   * \return The value of the argument.
+   */
+  inline RegType ReadArg(VMFrame* frame, Instruction::Arg arg);
+  /*!
+   * \brief Run the callee of a call instruction under the profiler, and record it to the trace.
+   * \param instr The call instruction.
+   * \param args The arguments of the call.
+   * \param ret The return value of the call.
+   */
+  void RunProfiledCall(const DecodedInstruction& instr, TVMArgs args, TVMRetValue* ret);
+  /*!
+   * \brief Run the callee of a call instruction of a sampled invocation, timing it if it is one
+   *  of the sampled calls.
+   * \param instr The call instruction.
+   * \param args The arguments of the call.
+   * \param ret The return value of the call.
+   */
+  void RunSampledCall(const DecodedInstruction& instr, TVMArgs args, TVMRetValue* ret);
+  /*! \brief Serialize the latency histograms of the sampling profiler to JSON. */
+  std::string SampledStats() const;
+  /*!
+   * \brief Run a function once under the profiler.
+   * \param gf_idx The index of the function.
+   * \param args The arguments of the function.
+   * \param collectors The collectors of the extra metrics of each call, e.g. the hardware
+   *  counters of PAPI.
+   * \return The report of the calls run by the function.
+   */
+  profiling::Report Profile(Index gf_idx, const std::vector<RegType>& args,
+                            const std::vector<profiling::MetricCollector>& collectors = {});
+  /*! \brief The total bytes in use of the allocators, or 0 if they keep no statistics. */
+  int64_t AllocatedBytes() const;
+  /*! \brief Serialize the trace of the last profiled run in the Chrome trace event format. */
+  std::string ChromeTrace() const;
 
   /*!
    * \brief Set inputs to a function.
@@ -178,11 +438,12 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param args args[offset:] are arguments to the function. If the arguments are not of the
    * correct device for the function, they will be copied to the device.
    * \param offset Starting offset of the arguments in \p args.
+   * \param zero_copy Whether to fail instead of copying the arguments not on the device.
    * \note This interface works when using VM over RPC by internally converting NDArray in
    * the arguments to DLTensor, which is supported in RPC where remote could only have a minimal C
    * runtime.
    */
-  void SetInput(std::string func_name, TVMArgs args, int offset);
+  void SetInput(std::string func_name, TVMArgs args, int offset, bool zero_copy = false);
 
   /*!
    * \brief Set a function argument with a given index to an input tensor.
@@ -191,9 +452,10 @@ class VirtualMachine : public runtime::ModuleNode {
    * of NDArray, they will be converted.
    * \param index The input tensor index in the function arguments.
    * \param dev device to copy to if needed.
+   * \param zero_copy Whether to fail instead of copying the tensor if it is not on the device.
    */
   void SetInputTensorWithIndex(std::vector<RegType>& func_args, const TVMArgValue& inp_tensor,
-                               int index, Device dev);
+                               int index, Device dev, bool zero_copy = false);
 
   /*!
    * \brief Look up whether the VM has a function by the given name.
@@ -220,21 +482,124 @@ class VirtualMachine : public runtime::ModuleNode {
    *       cannot change when the vm get loaded.
    */
   std::vector<PackedFunc> func_table_;
+  /*!
+   * \brief The pre-decoded instruction stream, indexed by program counter.
+   * \note A sentinel instruction with an invalid opcode terminates the stream.
+   */
+  std::vector<DecodedInstruction> instrs_;
+  /*!
+   * \brief The native code of the VM functions compiled by the VM TIR codegen, indexed by function
+   *  index, or nullptr for the functions run by the dispatch loop.
+   * \note A compiled function is called with the VM, its register file and the constant pool, and
+   *  writes its result to the register after the last one of the function.
+   */
+  std::vector<PackedFunc> native_funcs_;
+  /*! \brief The argument templates referred to by Call instructions in instrs_. */
+  std::vector<CallArgTemplate> call_arg_templates_;
+  /*!
+   * \brief The kernels of the vm.call_tir_dyn call sites, keyed by the name constants of the
+   *  call sites, which the map keeps alive so that their addresses are not reused.
+   */
+  std::unordered_map<String, PackedFunc, ObjectPtrHash, ObjectPtrEqual> call_tir_dyn_kernels_;
+  /*!
+   * \brief The stream pool of each device, indexed by device index then stream index.
+   * \note Null entries are either the default stream or streams not created yet.
+   */
+  std::vector<std::vector<TVMStreamHandle>> streams_;
+  /*!
+   * \brief Whether the VM runs on several devices other than the host, in which case each call
+   *  switches to the device of its first tensor argument.
+   */
+  bool multi_device_{false};
+  /*! \brief The copies of the constants on the other devices, by constant then device index. */
+  std::unordered_map<const Object*, std::vector<NDArray>> constant_copies_;
+  /*! \brief The host buffers the conditions are read back to, by device and dtype. */
+  std::map<std::tuple<int, int, std::string>, NDArray> scalar_readbacks_;
+  /*! \brief The allocator type of each device, to set up new contexts. */
+  std::vector<AllocatorType> alloc_types_;
+  /*!
+   * \brief The device memory budget of the constants in bytes, or -1 to upload them all eagerly.
+   * \note When set, the constants are uploaded by constant_pager_ on first use.
+   */
+  int64_t constant_budget_{-1};
+  /*! \brief The number of upcoming calls whose constants are prefetched. */
+  int constant_lookahead_{0};
+  /*! \brief The pager of the constants uploaded on demand. */
+  std::unique_ptr<ConstantPager> constant_pager_;
+  /*! \brief The named thread pool to run the kernels on, or empty for the default one. */
+  std::string thread_pool_;
+  /*! \brief Whether the host constants are copied for this VM instead of shared. */
+  bool replicate_constants_{false};
+  /*! \brief The copies of the host constants, shared with the contexts created from this VM. */
+  std::shared_ptr<const std::vector<TVMRetValue>> replica_constants_;
+  /*! \brief The name of the group of workers to join, or empty to run alone. */
+  std::string ccl_group_;
+  /*! \brief The number of workers in the group. */
+  int ccl_world_size_{1};
+  /*! \brief The rank of this worker in the group. */
+  int ccl_rank_{0};
   /*!
    * \brief The current stack of call frames.
    * \note: Use unique ptr to avoid re-allocation and copy when frames_ get resized.
    */
   std::vector<std::unique_ptr<VMFrame>> frames_;
+  /*!
+   * \brief Recycled frames to be reused by PushFrame.
+   * \note Keeps recursive and looping programs free of heap allocation
+   *  in the steady state.
+   */
+  std::vector<std::unique_ptr<VMFrame>> frame_pool_;
   /*! \brief The virtual machine PC. */
   Index pc_{0};
   /*! \brief The special return register. */
   RegType return_value_;
-  /*! \brief The global constant pool */
-  std::vector<TVMRetValue> constants;
+  /*!
+   * \brief The global constant pool, resident on the compute device.
+   * \note Owned by the executable and shared by all the VMs running it on the device.
+   */
+  std::shared_ptr<const std::vector<TVMRetValue>> constants;
   /*! \brief The function name to input register mapping. */
   std::unordered_map<std::string, std::vector<RegType>> inputs_;
   /*! \brief The function name to output register. */
   std::unordered_map<std::string, RegType> outputs_;
+  /*!
+   * \brief The buffers bound to the outputs of the functions by `set_output_zero_copy`,
+   *  indexed by function index then output index.
+   */
+  std::unordered_map<Index, std::vector<NDArray>> bound_outputs_;
+  /*! \brief A call recorded by the profiler. */
+  struct TraceEvent {
+    /*! \brief The name of the callee. */
+    std::string name;
+    /*! \brief The device running the call. */
+    Device device;
+    /*! \brief The start time in microseconds since the start of the run. */
+    double start_us;
+    /*! \brief The duration in microseconds, up to the device finishing the call. */
+    double duration_us;
+    /*! \brief The argument shapes. */
+    std::string shapes;
+    /*! \brief The bytes in use of the allocators after the call. */
+    int64_t bytes_in_use;
+    /*! \brief The bytes allocated by the call, negative if it frees more than it allocates. */
+    int64_t bytes_allocated;
+  };
+  /*! \brief The profiler, only set during a profiled run. */
+  std::unique_ptr<profiling::Profiler> profiler_;
+  /*! \brief The start of the profiled run. */
+  std::chrono::steady_clock::time_point trace_start_;
+  /*! \brief The calls of the last profiled run. */
+  std::vector<TraceEvent> trace_;
+  /*! \brief The sampling profiler, or nullptr if sampling is off. */
+  std::shared_ptr<SamplingState> sampling_;
+  /*! \brief The fractional invocations accumulated towards the next sampled one. */
+  double sample_credit_{0.0};
+  /*! \brief Whether the current top-level invocation is sampled. */
+  bool sampling_run_{false};
+  /*! \brief The number of call instructions run by the sampled invocations. */
+  int64_t sampled_call_count_{0};
+  /*! \brief The timers of the sampled invocations and calls, read once they have finished. */
+  profiling::DeferredTimers sample_timers_;
   /*! \brief A store of closures created by `save_function`. */
   std::unordered_map<std::string, PackedFunc> saved_closures_;
 };
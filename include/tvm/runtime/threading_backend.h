@@ -26,6 +26,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #if defined(__linux__) || defined(__ANDROID__)
@@ -146,6 +147,84 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 int32_t NumThreads();
 
+/*!
+ * \brief Select the thread pool behind TVMBackendParallelLaunch for the launches from the calling
+ *  thread, which defaults to the work-stealing one if the environment variable
+ *  TVM_THREAD_POOL_WORK_STEALING is set to 1.
+ *
+ *  The work-stealing pool splits a launch whose number of tasks is left to the runtime into
+ *  TVM_THREAD_POOL_TASKS_PER_THREAD (default 4) tasks per thread, which the threads claim one by
+ *  one, and supports the launches nested in a task. The parallel barrier is only supported in the
+ *  outermost launches of no more tasks than the threads, e.g. with TVM_THREAD_POOL_TASKS_PER_THREAD
+ *  set to 1.
+ *
+ * \param enable Whether to use the work-stealing thread pool.
+ *
+ * \note This does nothing when openmp is used.
+ */
+TVM_DLL void SetWorkStealing(bool enable);
+
+/*! \brief Whether the launches from the calling thread go to the work-stealing thread pool. */
+TVM_DLL bool IsWorkStealing();
+
+/*!
+ * \brief Hint that parallel launches are about to come from the calling thread, e.g. before a
+ *  request, which wakes the parked workers of its thread pool to spin for them for a while.
+ *
+ *  The workers otherwise spin for at most TVM_THREAD_POOL_SPIN_COUNT iterations before parking,
+ *  a budget which they shrink while idling and grow back under steady traffic.
+ *
+ * \param duration_us The time in microseconds for the workers to keep spinning.
+ *
+ * \note This does nothing when openmp is used.
+ */
+TVM_DLL void WarmUpThreadPool(int64_t duration_us);
+
+/*!
+ * \brief Create a named thread pool of its own workers, which runs the parallel launches from the
+ *  threads bound to it, e.g. to keep the models served in one process from competing for the
+ *  workers of each other.
+ * \param name The name of the pool.
+ * \param num_threads The number of the workers.
+ * \param cpus The CPUs to bind the workers to, one per worker, or empty to leave them unbound.
+ *
+ * \note The launching threads do not run any task of a named pool themselves, so that the tasks
+ *  only run on its CPUs. The launches from the threads bound to the same pool run one at a time.
+ */
+TVM_DLL void CreateThreadPool(const std::string& name, int num_threads,
+                              std::vector<unsigned int> cpus);
+
+/*!
+ * \brief Remove a named thread pool, which is destroyed once no thread is bound to it.
+ * \param name The name of the pool.
+ */
+TVM_DLL void RemoveThreadPool(const std::string& name);
+
+/*!
+ * \brief Bind the calling thread to a named thread pool for its parallel launches.
+ * \param name The name of the pool, or empty for the default thread pool of the calling thread.
+ * \return The name of the pool bound before, or empty if none.
+ */
+TVM_DLL std::string BindThreadPool(const std::string& name);
+
+/*!
+ * \brief Bind the calling thread to a named thread pool in a scope, e.g. a run of an executor.
+ *  An empty name leaves the binding as it is.
+ */
+class ThreadPoolScope {
+ public:
+  explicit ThreadPoolScope(const std::string& name) : bound_(!name.empty()) {
+    if (bound_) prev_ = BindThreadPool(name);
+  }
+  ~ThreadPoolScope() {
+    if (bound_) BindThreadPool(prev_);
+  }
+
+ private:
+  bool bound_;
+  std::string prev_;
+};
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
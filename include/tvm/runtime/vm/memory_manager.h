@@ -115,6 +115,11 @@ class StorageObj : public Object {
  public:
   /*! \brief The index into the VM function table. */
   Buffer buffer;
+  /*!
+   * \brief The storage this one is carved out of, which owns the memory, if any. The memory is
+   *  then released with the parent instead of freed to the allocator.
+   */
+  ObjectRef parent;
 
   /*! \brief Allocate an NDArray from a given piece of storage. */
   NDArray AllocNDArray(size_t offset, std::vector<int64_t> shape, DLDataType dtype);
@@ -123,6 +128,9 @@ class StorageObj : public Object {
   static void Deleter(Object* ptr);
 
   ~StorageObj() {
+    if (parent.defined()) {
+      return;
+    }
     auto alloc = MemoryManager::Global()->GetAllocator(buffer.device);
     alloc->Free(buffer);
   }
@@ -420,7 +420,52 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
 
   bool FindIndex(const std::vector<Index>& indices, Index val) const;
 
+  /*! \brief Start recording the storage allocations of an invocation. */
+  void BeginStorageArena();
+
+  /*!
+   * \brief Allocate the storage of an AllocStorage instruction, out of the region of its device
+   *  when the invocation follows the plan of the storage arena.
+   */
+  Storage AllocateStorage(Index device_index, int64_t size, int64_t alignment,
+                          DLDataType dtype_hint);
+
+  /*! \brief Make the allocations of a finished invocation the plan of the next ones. */
+  void EndStorageArena();
+
  protected:
+  /*! \brief A storage allocation of an invocation. */
+  struct StorageAlloc {
+    Index device_index;
+    int64_t size;
+    int64_t alignment;
+    /*! \brief The offset of the allocation in the region of its device. */
+    int64_t offset;
+  };
+
+  /*!
+   * \brief The storage arena, which records the storage allocations of an invocation as the plan
+   *  of the next ones. The allocations of an invocation following the plan are carved out of one
+   *  region per device, so that the steady state makes no allocator call.
+   */
+  struct StorageArena {
+    /*! \brief Whether the invocations allocate out of the arena. */
+    bool enabled = false;
+    /*! \brief The allocations of the last finished invocation. */
+    std::vector<StorageAlloc> plan;
+    /*! \brief The allocations of the running invocation. */
+    std::vector<StorageAlloc> trace;
+    /*!
+     * \brief The sets of regions of the plan, one per device. A set is reused once none of its
+     *  storage is alive, and a second one is allocated while the outputs of an invocation are.
+     */
+    std::vector<std::vector<Storage>> regions;
+    /*! \brief The set of regions of the running invocation, -1 once it leaves the plan. */
+    int active = -1;
+    /*! \brief The number of allocator calls of the last invocation. */
+    int64_t num_allocs = 0;
+  };
+
   /*! \brief The virtual machine's packed function table. */
   std::vector<PackedFunc> packed_funcs_;
   /*! \brief The current stack of call frames. */
@@ -458,6 +503,8 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
    * object to avoid rellocation of constants during inference.
    */
   std::vector<ObjectRef> const_pool_;
+  /*! \brief The storage arena of the invocations. */
+  StorageArena storage_arena_;
 };
 
 }  // namespace vm
@@ -398,8 +398,10 @@ Var EnvThread(String thread_tag);
  * \param buffer The buffer.
  * \param value The value to be stored.
  * \param indices The indices location to be stored.
+ * \param predicate The boolean vector masking the lanes to be stored, or NullOpt for all of them.
  */
-void BufferStore(Buffer buffer, PrimExpr value, Array<PrimExpr> indices);
+void BufferStore(Buffer buffer, PrimExpr value, Array<PrimExpr> indices,
+                 Optional<PrimExpr> predicate = NullOpt);
 
 /*!
  * \brief The prefetch hint for a buffer
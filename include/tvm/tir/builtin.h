@@ -467,6 +467,44 @@ TVM_DLL const Op& tvm_call_cpacked_lowered();
  */
 TVM_DLL const Op& tvm_call_trace_packed_lowered();
 
+/*!
+ * \brief Get an item of an AnyList, an array of TVMRetValue, as an argument of a packed call.
+ *  It can only appear as an argument of tvm_call_packed, tvm_call_cpacked or the anylist_setitem
+ *  calls, which pass the item itself without converting it.
+ *
+ *  TVMRetValue anylist_getitem(AnyList list, int index) {
+ *     return list[index];
+ *  }
+ */
+TVM_DLL const Op& anylist_getitem();
+
+/*!
+ * \brief Reset an item of an AnyList, releasing the object it holds.
+ *
+ *  int anylist_resetitem(AnyList list, int index) {
+ *     list[index] = nullptr;
+ *  }
+ */
+TVM_DLL const Op& anylist_resetitem();
+
+/*!
+ * \brief Call a packed function looked up by name and store its return value in an AnyList.
+ *
+ *  int anylist_setitem_call_packed(AnyList list, int index, name, args...) {
+ *     list[index] = call_packed(name, args...);
+ *  }
+ */
+TVM_DLL const Op& anylist_setitem_call_packed();
+
+/*!
+ * \brief Call a packed C function by its symbol and store its return value in an AnyList.
+ *
+ *  int anylist_setitem_call_cpacked(AnyList list, int index, name, args...) {
+ *     list[index] = call_cpacked(name, args...);
+ *  }
+ */
+TVM_DLL const Op& anylist_setitem_call_cpacked();
+
 /*!
  * \brief See pseudo code
  *
@@ -651,6 +689,66 @@ TVM_DLL const Op& ptx_cp_async();
 TVM_DLL const Op& ptx_commit_group();
 TVM_DLL const Op& ptx_wait_group();
 
+/*!
+ * \brief tvm intrinsic for ptx async bulk copy from global to shared memory, completing the
+ *  transaction bytes of an mbarrier in shared memory.
+ *
+ * void ptx_cp_async_bulk(Var shared_ptr, Expr shared_offset, Var global_ptr, Expr global_offset,
+ *                        Expr bytes, Var barrier_ptr, Expr barrier_offset);
+ *
+ */
+TVM_DLL const Op& ptx_cp_async_bulk();
+
+/*!
+ * \brief tvm intrinsics for the ptx mbarrier in shared memory tracking the async bulk copies.
+ *
+ * void ptx_init_barrier_thread_count(Var barrier_ptr, Expr barrier_offset, Expr thread_count);
+ * void ptx_arrive_barrier_expect_tx(Var barrier_ptr, Expr barrier_offset, Expr byte_count);
+ * void ptx_wait_barrier(Var barrier_ptr, Expr barrier_offset, Expr phase);
+ * void ptx_fence_barrier_init();
+ *
+ */
+TVM_DLL const Op& ptx_init_barrier_thread_count();
+TVM_DLL const Op& ptx_arrive_barrier_expect_tx();
+TVM_DLL const Op& ptx_wait_barrier();
+TVM_DLL const Op& ptx_fence_barrier_init();
+
+/*!
+ * \brief tvm intrinsic for the ptx fence ordering the accesses of the threads to shared memory
+ *  before the accesses of the async proxy, the bulk copies and wgmma.
+ *
+ * void ptx_fence_proxy_async();
+ *
+ */
+TVM_DLL const Op& ptx_fence_proxy_async();
+
+/*!
+ * \brief tvm intrinsic for ptx warpgroup-level tensor core wgmma instructions, with both
+ *  multiplicands in shared memory, laid out in the core matrices of 8 rows of 16 bytes without
+ *  swizzling. The leading and stride byte offsets are the bytes between the core matrices along
+ *  the leading and the strided dims.
+ *
+ *  void ptx_wgmma(StringImm shape, StringImm A_dtype, StringImm B_dtype, StringImm C_dtype,
+ *                 Var multiplicand_a, Expr a_index, Expr a_leading_byte_offset,
+ *                 Expr a_stride_byte_offset,
+ *                 Var multiplicand_b, Expr b_index, Expr b_leading_byte_offset,
+ *                 Expr b_stride_byte_offset,
+ *                 Var accumulator, Expr c_index, Expr scale_d, bool trans_a, bool trans_b);
+ */
+TVM_DLL const Op& ptx_wgmma();
+
+/*!
+ * \brief tvm intrinsics for ptx wgmma fence, commit and wait.
+ *
+ * void ptx_wgmma_fence();
+ * void ptx_wgmma_commit_group();
+ * void ptx_wgmma_wait_group(int num);
+ *
+ */
+TVM_DLL const Op& ptx_wgmma_fence();
+TVM_DLL const Op& ptx_wgmma_commit_group();
+TVM_DLL const Op& ptx_wgmma_wait_group();
+
 /*!
  * \brief tvm intrinsic for storing the result of PTX MMA into a destination pointer.
  *        For example, if each thread in a warp of size 32 has 4 elements from the result of
@@ -694,6 +792,14 @@ TVM_DLL const Op& vectorlow();
  */
 TVM_DLL const Op& vectorcombine();
 
+/*!
+ * \brief The multiple of the minimum width of the scalable vector registers of the target, i.e.
+ *  the vscale of SVE (128-bit granules) or RVV (64-bit granules).
+ *
+ *  int32 vscale()
+ */
+TVM_DLL const Op& vscale();
+
 /*!
  * \brief atomic add instruction, corresponding e.g. to atomicAdd in CUDA
  */
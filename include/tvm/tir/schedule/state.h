@@ -51,6 +51,11 @@ struct BlockInfo {
    * produced by its producers
    */
   bool region_cover{false};
+  /*!
+   * \brief Indicating the subtree of the block is changed by Replace after the info of the blocks
+   * inside was calculated, so that UpdateScopeBlockInfo has to recalculate it
+   */
+  bool subtree_modified{false};
 
   BlockInfo() = default;
 
@@ -146,6 +151,9 @@ class ScheduleStateNode : public Object {
    * \brief Recalculate the BlockInfo recursively under stmt.
    * If stmt is a Block itself, we will not reset its affine binding flag unless it doesn't
    * have block vars, since the affine flag depends on the outer scope of stmt.
+   * The subtree of a block below stmt is not visited again unless it is changed by Replace since
+   * its info was calculated, i.e. the update is limited to the replaced subtrees and their
+   * ancestors.
    */
   TVM_DLL void UpdateScopeBlockInfo(const Stmt& stmt);
   /*!
@@ -374,6 +374,19 @@ TVM_DLL Pass HoistIfThenElse();
  */
 TVM_DLL Pass HoistExpression();
 
+/*!
+ * \brief Hoist the loop-invariant integer arithmetic, such as the index and address
+ * computations, out of the loops, innermost loops first.
+ *
+ * Only pure expressions that cannot trap are hoisted, together with the let
+ * bindings of such values. In GPU kernels, the number of the hoisted values
+ * live at once along a loop nest is bounded by the register budget of the
+ * "tir.LoopInvariantCodeMotion" config.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass LoopInvariantCodeMotion();
+
 /*!
  * \brief Lower cross-thread reduction from thread
  * bindings to intrinsic function calls.
@@ -631,6 +644,23 @@ TVM_DLL Pass UnifiedStaticMemoryPlanner();
  */
 TVM_DLL Pass InjectSoftwarePipeline();
 
+/*!
+ * \brief Annotate the loops staging global memory into shared memory, or into VTCM on Hexagon,
+ *  for InjectSoftwarePipeline, and prefetch the data read by the next iteration of the loops on
+ *  CPU.
+ *
+ *  A loop whose body starts with copies from global memory into staging buffers allocated in the
+ *  body, followed by the computation reading them, gets the copies in stage 0 and the computation
+ *  in the last stage. The number of stages is bounded by the loop extent and by the shared memory
+ *  of a thread block or the "vtcm-capacity" of Hexagon. With "tir.use_async_copy" set, the copies
+ *  run asynchronously: on CUDA from sm_80 in up to 3 stages, and on Hexagon by DMA into ping-pong
+ *  buffers. The pipelines of synchronous copies have 2 stages. The loops already annotated are
+ *  kept.
+ *
+ * \return The IR transform pass.
+ */
+TVM_DLL Pass AutoSoftwarePipeline();
+
 TVM_DLL Pass BindParams(const Array<runtime::NDArray>& constants);
 
 /*!
@@ -690,6 +720,19 @@ TVM_DLL Pass RemoveWeightLayoutRewriteBlock(bool skip_ndarray_rewrite = false);
  */
 TVM_DLL Pass ManifestSharedMemoryLocalStage();
 
+/*!
+ * \brief Pad the rows of the shared memory buffers accessed across the rows by the threads, to
+ *  avoid the bank conflicts.
+ *
+ *  The rows of a shared buffer with at least two dimensions, which the threads index by
+ *  threadIdx or an intrinsic reads as a tile of several rows, get the storage alignment of
+ *  storage_align to be an odd number of accesses apart modulo the 128 bytes of the banks. The
+ *  buffers already aligned are kept. CompactBufferAllocation applies the alignment.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass PadSharedMemory();
+
 /*!
  * \brief Insert intrinsic calls to instrument function and loop level profiling.
  * \return The pass.
@@ -140,26 +140,33 @@ struct BufferInfoAnalysisNode : public Object {
    * for iterative algorithms to know this value to define termination
    * criteria.*/
   Integer memory_pressure;
+  /*! \brief The allocate nodes of the outputs computed in-place to the allocate nodes of the
+   * inputs whose storage they share. These have no BufferInfo objects of their own. */
+  Map<tir::Stmt, tir::Stmt> inplace_aliases;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("buffer_info_stmts", &buffer_info_stmts);
     v->Visit("memory_pressure", &memory_pressure);
+    v->Visit("inplace_aliases", &inplace_aliases);
   }
 
   bool SEqualReduce(const BufferInfoAnalysisNode* other, SEqualReducer equal) const {
     return equal(buffer_info_stmts, other->buffer_info_stmts) &&
-           equal(memory_pressure, other->memory_pressure);
+           equal(memory_pressure, other->memory_pressure) &&
+           equal(inplace_aliases, other->inplace_aliases);
   }
 
   void SHashReduce(SHashReducer hash_reduce) const {
     hash_reduce(buffer_info_stmts);
     hash_reduce(memory_pressure);
+    hash_reduce(inplace_aliases);
   }
 };
 
 class BufferInfoAnalysis : public ObjectRef {
  public:
-  TVM_DLL BufferInfoAnalysis(Map<BufferInfo, tir::Stmt> buffer_info_stmts, Integer memory_pressure);
+  TVM_DLL BufferInfoAnalysis(Map<BufferInfo, tir::Stmt> buffer_info_stmts, Integer memory_pressure,
+                             Map<tir::Stmt, tir::Stmt> inplace_aliases = {});
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(BufferInfoAnalysis, ObjectRef, BufferInfoAnalysisNode);
 };
 
@@ -268,6 +275,15 @@ static constexpr const char* kInputTensorAllocate = "input_tensor";
  */
 static constexpr const char* kOutputTensorAllocate = "output_tensor";
 
+/*!
+ * \brief The PrimFunc attribute to indicate that the operator can be computed in-place.
+ * Each element of an output of such an operator depends only on the element of the same index
+ * of each input of the same dtype and shape, so that the output can share the storage of such an
+ * input that is not used after the call. This needs to be kept in sync with
+ * INPLACE_SAFE_FUNC_ATTR in python/tvm/tir/usmp/utils.py.
+ */
+static constexpr const char* kInplaceSafeFuncAttr = "tir.usmp.inplace_safe";
+
 /*!
  * \brief Calculate the size of the extents in bytes
  *
@@ -71,6 +71,14 @@ class LibInfo {
 
   native int tvmArrayCopyToJArray(long from, byte[] to);
 
+  native int tvmArrayGetDTypeDevice(long handle, int[] dtypeDevice);
+
+  native int tvmArrayFromDLPack(long dltensor, Base.RefLong refHandle);
+
+  native int tvmArrayToDLPack(long handle, Base.RefLong refDLTensor);
+
+  native void tvmDLManagedTensorCallDeleter(long dltensor);
+
   // Device
   native int tvmSynchronize(int deviceType, int deviceId);
 }
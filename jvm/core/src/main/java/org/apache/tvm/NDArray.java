@@ -371,6 +371,44 @@ public class NDArray extends NDArrayBase {
     return device;
   }
 
+  /**
+   * Export the array as a DLPack tensor sharing its memory, without a copy.
+   * The DLManagedTensor holds its own reference to the memory, which its deleter releases.
+   * Its ownership is transferred to the consumer, or it must be released with deleteDLPack.
+   * @return The address of the DLManagedTensor.
+   */
+  public long toDLPack() {
+    Base.RefLong refDLTensor = new Base.RefLong();
+    Base.checkCall(Base._LIB.tvmArrayToDLPack(handle, refDLTensor));
+    return refDLTensor.value;
+  }
+
+  /**
+   * Create an array sharing the memory of a DLPack tensor, without a copy.
+   * @param dltensor The address of the DLManagedTensor, whose ownership is transferred to the
+   *                 array: its deleter is called when the array is released.
+   * @return The array tvm supported.
+   */
+  public static NDArray fromDLPack(long dltensor) {
+    if (dltensor == 0) {
+      throw new IllegalArgumentException("The DLManagedTensor is null");
+    }
+    Base.RefLong refHandle = new Base.RefLong();
+    Base.checkCall(Base._LIB.tvmArrayFromDLPack(dltensor, refHandle));
+    int[] info = new int[5];
+    Base.checkCall(Base._LIB.tvmArrayGetDTypeDevice(refHandle.value, info));
+    return new NDArray(refHandle.value, false, new TVMType(info[0], info[1], info[2]),
+        new Device(info[3], info[4]));
+  }
+
+  /**
+   * Call the deleter of a DLPack tensor no consumer has taken.
+   * @param dltensor The address of the DLManagedTensor.
+   */
+  public static void deleteDLPack(long dltensor) {
+    Base._LIB.tvmDLManagedTensorCallDeleter(dltensor);
+  }
+
   /**
    * Create an empty array given shape, type and device.
    * @param shape The shape of the array.
@@ -62,6 +62,19 @@ public class TVMType {
     this(typeStr, 1);
   }
 
+  /**
+   * TVMType constructor from the fields of a DLDataType.
+   * @param typeCode type code, e.g., TVMType.FLOAT.
+   * @param bits number of bits.
+   * @param lanes NDArray lanes.
+   */
+  TVMType(int typeCode, int bits, int lanes) {
+    this.typeCode = typeCode;
+    this.bits = bits;
+    this.lanes = lanes;
+    numOfBytes = bits / 8;
+  }
+
   @Override public int hashCode() {
     return (typeCode << 16) | (bits  << 8) | lanes;
   }
@@ -70,6 +70,20 @@ public class NDArrayTest {
     ndarray.release();
   }
 
+  @Test
+  public void test_dlpack() {
+    NDArray ndarray = NDArray.empty(new long[]{2, 2}, new TVMType("float32"));
+    NDArray shared = NDArray.fromDLPack(ndarray.toDLPack());
+    assertArrayEquals(new long[]{2, 2}, shared.shape());
+    assertEquals(Device.cpu(0).deviceType, shared.device().deviceType);
+    ndarray.copyFrom(new float[]{1, 2, 3, 4});
+    // The memory is shared, and outlives the exported array
+    ndarray.release();
+    assertArrayEquals(new float[]{1f, 2f, 3f, 4f}, shared.asFloatArray(), 1e-3f);
+    NDArray.deleteDLPack(shared.toDLPack());
+    shared.release();
+  }
+
   @Test
   public void test_from_uint16() {
     NDArray ndarray = NDArray.empty(new long[]{2, 2}, new TVMType("uint16"));
@@ -416,6 +416,39 @@ JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayGetShape(JNIEnv* env,
   return 0;
 }
 
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayGetDTypeDevice(JNIEnv* env, jobject obj,
+                                                                          jlong jhandle,
+                                                                          jintArray jret) {
+  DLTensor* array = reinterpret_cast<DLTensor*>(jhandle);
+  jint info[5] = {array->dtype.code, array->dtype.bits, array->dtype.lanes,
+                  array->device.device_type, array->device.device_id};
+  env->SetIntArrayRegion(jret, 0, 5, info);
+  return 0;
+}
+
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayFromDLPack(JNIEnv* env, jobject obj,
+                                                                      jlong jdltensor,
+                                                                      jobject jret) {
+  TVMArrayHandle out;
+  int ret = TVMArrayFromDLPack(reinterpret_cast<DLManagedTensor*>(jdltensor), &out);
+  setLongField(env, jret, reinterpret_cast<jlong>(out));
+  return ret;
+}
+
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayToDLPack(JNIEnv* env, jobject obj,
+                                                                    jlong jhandle, jobject jret) {
+  DLManagedTensor* out;
+  int ret = TVMArrayToDLPack(reinterpret_cast<TVMArrayHandle>(jhandle), &out);
+  setLongField(env, jret, reinterpret_cast<jlong>(out));
+  return ret;
+}
+
+JNIEXPORT void JNICALL Java_org_apache_tvm_LibInfo_tvmDLManagedTensorCallDeleter(JNIEnv* env,
+                                                                                 jobject obj,
+                                                                                 jlong jdltensor) {
+  TVMDLManagedTensorCallDeleter(reinterpret_cast<DLManagedTensor*>(jdltensor));
+}
+
 JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayCopyFromTo(JNIEnv* env, jobject obj,
                                                                       jlong jfrom, jlong jto) {
   return TVMArrayCopyFromTo(reinterpret_cast<TVMArrayHandle>(jfrom),
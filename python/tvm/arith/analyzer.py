@@ -91,6 +91,7 @@ class Analyzer:
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
         self._can_prove_equal = _mod("can_prove_equal")
+        self._simplify_memo_stats = _mod("simplify_memo_stats")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -270,3 +271,15 @@ class Analyzer:
             Whether we can prove that lhs == rhs
         """
         return self._can_prove_equal(lhs, rhs)
+
+    @property
+    def simplify_memo_stats(self):
+        """The hits and misses of the memo of simplify
+
+        Returns
+        -------
+        stats: Dict[str, int]
+            The number of the simplify calls found in the memo, under "hits", and of those
+            computed anew, under "misses".
+        """
+        return {key: value.value for key, value in self._simplify_memo_stats().items()}
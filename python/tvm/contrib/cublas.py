@@ -84,3 +84,39 @@ def batch_matmul(lhs, rhs, transa=False, transb=False, dtype=None):
         dtype=dtype,
         name="batch_matmul_cublas",
     )
+
+
+def grouped_matmul(lhs, rhs, indptr, transb=False, dtype=None):
+    """Create an extern op that compute the grouped matrix mult of lhs and rhs with cuBLAS, in a
+    single launch when cuBLAS supports grouped GEMMs
+
+    The rows [indptr[g], indptr[g + 1]) of lhs are multiplied by the matrix rhs[g].
+
+    Parameters
+    ----------
+    lhs : Tensor
+        The left matrix operand, of shape (m, k)
+    rhs : Tensor
+        The right matrix operands of the groups, of shape (num_groups, k, n)
+    indptr : Tensor
+        The int64 offsets of the rows of the groups in lhs, of shape (num_groups + 1,)
+    transb : bool
+        Whether transpose the matrices of rhs, given of shape (num_groups, n, k)
+
+    Returns
+    -------
+    C : Tensor
+        The result tensor, of shape (m, n).
+    """
+    m = lhs.shape[0]
+    n = rhs.shape[1] if transb else rhs.shape[2]
+    dtype = dtype if dtype is not None else lhs.dtype
+    return te.extern(
+        (m, n),
+        [lhs, rhs, indptr],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.cublas.grouped_matmul", ins[0], ins[1], ins[2], outs[0], transb
+        ),
+        dtype=dtype,
+        name="grouped_matmul_cublas",
+    )
@@ -52,3 +52,70 @@ def matmul(lhs, rhs, transa=False, transb=False, n=0, m=0, dtype=None):
         dtype=dtype,
         name="C",
     )
+
+
+def fused_matmul(lhs, rhs, bias=None, transa=False, transb=False, activation="none", dtype=None):
+    """Create an extern op that compute activation(lhs rhs + bias) with cuBLASLt, of 2D or
+    batched 3D matrices, with the bias and the activation fused in the epilogue of the matmul.
+
+    The plan of each problem, with the algorithm picked by the cuBLASLt heuristic, is created at
+    its first call and cached, and the workspace is reused across the calls.
+
+    Parameters
+    ----------
+    lhs : Tensor
+        The left matrix operand, of float16 or float32
+    rhs : Tensor
+        The right matrix operand
+    bias : Optional[Tensor]
+        The bias of the columns of the result, added before the activation
+    transa : bool
+        Whether transpose lhs
+    transb : bool
+        Whether transpose rhs
+    activation : str
+        The activation, one of "none", "relu" and "gelu". The GELU of cuBLASLt is the tanh
+        approximation.
+
+    Returns
+    -------
+    C : Tensor
+        The result tensor.
+    """
+    ndim = len(lhs.shape)
+    n = lhs.shape[ndim - 1] if transa else lhs.shape[ndim - 2]
+    m = rhs.shape[ndim - 2] if transb else rhs.shape[ndim - 1]
+    shape = (lhs.shape[0], n, m) if ndim == 3 else (n, m)
+    dtype = dtype if dtype is not None else lhs.dtype
+    if bias is None:
+        return te.extern(
+            shape,
+            [lhs, rhs],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.cublaslt.matmul_activation",
+                ins[0],
+                ins[1],
+                outs[0],
+                transa,
+                transb,
+                activation,
+            ),
+            dtype=dtype,
+            name="C",
+        )
+    return te.extern(
+        shape,
+        [lhs, rhs, bias],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.cublaslt.matmul_bias",
+            ins[0],
+            ins[1],
+            ins[2],
+            outs[0],
+            transa,
+            transb,
+            activation,
+        ),
+        dtype=dtype,
+        name="C",
+    )
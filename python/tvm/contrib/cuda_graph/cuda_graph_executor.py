@@ -18,6 +18,7 @@
 import tvm._ffi
 
 from tvm._ffi.base import string_types
+from tvm._ffi.runtime_ctypes import Device, RPC_SESS_MASK
 from tvm.contrib import graph_executor
 
 
@@ -35,7 +36,7 @@ def create(graph_json_str, libmod, device):
         The module of the corresponding function
 
     device : Device
-        The device to deploy the module, only supports CUDA GPU
+        The device to deploy the module, only supports CUDA GPU, or ROCm GPU with HIP graphs
 
     Returns
     -------
@@ -51,10 +52,14 @@ def create(graph_json_str, libmod, device):
     assert isinstance(graph_json_str, string_types)
     try:
         dev, num_rpc_dev, device_type_id = graph_executor.get_device(libmod, device)
+        if dev[0].device_type % RPC_SESS_MASK == Device.kDLROCM:
+            create_name = "tvm.graph_executor_hip_graph.create"
+        else:
+            create_name = "tvm.graph_executor_cuda_graph.create"
         if num_rpc_dev == len(dev):
-            fcreate = dev[0]._rpc_sess.get_function("tvm.graph_executor_cuda_graph.create")
+            fcreate = dev[0]._rpc_sess.get_function(create_name)
         else:
-            fcreate = tvm._ffi.get_global_func("tvm.graph_executor_cuda_graph.create")
+            fcreate = tvm._ffi.get_global_func(create_name)
     except ValueError:
         raise ValueError(
             "To enable CUDA graph support (experimental), please set "
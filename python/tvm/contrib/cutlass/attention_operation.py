@@ -0,0 +1,188 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Generator for the CUTLASS fused multi-head attention kernels."""
+import math
+
+from .library import substitute_template
+
+# The custom mask types of AttentionKernel.
+CausalMaskType = {"": 0, "TopLeft": 1, "BottomRight": 2}
+
+ATTENTION_TEMPLATE = """
+void ${symbol}_(${args}) {
+  using T = ${data_type};
+  using Attention = AttentionKernel<T,
+                                    /*ArchTag=*/${arch},
+                                    /*is_aligned=*/${is_aligned},
+                                    /*queries_per_block=*/${queries_per_block},
+                                    /*keys_per_block=*/${keys_per_block},
+                                    /*kMaxK=*/${max_k},
+                                    /*supports_dropout=*/false,
+                                    /*supports_bias=*/${supports_bias}>;
+
+  typename Attention::Params p;
+  p.query_ptr = reinterpret_cast<T*>(query->data);
+  p.key_ptr = reinterpret_cast<T*>(key->data);
+  p.value_ptr = reinterpret_cast<T*>(value->data);
+  p.output_ptr = reinterpret_cast<T*>(out0->data);
+  p.logsumexp_ptr = nullptr;
+  p.output_accum_ptr = nullptr;
+  uint64_t accum_bytes = uint64_t(${num_batches}) * ${num_queries} * ${num_heads} *
+                         ${head_dim_value} * sizeof(typename Attention::output_accum_t);
+  if (Attention::kNeedsOutputAccumulatorBuffer) {
+    p.output_accum_ptr = static_cast<typename Attention::output_accum_t*>(
+        TVMBackendAllocWorkspace(kDLCUDA, out0->device.device_id, accum_bytes, kDLFloat, 32));
+  }
+
+  p.num_batches = ${num_batches};
+  p.num_heads = ${num_heads};
+  p.head_dim = ${head_dim};
+  p.head_dim_value = ${head_dim_value};
+  p.num_queries = ${num_queries};
+  p.num_keys = ${num_keys};
+  p.scale = ${scale};
+  p.custom_mask_type = ${custom_mask_type};
+
+  // The tensors are of layout (batch, seq_len, num_heads, head_dim).
+  p.q_strideH = ${head_dim};
+  p.k_strideH = ${head_dim};
+  p.v_strideH = ${head_dim_value};
+  p.q_strideM = p.q_strideH * ${num_heads};
+  p.k_strideM = p.k_strideH * ${num_heads};
+  p.v_strideM = p.v_strideH * ${num_heads};
+  p.o_strideM = ${head_dim_value} * ${num_heads};
+  p.q_strideB = int64_t(p.q_strideM) * ${num_queries};
+  p.k_strideB = int64_t(p.k_strideM) * ${num_keys};
+  p.v_strideB = int64_t(p.v_strideM) * ${num_keys};
+${bias_params}
+  constexpr auto kernel_fn = attention_kernel_batched_impl<Attention>;
+  int smem_bytes = sizeof(typename Attention::SharedStorage);
+  if (smem_bytes > 0xc000) {
+    static bool once = [&]() {
+      cudaFuncSetAttribute(kernel_fn, cudaFuncAttributeMaxDynamicSharedMemorySize, smem_bytes);
+      return true;
+    }();
+  }
+  CHECK(Attention::check_supported(p)) << "${symbol}: unsupported attention parameters";
+  static const tvm::runtime::PackedFunc* get_stream =
+      tvm::runtime::Registry::Get("runtime.get_cuda_stream");
+  CHECK(get_stream != nullptr) << "runtime.get_cuda_stream is not registered";
+  cudaStream_t stream = static_cast<cudaStream_t>((*get_stream)().operator void*());
+  kernel_fn<<<p.getBlocksGrid(), p.getThreadsGrid(), smem_bytes, stream>>>(p);
+  if (p.output_accum_ptr != nullptr) {
+    TVMBackendFreeWorkspace(kDLCUDA, out0->device.device_id, p.output_accum_ptr);
+  }
+}
+
+TVM_DLL_EXPORT_TYPED_FUNC(${symbol}, ${symbol}_);
+"""
+
+BIAS_TEMPLATE = """
+  p.attn_bias_ptr = reinterpret_cast<T*>(bias->data);
+  p.bias_strideM = ${bias_stride_m};
+  p.bias_strideH = ${bias_stride_h};
+  p.bias_strideB = ${bias_stride_b};
+"""
+
+ATTENTION_PREAMBLE = """
+#include <cuda_fp16.h>
+#include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+
+#include "kernel_forward.h"
+"""
+
+
+def _arch_tag(sm):
+    for arch in [80, 75, 70]:
+        if sm >= arch:
+            return "cutlass::arch::Sm%d" % arch
+    return "cutlass::arch::Sm50"
+
+
+def instantiate_attention_template(attrs):
+    """Instantiate the CUDA source of a packed function computing an attention with the
+    CUTLASS fused multi-head attention kernel, the FlashAttention-style kernel of the
+    fused_multi_head_attention example of CUTLASS.
+
+    Parameters
+    ----------
+    attrs : Dict[str, Any]
+        symbol, data_type ("float16" or "float32"), sm, num_batches, num_queries, num_keys,
+        num_heads, head_dim, head_dim_value, scale (None for 1 / sqrt(head_dim)), causal_mask,
+        and bias_shape (None without bias).
+
+    Returns
+    -------
+    code : str
+        The source of the function, following ATTENTION_PREAMBLE.
+    """
+    head_dim, head_dim_value = attrs["head_dim"], attrs["head_dim_value"]
+    # The vectorized loads need rows of 128 bits.
+    alignment = 8 if attrs["data_type"] == "float16" else 4
+    is_aligned = head_dim % alignment == 0 and head_dim_value % alignment == 0
+    scale = attrs["scale"] if attrs["scale"] is not None else 1 / math.sqrt(head_dim)
+    args = ["DLTensor* query", "DLTensor* key", "DLTensor* value"]
+    bias_params = ""
+    bias_shape = attrs["bias_shape"]
+    if bias_shape is not None:
+        args.append("DLTensor* bias")
+        # The broadcast dimensions of the bias have a stride of 0.
+        strides = [0] * 4
+        stride = 1
+        for i in reversed(range(4)):
+            strides[i] = 0 if bias_shape[i] == 1 else stride
+            stride *= bias_shape[i]
+        is_aligned = is_aligned and attrs["num_keys"] % alignment == 0
+        bias_params = substitute_template(
+            BIAS_TEMPLATE,
+            {
+                "bias_stride_b": str(strides[0]),
+                "bias_stride_h": str(strides[1]),
+                "bias_stride_m": str(strides[2]),
+            },
+        )
+    args.append("DLTensor* out0")
+    # The small heads run with square tiles, and the large heads with more keys per block.
+    queries_per_block, keys_per_block = (64, 64) if head_dim <= 64 else (32, 128)
+    values = {
+        "symbol": attrs["symbol"],
+        "args": ", ".join(args),
+        "data_type": "cutlass::half_t" if attrs["data_type"] == "float16" else "float",
+        "arch": _arch_tag(attrs["sm"]),
+        "is_aligned": "true" if is_aligned else "false",
+        "queries_per_block": str(queries_per_block),
+        "keys_per_block": str(keys_per_block),
+        "max_k": str(max(head_dim, head_dim_value)),
+        "supports_bias": "true" if bias_shape is not None else "false",
+        "num_batches": str(attrs["num_batches"]),
+        "num_queries": str(attrs["num_queries"]),
+        "num_keys": str(attrs["num_keys"]),
+        "num_heads": str(attrs["num_heads"]),
+        "head_dim": str(head_dim),
+        "head_dim_value": str(head_dim_value),
+        "scale": repr(float(scale)) + "f",
+        "custom_mask_type": str(CausalMaskType[attrs["causal_mask"]]),
+        "bias_params": bias_params,
+    }
+    return substitute_template(ATTENTION_TEMPLATE, values)
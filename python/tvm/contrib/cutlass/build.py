@@ -26,6 +26,7 @@ from tvm._ffi.registry import register_func
 from .gen_gemm import CutlassGemmProfiler
 from .gen_conv2d import CutlassConv2DProfiler
 from .library import ConvKind
+from .attention_operation import ATTENTION_PREAMBLE, instantiate_attention_template
 
 logger = logging.getLogger("cutlass")
 
@@ -311,6 +312,7 @@ def tune_cutlass_kernels(
     find_first_valid=False,
     use_multiprocessing=False,
     tmp_dir="./tmp",
+    profile_db_path=None,
 ):
     """Given a module partitioned for CUTLASS offloading, profile each workload to select which
     kernels to emit.
@@ -349,6 +351,10 @@ def tune_cutlass_kernels(
     tmp_dir : string, optional
         A temporary directory where intermediate compiled artifacts will be stored.
 
+    profile_db_path : string, optional
+        A JSON file recording the best kernel of each profiled workload, reused across builds.
+        Defaults to the TVM_CUTLASS_PROFILE_DB environment variable, if set.
+
     Returns
     -------
     mod : IRModule
@@ -357,8 +363,8 @@ def tune_cutlass_kernels(
     num_cutlass_partition : int
         The number of partitioned functions created for CUTLASS.
     """
-    gemm_profiler = CutlassGemmProfiler(sm, _get_cutlass_path(), tmp_dir)
-    conv2d_profiler = CutlassConv2DProfiler(sm, _get_cutlass_path(), tmp_dir)
+    gemm_profiler = CutlassGemmProfiler(sm, _get_cutlass_path(), tmp_dir, profile_db_path)
+    conv2d_profiler = CutlassConv2DProfiler(sm, _get_cutlass_path(), tmp_dir, profile_db_path)
     num_cutlass_partition = 0
     for var in mod.get_global_vars():
         fun_name = var.name_hint
@@ -639,3 +645,70 @@ def finalize_modules_vm(vm_exec, lib_path="compile.so", vmcode_path="vmcode.ro",
         fo.write(code)
     lib = tvm.runtime.load_module(lib_path)
     return tvm.runtime.vm.Executable.load_exec(code, lib)
+
+
+def _get_attention_call(func):
+    """Return the relax.nn.attention call of a Relax function offloaded to CUTLASS."""
+    from tvm import relax  # pylint: disable=import-outside-toplevel
+
+    attention_op = tvm.ir.Op.get("relax.nn.attention")
+    calls = [
+        binding.value
+        for block in func.body.blocks
+        for binding in block.bindings
+        if isinstance(binding.value, relax.Call) and binding.value.op == attention_op
+    ]
+    if len(calls) != 1 or list(calls[0].args) != list(func.params):
+        raise ValueError(
+            "The CUTLASS codegen of Relax expects a function calling relax.nn.attention on its "
+            "parameters, but gets %s" % func
+        )
+    return calls[0]
+
+
+@register_func("relax.ext.cutlass")
+def relax_compile_for_cutlass(func):
+    """Compile a Relax function with Codegen="cutlass", which calls relax.nn.attention on static
+    shapes, into a static library implementing the function with the CUTLASS fused multi-head
+    attention kernel. The options of the compilation are those of the current "cutlass" target,
+    if any. An export_library step will be required on the final runtime module to link the
+    library into the overall .so library."""
+    cutlass_target = tvm.target.Target.current(allow_none=True)
+    if cutlass_target is None or cutlass_target.kind.name != "cutlass":
+        cutlass_target = tvm.target.Target("cutlass")
+    compile_config = {
+        key: cutlass_target.attrs.get(key) for key in ["sm", "threads", "use_fast_math"]
+    }
+    tmp_dir = cutlass_target.attrs.get("tmp_dir")
+
+    call = _get_attention_call(func)
+    shapes = [[int(dim) for dim in arg.shape_] for arg in call.args]
+    query_shape, key_shape, value_shape = shapes[:3]
+    symbol = str(func.attrs["global_symbol"])
+    code = instantiate_attention_template(
+        {
+            "symbol": symbol,
+            "data_type": call.args[0].checked_type.dtype,
+            "sm": int(compile_config["sm"]),
+            "num_batches": query_shape[0],
+            "num_queries": query_shape[1],
+            "num_heads": query_shape[2],
+            "head_dim": query_shape[3],
+            "num_keys": key_shape[1],
+            "head_dim_value": value_shape[3],
+            "scale": call.attrs.scale.value if call.attrs.scale is not None else None,
+            "causal_mask": str(call.attrs.causal_mask),
+            "bias_shape": shapes[3] if len(shapes) == 4 else None,
+        }
+    )
+    create_c_source_module = tvm._ffi.get_global_func("runtime.CSourceModuleCreate")
+    c_module = create_c_source_module(ATTENTION_PREAMBLE + code, "cu", [symbol], [])
+    compile_options = _get_cutlass_compile_options(**compile_config)
+    compile_options["options"].append(
+        "-I" + os.path.join(_get_cutlass_path(), "examples/41_fused_multi_head_attention")
+    )
+    os.makedirs(tmp_dir, exist_ok=True)
+    lib_path = os.path.join(tmp_dir, symbol + ".o")
+    logger.info("Compiling the CUTLASS attention %s", symbol)
+    c_module.export_library(lib_path, workspace_dir=tmp_dir, **compile_options)
+    return tvm.runtime.load_static_library(lib_path, [symbol])
@@ -20,7 +20,13 @@ from functools import partial
 from .conv2d_operation import Conv2dOperation, EmitConv2dInstance
 from .gen_gemm import CutlassGemmProfiler
 from .conv2d_profiler import Conv2dProfilerEmitter
-from .gen_tensor_op import ProfilerEngine, GENERATOR_FUNC_TABLE, EPILOGUE_MAP
+from .gen_tensor_op import (
+    ProfileDatabase,
+    ProfilerEngine,
+    GENERATOR_FUNC_TABLE,
+    EPILOGUE_MAP,
+    lookup_profiled_op,
+)
 from .library import (
     DataType,
     EpilogueFunctor,
@@ -177,12 +183,14 @@ def enumerate_conv2d_operators(
 class CutlassConv2DProfiler:
     """Profile all candidate kernels and select the best one."""
 
-    def __init__(self, sm, cutlass_path, binary_path):
-        self.gemm_profiler = CutlassGemmProfiler(sm, cutlass_path, binary_path)
+    def __init__(self, sm, cutlass_path, binary_path, profile_db_path=None):
+        self.gemm_profiler = CutlassGemmProfiler(sm, cutlass_path, binary_path, profile_db_path)
         self.sm = sm
         assert sm in GENERATOR_FUNC_TABLE, "sm%d not supported yet." % sm
         self.engine = ProfilerEngine(sm, cutlass_path, binary_path)
         self.cache = {}
+        # The best kernels profiled by the previous builds, see ProfileDatabase.open.
+        self.database = ProfileDatabase.open(profile_db_path)
 
     def get_default(
         self,
@@ -263,8 +271,17 @@ class CutlassConv2DProfiler:
             dilation[1],
         )
 
-        if workload in self.cache:
-            return self.cache[workload]
+        cache_key = workload + (
+            out_dtype,
+            data_dtype,
+            weight_dtype,
+            use_3xtf32,
+            conv_kind,
+            stride_support,
+            split_k_slices,
+        )
+        if cache_key in self.cache:
+            return self.cache[cache_key]
 
         ops = GENERATOR_FUNC_TABLE[self.sm](
             out_dtype,
@@ -281,6 +298,12 @@ class CutlassConv2DProfiler:
             accumlator_dtype="float32" if conv_kind == ConvKind.Wgrad else out_dtype,
         )
 
+        db_key = ProfileDatabase.make_key("conv2d", self.sm, *cache_key)
+        op = lookup_profiled_op(self.database, db_key, ops)
+        if op is not None:
+            self.cache[cache_key] = op
+            return op
+
         if not find_first_valid:
             self.engine.compile_all(ops, use_multiprocessing)
 
@@ -293,11 +316,13 @@ class CutlassConv2DProfiler:
             out = self.engine.evaluate(op, args.split(" "))
             op["runtime"] = out
             if out < float("inf") and find_first_valid:
-                self.cache[workload] = op
+                self.cache[cache_key] = op
                 return op
 
         op = min(ops, key=lambda i: i["runtime"])
-        self.cache[workload] = op
+        self.cache[cache_key] = op
+        if self.database is not None:
+            self.database.put(db_key, op["name"], op["runtime"])
         return op
 
     def profile(
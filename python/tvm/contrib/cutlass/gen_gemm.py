@@ -18,7 +18,13 @@
 """GEMM kernel generator and profiler for CUTLASS."""
 from .gemm_operation import GemmOperation, EmitGemmInstance
 from .gemm_profiler import GemmProfilerEmitter
-from .gen_tensor_op import ProfilerEngine, GENERATOR_FUNC_TABLE, EPILOGUE_MAP
+from .gen_tensor_op import (
+    ProfileDatabase,
+    ProfilerEngine,
+    GENERATOR_FUNC_TABLE,
+    EPILOGUE_MAP,
+    lookup_profiled_op,
+)
 from .library import (
     DataType,
     EpilogueFunctor,
@@ -160,11 +166,13 @@ DEFAULT_KERNELS = {
 class CutlassGemmProfiler:
     """Profile all candidate kernels and select the best one."""
 
-    def __init__(self, sm, cutlass_path, binary_path):
+    def __init__(self, sm, cutlass_path, binary_path, profile_db_path=None):
         assert sm in GENERATOR_FUNC_TABLE and sm in DEFAULT_KERNELS, "sm%d not supported yet." % sm
         self.engine = ProfilerEngine(sm, cutlass_path, binary_path)
         self.sm = sm
         self.cache = {}
+        # The best kernels profiled by the previous builds, see ProfileDatabase.open.
+        self.database = ProfileDatabase.open(profile_db_path)
 
     def get_default(
         self, op_type, out_dtype, arg0_dtype, arg1_dtype, use_3xtf32=True, batched=False
@@ -225,9 +233,20 @@ class CutlassGemmProfiler:
         Profile and select the best kernel from candidate kernels.
         See the documentation for the profile method below.
         """
-        if (M, N, K) in self.cache:
-            op = self.cache[(M, N, K)]
-            return op
+        workload = (
+            M,
+            N,
+            K,
+            out_dtype,
+            arg0_dtype,
+            arg1_dtype,
+            out_layout,
+            arg0_layout,
+            arg1_layout,
+            use_3xtf32,
+        )
+        if workload in self.cache:
+            return self.cache[workload]
 
         # TODO(masahi): CUTLASS alignment check on gemm kernels is too restrictive.
         # See https://github.com/NVIDIA/cutlass/issues/362.
@@ -248,6 +267,12 @@ class CutlassGemmProfiler:
             accumlator_dtype=out_dtype,
         )
 
+        db_key = ProfileDatabase.make_key("gemm", self.sm, *workload)
+        op = lookup_profiled_op(self.database, db_key, ops)
+        if op is not None:
+            self.cache[workload] = op
+            return op
+
         if not find_first_valid:
             self.engine.compile_all(ops, use_multiprocessing)
 
@@ -255,11 +280,13 @@ class CutlassGemmProfiler:
             out = self.engine.evaluate(op, [M, N, K])
             op["runtime"] = out
             if out < float("inf") and find_first_valid:
-                self.cache[(M, N, K)] = op
+                self.cache[workload] = op
                 return op
 
         op = min(ops, key=lambda i: i["runtime"])
-        self.cache[(M, N, K)] = op
+        self.cache[workload] = op
+        if self.database is not None:
+            self.database.put(db_key, op["name"], op["runtime"])
         return op
 
     def profile(
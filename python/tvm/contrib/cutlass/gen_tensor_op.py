@@ -16,11 +16,14 @@
 # under the License.
 # pylint: disable=invalid-name
 """Common functions and classes for CUTLASS GEMM and Conv2d geneator."""
+import json
 import logging
 import os
 import tempfile
+import threading
 import subprocess
 import multiprocessing
+from concurrent.futures import ThreadPoolExecutor
 from .library import (
     MathInstruction,
     DataType,
@@ -321,6 +324,85 @@ EPILOGUE_MAP = {
 }
 
 
+class ProfileDatabase:
+    """A JSON file of the best kernels of the profiled workloads, shared by the builds.
+
+    The keys describe the workload, the data types, the layouts and the architecture, so that a
+    kernel is only profiled once per problem. The file is merged with the records of the other
+    processes and replaced atomically on each update.
+    """
+
+    _databases = {}
+    _databases_lock = threading.Lock()
+
+    def __init__(self, path):
+        self.path = path
+        self.lock = threading.Lock()
+        self.records = self._load()
+
+    @staticmethod
+    def open(path):
+        """Return the database of path, or of the TVM_CUTLASS_PROFILE_DB environment variable if
+        path is None, or None if neither is set."""
+        path = path or os.environ.get("TVM_CUTLASS_PROFILE_DB")
+        if not path:
+            return None
+        path = os.path.abspath(path)
+        with ProfileDatabase._databases_lock:
+            if path not in ProfileDatabase._databases:
+                ProfileDatabase._databases[path] = ProfileDatabase(path)
+            return ProfileDatabase._databases[path]
+
+    @staticmethod
+    def make_key(kind, sm, *workload):
+        """Return the key of a workload of kind on sm."""
+        return "|".join([kind, "sm%d" % sm] + [str(item) for item in workload])
+
+    def _load(self):
+        if not os.path.exists(self.path):
+            return {}
+        try:
+            with open(self.path, "r") as f:
+                return json.load(f)
+        except (OSError, ValueError) as err:
+            logger.warning("Ignoring unreadable CUTLASS profile database %s: %s", self.path, err)
+            return {}
+
+    def get(self, key):
+        """Return the record of the best kernel of key, as a dict with the name and the runtime
+        of the kernel, or None."""
+        with self.lock:
+            return self.records.get(key)
+
+    def put(self, key, name, runtime):
+        """Record the best kernel of key."""
+        with self.lock:
+            records = self._load()
+            records.update(self.records)
+            records[key] = {"name": name, "runtime": runtime}
+            self.records = records
+            directory = os.path.dirname(self.path)
+            os.makedirs(directory, exist_ok=True)
+            fd, tmp_path = tempfile.mkstemp(dir=directory, suffix=".tmp")
+            with os.fdopen(fd, "w") as f:
+                json.dump(records, f, indent=2, sort_keys=True)
+            os.replace(tmp_path, self.path)
+
+
+def lookup_profiled_op(database, key, ops):
+    """Return the op of ops recorded as the best kernel of key in database, or None."""
+    record = database.get(key) if database is not None else None
+    if record is None:
+        return None
+    for op in ops:
+        if op["name"] == record["name"]:
+            op["runtime"] = record["runtime"]
+            logger.info("Reusing the profiled kernel %s for %s", op["name"], key)
+            return op
+    # The candidates differ from the profiled ones, e.g. with profile_all_alignments.
+    return None
+
+
 class ProfilerEngine:
     """Compile and run a given profiler executable."""
 
@@ -348,17 +430,19 @@ class ProfilerEngine:
         fi.close()
         cmd = self.cmd.format(cflags=self.cflags, src=fi.name, output=opath)
         logger.info("invoking compilation %s", cmd)
-        os.system(cmd)
+        subprocess.run(cmd, shell=True, check=False)
         os.unlink(fi.name)
 
     def compile_all(self, ops, use_multiprocessing=False):
-        """Compile all profiler executables."""
+        """Compile all profiler executables in parallel. The compilations run in nvcc processes
+        launched by a pool of threads, or by a pool of processes if use_multiprocessing."""
         if use_multiprocessing:
             pool = multiprocessing.Pool(multiprocessing.cpu_count())
             pool.map(self._compile, ops)
         else:
-            for op in ops:
-                self._compile(op)
+            os.makedirs(self.binary_prefix, exist_ok=True)
+            with ThreadPoolExecutor(os.cpu_count()) as executor:
+                list(executor.map(self._compile, ops))
 
     def evaluate(self, op, args):
         """Run the profiler executable corresponding to op_name with args."""
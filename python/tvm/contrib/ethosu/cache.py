@@ -0,0 +1,115 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A content-addressed cache of the Arm(R) Ethos(TM)-U NPU compilation artifacts which are costly
+to compute, e.g. the encoded weights and the cascader plans, so that unchanged subgraphs reuse
+them across builds.
+
+The artifacts are kept in memory for the process, and also written to the `cache_dir` compiler
+option when it is set, so that they are reused across processes too.
+"""
+import collections
+import hashlib
+import os
+import threading
+from typing import Optional
+
+import tvm
+
+
+def get_cache_dir() -> str:
+    """The cache directory given in the compiler options, or an empty string if there is none."""
+    options = tvm.transform.PassContext.current().config.get("relay.ext.ethos-u.options", None)
+    return str(options.cache_dir) if options else ""
+
+
+class ContentCache:
+    """A cache of bytes keyed by the hash of the content they are computed from.
+
+    Parameters
+    ----------
+    name : str
+        The name of the cache, which is the subdirectory of its entries on disk.
+    max_bytes : int
+        The maximum total size of the entries kept in memory, the least recently used ones are
+        evicted beyond it.
+    """
+
+    def __init__(self, name: str, max_bytes: int = 256 * 1024 * 1024):
+        self.name = name
+        self.max_bytes = max_bytes
+        self._entries = collections.OrderedDict()
+        self._num_bytes = 0
+        self._lock = threading.Lock()
+
+    @staticmethod
+    def key(*parts) -> str:
+        """The key of the content made of the given parts, which are bytes or are hashed as
+        their string representation."""
+        hasher = hashlib.sha256()
+        for part in parts:
+            data = part if isinstance(part, (bytes, bytearray)) else repr(part).encode("utf-8")
+            # Hash the length first, so that the boundaries of the parts are part of the key
+            hasher.update(len(data).to_bytes(8, "little"))
+            hasher.update(data)
+        return hasher.hexdigest()
+
+    def _path(self, key: str) -> Optional[str]:
+        cache_dir = get_cache_dir()
+        return os.path.join(cache_dir, self.name, key) if cache_dir else None
+
+    def get(self, key: str) -> Optional[bytes]:
+        """Get the cached bytes of a key, or None on a miss."""
+        with self._lock:
+            if key in self._entries:
+                self._entries.move_to_end(key)
+                return self._entries[key]
+        path = self._path(key)
+        if path is None or not os.path.isfile(path):
+            return None
+        with open(path, "rb") as entry_file:
+            value = entry_file.read()
+        self._insert(key, value)
+        return value
+
+    def put(self, key: str, value: bytes) -> None:
+        """Cache the bytes of a key."""
+        value = bytes(value)
+        self._insert(key, value)
+        path = self._path(key)
+        if path is not None:
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+            # Write to a temporary file first, so that concurrent builds never read a partial entry
+            tmp_path = f"{path}.{os.getpid()}.{threading.get_ident()}.tmp"
+            with open(tmp_path, "wb") as entry_file:
+                entry_file.write(value)
+            os.replace(tmp_path, path)
+
+    def clear(self) -> None:
+        """Clear the entries kept in memory."""
+        with self._lock:
+            self._entries.clear()
+            self._num_bytes = 0
+
+    def _insert(self, key: str, value: bytes) -> None:
+        with self._lock:
+            if key in self._entries:
+                self._num_bytes -= len(self._entries.pop(key))
+            self._entries[key] = value
+            self._num_bytes += len(value)
+            while self._num_bytes > self.max_bytes and len(self._entries) > 1:
+                _, evicted = self._entries.popitem(last=False)
+                self._num_bytes -= len(evicted)
@@ -36,6 +36,6 @@ from .parts import InlinePart, EthosuPart
 from .device_config import EthosuDeviceConfig
 from .tensor_config import TensorConfigState, MemoryRegion, TensorConfig
 from .plan import Plan
-from .scheduler import apply_proposal, cascade, extract_memory_info
+from .scheduler import apply_proposal, cascade, extract_memory_info, search_plans
 from .logging import Logging
 from .cascader_options import CascaderOptions
@@ -16,8 +16,11 @@
 # under the License.
 # pylint: disable=invalid-name
 """Scheduler for cascader which converts Proposals into Schedules."""
-from typing import Tuple, List, Dict, DefaultDict
+from typing import Any, Callable, Tuple, List, Dict, DefaultDict, Optional
 from collections import defaultdict
+from concurrent.futures import ThreadPoolExecutor
+import json
+import os
 import time
 import numpy as np
 
@@ -25,6 +28,7 @@ import tvm
 from tvm import te
 from tvm import tir
 from tvm import PoolInfo
+from ..cache import ContentCache
 from .cascader_options import CascaderOptions
 from .graph import CascaderGraph, Part, Tensor, TESubgraph
 from .parts import EthosuPart
@@ -36,6 +40,32 @@ from .graph import create_cascader_graph
 from .device_config import EthosuDeviceConfig
 from .logging import Logging
 
+# The scheduling decisions of the chosen Proposals, keyed by the graph and the cascader options
+PLAN_CACHE = ContentCache("cascader_plans")
+
+_REGION_FIELDS = (
+    "name",
+    "size",
+    "read_bandwidth",
+    "write_bandwidth",
+    "read_latency",
+    "write_latency",
+    "burst_length",
+)
+_OPTIONS_FIELDS = (
+    "max_proposals",
+    "stripe_factors",
+    "max_plan_size",
+    "max_open_plans",
+    "max_closed_plans",
+    "always_copy_size",
+    "disable_pareto_plans",
+    "disable_pareto_proposals",
+    "enable_multi_dimensional_striping",
+    "disable_block_culling",
+    "enable_striping",
+)
+
 
 def tile_nd(
     sch: te.Schedule, tensor: te.Tensor, tile: Tuple[int, ...]
@@ -117,20 +147,15 @@ def update_readers(part: Part, readers: DefaultDict[te.Tensor, List[te.Tensor]])
     _visit(part.subgraph.output_tensor)
 
 
-def apply_proposal(proposal: Proposal, sch: te.Schedule) -> None:
-    """Apply a Proposal to a Schedule, converting all the Plans into TE scheduling instructions.
-
-    Note that the Schedule is mutated in-place.
-
-    Parameters
-    ----------
-    proposal : Proposal
-        The Proposal to apply to the Schedule.
-    sch : te.Schedule
-        The Schedule to apply to Proposal to.
+def _record_proposal(proposal: Proposal, part_id: Callable[[Part], Any]) -> List[Dict[str, Any]]:
+    """Record the scheduling decisions of a Proposal, with the Parts given by `part_id`.
 
+    The record is applied by `_apply_record`. With indices of the Parts in the CascaderGraph, it
+    is plain data that is cached for the graphs that are the same.
     """
+    record = []
     for plan in proposal.plans:
+        block_configs = []
         for part in plan.part_group:
             if isinstance(part, EthosuPart):
                 tensor_config = plan.tensor_configs[part.output_tensor]
@@ -140,7 +165,6 @@ def apply_proposal(proposal: Proposal, sch: te.Schedule) -> None:
                 compute_cycles = part.get_performance_info(
                     stripe_config, buffer_mode
                 ).compute_cycles
-                iv = part.subgraph.output_tensor.op.axis[0]
                 block_shape = block_config.output_shape
                 if len(block_shape) == 4:
                     height, width, depth = block_shape[1:]
@@ -148,43 +172,65 @@ def apply_proposal(proposal: Proposal, sch: te.Schedule) -> None:
                     height = block_shape[1]
                     width = block_shape[3]
                     depth = block_shape[2] * block_shape[4]
-                sch[part.subgraph.output_tensor].pragma(iv, "block_config_height", height)
-                sch[part.subgraph.output_tensor].pragma(iv, "block_config_width", width)
-                sch[part.subgraph.output_tensor].pragma(iv, "block_config_depth", depth)
-
-                # Attach AttrStmt directly to npu op so it isn't removed by ReplaceOperators
-                npu_op = part.subgraph.output_tensor.op.input_tensors[0].op.input_tensors[0]
-                # Force the pragma to interpret the compute cycles as an int64 value
-                compute_cycles_int64_cast = tvm.tir.IntImm("int64", compute_cycles)
-                sch[npu_op].pragma(
-                    npu_op.op.axis[0], "compute_cycles_hint", compute_cycles_int64_cast
+                block_configs.append(
+                    [part_id(part), int(height), int(width), int(depth), int(compute_cycles)]
                 )
 
+        stripe = None
         output_tensor_config = plan.output_config
-        output_tensor = output_tensor_config.tensor
-        output_part = output_tensor.producers[0]
-        if output_part.in_line:
+        output_part = output_tensor_config.tensor.producers[0]
+        if not output_part.in_line:
+            stripe_config = output_tensor_config.stripe_configs[0]
+            copies = []
+            for part in plan.part_group:
+                for i, input_tensor in enumerate(part.input_tensors):
+                    tensor_config = plan.tensor_configs[input_tensor]
+                    if tensor_config.home_region != tensor_config.copy_region:
+                        compute_cycles_hint, _ = get_copy_cycles_hint(tensor_config)
+                        copies.append([part_id(part), i, int(compute_cycles_hint)])
+            stripe = {
+                "part": part_id(output_part),
+                "shape": [int(x) for x in stripe_config.shape],
+                "group": [part_id(part) for part in plan.part_group],
+                "copies": copies,
+            }
+        record.append({"block_configs": block_configs, "stripe": stripe})
+
+    return record
+
+
+def _apply_record(
+    record: List[Dict[str, Any]], get_part: Callable[[Any], Part], sch: te.Schedule
+) -> None:
+    """Apply the scheduling decisions recorded by `_record_proposal` to a Schedule."""
+    for plan in record:
+        for part_id, height, width, depth, compute_cycles in plan["block_configs"]:
+            part = get_part(part_id)
+            iv = part.subgraph.output_tensor.op.axis[0]
+            sch[part.subgraph.output_tensor].pragma(iv, "block_config_height", height)
+            sch[part.subgraph.output_tensor].pragma(iv, "block_config_width", width)
+            sch[part.subgraph.output_tensor].pragma(iv, "block_config_depth", depth)
+
+            # Attach AttrStmt directly to npu op so it isn't removed by ReplaceOperators
+            npu_op = part.subgraph.output_tensor.op.input_tensors[0].op.input_tensors[0]
+            # Force the pragma to interpret the compute cycles as an int64 value
+            compute_cycles_int64_cast = tvm.tir.IntImm("int64", compute_cycles)
+            sch[npu_op].pragma(npu_op.op.axis[0], "compute_cycles_hint", compute_cycles_int64_cast)
+
+        stripe = plan["stripe"]
+        if stripe is None:
             continue
-        stripe_config = output_tensor_config.stripe_configs[0]
-        stripe_shape = [int(x) for x in stripe_config.shape]
-        stripe_stage, stripe_axis = stripe_part(output_part, stripe_shape, sch)
-        copy_te_tensors = []
-        compute_cycles_hints = []
+        output_part = get_part(stripe["part"])
+        stripe_stage, stripe_axis = stripe_part(output_part, stripe["shape"], sch)
         readers = defaultdict(list)
-        for part in plan.part_group:
+        for part in map(get_part, stripe["group"]):
             if part != output_part:
                 cascade_part(part, stripe_stage, stripe_axis, sch)
 
             update_readers(part, readers)
-            for i, input_tensor in enumerate(part.input_tensors):
-                tensor_config = plan.tensor_configs[input_tensor]
-                if tensor_config.home_region != tensor_config.copy_region:
-                    copy_te_tensors.append(part.subgraph.input_tensors[i])
 
-                    compute_cycles_hint, _ = get_copy_cycles_hint(tensor_config)
-                    compute_cycles_hints.append(compute_cycles_hint)
-
-        for te_tensor, compute_cycles_hint in zip(copy_te_tensors, compute_cycles_hints):
+        for part_id, i, compute_cycles_hint in stripe["copies"]:
+            te_tensor = get_part(part_id).subgraph.input_tensors[i]
             copy_stage = sch.cache_read(te_tensor, "global", readers[te_tensor])
             sch[copy_stage].pragma(
                 copy_stage.op.axis[0], "compute_cycles_hint", compute_cycles_hint
@@ -192,6 +238,22 @@ def apply_proposal(proposal: Proposal, sch: te.Schedule) -> None:
             sch[copy_stage].compute_at(stripe_stage, stripe_axis)
 
 
+def apply_proposal(proposal: Proposal, sch: te.Schedule) -> None:
+    """Apply a Proposal to a Schedule, converting all the Plans into TE scheduling instructions.
+
+    Note that the Schedule is mutated in-place.
+
+    Parameters
+    ----------
+    proposal : Proposal
+        The Proposal to apply to the Schedule.
+    sch : te.Schedule
+        The Schedule to apply to Proposal to.
+
+    """
+    _apply_record(_record_proposal(proposal, lambda part: part), lambda part: part, sch)
+
+
 def create_home_map(
     graph: CascaderGraph,
     io_region: MemoryRegion,
@@ -258,6 +320,152 @@ def extract_memory_info(memory_pool: PoolInfo, memory_pressure: int) -> MemoryRe
     )
 
 
+def _te_graph_description(te_graph: TESubgraph, const_dict: Dict[int, np.ndarray]) -> List[str]:
+    """Describe a Tensor Expression graph by its operations in topological order, with the indices
+    of their inputs, so that the graphs with the same description are cascaded the same.
+
+    The values of the constants are left out, as the cascader only depends on which inputs are
+    constant, so that the subgraphs differing only in their weights share their plans.
+    """
+    inputs = list(te_graph.inputs)
+    tensor_ids = {}
+    lines = []
+
+    def _visit_tensor(tensor):
+        if tensor in tensor_ids:
+            return
+        if tensor in inputs:
+            index = inputs.index(tensor)
+            kind = "constant" if index in const_dict else "input"
+            line = f"{kind} {index} {list(tensor.shape)} {tensor.dtype}"
+        elif isinstance(tensor.op, te.PlaceholderOp):
+            line = f"placeholder {list(tensor.shape)} {tensor.dtype}"
+        else:
+            for input_tensor in tensor.op.input_tensors:
+                _visit_tensor(input_tensor)
+            input_ids = [tensor_ids[input_tensor] for input_tensor in tensor.op.input_tensors]
+            line = f"{tensor.op} {tensor.value_index} {input_ids}"
+        tensor_ids[tensor] = len(lines)
+        lines.append(line)
+
+    for output_tensor in te_graph.outputs:
+        _visit_tensor(output_tensor)
+    return lines
+
+
+def _cascade_key(
+    te_graph: TESubgraph,
+    const_dict: Dict[int, np.ndarray],
+    options: CascaderOptions,
+    io_region: MemoryRegion,
+    constant_region: MemoryRegion,
+    working_regions: List[MemoryRegion],
+    device_config: EthosuDeviceConfig,
+) -> str:
+    """The key of PLAN_CACHE for cascading a graph with the given options."""
+
+    def _region(region):
+        return [str(getattr(region, field)) for field in _REGION_FIELDS]
+
+    compiler_options = tvm.transform.PassContext.current().config.get(
+        "relay.ext.ethos-u.options", None
+    )
+    compiler_fields = []
+    if compiler_options:
+        compiler_fields = [
+            (field, str(getattr(compiler_options, field)))
+            for field in compiler_options.keys()
+            if field != "cache_dir"
+        ]
+    return ContentCache.key(
+        _te_graph_description(te_graph, const_dict),
+        [str(getattr(options, field)) for field in _OPTIONS_FIELDS],
+        _region(options.cascade_region),
+        _region(io_region),
+        _region(constant_region),
+        [_region(region) for region in working_regions],
+        device_config._device,  # pylint: disable=protected-access
+        compiler_fields,
+    )
+
+
+def _get_select_proposal_idx() -> int:
+    """The index of the Proposal to select given in the compiler options, or -1 if there is none."""
+    tvmc_options = tvm.transform.PassContext.current().config.get("relay.ext.ethos-u.options", None)
+    if tvmc_options and tvmc_options.dev_select_proposal_idx:
+        return int(tvmc_options.dev_select_proposal_idx)
+    return -1
+
+
+def search_plans(
+    te_graphs: List[Tuple[TESubgraph, Dict[int, np.ndarray]]],
+    options: CascaderOptions,
+    io_region: MemoryRegion,
+    constant_region: MemoryRegion,
+    working_regions: List[MemoryRegion],
+    device_config: EthosuDeviceConfig,
+    num_threads: Optional[int] = None,
+) -> None:
+    """Search the Proposals of several independent graphs in parallel, caching the choices for
+    `cascade`, which then only applies them to the Schedules.
+
+    Parameters
+    ----------
+    te_graphs : List[Tuple[TESubgraph, Dict[int, np.ndarray]]]
+        The Tensor Expression graphs and their constant dictionaries.
+    options : CascaderOptions
+        Configuration options for the cascading scheduler.
+    io_region : MemoryRegion
+        The MemoryRegion in which input/output tensors should reside.
+    constant_region : MemoryRegion
+        The MemoryRegion in which constants should reside.
+    working_regions : List[MemoryRegion]
+        The MemoryRegions in which intermediate working tensors can reside.
+    device_config : EthosuDeviceConfig
+        Target device configuration.
+    num_threads : Optional[int]
+        The number of threads searching, by default the number of CPUs.
+
+    """
+    tvmc_options = tvm.transform.PassContext.current().config.get("relay.ext.ethos-u.options", None)
+    if tvmc_options and tvmc_options.dev_cascader_logging:
+        # All the Proposals are searched again by `cascade` to be logged
+        return
+    select_proposal_idx = _get_select_proposal_idx()
+    # The graphs are created in turn, and only the searches, which do not touch Python objects,
+    # run in parallel.
+    searches = {}
+    for te_graph, const_dict in te_graphs:
+        key = _cascade_key(
+            te_graph,
+            const_dict,
+            options,
+            io_region,
+            constant_region,
+            working_regions,
+            device_config,
+        )
+        if key in searches or PLAN_CACHE.get(key) is not None:
+            continue
+        casc_graph = create_cascader_graph(te_graph, const_dict, device_config)
+        home_map = create_home_map(casc_graph, io_region, constant_region, working_regions)
+        searches[key] = (casc_graph, home_map)
+    if not searches:
+        return
+
+    def _search(key):
+        casc_graph, home_map = searches[key]
+        return generate_proposals(casc_graph, home_map, options)
+
+    keys = list(searches)
+    with ThreadPoolExecutor(max_workers=num_threads or os.cpu_count()) as executor:
+        all_proposals = list(executor.map(_search, keys))
+    for key, proposals in zip(keys, all_proposals):
+        proposal_choice = choose_proposal(proposals, options.cascade_region, select_proposal_idx)
+        record = _record_proposal(proposal_choice, searches[key][0].get_part_id)
+        PLAN_CACHE.put(key, json.dumps(record).encode("utf-8"))
+
+
 def cascade(
     sch: te.Schedule,
     te_graph: TESubgraph,
@@ -303,11 +511,7 @@ def cascade(
     """
     tvmc_options = tvm.transform.PassContext.current().config.get("relay.ext.ethos-u.options", None)
     log = Logging() if tvmc_options and tvmc_options.dev_cascader_logging else None
-    select_proposal_idx = (
-        int(tvmc_options.dev_select_proposal_idx)
-        if tvmc_options and tvmc_options.dev_select_proposal_idx
-        else -1
-    )
+    select_proposal_idx = _get_select_proposal_idx()
 
     if log:
         start = time.time()
@@ -317,19 +521,29 @@ def cascade(
     casc_graph = create_cascader_graph(te_graph, const_dict, device_config)
     # Then create a mapping between Tensors and their possible memory homes
     home_map = create_home_map(casc_graph, io_region, constant_region, working_regions)
-    # Generate Proposals for Pareto-optimal ways to cascade the CascaderGraph
-    proposals = generate_proposals(casc_graph, home_map, options)
-    # Select the best Proposal subject to the memory constraints
-    proposal_choice = choose_proposal(proposals, options.cascade_region, select_proposal_idx)
-
-    if log:
-        for idx, proposal in enumerate(proposals):
-            log.add_proposal(idx, proposal.memory_usage, proposal.cycles)
-            if proposal == proposal_choice:
-                log.selected_proposal_idx = idx
-
-        log.cascader_runtime = time.time() - start
-        log.dump_json()
+    # Reuse the Proposal chosen for the same graph, unless all the Proposals are logged
+    key = _cascade_key(
+        te_graph, const_dict, options, io_region, constant_region, working_regions, device_config
+    )
+    cached_record = None if log else PLAN_CACHE.get(key)
+    if cached_record is not None:
+        record = json.loads(cached_record)
+    else:
+        # Generate Proposals for Pareto-optimal ways to cascade the CascaderGraph
+        proposals = generate_proposals(casc_graph, home_map, options)
+        # Select the best Proposal subject to the memory constraints
+        proposal_choice = choose_proposal(proposals, options.cascade_region, select_proposal_idx)
+        record = _record_proposal(proposal_choice, casc_graph.get_part_id)
+        PLAN_CACHE.put(key, json.dumps(record).encode("utf-8"))
+
+        if log:
+            for idx, proposal in enumerate(proposals):
+                log.add_proposal(idx, proposal.memory_usage, proposal.cycles)
+                if proposal == proposal_choice:
+                    log.selected_proposal_idx = idx
+
+            log.cascader_runtime = time.time() - start
+            log.dump_json()
 
     # Apply the selected Proposal to the Tensor Expression Schedule
-    apply_proposal(proposal_choice, sch)
+    _apply_record(record, lambda part_id: casc_graph.part_order[part_id], sch)
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Minimum graph executor that executes graph containing TVM PackedFunc."""
+import contextlib
+
 import numpy as np
 import tvm._ffi
 
@@ -207,6 +209,18 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def set_parallel(self, parallel=True):
+        """Run the independent operators of the graph at the same time, on the threads of the
+        work-stealing thread pool, with every operator starting once its inputs are computed and
+        the storage it reuses is no longer in use. Only supported on CPU.
+
+        Parameters
+        ----------
+        parallel : bool
+            Whether to run the independent operators in parallel.
+        """
+        self.module["set_parallel"](parallel)
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -325,6 +339,21 @@ class GraphModule(object):
         """
         self._load_params(bytearray(params_bytes))
 
+    def load_params_from_file(self, path, use_mmap=False):
+        """Load parameters from a file of a serialized parameter dict, streaming each tensor into
+        the storage of its input instead of loading the whole dict on the host first.
+
+        Parameters
+        ----------
+        path : str
+            The path of the file, e.g. written from `relay.save_param_dict`.
+
+        use_mmap : bool
+            Whether to map the file in memory and copy the tensors from the mapping, instead of
+            reading the file in chunks.
+        """
+        self.module["load_params_from_file"](path, use_mmap)
+
     def share_params(self, other, params_bytes):
         """Share parameters from pre-existing GraphExecutor instance.
 
@@ -456,3 +485,97 @@ class GraphModule(object):
             cooldown_interval_ms=cooldown_interval_ms,
             repeats_to_cooldown=repeats_to_cooldown,
         )()
+
+
+class GraphExecutorPool(object):
+    """A pool of graph executors of the same graph on the same devices, which share one copy of
+    the params and each own the activations of a request, leased to the serving threads.
+
+    Only leasing an executor and returning it are serialized, the leased executors run
+    concurrently, so that the threads serving one device do not each hold the params.
+
+    Parameters
+    ----------
+    graph_json_str : str
+        The graph to be deployed in json format output by json graph.
+
+    libmod : tvm.runtime.Module
+        The module of the corresponding function.
+
+    device : Device or list of Device
+        The devices to deploy the module on, local ones.
+
+    num_instances : int
+        The number of the executors, i.e. of the requests run at a time.
+
+    params_bytes : Optional[bytearray]
+        The serialized parameter dict, loaded by the first executor and shared by the others.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        pool = graph_executor.GraphExecutorPool(graph, lib, tvm.cuda(), 4, params_bytes)
+        # in each serving thread
+        with pool.lease() as gmod:
+            gmod.run(data=data)
+            out = gmod.get_output(0).numpy()
+    """
+
+    def __init__(self, graph_json_str, libmod, device, num_instances, params_bytes=None):
+        _, num_rpc_dev, device_type_id = get_device(libmod, device)
+        if num_rpc_dev > 0:
+            raise ValueError("GraphExecutorPool only runs on local devices")
+        fcreate = tvm._ffi.get_global_func("tvm.graph_executor.create_pool")
+        params = None if params_bytes is None else bytearray(params_bytes)
+        self.module = fcreate(graph_json_str, libmod, num_instances, params, *device_type_id)
+        self._lease = self.module["lease"]
+        self._release = self.module["release"]
+
+    @property
+    def num_instances(self):
+        """The number of the executors of the pool."""
+        return self.module["num_instances"]()
+
+    @property
+    def num_available(self):
+        """The number of the executors not leased."""
+        return self.module["num_available"]()
+
+    def acquire(self, timeout_ms=-1):
+        """Lease an executor, to be returned by `release`.
+
+        Parameters
+        ----------
+        timeout_ms : int
+            The time to wait for an executor in milliseconds, or -1 to wait forever.
+
+        Returns
+        -------
+        graph_module : Optional[GraphModule]
+            The executor, or None if none is returned in time.
+        """
+        mod = self._lease(timeout_ms)
+        return None if mod is None else GraphModule(mod)
+
+    def release(self, graph_module):
+        """Return an executor leased by `acquire` to the pool."""
+        self._release(graph_module.module)
+
+    @contextlib.contextmanager
+    def lease(self, timeout_ms=-1):
+        """Lease an executor for the scope of a with block.
+
+        Parameters
+        ----------
+        timeout_ms : int
+            The time to wait for an executor in milliseconds, or -1 to wait forever.
+        """
+        graph_module = self.acquire(timeout_ms)
+        if graph_module is None:
+            raise TimeoutError("No executor of the pool is returned in time")
+        try:
+            yield graph_module
+        finally:
+            self.release(graph_module)
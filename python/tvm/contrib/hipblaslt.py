@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""External function interface to hipBLASLt libraries."""
+import tvm
+from tvm import te
+
+
+def _extern(shape, lhs, rhs, bias, transa, transb, activation, dtype):
+    if bias is None:
+        return te.extern(
+            shape,
+            [lhs, rhs],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.hipblaslt.matmul", ins[0], ins[1], outs[0], transa, transb, activation
+            ),
+            dtype=dtype,
+            name="C",
+        )
+    return te.extern(
+        shape,
+        [lhs, rhs, bias],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.hipblaslt.matmul_bias",
+            ins[0],
+            ins[1],
+            ins[2],
+            outs[0],
+            transa,
+            transb,
+            activation,
+        ),
+        dtype=dtype,
+        name="C",
+    )
+
+
+def matmul(lhs, rhs, bias=None, transa=False, transb=False, activation="none", dtype=None):
+    """Create an extern op that compute activation(lhs rhs + bias) with hipBLASLt,
+    with the bias and the activation fused in the epilogue of the matmul.
+
+    Parameters
+    ----------
+    lhs : Tensor
+        The left matrix operand
+    rhs : Tensor
+        The right matrix operand
+    bias : Optional[Tensor]
+        The bias of the columns of the result, added before the activation
+    transa : bool
+        Whether transpose lhs
+    transb : bool
+        Whether transpose rhs
+    activation : str
+        The activation, one of "none", "relu" and "gelu"
+
+    Returns
+    -------
+    C : Tensor
+        The result tensor.
+    """
+    n = lhs.shape[1] if transa else lhs.shape[0]
+    m = rhs.shape[0] if transb else rhs.shape[1]
+    dtype = dtype if dtype is not None else lhs.dtype
+    return _extern((n, m), lhs, rhs, bias, transa, transb, activation, dtype)
+
+
+def batch_matmul(lhs, rhs, bias=None, transa=False, transb=False, activation="none", dtype=None):
+    """Create an extern op that compute the batched activation(lhs rhs + bias) with hipBLASLt,
+    with the bias and the activation fused in the epilogue of the matmul.
+
+    Parameters
+    ----------
+    lhs : Tensor
+        The left matrix operand
+    rhs : Tensor
+        The right matrix operand
+    bias : Optional[Tensor]
+        The bias of the columns of the result, shared by the batches
+    transa : bool
+        Whether transpose lhs
+    transb : bool
+        Whether transpose rhs
+    activation : str
+        The activation, one of "none", "relu" and "gelu"
+
+    Returns
+    -------
+    C : Tensor
+        The result tensor.
+    """
+    b = lhs.shape[0]
+    n = lhs.shape[2] if transa else lhs.shape[1]
+    m = rhs.shape[1] if transb else rhs.shape[2]
+    dtype = dtype if dtype is not None else lhs.dtype
+    return _extern((b, n, m), lhs, rhs, bias, transa, transb, activation, dtype)
@@ -59,6 +59,7 @@ class PipelineModule(object):
         self._get_num_inputs = self.module["get_num_inputs"]
         self._get_input_pipeline_map = self.module["get_input_pipeline_map"]
         self._get_pipe_execute_count = self.module["get_execute_count"]
+        self._get_pipeline_metrics = self.module["get_pipeline_metrics"]
 
     def run(self):
         """Run the pipeline executor."""
@@ -163,6 +164,22 @@ class PipelineModule(object):
         """
         return self._get_pipe_execute_count()
 
+    def stage_metrics(self):
+        """Get the metrics of each stage of the pipeline.
+
+        Returns
+        -------
+        metrics : Dict[str, Any]
+            The metrics, where "stages" lists for each runtime module its number of replicas,
+            the number of runs, the throughput in runs per second since the first run, the time
+            in microseconds spent in running, in waiting for the inputs and in being blocked on
+            the full queues to the next stages, and the current depth, the max depth and the
+            capacity of each input queue. "outputs" lists the depths of the queues of the
+            global outputs, and "input_backpressure_us" is the time the global inputs were
+            blocked on the full queues.
+        """
+        return json.loads(self._get_pipeline_metrics())
+
     @property
     def num_outputs(self):
         """Get the number of outputs.
@@ -243,13 +260,13 @@ class PipelineExecutorFactoryModule(object):
             Common interface for pipeline executor factory Module.
         """
         if not self.module:
-            graph_executors, config = self.graph_executor_create(
+            graph_executors, config, replicas = self.graph_executor_create(
                 self.pipeline_mods, self.mods_config
             )
             self.pipeline_create = get_global_func(
                 "tvm.pipeline_executor.create", allow_missing=False
             )
-            self.module = self.pipeline_create(graph_executors, config)
+            self.module = self.pipeline_create(graph_executors, config, replicas)
         return self.module
 
     def graph_executor_create(self, pipeline_mods, mod_config):
@@ -270,17 +287,37 @@ class PipelineExecutorFactoryModule(object):
 
         mod_config : str
             The Modudle configuration.
+
+        replicas : List[List[Module]]
+            The copies of each module on its replica devices.
         """
         # Should store modules in the list named 'mods' in index order.
         mods = [None for _ in range(len(pipeline_mods))]
+        replicas = [[] for _ in range(len(pipeline_mods))]
         for lib_index in pipeline_mods:
             pipeline_lib = pipeline_mods[lib_index]["lib"]
             dev = pipeline_mods[lib_index]["dev"]
-            lib = graph_executor.GraphModule(pipeline_lib["default"](dev))
+            vm_func = pipeline_mods[lib_index].get("vm_func")
+            if vm_func:
+                # Import here to avoid a circular import.
+                from tvm import relax  # pylint: disable=import-outside-toplevel
+
+                relax_vm_stage = get_global_func("tvm.pipeline_executor.relax_vm_stage")
+
+                def create(dev, lib=pipeline_lib, func=vm_func, make=relax_vm_stage):
+                    return make(relax.VirtualMachine(lib, dev).module, func)
+
+            else:
+
+                def create(dev, lib=pipeline_lib):
+                    return graph_executor.GraphModule(lib["default"](dev)).module
+
             # Return a module list sorted by lib_index.
-            mods[lib_index] = lib.module
+            mods[lib_index] = create(dev)
+            for replica_dev in pipeline_mods[lib_index].get("replica_devs", []):
+                replicas[lib_index].append(create(replica_dev))
 
-        return mods, json.dumps(mod_config)
+        return mods, json.dumps(mod_config), replicas
 
     def export_library(self, directory_path):
         """Export the pipeline executor into disk files.
@@ -309,14 +346,24 @@ class PipelineExecutorFactoryModule(object):
             mconfig = {}
             mconfig["mod_idx"] = lib_index
             mconfig["lib_name"] = "{}/lib{}.so".format(directory_path, lib_index)
-            mconfig["json_name"] = "{}/json{}".format(directory_path, lib_index)
-            mconfig["params_name"] = "{}/params{}".format(directory_path, lib_index)
+            vm_func = self.pipeline_mods[lib_index].get("vm_func")
+            if not vm_func:
+                mconfig["json_name"] = "{}/json{}".format(directory_path, lib_index)
+                mconfig["params_name"] = "{}/params{}".format(directory_path, lib_index)
             mconfig["dev"] = "{},{}".format(
                 self.pipeline_mods[lib_index]["dev"].device_type,
                 self.pipeline_mods[lib_index]["dev"].device_id,
             )
+            mconfig["replica_devs"] = [
+                "{},{}".format(dev.device_type, dev.device_id)
+                for dev in self.pipeline_mods[lib_index].get("replica_devs", [])
+            ]
             # Get the graph, lib, and parameters from GraphExecutorFactoryModule.
             lib = self.pipeline_mods[lib_index]["lib"]
+            if vm_func:
+                # The relax VM executable carries its constants within the library.
+                mconfig["vm_func"] = vm_func
+                lib = lib.mod
             # Export the lib, graph, and parameters to disk.
             if self.pipeline_mods[lib_index]["export_cc"]:
                 lib.export_library(
@@ -325,6 +372,9 @@ class PipelineExecutorFactoryModule(object):
             else:
                 lib.export_library(mconfig["lib_name"])
 
+            if vm_func:
+                load_config.append(mconfig)
+                continue
             with open(mconfig["json_name"], "w") as file_handle:
                 file_handle.write(lib.graph_json)
             with open(mconfig["params_name"], "wb") as file_handle:
@@ -18,7 +18,7 @@
 import json
 import os
 import tvm._ffi
-from tvm import relay
+from tvm import relax, relay
 from tvm.relay.transform import InferType
 from tvm.contrib.pipeline_executor import PipelineExecutorFactoryModule
 
@@ -66,6 +66,7 @@ def build(pipe_configs):
         mod_idx = pipe_config["mod_idx"]
         dev = mod_config["dev"]
         target = mod_config["target"]
+        vm_func = mod_config.get("vm_func")
         build_func = relay.build
         # Callers may need to use a customized building function to wrap the pre-building logic
         # and the backend building logic. For example, in order to support a backend which only
@@ -74,13 +75,19 @@ def build(pipe_configs):
         if "build" in mod_config and mod_config["build"]:
             build_func = mod_config["build"]
 
-        lib = build_func(
-            ir_mod,
-            target,
-            params=mod_config["params"],
-            target_host=mod_config["target_host"],
-            mod_name=mod_config["mod_name"],
-        )
+        if vm_func:
+            # A relax module runs as a function of a relax VM.
+            if build_func is relay.build:
+                build_func = relax.vm.build
+            lib = build_func(ir_mod, target, params=mod_config["params"])
+        else:
+            lib = build_func(
+                ir_mod,
+                target,
+                params=mod_config["params"],
+                target_host=mod_config["target_host"],
+                mod_name=mod_config["mod_name"],
+            )
 
         pipe_config["dev"] = "{},{}".format(dev.device_type, dev.device_id)
         # Use "mod_idx" as the key to create a "module_connection" map which is not only
@@ -91,7 +98,10 @@ def build(pipe_configs):
             "dev": dev,
             "fcompile": mod_config["fcompile"],
             "export_cc": mod_config["export_cc"],
+            "replica_devs": mod_config.get("replica_devs", []),
         }
+        if vm_func:
+            libs[mod_idx]["vm_func"] = vm_func
 
     # Creating a text form configuration to record the "input_connection" and the
     # "module_connection" information. The "input_connection" is used to record the
@@ -101,6 +111,8 @@ def build(pipe_configs):
     string_config["param_connection"] = config["param_connection"]
     string_config["input_connection"] = config["input_connection"]
     string_config["module_connection"] = module_string_config
+    if "queue_capacity" in config:
+        string_config["queue_capacity"] = config["queue_capacity"]
 
     return PipelineExecutorFactoryModule(libs, string_config)
 
@@ -134,16 +146,27 @@ def export_library(factory, directory_path):
         mconfig = {}
         mconfig["mod_idx"] = lib_index
         mconfig["lib_name"] = "{}/lib{}.so".format(directory_path, lib_index)
-        mconfig["json_name"] = "{}/json{}".format(directory_path, lib_index)
-        mconfig["params_name"] = "{}/params{}".format(directory_path, lib_index)
         lib_config = factory.pipeline_mods[lib_index]
+        if "vm_func" not in lib_config:
+            mconfig["json_name"] = "{}/json{}".format(directory_path, lib_index)
+            mconfig["params_name"] = "{}/params{}".format(directory_path, lib_index)
         mconfig["dev"] = "{},{}".format(lib_config["dev"].device_type, lib_config["dev"].device_id)
+        mconfig["replica_devs"] = [
+            "{},{}".format(dev.device_type, dev.device_id) for dev in lib_config["replica_devs"]
+        ]
         fcompile = lib_config["fcompile"]
         if not fcompile:
             fcompile = False
 
-        # Get the graph, lib, and parameters from GraphExecutorFactoryModule.
         lib = factory.pipeline_mods[lib_index]["lib"]
+        if "vm_func" in lib_config:
+            # The relax VM executable carries its constants within the library.
+            mconfig["vm_func"] = lib_config["vm_func"]
+            lib.mod.export_library(mconfig["lib_name"], fcompile)
+            load_config.append(mconfig)
+            continue
+
+        # Get the graph, lib, and parameters from GraphExecutorFactoryModule.
         # Export the lib, graph, and parameters to disk.
         lib.export_library(mconfig["lib_name"], fcompile)
         with open(mconfig["json_name"], "w") as file_handle:
@@ -349,8 +372,10 @@ class PipelineConfig(object):
             self.bindings.append(binding)
             if not self.is_pipeline_executor_interface():
                 # Check whether the data types of the source and destination are the same.
+                # The types of relay and relax are not comparable with each other.
                 if (
                     isinstance(binding.io_owner, PipelineConfig.ModuleWrapper)
+                    and self.io_owner.is_relax == binding.io_owner.is_relax
                     and self.data_type != binding.data_type
                 ):
                     raise RuntimeError(
@@ -417,10 +442,20 @@ class PipelineConfig(object):
             self.dev = None
             self.export_cc = None
             self.cpu_affinity = ""
+            # The other devices running copies of the module, which share the runs of the
+            # module in the pipeline, in order to relieve a bottleneck stage.
+            self.replica_devs = []
             self.idx = None
             self.mod = mod
-            self.input_params = InferType()(mod)["main"].params
-            self.output_type = InferType()(mod)["main"].checked_type.ret_type
+            # A relax module runs its "main" function on a relax VM, and hands its output
+            # tensors over to the next modules without copying them.
+            self.is_relax = isinstance(mod["main"], relax.Function)
+            if self.is_relax:
+                self.input_params = mod["main"].params
+                self.output_type = mod["main"].ret_type
+            else:
+                self.input_params = InferType()(mod)["main"].params
+                self.output_type = InferType()(mod)["main"].checked_type.ret_type
             self.input_bindings = PipelineConfig.BindingList(self, "input")
             self.output_bindings = PipelineConfig.BindingList(self, "output")
             self.param_binding = PipelineConfig.Binding(self, "param", "param")
@@ -500,6 +535,9 @@ class PipelineConfig(object):
         self.output_bindings = self.BindingList(self, "output")
         # There is a map of global parameters group and module index.
         self.param_group_bindings = self.BindingList(self, "param")
+        # The max number of the data in each queue between two modules. A module blocks on
+        # forwarding its outputs when the queue is full. None means the default capacity.
+        self.queue_capacity = None
 
     def __str__(self):
         # Get configuration information as a string.
@@ -606,6 +644,10 @@ class PipelineConfig(object):
                 "dev": module.dev,
                 "export_cc": module.export_cc,
             }
+            if module.replica_devs:
+                module_connection[mod]["replica_devs"] = module.replica_devs
+            if module.is_relax:
+                module_connection[mod]["vm_func"] = "main"
 
         # Creating a map including pipeline inputs and subgraph inputs.
         input_connection = []
@@ -634,6 +676,8 @@ class PipelineConfig(object):
         mconfig["module_connection"] = module_connection
         mconfig["input_connection"] = input_connection
         mconfig["param_connection"] = param_connection
+        if self.queue_capacity is not None:
+            mconfig["queue_capacity"] = self.queue_capacity
         return mconfig
 
     def dag_topology_sort(self):
@@ -0,0 +1,114 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Utilities of the TVM JS runtime."""
+import json
+import os
+from typing import Dict, List, Mapping, Union
+
+import numpy as np
+
+import tvm
+
+
+def _to_numpy(arr) -> np.ndarray:
+    if isinstance(arr, tvm.nd.NDArray):
+        return arr.numpy()
+    return np.asarray(arr)
+
+
+def dump_ndarray_cache(
+    params: Union[Mapping[str, Union[np.ndarray, tvm.nd.NDArray]], List],
+    cache_dir: str,
+    prefix: str = "param",
+    shard_cap_mb: int = 32,
+) -> Dict:
+    """Dump the parameters to shards of raw data and to the ndarray-cache.json
+    listing them, which the web runtime fetches with Instance.fetchNDArrayCache.
+
+    The parameters are written in order, so that those of the first layers are in
+    the first shards, which the web runtime uploads first.
+
+    Parameters
+    ----------
+    params : Union[Mapping[str, Union[np.ndarray, tvm.nd.NDArray]], List]
+        The parameters by name, or the list of the parameters named
+        <prefix>_0, <prefix>_1, ..., as fetched by Instance.getParamsFromCache.
+
+    cache_dir : str
+        The directory of the shards and of ndarray-cache.json.
+
+    prefix : str
+        The prefix of the names of a list of parameters.
+
+    shard_cap_mb : int
+        The max size of a shard in MB, unless a single parameter is larger.
+
+    Returns
+    -------
+    manifest : Dict
+        The content of ndarray-cache.json.
+    """
+    if not isinstance(params, Mapping):
+        params = {"%s_%d" % (prefix, i): param for i, param in enumerate(params)}
+    os.makedirs(cache_dir, exist_ok=True)
+    shard_cap = shard_cap_mb * (1 << 20)
+    shards: List[Dict] = []
+    shard_data: List[bytes] = []
+    shard_records: List[Dict] = []
+    shard_nbytes = 0
+
+    def flush_shard():
+        nonlocal shard_data, shard_records, shard_nbytes
+        if not shard_records:
+            return
+        data_path = "params_shard_%d.bin" % len(shards)
+        with open(os.path.join(cache_dir, data_path), "wb") as outfile:
+            for data in shard_data:
+                outfile.write(data)
+        shards.append(
+            {
+                "dataPath": data_path,
+                "format": "raw-shard",
+                "nbytes": shard_nbytes,
+                "records": shard_records,
+            }
+        )
+        shard_data, shard_records, shard_nbytes = [], [], 0
+
+    for name, param in params.items():
+        arr = _to_numpy(param)
+        data = np.ascontiguousarray(arr).tobytes()
+        if shard_nbytes + len(data) > shard_cap:
+            flush_shard()
+        shard_records.append(
+            {
+                "name": name,
+                "shape": list(arr.shape),
+                "dtype": str(arr.dtype),
+                "format": "raw",
+                "nbytes": len(data),
+                "byteOffset": shard_nbytes,
+            }
+        )
+        shard_data.append(data)
+        shard_nbytes += len(data)
+    flush_shard()
+
+    manifest = {"records": shards}
+    with open(os.path.join(cache_dir, "ndarray-cache.json"), "w") as outfile:
+        json.dump(manifest, outfile, indent=2)
+    return manifest
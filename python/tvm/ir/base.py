@@ -121,6 +121,40 @@ class EnvFunc(Object):
         return _ffi_api.EnvFuncGet(name)
 
 
+@tvm._ffi.register_object("StructuralMemo")
+class StructuralMemo(Object):
+    """The memo of the structural hashes and equalities computed in its scope.
+
+    Within the scope, structural_hash and structural_equal look up the results of their earlier
+    calls on the same objects rather than walking the objects again. An expression cannot change
+    while the memo refers to it, and a module updated in place, e.g. by ``mod[gv] = func``, misses
+    the memo and is hashed anew. Arrays and maps are never memoized.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        with tvm.ir.StructuralMemo():
+            # The second call is a lookup.
+            tvm.ir.structural_hash(mod)
+            tvm.ir.structural_hash(mod)
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(tvm.runtime._ffi_node_api.StructuralMemo)
+
+    def __enter__(self):
+        tvm.runtime._ffi_node_api.StructuralMemoEnter(self)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        tvm.runtime._ffi_node_api.StructuralMemoExit(self)
+
+    def num_hits(self) -> int:
+        """The number of the lookups which hit the memo."""
+        return tvm.runtime._ffi_node_api.StructuralMemoNumHits(self)
+
+
 def load_json(json_str: Union[str, dict]):
     """Load tvm object from json_str.
 
@@ -159,6 +193,40 @@ def save_json(node):
     return tvm.runtime._ffi_node_api.SaveJSON(node)
 
 
+def save_binary(node, file_name):
+    """Save tvm object to a file in the binary IR format.
+
+    The format keeps the payloads of the NDArrays out of line, so that load_binary maps them
+    instead of decoding them. Unlike json, it is not upgraded across TVM versions, and is meant
+    to cache objects rather than to exchange them.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    file_name : str
+        The file to save to.
+    """
+    tvm.runtime._ffi_node_api.SaveBinaryFile(node, file_name)
+
+
+def load_binary(file_name):
+    """Load tvm object from a file saved by save_binary.
+
+    Parameters
+    ----------
+    file_name : str
+        The file to load from.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node, whose NDArrays are copy-on-write views of the mapped file.
+    """
+    return tvm.runtime._ffi_node_api.LoadBinaryFile(file_name)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
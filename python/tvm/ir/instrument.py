@@ -255,3 +255,56 @@ class PassTimingInstrument(tvm.runtime.Object):
                 profiles = timing_inst.render()
         """
         return _ffi_instrument_api.RenderTimePassProfiles()
+
+
+@tvm._ffi.register_object("instrument.PassInstrument")
+class PassProfilingInstrument(tvm.runtime.Object):
+    """A pass instrument that profiles the wall time, the increase of the peak resident set
+    size and the number of IR nodes before and after each pass, nested like the passes.
+
+    Parameters
+    ----------
+    count_nodes : bool
+        Whether to count the IR nodes of the module around each pass, which walks the whole
+        module twice per pass.
+    """
+
+    def __init__(self, count_nodes=True):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassProfilingInstrument, count_nodes
+        )
+
+    @staticmethod
+    def render():
+        """Retrieve the rendered profiles, one pass per line, indented by nesting.
+
+        Returns
+        -------
+        string : string
+            The rendered profiles.
+
+        Examples
+        --------
+
+        .. code-block:: python
+
+            profiling_inst = PassProfilingInstrument()
+            with tvm.transform.PassContext(instruments=[profiling_inst]):
+                mod = pipeline(mod)
+                # before exiting the context, get profile results.
+                print(profiling_inst.render())
+                with open("passes.json", "w") as f:
+                    f.write(profiling_inst.render_chrome_trace())
+        """
+        return _ffi_instrument_api.RenderPassProfilesDetailed()
+
+    @staticmethod
+    def render_chrome_trace():
+        """Retrieve the profiles as a Chrome trace, to be opened in chrome://tracing or Perfetto.
+
+        Returns
+        -------
+        string : string
+            The trace in JSON.
+        """
+        return _ffi_instrument_api.RenderPassProfilesChromeTrace()
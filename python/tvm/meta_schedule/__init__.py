@@ -24,6 +24,7 @@ from . import (
     measure_callback,
     mutator,
     postproc,
+    regression,
     relax_integration,
     relay_integration,
     runner,
@@ -112,7 +112,7 @@ class BuilderResult(Object):
 class Builder(Object):
     """The abstract builder interface."""
 
-    BuilderType = Union["Builder", Literal["local"]]
+    BuilderType = Union["Builder", Literal["local", "rpc"]]
 
     def build(self, build_inputs: List[BuilderInput]) -> List[BuilderResult]:
         """Build the given inputs.
@@ -130,7 +130,7 @@ class Builder(Object):
 
     @staticmethod
     def create(  # pylint: disable=keyword-arg-before-vararg
-        kind: Literal["local"] = "local",
+        kind: Literal["local", "rpc"] = "local",
         *args,
         **kwargs,
     ) -> "Builder":
@@ -138,18 +138,20 @@ class Builder(Object):
 
         Parameters
         ----------
-        kind : Literal["local"]
-            The kind of the builder. For now, only "local" is supported.
+        kind : Literal["local", "rpc"]
+            The kind of the builder. Can be "local" or "rpc".
 
         Returns
         -------
         builder : Builder
             The builder created.
         """
-        from . import LocalBuilder  # pylint: disable=import-outside-toplevel
+        from . import LocalBuilder, RPCBuilder  # pylint: disable=import-outside-toplevel
 
         if kind == "local":
             return LocalBuilder(*args, **kwargs)  # type: ignore
+        if kind == "rpc":
+            return RPCBuilder(*args, **kwargs)  # type: ignore
         raise ValueError(f"Unknown Builder: {kind}")
 
 
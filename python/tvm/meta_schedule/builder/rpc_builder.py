@@ -0,0 +1,216 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""RPC builder that compiles on a pool of build servers registered in the RPC tracker"""
+import json
+import os
+import tempfile
+from typing import Callable, List, Optional
+
+from tvm._ffi import get_global_func, register_func
+from tvm.ir import load_json, save_json
+from tvm.runtime import load_param_dict
+from tvm.target import Target
+
+from ...contrib.popen_pool import MapResult, PopenPoolExecutor, StatusKind
+from ..logging import get_logger
+from ..runner.config import RPCConfig
+from ..utils import derived_object
+from .builder import BuilderInput, BuilderResult, PyBuilder
+from .local_builder import _serialize_params
+
+logger = get_logger(__name__)  # pylint: disable=invalid-name
+
+
+@derived_object
+class RPCBuilder(PyBuilder):
+    """A builder that dispatches the builds to the build servers registered in the RPC tracker
+    under a key, and downloads the artifacts back to the local host.
+
+    Each build requests a session from the tracker, which hands out the next free build server,
+    so that the faster servers take more builds. The builds failing to reach a server, e.g. when
+    the server goes down, are retried on another one.
+
+    Parameters
+    ----------
+    rpc_config : RPCConfig
+        The configuration to connect to the tracker, whose key refers to the build servers.
+    max_workers : Optional[int]
+        The max number of builds in flight. Defaults to the number of the build servers.
+    timeout_sec : float
+        The timeout in seconds for a build, including the transfers.
+    max_retries : int
+        The max number of retries of a build on another server if the server is not reachable.
+    f_build : Optional[str]
+        Name of the build function on the build servers.
+        Defaults to `meta_schedule.builder.default_build`.
+    initializer: Optional[Callable[[], None]]
+        The initializer function for each popen worker.
+
+    Note
+    ----
+    The build servers are launched by
+
+    .. code-block:: bash
+
+        python -m tvm.exec.rpc_build_server --tracker=<host>:<port> --key=<key>
+
+    which registers the functions of the meta schedule builders on the server.
+    """
+
+    rpc_config: RPCConfig
+    max_workers: int
+    timeout_sec: float
+    max_retries: int
+    f_build: Optional[str]
+    initializer: Optional[Callable[[], None]]
+
+    def __init__(
+        self,
+        rpc_config: Optional[RPCConfig] = None,
+        *,
+        max_workers: Optional[int] = None,
+        timeout_sec: float = 60.0,
+        max_retries: int = 2,
+        f_build: Optional[str] = None,
+        initializer: Optional[Callable[[], None]] = None,
+    ) -> None:
+        super().__init__()
+        self.rpc_config = RPCConfig._normalized(rpc_config)  # pylint: disable=protected-access
+        if max_workers is None:
+            max_workers = max(self.rpc_config.count_num_servers(allow_missing=False), 1)
+        logger.info("RPCBuilder: max_workers = %d", max_workers)
+        self.max_workers = max_workers
+        self.timeout_sec = timeout_sec
+        self.max_retries = max_retries
+        self.f_build = f_build
+        self.initializer = initializer
+
+    def build(self, build_inputs: List[BuilderInput]) -> List[BuilderResult]:
+        results: List[BuilderResult] = []
+        map_result: MapResult
+
+        # Same reason for the single use PopenPool as mentioned in LocalBuilder.
+        pool = PopenPoolExecutor(
+            max_workers=self.max_workers,
+            timeout=self.timeout_sec,
+            initializer=self.initializer,
+        )
+        for map_result in pool.map_with_error_catching(
+            lambda x: _worker_func(*x),
+            [
+                (
+                    self.rpc_config,
+                    self.max_retries,
+                    self.f_build,
+                    save_json(build_input.mod),
+                    json.dumps(build_input.target.export()),
+                    _serialize_params(build_input.params),
+                )
+                for build_input in build_inputs
+            ],
+        ):
+            if map_result.status == StatusKind.COMPLETE:
+                results.append(BuilderResult(map_result.value, None))
+            elif map_result.status == StatusKind.TIMEOUT:
+                results.append(
+                    BuilderResult(
+                        None,
+                        f"RPCBuilder: Timeout, killed after {self.timeout_sec} seconds",
+                    )
+                )
+            elif map_result.status == StatusKind.EXCEPTION:
+                results.append(
+                    BuilderResult(
+                        None,
+                        "RPCBuilder: An exception occurred\n" + str(map_result.value),
+                    )
+                )
+            else:
+                raise ValueError("Unreachable: unexpected result: {map_result}")
+        del pool
+        return results
+
+
+def _worker_func(
+    rpc_config: RPCConfig,
+    max_retries: int,
+    f_build: Optional[str],
+    mod_json: str,
+    target_json: str,
+    params: Optional[bytearray],
+) -> str:
+    # Step 1. Connect to a build server, retrying on another one if it is not reachable
+    for attempt in range(max_retries + 1):
+        try:
+            session = rpc_config.connect_server()
+            remote_build = session.get_function("meta_schedule.builder.rpc_build")
+            break
+        except Exception as error:  # pylint: disable=broad-except
+            if attempt == max_retries:
+                raise
+            logger.warning("RPCBuilder: Retrying on another build server, because %s", error)
+    # Step 2. Build the IRModule remotely. The failures of the build itself are not retried.
+    remote_path: str = remote_build(mod_json, target_json, params or bytearray(), f_build or "")
+    # Step 3. Download the artifact
+    blob = session.download(remote_path)
+    session.remove(remote_path)
+    artifact_path = os.path.join(tempfile.mkdtemp(), os.path.basename(remote_path))
+    with open(artifact_path, "wb") as file:
+        file.write(blob)
+    return artifact_path
+
+
+@register_func("meta_schedule.builder.rpc_build")
+def rpc_build(mod_json: str, target_json: str, params: bytearray, f_build: str) -> str:
+    """The build function running on the build servers.
+
+    Parameters
+    ----------
+    mod_json : str
+        The serialized IRModule to be built.
+    target_json : str
+        The serialized target to be built.
+    params : bytearray
+        The serialized parameters to be used for the build, empty if there is none.
+    f_build : str
+        Name of the build function, or empty for `meta_schedule.builder.default_build`.
+
+    Returns
+    -------
+    remote_path : str
+        The path of the exported Module, relative to the workspace of the session.
+    """
+    from tvm.contrib.tar import tar  # pylint: disable=import-outside-toplevel
+
+    build = get_global_func(f_build or "meta_schedule.builder.default_build")
+    rt_mod = build(
+        load_json(mod_json),
+        Target(json.loads(target_json)),
+        load_param_dict(params) if params else None,
+    )
+    remote_path = "tvm_tmp_mod." + tar.output_format
+    rt_mod.export_library(get_global_func("tvm.rpc.server.workpath")(remote_path), tar)
+    return remote_path
+
+
+def init_build_server() -> None:
+    """Register the functions of the meta schedule builders on an RPC server, to be passed as
+    the `server_init_callback` of :py:class:`tvm.rpc.Server`."""
+    from tvm.meta_schedule.builder import (  # pylint: disable=import-outside-toplevel,unused-import
+        local_builder,
+        rpc_builder,
+    )
@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Native gradient-boosted decision trees cost model"""
+from typing import Optional
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from ..feature_extractor import FeatureExtractor
+from .cost_model import CostModel
+
+
+@register_object("meta_schedule.GBDTModel")
+class GBDTModel(CostModel):
+    """Gradient-boosted decision trees cost model, which is trained and predicts natively, so that
+    the search strategies do not call back into Python. Each update grows a few trees upon the
+    existing ones rather than retraining from scratch.
+
+    Parameters
+    ----------
+    extractor : FeatureExtractor
+        The feature extractor for the model.
+    num_warmup_samples : int
+        The number of samples that are used for warmup, i.e., the first few samples are predicted
+        with random results.
+    num_trees_per_update : int
+        The number of trees grown by each update.
+    max_num_trees : int
+        The maximum number of trees, beyond which the model is retrained from scratch.
+    max_depth : int
+        The maximum depth of the trees.
+    learning_rate : float
+        The learning rate, i.e. the shrinkage of each tree.
+    min_child_weight : float
+        The minimum sum of the hessians of a child of a split.
+    reg_lambda : float
+        The L2 regularization on the leaf values.
+    max_bin : int
+        The maximum number of histogram bins of each feature, at most 256.
+    seed : Optional[int]
+        The random seed of the predictions before the warmup.
+    """
+
+    extractor: FeatureExtractor
+    num_warmup_samples: int
+    num_trees_per_update: int
+    max_num_trees: int
+    max_depth: int
+    learning_rate: float
+    min_child_weight: float
+    reg_lambda: float
+    max_bin: int
+
+    def __init__(
+        self,
+        *,
+        extractor: FeatureExtractor.FeatureExtractorType = "per-store-feature",
+        num_warmup_samples: int = 100,
+        num_trees_per_update: int = 20,
+        max_num_trees: int = 1000,
+        max_depth: int = 10,
+        learning_rate: float = 0.2,
+        min_child_weight: float = 0.0,
+        reg_lambda: float = 1.0,
+        max_bin: int = 256,
+        seed: Optional[int] = None,
+    ):
+        if not isinstance(extractor, FeatureExtractor):
+            extractor = FeatureExtractor.create(extractor)
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostModelGBDTModel,  # type: ignore # pylint: disable=no-member
+            extractor,
+            num_warmup_samples,
+            num_trees_per_update,
+            max_num_trees,
+            max_depth,
+            learning_rate,
+            min_child_weight,
+            reg_lambda,
+            max_bin,
+            -1 if seed is None else seed,
+        )
+
+    @property
+    def num_trees(self) -> int:
+        """The number of trees of the ensemble."""
+        return _ffi_api.GBDTModelNumTrees(self)  # type: ignore # pylint: disable=no-member
@@ -642,6 +642,8 @@ class SegmentSumMLPTrainer:
         The fraction of data for testing.
     frozen: bool
         Determine whether to re-train the model or not.
+    device: str
+        The torch device on which the model is trained and the batched features are scored.
     optimizer: "torch.optim.adam.Adam"
         The optimizer.
     scheduler: "torch.optim.lr_scheduler.StepLR"
@@ -659,6 +661,7 @@ class SegmentSumMLPTrainer:
     test_interval: int = 1
     test_split: float = 0.2
     frozen: bool = False
+    device: str
     optimizer: "torch.optim.adam.Adam"  # type: ignore
     scheduler: "torch.optim.lr_scheduler.StepLR"  # type: ignore
 
@@ -666,6 +669,7 @@ class SegmentSumMLPTrainer:
         self,
         train_config: Optional[TrainerConfig] = None,
         state: Optional[State] = None,
+        device: Optional[str] = None,
     ):
         train_config = train_config or TrainerConfig()
         state = state or State()
@@ -674,7 +678,9 @@ class SegmentSumMLPTrainer:
         for attr in config:
             setattr(self, attr, config[attr])
         self.state = state
-        self.device = "cuda" if torch.cuda.device_count() else "cpu"
+        if device is None:
+            device = "cuda" if torch.cuda.device_count() else "cpu"
+        self.device = device
         self.optimizer, self.scheduler = None, None
 
     def train_step(
@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Analytical roofline cost model"""
+from typing import Dict, Optional
+
+from tvm._ffi import register_object
+from tvm.ir import IRModule
+
+from .. import _ffi_api
+from .cost_model import CostModel
+
+
+@register_object("meta_schedule.RooflineModel")
+class RooflineModel(CostModel):
+    """Analytical cost model, which bounds the running time of a candidate by its FLOPs and its
+    memory traffic per storage scope against the roofline of the target, so that the search is
+    guided without any training data. A learned model can be blended in as it is updated, in which
+    case the roofline serves as a warm-start prior.
+
+    Parameters
+    ----------
+    peak_flops : float
+        The peak floating point operations per second of the target.
+    bandwidth : Dict[str, float]
+        The peak bytes per second of each storage scope, e.g. "global" and "shared". The traffic
+        of the other scopes is not bound.
+    num_cores : int
+        The number of parallel units of the target, e.g. the cores of a CPU or the resident
+        threads of a GPU.
+    base_model : Optional[CostModel]
+        The learned model that is updated with the running results and blended in.
+    num_warmup_samples : int
+        The number of samples after which only the learned model is used. Before that its weight
+        grows linearly with the number of samples.
+    """
+
+    peak_flops: float
+    bandwidth: Dict[str, float]
+    num_cores: int
+    base_model: Optional[CostModel]
+    num_warmup_samples: int
+
+    def __init__(
+        self,
+        *,
+        peak_flops: float,
+        bandwidth: Dict[str, float],
+        num_cores: int = 1,
+        base_model: Optional[CostModel] = None,
+        num_warmup_samples: int = 100,
+    ):
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostModelRooflineModel,  # type: ignore # pylint: disable=no-member
+            float(peak_flops),
+            {scope: float(bw) for scope, bw in bandwidth.items()},
+            num_cores,
+            base_model,
+            num_warmup_samples,
+        )
+
+    def estimate_time(self, mod: IRModule) -> float:
+        """Estimate the running time of a scheduled module in seconds.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The scheduled module.
+
+        Returns
+        -------
+        time : float
+            The estimated running time.
+        """
+        return _ffi_api.RooflineModelEstimateTime(  # type: ignore # pylint: disable=no-member
+            self, mod
+        )
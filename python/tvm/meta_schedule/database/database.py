@@ -368,6 +368,7 @@ class Database(Object):
         kind: Union[
             Literal[
                 "json",
+                "indexed",
                 "memory",
                 "union",
                 "ordered_union",
@@ -381,9 +382,10 @@ class Database(Object):
 
         Parameters
         ----------
-        kind : str = "json" | "memory" | "union" | "ordered_union" | Callable[[Schedule], bool]
+        kind : str = "json" | "indexed" | "memory" | "union" | "ordered_union" |
+                     Callable[[Schedule], bool]
             The kind of the database to be created. The following kinds are supported:
-            "json", "memory", "union", "ordered_union", and a custom schedule function.
+            "json", "indexed", "memory", "union", "ordered_union", and a custom schedule function.
 
         Returns
         -------
@@ -391,6 +393,7 @@ class Database(Object):
             The created database.
         """
         from . import (  # pylint: disable=import-outside-toplevel
+            IndexedDatabase,
             JSONDatabase,
             MemoryDatabase,
             OrderedUnionDatabase,
@@ -402,6 +405,8 @@ class Database(Object):
             return ScheduleFnDatabase(kind, *args, **kwargs)  # type: ignore
         if kind == "json":
             return JSONDatabase(*args, **kwargs)
+        if kind == "indexed":
+            return IndexedDatabase(*args, **kwargs)  # type: ignore
         if kind == "memory":
             return MemoryDatabase(*args, **kwargs)  # type: ignore
         if kind == "union":
@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The database on indexed append-only logs, which opens without loading the tuning records"""
+import os.path as osp
+from typing import Optional
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .database import Database
+
+
+@register_object("meta_schedule.IndexedDatabase")
+class IndexedDatabase(Database):
+    """Database class backed by indexed append-only logs.
+
+    Opening the database reads the indices of the logs only, and the tuning records are parsed on
+    demand, so that it opens in no time regardless of its size. Multiple tuners, in the same
+    process or not, may append to the same database at the same time, and see the records appended
+    by each other.
+
+    The files of the database with the path prefix `<path>` are `<path>_workload.*` and
+    `<path>_tuning_record.*`, where the tuning records are sharded by the hashes of their
+    workloads.
+
+    Parameters
+    ----------
+    path : str
+        The path prefix of the logs.
+    module_equality : Optional[str]
+        A string to specify the module equality testing and hashing method.
+        It must be one of the followings:
+          - "structural": Use StructuralEqual/Hash
+          - "ignore-ndarray": Same as "structural", but ignore ndarray raw data during
+                              equality testing and hashing.
+          - "anchor-block": Apply equality testing and hashing on the anchor block extracted from a
+                            given module. The "ignore-ndarray" varint is used for the extracted
+                            blocks or in case no anchor block is found.
+                            For the definition of the anchor block, see tir/analysis/analysis.py.
+    """
+
+    path: str
+
+    def __init__(
+        self,
+        path: Optional[str] = None,
+        *,
+        work_dir: Optional[str] = None,
+        num_shards: int = 16,
+        allow_missing: bool = True,
+        module_equality: str = "structural",
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        path : Optional[str] = None
+            The path prefix of the logs. If not specified,
+            will be generated from `work_dir` as `$work_dir/database`.
+        work_dir : Optional[str] = None
+            The work directory, if specified, will be used to generate `path`.
+        num_shards : int
+            The number of shards of the tuning record log, if it is new.
+            An existing log keeps its own.
+        allow_missing : bool
+            Whether to create new logs when the given path is not found.
+        """
+        if work_dir is not None and path is None:
+            path = osp.join(work_dir, "database")
+        if path is None:
+            raise ValueError("`path` is not specified.")
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseIndexedDatabase,  # type: ignore # pylint: disable=no-member
+            path,
+            num_shards,
+            allow_missing,
+            module_equality,
+        )
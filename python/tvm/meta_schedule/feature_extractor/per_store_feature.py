@@ -37,6 +37,10 @@ class PerStoreFeature(FeatureExtractor):
         The number of bytes in a cache line.
     extract_workload : bool
         Whether to extract features in the workload in tuning context or not.
+    feature_cache_size : int
+        The maximum number of scheduled modules whose features are cached by their structural
+        hash, so that the duplicate candidates are not lowered or analyzed again. Zero disables
+        the cache.
     """
 
     buffers_per_store: int
@@ -47,6 +51,8 @@ class PerStoreFeature(FeatureExtractor):
     """The number of bytes in a cache line."""
     extract_workload: bool
     """Whether to extract features in the workload in tuning context or not."""
+    feature_cache_size: int
+    """The maximum number of scheduled modules whose features are cached."""
     feature_vector_length: int
     """Length of the feature vector."""
 
@@ -56,6 +62,7 @@ class PerStoreFeature(FeatureExtractor):
         arith_intensity_curve_num_samples: int = 10,
         cache_line_bytes: int = 64,
         extract_workload: bool = False,
+        feature_cache_size: int = 4096,
     ):
         self.__init_handle_by_constructor__(
             _ffi_api.FeatureExtractorPerStoreFeature,  # type: ignore # pylint: disable=no-member
@@ -63,4 +70,5 @@ class PerStoreFeature(FeatureExtractor):
             arith_intensity_curve_num_samples,
             cache_line_bytes,
             extract_workload,
+            feature_cache_size,
         )
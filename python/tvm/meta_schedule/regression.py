@@ -0,0 +1,164 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Detect the performance regressions of the tuned kernels on the current target"""
+from typing import List, NamedTuple, Optional, Union
+
+import numpy as np  # type: ignore
+
+from tvm.ir import IRModule, structural_hash
+from tvm.target import Target
+
+from .builder import Builder, BuilderInput
+from .database import Database, TuningRecord, Workload
+from .runner import Runner, RunnerInput
+from .utils import remove_build_dir
+
+
+class KernelRegression(NamedTuple):
+    """The re-measured latency of the best record of a workload.
+
+    Parameters
+    ----------
+    workload : Workload
+        The workload of the kernel.
+    record : TuningRecord
+        The best record of the workload in the database.
+    stored_sec : float
+        The median of the latencies stored in the record, in seconds.
+    measured_sec : Optional[float]
+        The median of the latencies measured now, in seconds, or None if the kernel fails to
+        build or run.
+    """
+
+    workload: Workload
+    record: TuningRecord
+    stored_sec: float
+    measured_sec: Optional[float]
+
+    @property
+    def slowdown(self) -> float:
+        """The measured latency over the stored one, infinite if the kernel fails."""
+        if self.measured_sec is None:
+            return float("inf")
+        return self.measured_sec / self.stored_sec
+
+
+def _best_records(database: Database, mod: Optional[IRModule], target: Target):
+    if mod is None:
+        workloads = {}
+        for record in database.get_all_tuning_records():
+            workloads.setdefault(structural_hash(record.workload.mod), record.workload)
+        workloads = list(workloads.values())
+    else:
+        from .relax_integration import (  # pylint: disable=import-outside-toplevel
+            extract_tasks,
+        )
+
+        workloads = []
+        for task in extract_tasks(mod, target):
+            task_mod = task.dispatched[0]
+            if database.has_workload(task_mod):
+                workloads.append(database.commit_workload(task_mod))
+    records = []
+    for workload in workloads:
+        top = database.get_top_k(workload, 1)
+        if top and top[0].run_secs:
+            records.append(top[0])
+    return records
+
+
+def _median_sec(run_secs) -> float:
+    return float(np.median([float(sec) for sec in run_secs]))
+
+
+def detect_regressions(
+    database: Database,
+    target: Union[str, Target],
+    *,
+    mod: Optional[IRModule] = None,
+    builder: Builder.BuilderType = "local",
+    runner: Runner.RunnerType = "local",
+    threshold: float = 0.1,
+) -> List[KernelRegression]:
+    """Re-measure the best record of each workload in the database on the target, and report the
+    kernels that are slower than the latencies stored in their records, e.g. after an update of the
+    driver or a change of the hardware.
+
+    The regressed workloads can be re-tuned by passing their `workload.mod` to `tune_tir`, with a
+    new database since the stale latencies of the records in this one keep them the best.
+
+    Parameters
+    ----------
+    database : Database
+        The database the kernels are tuned with.
+    target : Union[str, Target]
+        The target the kernels are re-measured on.
+    mod : Optional[IRModule]
+        The Relax module the tuned executable is built from, whose kernels are re-measured. All
+        the workloads in the database are re-measured if it is None.
+    builder : Builder.BuilderType
+        The builder of the kernels.
+    runner : Runner.RunnerType
+        The runner measuring the kernels.
+    threshold : float
+        The relative slowdown beyond which a kernel is reported, e.g. 0.1 for 10% slower.
+
+    Returns
+    -------
+    regressions : List[KernelRegression]
+        The regressed kernels, including the ones that fail, from the most regressed.
+    """
+    if not isinstance(target, Target):
+        target = Target(target)
+    if not isinstance(builder, Builder):
+        builder = Builder.create(builder)
+    if not isinstance(runner, Runner):
+        runner = Runner.create(runner)
+    records = _best_records(database, mod, target)
+    if not records:
+        return []
+    candidates = [record.as_measure_candidate() for record in records]
+    builder_results = builder.build(
+        [BuilderInput(candidate.sch.mod, target) for candidate in candidates]
+    )
+    runner_inputs, runner_indices = [], []
+    for i, (candidate, result) in enumerate(zip(candidates, builder_results)):
+        if result.error_msg is None:
+            runner_inputs.append(
+                RunnerInput(result.artifact_path, target.kind.name, candidate.args_info)
+            )
+            runner_indices.append(i)
+    measured: List[Optional[float]] = [None] * len(records)
+    for i, future in zip(runner_indices, runner.run(runner_inputs)):
+        result = future.result()
+        if result.error_msg is None:
+            measured[i] = _median_sec(result.run_secs)
+    for result in builder_results:
+        if result.error_msg is None:
+            remove_build_dir(result.artifact_path)
+    regressions = []
+    for record, measured_sec in zip(records, measured):
+        regression = KernelRegression(
+            workload=record.workload,
+            record=record,
+            stored_sec=_median_sec(record.run_secs),
+            measured_sec=measured_sec,
+        )
+        if regression.slowdown > 1.0 + threshold:
+            regressions.append(regression)
+    regressions.sort(key=lambda regression: regression.slowdown, reverse=True)
+    return regressions
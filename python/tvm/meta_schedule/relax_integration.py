@@ -57,6 +57,7 @@ def extract_tasks(
     target: Target,
     params: Optional[Dict[str, NDArray]] = None,
     module_equality="structural",
+    shape_buckets: Optional[Dict[str, List[int]]] = None,
 ) -> List[ExtractedTask]:
     """Extract tuning tasks from a relax program.
 
@@ -66,6 +67,10 @@ def extract_tasks(
         The module or function to tune
     target : tvm.target.Target
         The compilation target
+    shape_buckets : Optional[Dict[str, List[int]]]
+        The representative values of the symbolic dims by name, e.g. {"n": [32, 128, 512]}.
+        A PrimFunc whose symbolic dims all have values gets a task specialized to each
+        combination of them, named after the values, e.g. "fused_matmul_n128".
 
     Returns
     -------
@@ -83,7 +88,7 @@ def extract_tasks(
         target = Target(target)
     if params:
         mod = BindParams("main", params)(mod)
-    return list(_extract_task_func(mod, target, module_equality))
+    return list(_extract_task_func(mod, target, module_equality, shape_buckets or {}))
 
 
 def extracted_tasks_to_tune_contexts(
@@ -160,6 +165,7 @@ def tune_relax(
     strategy: SearchStrategy.SearchStrategyType = "evolutionary",
     seed: Optional[int] = None,
     module_equality: str = "structural",
+    shape_buckets: Optional[Dict[str, List[int]]] = None,
 ) -> Database:
     """Tune a Relax program.
 
@@ -197,6 +203,9 @@ def tune_relax(
         The search strategy to use
     seed : Optional[int]
         The random seed
+    shape_buckets : Optional[Dict[str, List[int]]]
+        The representative values of the symbolic dims to tune the dynamic PrimFuncs for, see
+        :py:func:`extract_tasks`.
 
     Returns
     -------
@@ -204,7 +213,7 @@ def tune_relax(
         The database that contains the tuning records
     """
     tasks, task_weights = extracted_tasks_to_tune_contexts(
-        extracted_tasks=extract_tasks(mod, target, params, module_equality),
+        extracted_tasks=extract_tasks(mod, target, params, module_equality, shape_buckets),
         work_dir=work_dir,
         space=space,
         strategy=strategy,
@@ -247,6 +256,7 @@ def _tune_relax(
     strategy: SearchStrategy.SearchStrategyType = "evolutionary",
     seed: Optional[int] = None,
     module_equality: str = "structural",
+    shape_buckets: Optional[Dict[str, List[int]]] = None,
 ) -> Database:
     """Interface with tuning api to tune a Relax program.
 
@@ -284,6 +294,8 @@ def _tune_relax(
         The search strategy to use
     seed : Optional[int]
         The random seed
+    shape_buckets : Optional[Dict[str, List[int]]]
+        The representative values of the symbolic dims to tune the dynamic PrimFuncs for
 
     Returns
     -------
@@ -311,6 +323,7 @@ def _tune_relax(
         strategy=strategy,
         seed=seed,
         module_equality=module_equality,
+        shape_buckets=shape_buckets,
     )
     # Return original IRModule
     # This pass only makes optimization decision
@@ -323,6 +336,7 @@ def compile_relax(
     target: Union[Target, str],
     params: Optional[Dict[str, NDArray]],
     module_equality: str = "structural",
+    shape_buckets: Optional[Dict[str, List[int]]] = None,
 ) -> "relax.vm.Executable":
     """Compile a relax program with a MetaSchedule database.
 
@@ -346,6 +360,9 @@ def compile_relax(
                             given module. The "ignore-ndarray" varint is used for the extracted
                             blocks or in case no anchor block is found.
                             For the definition of the anchor block, see tir/analysis/analysis.py.
+    shape_buckets : Optional[Dict[str, List[int]]]
+        The representative values of the symbolic dims the dynamic PrimFuncs were tuned for.
+        Each of them dispatches to the kernels of its buckets by the runtime shape.
 
     Returns
     -------
@@ -363,6 +380,8 @@ def compile_relax(
         mod = BindParams("main", params)(mod)
 
     with target, database, PassContext(opt_level=3):
-        relax_mod = MetaScheduleApplyDatabase(module_equality=module_equality)(mod)
+        relax_mod = MetaScheduleApplyDatabase(
+            module_equality=module_equality, shape_buckets=shape_buckets
+        )(mod)
         relax_ex = relax_build(relax_mod, target=target)
     return relax_ex
@@ -17,7 +17,7 @@
 """Configurations for measurements in the runner"""
 import os
 from threading import Thread
-from typing import NamedTuple, Optional, Union
+from typing import NamedTuple, Optional, Tuple, Union
 
 from tvm import rpc
 
@@ -41,6 +41,16 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    adaptive: bool
+        Whether to measure adaptively, where `repeat` is the minimum number of repeats, at least 2.
+        Compared with the fastest candidate of the same workload measured so far by the runner, a
+        candidate stops repeating as soon as the 95% confidence intervals of their mean costs
+        separate, either way, and otherwise repeats up to `max_repeat` times.
+    max_repeat: int
+        The maximum number of repeats in the adaptive mode.
+    reference_costs: Optional[Tuple[float, ...]]
+        The costs of the fastest candidate to compare with in the adaptive mode, which is filled in
+        by the runner.
 
     Note
     ----
@@ -52,6 +62,9 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 100
     enable_cpu_cache_flush: bool = False
+    adaptive: bool = False
+    max_repeat: int = 10
+    reference_costs: Optional[Tuple[float, ...]] = None
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -62,6 +75,9 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            adaptive=config.adaptive,
+            max_repeat=config.max_repeat,
+            reference_costs=config.reference_costs,
         )
         return config
 
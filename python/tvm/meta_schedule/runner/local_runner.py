@@ -31,6 +31,7 @@ from .runner import PyRunner, PyRunnerFuture, RunnerFuture, RunnerInput, RunnerR
 from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
+    FastestCosts,
     alloc_argument_common,
     run_evaluator_common,
 )
@@ -272,6 +273,7 @@ class LocalRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self._fastest_costs = FastestCosts()
 
         logger.info("LocalRunner: max_workers = 1")
         self.pool = PopenPoolExecutor(
@@ -285,16 +287,19 @@ class LocalRunner(PyRunner):
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
+            device_type = str(runner_input.device_type)
+            args_info = tuple(arg_info.as_json() for arg_info in runner_input.args_info)
+            key = FastestCosts.key(device_type, args_info)
             future = self.pool.submit(
                 _worker_func,
                 self.f_alloc_argument,
                 self.f_run_evaluator,
                 self.f_cleanup,
-                self.evaluator_config,
+                self._fastest_costs.config(self.evaluator_config, key),
                 self.alloc_repeat,
                 str(runner_input.artifact_path),
-                str(runner_input.device_type),
-                tuple(arg_info.as_json() for arg_info in runner_input.args_info),
+                device_type,
+                args_info,
             )
             try:
                 result: List[float] = future.result()
@@ -305,6 +310,8 @@ class LocalRunner(PyRunner):
             except Exception as exception:  # pylint: disable=broad-except
                 result = None
                 error_message = "LocalRunner: An exception occurred\n" + str(exception)
+            if self.evaluator_config.adaptive:
+                self._fastest_costs.update(key, result)
             local_future = LocalRunnerFuture(res=result, error_message=error_message)
             results.append(local_future)  # type: ignore
         return results
@@ -18,7 +18,7 @@
 import concurrent.futures
 import os.path as osp
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 
 from tvm.contrib.popen_pool import PopenPoolExecutor
 from tvm.rpc import RPCSession
@@ -37,6 +37,7 @@ from .runner import PyRunner, PyRunnerFuture, RunnerFuture, RunnerInput, RunnerR
 from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
+    FastestCosts,
     alloc_argument_common,
     run_evaluator_common,
 )
@@ -156,6 +157,13 @@ class RPCRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    max_retries: int
+        The max number of retries of a measurement on another device if the session cannot be
+        created or the module cannot be uploaded, e.g. when the device goes down.
+    batch_size: int
+        The max number of candidates measured in one session. The candidates of a batch are
+        uploaded and loaded up front, timed back-to-back on the device, and share the arguments
+        allocated for the same argument info, which saves the per-candidate session overhead.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -246,6 +254,8 @@ class RPCRunner(PyRunner):
         f_cleanup: Union[T_CLEANUP, str, None] = None,
         max_workers: Optional[int] = None,
         initializer: Optional[Callable[[], None]] = None,
+        max_retries: int = 0,
+        batch_size: int = 1,
     ) -> None:
         """Constructor
 
@@ -273,6 +283,11 @@ class RPCRunner(PyRunner):
             The maximum number of connections. Defaults to number of logical CPU cores.
         initializer: Optional[Callable[[], None]]
             The initializer function.
+        max_retries: int
+            The max number of retries of a measurement on another device if the session cannot be
+            created or the module cannot be uploaded.
+        batch_size: int
+            The max number of candidates measured in one session.
         """
         super().__init__()
         self.rpc_config = RPCConfig._normalized(rpc_config)
@@ -284,39 +299,115 @@ class RPCRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self.max_retries = max_retries
+        self.batch_size = batch_size
+        self._fastest_costs = FastestCosts()
         if max_workers is None:
             max_workers = cpu_count(logical=True)
         logger.info("RPCRunner: max_workers = %d", max_workers)
         self.pool = PopenPoolExecutor(
             max_workers=max_workers,
-            timeout=rpc_config.session_timeout_sec,
+            # A batch of candidates shares the session
+            timeout=rpc_config.session_timeout_sec * max(batch_size, 1),
             initializer=initializer,
         )
         self._sanity_check()
 
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        if self.batch_size > 1:
+            return self._run_batches(runner_inputs)
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
+            device_type = str(runner_input.device_type)
+            args_info = tuple(arg_info.as_json() for arg_info in runner_input.args_info)
+            key = FastestCosts.key(device_type, args_info)
+            pool_future = self.pool.submit(
+                _worker_func,
+                self.f_create_session,
+                self.f_upload_module,
+                self.f_alloc_argument,
+                self.f_run_evaluator,
+                self.f_cleanup,
+                self.rpc_config,
+                # The candidates in flight are compared with the fastest one finished so far
+                self._fastest_costs.config(self.evaluator_config, key),
+                self.alloc_repeat,
+                self.max_retries,
+                str(runner_input.artifact_path),
+                device_type,
+                args_info,
+            )
+            if self.evaluator_config.adaptive:
+                pool_future.add_done_callback(
+                    lambda f, key=key: self._fastest_costs.update(
+                        key, None if f.exception() is not None else f.result()
+                    )
+                )
             future = RPCRunnerFuture(
-                future=self.pool.submit(
-                    _worker_func,
-                    self.f_create_session,
-                    self.f_upload_module,
-                    self.f_alloc_argument,
-                    self.f_run_evaluator,
-                    self.f_cleanup,
-                    self.rpc_config,
-                    self.evaluator_config,
-                    self.alloc_repeat,
-                    str(runner_input.artifact_path),
-                    str(runner_input.device_type),
-                    tuple(arg_info.as_json() for arg_info in runner_input.args_info),
-                ),
+                future=pool_future,
                 timeout_sec=self.rpc_config.session_timeout_sec,
             )
             results.append(future)  # type: ignore
         return results
 
+    def _run_batches(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        results: List[RunnerFuture] = []
+        for i in range(0, len(runner_inputs), self.batch_size):
+            batch = runner_inputs[i : i + self.batch_size]
+            device_types = [str(runner_input.device_type) for runner_input in batch]
+            args_infos = [
+                tuple(arg_info.as_json() for arg_info in runner_input.args_info)
+                for runner_input in batch
+            ]
+            keys = [FastestCosts.key(*key) for key in zip(device_types, args_infos)]
+            batch_future = self.pool.submit(
+                _batch_worker_func,
+                self.f_create_session,
+                self.f_upload_module,
+                self.f_alloc_argument,
+                self.f_run_evaluator,
+                self.f_cleanup,
+                self.rpc_config,
+                [self._fastest_costs.config(self.evaluator_config, key) for key in keys],
+                self.alloc_repeat,
+                self.max_retries,
+                [str(runner_input.artifact_path) for runner_input in batch],
+                device_types,
+                args_infos,
+            )
+            futures = [concurrent.futures.Future() for _ in batch]
+            batch_future.add_done_callback(
+                lambda f, futures=futures, keys=keys: self._distribute(f, futures, keys)
+            )
+            for future in futures:
+                results.append(
+                    RPCRunnerFuture(  # type: ignore
+                        future=future,
+                        timeout_sec=self.rpc_config.session_timeout_sec * self.batch_size,
+                    )
+                )
+        return results
+
+    def _distribute(
+        self,
+        batch_future: concurrent.futures.Future,
+        futures: List[concurrent.futures.Future],
+        keys: List[str],
+    ) -> None:
+        """Distribute the results of a batch to the futures of its candidates"""
+        error = batch_future.exception()
+        for i, future in enumerate(futures):
+            if error is not None:
+                future.set_exception(error)
+                continue
+            costs, error_msg = batch_future.result()[i]
+            if error_msg is not None:
+                future.set_exception(RuntimeError(error_msg))
+                continue
+            if self.evaluator_config.adaptive:
+                self._fastest_costs.update(keys[i], costs)
+            future.set_result(costs)
+
     def _sanity_check(self) -> None:
         def _check(
             f_create_session,
@@ -351,6 +442,7 @@ def _worker_func(
     rpc_config: RPCConfig,
     evaluator_config: EvaluatorConfig,
     alloc_repeat: int,
+    max_retries: int,
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
@@ -383,15 +475,24 @@ def _worker_func(
                 f_cleanup(session, remote_path)
 
     with resource_handler():
-        # Step 1. Create session
-        with Profiler.timeit("RPCRunner/create_session"):
-            session = f_create_session(rpc_config)
-            device = session.device(dev_type=device_type, dev_id=0)
-        # Step 2. Upload the module
-        with Profiler.timeit("RPCRunner/upload_module"):
-            _, remote_path = osp.split(artifact_path)
-            local_path: str = artifact_path
-            rt_mod: Module = f_upload_module(session, local_path, remote_path)
+        for attempt in range(max_retries + 1):
+            try:
+                # Step 1. Create session
+                with Profiler.timeit("RPCRunner/create_session"):
+                    session = f_create_session(rpc_config)
+                    device = session.device(dev_type=device_type, dev_id=0)
+                # Step 2. Upload the module
+                with Profiler.timeit("RPCRunner/upload_module"):
+                    _, remote_path = osp.split(artifact_path)
+                    local_path: str = artifact_path
+                    rt_mod: Module = f_upload_module(session, local_path, remote_path)
+                break
+            except Exception as error:  # pylint: disable=broad-except
+                if attempt == max_retries:
+                    raise
+                logger.warning("RPCRunner: Retrying on another device, because %s", error)
+                # The workspace of the failed session is dropped along with the session.
+                session, remote_path = None, None
         # Step 3: Allocate input arguments
         with Profiler.timeit("RPCRunner/alloc_argument"):
             repeated_args: List[T_ARGUMENT_LIST] = f_alloc_argument(
@@ -412,6 +513,118 @@ def _worker_func(
     return costs
 
 
+def _batch_worker_func(
+    _f_create_session: Union[T_CREATE_SESSION, str, None],
+    _f_upload_module: Union[T_UPLOAD_MODULE, str, None],
+    _f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None],
+    _f_run_evaluator: Union[T_RUN_EVALUATOR, str, None],
+    _f_cleanup: Union[T_CLEANUP, str, None],
+    rpc_config: RPCConfig,
+    evaluator_configs: List[EvaluatorConfig],
+    alloc_repeat: int,
+    max_retries: int,
+    artifact_paths: List[str],
+    device_types: List[str],
+    args_infos: List[T_ARG_INFO_JSON_OBJ_LIST],
+) -> List[Tuple[Optional[List[float]], Optional[str]]]:
+    # Step 0. Get the registered functions
+    f_create_session: T_CREATE_SESSION = get_global_func_with_default_on_worker(
+        _f_create_session, default_create_session
+    )
+    f_upload_module: T_UPLOAD_MODULE = get_global_func_with_default_on_worker(
+        _f_upload_module, default_upload_module
+    )
+    f_alloc_argument: T_ALLOC_ARGUMENT = get_global_func_with_default_on_worker(
+        _f_alloc_argument, default_alloc_argument
+    )
+    f_run_evaluator: T_RUN_EVALUATOR = get_global_func_with_default_on_worker(
+        _f_run_evaluator, default_run_evaluator
+    )
+    f_cleanup: T_CLEANUP = get_global_func_with_default_on_worker(_f_cleanup, default_cleanup)
+    # Managed resources
+    session: Optional[RPCSession] = None
+    remote_paths: List[str] = []
+
+    @contextmanager
+    def resource_handler():
+        try:
+            yield
+        finally:
+            # Final step. Always clean up, after all the modules of the batch have run, because
+            # the cleanup may remove the workspace once it is empty
+            with Profiler.timeit("RPCRunner/cleanup"):
+                if not remote_paths:
+                    f_cleanup(session, None)
+                for remote_path in remote_paths:
+                    f_cleanup(session, remote_path)
+
+    results: List[Tuple[Optional[List[float]], Optional[str]]] = [
+        (None, None) for _ in artifact_paths
+    ]
+    with resource_handler():
+        # Step 1. Create session
+        for attempt in range(max_retries + 1):
+            try:
+                with Profiler.timeit("RPCRunner/create_session"):
+                    session = f_create_session(rpc_config)
+                break
+            except Exception as error:  # pylint: disable=broad-except
+                if attempt == max_retries:
+                    raise
+                logger.warning("RPCRunner: Retrying on another device, because %s", error)
+        # Step 2. Upload and load all the modules, under distinct remote names
+        rt_mods: List[Optional[Module]] = []
+        for i, artifact_path in enumerate(artifact_paths):
+            try:
+                with Profiler.timeit("RPCRunner/upload_module"):
+                    remote_path = f"{i}_{osp.basename(artifact_path)}"
+                    remote_paths.append(remote_path)
+                    rt_mods.append(f_upload_module(session, artifact_path, remote_path))
+            except Exception as error:  # pylint: disable=broad-except
+                rt_mods.append(None)
+                results[i] = (None, "RPCRunner: An exception occurred\n" + str(error))
+        # Step 3. Allocate the arguments once per device and argument info, and run back-to-back
+        repeated_args_cache: Dict[str, List[T_ARGUMENT_LIST]] = {}
+        best_costs: Dict[str, List[float]] = {}
+        for i, rt_mod in enumerate(rt_mods):
+            if rt_mod is None:
+                continue
+            key = FastestCosts.key(device_types[i], args_infos[i])
+            evaluator_config = evaluator_configs[i]
+            # The adaptive measurement also compares with the fastest candidate of the batch
+            if evaluator_config.adaptive and key in best_costs:
+                reference = evaluator_config.reference_costs
+                best = best_costs[key]
+                if not reference or sum(best) / len(best) < sum(reference) / len(reference):
+                    evaluator_config = evaluator_config._replace(reference_costs=tuple(best))
+            try:
+                device = session.device(dev_type=device_types[i], dev_id=0)
+                if key not in repeated_args_cache:
+                    with Profiler.timeit("RPCRunner/alloc_argument"):
+                        repeated_args_cache[key] = f_alloc_argument(
+                            session,
+                            device,
+                            args_infos[i],
+                            alloc_repeat,
+                        )
+                with Profiler.timeit("RPCRunner/run_evaluator"):
+                    costs: List[float] = f_run_evaluator(
+                        session,
+                        rt_mod,
+                        device,
+                        evaluator_config,
+                        repeated_args_cache[key],
+                    )
+            except Exception as error:  # pylint: disable=broad-except
+                results[i] = (None, "RPCRunner: An exception occurred\n" + str(error))
+                continue
+            results[i] = (costs, None)
+            best = best_costs.get(key, None)
+            if costs and (best is None or sum(costs) / len(costs) < sum(best) / len(best)):
+                best_costs[key] = costs
+    return results
+
+
 def default_create_session(rpc_config: RPCConfig) -> RPCSession:
     """Default function to create the session
 
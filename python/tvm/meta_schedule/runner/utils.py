@@ -16,7 +16,9 @@
 # under the License.
 """Runner utility functions"""
 import itertools
-from typing import Any, Callable, Dict, List
+import math
+import threading
+from typing import Any, Callable, Dict, List, Optional, Tuple
 
 from ...runtime import Device, Module, ndarray
 from .config import EvaluatorConfig
@@ -101,6 +103,8 @@ def run_evaluator_common(
     costs: List[float]
         The evaluator results
     """
+    if evaluator_config.adaptive:
+        return _run_evaluator_adaptive(rt_mod, device, evaluator_config, repeated_args)
     evaluator = rt_mod.time_evaluator(
         func_name=rt_mod.entry_name,
         dev=device,
@@ -118,3 +122,122 @@ def run_evaluator_common(
         repeated_costs.append(profile_result.results)
     costs = [float(cost) for cost in itertools.chain.from_iterable(repeated_costs)]
     return costs
+
+
+def _run_evaluator_adaptive(
+    rt_mod: Module,
+    device: Device,
+    evaluator_config: EvaluatorConfig,
+    repeated_args: List[T_ARGUMENT_LIST],
+) -> List[float]:
+    """Repeat the measurement one at a time, cycling through the repeated arguments, until the
+    confidence interval of the mean cost separates from the one of the reference costs."""
+    evaluator = rt_mod.time_evaluator(
+        func_name=rt_mod.entry_name,
+        dev=device,
+        number=evaluator_config.number,
+        repeat=1,
+        min_repeat_ms=evaluator_config.min_repeat_ms,
+        f_preproc="cache_flush_cpu_non_first_arg"
+        if evaluator_config.enable_cpu_cache_flush
+        else "",
+    )
+    reference = evaluator_config.reference_costs
+    min_repeat = max(evaluator_config.repeat, 2)
+    max_repeat = max(evaluator_config.max_repeat, min_repeat)
+    costs: List[float] = []
+    for i in range(max_repeat):
+        args = repeated_args[i % len(repeated_args)]
+        device.sync()
+        costs.extend(float(cost) for cost in evaluator(*args).results)
+        if len(costs) < min_repeat:
+            continue
+        if not reference or confidence_intervals_separate(costs, reference):
+            break
+    return costs
+
+
+# The 97.5% quantiles of Student's t-distribution with 1 to 30 degrees of freedom
+# fmt: off
+_T_QUANTILES = (
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+)
+# fmt: on
+
+
+def confidence_interval(costs: List[float]) -> Tuple[float, float]:
+    """The 95% confidence interval of the mean cost
+
+    Parameters
+    ----------
+    costs: List[float]
+        The costs measured
+
+    Returns
+    -------
+    interval: Tuple[float, float]
+        The lower and upper bounds of the interval, which is unbounded for less than 2 costs
+    """
+    num = len(costs)
+    if num < 2:
+        return (-math.inf, math.inf)
+    mean = sum(costs) / num
+    std = math.sqrt(sum((cost - mean) ** 2 for cost in costs) / (num - 1))
+    quantile = _T_QUANTILES[num - 2] if num - 1 <= len(_T_QUANTILES) else 1.960
+    radius = quantile * std / math.sqrt(num)
+    return (mean - radius, mean + radius)
+
+
+def confidence_intervals_separate(costs: List[float], reference: List[float]) -> bool:
+    """Whether the 95% confidence intervals of the mean costs of two candidates are disjoint,
+    i.e. one of them is provably faster than the other
+
+    Parameters
+    ----------
+    costs: List[float]
+        The costs of a candidate
+    reference: List[float]
+        The costs of the other candidate
+
+    Returns
+    -------
+    separate: bool
+        Whether the confidence intervals are disjoint
+    """
+    lower, upper = confidence_interval(costs)
+    ref_lower, ref_upper = confidence_interval(reference)
+    return lower > ref_upper or upper < ref_lower
+
+
+class FastestCosts:
+    """The costs of the fastest candidate measured so far by a runner of each workload, which are
+    the reference costs in the adaptive measurement. As the runner does not know the workloads, the
+    candidates are grouped by the device type and the arguments they run on."""
+
+    def __init__(self) -> None:
+        self._costs: Dict[str, List[float]] = {}
+        self._lock = threading.Lock()
+
+    @staticmethod
+    def key(device_type: str, args_info: T_ARG_INFO_JSON_OBJ_LIST) -> str:
+        """The key of the group of a candidate"""
+        return str((device_type, args_info))
+
+    def config(self, evaluator_config: EvaluatorConfig, key: str) -> EvaluatorConfig:
+        """The evaluator configuration with the reference costs of a group"""
+        if not evaluator_config.adaptive:
+            return evaluator_config
+        with self._lock:
+            costs = self._costs.get(key, None)
+        return evaluator_config._replace(reference_costs=None if costs is None else tuple(costs))
+
+    def update(self, key: str, costs: Optional[List[float]]) -> None:
+        """Update the fastest costs of a group with the costs of a candidate, if it is faster"""
+        if not costs:
+            return
+        with self._lock:
+            best = self._costs.get(key, None)
+            if best is None or sum(costs) / len(costs) < sum(best) / len(best):
+                self._costs[key] = list(costs)
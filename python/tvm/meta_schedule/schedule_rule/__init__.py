@@ -24,8 +24,10 @@ from .apply_custom_rule import ApplyCustomRule
 from .auto_bind import AutoBind
 from .auto_inline import AutoInline, InlineConstantScalars
 from .cross_thread_reduction import CrossThreadReduction
+from .gemv import GEMV
 from .multi_level_tiling import (
     MultiLevelTiling,
+    MultiLevelTilingSplitK,
     MultiLevelTilingTensorCore,
     MultiLevelTilingWideVector,
     MultiLevelTilingWithIntrin,
@@ -26,7 +26,8 @@ from .schedule_rule import ScheduleRule
 @register_object("meta_schedule.CrossThreadReduction")
 class CrossThreadReduction(ScheduleRule):
     """A schedule rule which applies cross-thread reduction to some reduction blocks
-    correspondingly when needed
+    correspondingly when needed. On CUDA, a long reduction of a few rows is also tried across
+    the blocks of a grid in one kernel.
 
     Parameters
     ----------
@@ -0,0 +1,60 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A rule which schedules the GEMV-like reductions for the memory bandwidth"""
+from typing import List, Optional
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.GEMV")
+class GEMV(ScheduleRule):
+    """A schedule rule which schedules the GEMV-like reductions, e.g. the matrix-vector products
+    of LLM decoding with their dequantization inlined, for the memory bandwidth. A reduction is
+    GEMV-like if one of its inputs is indexed by all its iters and contiguous along the reduction.
+    Each row is reduced by the threadIdx.x lanes, which load vectors of up to 128 bits into their
+    registers and accumulate in a register before being reduced across the threads, and a few
+    rows are bound to threadIdx.y of a thread block.
+
+    The block scheduled is annotated so that the rules after this one skip it, while they still
+    apply to the unscheduled branch. The rule is meant to follow AutoInline, and to precede
+    MultiLevelTiling and CrossThreadReduction.
+
+    Parameters
+    ----------
+    thread_extents: Optional[List[int]]
+        Candidates of the number of threadIdx.x lanes reducing a row.
+    rows_per_block: Optional[List[int]]
+        Candidates of the number of rows of a thread block.
+    """
+
+    def __init__(
+        self,
+        thread_extents: Optional[List[int]] = None,
+        rows_per_block: Optional[List[int]] = None,
+    ) -> None:
+        if thread_extents is None:
+            thread_extents = [32, 64, 128, 256]
+        if rows_per_block is None:
+            rows_per_block = [1, 2, 4]
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleGEMV,  # type: ignore # pylint: disable=no-member
+            thread_extents,
+            rows_per_block,
+        )
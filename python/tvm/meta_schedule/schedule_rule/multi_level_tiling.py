@@ -206,6 +206,9 @@ class MultiLevelTilingWideVector(ScheduleRule):
         Data reuse configuration for reading. None means no reuse.
     reuse_write : Optional[ReuseType]
         Data reuse configuration for writing. None means no reuse.
+    use_software_pipeline : bool
+        Whether to pipeline the read caches with the computation, the copies of the next
+        iteration running asynchronously, e.g. by DMA into VTCM on Hexagon.
     """
 
     def __init__(
@@ -215,6 +218,7 @@ class MultiLevelTilingWideVector(ScheduleRule):
         max_innermost_factor: Optional[int] = None,
         reuse_read: Optional[ReuseType] = None,
         reuse_write: Optional[ReuseType] = None,
+        use_software_pipeline: bool = False,
     ) -> None:
         self.__init_handle_by_constructor__(
             _ffi_api.ScheduleRuleMultiLevelTilingWideVector,  # type: ignore # pylint: disable=no-member
@@ -223,4 +227,64 @@ class MultiLevelTilingWideVector(ScheduleRule):
             max_innermost_factor,
             reuse_read.as_dict() if reuse_read is not None else None,
             reuse_write.as_dict() if reuse_write is not None else None,
+            use_software_pipeline,
+        )
+
+
+@register_object("meta_schedule.MultiLevelTilingSplitK")
+class MultiLevelTilingSplitK(ScheduleRule):
+    """Extension of MultiLevelTiling with split-K for the reductions of a few outputs and a long
+    reduction, e.g. the GEMMs of LLM decoding. The fused reduction loop is split into a sampled
+    number of partitions, the partial sums of the partitions are computed by a block multi-level
+    tiled over the partitions and the spatial axes, and the original block adds them up as the
+    epilogue. The schedules without split-K are kept, so that the rule replaces MultiLevelTiling.
+
+    Parameters
+    ----------
+    split_factors : List[int]
+        The candidates of the number of partitions of the reduction. Only the ones dividing the
+        reduction extent are sampled.
+    max_spatial_extent : int
+        The maximum spatial extent of a block to be split.
+    min_reduction_extent : int
+        The minimum reduction extent of a block to be split.
+    structure : str
+        The tiling structure. 'SSSRRSRS' is recommended.
+    tile_bind : Optional[List[str]]
+        For each level of tiles, which thread axis it is bound to. Recommended:
+        [blockIdx.x, vthread.x, threadIdx.x]
+    max_innermost_factor : Optional[int]
+        The maximum size of the innermost factor. None means no limit
+    vector_load_lens : Optional[List[int]]
+        The length of vector lane in vectorized cooperative fetching.
+        None means disable vectorization
+    reuse_read : Optional[ReuseType]
+        Data reuse configuration for reading. None means no reuse.
+    reuse_write : Optional[ReuseType]
+        Data reuse configuration for writing. None means no reuse.
+    """
+
+    def __init__(
+        self,
+        split_factors: List[int],
+        max_spatial_extent: int,
+        min_reduction_extent: int,
+        structure: str,
+        tile_binds: Optional[List[str]] = None,
+        max_innermost_factor: Optional[int] = None,
+        vector_load_lens: Optional[List[int]] = None,
+        reuse_read: Optional[ReuseType] = None,
+        reuse_write: Optional[ReuseType] = None,
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleMultiLevelTilingSplitK,  # type: ignore # pylint: disable=no-member
+            split_factors,
+            max_spatial_extent,
+            min_reduction_extent,
+            structure,
+            tile_binds,
+            max_innermost_factor,
+            vector_load_lens,
+            reuse_read.as_dict() if reuse_read is not None else None,
+            reuse_write.as_dict() if reuse_write is not None else None,
         )
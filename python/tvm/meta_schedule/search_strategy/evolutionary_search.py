@@ -45,6 +45,11 @@ class EvolutionarySearch(SearchStrategy):
         The maximum number to retry mutation.
     eps_greedy : float
         The ratio of greedy selected samples in the final picks.
+    num_warm_start_workloads : int
+        The number of the workloads of the same computation but of the nearest shapes in the
+        database to warm start from. The cost model is pretrained on their records, and their best
+        traces, with the tile sizes adapted to the shapes, seed the initial population. Zero means
+        no warm start.
     """
 
     population_size: int
@@ -54,6 +59,7 @@ class EvolutionarySearch(SearchStrategy):
     genetic_mutate_prob: float
     genetic_max_fail_count: int
     eps_greedy: float
+    num_warm_start_workloads: int
 
     def __init__(
         self,
@@ -66,6 +72,7 @@ class EvolutionarySearch(SearchStrategy):
         genetic_mutate_prob: float = 0.85,
         genetic_max_fail_count: int = 10,
         eps_greedy: float = 0.05,
+        num_warm_start_workloads: int = 0,
     ) -> None:
         """Constructor"""
         self.__init_handle_by_constructor__(
@@ -78,4 +85,5 @@ class EvolutionarySearch(SearchStrategy):
             genetic_mutate_prob,
             genetic_max_fail_count,
             eps_greedy,
+            num_warm_start_workloads,
         )
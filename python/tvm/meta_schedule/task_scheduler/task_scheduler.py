@@ -102,6 +102,7 @@ class TaskScheduler(Object):
         measure_callbacks: List[MeasureCallback],
         database: Optional[Database],
         cost_model: Optional[CostModel],
+        pipeline_depth: int = 1,
     ) -> None:
         """Auto-tuning.
 
@@ -127,6 +128,9 @@ class TaskScheduler(Object):
             The database.
         cost_model : Optional[CostModel]
             The cost model.
+        pipeline_depth : int
+            The max number of batches of a task in flight at the same time. With a depth larger
+            than 1, the next batch is generated and built while the previous ones are measured.
         """
         task_weights = [float(w) for w in task_weights]
         _ffi_api.TaskSchedulerTune(  # type: ignore # pylint: disable=no-member
@@ -141,6 +145,7 @@ class TaskScheduler(Object):
             measure_callbacks,
             database,
             cost_model,
+            pipeline_depth,
         )
 
     def terminate_task(self, task_id: int) -> None:
@@ -238,11 +243,13 @@ class PyTaskScheduler:
         task_weights: List[float],
         max_trials_global: int,
         max_trials_per_task: int,
+        num_trials_per_iter: int,
         builder: Builder,
         runner: Runner,
         measure_callbacks: List[MeasureCallback],
         database: Optional[Database],
         cost_model: Optional[CostModel],
+        pipeline_depth: int = 1,
     ) -> None:
         """Auto-tuning."""
         # Using self._outer to replace the self pointer
@@ -252,11 +259,13 @@ class PyTaskScheduler:
             task_weights,
             max_trials_global,
             max_trials_per_task,
+            num_trials_per_iter,
             builder,
             runner,
             measure_callbacks,
             database,
             cost_model,
+            pipeline_depth,
         )
 
     def next_task_id(self) -> int:
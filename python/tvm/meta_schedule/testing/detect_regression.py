@@ -0,0 +1,115 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Script re-measuring the tuned kernels of a JSON database to detect their regressions"""
+import argparse
+
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.utils import shash2hex
+from tvm.target import Target
+
+
+def _parse_args():
+    args = argparse.ArgumentParser()
+    args.add_argument(
+        "--work-dir",
+        type=str,
+        required=True,
+        help="The path to the work directory containing database files.",
+    )
+    args.add_argument(
+        "--target",
+        type=Target,
+        required=True,
+    )
+    args.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="The relative slowdown beyond which a kernel is reported.",
+    )
+    args.add_argument(
+        "--rpc-host",
+        type=str,
+        default=None,
+        help="The host of the RPC tracker, the kernels are measured locally if not given.",
+    )
+    args.add_argument(
+        "--rpc-port",
+        type=int,
+        default=None,
+    )
+    args.add_argument(
+        "--rpc-key",
+        type=str,
+        default=None,
+    )
+    args.add_argument(
+        "--number",
+        type=int,
+        default=3,
+    )
+    args.add_argument(
+        "--repeat",
+        type=int,
+        default=1,
+    )
+    args.add_argument(
+        "--min-repeat-ms",
+        type=int,
+        default=100,
+    )
+    return args.parse_args()
+
+
+def main():
+    """Main function"""
+    args = _parse_args()
+    evaluator_config = ms.runner.EvaluatorConfig(
+        number=args.number,
+        repeat=args.repeat,
+        min_repeat_ms=args.min_repeat_ms,
+    )
+    if args.rpc_host is None:
+        runner = ms.runner.LocalRunner(evaluator_config=evaluator_config)
+    else:
+        runner = ms.runner.RPCRunner(
+            rpc_config=ms.runner.RPCConfig(
+                tracker_host=args.rpc_host,
+                tracker_port=args.rpc_port,
+                tracker_key=args.rpc_key,
+                session_timeout_sec=600,
+            ),
+            evaluator_config=evaluator_config,
+        )
+    database = ms.database.create(work_dir=args.work_dir)
+    regressions = ms.regression.detect_regressions(
+        database, args.target, runner=runner, threshold=args.threshold
+    )
+    for regression in regressions:
+        name = regression.workload.mod.get_global_vars()[0].name_hint
+        measured = "failed"
+        if regression.measured_sec is not None:
+            measured = f"{regression.measured_sec * 1e6:.3f} us"
+        print(
+            f"{name} ({shash2hex(regression.workload.mod)}): stored "
+            f"{regression.stored_sec * 1e6:.3f} us, measured {measured}"
+        )
+    print(f"{len(regressions)} regressed kernel(s) found.")
+
+
+if __name__ == "__main__":
+    main()
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """RPC tracker and server running locally"""
+from typing import Callable, Optional
+
 from tvm.rpc.tracker import Tracker
 from tvm.rpc.server import Server
 
@@ -30,6 +32,8 @@ class LocalRPC:
         The port of the tracker
     tracker_key: str
         The key used in the tracker to refer to a worker
+    server_init_callback : Optional[Callable[[], None]]
+        The additional initialization function of the server
     """
 
     tracker_host: str
@@ -41,6 +45,7 @@ class LocalRPC:
         tracker_key: str = "key",
         silent: bool = False,
         no_fork: bool = False,
+        server_init_callback: Optional[Callable[[], None]] = None,
     ) -> None:
         self.tracker = Tracker(
             silent=silent,
@@ -56,6 +61,7 @@ class LocalRPC:
             no_fork=no_fork,
             port=9190,
             port_end=12345,
+            server_init_callback=server_init_callback,
         )
         self.tracker_host = self.tracker.host
         self.tracker_port = self.tracker.port
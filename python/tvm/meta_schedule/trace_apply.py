@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Specialized applications of trace"""
+from typing import List
+
 from ..tir.schedule import Schedule, Trace
 from ..ir.module import IRModule
 from ..target import Target
@@ -40,3 +42,40 @@ def schedule_using_anchor_trace(sch: Schedule, anchor_trace: Trace, record_mod:
         The compilation target
     """
     _ffi_api.ScheduleUsingAnchorTrace(sch, anchor_trace, record_mod, target)  # type: ignore
+
+
+def apply_trace_with_adapted_tiles(sch: Schedule, trace: Trace) -> None:
+    """Apply the trace tuned on a workload of the same computation but of different shapes, e.g. a
+    GEMM of another size. The sampled tiles whose product does not match the extent of the loop are
+    adapted to it, keeping the inner factors as far as they divide the extent.
+
+    Parameters
+    ----------
+    sch : Schedule
+        The target schedule
+    trace: Trace
+        The trace tuned on the other workload
+    """
+    _ffi_api.ApplyTraceWithAdaptedTiles(sch, trace)  # type: ignore
+
+
+def replay_traces(mod: IRModule, traces: List[Trace], seed: int) -> List[Schedule]:
+    """Replay the traces without their postprocessors one after another, each resuming from the
+    schedules checkpointed by the replays before it where it shares a prefix with their traces,
+    as the evolutionary search does for the mutants of a trace.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module to replay the traces on
+    traces : List[Trace]
+        The traces to replay
+    seed : int
+        The random seed of each schedule
+
+    Returns
+    -------
+    schs : List[Schedule]
+        The schedules replayed, the same as applying each trace to a new schedule of the seed
+    """
+    return list(_ffi_api.ReplayTraces(mod, traces, seed))  # type: ignore
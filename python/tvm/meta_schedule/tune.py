@@ -41,6 +41,7 @@ def tune_tasks(
     measure_callbacks: MeasureCallback.CallbackListType = "default",
     task_scheduler: TaskScheduler.TaskSchedulerType = "gradient",
     module_equality: str = "structural",
+    pipeline_depth: int = 1,
 ) -> Database:
     """Tune a list of tasks. Using a task scheduler.
 
@@ -80,6 +81,9 @@ def tune_tasks(
                             given module. The "ignore-ndarray" varint is used for the extracted
                             blocks or in case no anchor block is found.
                             For the definition of the anchor block, see tir/analysis/analysis.py.
+    pipeline_depth : int
+        The max number of batches of a task in flight at the same time. With a depth larger than 1,
+        the next batch of a task is generated and built while the previous ones are measured.
 
     Returns
     -------
@@ -119,5 +123,6 @@ def tune_tasks(
         measure_callbacks=measure_callbacks,
         database=database,
         cost_model=cost_model,
+        pipeline_depth=pipeline_depth,
     )
     return database
@@ -18,7 +18,7 @@
 import ctypes
 import os
 import shutil
-from typing import Any, Callable, List, Optional, Union
+from typing import Any, Callable, Dict, List, Optional, Union
 
 import numpy as np  # type: ignore
 import psutil  # type: ignore
@@ -213,6 +213,33 @@ def cpu_count(logical: bool = True) -> int:
     return _cpu_count_impl(logical)
 
 
+def cpu_cache_attrs() -> Dict[str, int]:
+    """Return the sizes of the data caches of the host CPU and of their lines in bytes, as the
+    attributes of an LLVM target, e.g. ``Target({"kind": "llvm", **cpu_cache_attrs()})``, with
+    which MultiLevelTiling seeds the search with the tiles fitting the caches.
+
+    Returns
+    -------
+    attrs : Dict[str, int]
+        The "l1-cache-size", "l2-cache-size", "l3-cache-size" and "cache-line-size" the system
+        reports, which may be none of them.
+    """
+    result = {}
+    for attr_name, sysconf_name in [
+        ("l1-cache-size", "SC_LEVEL1_DCACHE_SIZE"),
+        ("l2-cache-size", "SC_LEVEL2_CACHE_SIZE"),
+        ("l3-cache-size", "SC_LEVEL3_CACHE_SIZE"),
+        ("cache-line-size", "SC_LEVEL1_DCACHE_LINESIZE"),
+    ]:
+        try:
+            size = os.sysconf(sysconf_name)
+        except (AttributeError, ValueError, OSError):
+            continue
+        if size > 0:
+            result[attr_name] = size
+    return result
+
+
 @register_func("meta_schedule.using_ipython")
 def _using_ipython() -> bool:
     """Return whether the current process is running in an IPython shell.
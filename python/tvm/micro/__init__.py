@@ -16,10 +16,12 @@
 # under the License.
 """MicroTVM module for bare-metal backends"""
 from .build import autotvm_build_func
+from .build import build_candidates
 from .build import AutoTvmModuleLoader
 from .build import get_standalone_crt_dir
 from .build import get_microtvm_template_projects
 
+from .graph_plan import generate_graph_executor_plan
 from .model_library_format import (
     export_model_library_format,
     UnsupportedInModelLibraryFormatError,
@@ -109,6 +109,49 @@ def get_microtvm_template_projects(platform: str) -> str:
     return os.path.join(microtvm_template_projects, platform)
 
 
+def build_candidates(candidates, target, runtime=None, name_prefix: str = "candidate_"):
+    """Build several candidate implementations of an operator into one system library, so that
+    they are all measured on a device flashed once with `Session.batch_time_evaluator`.
+
+    Parameters
+    ----------
+    candidates : List[Tuple[tvm.te.Schedule, List[tvm.te.Tensor]]]
+        The schedule and the arguments of each candidate. The candidates should take the same
+        arguments to be measured in a batch.
+
+    target : tvm.target.Target
+        The target to build for.
+
+    runtime : Optional[tvm.relay.backend.Runtime]
+        The runtime, by default the CRT as a system library.
+
+    name_prefix : str
+        The prefix of the function names, which are followed by the index of the candidate.
+
+    Returns
+    -------
+    Tuple[tvm.runtime.Module, List[str]] :
+        The module and the function names of the candidates, in order.
+    """
+    # pylint: disable=import-outside-toplevel
+    from ..driver.build_module import build, lower
+    from ..relay.backend import Runtime
+
+    if runtime is None:
+        runtime = Runtime("crt", {"system-lib": True})
+    names = [f"{name_prefix}{i}" for i in range(len(candidates))]
+    mod = None
+    for name, (sch, args) in zip(names, candidates):
+        candidate_mod = lower(sch, args, name=name)
+        if mod is None:
+            mod = candidate_mod
+        else:
+            mod.update(candidate_mod)
+    if mod is None:
+        raise ValueError("No candidates to build.")
+    return build(mod, target=target, runtime=runtime), names
+
+
 class AutoTvmModuleLoader:
     """MicroTVM AutoTVM Module Loader
 
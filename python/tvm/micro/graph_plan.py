@@ -0,0 +1,132 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Generates the precomputed execution plan of a graph for the CRT graph executor."""
+
+import json
+import typing
+
+from ..runtime import DataType
+
+
+def _c_array(c_type: str, name: str, values: typing.List[str]) -> typing.Tuple[str, str]:
+    """The definition of a constant C array and the expression referring to it, which is NULL
+    for an empty array, as C does not allow them."""
+    if not values:
+        return "", "NULL"
+    lines = [f"static const {c_type} {name}[] = {{"]
+    lines.extend(f"    {value}," for value in values)
+    lines.append("};")
+    return "\n".join(lines) + "\n", name
+
+
+def generate_graph_executor_plan(graph_json: str, name: str = "graph") -> str:
+    """Generate the C source of the execution plan of a graph, which the CRT graph executor
+    runs with `TVMGraphExecutor_CreateFromPlan` instead of parsing the graph JSON at boot.
+
+    The plan is a flat table of the operators, with the entry ids of their arguments, and of the
+    data entries, with their storage ids, shapes and data types, and the sizes of the storages,
+    all emitted as constant C arrays that are placed in flash.
+
+    Parameters
+    ----------
+    graph_json : str
+        The graph JSON, as produced by the graph executor codegen.
+    name : str
+        The prefix of the C symbols. The plan is named `<name>_plan`.
+
+    Returns
+    -------
+    str :
+        The C source defining `const TVMGraphExecutorPlan <name>_plan`.
+    """
+    graph = json.loads(graph_json)
+    nodes = graph["nodes"]
+    node_row_ptr = graph["node_row_ptr"]
+    attrs = graph["attrs"]
+    storage_ids = attrs["storage_id"][1]
+    shapes = attrs["shape"][1]
+    dltypes = attrs["dltype"][1]
+
+    def entry_id(node_entry):
+        return node_row_ptr[node_entry[0]] + node_entry[1]
+
+    ops = []
+    args = []
+    for nid, node in enumerate(nodes):
+        if node["op"] == "null":
+            continue
+        if node["op"] != "tvm_op":
+            raise ValueError(f'Can only take tvm_op as op, but "{node["op"]}" is found.')
+        node_attrs = node["attrs"]
+        func_name = node_attrs["func_name"]
+        if func_name in ("__nop", "__copy"):
+            raise ValueError(f"{func_name} function is not yet supported.")
+        num_outputs = int(node_attrs.get("num_outputs", 1))
+        offset = len(args)
+        args.extend(entry_id(entry) for entry in node["inputs"])
+        args.extend(node_row_ptr[nid] + i for i in range(num_outputs))
+        flatten_data = int(node_attrs.get("flatten_data", 0))
+        ops.append(f"{{{json.dumps(func_name)}, {offset}, {len(args) - offset}, {flatten_data}}}")
+
+    if len(storage_ids) != node_row_ptr[-1]:
+        raise ValueError(
+            f"The graph has {node_row_ptr[-1]} entries, but {len(storage_ids)} storage ids"
+        )
+    entries = []
+    entry_shapes = []
+    storage_sizes: typing.Dict[int, int] = {}
+    for storage_id, shape, dltype in zip(storage_ids, shapes, dltypes):
+        dtype = DataType(dltype)
+        entries.append(
+            f"{{{storage_id}, {len(entry_shapes)}, {len(shape)}, "
+            f"{{{dtype.type_code}, {dtype.bits}, {dtype.lanes}}}}}"
+        )
+        entry_shapes.extend(str(dim) for dim in shape)
+        size = (dtype.bits * dtype.lanes + 7) // 8
+        for dim in shape:
+            size *= dim
+        storage_sizes[storage_id] = max(storage_sizes.get(storage_id, 0), size)
+    storage_count = max(storage_sizes) + 1 if storage_sizes else 0
+    storage_size_values = [str(storage_sizes.get(i, 0)) for i in range(storage_count)]
+
+    inputs = graph["arg_nodes"]
+    output_entries = [str(entry_id(entry)) for entry in graph["heads"]]
+
+    # The fields of TVMGraphExecutorPlan in order, with whether each array is followed by its count
+    arrays = [
+        ("TVMGraphExecutorPlanOp", "ops", ops, True),
+        ("uint32_t", "args", [str(arg) for arg in args], True),
+        ("TVMGraphExecutorPlanEntry", "entries", entries, True),
+        ("int64_t", "shapes", entry_shapes, False),
+        ("uint32_t", "storage_sizes", storage_size_values, True),
+        ("char* const", "input_names", [json.dumps(nodes[nid]["name"]) for nid in inputs], False),
+        ("uint32_t", "input_entries", [str(node_row_ptr[nid]) for nid in inputs], True),
+        ("uint32_t", "output_entries", output_entries, True),
+    ]
+    source = ["#include <tvm/runtime/crt/graph_executor.h>", ""]
+    fields = []
+    for c_type, suffix, values, has_count in arrays:
+        definition, ref = _c_array(c_type, f"{name}_{suffix}", values)
+        if definition:
+            source.append(definition)
+        fields.append(f"    {ref},")
+        if has_count:
+            fields.append(f"    {len(values)},")
+    source.append(f"const TVMGraphExecutorPlan {name}_plan = {{")
+    source.extend(fields)
+    source.append("};")
+    return "\n".join(source) + "\n"
@@ -23,13 +23,16 @@ import sys
 import os
 import pathlib
 import shutil
-from typing import Union
+import struct
+from typing import List, Union
 from ..error import register_error
 from .._ffi import get_global_func, register_func
 from ..contrib import graph_executor
 from ..contrib import utils
 from ..contrib.debugger import debug_executor
 from ..rpc import RPCSession
+from ..rpc.base import RPC_SESS_MASK
+from ..runtime.module import BenchmarkResult
 from . import project
 from .transport import IoTimeoutError
 from .transport import TransportLogger
@@ -96,6 +99,78 @@ class Session:
     def get_system_lib(self):
         return self._rpc.get_function("runtime.SystemLib")()
 
+    def batch_time_evaluator(
+        self,
+        func_names: List[str],
+        number: int = 10,
+        repeat: int = 1,
+        min_repeat_ms: int = 0,
+        limit_zero_time_iterations: int = 100,
+        cooldown_interval_ms: int = 0,
+        repeats_to_cooldown: int = 1,
+    ):
+        """Get an evaluator timing several functions of the system library in turn on the device,
+        as `Module.time_evaluator` does for one, in a single round-trip over the transport.
+
+        This measures several candidates built into one firmware image by `build_candidates`, so
+        that the device is flashed once and the results of all of them are sent back together.
+
+        Parameters
+        ----------
+        func_names : List[str]
+            The names of the functions, which take the same arguments.
+
+        number : int
+            The number of times to run each function for taking the average.
+
+        repeat : int
+            The number of times to repeat the measurement of each function.
+
+        min_repeat_ms : int
+            The minimum duration of one `repeat` in milliseconds.
+
+        limit_zero_time_iterations : int
+            The maximum number of repeats when the measured time is equal to 0.
+
+        cooldown_interval_ms : int
+            The cooldown interval in milliseconds between the number of repeats defined by
+            `repeats_to_cooldown`.
+
+        repeats_to_cooldown : int
+            The number of repeats before the cooldown is activated.
+
+        Returns
+        -------
+        ftimer : function
+            The function that takes the arguments of the functions and returns a list of
+            BenchmarkResult, one per function in order.
+        """
+        if not func_names or any("," in name for name in func_names):
+            raise ValueError(f"Expect non-empty function names without commas, got {func_names}")
+        feval = self._rpc.get_function("runtime.RPCBatchTimeEvaluator")(
+            self.get_system_lib(),
+            ",".join(func_names),
+            self.device.device_type % RPC_SESS_MASK,
+            self.device.device_id,
+            number,
+            repeat,
+            min_repeat_ms,
+            limit_zero_time_iterations,
+            cooldown_interval_ms,
+            repeats_to_cooldown,
+            "",
+        )
+
+        def evaluator(*args):
+            blob = feval(*args)
+            results = struct.unpack("@" + "d" * (repeat * len(func_names)), blob)
+            return [
+                BenchmarkResult(results[i * repeat : (i + 1) * repeat])
+                for i in range(len(func_names))
+            ]
+
+        return evaluator
+
     def create_aot_executor(self):
         return self._rpc.get_function("tvm.aot_executor.create")(
             self.get_system_lib(), self.device, "default"
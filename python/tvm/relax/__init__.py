@@ -20,6 +20,8 @@ from . import exec_builder
 from . import expr
 from . import ty
 from . import vm
+from . import aot
+from . import prepack
 from . import block_builder
 from . import op
 from . import analysis
@@ -69,10 +71,13 @@ PackedFuncType = ty.PackedFuncType
 # VM
 ExecBuilder = exec_builder.ExecBuilder
 VirtualMachine = vm.VirtualMachine
+NUMAReplicas = vm.NUMAReplicas
+ShapeDispatcher = vm.ShapeDispatcher
+ShapeSpecializer = vm.ShapeSpecializer
 
 # Operator
 from .op.base import call_tir, make_closure, invoke_closure
-from .op.op_attrs import VMAllocStorageAttrs, VMAllocTensorAttrs
+from .op.op_attrs import VMAllocStorageAttrs, VMAllocTensorAttrs, VMAllocOutputAttrs
 
 # IRBuilder
 BlockBuilder = block_builder.BlockBuilder
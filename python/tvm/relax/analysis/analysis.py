@@ -61,6 +61,68 @@ def well_formed(mod: tvm.IRModule) -> bool:
     return _ffi_api.well_formed(mod)  # type: ignore
 
 
+@tvm._ffi.register_object("relax.analysis.AnalysisManager")
+class AnalysisManager(tvm.runtime.Object):
+    """The manager of the analysis results of the functions across the passes of a pipeline.
+
+    The results of a function are cached by its identity, so that only the functions a pass
+    changed are analyzed again. Within its scope, `well_formed` and `udchain` reuse its results.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        manager = relax.analysis.AnalysisManager()
+        with manager:
+            for pass_ in passes:
+                mod = pass_(mod)
+                manager.invalidate(mod)
+                assert relax.analysis.well_formed(mod)
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(_ffi_api.AnalysisManager)  # type: ignore
+
+    def __enter__(self):
+        _ffi_api.AnalysisManagerEnterScope(self)  # type: ignore
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        _ffi_api.AnalysisManagerExitScope(self)  # type: ignore
+
+    def well_formed(self, mod: tvm.IRModule) -> bool:
+        """Check if the IRModule is well formed, checking again only the functions not given to
+        the manager before.
+
+        Parameters
+        ----------
+        mod : tvm.IRModule
+            The input IRModule.
+
+        Returns
+        -------
+        ret: bool
+            True if the IRModule is well formed, False if not.
+        """
+        return _ffi_api.AnalysisManagerWellFormed(self, mod)  # type: ignore
+
+    def invalidate(self, mod: tvm.IRModule) -> None:
+        """Drop the results of the functions which are not in the IRModule, i.e. the functions a
+        pass changed or removed.
+
+        Parameters
+        ----------
+        mod : tvm.IRModule
+            The IRModule after the pass.
+        """
+        _ffi_api.AnalysisManagerInvalidate(self, mod)  # type: ignore
+
+    @property
+    def num_cached_functions(self) -> int:
+        """The number of functions with cached results."""
+        return _ffi_api.AnalysisManagerNumCachedFunctions(self)  # type: ignore
+
+
 def get_var2val(func: Function) -> Dict[Var, Expr]:
     """
     Get a mapping from Var to Expr for each variable in the function.
@@ -0,0 +1,146 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Ahead-of-time compilation of Relax modules with static shapes, without the VM."""
+from typing import Dict, List, Optional, Union
+
+import numpy as np  # type: ignore
+
+import tvm
+from tvm import relax
+from tvm.ir.memory_pools import WorkspaceMemoryPools, WorkspacePoolInfo
+from tvm.ir.module import IRModule
+from tvm.runtime import Module, NDArray
+
+# This should be kept identical to runtime::symbol::tvm_module_main
+MAIN_FUNC_NAME_STR = "__tvm_main__"
+
+
+class AOTModule:
+    """A Relax module compiled ahead-of-time, whose main function calls the kernels directly.
+
+    Parameters
+    ----------
+    lib : tvm.runtime.Module
+        The compiled module, holding the main function and the kernels.
+
+    entry : str
+        The symbol of the main function.
+
+    outputs : List[tvm.tir.Buffer]
+        The buffers of the outputs of the main function.
+
+    pool_sizes : List[int]
+        The sizes of the workspace pools planned by USMP, in bytes.
+
+    device : tvm.runtime.Device
+        The device of the inputs and the outputs.
+    """
+
+    def __init__(self, lib: Module, entry: str, outputs, pool_sizes: List[int], device) -> None:
+        self.lib = lib
+        self.entry = entry
+        self._outputs = outputs
+        self._device = device
+        self._pools = [tvm.nd.empty((size,), "uint8", device) for size in pool_sizes]
+
+    def __call__(self, *inputs):
+        args = [
+            arg if isinstance(arg, NDArray) else tvm.nd.array(arg, self._device) for arg in inputs
+        ]
+        outputs = [
+            tvm.nd.empty([int(dim) for dim in buf.shape], buf.dtype, self._device)
+            for buf in self._outputs
+        ]
+        self.lib[self.entry](*args, *outputs, *self._pools)
+        return outputs[0] if len(outputs) == 1 else outputs
+
+    def export_library(self, file_name: str, **kwargs) -> None:
+        """Export the compiled module to a shared library."""
+        self.lib.export_library(file_name, **kwargs)
+
+
+def build(
+    mod: IRModule,
+    target: Union[str, tvm.target.Target],
+    params: Optional[Dict[str, np.ndarray]] = None,
+    mod_name: str = "default",
+    workspace_memory_pools: Optional[WorkspaceMemoryPools] = None,
+) -> AOTModule:
+    """
+    Build an IRModule with static shapes into a flat entry function calling the kernels, with the
+    intermediate tensors planned into the workspace pools by USMP.
+
+    Parameters
+    ----------
+    mod: IRModule
+        The input IRModule to be built. Its only Relax function is main.
+
+    target : Union[str, tvm.target.Target]
+        A CPU build target.
+
+    params: Optional[Dict[str, np.ndarray]]
+        Parameters of main to bind as constants.
+
+    mod_name: str
+        The name of the module, which prefixes the symbol of the entry function.
+
+    workspace_memory_pools: Optional[WorkspaceMemoryPools]
+        The pools to plan the intermediate tensors into, by default a single pool of the target.
+
+    Returns
+    -------
+    ret: AOTModule
+        The compiled module.
+    """
+    if isinstance(target, str):
+        target = tvm.target.Target(target)
+
+    if params:
+        mod = relax.transform.BindParams("main", params)(mod)
+    passes = [relax.transform.DeduplicatePrimFuncs()]
+    passes.append(relax.transform.ToNonDataflow())
+    passes.append(relax.transform.CallTIRRewrite())
+    passes.append(relax.transform.InplaceElementwise())
+    passes.append(relax.transform.AttachGlobalSymbol())
+    passes.append(relax.transform.AOTLowerMain(mod_name))
+    tir_mod = tvm.transform.Sequential(passes)(mod)
+
+    if workspace_memory_pools is None:
+        workspace_memory_pools = WorkspaceMemoryPools(
+            [WorkspacePoolInfo("global_workspace", [target])]
+        )
+    tir_mod = tir_mod.with_attr("executor", tvm.relay.backend.Executor("aot"))
+    tir_mod = tir_mod.with_attr("runtime", tvm.relay.backend.Runtime("cpp"))
+    tir_mod = tir_mod.with_attr("workspace_memory_pools", workspace_memory_pools)
+    tir_mod = tvm.tir.transform.BindTarget(target)(tir_mod)
+    if tvm.transform.PassContext.current().config.get("tir.usmp.enable", True):
+        tir_mod = tvm.tir.transform.UnifiedStaticMemoryPlanner()(tir_mod)
+    tir_mod = tvm.tir.transform.LegalizePackedCalls()(tir_mod)
+
+    main = tir_mod[MAIN_FUNC_NAME_STR]
+    outputs = [main.buffer_map[var] for var in main.attrs["output_vars"]]
+    pool_args = main.attrs["pool_args"] if "pool_args" in main.attrs else []
+    pool_args = sorted(pool_args, key=lambda pool: int(pool.pool_var_idx))
+    lib = tvm.build(tir_mod, target=target)
+    return AOTModule(
+        lib,
+        str(main.attrs["global_symbol"]),
+        outputs,
+        [int(pool.allocated_size) for pool in pool_args],
+        tvm.device(target.kind.name, 0),
+    )
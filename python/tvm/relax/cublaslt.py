@@ -0,0 +1,214 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Offload of the matmuls, with their bias and activation epilogues, to cuBLASLt.
+
+The chains matmul -> add -> activation matched by `gemm_pattern` are outlined into functions
+with Codegen="cublaslt", which relax.transform.RunCodegen compiles to one call of the cuBLASLt
+matmul each, with the bias and the activation fused in its epilogue.
+"""
+from typing import Dict, List, Optional
+
+import tvm
+from tvm import te
+from tvm.contrib import cublaslt
+from tvm.ir.module import IRModule
+
+from .analysis import get_var2val, remove_all_unused, udchain
+from .block_builder import BlockBuilder
+from .dpl import DFPattern, is_op, wildcard
+from .expr import Call, DataflowBlock, DataflowVar, Expr, Function, SeqExpr, ShapeExpr, Var
+from .expr_functor import mutator, PyExprMutator
+
+_ACTIVATIONS = {"relax.nn.relu": "relu", "relax.nn.gelu": "gelu"}
+
+
+def gemm_pattern(approximate_gelu: bool = False) -> DFPattern:
+    """The pattern of a relax.nn.dense or relax.nn.matmul, optionally followed by the add of a
+    bias, then optionally by a relu, which cuBLASLt runs in one kernel.
+
+    The GELU epilogue of cuBLASLt is the tanh approximation of the exact relax.nn.gelu, so a gelu
+    is only matched when `approximate_gelu` allows the approximation.
+    """
+    lhs, rhs, bias = wildcard(), wildcard(), wildcard()
+    gemm = is_op("relax.nn.dense")(lhs, rhs) | is_op("relax.nn.matmul")(lhs, rhs)
+    with_bias = is_op("relax.add")(gemm, bias)
+    activation = is_op("relax.nn.relu")(with_bias | gemm)
+    if approximate_gelu:
+        activation = activation | is_op("relax.nn.gelu")(with_bias | gemm)
+    return activation | with_bias | gemm
+
+
+class _Gemm:
+    """A matched chain: the calls from the matmul to the root, and the operands of the kernel."""
+
+    def __init__(self, calls: List[Call], inner_vars: List[Var]) -> None:
+        self.calls = calls
+        self.inner_vars = inner_vars
+        self.operands = list(calls[0].args)
+        if len(calls) > 1 and calls[1].op == tvm.ir.Op.get("relax.add"):
+            self.operands.append(calls[1].args[1])
+
+
+def _is_supported_gemm(call: Call) -> bool:
+    lhs, rhs = call.args
+    dtype = lhs.checked_type.dtype
+    if dtype not in ["float16", "float32"] or rhs.checked_type.dtype != dtype:
+        return False
+    if call.checked_type.dtype != dtype:
+        return False
+    ndim = lhs.checked_type.ndim
+    if call.op == tvm.ir.Op.get("relax.nn.dense"):
+        return ndim == 2 and rhs.checked_type.ndim == 2
+    # The batched matmul is strided, each batch of lhs with the same batch of rhs.
+    return ndim in [2, 3] and rhs.checked_type.ndim == ndim
+
+
+def _is_column_bias(bias: Expr, gemm: Call) -> bool:
+    shape = bias.shape_
+    out_shape = gemm.shape_
+    if not isinstance(shape, ShapeExpr) or not isinstance(out_shape, ShapeExpr):
+        return False
+    if len(shape) != 1 or bias.checked_type.dtype != gemm.checked_type.dtype:
+        return False
+    return tvm.arith.Analyzer().can_prove_equal(shape[0], out_shape[len(out_shape) - 1])
+
+
+def _match_gemm(
+    call: Call, var2val: Dict[Var, Expr], users: Dict[Var, List[Var]], pattern: DFPattern
+) -> Optional[_Gemm]:
+    """The chain rooted at a call, if it matches the pattern and cuBLASLt supports it, and the
+    intermediate results are only used by the next call of the chain."""
+    if not pattern.match(call, var2val):
+        return None
+    calls = [call]
+    inner_vars = []
+    while calls[0].op.name not in ["relax.nn.dense", "relax.nn.matmul"]:
+        var = calls[0].args[0]
+        if not isinstance(var, DataflowVar) or len(users.get(var, [])) != 1:
+            return None
+        inner_vars.append(var)
+        calls.insert(0, var2val[var])
+    if not _is_supported_gemm(calls[0]):
+        return None
+    if len(calls) > 1 and calls[1].op.name == "relax.add":
+        if not _is_column_bias(calls[1].args[1], calls[0]):
+            return None
+    return _Gemm(calls, inner_vars)
+
+
+@mutator
+class _CublasLtPartitioner(PyExprMutator):
+    def __init__(self, mod: IRModule, approximate_gelu: bool) -> None:
+        super().__init__(mod)
+        self.mod_ = mod
+        self.pattern_ = gemm_pattern(approximate_gelu)
+        self.roots_: Dict[Call, _Gemm] = {}
+
+    def transform(self) -> IRModule:
+        for global_var, func in self.mod_.functions.items():
+            if not isinstance(func, Function) or (func.attrs and "Codegen" in func.attrs):
+                continue
+            self.roots_ = self._find_roots(func, self.pattern_)
+            if self.roots_:
+                self.builder_.update_func(global_var, remove_all_unused(self.visit_expr(func)))
+        return self.builder_.get()
+
+    @staticmethod
+    def _find_roots(func: Function, pattern: DFPattern) -> Dict[Call, _Gemm]:
+        if not isinstance(func.body, SeqExpr):
+            return {}
+        var2val = get_var2val(func)
+        roots = {}
+        for block in func.body.blocks:
+            if not isinstance(block, DataflowBlock):
+                continue
+            users = {var: list(uses) for var, uses in udchain(block).items()}
+            claimed = set()
+            # The users come after their operands, so the longest chains are matched first.
+            for binding in reversed(block.bindings):
+                value = binding.value
+                if binding.var in claimed or not isinstance(value, Call):
+                    continue
+                gemm = _match_gemm(value, var2val, users, pattern)
+                if gemm is not None:
+                    roots[value] = gemm
+                    claimed.update(gemm.inner_vars)
+        return roots
+
+    def visit_call_(self, call):
+        gemm = self.roots_.get(call)
+        if gemm is None:
+            return self.visit_expr_post_order(call)
+        name = self.builder_.get_unique_name("fused_matmul_cublaslt")
+        params = [
+            Var("arg%d" % i, arg.shape_, arg.checked_type) for i, arg in enumerate(gemm.operands)
+        ]
+        bb = BlockBuilder()
+        with bb.function(name, params, {"Codegen": "cublaslt", "global_symbol": name}):
+            out = bb.emit(Call(gemm.calls[0].op, params[:2], gemm.calls[0].attrs))
+            for inner in gemm.calls[1:]:
+                args = [out] + params[2:] if inner.op.name == "relax.add" else [out]
+                out = bb.emit(Call(inner.op, args, inner.attrs))
+            bb.emit_func_output(out)
+        global_var = self.builder_.add_func(bb.get()[name], name)
+        return Call(global_var, [self.visit_expr(operand) for operand in gemm.operands])
+
+
+def partition_for_cublaslt(mod: IRModule, approximate_gelu: bool = False) -> IRModule:
+    """Outline the chains matmul -> add -> activation supported by cuBLASLt into functions with
+    Codegen="cublaslt", which relax.transform.RunCodegen compiles to one cuBLASLt matmul each.
+
+    A chain is offloaded when its tensors are float16 or float32, its matmul is a 2D
+    relax.nn.dense or a 2D or batched 3D relax.nn.matmul, its bias is a vector of the columns
+    of the result, and its intermediate results have no other users.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module, before the op legalizer.
+
+    approximate_gelu : bool
+        Whether a relax.nn.gelu may be offloaded to the GELU epilogue, which computes the tanh
+        approximation of the GELU rather than the exact one of the erf.
+
+    Returns
+    -------
+    mod : IRModule
+        The module with the outlined functions.
+    """
+    return _CublasLtPartitioner(mod, approximate_gelu).transform()
+
+
+@tvm._ffi.register_func("relax.ext.cublaslt")
+def _cublaslt_codegen(func: Function) -> tvm.runtime.Module:
+    """Compile a function outlined by `partition_for_cublaslt` to the call of the fused matmul of
+    cuBLASLt, in the destination-passing style of the external functions."""
+    name = str(func.attrs["global_symbol"])
+    ops = [binding.value.op.name for binding in func.body.blocks[0].bindings]
+    inputs = [
+        te.placeholder(list(param.shape_), dtype=param.checked_type.dtype, name=param.name_hint)
+        for param in func.params
+    ]
+    out = cublaslt.fused_matmul(
+        inputs[0],
+        inputs[1],
+        bias=inputs[2] if "relax.add" in ops else None,
+        transb=ops[0] == "relax.nn.dense",
+        activation=_ACTIVATIONS.get(ops[-1], "none"),
+    )
+    prim_func = te.create_prim_func(inputs + [out])
+    return tvm.build(prim_func, target=tvm.target.cuda(), name=name)
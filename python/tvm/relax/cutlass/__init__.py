@@ -20,3 +20,4 @@
 from .pattern import *
 from .gemm_profiler import *
 from .conv_profiler import *
+from .attention import is_cutlass_attention, partition_for_cutlass_attention
@@ -0,0 +1,94 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Offload of relax.nn.attention to the CUTLASS fused multi-head attention kernel."""
+import tvm
+from tvm import relax
+from tvm.ir.module import IRModule
+
+# Registers the relax.ext.cutlass codegen.
+from tvm.contrib.cutlass import build as _build  # pylint: disable=unused-import
+
+from ..block_builder import BlockBuilder
+from ..expr import Call, Function, Var
+from ..expr_functor import mutator, PyExprMutator
+
+
+def _is_static(shape):
+    return isinstance(shape, relax.ShapeExpr) and all(
+        isinstance(dim, tvm.tir.IntImm) for dim in shape
+    )
+
+
+def is_cutlass_attention(call: Call) -> bool:
+    """Whether the CUTLASS kernel supports the relax.nn.attention call: of float16 or float32
+    tensors of static shapes, without dropout, and with a bias whose rows are not broadcast."""
+    if call.op != tvm.ir.Op.get("relax.nn.attention") or float(call.attrs.dropout_rate) > 0:
+        return False
+    if not all(_is_static(arg.shape_) for arg in call.args):
+        return False
+    if call.args[0].checked_type.dtype not in ["float16", "float32"]:
+        return False
+    if len(call.args) == 4 and int(call.args[3].shape_[3]) != int(call.args[1].shape_[1]):
+        return False
+    return True
+
+
+@mutator
+class _AttentionPartitioner(PyExprMutator):
+    def __init__(self, mod: IRModule) -> None:
+        super().__init__(mod)
+        self.mod_ = mod
+
+    def transform(self) -> IRModule:
+        for global_var, func in self.mod_.functions.items():
+            if not isinstance(func, Function) or (func.attrs and "Codegen" in func.attrs):
+                continue
+            self.builder_.update_func(global_var, self.visit_expr(func))
+        return self.builder_.get()
+
+    def visit_call_(self, call):
+        call = self.visit_expr_post_order(call)
+        if not isinstance(call.op, tvm.ir.Op) or not is_cutlass_attention(call):
+            return call
+        name = self.builder_.get_unique_name("fused_attention_cutlass")
+        params = [
+            Var("arg%d" % i, arg.shape_, arg.checked_type) for i, arg in enumerate(call.args)
+        ]
+        bb = BlockBuilder()
+        with bb.function(name, params, {"Codegen": "cutlass", "global_symbol": name}):
+            bb.emit_func_output(bb.emit(Call(call.op, params, call.attrs)))
+        global_var = self.builder_.add_func(bb.get()[name], name)
+        return Call(global_var, call.args)
+
+
+def partition_for_cutlass_attention(mod: IRModule) -> IRModule:
+    """Outline the relax.nn.attention calls supported by CUTLASS into functions with
+    Codegen="cutlass", which relax.transform.RunCodegen compiles with the CUTLASS fused
+    multi-head attention kernel. The other calls are left to the tiled TIR kernel of the
+    op legalizer.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module, before the op legalizer.
+
+    Returns
+    -------
+    mod : IRModule
+        The module with the outlined functions.
+    """
+    return _AttentionPartitioner(mod).transform()
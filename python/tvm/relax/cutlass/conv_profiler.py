@@ -27,8 +27,22 @@ from tvm.contrib.cutlass.gen_conv2d import CutlassConv2DProfiler
 @click.option("--weight_dtype", default="float16", help="Type of C")
 @click.option("--op_type", default="cutlass.conv2d", help="Epilogue pattern")
 @click.option("--bin_dir", default="./bin", help="Directory to store generated binaries")
-def main(d, w, padding, strides, dilation, sm, out_dtype, data_dtype, weight_dtype, op_type, bin_dir):
-    cutlass_profiler = CutlassConv2DProfiler(sm, _get_cutlass_path(), bin_dir)
+@click.option("--profile_db", default=None, help="JSON file of the profiled kernels to reuse")
+def main(
+    d,
+    w,
+    padding,
+    strides,
+    dilation,
+    sm,
+    out_dtype,
+    data_dtype,
+    weight_dtype,
+    op_type,
+    bin_dir,
+    profile_db,
+):
+    cutlass_profiler = CutlassConv2DProfiler(sm, _get_cutlass_path(), bin_dir, profile_db)
     res = handle_conv2d(
         cutlass_profiler=cutlass_profiler,
         op_type=op_type,
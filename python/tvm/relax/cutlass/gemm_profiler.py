@@ -24,8 +24,9 @@ from tvm.contrib.cutlass.gen_gemm import CutlassGemmProfiler
 @click.option("--layoutc", default="row", help="Layout of C")
 @click.option("--op_type", default="cutlass.dense", help="Epilogue pattern")
 @click.option("--bin_dir", default="./bin", help="Directory to store generated binaries")
-def main(m, n, k, sm, typea, typeb, typec, layouta, layoutb, layoutc, op_type, bin_dir):
-    cutlass_profiler = CutlassGemmProfiler(sm, _get_cutlass_path(), bin_dir)
+@click.option("--profile_db", default=None, help="JSON file of the profiled kernels to reuse")
+def main(m, n, k, sm, typea, typeb, typec, layouta, layoutb, layoutc, op_type, bin_dir, profile_db):
+    cutlass_profiler = CutlassGemmProfiler(sm, _get_cutlass_path(), bin_dir, profile_db)
     name, cutlass_op_def = select_gemm_kernel(
         cutlass_profiler,
         op_type,
@@ -19,13 +19,13 @@
 # pylint: disable=no-member
 # pylint: disable=pointless-statement
 
-from typing import List, Optional, Dict, Union, Tuple
+from typing import Callable, List, Optional, Dict, Union, Tuple
 import typing
 
 import tvm
 import tvm._ffi as tvm_ffi
 from tvm.ir.expr import PrimExpr
-from tvm.relax import Expr, Var
+from tvm.relax import DataflowBlock, Expr, Function, Var
 from tvm.relay.op import get
 from tvm.ir.container import Array
 
@@ -1052,6 +1052,58 @@ class PatternSeq(Node):
         return ffi.dup_seq(self)  # type: ignore
 
 
+def match_bindings(patterns: List[DFPattern], dfb: DataflowBlock) -> Dict[Var, int]:
+    """
+    Match each binding of a DataflowBlock with a set of patterns in one traversal.
+
+    The patterns are indexed by the operator and the arity of the calls their roots can match,
+    so that each binding is only matched with the patterns which may match it.
+
+    Parameters
+    ----------
+    patterns : List[DFPattern]
+        The patterns to match, in their order of priority
+    dfb : tvm.relax.DataflowBlock
+        The DataflowBlock whose bindings are matched
+
+    Returns
+    -------
+    result: Dict[tvm.relax.Var, int]
+        The mapping from each matched binding var to the index of the first pattern it matches
+    """
+    return {var: int(index) for var, index in ffi.match_bindings(patterns, dfb).items()}
+
+
+def rewrite_bindings(
+    rules: List[Tuple[DFPattern, Callable[[Expr, Dict[DFPattern, Expr]], Expr]]], func: Function
+) -> Function:
+    """
+    Rewrite the bindings of the DataflowBlocks of a function with a set of rules, until none of
+    them applies.
+
+    When a binding is rewritten, only the binding and its users within the depth of the patterns
+    are matched again, and each block is normalized and emitted once, without the dataflow vars
+    left unused.
+
+    Parameters
+    ----------
+    rules : List[Tuple[DFPattern, Callable[[Expr, Dict[DFPattern, Expr]], Expr]]]
+        The patterns with their rewriters, in their order of priority. A rewriter is called with
+        the matched value and the mapping from the (sub-)patterns to the expressions they match,
+        and returns the new value, or the matched value to decline the rewrite.
+    func : tvm.relax.Function
+        The function to rewrite
+
+    Returns
+    -------
+    result: tvm.relax.Function
+        The rewritten function
+    """
+    patterns = [pattern for pattern, _ in rules]
+    rewriters = [rewriter for _, rewriter in rules]
+    return ffi.rewrite_bindings(patterns, rewriters, func)  # type: ignore
+
+
 ### Private functions
 
 
@@ -126,6 +126,30 @@ class ExecBuilder(Object):
         self._check_scope()
         _ffi_api.ExecBuilderEmitIf(self, cond, false_offset)  # type: ignore
 
+    def emit_tuple(self, fields: List[int], dst: int) -> None:
+        """emit a make tuple instruction"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitTuple(self, fields, dst)  # type: ignore
+
+    def emit_tuple_get_item(self, tuple_reg: int, index: int, dst: int) -> None:
+        """emit a tuple get item instruction"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitTupleGetItem(self, tuple_reg, index, dst)  # type: ignore
+
+    def emit_shape_of(self, tensor: int, dst: int) -> None:
+        """emit a shape of instruction"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitShapeOf(self, tensor, dst)  # type: ignore
+
+    def emit_invoke_closure(
+        self, closure: int, args: Optional[List[int]] = None, dst: int = None
+    ) -> None:
+        """emit an invoke closure instruction, which calls the VM function of the closure."""
+        self._check_scope()
+        if dst is None:
+            dst = SpecialReg.VOID_ARG
+        _ffi_api.ExecBuilderEmitInvokeClosure(self, closure, args or [], dst)  # type: ignore
+
     def get(self) -> Executable:
         """return the executable"""
         return Executable(_ffi_api.ExecBuilderGet(self))  # type: ignore
@@ -63,6 +63,33 @@ class TorchFXTranslator:
         dtype = TorchFXTranslator._convert_data_type(str(tensor.data.dtype))
         return relax.const(tensor.data.cpu().numpy(), relax.DynTensorType(ndim, dtype))
 
+    @staticmethod
+    def _convert_torch_tensor_to_ndarray(tensor: torch.Tensor) -> tvm.nd.NDArray:
+        """A view of the data of a CPU tensor through DLPack, without copy."""
+        data = tensor.detach()
+        if data.device.type != "cpu" or not data.is_contiguous():
+            return tvm.nd.array(data.cpu().contiguous().numpy())
+        return tvm.nd.from_dlpack(torch.utils.dlpack.to_dlpack(data))
+
+    @staticmethod
+    def _param_shape(param: relax.Expr):
+        """The shape of a parameter, either a constant or an input of the function."""
+        if isinstance(param, relax.Constant):
+            return param.data.shape
+        return [int(dim) for dim in param.shape_]
+
+    def _reshape_param(self, tensor: torch.Tensor, newshape) -> relax.Expr:
+        """Reshape a parameter, folded into the constant of the parameter when it is one."""
+        param = self.params[tensor]
+        if not isinstance(param, relax.Constant):
+            return self.bb.emit(relax.op.reshape(relax.op.wrap_param(param), newshape))
+        reshaped = relax.const(
+            param.data.numpy().reshape(newshape),
+            relax.DynTensorType(len(newshape), param.data.dtype),
+        )
+        self.params[tensor] = reshaped
+        return relax.op.wrap_param(reshaped)
+
     @staticmethod
     def shape_of(tensor):
         if isinstance(tensor, relax.Var):
@@ -121,7 +148,7 @@ class TorchFXTranslator:
         x = self.env[node.args[0]]
         module = self.named_modules[node.target]
         weight = self.params[module.weight]
-        weight_shape = weight.data.shape
+        weight_shape = self._param_shape(weight)
 
         kernel_size = weight_shape[2:]
         out_channels = weight_shape[1]
@@ -145,41 +172,38 @@ class TorchFXTranslator:
         if module.bias is None:
             return conv2d
 
-        bias = self.params[module.bias]
-        if len(bias.data.shape) == 1:
-            reshaped_bias = relax.const(
-                bias.data.numpy().reshape(1, -1, 1, 1),
-                relax.DynTensorType(4, bias.data.dtype),
-            )
-            bias = self.params[module.bias] = reshaped_bias
+        bias = relax.op.wrap_param(self.params[module.bias])
+        bias_shape = self._param_shape(self.params[module.bias])
+        if len(bias_shape) == 1:
+            bias = self._reshape_param(module.bias, (1, bias_shape[0], 1, 1))
 
-        return self.bb.emit(relax.op.add(conv2d, relax.op.wrap_param(bias)))
+        return self.bb.emit(relax.op.add(conv2d, bias))
 
     def _linear(self, node: fx.node.Node) -> relax.Var:
 
         x = self.env[node.args[0]]
         module = self.named_modules[node.target]
         weight = self.params[module.weight]
-        if module.weight not in self.params_transpose:
-            self.params_transpose[module.weight] = self._convert_torch_tensor_to_relax(
-                module.weight.T
-            )
-
-        weight_T = self.params_transpose[module.weight]
-        dense = self._matmul_impl(x, relax.op.wrap_param(weight_T))
+        if not isinstance(weight, relax.Constant):
+            # Transpose in the graph, rather than keeping a transposed copy of the weight.
+            weight_T = self.bb.emit(relax.op.transpose(relax.op.wrap_param(weight), [1, 0]))
+        else:
+            if module.weight not in self.params_transpose:
+                self.params_transpose[module.weight] = self._convert_torch_tensor_to_relax(
+                    module.weight.T
+                )
+            weight_T = relax.op.wrap_param(self.params_transpose[module.weight])
+        dense = self._matmul_impl(x, weight_T)
 
         if module.bias is None:
             return dense
 
-        bias = self.params[module.bias]
-        if len(bias.data.shape) == 1:
-            reshaped_bias = relax.const(
-                bias.data.numpy().reshape(1, -1),
-                relax.DynTensorType(2, bias.data.dtype),
-            )
-            bias = self.params[module.bias] = reshaped_bias
+        bias = relax.op.wrap_param(self.params[module.bias])
+        bias_shape = self._param_shape(self.params[module.bias])
+        if len(bias_shape) == 1:
+            bias = self._reshape_param(module.bias, (1, bias_shape[0]))
 
-        return self.bb.emit(relax.op.add(dense, relax.op.wrap_param(bias)))
+        return self.bb.emit(relax.op.add(dense, bias))
 
     def _relu(self, node: fx.node.Node) -> relax.Var:
         x = self.env[node.args[0]]
@@ -655,7 +679,33 @@ class TorchFXTranslator:
             attr_itr = getattr(attr_itr, atom)
         return attr_itr
 
-    def from_pytorch(self, model, input_info):
+    def from_pytorch(self, model, input_info, keep_params_as_input=False):
+        """Translate a PyTorch model to a Relax module.
+
+        Parameters
+        ----------
+        model : torch.nn.Module
+            The model to translate.
+
+        input_info : Dict[str, Tuple[Tuple[int, ...], str]]
+            The shape and the dtype of each input of the model, by name.
+
+        keep_params_as_input : bool
+            Whether to keep the parameters of the model as the inputs of the function after the
+            model inputs, marked by the function attribute "num_input", instead of constants. No
+            parameter is copied: they are returned as views of the torch tensors for BindParams,
+            or for export, while the model is alive. This keeps the import of large models within
+            the memory of the model.
+
+        Returns
+        -------
+        mod : tvm.IRModule
+            The translated module.
+
+        params : Dict[str, tvm.nd.NDArray]
+            The parameters by the names of the function inputs, which are the parameter names of
+            the model with "_" in place of ".". Returned only with keep_params_as_input.
+        """
         self.named_modules = dict(model.named_modules())
 
         # fx.symbolic_trace(model).graph.print_tabular()
@@ -669,19 +719,31 @@ class TorchFXTranslator:
             inputs[name] = input_var
 
         # Translate model parameters.
-        for _, param in model.named_parameters():
+        param_vars = []
+        bound_params = {}
+        for name, param in model.named_parameters():
             ndim = len(param.data.shape)
             dtype = self._convert_data_type(str(param.data.dtype))
-            if dtype == "float32" or dtype == "float16":
+            if dtype != "float32" and dtype != "float16":
+                raise ValueError("Unsupported data type for model parameters: %s" % dtype)
+            if keep_params_as_input:
+                name = name.replace(".", "_")
+                param_var = relax.Var(
+                    name, list(param.data.shape), relax.DynTensorType(ndim, dtype)
+                )
+                self.params[param] = param_var
+                param_vars.append(param_var)
+                bound_params[name] = self._convert_torch_tensor_to_ndarray(param)
+            else:
                 self.params[param] = relax.const(
                     param.data.cpu().numpy(), relax.DynTensorType(ndim, dtype)
                 )
-            else:
-                raise ValueError("Unsupported data type for model parameters: %s" % dtype)
 
         # Initialize the block builder with a function and a dataflow block.
         self.bb = relax.BlockBuilder()
-        with self.bb.function(name="main", params=list(inputs.values())):
+        attrs = {"num_input": len(inputs)} if keep_params_as_input else None
+        func_params = list(inputs.values()) + param_vars
+        with self.bb.function(name="main", params=func_params, attrs=attrs):
             output = None
             with self.bb.dataflow():
                 for node in graph.nodes:
@@ -719,4 +781,6 @@ class TorchFXTranslator:
             assert output is not None
             self.bb.emit_func_output(output)
 
+        if keep_params_as_input:
+            return self.bb.get(), bound_params
         return self.bb.get()
@@ -23,15 +23,26 @@ from tvm import relax
 class WellFormedInstrument:
     """An instrument that checks the input/output IRModule of the Pass
     is well formed. It will skip specific passes, like Normalize.
+
+    The results are kept in an analysis manager, which is in scope of the
+    PassContext, so that only the functions a pass changed are checked again.
     """
 
     def __init__(self):
         self.skip_pass_name = ["Normalize", "ResolveGlobals"]
+        self.manager = relax.analysis.AnalysisManager()
+
+    def enter_pass_ctx(self):
+        self.manager.__enter__()
+
+    def exit_pass_ctx(self):
+        self.manager.__exit__(None, None, None)
 
     def run_before_pass(self, mod, pass_info):
         if pass_info.name not in self.skip_pass_name:
-            assert relax.analysis.well_formed(mod)
+            assert self.manager.well_formed(mod)
 
     def run_after_pass(self, mod, pass_info):
+        self.manager.invalidate(mod)
         if pass_info.name not in self.skip_pass_name:
-            assert relax.analysis.well_formed(mod)
+            assert self.manager.well_formed(mod)
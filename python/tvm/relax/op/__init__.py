@@ -24,6 +24,7 @@ from .reduce import *
 from .tensor import *
 from .transform import *
 from . import builtin
+from . import ccl
 from . import image
 from . import memory
 from . import nn
@@ -344,3 +344,23 @@ def shape_of(expr: Expr) -> Expr:
         A relax Call, which gets the shape of the input
     """
     return _ffi_api.shape_of(expr)  # type: ignore # pylint: disable=no-member
+
+
+def device_copy(data: Expr, dst_device_index: int) -> Expr:
+    """Copy a tensor onto another device of the VM. The kernels taking the copy as their first
+    tensor argument run on that device, and their outputs are allocated there.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    dst_device_index : int
+        The index of the device in the device list of the VM, or -1 for the host.
+
+    Returns
+    -------
+    result : Expr
+        The tensor on the device.
+    """
+    return _ffi_api.device_copy(data, dst_device_index)  # type: ignore # pylint: disable=no-member
@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relax collective communication operators.
+
+The collectives run among a group of workers, each running a VM on a device of its own, which
+joins the group by `VirtualMachine.set_ccl_config` before initialization. Every worker of the
+group calls the same collectives in the same order, on the tensors of the same shape.
+"""
+
+from . import _ffi_api
+from ...expr import Expr
+
+
+def allreduce(data: Expr, op_type: str = "sum") -> Expr:
+    """Reduce the tensors of all the workers, e.g. the partial sums of a matmul sharded along
+    its reduction axis, and hand the result to every one of them.
+
+    Parameters
+    ----------
+    data : Expr
+        The tensor of this worker.
+
+    op_type : str
+        The reduction, one of "sum", "prod", "min" and "max".
+
+    Returns
+    -------
+    result : Expr
+        The reduction of the tensors of all the workers.
+    """
+    return _ffi_api.allreduce(data, op_type)  # type: ignore
+
+
+def allgather(data: Expr, num_workers: int) -> Expr:
+    """Concatenate the tensors of all the workers along the first dimension, in the order of
+    their ranks.
+
+    Parameters
+    ----------
+    data : Expr
+        The tensor of this worker.
+
+    num_workers : int
+        The number of workers in the group.
+
+    Returns
+    -------
+    result : Expr
+        The concatenation, num_workers times as large as data along the first dimension.
+    """
+    return _ffi_api.allgather(data, num_workers)  # type: ignore
+
+
+def reduce_scatter(data: Expr, num_workers: int, op_type: str = "sum") -> Expr:
+    """Reduce the tensors of all the workers, and hand the i-th part of the result along the
+    first dimension to the worker of rank i.
+
+    Parameters
+    ----------
+    data : Expr
+        The tensor of this worker, whose first dimension is a multiple of num_workers.
+
+    num_workers : int
+        The number of workers in the group.
+
+    op_type : str
+        The reduction, one of "sum", "prod", "min" and "max".
+
+    Returns
+    -------
+    result : Expr
+        The part of the reduction for this worker.
+    """
+    return _ffi_api.reduce_scatter(data, num_workers, op_type)  # type: ignore
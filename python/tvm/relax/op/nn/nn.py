@@ -526,6 +526,111 @@ def layer_norm(
     return _ffi_api.layer_norm(data, gamma, beta, axis, epsilon, center, scale)
 
 
+def fused_layer_norm(
+    data: Expr,
+    gamma: Expr,
+    beta: Expr,
+    residual: Optional[Expr] = None,
+    axis: Union[int, List[int]] = -1,
+    epsilon: float = 1e-5,
+    out_dtype: str = "",
+) -> Expr:
+    r"""
+    Layer normalization computed in a single kernel, with the optional residual added to the
+    data first:
+
+    .. math::
+
+        h = data + residual
+
+        out = \frac{h - mean(h, axis)}{\sqrt{var(h, axis)+\epsilon}} * gamma + beta
+
+    The mean and the variance of each row are computed in one pass with the Welford algorithm,
+    and the rows are normalized in a second pass over the same data while it is in cache.
+
+    Parameters
+    ----------
+    data : relax.Expr
+        Input to which layer_norm will be applied.
+
+    gamma : relax.Expr
+        The gamma scale factor, of the shape of the normalized axes.
+
+    beta : relax.Expr
+        The beta offset factor, of the shape of the normalized axes.
+
+    residual : Optional[relax.Expr]
+        The residual added to the data, of the shape and the data type of the data.
+
+    axis : Union[int, List[int]], default=-1
+        The axes that should be normalized, which are the trailing axes of the data.
+
+    epsilon : double, default=1e-5
+        Small float added to variance to avoid dividing by zero.
+
+    out_dtype : str, optional
+        The data type of the normalized data, by default the data type of the data.
+
+    Returns
+    -------
+    result : relax.Expr
+        The normalized data. With a residual, the tuple of the normalized data and of
+        data + residual, which is the input of the next residual connection.
+    """
+    if isinstance(axis, int):
+        axis = [axis]
+    return _ffi_api.fused_layer_norm(data, gamma, beta, residual, axis, epsilon, out_dtype)
+
+
+def rms_norm(
+    data: Expr,
+    weight: Expr,
+    residual: Optional[Expr] = None,
+    axis: Union[int, List[int]] = -1,
+    epsilon: float = 1e-5,
+    out_dtype: str = "",
+) -> Expr:
+    r"""
+    Root mean square normalization (Zhang and Sennrich, 2019) computed in a single kernel, with
+    the optional residual added to the data first:
+
+    .. math::
+
+        h = data + residual
+
+        out = \frac{h}{\sqrt{mean(h^2, axis)+\epsilon}} * weight
+
+    Parameters
+    ----------
+    data : relax.Expr
+        Input to which rms_norm will be applied.
+
+    weight : relax.Expr
+        The scale factor, of the shape of the normalized axes.
+
+    residual : Optional[relax.Expr]
+        The residual added to the data, of the shape and the data type of the data.
+
+    axis : Union[int, List[int]], default=-1
+        The axes that should be normalized, which are the trailing axes of the data.
+
+    epsilon : double, default=1e-5
+        Small float added to the mean square to avoid dividing by zero.
+
+    out_dtype : str, optional
+        The data type of the normalized data, by default the data type of the data.
+
+    Returns
+    -------
+    result : relax.Expr
+        The normalized data. With a residual, the tuple of the normalized data and of
+        data + residual, which is the input of the next residual connection.
+    """
+    if isinstance(axis, int):
+        axis = [axis]
+    return _ffi_api.rms_norm(data, weight, residual, axis, epsilon, out_dtype)
+
+
 def matmul(a: Expr, b: Expr, out_dtype: str = "") -> Expr:
     """
     General matrix multiplication of two tensors.
@@ -565,6 +670,221 @@ def matmul(a: Expr, b: Expr, out_dtype: str = "") -> Expr:
     return _ffi_api.matmul(a, b, out_dtype)
 
 
+def grouped_matmul(
+    x: Expr, w: Expr, indptr: Expr, transpose_w: bool = False, out_dtype: str = ""
+) -> Expr:
+    """
+    Grouped matrix multiplication, e.g. of the tokens routed to the experts of a mixture of
+    experts, or of the requests using the adapters of a multi-LoRA model. The rows
+    [indptr[g], indptr[g + 1]) of x are multiplied by the weight w[g]. The sizes of the groups
+    are only known at runtime, and the GEMMs of all the groups are dispatched to a single
+    grouped GEMM on targets with cuBLAS.
+
+    Parameters
+    ----------
+    x : relax.Expr
+        The rows of all the groups, of shape (m, k).
+    w : relax.Expr
+        The weights of the groups, of shape (num_groups, k, n).
+    indptr : relax.Expr
+        The int64 offsets of the rows of the groups in x, of shape (num_groups + 1,).
+    transpose_w : bool
+        Whether the weights are given of shape (num_groups, n, k).
+    out_dtype: str
+        The data type of the result
+
+    Returns
+    -------
+    result : relax.Expr
+        The result, of shape (m, n).
+    """
+    return _ffi_api.grouped_matmul(x, w, indptr, transpose_w, out_dtype)
+
+
+def attention(
+    query: Expr,
+    key: Expr,
+    value: Expr,
+    bias: Optional[Expr] = None,
+    scale: Optional[float] = None,
+    causal_mask: Optional[str] = None,
+    dropout_rate: float = 0.0,
+    seed: int = 0,
+) -> Expr:
+    """
+    Fused scaled dot-product attention,
+
+    .. math::
+
+        dropout(softmax(scale * Q K^T + bias)) V
+
+    computed per head without materializing the scores of shape (seq_len, seq_len_kv): the
+    keys and the values are visited by tiles, with an online softmax.
+
+    Parameters
+    ----------
+    query : relax.Expr
+        The queries, of shape (batch, seq_len, num_heads, head_dim).
+    key : relax.Expr
+        The keys, of shape (batch, seq_len_kv, num_heads, head_dim).
+    value : relax.Expr
+        The values, of shape (batch, seq_len_kv, num_heads, head_dim_v).
+    bias : Optional[relax.Expr]
+        The bias of the scores, of a shape broadcast to (batch, num_heads, seq_len, seq_len_kv).
+    scale : Optional[float]
+        The scale of the scores, by default 1 / sqrt(head_dim).
+    causal_mask : Optional[str]
+        None, "TopLeft" where the query i attends to the keys up to i, or "BottomRight" where
+        the query i attends to the keys up to i + seq_len_kv - seq_len.
+    dropout_rate : float
+        Fraction of the attention probabilities that gets dropped out.
+    seed : int
+        The seed of the dropout mask, which is a function of the seed and of the indices.
+
+    Returns
+    -------
+    result : relax.Expr
+        The result, of shape (batch, seq_len, num_heads, head_dim_v).
+    """
+    if scale is not None:
+        scale = tvm.tir.FloatImm("float32", scale)
+    return _ffi_api.attention(query, key, value, bias, scale, causal_mask or "", dropout_rate, seed)
+
+
+def quantize_weight(weight: Expr, bits: int = 8, group_size: int = 128) -> Expr:
+    """
+    Symmetric group-wise quantization of weights, for the weight-only quantized dense.
+
+    The weights of each group of group_size consecutive weights of a row share the scale
+    max(|w|) / (2^(bits - 1) - 1), and are rounded to the signed integers of bits bits. The
+    integers are packed 8 / bits per uint8 from the low bits, with an offset of 2^(bits - 1).
+
+    Parameters
+    ----------
+    weight : relax.Expr
+        The weights, of shape (n, k), with k divisible by the group size.
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+
+    Returns
+    -------
+    result : relax.Expr
+        The tuple of the packed weights of shape (n, k * bits / 8) and dtype uint8, and of the
+        scales of shape (n, k / group_size) and of the data type of the weights.
+    """
+    return _ffi_api.quantize_weight(weight, bits, group_size)
+
+
+def dequantize_weight(packed: Expr, scale: Expr, bits: int = 8, group_size: int = 128) -> Expr:
+    """
+    Dequantization of the weights quantized by quantize_weight.
+
+    Parameters
+    ----------
+    packed : relax.Expr
+        The packed weights, of shape (n, k * bits / 8) and dtype uint8.
+    scale : relax.Expr
+        The scales, of shape (n, k / group_size).
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+
+    Returns
+    -------
+    result : relax.Expr
+        The weights, of shape (n, k) and of the data type of the scales.
+    """
+    return _ffi_api.dequantize_weight(packed, scale, bits, group_size)
+
+
+def quantized_dense(
+    data: Expr,
+    packed: Expr,
+    scale: Expr,
+    bits: int = 8,
+    group_size: int = 128,
+    out_dtype: str = "",
+) -> Expr:
+    """
+    Dense operator with weight-only quantized weights, `Y = X * W^T` where W is dequantized
+    from the packed weights and the scales of quantize_weight in the main loop of the kernel,
+    so that only the packed weights are read from memory.
+
+    Parameters
+    ----------
+    data : relax.Expr
+        The input data, of shape (..., k).
+    packed : relax.Expr
+        The packed weights, of shape (n, k * bits / 8) and dtype uint8.
+    scale : relax.Expr
+        The scales, of shape (n, k / group_size).
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+    out_dtype : str, optional
+        The data type of the output, by default the data type of the data.
+
+    Returns
+    -------
+    result : relax.Expr
+        The output, of shape (..., n).
+    """
+    return _ffi_api.quantized_dense(data, packed, scale, bits, group_size, out_dtype)
+
+
+def sparse_pack_2in4(weight: Expr) -> Expr:
+    """
+    Pruning of weights to 2:4 structured sparsity, packed for the sparse tensor cores.
+
+    The 2 weights of largest magnitude of each group of 4 consecutive weights of a row are kept,
+    the lowest index first on ties, so that the weights which are already 2:4 sparse are packed
+    exactly. The indices of the kept weights in their groups take 2 bits each, in the layout of
+    the metadata operand of the m16n8k16 mma.sp: a uint32 word for the rows i and i + 8 of each
+    16x16 tile, whose low and high 16 bits are the indices of the rows from the low bits.
+
+    Parameters
+    ----------
+    weight : relax.Expr
+        The weights, of shape (n, k), with n and k divisible by 16.
+
+    Returns
+    -------
+    result : relax.Expr
+        The tuple of the kept weights of shape (n, k / 2), and of the metadata of shape
+        (n / 16, k / 16, 8) and dtype uint32.
+    """
+    return _ffi_api.sparse_pack_2in4(weight)
+
+
+def sparse_dense_2in4(data: Expr, values: Expr, metadata: Expr, out_dtype: str = "") -> Expr:
+    """
+    Dense operator with 2:4 structured sparse weights, `Y = X * W^T` where W is packed by
+    sparse_pack_2in4. On the CUDA targets of sm_80 and later, the float16 dense of static weights
+    runs on the sparse tensor cores, which skip the pruned weights.
+
+    Parameters
+    ----------
+    data : relax.Expr
+        The input data, of shape (..., k).
+    values : relax.Expr
+        The kept weights, of shape (n, k / 2).
+    metadata : relax.Expr
+        The indices of the kept weights, of shape (n / 16, k / 16, 8) and dtype uint32.
+    out_dtype : str, optional
+        The data type of the output, by default the data type of the data.
+
+    Returns
+    -------
+    result : relax.Expr
+        The output, of shape (..., n).
+    """
+    return _ffi_api.sparse_dense_2in4(data, values, metadata, out_dtype)
+
+
 def adaptive_avg_pool2d(
     data: Expr,
     output_size: Optional[Union[PrimExprLike, Tuple[PrimExprLike], List[PrimExprLike]]] = None,
@@ -29,6 +29,11 @@ class MemAllocStorageAttrs(Attrs):
     """Attributes used in memory planning alloc_storage operators"""
 
 
+@tvm._ffi.register_object("relax.attrs.DeviceCopyAttrs")
+class DeviceCopyAttrs(Attrs):
+    """Attributes used in device_copy operators"""
+
+
 @tvm._ffi.register_object("relax.attrs.MemAllocTensorAttrs")
 class MemAllocTensorAttrs(Attrs):
     """Attributes used in memory planning alloc_tensor operators"""
@@ -44,6 +49,11 @@ class VMAllocTensorAttrs(Attrs):
     """Attributes used in VM alloc_tensor operators"""
 
 
+@tvm._ffi.register_object("relax.attrs.VMAllocOutputAttrs")
+class VMAllocOutputAttrs(Attrs):
+    """Attributes used in VM alloc_output operators"""
+
+
 @tvm._ffi.register_object("relax.attrs.UniqueAttrs")
 class UniqueAttrs(Attrs):
     """Attributes used for the unique operator"""
@@ -167,3 +177,38 @@ class AdaptivePool2DAttrs(Attrs):
 @tvm._ffi.register_object("relax.attrs.MatmulAttrs")
 class MatmulAttrs(Attrs):
     """Attributes for matmul operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.GroupedMatmulAttrs")
+class GroupedMatmulAttrs(Attrs):
+    """Attributes for grouped matmul operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.AttentionAttrs")
+class AttentionAttrs(Attrs):
+    """Attributes for attention operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.FusedNormAttrs")
+class FusedNormAttrs(Attrs):
+    """Attributes for the fused normalization operators"""
+
+
+@tvm._ffi.register_object("relax.attrs.WeightQuantizeAttrs")
+class WeightQuantizeAttrs(Attrs):
+    """Attributes for the weight-only quantization operators"""
+
+
+@tvm._ffi.register_object("relax.attrs.AllReduceAttrs")
+class AllReduceAttrs(Attrs):
+    """Attributes for allreduce operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.AllGatherAttrs")
+class AllGatherAttrs(Attrs):
+    """Attributes for allgather operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.ReduceScatterAttrs")
+class ReduceScatterAttrs(Attrs):
+    """Attributes for reduce_scatter operator"""
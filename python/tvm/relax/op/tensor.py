@@ -17,9 +17,6 @@
 # pylint: disable=redefined-builtin, invalid-name
 # pylint: disable=redefined-builtin
 """Basic tensor operations."""
-import numpy as np  # type: ignore
-import tvm
-
 from . import _ffi_api
 from ..expr import Expr
 
@@ -291,29 +288,3 @@ def unique(
     """
 
     return _ffi_api.unique(data, sorted, return_inverse, return_counts, dim)  # type: ignore
-
-
-@tvm.register_func("relax.run.unique")
-def numpy_unique(
-    a: tvm.nd.array,
-    sort: int,
-    return_inverse: int,
-    return_counts: int,
-    dim: int,
-) -> tvm.nd.array:
-    """Returns the unique elements of the input tensor.
-
-    Uses numpy.unique to compute unique elements.
-    """
-    # TODO(prakalp): add support for returning a tuple when return_inverse or return_counts is True
-    if bool(return_inverse) or bool(return_counts):
-        raise NotImplementedError("missing support return_inverse or return_counts set to true")
-    if dim < 0:
-        dim = None
-    a_numpy = a.numpy()
-    # TODO(prakalp): use torch.unique instead of numpy when torch is installed in ci.
-    output_sorted_numpy, indices = np.unique(a_numpy, return_index=True)
-    if sort:
-        return tvm.nd.array(output_sorted_numpy)
-    output_numpy = [a_numpy.flatten()[index] for index in sorted(indices, reverse=True)]
-    return tvm.nd.array(output_numpy)
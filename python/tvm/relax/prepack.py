@@ -0,0 +1,114 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Prepack the weights transformed by the functions lifted with
+:py:func:`tvm.relax.transform.LiftTransformParams`, and persist them alongside the executable."""
+import hashlib
+from typing import List
+
+import tvm
+from tvm.runtime import NDArray
+
+from .vm import VirtualMachine
+
+
+def weight_hash(params: List[NDArray]) -> str:
+    """Hash the dtypes, shapes and contents of the original weights, which identifies the weights
+    a set of prepacked weights is computed from.
+
+    Parameters
+    ----------
+    params : List[NDArray]
+        The original weights.
+
+    Returns
+    -------
+    ret : str
+        The hex digest of the weights.
+    """
+    sha = hashlib.sha256()
+    for param in params:
+        sha.update(str(param.dtype).encode())
+        sha.update(str(tuple(param.shape)).encode())
+        sha.update(param.numpy().tobytes())
+    return sha.hexdigest()
+
+
+def prepack_params(
+    vm: VirtualMachine, params: List[NDArray], func_name: str = "main"
+) -> List[NDArray]:
+    """Compute the transformed weights of a function by its lifted "<func_name>_transform_params".
+
+    Parameters
+    ----------
+    vm : VirtualMachine
+        The virtual machine of the executable built after LiftTransformParams.
+    params : List[NDArray]
+        The original weights, i.e. the parameters of the function after the inputs.
+    func_name : str
+        The name of the function.
+
+    Returns
+    -------
+    ret : List[NDArray]
+        The transformed weights, to be passed to the function after the inputs.
+    """
+    packed = vm[func_name + "_transform_params"](*params)
+    return list(packed)
+
+
+def save_prepacked_params(prepacked: List[NDArray], params: List[NDArray]) -> bytearray:
+    """Serialize the prepacked weights, keyed by the hash of the original weights.
+
+    Parameters
+    ----------
+    prepacked : List[NDArray]
+        The transformed weights returned by :py:func:`prepack_params`.
+    params : List[NDArray]
+        The original weights the transformed weights are computed from.
+
+    Returns
+    -------
+    ret : bytearray
+        The serialized weights, to be loaded by :py:func:`load_prepacked_params`.
+    """
+    key = weight_hash(params)
+    return tvm.runtime.save_param_dict({f"{key}_{i}": w for i, w in enumerate(prepacked)})
+
+
+def load_prepacked_params(param_bytes: bytearray, params: List[NDArray]) -> List[NDArray]:
+    """Load the prepacked weights, checking that they are computed from the given weights.
+
+    Parameters
+    ----------
+    param_bytes : bytearray
+        The weights serialized by :py:func:`save_prepacked_params`.
+    params : List[NDArray]
+        The original weights.
+
+    Returns
+    -------
+    ret : List[NDArray]
+        The transformed weights.
+    """
+    key = weight_hash(params)
+    loaded = tvm.runtime.load_param_dict(param_bytes)
+    prepacked = []
+    while f"{key}_{len(prepacked)}" in loaded:
+        prepacked.append(loaded[f"{key}_{len(prepacked)}"])
+    if len(prepacked) != len(loaded):
+        raise ValueError("The prepacked weights are not computed from the given weights")
+    return prepacked
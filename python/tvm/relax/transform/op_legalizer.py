@@ -19,14 +19,16 @@ import math
 
 import tvm
 from tvm import ir, te, topi, relax
+from tvm.contrib import cublas
 from tvm.ir import Attrs
 from tvm.ir.module import IRModule
 from tvm.tir.generic import cast
 
 from ..analysis import remove_all_unused
-from ..expr import Call, Expr, Function, Tuple, TupleGetItem
+from ..expr import Call, Expr, Function, ShapeExpr, Tuple, TupleGetItem
 from ..expr_functor import mutator, PyExprMutator
 from ..block_builder import BlockBuilder
+from . import _ffi_api
 
 
 def _nn_conv2d(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
@@ -43,62 +45,6 @@ def _nn_conv2d(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: E
     )
 
 
-def _add(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.add, args[0], args[1])
-
-
-def _subtract(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.subtract, args[0], args[1])
-
-
-def _multiply(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.multiply, args[0], args[1])
-
-
-def _divide(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.divide, args[0], args[1])
-
-
-def _floor_divide(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.floor_divide, args[0], args[1])
-
-
-def _sin(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.sin, args[0])
-
-
-def _cos(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.cos, args[0])
-
-
-def _tanh(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.tanh, args[0])
-
-
-def _negative(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.negative, args[0])
-
-
-def _log(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.log, args[0])
-
-
-def _sqrt(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.sqrt, args[0])
-
-
-def _sigmoid(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.sigmoid, args[0])
-
-
-def _less(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.less, args[0], args[1])
-
-
-def _nn_relu(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.nn.relu, args[0])
-
-
 def _nn_gelu(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
     def gelu(x):
         dtype = x.dtype
@@ -116,10 +62,6 @@ def _reshape(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Exp
     return bb.call_te(topi.reshape, args[0], output_shape)
 
 
-def _transpose(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.transpose, args[0], attrs.axes)
-
-
 def _concatenate(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
     n_field = len(args[0].shape_.fields)
     fields = []
@@ -153,10 +95,6 @@ def _trilu(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr)
     return bb.call_te(topi.trilu, args[0], tvm.tir.const(attrs.k, "int32"), attrs.is_upper)
 
 
-def _cast(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.cast, args[0], attrs.dtype)
-
-
 def _take(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
     return bb.call_te(topi.take, args[0], args[1], attrs.axis, attrs.batch_dims, attrs.mode)
 
@@ -346,6 +284,163 @@ def _nn_matmul(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: E
     return bb.call_te(te_matmul, a, b, primfunc_name_hint="matmul")
 
 
+def _nn_grouped_matmul(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    x, w, indptr = args
+    transpose_w = bool(attrs.transpose_w)
+    dtype = attrs.out_dtype if attrs.out_dtype != "" else x.checked_type.dtype
+
+    # The GEMMs of all the groups are launched at once by cuBLAS, as in the strategies of Relay.
+    target = tvm.target.Target.current(allow_none=True)
+    if target is not None and target.kind.name == "cuda" and "cublas" in target.libs:
+        return bb.call_te(
+            cublas.grouped_matmul,
+            x,
+            w,
+            indptr,
+            transpose_w,
+            dtype,
+            primfunc_name_hint="grouped_matmul_cublas",
+        )
+
+    def te_grouped_matmul(x, w, indptr):
+        m, k = x.shape
+        num_groups = w.shape[0]
+        n = w.shape[1] if transpose_w else w.shape[2]
+        g = te.reduce_axis((0, num_groups), name="g")
+        # The group of a row is the number of the groups ending at or before it.
+        group = te.compute(
+            (m,),
+            lambda i: te.sum(
+                tvm.tir.Select(
+                    indptr[g + 1] <= i, tvm.tir.const(1, "int64"), tvm.tir.const(0, "int64")
+                ),
+                axis=g,
+            ),
+            name="group",
+        )
+
+        def grouped_matmul_compute(i, j):
+            r = te.reduce_axis((0, k), name="k")
+            w_group = te.min(group[i], num_groups - 1)
+            w_value = w[w_group, j, r] if transpose_w else w[w_group, r, j]
+            # The rows after the last group are zeros.
+            value = tvm.tir.Select(
+                group[i] < num_groups,
+                x[i, r].astype(dtype) * w_value.astype(dtype),
+                tvm.tir.const(0, dtype),
+            )
+            return te.sum(value, axis=r)
+
+        return te.compute((m, n), grouped_matmul_compute, name="grouped_matmul")
+
+    return bb.call_te(te_grouped_matmul, x, w, indptr, primfunc_name_hint="grouped_matmul")
+
+
+def _nn_attention(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    kwargs = {
+        "scale": attrs.scale.value if attrs.scale is not None else None,
+        "causal_mask": str(attrs.causal_mask),
+        "dropout_rate": float(attrs.dropout_rate),
+        "seed": int(attrs.seed),
+    }
+    # The tiled kernel binds its blocks and threads itself on GPU.
+    target = tvm.target.Target.current(allow_none=True)
+    use_gpu = target is not None and "gpu" in target.keys
+    attention = topi.cuda.attention if use_gpu else topi.nn.attention
+
+    def te_attention(query, key, value, bias=None):
+        return attention(query, key, value, bias, **kwargs)
+
+    return bb.call_te(te_attention, *args, primfunc_name_hint="attention")
+
+
+def _nn_fused_norm(bb: BlockBuilder, args: List[Expr], attrs: Attrs, is_layer_norm: bool):
+    num_params = 2 if is_layer_norm else 1
+    kwargs = {
+        "axis": [int(axis) for axis in attrs.axis],
+        "epsilon": float(attrs.epsilon),
+        "out_dtype": attrs.out_dtype if attrs.out_dtype != "" else None,
+    }
+    # The kernels bind the rows and the threads themselves on GPU.
+    target = tvm.target.Target.current(allow_none=True)
+    topi_module = topi.cuda if target is not None and "gpu" in target.keys else topi.nn
+    norm = topi_module.fused_layer_norm if is_layer_norm else topi_module.rms_norm
+
+    def te_norm(data, *inputs):
+        residual = inputs[num_params] if len(inputs) > num_params else None
+        return norm(data, *inputs[:num_params], residual, **kwargs)
+
+    return bb.call_te(
+        te_norm, *args, primfunc_name_hint="layer_norm" if is_layer_norm else "rms_norm"
+    )
+
+
+def _nn_fused_layer_norm(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    return _nn_fused_norm(bb, args, attrs, is_layer_norm=True)
+
+
+def _nn_rms_norm(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    return _nn_fused_norm(bb, args, attrs, is_layer_norm=False)
+
+
+def _nn_quantize_weight(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    return bb.call_te(
+        topi.nn.quantize_weight,
+        args[0],
+        bits=int(attrs.bits),
+        group_size=int(attrs.group_size),
+        primfunc_name_hint="quantize_weight",
+    )
+
+
+def _nn_dequantize_weight(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    return bb.call_te(
+        topi.nn.dequantize_weight,
+        args[0],
+        args[1],
+        bits=int(attrs.bits),
+        group_size=int(attrs.group_size),
+        primfunc_name_hint="dequantize_weight",
+    )
+
+
+def _nn_quantized_dense(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    return bb.call_te(
+        topi.nn.quantized_dense,
+        args[0],
+        args[1],
+        args[2],
+        bits=int(attrs.bits),
+        group_size=int(attrs.group_size),
+        out_dtype=str(attrs.out_dtype) if attrs.out_dtype != "" else None,
+        primfunc_name_hint="quantized_dense",
+    )
+
+
+def _nn_sparse_pack_2in4(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    return bb.call_te(topi.nn.sparse_pack_2in4, args[0], primfunc_name_hint="sparse_pack_2in4")
+
+
+def _nn_sparse_dense_2in4(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
+    data, values = args[0], args[1]
+    # The float16 dense of static weights runs on the sparse tensor cores.
+    target = tvm.target.Target.current(allow_none=True)
+    use_sparse_tensor_core = (
+        topi.cuda.has_sparse_tensor_core(target)
+        and data.checked_type.dtype == "float16"
+        and values.checked_type.dtype == "float16"
+        and isinstance(values.shape_, ShapeExpr)
+        and all(isinstance(dim, tvm.tir.IntImm) for dim in values.shape_.values)
+    )
+    topi_module = topi.cuda if use_sparse_tensor_core else topi.nn
+    return bb.call_te(
+        topi_module.sparse_dense_2in4,
+        *args,
+        out_dtype=str(attrs.out_dtype) if attrs.out_dtype != "" else None,
+        primfunc_name_hint="sparse_dense_2in4",
+    )
+
+
 def _nn_softmax(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
     return bb.call_te(topi.nn.softmax, args[0], attrs.axis)
 
@@ -374,10 +469,6 @@ def _nn_softmax_cross_entropy(bb: BlockBuilder, args: List[Expr], attrs: Attrs,
     return bb.call_te(te_softmax_cross_entropy, args[0], args[1], primfunc_name_hint="softmax_cross_entropy")
 
 
-def _sum(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
-    return bb.call_te(topi.sum, args[0], attrs.axis, attrs.keepdims)
-
-
 def _mean(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_shape: Expr):
     shape_prod = tvm.tir.const(1, "int32")
     axis = attrs.axis if attrs.axis is not None else range(0, len(args[0].shape))
@@ -406,26 +497,13 @@ def _image_resize2d(bb: BlockBuilder, args: List[Expr], attrs: Attrs, output_sha
 
 op_legalization_map = {
     ir.Op.get("relax.nn.conv2d"): _nn_conv2d,
-    ir.Op.get("relax.add"): _add,
-    ir.Op.get("relax.subtract"): _subtract,
-    ir.Op.get("relax.multiply"): _multiply,
-    ir.Op.get("relax.divide"): _divide,
-    ir.Op.get("relax.floor_divide"): _floor_divide,
-    ir.Op.get("relax.sin"): _sin,
-    ir.Op.get("relax.cos"): _cos,
-    ir.Op.get("relax.sqrt"): _sqrt,
-    ir.Op.get("relax.sigmoid"): _sigmoid,
-    ir.Op.get("relax.less"): _less,
-    ir.Op.get("relax.nn.relu"): _nn_relu,
     ir.Op.get("relax.nn.gelu"): _nn_gelu,
     ir.Op.get("relax.nn.silu"): _nn_silu,
     ir.Op.get("relax.reshape"): _reshape,
-    ir.Op.get("relax.transpose"): _transpose,
     ir.Op.get("relax.concatenate"): _concatenate,
     ir.Op.get("relax.expand_dims"): _expand_dims,
     ir.Op.get("relax.cumsum"): _cumsum,
     ir.Op.get("relax.trilu"): _trilu,
-    ir.Op.get("relax.cast"): _cast,
     ir.Op.get("relax.take"): _take,
     ir.Op.get("relax.full"): _full,
     ir.Op.get("relax.full_like"): _full_like,
@@ -443,23 +521,31 @@ op_legalization_map = {
     ir.Op.get("relax.nn.batch_norm"): _nn_batch_norm,
     ir.Op.get("relax.nn.layer_norm"): _nn_layer_norm,
     ir.Op.get("relax.nn.matmul"): _nn_matmul,
+    ir.Op.get("relax.nn.grouped_matmul"): _nn_grouped_matmul,
+    ir.Op.get("relax.nn.attention"): _nn_attention,
+    ir.Op.get("relax.nn.fused_layer_norm"): _nn_fused_layer_norm,
+    ir.Op.get("relax.nn.rms_norm"): _nn_rms_norm,
+    ir.Op.get("relax.nn.quantize_weight"): _nn_quantize_weight,
+    ir.Op.get("relax.nn.dequantize_weight"): _nn_dequantize_weight,
+    ir.Op.get("relax.nn.quantized_dense"): _nn_quantized_dense,
+    ir.Op.get("relax.nn.sparse_pack_2in4"): _nn_sparse_pack_2in4,
+    ir.Op.get("relax.nn.sparse_dense_2in4"): _nn_sparse_dense_2in4,
     ir.Op.get("relax.nn.softmax"): _nn_softmax,
     ir.Op.get("relax.nn.flatten"): _nn_flatten,
     ir.Op.get("relax.nn.adaptive_avg_pool2d"): _nn_adaptive_max_pool2d,
     ir.Op.get("relax.nn.cross_entropy"): _nn_cross_entropy,
     ir.Op.get("relax.nn.softmax_cross_entropy"): _nn_softmax_cross_entropy,
-    ir.Op.get("relax.sum"): _sum,
     ir.Op.get("relax.mean"): _mean,
     ir.Op.get("relax.image.resize2d"): _image_resize2d,
-    ir.Op.get("relax.tanh"): _tanh,
-    ir.Op.get("relax.negative"): _negative,
-    ir.Op.get("relax.log"): _log,
 }
 
 
 @mutator
 class OperatorLegalizer(PyExprMutator):
     def __init__(self, mod: IRModule) -> None:
+        # The ops with a C++ FLegalize are legalized first, with one PrimFunc built for the calls
+        # of the same op, attrs, shapes and dtypes.
+        mod = _ffi_api.LegalizeOps()(mod)  # type: ignore
         super().__init__(mod)
         self.mod_ = mod
 
@@ -19,11 +19,12 @@
 import functools
 import inspect
 import types
-from typing import Callable, Dict, Union, Optional, List
+from typing import Callable, Dict, Union, Optional, List, Sequence
 import numpy as np  # type: ignore
 
 import tvm.ir
 from tvm.runtime import NDArray
+from ..expr import Binding
 from . import _ffi_api
 
 
@@ -81,6 +82,20 @@ def LambdaLift():
     return _ffi_api.LambdaLift()  # type: ignore
 
 
+def SpecializeClosures() -> tvm.ir.transform.Pass:
+    """Call the lifted functions of the closures known at compile time directly, with the
+    captured variables as trailing arguments, in place of invoking the closures.
+
+    The closures made in the function, or returned by a global function which only makes the
+    closure of its parameters, are known. The bindings making them are removed once unused.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+    """
+    return _ffi_api.SpecializeClosures()  # type: ignore
+
+
 def ToNonDataflow() -> tvm.ir.transform.Pass:
     """Transform all dataflow structure to non-dataflow version.
 
@@ -101,7 +116,55 @@ def CallTIRRewrite() -> tvm.ir.transform.Pass:
     return _ffi_api.CallTIRRewrite()  # type: ignore
 
 
+def InplaceElementwise() -> tvm.ir.transform.Pass:
+    """Let the elementwise kernels write their output to an input which dies at the kernel,
+    instead of a fresh allocation. Applies after CallTIRRewrite.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.InplaceElementwise()  # type: ignore
+
+
+def CheckpointActivations(memory_budget: Optional[int] = None) -> tvm.ir.transform.Pass:
+    """Recompute the activations of the dataflow blocks right before their late uses, instead of
+    keeping them alive, e.g. from the forward to the backward pass of a training graph, until the
+    bytes of the tensors live together in a block fit the memory budget. The activations freeing
+    the most bytes per recompute cost are picked first. Applies before ToNonDataflow, so that
+    VMGraphMemoryPlan reuses the storages of the activations dropped.
+
+    Parameters
+    ----------
+    memory_budget : Optional[int]
+        The budget in bytes. By default the config "relax.CheckpointActivations.memory_budget",
+        without which the pass does nothing.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    if memory_budget is None:
+        memory_budget = -1
+    return _ffi_api.CheckpointActivations(memory_budget)  # type: ignore
+
+
 def VMGraphMemoryPlan() -> tvm.ir.transform.Pass:
+    """Plan the storages of the tensors of the functions, reusing them across the tensors which
+    are not live together.
+
+    With the config "relax.VMGraphMemoryPlan.vtcm_capacity" set to a number of bytes, the small
+    static-size tensors on a device are planned into the "global.vtcm" storage scope while the
+    VTCM storages fit the capacity.
+
+    The static-size tensors which the PrimFuncs only access in a texture scope, e.g.
+    "global.texture" on OpenCL, are planned as 2D images of the scope, which are reused and grown
+    by the tensors whose flattened extents they nearly cover.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
     return _ffi_api.VMGraphMemoryPlan()
 
 
@@ -115,6 +178,18 @@ def VMMemoryLower() -> tvm.ir.transform.Pass:
     return _ffi_api.VMMemoryLower()  # type: ignore
 
 
+def VMStreamAssign() -> tvm.ir.transform.Pass:
+    """Spread the independent kernel calls over a pool of device streams, and order the dependent
+    ones with stream synchronization. The number of streams is read from the
+    "relax.VMStreamAssign.num_streams" pass config, the pass does nothing for a single stream.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.VMStreamAssign()  # type: ignore
+
+
 def VMShapeLower() -> tvm.ir.transform.Pass:
     """Lower the shape expressions in relax to VM shape heap manipulations and generate related
     TIR functions to do shape calculations.
@@ -126,6 +201,22 @@ def VMShapeLower() -> tvm.ir.transform.Pass:
     return _ffi_api.VMShapeLower()  # type: ignore
 
 
+def AOTLowerMain(mod_name: str = "default") -> tvm.ir.transform.Pass:
+    """Lower the Relax function main with static shapes into a TIR main function which calls the
+    kernels directly, for the AOT executor. Applies after CallTIRRewrite and AttachGlobalSymbol.
+
+    Parameters
+    ----------
+    mod_name : str
+        The name of the module, which prefixes the symbol of the TIR main function.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.AOTLowerMain(mod_name)  # type: ignore
+
+
 def AttachGlobalSymbol() -> tvm.ir.transform.Pass:
     """Attach global_symbol to Relax functions and TIR Primfuncs for codegen.
 
@@ -204,6 +295,33 @@ def BindParams(
     return _ffi_api.BindParams(func_name, tvm_params)  # type: ignore
 
 
+def SpecializeShapes(
+    func_name: str, shapes: Sequence[Optional[Sequence[int]]]
+) -> tvm.ir.transform.Pass:
+    """Specialize a function with symbolic shapes to the shapes of its arguments.
+
+    The symbolic dims of the parameters, and of their match_shape, are bound to the given dims.
+    Each call_tir whose arguments and outputs then have static shapes calls a copy of its
+    PrimFunc specialized to them, e.g. "fused_matmul_n16", so that the kernels can be tuned as
+    static tasks and the memory of the function is planned statically. Specialize the module
+    before legalization to specialize the kernels of the high-level operators too.
+
+    Parameters
+    ----------
+    func_name: str
+        The name of the function to specialize.
+
+    shapes: Sequence[Optional[Sequence[int]]]
+        The shape of each argument, or None to leave an argument symbolic.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    shapes = [None if shape is None else tvm.runtime.ShapeTuple(shape) for shape in shapes]
+    return _ffi_api.SpecializeShapes(func_name, shapes)  # type: ignore
+
+
 def RemoveUnusedFunctions(entry_functions: Optional[List[str]] = None) -> tvm.ir.transform.Pass:
     """Remove unused relax/prim functions without external linkage in a IRModule.
 
@@ -248,6 +366,12 @@ def RunCodegen(
 def FoldConstant() -> tvm.ir.transform.Pass:
     """Fold constant expressions.
 
+    The kernels of the folded call_tirs are compiled once per pass instance for each structurally
+    distinct PrimFunc, and the independent calls are compiled and evaluated in parallel. The
+    outputs of at least "relax.FoldConstant.device_min_bytes" bytes (1MB by default) are evaluated
+    on the "relax.FoldConstant.device_target" pass config target if it is set, falling back to
+    the CPU for the PrimFuncs which cannot be built for it.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
@@ -265,7 +389,9 @@ def AnnotateTIROpPattern() -> tvm.ir.transform.Pass:
     return _ffi_api.AnnotateTIROpPattern()  # type: ignore
 
 
-def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
+def FuseOps(
+    fuse_opt_level=-1, fusion_policy: Optional[Callable[[List[Binding]], bool]] = None
+) -> tvm.ir.transform.Pass:
     """This pass groups bindings in a dataflow block of Relax functions and generate a new grouped
     Relax function for each group, according to the fusion algorithm described in the pass
     implementation. By grouping bindings into new Relax functions, we substitute the bindings in
@@ -279,12 +405,18 @@ def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
         The level of fuse optimization. -1 indicates that the level will be
         inferred from pass context.
 
+    fusion_policy : Optional[Callable[[List[Binding]], bool]]
+        The function deciding whether to commit each fusion allowed by the op patterns, e.g. by
+        querying a cost model or the measured latencies in a tuning database. It is given the
+        bindings of the group that the fusion would create, and returns True to commit the
+        fusion. All the allowed fusions are committed if it is None.
+
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for operator fusion.
     """
-    return _ffi_api.FuseOps(fuse_opt_level)  # type: ignore
+    return _ffi_api.FuseOps(fuse_opt_level, fusion_policy)  # type: ignore
 
 
 def FuseTIR() -> tvm.ir.transform.Pass:
@@ -298,11 +430,55 @@ def FuseTIR() -> tvm.ir.transform.Pass:
     return _ffi_api.FuseTIR()  # type: ignore
 
 
+def DeduplicatePrimFuncs() -> tvm.ir.transform.Pass:
+    """Merge the TIR PrimFuncs which are structurally equal regardless of their names, and
+    redirect the calls to the merged ones. The PrimFunc of the smallest name is kept.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for PrimFunc deduplication.
+    """
+    return _ffi_api.DeduplicatePrimFuncs()  # type: ignore
+
+
+def LiftTransformParams() -> tvm.ir.transform.Pass:
+    """Lift the transformations of the weights of each function with the attribute "num_input",
+    such as their layout rewrites, into a function "<name>_transform_params". The parameters of
+    the function after the first "num_input" ones are the weights.
+
+    The function then takes the transformed weights in place of the weights, so that the
+    transformations run once ahead of the deployment rather than on each call. See
+    :py:func:`tvm.relax.prepack.prepack_params`.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for lifting the weight transformations.
+    """
+    return _ffi_api.LiftTransformParams()  # type: ignore
+
+
 def MetaScheduleApplyDatabase(
     work_dir: Optional[str] = None,
     module_equality: str = "structural",
+    shape_buckets: Optional[Dict[str, List[int]]] = None,
 ) -> tvm.ir.transform.Pass:
     """Apply the best schedule from tuning database.
+
+    If the "relax.MetaScheduleApplyDatabase.schedule_cache_dir" pass config is set to an existing
+    directory, the scheduled PrimFuncs are cached in it, keyed by the PrimFunc, the target and the
+    best tuning record, so that the builds of unchanged models skip replaying the traces.
+
+    A PrimFunc whose symbolic dims all have values in `shape_buckets` is scheduled with the best
+    record of each of its buckets, i.e. of each combination of the values, as extracted by
+    :py:func:`tvm.meta_schedule.relax_integration.extract_tasks`. The split factors of the
+    records are kept but the outer ones, so that each kernel runs any shape, and the PrimFunc
+    dispatches to the kernel of the first bucket whose values bound the runtime dims, or else to
+    the kernel of the last bucket.
+
+    Parameters
+    ----------
     work_dir : Optional[str]
        work directory to deduce default database if database is not provided
        (it will be ignored when an user passes database)
@@ -316,12 +492,16 @@ def MetaScheduleApplyDatabase(
                             given module. The "ignore-ndarray" varint is used for the extracted
                             blocks or in case no anchor block is found.
                             For the definition of the anchor block, see tir/analysis/analysis.py.
+    shape_buckets : Optional[Dict[str, List[int]]]
+        The representative values of the symbolic dims by name, e.g. {"n": [32, 128, 512]}.
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass
     """
-    return _ffi_api.MetaScheduleApplyDatabase(work_dir, module_equality)  # type: ignore
+    return _ffi_api.MetaScheduleApplyDatabase(  # type: ignore
+        work_dir, module_equality, shape_buckets or {}
+    )
 
 
 def MetaScheduleTuneTIR(
@@ -376,35 +556,129 @@ def SplitCutlass() -> tvm.ir.transform.Pass:
     return _ffi_api.SplitCutlass()
 
 
-def ToMixedPrecision(out_dtype="float32") -> tvm.ir.transform.Pass:
+def QuantizeWeights(bits: int = 8, group_size: int = 128) -> tvm.ir.transform.Pass:
+    """Rewrite the relax.nn.dense and relax.nn.matmul calls of constant weights into
+    relax.nn.quantized_dense calls of weights quantized by relax.nn.quantize_weight, which
+    divides the memory and the bandwidth of float16 weights by 16 / bits.
+
+    The pass applies after BindParams, so that the weights are constants. The quantization of
+    the weights is then computed at compile time by FoldConstant after the op legalizer, and
+    the weights whose rows do not divide into groups are left as they are.
+
+    Parameters
+    ----------
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+    """
+    return _ffi_api.QuantizeWeights(bits, group_size)  # type: ignore
+
+
+def SparsifyWeights(prune: bool = False) -> tvm.ir.transform.Pass:
+    """Rewrite the relax.nn.dense and relax.nn.matmul calls of constant float16 weights into
+    relax.nn.sparse_dense_2in4 calls of weights packed by relax.nn.sparse_pack_2in4, which run
+    on the sparse tensor cores of sm_80 and later.
+
+    The pass applies after BindParams, so that the weights are constants. The packing of the
+    weights is then computed at compile time by FoldConstant after the op legalizer, and the
+    weights whose dims do not divide by 16 are left as they are.
+
+    Parameters
+    ----------
+    prune : bool
+        Whether to prune the weights to the 2 of largest magnitude of each group of 4 of a row.
+        By default, only the weights which are already 2:4 sparse are rewritten.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+    """
+    return _ffi_api.SparsifyWeights(prune)  # type: ignore
+
+
+def LegalizeOps() -> tvm.ir.transform.Pass:
+    """Legalize the calls of the ops with a C++ FLegalize into call_tir of the PrimFuncs of
+    their TE compute, leaving the other calls to the OperatorLegalizer, which runs this pass
+    first.
+
+    The calls of the same op, attrs, shapes and dtypes share one PrimFunc, which is built once.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+    """
+    return _ffi_api.LegalizeOps()  # type: ignore
+
+
+def ToMixedPrecision(
+    out_dtype="float32",
+    low_precision_dtype="float16",
+    always_ops: Optional[List[str]] = None,
+    never_ops: Optional[List[str]] = None,
+    op_out_dtypes: Optional[Dict[str, str]] = None,
+) -> tvm.ir.transform.Pass:
     """Automatic mixed precision pass.
 
+    The ops are converted according to the conversion category registered for them, see
+    :py:mod:`tvm.relax.transform.mixed_precision`, unless overridden by the policy given.
+    Each tensor is casted at most once to each dtype.
+
     Parameters
     ----------
     out_dtype : str
         The output data type of gemm/conv
 
+    low_precision_dtype : str
+        The low precision data type, e.g. "float16" or "bfloat16"
+
+    always_ops : Optional[List[str]]
+        The names of the ops always computed in low precision
+
+    never_ops : Optional[List[str]]
+        The names of the ops never computed in low precision, e.g. for numerical accuracy
+
+    op_out_dtypes : Optional[Dict[str, str]]
+        The output (accumulation) data type of each op which differs from out_dtype, e.g.
+        {"relax.nn.matmul": "float16"} to accumulate matmul in low precision
+
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for mixed precision.
     """
-    return _ffi_api.ToMixedPrecision(out_dtype)
+    return _ffi_api.ToMixedPrecision(  # type: ignore
+        out_dtype,
+        low_precision_dtype,
+        always_ops or [],
+        never_ops or [],
+        op_out_dtypes or {},
+    )
 
 
-def ConvertLayout(desired_layouts) -> tvm.ir.transform.Pass:
+def ConvertLayout(desired_layouts, global_assignment: bool = False) -> tvm.ir.transform.Pass:
     """Automatic layout conversion pass.
     Parameters
     ----------
     desired_layouts : Dict[str, List[str]]
         The desired layouts for some operators
 
+    global_assignment : bool
+        Whether to decide which layout-agnostic operators follow the converted layout over the
+        whole function, so that the total size of the tensors transposed is the smallest. By
+        default each operator follows the layout of its inputs greedily.
+
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for layout conversion.
     """
-    return _ffi_api.ConvertLayout(desired_layouts)
+    return _ffi_api.ConvertLayout(desired_layouts, global_assignment)  # type: ignore
 
 
 def _wrap_class_function_pass(pass_cls, pass_info):
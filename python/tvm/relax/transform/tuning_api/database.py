@@ -223,6 +223,27 @@ class Database(Object):
         """
         return _ffi_api.DatabaseGetTopK(self, workload, target, top_k)  # type: ignore # pylint: disable=no-member
 
+    def get_tuning_record(
+        self, workload: Workload, target: Target, trace: Trace
+    ) -> Optional[TuningRecord]:
+        """Get the tuning record of a trace with the same knobs and decisions from the database.
+
+        Parameters
+        ----------
+        workload : Workload
+            The workload of the input IRModule of the trace.
+        target: Target
+            The target to be searched for.
+        trace : Trace
+            The trace to be searched for.
+
+        Returns
+        -------
+        record : Optional[TuningRecord]
+            The tuning record of the trace if exists.
+        """
+        return _ffi_api.DatabaseGetTuningRecord(self, workload, target, trace)  # type: ignore # pylint: disable=no-member
+
 
 @register_object("relax.tuning_api.JSONDatabase")
 class JSONDatabase(Database):
@@ -271,3 +292,42 @@ class JSONDatabase(Database):
             path_measurement_record,
             allow_missing,
         )
+
+
+@register_object("relax.tuning_api.IndexedDatabase")
+class IndexedDatabase(Database):
+    """The class of the database on indexed append-only logs, which opens without loading the
+    records, and can be appended by multiple tuners at the same time.
+
+    Parameters
+    ----------
+    path : str
+        The path prefix of the logs of the workloads, the tuning records and the measurement
+        records.
+    """
+
+    path: str
+
+    def __init__(
+        self,
+        path: str,
+        num_shards: int = 16,
+        allow_missing: bool = True,
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        path : str
+            The path prefix of the logs.
+        num_shards : int
+            The number of shards of the record logs, if they are new.
+        allow_missing : bool
+            Whether to create new logs when the given path is not found.
+        """
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseIndexedDatabase,  # type: ignore # pylint: disable=no-member
+            path,
+            num_shards,
+            allow_missing,
+        )
@@ -27,6 +27,7 @@ from tvm.ir.transform import PassContext, Pass
 from tvm import meta_schedule
 from tvm.meta_schedule.arg_info import TensorInfo
 from tvm.meta_schedule.builder import BuilderInput, LocalBuilder
+from tvm.meta_schedule.database import Workload
 from tvm.meta_schedule.utils import get_global_func_with_default_on_worker
 from tvm.meta_schedule.runner import (
     EvaluatorConfig,
@@ -35,6 +36,7 @@ from tvm.meta_schedule.runner import (
 )
 from tvm._ffi.registry import register_func
 from .primitives import Knob, Trace
+from .database import TuningRecord
 
 logger = logging.getLogger("TuningAPI")  # pylint: disable=invalid-name
 
@@ -138,6 +140,20 @@ def default_consider_eval_passes(
     return candidates
 
 
+def _set_perf(candidate: Trace, run_secs: List[float]) -> None:
+    """Set the performance of a candidate to the average of its valid measurements."""
+    perfs = []
+    for result in run_secs:
+        if isinstance(result, tvm.tir.FloatImm):
+            result = result.value
+        assert isinstance(result, float)
+        assert result >= 0.0
+        perfs.append(result)
+
+    # Store the evaluation result
+    candidate.set_perf(np.mean(perfs))
+
+
 @register_func("relax.tuning_api.default_evaluate")
 def default_evaluate(
     candidates: List[Trace],
@@ -148,6 +164,10 @@ def default_evaluate(
 ) -> None:
     """
     Default function to evaluate a set of candidate traces by using MetaSchedule builder/runner.
+    The candidates are built together, so that the builder compiles them in parallel, and then
+    measured together by the runner. Every trace evaluated is committed as a tuning record of its
+    input IRModule, so that the traces with the same decisions, e.g. the prefixes explored by the
+    earlier tuning passes of a pipeline tuned again, are not built again.
 
     Parameters
     ----------
@@ -217,42 +237,75 @@ def default_evaluate(
 
     # Keep track of number of evaluations (mostly for the debugging purpose)
     num_evals = 0
-    # Evaluation
+    # The candidates to measure, by their workloads. The candidates of the same out_mod share
+    # their measurement.
+    pending: Dict[Workload, List[Trace]] = {}
+    # The workloads of the input IRModules, which key the tuning records of the traces.
+    in_workloads: Dict[IRModule, Workload] = {}
+
+    def in_workload_of(candidate: Trace) -> Workload:
+        if candidate.in_mod not in in_workloads:
+            in_workloads[candidate.in_mod] = database.commit_workload(candidate.in_mod)
+        return in_workloads[candidate.in_mod]
+
     for candidate in candidates:
         # If this candidate is already evaluated, skip the measurement
         if candidate.perf != -1:
             continue
-
-        # Evaluate candidates
         num_evals += 1
-        mod = candidate.out_mod
-        workload = database.commit_workload(mod)
 
+        # If the same trace was evaluated from the same input before, reuse its record
+        # without looking up its out_mod.
+        record = database.get_tuning_record(in_workload_of(candidate), target, candidate)
+        if record is not None and record.run_secs is not None:
+            _set_perf(candidate, record.run_secs)
+            continue
+
+        workload = database.commit_workload(candidate.out_mod)
         # If this workload and target pair has measured before, fetch its data.
         if database.has_measurement_record(workload, target):
             run_secs = database.get_measurement_record(workload, target)
+            _set_perf(candidate, run_secs)
+            database.commit_tuning_record(
+                in_workload_of(candidate), target, TuningRecord(candidate, run_secs)
+            )
         # Otherwise, measure it.
         else:
-            # Build candidate
-            (builder_result,) = builder.build([BuilderInput(mod, target, params)])
+            pending.setdefault(workload, []).append(candidate)
 
+    if pending:
+        workloads = list(pending.keys())
+        # Build all the candidates at once, so that the builder compiles them in parallel.
+        builder_results = builder.build(
+            [BuilderInput(workload.mod, target, params) for workload in workloads]
+        )
+        # Then measure all the ones built, which the runner schedules on its own.
+        built = [
+            (workload, builder_result.artifact_path)
+            for workload, builder_result in zip(workloads, builder_results)
+            if builder_result.artifact_path is not None
+        ]
+        runner_inputs = []
+        for workload, artifact_path in built:
+            # If build passes, set up runner input and measure the performance.
+            args_info = [
+                TensorInfo(shape=[int(i) for i in p.shape], dtype=p.checked_type.dtype)
+                for p in workload.mod["main"].params
+            ]  # convert list[Var] to list[TensorInfo]
+            runner_inputs.append(RunnerInput(artifact_path, target_str, args_info=args_info))
+        runner_futures = {
+            workload: future
+            for (workload, _), future in zip(built, runner.run(runner_inputs) if built else [])
+        }
+
+        for workload, builder_result in zip(workloads, builder_results):
             if builder_result.artifact_path is None:
                 # Build error
                 # Assign the worst performance and move on to the next candidate.
                 logger.warning(builder_result.error_msg)
                 run_secs = [1e100]
             else:
-                # If build passes, set up runner input and measure the performance.
-                args_info = [
-                    TensorInfo(shape=[int(i) for i in p.shape], dtype=p.checked_type.dtype)
-                    for p in mod["main"].params
-                ]  # convert list[Var] to list[TensorInfo]
-                runner_input = RunnerInput(
-                    builder_result.artifact_path, target_str, args_info=args_info
-                )
-                (runner_future,) = runner.run([runner_input])
-                runner_result = runner_future.result()
-
+                runner_result = runner_futures[workload].result()
                 run_secs = runner_result.run_secs
                 # Runtime error
                 # Assign the worst performance and move on to the next candidate.
@@ -265,17 +318,11 @@ def default_evaluate(
             # Clean up the artifact
             f_clean_build(builder_result.artifact_path)
 
-        # For valid measurments, compute the average and update the trace performance.
-        perfs = []
-        for result in run_secs:
-            if isinstance(result, tvm.tir.FloatImm):
-                result = result.value
-            assert isinstance(result, float)
-            assert result >= 0.0
-            perfs.append(result)
-
-        # Store the evaluation result
-        candidate.set_perf(np.mean(perfs))
+            for candidate in pending[workload]:
+                _set_perf(candidate, run_secs)
+                database.commit_tuning_record(
+                    in_workload_of(candidate), target, TuningRecord(candidate, run_secs)
+                )
 
     ctx.inc_num_evals(num_evals)
 
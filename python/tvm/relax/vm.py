@@ -16,17 +16,26 @@
 # under the License.
 # pylint: disable=invalid-name, redefined-builtin, no-else-return
 """The Relax virtual machine"""
-from typing import Callable, List, Optional, Union, Dict, Tuple
+import ctypes
+import glob
+import json
+import logging
+import os
+import threading
+from typing import Callable, List, Optional, Sequence, Union, Dict, Tuple
 import numpy as np  # type: ignore
 
 from tvm._ffi import base as _base
 import tvm
 from tvm import relax
 from tvm._ffi import base as _base
+from tvm._ffi._ctypes.types import TVMValue
+from tvm._ffi.runtime_ctypes import ArgTypeCode
 from tvm.ir.module import IRModule
 from tvm.relay import Any
 from tvm.runtime import Device, Module, PackedFunc, container
 from tvm.runtime.object import Object
+from tvm.runtime.profiling import MetricCollector, Report
 from tvm.tir.function import PrimFunc
 
 from ..rpc.base import RPC_SESS_MASK
@@ -54,18 +63,61 @@ class Executable(object):
         """print the instructions as python program."""
         return self._as_python()
 
+    def memory_footprint(self, func_name: Optional[str] = None) -> Dict[str, object]:
+        """The memory the executable is planned to need, read from its metadata without loading
+        it on any device, e.g. to check that a model fits before loading it.
+
+        Parameters
+        ----------
+        func_name : Optional[str]
+            The function whose activations are reported. By default, the most that any function
+            of the executable needs on each device.
+
+        Returns
+        -------
+        footprint : Dict[str, object]
+            The "constant_bytes" of the constants, the "workspace_bytes" of the largest scratch
+            of the kernels, or -1 when unknown, and the "devices", from the runtime device index
+            to the planned "activation_bytes" and the "num_dynamic_allocs" whose size is only
+            known at runtime, and not counted in the activation bytes.
+        """
+        footprint = self.mod["get_memory_footprint"](func_name or "")
+        devices = {}
+        for i, index in enumerate(footprint["device_index"]):
+            devices[int(index)] = {
+                "activation_bytes": int(footprint["activation_bytes"][i]),
+                "num_dynamic_allocs": int(footprint["num_dynamic_allocs"][i]),
+            }
+        return {
+            "constant_bytes": int(footprint["constant_bytes"][0]),
+            "workspace_bytes": int(footprint["workspace_bytes"][0]),
+            "devices": devices,
+        }
+
 
 class VirtualMachine(object):
     """Relax VM runtime."""
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    SIZE_CLASS_ALLOCATOR = 3
+    PINNED_HOST_ALLOCATOR = 4
+    _ALLOCATOR_TYPES = {
+        "naive": NAIVE_ALLOCATOR,
+        "pooled": POOLED_ALLOCATOR,
+        "size_class": SIZE_CLASS_ALLOCATOR,
+    }
 
     def __init__(
         self,
         exec: Union[Executable, Module],
         device: Union[Device, List[Device]],
         memory_cfg: Optional[Union[str, Dict[Device, str]]] = None,
+        constant_budget: Optional[int] = None,
+        constant_prefetch: int = 2,
+        thread_pool: Optional[str] = None,
+        ccl_config: Optional[Tuple[str, int, int]] = None,
+        replicate_constants: bool = False,
     ) -> None:
         """
         Construct a VirtualMachine wrapper object.
@@ -80,26 +132,66 @@ class VirtualMachine(object):
 
         memory_cfg : Optional[Union[str, Dict[Device, str]]]
             Config the type of memory allocator. The allocator type can be ["naive",
-            "pooled"]. If memory_cfg is None, all devices will use pooled allocator
+            "pooled", "size_class"]. If memory_cfg is None, all devices will use pooled allocator
             by default. If memory_cfg is string, all devices will use the specified
             allocator type. If memory_cfg is a dict, each device uses the allocator
             type specified in the dict, or pooled allocator if not specified in the
             dict.
+
+        constant_budget : Optional[int]
+            The device memory budget in bytes of the constants. If set, the constants are
+            uploaded to the device on first use, and the least recently used ones are evicted
+            to stay within the budget, instead of all being uploaded at initialization.
+
+        constant_prefetch : int
+            The number of upcoming calls whose constants are prefetched when constant_budget
+            is set.
+
+        thread_pool : Optional[str]
+            The name of the thread pool, created by `runtime.threading.CreateThreadPool`, to run
+            the parallel kernels on, so that the models served in one process do not compete for
+            the same workers. Defaults to the thread pool of the calling thread.
+
+        ccl_config : Optional[Tuple[str, int, int]]
+            The name of the group of workers running the shards of a model, the number of
+            workers and the rank of this one, for the collectives in `relax.op.ccl`. Each
+            worker runs a VM on a device of its own, in a thread of its own of this process,
+            and the construction returns once all the workers of the group have joined.
+
+        replicate_constants : bool
+            Whether to copy the constants on the CPU for this VM instead of sharing those of the
+            executable. The copies are made by the workers of the thread pool, so that they are
+            placed on the NUMA nodes of its CPUs. See `NUMAReplicas`.
         """
-        self.module = (
+        self._bind_module(
             exec.mod["vm_load_executable"]()
             if isinstance(exec, Executable)
             else exec["vm_load_executable"]()
         )
+        if constant_budget is not None:
+            self.module["set_constant_paging"](constant_budget, constant_prefetch)
+        if thread_pool is not None:
+            self.module["set_thread_pool"](thread_pool)
+        if replicate_constants:
+            self.module["set_replicate_constants"](True)
+        if ccl_config is not None:
+            group, world_size, rank = ccl_config
+            self.module["set_ccl_config"](group, world_size, rank)
+        self._setup_device(device, memory_cfg)
+
+    def _bind_module(self, module: Module) -> None:
+        """bind the wrapper to a VM runtime module."""
+        self.module = module
         self._invoke_closure = self.module["invoke_closure"]
         self._save_function = self.module["save_function"]
         self._set_input = self.module["set_input"]
+        self._set_input_zero_copy = self.module["set_input_zero_copy"]
+        self._set_output_zero_copy = self.module["set_output_zero_copy"]
         self._invoke_stateful = self.module["invoke_stateful"]
         self._get_output = self.module["get_output"]
         self._get_output_arity = self.module["get_output_arity"]
         self._get_function_arity = self.module["get_function_arity"]
         self._get_function_param_name = self.module["get_function_param_name"]
-        self._setup_device(device, memory_cfg)
 
     def _setup_device(self, dev: Device, memory_cfg: Union[str, Dict[Device, str]]) -> None:
         """init devices and allocators."""
@@ -125,9 +217,8 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
-            if memory_cfg == "naive":
-                default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            assert memory_cfg in VirtualMachine._ALLOCATOR_TYPES
+            default_alloc_type = VirtualMachine._ALLOCATOR_TYPES[memory_cfg]
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -138,13 +229,76 @@ class VirtualMachine(object):
         for device in devs:
             init_args.append(device.device_type % RPC_SESS_MASK)
             init_args.append(device.device_id)
-            alloc_type = memory_cfg[device] if device in memory_cfg else default_alloc_type
+            alloc_type = (
+                VirtualMachine._ALLOCATOR_TYPES[memory_cfg[device]]
+                if device in memory_cfg
+                else default_alloc_type
+            )
             init_args.append(alloc_type)
         self.module["vm_initialization"](*init_args)
 
+    @staticmethod
+    def memory_stats(dev: Device) -> Dict[str, Union[int, float]]:
+        """Get the usage statistics of the memory allocator of a device.
+
+        Parameters
+        ----------
+        dev : Device
+            The device whose allocator is queried.
+
+        Returns
+        -------
+        stats : Dict[str, Union[int, float]]
+            The statistics, e.g. bytes_in_use and bytes_reserved of every allocator, and
+            bytes_cached, hit_rate and fragmentation of the "size_class" allocator.
+        """
+        return json.loads(tvm.get_global_func("vm.memory_manager.stats")(dev))
+
+    @staticmethod
+    def pinned_empty(shape, dtype: str, dev: Device) -> tvm.nd.NDArray:
+        """Allocate a staging array in the page-locked host memory of a device, which the device
+        copies to and from asynchronously. The arrays are pooled, so that a serving loop
+        allocating one per request does not lock host memory every time.
+
+        Parameters
+        ----------
+        shape : Tuple[int]
+            The shape of the array.
+
+        dtype : str
+            The data type of the array.
+
+        dev : Device
+            The device the array stages the transfers of, a CUDA device or the CPU.
+
+        Returns
+        -------
+        arr : tvm.nd.NDArray
+            The array, on the "cuda_host" device for a CUDA device, or on the CPU.
+        """
+        return tvm.get_global_func("vm.memory_manager.pinned_empty")(
+            tvm.runtime.ShapeTuple(shape), dtype, dev
+        )
+
     def __getitem__(self, key: str) -> PackedFunc:
         return self.module[key]
 
+    def create_context(self) -> "VirtualMachine":
+        """Create a new execution context of the executable on the same devices.
+
+        The context shares the executable, the device copy of the constants and the memory
+        allocators with this VM, and only owns its own call frames and registers. A VM must not
+        be used by several threads at a time, so create one context per serving thread.
+
+        Returns
+        -------
+        ctx : VirtualMachine
+            The new execution context.
+        """
+        ctx = VirtualMachine.__new__(VirtualMachine)
+        ctx._bind_module(self.module["create_context"]())
+        return ctx
+
     def invoke_closure(self, closure: Object, *args: Any) -> Object:
         """Invoke a closure.
 
@@ -299,6 +453,52 @@ class VirtualMachine(object):
 
         self._set_input(func_name, *cargs)
 
+    def set_input_zero_copy(self, func_name: str, *args: Any, **kwargs: Any) -> None:
+        """Set the inputs to a function without copying them, like `set_input`.
+        The input tensors are used by the function as they are, so they must be on the
+        device of the function and must not be modified until the call is done.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+        args: List[tvm.runtime.NDArray]
+            The arguments to the function.
+        kwargs: dict of str to tvm.runtime.NDArray
+            Named arguments to the function.
+        """
+        cargs: List[Any] = []
+
+        if kwargs:
+            args = self._convert_func_named_args(func_name, args, **kwargs)
+
+        for arg in args:
+            self._convert(arg, cargs)
+
+        self._set_input_zero_copy(func_name, *cargs)
+
+    def set_output_zero_copy(
+        self, func_name: str, index: int, buffer: Optional[tvm.runtime.NDArray]
+    ) -> None:
+        """Bind a buffer to a tensor of the output of a function, which the function then
+        writes its result into instead of allocating a new tensor. The buffer is returned as
+        the output, and stays bound for the later calls until it is unbound.
+
+        Only the output tensors allocated by the function itself are written into the bound
+        buffers. An output that is one of the inputs, or a constant, is returned as it is.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+        index : int
+            The index of the tensor in the output tuple, or 0 if the output is not a tuple.
+        buffer : Optional[tvm.runtime.NDArray]
+            The buffer to bind, which must match the shape, dtype and device of the output,
+            or None to unbind the buffer.
+        """
+        self._set_output_zero_copy(func_name, index, buffer)
+
     def invoke_stateful(self, func_name: str) -> None:
         """
         Call the named function from the VM module using the arguments set using `set_input`.
@@ -345,6 +545,262 @@ class VirtualMachine(object):
 
         return get_output_rec(func_name)
 
+    def bind_call(
+        self, func_name: str, outputs: Optional[Sequence[tvm.runtime.NDArray]] = None
+    ) -> "BoundCall":
+        """
+        Get a call of the named function with the overhead of the FFI paid once.
+
+        The output buffers are bound with `set_output_zero_copy`, and the arguments of the
+        FFI call are built once, so that each call only sets the handles of the input arrays
+        and makes a single call into the VM, which sets the inputs without copying them and
+        invokes the function.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+        outputs : Optional[Sequence[tvm.runtime.NDArray]]
+            The buffers of the tensors of the output tuple, or of the output if it is not a
+            tuple. The output is got from the VM if it is not written into the buffers.
+
+        Returns
+        -------
+        call : BoundCall
+            The call, taking the input NDArrays, which must be on the device of the VM.
+        """
+        return BoundCall(self, func_name, outputs)
+
+    def capture_cuda_graph(self, func_name: str) -> PackedFunc:
+        """
+        Get a function that runs the named VM function through CUDA graphs.
+
+        The first call for each distinct set of input shapes captures the whole invocation
+        into a CUDA graph. Later calls with the same shapes copy the inputs into the captured
+        input buffers and replay the graph, avoiding per-kernel launch overhead.
+
+        Note: the function must have static shapes and no host-synchronizing control flow.
+        The returned outputs are overwritten by the next replay with the same input shapes.
+        A VM on ROCm captures HIP graphs in the same way.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function to capture.
+
+        Returns
+        -------
+        func: PackedFunc
+            The function taking the same NDArray arguments as the VM function.
+        """
+        return self.module["capture_cuda_graph"](func_name)
+
+    def freeze_allocators(
+        self, func_name: Optional[str] = None, warmup_inputs: Sequence[Sequence[Any]] = ()
+    ) -> None:
+        """
+        Run the warm-up inputs, then freeze the allocators of the devices of the VM.
+
+        A frozen allocator reserves one arena holding as many buffers of each size as it has
+        needed at once so far, and serves all the later allocations from it. An allocation it
+        has no buffer left for fails instead of allocating from the device, so warm up with the
+        largest inputs, e.g. one per expected shape.
+
+        Only the "pooled" allocators can be frozen. They are shared by the VMs of the same
+        devices, which are frozen along.
+
+        Parameters
+        ----------
+        func_name : Optional[str]
+            The function the warm-up inputs are run through.
+
+        warmup_inputs : Sequence[Sequence[Any]]
+            The arguments of each warm-up run.
+        """
+        if warmup_inputs and func_name is None:
+            raise ValueError("The warm-up inputs need the function they are run through")
+        for args in warmup_inputs:
+            self[func_name](*args)
+        self.module["freeze_allocators"]()
+
+    def unfreeze_allocators(self) -> None:
+        """Release the arenas of the frozen allocators of the devices of the VM, which then
+        allocate from the devices again. The buffers of the arenas must all have been freed."""
+        self.module["unfreeze_allocators"]()
+
+    def make_batcher(
+        self, func_name: str, max_batch_size: int, max_delay_us: int = 1000
+    ) -> PackedFunc:
+        """
+        Get a function that gathers the concurrent calls of the named VM function into
+        batches, runs the VM function once per batch and scatters the results back.
+
+        Every argument must be an NDArray batched along its first dimension, which is
+        symbolic in the VM function. The calls with the same dtypes and other dimensions are
+        batched together, up to `max_batch_size` rows in total. A batch runs once it is full,
+        or once its oldest call has waited for `max_delay_us` microseconds.
+
+        Note: the batches run on a worker thread, in an execution context of this VM of its
+        own. The results of a batch of several calls are views into the outputs of the batch,
+        so every output of the VM function must be batched along its first dimension too.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function to batch.
+
+        max_batch_size: int
+            The max number of rows of a batch.
+
+        max_delay_us: int
+            The max time in microseconds a call waits for its batch to fill up.
+
+        Returns
+        -------
+        func: PackedFunc
+            The function taking the same NDArray arguments as the VM function, which may be
+            called from several threads at a time.
+        """
+        return self.module["make_batcher"](func_name, max_batch_size, max_delay_us)
+
+    def make_shape_dispatcher(
+        self, func_name: str, max_num_shapes: int = 1024
+    ) -> "ShapeDispatcher":
+        """
+        Get a dispatcher of the calls of the named VM function by the shapes of their
+        arguments, which records the histogram of the shapes and runs the calls with the
+        shapes of a specialization on its VM. The other calls run the function of this VM.
+
+        The specializations are added with `ShapeDispatcher.add_specialization`, or compiled
+        in the background for the hot shapes by a :py:class:`ShapeSpecializer`.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function to dispatch.
+
+        max_num_shapes: int
+            The max number of distinct shapes recorded in the histogram.
+
+        Returns
+        -------
+        dispatcher: ShapeDispatcher
+            The dispatcher, called with the same arguments as the VM function.
+        """
+        return ShapeDispatcher(
+            self.module["make_shape_dispatcher"](func_name, max_num_shapes), func_name
+        )
+
+    def profile(
+        self,
+        func_name: str,
+        *args: Any,
+        collectors: Optional[Sequence[MetricCollector]] = None,
+        **kwargs: Any,
+    ) -> Report:
+        """
+        Run a function once with every call timed on its device, and return the report of
+        the latency and the allocations of the calls.
+
+        Each call waits for the work queued before it and is synchronized with its device, so
+        the times are those of the call alone, at the cost of the overlap across calls. The
+        "Allocated Bytes" of a call are the change of the bytes in use of the allocators.
+
+        The collectors add their metrics to each call, e.g. the hardware counters of
+        :py:class:`tvm.runtime.profiling.PAPIMetricCollector`. On CPU, "PAPI_TOT_INS" and
+        "PAPI_TOT_CYC" give the IPC and the cache misses such as "PAPI_L3_TCM" the memory
+        traffic. On CUDA, the PAPI cuda component reads the CUPTI metrics, e.g.
+        "cuda:::sm__warps_active.avg.pct_of_peak_sustained_active:device=0" for the achieved
+        occupancy and "cuda:::dram__throughput.avg.pct_of_peak_sustained_elapsed:device=0" for
+        the DRAM throughput, which tell the compute-bound kernels from the memory-bound ones.
+
+        Note: the first run of a function includes its lazy initialization, so profile a
+        function after a warmup run of it.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+        args: List[tvm.runtime.NDArray] or List[np.ndarray]
+            The arguments to the function.
+        collectors : Optional[Sequence[MetricCollector]]
+            The collectors of extra metrics of the calls. They cannot be used over RPC.
+        kwargs: dict of str to tvm.runtime.NDArray or np.ndarray
+            Named arguments to the function.
+
+        Returns
+        -------
+        report : Report
+            The report of the calls run by the function. Use :py:meth:`chrome_trace` for a
+            timeline of the calls.
+        """
+        cargs: List[Any] = []
+
+        if kwargs:
+            args = self._convert_func_named_args(func_name, args, **kwargs)
+
+        for arg in args:
+            self._convert(arg, cargs)
+
+        if collectors is not None:
+            # The collectors cannot be serialized over RPC.
+            assert (
+                self.module.type_key != "rpc"
+            ), "Profiling with collectors is not supported over RPC"
+            return self.module["profile_with_collectors"](func_name, list(collectors), *cargs)
+        return self.module["profile"](func_name, *cargs)
+
+    def chrome_trace(self) -> str:
+        """
+        Get the timeline of the last :py:meth:`profile` run in the Chrome trace event format,
+        to be loaded by chrome://tracing or Perfetto.
+
+        Returns
+        -------
+        trace : str
+            The JSON of the trace, with a track of the calls for each device and a counter of
+            the bytes in use of the allocators.
+        """
+        return self.module["get_chrome_trace"]()
+
+    def set_sampling(self, invocation_rate: float = 0.01, call_stride: int = 1) -> None:
+        """
+        Turn on the sampling profiler, which times a fraction of the invocations of the VM
+        functions and of the calls they run, cheaply enough to stay on in production.
+
+        The sampled invocations and calls are timed on the device timers, e.g. CUDA events,
+        without synchronizing the device, and the timers are read at the next sampled
+        invocation. The latencies go into histograms shared with the contexts created by
+        :py:meth:`create_context` afterwards, which record into them concurrently.
+
+        Parameters
+        ----------
+        invocation_rate : float
+            The fraction of the top-level invocations to time, or 0 to turn sampling off.
+
+        call_stride : int
+            Time every `call_stride`-th call instruction of the timed invocations. The calls
+            counted rotate across the invocations, so that every call is covered over time.
+        """
+        self.module["set_sampling"](invocation_rate, call_stride)
+
+    def sampled_stats(self) -> Dict[str, Dict[str, Dict[str, float]]]:
+        """
+        Get the latency statistics of the sampling profiler.
+
+        Returns
+        -------
+        stats : Dict[str, Dict[str, Dict[str, float]]]
+            The statistics of the VM functions under "functions", and of the callees of the
+            call instructions, e.g. the kernels, under "calls". Each maps a name to its count,
+            mean_us, p50_us, p90_us, p99_us and max_us.
+        """
+        return json.loads(self.module["get_sampled_stats"]())
+
+    def reset_sampled_stats(self) -> None:
+        """Clear the latency statistics of the sampling profiler."""
+        self.module["reset_sampled_stats"]()
+
     def time_evaluator(
         self,
         func_name,
@@ -455,10 +911,372 @@ class VirtualMachine(object):
         )
 
 
+class BoundCall:
+    """A call of a VM function whose FFI arguments are built once, see
+    `VirtualMachine.bind_call`."""
+
+    def __init__(
+        self,
+        vm: VirtualMachine,
+        func_name: str,
+        outputs: Optional[Sequence[tvm.runtime.NDArray]] = None,
+    ):
+        self._vm = vm
+        self._func_name = func_name
+        self._arity = vm._get_function_arity(func_name)
+        outputs = list(outputs) if outputs is not None else []
+        for i, out in enumerate(outputs):
+            if not isinstance(out, tvm.runtime.NDArray):
+                raise TypeError(f"Output {i} must be an NDArray, but got {type(out)}")
+            vm.set_output_zero_copy(func_name, i, out)
+        self._outputs = outputs[0] if len(outputs) == 1 else tuple(outputs)
+        self._has_outputs = bool(outputs)
+        self._func = vm.module["invoke_zero_copy"]
+        self._handle = self._func.handle
+        num_args = self._arity + 1
+        self._num_args = ctypes.c_int(num_args)
+        self._values = (TVMValue * num_args)()
+        self._tcodes = (ctypes.c_int * num_args)()
+        self._name = _base.c_str(func_name)
+        self._values[0].v_str = self._name
+        self._tcodes[0] = ArgTypeCode.STR
+        self._ret_val = TVMValue()
+        self._ret_tcode = ctypes.c_int()
+
+    def __call__(self, *args: tvm.runtime.NDArray) -> Union[tvm.Object, Tuple[Any]]:
+        """Call the function with the input NDArrays, and return the output, which is the
+        bound buffers if the function wrote into them."""
+        if len(args) != self._arity:
+            raise ValueError(f"{self._func_name} takes {self._arity} inputs, but got {len(args)}")
+        values = self._values
+        tcodes = self._tcodes
+        for i, arg in enumerate(args, 1):
+            if not isinstance(arg, tvm.runtime.NDArray):
+                raise TypeError(f"Input {i - 1} must be an NDArray, but got {type(arg)}")
+            values[i].v_handle = arg._tvm_handle
+            tcodes[i] = ArgTypeCode.DLTENSOR_HANDLE if arg.is_view else ArgTypeCode.NDARRAY_HANDLE
+        _base.check_call(
+            _base._LIB.TVMFuncCall(
+                self._handle,
+                values,
+                tcodes,
+                self._num_args,
+                ctypes.byref(self._ret_val),
+                ctypes.byref(self._ret_tcode),
+            )
+        )
+        if self._has_outputs and self._ret_val.v_int64:
+            return self._outputs
+        return self._vm.get_outputs(self._func_name)
+
+
+ShapeKey = Tuple[Optional[Tuple[int, ...]], ...]
+
+
+class ShapeDispatcher:
+    """The calls of a VM function dispatched by the shapes of their arguments, see
+    `VirtualMachine.make_shape_dispatcher`.
+
+    The shapes of a call are the shape of each tensor or shape argument, or None for the other
+    arguments."""
+
+    def __init__(self, module: Module, func_name: str):
+        self.module = module
+        self.func_name = func_name
+        self._invoke = module["invoke"]
+        self._specialized: List[ShapeKey] = []
+
+    def __call__(self, *args: Any) -> Object:
+        return self._invoke(*args)
+
+    def shape_histogram(self) -> List[Tuple[ShapeKey, int]]:
+        """The distinct shapes of the calls and the numbers of calls with them, the most
+        frequent first."""
+        shapes, counts = self.module["get_shape_histogram"]()
+        histogram = [
+            (tuple(None if shape is None else tuple(shape) for shape in key), int(count))
+            for key, count in zip(shapes, counts)
+        ]
+        histogram.sort(key=lambda item: -item[1])
+        return histogram
+
+    @property
+    def num_calls(self) -> int:
+        """The number of calls, with the shapes beyond the histogram too."""
+        return self.module["get_num_calls"]()
+
+    @property
+    def num_specializations(self) -> int:
+        """The number of shapes dispatched to a specialization."""
+        return self.module["get_num_specializations"]()
+
+    @property
+    def specialized(self) -> List[ShapeKey]:
+        """The shapes dispatched to a specialization, in the order they were added."""
+        return list(self._specialized)
+
+    def add_specialization(self, shapes: ShapeKey, vm: VirtualMachine) -> None:
+        """Run the calls with the given shapes on the function of a VM, which must be
+        initialized on the device of the generic one. The VM may be added while calls go on."""
+        key = tuple(None if shape is None else tuple(shape) for shape in shapes)
+        shapes = [None if shape is None else tvm.runtime.ShapeTuple(shape) for shape in shapes]
+        self.module["add_specialization"](shapes, vm.module)
+        if key not in self._specialized:
+            self._specialized.append(key)
+
+    def clear_specializations(self) -> None:
+        """Run all the calls on the generic function again. A `ShapeSpecializer` of the
+        dispatcher specializes the hot shapes anew on its next step."""
+        self.module["clear_specializations"]()
+        self._specialized = []
+
+
+class ShapeSpecializer:
+    """Compile the function of a dispatcher specialized for the hot shapes of its calls, and add
+    the specialized VMs to the dispatcher, on a background thread or on each `step`.
+
+    The shapes called at least `min_calls` times are specialized, the most frequent first, up
+    to `max_specializations` of them. A specialization binds the symbolic dims of the function
+    with `relax.transform.SpecializeShapes`, applies `pipeline`, e.g. the tuning of the static
+    kernels and the application of the tuned records, and builds the module, so that the memory
+    of the specialized function is planned statically. A shape failing to compile is logged and
+    never tried again, its calls keep running the generic function.
+
+    Parameters
+    ----------
+    dispatcher: ShapeDispatcher
+        The dispatcher of the calls.
+
+    mod: IRModule
+        The module the generic executable is built from, best before legalization so that the
+        kernels of the high-level operators are specialized too.
+
+    target: Union[str, tvm.target.Target]
+        The target to build the specializations for.
+
+    device: Union[Device, List[Device]]
+        The device of the generic VM, to run the specializations on.
+
+    min_calls: int
+        The min number of calls of a shape to specialize it.
+
+    max_specializations: int
+        The max number of specializations.
+
+    interval_s: float
+        The time between two rounds of specialization on the background thread.
+
+    pipeline: Optional[Callable[[IRModule], IRModule]]
+        The transformation of the specialized module before it is built.
+
+    memory_cfg: Optional[Union[str, Dict[Device, str]]]
+        The memory allocators of the specialized VMs, see `VirtualMachine`.
+    """
+
+    def __init__(
+        self,
+        dispatcher: ShapeDispatcher,
+        mod: IRModule,
+        target: Union[str, tvm.target.Target],
+        device: Union[Device, List[Device]],
+        min_calls: int = 100,
+        max_specializations: int = 4,
+        interval_s: float = 1.0,
+        pipeline: Optional[Callable[[IRModule], IRModule]] = None,
+        memory_cfg: Optional[Union[str, Dict[Device, str]]] = None,
+    ) -> None:
+        if min_calls < 1:
+            raise ValueError(f"min_calls must be positive, but got {min_calls}")
+        self.dispatcher = dispatcher
+        self._mod = mod
+        self._target = target
+        self._device = device
+        self._min_calls = min_calls
+        self._max_specializations = max_specializations
+        self._interval_s = interval_s
+        self._pipeline = pipeline
+        self._memory_cfg = memory_cfg
+        self.failed: List[ShapeKey] = []
+        self._lock = threading.Lock()
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+
+    @property
+    def specialized(self) -> List[ShapeKey]:
+        """The shapes the dispatcher runs on a specialization, which are not specialized again
+        unless the specializations of the dispatcher are cleared."""
+        return self.dispatcher.specialized
+
+    def specialize(self, shapes: ShapeKey) -> VirtualMachine:
+        """Compile the VM of the function specialized for some shapes."""
+        func_name = self.dispatcher.func_name
+        mod = relax.transform.SpecializeShapes(func_name, shapes)(self._mod)
+        if self._pipeline is not None:
+            mod = self._pipeline(mod)
+        return VirtualMachine(build(mod, self._target), self._device, memory_cfg=self._memory_cfg)
+
+    def step(self) -> int:
+        """Specialize the hot shapes not specialized yet, and return the number of the
+        specializations added."""
+        with self._lock:
+            num_added = 0
+            specialized = self.specialized
+            for shapes, count in self.dispatcher.shape_histogram():
+                if len(specialized) >= self._max_specializations or count < self._min_calls:
+                    break
+                if shapes in specialized or shapes in self.failed:
+                    continue
+                try:
+                    vm = self.specialize(shapes)
+                except Exception:  # pylint: disable=broad-except
+                    logging.getLogger(__name__).warning(
+                        "Failed to specialize %s for the shapes %s",
+                        self.dispatcher.func_name,
+                        shapes,
+                        exc_info=True,
+                    )
+                    self.failed.append(shapes)
+                    continue
+                self.dispatcher.add_specialization(shapes, vm)
+                specialized.append(shapes)
+                num_added += 1
+            return num_added
+
+    def start(self) -> "ShapeSpecializer":
+        """Start specializing on a background thread every `interval_s` seconds."""
+        if self._thread is not None:
+            raise RuntimeError("The ShapeSpecializer is started already")
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._loop, daemon=True)
+        self._thread.start()
+        return self
+
+    def stop(self) -> None:
+        """Stop the background thread, after the specialization it is compiling, if any."""
+        if self._thread is None:
+            return
+        self._stop.set()
+        self._thread.join()
+        self._thread = None
+
+    def _loop(self) -> None:
+        while not self._stop.wait(self._interval_s):
+            self.step()
+
+    def __enter__(self) -> "ShapeSpecializer":
+        return self.start()
+
+    def __exit__(self, *exc_info: Any) -> None:
+        self.stop()
+
+
+def numa_node_cpus() -> Dict[int, List[int]]:
+    """Get the CPUs of each NUMA node of the system that this process may run on.
+
+    Returns
+    -------
+    node_cpus : Dict[int, List[int]]
+        The CPUs of each node, or all the CPUs as node 0 if the system reports no NUMA topology.
+    """
+    allowed = (
+        sorted(os.sched_getaffinity(0))
+        if hasattr(os, "sched_getaffinity")
+        else list(range(os.cpu_count() or 1))
+    )
+    node_cpus: Dict[int, List[int]] = {}
+    for path in sorted(glob.glob("/sys/devices/system/node/node[0-9]*/cpulist")):
+        node = int(os.path.basename(os.path.dirname(path))[len("node") :])
+        with open(path) as cpulist:
+            cpus = set()
+            for cpu_range in cpulist.read().strip().split(","):
+                if cpu_range:
+                    first, _, last = cpu_range.partition("-")
+                    cpus.update(range(int(first), int(last or first) + 1))
+        cpus_allowed = [cpu for cpu in allowed if cpu in cpus]
+        if cpus_allowed:
+            node_cpus[node] = cpus_allowed
+    return node_cpus or {0: allowed}
+
+
+class NUMAReplicas:
+    """One VirtualMachine of an executable per NUMA node, each running its kernels on a thread
+    pool of the CPUs of its node and reading its own copy of the constants placed on the node, so
+    that the requests served on a node do not read the weights across the sockets.
+
+    The replicas share the executable and the compiled kernels. The serving layer dispatches each
+    request to one of `num_replicas` replicas, e.g. from a serving thread per replica.
+
+    Parameters
+    ----------
+    exec: Union[Executable, Module]
+        The VM executable or Runtime Module.
+
+    memory_cfg : Optional[Union[str, Dict[Device, str]]]
+        The memory allocator of the VMs, see `VirtualMachine`.
+
+    num_threads_per_node : Optional[int]
+        The number of workers of the thread pool of each node, by default one per CPU of the node.
+
+    pool_prefix : str
+        The prefix of the names of the thread pools, followed by the node, e.g. "numa0".
+    """
+
+    def __init__(
+        self,
+        exec: Union[Executable, Module],
+        memory_cfg: Optional[Union[str, Dict[Device, str]]] = None,
+        num_threads_per_node: Optional[int] = None,
+        pool_prefix: str = "numa",
+    ) -> None:
+        create_pool = tvm.get_global_func("runtime.threading.CreateThreadPool")
+        self._remove_pool = tvm.get_global_func("runtime.threading.RemoveThreadPool")
+        self.nodes: List[int] = []
+        self.thread_pools: List[str] = []
+        self.replicas: List[VirtualMachine] = []
+        try:
+            for node, cpus in numa_node_cpus().items():
+                if num_threads_per_node is not None:
+                    cpus = cpus[:num_threads_per_node]
+                pool = f"{pool_prefix}{node}"
+                create_pool(pool, len(cpus), [str(cpu) for cpu in cpus])
+                self.nodes.append(node)
+                self.thread_pools.append(pool)
+                self.replicas.append(
+                    VirtualMachine(
+                        exec,
+                        tvm.cpu(),
+                        memory_cfg=memory_cfg,
+                        thread_pool=pool,
+                        replicate_constants=True,
+                    )
+                )
+        except Exception:
+            self.close()
+            raise
+
+    @property
+    def num_replicas(self) -> int:
+        """The number of the replicas, one per NUMA node."""
+        return len(self.replicas)
+
+    def __len__(self) -> int:
+        return len(self.replicas)
+
+    def __getitem__(self, index: int) -> VirtualMachine:
+        return self.replicas[index]
+
+    def close(self) -> None:
+        """Remove the thread pools of the replicas, after which the replicas must not run."""
+        for pool in self.thread_pools:
+            self._remove_pool(pool)
+        self.thread_pools = []
+
+
 def build(
     mod: tvm.IRModule,
     target: Union[str, tvm.target.Target],
     params: Optional[Dict[str, list]] = None,
+    exec_mode: str = "bytecode",
 ) -> Executable:
     """
     Build an IRModule to VM executable.
@@ -481,6 +1299,11 @@ def build(
     params: Optional[Dict[str, list]]
         Parameters for the input IRModule that will be bound.
 
+    exec_mode: str
+        "bytecode" to run the Relax functions in the dispatch loop of the VM, or "compiled" to also
+        compile their instructions into native host functions calling the kernels directly, which
+        the VM runs in place of the instructions. The bytecode is kept for the profiler.
+
     Returns
     -------
     ex: tvm.relax.vm.Executable
@@ -503,10 +1326,14 @@ def build(
     if isinstance(target, str):
         target = tvm.target.Target(target)
 
-    passes = [relax.transform.ToNonDataflow()]
+    passes = [relax.transform.DeduplicatePrimFuncs()]
+    passes.append(relax.transform.CheckpointActivations())
+    passes.append(relax.transform.ToNonDataflow())
     passes.append(relax.transform.CallTIRRewrite())
+    passes.append(relax.transform.InplaceElementwise())
     passes.append(relax.transform.VMGraphMemoryPlan())
     passes.append(relax.transform.VMMemoryLower())
+    passes.append(relax.transform.VMStreamAssign())
     passes.append(relax.transform.VMShapeLower())
     passes.append(relax.transform.AttachGlobalSymbol())
     seq = tvm.transform.Sequential(passes)
@@ -514,7 +1341,21 @@ def build(
 
     # Split primfunc and relax function
     rx_mod, tir_mod = _split_tir_relax(new_mod)
-    lib = tvm.build(tir_mod, target=target)
+    if exec_mode == "bytecode":
+        lib = tvm.build(tir_mod, target=target)
+    elif exec_mode == "compiled":
+        host = target.host if target.host is not None else tvm.target.Target("llvm")
+        if tvm.device(target.kind.name, 0).device_type == tvm.cpu(0).device_type:
+            host = target
+        vmtir_mod = _ffi_api.VMTIRCodeGen(rx_mod, tir_mod, host)  # type: ignore
+        if host.same_as(target):
+            tir_mod.update(vmtir_mod)
+            lib = tvm.build(tir_mod, target=target)
+        else:
+            target = tvm.target.Target(target, host=host)
+            lib = tvm.build({target: tir_mod, host: vmtir_mod})
+    else:
+        raise ValueError(f"Unknown exec_mode {exec_mode}, expected bytecode or compiled")
 
     # Extract external runtime modules if exist.
     ext_libs = []
@@ -524,10 +1365,42 @@ def build(
     if params is None:
         params = {}
 
+    workspace_bytes = tvm.tir.IntImm("int64", _workspace_bytes(tir_mod))
+    rx_mod = rx_mod.with_attr("vm_workspace_bytes", workspace_bytes)
     # type: ignore
     return Executable(_ffi_api.VMCodeGen(rx_mod, lib, ext_libs, target, params))
 
 
+def _workspace_bytes(tir_mod: tvm.IRModule) -> int:
+    """The bytes of the global intermediate buffers of the kernel with the most of them, counting
+    only the buffers of static size."""
+    workspace_bytes = 0
+    for func in tir_mod.functions.values():
+        if not isinstance(func, PrimFunc):
+            continue
+        buffers = []
+
+        def _visit(node):
+            if isinstance(node, tvm.tir.Block):
+                buffers.extend((buf.scope(), buf.shape, buf.dtype) for buf in node.alloc_buffers)
+            elif isinstance(node, tvm.tir.Allocate):
+                scope = node.buffer_var.type_annotation.storage_scope
+                buffers.append((scope, node.extents, node.dtype))
+
+        tvm.tir.stmt_functor.post_order_visit(func.body, _visit)
+        func_bytes = 0
+        for scope, shape, dtype in buffers:
+            if scope != "global" or not all(isinstance(dim, tvm.tir.IntImm) for dim in shape):
+                continue
+            dtype = tvm.DataType(dtype)
+            num_bytes = (dtype.bits * dtype.lanes + 7) // 8
+            for dim in shape:
+                num_bytes *= int(dim)
+            func_bytes += num_bytes
+        workspace_bytes = max(workspace_bytes, func_bytes)
+    return workspace_bytes
+
+
 def _split_tir_relax(mod: tvm.IRModule) -> Tuple[tvm.IRModule, tvm.IRModule]:
     rx_mod = IRModule({})
     tir_mod = IRModule({})
@@ -20,10 +20,11 @@ from collections import defaultdict
 from typing import List, Callable
 import tvm
 from tvm import relay
-from tvm.relay.backend.contrib.ethosu.tir.compiler import LowerToTIR
+from tvm.relay.backend.contrib.ethosu.tir.compiler import LowerToTIR, lower_npu_function_to_te
 from tvm.relay.backend.contrib.ethosu.tir.scheduler import copy_constants
 from tvm.contrib.ethosu.cascader import (
     cascade,
+    search_plans,
     EthosuDeviceConfig,
     CascaderOptions,
     MemoryRegion,
@@ -354,6 +355,11 @@ def _create_cascader(
             device_config,
         )
 
+    def _search_plans(te_graphs):
+        search_plans(te_graphs, options, io_region, constant_region, working_regions, device_config)
+
+    # The plans of independent graphs are searched in parallel before cascading them in turn
+    _cascader.search_plans = _search_plans
     return _cascader
 
 
@@ -465,7 +471,15 @@ def relay_to_tir(mod: tvm.ir.IRModule) -> tvm.ir.IRModule:
 
         memory_pressure = _calculate_memory_pressure(mod)
         sram = extract_memory_info(workspace_memory_pools.pools[0], memory_pressure)
-        tir_mod = LowerToTIR(_ethos_u55_cascader(sram, util.is_striping_enabled()))(mod)
+        cascader = _ethos_u55_cascader(sram, util.is_striping_enabled())
+        cascader.search_plans(
+            [
+                lower_npu_function_to_te(func)
+                for _, func in mod.functions.items()
+                if util.is_npu_func(func)
+            ]
+        )
+        tir_mod = LowerToTIR(cascader)(mod)
     else:
         tir_mod = LowerToTIR(copy_constants())(mod)
 
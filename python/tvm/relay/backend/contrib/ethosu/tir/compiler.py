@@ -219,6 +219,29 @@ class LowerToTIR:
         pass
 
 
+def lower_npu_function_to_te(func):
+    """Lower a Relay function for the Arm(R) Ethos(TM)-U NPU to a Tensor Expression graph, with
+    its constants extracted as inputs.
+
+    Parameters
+    ----------
+    func : tvm.relay.Function
+        The Relay function to lower.
+
+    Returns
+    -------
+    cached_func : CachedFunc
+        The lowered Tensor Expression as part of a CachedFunc.
+    consts : dict of int to numpy.ndarray
+        A dict of the extracted constants keyed by their param index.
+
+    """
+    func, consts = extract_constants(func)
+    mod = tvm.IRModule.from_expr(func)
+    func = relay.transform.InferType()(mod)["main"]
+    return lower_to_te(func), consts
+
+
 def _lower_to_tir(func, cascader=None):
     """Lower a Relay function to TIR for the Arm(R) Ethos(TM)-U NPU target.
 
@@ -240,10 +263,7 @@ def _lower_to_tir(func, cascader=None):
         A dict of the extracted constants keyed by their param index.
 
     """
-    func, consts = extract_constants(func)
-    mod = tvm.IRModule.from_expr(func)
-    func = relay.transform.InferType()(mod)["main"]
-    cached_func = lower_to_te(func)
+    cached_func, consts = lower_npu_function_to_te(func)
     s = schedule(cached_func, consts, cascader)
     mod, consts = lower_ethosu(s, cached_func, consts)
     return mod, consts
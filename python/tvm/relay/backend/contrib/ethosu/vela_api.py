@@ -28,6 +28,7 @@ import numpy as np  # type: ignore
 from ethosu.vela import api as vapi  # type: ignore
 
 import tvm
+from tvm.contrib.ethosu.cache import ContentCache
 from tvm.relay.backend.contrib.ethosu import util  # type: ignore
 from tvm.relay.backend.contrib.ethosu import tir_to_cs_translator as tirtocs
 
@@ -44,6 +45,9 @@ VELA_TO_NP_DTYPES = {
 
 SCALE_BIAS_LENGTH = 10
 
+# The encoded weights, keyed by the raw weights and the encoding parameters
+WEIGHTS_CACHE = ContentCache("weights")
+
 
 def get_optimal_block_config(
     npu_op: vapi.NpuOperation, accel_config: vapi.NpuAccelerator
@@ -211,6 +215,22 @@ def compress_weights(
     layout_transform_indices = {"HWIO": (3, 0, 1, 2), "HWOI": (2, 0, 1, 3), "OHWI": (0, 1, 2, 3)}
     assert weights_layout in layout_transform_indices.keys()
     assert isinstance(weights_zp, np.int64)
+    cache_key = ContentCache.key(
+        np.ascontiguousarray(weights).tobytes(),
+        weights.shape,
+        str(weights.dtype),
+        int(weights_zp),
+        weights_layout,
+        ifm_bitdepth,
+        block_depth,
+        tuple(dilation),
+        str(accel_config),
+        bool(is_depthwise),
+        vapi.npu_get_API_version(),
+    )
+    cached_weights = WEIGHTS_CACHE.get(cache_key)
+    if cached_weights is not None:
+        return bytearray(cached_weights)
     weights = weights.astype(np.int16) - weights_zp
     # Vela needs the weights in OHWI layout
     weights_ohwi = np.transpose(weights, layout_transform_indices[weights_layout])
@@ -231,6 +251,7 @@ def compress_weights(
         is_depthwise=is_depthwise,
         block_traversal=block_traversal,
     )
+    WEIGHTS_CACHE.put(cache_key, compressed_weights)
     return compressed_weights
 
 
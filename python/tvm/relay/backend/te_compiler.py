@@ -412,3 +412,13 @@ def get():
         The TE Compiler.
     """
     return _backend._TECompilerGlobal()
+
+
+def clear_global_cache():
+    """Clear the lowered functions shared by the TE Compilers of the process.
+
+    The sharing is enabled by the "relay.backend.te_compiler_global_cache" config of the
+    PassContext, and "relay.backend.te_compiler_cache_dir" further persists the lowered functions
+    into a directory, which this does not clear.
+    """
+    _backend._TECompilerGlobalCacheClear()
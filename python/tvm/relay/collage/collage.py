@@ -22,6 +22,7 @@ import logging
 import os
 import math
 import tempfile
+import threading
 
 import numpy as np
 
@@ -35,6 +36,10 @@ MEASURE_NUMBER = 20
 MEASURE_REPEAT = 5
 WARMUP_MIN_REPEAT_MS = 250
 
+# Candidates may be compiled concurrently, see "relay.collage.num_estimation_threads", but are
+# benchmarked one at a time so that the measurements do not interfere.
+_BENCHMARK_LOCK = threading.Lock()
+
 
 @register_object("relay.collage.CostEstimator")
 class CostEstimator(Object):
@@ -109,7 +114,8 @@ def estimate_seconds(mod, target):
     func_name = "main"
     main_args = {v.name_hint: arg_for(v.checked_type, device) for v in mod[func_name].params}
     logging.info("Benchmarking module to estimate")
-    profile = vm_estimate_seconds(device, the_vm, func_name, main_args)
+    with _BENCHMARK_LOCK:
+        profile = vm_estimate_seconds(device, the_vm, func_name, main_args)
     logging.info("profile: %s", profile)
     return profile.median  # seconds
 
@@ -17,7 +17,8 @@
 """Find scales for quantization on the dataset."""
 from __future__ import absolute_import
 import logging
-import multiprocessing as mp
+import queue
+from concurrent.futures import ThreadPoolExecutor
 import numpy as np
 import tvm
 import tvm.driver
@@ -30,10 +31,14 @@ from .. import expr as _expr
 from .. import analysis as _analysis
 from .. import build_module as _build_module
 from ...contrib import graph_executor
-from .kl_divergence import _find_scale_by_kl
 
 
 def _get_profile_runtime(mod):
+    return _get_profile_runtimes(mod, 1)[0]
+
+
+def _get_profile_runtimes(mod, num_runtimes):
+    """Build the profile graph once and create an executor of it for each worker."""
     func = mod["main"]
     func = _quantize.CreateStatsCollector(func)
 
@@ -46,9 +51,7 @@ def _get_profile_runtime(mod):
 
     with tvm.transform.PassContext(opt_level=3):
         lib = _build_module.build(func, target=target)
-    runtime = graph_executor.GraphModule(lib["default"](dev))
-
-    return runtime
+    return [graph_executor.GraphModule(lib["default"](dev)) for _ in range(num_runtimes)]
 
 
 def collect_stats(mod, dataset, chunk_by=-1):
@@ -90,14 +93,84 @@ def collect_stats(mod, dataset, chunk_by=-1):
         yield [np.concatenate(output).reshape(-1) for output in outputs]
 
 
+def _run_batches(runtimes, dataset, fupdate):
+    """Run the batches of the dataset on the executors, each running one batch at a time, and
+    accumulate the outputs of each batch with fupdate."""
+    idle = queue.Queue()
+    for runtime in runtimes:
+        idle.put(runtime)
+
+    def run(batch):
+        runtime = idle.get()
+        try:
+            runtime.set_input(**batch)
+            runtime.run()
+            fupdate(runtime)
+        finally:
+            idle.put(runtime)
+
+    if len(runtimes) == 1:
+        for batch in dataset:
+            run(batch)
+        return
+    with ThreadPoolExecutor(len(runtimes)) as executor:
+        for _ in executor.map(run, dataset):
+            pass
+
+
+def collect_streaming_stats(mod, dataset, num_workers=1, num_bins=8001, num_abs_bins=16384):
+    """Given an annotated graph, accumulate the histograms of the simulated_quantize op inputs
+    over the calibration dataset, without keeping the outputs of the batches.
+
+    The dataset is visited twice, for the ranges of the outputs and then for their histograms,
+    and the batches are run in parallel on `num_workers` executors of the profile graph.
+
+    Parameters
+    ----------
+    mod: Module
+        The simulation graph after annotation.
+
+    dataset: Iterable[NDArray]
+        The calibration dataset. An iterator is materialized to be visited twice.
+
+    num_workers: int
+        The number of executors running the batches in parallel.
+
+    num_bins: int
+        The number of bins of the histograms for KL divergence minimization.
+
+    num_abs_bins: int
+        The number of bins of the histograms of the absolute values, for percentiles.
+
+    Returns
+    -------
+    ret: Object
+        The accumulated relay.quantize.CalibrationStats.
+    """
+    logging.info("collecting streaming statistics for calibration...")
+    runtimes = _get_profile_runtimes(mod, max(num_workers, 1))
+    num_outputs = runtimes[0].get_num_outputs()
+    stats = _quantize.CalibrationStats(num_outputs, num_bins, num_abs_bins)
+    if iter(dataset) is dataset:
+        dataset = list(dataset)
+    for update in [
+        _quantize.CalibrationStatsUpdateRange,
+        _quantize.CalibrationStatsUpdateHistogram,
+    ]:
+
+        def fupdate(runtime, update=update):
+            for i in range(num_outputs):
+                update(stats, i, runtime.get_output(i))
+
+        _run_batches(runtimes, dataset, fupdate)
+    return stats
+
+
 def _kl_scale(mod, dataset):
     cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with kl for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_kl, samples))
+    stats = collect_streaming_stats(mod, dataset, cfg.calibrate_num_workers)
+    logging.info("finding threshold with kl for calibration...")
+    scales = [s.value for s in _quantize.CalibrationStatsFindScalesByKL(stats, 255)]
 
     def func(_):
         scale = scales[func.scale_idx]
@@ -118,12 +191,9 @@ def _find_scale_by_percentile(arr, percentile=0.99999):
 
 def _percentile_scale(mod, dataset):
     cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with percentile for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_percentile, samples))
+    stats = collect_streaming_stats(mod, dataset, cfg.calibrate_num_workers)
+    logging.info("finding threshold with percentile for calibration...")
+    scales = [s.value for s in _quantize.CalibrationStatsFindScalesByPercentile(stats, 0.99999)]
 
     def func(_):
         scale = scales[func.scale_idx]
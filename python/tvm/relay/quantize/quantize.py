@@ -86,6 +86,7 @@ class QConfig(Object):
         "debug_enabled_ops": None,
         "rounding": "UPWARD",
         "calibrate_chunk_by": -1,
+        "calibrate_num_workers": 1,
         "partition_conversions": "disabled",
     }
 
@@ -180,6 +181,11 @@ def qconfig(**kwargs):
     rounding: "UPWARD" or "TONEAREST"
         Rounding direction for fixed point multiplications.
 
+    calibrate_num_workers: int
+        The number of executors running the calibration batches in parallel,
+        for the calibrate modes collecting statistics on the dataset.
+        The default value is 1.
+
     partition_conversions: 'disabled', 'enabled', or 'fully_integral'
         If set to 'enabled' or 'fully_integral', partitions a quantized
         result into a module containing
@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """RPC client tools"""
+import hashlib
 import os
 import socket
 import stat
@@ -24,6 +25,7 @@ import time
 import tvm._ffi
 from tvm._ffi.base import TVMError
 from tvm.contrib import utils
+from tvm.runtime import Object
 from tvm.runtime import ndarray as nd
 from tvm._ffi.runtime_ctypes import Device
 
@@ -91,7 +93,7 @@ class RPCSession(object):
         dev._rpc_sess = self
         return dev
 
-    def upload(self, data, target=None):
+    def upload(self, data, target=None, use_cache=False):
         """Upload file to remote runtime temp folder
 
         Parameters
@@ -101,6 +103,12 @@ class RPCSession(object):
 
         target : str, optional
             The path in remote
+
+        use_cache : bool, optional
+            Whether to look the content up in the cache of the remote by its hash first, and only
+            send it on a miss, caching it for the later sessions. This saves re-uploading the same
+            libraries and weights to the remote in every session. The cache of the remote is in
+            TVM_RPC_CACHE_DIR if set there, or in `rpc_cache` of its TVM cache directory.
         """
         if isinstance(data, bytearray):
             if not target:
@@ -111,6 +119,23 @@ class RPCSession(object):
             if not target:
                 target = os.path.basename(data)
 
+        if use_cache and "upload_from_cache" not in self._remote_funcs:
+            try:
+                self._remote_funcs["upload_from_cache"] = self.get_function(
+                    "tvm.rpc.server.upload_from_cache"
+                )
+                self._remote_funcs["upload_to_cache"] = self.get_function(
+                    "tvm.rpc.server.upload_to_cache"
+                )
+            except AttributeError:
+                # The remote has no cache, to which the content is uploaded as usual.
+                self._remote_funcs["upload_from_cache"] = None
+        if use_cache and self._remote_funcs["upload_from_cache"] is not None:
+            digest = hashlib.sha256(blob).hexdigest()
+            if not self._remote_funcs["upload_from_cache"](target, digest):
+                self._remote_funcs["upload_to_cache"](target, digest, blob)
+            return
+
         if "upload" not in self._remote_funcs:
             self._remote_funcs["upload"] = self.get_function("tvm.rpc.server.upload")
         self._remote_funcs["upload"](target, blob)
@@ -196,6 +221,92 @@ class RPCSession(object):
             )
         return self._remote_funcs["download_linked_module"](path)
 
+    def set_transfer_chunk_size(self, nbytes):
+        """Set the max bytes of data a copy between the host and the remote sends in one packet.
+
+        A large copy is streamed in chunks, so that neither side buffers more than a chunk of it
+        at a time. The remote may limit the chunks further. The default is 16 MiB.
+
+        Parameters
+        ----------
+        nbytes : int
+            The max bytes of a chunk, or 0 to send every copy in a single packet.
+        """
+        _ffi_api.SetTransferChunkSize(self._sess, nbytes)
+
+    def enable_async(self, max_inflight=64):
+        """Switch the session to the async mode, in which the requests are pipelined over the
+        connection instead of each waiting for the reply of the previous one.
+
+        The synchronous calls keep working in the async mode, while `async_call`,
+        `async_copy_to_remote` and `async_copy_from_remote` return futures without waiting.
+
+        Parameters
+        ----------
+        max_inflight : int
+            The max number of requests waiting for their replies, beyond which a new request
+            blocks until the oldest one completes.
+        """
+        _ffi_api.EnableAsync(self._sess, max_inflight)
+
+    def async_call(self, func, *args):
+        """Call a remote function without waiting for its return.
+
+        Parameters
+        ----------
+        func : PackedFunc
+            The remote function, e.g. from `get_function` or a remote module.
+
+        args : list
+            The arguments.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the return value.
+        """
+        return _ffi_api.AsyncCall(func, *args)
+
+    def async_copy_to_remote(self, source, target):
+        """Copy a local array into a remote array without waiting for the copy.
+
+        Parameters
+        ----------
+        source : numpy.ndarray or NDArray
+            The local array, which is kept alive by the future.
+
+        target : NDArray
+            The remote array of the same size.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the copy.
+        """
+        if not isinstance(source, nd.NDArray):
+            source = nd.array(source)
+        return _ffi_api.AsyncCopyToRemote(source, target)
+
+    def async_copy_from_remote(self, source, target=None):
+        """Copy a remote array into a local array without waiting for the copy.
+
+        Parameters
+        ----------
+        source : NDArray
+            The remote array.
+
+        target : NDArray, optional
+            The local array of the same size, allocated if not given.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future whose result is the local array.
+        """
+        if target is None:
+            target = nd.empty(source.shape, source.dtype)
+        return _ffi_api.AsyncCopyFromRemote(source, target)
+
     def cpu(self, dev_id=0):
         """Construct CPU device."""
         return self.device(Device.kDLCPU, dev_id)
@@ -233,6 +344,22 @@ class RPCSession(object):
         return self.device(Device.kDLWebGPU, dev_id)
 
 
+@tvm._ffi.register_object("rpc.RPCFuture")
+class RPCFuture(Object):
+    """The result of an asynchronous RPC request."""
+
+    def done(self):
+        """Whether the request has completed."""
+        return bool(_ffi_api.FutureDone(self))
+
+    def result(self):
+        """Wait for the request to complete and return its result.
+
+        Raises the error of the request if it fails on the remote.
+        """
+        return _ffi_api.FutureResult(self)
+
+
 class LocalSession(RPCSession):
     """RPCSession interface backed by local environment.
 
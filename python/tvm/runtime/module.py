@@ -251,6 +251,19 @@ class Module(object):
         """
         return _ffi_api.ModuleIsDSOExportable(self)
 
+    def init_imports(self, num_threads=0):
+        """Initialize the external submodules in the import tree, e.g. the BYOC subgraphs, with
+        their constants in parallel.
+
+        The submodules are otherwise initialized at the first call of their functions.
+
+        Parameters
+        ----------
+        num_threads : int
+            The number of threads, the number of cores if not positive.
+        """
+        _ffi_api.ModuleInitImports(self, num_threads)
+
     def save(self, file_name, fmt=""):
         """Save the module to file.
 
@@ -394,7 +407,15 @@ class Module(object):
     def _collect_dso_modules(self):
         return self._collect_from_import_tree(lambda m: m.is_dso_exportable)
 
-    def export_library(self, file_name, fcompile=None, addons=None, workspace_dir=None, **kwargs):
+    def export_library(
+        self,
+        file_name,
+        fcompile=None,
+        addons=None,
+        workspace_dir=None,
+        const_alignment=None,
+        **kwargs,
+    ):
         """
         Export the module and all imported modules into a single device library.
 
@@ -426,6 +447,13 @@ class Module(object):
             artifacts when exporting the module.
             If this is not provided a temporary dir will be created.
 
+        const_alignment : int, optional
+            The alignment in bytes, a power of two in [64, 4096], of the data of the constants of
+            the external submodules in the embedded module blob. The constants are then viewed in
+            place in the library mapped by the dynamic loader instead of copied at load, and share
+            the page cache across the processes. Only the blobs packed with LLVM are aligned, the
+            constants are copied otherwise.
+
         kwargs : dict, optional
             Additional arguments passed to fcompile
 
@@ -521,16 +549,22 @@ class Module(object):
             raise ValueError("%s need --system-lib option" % str(fcompile))
 
         if self.imported_modules:
-            if enabled("llvm") and llvm_target_string:
-                path_obj = os.path.join(workspace_dir, f"devc.{global_object_format}")
-                m = _ffi_api.ModulePackImportsToLLVM(self, is_system_lib, llvm_target_string)
-                m.save(path_obj)
-                files.append(path_obj)
-            else:
-                path_cc = os.path.join(workspace_dir, "devc.c")
-                with open(path_cc, "w") as f:
-                    f.write(_ffi_api.ModulePackImportsToC(self, is_system_lib))
-                files.append(path_cc)
+            if const_alignment:
+                _ffi_api.ModuleSetConstAlignment(self, const_alignment)
+            try:
+                if enabled("llvm") and llvm_target_string:
+                    path_obj = os.path.join(workspace_dir, f"devc.{global_object_format}")
+                    m = _ffi_api.ModulePackImportsToLLVM(self, is_system_lib, llvm_target_string)
+                    m.save(path_obj)
+                    files.append(path_obj)
+                else:
+                    path_cc = os.path.join(workspace_dir, "devc.c")
+                    with open(path_cc, "w") as f:
+                        f.write(_ffi_api.ModulePackImportsToC(self, is_system_lib))
+                    files.append(path_cc)
+            finally:
+                if const_alignment:
+                    _ffi_api.ModuleSetConstAlignment(self, 0)
 
         # The imports could contain a c module but the object format could be tar
         # Thus, it would not recognize the following include paths as options
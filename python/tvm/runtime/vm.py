@@ -402,6 +402,8 @@ class VirtualMachine(object):
         self._set_input = self.module["set_input"]
         self._set_one_input = self.module["set_one_input"]
         self._set_outputs = self.module["set_outputs"]
+        self._set_storage_arena = self.module["set_storage_arena"]
+        self._get_num_storage_allocs = self.module["get_num_storage_allocs"]
         self._setup_device(device, memory_cfg)
 
     def _setup_device(self, dev, memory_cfg):
@@ -607,6 +609,31 @@ class VirtualMachine(object):
         """
         return [self._get_output(i) for i in range(self._get_num_outputs())]
 
+    def set_storage_arena(self, enabled=True):
+        """Allocate the storage of the invocations out of an arena.
+
+        The storage allocations of an invocation are recorded, and the next invocations making
+        the same allocations carve them out of one region per device, so that they make no
+        allocator call. An invocation making other allocations falls back to the allocators and
+        replaces the recorded ones. Two sets of regions are kept, so that the outputs of an
+        invocation can be alive during the next one.
+
+        Parameters
+        ----------
+        enabled : bool
+            Whether the invocations allocate out of the arena.
+        """
+        self._set_storage_arena(enabled)
+
+    def get_num_storage_allocs(self):
+        """Get the number of allocator calls of the last invocation.
+
+        Returns
+        -------
+        num_allocs : int
+        """
+        return self._get_num_storage_allocs()
+
     def get_input_index(self, input_name, func_name="main"):
         """Get inputs index via input name.
         Parameters
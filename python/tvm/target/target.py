@@ -642,6 +642,9 @@ def hexagon(cpu_ver="v66", **kwargs):
         Whether to use IEEE HVX instructions
     num_cores : int (default: 4)
         The number of HVX threads. This attribute is required by meta scheduler.
+    vtcm_capacity : int (default: 0)
+        The bytes of VTCM the kernels may stage data into. The value 0 leaves it to the
+        compiler, which assumes 4MB.
 
     Note: Floating point support in HVX requires LLVM 14+.
     """
@@ -749,6 +752,10 @@ def hexagon(cpu_ver="v66", **kwargs):
     num_cores = config["num_cores"] if "num_cores" in kwargs else 4
     args_list.append("--num-cores=%d" % num_cores)
 
+    vtcm_capacity = config.get("vtcm_capacity", 0)
+    if vtcm_capacity > 0:
+        args_list.append("--vtcm-capacity=%d" % vtcm_capacity)
+
     return Target(" ".join(["hexagon"] + args_list))
 
 
@@ -62,7 +62,16 @@ from .op import (
 )
 from .op import ptx_mma, ptx_mma_sp, mma_store, mma_fill
 from .op import ptx_ldmatrix, ptx_cp_async, ptx_commit_group, ptx_wait_group
-from .op import vectorlow, vectorhigh, vectorcombine
+from .op import (
+    ptx_cp_async_bulk,
+    ptx_init_barrier_thread_count,
+    ptx_arrive_barrier_expect_tx,
+    ptx_wait_barrier,
+    ptx_fence_barrier_init,
+    ptx_fence_proxy_async,
+)
+from .op import ptx_wgmma, ptx_wgmma_fence, ptx_wgmma_commit_group, ptx_wgmma_wait_group
+from .op import vectorlow, vectorhigh, vectorcombine, vscale
 from .op import infinity, reinterpret
 from .op import exp, exp2, exp10, log, log2, log10, log1p, ldexp, clz
 from .op import sin, sinh, asin, asinh
@@ -1276,6 +1276,305 @@ def ptx_wait_group(num):
     return call_intrin("", "tir.ptx_wait_group", num)
 
 
+def ptx_cp_async_bulk(
+    dtype, shared_ptr, shared_offset, global_ptr, global_offset, bytes, barrier_ptr, barrier_offset
+):
+    """TVM intrinsic for ptx async bulk copy from global to shared memory, completing the
+    transaction bytes of an mbarrier
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-cp-async-bulk
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result.
+
+    shared_ptr : Var
+        The shared memory pointer variable.
+
+    shared_offset : Expr
+        The offset of shared memory pointer.
+
+    global_ptr : Var
+        The global memory pointer variable.
+
+    global_offset : Expr
+        The offset of global memory pointer.
+
+    bytes : Expr
+        The data size to copy, a multiple of 16.
+
+    barrier_ptr : Var
+        The pointer variable of the uint64 mbarriers in shared memory.
+
+    barrier_offset : Expr
+        The offset of the mbarrier completing the copy.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_cp_async_bulk",
+        shared_ptr,
+        shared_offset,
+        global_ptr,
+        global_offset,
+        bytes,
+        barrier_ptr,
+        barrier_offset,
+    )
+
+
+def ptx_init_barrier_thread_count(barrier_ptr, barrier_offset, thread_count):
+    """TVM intrinsic for ptx mbarrier initialization
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-mbarrier-init
+
+    Parameters
+    ----------
+    barrier_ptr : Var
+        The pointer variable of the uint64 mbarriers in shared memory.
+
+    barrier_offset : Expr
+        The offset of the mbarrier.
+
+    thread_count : Expr
+        The number of the threads arriving at the mbarrier in each phase.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        "", "tir.ptx_init_barrier_thread_count", barrier_ptr, barrier_offset, thread_count
+    )
+
+
+def ptx_arrive_barrier_expect_tx(barrier_ptr, barrier_offset, byte_count):
+    """TVM intrinsic for ptx mbarrier arrival expecting the transaction bytes of async copies
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-mbarrier-arrive
+
+    Parameters
+    ----------
+    barrier_ptr : Var
+        The pointer variable of the uint64 mbarriers in shared memory.
+
+    barrier_offset : Expr
+        The offset of the mbarrier.
+
+    byte_count : Expr
+        The number of bytes the async copies of the phase complete.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        "", "tir.ptx_arrive_barrier_expect_tx", barrier_ptr, barrier_offset, byte_count
+    )
+
+
+def ptx_wait_barrier(barrier_ptr, barrier_offset, phase):
+    """TVM intrinsic for ptx mbarrier wait for the completion of a phase
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-mbarrier-test-wait-try-wait
+
+    Parameters
+    ----------
+    barrier_ptr : Var
+        The pointer variable of the uint64 mbarriers in shared memory.
+
+    barrier_offset : Expr
+        The offset of the mbarrier.
+
+    phase : Expr
+        The parity of the phase to wait for.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wait_barrier", barrier_ptr, barrier_offset, phase)
+
+
+def ptx_fence_barrier_init():
+    """TVM intrinsic for ptx fence making the mbarrier initialization visible to the async copies
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-membar
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_fence_barrier_init")
+
+
+def ptx_fence_proxy_async():
+    """TVM intrinsic for ptx fence ordering the shared memory accesses of the threads before the
+    ones of the async proxy, the bulk copies and wgmma
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-membar
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_fence_proxy_async")
+
+
+def ptx_wgmma(
+    dtype,
+    shape,
+    A_dtype,
+    B_dtype,
+    C_dtype,
+    multiplicand_a,
+    a_index,
+    a_leading_byte_offset,
+    a_stride_byte_offset,
+    multiplicand_b,
+    b_index,
+    b_leading_byte_offset,
+    b_stride_byte_offset,
+    accumulator,
+    c_index,
+    scale_d,
+    trans_a=False,
+    trans_b=False,
+):
+    """TVM intrinsic for ptx warpgroup-level tensor core wgmma instructions, with both
+    multiplicands in shared memory, laid out in the core matrices of 8 rows of 16 bytes without
+    swizzling
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions
+
+    Parameters
+    ----------
+    dtype : str
+        The data type of the result.
+
+    shape : str
+        The shape of wgmma fragment, m64nNk16 with N a multiple of 8 up to 256.
+
+    A_dtype : str
+        The data type of multiplicand A, fp16 or bf16.
+
+    B_dtype : str
+        The data type of multiplicand B, the same as A_dtype.
+
+    C_dtype : str
+        The data type of the accumulator, fp32, or fp16 with fp16 multiplicands.
+
+    multiplicand_a : Var
+        The shared memory pointer variable of multiplicand A.
+
+    a_index : Expr
+        The index of the first element of multiplicand A.
+
+    a_leading_byte_offset : Expr
+        The bytes between the core matrices of A along the leading dimension.
+
+    a_stride_byte_offset : Expr
+        The bytes between the core matrices of A along the strided dimension.
+
+    multiplicand_b : Var
+        The shared memory pointer variable of multiplicand B.
+
+    b_index : Expr
+        The index of the first element of multiplicand B.
+
+    b_leading_byte_offset : Expr
+        The bytes between the core matrices of B along the leading dimension.
+
+    b_stride_byte_offset : Expr
+        The bytes between the core matrices of B along the strided dimension.
+
+    accumulator : Var
+        The local pointer variable of the accumulators of the thread.
+
+    c_index : Expr
+        The index of the first accumulator of the thread.
+
+    scale_d : Expr
+        Whether to accumulate into the accumulators, or to overwrite them.
+
+    trans_a : bool
+        Whether multiplicand A is transposed.
+
+    trans_b : bool
+        Whether multiplicand B is transposed.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_wgmma",
+        shape,
+        A_dtype,
+        B_dtype,
+        C_dtype,
+        multiplicand_a,
+        a_index,
+        a_leading_byte_offset,
+        a_stride_byte_offset,
+        multiplicand_b,
+        b_index,
+        b_leading_byte_offset,
+        b_stride_byte_offset,
+        accumulator,
+        c_index,
+        scale_d,
+        trans_a,
+        trans_b,
+    )
+
+
+def ptx_wgmma_fence():
+    """TVM intrinsic for ptx fence ordering the register accesses before wgmma
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-fence
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_fence")
+
+
+def ptx_wgmma_commit_group():
+    """TVM intrinsic for ptx wgmma commit
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-commit-group
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_commit_group")
+
+
+def ptx_wgmma_wait_group(num):
+    """TVM intrinsic for ptx wgmma wait
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-wait-group
+
+    Parameters
+    ----------
+    num : int
+        The number of the most recent pending wgmma groups to leave pending.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_wait_group", num)
+
+
 def vectorlow(dtype, vec):
     """Get the low level half of the vector
 
@@ -1333,6 +1632,18 @@ def vectorcombine(dtype, vec1, vec2):
     return call_intrin(dtype, "tir.vectorcombine", vec1, vec2)
 
 
+def vscale():
+    """Get the vscale of the target, the width of its scalable vector registers in
+    multiples of their minimum width, i.e. 128 bits for SVE and 64 bits for RVV.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("int32", "tir.vscale")
+
+
 def ret(val):
     """Create a tir return expression
 
@@ -21,7 +21,7 @@ import tvm._ffi
 from tvm.runtime import Object
 
 from ..buffer import Buffer
-from ..stmt import For
+from ..stmt import Block, For
 from ..expr import PrimExpr
 from ..function import IndexMap, PrimFunc
 
@@ -124,6 +124,26 @@ def get_auto_tensorize_mapping_info(
     return _ffi_api.GetAutoTensorizeMappingInfo(sch, block, desc_func)  # type: ignore
 
 
+def get_auto_tensorize_signature(block: Block) -> Optional[int]:
+    """Get the signature of a block for auto tensorization, which hashes its arithmetic
+    operations, constants and buffer dtypes, but neither its loops nor its buffer indices. A
+    workload block is only compared with the tensor intrinsics of the same signature.
+
+    Parameters
+    ----------
+    block : Block
+        The compute block of a workload, or of the description of a tensor intrinsic
+
+    Returns
+    -------
+    signature : Optional[int]
+        The signature, or None if the block is not a single buffer store of data parallel and
+        reduction iters, in which case it is compared with every intrinsic.
+    """
+    signature = _ffi_api.GetAutoTensorizeSignature(block)  # type: ignore
+    return None if signature is None else signature.value
+
+
 def has_block(sch: Schedule, block_name: str) -> bool:
     """Query if the given block name exists in the module associated with the provided schedule.
 
@@ -709,6 +709,23 @@ def HoistExpression():
     return _ffi_api.HoistExpression()  # type: ignore
 
 
+def LoopInvariantCodeMotion():
+    """Hoist the loop-invariant integer arithmetic, such as the index and
+    address computations, out of the loops, innermost loops first.
+
+    Only pure expressions that cannot trap are hoisted, together with the
+    let bindings of such values. In GPU kernels, the number of the hoisted
+    values live at once along a loop nest is bounded by the
+    ``register_budget`` of the ``"tir.LoopInvariantCodeMotion"`` config.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LoopInvariantCodeMotion()  # type: ignore
+
+
 def LowerCrossThreadReduction():
     """Lower cross-thread reduction from thread bindings to
     intrinsic function calls.
@@ -893,6 +910,25 @@ def InjectSoftwarePipeline():
     return _ffi_api.InjectSoftwarePipeline()  # type: ignore
 
 
+def AutoSoftwarePipeline():
+    """Annotate the loops staging global memory into shared memory, or into VTCM on Hexagon, with
+    the stages of a software pipeline, and prefetch the data read by the next iteration of the
+    loops on CPU.
+
+    The copies are the first stage and the computation the last one. The pipeline is as deep as
+    the loop extent and the shared memory or VTCM allow, up to 3 stages with the asynchronous
+    copies of CUDA from sm_80 when "tir.use_async_copy" is set, and 2 otherwise. On Hexagon, the
+    asynchronous copies are DMA transfers into ping-pong VTCM buffers. The loops already annotated
+    are kept.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.AutoSoftwarePipeline()  # type: ignore
+
+
 def ExtractPrimFuncConstants():
     """Collects and unificates tir non-scalar constants to module's attr 'Constants' array.
 
@@ -997,6 +1033,22 @@ def ManifestSharedMemoryLocalStage():
     return _ffi_api.ManifestSharedMemoryLocalStage()  # type: ignore
 
 
+def PadSharedMemory():
+    """Pad the rows of the shared memory buffers accessed across the rows by the threads, to
+    avoid the bank conflicts.
+
+    The rows of a shared buffer, which the threads index by threadIdx or an intrinsic reads as a
+    tile of several rows, get the storage alignment of ``storage_align`` to be an odd number of
+    accesses apart modulo the 128 bytes of the banks. The buffers already aligned are kept.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.PadSharedMemory()  # type: ignore
+
+
 def InstrumentProfileIntrinsics():
     """Insert intrinsic calls to instrument function and loop level profiling.
 
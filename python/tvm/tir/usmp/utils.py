@@ -31,6 +31,12 @@ from ...ir.memory_pools import PoolInfo
 # include/tvm/tir/usmp/utils.h
 CANDIDATE_MEMORY_POOL_ATTR = "candidate_memory_pools"
 
+# The PrimFunc attribute to indicate that the operator can be computed in-place,
+# each element of its outputs depending only on the element of the same index of its inputs.
+# This needs to be kept in sync with kInplaceSafeFuncAttr in
+# include/tvm/tir/usmp/utils.h
+INPLACE_SAFE_FUNC_ATTR = "tir.usmp.inplace_safe"
+
 
 def use_workspace_io_is_enabled() -> bool:
     """
@@ -61,3 +61,6 @@ from .transform import *
 from .unique import *
 from .searchsorted import *
 from .stft import *
+from .attention import *
+from .fused_norm import *
+from .sparse_2in4 import *
@@ -0,0 +1,77 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments
+"""Fused scaled dot-product attention operator on GPU"""
+import tvm
+from tvm import tir
+from ..nn.attention import attention_extern
+
+# The bytes of shared memory for the tiles of the keys and the values of a block.
+SHARED_MEMORY_BYTES = 32 * 1024
+
+
+def attention(
+    query, key, value, bias=None, scale=None, causal_mask=None, dropout_rate=0.0, seed=0
+):
+    """Fused scaled dot-product attention on GPU, where the threads of a block run a block of
+    queries of a head, and share the tiles of the keys and the values in shared memory.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim]
+
+    key : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim]
+
+    value : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim_v]
+
+    bias : Optional[tvm.te.Tensor]
+        4-D, broadcast to [batch, num_heads, seq_len, seq_len_kv]
+
+    scale : Optional[float]
+        The scale of the scores, by default 1 / sqrt(head_dim).
+
+    causal_mask : Optional[str]
+        None, "TopLeft" or "BottomRight".
+
+    dropout_rate : float
+        Fraction of the probabilities that gets dropped out.
+
+    seed : int
+        The seed of the dropout mask.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim_v]
+    """
+    head_dim, head_dim_v = query.shape[3], value.shape[3]
+    if not isinstance(head_dim, tir.IntImm) or not isinstance(head_dim_v, tir.IntImm):
+        raise ValueError(
+            "The attention on GPU needs static head dimensions, but gets %s and %s"
+            % (head_dim, head_dim_v)
+        )
+    # The largest power of two of keys, up to 32, whose tiles fit in the shared memory.
+    row_bytes = (head_dim.value + head_dim_v.value) * tvm.DataType(query.dtype).bits // 8
+    keys_per_tile = 32
+    while keys_per_tile > 1 and keys_per_tile * row_bytes > SHARED_MEMORY_BYTES:
+        keys_per_tile //= 2
+    return attention_extern(
+        query, key, value, bias, scale, causal_mask, dropout_rate, seed, True, keys_per_tile
+    )
@@ -0,0 +1,110 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments
+"""Fused layer normalization and RMS normalization operators on GPU"""
+from tvm import tir
+from ..nn.fused_norm import fused_norm_extern
+from ..utils import prod
+
+# The most threads normalizing each row.
+MAX_THREADS_PER_ROW = 256
+
+
+def _num_threads(data, axis):
+    """The threads of each row: the smallest power of two, from a warp, covering the row."""
+    num_cols = prod([data.shape[a % len(data.shape)] for a in axis])
+    if not isinstance(num_cols, tir.IntImm):
+        return MAX_THREADS_PER_ROW
+    num_threads = 32
+    while num_threads < min(num_cols.value, MAX_THREADS_PER_ROW):
+        num_threads *= 2
+    return num_threads
+
+
+def fused_layer_norm(data, gamma, beta, residual=None, axis=(-1,), epsilon=1e-5, out_dtype=None):
+    """Layer normalization of the trailing axes of the data on GPU, with the optional residual
+    added to the data first. Each row is run by a block, whose threads combine their Welford
+    statistics in shared memory.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape (d_0, d_1, ..., d_{N-1})
+
+    gamma : tvm.te.Tensor
+        K-D with shape (d_{N-K}, ..., d_{N-1}) where K == len(axis)
+
+    beta : tvm.te.Tensor
+        K-D with shape (d_{N-K}, ..., d_{N-1}) where K == len(axis)
+
+    residual : Optional[tvm.te.Tensor]
+        N-D with the shape and the data type of the data
+
+    axis : list of int
+        The trailing axes over which the normalization is applied
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    out_dtype : Optional[str]
+        The data type of the normalized data, by default the data type of the data.
+
+    Returns
+    -------
+    result : Union[tvm.te.Tensor, List[tvm.te.Tensor]]
+        The normalized data, N-D with shape (d_0, d_1, ..., d_{N-1}), followed by
+        data + residual with a residual.
+    """
+    return fused_norm_extern(
+        data, [gamma, beta], residual, axis, epsilon, out_dtype, _num_threads(data, axis)
+    )
+
+
+def rms_norm(data, weight, residual=None, axis=(-1,), epsilon=1e-5, out_dtype=None):
+    """RMS normalization of the trailing axes of the data on GPU, with the optional residual
+    added to the data first. Each row is run by a block, whose threads sum their squares in
+    shared memory.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape (d_0, d_1, ..., d_{N-1})
+
+    weight : tvm.te.Tensor
+        K-D with shape (d_{N-K}, ..., d_{N-1}) where K == len(axis)
+
+    residual : Optional[tvm.te.Tensor]
+        N-D with the shape and the data type of the data
+
+    axis : list of int
+        The trailing axes over which the normalization is applied
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    out_dtype : Optional[str]
+        The data type of the normalized data, by default the data type of the data.
+
+    Returns
+    -------
+    result : Union[tvm.te.Tensor, List[tvm.te.Tensor]]
+        The normalized data, N-D with shape (d_0, d_1, ..., d_{N-1}), followed by
+        data + residual with a residual.
+    """
+    return fused_norm_extern(
+        data, [weight], residual, axis, epsilon, out_dtype, _num_threads(data, axis)
+    )
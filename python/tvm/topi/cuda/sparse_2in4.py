@@ -0,0 +1,166 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-locals
+"""2:4 structured sparse dense operator on the sparse tensor cores"""
+from tvm import te, tir
+from ..transform import reshape
+from ..nn.sparse_2in4 import SPARSE_TILE_SIZE
+from ..utils import ceil_div, prod
+
+# The warps of a block, each computing a tile of 16 outputs of 8 rows of the data.
+WARPS_PER_BLOCK = 4
+
+
+def has_sparse_tensor_core(target):
+    """Whether the target has the sparse tensor cores of mma.sp, since sm_80."""
+    if target is None or target.kind.name != "cuda" or "arch" not in target.attrs:
+        return False
+    arch = str(target.attrs["arch"])
+    return arch.startswith("sm_") and arch[3:].isdigit() and int(arch[3:]) >= 80
+
+
+def sparse_dense_2in4_ir(data, values, metadata, out):
+    """Low level IR of the sparse dense on the m16n8k16 mma.sp.
+
+    The mma.sp multiplies the sparse tile of 16 weights by 16 columns with the tile of 8 rows of
+    the data by the same 16 columns, so each warp computes the transposed tile of 16 outputs of
+    8 rows, visiting the columns 16 by 16. The fragments are loaded from the global memory in
+    the layout of the operands of the mma.sp, and the rows past the data are zeros.
+
+    Parameters
+    ----------
+    data : Buffer
+        The data, of shape (m, k) and dtype float16.
+
+    values, metadata : Buffer
+        The weights packed by sparse_pack_2in4, of shapes (n, k / 2) and (n / 16, k / 16, 8).
+
+    out : Buffer
+        The output, of shape (m, n).
+    """
+    ib = tir.ir_builder.create()
+    m, k = data.shape
+    n = values.shape[0]
+    data_ptr = ib.buffer_ptr(data)
+    values_ptr = ib.buffer_ptr(values)
+    metadata_ptr = ib.buffer_ptr(metadata)
+    out_ptr = ib.buffer_ptr(out)
+
+    bx = te.thread_axis("blockIdx.x")
+    by = te.thread_axis("blockIdx.y")
+    ty = te.thread_axis("threadIdx.y")
+    tx = te.thread_axis("threadIdx.x")
+    ib.scope_attr(bx, "thread_extent", tir.Cast("int32", ceil_div(m, 8)))
+    ib.scope_attr(
+        by, "thread_extent", tir.Cast("int32", ceil_div(n // SPARSE_TILE_SIZE, WARPS_PER_BLOCK))
+    )
+    ib.scope_attr(ty, "thread_extent", WARPS_PER_BLOCK)
+    ib.scope_attr(tx, "thread_extent", 32)
+    tile = by * WARPS_PER_BLOCK + ty
+    a_frag = ib.allocate("float16", (4,), name="a_frag", scope="local")
+    b_frag = ib.allocate("float16", (4,), name="b_frag", scope="local")
+    acc = ib.allocate("float32", (4,), name="acc", scope="local")
+    meta = ib.allocate("uint32", (1,), name="meta", scope="local")
+
+    # The warps past the weights are idle as a whole, as the mma.sp needs all the threads.
+    with ib.if_scope(tile < n // SPARSE_TILE_SIZE):
+        j0 = tile * SPARSE_TILE_SIZE
+        i0 = bx * 8
+        row = i0 + tx // 4
+        for e in range(4):
+            acc[e] = tir.const(0, "float32")
+        with ib.for_range(0, k // SPARSE_TILE_SIZE, name="t") as t:
+            for e in range(4):
+                a_frag[e] = values_ptr[j0 + tx // 4 + e // 2 * 8, t * 8 + tx % 4 * 2 + e % 2]
+                b_frag[e] = tir.Select(
+                    row < m,
+                    data_ptr[tir.min(row, m - 1), t * 16 + e // 2 * 8 + tx % 4 * 2 + e % 2],
+                    tir.const(0, "float16"),
+                )
+            meta[0] = metadata_ptr[tile, t, tx // 4]
+            ib.emit(
+                tir.ptx_mma_sp(
+                    "float32",
+                    "m16n8k16",
+                    "row",
+                    "col",
+                    "fp16",
+                    "fp16",
+                    "fp32",
+                    a_frag.asobject().data,
+                    0,
+                    b_frag.asobject().data,
+                    0,
+                    acc.asobject().data,
+                    0,
+                    meta.asobject().data,
+                    0,
+                    0,
+                    False,
+                )
+            )
+        for e in range(4):
+            col = i0 + tx % 4 * 2 + e % 2
+            with ib.if_scope(col < m):
+                out_ptr[col, j0 + e // 2 * 8 + tx // 4] = acc[e].astype(out.dtype)
+    return ib.get()
+
+
+def sparse_dense_2in4(data, values, metadata, out_dtype=None):
+    """Dense operator with the 2:4 sparse weights packed by sparse_pack_2in4, on the sparse
+    tensor cores of sm_80 and later, which skip the pruned weights.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape [..., k] and dtype float16
+
+    values : tvm.te.Tensor
+        2-D with shape [n, k / 2] and dtype float16, with n and k static
+
+    metadata : tvm.te.Tensor
+        3-D with shape [n / 16, k / 16, 8] and dtype uint32
+
+    out_dtype : Optional[str]
+        The data type of the output, by default the data type of the data.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        N-D with shape [..., n]
+    """
+    n, half_k = values.shape
+    if not isinstance(n, tir.IntImm) or not isinstance(half_k, tir.IntImm):
+        raise ValueError(
+            "The sparse dense on GPU needs static weights, but gets the shape %s" % values.shape
+        )
+    if data.dtype != "float16" or values.dtype != "float16":
+        raise ValueError(
+            "The sparse dense on GPU supports float16, but gets %s and %s"
+            % (data.dtype, values.dtype)
+        )
+    leading = list(data.shape[:-1])
+    data_2d = data if len(leading) == 1 else reshape(data, (prod(leading), data.shape[-1]))
+    out = te.extern(
+        [(data_2d.shape[0], n)],
+        [data_2d, values, metadata],
+        lambda ins, outs: sparse_dense_2in4_ir(ins[0], ins[1], ins[2], outs[0]),
+        dtype=out_dtype or data.dtype,
+        name="sparse_dense_2in4",
+        tag="sparse_dense_2in4_gpu",
+    )
+    return out if len(leading) == 1 else reshape(out, leading + [n])
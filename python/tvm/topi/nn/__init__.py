@@ -53,3 +53,7 @@ from .space_to_batch_nd import *
 from .batch_to_space_nd import *
 from .loss import *
 from .lstm import *
+from .attention import *
+from .fused_norm import *
+from .weight_quantize import *
+from .sparse_2in4 import *
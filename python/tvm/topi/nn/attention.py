@@ -0,0 +1,338 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments, too-many-locals, too-many-statements
+"""Fused scaled dot-product attention operator"""
+import tvm
+from tvm import te, tir
+from ..utils import ceil_div
+
+# The number of queries sharing each tile of the keys and the values, one per thread on GPU.
+QUERIES_PER_BLOCK = 64
+
+
+def _dropout_keep(seed, indices, dropout_rate):
+    """Whether the probability at the indices is kept by the dropout, by a hash of the indices."""
+
+    def mix(x):
+        # The finalizer of MurmurHash3.
+        x = x ^ (x >> tir.const(16, "uint32"))
+        x = x * tir.const(0x85EBCA6B, "uint32")
+        x = x ^ (x >> tir.const(13, "uint32"))
+        x = x * tir.const(0xC2B2AE35, "uint32")
+        return x ^ (x >> tir.const(16, "uint32"))
+
+    x = tir.const(seed & 0xFFFFFFFF, "uint32")
+    for index in indices:
+        x = mix(x ^ index.astype("uint32"))
+    threshold = min(int(dropout_rate * 2**32), 2**32 - 1)
+    return x >= tir.const(threshold, "uint32")
+
+
+def attention_ir(
+    query, key, value, bias, out, scale, causal_mask, dropout_rate, seed, use_gpu, keys_per_tile
+):
+    """Low level IR of the tiled attention.
+
+    The queries of each head are split into blocks of QUERIES_PER_BLOCK, which visit the keys and
+    the values tile by tile. Each query keeps the running max, sum and output of the online
+    softmax of its scores, rescaled whenever the max grows, so that only a tile of the scores
+    is live at a time instead of the (seq_len, seq_len_kv) scores. With a causal mask, the tiles
+    after the last key visible to the block are skipped. On GPU, each thread of a block runs a
+    query, and the tiles are loaded in shared memory by all the threads of the block.
+
+    Parameters
+    ----------
+    query, key, value : Buffer
+        The queries, keys and values, of layout (batch, seq_len, num_heads, head_dim).
+
+    bias : Optional[Buffer]
+        The bias, broadcast to (batch, num_heads, seq_len, seq_len_kv).
+
+    out : Buffer
+        The output, of shape (batch, seq_len, num_heads, head_dim_v).
+
+    scale : PrimExpr
+        The scale of the scores.
+
+    causal_mask : str
+        "", "TopLeft" or "BottomRight".
+
+    dropout_rate : float
+        Fraction of the probabilities that gets dropped out.
+
+    seed : int
+        The seed of the dropout mask.
+
+    use_gpu : bool
+        Whether to bind the blocks and the queries to the GPU blocks and threads.
+
+    keys_per_tile : int
+        The number of keys of each tile.
+    """
+    ib = tir.ir_builder.create()
+    batch, seq_len, num_heads, head_dim = query.shape
+    seq_len_kv, head_dim_v = key.shape[1], value.shape[3]
+    dtype = "float64" if out.dtype == "float64" else "float32"
+    min_value = tir.min_value(dtype)
+    zero = tir.const(0, dtype)
+    offset = seq_len_kv - seq_len if causal_mask == "BottomRight" else 0
+
+    query_ptr = ib.buffer_ptr(query)
+    key_ptr = ib.buffer_ptr(key)
+    value_ptr = ib.buffer_ptr(value)
+    bias_ptr = ib.buffer_ptr(bias) if bias is not None else None
+    out_ptr = ib.buffer_ptr(out)
+
+    def visible(i, j):
+        if causal_mask:
+            return tir.all(j < seq_len_kv, j <= i + offset)
+        return j < seq_len_kv
+
+    def bias_load(b, h, i, j):
+        indices = [
+            0 if isinstance(dim, tir.IntImm) and dim.value == 1 else index
+            for dim, index in zip(bias.shape, (b, h, i, j))
+        ]
+        return bias_ptr[indices].astype(dtype)
+
+    def emit_tile(b, h, i, j0, query_row, key_tile, value_tile, state, q):
+        """Update the softmax state q of the query i with the keys [j0, j0 + keys_per_tile)."""
+        row_max, row_sum, acc, scores, scratch = state
+        # The max of the scores of the tile, and the correction of the previous tiles.
+        scratch[0] = row_max[q]
+        with ib.for_range(0, keys_per_tile, name="r") as r:
+            j = j0 + r
+            scores[r] = zero
+            with ib.if_scope(visible(i, j)):
+                with ib.for_range(0, head_dim, name="d") as d:
+                    scores[r] += query_row(d) * key_tile(r, d).astype(dtype)
+                if bias_ptr is not None:
+                    scores[r] += bias_load(b, h, i, j)
+                scratch[0] = tir.max(scratch[0], scores[r])
+        scratch[1] = tir.exp(row_max[q] - scratch[0])
+        row_max[q] = scratch[0]
+        row_sum[q] = row_sum[q] * scratch[1]
+        with ib.for_range(0, head_dim_v, name="d") as d:
+            acc[q, d] = acc[q, d] * scratch[1]
+        with ib.for_range(0, keys_per_tile, name="r") as r:
+            j = j0 + r
+            with ib.if_scope(visible(i, j)):
+                scores[r] = tir.exp(scores[r] - scratch[0])
+                row_sum[q] += scores[r]
+                if dropout_rate > 0:
+                    # The dropped probabilities still count in the sum of the softmax.
+                    scores[r] = tir.Select(
+                        _dropout_keep(seed, (b, h, i, j), dropout_rate),
+                        scores[r] * tir.const(1 / (1 - dropout_rate), dtype),
+                        zero,
+                    )
+                with ib.for_range(0, head_dim_v, name="d") as d:
+                    acc[q, d] += scores[r] * value_tile(r, d).astype(dtype)
+
+    def keys_end(q_begin):
+        # The end of the keys visible to the block of queries starting at q_begin.
+        if not causal_mask:
+            return seq_len_kv
+        last = tir.min(seq_len, q_begin + QUERIES_PER_BLOCK) - 1
+        return tir.max(tir.min(seq_len_kv, last + offset + 1), 0)
+
+    num_blocks = batch * num_heads * ceil_div(seq_len, QUERIES_PER_BLOCK)
+
+    def block_indices(block):
+        bh = block // ceil_div(seq_len, QUERIES_PER_BLOCK)
+        q_begin = block % ceil_div(seq_len, QUERIES_PER_BLOCK) * QUERIES_PER_BLOCK
+        return bh // num_heads, bh % num_heads, q_begin
+
+    if use_gpu:
+        bx = te.thread_axis("blockIdx.x")
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(bx, "thread_extent", tir.Cast("int32", num_blocks))
+        ib.scope_attr(tx, "thread_extent", QUERIES_PER_BLOCK)
+        b, h, q_begin = block_indices(bx)
+        i = q_begin + tx
+        key_tile = ib.allocate(
+            key.dtype, (keys_per_tile, head_dim), name="key_tile", scope="shared"
+        )
+        value_tile = ib.allocate(
+            value.dtype, (keys_per_tile, head_dim_v), name="value_tile", scope="shared"
+        )
+        query_row = ib.allocate(dtype, (head_dim,), name="query_row", scope="local")
+        state = (
+            ib.allocate(dtype, (1,), name="row_max", scope="local"),
+            ib.allocate(dtype, (1,), name="row_sum", scope="local"),
+            ib.allocate(dtype, (1, head_dim_v), name="acc", scope="local"),
+            ib.allocate(dtype, (keys_per_tile,), name="scores", scope="local"),
+            ib.allocate(dtype, (2,), name="scratch", scope="local"),
+        )
+        with ib.for_range(0, head_dim, name="d") as d:
+            query_row[d] = tir.Select(
+                i < seq_len, query_ptr[b, tir.min(i, seq_len - 1), h, d].astype(dtype) * scale, zero
+            )
+        state[0][0] = min_value
+        state[1][0] = zero
+        with ib.for_range(0, head_dim_v, name="d") as d:
+            state[2][0, d] = zero
+
+        def load_tile(tile, tensor, j0, dim):
+            with ib.for_range(0, ceil_div(keys_per_tile * dim, QUERIES_PER_BLOCK), name="e") as e:
+                index = e * QUERIES_PER_BLOCK + tx
+                r = index // dim
+                with ib.if_scope(tir.all(index < keys_per_tile * dim, j0 + r < seq_len_kv)):
+                    tile[r, index % dim] = tensor[b, j0 + r, h, index % dim]
+
+        def sync():
+            ib.emit(tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+        with ib.for_range(0, ceil_div(keys_end(q_begin), keys_per_tile), name="t") as t:
+            j0 = t * keys_per_tile
+            load_tile(key_tile, key_ptr, j0, head_dim)
+            load_tile(value_tile, value_ptr, j0, head_dim_v)
+            sync()
+            with ib.if_scope(i < seq_len):
+                emit_tile(
+                    b,
+                    h,
+                    i,
+                    j0,
+                    lambda d: query_row[d],
+                    lambda r, d: key_tile[r, d],
+                    lambda r, d: value_tile[r, d],
+                    state,
+                    0,
+                )
+            sync()
+        with ib.if_scope(i < seq_len):
+            with ib.for_range(0, head_dim_v, name="d") as d:
+                out_ptr[b, i, h, d] = tir.Select(
+                    state[1][0] > zero, state[2][0, d] / state[1][0], zero
+                ).astype(out.dtype)
+        return ib.get()
+
+    with ib.for_range(0, num_blocks, name="block", kind="parallel") as block:
+        b, h, q_begin = block_indices(block)
+        num_queries = tir.min(QUERIES_PER_BLOCK, seq_len - q_begin)
+        query_rows = ib.allocate(dtype, (QUERIES_PER_BLOCK, head_dim), name="query_rows")
+        state = (
+            ib.allocate(dtype, (QUERIES_PER_BLOCK,), name="row_max"),
+            ib.allocate(dtype, (QUERIES_PER_BLOCK,), name="row_sum"),
+            ib.allocate(dtype, (QUERIES_PER_BLOCK, head_dim_v), name="acc"),
+            ib.allocate(dtype, (keys_per_tile,), name="scores"),
+            ib.allocate(dtype, (2,), name="scratch"),
+        )
+        with ib.for_range(0, num_queries, name="q") as q:
+            with ib.for_range(0, head_dim, name="d") as d:
+                query_rows[q, d] = query_ptr[b, q_begin + q, h, d].astype(dtype) * scale
+            state[0][q] = min_value
+            state[1][q] = zero
+            with ib.for_range(0, head_dim_v, name="d") as d:
+                state[2][q, d] = zero
+        # The queries of the block visit each tile in turn, while it is in cache.
+        with ib.for_range(0, ceil_div(keys_end(q_begin), keys_per_tile), name="t") as t:
+            j0 = t * keys_per_tile
+            with ib.for_range(0, num_queries, name="q") as q:
+                emit_tile(
+                    b,
+                    h,
+                    q_begin + q,
+                    j0,
+                    lambda d: query_rows[q, d],
+                    lambda r, d: key_ptr[b, j0 + r, h, d],
+                    lambda r, d: value_ptr[b, j0 + r, h, d],
+                    state,
+                    q,
+                )
+        with ib.for_range(0, num_queries, name="q") as q:
+            with ib.for_range(0, head_dim_v, name="d") as d:
+                out_ptr[b, q_begin + q, h, d] = tir.Select(
+                    state[1][q] > zero, state[2][q, d] / state[1][q], zero
+                ).astype(out.dtype)
+    return ib.get()
+
+
+def attention_extern(
+    query, key, value, bias, scale, causal_mask, dropout_rate, seed, use_gpu, keys_per_tile
+):
+    """The extern op of attention_ir, with the default scale."""
+    batch, seq_len, num_heads, head_dim = query.shape
+    dtype = "float64" if query.dtype == "float64" else "float32"
+    if scale is None:
+        scale = 1 / tir.sqrt(tir.Cast(dtype, head_dim))
+    else:
+        scale = tir.const(scale, dtype)
+    inputs = [query, key, value] + ([bias] if bias is not None else [])
+    return te.extern(
+        [(batch, seq_len, num_heads, value.shape[3])],
+        inputs,
+        lambda ins, outs: attention_ir(
+            ins[0],
+            ins[1],
+            ins[2],
+            ins[3] if bias is not None else None,
+            outs[0],
+            scale,
+            causal_mask or "",
+            dropout_rate,
+            seed,
+            use_gpu,
+            keys_per_tile,
+        ),
+        dtype=query.dtype,
+        name="attention",
+        tag="attention_gpu" if use_gpu else "attention_cpu",
+    )
+
+
+def attention(
+    query, key, value, bias=None, scale=None, causal_mask=None, dropout_rate=0.0, seed=0
+):
+    """Fused scaled dot-product attention, dropout(softmax(scale * Q K^T + bias)) V per head,
+    without materializing the scores. The blocks of queries run in parallel.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim]
+
+    key : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim]
+
+    value : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim_v]
+
+    bias : Optional[tvm.te.Tensor]
+        4-D, broadcast to [batch, num_heads, seq_len, seq_len_kv]
+
+    scale : Optional[float]
+        The scale of the scores, by default 1 / sqrt(head_dim).
+
+    causal_mask : Optional[str]
+        None, "TopLeft" or "BottomRight".
+
+    dropout_rate : float
+        Fraction of the probabilities that gets dropped out.
+
+    seed : int
+        The seed of the dropout mask.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim_v]
+    """
+    return attention_extern(
+        query, key, value, bias, scale, causal_mask, dropout_rate, seed, False, 64
+    )
@@ -0,0 +1,275 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments, too-many-locals, too-many-statements
+"""Fused layer normalization and RMS normalization operators"""
+import tvm
+from tvm import te, tir
+from ..utils import prod
+
+
+def _welford_update(stats, x):
+    """Add the value x to the (count, mean, m2) statistics, in place."""
+    count, mean, m2 = stats
+    count[0] = count[0] + tir.const(1, count.dtype)
+    # The loads of the buffers are not values: m2 is updated before the mean it reads.
+    delta = x - mean[0]
+    m2[0] = m2[0] + delta * (x - (mean[0] + delta / count[0]))
+    mean[0] = mean[0] + delta / count[0]
+
+
+def _welford_combine(a, b):
+    """The (count, mean, m2) statistics of the union of two disjoint sets of values."""
+    count = a[0] + b[0]
+    delta = b[1] - a[1]
+    # The ratio of the second set, 0 when both sets are empty.
+    one, zero = tir.const(1, count.dtype), tir.const(0, count.dtype)
+    ratio = tir.Select(count > zero, b[0] / tir.max(count, one), zero)
+    return count, a[1] + delta * ratio, a[2] + b[2] + delta * delta * a[0] * ratio
+
+
+def fused_norm_ir(data, params, residual, out, residual_out, is_layer_norm, epsilon, num_threads):
+    """Low level IR of the fused normalization, of the rows of the trailing axes of the data.
+
+    Each row is read once to compute its statistics, in one pass with the Welford algorithm for
+    the layer norm, and read again to write the normalized row while it is in cache. With a
+    residual, the first pass adds it to the data and writes the sum, which the second pass reads
+    back. On GPU each row is run by a block of num_threads threads, whose statistics are combined
+    by a tree reduction in shared memory.
+
+    Parameters
+    ----------
+    data : Buffer
+        The data, whose trailing axes are normalized.
+
+    params : List[Buffer]
+        [gamma, beta] for the layer norm, [weight] for the RMS norm, of the normalized shape.
+
+    residual : Optional[Buffer]
+        The residual added to the data.
+
+    out : Buffer
+        The normalized data.
+
+    residual_out : Optional[Buffer]
+        The sum of the data and the residual.
+
+    is_layer_norm : bool
+        Whether to compute the layer norm, or else the RMS norm.
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    num_threads : Optional[int]
+        The number of threads of each row on GPU, a power of two, or None on CPU.
+    """
+    ib = tir.ir_builder.create()
+    num_stats = 3 if is_layer_norm else 1
+    ndim, n_axis = len(data.shape), len(params[0].shape)
+    num_rows = prod(data.shape[: ndim - n_axis])
+    num_cols = prod(data.shape[ndim - n_axis :])
+    dtype = "float64" if data.dtype == "float64" else "float32"
+    zero = tir.const(0, dtype)
+
+    data_ptr = ib.buffer_ptr(data)
+    param_ptrs = [ib.buffer_ptr(param) for param in params]
+    residual_ptr = ib.buffer_ptr(residual) if residual is not None else None
+    out_ptr = ib.buffer_ptr(out)
+    residual_out_ptr = ib.buffer_ptr(residual_out) if residual is not None else None
+
+    def load(index):
+        """The value at the flat index, after the first pass has added the residual."""
+        if residual is None:
+            return data_ptr[index].astype(dtype)
+        return residual_out_ptr[index].astype(dtype)
+
+    def first_pass(row, begin, step, stats):
+        with ib.for_range(0, tir.indexdiv(num_cols - begin + step - 1, step), name="c") as c:
+            index = row * num_cols + begin + c * step
+            if residual is not None:
+                residual_out_ptr[index] = data_ptr[index] + residual_ptr[index]
+            if is_layer_norm:
+                _welford_update(stats, load(index))
+            else:
+                stats[0][0] = stats[0][0] + load(index) * load(index)
+
+    def second_pass(row, begin, step, mean, inv_std):
+        with ib.for_range(0, tir.indexdiv(num_cols - begin + step - 1, step), name="c") as c:
+            col = begin + c * step
+            index = row * num_cols + col
+            value = (load(index) - mean) * inv_std * param_ptrs[0][col].astype(dtype)
+            if is_layer_norm:
+                value = value + param_ptrs[1][col].astype(dtype)
+            out_ptr[index] = value.astype(out.dtype)
+
+    def finalize(stats):
+        """The mean and the inverse standard deviation of the row, from its statistics."""
+        eps = tir.const(epsilon, dtype)
+        if is_layer_norm:
+            return stats[1], tir.rsqrt(stats[2] / tir.Cast(dtype, num_cols) + eps)
+        return zero, tir.rsqrt(stats[0] / tir.Cast(dtype, num_cols) + eps)
+
+    if num_threads is not None:
+        bx = te.thread_axis("blockIdx.x")
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(bx, "thread_extent", tir.Cast("int32", num_rows))
+        ib.scope_attr(tx, "thread_extent", num_threads)
+        stats = [
+            ib.allocate(dtype, (1,), name="stats%d" % i, scope="local") for i in range(num_stats)
+        ]
+        for stat in stats:
+            stat[0] = zero
+        first_pass(bx, tx, num_threads, stats)
+        shared = [
+            ib.allocate(dtype, (num_threads,), name="shared%d" % i, scope="shared")
+            for i in range(num_stats)
+        ]
+
+        def sync():
+            ib.emit(tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+        for i in range(num_stats):
+            shared[i][tx] = stats[i][0]
+        sync()
+        stride = num_threads // 2
+        while stride > 0:
+            with ib.if_scope(tx < stride):
+                a = [shared[i][tx] for i in range(num_stats)]
+                b = [shared[i][tx + stride] for i in range(num_stats)]
+                combined = _welford_combine(a, b) if is_layer_norm else [a[0] + b[0]]
+                for i in range(num_stats):
+                    stats[i][0] = combined[i]
+                for i in range(num_stats):
+                    shared[i][tx] = stats[i][0]
+            sync()
+            stride //= 2
+        for i in range(num_stats):
+            stats[i][0] = shared[i][0]
+        mean, inv_std = finalize([stat[0] for stat in stats])
+        second_pass(bx, tx, num_threads, mean, inv_std)
+        return ib.get()
+
+    with ib.for_range(0, num_rows, name="row", kind="parallel") as row:
+        stats = [ib.allocate(dtype, (1,), name="stats%d" % i) for i in range(num_stats)]
+        for stat in stats:
+            stat[0] = zero
+        first_pass(row, 0, 1, stats)
+        mean, inv_std = finalize([stat[0] for stat in stats])
+        second_pass(row, 0, 1, mean, inv_std)
+    return ib.get()
+
+
+def fused_norm_extern(data, params, residual, axis, epsilon, out_dtype, num_threads):
+    """The extern op of fused_norm_ir, returning the normalized data, followed by the sum of the
+    data and the residual with a residual."""
+    is_layer_norm = len(params) == 2
+    ndim = len(data.shape)
+    if sorted(a % ndim for a in axis) != list(range(ndim - len(axis), ndim)):
+        raise ValueError(
+            "The fused normalization expects the normalized axes to be the trailing axes of the "
+            "data, but gets %s for a data of rank %d" % (list(axis), ndim)
+        )
+    inputs = [data] + list(params) + ([residual] if residual is not None else [])
+    out_shapes = [data.shape] + ([data.shape] if residual is not None else [])
+    out_dtypes = [out_dtype or data.dtype] + ([data.dtype] if residual is not None else [])
+    outs = te.extern(
+        out_shapes,
+        inputs,
+        lambda ins, outs: fused_norm_ir(
+            ins[0],
+            ins[1 : 1 + len(params)],
+            ins[-1] if residual is not None else None,
+            outs[0],
+            outs[1] if residual is not None else None,
+            is_layer_norm,
+            epsilon,
+            num_threads,
+        ),
+        dtype=out_dtypes,
+        name="layer_norm" if is_layer_norm else "rms_norm",
+        tag="fused_norm_gpu" if num_threads is not None else "fused_norm_cpu",
+    )
+    return outs if residual is not None else outs[0]
+
+
+def fused_layer_norm(data, gamma, beta, residual=None, axis=(-1,), epsilon=1e-5, out_dtype=None):
+    """Layer normalization of the trailing axes of the data, with the optional residual added
+    to the data first, in a single pass for the statistics of each row. The rows run in
+    parallel.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape (d_0, d_1, ..., d_{N-1})
+
+    gamma : tvm.te.Tensor
+        K-D with shape (d_{N-K}, ..., d_{N-1}) where K == len(axis)
+
+    beta : tvm.te.Tensor
+        K-D with shape (d_{N-K}, ..., d_{N-1}) where K == len(axis)
+
+    residual : Optional[tvm.te.Tensor]
+        N-D with the shape and the data type of the data
+
+    axis : list of int
+        The trailing axes over which the normalization is applied
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    out_dtype : Optional[str]
+        The data type of the normalized data, by default the data type of the data.
+
+    Returns
+    -------
+    result : Union[tvm.te.Tensor, List[tvm.te.Tensor]]
+        The normalized data, N-D with shape (d_0, d_1, ..., d_{N-1}), followed by
+        data + residual with a residual.
+    """
+    return fused_norm_extern(data, [gamma, beta], residual, axis, epsilon, out_dtype, None)
+
+
+def rms_norm(data, weight, residual=None, axis=(-1,), epsilon=1e-5, out_dtype=None):
+    """RMS normalization of the trailing axes of the data, with the optional residual added
+    to the data first. The rows run in parallel.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape (d_0, d_1, ..., d_{N-1})
+
+    weight : tvm.te.Tensor
+        K-D with shape (d_{N-K}, ..., d_{N-1}) where K == len(axis)
+
+    residual : Optional[tvm.te.Tensor]
+        N-D with the shape and the data type of the data
+
+    axis : list of int
+        The trailing axes over which the normalization is applied
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    out_dtype : Optional[str]
+        The data type of the normalized data, by default the data type of the data.
+
+    Returns
+    -------
+    result : Union[tvm.te.Tensor, List[tvm.te.Tensor]]
+        The normalized data, N-D with shape (d_0, d_1, ..., d_{N-1}), followed by
+        data + residual with a residual.
+    """
+    return fused_norm_extern(data, [weight], residual, axis, epsilon, out_dtype, None)
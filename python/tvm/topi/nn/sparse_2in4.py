@@ -0,0 +1,133 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""2:4 structured sparsity operators"""
+from tvm import te, tir
+
+# The rows and the columns of the tiles of the metadata, those of the m16n8k16 mma.sp.
+SPARSE_TILE_SIZE = 16
+
+
+def sparse_pack_2in4(weight):
+    """Pruning of weights to the 2 of largest magnitude of each group of 4 consecutive weights of
+    a row, the lowest index first on ties, packed for the sparse tensor cores. The weights which
+    are already 2:4 sparse are packed exactly.
+
+    Parameters
+    ----------
+    weight : tvm.te.Tensor
+        2-D with shape [n, k], with n and k divisible by 16
+
+    Returns
+    -------
+    values : tvm.te.Tensor
+        2-D with shape [n, k / 2], the kept weights of each group in their order
+
+    metadata : tvm.te.Tensor
+        3-D with shape [n / 16, k / 16, 8] and dtype uint32, the word of the rows i and i + 8 of
+        each 16x16 tile, whose low and high 16 bits are the 2-bit indices of the kept weights in
+        their groups, from the low bits, as the metadata operand of the m16n8k16 mma.sp
+    """
+    n, k = weight.shape
+
+    def index(i, j):
+        base = j // 2 * 4
+        magnitudes = [te.abs(weight[i, base + q]) for q in range(4)]
+
+        def kept(p):
+            # The weight is among the 2 largest when at most one other beats it.
+            beaten = [
+                tir.Select(
+                    magnitudes[q] >= magnitudes[p] if q < p else magnitudes[q] > magnitudes[p],
+                    tir.const(1, "int32"),
+                    tir.const(0, "int32"),
+                )
+                for q in range(4)
+                if q != p
+            ]
+            return beaten[0] + beaten[1] + beaten[2] < 2
+
+        first = tir.Select(kept(0), 0, tir.Select(kept(1), 1, 2))
+        last = tir.Select(kept(3), 3, tir.Select(kept(2), 2, 1))
+        return tir.Select(j % 2 == 0, first, last)
+
+    indices = te.compute((n, k // 2), index, name="indices")
+    values = te.compute(
+        (n, k // 2),
+        lambda i, j: weight[i, j // 2 * 4 + indices[i, j].astype(j.dtype)],
+        name="values",
+    )
+
+    def pack(t, u, r):
+        word = tir.const(0, "uint32")
+        for half in range(2):
+            for p in range(8):
+                row = t * SPARSE_TILE_SIZE + half * 8 + r
+                bits = indices[row, u * 8 + p].astype("uint32")
+                word = word | (bits << tir.const(half * 16 + p * 2, "uint32"))
+        return word
+
+    metadata = te.compute(
+        (n // SPARSE_TILE_SIZE, k // SPARSE_TILE_SIZE, 8), pack, name="metadata"
+    )
+    return [values, metadata]
+
+
+def sparse_2in4_index(metadata, i, j):
+    """The index in its group of the kept weight j of the row i, read from the metadata."""
+    word = metadata[i // SPARSE_TILE_SIZE, j // 8, i % 8]
+    shift = (i % SPARSE_TILE_SIZE // 8 * 16 + j % 8 * 2).astype("uint32")
+    return (word >> shift) & tir.const(3, "uint32")
+
+
+def sparse_dense_2in4(data, values, metadata, out_dtype=None):
+    """Dense operator with the 2:4 sparse weights packed by sparse_pack_2in4, whose reduction
+    only visits the kept weights.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape [..., k]
+
+    values : tvm.te.Tensor
+        2-D with shape [n, k / 2]
+
+    metadata : tvm.te.Tensor
+        3-D with shape [n / 16, k / 16, 8] and dtype uint32
+
+    out_dtype : Optional[str]
+        The data type of the output, by default the data type of the data.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        N-D with shape [..., n]
+    """
+    out_dtype = out_dtype or data.dtype
+    r = te.reduce_axis((0, values.shape[1]), name="k")
+
+    def compute(*indices):
+        row, col = indices[:-1], indices[-1]
+        k = r // 2 * 4 + sparse_2in4_index(metadata, col, r).astype(r.var.dtype)
+        return te.sum(data[row + (k,)].astype(out_dtype) * values[col, r].astype(out_dtype), axis=r)
+
+    return te.compute(
+        list(data.shape[:-1]) + [values.shape[0]],
+        compute,
+        name="sparse_dense_2in4",
+        tag="sparse_dense_2in4",
+    )
@@ -0,0 +1,172 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments
+"""Weight-only quantization operators"""
+from tvm import te, tir
+
+
+def _packing(bits):
+    """The weights per packed byte, the mask of a weight and the offset of the integers."""
+    if bits not in (4, 8):
+        raise ValueError("The weight-only quantization supports 4 or 8 bits, but gets %d" % bits)
+    return 8 // bits, (1 << bits) - 1, 1 << (bits - 1)
+
+
+def quantize_weight(weight, bits=8, group_size=128):
+    """Symmetric group-wise quantization of weights.
+
+    Parameters
+    ----------
+    weight : tvm.te.Tensor
+        2-D with shape [n, k], with k divisible by group_size
+
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+
+    Returns
+    -------
+    packed : tvm.te.Tensor
+        2-D with shape [n, k * bits / 8] and dtype uint8, the integers of 8 / bits weights per
+        byte from the low bits, with an offset of 2^(bits - 1)
+
+    scale : tvm.te.Tensor
+        2-D with shape [n, k / group_size], the scale max(|w|) / (2^(bits - 1) - 1) of each group
+    """
+    weights_per_byte, _, offset = _packing(bits)
+    n, k = weight.shape
+    dtype = "float64" if weight.dtype == "float64" else "float32"
+    r = te.reduce_axis((0, group_size), name="r")
+    absmax = te.compute(
+        (n, k // group_size),
+        lambda i, g: te.max(te.abs(weight[i, g * group_size + r].astype(dtype)), axis=r),
+        name="absmax",
+    )
+    scale = te.compute(
+        (n, k // group_size),
+        lambda i, g: (absmax[i, g] / tir.const(offset - 1, dtype)).astype(weight.dtype),
+        name="scale",
+    )
+
+    def quantize(i, j):
+        group_scale = scale[i, j // group_size].astype(dtype)
+        value = tir.Select(
+            group_scale > tir.const(0, dtype),
+            te.round(weight[i, j].astype(dtype) / group_scale),
+            tir.const(0, dtype),
+        )
+        value = te.max(te.min(value, tir.const(offset - 1, dtype)), tir.const(-offset, dtype))
+        return (value.astype("int32") + offset).astype("uint8")
+
+    def pack(i, p):
+        byte = quantize(i, p * weights_per_byte)
+        for w in range(1, weights_per_byte):
+            byte = byte | (quantize(i, p * weights_per_byte + w) << tir.const(w * bits, "uint8"))
+        return byte
+
+    packed = te.compute((n, k // weights_per_byte), pack, name="packed")
+    return [packed, scale]
+
+
+def _dequantize(packed, scale, bits, group_size, i, j, dtype):
+    """The weight (i, j) of the packed weights, dequantized in dtype."""
+    weights_per_byte, mask, offset = _packing(bits)
+    byte = packed[i, j // weights_per_byte]
+    if weights_per_byte > 1:
+        shift = (j % weights_per_byte * bits).astype("uint8")
+        byte = (byte >> shift) & tir.const(mask, "uint8")
+    value = byte.astype("int32") - offset
+    return value.astype(dtype) * scale[i, j // group_size].astype(dtype)
+
+
+def dequantize_weight(packed, scale, bits=8, group_size=128):
+    """Dequantization of the weights quantized by quantize_weight.
+
+    Parameters
+    ----------
+    packed : tvm.te.Tensor
+        2-D with shape [n, k * bits / 8] and dtype uint8
+
+    scale : tvm.te.Tensor
+        2-D with shape [n, k / group_size]
+
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+
+    Returns
+    -------
+    weight : tvm.te.Tensor
+        2-D with shape [n, k] and the dtype of the scales
+    """
+    weights_per_byte, _, _ = _packing(bits)
+    n, packed_k = packed.shape
+    return te.compute(
+        (n, packed_k * weights_per_byte),
+        lambda i, j: _dequantize(packed, scale, bits, group_size, i, j, scale.dtype),
+        name="dequantize",
+    )
+
+
+def quantized_dense(data, packed, scale, bits=8, group_size=128, out_dtype=None):
+    """Dense operator with the weights quantized by quantize_weight, which are dequantized in
+    the reduction, so that only the packed weights are read.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape [..., k]
+
+    packed : tvm.te.Tensor
+        2-D with shape [n, k * bits / 8] and dtype uint8
+
+    scale : tvm.te.Tensor
+        2-D with shape [n, k / group_size]
+
+    bits : int
+        The bits of the quantized weights, 8 or 4.
+
+    group_size : int
+        The number of consecutive weights of a row sharing a scale.
+
+    out_dtype : Optional[str]
+        The data type of the output, by default the data type of the data.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        N-D with shape [..., n]
+    """
+    out_dtype = out_dtype or data.dtype
+    k = data.shape[-1]
+    r = te.reduce_axis((0, k), name="k")
+
+    def compute(*indices):
+        row, col = indices[:-1], indices[-1]
+        weight = _dequantize(packed, scale, bits, group_size, col, r, out_dtype)
+        return te.sum(data[row + (r,)].astype(out_dtype) * weight, axis=r)
+
+    return te.compute(
+        list(data.shape[:-1]) + [packed.shape[0]],
+        compute,
+        name="quantized_dense",
+        tag="quantized_dense",
+    )
@@ -385,6 +385,43 @@ impl NDArray {
         NDArray(ptr)
     }
 
+    /// Creates an NDArray sharing the memory of a DLPack tensor, without a copy.
+    ///
+    /// # Safety
+    ///
+    /// `dltensor` must point to a valid `DLManagedTensor`, whose ownership is transferred to the
+    /// NDArray: its deleter is called when the last reference to the NDArray is dropped.
+    pub unsafe fn from_dlpack(dltensor: *mut ffi::DLManagedTensor) -> NDArray {
+        let mut handle = ptr::null_mut() as ffi::TVMArrayHandle;
+        check_call!(ffi::TVMArrayFromDLPack(dltensor, &mut handle as *mut _));
+        let ptr = NDArrayContainer::from_raw(handle)
+            .map(|o| o.downcast().expect("this should never fail"));
+        NDArray(ptr)
+    }
+
+    /// Exports the NDArray as a DLPack tensor sharing its memory, without a copy.
+    ///
+    /// The `DLManagedTensor` holds its own reference to the NDArray, which its deleter releases.
+    /// Its ownership is transferred to the consumer, or it must be released with
+    /// [`NDArray::delete_dlpack`].
+    pub fn to_dlpack(&self) -> *mut ffi::DLManagedTensor {
+        let mut dltensor = ptr::null_mut() as *mut ffi::DLManagedTensor;
+        check_call!(ffi::TVMArrayToDLPack(
+            self.as_raw_dltensor(),
+            &mut dltensor as *mut _
+        ));
+        dltensor
+    }
+
+    /// Calls the deleter of a DLPack tensor no consumer has taken.
+    ///
+    /// # Safety
+    ///
+    /// `dltensor` must point to a valid `DLManagedTensor`, which must not be used afterwards.
+    pub unsafe fn delete_dlpack(dltensor: *mut ffi::DLManagedTensor) {
+        ffi::TVMDLManagedTensorCallDeleter(dltensor);
+    }
+
     pub fn zeroed(self) -> NDArray {
         unsafe {
             let dltensor = self.as_raw_dltensor();
@@ -500,6 +537,20 @@ mod tests {
         nd_float.copy_to_ndarray(empty_int).unwrap();
     }
 
+    #[test]
+    fn dlpack() {
+        let data = vec![1i32, 2, 3, 4];
+        let mut ndarray = NDArray::empty(&[2, 2], Device::cpu(0), DataType::int(32, 1));
+        let shared = unsafe { NDArray::from_dlpack(ndarray.to_dlpack()) };
+        assert_eq!(shared.shape(), &[2, 2]);
+        assert_eq!(shared.dtype(), DataType::int(32, 1));
+        ndarray.copy_from_buffer(&data);
+        // The memory is shared, and outlives the exported array
+        drop(ndarray);
+        assert_eq!(shared.to_vec::<i32>().unwrap(), data);
+        unsafe { NDArray::delete_dlpack(shared.to_dlpack()) };
+    }
+
     #[test]
     fn rust_ndarray() {
         let a = Array::from_shape_vec((2, 2), vec![1f32, 2., 3., 4.])
@@ -28,6 +28,9 @@
 namespace tvm {
 namespace arith {
 
+/*! \brief The max number of the memoized Simplify results, beyond which the memo is cleared. */
+constexpr size_t kMaxSimplifyMemoSize = 1 << 16;
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
@@ -46,6 +49,7 @@ void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   this->canonical_simplify.Update(var, new_expr, allow_override);
   this->int_set.Update(var, this->int_set(new_expr), allow_override);
   this->transitive_comparisons.Bind(var, expr, allow_override);
+  this->NewEpoch();
 }
 
 void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
@@ -56,6 +60,7 @@ void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
     this->const_int_bound.Bind(var, range, allow_override);
     this->int_set.Bind(var, range, allow_override);
     this->transitive_comparisons.Bind(var, range, allow_override);
+    this->NewEpoch();
   }
   // skip modular_set
   // skip rewrite simplify
@@ -69,12 +74,15 @@ void Analyzer::Bind(const Map<Var, Range>& variables, bool allow_override) {
 
 void ConstraintContext::EnterWithScope() {
   ICHECK(recovery_functions_.size() == 0);
+  outer_epoch_ = analyzer_->epoch_;
   // entering the scope.
   recovery_functions_.push_back(analyzer_->const_int_bound.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->modular_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->rewrite_simplify.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->int_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->transitive_comparisons.EnterConstraint(constraint_));
+  analyzer_->NewEpoch();
+  inner_epoch_ = analyzer_->epoch_;
 }
 
 void ConstraintContext::ExitWithScope() {
@@ -85,6 +93,12 @@ void ConstraintContext::ExitWithScope() {
     }
     recovery_functions_.pop_back();
   }
+  // The analyzer is back to its state out of the scope, unless it was updated in the scope.
+  if (analyzer_->epoch_ == inner_epoch_) {
+    analyzer_->epoch_ = outer_epoch_;
+  } else {
+    analyzer_->NewEpoch();
+  }
 }
 
 bool Analyzer::CanProveGreaterEqual(const PrimExpr& expr, int64_t lower_bound) {
@@ -127,11 +141,21 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
+  if (tir::is_const_int(expr)) {
+    return expr;
+  }
+  SimplifyMemoKey key{expr.get(), epoch_, steps};
+  auto it = simplify_memo_.find(key);
+  if (it != simplify_memo_.end()) {
+    ++simplify_memo_hits;
+    return it->second.second;
+  }
+  ++simplify_memo_misses;
   PrimExpr res = expr;
 
   for (int i = 0; i < steps; ++i) {
     if (tir::is_const_int(res)) {
-      return res;
+      break;
     }
     if (i % 2 == 0) {
       res = this->rewrite_simplify(res);
@@ -140,6 +164,14 @@ PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
     }
   }
 
+  // The simplification may bind the variables of let expressions, in which case the result is
+  // not memoized for the epoch it started in.
+  if (epoch_ == key.epoch) {
+    if (simplify_memo_.size() >= kMaxSimplifyMemoSize) {
+      simplify_memo_.clear();
+    }
+    simplify_memo_[key] = {expr, res};
+  }
   return res;
 }
 
@@ -197,6 +229,11 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "can_prove_equal") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { *ret = self->CanProveEqual(args[0], args[1]); });
+    } else if (name == "simplify_memo_stats") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
+        *ret = Map<String, Integer>{{"hits", Integer(self->simplify_memo_hits)},
+                                    {"misses", Integer(self->simplify_memo_misses)}};
+      });
     }
     return PackedFunc();
   };
@@ -97,6 +97,8 @@ class ConstIntBoundAnalyzer::Impl
     BoundInfo(PrimExpr expr, Entry bound) : expr(expr), bound(bound) {}
   };
 
+  explicit Impl(Analyzer* parent) : parent_(parent) {}
+
   void Bind(const Var& var, const Range& range, bool allow_override) {
     Entry a = VisitExpr(range->min);
     Entry b = VisitExpr(range->extent);
@@ -118,6 +120,7 @@ class ConstIntBoundAnalyzer::Impl
       }
     }
     var_map_[var] = info;
+    parent_->NewEpoch();
   }
 
   Entry VisitExpr_(const LetNode* op) final {
@@ -406,6 +409,8 @@ class ConstIntBoundAnalyzer::Impl
 
  private:
   friend class ConstIntBoundAnalyzer;
+  // the parent analyzer
+  Analyzer* parent_;
   // internal variable map
   std::unordered_map<Var, Entry, ObjectPtrHash, ObjectPtrEqual> var_map_;
   // additional bound info
@@ -733,7 +738,7 @@ std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const PrimExpr& con
   return impl_->EnterConstraint(constraint);
 }
 
-ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent) : impl_(new Impl()) {}
+ConstIntBoundAnalyzer::ConstIntBoundAnalyzer(Analyzer* parent) : impl_(new Impl(parent)) {}
 
 ConstIntBoundAnalyzer::~ConstIntBoundAnalyzer() { delete impl_; }
 
@@ -623,6 +623,7 @@ void IntSetAnalyzer::Impl::Update(const Var& var, const IntSet& info, bool can_o
     }
   }
   dom_map_.Set(var, info);
+  analyzer_->NewEpoch();
 }
 
 void IntSetAnalyzer::Impl::Bind(const Var& var, const PrimExpr& expr, bool can_override) {
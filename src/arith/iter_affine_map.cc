@@ -502,6 +502,9 @@ class IterMapRewriter : public ExprMutator {
   std::unordered_map<IterSumExpr, IterSumExpr, IterSumHash, IterSumEqual> flattened_map_;
   // The flattened forms of constrained iters
   std::vector<IterSumExpr> constrained_iters_flattened_;
+  // The results of TryFuseIters at the check level of the rewriter, which stay valid until a
+  // constraint updates the fused marks.
+  std::unordered_map<IterSumExpr, Optional<IterSumExpr>, IterSumHash, IterSumEqual> fused_cache_;
 
   /*!
    * \brief Look for a split in splits that is not used such that its lower_factor is smallest.
@@ -692,6 +695,8 @@ class IterMapRewriter : public ExprMutator {
       // we need to note down the flattened form of constrained iterators
       // to check the validity of constraints, see also CheckConstraints()
       constrained_iters_flattened_.push_back(flattened_form);
+      // the sums fused so far may be fused differently with the constraint
+      fused_cache_.clear();
       expr.CopyOnWrite()->args = Array<IterSplitExpr>({split});
       expr.CopyOnWrite()->base = base + iter_min;
       return expr;
@@ -745,6 +750,51 @@ class IterMapRewriter : public ExprMutator {
    * \return The sum with the fused IterMark and extra offset if succeed.
    */
   Optional<IterSumExpr> TryFuseIters(IterSumExpr expr, IterMapLevel check_level) {
+    if (check_level != check_level_) {
+      return TryFuseItersImpl(expr, check_level);
+    }
+    // The same sum is fused for each of its splits, e.g. (i*4 + j) // 2 and (i*4 + j) % 2, and
+    // for each round of rewriting.
+    auto it = fused_cache_.find(expr);
+    if (it != fused_cache_.end()) {
+      return it->second;
+    }
+    Optional<IterSumExpr> result = TryFuseItersImpl(expr, check_level);
+    fused_cache_[expr] = result;
+    return result;
+  }
+
+  /*! \brief Whether lhs == rhs, proved without the analyzer if they are constants. */
+  bool CanProveScaleEqual(const PrimExpr& lhs, const PrimExpr& rhs) {
+    const auto* clhs = lhs.as<IntImmNode>();
+    const auto* crhs = rhs.as<IntImmNode>();
+    if (clhs && crhs) {
+      return clhs->value == crhs->value;
+    }
+    return analyzer_->CanProveEqual(lhs, rhs);
+  }
+
+  /*! \brief Whether lhs >= rhs, proved without the analyzer if they are constants. */
+  bool CanProveScaleGreaterEqual(const PrimExpr& lhs, const PrimExpr& rhs) {
+    const auto* clhs = lhs.as<IntImmNode>();
+    const auto* crhs = rhs.as<IntImmNode>();
+    if (clhs && crhs) {
+      return clhs->value >= crhs->value;
+    }
+    return analyzer_->CanProveGreaterEqual(lhs - rhs, 0);
+  }
+
+  /*! \brief Whether lhs < rhs, proved without the analyzer if they are constants. */
+  bool CanProveScaleLess(const PrimExpr& lhs, const PrimExpr& rhs) {
+    const auto* clhs = lhs.as<IntImmNode>();
+    const auto* crhs = rhs.as<IntImmNode>();
+    if (clhs && crhs) {
+      return clhs->value < crhs->value;
+    }
+    return analyzer_->CanProveLess(lhs - rhs, 0);
+  }
+
+  Optional<IterSumExpr> TryFuseItersImpl(IterSumExpr expr, IterMapLevel check_level) {
     // select the iterators in order
     std::vector<bool> visited(expr->args.size(), false);
     std::vector<IterSplitExpr> flattened_iters, grouped_iters;
@@ -782,7 +832,7 @@ class IterMapRewriter : public ExprMutator {
         const PrimExpr& cur_scale = expr->args[j]->scale;
 
         // for bijective mapping, the matched scale must equal to expected scale
-        if (analyzer_->CanProveEqual(cur_scale, expected_scale)) {
+        if (CanProveScaleEqual(cur_scale, expected_scale)) {
           matched_pos = j;
           matched_scale = cur_scale;
           is_exact_match = true;
@@ -790,10 +840,9 @@ class IterMapRewriter : public ExprMutator {
         }
         if (check_level != IterMapLevel::Bijective && base_scale.value()->value == 1) {
           // find the closest scale which is less or equal to expected scale
-          if (analyzer_->CanProveGreaterEqual(expected_scale - cur_scale, 0) &&
-              analyzer_->CanProveGreaterEqual(cur_scale, 0)) {
-            if (matched_pos == expr->args.size() ||
-                analyzer_->CanProveLess(matched_scale - cur_scale, 0)) {
+          if (CanProveScaleGreaterEqual(expected_scale, cur_scale) &&
+              CanProveScaleGreaterEqual(cur_scale, make_zero(cur_scale.dtype()))) {
+            if (matched_pos == expr->args.size() || CanProveScaleLess(matched_scale, cur_scale)) {
               matched_pos = j;
               matched_scale = cur_scale;
             }
@@ -828,8 +877,7 @@ class IterMapRewriter : public ExprMutator {
           size_t k = 0;
           for (; k < expr->args.size(); ++k) {
             if (!visited[k] && IterSplitEqual(expr->args[k], *it, false)) {
-              if (analyzer_->CanProveEqual((*it)->scale * matched_scale, expr->args[k]->scale))
-                break;
+              if (CanProveScaleEqual((*it)->scale * matched_scale, expr->args[k]->scale)) break;
             }
           }
           if (k == expr->args.size()) {
@@ -875,7 +923,7 @@ class IterMapRewriter : public ExprMutator {
     auto it = sum_fuse_map_.find(flattened_form);
     if (it != sum_fuse_map_.end()) {
       // old iter
-      if (!analyzer_->CanProveEqual(expected_extra_base, it->second.offset * base_scale.value())) {
+      if (!CanProveScaleEqual(expected_extra_base, it->second.offset * base_scale.value())) {
         // the extra offset is not consistent with old
         return NullOpt;
       }
@@ -1765,6 +1813,28 @@ Array<PrimExpr> IterMapSimplify(const Array<PrimExpr>& indices, const Map<Var, R
                                 const PrimExpr& input_pred, IterMapLevel check_level,
                                 bool simplify_trivial_iterators) {
   if (!IterRangeSanityCheck(input_iters)) return indices;
+  // Fast path: the constants and the distinct iterators starting from zero, e.g. the bindings of
+  // the blocks untouched by a loop transformation, are already in their simplest form.
+  if (is_one(input_pred)) {
+    std::unordered_set<const VarNode*> used_vars;
+    bool is_trivial = true;
+    for (const PrimExpr& index : indices) {
+      if (index->IsInstance<IntImmNode>()) {
+        continue;
+      }
+      const auto* var = index.as<VarNode>();
+      auto it = var ? input_iters.find(GetRef<Var>(var)) : input_iters.end();
+      if (it == input_iters.end() || !is_zero((*it).second->min) ||
+          (simplify_trivial_iterators && is_one((*it).second->extent)) ||
+          !used_vars.insert(var).second) {
+        is_trivial = false;
+        break;
+      }
+    }
+    if (is_trivial) {
+      return indices;
+    }
+  }
   Analyzer analyzer;
   auto res = DetectIterMap(indices, input_iters, input_pred, check_level, &analyzer,
                            /*simplify_trivial_iterators=*/simplify_trivial_iterators);
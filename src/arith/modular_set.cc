@@ -111,6 +111,7 @@ class ModularSetAnalyzer::Impl : public ExprFunctor<ModularSetAnalyzer::Entry(co
       }
     }
     var_map_[var] = Entry(info->coeff, info->base);
+    parent_->NewEpoch();
   }
 
   // Detect useful constraints and use them in the analysis scope.
@@ -172,6 +172,92 @@ CompareResult RewriteSimplifier::Impl::TryCompare(const PrimExpr& x, int64_t val
   return CompareResult::kUnknown;
 }
 
+/*! \brief The max number of the memoized subexpressions, beyond which the memo is cleared. */
+constexpr size_t kMaxVisitMemoSize = 1 << 16;
+/*! \brief The depth of the subexpressions simplified ahead by SimplifyDeepOperands. */
+constexpr int kDeepOperandDepth = 64;
+
+PrimExpr RewriteSimplifier::Impl::VisitExpr(const PrimExpr& expr) {
+  if (!memoize_visits_ || recur_depth_ != 0 || recursively_visiting_boolean_ ||
+      expr->IsInstance<VarNode>() || expr->IsInstance<IntImmNode>() ||
+      expr->IsInstance<FloatImmNode>()) {
+    return IRMutatorWithAnalyzer::VisitExpr(expr);
+  }
+  VisitMemoKey key{expr.get(), analyzer_->epoch()};
+  auto it = visit_memo_.find(key);
+  if (it != visit_memo_.end()) {
+    return it->second.second;
+  }
+  PrimExpr res = IRMutatorWithAnalyzer::VisitExpr(expr);
+  // The visit may bind the variables of let expressions, which starts a new epoch.
+  if (analyzer_->epoch() == key.second) {
+    if (visit_memo_.size() >= kMaxVisitMemoSize) {
+      visit_memo_.clear();
+    }
+    visit_memo_[key] = {expr, res};
+  }
+  return res;
+}
+
+void RewriteSimplifier::Impl::SimplifyDeepOperands(const PrimExpr& expr) {
+  if (!memoize_visits_) return;
+  // The operands of the arithmetic, comparison and logical operators, which make up the deep
+  // index expressions. The other nodes are simplified recursively.
+  auto get_operands = [](const PrimExprNode* node, const PrimExprNode** a,
+                         const PrimExprNode** b) {
+#define TVM_DEEP_OPERANDS(Node)                      \
+  if (node->IsInstance<Node>()) {                    \
+    const auto* op = static_cast<const Node*>(node); \
+    *a = op->a.get();                                \
+    *b = op->b.get();                                \
+    return;                                          \
+  }
+    TVM_DEEP_OPERANDS(AddNode);
+    TVM_DEEP_OPERANDS(SubNode);
+    TVM_DEEP_OPERANDS(MulNode);
+    TVM_DEEP_OPERANDS(DivNode);
+    TVM_DEEP_OPERANDS(ModNode);
+    TVM_DEEP_OPERANDS(FloorDivNode);
+    TVM_DEEP_OPERANDS(FloorModNode);
+    TVM_DEEP_OPERANDS(MinNode);
+    TVM_DEEP_OPERANDS(MaxNode);
+    TVM_DEEP_OPERANDS(EQNode);
+    TVM_DEEP_OPERANDS(NENode);
+    TVM_DEEP_OPERANDS(LTNode);
+    TVM_DEEP_OPERANDS(LENode);
+    TVM_DEEP_OPERANDS(GTNode);
+    TVM_DEEP_OPERANDS(GENode);
+#undef TVM_DEEP_OPERANDS
+    *a = nullptr;
+    *b = nullptr;
+  };
+  // The depth of the visited nodes, counted from the deepest subexpression not simplified yet.
+  std::unordered_map<const PrimExprNode*, int> depth;
+  std::vector<std::pair<const PrimExprNode*, bool>> stack{{expr.get(), false}};
+  while (!stack.empty()) {
+    auto [node, expanded] = stack.back();
+    stack.pop_back();
+    if (!expanded && depth.count(node)) continue;
+    const PrimExprNode *a, *b;
+    get_operands(node, &a, &b);
+    if (!expanded) {
+      stack.emplace_back(node, true);
+      if (a != nullptr) {
+        stack.emplace_back(a, false);
+        stack.emplace_back(b, false);
+      }
+      continue;
+    }
+    int node_depth = a == nullptr ? 1 : std::max(depth[a], depth[b]) + 1;
+    if (node_depth >= kDeepOperandDepth && node != expr.get()) {
+      // Its operands were simplified ahead, so the recursion stops there.
+      this->VisitExpr(GetRef<PrimExpr>(node));
+      node_depth = 1;
+    }
+    depth[node] = node_depth;
+  }
+}
+
 void RewriteSimplifier::Impl::Update(const Var& var, const PrimExpr& info, bool can_override) {
   if (!can_override) {
     auto it = var_map_.find(var);
@@ -182,6 +268,7 @@ void RewriteSimplifier::Impl::Update(const Var& var, const PrimExpr& info, bool
     }
   }
   var_map_[var] = info;
+  analyzer_->NewEpoch();
 }
 
 PrimExpr RewriteSimplifier::Impl::VisitExpr_(const AddNode* op) {
@@ -317,7 +404,10 @@ std::function<void()> RewriteSimplifier::Impl::EnterConstraint(const PrimExpr& c
   return frecover;
 }
 
-void RewriteSimplifier::Impl::SetEnabledExtensions(Extension flags) { enabled_extensions_ = flags; }
+void RewriteSimplifier::Impl::SetEnabledExtensions(Extension flags) {
+  enabled_extensions_ = flags;
+  analyzer_->NewEpoch();
+}
 
 RewriteSimplifier::Extension RewriteSimplifier::Impl::GetEnabledExtensions() const {
   return enabled_extensions_;
@@ -2037,6 +2127,7 @@ PrimExpr RewriteSimplifier::operator()(const PrimExpr& expr) {
   PrimExpr res = expr;
   int max_iter = 2;
   for (int i = 0; i < max_iter; ++i) {
+    impl_->SimplifyDeepOperands(res);
     PrimExpr new_expr = impl_->operator()(res);
     if (new_expr.same_as(res)) return res;
     res = new_expr;
@@ -2059,7 +2150,7 @@ RewriteSimplifier::Extension RewriteSimplifier::GetEnabledExtensions() const {
   return impl_->GetEnabledExtensions();
 }
 
-RewriteSimplifier::RewriteSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
+RewriteSimplifier::RewriteSimplifier(Analyzer* parent) : impl_(new Impl(parent, true)) {}
 
 RewriteSimplifier::~RewriteSimplifier() { delete impl_; }
 
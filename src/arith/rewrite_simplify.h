@@ -28,6 +28,7 @@
 #include <tvm/tir/op.h>
 
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "const_fold.h"
@@ -48,9 +49,30 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
  public:
   using IRMutatorWithAnalyzer::VisitExpr_;
 
-  explicit Impl(Analyzer* parent) : IRMutatorWithAnalyzer(parent) {}
+  /*!
+   * \brief Constructor.
+   * \param parent The parent analyzer.
+   * \param memoize_visits Whether to memoize the simplified subexpressions, see VisitExpr.
+   */
+  explicit Impl(Analyzer* parent, bool memoize_visits = false)
+      : IRMutatorWithAnalyzer(parent), memoize_visits_(memoize_visits) {}
 
   void Update(const Var& var, const PrimExpr& info, bool override_info);
+  /*!
+   * \brief Simplify a subexpression, through the memo of the current epoch of the analyzer.
+   *
+   *  The subexpressions shared in a DAG, as the unrolled index expressions are, are simplified
+   *  once per epoch rather than once per use. The rewrites under a recursive rewrite or a boolean
+   *  visit depend on more than the epoch, and are not memoized.
+   */
+  PrimExpr VisitExpr(const PrimExpr& expr) override;
+  /*!
+   * \brief Simplify the deep subexpressions of an expression bottom up, from an explicit stack,
+   *  so that the recursive simplification of the expression finds them in the memo instead of
+   *  recursing as deep as the expression is.
+   * \param expr The expression.
+   */
+  void SimplifyDeepOperands(const PrimExpr& expr);
   PrimExpr VisitExpr_(const AddNode* op) override;
   PrimExpr VisitExpr_(const SubNode* op) override;
   PrimExpr VisitExpr_(const MulNode* op) override;
@@ -90,6 +112,19 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
  protected:
   // counter to record recursive rewrite depth.
   int recur_depth_{0};
+  // Whether the simplified subexpressions are memoized.
+  bool memoize_visits_;
+  // The key of a memoized subexpression: its address and the epoch of the analyzer.
+  using VisitMemoKey = std::pair<const Object*, uint64_t>;
+  struct VisitMemoKeyHash {
+    size_t operator()(const VisitMemoKey& key) const {
+      size_t hash = std::hash<const Object*>()(key.first);
+      return hash ^ (std::hash<uint64_t>()(key.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+    }
+  };
+  // The simplified subexpressions, holding the subexpressions so that their addresses are not
+  // reused.
+  std::unordered_map<VisitMemoKey, std::pair<PrimExpr, PrimExpr>, VisitMemoKeyHash> visit_memo_;
   // internal variable map
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> var_map_;
 
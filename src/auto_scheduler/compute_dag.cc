@@ -37,6 +37,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
@@ -44,6 +47,7 @@
 
 #include "../arith/pattern_match.h"
 #include "../relay/transforms/auto_scheduler_layout_rewrite.h"
+#include "../support/utils.h"
 #include "search_policy/utils.h"
 #include "utils.h"
 
@@ -680,6 +684,139 @@ void CheckComputeValidity(const te::Schedule& sch) {
   }
 }
 
+/*!
+ * \brief The schedules replayed by ApplySteps for the prefixes of the steps. The states derived
+ * from a state, e.g. by the mutations of the evolutionary search, share its steps up to the first
+ * one changed, and a state is applied again once its bounds are inferred for the features, so that
+ * only the rest of the steps is replayed from the longest prefix cached. A prefix is identified by
+ * its step objects, which its entry holds. A snapshot is taken every kSnapshotInterval steps and
+ * after the last one, and the least recently used ones are evicted.
+ */
+class ApplyStepsCache {
+ public:
+  /*! \brief The number of steps between two snapshots of the schedule. */
+  static constexpr size_t kSnapshotInterval = 8;
+  /*! \brief The maximum number of snapshots. */
+  static constexpr size_t kCapacity = 1024;
+
+  /*! \brief The hashes of the prefixes of the steps, by their lengths. */
+  static std::vector<uint64_t> PrefixHashes(const Array<Step>& steps) {
+    std::vector<uint64_t> hashes(steps.size() + 1, 0);
+    for (size_t i = 0; i < steps.size(); ++i) {
+      hashes[i + 1] = support::HashCombine(hashes[i], ObjectPtrHash()(steps[i]));
+    }
+    return hashes;
+  }
+
+  /*! \brief Whether a snapshot is taken after the first `num_steps` steps of `num_total`. */
+  static bool IsSnapshot(size_t num_steps, size_t num_total) {
+    return num_steps == num_total || num_steps % kSnapshotInterval == 0;
+  }
+
+  /*!
+   * \brief Copy the schedule of the longest prefix of the steps cached.
+   * \return The length of the prefix, or 0 if no prefix is cached.
+   */
+  size_t Lookup(const Array<Step>& steps, const std::vector<uint64_t>& hashes,
+                te::Schedule* schedule, Array<te::Stage>* stages, StageToAxesMap* stage_to_axes) {
+    Entry entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t len = steps.size(); len > 0 && !entry.schedule.defined(); --len) {
+        auto it = index_.find(hashes[len]);
+        if (it != index_.end() && IsPrefix(it->second->prefix, steps)) {
+          entries_.splice(entries_.begin(), entries_, it->second);
+          entry = *it->second;
+        }
+      }
+    }
+    if (!entry.schedule.defined()) {
+      return 0;
+    }
+    Copy(entry.schedule, entry.stages, entry.stage_to_axes, schedule, stages, stage_to_axes);
+    return entry.prefix.size();
+  }
+
+  /*! \brief Take a snapshot of the schedule after the first `len` steps. */
+  void Insert(const Array<Step>& steps, size_t len, uint64_t hash, const te::Schedule& schedule,
+              const Array<te::Stage>& stages, const StageToAxesMap& stage_to_axes) {
+    Entry entry;
+    entry.prefix = Array<Step>(steps.begin(), steps.begin() + len);
+    entry.hash = hash;
+    Copy(schedule, stages, stage_to_axes, &entry.schedule, &entry.stages, &entry.stage_to_axes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    entries_.push_front(std::move(entry));
+    index_[hash] = entries_.begin();
+    if (entries_.size() > kCapacity) {
+      index_.erase(entries_.back().hash);
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  /*! \brief The schedule replayed for a prefix of the steps. */
+  struct Entry {
+    Array<Step> prefix;
+    uint64_t hash = 0;
+    te::Schedule schedule;
+    Array<te::Stage> stages;
+    StageToAxesMap stage_to_axes;
+  };
+
+  static bool IsPrefix(const Array<Step>& prefix, const Array<Step>& steps) {
+    if (prefix.size() > steps.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) {
+      if (!prefix[i].same_as(steps[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief Copy a schedule, with the stages and their axes remapped to those of the copy. */
+  static void Copy(const te::Schedule& schedule, const Array<te::Stage>& stages,
+                   const StageToAxesMap& stage_to_axes, te::Schedule* new_schedule,
+                   Array<te::Stage>* new_stages, StageToAxesMap* new_stage_to_axes) {
+    *new_schedule = schedule.copy();
+    // The copy keeps the order of the stages and of the groups.
+    std::unordered_map<const Object*, te::Stage> stage_map;
+    for (size_t i = 0; i < schedule->stages.size(); ++i) {
+      stage_map[schedule->stages[i].get()] = (*new_schedule)->stages[i];
+    }
+    for (size_t i = 0; i < schedule->groups.size(); ++i) {
+      stage_map[schedule->groups[i].get()] = (*new_schedule)->groups[i];
+    }
+    auto remap = [&stage_map](const te::Stage& stage) {
+      auto it = stage_map.find(stage.get());
+      ICHECK(it != stage_map.end()) << "Cannot find the stage " << stage << " in the schedule";
+      return it->second;
+    };
+    Array<te::Stage> result_stages;
+    for (const te::Stage& stage : stages) {
+      result_stages.push_back(remap(stage));
+    }
+    StageToAxesMap result_stage_to_axes;
+    for (const auto& kv : stage_to_axes) {
+      result_stage_to_axes.Set(remap(kv.first), kv.second);
+    }
+    *new_stages = std::move(result_stages);
+    *new_stage_to_axes = std::move(result_stage_to_axes);
+  }
+
+  std::mutex mutex_;
+  /*! \brief The snapshots, the most recently used first. */
+  std::list<Entry> entries_;
+  /*! \brief The snapshots by the hashes of their prefixes. */
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+};
+
 ComputeDAG::ComputeDAG(Array<te::Tensor> tensors) {
   auto node = make_object<ComputeDAGNode>();
   node->tensors = std::move(tensors);
@@ -701,6 +838,7 @@ ComputeDAG::ComputeDAG(Array<te::Tensor> tensors) {
 
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->apply_steps_cache = std::make_shared<ApplyStepsCache>();
   data_ = std::move(node);
 }
 
@@ -728,6 +866,7 @@ ComputeDAG::ComputeDAG(const te::Schedule& sch) {
   node->access_analyzer = AccessAnalyzer(node->tensors);
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->apply_steps_cache = std::make_shared<ApplyStepsCache>();
   data_ = std::move(node);
 }
 
@@ -1177,27 +1316,42 @@ std::pair<te::Schedule, Array<te::Tensor>> ComputeDAG::ApplySteps(
   if (stage_to_axes == nullptr) {
     stage_to_axes = &temp_stage_to_axes;
   }
-  Array<te::Operation> out_ops;
-  for (const auto& op : operator->()->ops) {
-    if (operator->()->access_analyzer.IsOutput(op)) {
-      out_ops.push_back(op);
-    }
+  // Start from the schedule of the longest prefix of the steps replayed
+  ApplyStepsCache* cache = operator->()->apply_steps_cache.get();
+  std::vector<uint64_t> hashes;
+  te::Schedule schedule;
+  size_t num_replayed = 0;
+  if (cache != nullptr && !transform_steps.empty()) {
+    hashes = ApplyStepsCache::PrefixHashes(transform_steps);
+    num_replayed = cache->Lookup(transform_steps, hashes, &schedule, stages, stage_to_axes);
   }
 
-  // Create the initial schedule
-  te::Schedule schedule = te::create_schedule(out_ops);
+  if (num_replayed == 0) {
+    Array<te::Operation> out_ops;
+    for (const auto& op : operator->()->ops) {
+      if (operator->()->access_analyzer.IsOutput(op)) {
+        out_ops.push_back(op);
+      }
+    }
 
-  // init axes
-  for (const auto& x : operator->()->ops) {
-    const te::Stage& stage = schedule[x];
-    stages->push_back(stage);
-    UpdateStageToAxesMap(stage, stage_to_axes);
+    // Create the initial schedule
+    schedule = te::create_schedule(out_ops);
+
+    // init axes
+    for (const auto& x : operator->()->ops) {
+      const te::Stage& stage = schedule[x];
+      stages->push_back(stage);
+      UpdateStageToAxesMap(stage, stage_to_axes);
+    }
   }
 
   // Apply the history steps to TVM schedule
   // Call each step's ApplyToSchedule method
-  for (const auto& step : transform_steps) {
-    StepApplyToSchedule(step, stages, stage_to_axes, &schedule, transform_steps);
+  for (size_t i = num_replayed; i < transform_steps.size(); ++i) {
+    StepApplyToSchedule(transform_steps[i], stages, stage_to_axes, &schedule, transform_steps);
+    if (cache != nullptr && ApplyStepsCache::IsSnapshot(i + 1, transform_steps.size())) {
+      cache->Insert(transform_steps, i + 1, hashes[i + 1], schedule, *stages, *stage_to_axes);
+    }
   }
 
   return std::make_pair(schedule, operator->()->tensors);
@@ -40,10 +40,13 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <list>
+#include <mutex>
 #include <numeric>
 #include <unordered_map>
 #include <vector>
 
+#include "../support/utils.h"
 #include "search_policy/utils.h"
 #include "utils.h"
 
@@ -1355,8 +1358,88 @@ void GetPerStoreFeatureName(int max_n_bufs, std::vector<std::string>* ret) {
   // section total : 3
 }
 
+/*!
+ * \brief The features of the states recently extracted, so that the states predicted again, e.g.
+ * those kept in the population by the evolutionary search, are not lowered again. A state is
+ * identified by the array of its steps, which is copied on write when the state is changed, and
+ * which its entry holds. The least recently used entries are evicted.
+ */
+class FeatureCache {
+ public:
+  /*! \brief The maximum number of entries. */
+  static constexpr size_t kCapacity = 4096;
+
+  static FeatureCache* Global() {
+    static FeatureCache* inst = new FeatureCache();
+    return inst;
+  }
+
+  /*! \brief Get the features of a state, and return whether they are cached. */
+  bool Lookup(const SearchTask& task, const Array<Step>& steps, int max_n_bufs,
+              std::vector<float>* feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(Hash(task, steps, max_n_bufs));
+    if (it == index_.end()) {
+      return false;
+    }
+    const Entry& entry = *it->second;
+    if (!entry.task.same_as(task) || !entry.steps.same_as(steps) ||
+        entry.max_n_bufs != max_n_bufs) {
+      return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *feature = entry.feature;
+    return true;
+  }
+
+  void Insert(const SearchTask& task, const Array<Step>& steps, int max_n_bufs,
+              const std::vector<float>& feature) {
+    uint64_t hash = Hash(task, steps, max_n_bufs);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    entries_.push_front(Entry{hash, task, steps, max_n_bufs, feature});
+    index_[hash] = entries_.begin();
+    if (entries_.size() > kCapacity) {
+      index_.erase(entries_.back().hash);
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    SearchTask task;
+    Array<Step> steps;
+    int max_n_bufs;
+    std::vector<float> feature;
+  };
+
+  static uint64_t Hash(const SearchTask& task, const Array<Step>& steps, int max_n_bufs) {
+    uint64_t hash = support::HashCombine(ObjectPtrHash()(task), ObjectPtrHash()(steps));
+    return support::HashCombine(hash, max_n_bufs);
+  }
+
+  std::mutex mutex_;
+  /*! \brief The entries, the most recently used first. */
+  std::list<Entry> entries_;
+  /*! \brief The entries by the hashes of their keys. */
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+};
+
 void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
                                    std::vector<float>* feature, std::atomic<int>* error_ct) {
+  FeatureCache* cache = FeatureCache::Global();
+  if (cache->Lookup(task, state->transform_steps, max_n_bufs, feature)) {
+    if (feature->empty()) {
+      (*error_ct)++;
+    }
+    return;
+  }
+
   auto [sch, tensors] = task->compute_dag.ApplySteps(state->transform_steps);
 
   // When inlining, replace const matrices with const values.
@@ -1409,6 +1492,7 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
   } catch (Error& e) {
     (*error_ct)++;
   }
+  cache->Insert(task, state->transform_steps, max_n_bufs, *feature);
 }
 
 void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask& task,
@@ -51,6 +51,9 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.is_entry_func", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.add_lower_pass", Array<Array<ObjectRef>>);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.debug_keep_trivial_loop", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.use_async_copy", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.auto_software_pipeline", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.pad_shared_memory", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_loop_invariant_code_motion", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_async_commit_queue_scope", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_lwp", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.dma_bypass_cache", Bool);
@@ -150,6 +153,11 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   bool disable_cse_tir = pass_ctx->GetConfig<Bool>("tir.disable_cse_tir", Bool(false)).value();
   bool enable_equiv_terms_in_cse_tir =
       pass_ctx->GetConfig<Bool>("tir.enable_equiv_terms_in_cse_tir", Bool(false)).value();
+  bool auto_software_pipeline =
+      pass_ctx->GetConfig<Bool>("tir.auto_software_pipeline", Bool(false)).value();
+  bool pad_shared_memory = pass_ctx->GetConfig<Bool>("tir.pad_shared_memory", Bool(false)).value();
+  bool enable_loop_invariant_code_motion =
+      pass_ctx->GetConfig<Bool>("tir.enable_loop_invariant_code_motion", Bool(false)).value();
 
   // Get any user-added passes
   Array<Array<ObjectRef>> add_lower_pass =
@@ -202,8 +210,14 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   pass_list.push_back(tir::transform::ConvertBlocksToOpaque());
   pass_list.push_back(tir::transform::UnifyThreadBinding());
   pass_list.push_back(tir::transform::ManifestSharedMemoryLocalStage());
+  if (pad_shared_memory) {
+    pass_list.push_back(tir::transform::PadSharedMemory());
+  }
   pass_list.push_back(tir::transform::CompactBufferAllocation());
   pass_list.push_back(tir::transform::LowerMatchBuffer());
+  if (auto_software_pipeline) {
+    pass_list.push_back(tir::transform::AutoSoftwarePipeline());
+  }
   pass_list.push_back(tir::transform::InjectSoftwarePipeline());
   pass_list.push_back(tir::transform::LowerOpaqueBlock());
   pass_list.push_back(tir::transform::FlattenBuffer());
@@ -243,6 +257,9 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   pass_list.push_back(tir::transform::RemoveNoOp());
   pass_list.push_back(tir::transform::RewriteUnsafeSelect());
   pass_list.push_back(tir::transform::HoistIfThenElse());
+  if (enable_loop_invariant_code_motion) {
+    pass_list.push_back(tir::transform::LoopInvariantCodeMotion());
+  }
 
   // Add user-defined phase-3 passes
   pass_list.insert(pass_list.end(), user_lower_phase3.begin(), user_lower_phase3.end());
@@ -24,10 +24,19 @@
 #include <dmlc/thread_local.h>
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
+#include <tvm/node/reflection.h>
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <iomanip>
 #include <stack>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace tvm {
 namespace instrument {
@@ -216,16 +225,16 @@ struct PassProfile {
   Duration duration;
   /*! \brief PassProfiles for all sub-passes invoked during the execution of the pass. */
   std::vector<PassProfile> children;
+  /*! \brief The peak resident set size when the pass was entered, in KB, or -1. */
+  int64_t peak_rss_start_kb{-1};
+  /*! \brief The increase of the peak resident set size during the pass, in KB, or -1. */
+  int64_t peak_rss_delta_kb{-1};
+  /*! \brief The number of IR nodes of the module before and after the pass, or -1. */
+  int64_t num_nodes_before{-1};
+  int64_t num_nodes_after{-1};
 
   explicit PassProfile(String name)
       : name(name), start(Clock::now()), end(Clock::now()), children() {}
-
-  /*! \brief Gets the PassProfile of the currently executing pass. */
-  static PassProfile* Current();
-  /*! \brief Pushes a new PassProfile with the given pass name. */
-  static void EnterPass(String name);
-  /*! \brief Pops the current PassProfile. */
-  static void ExitPass();
 };
 
 struct PassProfileThreadLocalEntry {
@@ -235,36 +244,103 @@ struct PassProfileThreadLocalEntry {
   std::stack<PassProfile*> profile_stack;
 
   PassProfileThreadLocalEntry() : root("root") {}
+
+  /*! \brief Gets the PassProfile of the currently executing pass. */
+  PassProfile* Current() { return profile_stack.empty() ? &root : profile_stack.top(); }
+
+  /*! \brief Pushes a new PassProfile with the given pass name. */
+  PassProfile* EnterPass(String name) {
+    PassProfile* cur = Current();
+    cur->children.emplace_back(name);
+    profile_stack.push(&cur->children.back());
+    return profile_stack.top();
+  }
+
+  /*! \brief Pops the current PassProfile. */
+  PassProfile* ExitPass() {
+    PassProfile* cur = Current();
+    ICHECK_NE(cur->name, "root") << "mismatched enter/exit for pass profiling";
+    cur->end = PassProfile::Clock::now();
+    cur->duration = std::chrono::duration_cast<PassProfile::Duration>(cur->end - cur->start);
+    profile_stack.pop();
+    return cur;
+  }
 };
 
 /*! \brief Thread local store to hold the pass profiling data. */
 typedef dmlc::ThreadLocalStore<PassProfileThreadLocalEntry> PassProfileThreadLocalStore;
 
-void PassProfile::EnterPass(String name) {
-  PassProfile* cur = PassProfile::Current();
-  cur->children.emplace_back(name);
-  PassProfileThreadLocalStore::Get()->profile_stack.push(&cur->children.back());
+/*! \brief The profiles of PassProfilingInstrument, kept apart from those of the timing one. */
+struct PassProfilingThreadLocalEntry : public PassProfileThreadLocalEntry {};
+
+typedef dmlc::ThreadLocalStore<PassProfilingThreadLocalEntry> PassProfilingThreadLocalStore;
+
+/*! \return The peak resident set size of the process in KB, or -1 if it is not available. */
+int64_t PeakRSSKiloBytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return -1;
+#endif
 }
 
-void PassProfile::ExitPass() {
-  PassProfile* cur = PassProfile::Current();
-  ICHECK_NE(cur->name, "root") << "mismatched enter/exit for pass profiling";
-  cur->end = PassProfile::Clock::now();
-  cur->duration = std::chrono::duration_cast<PassProfile::Duration>(cur->end - cur->start);
-  PassProfileThreadLocalStore::Get()->profile_stack.pop();
-}
+/*! \brief Count the distinct IR nodes reachable from an object through its reflected fields. */
+class IRNodeCounter : public AttrVisitor {
+ public:
+  int64_t Count(const ObjectRef& root) {
+    Push(root.get());
+    while (!stack_.empty()) {
+      Object* node = stack_.back();
+      stack_.pop_back();
+      if (node->IsInstance<runtime::ArrayNode>()) {
+        for (const ObjectRef& elem : *static_cast<const runtime::ArrayNode*>(node)) {
+          Push(elem.get());
+        }
+      } else if (node->IsInstance<MapNode>()) {
+        for (const auto& kv : *static_cast<const MapNode*>(node)) {
+          Push(kv.first.get());
+          Push(kv.second.get());
+        }
+      } else {
+        ReflectionVTable::Global()->VisitAttrs(node, this);
+      }
+    }
+    return static_cast<int64_t>(visited_.size());
+  }
 
-PassProfile* PassProfile::Current() {
-  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
-  if (!entry->profile_stack.empty()) {
-    return entry->profile_stack.top();
-  } else {
-    return &entry->root;
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {}
+  void Visit(const char* key, ObjectRef* value) final { Push(const_cast<Object*>(value->get())); }
+
+ private:
+  void Push(const Object* node) {
+    if (node != nullptr && visited_.insert(node).second) {
+      stack_.push_back(const_cast<Object*>(node));
+    }
   }
-}
 
-String RenderPassProfiles() {
-  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+  std::unordered_set<const Object*> visited_;
+  std::vector<Object*> stack_;
+};
+
+/*!
+ * \brief Render the tree of pass profiles, with the memory and IR size columns of
+ *  PassProfilingInstrument when `detailed` is set.
+ */
+String RenderPassProfiles(PassProfileThreadLocalEntry* entry, bool detailed) {
   CHECK(entry->profile_stack.empty()) << "cannot print pass profile while still in a pass!";
 
   if (entry->root.children.empty()) {
@@ -309,22 +385,70 @@ String RenderPassProfiles() {
     os << profile->name << ": ";
     os << std::setprecision(0);
     os << profile->duration.count() << "us [" << self_duration.count() << "us] ";
-    os << std::setprecision(2) << "(" << total_pct << "%; " << parent_pct << "%)\n";
+    os << std::setprecision(2) << "(" << total_pct << "%; " << parent_pct << "%)";
+    if (detailed && profile->peak_rss_delta_kb >= 0) {
+      os << " rss +" << profile->peak_rss_delta_kb << "KB";
+    }
+    if (detailed && profile->num_nodes_before >= 0) {
+      os << " nodes " << profile->num_nodes_before << " -> " << profile->num_nodes_after;
+    }
+    os << "\n";
   }
 
   return os.str();
 }
 
-TVM_REGISTER_GLOBAL("instrument.RenderTimePassProfiles").set_body_typed(RenderPassProfiles);
+/*! \brief Render the pass profiles as the events of a Chrome trace, in JSON. */
+String RenderPassProfilesChromeTrace(PassProfileThreadLocalEntry* entry) {
+  CHECK(entry->profile_stack.empty()) << "cannot print pass profile while still in a pass!";
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(0) << "{\"traceEvents\": [";
+  bool first = true;
+  std::vector<const PassProfile*> profiles;
+  for (auto it = entry->root.children.rbegin(); it != entry->root.children.rend(); ++it) {
+    profiles.push_back(&*it);
+  }
+  PassProfile::Time origin =
+      entry->root.children.empty() ? entry->root.start : entry->root.children.front().start;
+  while (!profiles.empty()) {
+    const PassProfile* profile = profiles.back();
+    profiles.pop_back();
+    for (auto it = profile->children.rbegin(); it != profile->children.rend(); ++it) {
+      profiles.push_back(&*it);
+    }
+    PassProfile::Duration ts =
+        std::chrono::duration_cast<PassProfile::Duration>(profile->start - origin);
+    os << (first ? "" : ",") << "\n  {\"name\": " << std::quoted(std::string(profile->name))
+       << ", \"cat\": \"pass\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": " << ts.count()
+       << ", \"dur\": " << profile->duration.count() << ", \"args\": {";
+    const char* sep = "";
+    if (profile->peak_rss_delta_kb >= 0) {
+      os << "\"peak_rss_delta_kb\": " << profile->peak_rss_delta_kb;
+      sep = ", ";
+    }
+    if (profile->num_nodes_before >= 0) {
+      os << sep << "\"num_nodes_before\": " << profile->num_nodes_before
+         << ", \"num_nodes_after\": " << profile->num_nodes_after;
+    }
+    os << "}}";
+    first = false;
+  }
+  os << "\n]}\n";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("instrument.RenderTimePassProfiles").set_body_typed([]() {
+  return RenderPassProfiles(PassProfileThreadLocalStore::Get(), false);
+});
 
 TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
   auto run_before_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
-    PassProfile::EnterPass(pass_info->name);
+    PassProfileThreadLocalStore::Get()->EnterPass(pass_info->name);
     return true;
   };
 
   auto run_after_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
-    PassProfile::ExitPass();
+    PassProfileThreadLocalStore::Get()->ExitPass();
   };
 
   auto exit_pass_ctx = []() { PassProfileThreadLocalStore::Get()->root.children.clear(); };
@@ -334,5 +458,39 @@ TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
                             run_before_pass, run_after_pass);
 });
 
+TVM_REGISTER_GLOBAL("instrument.RenderPassProfilesDetailed").set_body_typed([]() {
+  return RenderPassProfiles(PassProfilingThreadLocalStore::Get(), true);
+});
+
+TVM_REGISTER_GLOBAL("instrument.RenderPassProfilesChromeTrace").set_body_typed([]() {
+  return RenderPassProfilesChromeTrace(PassProfilingThreadLocalStore::Get());
+});
+
+TVM_REGISTER_GLOBAL("instrument.MakePassProfilingInstrument").set_body_typed([](bool count_nodes) {
+  auto run_before_pass = [count_nodes](const IRModule& mod, const transform::PassInfo& pass_info) {
+    // The node count comes first, so that its time and memory are not charged to the pass.
+    int64_t num_nodes = count_nodes ? IRNodeCounter().Count(mod) : -1;
+    PassProfile* profile = PassProfilingThreadLocalStore::Get()->EnterPass(pass_info->name);
+    profile->num_nodes_before = num_nodes;
+    profile->peak_rss_start_kb = PeakRSSKiloBytes();
+    return true;
+  };
+
+  auto run_after_pass = [count_nodes](const IRModule& mod, const transform::PassInfo& pass_info) {
+    int64_t peak_rss = PeakRSSKiloBytes();
+    PassProfile* profile = PassProfilingThreadLocalStore::Get()->ExitPass();
+    if (peak_rss >= 0 && profile->peak_rss_start_kb >= 0) {
+      profile->peak_rss_delta_kb = peak_rss - profile->peak_rss_start_kb;
+    }
+    if (count_nodes) profile->num_nodes_after = IRNodeCounter().Count(mod);
+  };
+
+  auto exit_pass_ctx = []() { PassProfilingThreadLocalStore::Get()->root.children.clear(); };
+
+  return BasePassInstrument("PassProfilingInstrument",
+                            /* enter_pass_ctx */ nullptr, exit_pass_ctx, /* should_run */ nullptr,
+                            run_before_pass, run_after_pass);
+});
+
 }  // namespace instrument
 }  // namespace tvm
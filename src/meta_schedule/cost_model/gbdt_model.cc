@@ -0,0 +1,593 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief A regression tree stored as flat arrays of nodes, where the root is the node 0 and a node
+ * of negative feature index is a leaf.
+ */
+struct GBDTTree {
+  /*! \brief The feature index each node splits on, or -1 for the leaves. */
+  std::vector<int32_t> feature;
+  /*! \brief The rows whose feature is no greater than the threshold go to the left child. */
+  std::vector<float> threshold;
+  /*! \brief The left child of each node. */
+  std::vector<int32_t> left;
+  /*! \brief The right child of each node. */
+  std::vector<int32_t> right;
+  /*! \brief The output of each leaf, with the learning rate applied. */
+  std::vector<double> value;
+
+  int32_t AddNode() {
+    feature.push_back(-1);
+    threshold.push_back(0.0f);
+    left.push_back(-1);
+    right.push_back(-1);
+    value.push_back(0.0);
+    return static_cast<int32_t>(feature.size()) - 1;
+  }
+
+  double Predict(const float* row) const {
+    int32_t node = 0;
+    while (feature[node] >= 0) {
+      node = row[feature[node]] <= threshold[node] ? left[node] : right[node];
+    }
+    return value[node];
+  }
+
+  void Save(dmlc::Stream* strm) const {
+    strm->Write(feature);
+    strm->Write(threshold);
+    strm->Write(left);
+    strm->Write(right);
+    strm->Write(value);
+  }
+
+  bool Load(dmlc::Stream* strm) {
+    return strm->Read(&feature) && strm->Read(&threshold) && strm->Read(&left) &&
+           strm->Read(&right) && strm->Read(&value);
+  }
+};
+
+/*!
+ * \brief The gradient-boosted decision trees cost model, which trains and predicts natively so that
+ * the search strategies do not round-trip through the Python cost models.
+ * \details The model follows the pack-sum format of XGBModel: each candidate has one feature
+ * vector per block, and its score is the sum of the predictions of its blocks. The label of a
+ * candidate is the minimum cost of its workload over its own cost, and the square error is
+ * weighted by the label, so that the score of the fast candidates is fit the most.
+ *
+ * Each `Update` grows `num_trees_per_update` trees upon the existing ensemble, continuing the
+ * boosting from the cached predictions of the samples rather than retraining from scratch. Once
+ * the ensemble would exceed `max_num_trees`, it is retrained from scratch with half of the trees.
+ */
+class GBDTModelNode : public CostModelNode {
+ public:
+  using TRandState = support::LinearCongruentialEngine::TRandState;
+
+  /*! \brief The feature extractor. */
+  FeatureExtractor extractor{nullptr};
+  /*! \brief The number of samples before which the predictions are random. */
+  int num_warmup_samples;
+  /*! \brief The number of trees grown by each update. */
+  int num_trees_per_update;
+  /*! \brief The maximum number of trees of the ensemble. */
+  int max_num_trees;
+  /*! \brief The maximum depth of the trees. */
+  int max_depth;
+  /*! \brief The learning rate, i.e. the shrinkage of each tree. */
+  double learning_rate;
+  /*! \brief The minimum sum of the hessians of a child of a split. */
+  double min_child_weight;
+  /*! \brief The L2 regularization on the leaf values. */
+  double reg_lambda;
+  /*! \brief The maximum number of histogram bins of each feature. */
+  int max_bin;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("extractor", &extractor);
+    v->Visit("num_warmup_samples", &num_warmup_samples);
+    v->Visit("num_trees_per_update", &num_trees_per_update);
+    v->Visit("max_num_trees", &max_num_trees);
+    v->Visit("max_depth", &max_depth);
+    v->Visit("learning_rate", &learning_rate);
+    v->Visit("min_child_weight", &min_child_weight);
+    v->Visit("reg_lambda", &reg_lambda);
+    v->Visit("max_bin", &max_bin);
+    // `rand_state_` is not visited
+    // The training data and the trees are not visited
+  }
+
+  void Load(const String& path) final {
+    std::ifstream is(path, std::ios::binary);
+    CHECK(is.good()) << "ValueError: Cannot open file: " << path;
+    std::string blob((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    dmlc::MemoryStringStream mstrm(&blob);
+    dmlc::Stream* strm = &mstrm;
+    uint64_t magic = 0;
+    uint64_t num_trees = 0;
+    bool ok = strm->Read(&magic) && magic == kMagic;
+    ok = ok && strm->Read(&num_features_) && strm->Read(&features_) &&
+         strm->Read(&row_sample_) && strm->Read(&sample_group_) && strm->Read(&sample_cost_) &&
+         strm->Read(&sample_pred_) && strm->Read(&group_hashes_) &&
+         strm->Read(&group_min_cost_) && strm->Read(&num_trees);
+    if (ok) {
+      trees_.resize(num_trees);
+      for (GBDTTree& tree : trees_) {
+        ok = ok && tree.Load(strm);
+      }
+    }
+    CHECK(ok) << "ValueError: Invalid GBDTModel file: " << path;
+    group_index_.clear();
+    for (size_t i = 0; i < group_hashes_.size(); ++i) {
+      group_index_.emplace(group_hashes_[i], i);
+    }
+  }
+
+  void Save(const String& path) final {
+    std::string blob;
+    dmlc::MemoryStringStream mstrm(&blob);
+    dmlc::Stream* strm = &mstrm;
+    strm->Write(kMagic);
+    strm->Write(num_features_);
+    strm->Write(features_);
+    strm->Write(row_sample_);
+    strm->Write(sample_group_);
+    strm->Write(sample_cost_);
+    strm->Write(sample_pred_);
+    strm->Write(group_hashes_);
+    strm->Write(group_min_cost_);
+    strm->Write(static_cast<uint64_t>(trees_.size()));
+    for (const GBDTTree& tree : trees_) {
+      tree.Save(strm);
+    }
+    std::ofstream os(path, std::ios::binary);
+    CHECK(os.good()) << "ValueError: Cannot create file: " << path;
+    os.write(blob.data(), blob.size());
+  }
+
+  void Update(const TuneContext& context, const Array<MeasureCandidate>& candidates,
+              const Array<RunnerResult>& results) final {
+    CHECK_EQ(candidates.size(), results.size());
+    if (candidates.empty()) {
+      return;
+    }
+    int num_threads = std::max(context->num_threads, 1);
+    // Step 1. Get the workload group of the candidates
+    std::string group_hash = SHash2Hex(context->mod);
+    auto it = group_index_.find(group_hash);
+    if (it == group_index_.end()) {
+      it = group_index_.emplace(group_hash, group_hashes_.size()).first;
+      group_hashes_.push_back(group_hash);
+      group_min_cost_.push_back(std::numeric_limits<double>::max());
+    }
+    int32_t group = it->second;
+    // Step 2. Add the features and the costs into the training data
+    int64_t first_row = NumRows();
+    Array<runtime::NDArray> features = extractor->ExtractFrom(context, candidates);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      const RunnerResult& result = results[i];
+      double cost = 1e10;
+      if (result->run_secs.defined() && !result->run_secs.value().empty()) {
+        cost = GetRunMsMedian(result);
+      }
+      int32_t sample = sample_cost_.size();
+      int64_t num_rows = AppendRows(features[i], &features_);
+      row_sample_.insert(row_sample_.end(), num_rows, sample);
+      sample_group_.push_back(group);
+      sample_cost_.push_back(cost);
+      group_min_cost_[group] = std::min(group_min_cost_[group], cost);
+    }
+    // Step 3. Predict the new samples with the current ensemble to continue the boosting from it
+    std::vector<double> row_pred = PredictRows(features_.data() + first_row * num_features_,
+                                               NumRows() - first_row, num_threads);
+    sample_pred_.resize(sample_cost_.size(), 0.0);
+    for (int64_t row = first_row; row < NumRows(); ++row) {
+      sample_pred_[row_sample_[row]] += row_pred[row - first_row];
+    }
+    // Step 4. Grow the trees
+    int num_rounds = num_trees_per_update;
+    if (static_cast<int64_t>(trees_.size()) + num_rounds > max_num_trees) {
+      trees_.clear();
+      std::fill(sample_pred_.begin(), sample_pred_.end(), 0.0);
+      num_rounds = std::max(max_num_trees / 2, num_rounds);
+    }
+    Train(num_rounds, num_threads);
+  }
+
+  std::vector<double> Predict(const TuneContext& context,
+                              const Array<MeasureCandidate>& candidates) final {
+    int n = candidates.size();
+    std::vector<double> result(n, 0.0);
+    if (static_cast<int64_t>(sample_cost_.size()) < num_warmup_samples || trees_.empty()) {
+      support::LinearCongruentialEngine rand_engine(&rand_state_);
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      for (double& score : result) {
+        score = dist(rand_engine);
+      }
+      return result;
+    }
+    Array<runtime::NDArray> features = extractor->ExtractFrom(context, candidates);
+    std::vector<float> rows;
+    std::vector<int32_t> row_candidate;
+    for (int i = 0; i < n; ++i) {
+      int64_t num_rows = AppendRows(features[i], &rows);
+      row_candidate.insert(row_candidate.end(), num_rows, i);
+    }
+    std::vector<double> row_pred =
+        PredictRows(rows.data(), row_candidate.size(), std::max(context->num_threads, 1));
+    for (size_t row = 0; row < row_candidate.size(); ++row) {
+      result[row_candidate[row]] += row_pred[row];
+    }
+    return result;
+  }
+
+  /*! \brief The number of trees of the ensemble. */
+  int64_t NumTrees() const { return trees_.size(); }
+  /*! \brief The number of training samples. */
+  int64_t NumSamples() const { return sample_cost_.size(); }
+
+  static constexpr const char* _type_key = "meta_schedule.GBDTModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(GBDTModelNode, CostModelNode);
+
+ private:
+  friend class CostModel;
+
+  /*! \brief The best split of a tree node. */
+  struct Split {
+    int32_t feature = -1;
+    int32_t bin = -1;
+    double gain = 0.0;
+  };
+
+  /*! \brief The number of rows, i.e. the number of the blocks, of the training data. */
+  int64_t NumRows() const { return row_sample_.size(); }
+
+  /*!
+   * \brief Append the feature vectors of the blocks of a candidate as rows
+   * \param feature The feature NDArray of shape [num_blocks, num_features]
+   * \param rows The row-major rows to be appended to
+   * \return The number of the appended rows
+   */
+  int64_t AppendRows(const runtime::NDArray& feature, std::vector<float>* rows) {
+    CHECK_EQ(feature->ndim, 2) << "ValueError: Expect 2-dimensional features, but gets "
+                               << feature->ndim << " dimensions";
+    int64_t num_rows = feature->shape[0];
+    int64_t num_features = feature->shape[1];
+    if (num_features_ < 0) {
+      num_features_ = num_features;
+    }
+    CHECK_EQ(num_features, num_features_)
+        << "ValueError: The length of the feature vectors changes from " << num_features_ << " to "
+        << num_features;
+    runtime::NDArray cpu_feature = feature.CopyTo(DLDevice{kDLCPU, 0});
+    int64_t size = num_rows * num_features;
+    DLDataType dtype = cpu_feature->dtype;
+    if (dtype.code == kDLFloat && dtype.bits == 64) {
+      const double* data = static_cast<const double*>(cpu_feature->data);
+      rows->insert(rows->end(), data, data + size);
+    } else if (dtype.code == kDLFloat && dtype.bits == 32) {
+      const float* data = static_cast<const float*>(cpu_feature->data);
+      rows->insert(rows->end(), data, data + size);
+    } else {
+      LOG(FATAL) << "TypeError: Unsupported feature dtype: " << runtime::DLDataType2String(dtype);
+    }
+    return num_rows;
+  }
+
+  /*!
+   * \brief Predict a batch of rows with the ensemble
+   * \param rows The row-major rows
+   * \param num_rows The number of rows
+   * \param num_threads The number of threads
+   * \return The prediction of each row
+   * \note The rows are processed in chunks, and each tree is evaluated on the whole chunk before
+   * the next one, so that the nodes of a tree stay in cache across the candidates.
+   */
+  std::vector<double> PredictRows(const float* rows, int64_t num_rows, int num_threads) const {
+    constexpr int64_t kChunkSize = 64;
+    std::vector<double> pred(num_rows, 0.0);
+    int64_t num_chunks = (num_rows + kChunkSize - 1) / kChunkSize;
+    auto f_chunk = [&](int thread_id, int chunk) -> void {
+      int64_t begin = chunk * kChunkSize;
+      int64_t end = std::min(begin + kChunkSize, num_rows);
+      for (const GBDTTree& tree : trees_) {
+        for (int64_t row = begin; row < end; ++row) {
+          pred[row] += tree.Predict(rows + row * num_features_);
+        }
+      }
+    };
+    if (num_chunks > 1 && num_threads > 1) {
+      support::parallel_for_dynamic(0, num_chunks, std::min<int64_t>(num_threads, num_chunks),
+                                    f_chunk);
+    } else {
+      for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+        f_chunk(0, chunk);
+      }
+    }
+    return pred;
+  }
+
+  /*!
+   * \brief Quantize the training data into histogram bins
+   * \param num_threads The number of threads
+   * \note The bins are recomputed with all the training data on each update. The trees keep the
+   * raw thresholds, so that the trees grown by the previous updates are not affected.
+   */
+  void BuildBins(int num_threads) {
+    int64_t num_rows = NumRows();
+    cuts_.assign(num_features_, {});
+    bins_.resize(num_rows * num_features_);
+    auto f_feature = [&](int thread_id, int f) -> void {
+      std::vector<float> values(num_rows);
+      for (int64_t row = 0; row < num_rows; ++row) {
+        values[row] = features_[row * num_features_ + f];
+      }
+      std::sort(values.begin(), values.end());
+      std::vector<float>& cuts = cuts_[f];
+      int64_t num_unique = std::unique(values.begin(), values.end()) - values.begin();
+      if (num_unique <= max_bin) {
+        cuts.assign(values.begin(), values.begin() + num_unique);
+      } else {
+        // The quantiles of the unique values, ending with the maximum value.
+        for (int i = 1; i <= max_bin; ++i) {
+          float cut = values[i * num_unique / max_bin - 1];
+          if (cuts.empty() || cuts.back() < cut) {
+            cuts.push_back(cut);
+          }
+        }
+      }
+      for (int64_t row = 0; row < num_rows; ++row) {
+        float value = features_[row * num_features_ + f];
+        bins_[row * num_features_ + f] =
+            std::lower_bound(cuts.begin(), cuts.end(), value) - cuts.begin();
+      }
+    };
+    support::parallel_for_dynamic(0, num_features_, num_threads, f_feature);
+  }
+
+  /*!
+   * \brief Grow trees upon the ensemble
+   * \param num_rounds The number of trees to be grown
+   * \param num_threads The number of threads
+   */
+  void Train(int num_rounds, int num_threads) {
+    BuildBins(num_threads);
+    int64_t num_rows = NumRows();
+    std::vector<double> labels(sample_cost_.size());
+    for (size_t i = 0; i < sample_cost_.size(); ++i) {
+      labels[i] = group_min_cost_[sample_group_[i]] / sample_cost_[i];
+    }
+    std::vector<double> grad(num_rows);
+    std::vector<double> hess(num_rows);
+    std::vector<double> row_out(num_rows);
+    for (int round = 0; round < num_rounds; ++round) {
+      // The gradient and the hessian of the weighted square error in the pack-sum format.
+      for (int64_t row = 0; row < num_rows; ++row) {
+        int32_t sample = row_sample_[row];
+        grad[row] = (sample_pred_[sample] - labels[sample]) * labels[sample];
+        hess[row] = labels[sample];
+      }
+      std::vector<int32_t> rows(num_rows);
+      std::iota(rows.begin(), rows.end(), 0);
+      GBDTTree tree;
+      BuildNode(&tree, std::move(rows), 0, grad, hess, &row_out, num_threads);
+      for (int64_t row = 0; row < num_rows; ++row) {
+        sample_pred_[row_sample_[row]] += row_out[row];
+      }
+      trees_.push_back(std::move(tree));
+    }
+  }
+
+  /*!
+   * \brief Grow a node of a tree, and the subtree under it
+   * \param tree The tree
+   * \param rows The training rows falling into the node
+   * \param depth The depth of the node
+   * \param grad The gradient of each row
+   * \param hess The hessian of each row
+   * \param row_out The output of the leaf each row falls into
+   * \param num_threads The number of threads
+   * \return The index of the node
+   */
+  int32_t BuildNode(GBDTTree* tree, std::vector<int32_t> rows, int depth,
+                    const std::vector<double>& grad, const std::vector<double>& hess,
+                    std::vector<double>* row_out, int num_threads) {
+    double sum_grad = 0.0;
+    double sum_hess = 0.0;
+    for (int32_t row : rows) {
+      sum_grad += grad[row];
+      sum_hess += hess[row];
+    }
+    int32_t node = tree->AddNode();
+    Split split;
+    if (depth < max_depth && rows.size() > 1) {
+      split = FindSplit(rows, sum_grad, sum_hess, grad, hess, num_threads);
+    }
+    if (split.feature < 0) {
+      double value = -sum_grad / (sum_hess + reg_lambda) * learning_rate;
+      tree->value[node] = value;
+      for (int32_t row : rows) {
+        (*row_out)[row] = value;
+      }
+      return node;
+    }
+    std::vector<int32_t> left_rows;
+    std::vector<int32_t> right_rows;
+    for (int32_t row : rows) {
+      if (bins_[static_cast<int64_t>(row) * num_features_ + split.feature] <= split.bin) {
+        left_rows.push_back(row);
+      } else {
+        right_rows.push_back(row);
+      }
+    }
+    rows.clear();
+    rows.shrink_to_fit();
+    tree->feature[node] = split.feature;
+    tree->threshold[node] = cuts_[split.feature][split.bin];
+    int32_t left = BuildNode(tree, std::move(left_rows), depth + 1, grad, hess, row_out,  //
+                             num_threads);
+    tree->left[node] = left;
+    int32_t right = BuildNode(tree, std::move(right_rows), depth + 1, grad, hess, row_out,  //
+                              num_threads);
+    tree->right[node] = right;
+    return node;
+  }
+
+  /*!
+   * \brief Find the split of the largest gain of a node from the histograms of the features
+   * \return The best split, whose feature is -1 if no split has a positive gain
+   */
+  Split FindSplit(const std::vector<int32_t>& rows, double sum_grad, double sum_hess,
+                  const std::vector<double>& grad, const std::vector<double>& hess,
+                  int num_threads) const {
+    constexpr int64_t kMinParallelWork = 1 << 16;
+    std::vector<Split> splits(num_features_);
+    double parent_score = sum_grad * sum_grad / (sum_hess + reg_lambda);
+    auto f_feature = [&](int thread_id, int f) -> void {
+      int num_bins = cuts_[f].size();
+      if (num_bins < 2) {
+        return;
+      }
+      std::vector<double> hist_grad(num_bins, 0.0);
+      std::vector<double> hist_hess(num_bins, 0.0);
+      for (int32_t row : rows) {
+        int bin = bins_[static_cast<int64_t>(row) * num_features_ + f];
+        hist_grad[bin] += grad[row];
+        hist_hess[bin] += hess[row];
+      }
+      double left_grad = 0.0;
+      double left_hess = 0.0;
+      for (int bin = 0; bin + 1 < num_bins; ++bin) {
+        left_grad += hist_grad[bin];
+        left_hess += hist_hess[bin];
+        double right_grad = sum_grad - left_grad;
+        double right_hess = sum_hess - left_hess;
+        if (left_hess < min_child_weight || right_hess < min_child_weight) {
+          continue;
+        }
+        double gain = left_grad * left_grad / (left_hess + reg_lambda) +
+                      right_grad * right_grad / (right_hess + reg_lambda) - parent_score;
+        if (gain > splits[f].gain) {
+          splits[f] = Split{f, bin, gain};
+        }
+      }
+    };
+    if (num_threads > 1 && static_cast<int64_t>(rows.size()) * num_features_ >= kMinParallelWork) {
+      support::parallel_for_dynamic(0, num_features_, num_threads, f_feature);
+    } else {
+      for (int f = 0; f < num_features_; ++f) {
+        f_feature(0, f);
+      }
+    }
+    // Reduce in the order of the features, so that the tree does not depend on the scheduling.
+    Split best;
+    best.gain = kMinGain;
+    for (const Split& split : splits) {
+      if (split.feature >= 0 && split.gain > best.gain) {
+        best = split;
+      }
+    }
+    return best;
+  }
+
+  /*! \brief The magic number of the saved files. */
+  static constexpr uint64_t kMagic = 0x4742445444454C31;
+  /*! \brief The minimum gain of a split. */
+  static constexpr double kMinGain = 1e-12;
+
+  /*! \brief The random state of the predictions before the warmup. */
+  TRandState rand_state_;
+  /*! \brief The length of the feature vectors, or -1 before any update. */
+  int64_t num_features_ = -1;
+  /*! \brief The row-major feature vectors of the blocks of the training samples. */
+  std::vector<float> features_;
+  /*! \brief The training sample each row belongs to. */
+  std::vector<int32_t> row_sample_;
+  /*! \brief The workload group of each training sample. */
+  std::vector<int32_t> sample_group_;
+  /*! \brief The cost of each training sample. */
+  std::vector<double> sample_cost_;
+  /*! \brief The prediction of the ensemble on each training sample. */
+  std::vector<double> sample_pred_;
+  /*! \brief The structural hash of the workload of each group. */
+  std::vector<std::string> group_hashes_;
+  /*! \brief The minimum cost of each group. */
+  std::vector<double> group_min_cost_;
+  /*! \brief The map from the structural hash of a workload to its group. */
+  std::unordered_map<std::string, int32_t> group_index_;
+  /*! \brief The trees of the ensemble. */
+  std::vector<GBDTTree> trees_;
+  /*! \brief The histogram cuts of each feature. */
+  std::vector<std::vector<float>> cuts_;
+  /*! \brief The row-major histogram bins of the training data. */
+  std::vector<uint8_t> bins_;
+};
+
+CostModel CostModel::GBDTModel(FeatureExtractor extractor, int num_warmup_samples,
+                               int num_trees_per_update, int max_num_trees, int max_depth,
+                               double learning_rate, double min_child_weight, double reg_lambda,
+                               int max_bin, support::LinearCongruentialEngine::TRandState seed) {
+  CHECK_GT(num_trees_per_update, 0) << "ValueError: `num_trees_per_update` must be positive";
+  CHECK_GE(max_num_trees, num_trees_per_update)
+      << "ValueError: `max_num_trees` must be no less than `num_trees_per_update`";
+  CHECK(max_bin >= 2 && max_bin <= 256) << "ValueError: `max_bin` must be in [2, 256]";
+  ObjectPtr<GBDTModelNode> n = make_object<GBDTModelNode>();
+  n->extractor = std::move(extractor);
+  n->num_warmup_samples = num_warmup_samples;
+  n->num_trees_per_update = num_trees_per_update;
+  n->max_num_trees = max_num_trees;
+  n->max_depth = max_depth;
+  n->learning_rate = learning_rate;
+  n->min_child_weight = min_child_weight;
+  n->reg_lambda = reg_lambda;
+  n->max_bin = max_bin;
+  n->rand_state_ = support::LinearCongruentialEngine::NormalizeSeed(seed);
+  return CostModel(n);
+}
+
+TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
+    .set_dispatch<GBDTModelNode>([](const ObjectRef& n, ReprPrinter* p) {
+      const auto* self = n.as<GBDTModelNode>();
+      ICHECK(self);
+      p->stream << "GBDTModel(num_trees=" << self->NumTrees()
+                << ", num_samples=" << self->NumSamples() << ")";
+    });
+
+TVM_REGISTER_NODE_TYPE(GBDTModelNode);
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelGBDTModel").set_body_typed(CostModel::GBDTModel);
+TVM_REGISTER_GLOBAL("meta_schedule.GBDTModelNumTrees")
+    .set_body_typed([](CostModel model) -> int64_t {
+      const auto* node = model.as<GBDTModelNode>();
+      CHECK(node) << "TypeError: Expect GBDTModel, but gets: " << model->GetTypeKey();
+      return node->NumTrees();
+    });
+
+}  // namespace meta_schedule
+}  // namespace tvm
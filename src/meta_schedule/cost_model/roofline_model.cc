@@ -0,0 +1,247 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The statistics of a scheduled PrimFunc that bound its running time on a roofline. */
+struct RooflineStats {
+  /*! \brief The number of floating point operations. */
+  double flops = 0.0;
+  /*! \brief The bytes accessed in each storage scope. */
+  std::unordered_map<std::string, double> bytes;
+  /*! \brief The maximum number of parallel iterations of a loop nest. */
+  double parallelism = 1.0;
+};
+
+/*!
+ * \brief Count the bytes accessed in each storage scope and the parallelism of the loop nests. An
+ * access is counted once per iteration of its enclosing loops, so that the traffic of a buffer is
+ * reduced by the caching stages of the schedule.
+ */
+class RooflineStatsCollector : private tir::StmtExprVisitor {
+ public:
+  static void Collect(const tir::PrimFunc& func, RooflineStats* stats) {
+    RooflineStatsCollector collector(stats);
+    collector.VisitStmt(func->body);
+    stats->flops += tir::EstimateTIRFlops(func->body);
+  }
+
+ private:
+  explicit RooflineStatsCollector(RooflineStats* stats) : stats_(stats) {}
+
+  void VisitStmt_(const tir::ForNode* loop) final {
+    const auto* extent = loop->extent.as<IntImmNode>();
+    double trip_count = extent != nullptr ? std::max<int64_t>(extent->value, 1) : 1.0;
+    double outer_trip_count = trip_count_;
+    double outer_parallelism = parallelism_;
+    trip_count_ *= trip_count;
+    if (loop->kind == tir::ForKind::kParallel || loop->kind == tir::ForKind::kThreadBinding) {
+      parallelism_ *= trip_count;
+      stats_->parallelism = std::max(stats_->parallelism, parallelism_);
+    }
+    tir::StmtExprVisitor::VisitStmt_(loop);
+    trip_count_ = outer_trip_count;
+    parallelism_ = outer_parallelism;
+  }
+
+  void VisitStmt_(const tir::BlockNode* block) final {
+    // The init of a reduction runs once per its spatial iterations, which is negligible
+    VisitStmt(block->body);
+  }
+
+  void VisitStmt_(const tir::BufferStoreNode* store) final {
+    AddAccess(store->buffer, store->value.dtype());
+    tir::StmtExprVisitor::VisitStmt_(store);
+  }
+
+  void VisitExpr_(const tir::BufferLoadNode* load) final {
+    AddAccess(load->buffer, load->dtype);
+    tir::StmtExprVisitor::VisitExpr_(load);
+  }
+
+  void AddAccess(const tir::Buffer& buffer, const DataType& dtype) {
+    stats_->bytes[buffer.scope()] += trip_count_ * dtype.bytes() * dtype.lanes();
+  }
+
+  /*! \brief The statistics to be collected. */
+  RooflineStats* stats_;
+  /*! \brief The number of iterations of the enclosing loops. */
+  double trip_count_ = 1.0;
+  /*! \brief The number of parallel iterations of the enclosing loops. */
+  double parallelism_ = 1.0;
+};
+
+/*!
+ * \brief The analytical cost model, which bounds the running time of a candidate by its FLOPs and
+ * its memory traffic per storage scope against the peak throughputs of the target, so that it
+ * ranks the candidates sensibly without any training data.
+ * \details The estimated time of a candidate is the maximum of its compute time and of the memory
+ * time of each scope, divided by the fraction of the parallel units its loop nests occupy. The
+ * score of a candidate is the minimum estimated time of the candidates over its own.
+ *
+ * If a learned model is given, it is updated with the running results and its predictions are
+ * blended in, with a weight growing linearly to one with the number of samples it is updated with
+ * until `num_warmup_samples`, so that the roofline serves as a warm-start prior.
+ */
+class RooflineModelNode : public CostModelNode {
+ public:
+  /*! \brief The peak floating point operations per second of the target. */
+  double peak_flops;
+  /*! \brief The peak bytes per second of each storage scope, the others are not bound. */
+  Map<String, FloatImm> bandwidth;
+  /*! \brief The number of parallel units, e.g. the cores or the resident GPU threads. */
+  int num_cores;
+  /*! \brief The learned model blended in, if any. */
+  Optional<CostModel> base_model;
+  /*! \brief The number of samples after which only the learned model is used. */
+  int num_warmup_samples;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("peak_flops", &peak_flops);
+    v->Visit("bandwidth", &bandwidth);
+    v->Visit("num_cores", &num_cores);
+    v->Visit("base_model", &base_model);
+    v->Visit("num_warmup_samples", &num_warmup_samples);
+    // `num_samples_` is not visited
+  }
+
+  void Load(const String& path) final {
+    if (base_model.defined()) {
+      base_model.value()->Load(path);
+    }
+  }
+
+  void Save(const String& path) final {
+    if (base_model.defined()) {
+      base_model.value()->Save(path);
+    }
+  }
+
+  void Update(const TuneContext& context, const Array<MeasureCandidate>& candidates,
+              const Array<RunnerResult>& results) final {
+    if (base_model.defined()) {
+      base_model.value()->Update(context, candidates, results);
+      num_samples_ += candidates.size();
+    }
+  }
+
+  std::vector<double> Predict(const TuneContext& context,
+                              const Array<MeasureCandidate>& candidates) final {
+    int n = candidates.size();
+    std::vector<double> result(n, 0.0);
+    double min_time = std::numeric_limits<double>::max();
+    for (int i = 0; i < n; ++i) {
+      result[i] = EstimateTime(candidates[i]->sch->mod());
+      min_time = std::min(min_time, result[i]);
+    }
+    for (int i = 0; i < n; ++i) {
+      result[i] = result[i] > 0.0 ? min_time / result[i] : 1.0;
+    }
+    if (base_model.defined() && num_samples_ > 0) {
+      double weight = std::min(1.0, static_cast<double>(num_samples_) /
+                                        std::max(num_warmup_samples, 1));
+      std::vector<double> learned = base_model.value()->Predict(context, candidates);
+      ICHECK_EQ(learned.size(), result.size());
+      for (int i = 0; i < n; ++i) {
+        result[i] = (1.0 - weight) * result[i] + weight * learned[i];
+      }
+    }
+    return result;
+  }
+
+  /*! \brief The estimated running time of a scheduled module in seconds. */
+  double EstimateTime(const IRModule& mod) const {
+    double time = 0.0;
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+        RooflineStats stats;
+        RooflineStatsCollector::Collect(GetRef<tir::PrimFunc>(func), &stats);
+        double bound = stats.flops / peak_flops;
+        for (const auto& scope_bytes : stats.bytes) {
+          if (Optional<FloatImm> bw = FindBandwidth(scope_bytes.first)) {
+            bound = std::max(bound, scope_bytes.second / bw.value()->value);
+          }
+        }
+        double occupancy = std::min(stats.parallelism, static_cast<double>(num_cores)) / num_cores;
+        time += bound / occupancy;
+      }
+    }
+    return time;
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.RooflineModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RooflineModelNode, CostModelNode);
+
+ private:
+  /*! \brief The bandwidth of a scope, falling back to its base scope, e.g. "shared.dyn". */
+  Optional<FloatImm> FindBandwidth(const std::string& scope) const {
+    if (Optional<FloatImm> bw = bandwidth.Get(scope)) {
+      return bw;
+    }
+    size_t pos = scope.find('.');
+    if (pos != std::string::npos) {
+      return bandwidth.Get(scope.substr(0, pos));
+    }
+    return NullOpt;
+  }
+
+  /*! \brief The number of samples the learned model is updated with. */
+  int64_t num_samples_ = 0;
+};
+
+CostModel CostModel::RooflineModel(double peak_flops, Map<String, FloatImm> bandwidth,
+                                   int num_cores, Optional<CostModel> base_model,
+                                   int num_warmup_samples) {
+  CHECK_GT(peak_flops, 0.0) << "ValueError: `peak_flops` must be positive";
+  CHECK_GT(num_cores, 0) << "ValueError: `num_cores` must be positive";
+  for (const auto& kv : bandwidth) {
+    CHECK_GT(kv.second->value, 0.0)
+        << "ValueError: The bandwidth of the scope " << kv.first << " must be positive";
+  }
+  ObjectPtr<RooflineModelNode> n = make_object<RooflineModelNode>();
+  n->peak_flops = peak_flops;
+  n->bandwidth = std::move(bandwidth);
+  n->num_cores = num_cores;
+  n->base_model = std::move(base_model);
+  n->num_warmup_samples = num_warmup_samples;
+  return CostModel(n);
+}
+
+TVM_REGISTER_NODE_TYPE(RooflineModelNode);
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelRooflineModel")
+    .set_body_typed(CostModel::RooflineModel);
+TVM_REGISTER_GLOBAL("meta_schedule.RooflineModelEstimateTime")
+    .set_body_typed([](CostModel model, IRModule mod) -> double {
+      const auto* node = model.as<RooflineModelNode>();
+      CHECK(node) << "TypeError: Expect RooflineModel, but gets: " << model->GetTypeKey();
+      return node->EstimateTime(mod);
+    });
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -16,6 +16,10 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <vector>
@@ -160,34 +164,58 @@ class JSONTokenizer {
     if (st == cur_) {
       return false;
     }
-    std::string to_parse(st, cur_);
+    // The number is converted in place, which stops at `cur_`, because the text always ends with
+    // a character out of the number, e.g. the null terminator or the line break.
+    char* parsed_end = nullptr;
     if (!is_float) {
-      try {
-        *token = Token{TokenType::kInteger, IntImm(DataType::Int(64), std::stoll(to_parse))};
-      } catch (const std::invalid_argument& e) {
-        LOG(WARNING) << "ValueError: Invalid argument to std::stoll: " << to_parse
-                     << ". Details: " << e.what() << ". Switching to std::stod now.";
+      errno = 0;
+      int64_t value = std::strtoll(st, &parsed_end, 10);
+      if (parsed_end != cur_) {
+        LOG(WARNING) << "ValueError: Invalid argument to std::strtoll: " << std::string(st, cur_)
+                     << ". Switching to std::strtod now.";
         is_float = true;
-      } catch (const std::out_of_range& e) {
-        LOG(WARNING) << "ValueError: Out-of-range for std::stoll: " << to_parse
-                     << ". Details: " << e.what() << ". Switching to std::stod now.";
+      } else if (errno == ERANGE) {
+        LOG(WARNING) << "ValueError: Out-of-range for std::strtoll: " << std::string(st, cur_)
+                     << ". Switching to std::strtod now.";
         is_float = true;
+      } else {
+        *token = Token{TokenType::kInteger, MakeInteger(value)};
       }
     }
     if (is_float) {
-      try {
-        *token = Token{TokenType::kFloat, FloatImm(DataType::Float(64), std::stod(to_parse))};
-      } catch (const std::invalid_argument& e) {
-        LOG(INFO) << "ValueError: Invalid argument to std::stod: " << to_parse
-                  << ". Details: " << e.what();
-      } catch (const std::out_of_range& e) {
-        LOG(INFO) << "ValueError: Out-of-range for std::stod: " << to_parse
-                  << ". Details: " << e.what();
+      errno = 0;
+      double value = std::strtod(st, &parsed_end);
+      if (parsed_end != cur_) {
+        LOG(INFO) << "ValueError: Invalid argument to std::strtod: " << std::string(st, cur_);
+      } else if (errno == ERANGE) {
+        LOG(INFO) << "ValueError: Out-of-range for std::strtod: " << std::string(st, cur_);
+      } else {
+        *token = Token{TokenType::kFloat, FloatImm(DataType::Float(64), value)};
       }
     }
     return true;
   }
 
+  /*!
+   * \brief Make an integer, where the small ones, e.g. the decisions and the tile sizes making up
+   * most of the numbers in the traces, are shared instead of allocated one by one.
+   */
+  static IntImm MakeInteger(int64_t value) {
+    constexpr int64_t kNumShared = 1024;
+    static const std::vector<IntImm> shared = []() {
+      std::vector<IntImm> result;
+      result.reserve(kNumShared);
+      for (int64_t i = 0; i < kNumShared; ++i) {
+        result.push_back(IntImm(runtime::DataType::Int(64), i));
+      }
+      return result;
+    }();
+    if (0 <= value && value < kNumShared) {
+      return shared[value];
+    }
+    return IntImm(runtime::DataType::Int(64), value);
+  }
+
   bool NextString(Token* token) {
     if (cur_ == end_ || *cur_ != '"') return false;
     ++cur_;
@@ -389,5 +417,41 @@ ObjectRef JSONLoads(std::string str) {
   return JSONParser(st, ed).Get();
 }
 
+std::vector<ObjectRef> JSONLoadLines(const std::string& text, int num_threads) {
+  num_threads = std::max(num_threads, 1);
+  const char* begin = text.c_str();
+  int64_t size = text.length();
+  // Step 1. Find the line breaks in the chunks of the text in parallel
+  int64_t chunk_size = (size + num_threads - 1) / num_threads;
+  std::vector<std::vector<const char*>> line_ends(num_threads);
+  support::parallel_for_dynamic(0, num_threads, num_threads, [&](int thread_id, int task_id) {
+    const char* st = begin + std::min(size, task_id * chunk_size);
+    const char* ed = begin + std::min(size, (task_id + 1) * chunk_size);
+    for (const char* p = st; (p = static_cast<const char*>(std::memchr(p, '\n', ed - p)));
+         ++p) {
+      line_ends[task_id].push_back(p);
+    }
+  });
+  // Step 2. Collect the lines, where the last one is only kept if not empty, as `std::getline`
+  std::vector<std::pair<const char*, const char*>> lines;
+  const char* line_begin = begin;
+  for (const std::vector<const char*>& ends : line_ends) {
+    for (const char* line_end : ends) {
+      lines.emplace_back(line_begin, line_end);
+      line_begin = line_end + 1;
+    }
+  }
+  if (line_begin != begin + size) {
+    lines.emplace_back(line_begin, begin + size);
+  }
+  // Step 3. Parse the lines in parallel, in place in the text
+  int n = lines.size();
+  std::vector<ObjectRef> results(n);
+  support::parallel_for_dynamic(0, n, num_threads, [&](int thread_id, int task_id) {
+    results[task_id] = JSONParser(lines[task_id].first, lines[task_id].second).Get();
+  });
+  return results;
+}
+
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -0,0 +1,228 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <map>
+#include <unordered_map>
+
+#include "../module_equality.h"
+#include "../utils.h"
+#include "./record_log.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief A database on the indexed append-only logs of the workloads and the tuning records, which
+ * opens by reading the indices only, parses the records on demand, and is shared by the tuners
+ * appending to it at the same time. The tuning records are keyed by the positions of their
+ * workloads in the log, which are found by the module equality, not by the hash alone.
+ */
+class IndexedDatabaseNode : public DatabaseNode {
+ public:
+  explicit IndexedDatabaseNode(String mod_eq_name = "structural") : DatabaseNode(mod_eq_name) {}
+
+  /*! \brief The path prefix of the logs. */
+  String path;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path", &path);
+    // `workload_log_` is not visited
+    // `record_log_` is not visited
+    // `workloads_` is not visited
+    // `workload_ids_` is not visited
+    // `records_` is not visited
+    // `num_records_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.IndexedDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(IndexedDatabaseNode, DatabaseNode);
+
+ public:
+  /*! \brief A workload in the log, parsed on demand. */
+  struct WorkloadSlot {
+    RecordLog::Entry entry;
+    Workload workload{nullptr};
+  };
+  /*! \brief A tuning record in the log, parsed on demand. */
+  struct RecordSlot {
+    RecordLog::Entry entry;
+    TuningRecord record{nullptr};
+  };
+
+  /*! \brief The log of the workloads. */
+  std::unique_ptr<RecordLog> workload_log_;
+  /*! \brief The log of the tuning records. */
+  std::unique_ptr<RecordLog> record_log_;
+  /*! \brief The workloads in the order of the log. */
+  std::vector<WorkloadSlot> workloads_;
+  /*! \brief The positions of the workloads in the log by their hashes. */
+  std::unordered_map<uint64_t, std::vector<int64_t>> workload_ids_;
+  /*! \brief The tuning records by the positions of their workloads, sorted by the mean run time. */
+  std::unordered_map<int64_t, std::multimap<double, RecordSlot>> records_;
+  /*! \brief The number of the tuning records. */
+  int64_t num_records_ = 0;
+
+  bool HasWorkload(const IRModule& mod) {
+    return FindWorkload(mod, GetModuleEquality().Hash(mod)) >= 0;
+  }
+
+  Workload CommitWorkload(const IRModule& mod) {
+    size_t shash = GetModuleEquality().Hash(mod);
+    int64_t id = FindWorkload(mod, shash);
+    if (id < 0) {
+      Workload workload(mod, shash);
+      std::string json = JSONDumps(workload->AsJSON());
+      workload_log_->Append(shash, 0.0, json);
+      Sync();
+      // Find the slot just appended, which may come along with the ones appended by others
+      for (int64_t i : workload_ids_[shash]) {
+        WorkloadSlot& slot = workloads_[i];
+        if (!slot.workload.defined() && workload_log_->Read(slot.entry) == json) {
+          slot.workload = workload;
+          break;
+        }
+      }
+      // An equal workload appended by others before this one is used by all
+      id = FindWorkload(mod, shash);
+      ICHECK_GE(id, 0);
+    }
+    return workloads_[id].workload;
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) {
+    int64_t id = FindWorkload(record->workload->mod, record->workload->shash);
+    CHECK_GE(id, 0) << "ValueError: The workload of the tuning record is not committed to "
+                    << path;
+    record_log_->Append(id, SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({})),
+                        JSONDumps(record->AsJSON()));
+  }
+
+  Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    if (top_k == 0) {
+      return {};
+    }
+    int64_t id = FindWorkload(workload->mod, workload->shash);
+    Array<TuningRecord> results;
+    auto it = records_.find(id);
+    if (id < 0 || it == records_.end()) {
+      return results;
+    }
+    results.reserve(top_k);
+    for (auto& kv : it->second) {
+      // The failed runs are sorted to the end
+      if (kv.first >= SortTuningRecordByMeanRunSecs::kMaxMeanTime) {
+        break;
+      }
+      results.push_back(GetRecord(&kv.second, workload));
+      if (static_cast<int>(results.size()) == top_k) {
+        break;
+      }
+    }
+    return results;
+  }
+
+  Array<TuningRecord> GetAllTuningRecords() {
+    Sync();
+    Array<TuningRecord> results;
+    results.reserve(num_records_);
+    for (auto& kv : records_) {
+      CHECK_LT(static_cast<size_t>(kv.first), workloads_.size())
+          << "ValueError: The workload of the tuning records is not found in " << path
+          << ", whose position is " << kv.first;
+      const Workload& workload = ParseWorkload(&workloads_[kv.first]);
+      for (auto& record : kv.second) {
+        results.push_back(GetRecord(&record.second, workload));
+      }
+    }
+    return results;
+  }
+
+  int64_t Size() {
+    Sync();
+    return num_records_;
+  }
+
+ private:
+  /*!
+   * \brief Index the entries appended since the last sync. The tuning records are synced first, so
+   * that the workloads they refer to, which are appended before them, are synced along.
+   */
+  void Sync() {
+    for (const RecordLog::Entry& entry : record_log_->Sync()) {
+      records_[entry.key].emplace(entry.score, RecordSlot{entry});
+      ++num_records_;
+    }
+    for (const RecordLog::Entry& entry : workload_log_->Sync()) {
+      workload_ids_[entry.key].push_back(workloads_.size());
+      workloads_.push_back(WorkloadSlot{entry});
+    }
+  }
+
+  /*! \brief Parse the workload of a slot if it is not parsed yet. */
+  const Workload& ParseWorkload(WorkloadSlot* slot) {
+    if (!slot->workload.defined()) {
+      slot->workload = Workload::FromJSON(JSONLoads(workload_log_->Read(slot->entry)));
+    }
+    return slot->workload;
+  }
+
+  /*!
+   * \brief Find the first workload in the log equal to a module.
+   * \return The position of the workload in the log, or -1 if it is not found.
+   */
+  int64_t FindWorkload(const IRModule& mod, size_t shash) {
+    Sync();
+    auto it = workload_ids_.find(shash);
+    if (it == workload_ids_.end()) {
+      return -1;
+    }
+    for (int64_t id : it->second) {
+      const Workload& workload = ParseWorkload(&workloads_[id]);
+      if (workload->mod.same_as(mod) || GetModuleEquality().Equal(workload->mod, mod)) {
+        return id;
+      }
+    }
+    return -1;
+  }
+
+  /*! \brief Parse the tuning record of a slot if it is not parsed yet. */
+  TuningRecord GetRecord(RecordSlot* slot, const Workload& workload) {
+    if (!slot->record.defined()) {
+      slot->record = TuningRecord::FromJSON(JSONLoads(record_log_->Read(slot->entry)), workload);
+    }
+    return slot->record;
+  }
+};
+
+Database Database::IndexedDatabase(String path, int num_shards, bool allow_missing,
+                                   String mod_eq_name) {
+  ObjectPtr<IndexedDatabaseNode> n = make_object<IndexedDatabaseNode>(mod_eq_name);
+  n->path = path;
+  n->workload_log_ = std::make_unique<RecordLog>(path + "_workload", 1, allow_missing);
+  n->record_log_ =
+      std::make_unique<RecordLog>(path + "_tuning_record", num_shards, allow_missing);
+  return Database(n);
+}
+
+TVM_REGISTER_NODE_TYPE(IndexedDatabaseNode);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseIndexedDatabase")
+    .set_body_typed(Database::IndexedDatabase);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -34,19 +34,16 @@ namespace meta_schedule {
  * \return An array containing lines read from the json file.
  */
 std::vector<ObjectRef> JSONFileReadLines(const String& path, int num_threads, bool allow_missing) {
-  std::ifstream is(path);
+  std::ifstream is(path, std::ifstream::binary);
   if (is.good()) {
-    std::vector<String> json_strs;
-    for (std::string str; std::getline(is, str);) {
-      json_strs.push_back(str);
-    }
-    int n = json_strs.size();
-    std::vector<ObjectRef> json_objs;
-    json_objs.resize(n);
-    support::parallel_for_dynamic(0, n, num_threads, [&](int thread_id, int task_id) {
-      json_objs[task_id] = JSONLoads(json_strs[task_id]);
-    });
-    return json_objs;
+    // Read the file at once, and split it into lines and parse them in parallel
+    std::string text;
+    is.seekg(0, std::ios::end);
+    text.resize(is.tellg());
+    is.seekg(0, std::ios::beg);
+    is.read(&text[0], text.size());
+    CHECK(is.good()) << "ValueError: Cannot read the file: " << path;
+    return JSONLoadLines(text, num_threads);
   }
   CHECK(allow_missing) << "ValueError: File doesn't exist: " << path;
   std::ofstream os(path);
@@ -161,15 +158,18 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
     std::vector<ObjectRef> json_objs = JSONFileReadLines(path_workload, num_threads, allow_missing);
     int n_objs = json_objs.size();
     n->workloads2idx_.reserve(n_objs);
-    workloads.reserve(n_objs);
-    for (int i = 0; i < n_objs; ++i) {
-      Workload workload = Workload::FromJSON(json_objs[i]);
+    workloads.resize(n_objs, Workload{nullptr});
+    // Decoding the modules and recalculating their hashes dominate loading the workloads
+    support::parallel_for_dynamic(0, n_objs, num_threads, [&](int thread_id, int task_id) {
+      Workload workload = Workload::FromJSON(json_objs[task_id]);
       auto recalc_hash = n->GetModuleEquality().Hash(workload->mod);
       CHECK_EQ(recalc_hash, workload->shash)
           << "ValueError: Module hash changed. Given: " << workload->shash
           << "; Recalculated: " << recalc_hash;
-      n->workloads2idx_.emplace(workload, i);
-      workloads.push_back(workload);
+      workloads[task_id] = workload;
+    });
+    for (int i = 0; i < n_objs; ++i) {
+      n->workloads2idx_.emplace(workloads[i], i);
     }
   }
   // Load `n->tuning_records_` from `path_tuning_record`
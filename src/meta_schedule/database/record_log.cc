@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "record_log.h"
+
+#include <dmlc/logging.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <utility>
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The byte size of an index entry on disk: key, score, offset and length. */
+static constexpr int kEntrySize = 8 + 8 + 8 + 4;
+
+/*! \brief An exclusive lock of a file across processes, held in its scope. */
+class FileLock {
+ public:
+  explicit FileLock(const std::string& path) {
+#ifndef _WIN32
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    CHECK_GE(fd_, 0) << "ValueError: Cannot open the file to lock: " << path;
+    CHECK_EQ(flock(fd_, LOCK_EX), 0) << "ValueError: Cannot lock the file: " << path;
+#endif
+  }
+
+  ~FileLock() {
+#ifndef _WIN32
+    flock(fd_, LOCK_UN);
+    close(fd_);
+#endif
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+RecordLog::RecordLog(std::string prefix, int num_shards, bool allow_missing)
+    : prefix_(std::move(prefix)) {
+  std::string path_shards = prefix_ + ".shards";
+  {
+    FileLock lock(path_shards);
+    std::ifstream is(path_shards);
+    if (is >> num_shards_) {
+      CHECK_GT(num_shards_, 0) << "ValueError: Invalid number of shards in " << path_shards;
+    } else {
+      CHECK(allow_missing) << "ValueError: File doesn't exist: " << path_shards;
+      CHECK_GT(num_shards, 0) << "ValueError: `num_shards` must be positive, but gets "
+                              << num_shards;
+      num_shards_ = num_shards;
+      std::ofstream os(path_shards, std::ofstream::trunc);
+      CHECK(os.good()) << "ValueError: Cannot create new file: " << path_shards;
+      os << num_shards_ << std::endl;
+    }
+  }
+  num_synced_.resize(num_shards_, 0);
+  readers_.resize(num_shards_);
+}
+
+std::string RecordLog::LogPath(int shard) const {
+  return prefix_ + "." + std::to_string(shard) + ".log";
+}
+
+std::string RecordLog::IndexPath(int shard) const {
+  return prefix_ + "." + std::to_string(shard) + ".idx";
+}
+
+void RecordLog::Append(uint64_t key, double score, const std::string& record) {
+  int shard = key % num_shards_;
+  FileLock lock(IndexPath(shard));
+  // Step 1. Append the record, whose offset is the end of the log since no one else is writing
+  std::ofstream log(LogPath(shard), std::ofstream::binary | std::ofstream::app);
+  CHECK(log.good()) << "ValueError: Cannot open the file to write: " << LogPath(shard);
+  log.seekp(0, std::ios::end);
+  uint64_t offset = log.tellp();
+  uint32_t length = record.size();
+  log << record << '\n';
+  log.flush();
+  CHECK(log.good()) << "ValueError: Cannot write to the file: " << LogPath(shard);
+  // Step 2. Append the index entry, only after the record is complete
+  char buffer[kEntrySize];
+  std::memcpy(buffer, &key, 8);
+  std::memcpy(buffer + 8, &score, 8);
+  std::memcpy(buffer + 16, &offset, 8);
+  std::memcpy(buffer + 24, &length, 4);
+  std::ofstream index(IndexPath(shard), std::ofstream::binary | std::ofstream::app);
+  CHECK(index.good()) << "ValueError: Cannot open the file to write: " << IndexPath(shard);
+  index.write(buffer, kEntrySize);
+  index.flush();
+  CHECK(index.good()) << "ValueError: Cannot write to the file: " << IndexPath(shard);
+}
+
+std::vector<RecordLog::Entry> RecordLog::Sync() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Entry> entries;
+  for (int shard = 0; shard < num_shards_; ++shard) {
+    std::ifstream index(IndexPath(shard), std::ifstream::binary);
+    if (!index.good()) {
+      continue;
+    }
+    index.seekg(num_synced_[shard] * kEntrySize);
+    // A partially written entry at the end is left for the next sync
+    for (char buffer[kEntrySize]; index.read(buffer, kEntrySize); ++num_synced_[shard]) {
+      Entry entry;
+      std::memcpy(&entry.key, buffer, 8);
+      std::memcpy(&entry.score, buffer + 8, 8);
+      std::memcpy(&entry.offset, buffer + 16, 8);
+      std::memcpy(&entry.length, buffer + 24, 4);
+      entry.shard = shard;
+      entries.push_back(entry);
+    }
+  }
+  return entries;
+}
+
+std::string RecordLog::Read(const Entry& entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<std::ifstream>& reader = readers_.at(entry.shard);
+  if (reader == nullptr) {
+    reader = std::make_unique<std::ifstream>(LogPath(entry.shard), std::ifstream::binary);
+    CHECK(reader->good()) << "ValueError: Cannot open the file to read: " << LogPath(entry.shard);
+  }
+  // The log may have grown since the last read hits its end
+  reader->clear();
+  reader->seekg(entry.offset);
+  std::string record(entry.length, '\0');
+  reader->read(&record[0], entry.length);
+  CHECK(reader->good()) << "ValueError: Cannot read the record at offset " << entry.offset
+                        << " of " << LogPath(entry.shard);
+  return record;
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_META_SCHEDULE_DATABASE_RECORD_LOG_H_
+#define TVM_META_SCHEDULE_DATABASE_RECORD_LOG_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief An append-only log of serialized records, sharded by the keys of the records, with an
+ * index of fixed-size entries locating each record in its shard. Opening a log reads nothing but
+ * the index, and the records are read on demand.
+ *
+ * Multiple processes may append to the same log at the same time. An append holds an exclusive
+ * lock of the shard and writes the record before its index entry, so that an entry always refers
+ * to a complete record, and the entries appended by the other processes show up in `Sync`.
+ *
+ * The files of a log with the prefix `<prefix>` are
+ *  - `<prefix>.shards`: the number of shards;
+ *  - `<prefix>.<shard>.log`: the records of a shard, one per line;
+ *  - `<prefix>.<shard>.idx`: the index entries of a shard, one per record.
+ */
+class RecordLog {
+ public:
+  /*! \brief An entry of the index. */
+  struct Entry {
+    /*! \brief The key of the record, which decides its shard. */
+    uint64_t key;
+    /*! \brief The score of the record, e.g. its mean run time, to sort the records by. */
+    double score;
+    /*! \brief The shard of the record. */
+    int shard;
+    /*! \brief The byte offset of the record in the log of the shard. */
+    uint64_t offset;
+    /*! \brief The byte length of the record. */
+    uint32_t length;
+  };
+
+  /*!
+   * \brief Open a log, or create it.
+   * \param prefix The prefix of the files of the log.
+   * \param num_shards The number of shards of a new log. An existing log keeps its own.
+   * \param allow_missing Whether to create the log if it does not exist.
+   */
+  explicit RecordLog(std::string prefix, int num_shards, bool allow_missing);
+
+  /*!
+   * \brief Append a record to the log.
+   * \param key The key of the record.
+   * \param score The score of the record.
+   * \param record The serialized record, which must not contain a newline.
+   */
+  void Append(uint64_t key, double score, const std::string& record);
+  /*!
+   * \brief Read the index entries appended since the last sync, by this process or the others.
+   * \return The new entries, in the order of appending within each shard.
+   */
+  std::vector<Entry> Sync();
+  /*!
+   * \brief Read a record.
+   * \param entry The index entry of the record.
+   * \return The serialized record.
+   */
+  std::string Read(const Entry& entry);
+
+  /*! \brief The number of shards. */
+  int num_shards() const { return num_shards_; }
+
+ private:
+  std::string LogPath(int shard) const;
+  std::string IndexPath(int shard) const;
+
+  /*! \brief The prefix of the files. */
+  std::string prefix_;
+  /*! \brief The number of shards. */
+  int num_shards_;
+  /*! \brief The number of the index entries of each shard already synced. */
+  std::vector<uint64_t> num_synced_;
+  /*! \brief The readers of the logs of the shards, opened on demand. */
+  std::vector<std::unique_ptr<std::ifstream>> readers_;
+  /*! \brief The mutex guarding the sync and the readers. */
+  std::mutex mutex_;
+};
+
+}  // namespace meta_schedule
+}  // namespace tvm
+
+#endif  // TVM_META_SCHEDULE_DATABASE_RECORD_LOG_H_
@@ -18,8 +18,11 @@
  */
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <cmath>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -1358,14 +1361,21 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
   int cache_line_bytes;
   bool extract_workload;
   int feature_vector_length;
+  int feature_cache_size;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("buffers_per_store", &buffers_per_store);
     v->Visit("arith_intensity_curve_num_samples", &arith_intensity_curve_num_samples);
     v->Visit("cache_line_bytes", &cache_line_bytes);
     v->Visit("feature_vector_length", &feature_vector_length);
+    v->Visit("feature_cache_size", &feature_cache_size);
+    // `cache_` is not visited
+    // `cache_order_` is not visited
+    // `cache_mutex_` is not visited
   }
 
+  using Features = std::vector<std::vector<double>>;
+
   void ExtractSingle(IRModule mod, bool is_gpu, std::vector<std::vector<double>>* results) {
     static transform::Sequential passes = tir::transform::PassListForPerStoreFeature();
     mod = passes(std::move(mod));
@@ -1396,8 +1406,19 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     }
     auto f = [this, is_gpu, &feature_group6, &candidates, &results](int, int task_id) -> void {
       const auto& candidate = candidates[task_id];
-      std::vector<std::vector<double>> features;
-      ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu, &features);
+      IRModule mod = candidate->sch->mod();
+      size_t hash = feature_cache_size > 0 ? StructuralHash()(mod) : 0;
+      std::shared_ptr<const Features> cached =
+          feature_cache_size > 0 ? LookupCache(hash, mod, is_gpu) : nullptr;
+      Features features;
+      if (cached != nullptr) {
+        features = *cached;
+      } else {
+        ExtractSingle(DeepCopyIRModule(mod), is_gpu, &features);
+        if (feature_cache_size > 0) {
+          InsertCache(hash, mod, is_gpu, features);
+        }
+      }
       if (extract_workload) {
         for (auto& feature : features) {
           feature_group6->Export(&feature);
@@ -1411,16 +1432,87 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
 
   static constexpr const char* _type_key = "meta_schedule.PerStoreFeature";
   TVM_DECLARE_FINAL_OBJECT_INFO(PerStoreFeatureNode, FeatureExtractorNode);
+
+ private:
+  /*! \brief An entry of the feature cache. */
+  struct CacheEntry {
+    /*! \brief The scheduled module the features are extracted from. */
+    IRModule mod;
+    /*! \brief Whether the features are extracted for GPU. */
+    bool is_gpu;
+    /*! \brief The features, before the workload features are appended. */
+    std::shared_ptr<const Features> features;
+  };
+
+  /*!
+   * \brief Look up the features of a scheduled module extracted before
+   * \param hash The structural hash of the module
+   * \param mod The scheduled module
+   * \param is_gpu Whether the features are extracted for GPU
+   * \return The cached features, or nullptr if not found
+   * \note The structural equality is checked outside of the lock, since it may be expensive.
+   */
+  std::shared_ptr<const Features> LookupCache(size_t hash, const IRModule& mod, bool is_gpu) {
+    std::vector<CacheEntry> entries;
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      auto it = cache_.find(hash);
+      if (it == cache_.end()) {
+        return nullptr;
+      }
+      entries = it->second;
+    }
+    for (const CacheEntry& entry : entries) {
+      if (entry.is_gpu == is_gpu && StructuralEqual()(entry.mod, mod)) {
+        return entry.features;
+      }
+    }
+    return nullptr;
+  }
+
+  /*!
+   * \brief Cache the features of a scheduled module, evicting the oldest entry if the cache is full
+   * \param hash The structural hash of the module
+   * \param mod The scheduled module
+   * \param is_gpu Whether the features are extracted for GPU
+   * \param features The features extracted
+   */
+  void InsertCache(size_t hash, const IRModule& mod, bool is_gpu, const Features& features) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[hash].push_back(CacheEntry{mod, is_gpu, std::make_shared<const Features>(features)});
+    cache_order_.emplace_back(hash, mod);
+    while (static_cast<int>(cache_order_.size()) > feature_cache_size) {
+      auto it = cache_.find(cache_order_.front().first);
+      const IRModule& evicted = cache_order_.front().second;
+      std::vector<CacheEntry>& entries = it->second;
+      entries.erase(std::find_if(entries.begin(), entries.end(),
+                                 [&](const CacheEntry& e) { return e.mod.same_as(evicted); }));
+      if (entries.empty()) {
+        cache_.erase(it);
+      }
+      cache_order_.pop_front();
+    }
+  }
+
+  /*! \brief The cached features by the structural hash of the scheduled modules. */
+  std::unordered_map<size_t, std::vector<CacheEntry>> cache_;
+  /*! \brief The cached modules in the order of insertion. */
+  std::deque<std::pair<size_t, IRModule>> cache_order_;
+  /*! \brief The mutex guarding the cache. */
+  std::mutex cache_mutex_;
 };
 
 FeatureExtractor FeatureExtractor::PerStoreFeature(int buffers_per_store,
                                                    int arith_intensity_curve_num_samples,
-                                                   int cache_line_bytes, bool extract_workload) {
+                                                   int cache_line_bytes, bool extract_workload,
+                                                   int feature_cache_size) {
+  CHECK_GE(feature_cache_size, 0) << "ValueError: `feature_cache_size` must be non-negative";
   ObjectPtr<PerStoreFeatureNode> n = make_object<PerStoreFeatureNode>();
   n->buffers_per_store = buffers_per_store;
   n->arith_intensity_curve_num_samples = arith_intensity_curve_num_samples;
   n->cache_line_bytes = cache_line_bytes;
   n->extract_workload = extract_workload;
+  n->feature_cache_size = feature_cache_size;
   n->feature_vector_length = tir::group1::Feature::kCount +                                  //
                              tir::group2::Feature::SubFeature::kCount * buffers_per_store +  //
                              arith_intensity_curve_num_samples +                             //
@@ -22,7 +22,11 @@
 #include <tvm/node/structural_equal.h>
 #include <tvm/node/structural_hash.h>
 #include <tvm/tir/analysis.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <cmath>
+#include <limits>
 #include <memory>
 
 #include "../node/ndarray_hash_equal.h"
@@ -107,5 +111,52 @@ std::unique_ptr<ModuleEquality> ModuleEquality::Create(const std::string& mod_eq
   return nullptr;
 }
 
+// The integer constants are hashed by their dtypes only, which erases the shapes of the buffers,
+// the extents of the loops and the constant offsets of the indices.
+class SHashHandlerIgnoreIntImm : public SHashHandlerIgnoreNDArray {
+ protected:
+  void DispatchSHash(const ObjectRef& object, bool map_free_vars) override {
+    ICHECK(object.defined());
+    if (const auto* imm = object.as<IntImmNode>()) {
+      SHashReducer hash_reduce(this, map_free_vars);
+      hash_reduce(imm->dtype);
+    } else {
+      SHashHandlerIgnoreNDArray::DispatchSHash(object, map_free_vars);
+    }
+  }
+};
+
+WorkloadShape WorkloadShape::FromModule(const IRModule& mod) {
+  WorkloadShape shape;
+  shape.structure_hash = SHashHandlerIgnoreIntImm().Hash(mod, false);
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+      tir::PreOrderVisit(func->body, [&shape](const ObjectRef& obj) -> bool {
+        if (const auto* loop = obj.as<tir::ForNode>()) {
+          const auto* extent = loop->extent.as<IntImmNode>();
+          shape.loop_extents.push_back(extent ? extent->value : 1);
+        }
+        return true;
+      });
+    }
+  }
+  return shape;
+}
+
+double WorkloadShape::Distance(const WorkloadShape& other) const {
+  if (structure_hash != other.structure_hash || loop_extents.size() != other.loop_extents.size()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  if (loop_extents.empty()) {
+    return 0.0;
+  }
+  double dist = 0.0;
+  for (size_t i = 0; i < loop_extents.size(); ++i) {
+    dist += std::abs(std::log(std::max<int64_t>(loop_extents[i], 1)) -
+                     std::log(std::max<int64_t>(other.loop_extents[i], 1)));
+  }
+  return dist / loop_extents.size();
+}
+
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -23,6 +23,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace tvm {
 namespace meta_schedule {
@@ -73,6 +74,26 @@ class ModuleEqual {
   const ModuleEquality& mod_eq_;
 };
 
+/*!
+ * \brief The shape of a workload, used to find the workloads of the same computation but of
+ * different shapes, e.g. GEMMs of different sizes.
+ */
+struct WorkloadShape {
+  /*! \brief The structural hash of the workload regardless of its integer constants. */
+  size_t structure_hash;
+  /*! \brief The constant extents of the loops, in pre-order. */
+  std::vector<int64_t> loop_extents;
+
+  /*! \brief Extract the shape of a workload. */
+  static WorkloadShape FromModule(const IRModule& mod);
+  /*!
+   * \brief The distance between the shapes of two workloads.
+   * \return The mean absolute log ratio of the loop extents, or infinity if the two workloads do
+   * not have the same structure.
+   */
+  double Distance(const WorkloadShape& other) const;
+};
+
 }  // namespace meta_schedule
 }  // namespace tvm
 
@@ -43,6 +43,8 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
     }
     max_threads_per_block = opt_max_threads_per_block.value_or(Integer(-1))->value;
     warp_size = opt_warp_size.value_or(Integer(-1))->value;
+    // LowerThreadAllreduce reduces across the blocks of a grid on CUDA only.
+    cross_block_reduction = target->kind->name == "cuda";
   }
 
   // Inherited from ScheduleRuleNode
@@ -110,6 +112,13 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
         tmp_sch->Split(fused_reduce_loop, {NullOpt, thread_extent});
     tmp_sch->Bind(split_res[1], "threadIdx.x");
 
+    // Step 6. A long reduction of a few rows leaves most of the device idle in one block per
+    // row, so also try reducing each row across the blocks of a grid in one kernel.
+    if (!fusible && cross_block_reduction) {
+      if (Optional<tir::Schedule> grid_sch = TryCrossBlockReduction(sch, block_rv)) {
+        return {tmp_sch, grid_sch.value(), sch};
+      }
+    }
     return {tmp_sch, sch};
   }
 
@@ -120,6 +129,57 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
   }
 
  private:
+  /*! \brief The minimum extent of a reduction to be reduced across the blocks of a grid. */
+  static constexpr int64_t kMinCrossBlockReduceExtent = 16384;
+  /*! \brief The maximum spatial extent of a reduction to be reduced across the blocks of a grid. */
+  static constexpr int64_t kMaxCrossBlockSpatialExtent = 64;
+
+  /*!
+   * \brief Reduce a block across the blocks of a grid, binding the outer part of its fused
+   * reduction loop to blockIdx.y, the inner part to threadIdx.x, and its fused spatial loops to
+   * blockIdx.x.
+   * \param sch The TensorIR schedule
+   * \param block_rv The block to be reduced
+   * \return The new schedule, or NullOpt if the reduction is not long enough or has too many rows.
+   */
+  Optional<tir::Schedule> TryCrossBlockReduction(const tir::Schedule& sch,
+                                                 const tir::BlockRV& block_rv) {
+    tir::Schedule grid_sch = sch->Copy();
+    grid_sch->Seed(sch->ForkSeed());
+    size_t num_spatial_loops;
+    tir::LoopRV fused_reduce_loop;
+    ReorderAndFuseReductionLoops(grid_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+    Array<tir::LoopRV> loops = grid_sch->GetLoops(block_rv);
+    int64_t spatial_extent = 1;
+    for (size_t i = 0; i < num_spatial_loops; ++i) {
+      const int64_t* extent = tir::GetLoopIntExtent(grid_sch->Get(loops[i]).get());
+      if (extent == nullptr) {
+        return NullOpt;
+      }
+      spatial_extent *= *extent;
+    }
+    const int64_t* reduce_extent = tir::GetLoopIntExtent(grid_sch->Get(fused_reduce_loop).get());
+    if (reduce_extent == nullptr || *reduce_extent < kMinCrossBlockReduceExtent ||
+        spatial_extent > kMaxCrossBlockSpatialExtent) {
+      return NullOpt;
+    }
+    int n_candidate = static_cast<int>(thread_extents.size());
+    Array<FloatImm> probs(n_candidate, FloatImm(DataType::Float(64), 1.0 / n_candidate));
+    tir::ExprRV thread_extent = grid_sch->SampleCategorical(thread_extents, probs);
+    Array<Integer> block_extents{8, 16, 32};
+    Array<FloatImm> block_probs(block_extents.size(), FloatImm(DataType::Float(64), 1.0 / 3));
+    tir::ExprRV block_extent = grid_sch->SampleCategorical(block_extents, block_probs);
+    const Array<tir::LoopRV>& split_res =
+        grid_sch->Split(fused_reduce_loop, {block_extent, NullOpt, thread_extent});
+    grid_sch->Bind(split_res[0], "blockIdx.y");
+    grid_sch->Bind(split_res[2], "threadIdx.x");
+    if (num_spatial_loops > 0) {
+      Array<tir::LoopRV> spatial_loops(loops.begin(), loops.begin() + num_spatial_loops);
+      grid_sch->Bind(grid_sch->Fuse(spatial_loops), "blockIdx.x");
+    }
+    return grid_sch;
+  }
+
   /*!
    * \brief Check whether the input block is in thread scope, i.e., some of its outer loop is
    * bound to threadIdx.
@@ -268,11 +328,14 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
   int warp_size;
   /*! \brief Candidates of thread axis extent (values are required to be positive). */
   Array<Integer> thread_extents;
+  /*! \brief Whether the target supports the reduction across the blocks of a grid */
+  bool cross_block_reduction = false;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("max_threads_per_block", &max_threads_per_block);
     v->Visit("warp_size", &warp_size);
     v->Visit("thread_extents", &thread_extents);
+    v->Visit("cross_block_reduction", &cross_block_reduction);
   }
 
   static constexpr const char* _type_key = "meta_schedule.CrossThreadReduction";
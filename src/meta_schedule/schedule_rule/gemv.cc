@@ -0,0 +1,280 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../../tir/schedule/analysis.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+using tir::BlockRV;
+using tir::LoopRV;
+using tir::Schedule;
+
+/*!
+ * \brief The reads of a GEMV-like block to be loaded in vectors, i.e. those whose innermost axis
+ * is indexed by a reduction iter. A block is GEMV-like if one of them is indexed by all the
+ * non-unit iters of the block, so that each of its elements is loaded exactly once and the block
+ * is bound by the memory bandwidth.
+ * \param block The block to be checked
+ * \return The indices of the reads, or nothing if the block is not GEMV-like.
+ */
+std::vector<int> GetGEMVVectorizedReads(const tir::Block& block) {
+  std::unordered_set<const tir::VarNode*> iter_vars;
+  std::unordered_set<const tir::VarNode*> reduce_vars;
+  bool has_spatial = false;
+  for (const tir::IterVar& iter : block->iter_vars) {
+    if (iter->iter_type != tir::kDataPar && iter->iter_type != tir::kCommReduce) {
+      return {};
+    }
+    if (tir::is_one(iter->dom->extent)) {
+      continue;
+    }
+    iter_vars.insert(iter->var.get());
+    if (iter->iter_type == tir::kCommReduce) {
+      reduce_vars.insert(iter->var.get());
+    } else {
+      has_spatial = true;
+    }
+  }
+  if (!has_spatial || reduce_vars.empty() || block->writes.size() != 1) {
+    return {};
+  }
+  const tir::Buffer& output = block->writes[0]->buffer;
+  std::vector<int> reads;
+  bool streamed = false;
+  for (int i = 0, n = block->reads.size(); i < n; ++i) {
+    const tir::BufferRegion& read = block->reads[i];
+    if (read->buffer.same_as(output) || read->region.empty() ||
+        !tir::UsesVar(read->region.back()->min,
+                      [&](const tir::VarNode* var) { return reduce_vars.count(var); })) {
+      continue;
+    }
+    reads.push_back(i);
+    std::unordered_set<const tir::VarNode*> used;
+    for (const Range& range : read->region) {
+      tir::PostOrderVisit(range->min, [&](const ObjectRef& obj) {
+        if (const auto* var = obj.as<tir::VarNode>()) {
+          if (iter_vars.count(var)) {
+            used.insert(var);
+          }
+        }
+      });
+    }
+    streamed |= used.size() == iter_vars.size();
+  }
+  if (!streamed) {
+    return {};
+  }
+  return reads;
+}
+
+/*!
+ * \brief A rule that schedules the GEMV-like reductions, e.g. the matrix-vector products of LLM
+ * decoding with their dequantization inlined, for the memory bandwidth: each row is reduced by
+ * the threadIdx.x lanes of a few warps, with the rows of a block bound to threadIdx.y. Each lane
+ * loads a vector of the sampled length from each read contiguous along the reduction into its
+ * registers, and accumulates the products in a register, before the lanes are reduced across
+ * the threads. The block scheduled is annotated so that the rules after this one skip it, and the
+ * unscheduled schedule is kept for them.
+ */
+class GEMVNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    Target target = context->target.value();
+    Optional<Integer> opt_max_threads_per_block = target->GetAttr<Integer>("max_threads_per_block");
+    Optional<Integer> opt_warp_size = target->GetAttr<Integer>("thread_warp_size");
+    if (!opt_max_threads_per_block.defined() || !opt_warp_size.defined()) {
+      TVM_PY_LOG(WARNING, context->logger)
+          << "Target does not have attribute \"max_threads_per_block\" or \"thread_warp_size\", "
+             "therefore the rule GEMV will not be applied";
+    }
+    max_threads_per_block = opt_max_threads_per_block.value_or(Integer(-1))->value;
+    warp_size = opt_warp_size.value_or(Integer(-1))->value;
+  }
+
+  // Inherited from ScheduleRuleNode
+  Array<Schedule> Apply(const Schedule& sch, const BlockRV& block_rv) final {
+    if (max_threads_per_block == -1 || warp_size == -1) {
+      return {sch};
+    }
+    if (Optional<Schedule> gemv_sch = ApplyGEMV(sch, block_rv)) {
+      return {gemv_sch.value(), sch};
+    }
+    return {sch};
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<GEMVNode> n = make_object<GEMVNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ private:
+  /*! \brief The maximum number of bits of a vector load. */
+  static constexpr int kMaxVectorBits = 128;
+
+  /*! \brief The schedule of a block as a GEMV, or NullOpt if the block is not GEMV-like. */
+  Optional<Schedule> ApplyGEMV(const Schedule& sch, const BlockRV& block_rv) {
+    const tir::StmtSRef& block_sref = sch->GetSRef(block_rv);
+    const tir::StmtSRef& scope_sref = tir::GetScopeRoot(sch->state(), block_sref,
+                                                        /*require_stage_pipeline=*/false);
+    if (!tir::IsReductionBlock(sch->state(), block_sref, scope_sref) ||
+        !tir::IsTrivialBinding(sch->state(), block_sref) ||
+        tir::HasBeenMultiLevelTiled(block_sref)) {
+      return NullOpt;
+    }
+    tir::Block block = GetRef<tir::Block>(block_sref->StmtAs<tir::BlockNode>());
+    std::vector<int> reads = GetGEMVVectorizedReads(block);
+    if (reads.empty()) {
+      return NullOpt;
+    }
+    auto [spatial_extent, reduction_extent] =
+        GetCumulativeSpaceAndReductionLength(sch->state(), block_sref);
+    if (spatial_extent == -1 || reduction_extent == -1) {
+      return NullOpt;
+    }
+    // The vectors and the lanes divide the reduction, and the rows of a block divide the rows, so
+    // that no predicate guards the loads.
+    int max_bits = 0;
+    for (int index : reads) {
+      max_bits = std::max(max_bits, block->reads[index]->buffer->dtype.bits());
+    }
+    Array<Integer> vector_lens;
+    for (int len = 1; len * max_bits <= kMaxVectorBits; len *= 2) {
+      if (reduction_extent % len == 0) {
+        vector_lens.push_back(Integer(len));
+      }
+    }
+    int64_t max_vector_len = vector_lens.back()->value;
+    Array<Integer> lanes;
+    for (const Integer& extent : thread_extents) {
+      if (extent->value <= max_threads_per_block &&
+          reduction_extent % (extent->value * max_vector_len) == 0) {
+        lanes.push_back(extent);
+      }
+    }
+    if (lanes.empty()) {
+      return NullOpt;
+    }
+    int64_t max_lanes = 0;
+    for (const Integer& extent : lanes) {
+      max_lanes = std::max(max_lanes, extent->value);
+    }
+    Array<Integer> rows;
+    for (const Integer& extent : rows_per_block) {
+      if (extent->value * max_lanes <= max_threads_per_block &&
+          spatial_extent % extent->value == 0) {
+        rows.push_back(extent);
+      }
+    }
+    if (rows.empty()) {
+      return NullOpt;
+    }
+
+    Schedule gemv_sch = sch->Copy();
+    gemv_sch->Seed(sch->ForkSeed());
+    try {
+      size_t num_spatial_loops;
+      LoopRV fused_reduce_loop;
+      ReorderAndFuseReductionLoops(gemv_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+      if (num_spatial_loops == 0) {
+        return NullOpt;
+      }
+      Array<LoopRV> loops = gemv_sch->GetLoops(block_rv);
+      Array<LoopRV> spatial_loops(loops.begin(), loops.begin() + num_spatial_loops);
+      LoopRV fused_spatial_loop =
+          num_spatial_loops == 1 ? spatial_loops[0] : gemv_sch->Fuse(spatial_loops);
+      tir::ExprRV lane = Sample(gemv_sch, lanes);
+      tir::ExprRV vector_len = Sample(gemv_sch, vector_lens);
+      tir::ExprRV row = Sample(gemv_sch, rows);
+      // [blockIdx.x, threadIdx.y, threadIdx.x, serial, vector], so that the lanes of a warp load
+      // the contiguous vectors of a row at each step of the serial loop.
+      Array<LoopRV> r = gemv_sch->Split(fused_reduce_loop, {NullOpt, lane, vector_len});
+      Array<LoopRV> s = gemv_sch->Split(fused_spatial_loop, {NullOpt, row});
+      gemv_sch->Reorder({r[1], r[0]});
+      gemv_sch->Bind(s[0], "blockIdx.x");
+      gemv_sch->Bind(s[1], "threadIdx.y");
+      gemv_sch->Bind(r[1], "threadIdx.x");
+      for (int index : reads) {
+        BlockRV cache = gemv_sch->CacheRead(block_rv, index, "local");
+        gemv_sch->ComputeAt(cache, r[0], /*preserve_unit_loops=*/true);
+        Array<LoopRV> cache_loops = gemv_sch->GetLoops(cache);
+        // The loops of the copy are those under blockIdx.x, threadIdx.y, threadIdx.x and serial.
+        Array<LoopRV> copy_loops(cache_loops.begin() + 4, cache_loops.end());
+        if (!copy_loops.empty()) {
+          gemv_sch->Vectorize(copy_loops.size() == 1 ? copy_loops[0] : gemv_sch->Fuse(copy_loops));
+        }
+      }
+    } catch (const tvm::runtime::Error& e) {
+      return NullOpt;
+    }
+    gemv_sch->Annotate(block_rv, "schedule_rule", String("None"));
+    return gemv_sch;
+  }
+
+  /*! \brief Sample one of the candidates uniformly. */
+  static tir::ExprRV Sample(const Schedule& sch, const Array<Integer>& candidates) {
+    int n = candidates.size();
+    Array<FloatImm> probs(n, FloatImm(DataType::Float(64), 1.0 / n));
+    return sch->SampleCategorical(candidates, probs);
+  }
+
+ public:
+  /*! \brief The candidates of the number of the threadIdx.x lanes reducing a row. */
+  Array<Integer> thread_extents;
+  /*! \brief The candidates of the number of the rows of a thread block. */
+  Array<Integer> rows_per_block;
+  /*! \brief The max number of threads per block from Target */
+  int64_t max_threads_per_block = -1;
+  /*! \brief The number of threads per warp from Target */
+  int64_t warp_size = -1;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("thread_extents", &thread_extents);
+    v->Visit("rows_per_block", &rows_per_block);
+    v->Visit("max_threads_per_block", &max_threads_per_block);
+    v->Visit("warp_size", &warp_size);
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.GEMV";
+  TVM_DECLARE_FINAL_OBJECT_INFO(GEMVNode, ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::GEMV(Array<Integer> thread_extents, Array<Integer> rows_per_block) {
+  for (const Integer& extent : thread_extents) {
+    CHECK_GT(extent->value, 0) << "ValueError: The candidates of thread extent must be positive, "
+                               << "but gets " << thread_extents;
+  }
+  for (const Integer& extent : rows_per_block) {
+    CHECK_GT(extent->value, 0) << "ValueError: The candidates of rows per block must be positive, "
+                               << "but gets " << rows_per_block;
+  }
+  ObjectPtr<GEMVNode> n = make_object<GEMVNode>();
+  n->thread_extents = std::move(thread_extents);
+  n->rows_per_block = std::move(rows_per_block);
+  return ScheduleRule(n);
+}
+
+TVM_REGISTER_NODE_TYPE(GEMVNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleGEMV").set_body_typed(ScheduleRule::GEMV);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -21,6 +21,7 @@
 #include <tvm/meta_schedule/schedule_rule.h>
 
 #include <algorithm>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -87,6 +88,14 @@ void MultiLevelTilingNode::InitializeWithTuneContext(const TuneContext& context)
       TVM_PY_LOG(INFO, context->logger) << "'thread_warp_size' is not defined in the target";
     }
   }
+  for (const char* attr_name : {"l1-cache-size", "l2-cache-size", "l3-cache-size"}) {
+    int64_t size = GetTargetCacheAttr(context->target.value(), attr_name);
+    if (size <= 0) {
+      break;
+    }
+    this->cache_sizes_.push_back(size);
+  }
+  this->cache_line_size_ = GetTargetCacheAttr(context->target.value(), "cache-line-size");
   logger = context->logger;
 }
 
@@ -167,16 +176,157 @@ std::vector<State> MultiLevelTilingNode::AddWriteReuse(State state) const {
 }
 
 Array<tir::LoopRV> MultiLevelTilingNode::SplitLoop(const Schedule& sch, BlockRV block, LoopRV loop,
-                                                   int n_tiles) const {
+                                                   int n_tiles,
+                                                   Optional<Array<Integer>> decision) const {
   Array<tir::ExprRV> factors = sch->SamplePerfectTile(
       /*loop=*/loop,
       /*n=*/n_tiles,
-      /*max_innermost_factor=*/max_innermost_factor);
+      /*max_innermost_factor=*/max_innermost_factor,
+      /*decision=*/decision);
   Array<tir::LoopRV> splits = sch->Split(/*loop=*/loop,
                                          /*factors=*/{factors.begin(), factors.end()});
   return splits;
 }
 
+std::vector<Optional<Array<Integer>>> MultiLevelTilingNode::CacheFittingTiles(
+    const Schedule& sch, const BlockRV& block_rv, const Array<LoopRV>& loops,
+    const std::vector<IterVarType>& iter_types) const {
+  int n = loops.size();
+  std::vector<Optional<Array<Integer>>> decisions(n, NullOpt);
+  if (this->cache_sizes_.empty() || this->cache_line_size_ <= 0 || s_indices_.size() < 2) {
+    return decisions;
+  }
+  const tir::BlockNode* block = sch->Get(block_rv).get();
+  // Step 1. Find the slots in `structure` of the tiles of each loop, where `factors[i][0]`, the
+  // outermost tile of loop `i`, takes the rest of its extent
+  std::vector<const std::vector<int>*> slots(n, nullptr);
+  std::vector<std::vector<int64_t>> factors(n);
+  std::unordered_map<const tir::VarNode*, int> var2loop;
+  for (int i = 0; i < n; ++i) {
+    if (iter_types[i] == IterVarType::kDataPar) {
+      slots[i] = &s_indices_;
+    } else if (iter_types[i] == IterVarType::kCommReduce) {
+      slots[i] = &r_indices_;
+    } else {
+      continue;
+    }
+    const int64_t* extent = tir::GetLoopIntExtent(sch->Get(loops[i]).get());
+    if (extent == nullptr) {
+      return decisions;
+    }
+    factors[i].assign(slots[i]->size(), 1);
+    factors[i][0] = *extent;
+    var2loop[block->iter_vars[i]->var.get()] = i;
+  }
+  // The bytes of the regions of the block accessed in the tile inside the slot `cut`,
+  // where the contiguous dim of a buffer is rounded up to whole cache lines
+  auto f_footprint = [&](int cut) -> int64_t {
+    std::vector<int64_t> tile(n, 1);
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0, m = factors[i].size(); j < m; ++j) {
+        if (slots[i]->at(j) >= cut) {
+          tile[i] *= factors[i][j];
+        }
+      }
+    }
+    int64_t total = 0;
+    for (const Array<tir::BufferRegion>* regions : {&block->reads, &block->writes}) {
+      for (const tir::BufferRegion& region : *regions) {
+        int64_t bytes = region->buffer->dtype.bytes() * region->buffer->dtype.lanes();
+        for (int d = 0, ndim = region->region.size(); d < ndim; ++d) {
+          const Range& range = region->region[d];
+          const auto* extent = range->extent.as<IntImmNode>();
+          int64_t len = extent != nullptr ? extent->value : 1;
+          tir::PostOrderVisit(range->min, [&](const ObjectRef& obj) {
+            auto it = var2loop.find(obj.as<tir::VarNode>());
+            if (it != var2loop.end()) {
+              len += tile[it->second] - 1;
+            }
+          });
+          if (d == ndim - 1) {
+            bytes = (bytes * len + cache_line_size_ - 1) / cache_line_size_ * cache_line_size_;
+          } else {
+            bytes *= len;
+          }
+        }
+        total += bytes;
+      }
+    }
+    return total;
+  };
+  // Move the smallest prime factor of the rest of loop `i` to its tile `j`
+  auto f_grow = [&](int i, int j, int64_t max_factor) -> bool {
+    int64_t rest = factors[i][0];
+    int64_t q = 2;
+    while (q * q <= rest && rest % q != 0) ++q;
+    if (q * q > rest) q = rest;
+    if (rest == 1 || (max_factor != -1 && factors[i][j] * q > max_factor)) {
+      return false;
+    }
+    factors[i][j] *= q;
+    factors[i][0] /= q;
+    return true;
+  };
+  auto f_max_factor = [&](int i, int j) -> int64_t {
+    return j + 1 == static_cast<int>(factors[i].size()) ? max_innermost_factor : -1;
+  };
+  // Step 2. The innermost tile of the loop of the contiguous dim of the output spans a cache line
+  if (!block->writes.empty() && !block->writes[0]->region.empty()) {
+    const tir::BufferRegion& write = block->writes[0];
+    auto it = var2loop.find(write->region.back()->min.as<tir::VarNode>());
+    if (it != var2loop.end() && iter_types[it->second] == IterVarType::kDataPar) {
+      int i = it->second;
+      int j = factors[i].size() - 1;
+      int64_t lanes = std::max<int64_t>(cache_line_size_ / write->buffer->dtype.bytes(), 1);
+      int64_t max_factor = max_innermost_factor == -1
+                               ? lanes
+                               : std::min<int64_t>(lanes, max_innermost_factor);
+      while (f_grow(i, j, max_factor)) {
+      }
+    }
+  }
+  // Step 3. Grow the tiles inside each outer spatial level to fit the caches from the L1
+  int inner = s_indices_.back();
+  for (int k = s_indices_.size() - 2, level = 0;
+       k >= 1 && level < static_cast<int>(cache_sizes_.size()); --k, ++level) {
+    int cut = s_indices_[k];
+    int64_t budget = cache_sizes_[level] / 2;
+    while (true) {
+      int best_i = -1, best_j = -1;
+      int64_t best_footprint = budget + 1;
+      for (int i = 0; i < n; ++i) {
+        for (int j = 1, m = factors[i].size(); j < m; ++j) {
+          int slot = slots[i]->at(j);
+          if (slot < cut || slot >= inner) {
+            continue;
+          }
+          std::vector<int64_t> backup = factors[i];
+          if (f_grow(i, j, f_max_factor(i, j))) {
+            int64_t footprint = f_footprint(cut);
+            if (footprint < best_footprint) {
+              best_footprint = footprint;
+              best_i = i;
+              best_j = j;
+            }
+            factors[i] = std::move(backup);
+          }
+        }
+      }
+      if (best_i == -1) {
+        break;
+      }
+      f_grow(best_i, best_j, f_max_factor(best_i, best_j));
+    }
+    inner = cut;
+  }
+  for (int i = 0; i < n; ++i) {
+    if (slots[i] != nullptr && slots[i]->size() > 1) {
+      decisions[i] = support::AsArray<int64_t, Integer>(factors[i]);
+    }
+  }
+  return decisions;
+}
+
 std::vector<State> MultiLevelTilingNode::TileLoopNest(State state) const {
   Schedule& sch = state->sch;
   const BlockRV& block_rv = state->block_rv;
@@ -184,6 +334,10 @@ std::vector<State> MultiLevelTilingNode::TileLoopNest(State state) const {
   Array<LoopRV> loops = sch->GetLoops(block_rv);
   std::vector<IterVarType> iter_types = GetBlockVarTypes(sch->GetSRef(state->block_rv));
   ICHECK_EQ(loops.size(), iter_types.size());
+  std::vector<Optional<Array<Integer>>> decisions(loops.size(), NullOpt);
+  if (tile_binds.empty() && this->thread_warp_size_ == -1) {
+    decisions = CacheFittingTiles(sch, block_rv, loops, iter_types);
+  }
   // Step 2. For each loop axis, tile it
   int64_t spatial_loop_product = 1;
   std::vector<Array<LoopRV>> tiles(s_indices_.size() + r_indices_.size());
@@ -211,7 +365,7 @@ std::vector<State> MultiLevelTilingNode::TileLoopNest(State state) const {
     if (n_tiles == 1) {
       tiles[idx->at(0)].push_back(loop);
     } else {
-      auto splits = SplitLoop(sch, block_rv, loop, n_tiles);
+      auto splits = SplitLoop(sch, block_rv, loop, n_tiles, decisions[i]);
 
       // Put every tile to its slot
       for (int j = 0; j < n_tiles; ++j) {
@@ -248,10 +402,13 @@ std::vector<State> MultiLevelTilingNode::AddReadReuse(State state) const {
   if (config.req == ReuseType::kNoReuse) {
     return {std::move(state)};
   }
-  ICHECK(config.req != ReuseType::kMayReuse);
   const BlockRV& block_rv = state->block_rv;
   std::vector<State> results;
-  results.reserve(config.levels.size());
+  results.reserve(config.levels.size() + 1);
+  if (config.req == ReuseType::kMayReuse) {
+    // The schedule reading the buffers in place stays in the design space.
+    results.push_back(state->Copy());
+  }
   for (int level : config.levels) {
     State new_state = state->Copy();
     Schedule& sch = new_state->sch;
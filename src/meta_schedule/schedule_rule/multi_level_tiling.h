@@ -162,7 +162,23 @@ class MultiLevelTilingNode : public ScheduleRuleNode {
   virtual std::vector<State> ApplySubRules(std::vector<State> states);
 
   virtual Array<tir::LoopRV> SplitLoop(const tir::Schedule& sch, tir::BlockRV block,
-                                       tir::LoopRV loop, int n_tiles) const;
+                                       tir::LoopRV loop, int n_tiles,
+                                       Optional<Array<Integer>> decision) const;
+
+  /*!
+   * \brief Get the tile sizes of the loops of a block whose working sets fit the data caches of
+   * the target, to be the initial decisions of the tiles. The innermost spatial tile of the loop
+   * of the contiguous dim of the output spans a cache line, and each outer spatial level of the
+   * structure is grown greedily until the working set of its tile exceeds half of the next cache.
+   * \param sch The schedule
+   * \param block_rv The block to be tiled
+   * \param loops The loops of the block
+   * \param iter_types The types of the block vars bound to the loops
+   * \return The decision of each loop, or NullOpt if the caches are unknown or it is not tiled
+   */
+  std::vector<Optional<Array<Integer>>> CacheFittingTiles(
+      const tir::Schedule& sch, const tir::BlockRV& block_rv, const Array<tir::LoopRV>& loops,
+      const std::vector<tir::IterVarType>& iter_types) const;
 
   // Annotate a block to use cooperative fetching
   void AnnotateCooperativeFetching(tir::Schedule* sch, const tir::BlockRV& block) const;
@@ -192,6 +208,10 @@ class MultiLevelTilingNode : public ScheduleRuleNode {
   int thread_warp_size_;
   /*! \brief The maximum number of threads to be used size of a thread warp */
   int max_threads_per_block_;
+  /*! \brief The sizes of the data caches of a CPU target in bytes, from the L1 cache */
+  std::vector<int64_t> cache_sizes_;
+  /*! \brief The size of a cache line in bytes, or -1 if unknown */
+  int64_t cache_line_size_ = -1;
   /*! \brief The logging function */
   PackedFunc logger;
 
@@ -206,6 +226,8 @@ class MultiLevelTilingNode : public ScheduleRuleNode {
     // `r_indices_` is not visited
     // `thread_warp_size_` is not visited
     // `max_threads_per_block` is not visited
+    // `cache_sizes_` is not visited
+    // `cache_line_size_` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.MultiLevelTiling";
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../tir/schedule/analysis.h"
+#include "../../tir/schedule/transform.h"
+#include "../utils.h"
+#include "multi_level_tiling.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+using tir::BlockRV;
+using tir::LoopRV;
+using tir::Schedule;
+
+/*!
+ * \brief Extension of MultiLevelTiling with split-K for the GEMMs of a few outputs and a long
+ * reduction, e.g. those of LLM decoding, which leave most of the device idle when only the spatial
+ * axes are distributed. The fused reduction loop is split into a sampled number of partitions and
+ * factored out by rfactor, so that the partial sums of the partitions are computed by a block
+ * multi-level tiled over the partitions and the spatial axes, and added up by the original block
+ * as the epilogue. The schedules without split-K are kept, so that the search picks the number of
+ * partitions or none.
+ */
+class MultiLevelTilingSplitKNode : public MultiLevelTilingNode {
+ public:
+  /*! \brief The candidates of the number of partitions of the reduction. */
+  Array<Integer> split_factors;
+  /*! \brief The maximum spatial extent of a block to be split. */
+  int64_t max_spatial_extent;
+  /*! \brief The minimum reduction extent of a block to be split. */
+  int64_t min_reduction_extent;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    MultiLevelTilingNode::VisitAttrs(v);
+    v->Visit("split_factors", &split_factors);
+    v->Visit("max_spatial_extent", &max_spatial_extent);
+    v->Visit("min_reduction_extent", &min_reduction_extent);
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.MultiLevelTilingSplitK";
+  TVM_DECLARE_FINAL_OBJECT_INFO(MultiLevelTilingSplitKNode, MultiLevelTilingNode);
+
+ protected:
+  ScheduleRule Clone() const final {
+    ObjectPtr<MultiLevelTilingSplitKNode> n = make_object<MultiLevelTilingSplitKNode>(*this);
+    return ScheduleRule(n);
+  }
+
+  Array<Schedule> Apply(const Schedule& sch, const BlockRV& block_rv) final {
+    Array<Schedule> results = ApplySplitK(sch, block_rv);
+    for (const Schedule& result : MultiLevelTilingNode::Apply(sch, block_rv)) {
+      results.push_back(result);
+    }
+    return results;
+  }
+
+ private:
+  /*! \brief The schedules splitting the reduction of a block, if it is worth it. */
+  Array<Schedule> ApplySplitK(const Schedule& sch, const BlockRV& block_rv) {
+    const tir::StmtSRef& block_sref = sch->GetSRef(block_rv);
+    if (!NeedsMultiLevelTiling(sch->state(), block_sref)) {
+      return {};
+    }
+    auto [spatial_extent, reduction_extent] =
+        GetCumulativeSpaceAndReductionLength(sch->state(), block_sref);
+    if (spatial_extent == -1 || spatial_extent > max_spatial_extent ||
+        reduction_extent < min_reduction_extent) {
+      return {};
+    }
+    // The partitions divide the reduction, so that no predicate guards the partial sums.
+    Array<Integer> factors;
+    for (const Integer& factor : split_factors) {
+      if (factor->value > 1 && factor->value < reduction_extent &&
+          reduction_extent % factor->value == 0) {
+        factors.push_back(factor);
+      }
+    }
+    if (factors.empty()) {
+      return {};
+    }
+    Schedule split_sch = sch->Copy();
+    split_sch->Seed(sch->ForkSeed());
+    BlockRV block_rf{nullptr};
+    try {
+      size_t num_spatial_loops;
+      LoopRV fused_reduce_loop;
+      ReorderAndFuseReductionLoops(split_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+      int n_factors = factors.size();
+      Array<FloatImm> probs(n_factors, FloatImm(DataType::Float(64), 1.0 / n_factors));
+      tir::ExprRV factor = split_sch->SampleCategorical(factors, probs);
+      Array<LoopRV> split = split_sch->Split(fused_reduce_loop, {factor, NullOpt});
+      // The partitions are the outermost axis of the partial sums, so that the threads bound to
+      // the spatial axes access them contiguously.
+      block_rf = split_sch->RFactor(split[0], /*factor_axis=*/0);
+    } catch (const tvm::runtime::Error& e) {
+      return {};
+    }
+    if (!NeedsMultiLevelTiling(split_sch->state(), split_sch->GetSRef(block_rf))) {
+      return {};
+    }
+    return MultiLevelTilingNode::Apply(split_sch, block_rf);
+  }
+};
+
+ScheduleRule ScheduleRule::MultiLevelTilingSplitK(
+    Array<Integer> split_factors, int64_t max_spatial_extent, int64_t min_reduction_extent,
+    String structure, Optional<Array<String>> tile_binds, Optional<Integer> max_innermost_factor,
+    Optional<Array<Integer>> vector_load_lens, Optional<Map<String, ObjectRef>> reuse_read,
+    Optional<Map<String, ObjectRef>> reuse_write) {
+  for (const Integer& factor : split_factors) {
+    CHECK_GT(factor->value, 0) << "ValueError: The split factors must be positive, but gets "
+                               << split_factors;
+  }
+  auto node = MultiLevelTilingInitCommon<MultiLevelTilingSplitKNode>(
+      structure, tile_binds, max_innermost_factor, vector_load_lens, reuse_read, reuse_write);
+  node->split_factors = split_factors;
+  node->max_spatial_extent = max_spatial_extent;
+  node->min_reduction_extent = min_reduction_extent;
+  return ScheduleRule(node);
+}
+
+TVM_REGISTER_NODE_TYPE(MultiLevelTilingSplitKNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleMultiLevelTilingSplitK")
+    .set_body_typed(ScheduleRule::MultiLevelTilingSplitK);
+
+}  // namespace meta_schedule
+}  // namespace tvm
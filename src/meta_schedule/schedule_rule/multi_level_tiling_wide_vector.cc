@@ -32,11 +32,15 @@ using tir::Schedule;
 /*!
  * \brief Extension of MultiLevelTiling for backends with wide vectors.
  * The loop over the innermost spatial axis of the output buffer is always vectorized with the
- * maximum vector length.
+ * maximum vector length. With the software pipeline, the loop where the read caches are computed
+ * copies the tiles of its next iteration asynchronously while computing this one, e.g. by DMA
+ * into ping-pong VTCM buffers on Hexagon.
  */
 class MultiLevelTilingWideVectorNode : public MultiLevelTilingNode {
  public:
   size_t vector_length_in_bits;
+  /*! \brief Whether to pipeline the read caches with the computation. */
+  bool use_software_pipeline = false;
 
   static constexpr const char* _type_key = "meta_schedule.MultiLevelTilingWideVector";
   TVM_DECLARE_FINAL_OBJECT_INFO(MultiLevelTilingWideVectorNode, MultiLevelTilingNode);
@@ -48,11 +52,53 @@ class MultiLevelTilingWideVectorNode : public MultiLevelTilingNode {
     return ScheduleRule(n);
   }
 
-  Array<tir::LoopRV> SplitLoop(const Schedule& sch, BlockRV block, LoopRV loop, int n_tiles) const;
+  Array<tir::LoopRV> SplitLoop(const Schedule& sch, BlockRV block, LoopRV loop, int n_tiles,
+                               Optional<Array<Integer>> decision) const;
+
+  std::vector<State> ApplySubRules(std::vector<State> states) final {
+    states = MultiLevelTilingNode::ApplySubRules(std::move(states));
+    return SubRule(std::move(states), [&](State state) { return AddSoftwarePipeline(state); });
+  }
+
+  // SubRule 4. pipeline the read caches with the computation
+  std::vector<State> AddSoftwarePipeline(State state) const;
 };
 
-Array<tir::LoopRV> MultiLevelTilingWideVectorNode::SplitLoop(const Schedule& sch, BlockRV block_rv,
-                                                             LoopRV loop_rv, int n_tiles) const {
+std::vector<State> MultiLevelTilingWideVectorNode::AddSoftwarePipeline(State state) const {
+  if (!use_software_pipeline || state->read_reuse.empty()) {
+    return {state};
+  }
+  Schedule& sch = state->sch;
+  // The read caches are computed at the same loop, each under the loop of its fused iterators.
+  Array<LoopRV> loops = sch->GetLoops(state->read_reuse.begin()->second);
+  if (loops.size() < 2) {
+    return {state};
+  }
+  const LoopRV& loop_rv = loops[loops.size() - 2];
+  const tir::ForNode* loop = TVM_SREF_TO_FOR(sch->GetSRef(loop_rv));
+  const auto* extent = loop->extent.as<IntImmNode>();
+  const auto* seq = loop->body.as<tir::SeqStmtNode>();
+  int num_caches = state->read_reuse.size();
+  // The body must be the copies followed by the tiles of the computation alone.
+  if (extent == nullptr || extent->value < 2 || seq == nullptr ||
+      static_cast<int>(seq->size()) != num_caches + 1) {
+    return {state};
+  }
+  Array<Integer> stages(num_caches, Integer(0));
+  stages.push_back(Integer(1));
+  Array<Integer> orders;
+  for (int i = 0; i <= num_caches; ++i) {
+    orders.push_back(Integer(i));
+  }
+  sch->Annotate(loop_rv, tir::attr::software_pipeline_stage, stages);
+  sch->Annotate(loop_rv, tir::attr::software_pipeline_order, orders);
+  sch->Annotate(loop_rv, tir::attr::software_pipeline_async_stages, Array<Integer>{Integer(0)});
+  return {state};
+}
+
+Array<tir::LoopRV> MultiLevelTilingWideVectorNode::SplitLoop(
+    const Schedule& sch, BlockRV block_rv, LoopRV loop_rv, int n_tiles,
+    Optional<Array<Integer>> decision) const {
   const tir::ForNode* loop = TVM_SREF_TO_FOR(sch->GetSRef(loop_rv));
   const tir::StmtSRef block_sref = sch->GetSRef(block_rv);
   const tir::BlockNode* block_node = block_sref->StmtAs<tir::BlockNode>();
@@ -85,7 +131,7 @@ Array<tir::LoopRV> MultiLevelTilingWideVectorNode::SplitLoop(const Schedule& sch
 
   if (!arith::Analyzer().CanProve(loop->loop_var == innermost_iter_value)) {
     // If this is not the innermost spatial loop, split the loop in the normal way.
-    return MultiLevelTilingNode::SplitLoop(sch, block_rv, loop_rv, n_tiles);
+    return MultiLevelTilingNode::SplitLoop(sch, block_rv, loop_rv, n_tiles, decision);
   } else {
     // We split the innermost spatial loop in a way that always uses the maximum vector length.
     const int64_t* extent_int = tir::GetLoopIntExtent(loop);
@@ -111,10 +157,12 @@ Array<tir::LoopRV> MultiLevelTilingWideVectorNode::SplitLoop(const Schedule& sch
 
 ScheduleRule ScheduleRule::MultiLevelTilingWideVector(
     String structure, Integer vector_length_in_bits, Optional<Integer> max_innermost_factor,
-    Optional<Map<String, ObjectRef>> reuse_read, Optional<Map<String, ObjectRef>> reuse_write) {
+    Optional<Map<String, ObjectRef>> reuse_read, Optional<Map<String, ObjectRef>> reuse_write,
+    bool use_software_pipeline) {
   auto node = MultiLevelTilingInitCommon<MultiLevelTilingWideVectorNode>(
       structure, NullOpt, max_innermost_factor, NullOpt, reuse_read, reuse_write);
   node->vector_length_in_bits = vector_length_in_bits->value;
+  node->use_software_pipeline = use_software_pipeline;
   return ScheduleRule(node);
 }
 
@@ -17,6 +17,8 @@
  * under the License.
  */
 
+#include <future>
+
 #include "../module_equality.h"
 #include "../utils.h"
 
@@ -114,6 +116,8 @@ struct PerThreadData {
   TRandState rand_state{-1};
   std::function<int32_t()> trace_sampler = nullptr;
   std::function<Optional<Mutator>()> mutator_sampler = nullptr;
+  /*! \brief The recently replayed traces, which the replays of their mutants resume from. */
+  std::shared_ptr<TraceReplayCache> replay_cache = std::make_shared<TraceReplayCache>();
 
   /*!
    * \brief Set the value for the trace and mutator samplers per thread.
@@ -273,6 +277,12 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     CostModel cost_model_{nullptr};
     /*! \brief The token registered for the given workload in database. */
     Workload token_{nullptr};
+    /*!
+     * \brief The best traces of the similar workloads in the database, nearest workload first,
+     * and the design spaces with the decisions they are generated with, which fill up the initial
+     * population while the workload has few measured records itself.
+     */
+    std::vector<tir::Trace> warm_start_traces_;
 
     explicit State(EvolutionarySearchNode* self, int max_trials, int num_trials_per_iter,
                    Array<Schedule> design_space_schedules, Database database, CostModel cost_model)
@@ -297,8 +307,24 @@ class EvolutionarySearchNode : public SearchStrategyNode {
       this->database_ = database;
       this->cost_model_ = cost_model;
       this->token_ = database->CommitWorkload(mod);
+      if (self->num_warm_start_workloads > 0) {
+        this->WarmStart();
+      }
+      // On a CPU whose caches are known, the design spaces are tiled to fit the caches, and their
+      // own decisions seed the initial population too
+      if (GetTargetCacheAttr(ctx->target.value(), "l1-cache-size") > 0) {
+        for (const tir::Trace& trace : design_spaces) {
+          this->warm_start_traces_.push_back(trace);
+        }
+      }
     }
 
+    /*!
+     * \brief Warm start from the workloads of the same computation but of the nearest shapes in
+     * the database, by pretraining the cost model on their records, and keeping their best traces
+     * to seed the initial population.
+     */
+    inline void WarmStart();
     /*!
      * \brief Pick up best candidates from database.
      * \param num The number of traces to produce.
@@ -367,6 +393,11 @@ class EvolutionarySearchNode : public SearchStrategyNode {
   int init_min_unmeasured;
   /*! \brief The maximum number of failure during initial sampling. */
   int max_fail_count;
+  /*!
+   * \brief The number of the most similar workloads in the database to warm start from. Zero means
+   * no warm start.
+   */
+  int num_warm_start_workloads;
   /*** Configuration: evolution ***/
   /*! \brief The number of iterations performed by generic algorithm. */
   int genetic_num_iters;
@@ -390,6 +421,7 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     v->Visit("init_measured_ratio", &init_measured_ratio);
     v->Visit("init_min_unmeasured", &init_min_unmeasured);
     v->Visit("max_fail_count", &max_fail_count);
+    v->Visit("num_warm_start_workloads", &num_warm_start_workloads);
     /*** Configuration: evolution ***/
     v->Visit("genetic_num_iters", &genetic_num_iters);
     v->Visit("genetic_mutate_prob", &genetic_mutate_prob);
@@ -460,6 +492,7 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     n->init_measured_ratio = this->init_measured_ratio;
     n->init_min_unmeasured = this->init_min_unmeasured;
     n->max_fail_count = this->max_fail_count;
+    n->num_warm_start_workloads = this->num_warm_start_workloads;
     n->genetic_num_iters = this->genetic_num_iters;
     n->genetic_mutate_prob = this->genetic_mutate_prob;
     n->genetic_max_fail_count = this->genetic_max_fail_count;
@@ -479,18 +512,33 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickBestFromDatabase(int nu
   for (TuningRecord record : top_records) {
     measured_traces.push_back(record->trace);
   }
+  // The best traces of the similar workloads take the rest of the places
+  int num_measured = measured_traces.size();
+  for (const tir::Trace& trace : this->warm_start_traces_) {
+    if (static_cast<int>(measured_traces.size()) >= num) break;
+    measured_traces.push_back(trace);
+  }
   int actual_num = measured_traces.size();
   ThreadedTraceApply pp(self->postprocs_);
   std::vector<Schedule> results(actual_num, Schedule{nullptr});
-  auto f_proc_measured = [this, &measured_traces, &results, &pp](int thread_id,
-                                                                 int trace_id) -> void {
+  auto f_proc_measured = [this, &measured_traces, &results, &pp, num_measured](
+                             int thread_id, int trace_id) -> void {
     PerThreadData& data = this->per_thread_data_.at(thread_id);
     TRandState* rand_state = &data.rand_state;
     const IRModule& mod = data.mod;
     tir::Trace trace = measured_traces.at(trace_id);
     Schedule& result = results.at(trace_id);
     ICHECK(!result.defined());
-    if (Optional<Schedule> sch = pp.Apply(mod, trace, rand_state)) {
+    if (trace_id >= num_measured) {
+      // The traces of other shapes are dropped if they do not apply to this one
+      try {
+        if (Optional<Schedule> sch = pp.Apply(mod, trace, rand_state, /*adapt_tiles=*/true)) {
+          result = sch.value();
+        }
+      } catch (const std::runtime_error& e) {  // includes tvm::Error and dmlc::Error
+      }
+    } else if (Optional<Schedule> sch = pp.Apply(mod, trace, rand_state, /*adapt_tiles=*/false,
+                                                 data.replay_cache.get())) {
       result = sch.value();
     } else {
       LOG(FATAL) << "ValueError: Cannot postprocess the trace:\n" << trace;
@@ -498,9 +546,87 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickBestFromDatabase(int nu
     }
   };
   support::parallel_for_dynamic(0, actual_num, self->ctx_->num_threads, f_proc_measured);
+  results.erase(std::remove_if(results.begin(), results.end(),
+                               [](const Schedule& sch) { return !sch.defined(); }),
+                results.end());
   return results;
 }
 
+void EvolutionarySearchNode::State::WarmStart() {
+  auto _ = Profiler::TimedScope("EvoSearch/WarmStart");
+  const TuneContextNode* ctx = self->ctx_;
+  // Step 1. Find the workloads of the same computation with the nearest shapes
+  WorkloadShape shape = WorkloadShape::FromModule(ctx->mod.value());
+  std::unordered_set<const WorkloadNode*> visited;
+  std::vector<std::pair<double, Workload>> neighbors;
+  for (const TuningRecord& record : this->database_->GetAllTuningRecords()) {
+    const Workload& workload = record->workload;
+    if (!visited.insert(workload.get()).second || workload->shash == this->token_->shash) {
+      continue;
+    }
+    double dist = shape.Distance(WorkloadShape::FromModule(workload->mod));
+    if (std::isfinite(dist)) {
+      neighbors.emplace_back(dist, workload);
+    }
+  }
+  int num_workloads = std::min<int>(neighbors.size(), self->num_warm_start_workloads);
+  std::partial_sort(neighbors.begin(), neighbors.begin() + num_workloads, neighbors.end(),
+                    [](const std::pair<double, Workload>& a, const std::pair<double, Workload>& b) {
+                      return a.first < b.first;
+                    });
+  // Step 2. Replay their best records measured on the same kind of target
+  std::vector<TuningRecord> records;
+  std::vector<int> workload_ids;
+  for (int i = 0; i < num_workloads; ++i) {
+    for (const TuningRecord& record :
+         this->database_->GetTopK(neighbors[i].second, self->population_size)) {
+      if (!record->target.defined() || !ctx->target.defined() ||
+          record->target.value()->kind->name == ctx->target.value()->kind->name) {
+        records.push_back(record);
+        workload_ids.push_back(i);
+      }
+    }
+  }
+  int num_records = records.size();
+  ThreadedTraceApply pp(self->postprocs_);
+  std::vector<Schedule> schs(num_records, Schedule{nullptr});
+  auto f_proc_record = [this, &records, &schs, &pp](int thread_id, int record_id) -> void {
+    TRandState* rand_state = &this->per_thread_data_.at(thread_id).rand_state;
+    const TuningRecord& record = records.at(record_id);
+    try {
+      if (Optional<Schedule> sch =
+              pp.Apply(DeepCopyIRModule(record->workload->mod), record->trace, rand_state)) {
+        schs.at(record_id) = sch.value();
+      }
+    } catch (const std::runtime_error& e) {  // includes tvm::Error and dmlc::Error
+    }
+  };
+  support::parallel_for_dynamic(0, num_records, ctx->num_threads, f_proc_record);
+  // Step 3. Pretrain the cost model on the records, and keep their traces to seed the population.
+  // The records of each workload are given with a context of that workload, which the cost model
+  // groups and normalizes them by, so that they do not take part in the min-cost baseline of this
+  // workload.
+  std::vector<Array<MeasureCandidate>> candidates(num_workloads);
+  std::vector<Array<RunnerResult>> results(num_workloads);
+  int num_pretrained = 0;
+  for (int i = 0; i < num_records; ++i) {
+    if (!schs[i].defined()) continue;
+    candidates[workload_ids[i]].push_back(
+        MeasureCandidate(schs[i], ArgInfo::FromEntryFunc(schs[i]->mod(), /*remove_preproc=*/true)));
+    results[workload_ids[i]].push_back(RunnerResult(records[i]->run_secs, NullOpt));
+    this->warm_start_traces_.push_back(records[i]->trace);
+    ++num_pretrained;
+  }
+  for (int i = 0; i < num_workloads; ++i) {
+    if (candidates[i].empty()) continue;
+    ObjectPtr<TuneContextNode> workload_ctx = make_object<TuneContextNode>(*ctx);
+    workload_ctx->mod = neighbors[i].second->mod;
+    this->cost_model_->Update(TuneContext(workload_ctx), candidates[i], results[i]);
+  }
+  TVM_PY_LOG(INFO, ctx->logger) << "Warm started from " << num_pretrained << " record(s) of "
+                                << num_workloads << " similar workload(s)";
+}
+
 std::vector<Schedule> EvolutionarySearchNode::State::SampleInitPopulation(int num) {
   auto _ = Profiler::TimedScope("EvoSearch/SampleInitPopulation");
   ThreadedTraceApply pp(self->postprocs_);
@@ -517,7 +643,8 @@ std::vector<Schedule> EvolutionarySearchNode::State::SampleInitPopulation(int nu
       ICHECK(!result.defined());
       int design_space_index = tir::SampleInt(rand_state, 0, design_spaces.size());
       tir::Trace trace(design_spaces[design_space_index]->insts, {});
-      if (Optional<Schedule> sch = pp.Apply(mod, trace, rand_state)) {
+      if (Optional<Schedule> sch = pp.Apply(mod, trace, rand_state, /*adapt_tiles=*/false,
+                                            data.replay_cache.get())) {
         result = sch.value();
       }
     };
@@ -547,17 +674,27 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
   }
   SizedHeap heap(num);
   for (int iter = 0;; ++iter) {
+    // Hash the population for deduplication while the cost model predicts its scores, which it
+    // does not depend on. The mutation of the next population cannot overlap the prediction, as
+    // its traces are sampled by the scores.
+    std::vector<size_t> shashes(population.size());
+    std::future<void> hashing = std::async(std::launch::async, [&population, &shashes, this]() {
+      for (int i = 0, n = population.size(); i < n; ++i) {
+        shashes[i] = ModuleHash(population[i]->mod());
+      }
+    });
     // Predict normalized score with the cost model,
     std::vector<double> scores =
         PredictNormalizedScore(population, GetRef<TuneContext>(self->ctx_), this->cost_model_);
 
     {
       auto _ = Profiler::TimedScope("EvoSearch/Evolve/Misc");
+      hashing.get();
       ICHECK_EQ(scores.size(), population.size());
       for (int i = 0, n = population.size(); i < n; ++i) {
         Schedule sch = population.at(i);
         IRModule mod = sch->mod();
-        size_t shash = ModuleHash(mod);
+        size_t shash = shashes.at(i);
         double score = scores.at(i);
         if (!exists.Has(mod, shash)) {
           exists.Add(mod, shash);
@@ -597,7 +734,9 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
             // Decision: mutate
             Mutator mutator = opt_mutator.value();
             if (Optional<tir::Trace> new_trace = mutator->Apply(trace, rand_state)) {
-              if (Optional<Schedule> sch = pp.Apply(mod, new_trace.value(), rand_state)) {
+              if (Optional<Schedule> sch = pp.Apply(mod, new_trace.value(), rand_state,
+                                                    /*adapt_tiles=*/false,
+                                                    data.replay_cache.get())) {
                 // note that sch's trace is different from new_trace
                 // because it contains post-processing information
                 result = sch.value();
@@ -735,27 +874,29 @@ Optional<Array<MeasureCandidate>> EvolutionarySearchNode::State::GenerateMeasure
       return NullOpt;
     }
   }
+  // Advance the trial counter as soon as the candidates are sent, so that the batches generated
+  // ahead of the measurement in a pipelined task scheduler stay within the budget.
+  st += picks.size();
+  ed += picks.size();
   return AssembleCandidates(picks);
 }
 
 void EvolutionarySearchNode::State::NotifyRunnerResults(
-    const Array<MeasureCandidate>& measure_candidates, const Array<RunnerResult>& results) {
-  st += results.size();
-  ed += results.size();
-}
+    const Array<MeasureCandidate>& measure_candidates, const Array<RunnerResult>& results) {}
 
 size_t EvolutionarySearchNode::State::ModuleHash(const IRModule& mod) const {
   return database_->GetModuleEquality().Hash(mod);
 }
 
-SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,         //
-                                                  double init_measured_ratio,  //
-                                                  int init_min_unmeasured,     //
-                                                  int max_fail_count,          //
-                                                  int genetic_num_iters,       //
-                                                  double genetic_mutate_prob,  //
-                                                  int genetic_max_fail_count,  //
-                                                  double eps_greedy) {
+SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,           //
+                                                  double init_measured_ratio,    //
+                                                  int init_min_unmeasured,       //
+                                                  int max_fail_count,            //
+                                                  int genetic_num_iters,         //
+                                                  double genetic_mutate_prob,    //
+                                                  int genetic_max_fail_count,    //
+                                                  double eps_greedy,             //
+                                                  int num_warm_start_workloads) {
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(init_measured_ratio, "Initial measured ratio");
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(genetic_mutate_prob, "Mutation probability");
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(eps_greedy, "Greedy pick probability");
@@ -765,6 +906,7 @@ SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,         /
   n->init_measured_ratio = init_measured_ratio;
   n->init_min_unmeasured = init_min_unmeasured;
   n->max_fail_count = max_fail_count;
+  n->num_warm_start_workloads = num_warm_start_workloads;
   n->genetic_num_iters = genetic_num_iters;
   n->genetic_max_fail_count = genetic_max_fail_count;
   n->genetic_mutate_prob = genetic_mutate_prob;
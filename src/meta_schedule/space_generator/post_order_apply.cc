@@ -95,20 +95,23 @@ class PostOrderApplyNode : public SpaceGeneratorNode {
   runtime::PackedFunc f_block_filter_ = nullptr;
   /*! \brief The random state. -1 means using random number. */
   TRandState rand_state_ = -1;
+  /*! \brief The number of threads to apply the rules to the branches of the design space. */
+  int num_threads_ = 1;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     SpaceGeneratorNode::VisitAttrs(v);
     // `rand_state_` is not visited
+    // `num_threads_` is not visited
     // `sch_rules_` is not visited
   }
 
   void InitializeWithTuneContext(const TuneContext& context) final {
     SpaceGeneratorNode::InitializeWithTuneContext(context);
     this->rand_state_ = ForkSeed(&context->rand_state);
+    this->num_threads_ = std::max(context->num_threads, 1);
   }
 
   Array<tir::Schedule> GenerateDesignSpace(const IRModule& mod) final {
-    using ScheduleAndUnvisitedBlocks = std::pair<tir::Schedule, Array<tir::BlockRV>>;
     CHECK(sch_rules.defined()) << "ValueError: `sch_rules` is not set in PostOrderApply";
     tir::Schedule sch = tir::Schedule::Traced(
         /*mod=*/mod,
@@ -116,44 +119,76 @@ class PostOrderApplyNode : public SpaceGeneratorNode {
         /*debug_mode=*/0,
         /*error_render_level=*/tir::ScheduleErrorRenderLevel::kDetail);
 
-    std::vector<ScheduleAndUnvisitedBlocks> stack;
     Array<tir::Schedule> result{sch};
     Array<tir::BlockRV> all_blocks = BlockCollector::Collect(sch, f_block_filter_);
 
     for (ScheduleRule sch_rule : sch_rules.value()) {
-      for (const tir::Schedule& sch : result) {
-        stack.emplace_back(sch, all_blocks);
+      int n = result.size();
+      // The schedules in `result` are independent branches of the design space, which the rule is
+      // applied to in parallel. The rules implemented in python are applied sequentially.
+      if (n == 1 || num_threads_ == 1 || sch_rule->IsInstance<PyScheduleRuleNode>()) {
+        Array<tir::Schedule> applied;
+        for (int i = n - 1; i >= 0; --i) {
+          ApplyToBlocks(sch_rule, result[i], all_blocks, &applied);
+        }
+        result = applied;
+        continue;
       }
-      result.clear();
-      while (!stack.empty()) {
-        // get the stack.top()
-        auto [sch, blocks] = stack.back();
-        stack.pop_back();
-        // if all blocks are visited
-        if (blocks.empty()) {
-          result.push_back(sch);
-          continue;
+      // Each thread works on a clone of the rule, in case the rule is stateful
+      std::vector<Optional<ScheduleRule>> thread_rules(num_threads_);
+      std::vector<Array<tir::Schedule>> applied(n);
+      support::parallel_for_dynamic(0, n, num_threads_, [&](int thread_id, int task_id) {
+        if (!thread_rules[thread_id].defined()) {
+          thread_rules[thread_id] = sch_rule->Clone();
         }
-        // otherwise, get the last block that is not visited
-        tir::BlockRV block_rv = blocks.back();
-        blocks.pop_back();
-        if (!sch->HasBlock(block_rv)) {
+        ApplyToBlocks(thread_rules[thread_id].value(), result[task_id], all_blocks,
+                      &applied[task_id]);
+      });
+      // Concatenate in the order of applying the rule to the branches sequentially
+      result.clear();
+      for (int i = n - 1; i >= 0; --i) {
+        result.insert(result.end(), applied[i].begin(), applied[i].end());
+      }
+    }
+    return result;
+  }
+
+  /*!
+   * \brief Apply a rule to the blocks of a schedule in post-DFS order, and collect the schedules
+   * of all the branches forked by the rule.
+   */
+  static void ApplyToBlocks(const ScheduleRule& sch_rule, const tir::Schedule& sch,
+                            const Array<tir::BlockRV>& all_blocks, Array<tir::Schedule>* result) {
+    using ScheduleAndUnvisitedBlocks = std::pair<tir::Schedule, Array<tir::BlockRV>>;
+    std::vector<ScheduleAndUnvisitedBlocks> stack;
+    stack.emplace_back(sch, all_blocks);
+    while (!stack.empty()) {
+      // get the stack.top()
+      auto [sch, blocks] = stack.back();
+      stack.pop_back();
+      // if all blocks are visited
+      if (blocks.empty()) {
+        result->push_back(sch);
+        continue;
+      }
+      // otherwise, get the last block that is not visited
+      tir::BlockRV block_rv = blocks.back();
+      blocks.pop_back();
+      if (!sch->HasBlock(block_rv)) {
+        stack.emplace_back(sch, blocks);
+        continue;
+      }
+      if (!ScheduleRule::IsApplyCustomRule(sch_rule)) {
+        if (tir::GetAnn<String>(sch->GetSRef(block_rv), "schedule_rule").defined()) {
           stack.emplace_back(sch, blocks);
           continue;
         }
-        if (!ScheduleRule::IsApplyCustomRule(sch_rule)) {
-          if (tir::GetAnn<String>(sch->GetSRef(block_rv), "schedule_rule").defined()) {
-            stack.emplace_back(sch, blocks);
-            continue;
-          }
-        }
-        Array<tir::Schedule> applied = sch_rule->Apply(sch, /*block=*/block_rv);
-        for (const tir::Schedule& sch : applied) {
-          stack.emplace_back(sch, blocks);
-        }
+      }
+      Array<tir::Schedule> applied = sch_rule->Apply(sch, /*block=*/block_rv);
+      for (const tir::Schedule& sch : applied) {
+        stack.emplace_back(sch, blocks);
       }
     }
-    return result;
   }
 
   SpaceGenerator Clone() const final {
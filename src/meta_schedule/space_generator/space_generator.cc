@@ -71,7 +71,13 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
     Array<Postproc> default_postprocs;
     Map<Mutator, FloatImm> default_mutator_probs;
     if (kind == "llvm") {
-      default_sch_rules = ScheduleRule::DefaultLLVM();
+      // The innermost loops of the targets with a given vector width, e.g. SVE or RVV ones, are
+      // tiled to fill up the vectors.
+      if (Optional<Integer> width = context->target.value()->GetAttr<Integer>("vector-width")) {
+        default_sch_rules = ScheduleRule::DefaultLLVMWideVector(width.value()->value);
+      } else {
+        default_sch_rules = ScheduleRule::DefaultLLVM();
+      }
       default_postprocs = Postproc::DefaultLLVM();
       default_mutator_probs = Mutator::DefaultLLVM();
     } else if (kind == "cuda") {
@@ -47,13 +47,13 @@ class GradientBasedNode final : public TaskSchedulerNode {
   void Tune(Array<TuneContext> tasks, Array<FloatImm> task_weights, int max_trials_global,
             int max_trials_per_task, int num_trials_per_iter, Builder builder, Runner runner,
             Array<MeasureCallback> measure_callbacks, Optional<Database> database,
-            Optional<CostModel> cost_model) final {
+            Optional<CostModel> cost_model, int pipeline_depth) final {
     int n_tasks = tasks.size();
     round_robin_rounds_ = 0;
     best_latency_history_.resize(n_tasks, std::vector<double>());
     TaskSchedulerNode::Tune(tasks, task_weights, max_trials_global, max_trials_per_task,
                             num_trials_per_iter, builder, runner, measure_callbacks, database,
-                            cost_model);
+                            cost_model, pipeline_depth);
   }
 
   int NextTaskId() final {
@@ -68,9 +68,7 @@ class GradientBasedNode final : public TaskSchedulerNode {
     }
     if (round_robin_rounds_ == n_tasks) {
       for (int i = 0; i < n_tasks; ++i) {
-        if (this->tasks_[i]->runner_futures.defined()) {
-          this->JoinRunningTask(i);
-        }
+        this->JoinRunningTaskUntil(i, 0);
       }
       ++round_robin_rounds_;
     }
@@ -116,9 +114,7 @@ class GradientBasedNode final : public TaskSchedulerNode {
     } else {
       task_id = tasks_alive[std::distance(grad.begin(), max_grad)];
     }
-    if (this->tasks_[task_id]->runner_futures.defined()) {
-      JoinRunningTask(task_id);
-    }
+    this->JoinRunningTaskUntil(task_id, this->pipeline_depth_ - 1);
     return task_id;
   }
 
@@ -45,9 +45,7 @@ class RoundRobinNode final : public TaskSchedulerNode {
       task_id = (task_id + 1) % n_tasks;
       TaskRecordNode* task = this->tasks_[task_id].get();
       if (!task->is_terminated) {
-        if (task->runner_futures.defined()) {
-          JoinRunningTask(task_id);
-        }
+        this->JoinRunningTaskUntil(task_id, this->pipeline_depth_ - 1);
         return task_id;
       }
     }
@@ -38,22 +38,22 @@ TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   this->data_ = std::move(n);
 }
 
-void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
+Array<BuilderResult> SendToBuilder(TaskRecordNode* self, const Builder& builder,
+                                   const Array<MeasureCandidate>& candidates) {
   auto _ = Profiler::TimedScope("SendToBuilder");
-  Array<MeasureCandidate> candidates = self->measure_candidates.value();
   Target target = self->ctx->target.value();
   Array<BuilderInput> inputs;
   inputs.reserve(candidates.size());
   for (const MeasureCandidate& candidate : candidates) {
     inputs.push_back(BuilderInput(candidate->sch->mod(), target));
   }
-  self->builder_results = builder->Build(inputs);
+  return builder->Build(inputs);
 }
 
-void SendToRunner(TaskRecordNode* self, const Runner& runner) {
+Array<RunnerFuture> SendToRunner(TaskRecordNode* self, const Runner& runner,
+                                 const Array<MeasureCandidate>& candidates,
+                                 const Array<BuilderResult>& builder_results) {
   auto _ = Profiler::TimedScope("SendToRunner");
-  Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  Array<BuilderResult> builder_results = self->builder_results.value();
   Target target = self->ctx->target.value();
   ICHECK_EQ(candidates.size(), builder_results.size());
   int n = candidates.size();
@@ -73,8 +73,7 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
   }
   Array<RunnerFuture> futures = runner->Run(inputs);
   if (n_build_errors == 0) {
-    self->runner_futures = futures;
-    return;
+    return futures;
   }
   Array<RunnerFuture> results;
   results.reserve(n);
@@ -91,7 +90,7 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
       results.push_back(futures[j++]);
     }
   }
-  self->runner_futures = results;
+  return results;
 }
 
 void TaskCleanUp(TaskRecordNode* self, int task_id, const Array<RunnerResult>& results) {
@@ -135,19 +134,31 @@ void TaskCleanUp(TaskRecordNode* self, int task_id, const Array<RunnerResult>& r
                                << ". Best GFLOPs: " << (self->flop / best_ms / 1e6);
     }
   }
-  self->measure_candidates = NullOpt;
-  self->builder_results = NullOpt;
-  self->runner_futures = NullOpt;
+  if (self->pending_batches.empty()) {
+    self->measure_candidates = NullOpt;
+    self->builder_results = NullOpt;
+    self->runner_futures = NullOpt;
+  } else {
+    // Promote the next batch in flight, which is joined next
+    TaskRecordNode::PendingBatch& batch = self->pending_batches.front();
+    self->measure_candidates = std::move(batch.measure_candidates);
+    self->builder_results = std::move(batch.builder_results);
+    self->runner_futures = std::move(batch.runner_futures);
+    self->pending_batches.pop_front();
+  }
 }
 
 void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weights,
                              int max_trials_global, int max_trials_per_task,
                              int num_trials_per_iter, Builder builder, Runner runner,
                              Array<MeasureCallback> measure_callbacks, Optional<Database> database,
-                             Optional<CostModel> cost_model) {
+                             Optional<CostModel> cost_model, int pipeline_depth) {
   CHECK_EQ(ctxs.size(), task_weights.size()) << "ValueError: `task_weights` must have the same "
                                                 "length as `ctxs`";
+  CHECK_GE(pipeline_depth, 1) << "ValueError: `pipeline_depth` must be positive, but gets "
+                              << pipeline_depth;
   int n_tasks = this->remaining_tasks_ = ctxs.size();
+  this->pipeline_depth_ = pipeline_depth;
   this->measure_callbacks_ = measure_callbacks;
   this->database_ = database;
   this->cost_model_ = cost_model;
@@ -181,29 +192,39 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
         << "TaskScheduler picks Task #" << task_id << ": " << tasks_[task_id]->ctx->task_name;
     TaskRecordNode* task = tasks_[task_id].get();
     ICHECK(!task->is_terminated);
-    ICHECK(!task->runner_futures.defined());
-    if (static_cast<int>(task->latency_ms.size()) >= max_trials_per_task) {
+    // With pipelining, the batches of a task still running leave room for the next one
+    JoinRunningTaskUntil(task_id, pipeline_depth - 1);
+    if (static_cast<int>(task->latency_ms.size()) + task->NumInFlightTrials() >=
+        max_trials_per_task) {
+      JoinRunningTaskUntil(task_id, 0);
       TerminateTask(task_id);
       continue;
     }
-    if (Optional<Array<MeasureCandidate>> candidates = task->measure_candidates =
+    if (Optional<Array<MeasureCandidate>> candidates =
             task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
       int num_candidates = candidates.value().size();
       num_trials_already += num_candidates;
       TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
-      SendToBuilder(task, builder);
+      Array<BuilderResult> builder_results = SendToBuilder(task, builder, candidates.value());
       TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
-      SendToRunner(task, runner);
+      Array<RunnerFuture> runner_futures =
+          SendToRunner(task, runner, candidates.value(), builder_results);
+      if (task->runner_futures.defined()) {
+        task->pending_batches.push_back({candidates.value(), builder_results, runner_futures});
+      } else {
+        task->measure_candidates = candidates;
+        task->builder_results = builder_results;
+        task->runner_futures = runner_futures;
+      }
     } else {
+      JoinRunningTaskUntil(task_id, 0);
       TerminateTask(task_id);
     }
   }
   for (int task_id = 0; task_id < n_tasks; ++task_id) {
     TaskRecordNode* task = this->tasks_[task_id].get();
     if (!task->is_terminated) {
-      if (task->runner_futures.defined()) {
-        JoinRunningTask(task_id);
-      }
+      JoinRunningTaskUntil(task_id, 0);
       TerminateTask(task_id);
     }
     task->ctx->search_strategy.value()->PostTuning();
@@ -239,9 +260,17 @@ Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
   return results;
 }
 
+void TaskSchedulerNode::JoinRunningTaskUntil(int task_id, int max_in_flight) {
+  TaskRecordNode* task = this->tasks_[task_id].get();
+  while (task->NumInFlightBatches() > max_in_flight) {
+    this->JoinRunningTask(task_id);
+  }
+}
+
 void TaskSchedulerNode::TouchTask(int task_id) {
   TaskRecordNode* task = this->tasks_[task_id].get();
-  if (!task->is_terminated && task->runner_futures.defined()) {
+  // Join the batches in the order they are sent, as long as they are done
+  while (!task->is_terminated && task->runner_futures.defined()) {
     for (const RunnerFuture future : task->runner_futures.value()) {
       if (!future->Done()) {
         return;
@@ -350,14 +379,15 @@ void PyTaskSchedulerNode::Tune(Array<TuneContext> tasks, Array<FloatImm> task_we
                                int max_trials_global, int max_trials_per_task,
                                int num_trials_per_iter, Builder builder, Runner runner,
                                Array<MeasureCallback> measure_callbacks,
-                               Optional<Database> database, Optional<CostModel> cost_model) {
+                               Optional<Database> database, Optional<CostModel> cost_model,
+                               int pipeline_depth) {
   if (f_tune == nullptr) {
     TaskSchedulerNode::Tune(tasks, task_weights, max_trials_global, max_trials_per_task,
                             num_trials_per_iter, builder, runner, measure_callbacks, database,
-                            cost_model);
+                            cost_model, pipeline_depth);
   } else {
     f_tune(tasks, task_weights, max_trials_global, max_trials_per_task, num_trials_per_iter,
-           builder, runner, measure_callbacks, database, cost_model);
+           builder, runner, measure_callbacks, database, cost_model, pipeline_depth);
   }
 }
 
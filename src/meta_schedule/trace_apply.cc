@@ -394,8 +394,174 @@ void ScheduleUsingAnchorTrace(Schedule sch, const Trace& anchor_trace, const IRM
   }
 }
 
+/*!
+ * \brief Adapt the factors of a perfect tile to another extent. The factors are taken from the
+ * innermost one, each shrunk to the largest divisor of the remaining extent, and the outermost
+ * factor takes the rest.
+ */
+Array<Integer> AdaptTileFactors(const Array<Integer>& factors, int64_t extent) {
+  int n = factors.size();
+  std::vector<int64_t> result(n, 1);
+  int64_t rest = extent;
+  for (int i = n - 1; i > 0; --i) {
+    int64_t factor = std::max<int64_t>(factors[i]->value, 1);
+    while (rest % factor != 0) {
+      --factor;
+    }
+    result[i] = factor;
+    rest /= factor;
+  }
+  result[0] = rest;
+  return support::AsArray<int64_t, Integer>(result);
+}
+
+void ApplyTraceWithAdaptedTiles(Schedule sch, const Trace& trace) {
+  static const InstructionKind& inst_sample_perfect_tile =
+      InstructionKind::Get("SamplePerfectTile");
+  trace->ApplyToSchedule(
+      sch, /*remove_postproc=*/true,
+      [&sch](const Instruction& inst, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs,
+             const Optional<ObjectRef>& decision) -> ObjectRef {
+        if (!inst->kind.same_as(inst_sample_perfect_tile) || !decision.defined()) {
+          return decision.value_or(ObjectRef{nullptr});
+        }
+        Array<Integer> factors = Downcast<Array<Integer>>(decision.value());
+        const int64_t* extent = GetLoopIntExtent(sch->GetSRef(Downcast<LoopRV>(inputs[0])));
+        if (extent == nullptr) {
+          return factors;
+        }
+        int64_t product = 1;
+        for (const Integer& factor : factors) {
+          product *= factor->value;
+        }
+        return product == *extent ? factors : AdaptTileFactors(factors, *extent);
+      });
+}
+
+int TraceReplayCache::CommonPrefix(const Trace& trace, const Array<Instruction>& insts,
+                                   const Trace& sch_trace) {
+  int n = std::min<int>(trace->insts.size(), insts.size());
+  for (int i = 0; i < n; ++i) {
+    const Instruction& inst = trace->insts[i];
+    if (!inst.same_as(insts[i]) || inst->kind->IsPostproc()) {
+      return i;
+    }
+    // The decision that the replayed schedule used, or none if the instruction samples nothing
+    Optional<ObjectRef> used = sch_trace->GetDecision(sch_trace->insts[i]);
+    Optional<ObjectRef> decision = trace->GetDecision(inst);
+    if (used.defined() != decision.defined()) {
+      return i;
+    }
+    if (used.defined() && !used.same_as(decision) &&
+        !StructuralEqual()(used.value(), decision.value())) {
+      return i;
+    }
+  }
+  return n;
+}
+
+Schedule TraceReplayCache::Replay(const IRModule& mod, const Trace& trace,
+                                  support::LinearCongruentialEngine::TRandState seed) {
+  if (!mod_.same_as(mod)) {
+    mod_ = mod;
+    entries_.clear();
+  }
+  // Step 1. Find the last checkpoint within the longest prefix shared with a cached trace, which
+  // is either the trace replayed, or the trace of its schedule that mutants are derived from
+  const Entry* best_entry = nullptr;
+  const Checkpoint* best = nullptr;
+  for (const Entry& entry : entries_) {
+    for (bool from_sch_trace : {false, true}) {
+      int n = CommonPrefix(trace, from_sch_trace ? entry.sch_trace->insts : entry.trace->insts,
+                           entry.sch_trace);
+      for (auto it = entry.checkpoints.rbegin(); it != entry.checkpoints.rend(); ++it) {
+        if (it->num_insts <= n) {
+          if (best == nullptr || it->num_insts > best->num_insts) {
+            best_entry = &entry;
+            best = &*it;
+          }
+          break;
+        }
+      }
+    }
+  }
+  // Step 2. Resume from a copy of the checkpoint, or start from scratch
+  Schedule sch{nullptr};
+  std::unordered_map<const Object*, const Object*> rv_map;
+  Entry new_entry{trace, Trace{nullptr}, {}};
+  int begin = 0;
+  if (best != nullptr) {
+    sch = best->sch->Copy();
+    sch->Seed(seed);
+    begin = best->num_insts;
+    new_entry.checkpoints.assign(best_entry->checkpoints.data(), best + 1);
+    // Whichever trace the prefix is shared with, the random variables of the checkpoint are the
+    // outputs of the trace of its schedule
+    for (int i = 0; i < begin; ++i) {
+      const Array<ObjectRef>& outputs = trace->insts[i]->outputs;
+      const Array<ObjectRef>& sch_outputs = best_entry->sch_trace->insts[i]->outputs;
+      for (int j = 0, m = outputs.size(); j < m; ++j) {
+        rv_map.emplace(outputs[j].get(), sch_outputs[j].get());
+      }
+    }
+  } else {
+    sch = Schedule::Traced(mod, seed, /*debug_mode=*/0,
+                           /*error_render_level=*/ScheduleErrorRenderLevel::kNone);
+  }
+  // Step 3. Replay the rest, checkpointing before each run of the sampling instructions. The
+  // random state at a checkpoint is to be the seed, as it is reseeded on resume, so checkpoints are
+  // only taken until an instruction samples anew rather than keeping its decision
+  bool prev_sampled = true;
+  bool drawn = false;
+  int end = begin;
+  for (int n = trace->insts.size(); end < n; ++end) {
+    const Instruction& inst = trace->insts[end];
+    if (inst->kind->IsPostproc()) {
+      break;
+    }
+    Optional<ObjectRef> decision = trace->GetDecision(inst);
+    bool sampled = decision.defined() || support::StartsWith(inst->kind->name, "Sample");
+    if (sampled && !prev_sampled && !drawn) {
+      new_entry.checkpoints.push_back(Checkpoint{end, sch->Copy()});
+      // The copy forks the random state, which nothing has drawn from yet
+      sch->Seed(seed);
+    }
+    prev_sampled = sampled;
+    Array<ObjectRef> inputs = TranslateInputRVs(inst->inputs, rv_map);
+    Array<ObjectRef> outputs = inst->kind->f_apply_to_schedule(sch, inputs, inst->attrs, decision);
+    TranslateAddOutputRVs(inst->outputs, outputs, &rv_map);
+    if (sampled && !drawn) {
+      Trace sch_trace = sch->trace().value();
+      Optional<ObjectRef> used = sch_trace->GetDecision(sch_trace->insts.back());
+      drawn = !decision.defined() || !used.defined() ||
+              (!used.same_as(decision) && !StructuralEqual()(used.value(), decision.value()));
+    }
+  }
+  // Step 4. Cache the trace, if every instruction is recorded one for one in the schedule
+  Trace sch_trace = sch->trace().value();
+  new_entry.sch_trace = Trace(sch_trace->insts, sch_trace->decisions);
+  if (!new_entry.checkpoints.empty() && static_cast<int>(sch_trace->insts.size()) == end) {
+    entries_.push_front(std::move(new_entry));
+    if (static_cast<int>(entries_.size()) > capacity_) {
+      entries_.pop_back();
+    }
+  }
+  return sch;
+}
+
 TVM_REGISTER_GLOBAL("meta_schedule.ScheduleUsingAnchorTrace")
     .set_body_typed(ScheduleUsingAnchorTrace);
+TVM_REGISTER_GLOBAL("meta_schedule.ApplyTraceWithAdaptedTiles")
+    .set_body_typed(ApplyTraceWithAdaptedTiles);
+TVM_REGISTER_GLOBAL("meta_schedule.ReplayTraces")
+    .set_body_typed([](IRModule mod, Array<Trace> traces, int64_t seed) {
+      TraceReplayCache cache;
+      Array<Schedule> schs;
+      for (const Trace& trace : traces) {
+        schs.push_back(cache.Replay(mod, trace, seed));
+      }
+      return schs;
+    });
 
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -20,11 +20,14 @@
 #define TVM_META_SCHEDULE_TRACE_APPLY_H_
 
 #include <tvm/meta_schedule/schedule_rule.h>
+#include <tvm/support/random_engine.h>
 #include <tvm/target/target.h>
 #include <tvm/tir/schedule/schedule.h>
 #include <tvm/tir/schedule/trace.h>
 
+#include <list>
 #include <string>
+#include <vector>
 
 namespace tvm {
 namespace meta_schedule {
@@ -43,6 +46,82 @@ namespace meta_schedule {
 void ScheduleUsingAnchorTrace(tir::Schedule sch, const tir::Trace& anchor_trace,
                               const IRModule& record_mod, const tvm::Target& target);
 
+/*!
+ * \brief Apply the trace tuned on a workload of the same computation but of different shapes, e.g.
+ * a GEMM of another size. The sampled tiles whose product does not match the extent of the loop
+ * are adapted to it, keeping the inner factors as far as they divide the extent, and the other
+ * decisions are kept as they are.
+ * \param sch The schedule to apply the trace.
+ * \param trace The trace tuned on the other workload.
+ * \throw tir::ScheduleError if the trace does not apply to the schedule.
+ */
+void ApplyTraceWithAdaptedTiles(tir::Schedule sch, const tir::Trace& trace);
+
+/*!
+ * \brief A cache of the recently replayed traces of a module, which keeps the schedules
+ * checkpointed before the sampling instructions of each replay. A trace sharing a prefix of the
+ * instructions and decisions with a cached one, e.g. a mutant and its parent in the evolutionary
+ * search, is replayed from a copy of the last checkpoint within the prefix instead of from scratch.
+ * \note The cache is not thread-safe, and is meant to be owned by each thread.
+ */
+class TraceReplayCache {
+ public:
+  /*!
+   * \brief Constructor
+   * \param capacity The max number of the traces to cache.
+   */
+  explicit TraceReplayCache(int capacity = 8) : capacity_(capacity) {}
+
+  /*!
+   * \brief Replay a trace, without its postprocessors, to a new traced schedule of a module.
+   * \param mod The module to replay the trace on. The cache is reset when the module changes.
+   * \param trace The trace to replay.
+   * \param seed The random seed of the schedule.
+   * \return The schedule replayed, the same as applying the trace to a new schedule of the seed.
+   * \throw tir::ScheduleError if the trace does not apply to the module.
+   */
+  tir::Schedule Replay(const IRModule& mod, const tir::Trace& trace,
+                       support::LinearCongruentialEngine::TRandState seed);
+
+ private:
+  /*! \brief A copy of the schedule before an instruction of the replay. */
+  struct Checkpoint {
+    /*! \brief The number of the instructions replayed before the checkpoint. */
+    int num_insts;
+    /*! \brief The schedule, which is copied again to resume from. */
+    tir::Schedule sch;
+  };
+  /*! \brief A replayed trace and its checkpoints. */
+  struct Entry {
+    /*! \brief The trace replayed. */
+    tir::Trace trace;
+    /*!
+     * \brief The trace of the replayed schedule, whose instructions correspond to those of `trace`
+     * one for one, and define the random variables of the schedule in their place.
+     */
+    tir::Trace sch_trace;
+    /*! \brief The checkpoints in the order of the replay. */
+    std::vector<Checkpoint> checkpoints;
+  };
+
+  /*!
+   * \brief The length of the prefix that a trace shares with a replayed one, where the
+   * instructions are the same, and so are the decisions, or the instructions sample no decision.
+   * \param trace The trace to match.
+   * \param insts The instructions of the replayed trace, or of its schedule.
+   * \param sch_trace The trace of the replayed schedule, which holds the decisions used.
+   */
+  static int CommonPrefix(const tir::Trace& trace, const Array<tir::Instruction>& insts,
+                          const tir::Trace& sch_trace);
+
+  /*! \brief The max number of the traces to cache. */
+  int capacity_;
+  /*! \brief The module the traces replay on. */
+  IRModule mod_{nullptr};
+  /*! \brief The cached traces, the most recently replayed first. */
+  std::list<Entry> entries_;
+};
+
 }  // namespace meta_schedule
 }  // namespace tvm
 
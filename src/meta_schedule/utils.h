@@ -56,6 +56,7 @@
 #include "../support/utils.h"
 #include "../tir/schedule/primitive.h"
 #include "../tir/schedule/utils.h"
+#include "trace_apply.h"
 
 #define TVM_PY_LOG(logging_level, logger)                                \
   ::tvm::meta_schedule::PyLogMessage(__FILE__, __LINE__, logger,         \
@@ -198,6 +199,14 @@ inline std::string Base64Decode(std::string str) {
  */
 ObjectRef JSONLoads(std::string json_str);
 
+/*!
+ * \brief Parses the lines of a text into json objects in parallel, one object per line.
+ * \param text The text, whose lines are split at '\n'.
+ * \param num_threads The number of threads used to split and parse the lines.
+ * \return The json objects, in the order of the lines.
+ */
+std::vector<ObjectRef> JSONLoadLines(const std::string& text, int num_threads);
+
 /*!
  * \brief Dumps a json object into a json string.
  * \param json_obj The json object.
@@ -317,17 +326,27 @@ struct ThreadedTraceApply {
    * \param mod The IRModule to be applied
    * \param trace The trace to apply to the IRModule
    * \param rand_state The random seed
+   * \param adapt_tiles Whether the trace is tuned on another shape, whose tiles are to be adapted
+   * \param cache The cache to resume the replay from, or nullptr to replay from scratch
    * \return The schedule created, or NullOpt if any postprocessor fails
    */
   Optional<tir::Schedule> Apply(const IRModule& mod, const tir::Trace& trace,
-                                TRandState* rand_state) {
-    tir::Schedule sch =
-        tir::Schedule::Traced(mod,
-                              /*rand_state=*/ForkSeed(rand_state),
-                              /*debug_mode=*/0,
-                              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
-
-    trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+                                TRandState* rand_state, bool adapt_tiles = false,
+                                TraceReplayCache* cache = nullptr) {
+    tir::Schedule sch{nullptr};
+    if (cache != nullptr && !adapt_tiles) {
+      sch = cache->Replay(mod, trace, /*seed=*/ForkSeed(rand_state));
+    } else {
+      sch = tir::Schedule::Traced(mod,
+                                  /*rand_state=*/ForkSeed(rand_state),
+                                  /*debug_mode=*/0,
+                                  /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+      if (adapt_tiles) {
+        ApplyTraceWithAdaptedTiles(sch, trace);
+      } else {
+        trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+      }
+    }
     sch->EnterPostproc();
 
     for (int i = 0; i < n_; ++i) {
@@ -389,6 +408,16 @@ inline int GetTargetNumCores(const Target& target) {
   return num_cores;
 }
 
+/*!
+ * \brief Get a cache attribute of a CPU target, e.g. "l1-cache-size"
+ * \param target The target
+ * \param attr_name The name of the attribute
+ * \return The size in bytes, or -1 if it is not specified
+ */
+inline int64_t GetTargetCacheAttr(const Target& target, const String& attr_name) {
+  return target->GetAttr<Integer>(attr_name).value_or(-1).IntValue();
+}
+
 /*!
  * \brief Get the median of the running time from RunnerResult in millisecond
  * \param results The results from RunnerResult
@@ -28,14 +28,20 @@
 #include <tvm/node/serialization.h>
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
 #include <cctype>
+#include <fstream>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "../runtime/file_utils.h"
 #include "../runtime/object_internal.h"
 #include "../support/base64.h"
 
@@ -500,7 +506,12 @@ struct JSONGraph {
     helper.ReadAllFields(reader);
   }
 
-  static JSONGraph Create(const ObjectRef& root) {
+  /*!
+   * \brief Create the graph of a node.
+   * \param root The root node.
+   * \param tensors The tensors of the graph, which are embedded as base64 if null.
+   */
+  static JSONGraph Create(const ObjectRef& root, std::vector<DLTensor*>* tensors = nullptr) {
     JSONGraph g;
     NodeIndexer indexer;
     indexer.MakeIndex(const_cast<Object*>(root.get()));
@@ -515,6 +526,10 @@ struct JSONGraph {
     }
     g.attrs["tvm_version"] = TVM_VERSION;
     g.root = indexer.node_index_.at(const_cast<Object*>(root.get()));
+    if (tensors != nullptr) {
+      *tensors = indexer.tensor_list_;
+      return g;
+    }
     // serialize tensor
     for (DLTensor* tensor : indexer.tensor_list_) {
       std::string blob;
@@ -571,28 +586,11 @@ std::string SaveJSON(const ObjectRef& n) {
   return os.str();
 }
 
-ObjectRef LoadJSON(std::string json_str) {
+/*! \brief Create the objects of a graph, given its tensors. */
+static ObjectRef LoadGraph(JSONGraph* graph, const std::vector<runtime::NDArray>& tensors) {
   ReflectionVTable* reflection = ReflectionVTable::Global();
-  JSONGraph jgraph;
-  {
-    // load in json graph.
-    std::istringstream is(json_str);
-    dmlc::JSONReader reader(&is);
-    jgraph.Load(&reader);
-  }
+  JSONGraph& jgraph = *graph;
   size_t n_nodes = jgraph.nodes.size();
-  std::vector<runtime::NDArray> tensors;
-  {
-    // load in tensors
-    for (const std::string& blob : jgraph.b64ndarrays) {
-      dmlc::MemoryStringStream mstrm(const_cast<std::string*>(&blob));
-      support::Base64InStream b64strm(&mstrm);
-      b64strm.InitPosition();
-      runtime::NDArray temp;
-      ICHECK(temp.Load(&b64strm));
-      tensors.emplace_back(std::move(temp));
-    }
-  }
   // Pass 1: create all non-container objects
   std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
   for (size_t i = 0; i < n_nodes; ++i) {
@@ -622,6 +620,224 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+ObjectRef LoadJSON(std::string json_str) {
+  JSONGraph jgraph;
+  {
+    // load in json graph.
+    std::istringstream is(json_str);
+    dmlc::JSONReader reader(&is);
+    jgraph.Load(&reader);
+  }
+  std::vector<runtime::NDArray> tensors;
+  {
+    // load in tensors
+    for (const std::string& blob : jgraph.b64ndarrays) {
+      dmlc::MemoryStringStream mstrm(const_cast<std::string*>(&blob));
+      support::Base64InStream b64strm(&mstrm);
+      b64strm.InitPosition();
+      runtime::NDArray temp;
+      ICHECK(temp.Load(&b64strm));
+      tensors.emplace_back(std::move(temp));
+    }
+  }
+  return LoadGraph(&jgraph, tensors);
+}
+
+/*! \brief The magic of the binary IR format. */
+constexpr uint64_t kTVMBinaryIRMagic = 0x4E4942524956544D;
+/*! \brief The version of the binary IR format. */
+constexpr uint64_t kTVMBinaryIRFormatVersion = 1;
+/*! \brief The alignment of the tensor blob in the file, so that it can be mapped. */
+constexpr uint64_t kTVMBinaryIRBlobAlignment = 4096;
+
+inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+/*! \brief The table of the distinct strings of a binary IR file. */
+class StringTable {
+ public:
+  /*! \brief Return the index of a string, adding it to the table if it is new. */
+  uint64_t Intern(const std::string& str) {
+    auto it = index_.emplace(str, strings_.size());
+    if (it.second) {
+      strings_.push_back(str);
+    }
+    return it.first->second;
+  }
+  const std::vector<std::string>& strings() const { return strings_; }
+
+ private:
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint64_t> index_;
+};
+
+/*! \brief Write an attribute map as pairs of interned strings. */
+static void WriteAttrMap(dmlc::Stream* strm, StringTable* table, const AttrMap& attrs) {
+  strm->Write(static_cast<uint64_t>(attrs.size()));
+  for (const auto& kv : attrs) {
+    strm->Write(table->Intern(kv.first));
+    strm->Write(table->Intern(kv.second));
+  }
+}
+
+void SaveBinaryFile(const ObjectRef& node, const std::string& file_name) {
+  // File layout: magic, format version, blob offset, the graph, then the page-aligned blob with
+  // the payload of every tensor, each aligned as NDArray requires. The graph is the string
+  // table, followed by the nodes and the tensors referring to the strings by their index.
+  std::vector<DLTensor*> tensors;
+  JSONGraph jgraph = JSONGraph::Create(node, &tensors);
+  StringTable table;
+  std::string body;
+  {
+    dmlc::MemoryStringStream writer(&body);
+    dmlc::Stream* strm = &writer;
+    strm->Write(static_cast<uint64_t>(jgraph.root));
+    WriteAttrMap(strm, &table, jgraph.attrs);
+    strm->Write(static_cast<uint64_t>(jgraph.nodes.size()));
+    for (const JSONNode& jnode : jgraph.nodes) {
+      strm->Write(table.Intern(jnode.type_key));
+      strm->Write(table.Intern(jnode.repr_bytes));
+      WriteAttrMap(strm, &table, jnode.attrs);
+      strm->Write(static_cast<uint64_t>(jnode.keys.size()));
+      for (const std::string& key : jnode.keys) {
+        strm->Write(table.Intern(key));
+      }
+      strm->Write(std::vector<uint64_t>(jnode.data.begin(), jnode.data.end()));
+    }
+    strm->Write(static_cast<uint64_t>(tensors.size()));
+    uint64_t blob_size = 0;
+    for (DLTensor* tensor : tensors) {
+      uint64_t offset = AlignUp(blob_size, runtime::kAllocAlignment);
+      uint64_t nbytes = runtime::GetDataSize(*tensor);
+      strm->Write(tensor->dtype);
+      strm->Write(std::vector<int64_t>(tensor->shape, tensor->shape + tensor->ndim));
+      strm->Write(offset);
+      strm->Write(nbytes);
+      blob_size = offset + nbytes;
+    }
+  }
+  std::string strings;
+  {
+    dmlc::MemoryStringStream writer(&strings);
+    dmlc::Stream* strm = &writer;
+    strm->Write(table.strings());
+  }
+  std::string head;
+  {
+    dmlc::MemoryStringStream writer(&head);
+    dmlc::Stream* strm = &writer;
+    uint64_t blob_offset =
+        AlignUp(sizeof(uint64_t) * 3 + strings.size() + body.size(), kTVMBinaryIRBlobAlignment);
+    strm->Write(kTVMBinaryIRMagic);
+    strm->Write(kTVMBinaryIRFormatVersion);
+    strm->Write(blob_offset);
+    head += strings;
+    head += body;
+    head.resize(blob_offset, '\0');
+  }
+
+  std::ofstream fs(file_name, std::ios::out | std::ios::binary);
+  CHECK(!fs.fail()) << "ValueError: Cannot open " << file_name;
+  fs.write(head.data(), head.size());
+  // Lay out the tensors the same way as the graph refers to them.
+  uint64_t blob_size = 0;
+  std::vector<char> bytes;
+  for (DLTensor* tensor : tensors) {
+    uint64_t offset = AlignUp(blob_size, runtime::kAllocAlignment);
+    uint64_t nbytes = runtime::GetDataSize(*tensor);
+    fs.write(std::string(offset - blob_size, '\0').data(), offset - blob_size);
+    if (tensor->device.device_type == kDLCPU && runtime::IsContiguous(*tensor)) {
+      fs.write(static_cast<const char*>(tensor->data) + tensor->byte_offset, nbytes);
+    } else {
+      bytes.resize(nbytes);
+      ICHECK_EQ(TVMArrayCopyToBytes(tensor, bytes.data(), nbytes), 0) << TVMGetLastError();
+      fs.write(bytes.data(), nbytes);
+    }
+    blob_size = offset + nbytes;
+  }
+  CHECK(!fs.fail()) << "ValueError: Failed to write " << file_name;
+}
+
+#define BINARY_IR_CHECK(val, file_name) \
+  CHECK(val) << "ValueError: Invalid binary IR file " << file_name
+
+ObjectRef LoadBinaryFile(const std::string& file_name) {
+  auto file = std::make_shared<runtime::MappedFile>(file_name);
+  dmlc::MemoryFixedSizeStream reader(file->data(), file->size());
+  dmlc::Stream* strm = &reader;
+  uint64_t magic, version, blob_offset;
+  BINARY_IR_CHECK(strm->Read(&magic) && magic == kTVMBinaryIRMagic, file_name);
+  BINARY_IR_CHECK(strm->Read(&version), file_name);
+  CHECK_EQ(version, kTVMBinaryIRFormatVersion)
+      << "ValueError: Unsupported version " << version << " of the binary IR file " << file_name;
+  BINARY_IR_CHECK(strm->Read(&blob_offset) && blob_offset <= file->size(), file_name);
+  std::vector<std::string> strings;
+  BINARY_IR_CHECK(strm->Read(&strings), file_name);
+  auto read_string = [&](std::string* value) {
+    uint64_t index;
+    BINARY_IR_CHECK(strm->Read(&index) && index < strings.size(), file_name);
+    *value = strings[index];
+  };
+  auto read_attrs = [&](AttrMap* attrs) {
+    uint64_t size;
+    BINARY_IR_CHECK(strm->Read(&size), file_name);
+    for (uint64_t i = 0; i < size; ++i) {
+      std::string key;
+      read_string(&key);
+      read_string(&(*attrs)[key]);
+    }
+  };
+
+  JSONGraph jgraph;
+  uint64_t root, num_nodes;
+  BINARY_IR_CHECK(strm->Read(&root), file_name);
+  read_attrs(&jgraph.attrs);
+  // The binary format is a cache, which is not upgraded across versions like the JSON one.
+  auto it = jgraph.attrs.find("tvm_version");
+  CHECK(it != jgraph.attrs.end() && it->second == TVM_VERSION)
+      << "ValueError: The binary IR file " << file_name << " was saved by another version of TVM";
+  BINARY_IR_CHECK(strm->Read(&num_nodes) && root < num_nodes, file_name);
+  jgraph.root = root;
+  jgraph.nodes.resize(num_nodes);
+  for (JSONNode& jnode : jgraph.nodes) {
+    read_string(&jnode.type_key);
+    read_string(&jnode.repr_bytes);
+    read_attrs(&jnode.attrs);
+    uint64_t num_keys;
+    BINARY_IR_CHECK(strm->Read(&num_keys), file_name);
+    jnode.keys.resize(num_keys);
+    for (std::string& key : jnode.keys) {
+      read_string(&key);
+    }
+    std::vector<uint64_t> data;
+    BINARY_IR_CHECK(strm->Read(&data), file_name);
+    for (uint64_t index : data) {
+      BINARY_IR_CHECK(index < num_nodes, file_name);
+    }
+    jnode.data.assign(data.begin(), data.end());
+  }
+  uint64_t num_tensors;
+  BINARY_IR_CHECK(strm->Read(&num_tensors), file_name);
+  std::vector<runtime::NDArray> tensors;
+  for (uint64_t i = 0; i < num_tensors; ++i) {
+    DLDataType dtype;
+    std::vector<int64_t> shape;
+    uint64_t offset, nbytes;
+    BINARY_IR_CHECK(strm->Read(&dtype) && strm->Read(&shape), file_name);
+    BINARY_IR_CHECK(strm->Read(&offset) && strm->Read(&nbytes), file_name);
+    BINARY_IR_CHECK(blob_offset + offset + nbytes <= file->size(), file_name);
+    // View the mapping, the tensor keeps the file mapped while alive.
+    tensors.push_back(
+        runtime::MappedFile::View(file, blob_offset + offset, runtime::ShapeTuple(shape), dtype));
+  }
+  return LoadGraph(&jgraph, tensors);
+}
+
+TVM_REGISTER_GLOBAL("node.SaveBinaryFile").set_body_typed(SaveBinaryFile);
+
+TVM_REGISTER_GLOBAL("node.LoadBinaryFile").set_body_typed(LoadBinaryFile);
+
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
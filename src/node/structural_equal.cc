@@ -25,6 +25,7 @@
 #include <tvm/node/object_path.h>
 #include <tvm/node/reflection.h>
 #include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_memo.h>
 #include <tvm/runtime/registry.h>
 
 #include <unordered_map>
@@ -460,10 +461,28 @@ bool SEqualHandlerDefault::DispatchSEqualReduce(const ObjectRef& lhs, const Obje
   return impl->DispatchSEqualReduce(lhs, rhs, map_free_vars, current_paths);
 }
 
+/*! \brief Compare two objects, through the memo of the current scope if any. */
+static bool MemoizedEqual(const ObjectRef& lhs, const ObjectRef& rhs, bool map_free_vars) {
+  Optional<StructuralMemo> memo = StructuralMemo::Current();
+  bool equal;
+  if (memo.defined() && memo.value()->LookupEqual(lhs, rhs, map_free_vars, &equal)) {
+    return equal;
+  }
+  equal = SEqualHandlerDefault(false, nullptr).Equal(lhs, rhs, map_free_vars);
+  if (memo.defined()) {
+    memo.value()->SetEqual(lhs, rhs, map_free_vars, equal);
+  }
+  return equal;
+}
+
 TVM_REGISTER_GLOBAL("node.StructuralEqual")
     .set_body_typed([](const ObjectRef& lhs, const ObjectRef& rhs, bool assert_mode,
                        bool map_free_vars) {
-      return SEqualHandlerDefault(assert_mode, nullptr).Equal(lhs, rhs, map_free_vars);
+      // The assert mode reports the first mismatch, so it always compares.
+      if (assert_mode) {
+        return SEqualHandlerDefault(true, nullptr).Equal(lhs, rhs, map_free_vars);
+      }
+      return MemoizedEqual(lhs, rhs, map_free_vars);
     });
 
 TVM_REGISTER_GLOBAL("node.GetFirstStructuralMismatch")
@@ -475,7 +494,7 @@ TVM_REGISTER_GLOBAL("node.GetFirstStructuralMismatch")
     });
 
 bool StructuralEqual::operator()(const ObjectRef& lhs, const ObjectRef& rhs) const {
-  return SEqualHandlerDefault(false, nullptr).Equal(lhs, rhs, false);
+  return MemoizedEqual(lhs, rhs, false);
 }
 
 bool NDArrayEqual(const runtime::NDArray::Container* lhs, const runtime::NDArray::Container* rhs,
@@ -25,6 +25,7 @@
 #include <tvm/node/object_path.h>
 #include <tvm/node/reflection.h>
 #include <tvm/node/structural_hash.h>
+#include <tvm/node/structural_memo.h>
 #include <tvm/runtime/container/adt.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
@@ -287,14 +288,28 @@ void SHashHandlerDefault::DispatchSHash(const ObjectRef& key, bool map_free_vars
   impl->DispatchSHash(key, map_free_vars);
 }
 
+/*! \brief Hash an object, through the memo of the current scope if any. */
+static size_t MemoizedHash(const ObjectRef& object, bool map_free_vars) {
+  Optional<StructuralMemo> memo = StructuralMemo::Current();
+  size_t hashed_value;
+  if (memo.defined() && memo.value()->LookupHash(object, map_free_vars, &hashed_value)) {
+    return hashed_value;
+  }
+  hashed_value = SHashHandlerDefault().Hash(object, map_free_vars);
+  if (memo.defined()) {
+    memo.value()->SetHash(object, map_free_vars, hashed_value);
+  }
+  return hashed_value;
+}
+
 TVM_REGISTER_GLOBAL("node.StructuralHash")
     .set_body_typed([](const ObjectRef& object, bool map_free_vars) -> int64_t {
-      size_t hashed_value = SHashHandlerDefault().Hash(object, map_free_vars);
+      size_t hashed_value = MemoizedHash(object, map_free_vars);
       return static_cast<int64_t>(hashed_value);
     });
 
 size_t StructuralHash::operator()(const ObjectRef& object) const {
-  return SHashHandlerDefault().Hash(object, false);
+  return MemoizedHash(object, false);
 }
 
 // SEQualReduce traits for runtime containers.
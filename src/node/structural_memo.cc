@@ -0,0 +1,154 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/node/structural_memo.cc
+ * \brief The scoped memo of the structural hashes and equalities.
+ */
+#include <tvm/ir/module.h>
+#include <tvm/node/structural_memo.h>
+#include <tvm/runtime/registry.h>
+
+#include <vector>
+
+namespace tvm {
+
+/*! \brief Whether an object may be memoized, i.e. is no container of mutable objects. */
+static bool IsMemoizable(const ObjectRef& object) {
+  return object.as<ArrayNode>() == nullptr && object.as<MapNode>() == nullptr;
+}
+
+/*! \brief The fields of an object which are replaced when it is mutated in place. */
+static Array<ObjectRef> MutableFields(const ObjectRef& object) {
+  if (const auto* mod = object.as<IRModuleNode>()) {
+    return {mod->functions, mod->type_definitions, mod->attrs};
+  }
+  return {};
+}
+
+/*! \brief Whether no field of a memoized object was replaced since it was recorded. */
+static bool IsUnchanged(const ObjectRef& object, const Array<ObjectRef>& fields) {
+  Array<ObjectRef> current = MutableFields(object);
+  for (size_t i = 0; i < fields.size(); ++i) {
+    if (!current[i].same_as(fields[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool StructuralMemoNode::LookupHash(const ObjectRef& object, bool map_free_vars,
+                                    size_t* hash_value) {
+  if (!IsMemoizable(object)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& hashes = hashes_[map_free_vars];
+  auto it = hashes.find(object.get());
+  if (it == hashes.end() || !IsUnchanged(object, it->second.first.fields)) {
+    return false;
+  }
+  *hash_value = it->second.second;
+  ++num_hits_;
+  return true;
+}
+
+void StructuralMemoNode::SetHash(const ObjectRef& object, bool map_free_vars, size_t hash_value) {
+  if (!IsMemoizable(object)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  hashes_[map_free_vars][object.get()] = {{object, MutableFields(object)}, hash_value};
+}
+
+bool StructuralMemoNode::LookupEqual(const ObjectRef& lhs, const ObjectRef& rhs,
+                                     bool map_free_vars, bool* equal) {
+  if (!IsMemoizable(lhs) || !IsMemoizable(rhs)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& equals = equals_[map_free_vars];
+  auto it = equals.find({lhs.get(), rhs.get()});
+  if (it == equals.end() || !IsUnchanged(lhs, it->second.first.first.fields) ||
+      !IsUnchanged(rhs, it->second.first.second.fields)) {
+    return false;
+  }
+  *equal = it->second.second;
+  ++num_hits_;
+  return true;
+}
+
+void StructuralMemoNode::SetEqual(const ObjectRef& lhs, const ObjectRef& rhs, bool map_free_vars,
+                                  bool equal) {
+  if (!IsMemoizable(lhs) || !IsMemoizable(rhs)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  equals_[map_free_vars][{lhs.get(), rhs.get()}] = {
+      {{lhs, MutableFields(lhs)}, {rhs, MutableFields(rhs)}}, equal};
+}
+
+int64_t StructuralMemoNode::NumHits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+/*! \brief The stack of the memo scopes entered on this thread. */
+static std::vector<StructuralMemo>* MemoStack() {
+  static thread_local std::vector<StructuralMemo> stack;
+  return &stack;
+}
+
+StructuralMemo::StructuralMemo() { data_ = make_object<StructuralMemoNode>(); }
+
+Optional<StructuralMemo> StructuralMemo::Current() {
+  std::vector<StructuralMemo>* stack = MemoStack();
+  if (stack->empty()) {
+    return NullOpt;
+  }
+  return stack->back();
+}
+
+void StructuralMemo::EnterWithScope() { MemoStack()->push_back(*this); }
+
+void StructuralMemo::ExitWithScope() {
+  std::vector<StructuralMemo>* stack = MemoStack();
+  ICHECK(!stack->empty() && stack->back().same_as(*this)) << "The memo scopes are not nested";
+  stack->pop_back();
+}
+
+TVM_REGISTER_OBJECT_TYPE(StructuralMemoNode);
+
+class StructuralMemo::Internal {
+ public:
+  static void EnterScope(StructuralMemo memo) { memo.EnterWithScope(); }
+  static void ExitScope(StructuralMemo memo) { memo.ExitWithScope(); }
+};
+
+TVM_REGISTER_GLOBAL("node.StructuralMemo").set_body_typed([]() { return StructuralMemo(); });
+
+TVM_REGISTER_GLOBAL("node.StructuralMemoEnter")
+    .set_body_typed(StructuralMemo::Internal::EnterScope);
+
+TVM_REGISTER_GLOBAL("node.StructuralMemoExit").set_body_typed(StructuralMemo::Internal::ExitScope);
+
+TVM_REGISTER_GLOBAL("node.StructuralMemoNumHits").set_body_typed([](StructuralMemo memo) {
+  return memo->NumHits();
+});
+
+}  // namespace tvm
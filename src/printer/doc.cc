@@ -27,100 +27,69 @@
 
 #include <tvm/runtime/packed_func.h>
 
-#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "../support/str_escape.h"
 
 namespace tvm {
 
-/*!
- * \brief Represent a piece of text in the doc.
- */
-class DocTextNode : public DocAtomNode {
- public:
-  /*! \brief The str content in the text. */
-  std::string str;
-
-  explicit DocTextNode(std::string str_val) : str(str_val) {}
-
-  static constexpr const char* _type_key = "printer.DocText";
-  TVM_DECLARE_FINAL_OBJECT_INFO(DocTextNode, DocAtomNode);
-};
-
-TVM_REGISTER_OBJECT_TYPE(DocTextNode);
-
-class DocText : public DocAtom {
- public:
-  explicit DocText(std::string str) { data_ = runtime::make_object<DocTextNode>(str); }
-
-  TVM_DEFINE_OBJECT_REF_METHODS(DocText, DocAtom, DocTextNode);
-};
-
-/*!
- * \brief Represent a line breaker in the doc.
- */
-class DocLineNode : public DocAtomNode {
- public:
-  /*! \brief The amount of indent in newline. */
-  int indent;
-
-  explicit DocLineNode(int indent) : indent(indent) {}
-
-  static constexpr const char* _type_key = "printer.DocLine";
-  TVM_DECLARE_FINAL_OBJECT_INFO(DocLineNode, DocAtomNode);
-};
-
-TVM_REGISTER_OBJECT_TYPE(DocLineNode);
-
-class DocLine : public DocAtom {
- public:
-  explicit DocLine(int indent) { data_ = runtime::make_object<DocLineNode>(indent); }
-
-  TVM_DEFINE_OBJECT_REF_METHODS(DocLine, DocAtom, DocLineNode);
-};
-
 // DSL function implementations
 Doc& Doc::operator<<(const Doc& right) {
   ICHECK(this != &right);
-  this->stream_.insert(this->stream_.end(), right.stream_.begin(), right.stream_.end());
+  size_t offset = text_.size();
+  text_ += right.text_;
+  for (const Line& line : right.lines_) {
+    lines_.push_back({line.pos + offset, line.indent});
+  }
   return *this;
 }
 
-Doc& Doc::operator<<(std::string right) { return *this << DocText(right); }
-
-Doc& Doc::operator<<(const DocAtom& right) {
-  this->stream_.push_back(right);
+Doc& Doc::operator<<(std::string right) {
+  if (text_.empty()) {
+    text_ = std::move(right);
+  } else {
+    text_ += right;
+  }
   return *this;
 }
 
 std::string Doc::str() {
-  std::ostringstream os;
-  for (auto atom : this->stream_) {
-    if (auto* text = atom.as<DocTextNode>()) {
-      os << text->str;
-    } else if (auto* line = atom.as<DocLineNode>()) {
-      os << "\n" << std::string(line->indent, ' ');
-    } else {
-      LOG(FATAL) << "do not expect type " << atom->GetTypeKey();
-    }
+  size_t size = text_.size();
+  for (const Line& line : lines_) {
+    size += 1 + line.indent;
   }
-  return os.str();
+  std::string ret;
+  ret.reserve(size);
+  size_t pos = 0;
+  for (const Line& line : lines_) {
+    ret.append(text_, pos, line.pos - pos);
+    ret.push_back('\n');
+    ret.append(line.indent, ' ');
+    pos = line.pos;
+  }
+  ret.append(text_, pos, std::string::npos);
+  return ret;
 }
 
-Doc Doc::NewLine(int indent) { return Doc() << DocLine(indent); }
-
-Doc Doc::Text(std::string text) { return Doc() << DocText(text); }
+Doc Doc::NewLine(int indent) {
+  Doc doc;
+  doc.lines_.push_back({0, indent});
+  return doc;
+}
 
-Doc Doc::RawText(std::string text) {
-  return Doc() << DocAtom(runtime::make_object<DocTextNode>(text));
+Doc Doc::Text(std::string text) {
+  Doc doc;
+  doc.text_ = std::move(text);
+  return doc;
 }
 
+Doc Doc::RawText(std::string text) { return Text(std::move(text)); }
+
 Doc Doc::Indent(int indent, Doc doc) {
-  for (size_t i = 0; i < doc.stream_.size(); ++i) {
-    if (auto* line = doc.stream_[i].as<DocLineNode>()) {
-      doc.stream_[i] = DocLine(indent + line->indent);
-    }
+  for (Line& line : doc.lines_) {
+    line.indent += indent;
   }
   return doc;
 }
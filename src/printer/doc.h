@@ -36,25 +36,6 @@
 
 namespace tvm {
 
-/*!
- * \brief Doc atom node for the ADT.
- * \sa DocAtom
- */
-class DocAtomNode : public Object {
- public:
-  static constexpr const char* _type_key = "printer.DocAtom";
-  TVM_DECLARE_BASE_OBJECT_INFO(DocAtomNode, Object);
-};
-
-/*!
- * \brief Managed reference to DocAtomNode.
- * \sa DocAtomNode.
- */
-class DocAtom : public ObjectRef {
- public:
-  TVM_DEFINE_OBJECT_REF_METHODS(DocAtom, ObjectRef, DocAtomNode);
-};
-
 /*!
  * \brief Stream-like interface for Doc DSL.
  *
@@ -63,6 +44,10 @@ class DocAtom : public ObjectRef {
  * The layout(code formating) decisions include:
  * - Change indentation.
  * - Break single line into multiple ones(subjected to future improvements).
+ *
+ * The doc is kept as a flat text buffer with the positions of its line breaks, so that appending
+ * a doc is a copy of its text rather than of a list of allocated atoms, and indenting a doc only
+ * updates the indents of its line breaks. It makes the printing of large modules linear.
  */
 class Doc {
  public:
@@ -81,12 +66,6 @@ class Doc {
    * \note pass by value to allow copy elison optimization.
    */
   Doc& operator<<(std::string right);
-  /*!
-   * \brief Append right to the end of the current doc stream.
-   * \param right The doc to be appended.
-   * \return reference to self.
-   */
-  Doc& operator<<(const DocAtom& right);
   /*!
    * \brief Convert value to string via std::ostreamstream
    *        the append to the current doc stream.
@@ -159,8 +138,18 @@ class Doc {
   static Doc Concat(const std::vector<Doc>& vec, const Doc& sep = Text(", "));
 
  private:
-  /*! \brief Internal doc stream. */
-  std::vector<DocAtom> stream_;
+  /*! \brief A line break, followed by the indent. */
+  struct Line {
+    /*! \brief The position of the line break in the text. */
+    size_t pos;
+    /*! \brief The amount of indent in newline. */
+    int indent;
+  };
+
+  /*! \brief The text, without the line breaks. */
+  std::string text_;
+  /*! \brief The line breaks, in the order of their positions. */
+  std::vector<Line> lines_;
 };
 
 }  // namespace tvm
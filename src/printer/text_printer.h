@@ -614,12 +614,14 @@ class TextPrinter {
   }
 
   Doc PrintRelax(const ObjectRef& node) {
-    relax_text_printer_.Print(node);
+    // The node is printed once; the metadata it collects is prepended and only serialized when
+    // it is shown.
+    Doc body = relax_text_printer_.Print(node);
     Doc doc;
     if (show_meta_data_ && !meta_.empty()) {
       doc << "metadata = tvm.ir.load_json(" << meta_.GetMetaSection() << ")" << Doc::NewLine();
     }
-    doc << relax_text_printer_.Print(node);
+    doc << body;
     return doc;
   }
 
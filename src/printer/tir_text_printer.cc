@@ -367,6 +367,9 @@ Doc TIRTextPrinter::VisitExpr_(const SelectNode* op) {
 Doc TIRTextPrinter::VisitExpr_(const BufferLoadNode* op) {
   Doc doc;
   doc << Print(op->buffer) << Print(op->indices);
+  if (op->predicate.defined()) {
+    doc << " if " << Print(op->predicate.value());
+  }
   return doc;
 }
 
@@ -487,6 +490,9 @@ Doc TIRTextPrinter::VisitStmt_(const StoreNode* op) {
 Doc TIRTextPrinter::VisitStmt_(const BufferStoreNode* op) {
   Doc doc;
   doc << Print(op->buffer) << Print(op->indices) << " = " << Print(op->value);
+  if (op->predicate.defined()) {
+    doc << " if " << Print(op->predicate.value());
+  }
   return doc;
 }
 
@@ -910,7 +910,14 @@ Doc TVMScriptPrinter::VisitExpr_(const ProducerLoadNode* op, ExprPrecedence* out
 Doc TVMScriptPrinter::VisitExpr_(const BufferLoadNode* op, ExprPrecedence* out_precedence) {
   *out_precedence = ExprPrecedence::kIdentity;
   Doc doc;
-  if (op->indices.size() == 0) {
+  if (op->predicate.defined()) {
+    std::vector<Doc> indices;
+    for (const PrimExpr& index : op->indices) {
+      indices.push_back(Print(index));
+    }
+    doc << Print(op->buffer) << ".vload([" << PrintSep(indices, Doc::Text(", "))
+        << "], predicate=" << Print(op->predicate.value()) << ")";
+  } else if (op->indices.size() == 0) {
     doc << Print(op->buffer) << "[()]";
   } else {
     doc << Print(op->buffer) << PrintBufferIndices(op->indices);
@@ -1384,7 +1391,15 @@ Doc TVMScriptPrinter::VisitType_(const TupleTypeNode* node) {
 
 Doc TVMScriptPrinter::VisitStmt_(const BufferStoreNode* op) {
   Doc doc;
-  if (op->indices.size() == 0) {
+  if (op->predicate.defined()) {
+    std::vector<Doc> indices;
+    for (const PrimExpr& index : op->indices) {
+      indices.push_back(Print(index));
+    }
+    doc << tir_prefix_ << ".buffer_store(" << Print(op->buffer) << ", " << Print(op->value)
+        << ", [" << PrintSep(indices, Doc::Text(", "))
+        << "], predicate=" << Print(op->predicate.value()) << ")";
+  } else if (op->indices.size() == 0) {
     doc << Print(op->buffer) << "[()] = " << Print(op->value);
   } else {
     doc << Print(op->buffer) << PrintBufferIndices(op->indices) << " = " << Print(op->value);
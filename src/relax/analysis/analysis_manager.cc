@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/analysis/analysis_manager.cc
+ * \brief The manager of the analysis results across the passes of a pipeline.
+ */
+#include <dmlc/thread_local.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/runtime/registry.h>
+
+#include <stack>
+#include <unordered_set>
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_NODE_TYPE(AnalysisManagerNode);
+
+AnalysisManager::AnalysisManager() { data_ = make_object<AnalysisManagerNode>(); }
+
+/*! \brief Entry to hold the AnalysisManager context stack. */
+struct AnalysisManagerThreadLocalEntry {
+  /*! \brief The current analysis manager context */
+  std::stack<AnalysisManager> context_stack;
+};
+
+/*! \brief Thread local store to hold the AnalysisManager context stack. */
+using AnalysisManagerThreadLocalStore = dmlc::ThreadLocalStore<AnalysisManagerThreadLocalEntry>;
+
+void AnalysisManager::EnterWithScope() {
+  AnalysisManagerThreadLocalStore::Get()->context_stack.push(*this);
+}
+
+void AnalysisManager::ExitWithScope() {
+  AnalysisManagerThreadLocalEntry* entry = AnalysisManagerThreadLocalStore::Get();
+  ICHECK(!entry->context_stack.empty());
+  ICHECK(entry->context_stack.top().same_as(*this));
+  entry->context_stack.pop();
+}
+
+Optional<AnalysisManager> AnalysisManager::Current() {
+  AnalysisManagerThreadLocalEntry* entry = AnalysisManagerThreadLocalStore::Get();
+  if (entry->context_stack.empty()) {
+    return NullOpt;
+  }
+  return entry->context_stack.top();
+}
+
+/*! \brief Collect the dataflow blocks of a function, including those of its local functions. */
+class DataflowBlockCollector : public ExprVisitor {
+ public:
+  std::unordered_set<const DataflowBlockNode*> blocks;
+
+  void VisitBindingBlock_(const DataflowBlockNode* block) final {
+    blocks.insert(block);
+    ExprVisitor::VisitBindingBlock_(block);
+  }
+};
+
+void AnalysisManagerNode::Invalidate(const IRModule& m) {
+  std::unordered_set<const Object*> live_functions;
+  DataflowBlockCollector collector;
+  for (const auto& it : m->functions) {
+    if (const auto* func = it.second.as<FunctionNode>()) {
+      live_functions.insert(func);
+      collector.VisitExpr(GetRef<Function>(func));
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = functions_.begin(); it != functions_.end();) {
+    it = live_functions.count(it->first.get()) ? std::next(it) : functions_.erase(it);
+  }
+  for (auto it = blocks_.begin(); it != blocks_.end();) {
+    it = collector.blocks.count(it->first.get()) ? std::next(it) : blocks_.erase(it);
+  }
+}
+
+class AnalysisManagerInternal {
+ public:
+  static void EnterScope(AnalysisManager manager) { manager.EnterWithScope(); }
+  static void ExitScope(AnalysisManager manager) { manager.ExitWithScope(); }
+};
+
+TVM_REGISTER_GLOBAL("relax.analysis.AnalysisManager").set_body_typed([]() {
+  return AnalysisManager();
+});
+TVM_REGISTER_GLOBAL("relax.analysis.AnalysisManagerEnterScope")
+    .set_body_typed(AnalysisManagerInternal::EnterScope);
+TVM_REGISTER_GLOBAL("relax.analysis.AnalysisManagerExitScope")
+    .set_body_typed(AnalysisManagerInternal::ExitScope);
+TVM_REGISTER_GLOBAL("relax.analysis.AnalysisManagerWellFormed")
+    .set_body_typed([](AnalysisManager manager, IRModule m) { return manager->WellFormed(m); });
+TVM_REGISTER_GLOBAL("relax.analysis.AnalysisManagerInvalidate")
+    .set_body_typed([](AnalysisManager manager, IRModule m) { manager->Invalidate(m); });
+TVM_REGISTER_GLOBAL("relax.analysis.AnalysisManagerNumCachedFunctions")
+    .set_body_typed([](AnalysisManager manager) {
+      return static_cast<int64_t>(manager->NumCachedFunctions());
+    });
+
+}  // namespace relax
+}  // namespace tvm
@@ -28,6 +28,8 @@
 
 #include <cstddef>
 #include <limits>
+#include <map>
+#include <set>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -59,8 +61,7 @@ class UDChain : public relax::ExprVisitor {
   }
 };
 
-std::pair<runtime::Map<Var, runtime::Array<Var>>, runtime::Array<Var>> FunctionUseDef(
-    const Function& fn) {
+static std::pair<Map<Var, Array<Var>>, Array<Var>> ComputeFunctionUseDef(const Function& fn) {
   UDChain udchain;
   udchain.VisitExpr_(fn.get());
 
@@ -83,7 +84,7 @@ std::pair<runtime::Map<Var, runtime::Array<Var>>, runtime::Array<Var>> FunctionU
   return std::make_pair(std::move(user_map), std::move(fn_outs));
 }
 
-runtime::Map<Var, Array<Var>> DataflowBlockUseDef(const DataflowBlock& dfb) {
+static Map<Var, Array<Var>> ComputeDataflowBlockUseDef(const DataflowBlock& dfb) {
   UDChain udchain;
   udchain.VisitBindingBlock_(dfb.get());
   runtime::Map<Var, Array<Var>> ret;
@@ -96,6 +97,41 @@ runtime::Map<Var, Array<Var>> DataflowBlockUseDef(const DataflowBlock& dfb) {
   return ret;
 }
 
+std::pair<Map<Var, Array<Var>>, Array<Var>> AnalysisManagerNode::FunctionUseDef(
+    const Function& fn) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FunctionEntry& entry = functions_[fn];
+  if (!entry.has_use_def) {
+    entry.use_def = ComputeFunctionUseDef(fn);
+    entry.has_use_def = true;
+  }
+  return entry.use_def;
+}
+
+Map<Var, Array<Var>> AnalysisManagerNode::DataflowBlockUseDef(const DataflowBlock& dfb) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = blocks_.find(dfb);
+  if (it == blocks_.end()) {
+    it = blocks_.emplace(dfb, ComputeDataflowBlockUseDef(dfb)).first;
+  }
+  return it->second;
+}
+
+std::pair<runtime::Map<Var, runtime::Array<Var>>, runtime::Array<Var>> FunctionUseDef(
+    const Function& fn) {
+  if (Optional<AnalysisManager> manager = AnalysisManager::Current()) {
+    return manager.value()->FunctionUseDef(fn);
+  }
+  return ComputeFunctionUseDef(fn);
+}
+
+runtime::Map<Var, Array<Var>> DataflowBlockUseDef(const DataflowBlock& dfb) {
+  if (Optional<AnalysisManager> manager = AnalysisManager::Current()) {
+    return manager.value()->DataflowBlockUseDef(dfb);
+  }
+  return ComputeDataflowBlockUseDef(dfb);
+}
+
 TVM_REGISTER_GLOBAL("relax.analysis.udchain").set_body_typed(DataflowBlockUseDef);
 
 }  // namespace relax
@@ -48,6 +48,9 @@
  *           * The op or args fields of Call nodes
  *           * Inside the fields of Tuple nodes
  *    8. Expr always has checked_type_ (with the exception of Op).
+ * Each function is checked on its own, and then the GlobalVars it uses and the params it shares
+ * with the other functions are checked against the module, so that the AnalysisManager can reuse
+ * the results of the functions a pass did not change.
  */
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr.h>
@@ -55,7 +58,10 @@
 #include <tvm/relax/utils.h>
 #include <tvm/tir/expr_functor.h>
 
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../../printer/text_printer.h"
 
@@ -76,12 +82,16 @@ class PrimExprVisitor : public tir::ExprVisitor {
   void VisitExpr_(const tir::VarNode* op);
 };
 
-/*! \brief Helper to implement well formed check.*/
+/*! \brief Helper to implement well formed check of a function.*/
 class WellFormedChecker : public relax::ExprVisitor {
  public:
   Optional<DiagnosticContext> diag_ctx;
 
   bool well_formed = true;
+  /*! \brief The GlobalVars used, to be checked against the module. */
+  std::vector<GlobalVar> global_vars;
+  /*! \brief The params of the functions visited, to be checked across the module. */
+  std::vector<std::pair<Var, Function>> params;
 
   explicit WellFormedChecker(const Optional<DiagnosticContext>& ctx)
       : diag_ctx(ctx), prim_expr_visitor_(this) {}
@@ -99,14 +109,11 @@ class WellFormedChecker : public relax::ExprVisitor {
     ExprVisitor::VisitExpr(expr);
   }
 
-  void RegisterGlobalVar(GlobalVar var) { global_var_set_.insert(var); }
-
  private:
   void VisitExpr_(const GlobalVarNode* op) {
     GlobalVar var = GetRef<GlobalVar>(op);
-    if (global_var_set_.count(var) == 0) {
-      Malformed(Diagnostic::Error(var->span)
-                << "GlobalVar " << op->name_hint << " is not defined.");
+    if (global_var_set_.insert(var).second) {
+      global_vars.push_back(var);
     }
 
     if (op->checked_type_.defined()) {
@@ -184,15 +191,7 @@ class WellFormedChecker : public relax::ExprVisitor {
       }
 
       this->VisitVarDef(param);
-
-      if (param_var_func_map_.count(param) == 1) {
-        Malformed(Diagnostic::Error(param->span)
-                  << "Relax variable " << param->name_hint()
-                  << " is repeatedly used as parameters in function:\n"
-                  << AsRelaxScript(param_var_func_map_[param], false)
-                  << "\nand function:\n" << AsRelaxScript(func, false));
-      }
-      param_var_func_map_.insert({param, func});
+      params.emplace_back(param, func);
     }
     if (auto seq = op->body.as<SeqExprNode>()) {
       this->VisitSeqExpr(seq);
@@ -350,7 +349,6 @@ class WellFormedChecker : public relax::ExprVisitor {
   std::unordered_set<GlobalVar, ObjectPtrHash, ObjectPtrEqual> global_var_set_;
   std::unordered_set<Var, ObjectPtrHash, ObjectPtrEqual> var_set_;
   std::unordered_set<DataflowVar, ObjectPtrHash, ObjectPtrEqual> dataflow_var_set_;
-  std::unordered_map<Var, Function, ObjectPtrHash, ObjectPtrEqual> param_var_func_map_;
 
   PrimExprVisitor prim_expr_visitor_;
 };
@@ -363,22 +361,59 @@ void PrimExprVisitor::VisitExpr_(const tir::VarNode* op) {
   }
 }
 
-bool WellFormed(const IRModule& m, Optional<DiagnosticContext> diag_ctx) {
-  WellFormedChecker well_formed_checker = WellFormedChecker(diag_ctx);
-  for (const auto& it : m->functions) {
-    // register GlobalVar in the IRModule first
-    well_formed_checker.RegisterGlobalVar(it.first);
-  }
-
+bool AnalysisManagerNode::WellFormed(const IRModule& m, Optional<DiagnosticContext> diag_ctx) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool well_formed = true;
+  auto malformed = [&well_formed](Diagnostic diag) {
+    well_formed = false;
+    LOG(WARNING) << "This IR is not well formed: " << diag->message;
+  };
+  std::unordered_map<Var, Function, ObjectPtrHash, ObjectPtrEqual> param_var_func_map;
   for (const auto& it : m->functions) {
     // visit relax.Function
-    if (auto* n = it.second.as<FunctionNode>()) {
-      Function func = GetRef<Function>(n);
-      well_formed_checker.VisitExpr(func);
+    auto* n = it.second.as<FunctionNode>();
+    if (n == nullptr) {
+      continue;
+    }
+    Function func = GetRef<Function>(n);
+    FunctionEntry& entry = functions_[func];
+    if (!entry.well_formed) {
+      // the malformed functions are checked again to log the messages
+      WellFormedChecker checker(diag_ctx);
+      checker.VisitExpr(func);
+      entry.well_formed = checker.well_formed;
+      entry.global_vars = std::move(checker.global_vars);
+      entry.params = std::move(checker.params);
+      well_formed &= checker.well_formed;
+    }
+    for (const GlobalVar& var : entry.global_vars) {
+      if (m->functions.count(var) == 0) {
+        malformed(Diagnostic::Error(var->span)
+                  << "GlobalVar " << var->name_hint << " is not defined.");
+      }
+    }
+    for (const auto& param_func : entry.params) {
+      const Var& param = param_func.first;
+      auto param_it = param_var_func_map.find(param);
+      if (param_it != param_var_func_map.end()) {
+        malformed(Diagnostic::Error(param->span)
+                  << "Relax variable " << param->name_hint()
+                  << " is repeatedly used as parameters in function:\n"
+                  << AsRelaxScript(param_it->second, false) << "\nand function:\n"
+                  << AsRelaxScript(param_func.second, false));
+      } else {
+        param_var_func_map.emplace(param, param_func.second);
+      }
     }
   }
+  return well_formed;
+}
 
-  return well_formed_checker.well_formed;
+bool WellFormed(const IRModule& m, Optional<DiagnosticContext> diag_ctx) {
+  if (Optional<AnalysisManager> manager = AnalysisManager::Current()) {
+    return manager.value()->WellFormed(m, diag_ctx);
+  }
+  return AnalysisManager()->WellFormed(m, diag_ctx);
 }
 
 TVM_REGISTER_GLOBAL(("relax.analysis.well_formed")).set_body_typed([](IRModule m) {
@@ -0,0 +1,324 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/backend/aot/aot_lower_main.cc
+ * \brief Lower the Relax main function into an AOT TIR main function calling the kernels directly.
+ */
+#include <tvm/relax/attrs/memory.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/type.h>
+#include <tvm/runtime/name_transforms.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../../runtime/meta_data.h"
+
+namespace tvm {
+namespace relax {
+
+// ==================
+// AOTLowerMain
+// Lower the Relax main function with static shapes, after CallTIRRewrite, into a TIR main
+// function which calls the kernels through tvm_call_cpacked, so that it runs without the VM.
+// Example:
+// def main(x: Tensor((16,), "float32")):
+//   alloc = relax.builtin.alloc_tensor((16,), dtype="float32")
+//   _ = exp(x, alloc)
+//   alloc1 = relax.builtin.alloc_tensor((16,), dtype="float32")
+//   _ = log(alloc, alloc1)
+//   return alloc1
+// -->
+// def __tvm_main__(x: T.handle, output: T.handle):
+//   sid_0 = T.allocate([64], "int8", "global.workspace")
+//   T.tvm_call_cpacked("exp", x_buffer_var, sid_0, T.reinterpret(T.uint64(0), dtype="handle"))
+//   T.tvm_call_cpacked("log", sid_0, output_buffer_var, T.reinterpret(...))
+//
+// The tensors allocated by the function become the allocates of the TIR main function, which
+// USMP plans into the workspace pools, except the ones returned, which the kernels write in the
+// output buffers directly. The inputs, constants and the tensors returned more than once are
+// copied to the outputs. Like the Relay AOT main function, the packed calls are to be legalized
+// by LegalizePackedCalls.
+
+/*! \brief A tensor of the TIR main function. */
+struct AOTTensor {
+  /*! \brief The pointer to the data of the tensor. */
+  tir::Var data;
+  /*! \brief The static shape of the tensor. */
+  Array<PrimExpr> shape;
+  /*! \brief The dtype of the tensor. */
+  DataType dtype;
+
+  int64_t NumBytes() const {
+    int64_t size = (dtype.bits() * dtype.lanes() + 7) / 8;
+    for (const PrimExpr& dim : shape) {
+      size *= Downcast<IntImm>(dim)->value;
+    }
+    return size;
+  }
+};
+
+class AOTMainLowerer {
+ public:
+  explicit AOTMainLowerer(IRModule mod) : mod_(mod) {}
+
+  IRModule Lower(const String& mod_name) {
+    GlobalVar main_gv;
+    for (const auto& kv : mod_->functions) {
+      if (kv.second->IsInstance<FunctionNode>()) {
+        CHECK_EQ(kv.first->name_hint, "main")
+            << "ValueError: AOT only lowers the Relax function main, but the module also has "
+            << kv.first->name_hint;
+        main_gv = kv.first;
+      }
+    }
+    CHECK(main_gv.defined()) << "ValueError: AOT expects a Relax function main in the module";
+    tir::PrimFunc tir_main = LowerMain(Downcast<Function>(mod_->Lookup(main_gv)), mod_name);
+
+    IRModule ret = mod_;
+    ret.CopyOnWrite();
+    ret->Remove(main_gv);
+    ret->Add(GlobalVar(runtime::symbol::tvm_module_main), tir_main);
+    return ret;
+  }
+
+ private:
+  tir::PrimFunc LowerMain(const Function& func, const String& mod_name) {
+    for (const Var& param : func->params) {
+      AOTTensor tensor = StaticTensor(param, GetShape(param->shape_), param->checked_type());
+      tensor.data = CreateIOVar(param->name_hint(), tensor);
+      values_[param.get()] = {tensor};
+    }
+    size_t num_inputs = signature_.size();
+
+    const auto* seq = func->body.as<SeqExprNode>();
+    CHECK(seq != nullptr) << "ValueError: AOT expects the body of main to be normalized, but got "
+                          << func->body->GetTypeKey();
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        const auto* var_binding = binding.as<VarBindingNode>();
+        CHECK(var_binding != nullptr)
+            << "ValueError: AOT supports only static shapes, but got the binding " << binding;
+        values_[var_binding->var.get()] = LowerBinding(var_binding->value);
+      }
+    }
+
+    // The returned tensors are computed in the output buffers, unless they are computed before
+    // the function runs or returned twice.
+    std::vector<AOTTensor> results = LowerArg(seq->body);
+    Map<tir::Var, PrimExpr> output_allocs;
+    std::vector<tir::Stmt> copies;
+    for (size_t i = 0; i < results.size(); ++i) {
+      std::string name = results.size() == 1 ? "output" : "output" + std::to_string(i);
+      tir::Var output = CreateIOVar(name, results[i]);
+      if (sids_.count(results[i].data.get()) && !output_allocs.count(results[i].data)) {
+        output_allocs.Set(results[i].data, output);
+      } else {
+        copies.push_back(CopyToOutput(output, results[i].data, results[i].NumBytes()));
+      }
+    }
+    stmts_.insert(stmts_.end(), copies.begin(), copies.end());
+
+    tir::Stmt body = tir::Substitute(tir::SeqStmt::Flatten(stmts_), output_allocs);
+    for (auto it = allocs_.rbegin(); it != allocs_.rend(); ++it) {
+      if (!output_allocs.count(it->data)) {
+        // Like the Relay AOT main function, the allocates are serviced by TVMBackendAllocWorkspace
+        // when they are not planned by USMP.
+        body = tir::Allocate(it->data, DataType::Int(8),
+                             {IntImm(DataType::Int(64), it->NumBytes())}, tir::const_true(), body);
+      }
+    }
+    for (auto it = constants_.rbegin(); it != constants_.rend(); ++it) {
+      Array<PrimExpr> extents;
+      for (int64_t dim : it->second->data.Shape()) {
+        extents.push_back(IntImm(DataType::Int(64), dim));
+      }
+      if (extents.empty()) {
+        extents.push_back(IntImm(DataType::Int(64), 1));
+      }
+      body = tir::AllocateConst(it->first, DataType(it->second->data->dtype), extents,
+                                it->second->data, body);
+    }
+
+    Map<String, ObjectRef> attrs;
+    attrs.Set(tvm::attr::kGlobalSymbol,
+              runtime::get_name_mangled(mod_name, runtime::symbol::tvm_module_main));
+    attrs.Set("runner_function", Bool(true));
+    attrs.Set("input_vars", Array<tir::Var>(signature_.begin(), signature_.begin() + num_inputs));
+    attrs.Set("output_vars", Array<tir::Var>(signature_.begin() + num_inputs, signature_.end()));
+    return tir::PrimFunc(signature_, body, VoidType(), buffer_map_, DictAttrs(attrs));
+  }
+
+  /*! \brief Lower the value of a binding, returning the tensors it evaluates to. */
+  std::vector<AOTTensor> LowerBinding(const Expr& value) {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    static const Op& memory_kill_tensor_op = Op::Get("relax.memory.kill_tensor");
+    static const Op& memory_kill_storage_op = Op::Get("relax.memory.kill_storage");
+    if (const auto* call = value.as<CallNode>()) {
+      if (call->op == alloc_tensor_op) {
+        const auto* attrs = call->attrs.as<AllocTensorAttrs>();
+        CHECK(call->args[0]->IsInstance<ShapeExprNode>())
+            << "ValueError: AOT supports only static shapes, but got " << call->args[0];
+        AOTTensor tensor = StaticTensor(call->args[0], Downcast<ShapeExpr>(call->args[0])->values,
+                                        DynTensorType(-1, attrs->dtype));
+        tensor.data = tir::Var("sid_" + std::to_string(allocs_.size()),
+                               PointerType(PrimType(DataType::Int(8)), "global.workspace"));
+        allocs_.push_back(tensor);
+        sids_.insert(tensor.data.get());
+        return {tensor};
+      } else if (call->op == memory_kill_tensor_op || call->op == memory_kill_storage_op) {
+        return {};
+      } else if (const auto* gv = call->op.as<GlobalVarNode>()) {
+        CHECK(mod_->Lookup(GetRef<GlobalVar>(gv))->IsInstance<tir::PrimFuncNode>())
+            << "ValueError: AOT supports only calls to PrimFuncs, but got a call to "
+            << gv->name_hint;
+        Array<PrimExpr> args{tir::StringImm(gv->name_hint)};
+        for (const Expr& arg : call->args) {
+          for (const AOTTensor& tensor : LowerArg(arg)) {
+            args.push_back(tensor.data);
+          }
+        }
+        // The device context placeholder of tvm_call_cpacked.
+        args.push_back(tir::make_zero(DataType::Handle()));
+        stmts_.push_back(
+            tir::Evaluate(tir::Call(DataType::Int(32), tir::builtin::tvm_call_cpacked(), args)));
+        return {};
+      }
+      LOG(FATAL) << "ValueError: AOT supports only calls to PrimFuncs and static allocations, "
+                 << "but got " << call->op;
+    } else if (const auto* get_item = value.as<TupleGetItemNode>()) {
+      std::vector<AOTTensor> fields = LowerArg(get_item->tuple);
+      CHECK_LT(get_item->index, fields.size());
+      return {fields[get_item->index]};
+    }
+    return LowerArg(value);
+  }
+
+  /*! \brief Get the tensors of a variable, a constant or a flat tuple of them. */
+  std::vector<AOTTensor> LowerArg(const Expr& arg) {
+    if (const auto* var = arg.as<VarNode>()) {
+      auto it = values_.find(var);
+      ICHECK(it != values_.end()) << "Unbound variable " << var->name_hint();
+      return it->second;
+    } else if (const auto* constant = arg.as<ConstantNode>()) {
+      tir::Var data("constant_" + std::to_string(constants_.size()),
+                    PointerType(PrimType(DataType(constant->data->dtype))));
+      constants_.emplace_back(data, constant);
+      Array<PrimExpr> shape;
+      for (int64_t dim : constant->data.Shape()) {
+        shape.push_back(IntImm(DataType::Int(64), dim));
+      }
+      return {AOTTensor{data, shape, DataType(constant->data->dtype)}};
+    } else if (const auto* tuple = arg.as<TupleNode>()) {
+      std::vector<AOTTensor> tensors;
+      for (const Expr& field : tuple->fields) {
+        CHECK(!field->IsInstance<TupleNode>())
+            << "ValueError: AOT supports only flat tuples, but got " << arg;
+        std::vector<AOTTensor> field_tensors = LowerArg(field);
+        tensors.insert(tensors.end(), field_tensors.begin(), field_tensors.end());
+      }
+      return tensors;
+    }
+    LOG(FATAL) << "ValueError: AOT does not support " << arg->GetTypeKey();
+    return {};
+  }
+
+  /*! \brief Get the static shape of a tensor. */
+  static Array<PrimExpr> GetShape(const Optional<ObjectRef>& shape) {
+    const auto* shape_expr = shape.as<ShapeExprNode>();
+    CHECK(shape_expr != nullptr) << "ValueError: AOT supports only static shapes, but got "
+                                 << shape;
+    return shape_expr->values;
+  }
+
+  /*! \brief Make a tensor, checking that its shape is static. */
+  static AOTTensor StaticTensor(const ObjectRef& expr, const Array<PrimExpr>& shape,
+                                const Type& type) {
+    const auto* tensor_type = type.as<DynTensorTypeNode>();
+    CHECK(tensor_type != nullptr && !tensor_type->IsUnknownDtype())
+        << "ValueError: AOT supports only tensors of known dtype, but got " << expr;
+    for (const PrimExpr& dim : shape) {
+      CHECK(dim->IsInstance<IntImmNode>())
+          << "ValueError: AOT supports only static shapes, but got " << expr << " of shape "
+          << shape;
+    }
+    return AOTTensor{tir::Var(), shape, tensor_type->dtype};
+  }
+
+  /*! \brief Create a parameter of the TIR main function for an input or an output tensor. */
+  tir::Var CreateIOVar(const std::string& name, AOTTensor tensor) {
+    std::string io_name = runtime::SanitizeName(name);
+    tir::Var var(io_name, DataType::Handle());
+    tir::Var data(io_name + "_buffer_var", PointerType(PrimType(tensor.dtype), "global"));
+    signature_.push_back(var);
+    buffer_map_.Set(var, tir::Buffer(data, tensor.dtype, tensor.shape, {}, 0, io_name + "_buffer",
+                                     16, 1, tir::BufferType::kDefault));
+    return data;
+  }
+
+  /*! \brief Copy the bytes of a tensor to an output. */
+  static tir::Stmt CopyToOutput(const tir::Var& output, const tir::Var& input, int64_t size) {
+    tir::Buffer src = tir::decl_buffer({IntImm(DataType::Int(64), size)}, DataType::UInt(8), "src");
+    tir::Buffer dst = tir::decl_buffer({IntImm(DataType::Int(64), size)}, DataType::UInt(8), "dst");
+    tir::Var i("i", DataType::Int(64));
+    tir::Stmt copy = tir::For(i, IntImm(DataType::Int(64), 0), IntImm(DataType::Int(64), size),
+                              tir::ForKind::kSerial,
+                              tir::BufferStore(dst, tir::BufferLoad(src, {i}), {i}));
+    return tir::LetStmt(src->data, input, tir::LetStmt(dst->data, output, copy));
+  }
+
+  /*! \brief The module being lowered. */
+  IRModule mod_;
+  /*! \brief The tensors of the Relax variables. */
+  std::unordered_map<const VarNode*, std::vector<AOTTensor>> values_;
+  /*! \brief The tensors allocated by the function, in order. */
+  std::vector<AOTTensor> allocs_;
+  /*! \brief The data of the tensors allocated by the function. */
+  std::unordered_set<const tir::VarNode*> sids_;
+  /*! \brief The constants, in order. */
+  std::vector<std::pair<tir::Var, const ConstantNode*>> constants_;
+  /*! \brief The statements of the TIR main function, in order. */
+  std::vector<tir::Stmt> stmts_;
+  /*! \brief The inputs and the outputs of the TIR main function. */
+  Array<tir::Var> signature_;
+  /*! \brief The buffers of the inputs and the outputs of the TIR main function. */
+  Map<tir::Var, tir::Buffer> buffer_map_;
+};
+
+namespace transform {
+
+Pass AOTLowerMain(String mod_name) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return AOTMainLowerer(mod).Lower(mod_name); };
+  return CreateModulePass(pass_func, 0, "AOTLowerMain", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.AOTLowerMain").set_body_typed(AOTLowerMain);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/backend/contrib/dnnl/codegen.cc
+ * \brief Implementation of the DNNL JSON serializer.
+ *
+ * The functions annotated with Codegen="dnnl" are serialized to the JSON graph of the DNNL JSON
+ * runtime, with the op names of Relay, i.e. without the "relax." prefix. The leading dimension of
+ * the shapes may be symbolic, in which case the runtime builds the primitives for the batch size
+ * of each call.
+ */
+#include <tvm/ir/module.h>
+#include <tvm/relax/type.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../codegen_json/codegen_json.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace relax {
+namespace contrib {
+
+using JSONGraphNode = tvm::runtime::json::JSONGraphNode;
+using JSONGraphNodeEntry = tvm::runtime::json::JSONGraphNodeEntry;
+using JSONGraphObjectPtr = backend::contrib::JSONGraphObjectPtr;
+using OpAttrExtractor = backend::contrib::OpAttrExtractor;
+using JSONSerializer = backend::contrib::JSONSerializer;
+
+/*!
+ * \brief Expand the "padding" attribute of the 2D ops to the (top, left, bottom, right) paddings
+ * expected by the runtime, from the one or two values allowed by the Relax ops.
+ */
+void SetPaddingAttribute(JSONGraphObjectPtr node) {
+  if (!node->HasAttr("padding")) return;
+  auto padding = dmlc::get<std::vector<std::string>>(
+      node->GetAttr<std::vector<dmlc::any>>("padding")[0]);
+  if (padding.size() == 1) {
+    padding = {padding[0], padding[0], padding[0], padding[0]};
+  } else if (padding.size() == 2) {
+    padding = {padding[0], padding[1], padding[0], padding[1]};
+  }
+  CHECK_EQ(padding.size(), 4U) << "ValueError: DNNL expects 1, 2 or 4 padding values";
+  std::vector<dmlc::any> padding_attr;
+  padding_attr.emplace_back(padding);
+  node->SetAttr("padding", padding_attr);
+}
+
+class DNNLJSONSerializer;
+
+/*!
+ * \brief Collect the constants and attributes from all operator calls in the body
+ * of a "Composite" function.
+ */
+class CollectFromDNNLCompositeBody : public ExprVisitor {
+ public:
+  explicit CollectFromDNNLCompositeBody(DNNLJSONSerializer* serializer)
+      : serializer_(serializer), node_(std::make_shared<JSONGraphNode>()) {}
+
+  void VisitExpr_(const ConstantNode* constant_node) final;
+  void VisitExpr_(const CallNode* call_node) final;
+
+  DNNLJSONSerializer* serializer_;
+  /*! \brief Accumulated translated arguments. */
+  std::vector<JSONGraphNodeEntry> args_;
+  /*! \brief Temporary node into which the attributes of the calls are accumulated. */
+  JSONGraphObjectPtr node_;
+};
+
+/*!
+ * \brief Generates a DNNL JSON runtime module from a relax function by serializing it to a json
+ * representation.
+ */
+class DNNLJSONSerializer : public JSONSerializer {
+ public:
+  DNNLJSONSerializer(const std::string& symbol, const Expr& expr) : JSONSerializer(symbol, expr) {}
+
+  using JSONSerializer::VisitExpr_;
+
+  std::vector<JSONGraphNodeEntry> VisitExpr_(const CallNode* call_node) final {
+    std::string name;
+    std::vector<JSONGraphNodeEntry> inputs;
+    for (const auto& arg : call_node->args) {
+      auto res = VisitExpr(arg);
+      inputs.insert(inputs.end(), res.begin(), res.end());
+    }
+    auto attrs = std::make_shared<JSONGraphNode>();
+    if (const auto* op_node = call_node->op.as<OpNode>()) {
+      name = StripRelaxPrefix(op_node->name);
+      OpAttrExtractor extractor(attrs);
+      const Object* attr_obj = call_node->attrs.get();
+      extractor.Extract(const_cast<Object*>(attr_obj));
+    } else if (const auto* function_node = call_node->op.as<FunctionNode>()) {
+      auto opt_composite = function_node->GetAttr<String>(attr::kComposite);
+      CHECK(opt_composite.defined()) << "ValueError: DNNL only supports composite functions";
+      name = opt_composite.value();
+      // Collect the constants and attributes of all operator calls inside the composite body.
+      CollectFromDNNLCompositeBody collector(this);
+      collector.VisitExpr(function_node->body);
+      inputs.insert(inputs.end(), collector.args_.begin(), collector.args_.end());
+      attrs = collector.node_;
+    } else {
+      LOG(FATAL) << "ValueError: DNNL does not support calls to " << call_node->op->GetTypeKey();
+    }
+    SetPaddingAttribute(attrs);
+
+    auto node = std::make_shared<JSONGraphNode>(name, /*op_type=*/"kernel", inputs,
+                                                /*num_output=*/1);
+    node->CaptureAttrs(*attrs);
+    VLOG(1) << name << " has " << node->GetInputs().size() << " inputs";
+    return AddNode(node, GetRef<Expr>(call_node));
+  }
+
+  /*! \brief The op name of the runtime, e.g. "nn.conv2d" for "relax.nn.conv2d". */
+  static std::string StripRelaxPrefix(const std::string& name) {
+    const std::string prefix = "relax.";
+    return name.compare(0, prefix.size(), prefix) == 0 ? name.substr(prefix.size()) : name;
+  }
+};
+
+void CollectFromDNNLCompositeBody::VisitExpr_(const ConstantNode* constant_node) {
+  for (const auto& entry : serializer_->VisitExpr(GetRef<Constant>(constant_node))) {
+    args_.emplace_back(entry);
+  }
+}
+
+void CollectFromDNNLCompositeBody::VisitExpr_(const CallNode* call_node) {
+  const auto* op_node = call_node->op.as<OpNode>();
+  ICHECK(op_node != nullptr);
+  OpAttrExtractor extractor(node_);
+  const Object* attr_obj = call_node->attrs.get();
+  extractor.Extract(const_cast<Object*>(attr_obj));
+  ExprVisitor::VisitExpr_(call_node);
+}
+
+/*!
+ * \brief Create a runtime module for DNNL.
+ * \param ref The ext_func Relax function to be executed using extern ops.
+ * \return A runtime module.
+ */
+runtime::Module DNNLCompiler(const ObjectRef& ref) {
+  ICHECK(ref->IsInstance<FunctionNode>()) << "The input ref is expected to be a Relax function.";
+  Function func = Downcast<Function>(ref);
+  std::string func_name = backend::GetExtSymbol(func);
+
+  VLOG(1) << "DNNL partition:" << std::endl << PrettyPrint(func);
+  DNNLJSONSerializer serializer(func_name, func);
+  serializer.serialize();
+  std::string graph_json = serializer.GetJSON();
+  VLOG(1) << "DNNL JSON:" << std::endl << graph_json;
+  auto param_names = serializer.GetParams();
+  const auto* pf = runtime::Registry::Get("runtime.DNNLJSONRuntimeCreate");
+  ICHECK(pf != nullptr) << "Cannot find DNNL JSON runtime module create function.";
+  return (*pf)(func_name, graph_json, param_names);
+}
+
+TVM_REGISTER_GLOBAL("relax.ext.dnnl").set_body_typed(DNNLCompiler);
+
+}  // namespace contrib
+}  // namespace relax
+}  // namespace tvm
@@ -49,6 +49,7 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
   bool remove_no_mac_subgraphs;
   bool use_fp16;
   bool use_uint8;
+  bool build_engine_at_compile_time;
 
   TVM_DECLARE_ATTRS(TensorRTCompilerConfigNode, "relax.ext.attrs.TensorRTCompilerConfigNode") {
     TVM_ATTR_FIELD(tensorrt_version)
@@ -59,6 +60,12 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
     TVM_ATTR_FIELD(remove_no_mac_subgraphs).set_default(false);
     TVM_ATTR_FIELD(use_fp16).set_default(false);
     TVM_ATTR_FIELD(use_uint8).set_default(false);
+    TVM_ATTR_FIELD(build_engine_at_compile_time)
+        .describe(
+            "Whether to build the TensorRT engines when compiling, and save them serialized with "
+            "the runtime module, instead of building them when the module is loaded. The engines "
+            "are built for the GPU of the compiling machine.")
+        .set_default(false);
   }
 };
 
@@ -71,6 +78,16 @@ class TensorRTCompilerConfig : public Attrs {
 TVM_REGISTER_NODE_TYPE(TensorRTCompilerConfigNode);
 TVM_REGISTER_PASS_CONFIG_OPTION("relax.ext.tensorrt.options", TensorRTCompilerConfig);
 
+/*! \brief The TensorRT options of the current pass context, or the default options. */
+TensorRTCompilerConfig GetTensorRTCompilerConfig() {
+  auto ctx = transform::PassContext::Current();
+  auto cfg = ctx->GetConfig<TensorRTCompilerConfig>("relax.ext.tensorrt.options");
+  if (!cfg.defined()) {
+    cfg = AttrsWithDefaultValues<TensorRTCompilerConfig>();
+  }
+  return cfg.value();
+}
+
 using JSONGraphNode = tvm::runtime::json::JSONGraphNode;
 using JSONGraphNodeEntry = tvm::runtime::json::JSONGraphNodeEntry;
 using JSONGraphObjectPtr = backend::contrib::JSONGraphObjectPtr;
@@ -257,21 +274,25 @@ class TensorRTJSONSerializer : public JSONSerializer {
     return AddNode(node, GetRef<Expr>(call_node));
   }
 
+  std::vector<JSONGraphNodeEntry> VisitExpr_(const ConstantNode* constant_node) final {
+    constants_.push_back(constant_node->data);
+    return JSONSerializer::VisitExpr_(constant_node);
+  }
+
+  /*! \brief The constants of the function, in the order of the required params. */
+  Array<runtime::NDArray> GetConstants() const { return constants_; }
+
   static void SaveGlobalAttributes(std::shared_ptr<JSONGraphNode> node) {
-    auto ctx = transform::PassContext::Current();
-    auto cfg = ctx->GetConfig<TensorRTCompilerConfig>("relax.ext.tensorrt.options");
-    if (!cfg.defined()) {
-      cfg = AttrsWithDefaultValues<TensorRTCompilerConfig>();
-    }
-    ICHECK_EQ(cfg.value()->tensorrt_version.size(), 3);
+    TensorRTCompilerConfig cfg = GetTensorRTCompilerConfig();
+    ICHECK_EQ(cfg->tensorrt_version.size(), 3);
     std::vector<std::string> tensorrt_version = {
-        std::to_string(cfg.value()->tensorrt_version[0].IntValue()),
-        std::to_string(cfg.value()->tensorrt_version[1].IntValue()),
-        std::to_string(cfg.value()->tensorrt_version[2].IntValue())};
-    std::vector<std::string> use_implicit_batch = {std::to_string(cfg.value()->use_implicit_batch)};
-    std::vector<std::string> max_workspace_size = {std::to_string(cfg.value()->max_workspace_size)};
-    std::vector<std::string> use_fp16 = {std::to_string(cfg.value()->use_fp16)};
-    std::vector<std::string> use_uint8 = {std::to_string(cfg.value()->use_uint8)};
+        std::to_string(cfg->tensorrt_version[0].IntValue()),
+        std::to_string(cfg->tensorrt_version[1].IntValue()),
+        std::to_string(cfg->tensorrt_version[2].IntValue())};
+    std::vector<std::string> use_implicit_batch = {std::to_string(cfg->use_implicit_batch)};
+    std::vector<std::string> max_workspace_size = {std::to_string(cfg->max_workspace_size)};
+    std::vector<std::string> use_fp16 = {std::to_string(cfg->use_fp16)};
+    std::vector<std::string> use_uint8 = {std::to_string(cfg->use_uint8)};
     std::vector<dmlc::any> tensorrt_version_attr, use_implicit_batch_attr, max_workspace_size_attr,
         use_fp16_attr, use_uint8_attr;
     tensorrt_version_attr.emplace_back(tensorrt_version);
@@ -285,6 +306,10 @@ class TensorRTJSONSerializer : public JSONSerializer {
     node->SetAttr("use_fp16", use_fp16_attr);
     node->SetAttr("use_uint8", use_uint8_attr);
   }
+
+ private:
+  /*! \brief The constants of the function, in the order of the required params. */
+  Array<runtime::NDArray> constants_;
 };
 
 void CollectFromCompositeFunctionBody::VisitExpr_(const ConstantNode* constant_node) {
@@ -312,6 +337,18 @@ void CollectFromCompositeFunctionBody::VisitExpr_(const CallNode* call_node) {
   ExprVisitor::VisitExpr_(call_node);
 }
 
+/*!
+ * \brief Check whether TensorRT graph executor is enabled.
+ * \return True if enabled, False if not.
+ */
+inline constexpr bool IsTensorRTRuntimeEnabled() {
+#if TVM_GRAPH_EXECUTOR_TENSORRT
+  return true;
+#else
+  return false;
+#endif  // TVM_GRAPH_EXECUTOR_TENSORRT
+}
+
 /*!
  * \brief Create a runtime module for TensorRT.
  * \param ref The ext_func Relay expression/module to be executed using extern ops.
@@ -332,23 +369,18 @@ runtime::Module TensorRTCompiler(const ObjectRef& ref) {
   ICHECK(pf != nullptr) << "Cannot find TensorRT runtime module create function.";
   VLOG(1) << "Creating tensorrt runtime::Module for '" << func_name << "'";
   runtime::Module lib = (*pf)(func_name, graph_json, param_names);
+  if (GetTensorRTCompilerConfig()->build_engine_at_compile_time) {
+    CHECK(IsTensorRTRuntimeEnabled())
+        << "ValueError: build_engine_at_compile_time requires TVM built with USE_TENSORRT_RUNTIME";
+    // Initializing the module starts the build of its engine, which the module waits for and
+    // serializes when it is saved, so the engines of all the partitions build in parallel.
+    lib.GetFunction("__init_" + func_name)(serializer.GetConstants());
+  }
   return lib;
 }
 
 TVM_REGISTER_GLOBAL("relax.ext.tensorrt").set_body_typed(TensorRTCompiler);
 
-/*!
- * \brief Check whether TensorRT graph executor is enabled.
- * \return True if enabled, False if not.
- */
-inline constexpr bool IsTensorRTRuntimeEnabled() {
-#if TVM_GRAPH_EXECUTOR_TENSORRT
-  return true;
-#else
-  return false;
-#endif  // TVM_GRAPH_EXECUTOR_TENSORRT
-}
-
 /*!
  * \brief Get TensorRT version that TVM is built against.
  * \return Array of three integers for major, minor, and patch, or empty array if TensorRT graph
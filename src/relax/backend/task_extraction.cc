@@ -23,6 +23,7 @@
 #include <tvm/target/target.h>
 #include <tvm/tir/function.h>
 #include "../../meta_schedule/module_equality.h"
+#include "../transform/shape_bucket.h"
 
 namespace tvm {
 namespace relax {
@@ -45,12 +46,15 @@ using tvm::meta_schedule::ExtractedTask;
  *   `fn2` is called by 3 Call-TIR and `fn3` is called by 5 Call-TIR.
  *   Then we will have a ExtractedTask for all three functions, whose weight
  *   is 5 + 3 + 2 = 10.
+ *   3. A PrimFunc with symbolic dims which all have bucket values gets a static task for each
+ *   of its shape buckets instead, see shape_bucket.h.
  */
 class TaskExtractor : public ExprVisitor {
  public:
-  static Array<ExtractedTask> ExtractTask(IRModule mod, Target target, String mod_eq_name) {
+  static Array<ExtractedTask> ExtractTask(IRModule mod, Target target, String mod_eq_name,
+                                          Map<String, Array<Integer>> shape_buckets) {
     auto mod_eq = meta_schedule::ModuleEquality::Create(mod_eq_name);
-    TaskExtractor extractor(mod, target, *mod_eq);
+    TaskExtractor extractor(mod, target, *mod_eq, shape_buckets);
     // We go through each Relax function in the module.
     for (const auto& kv : mod->functions) {
       if (const auto* func = kv.second.as<FunctionNode>()) {
@@ -61,8 +65,12 @@ class TaskExtractor : public ExprVisitor {
   }
 
  private:
-  explicit TaskExtractor(IRModule mod, Target target, const ModuleEquality& mod_eq)
-      : mod_(std::move(mod)), target_(std::move(target)), mod2task_(/*bucket_count*/ 0, ModuleHash(mod_eq), ModuleEqual(mod_eq))  {
+  explicit TaskExtractor(IRModule mod, Target target, const ModuleEquality& mod_eq,
+                         Map<String, Array<Integer>> shape_buckets)
+      : mod_(std::move(mod)),
+        target_(std::move(target)),
+        shape_buckets_(std::move(shape_buckets)),
+        mod2task_(/*bucket_count*/ 0, ModuleHash(mod_eq), ModuleEqual(mod_eq)) {
     normalize_mod_func_ = runtime::Registry::Get("tvm.meta_schedule.normalize_mod");
     ICHECK(normalize_mod_func_) << "Normalization function is not found.";
   }
@@ -89,6 +97,17 @@ class TaskExtractor : public ExprVisitor {
       return;
     }
     const tir::PrimFunc& func = Downcast<tir::PrimFunc>(f);
+    std::vector<ShapeBucket> buckets = GetShapeBuckets(func, shape_buckets_);
+    if (buckets.empty()) {
+      AddTask(global_var->name_hint, func);
+      return;
+    }
+    for (const ShapeBucket& bucket : buckets) {
+      AddTask(ShapeBucketName(global_var->name_hint, bucket), SpecializeShapeBucket(func, bucket));
+    }
+  }
+
+  void AddTask(const String& task_name, const tir::PrimFunc& func) {
     IRModule tir_mod = (*normalize_mod_func_)(func);
     auto it = mod2task_.find(tir_mod);
     if (it != mod2task_.end()) {
@@ -96,10 +115,10 @@ class TaskExtractor : public ExprVisitor {
       return;
     }
 
-    ExtractedTask task(/*task_name=*/global_var->name_hint,  //
-                       /*mod=*/tir_mod,                      //
-                       /*target=*/target_,                   //
-                       /*dispatched=*/{tir_mod},             //
+    ExtractedTask task(/*task_name=*/task_name,  //
+                       /*mod=*/tir_mod,          //
+                       /*target=*/target_,       //
+                       /*dispatched=*/{tir_mod},  //
                        /*weight=*/1);
     tasks_.push_back(task);
     mod2task_.emplace(tir_mod, task);
@@ -107,14 +126,17 @@ class TaskExtractor : public ExprVisitor {
 
   IRModule mod_;
   Target target_;
+  Map<String, Array<Integer>> shape_buckets_;
   Array<ExtractedTask> tasks_;
   std::unordered_map<IRModule, ExtractedTask, ModuleHash, ModuleEqual> mod2task_;
   const runtime::PackedFunc* normalize_mod_func_;
 };
 
 TVM_REGISTER_GLOBAL("relax.backend.MetaScheduleExtractTask")
-    .set_body_typed([](IRModule mod, Target target, String mod_eq_name) {
-      return TaskExtractor::ExtractTask(std::move(mod), std::move(target), mod_eq_name);
+    .set_body_typed([](IRModule mod, Target target, String mod_eq_name,
+                       Map<String, Array<Integer>> shape_buckets) {
+      return TaskExtractor::ExtractTask(std::move(mod), std::move(target), mod_eq_name,
+                                        shape_buckets);
     });
 
 }  // namespace backend
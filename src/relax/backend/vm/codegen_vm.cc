@@ -32,8 +32,10 @@
 #include <tvm/target/target.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../../../target/metadata_module.h"
@@ -89,6 +91,7 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
 
     // var_register_map_ is local in function scope
     var_register_map_.clear();
+    var_constant_map_.clear();
 
     Array<String> param_names;
     for (Var param : func_node->params) {
@@ -96,6 +99,10 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     }
 
     builder_->EmitFunction(gsymbol.value(), func_node->params.size(), param_names);
+    func_name_ = gsymbol.value();
+    func_start_instr_ = builder_->exec->instr_offset.size();
+    tail_calls_.clear();
+    CollectTailCalls(func_node->body, func_node->params.size());
 
     for (Var param : func_node->params) {
       Instruction::Arg reg = this->VisitExpr(param);
@@ -107,6 +114,39 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return ret;
   }
 
+  /*!
+   * \brief Collect the calls of the function to itself whose result is the result of the function,
+   *  which are compiled into a jump to the start of the function.
+   * \param expr An expression whose value is the result of the function.
+   * \param num_params The number of parameters of the function.
+   */
+  void CollectTailCalls(const Expr& expr, size_t num_params) {
+    if (const auto* seq = expr.as<SeqExprNode>()) {
+      // The binding of the result must be the last one, so that nothing runs after the call.
+      const auto* body_var = seq->body.as<VarNode>();
+      if (body_var == nullptr) {
+        CollectTailCalls(seq->body, num_params);
+        return;
+      }
+      for (auto it = seq->blocks.rbegin(); it != seq->blocks.rend(); ++it) {
+        if ((*it)->bindings.empty()) continue;
+        const auto* binding = (*it)->bindings.back().as<VarBindingNode>();
+        if (binding != nullptr && binding->var.get() == body_var) {
+          CollectTailCalls(binding->value, num_params);
+        }
+        return;
+      }
+    } else if (const auto* ife = expr.as<IfNode>()) {
+      CollectTailCalls(ife->true_branch, num_params);
+      CollectTailCalls(ife->false_branch, num_params);
+    } else if (const auto* call = expr.as<CallNode>()) {
+      const auto* gvar = call->op.as<GlobalVarNode>();
+      if (gvar != nullptr && gvar->name_hint == func_name_ && call->args.size() == num_params) {
+        tail_calls_.insert(call);
+      }
+    }
+  }
+
   Instruction::Arg VisitExpr_(const SeqExprNode* op) {
     for (auto block : op->blocks) {
       for (Binding binding : block->bindings) {
@@ -115,6 +155,9 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
         Var var = Downcast<VarBinding>(binding)->var;
         Instruction::Arg reg = this->VisitExpr(value);
         this->var_register_map_.insert({var, reg.data});
+        if (const auto* constant = value.as<ConstantNode>()) {
+          this->var_constant_map_.insert({var, GetRef<Constant>(constant)});
+        }
       }
     }
 
@@ -134,8 +177,15 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
         return EmitPackedFuncCall(call, name);
       } else if (call_node->op == alloc_storage_op_) {
         return EmitAllocStorage(call);
+      } else if (call_node->op == device_copy_op_) {
+        return EmitDeviceCopy(call);
+      } else if (call_node->op == allreduce_op_ || call_node->op == allgather_op_ ||
+                 call_node->op == reduce_scatter_op_) {
+        return EmitCollective(call);
       } else if (call_node->op == alloc_tensor_op_) {
         return EmitAllocTensor(call);
+      } else if (call_node->op == alloc_output_op_) {
+        return EmitAllocOutput(call);
       } else if (call_node->op == store_shape_op_ || call_node->op == load_shape_op_) {
         return EmitShape(call);
       } else if (call_node->op == call_tir_dyn_op_) {
@@ -150,6 +200,9 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
         LOG(FATAL) << "CodeGenVM cannot handle this intrinsic now:\n" << call_node->op;
       }
     }
+    if (tail_calls_.count(call_node)) {
+      return EmitTailCall(GetRef<Call>(call_node));
+    }
     String name;
     if (auto* extern_func = call_node->op.as<ExternFuncNode>()) {
       name = extern_func->global_symbol;
@@ -161,13 +214,22 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     }
     std::vector<Instruction::Arg> args;
     // For extern function `vm.builtin.alloc_shape_heap` we must pass vm register as the first
-    // argument to find the device in which shape heap should be allocated.
-    if (name == "vm.builtin.alloc_shape_heap") {
+    // argument to find the device in which shape heap should be allocated. Likewise the stream
+    // builtins need the vm to find its stream pool.
+    static const std::unordered_set<std::string> builtins_with_vm = {
+        "vm.builtin.alloc_shape_heap", "vm.builtin.stream_switch", "vm.builtin.stream_sync"};
+    if (builtins_with_vm.count(name)) {
       args.push_back(Instruction::Arg(Instruction::kRegister, Instruction::kVMRegister));
     }
     std::vector<Instruction::Arg> converted_args = ConvertArgs(GetRef<Call>(call_node));
     args.insert(args.end(), converted_args.begin(), converted_args.end());
     size_t dst_register = NewRegister();
+    if (name == "vm.builtin.shape_of" && args.size() == 1 &&
+        args[0].kind() == Instruction::kRegister) {
+      // The shapes of the tensors are read by the VM in place.
+      builder_->EmitShapeOf(args[0].value(), dst_register);
+      return Instruction::Arg(Instruction::kRegister, dst_register);
+    }
     builder_->EmitCall(name, args, dst_register);
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
@@ -178,7 +240,7 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     ObjectPtr<Executable> exec_ = builder_->Get();
 
     // Visit the condition expression
-    Instruction::Arg cond_reg = this->VisitExpr(ife->cond);
+    Instruction::Arg cond_reg = this->VisitCondition(ife->cond);
     // Record the offset of If instruction
     size_t if_offset = exec_->instr_offset.size();
 
@@ -212,6 +274,47 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return Instruction::Arg(Instruction::kRegister, merge_register);
   }
 
+  /*!
+   * \brief Visit the condition of an If. A constant condition is kept on the host as an int
+   * register, which the If reads without copying a tensor from the device.
+   */
+  Instruction::Arg VisitCondition(const Expr& cond) {
+    Optional<Constant> constant;
+    if (const auto* constant_node = cond.as<ConstantNode>()) {
+      constant = GetRef<Constant>(constant_node);
+    } else if (const auto* var = cond.as<VarNode>()) {
+      auto it = var_constant_map_.find(GetRef<Var>(var));
+      if (it != var_constant_map_.end()) constant = it->second;
+    }
+    if (constant.defined()) {
+      const runtime::NDArray& data = constant.value()->data;
+      DLDataType dtype = data->dtype;
+      if (data->ndim == 0 && data->device.device_type == kDLCPU &&
+          (dtype.code == kDLInt || dtype.code == kDLUInt) && dtype.lanes == 1) {
+        int64_t value = 0;
+        switch (dtype.bits) {
+          case 1:
+          case 8:
+            value = static_cast<const int8_t*>(data->data)[0];
+            break;
+          case 16:
+            value = static_cast<const int16_t*>(data->data)[0];
+            break;
+          case 32:
+            value = static_cast<const int32_t*>(data->data)[0];
+            break;
+          default:
+            value = static_cast<const int64_t*>(data->data)[0];
+        }
+        size_t dst_register = NewRegister();
+        Instruction::Arg imm(Instruction::kImmediate, value != 0);
+        builder_->EmitCall("vm.builtin.copy", {imm}, dst_register);
+        return Instruction::Arg(Instruction::kRegister, dst_register);
+      }
+    }
+    return this->VisitExpr(cond);
+  }
+
   Instruction::Arg VisitExpr_(const VarNode* op) {
     auto it = this->var_register_map_.find(GetRef<Var>(op));
     if (it != this->var_register_map_.end()) {
@@ -255,7 +358,7 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
       args.push_back(this->VisitExpr(arg));
     }
     size_t dst_register = NewRegister();
-    builder_->EmitCall("runtime.Tuple", args, dst_register);
+    builder_->EmitTuple(args, dst_register);
 
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
@@ -263,6 +366,11 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
   Instruction::Arg VisitExpr_(const TupleGetItemNode* op) {
     TupleGetItem expr = GetRef<TupleGetItem>(op);
     std::vector<Instruction::Arg> args = {this->VisitExpr(expr->tuple)};
+    if (args[0].kind() == Instruction::kRegister) {
+      size_t dst_register = NewRegister();
+      builder_->EmitTupleGetItem(args[0].value(), expr->index, dst_register);
+      return Instruction::Arg(Instruction::kRegister, dst_register);
+    }
 
     std::vector<int64_t> tuple_index = {expr->index};
     auto shape_tuple = ShapeTuple(tuple_index);
@@ -277,6 +385,79 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
+  Instruction::Arg EmitDeviceCopy(const Call& call_node) {
+    std::vector<Instruction::Arg> args;
+    args.push_back(Instruction::Arg(Instruction::kVMRegister));
+    args.push_back(ConvertArg(call_node->args[0]));
+    auto copy_attrs = call_node->attrs.as<DeviceCopyAttrs>();
+    ICHECK(copy_attrs != nullptr) << "must be DeviceCopyAttrs";
+    args.push_back(Instruction::Arg(Instruction::kImmediate, copy_attrs->dst_device_index));
+    size_t dst_register = NewRegister();
+    builder_->EmitCall("vm.builtin.to_device", args, dst_register);
+    return Instruction::Arg(Instruction::kRegister, dst_register);
+  }
+
+  Instruction::Arg EmitCollective(const Call& call_node) {
+    // The collectives take the VM, whose communicator connects the workers.
+    std::vector<Instruction::Arg> args;
+    args.push_back(Instruction::Arg(Instruction::kVMRegister));
+    args.push_back(ConvertArg(call_node->args[0]));
+    String func_name;
+    if (call_node->op == allreduce_op_) {
+      func_name = "vm.builtin.ccl.allreduce";
+      args.push_back(EmitConstantFromValue(call_node->attrs.as<AllReduceAttrs>()->op_type));
+    } else if (call_node->op == allgather_op_) {
+      func_name = "vm.builtin.ccl.allgather";
+    } else {
+      func_name = "vm.builtin.ccl.reduce_scatter";
+      args.push_back(EmitConstantFromValue(call_node->attrs.as<ReduceScatterAttrs>()->op_type));
+    }
+    size_t dst_register = NewRegister();
+    builder_->EmitCall(func_name, args, dst_register);
+    return Instruction::Arg(Instruction::kRegister, dst_register);
+  }
+
+  /*!
+   * \brief The bytes of a storage or an output, or -1 if its size is only known at runtime.
+   * \param size The shape of the output, the size of the storage in bytes, or the (height, width,
+   *  channel) extent of a texture storage.
+   * \param element_bytes The bytes of each element of the size.
+   */
+  static int64_t StaticBytes(const Expr& size, int64_t element_bytes) {
+    const auto* shape = size.as<ShapeExprNode>();
+    if (shape == nullptr) {
+      return -1;
+    }
+    int64_t bytes = element_bytes;
+    for (const PrimExpr& value : shape->values) {
+      const auto* imm = value.as<IntImmNode>();
+      if (imm == nullptr) {
+        return -1;
+      }
+      bytes *= imm->value;
+    }
+    return bytes;
+  }
+
+  static int64_t ElementBytes(DataType dtype) { return (dtype.bits() * dtype.lanes() + 7) / 8; }
+
+  /*! \brief Add an allocation to the planned memory of the function being compiled. */
+  void RecordAlloc(Index device_index, int64_t bytes) {
+    VMFunction& func = builder_->exec->global_funcs[builder_->exec->global_map.at(func_name_)];
+    auto it = std::find_if(func.memory.begin(), func.memory.end(),
+                           [&](const VMMemoryFootprint& footprint) {
+                             return footprint.device_index == device_index;
+                           });
+    if (it == func.memory.end()) {
+      it = func.memory.insert(func.memory.end(), VMMemoryFootprint{device_index});
+    }
+    if (bytes < 0) {
+      ++it->num_dynamic_allocs;
+    } else {
+      it->static_bytes += bytes;
+    }
+  }
+
   Instruction::Arg EmitAllocStorage(const Call& call_node) {
     // Handle args of the call
     std::vector<Instruction::Arg> args;
@@ -295,6 +476,14 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     data_type = dtype;
     Index index = this->builder_->EmitConstant(data_type);
     args.push_back(Instruction::Arg(Instruction::kConstIdx, index));
+    // The storage scope is only passed when it is not the default.
+    if (alloc_attrs->storage_scope != "global") {
+      args.push_back(EmitConstantFromValue(String(alloc_attrs->storage_scope)));
+    }
+
+    const auto* size = call_node->args[0].as<ShapeExprNode>();
+    int64_t element_bytes = size && size->values.size() == 1 ? 1 : ElementBytes(dtype);
+    RecordAlloc(runtime_device_index, StaticBytes(call_node->args[0], element_bytes));
 
     size_t dst_register = NewRegister();
     builder_->EmitCall("vm.builtin.alloc_storage", args, dst_register);
@@ -325,6 +514,30 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
+  Instruction::Arg EmitAllocOutput(const Call& call_node) {
+    ICHECK_EQ(call_node->args.size(), 1);
+    std::vector<Instruction::Arg> args;
+    args.reserve(5);
+    args.push_back(Instruction::Arg(Instruction::kVMRegister));
+    // Handle `shape`
+    args.push_back(ConvertArg(call_node->args[0]));
+    // Handle attrs of the call
+    auto alloc_attrs = call_node->attrs.as<VMAllocOutputAttrs>();
+    ICHECK(alloc_attrs != nullptr) << "must be VMAllocOutputAttrs";
+    args.push_back(Instruction::Arg(Instruction::kImmediate, alloc_attrs->output_index));
+    args.push_back(Instruction::Arg(Instruction::kImmediate, alloc_attrs->runtime_device_index));
+    DataType dtype = alloc_attrs->dtype;
+    TVMRetValue data_type;
+    data_type = dtype;
+    Index index = this->builder_->EmitConstant(data_type);
+    args.push_back(Instruction::Arg(Instruction::kConstIdx, index));
+    RecordAlloc(alloc_attrs->runtime_device_index,
+                StaticBytes(call_node->args[0], ElementBytes(dtype)));
+    size_t dst_register = NewRegister();
+    builder_->EmitCall("vm.builtin.alloc_output", args, dst_register);
+    return Instruction::Arg(Instruction::kRegister, dst_register);
+  }
+
   Instruction::Arg EmitShape(const Call& call_node) {
     // Handle args of the call
     std::vector<Instruction::Arg> args;
@@ -453,31 +666,53 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
+  /*!
+   * \brief Emit a call of the function to itself in tail position as a loop: the arguments are
+   *  copied to the parameter registers and the function restarts in the same frame.
+   */
+  Instruction::Arg EmitTailCall(const Call& call) {
+    std::vector<Instruction::Arg> args = ConvertArgs(call);
+    Index num_params = static_cast<Index>(args.size());
+    auto is_param = [num_params](const Instruction::Arg& arg) {
+      return arg.kind() == Instruction::kRegister && arg.value() < num_params;
+    };
+    // A parameter read by a later argument is overwritten first, so it is copied aside.
+    for (Index i = 0; i < num_params; ++i) {
+      if (is_param(args[i]) && args[i].value() < i) {
+        size_t staging_register = NewRegister();
+        builder_->EmitCall("vm.builtin.copy", {args[i]}, staging_register);
+        args[i] = Instruction::Arg(Instruction::kRegister, staging_register);
+      }
+    }
+    for (Index i = 0; i < num_params; ++i) {
+      if (is_param(args[i]) && args[i].value() == i) continue;
+      builder_->EmitCall("vm.builtin.copy", {args[i]}, i);
+    }
+    Index pc = builder_->exec->instr_offset.size();
+    builder_->EmitGoto(func_start_instr_ - pc);
+    // The instructions using the result of the call are never reached.
+    return Instruction::Arg(Instruction::kImmediate, 0);
+  }
+
   Instruction::Arg EmitInvokeClosure(const Call& call_node) {
     ICHECK(call_node->args.size() == 2);
     ICHECK(call_node->args[0]->IsInstance<VarNode>());
     ICHECK(call_node->args[1]->IsInstance<TupleNode>());
 
-    std::vector<Instruction::Arg> args;
-    // VM is utilized to help get the Function in builtin packedfunc
-    args.push_back(Instruction::Arg(Instruction::kVMRegister));
-
     auto lv = Downcast<Var>(call_node->args[0]);
     auto it = this->var_register_map_.find(lv);
-    if (it != this->var_register_map_.end()) {
-      args.push_back(Instruction::Arg(Instruction::kRegister, it->second));
-    } else {
-      args.push_back(Instruction::Arg(Instruction::kRegister, registers_num_));
-    }
+    RegName closure = it != this->var_register_map_.end() ? it->second : registers_num_;
 
     // args for the invoke_closure
+    std::vector<Instruction::Arg> args;
     auto invoke_closure_args = Downcast<Tuple>(call_node->args[1]);
     for (Expr arg : invoke_closure_args->fields) {
       args.push_back(ConvertArg(arg));
     }
 
+    // The VM runs the function of the closure in a new frame, without a packed function.
     size_t dst_register = NewRegister();
-    builder_->EmitCall("vm.builtin.invoke_closure", args, dst_register);
+    builder_->EmitInvokeClosure(closure, args, dst_register);
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
@@ -537,9 +772,22 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
   size_t registers_num_ = 0;
   /*! \brief Map from var to register number. */
   std::unordered_map<Var, RegName, ObjectPtrHash, ObjectPtrEqual> var_register_map_;
+  /*! \brief Map from var to the constant it is bound to. */
+  std::unordered_map<Var, Constant, ObjectPtrHash, ObjectPtrEqual> var_constant_map_;
+  /*! \brief The symbol of the function being compiled. */
+  String func_name_;
+  /*! \brief The index of the first instruction of the function being compiled. */
+  Index func_start_instr_{0};
+  /*! \brief The calls of the function to itself in tail position, see CollectTailCalls. */
+  std::unordered_set<const CallNode*> tail_calls_;
   /*! \brief Cache ops that need to be frequently used later to reduce lookup overhead. */
   const Op& alloc_storage_op_ = Op::Get("relax.vm.builtin.alloc_storage");
+  const Op& device_copy_op_ = Op::Get("relax.device_copy");
+  const Op& allreduce_op_ = Op::Get("relax.ccl.allreduce");
+  const Op& allgather_op_ = Op::Get("relax.ccl.allgather");
+  const Op& reduce_scatter_op_ = Op::Get("relax.ccl.reduce_scatter");
   const Op& alloc_tensor_op_ = Op::Get("relax.vm.builtin.alloc_tensor");
+  const Op& alloc_output_op_ = Op::Get("relax.vm.builtin.alloc_output");
   const Op& store_shape_op_ = Op::Get("relax.vm.builtin.store_shape");
   const Op& load_shape_op_ = Op::Get("relax.vm.builtin.load_shape");
   const Op& call_tir_dyn_op_ = Op::Get("relax.vm.call_tir_dyn");
@@ -572,6 +820,9 @@ Module CodeGen(IRModule mod, Optional<Module> lib, Array<Module> ext_libs, Targe
   VMCodeGen codegen;
   codegen.CodeGen(mod);
   ObjectPtr<Executable> executable = codegen.GetExec();
+  if (Optional<Integer> workspace_bytes = mod->GetAttr<Integer>("vm_workspace_bytes")) {
+    executable->workspace_bytes = workspace_bytes.value()->value;
+  }
   if (!lib.defined()) {
     lib = codegen::CSourceModuleCreate(";", "", Array<String>{});
   }
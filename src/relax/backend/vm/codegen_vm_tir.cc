@@ -0,0 +1,276 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/backend/vm/codegen_vm_tir.cc
+ * \brief A codegen compiling the instructions of the VM functions into TIR host functions.
+ *
+ * Each VM function is compiled into a PrimFunc `__vmtir__<name>(ctx_ptr, r, c)` taking the VM, the
+ * register file of the function and the constant pool, which the VM calls in place of running the
+ * instructions of the function. The register file and the constant pool are AnyLists, arrays of
+ * TVMRetValue, whose items are passed to the calls as they are:
+ *
+ *   Call dst, func, args  ->  anylist_setitem_call_cpacked(r, dst, "func", args...)  (kernels)
+ *                             anylist_setitem_call_packed(r, dst, "func", args...)   (builtins)
+ *   If cond ... Goto ...  ->  if (read_if_cond(vm, r[cond]) != 0) { ... } else { ... }
+ *   Ret result            ->  r[register_file_size] = r[result]
+ *
+ * The functions looping on their tail calls, see CodeGenVM::EmitTailCall, are not compiled.
+ *
+ * so that the dispatch on the opcodes and the marshalling of the arguments from the registers
+ * are compiled, and the kernels of the module are called directly by their symbol.
+ */
+
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "codegen_vm.h"
+
+namespace tvm {
+namespace relax {
+namespace relax_vm {
+
+class CodeGenVMTIR {
+ public:
+  CodeGenVMTIR(ObjectPtr<Executable> exec, const IRModule& tir_mod) : exec_(exec) {
+    for (const auto& kv : tir_mod->functions) {
+      if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+        kernels_.insert(
+            func->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or(kv.first->name_hint));
+      }
+    }
+  }
+
+  tir::PrimFunc Codegen(const VMFunction& func, const Target& target) {
+    ret_reg_ = func.register_file_size;
+    tir::Stmt body = tir::SeqStmt::Flatten(EmitRange(func.start_instr, FunctionEnd(func)));
+    Map<String, ObjectRef> attrs;
+    attrs.Set(tvm::attr::kGlobalSymbol, String("__vmtir__" + func.name));
+    attrs.Set(tvm::attr::kTarget, target);
+    return tir::PrimFunc({ctx_ptr_, r_, c_}, body, VoidType(), {}, DictAttrs(attrs));
+  }
+
+  /*!
+   * \brief Whether the function loops, i.e. its tail calls to itself jump back to its start.
+   * \note The loops are left to the dispatch loop, the function is not compiled.
+   */
+  bool HasLoop(const VMFunction& func) const {
+    for (Index pc = func.start_instr; pc < FunctionEnd(func); ++pc) {
+      Instruction instr = exec_->GetInstruction(pc);
+      if (instr.op == Opcode::Goto && instr.pc_offset < 0) return true;
+    }
+    return false;
+  }
+
+ private:
+  /*! \brief The end of the instructions of the function. */
+  Index FunctionEnd(const VMFunction& func) const {
+    Index end = exec_->instr_offset.size();
+    for (const VMFunction& other : exec_->global_funcs) {
+      if (other.start_instr > func.start_instr) {
+        end = std::min(end, other.start_instr);
+      }
+    }
+    return end;
+  }
+
+  /*! \brief Compile the instructions [begin, end), which are structured as emitted by CodeGenVM. */
+  std::vector<tir::Stmt> EmitRange(Index begin, Index end) {
+    std::vector<tir::Stmt> stmts;
+    Index pc = begin;
+    while (pc < end) {
+      Instruction instr = exec_->GetInstruction(pc);
+      switch (instr.op) {
+        case Opcode::Call: {
+          stmts.push_back(EmitCall(instr));
+          ++pc;
+          break;
+        }
+        // The instructions run in place by the interpreter become calls to their builtins.
+        case Opcode::MakeTuple: {
+          stmts.push_back(tir::Evaluate(SetItemCall(tir::builtin::anylist_setitem_call_packed(),
+                                                    instr.dst, "runtime.Tuple",
+                                                    ConvertArgs(instr.args, instr.num_args))));
+          ++pc;
+          break;
+        }
+        case Opcode::TupleGetItem: {
+          stmts.push_back(tir::Evaluate(SetItemCall(
+              tir::builtin::anylist_setitem_call_packed(), instr.dst, "vm.builtin.tuple_getitem",
+              {GetItem(r_, instr.tuple), IntImm(DataType::Int(64), instr.field_index)})));
+          ++pc;
+          break;
+        }
+        case Opcode::ShapeOf: {
+          stmts.push_back(tir::Evaluate(SetItemCall(tir::builtin::anylist_setitem_call_packed(),
+                                                    instr.dst, "vm.builtin.shape_of",
+                                                    {GetItem(r_, instr.tensor)})));
+          ++pc;
+          break;
+        }
+        case Opcode::InvokeClosure: {
+          Array<PrimExpr> args{ctx_ptr_};
+          for (const PrimExpr& arg : ConvertArgs(instr.args, instr.num_args)) {
+            args.push_back(arg);
+          }
+          stmts.push_back(tir::Evaluate(SetItemCall(tir::builtin::anylist_setitem_call_packed(),
+                                                    instr.dst, "vm.builtin.invoke_closure", args)));
+          ++pc;
+          break;
+        }
+        case Opcode::Ret: {
+          stmts.push_back(tir::Evaluate(SetItemCall(
+              tir::builtin::anylist_setitem_call_packed(), ret_reg_, "vm.builtin.copy",
+              {GetItem(r_, instr.result)})));
+          ++pc;
+          break;
+        }
+        case Opcode::If: {
+          // If cond, false_offset; <true branch>; Goto merge; <false branch>; merge:
+          Index false_pc = pc + instr.false_offset;
+          Instruction goto_instr = exec_->GetInstruction(false_pc - 1);
+          CHECK(goto_instr.op == Opcode::Goto)
+              << "ValueError: The VM TIR codegen expects the true branch of the If at pc " << pc
+              << " to end with a Goto";
+          Index merge_pc = false_pc - 1 + goto_instr.pc_offset;
+          PrimExpr cond = tir::Call(DataType::Int(64), tir::builtin::tvm_call_packed(),
+                                    {tir::StringImm("vm.builtin.read_if_cond"), ctx_ptr_,
+                                     GetItem(r_, instr.cond)});
+          stmts.push_back(tir::IfThenElse(cond != tir::make_zero(DataType::Int(64)),
+                                          tir::SeqStmt::Flatten(EmitRange(pc + 1, false_pc - 1)),
+                                          tir::SeqStmt::Flatten(EmitRange(false_pc, merge_pc))));
+          pc = merge_pc;
+          break;
+        }
+        default:
+          LOG(FATAL) << "ValueError: The VM TIR codegen does not support the unstructured "
+                     << "instruction at pc " << pc;
+      }
+    }
+    return stmts;
+  }
+
+  tir::Stmt EmitCall(const Instruction& instr) {
+    std::string func_name = exec_->func_names[instr.func_idx];
+    Array<PrimExpr> args = ConvertArgs(instr.args, instr.num_args);
+    if (kernels_.count(func_name)) {
+      return tir::Evaluate(
+          SetItemCall(tir::builtin::anylist_setitem_call_cpacked(), instr.dst, func_name, args));
+    }
+    if (exec_->global_map.count(func_name)) {
+      // The Relax functions are called through the VM, as they may run in the dispatch loop.
+      Array<PrimExpr> call_args{ctx_ptr_, tir::StringImm(func_name)};
+      call_args.insert(call_args.end(), args.begin(), args.end());
+      args = call_args;
+      func_name = "vm.builtin.call_vm_func";
+    }
+    return tir::Evaluate(
+        SetItemCall(tir::builtin::anylist_setitem_call_packed(), instr.dst, func_name, args));
+  }
+
+  Array<PrimExpr> ConvertArgs(const Instruction::Arg* instr_args, Index num_args) {
+    Array<PrimExpr> args;
+    for (Index i = 0; i < num_args; ++i) {
+      Instruction::Arg arg = instr_args[i];
+      switch (arg.kind()) {
+        case Instruction::kRegister: {
+          if (arg.value() == Instruction::kVMRegister) {
+            args.push_back(ctx_ptr_);
+          } else {
+            args.push_back(GetItem(r_, arg.value()));
+          }
+          break;
+        }
+        case Instruction::kImmediate: {
+          args.push_back(IntImm(DataType::Int(64), arg.value()));
+          break;
+        }
+        case Instruction::kConstIdx: {
+          args.push_back(GetItem(c_, arg.value()));
+          break;
+        }
+        default:
+          LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+      }
+    }
+    return args;
+  }
+
+  static PrimExpr GetItem(const tir::Var& list, Index index) {
+    return tir::Call(DataType::Handle(), tir::builtin::anylist_getitem(),
+                     {list, IntImm(DataType::Int(32), index)});
+  }
+
+  PrimExpr SetItemCall(const Op& op, Index index, const std::string& func_name,
+                       const Array<PrimExpr>& args) {
+    Array<PrimExpr> call_args{r_, IntImm(DataType::Int(32), index), tir::StringImm(func_name)};
+    call_args.insert(call_args.end(), args.begin(), args.end());
+    return tir::Call(DataType::Int(32), op, call_args);
+  }
+
+  /*! \brief The executable whose functions are compiled. */
+  ObjectPtr<Executable> exec_;
+  /*! \brief The symbols of the kernels, which are called directly. */
+  std::unordered_set<std::string> kernels_;
+  /*! \brief The register receiving the result of the function. */
+  Index ret_reg_{0};
+  /*! \brief The VM. */
+  tir::Var ctx_ptr_{"ctx_ptr", DataType::Handle()};
+  /*! \brief The register file. */
+  tir::Var r_{"r", DataType::Handle()};
+  /*! \brief The constant pool. */
+  tir::Var c_{"c", DataType::Handle()};
+};
+
+/*!
+ * \brief Compile the VM functions of a Relax IRModule into TIR host functions.
+ * \param rx_mod The IRModule of the Relax functions, as passed to the VM codegen.
+ * \param tir_mod The IRModule of the kernels, which are called directly.
+ * \param target The host target of the functions.
+ * \return The IRModule of the compiled functions, to build together with the kernels.
+ * \note The functions refer to the registers and the constants by their indices in the executable
+ *  built by the VM codegen from the same rx_mod.
+ */
+IRModule VMTIRCodeGen(IRModule rx_mod, IRModule tir_mod, Target target) {
+  VMCodeGen codegen;
+  codegen.CodeGen(rx_mod);
+  ObjectPtr<Executable> exec = codegen.GetExec();
+  CodeGenVMTIR tir_codegen(exec, tir_mod);
+  IRModule ret;
+  for (const VMFunction& func : exec->global_funcs) {
+    // The functions without a compiled counterpart run in the dispatch loop.
+    if (tir_codegen.HasLoop(func)) continue;
+    ret->Add(GlobalVar("__vmtir__" + func.name), tir_codegen.Codegen(func, target));
+  }
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("relax.VMTIRCodeGen").set_body_typed(VMTIRCodeGen);
+
+}  // namespace relax_vm
+}  // namespace relax
+}  // namespace tvm
@@ -97,6 +97,41 @@ void ExecBuilderNode::EmitIf(vm::RegName cond, vm::Index false_offset) {
   exec->instr_data.push_back(false_offset);
 }
 
+void ExecBuilderNode::EmitTuple(std::vector<Instruction::Arg> fields, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::MakeTuple));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(fields.size());
+  std::transform(fields.cbegin(), fields.cend(), std::back_inserter(exec->instr_data),
+                 [](Instruction::Arg arg) { return arg.data; });
+}
+
+void ExecBuilderNode::EmitTupleGetItem(RegName tuple, Index field_index, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::TupleGetItem));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(tuple);
+  exec->instr_data.push_back(field_index);
+}
+
+void ExecBuilderNode::EmitShapeOf(RegName tensor, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::ShapeOf));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(tensor);
+}
+
+void ExecBuilderNode::EmitInvokeClosure(RegName closure, std::vector<Instruction::Arg> args,
+                                        RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::InvokeClosure));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(args.size() + 1);
+  exec->instr_data.push_back(Instruction::Arg(Instruction::kRegister, closure).data);
+  std::transform(args.cbegin(), args.cend(), std::back_inserter(exec->instr_data),
+                 [](Instruction::Arg arg) { return arg.data; });
+}
+
 void ExecBuilderNode::CheckExecutable() {
   for (auto it = exec->global_funcs.cbegin(); it != exec->global_funcs.cend(); ++it) {
     Index num_inputs = it->num_args;
@@ -104,29 +139,39 @@ void ExecBuilderNode::CheckExecutable() {
     std::unordered_set<RegName> arg_registers;
     size_t start_instr = it->start_instr;
     size_t end_instr = exec->instr_offset.size();
+    auto check_arg = [&](Instruction::Arg arg) {
+      if (arg.kind() == Instruction::kRegister && arg.value() == Instruction::kVMRegister) {
+        return;
+      }
+      if (arg.kind() == Instruction::kRegister && arg.value() >= num_inputs &&
+          dst_registers.find(arg.value()) == dst_registers.end()) {
+        LOG(FATAL) << "register r(" << arg.value() << ") in VM function \"" << it->name
+                   << "\" is used as input while the number of inputs is only " << num_inputs
+                   << ".\n";
+      }
+      arg_registers.emplace(arg.value());
+    };
     for (size_t idx = start_instr; idx < end_instr; ++idx) {
       Instruction instr = exec->GetInstruction(idx);
       switch (instr.op) {
-        case Opcode::Call: {
+        case Opcode::Call:
+        case Opcode::MakeTuple:
+        case Opcode::InvokeClosure: {
           for (int i = 0; i < instr.num_args; ++i) {
-            if (instr.args[i].kind() == Instruction::kRegister &&
-                instr.args[i].value() == Instruction::kVMRegister) {
-              continue;
-            }
-            if (instr.args[i].kind() == Instruction::kRegister &&
-                instr.args[i].value() >= num_inputs &&
-                dst_registers.find(instr.args[i].value()) == dst_registers.end()) {
-              LOG(FATAL) << "register r(" << instr.args[i].value() << ") in VM function \""
-                         << it->name << "\" is used as input while the number of inputs is only "
-                         << num_inputs << ".\n";
-            }
-            arg_registers.emplace(instr.args[i].value());
+            check_arg(instr.args[i]);
           }
           if (instr.dst != Instruction::kVoidArg) {
             dst_registers.emplace(instr.dst);
           }
           break;
         }
+        case Opcode::TupleGetItem:
+        case Opcode::ShapeOf: {
+          RegName src = instr.op == Opcode::TupleGetItem ? instr.tuple : instr.tensor;
+          check_arg(Instruction::Arg(Instruction::kRegister, src));
+          dst_registers.emplace(instr.dst);
+          break;
+        }
         case Opcode::Ret: {
           arg_registers.emplace(instr.result);
           for (int i = 0; i < num_inputs; i++) {
@@ -171,20 +216,36 @@ void ExecBuilderNode::Formalize() {
     size_t end_instr = this->exec->instr_offset.size();
     for (size_t idx = start_instr; idx < end_instr; ++idx) {
       Instruction instr = this->exec->GetInstruction(idx);
+      Index offset = this->exec->instr_offset[idx];
+      auto formalize_dst = [&]() {
+        if (instr.dst != Instruction::kVoidArg && instr.dst >= num_inputs &&
+            register_map.find(instr.dst) == register_map.end()) {
+          this->exec->instr_data[offset + 1] = register_idx;
+          register_map[instr.dst] = register_idx++;
+        }
+      };
       switch (instr.op) {
-        case Opcode::Call: {
+        case Opcode::Call:
+        case Opcode::MakeTuple:
+        case Opcode::InvokeClosure: {
+          // The arguments of a Call follow its function index.
+          Index args_offset = offset + (instr.op == Opcode::Call ? 4 : 3);
           for (int i = 0; i < instr.num_args; ++i) {
             if (instr.args[i].kind() == Instruction::kRegister &&
                 register_map.find(instr.args[i].value()) != register_map.end()) {
-              this->exec->instr_data[this->exec->instr_offset[idx] + 4 + i] =
-                  register_map[instr.args[i].value()];
+              this->exec->instr_data[args_offset + i] = register_map[instr.args[i].value()];
             }
           }
-          if (instr.dst != Instruction::kVoidArg && instr.dst >= num_inputs &&
-              register_map.find(instr.dst) == register_map.end()) {
-            this->exec->instr_data[this->exec->instr_offset[idx] + 1] = register_idx;
-            register_map[instr.dst] = register_idx++;
+          formalize_dst();
+          break;
+        }
+        case Opcode::TupleGetItem:
+        case Opcode::ShapeOf: {
+          RegName src = instr.op == Opcode::TupleGetItem ? instr.tuple : instr.tensor;
+          if (register_map.find(src) != register_map.end()) {
+            this->exec->instr_data[offset + 2] = register_map[src];
           }
+          formalize_dst();
           break;
         }
         case Opcode::Ret: {
@@ -240,6 +301,45 @@ TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitGoto")
 TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitIf")
     .set_body_method<ExecBuilder>(&ExecBuilderNode::EmitIf);
 
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitTuple")
+    .set_body_typed([](ExecBuilder builder, Array<IntImm> fields, int64_t dst) {
+      std::vector<Instruction::Arg> fields_;
+      for (size_t i = 0; i < fields.size(); ++i) {
+        fields_.push_back(static_cast<Instruction::Arg>(fields[i]->value));
+      }
+      Instruction::Arg dst_(dst);
+      CHECK_EQ(dst_.kind(), Instruction::ArgKind::kRegister);
+      builder->EmitTuple(fields_, dst_.value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitTupleGetItem")
+    .set_body_typed([](ExecBuilder builder, int64_t tuple, int64_t field_index, int64_t dst) {
+      Instruction::Arg tuple_(tuple), dst_(dst);
+      CHECK_EQ(tuple_.kind(), Instruction::ArgKind::kRegister);
+      CHECK_EQ(dst_.kind(), Instruction::ArgKind::kRegister);
+      builder->EmitTupleGetItem(tuple_.value(), field_index, dst_.value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitShapeOf")
+    .set_body_typed([](ExecBuilder builder, int64_t tensor, int64_t dst) {
+      Instruction::Arg tensor_(tensor), dst_(dst);
+      CHECK_EQ(tensor_.kind(), Instruction::ArgKind::kRegister);
+      CHECK_EQ(dst_.kind(), Instruction::ArgKind::kRegister);
+      builder->EmitShapeOf(tensor_.value(), dst_.value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitInvokeClosure")
+    .set_body_typed([](ExecBuilder builder, int64_t closure, Array<IntImm> args, int64_t dst) {
+      std::vector<Instruction::Arg> args_;
+      for (size_t i = 0; i < args.size(); ++i) {
+        args_.push_back(static_cast<Instruction::Arg>(args[i]->value));
+      }
+      Instruction::Arg closure_(closure), dst_(dst);
+      CHECK_EQ(closure_.kind(), Instruction::ArgKind::kRegister);
+      CHECK_EQ(dst_.kind(), Instruction::ArgKind::kRegister);
+      builder->EmitInvokeClosure(closure_.value(), args_, dst_.value());
+    });
+
 TVM_REGISTER_GLOBAL("relax.ExecBuilderR").set_body_typed([](ExecBuilder builder, int64_t value) {
   return Instruction::Arg(Instruction::kRegister, value).data;
 });
@@ -21,26 +21,62 @@
  * \brief Perform memory planning for memory reuse.
  * \note
  *  - Nested functions are not considered yet.
- *  - Symbolic shape cases (ones with MatchShape) are completely not considered yet.
+ *  - A symbolic-shape tensor is planned with the upper bound of its size when the function
+ *    attribute "tir_var_upper_bound" bounds all its symbolic variables. Otherwise its storage
+ *    can only be reused by the tensors of the same symbolic size, and is sized at runtime.
+ *  - With "relax.VMGraphMemoryPlan.offset_packing", the static-size tensors of a binding block
+ *    are packed at offsets of one storage per device instead, by their live intervals.
+ *  - With "relax.VMGraphMemoryPlan.vtcm_capacity", the small static-size tensors on a device are
+ *    planned into the "global.vtcm" storage scope, the VTCM of Hexagon, until their storages take
+ *    the capacity. They are reused among themselves only.
+ *  - The static-size tensors passed to the PrimFunc params of a texture scope, e.g.
+ *    "global.texture" of Adreno, are planned as 2D images of the scope. An image is reused by
+ *    the tensors of its dtype and scope whose flattened extent it covers, or is grown to cover,
+ *    with the rules of the texture planning of Relay.
  *  - RuntimeDepShape is not allowed at this moment.
  */
+#include <tvm/arith/analyzer.h>
 #include <tvm/relax/attrs/memory.h>
 #include <tvm/relax/backend.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/type.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <limits>
 #include <map>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../../../relay/transforms/pattern_utils.h"
+#include "../../../runtime/texture.h"
 #include "../../../support/arena.h"
 #include "../../op/make_op.h"
 
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMGraphMemoryPlan.offset_packing", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMGraphMemoryPlan.vtcm_capacity", Integer);
+
+/*! \brief The storage scope of the VTCM of Hexagon. */
+static constexpr const char* kVtcmScope = "global.vtcm";
+/*! \brief The largest tensor planned into VTCM takes this fraction of its capacity. */
+static constexpr int64_t kVtcmTensorFraction = 4;
+
+/*! \brief A storage shared by the tensors packed at its offsets. */
+struct PackedStorage {
+  /*! \brief Number of bytes. */
+  int64_t bytes{0};
+  /*! \brief The variable corresponding to the allocated storage */
+  Var storage{nullptr};
+};
+
 /*!
  * \brief A representation of a block of reusable memory required at runtime.
  * \details Only the tensors whose memory can be "possibly reused" will have their storage token. In
@@ -59,6 +95,8 @@ struct StorageToken {
   int ref_counter{0};
   /*! \brief Number of bytes, which is impossible to exceed the range of int. */
   int64_t bytes{-1};
+  /*! \brief Number of bytes when it is only known at runtime, in which case `bytes` is -1. */
+  PrimExpr symbolic_bytes{nullptr};
   /*! \brief The shape of the tensor */
   Array<PrimExpr> shape;
   /*! \brief The corresponding tensor dtype. */
@@ -67,11 +105,33 @@ struct StorageToken {
   int storage_id{-1};
   /*! \brief The variable corresponding to the allocated storage */
   Var storage{nullptr};
+  /*! \brief The storage the token is packed into when offset packing, nullptr otherwise. */
+  PackedStorage* packed{nullptr};
+  /*! \brief The offset of the token in the packed storage. */
+  int64_t offset{0};
+  /*! \brief The virtual device index of the token. */
+  int64_t device_index{0};
+  /*! \brief The storage scope of the token. */
+  std::string storage_scope{"global"};
+  /*! \brief The extent of the 2D image of the token, when of a texture scope. */
+  runtime::Texture2DShape<int64_t> texture{0, 0, 0};
+  /*! \brief The live interval of the token in the call order, when offset packing. */
+  int live_begin{-1};
+  int live_end{-1};
+
+  /*! \brief Whether the size of the token has been determined. */
+  bool HasSize() const { return bytes >= 0 || symbolic_bytes.defined(); }
 
   std::string ToString() const {
     ICHECK(shape.defined());
     std::ostringstream os;
-    os << "{storage_id: " << storage_id << ", bytes: " << bytes << ", shape: " << shape
+    os << "{storage_id: " << storage_id << ", bytes: ";
+    if (symbolic_bytes.defined()) {
+      os << symbolic_bytes;
+    } else {
+      os << bytes;
+    }
+    os << ", shape: " << shape
        << ", dtype: " << dtype << ", ref_counter: " << ref_counter << "}";
     return os.str();
   }
@@ -169,6 +229,19 @@ struct TokenContainer {
  */
 class TokenAllocator1D {
  public:
+  /*!
+   * \brief Construct the allocator.
+   * \param upper_bounds The upper bounds of the symbolic variables by name.
+   * \param capacity The bytes the storages may take in total, or -1 for no limit.
+   */
+  explicit TokenAllocator1D(Map<String, Integer> upper_bounds, int64_t capacity = -1)
+      : upper_bounds_(std::move(upper_bounds)), capacity_(capacity) {}
+
+  /*! \brief Whether a new storage of the given bytes fits in the capacity. */
+  bool CanAlloc(int64_t size) const {
+    return capacity_ < 0 || allocated_bytes_ + size <= capacity_;
+  }
+
   /*!
    * \brief Request a storage token from the available token pool for a given prototype.
    * \param prototype The prototype storage token.
@@ -176,12 +249,24 @@ class TokenAllocator1D {
    */
   StorageToken* Request(StorageToken* prototype) {
     ICHECK_EQ(prototype->storage_id, -1);
-    ICHECK_EQ(prototype->bytes, -1);
     ICHECK_GT(prototype->ref_counter, 0);
     ICHECK(!prototype->storage.defined());
 
     // Calculate the size in byte.
     int64_t size = GetMemorySize(prototype);
+    if (prototype->symbolic_bytes.defined()) {
+      // A runtime size can only be reused by the tensors whose size is equal for any input.
+      for (auto it = available_symbolic_pool_.begin(); it != available_symbolic_pool_.end(); ++it) {
+        StorageToken* available_token = *it;
+        ICHECK_EQ(available_token->ref_counter, 0);
+        if (StructuralEqual()(available_token->symbolic_bytes, prototype->symbolic_bytes)) {
+          available_token->ref_counter = prototype->ref_counter;
+          available_symbolic_pool_.erase(it);
+          return available_token;
+        }
+      }
+      return nullptr;
+    }
     // Search memory blocks in [size / match_range_, size * match_range_)
     auto begin = available_pool_.lower_bound(size / match_range_);
     auto mid = available_pool_.lower_bound(size);
@@ -202,6 +287,10 @@ class TokenAllocator1D {
       StorageToken* available_token = it->second;
       ICHECK_EQ(available_token->ref_counter, 0);
       ICHECK_GE(size, available_token->bytes);
+      if (!CanAlloc(size - available_token->bytes)) {
+        continue;
+      }
+      allocated_bytes_ += size - available_token->bytes;
       available_token->bytes = size;
       available_token->ref_counter = prototype->ref_counter;
       // erase from map and return
@@ -223,8 +312,9 @@ class TokenAllocator1D {
     int64_t size = GetMemorySize(prototype);
     if (prototype->bytes != -1) {
       ICHECK_EQ(size, prototype->bytes);
+      allocated_bytes_ += size;
     } else {
-      prototype->bytes = size;
+      ICHECK(prototype->symbolic_bytes.defined());
     }
     prototype->storage_id = storage_id;
     full_pool_.push_back(prototype);
@@ -237,10 +327,14 @@ class TokenAllocator1D {
    */
   void Release(StorageToken* token) {
     ICHECK_GE(token->storage_id, 0);
-    ICHECK_GE(token->bytes, 0);
+    ICHECK(token->HasSize());
     ICHECK_EQ(token->ref_counter, 0);
     ICHECK(!token->storage.defined());
-    available_pool_.insert({token->bytes, token});
+    if (token->symbolic_bytes.defined()) {
+      available_symbolic_pool_.push_back(token);
+    } else {
+      available_pool_.insert({token->bytes, token});
+    }
   }
 
   std::string DumpMemoryAllocation() const {
@@ -248,6 +342,10 @@ class TokenAllocator1D {
     double total_gb = 0.0;
     os << "=========================== Dump Memory Allocation ===========================\n";
     for (const StorageToken* token : full_pool_) {
+      if (token->symbolic_bytes.defined()) {
+        os << " - Allocated " << token->symbolic_bytes << " bytes at runtime\n";
+        continue;
+      }
       double size = 1.0 * token->bytes / (1ll << 30);
       total_gb += size;
       os << " - Allocated " << size << " GB\n";
@@ -256,40 +354,187 @@ class TokenAllocator1D {
     return os.str();
   }
 
- private:
   /*!
    * \brief Get the size of the consumed memory of a prototype token.
    * \param prototype The prototype token.
-   * \return The required memory size.
+   * \return The required memory size, or -1 if it is only known at runtime, in which case the
+   *  size expression is set to the `symbolic_bytes` of the prototype.
    */
   int64_t GetMemorySize(StorageToken* prototype) {
     ICHECK_EQ(prototype->storage_id, -1);
-    if (prototype->bytes != -1) {
+    if (prototype->HasSize()) {
       return prototype->bytes;
     }
 
-    int64_t size = 1;
+    PrimExpr size = tir::make_const(DataType::Int(64), 1);
     for (const PrimExpr& dim_len : prototype->shape) {
-      const int64_t* p_dim_len = tir::as_const_int(dim_len);
-      ICHECK_NOTNULL(p_dim_len);
-      size *= *p_dim_len;
+      size = size * cast(DataType::Int(64), dim_len);
+    }
+    size = size * tir::make_const(DataType::Int(64),
+                                  (prototype->dtype.bits() * prototype->dtype.lanes() + 7) / 8);
+
+    arith::Analyzer analyzer;
+    tir::PostOrderVisit(size, [&](const ObjectRef& obj) {
+      if (const auto* var = obj.as<tir::VarNode>()) {
+        auto it = upper_bounds_.find(var->name_hint);
+        if (it != upper_bounds_.end()) {
+          analyzer.Bind(GetRef<tir::Var>(var),
+                        Range::FromMinExtent(tir::make_const(var->dtype, 0),
+                                             tir::make_const(var->dtype, (*it).second->value + 1)));
+        }
+      }
+    });
+    size = analyzer.Simplify(size);
+    if (const int64_t* p_size = tir::as_const_int(size)) {
+      prototype->bytes = *p_size;
+    } else {
+      // Plan with the upper bound of the size if all the symbolic variables are bounded.
+      arith::ConstIntBound bound = analyzer.const_int_bound(size);
+      if (bound->max_value != arith::ConstIntBound::kPosInf) {
+        prototype->bytes = bound->max_value;
+      } else {
+        prototype->symbolic_bytes = size;
+      }
     }
-    size *= (prototype->dtype.bits() * prototype->dtype.lanes() + 7) / 8;
-    prototype->bytes = size;
-    return size;
+    return prototype->bytes;
   }
 
  private:
   // scale used for rough match
   const int match_range_{16};
+  // the upper bounds of the symbolic variables by name
+  Map<String, Integer> upper_bounds_;
   // free list of storage entry
   std::multimap<int64_t, StorageToken*> available_pool_;
+  // free list of storage entry whose size is only known at runtime
+  std::vector<StorageToken*> available_symbolic_pool_;
   // all the storage resources available
   std::vector<StorageToken*> full_pool_;
+  // the bytes the storages may take in total, or -1 for no limit
+  int64_t capacity_;
+  // the bytes of the static-size storages
+  int64_t allocated_bytes_{0};
   /*! \brief Number of storages */
   int n_storage_;
 };
 
+/**
+ * \brief Memory manager for the 2D images of the texture scopes, e.g. "global.texture" on OpenCL.
+ * \details An available image is reused by the tensors of its dtype, scope and device, unless
+ * either of them is too large for the other. The image which takes the least added area to cover
+ * the tensor is chosen, then the one wasting the least area. An image is only grown when the
+ * added area is smaller than a new image of the tensor.
+ */
+class TokenAllocator2D {
+ public:
+  /*! \brief Whether a prototype token can be planned as a 2D image of its scope. */
+  static bool CanPlan(const StorageToken* prototype) {
+    if (prototype->shape.size() < 3) {
+      return false;
+    }
+    for (const PrimExpr& dim : prototype->shape) {
+      const int64_t* value = tir::as_const_int(dim);
+      if (value == nullptr || *value <= 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Request a storage token from the available images for a given prototype.
+   * \param prototype The prototype storage token.
+   * \return The result token, or nullptr if no image can be reused.
+   */
+  StorageToken* Request(StorageToken* prototype) {
+    ICHECK_EQ(prototype->storage_id, -1);
+    ICHECK_GT(prototype->ref_counter, 0);
+    runtime::Texture2DShape<int64_t> shape = GetSize2D(prototype);
+    auto best = available_pool_.end();
+    int64_t min_added = std::numeric_limits<int64_t>::max();
+    int64_t min_wasted = std::numeric_limits<int64_t>::max();
+    for (auto it = available_pool_.begin(); it != available_pool_.end(); ++it) {
+      const StorageToken* available_token = *it;
+      ICHECK_EQ(available_token->ref_counter, 0);
+      const runtime::Texture2DShape<int64_t>& cached = available_token->texture;
+      if (available_token->dtype != prototype->dtype ||
+          available_token->storage_scope != prototype->storage_scope ||
+          available_token->device_index != prototype->device_index ||
+          cached.channel != shape.channel) {
+        continue;
+      }
+      if (shape.width / cached.width > kMaxRatio || cached.width / shape.width > kMaxRatio ||
+          shape.height / cached.height > kMaxRatio || cached.height / shape.height > kMaxRatio) {
+        continue;
+      }
+      int64_t area = std::max(cached.width, shape.width) * std::max(cached.height, shape.height);
+      int64_t added = area - cached.width * cached.height;
+      int64_t wasted = area - shape.width * shape.height;
+      if (added < min_added || (added == min_added && wasted < min_wasted)) {
+        best = it;
+        min_added = added;
+        min_wasted = wasted;
+      }
+    }
+    if (best == available_pool_.end() || min_added >= shape.width * shape.height) {
+      return nullptr;
+    }
+    StorageToken* token = *best;
+    available_pool_.erase(best);
+    token->texture.width = std::max(token->texture.width, shape.width);
+    token->texture.height = std::max(token->texture.height, shape.height);
+    token->bytes = GetImageBytes(token);
+    token->ref_counter = prototype->ref_counter;
+    return token;
+  }
+
+  /*!
+   * \brief Allocate a storage token of a new image for the input prototype token
+   * \param prototype The prototype token.
+   * \param storage_id The id of this token.
+   */
+  StorageToken* Alloc(StorageToken* prototype, int storage_id) {
+    ICHECK_EQ(prototype->storage_id, -1);
+    prototype->texture = GetSize2D(prototype);
+    prototype->bytes = GetImageBytes(prototype);
+    prototype->storage_id = storage_id;
+    return prototype;
+  }
+
+  /*!
+   * \brief Release the input token, putting its image into the available pool.
+   * \param token The token to be released.
+   */
+  void Release(StorageToken* token) {
+    ICHECK_GE(token->storage_id, 0);
+    ICHECK_EQ(token->ref_counter, 0);
+    available_pool_.push_back(token);
+  }
+
+ private:
+  /*! \brief The extent of the 2D image of a tensor, flattened by the convention of its scope. */
+  static runtime::Texture2DShape<int64_t> GetSize2D(const StorageToken* prototype) {
+    ICHECK(CanPlan(prototype));
+    std::vector<int64_t> shape;
+    for (const PrimExpr& dim : prototype->shape) {
+      shape.push_back(*tir::as_const_int(dim));
+    }
+    size_t axis = runtime::DefaultTextureLayoutSeparator(shape.size(), prototype->storage_scope);
+    return runtime::ApplyTexture2DFlattening<int64_t>(shape, shape.size(), axis);
+  }
+
+  /*! \brief The bytes of the image of a token. */
+  static int64_t GetImageBytes(const StorageToken* token) {
+    return token->texture.width * token->texture.height * token->texture.channel *
+           ((token->dtype.bits() * token->dtype.lanes() + 7) / 8);
+  }
+
+  /*! \brief An image is not reused by a tensor this many times larger or smaller on an axis. */
+  static constexpr int64_t kMaxRatio = 5;
+  /*! \brief The available images. */
+  std::vector<StorageToken*> available_pool_;
+};
+
 /*! \brief The base class for the storage allocation visitor */
 class StorageAllocatorBaseVisitor : public ExprVisitor {
  public:
@@ -360,13 +605,21 @@ class StorageAllocatorBaseVisitor : public ExprVisitor {
 
 class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
  public:
-  explicit StorageAllocatorInit(support::Arena* arena) : StorageAllocatorBaseVisitor(arena) {}
+  explicit StorageAllocatorInit(support::Arena* arena, IRModule mod)
+      : StorageAllocatorBaseVisitor(arena), mod_(std::move(mod)) {}
 
   std::unordered_map<const ExprNode*, TokenContainer> Initialize(const Function& func) {
     for (const Var& param : func->params) {
       token_map_[param.get()] = no_tokens_;
       this->VisitVarDef(param);
     }
+    // Plan the tensors which the PrimFuncs only access in a texture scope as its 2D images.
+    for (const auto& kv : token2scope_) {
+      StorageToken* token = const_cast<StorageToken*>(kv.first);
+      if (runtime::IsTextureStorage(kv.second) && TokenAllocator2D::CanPlan(token)) {
+        token->storage_scope = kv.second;
+      }
+    }
     const TokenContainer& body_tokens = GetTokens(func->body);
     // Erase the tokens of the function output.
     body_tokens.ApplyToTokens([this](StorageToken* token) { this->EraseToken(token); });
@@ -385,9 +638,19 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
 
     // `block_stack_` here is possibly empty (e.g., the function body is a `call_packed`).
     const BindingBlockNode* cur_block = block_stack_.empty() ? nullptr : block_stack_.back();
-    for (const Expr& arg : call->args) {
-      const TokenContainer& container = GetTokensWithAllocSiteCheck(arg, cur_block);
+    const tir::PrimFuncNode* prim_func = nullptr;
+    if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+      auto it = mod_->functions.find(GetRef<GlobalVar>(gvar));
+      if (it != mod_->functions.end()) {
+        prim_func = (*it).second.as<tir::PrimFuncNode>();
+      }
+    }
+    for (size_t i = 0; i < call->args.size(); ++i) {
+      const TokenContainer& container = GetTokensWithAllocSiteCheck(call->args[i], cur_block);
       IncreaseRefCounter(container);
+      if (!container.is_tuple) {
+        RecordScope(container.token, prim_func, i);
+      }
     }
   }
 
@@ -425,14 +688,6 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
       token_map_[call] = no_tokens_;
       return no_tokens_;
     }
-    // Does not support planning for symbolic shape at this moment.
-    for (const PrimExpr& dim_len : shape->values) {
-      if (!tir::is_const_int(dim_len)) {
-        token_map_[call] = no_tokens_;
-        return no_tokens_;
-      }
-    }
-
     auto* token = arena_->make<StorageToken>();
     token->dtype = ttype->dtype;
     token->shape = shape->values;
@@ -463,6 +718,25 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
     return token_map_[expr.get()];
   }
 
+  /*!
+   * \brief Record the storage scope a tensor is accessed in as an argument of a call, which is
+   *  the scope of the param buffer of a PrimFunc and "global" otherwise. A tensor accessed in
+   *  different scopes is not planned into the scopes.
+   */
+  void RecordScope(const StorageToken* token, const tir::PrimFuncNode* prim_func, size_t index) {
+    std::string scope = "global";
+    if (prim_func != nullptr && index < prim_func->params.size()) {
+      auto it = prim_func->buffer_map.find(prim_func->params[index]);
+      if (it != prim_func->buffer_map.end()) {
+        scope = (*it).second.scope();
+      }
+    }
+    auto it_insert = token2scope_.insert({token, scope});
+    if (!it_insert.second && it_insert.first->second != scope) {
+      it_insert.first->second = "global";
+    }
+  }
+
   void IncreaseRefCounter(const TokenContainer& token_container) {
     token_container.ApplyToTokens([](StorageToken* token) { token->ref_counter += 1; });
   }
@@ -474,8 +748,14 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
     }
     token2exprs_.erase(token);
     token2block_.erase(token);
+    token2scope_.erase(token);
   }
 
+  /*! \brief The module of the PrimFuncs called. */
+  IRModule mod_;
+  /*! \brief The mapping from each token to the storage scope the PrimFuncs access it in. */
+  std::unordered_map<const StorageToken*, std::string> token2scope_;
+
   /*! \brief The mapping from each token to the binding block where it is created */
   std::unordered_map<const StorageToken*, const BindingBlockNode*> token2block_;
   /*! \brief The mapping from each token to the Exprs that share this token */
@@ -485,8 +765,13 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
 class StorageAllocator : public StorageAllocatorBaseVisitor {
  public:
   explicit StorageAllocator(std::unordered_map<const ExprNode*, TokenContainer> token_map,
-                            support::Arena* arena)
-      : StorageAllocatorBaseVisitor(arena) {
+                            Map<String, Integer> upper_bounds, bool offset_packing,
+                            int64_t vtcm_capacity, support::Arena* arena)
+      : StorageAllocatorBaseVisitor(arena),
+        allocator_(upper_bounds),
+        vtcm_allocator_(upper_bounds, vtcm_capacity),
+        offset_packing_(offset_packing),
+        vtcm_capacity_(vtcm_capacity) {
     this->token_map_ = std::move(token_map);
   }
 
@@ -510,6 +795,9 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     for (const StorageToken* token : block2tokens[block]) {
       ICHECK_EQ(token->ref_counter, 0);
     }
+    if (offset_packing_) {
+      PackOffsets(block);
+    }
   }
 
   void VisitBinding_(const VarBindingNode* binding) final {
@@ -527,6 +815,7 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   void VisitExpr_(const CallNode* call) final {
     static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    ++call_counter_;
     if (call->op == alloc_tensor_op) {
       auto it = token_map_.find(call);
       ICHECK(it != token_map_.end());
@@ -561,6 +850,36 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
   }
 
   StorageToken* RequestOrAlloc(StorageToken* prototype, int64_t virtual_device_idx) {
+    if (runtime::IsTextureStorage(prototype->storage_scope)) {
+      prototype->device_index = virtual_device_idx;
+      StorageToken* token = texture_allocator_.Request(prototype);
+      if (token == nullptr) {
+        token = texture_allocator_.Alloc(prototype, this->n_storage_++);
+      }
+      return token;
+    }
+    int64_t size = allocator_.GetMemorySize(prototype);
+    // Plan the small tensors of a device into VTCM while it has room, reusing the VTCM storages.
+    if (vtcm_capacity_ > 0 && virtual_device_idx != -1 && size != -1 &&
+        size <= vtcm_capacity_ / kVtcmTensorFraction) {
+      StorageToken* token = vtcm_allocator_.Request(prototype);
+      if (token == nullptr && vtcm_allocator_.CanAlloc(size)) {
+        token = vtcm_allocator_.Alloc(prototype, this->n_storage_++);
+        token->storage_scope = kVtcmScope;
+        token->device_index = virtual_device_idx;
+      }
+      if (token != nullptr) {
+        return token;
+      }
+    }
+    // Give each static-size tensor a token of its own when offset packing, to be packed by its
+    // live interval. The runtime sizes cannot be packed and are reused as usual.
+    if (offset_packing_ && size != -1) {
+      StorageToken* token = allocator_.Alloc(prototype, this->n_storage_++);
+      token->device_index = virtual_device_idx;
+      token->live_begin = call_counter_;
+      return token;
+    }
     StorageToken* token = allocator_.Request(prototype);
     if (token == nullptr) {
       token = allocator_.Alloc(prototype, this->n_storage_++);
@@ -571,11 +890,19 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   void CheckForRelease(StorageToken* token, const CallNode* release_site) {
     ICHECK_GE(token->storage_id, 0);
-    ICHECK_GE(token->bytes, 0);
+    ICHECK(token->HasSize());
     ICHECK_GE(token->ref_counter, 0);
     ICHECK(!token->storage.defined());
     if (token->ref_counter == 0) {
-      allocator_.Release(token);
+      if (token->live_begin != -1) {
+        token->live_end = call_counter_;
+      } else if (token->storage_scope == kVtcmScope) {
+        vtcm_allocator_.Release(token);
+      } else if (runtime::IsTextureStorage(token->storage_scope)) {
+        texture_allocator_.Release(token);
+      } else {
+        allocator_.Release(token);
+      }
 
       auto it = token2cur_tensor_.find(token);
       ICHECK(it != token2cur_tensor_.end());
@@ -584,10 +911,70 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     }
   }
 
+  /*!
+   * \brief Pack the static-size tokens of a block at offsets of one storage per device, greedily
+   *  by decreasing size. A token goes to the lowest offset which does not overlap with the
+   *  tokens already packed and live at the same time.
+   */
+  void PackOffsets(const BindingBlockNode* block) {
+    std::vector<StorageToken*> tokens;
+    for (const StorageToken* token : block2tokens[block]) {
+      if (token->live_begin != -1) {
+        ICHECK_NE(token->live_end, -1);
+        tokens.push_back(const_cast<StorageToken*>(token));
+      }
+    }
+    auto aligned_size = [](const StorageToken* token) {
+      int64_t align = runtime::kAllocAlignment;
+      return (token->bytes + align - 1) / align * align;
+    };
+    std::sort(tokens.begin(), tokens.end(), [&](const StorageToken* a, const StorageToken* b) {
+      if (aligned_size(a) != aligned_size(b)) return aligned_size(a) > aligned_size(b);
+      return a->live_begin < b->live_begin;
+    });
+    std::map<int64_t, PackedStorage*> device2storage;
+    std::vector<StorageToken*> packed;
+    for (StorageToken* token : tokens) {
+      std::vector<const StorageToken*> conflicts;
+      for (const StorageToken* other : packed) {
+        if (other->device_index == token->device_index && other->live_begin <= token->live_end &&
+            token->live_begin <= other->live_end) {
+          conflicts.push_back(other);
+        }
+      }
+      std::sort(conflicts.begin(), conflicts.end(),
+                [](const StorageToken* a, const StorageToken* b) { return a->offset < b->offset; });
+      int64_t size = aligned_size(token);
+      int64_t offset = 0;
+      for (const StorageToken* other : conflicts) {
+        if (offset + size <= other->offset) break;
+        offset = std::max(offset, other->offset + aligned_size(other));
+      }
+      PackedStorage*& storage = device2storage[token->device_index];
+      if (storage == nullptr) {
+        storage = arena_->make<PackedStorage>();
+      }
+      storage->bytes = std::max(storage->bytes, offset + size);
+      token->offset = offset;
+      token->packed = storage;
+      packed.push_back(token);
+    }
+  }
+
   /*! \brief Number of allocated storages */
   int n_storage_{0};
   /*! \brief The 1D memory allocator */
   TokenAllocator1D allocator_;
+  /*! \brief The 1D memory allocator of VTCM */
+  TokenAllocator1D vtcm_allocator_;
+  /*! \brief The 2D memory allocator of the texture scopes */
+  TokenAllocator2D texture_allocator_;
+  /*! \brief Whether to pack the static-size tensors at offsets of a per-device storage. */
+  bool offset_packing_;
+  /*! \brief The bytes of VTCM the tensors may take, 0 if they are not planned into VTCM. */
+  int64_t vtcm_capacity_;
+  /*! \brief The number of calls visited, as the clock of the live intervals. */
+  int call_counter_{0};
   /*! \brief The mapping from each token to the tensor that is currently occupying it */
   std::unordered_map<const StorageToken*, Var> token2cur_tensor_;
 };
@@ -613,7 +1000,15 @@ class StorageAllocationRewriter : public ExprMutator {
     }
 
     // Insert `memory.kill_storage` for the storage tokens allocated inside this block.
+    std::unordered_set<const PackedStorage*> killed_packed;
     for (const StorageToken* token : block2tokens_[block]) {
+      if (token->packed != nullptr) {
+        if (killed_packed.insert(token->packed).second) {
+          ICHECK(token->packed->storage.defined());
+          this->builder_->Emit(MakeMemKillStorage(token->packed->storage));
+        }
+        continue;
+      }
       ICHECK(token->storage.defined());
       this->builder_->Emit(MakeMemKillStorage(token->storage));
     }
@@ -657,10 +1052,28 @@ class StorageAllocationRewriter : public ExprMutator {
       // - If the token is visited for the first time, create a storage variable using
       // `memory.alloc_storage` for it.
       // - And always create a `memory.alloc_tensor` for the old `builtin.alloc_tensor`.
+      if (token->packed != nullptr) {
+        PackedStorage* packed = token->packed;
+        if (!packed->storage.defined()) {
+          ShapeExpr size({tir::make_const(DataType::Int(64), packed->bytes)});
+          Call alloc_storage = Downcast<Call>(MakeAllocStorage(
+              std::move(size), attrs->runtime_device_index, "global", DataType::UInt(8)));
+          packed->storage = builder_->Emit(alloc_storage, "storage");
+        }
+        return MakeMemAllocTensor(packed->storage, call->args[0], token->offset, attrs->dtype);
+      }
       if (!token->storage.defined()) {
-        ShapeExpr size({tir::make_const(DataType::Int(64), token->bytes)});
-        Call alloc_storage = Downcast<Call>(
-            MakeAllocStorage(std::move(size), attrs->runtime_device_index, "global", token->dtype));
+        ShapeExpr size({token->symbolic_bytes.defined()
+                            ? token->symbolic_bytes
+                            : tir::make_const(DataType::Int(64), token->bytes)});
+        if (runtime::IsTextureStorage(token->storage_scope)) {
+          // A 2D image is sized by its (height, width, channel) extent.
+          size = ShapeExpr({tir::make_const(DataType::Int(64), token->texture.height),
+                            tir::make_const(DataType::Int(64), token->texture.width),
+                            tir::make_const(DataType::Int(64), token->texture.channel)});
+        }
+        Call alloc_storage = Downcast<Call>(MakeAllocStorage(
+            std::move(size), attrs->runtime_device_index, token->storage_scope, token->dtype));
         token->storage = builder_->Emit(alloc_storage, "storage");
       }
       return MakeMemAllocTensor(token->storage, call->args[0], /*offset=*/0, attrs->dtype);
@@ -683,13 +1096,16 @@ class StorageAllocationRewriter : public ExprMutator {
   support::Arena* arena_;
 };
 
-Expr VMGraphMemoryPlan(Function func) {
+Expr VMGraphMemoryPlan(Function func, IRModule mod, bool offset_packing, int64_t vtcm_capacity) {
   support::Arena arena;
   // Step 1. Initialize.
   std::unordered_map<const ExprNode*, TokenContainer> token_map =
-      StorageAllocatorInit(&arena).Initialize(func);
+      StorageAllocatorInit(&arena, std::move(mod)).Initialize(func);
   // Step 2. Collect the memory allocation info.
-  StorageAllocator allocator(std::move(token_map), &arena);
+  Map<String, Integer> upper_bounds =
+      func->GetAttr<Map<String, Integer>>("tir_var_upper_bound").value_or({});
+  StorageAllocator allocator(std::move(token_map), std::move(upper_bounds), offset_packing,
+                             vtcm_capacity, &arena);
   allocator(func);
   // Dump the memory allocation information by using `allocator.DumpMemoryAllocation()`.
   // Step 3. Rewrite the function.
@@ -705,7 +1121,14 @@ namespace transform {
 Pass VMGraphMemoryPlan() {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(VMGraphMemoryPlan(std::move(f)));
+        bool offset_packing =
+            pc->GetConfig<Bool>("relax.VMGraphMemoryPlan.offset_packing", Bool(false)).value();
+        int64_t vtcm_capacity =
+            pc->GetConfig<Integer>("relax.VMGraphMemoryPlan.vtcm_capacity", Integer(0))
+                .value()
+                ->value;
+        return Downcast<Function>(
+            VMGraphMemoryPlan(std::move(f), std::move(m), offset_packing, vtcm_capacity));
       };
   return CreateFunctionPass(pass_func, 0, "VMGraphMemoryPlan", {});
 }
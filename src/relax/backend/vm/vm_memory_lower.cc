@@ -42,8 +42,62 @@ namespace relax {
 // relax.attrs.VMAllocStorageAttrs)
 // gv1 = relax.call_packed("relax.vm.builtin.alloc_tensor", gv0, (m, n),
 // relax.attrs.VMAllocTensorAttrs)
+//
+// The tensors returned as the function output (or as the fields of an output tuple) are lowered
+// to relax.vm.builtin.alloc_output instead, which hands out the buffer bound to the output by
+// `set_output_zero_copy` at runtime, if any.
 
 class VMMemLowerMutator : public ExprMutator {
+ public:
+  explicit VMMemLowerMutator(const Expr& e) {
+    if (const auto* func = e.as<FunctionNode>()) {
+      CollectOutputAllocs(func->body);
+    }
+  }
+
+ private:
+  /*! \brief Find the alloc_tensor calls whose results are returned as the function output. */
+  void CollectOutputAllocs(const Expr& body) {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    const auto* seq = body.as<SeqExprNode>();
+    if (seq == nullptr) {
+      return;
+    }
+    std::unordered_map<const VarNode*, Expr> bindings;
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        if (const auto* var_binding = binding.as<VarBindingNode>()) {
+          bindings[var_binding->var.get()] = var_binding->value;
+        }
+      }
+    }
+    // Chase the aliases back to the value defining them
+    auto f_resolve = [&](Expr expr) {
+      while (const auto* var = expr.as<VarNode>()) {
+        auto it = bindings.find(var);
+        if (it == bindings.end()) {
+          break;
+        }
+        expr = it->second;
+      }
+      return expr;
+    };
+    auto f_collect = [&](const Expr& expr, int output_index) {
+      const auto* call = f_resolve(expr).as<CallNode>();
+      if (call != nullptr && call->op == alloc_tensor_op) {
+        output_allocs_.emplace(call, output_index);
+      }
+    };
+    Expr output = f_resolve(seq->body);
+    if (const auto* tuple = output.as<TupleNode>()) {
+      for (size_t i = 0; i < tuple->fields.size(); ++i) {
+        f_collect(tuple->fields[i], i);
+      }
+    } else {
+      f_collect(output, 0);
+    }
+  }
+
   Expr ComputeStorageSize(const Expr& shape, const DataType& dtype) const {
     // Question: what if the dtype of tensor_type is unknown?
     // Symbolic/static shape case
@@ -70,6 +124,7 @@ class VMMemLowerMutator : public ExprMutator {
   using ExprMutator::VisitExpr_;
 
   Expr VisitExpr_(const CallNode* call) override {
+    auto it_output = output_allocs_.find(call);
     // post-order mutation
     Expr expr = VisitExprPostOrder_(call);
     call = expr.as<CallNode>();
@@ -84,6 +139,10 @@ class VMMemLowerMutator : public ExprMutator {
       auto alloc_attrs = call->attrs.as<AllocTensorAttrs>();
       ICHECK(alloc_attrs != nullptr) << "must be AllocTensorAttrs";
       DataType dtype = alloc_attrs->dtype;
+      if (it_output != output_allocs_.end()) {
+        return MakeVMAllocOutput(call->args[0], it_output->second, dtype,
+                                 alloc_attrs->runtime_device_index);
+      }
       Expr storage_size = ComputeStorageSize(output_shape, dtype);
       Var storage = builder_->Emit(
           MakeVMAllocStorage(std::move(storage_size), dtype, alloc_attrs->runtime_device_index),
@@ -95,7 +154,8 @@ class VMMemLowerMutator : public ExprMutator {
       const auto* attrs = call->attrs.as<MemAllocStorageAttrs>();
       ICHECK_NOTNULL(attrs);
       ICHECK(call->args.size() == 1);
-      return MakeVMAllocStorage(call->args[0], attrs->dtype, attrs->virtual_device_index);
+      return MakeVMAllocStorage(call->args[0], attrs->dtype, attrs->virtual_device_index,
+                                attrs->storage_scope);
     } else if (call->op == memory_alloc_tensor_op) {
       const auto* attrs = call->attrs.as<MemAllocTensorAttrs>();
       ICHECK_NOTNULL(attrs);
@@ -118,9 +178,12 @@ class VMMemLowerMutator : public ExprMutator {
 
     ExprMutator::VisitBinding_(binding);
   }
+
+  /*! \brief The alloc_tensor calls returned as the function output, to their output indices. */
+  std::unordered_map<const CallNode*, int> output_allocs_;
 };
 
-Expr VMMemLower(const Expr& e) { return VMMemLowerMutator().VisitExpr(e); }
+Expr VMMemLower(const Expr& e) { return VMMemLowerMutator(e).VisitExpr(e); }
 
 namespace transform {
 
@@ -29,9 +29,38 @@
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace tvm {
 namespace relax {
 
+/*!
+ * \brief Collect the non-constant shape expressions evaluated by a binding, without entering the
+ *  nested scopes, which may or may not run.
+ */
+class ShapeExprCollector : public ExprVisitor {
+ public:
+  explicit ShapeExprCollector(std::vector<ShapeExpr>* shapes) : shapes_(shapes) {}
+
+  void VisitExpr_(const ShapeExprNode* op) final {
+    for (PrimExpr e : op->values) {
+      if (!e->IsInstance<IntImmNode>()) {
+        shapes_->push_back(GetRef<ShapeExpr>(op));
+        return;
+      }
+    }
+  }
+  void VisitExpr_(const IfNode* op) final {}
+  void VisitExpr_(const FunctionNode* op) final {}
+  void VisitExpr_(const SeqExprNode* op) final {}
+
+ private:
+  std::vector<ShapeExpr>* shapes_;
+};
+
 class VMShapeLowerMutator : public ExprMutator {
  public:
   static DataType ShapeDType() { return DataType::Int(64); }
@@ -62,6 +91,7 @@ class VMShapeLowerMutator : public ExprMutator {
     // TODO(@yuchen): match_shape overloaded semantic: value is ShapeType
     Var shape = builder_->Emit(Call(ExternFunc("vm.builtin.shape_of"), {value}), "sh");
     StoreShape(shape, binding->pattern);
+    if (!plans_.empty()) ++plans_.back().segment;
   }
 
   using ExprMutator::VisitExpr_;
@@ -70,10 +100,29 @@ class VMShapeLowerMutator : public ExprMutator {
     if (IsConstantShape(GetRef<ShapeExpr>(node))) {
       return ExprMutator::VisitExpr_(node);
     }
-    tir::PrimFunc func = CalculateShape(GetRef<ShapeExpr>(node));
+    BlockPlan* plan = plans_.empty() ? nullptr : &plans_.back();
+    auto pending = [&](const PrimExpr& e) {
+      return plan == nullptr || plan->computed.count(expr2slot_.at(e)->value) == 0;
+    };
+    if (std::any_of(node->values.begin(), node->values.end(), pending)) {
+      // Compute the rest of the segment along, so that it takes a single host call.
+      Array<PrimExpr> values;
+      std::unordered_set<int64_t> slots;
+      auto add = [&](const PrimExpr& e) {
+        if (pending(e) && slots.insert(expr2slot_.at(e)->value).second) values.push_back(e);
+      };
+      for (PrimExpr e : node->values) add(e);
+      if (plan != nullptr && plan->segment < plan->segments.size()) {
+        for (const ShapeExpr& shape : plan->segments[plan->segment]) {
+          for (PrimExpr e : shape->values) add(e);
+        }
+      }
+      if (plan != nullptr) plan->computed.insert(slots.begin(), slots.end());
 
-    GlobalVar shape_func_var = builder_->AddFunction(func, "shape_func");
-    builder_->Emit(Call(shape_func_var, {shape_heap_}), "_");
+      tir::PrimFunc func = CalculateShape(values);
+      GlobalVar shape_func_var = builder_->AddFunction(func, "shape_func");
+      builder_->Emit(Call(shape_func_var, {shape_heap_}), "_");
+    }
 
     // construct shape
     Array<Integer> indices;
@@ -87,6 +136,59 @@ class VMShapeLowerMutator : public ExprMutator {
     return builder_->Emit(Call(load_shape_op, {shape_heap_}, Attrs(load_shape_attr)), "sh");
   }
 
+  BindingBlock VisitBindingBlock(const BindingBlock& block) override {
+    if (expr2slot_.empty()) {
+      return ExprMutator::VisitBindingBlock(block);
+    }
+    // Split the block into segments at the match_shapes, which store new values to the heap. The
+    // shapes of a segment only depend on the values stored before it, so they are all computed
+    // by the first shape function the segment calls.
+    BlockPlan plan;
+    // The slots computed by the enclosing blocks dominate this one.
+    if (!plans_.empty()) plan.computed = plans_.back().computed;
+    plan.segments.emplace_back();
+    for (const Binding& binding : block->bindings) {
+      ShapeExprCollector collector(&plan.segments.back());
+      if (const auto* var_binding = binding.as<VarBindingNode>()) {
+        collector.VisitExpr(var_binding->value);
+        if (var_binding->var->shape_) {
+          collector.VisitExpr(Downcast<Expr>(var_binding->var->shape_.value()));
+        }
+      } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+        collector.VisitExpr(match_shape->value);
+        plan.segments.emplace_back();
+      }
+    }
+    plans_.push_back(std::move(plan));
+    BindingBlock ret = ExprMutator::VisitBindingBlock(block);
+    plans_.pop_back();
+    return ret;
+  }
+
+  Expr VisitExpr_(const IfNode* node) override {
+    Expr cond = this->VisitExpr(node->cond);
+    Expr true_branch = VisitBranch(node->true_branch);
+    Expr false_branch = VisitBranch(node->false_branch);
+    if (node->cond.same_as(cond) && node->true_branch.same_as(true_branch) &&
+        node->false_branch.same_as(false_branch)) {
+      return GetRef<Expr>(node);
+    }
+    return If(cond, true_branch, false_branch, node->span);
+  }
+
+  /*!
+   * \brief Visit a branch of an If with its own plan. The branch may not run, so the slots it
+   *  computes must not be taken as computed by the shapes after the If.
+   */
+  Expr VisitBranch(const Expr& branch) {
+    BlockPlan plan;
+    if (!plans_.empty()) plan.computed = plans_.back().computed;
+    plans_.push_back(std::move(plan));
+    Expr ret = this->VisitWithNewScope(branch);
+    plans_.pop_back();
+    return ret;
+  }
+
   Expr VisitExpr_(const FunctionNode* node) override {
     if (heap_size_->value > 0) {
       builder_->BeginBindingBlock();
@@ -134,7 +236,7 @@ class VMShapeLowerMutator : public ExprMutator {
     return builder_->Normalize(Function(node->params, new_body, ret_type, ret_shape, node->attrs));
   }
 
-  tir::PrimFunc CalculateShape(ShapeExpr s) {
+  tir::PrimFunc CalculateShape(Array<PrimExpr> values) {
     // TODO(ziheng): avoid generating shape func for known value
     tir::Var heap("heap", DataType::Handle());
     Array<PrimExpr> buffer_shape{heap_size_};
@@ -143,7 +245,7 @@ class VMShapeLowerMutator : public ExprMutator {
     buffer_map.Set(heap, buffer);
 
     Array<tir::Stmt> seq;
-    for (PrimExpr e : s->values) {
+    for (PrimExpr e : values) {
       Map<tir::Var, PrimExpr> var_mapping = BuildVarMapping(e, buffer);
       PrimExpr value = tir::Substitute(e, var_mapping);
       // cast value to shape heap dtype
@@ -221,10 +323,22 @@ class VMShapeLowerMutator : public ExprMutator {
   }
 
  private:
+  /*! \brief The shapes to compute of a binding block. */
+  struct BlockPlan {
+    /*! \brief The non-constant shapes of each segment between match_shapes. */
+    std::vector<std::vector<ShapeExpr>> segments;
+    /*! \brief The current segment. */
+    size_t segment{0};
+    /*! \brief The heap slots already computed in the block. */
+    std::unordered_set<int64_t> computed;
+  };
+
   // function-wise members
   IntImm heap_size_;
   Var shape_heap_;
   Map<PrimExpr, Integer> expr2slot_;
+  // the plans of the binding blocks being visited, innermost last
+  std::vector<BlockPlan> plans_;
 };
 
 namespace transform {
@@ -0,0 +1,337 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/backend/vm/vm_stream_assign.cc
+ * \brief Assign independent kernel calls to multiple device streams.
+ */
+#include <tvm/relax/backend.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/tir/function.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMStreamAssign.num_streams", Integer);
+
+// ==================
+// StreamAssignMutator
+// Spread the kernel calls of a binding block over a pool of device streams, and order the
+// dependent ones with stream events.
+// Example (with 2 streams):
+// _ = add(x, y, alloc0)
+// _ = mul(x, y, alloc1)
+// _ = sub(alloc0, alloc1, alloc2)
+// -->
+// _ = call_packed("vm.builtin.stream_sync", (0, 1))
+// _ = add(x, y, alloc0)
+// _ = call_packed("vm.builtin.stream_switch", (1,))
+// _ = mul(x, y, alloc1)
+// _ = call_packed("vm.builtin.stream_sync", (0, 1))
+// _ = sub(alloc0, alloc1, alloc2)
+// _ = call_packed("vm.builtin.stream_sync", (1, 0))
+// _ = call_packed("vm.builtin.stream_switch", (0,))
+//
+// Must run after the memory lowering, so that the data dependences can be tracked per storage
+// (the memory planner may reuse a storage for several tensors), and before the shape lowering,
+// so that the shape functions it generates are not taken as device kernels. Everything that is
+// not a kernel call or an allocation is kept on the default stream 0, which is also the stream
+// every block starts and ends on.
+
+class StreamAssignMutator : public ExprMutator {
+ public:
+  StreamAssignMutator(IRModule mod, int num_streams) : mod_(mod), num_streams_(num_streams) {}
+
+  using ExprMutator::VisitExpr_;
+
+  BindingBlock VisitBindingBlock_(const BindingBlockNode* block) final {
+    // Blocks nested in If branches get their own fork and join.
+    BlockState state(num_streams_);
+    BlockState* outer = state_;
+    state_ = &state;
+
+    // Plan the whole block first, so that the streams used can fork from the default stream at
+    // the beginning of the block, before any kernel is issued to it.
+    std::vector<int> binding_ops;
+    for (const Binding& binding : block->bindings) {
+      if (const auto* var_binding = binding.as<VarBindingNode>()) {
+        binding_ops.push_back(PlanBinding(var_binding));
+      } else {
+        binding_ops.push_back(PlanHostOp(binding.as<MatchShapeNode>()->value));
+      }
+    }
+
+    builder_->BeginBindingBlock();
+    for (int s = 1; s < num_streams_; ++s) {
+      if (state.planned_tail[s] != -1) {
+        EmitStreamSync(0, s);
+      }
+    }
+    for (size_t i = 0; i < block->bindings.size(); ++i) {
+      if (binding_ops[i] != -1) {
+        IssueOp(binding_ops[i]);
+      }
+      this->VisitBinding(block->bindings[i]);
+    }
+    // Join every stream used by the block back into the default stream.
+    for (int s = 1; s < num_streams_; ++s) {
+      if (state.issued_tail[s] > state.waited[0][s]) {
+        EmitStreamSync(s, 0);
+      }
+    }
+    EmitStreamSwitch(0);
+
+    state_ = outer;
+    return builder_->EndBlock();
+  }
+
+ private:
+  /*! \brief The scheduling state of a binding block. */
+  struct BlockState {
+    explicit BlockState(int num_streams)
+        : planned_tail(num_streams, -1),
+          issued_tail(num_streams, -1),
+          waited(num_streams, std::vector<int>(num_streams, -1)) {}
+    /*! \brief The stream each op is assigned to. */
+    std::vector<int> op_stream;
+    /*! \brief The ops each op depends on. */
+    std::vector<std::vector<int>> op_deps;
+    /*! \brief The last op assigned to each stream so far by the planning. */
+    std::vector<int> planned_tail;
+    /*! \brief The last op which wrote each resource. */
+    std::unordered_map<const VarNode*, int> last_writer;
+    /*! \brief The ops which read each resource since it was last written. */
+    std::unordered_map<const VarNode*, std::vector<int>> readers;
+    /*! \brief The stream to try for the next kernel which does not extend a chain. */
+    int next_stream = 0;
+    /*! \brief The last op emitted to each stream. */
+    std::vector<int> issued_tail;
+    /*! \brief waited[dst][src] is the last op of stream src that stream dst has waited for. */
+    std::vector<std::vector<int>> waited;
+    /*! \brief The stream the ops being emitted are issued to. */
+    int current_stream = 0;
+  };
+
+  void EmitStreamSwitch(int stream) {
+    if (state_->current_stream == stream) return;
+    static const ExternFunc stream_switch("vm.builtin.stream_switch");
+    builder_->Emit(Call(stream_switch, {ShapeExpr({Integer(stream)})}), "_");
+    state_->current_stream = stream;
+  }
+
+  void EmitStreamSync(int src, int dst) {
+    static const ExternFunc stream_sync("vm.builtin.stream_sync");
+    builder_->Emit(Call(stream_sync, {ShapeExpr({Integer(src), Integer(dst)})}), "_");
+    state_->waited[dst][src] = state_->issued_tail[src];
+  }
+
+  /*! \brief Emit the syncs and the stream switch required before the given op. */
+  void IssueOp(int op) {
+    BlockState& state = *state_;
+    int stream = state.op_stream[op];
+    for (int dep : state.op_deps[op]) {
+      int src = state.op_stream[dep];
+      if (src != stream && state.waited[stream][src] < dep) {
+        EmitStreamSync(src, stream);
+      }
+    }
+    EmitStreamSwitch(stream);
+    state.issued_tail[stream] = op;
+  }
+
+  /*! \brief The resources a variable refers to, tensors alias the storage they live in. */
+  const std::vector<const VarNode*>& ResourcesOf(const VarNode* var) {
+    auto it = var2res_.find(var);
+    if (it == var2res_.end()) {
+      it = var2res_.emplace(var, std::vector<const VarNode*>{var}).first;
+    }
+    return it->second;
+  }
+
+  void CollectResources(const Expr& expr, std::vector<const VarNode*>* res) {
+    if (const auto* var = expr.as<VarNode>()) {
+      const std::vector<const VarNode*>& var_res = ResourcesOf(var);
+      res->insert(res->end(), var_res.begin(), var_res.end());
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) {
+        CollectResources(field, res);
+      }
+    } else if (const auto* get_item = expr.as<TupleGetItemNode>()) {
+      CollectResources(get_item->tuple, res);
+    }
+  }
+
+  /*! \brief The previous users an op touching the given resources depends on. */
+  std::vector<int> CollectDeps(const std::vector<const VarNode*>& reads,
+                               const std::vector<const VarNode*>& writes) {
+    std::vector<int> deps;
+    for (const VarNode* res : reads) {
+      auto it = state_->last_writer.find(res);
+      if (it != state_->last_writer.end()) deps.push_back(it->second);
+    }
+    for (const VarNode* res : writes) {
+      auto it = state_->last_writer.find(res);
+      if (it != state_->last_writer.end()) deps.push_back(it->second);
+      const std::vector<int>& readers = state_->readers[res];
+      deps.insert(deps.end(), readers.begin(), readers.end());
+    }
+    return deps;
+  }
+
+  /*! \brief Assign an op to a stream, returns the op id. */
+  int AddOp(int stream, std::vector<int> deps, const std::vector<const VarNode*>& reads,
+            const std::vector<const VarNode*>& writes) {
+    BlockState& state = *state_;
+    int op = static_cast<int>(state.op_stream.size());
+    state.op_stream.push_back(stream);
+    state.op_deps.push_back(std::move(deps));
+    state.planned_tail[stream] = op;
+    for (const VarNode* res : reads) {
+      state.readers[res].push_back(op);
+    }
+    for (const VarNode* res : writes) {
+      state.last_writer[res] = op;
+      state.readers[res].clear();
+    }
+    return op;
+  }
+
+  int PlanHostOp(const Expr& value) {
+    std::vector<const VarNode*> res;
+    PostOrderVisit(value, [this, &res](const Expr& e) {
+      if (const auto* var = e.as<VarNode>()) {
+        const std::vector<const VarNode*>& var_res = ResourcesOf(var);
+        res.insert(res.end(), var_res.begin(), var_res.end());
+      }
+    });
+    // Host ops are opaque, so conservatively take them as writing everything they touch.
+    return AddOp(0, CollectDeps({}, res), {}, res);
+  }
+
+  int PlanKernel(const Array<Expr>& args) {
+    std::vector<const VarNode*> reads, writes;
+    for (const Expr& arg : args) {
+      const auto* var = arg.as<VarNode>();
+      if (var != nullptr && fresh_tensors_.erase(var)) {
+        // The first use of a newly allocated tensor is the kernel that produces it.
+        const std::vector<const VarNode*>& var_res = ResourcesOf(var);
+        writes.insert(writes.end(), var_res.begin(), var_res.end());
+      } else {
+        CollectResources(arg, &reads);
+      }
+    }
+    std::vector<int> deps = CollectDeps(reads, writes);
+
+    // Extend the chain of the latest dep if it is still the tail of its stream, so that a chain
+    // of dependent kernels stays on one stream; otherwise pick the streams round-robin.
+    BlockState& state = *state_;
+    int stream = -1;
+    int latest = -1;
+    for (int dep : deps) {
+      int dep_stream = state.op_stream[dep];
+      if (dep > latest && state.planned_tail[dep_stream] == dep) {
+        latest = dep;
+        stream = dep_stream;
+      }
+    }
+    if (stream == -1) {
+      stream = state.next_stream;
+      state.next_stream = (state.next_stream + 1) % num_streams_;
+    }
+    return AddOp(stream, std::move(deps), reads, writes);
+  }
+
+  /*! \brief Plan a binding, returns its op id or -1 if it issues no work. */
+  int PlanBinding(const VarBindingNode* binding) {
+    static const Op& alloc_storage_op = Op::Get("relax.vm.builtin.alloc_storage");
+    static const Op& alloc_tensor_op = Op::Get("relax.vm.builtin.alloc_tensor");
+    static const Op& alloc_output_op = Op::Get("relax.vm.builtin.alloc_output");
+    static const Op& call_tir_dyn_op = Op::Get("relax.vm.call_tir_dyn");
+    const VarNode* var = binding->var.get();
+    const Expr& value = binding->value;
+
+    if (const auto* call = value.as<CallNode>()) {
+      if (call->op == alloc_storage_op) {
+        return -1;
+      } else if (call->op == alloc_tensor_op) {
+        std::vector<const VarNode*> res;
+        CollectResources(call->args[0], &res);
+        var2res_[var] = res;
+        fresh_tensors_.insert(var);
+        return -1;
+      } else if (call->op == alloc_output_op) {
+        fresh_tensors_.insert(var);
+        return -1;
+      } else if (call->op == call_tir_dyn_op) {
+        return PlanKernel(Downcast<Tuple>(call->args[1])->fields);
+      } else if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+        auto it = mod_->functions.find(GetRef<GlobalVar>(gvar));
+        if (it != mod_->functions.end() && (*it).second->IsInstance<tir::PrimFuncNode>()) {
+          return PlanKernel(call->args);
+        }
+      }
+    } else if (value->IsInstance<VarNode>() || value->IsInstance<TupleNode>() ||
+               value->IsInstance<TupleGetItemNode>()) {
+      // Aliases only forward the resources.
+      std::vector<const VarNode*> res;
+      CollectResources(value, &res);
+      var2res_[var] = res;
+      return -1;
+    } else if (value->IsInstance<ConstantNode>() || value->IsInstance<ShapeExprNode>() ||
+               value->IsInstance<ExternFuncNode>() || value->IsInstance<GlobalVarNode>()) {
+      return -1;
+    }
+    return PlanHostOp(value);
+  }
+
+  /*! \brief The module, to tell the kernel calls from the calls to Relax functions. */
+  IRModule mod_;
+  /*! \brief The number of streams to spread the kernels over. */
+  int num_streams_;
+  /*! \brief The scheduling state of the innermost block visited. */
+  BlockState* state_{nullptr};
+  /*! \brief The resources each variable refers to, when different from the variable itself. */
+  std::unordered_map<const VarNode*, std::vector<const VarNode*>> var2res_;
+  /*! \brief The allocated tensors which have not been used yet. */
+  std::unordered_set<const VarNode*> fresh_tensors_;
+};
+
+namespace transform {
+
+Pass VMStreamAssign() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        int num_streams =
+            pc->GetConfig<Integer>("relax.VMStreamAssign.num_streams", Integer(1)).value()->value;
+        if (num_streams <= 1) {
+          return f;
+        }
+        return Downcast<Function>(StreamAssignMutator(m, num_streams).VisitExpr(f));
+      };
+  return CreateFunctionPass(pass_func, 0, "VMStreamAssign", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.VMStreamAssign").set_body_typed(VMStreamAssign);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -21,6 +21,7 @@
  * \file src/relax/block_builder.cc
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relax/block_builder.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/op_attr_types.h>
@@ -33,6 +34,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // Block builder have three categories of logics that are interdependent with each other.
@@ -48,6 +50,8 @@
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.BlockBuilder.memoize_normalize", Bool);
+
 //---------------------------------------
 // ctx and scope management.
 //---------------------------------------
@@ -116,7 +120,7 @@ class BlockBuilderImpl : public BlockBuilderNode {
 
   IRModule GetContextIRModule() const final { return context_mod_; }
 
-  GlobalVar AddFunction(const BaseFunc& func, String func_name_hint) final {
+  GlobalVar AddFunction(const BaseFunc& func, String func_name_hint) override {
     LazyInitCtxFuncDedupMap();
     auto it = ctx_func_dedup_map_->find(func);
     if (it == ctx_func_dedup_map_->end()) {
@@ -140,7 +144,7 @@ class BlockBuilderImpl : public BlockBuilderNode {
     }
   }
 
-  void UpdateFunction(const GlobalVar& gv, BaseFunc function) final {
+  void UpdateFunction(const GlobalVar& gv, BaseFunc function) override {
     context_mod_.CopyOnWrite();
 
     // invalidate old dedup map
@@ -401,7 +405,8 @@ class BlockBuilderImpl : public BlockBuilderNode {
 // TODO(relax-team): Check normalize logic after struct info.
 class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&)> {
  public:
-  explicit Normalizer(IRModule context_mod) : BlockBuilderImpl(context_mod) {}
+  explicit Normalizer(IRModule context_mod, bool memoize)
+      : BlockBuilderImpl(context_mod), memoize_(memoize) {}
 
   Expr Normalize(const Expr& expr) final {
     Expr normalized = this->VisitExpr(expr);
@@ -414,10 +419,31 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
              "normalization must not be nullptr. However, this Expr does not have checked_type_: "
           << normalized;
     }
+    // A function normalized outside of any block is complete
+    if (normalized->IsInstance<FunctionNode>() && block_stack_.empty()) {
+      normalized_.clear();
+    }
 
     return normalized;
   }
 
+  GlobalVar AddFunction(const BaseFunc& func, String func_name_hint) final {
+    if (func->IsInstance<FunctionNode>()) {
+      normalized_.clear();
+    }
+    return BlockBuilderImpl::AddFunction(func, func_name_hint);
+  }
+
+  void UpdateFunction(const GlobalVar& gv, BaseFunc function) final {
+    if (function->IsInstance<FunctionNode>()) {
+      normalized_.clear();
+    }
+    BlockBuilderImpl::UpdateFunction(gv, function);
+  }
+
+  /*! \brief The number of the normalizations skipped as the expressions are normalized already. */
+  int64_t NumMemoHits() const { return num_memo_hits_; }
+
   /*!
    * \brief Normalize Argument values to call and other IR sub-fields.
    * \param arg The argument.
@@ -439,7 +465,7 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
       }
     }
     // skip visit expr's cache, normalize arg
-    Expr post = ExprFunctor::VisitExpr(arg);
+    Expr post = IsNormalized(arg) ? arg : ExprFunctor::VisitExpr(arg);
 
     if (!IsLeafExpr(arg)) {
       ICHECK(!block_stack_.empty()) << "Cannot normalize non-leaf without a scope";
@@ -495,7 +521,12 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
         return it->second;
       }
     }
-    return ExprFunctor::VisitExpr(expr);
+    if (IsNormalized(expr)) return expr;
+    Expr post = ExprFunctor::VisitExpr(expr);
+    if (memoize_ && !IsLeafExpr(post)) {
+      normalized_.insert(post);
+    }
+    return post;
   }
 
   // Helper function to get the shape of a Tuple based on its fields
@@ -767,6 +798,23 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
   }
 
  private:
+  /*!
+   * \brief Whether an expression is the result of an earlier normalization by this builder, within
+   * the function being built.
+   * \note The normal form is a fixed point of the normalization, so that the traversal of the
+   * expression can be skipped, e.g. of each binding value emitted into a function body when the
+   * body is normalized, or when a mutator normalizes the function it rebuilt. The memo is cleared
+   * once the function is complete, i.e. normalized outside of any block or added to the module, so
+   * that it only holds the expressions of one function alive.
+   */
+  bool IsNormalized(const Expr& expr) {
+    if (memoize_ && normalized_.count(expr)) {
+      ++num_memo_hits_;
+      return true;
+    }
+    return false;
+  }
+
   bool ShapeStructEqual(const Expr& lhs, const Expr& rhs) { return CanProveShapeEqual(lhs, rhs); }
 
   // Helper function to check if a ShapeExpr is constant shape or tuple of constant shape
@@ -1072,10 +1120,22 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
 
   /*! \brief Operator to type inference map. */
   tvm::OpAttrMap<FInferType> op_map_infer_type_ = Op::GetAttrMap<FInferType>("FInferType");
+
+  /*! \brief Whether to memoize the normalized expressions. */
+  bool memoize_;
+
+  /*! \brief The non-leaf expressions normalized in the function being built. */
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> normalized_;
+
+  /*! \brief The number of the normalizations skipped by the memo. */
+  int64_t num_memo_hits_{0};
 };
 
 BlockBuilder BlockBuilder::Create(Optional<IRModule> mod) {
-  ObjectPtr<BlockBuilderNode> n = make_object<Normalizer>(mod.value_or(IRModule()));
+  bool memoize = transform::PassContext::Current()
+                     ->GetConfig<Bool>("relax.BlockBuilder.memoize_normalize", Bool(true))
+                     .value();
+  ObjectPtr<BlockBuilderNode> n = make_object<Normalizer>(mod.value_or(IRModule()), memoize);
   return BlockBuilder(n);
 }
 
@@ -1100,6 +1160,12 @@ TVM_REGISTER_GLOBAL("relax.BlockBuilderEndBlock")
 TVM_REGISTER_GLOBAL("relax.BlockBuilderNormalize")
     .set_body_method<BlockBuilder>(&BlockBuilderNode::Normalize);
 
+TVM_REGISTER_GLOBAL("relax.BlockBuilderNumNormalizeMemoHits")
+    .set_body_typed([](BlockBuilder builder) -> int64_t {
+      // Every builder is a Normalizer, as created by BlockBuilder::Create
+      return static_cast<const Normalizer*>(builder.get())->NumMemoHits();
+    });
+
 TVM_REGISTER_GLOBAL("relax.BlockBuilderEmit").set_body_typed([](BlockBuilder builder, Expr expr) {
   return builder->Emit(expr);
 });
@@ -29,9 +29,14 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <deque>
+#include <functional>
 #include <limits>
+#include <map>
+#include <set>
 #include <stack>
 #include <type_traits>
 #include <unordered_map>
@@ -507,6 +512,334 @@ bool MatchExpr(DFPattern pattern, Expr expr, Optional<runtime::Map<Var, Expr>> v
 
 TVM_REGISTER_GLOBAL("relax.dpl.match_expr").set_body_typed(MatchExpr);
 
+PatternIndex::PatternIndex(Array<DFPattern> patterns) {
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    std::vector<RootKey> keys;
+    if (!CollectRootKeys(patterns[i], &keys)) {
+      unindexed_.push_back(i);
+      continue;
+    }
+    for (const RootKey& key : keys) {
+      if (key.op != nullptr) {
+        op_patterns_[key.op].emplace_back(i, key);
+      } else {
+        call_patterns_.emplace_back(i, key);
+      }
+    }
+  }
+}
+
+std::vector<size_t> PatternIndex::Candidates(const Expr& expr) const {
+  std::vector<size_t> ret = unindexed_;
+  if (const auto* call = expr.as<CallNode>()) {
+    for (const auto& kv : call_patterns_) {
+      if (KeyMatches(kv.second, expr)) ret.push_back(kv.first);
+    }
+    auto it = op_patterns_.find(call->op.get());
+    if (it != op_patterns_.end()) {
+      for (const auto& kv : it->second) {
+        if (KeyMatches(kv.second, expr)) ret.push_back(kv.first);
+      }
+    }
+  }
+  std::sort(ret.begin(), ret.end());
+  ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+  return ret;
+}
+
+bool PatternIndex::MayMatch(const DFPattern& pattern, const Expr& expr) {
+  std::vector<RootKey> keys;
+  if (!CollectRootKeys(pattern, &keys)) return true;
+  return std::any_of(keys.begin(), keys.end(),
+                     [&expr](const RootKey& key) { return KeyMatches(key, expr); });
+}
+
+bool PatternIndex::CollectRootKeys(const DFPattern& pattern, std::vector<RootKey>* keys) {
+  if (const auto* call = pattern.as<CallPatternNode>()) {
+    const Object* op = nullptr;
+    if (const auto* expr_pattern = call->op.as<ExprPatternNode>()) {
+      if (expr_pattern->expr->IsInstance<OpNode>()) op = expr_pattern->expr.get();
+    }
+    keys->push_back({op, call->args.size(), call->varg_default_wildcard});
+    // The matcher also matches the multiplies and divides reassociated with each other.
+    static const Op& multiply_op = Op::Get("relax.multiply");
+    static const Op& divide_op = Op::Get("relax.divide");
+    if (op == multiply_op.get() || op == divide_op.get()) {
+      const Object* other = op == multiply_op.get() ? divide_op.get() : multiply_op.get();
+      keys->push_back({other, call->args.size(), call->varg_default_wildcard});
+    }
+    return true;
+  } else if (const auto* op = pattern.as<OrPatternNode>()) {
+    size_t num_keys = keys->size();
+    if (CollectRootKeys(op->left, keys) && CollectRootKeys(op->right, keys)) return true;
+    keys->resize(num_keys);
+    return false;
+  } else if (const auto* op = pattern.as<AndPatternNode>()) {
+    // Either side is a necessary condition.
+    size_t num_keys = keys->size();
+    if (CollectRootKeys(op->left, keys)) return true;
+    keys->resize(num_keys);
+    if (CollectRootKeys(op->right, keys)) return true;
+    keys->resize(num_keys);
+    return false;
+  } else if (const auto* op = pattern.as<AttrPatternNode>()) {
+    return CollectRootKeys(op->pattern, keys);
+  } else if (const auto* op = pattern.as<TypePatternNode>()) {
+    return CollectRootKeys(op->pattern, keys);
+  } else if (const auto* op = pattern.as<ShapePatternNode>()) {
+    return CollectRootKeys(op->pattern, keys);
+  } else if (const auto* op = pattern.as<DataTypePatternNode>()) {
+    return CollectRootKeys(op->pattern, keys);
+  } else if (const auto* op = pattern.as<RuntimeDepShapePatternNode>()) {
+    return CollectRootKeys(op->pattern, keys);
+  }
+  return false;
+}
+
+bool PatternIndex::KeyMatches(const RootKey& key, const Expr& expr) {
+  const auto* call = expr.as<CallNode>();
+  if (call == nullptr) return false;
+  if (key.op != nullptr && key.op != call->op.get()) return false;
+  return key.varg ? call->args.size() >= key.num_args : call->args.size() == key.num_args;
+}
+
+/*!
+ * \brief The value an expression is bound to through the var bindings, which is what the root of a
+ * pattern is matched against with var2val.
+ */
+static Expr GetBoundValue(Expr expr, const runtime::Map<Var, Expr>& var2val) {
+  // Bound the walk, in case of a malformed cyclic binding.
+  for (size_t i = 0; i <= var2val.size(); ++i) {
+    const auto* var = expr.as<VarNode>();
+    if (var == nullptr) break;
+    Optional<Expr> value = var2val.Get(GetRef<Var>(var));
+    if (!value.defined()) break;
+    expr = value.value();
+  }
+  return expr;
+}
+
+Map<Var, Integer> MatchBindings(const Array<DFPattern>& patterns, const DataflowBlock& dfb) {
+  Map<Var, Integer> ret;
+  runtime::Map<Var, Expr> var2val = AnalyzeVar2Value(dfb);
+  DFPatternMatcher matcher(var2val);
+  PatternIndex index(patterns);
+  for (const Binding& binding : dfb->bindings) {
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (var_binding == nullptr) continue;
+    for (size_t i : index.Candidates(GetBoundValue(var_binding->value, var2val))) {
+      if (matcher.Match(patterns[i], var_binding->var)) {
+        ret.Set(var_binding->var, Integer(i));
+        break;
+      }
+    }
+  }
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("relax.dpl.match_bindings").set_body_typed(MatchBindings);
+
+/*! \brief The depth of the calls and the tuples a pattern matches through from its root. */
+static size_t PatternDepth(const DFPattern& pattern) {
+  auto max_depth = [](const Array<DFPattern>& patterns) {
+    size_t depth = 0;
+    for (const DFPattern& pattern : patterns) depth = std::max(depth, PatternDepth(pattern));
+    return depth;
+  };
+  if (const auto* op = pattern.as<CallPatternNode>()) {
+    return std::max(PatternDepth(op->op), op->args.defined() ? max_depth(op->args) : 0) + 1;
+  } else if (const auto* op = pattern.as<TuplePatternNode>()) {
+    return max_depth(op->fields) + 1;
+  } else if (const auto* op = pattern.as<UnorderedTuplePatternNode>()) {
+    return max_depth(op->fields) + 1;
+  } else if (const auto* op = pattern.as<TupleGetItemPatternNode>()) {
+    return PatternDepth(op->tuple) + 1;
+  } else if (const auto* op = pattern.as<OrPatternNode>()) {
+    return std::max(PatternDepth(op->left), PatternDepth(op->right));
+  } else if (const auto* op = pattern.as<AndPatternNode>()) {
+    return std::max(PatternDepth(op->left), PatternDepth(op->right));
+  } else if (const auto* op = pattern.as<NotPatternNode>()) {
+    return PatternDepth(op->reject);
+  } else if (const auto* op = pattern.as<AttrPatternNode>()) {
+    return PatternDepth(op->pattern);
+  } else if (const auto* op = pattern.as<TypePatternNode>()) {
+    return PatternDepth(op->pattern);
+  } else if (const auto* op = pattern.as<ShapePatternNode>()) {
+    return PatternDepth(op->pattern);
+  } else if (const auto* op = pattern.as<DataTypePatternNode>()) {
+    return PatternDepth(op->pattern);
+  } else if (const auto* op = pattern.as<RuntimeDepShapePatternNode>()) {
+    return PatternDepth(op->pattern);
+  }
+  return 0;
+}
+
+/*! \brief The matcher of the bindings being rewritten, whose values are updated in place. */
+class BindingMatcher : public DFPatternMatcher {
+ public:
+  void Bind(const Var& var, const Expr& value) { var2val_.Set(var, value); }
+  const var2val_t& var2val() const { return var2val_; }
+};
+
+/*!
+ * \brief The worklist driver of RewriteBindings.
+ * \details The bindings of a DataflowBlock are matched in order. When a binding is rewritten, the
+ * new value is normalized on its own, with its ANF bindings emitted before the binding, and the
+ * matcher sees it through var2val. Only the binding and its users up to the depth of the patterns
+ * are matched again, as the other matches do not depend on the new value. The block is emitted
+ * once at the fixpoint, without the dataflow vars left unused.
+ */
+class BindingRewriter : public ExprMutator {
+ public:
+  BindingRewriter(Array<DFPattern> patterns, Array<PackedFunc> rewriters)
+      : patterns_(patterns), rewriters_(rewriters), index_(patterns) {
+    for (const DFPattern& pattern : patterns_) {
+      max_depth_ = std::max(max_depth_, PatternDepth(pattern));
+    }
+  }
+
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    std::vector<Binding> bindings;
+    // The bindings to emit before each binding, i.e. the ANF bindings of its rewritten value.
+    std::vector<std::vector<size_t>> emit_before;
+    std::unordered_map<const VarNode*, std::vector<size_t>> users;
+    std::vector<bool> queued;
+    std::deque<size_t> worklist;
+    BindingMatcher matcher;
+
+    auto enqueue = [&](size_t i) {
+      if (!queued[i]) {
+        queued[i] = true;
+        worklist.push_back(i);
+      }
+    };
+    auto add_users = [&](size_t i) {
+      const auto* binding = bindings[i].as<VarBindingNode>();
+      if (binding == nullptr) return;
+      matcher.Bind(binding->var, binding->value);
+      for (const Var& var : FreeVars(binding->value)) users[var.get()].push_back(i);
+    };
+    auto add_binding = [&](const Binding& binding) {
+      bindings.push_back(binding);
+      emit_before.emplace_back();
+      queued.push_back(false);
+      add_users(bindings.size() - 1);
+      enqueue(bindings.size() - 1);
+      return bindings.size() - 1;
+    };
+
+    for (const Binding& binding : block->bindings) add_binding(binding);
+    size_t num_bindings = bindings.size();
+    bool rewritten = false;
+    while (!worklist.empty()) {
+      size_t i = worklist.front();
+      worklist.pop_front();
+      queued[i] = false;
+      const auto* binding = bindings[i].as<VarBindingNode>();
+      if (binding == nullptr) continue;
+      Optional<Expr> new_value = RewriteBinding(binding, &matcher);
+      if (!new_value.defined()) continue;
+      rewritten = true;
+      Var var = binding->var;
+      builder_->BeginDataflowBlock();
+      Expr normalized = builder_->Normalize(new_value.value());
+      BindingBlock anf_block = builder_->EndBlock();
+      for (const Binding& anf_binding : anf_block->bindings) {
+        size_t j = add_binding(anf_binding);
+        emit_before[i].push_back(j);
+      }
+      bindings[i] = VarBinding(var, normalized);
+      add_users(i);
+      enqueue(i);
+      // The patterns rooted at the users see the new value through var2val.
+      std::vector<size_t> frontier{i};
+      std::unordered_set<size_t> visited{i};
+      for (size_t depth = 1; depth < max_depth_ && !frontier.empty(); ++depth) {
+        std::vector<size_t> next;
+        for (size_t j : frontier) {
+          const auto* user_binding = bindings[j].as<VarBindingNode>();
+          if (user_binding == nullptr) continue;
+          for (size_t user : users[user_binding->var.get()]) {
+            if (visited.insert(user).second) {
+              enqueue(user);
+              next.push_back(user);
+            }
+          }
+        }
+        frontier = std::move(next);
+      }
+    }
+    if (!rewritten) {
+      return ExprMutator::VisitBindingBlock_(block);
+    }
+
+    std::vector<size_t> order;
+    std::function<void(size_t)> visit_order = [&](size_t i) {
+      for (size_t j : emit_before[i]) visit_order(j);
+      order.push_back(i);
+    };
+    for (size_t i = 0; i < num_bindings; ++i) visit_order(i);
+    // Remove the dataflow vars left unused, in the reverse order.
+    std::unordered_map<const VarNode*, int> num_uses;
+    for (size_t i : order) {
+      Expr value = bindings[i]->IsInstance<VarBindingNode>()
+                       ? Downcast<VarBinding>(bindings[i])->value
+                       : Downcast<MatchShape>(bindings[i])->value;
+      for (const Var& var : FreeVars(value)) ++num_uses[var.get()];
+    }
+    std::vector<bool> live(bindings.size(), true);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      const auto* binding = bindings[*it].as<VarBindingNode>();
+      if (binding == nullptr || !binding->var->IsInstance<DataflowVarNode>() ||
+          num_uses[binding->var.get()] > 0) {
+        continue;
+      }
+      live[*it] = false;
+      for (const Var& var : FreeVars(binding->value)) --num_uses[var.get()];
+    }
+
+    builder_->BeginDataflowBlock();
+    for (size_t i : order) {
+      if (live[i]) this->VisitBinding(bindings[i]);
+    }
+    return builder_->EndBlock();
+  }
+
+ private:
+  /*! \brief Rewrite a binding with the first rule which matches it and changes its value. */
+  Optional<Expr> RewriteBinding(const VarBindingNode* binding, BindingMatcher* matcher) {
+    for (size_t i : index_.Candidates(GetBoundValue(binding->value, matcher->var2val()))) {
+      if (!matcher->Match(patterns_[i], binding->var)) continue;
+      Map<DFPattern, Expr> matches;
+      for (const auto& kv : matcher->GetMemo()) matches.Set(kv.first, kv.second[0]);
+      Expr new_value = rewriters_[i](binding->value, matches);
+      // A rule returning an equal value declines, which also guards the fixpoint.
+      if (!new_value.same_as(binding->value) && !StructuralEqual()(new_value, binding->value)) {
+        return new_value;
+      }
+    }
+    return NullOpt;
+  }
+
+  Array<DFPattern> patterns_;
+  Array<PackedFunc> rewriters_;
+  PatternIndex index_;
+  /*! \brief The maximum depth of the patterns, to which the users are matched again. */
+  size_t max_depth_ = 1;
+};
+
+Function RewriteBindings(const Array<DFPattern>& patterns, const Array<PackedFunc>& rewriters,
+                         const Function& func) {
+  CHECK_EQ(patterns.size(), rewriters.size())
+      << "ValueError: Each pattern must have a rewriter, but gets " << patterns.size()
+      << " patterns and " << rewriters.size() << " rewriters";
+  return Downcast<Function>(BindingRewriter(patterns, rewriters).VisitExpr(func));
+}
+
+TVM_REGISTER_GLOBAL("relax.dpl.rewrite_bindings").set_body_typed(RewriteBindings);
+
 struct PNode {
   const DFPatternNode* ptr;
   const VarNode* matched = nullptr;
@@ -720,7 +1053,9 @@ tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx, const Da
   if (start_hint.defined()) {
     Var v = start_hint.value();
     auto rnode_ptr = var2node.find(v.get());
+    Expr hint_value = GetBoundValue(v, var2val);
     for (auto& ppair : pattern2node) {
+      if (!PatternIndex::MayMatch(GetRef<DFPattern>(ppair.first), hint_value)) continue;
       if (try_match(&ppair.second, &rnode_ptr->second, &matcher, def2use, caller2callees)) {
         for (auto ppair : pattern2node)
           ret.Set(GetRef<DFPattern>(ppair.first), GetRef<Var>(ppair.second.matched));
@@ -734,8 +1069,12 @@ tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx, const Da
   PNode* pnode_start = &pattern2node.begin()->second;
 
   if (!pnode_start->matched) {
+    PatternIndex start_index({GetRef<DFPattern>(pnode_start->ptr)});
     for (auto& rpair : var2node) {
       if (start_hint.defined() && start_hint.value().get() == rpair.first) continue;
+      // Skip the nodes the start pattern cannot match by its root, before the matching.
+      Expr value = GetBoundValue(GetRef<Var>(rpair.first), var2val);
+      if (start_index.Candidates(value).empty()) continue;
       if (try_match(pnode_start, &rpair.second, &matcher, def2use, caller2callees)) {
         for (auto ppair : pattern2node)
           ret.Set(GetRef<DFPattern>(ppair.first), GetRef<Var>(ppair.second.matched));
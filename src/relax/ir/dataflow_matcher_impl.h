@@ -82,6 +82,51 @@ class DFPatternMatcher : public DFPatternFunctor<bool(const DFPattern&, const Ex
   bool memoize_ = true;
 };
 
+/*!
+ * \brief An index of patterns by the operator and the arity of the calls their roots can match.
+ * \details Most of the patterns of a pattern table are rooted at a call to a specific operator, so
+ * that running the matcher of each of them on every expression is mostly wasted. The index yields,
+ * for an expression, only the patterns whose root may match it, which is a necessary condition
+ * of the full match.
+ */
+class PatternIndex {
+ public:
+  explicit PatternIndex(Array<DFPattern> patterns);
+
+  /*!
+   * \brief The patterns which may match an expression.
+   * \param expr The expression, i.e. the value of a binding for a matcher with var2val.
+   * \return The indices of the candidate patterns, in increasing order.
+   */
+  std::vector<size_t> Candidates(const Expr& expr) const;
+
+  /*! \brief Whether a pattern may match an expression by its root. */
+  static bool MayMatch(const DFPattern& pattern, const Expr& expr);
+
+ private:
+  /*! \brief The calls a pattern root can match, with a null op for any op. */
+  struct RootKey {
+    const Object* op;
+    size_t num_args;
+    bool varg;
+  };
+
+  /*!
+   * \brief Collect the calls the root of a pattern can match.
+   * \return Whether the pattern is restricted to the collected calls.
+   */
+  static bool CollectRootKeys(const DFPattern& pattern, std::vector<RootKey>* keys);
+
+  static bool KeyMatches(const RootKey& key, const Expr& expr);
+
+  /*! \brief The patterns of each op, with the keys of that op. */
+  std::unordered_map<const Object*, std::vector<std::pair<size_t, RootKey>>> op_patterns_;
+  /*! \brief The patterns restricted to calls of any op. */
+  std::vector<std::pair<size_t, RootKey>> call_patterns_;
+  /*! \brief The patterns which are not restricted by their root. */
+  std::vector<size_t> unindexed_;
+};
+
 }  // namespace relax
 }  // namespace tvm
 
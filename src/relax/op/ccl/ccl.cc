@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file ccl.cc
+ * \brief Collective communication operators, among the workers running the shards of a model.
+ */
+
+#include "ccl.h"
+
+#include "../tensor/unary.h"
+
+namespace tvm {
+namespace relax {
+
+/* relax.ccl.allreduce */
+TVM_REGISTER_NODE_TYPE(AllReduceAttrs);
+
+RELAX_REGISTER_OP("relax.ccl.allreduce")
+    .set_attrs_type<AllReduceAttrs>()
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The shard of this worker.")
+    .set_attr<FInferShape>("FInferShape", InferShapeUnaryBroadcast)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryBroadcast);
+
+Expr MakeAllReduce(Expr data, String op_type) {
+  ObjectPtr<AllReduceAttrs> attrs = make_object<AllReduceAttrs>();
+  attrs->op_type = std::move(op_type);
+
+  static const Op& op = Op::Get("relax.ccl.allreduce");
+  return Call(op, {std::move(data)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.allreduce").set_body_typed(MakeAllReduce);
+
+/* relax.ccl.allgather */
+TVM_REGISTER_NODE_TYPE(AllGatherAttrs);
+
+RELAX_REGISTER_OP("relax.ccl.allgather")
+    .set_attrs_type<AllGatherAttrs>()
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The shard of this worker.")
+    .set_attr<FInferShape>("FInferShape", InferShapeAllGather)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryBroadcast);
+
+Expr MakeAllGather(Expr data, int num_workers) {
+  ObjectPtr<AllGatherAttrs> attrs = make_object<AllGatherAttrs>();
+  attrs->num_workers = num_workers;
+
+  static const Op& op = Op::Get("relax.ccl.allgather");
+  return Call(op, {std::move(data)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.allgather").set_body_typed(MakeAllGather);
+
+/*! \brief The shape of the input of a collective, whose first dimension is rescaled. */
+static const ShapeExprNode* GetCollectiveInputShape(const Call& call, int num_workers,
+                                                    DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << call->op << " op should have 1 argument");
+  }
+  if (num_workers <= 0) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects a positive number of workers, but gets "
+                       << num_workers);
+  }
+  const auto* input_shape = call->args[0]->shape().as<ShapeExprNode>();
+  if (input_shape != nullptr && input_shape->values.empty()) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op
+                       << " works along the first dimension, but the input is a scalar");
+  }
+  return input_shape;
+}
+
+Expr InferShapeAllGather(const Call& call, DiagnosticContext diag_ctx) {
+  const auto* attrs = call->attrs.as<AllGatherAttrs>();
+  const ShapeExprNode* input_shape = GetCollectiveInputShape(call, attrs->num_workers, diag_ctx);
+  if (input_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  Array<PrimExpr> output_shape = input_shape->values;
+  output_shape.Set(0, output_shape[0] * attrs->num_workers);
+  return ShapeExpr(output_shape);
+}
+
+/* relax.ccl.reduce_scatter */
+TVM_REGISTER_NODE_TYPE(ReduceScatterAttrs);
+
+RELAX_REGISTER_OP("relax.ccl.reduce_scatter")
+    .set_attrs_type<ReduceScatterAttrs>()
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The shard of this worker.")
+    .set_attr<FInferShape>("FInferShape", InferShapeReduceScatter)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryBroadcast);
+
+Expr MakeReduceScatter(Expr data, int num_workers, String op_type) {
+  ObjectPtr<ReduceScatterAttrs> attrs = make_object<ReduceScatterAttrs>();
+  attrs->num_workers = num_workers;
+  attrs->op_type = std::move(op_type);
+
+  static const Op& op = Op::Get("relax.ccl.reduce_scatter");
+  return Call(op, {std::move(data)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.reduce_scatter").set_body_typed(MakeReduceScatter);
+
+Expr InferShapeReduceScatter(const Call& call, DiagnosticContext diag_ctx) {
+  const auto* attrs = call->attrs.as<ReduceScatterAttrs>();
+  const ShapeExprNode* input_shape = GetCollectiveInputShape(call, attrs->num_workers, diag_ctx);
+  if (input_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  Array<PrimExpr> output_shape = input_shape->values;
+  output_shape.Set(0, floordiv(output_shape[0], attrs->num_workers));
+  return ShapeExpr(output_shape);
+}
+
+}  // namespace relax
+}  // namespace tvm
@@ -40,14 +40,26 @@ Expr MakeMemKillStorage(Expr storage);
 
 Expr MakeMemKillTensor(Expr tensor);
 
-Expr MakeVMAllocStorage(Expr size, DataType dtype, int64_t runtime_device_index);
+Expr MakeVMAllocStorage(Expr size, DataType dtype, int64_t runtime_device_index,
+                        std::string storage_scope = "global");
 
 Expr MakeVMAllocTensor(Expr storage, Expr shape, int offset, DataType dtype);
 
+Expr MakeVMAllocOutput(Expr shape, int output_index, DataType dtype, int64_t runtime_device_index);
+
 Expr MakeCast(Expr data, DataType dtype);
 
 Expr MakeTranspose(Expr data, Optional<Array<Integer>> axes);
 
+Expr MakeQuantizeWeight(Expr weight, int bits, int group_size);
+
+Expr MakeQuantizedDense(Expr data, Expr packed, Expr scale, int bits, int group_size,
+                        DataType out_dtype);
+
+Expr MakeSparsePack2in4(Expr weight);
+
+Expr MakeSparseDense2in4(Expr data, Expr values, Expr metadata, DataType out_dtype);
+
 }  // namespace relax
 }  // namespace tvm
 #endif  // TVM_RELAX_OP_MAKE_OP_H_
@@ -19,6 +19,8 @@
 
 #include "nn.h"
 
+#include <tvm/topi/nn.h>
+
 namespace tvm {
 namespace relax {
 TVM_REGISTER_NODE_TYPE(DenseAttrs);
@@ -75,7 +77,8 @@ RELAX_REGISTER_OP("relax.nn.softmax")
 TVM_REGISTER_GLOBAL("relax.op.nn.softmax").set_body_typed(MakeSoftmax);
 
 /* relax.nn.relu */
-RELAX_REGISTER_UNARY_OP("nn.relu");
+RELAX_REGISTER_UNARY_OP("nn.relu")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::relu<float>));
 
 /* relax.nn.gelu */
 RELAX_REGISTER_UNARY_OP("nn.gelu");
@@ -615,6 +618,392 @@ Type InferTypeMatmul(const Call& call, DiagnosticContext diag_ctx) {
   return DynTensorType(output_ndim, output_dtype);
 }
 
+/* relax.nn.grouped_matmul */
+TVM_REGISTER_NODE_TYPE(GroupedMatmulAttrs);
+
+RELAX_REGISTER_OP("relax.nn.grouped_matmul")
+    .set_num_inputs(3)
+    .add_argument("x", "Tensor", "The rows of all the groups.")
+    .add_argument("w", "Tensor", "The weights of the groups.")
+    .add_argument("indptr", "Tensor", "The offsets of the rows of the groups in x.")
+    .set_attr<FInferShape>("FInferShape", InferShapeGroupedMatmul)
+    .set_attr<FInferType>("FInferType", InferTypeGroupedMatmul);
+
+Expr MakeGroupedMatmul(Expr x, Expr w, Expr indptr, bool transpose_w, DataType out_dtype) {
+  ObjectPtr<GroupedMatmulAttrs> attrs = make_object<GroupedMatmulAttrs>();
+  attrs->transpose_w = transpose_w;
+  attrs->out_dtype = out_dtype;
+
+  static const Op& op = Op::Get("relax.nn.grouped_matmul");
+  return Call(op, {std::move(x), std::move(w), std::move(indptr)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.grouped_matmul").set_body_typed(MakeGroupedMatmul);
+
+Expr InferShapeGroupedMatmul(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul operator should have 3 arguments");
+  }
+  const auto* x_shape = call->args[0]->shape().as<ShapeExprNode>();
+  const auto* w_shape = call->args[1]->shape().as<ShapeExprNode>();
+  const auto* indptr_shape = call->args[2]->shape().as<ShapeExprNode>();
+  const auto* attrs = call->attrs.as<GroupedMatmulAttrs>();
+  if (x_shape == nullptr || w_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  if (x_shape->values.size() != 2 || w_shape->values.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul expects x of shape (m, k) and w of shape (num_groups, k, "
+                          "n). However, x has rank "
+                       << x_shape->values.size() << " and w has rank " << w_shape->values.size());
+  }
+
+  arith::Analyzer ana;
+  PrimExpr k = attrs->transpose_w ? w_shape->values[2] : w_shape->values[1];
+  if (ana.CanProve(x_shape->values[1] != k)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul expects the reduction dimensions of x and w to match. "
+                          "However, x has "
+                       << x_shape->values[1] << " columns while the weights have " << k << " rows");
+  }
+  if (indptr_shape != nullptr &&
+      (indptr_shape->values.size() != 1 ||
+       ana.CanProve(indptr_shape->values[0] != w_shape->values[0] + 1))) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul expects indptr to have num_groups + 1 offsets, which is "
+                       << w_shape->values[0] + 1);
+  }
+  PrimExpr n = attrs->transpose_w ? w_shape->values[1] : w_shape->values[2];
+  return ShapeExpr({x_shape->values[0], n});
+}
+
+Type InferTypeGroupedMatmul(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul operator should have 3 arguments");
+  }
+  const auto* x_type = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  const auto* w_type = call->args[1]->checked_type().as<DynTensorTypeNode>();
+  const auto* indptr_type = call->args[2]->checked_type().as<DynTensorTypeNode>();
+  const auto* attrs = call->attrs.as<GroupedMatmulAttrs>();
+  if (x_type == nullptr || w_type == nullptr || indptr_type == nullptr) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul expects x, w and indptr to have type DynTensorType");
+  }
+  if (!indptr_type->IsUnknownDtype() && indptr_type->dtype != DataType::Int(64)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul expects indptr to be int64, but gets "
+                       << indptr_type->dtype);
+  }
+
+  DataType output_dtype;
+  if (x_type->IsUnknownDtype() || w_type->IsUnknownDtype()) {
+    output_dtype = attrs->out_dtype;
+  } else if (x_type->dtype != w_type->dtype) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "GroupedMatmul expects x and w to have the same data type. However, x "
+                          "has dtype "
+                       << x_type->dtype << " while w has dtype " << w_type->dtype);
+  } else {
+    output_dtype = attrs->out_dtype.is_void() ? x_type->dtype : attrs->out_dtype;
+  }
+  return DynTensorType(2, output_dtype);
+}
+
+/* relax.nn.attention */
+TVM_REGISTER_NODE_TYPE(AttentionAttrs);
+
+RELAX_REGISTER_OP("relax.nn.attention")
+    .set_num_inputs(4)
+    .add_argument("query", "Tensor", "The queries, of shape (batch, seq_len, num_heads, head_dim).")
+    .add_argument("key", "Tensor", "The keys, of shape (batch, seq_len_kv, num_heads, head_dim).")
+    .add_argument("value", "Tensor",
+                  "The values, of shape (batch, seq_len_kv, num_heads, head_dim_v).")
+    .add_argument("bias", "Tensor",
+                  "The optional bias of the scores, broadcast to (batch, num_heads, seq_len, "
+                  "seq_len_kv).")
+    .set_attr<FInferShape>("FInferShape", InferShapeAttention)
+    .set_attr<FInferType>("FInferType", InferTypeAttention);
+
+Expr MakeAttention(Expr query, Expr key, Expr value, Optional<Expr> bias, Optional<FloatImm> scale,
+                   String causal_mask, double dropout_rate, int seed) {
+  ObjectPtr<AttentionAttrs> attrs = make_object<AttentionAttrs>();
+  attrs->scale = scale;
+  attrs->causal_mask = causal_mask;
+  attrs->dropout_rate = dropout_rate;
+  attrs->seed = seed;
+
+  static const Op& op = Op::Get("relax.nn.attention");
+  Array<Expr> args{std::move(query), std::move(key), std::move(value)};
+  if (bias.defined()) {
+    args.push_back(bias.value());
+  }
+  return Call(op, args, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.attention").set_body_typed(MakeAttention);
+
+Expr InferShapeAttention(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3 && call->args.size() != 4) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Attention operator should have 3 or 4 arguments");
+  }
+  const auto* attrs = call->attrs.as<AttentionAttrs>();
+  if (attrs->causal_mask != "" && attrs->causal_mask != "TopLeft" &&
+      attrs->causal_mask != "BottomRight") {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Attention expects the causal mask to be empty, TopLeft or BottomRight, "
+                          "but gets "
+                       << attrs->causal_mask);
+  }
+  if (attrs->dropout_rate < 0 || attrs->dropout_rate >= 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Attention expects a dropout rate in [0, 1), but gets "
+                       << attrs->dropout_rate);
+  }
+
+  std::vector<const ShapeExprNode*> shapes;
+  for (const Expr& arg : call->args) {
+    shapes.push_back(arg->shape().as<ShapeExprNode>());
+  }
+  if (shapes[0] == nullptr || shapes[1] == nullptr || shapes[2] == nullptr) {
+    return RuntimeDepShape();
+  }
+  for (const ShapeExprNode* shape : shapes) {
+    if (shape != nullptr && shape->values.size() != 4) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "Attention expects the query, the key, the value and the bias to "
+                            "have rank 4. However, one of them has rank "
+                         << shape->values.size());
+    }
+  }
+
+  const Array<PrimExpr>& q = shapes[0]->values;
+  const Array<PrimExpr>& k = shapes[1]->values;
+  const Array<PrimExpr>& v = shapes[2]->values;
+  arith::Analyzer ana;
+  auto check_equal = [&](const PrimExpr& lhs, const PrimExpr& rhs, const char* what) {
+    if (ana.CanProve(lhs != rhs)) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "Attention expects the " << what << " to match, but gets " << lhs
+                         << " and " << rhs);
+    }
+  };
+  check_equal(q[0], k[0], "batch sizes of the query and the key");
+  check_equal(q[0], v[0], "batch sizes of the query and the value");
+  check_equal(k[1], v[1], "sequence lengths of the key and the value");
+  check_equal(q[2], k[2], "numbers of heads of the query and the key");
+  check_equal(q[2], v[2], "numbers of heads of the query and the value");
+  check_equal(q[3], k[3], "head dimensions of the query and the key");
+  if (shapes.size() == 4 && shapes[3] != nullptr) {
+    // The bias is broadcast to the scores, of shape (batch, num_heads, seq_len, seq_len_kv).
+    Array<PrimExpr> scores{q[0], q[2], q[1], k[1]};
+    for (int i = 0; i < 4; ++i) {
+      PrimExpr dim = shapes[3]->values[i];
+      if (!tir::is_one(dim)) {
+        check_equal(dim, scores[i], "dimensions of the bias and the scores");
+      }
+    }
+  }
+  return ShapeExpr({q[0], q[1], q[2], v[3]});
+}
+
+Type InferTypeAttention(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3 && call->args.size() != 4) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Attention operator should have 3 or 4 arguments");
+  }
+  DataType output_dtype = DataType::Void();
+  for (const Expr& arg : call->args) {
+    const auto* type = arg->checked_type().as<DynTensorTypeNode>();
+    if (type == nullptr) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "Attention expects the query, the key, the value and the bias to "
+                            "have type DynTensorType");
+    }
+    if (type->IsUnknownDtype()) {
+      continue;
+    }
+    if (!output_dtype.is_void() && type->dtype != output_dtype) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "Attention expects its inputs to have the same data type. However, "
+                            "they have dtypes "
+                         << output_dtype << " and " << type->dtype);
+    }
+    output_dtype = type->dtype;
+  }
+  return DynTensorType(4, output_dtype);
+}
+
+/* relax.nn.fused_layer_norm and relax.nn.rms_norm */
+TVM_REGISTER_NODE_TYPE(FusedNormAttrs);
+
+RELAX_REGISTER_OP("relax.nn.fused_layer_norm")
+    .set_attrs_type<FusedNormAttrs>()
+    .set_num_inputs(4)
+    .add_argument("data", "Tensor", "Input to which layer_norm will be applied.")
+    .add_argument("gamma", "Tensor", "The gamma scale factor.")
+    .add_argument("beta", "Tensor", "The beta offset factor.")
+    .add_argument("residual", "Tensor", "The optional residual added to the data.")
+    .set_attr<FInferShape>("FInferShape", InferShapeFusedNorm)
+    .set_attr<FInferType>("FInferType", InferTypeFusedNorm);
+
+RELAX_REGISTER_OP("relax.nn.rms_norm")
+    .set_attrs_type<FusedNormAttrs>()
+    .set_num_inputs(3)
+    .add_argument("data", "Tensor", "Input to which rms_norm will be applied.")
+    .add_argument("weight", "Tensor", "The scale factor.")
+    .add_argument("residual", "Tensor", "The optional residual added to the data.")
+    .set_attr<FInferShape>("FInferShape", InferShapeFusedNorm)
+    .set_attr<FInferType>("FInferType", InferTypeFusedNorm);
+
+Expr MakeFusedNorm(const Op& op, Array<Expr> args, Optional<Expr> residual, Array<Integer> axis,
+                   double epsilon, DataType out_dtype) {
+  ObjectPtr<FusedNormAttrs> attrs = make_object<FusedNormAttrs>();
+  attrs->axis = std::move(axis);
+  attrs->epsilon = epsilon;
+  attrs->out_dtype = out_dtype;
+  if (residual.defined()) {
+    args.push_back(residual.value());
+  }
+  return Call(op, args, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.fused_layer_norm")
+    .set_body_typed([](Expr data, Expr gamma, Expr beta, Optional<Expr> residual,
+                       Array<Integer> axis, double epsilon, DataType out_dtype) {
+      static const Op& op = Op::Get("relax.nn.fused_layer_norm");
+      return MakeFusedNorm(op, {data, gamma, beta}, residual, axis, epsilon, out_dtype);
+    });
+
+TVM_REGISTER_GLOBAL("relax.op.nn.rms_norm")
+    .set_body_typed([](Expr data, Expr weight, Optional<Expr> residual, Array<Integer> axis,
+                       double epsilon, DataType out_dtype) {
+      static const Op& op = Op::Get("relax.nn.rms_norm");
+      return MakeFusedNorm(op, {data, weight}, residual, axis, epsilon, out_dtype);
+    });
+
+/*! \brief The number of scale and offset parameters of the fused normalization op. */
+static size_t NumFusedNormParams(const Call& call) {
+  static const Op& layer_norm_op = Op::Get("relax.nn.fused_layer_norm");
+  return call->op.same_as(layer_norm_op) ? 2 : 1;
+}
+
+Expr InferShapeFusedNorm(const Call& call, DiagnosticContext diag_ctx) {
+  size_t num_params = NumFusedNormParams(call);
+  if (call->args.size() != num_params + 1 && call->args.size() != num_params + 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " should have " << num_params + 1 << " or "
+                       << num_params + 2 << " arguments");
+  }
+  bool has_residual = call->args.size() == num_params + 2;
+  const auto* data_shape = call->args[0]->shape().as<ShapeExprNode>();
+  if (data_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+
+  const auto* attrs = call->attrs.as<FusedNormAttrs>();
+  int ndim = data_shape->values.size();
+  int n_axis = attrs->axis.size();
+  // The kernels normalize the rows of the trailing axes, so that each row is contiguous.
+  std::vector<bool> normalized(ndim, false);
+  for (const Integer& axis : attrs->axis) {
+    int dim = axis->value < 0 ? axis->value + ndim : axis->value;
+    if (dim < 0 || dim >= ndim || normalized[dim]) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << call->op << " expects distinct axis indices in range [-" << ndim
+                         << ", " << ndim << "). However, the given axes are " << attrs->axis);
+    }
+    normalized[dim] = true;
+  }
+  for (int dim = ndim - n_axis; dim < ndim; ++dim) {
+    if (!normalized[dim]) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << call->op << " expects the normalized axes to be the trailing axes of "
+                                        "the data. However, the given axes are "
+                         << attrs->axis << " while the data has rank " << ndim);
+    }
+  }
+
+  arith::Analyzer ana;
+  for (size_t i = 1; i <= num_params; ++i) {
+    const auto* param_shape = call->args[i]->shape().as<ShapeExprNode>();
+    if (param_shape == nullptr) {
+      continue;
+    }
+    if (static_cast<int>(param_shape->values.size()) != n_axis) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << call->op << " expects the scale and offset parameters to have the "
+                                        "same rank as the number of axes. However, parameter "
+                         << i << " has rank " << param_shape->values.size()
+                         << " while the number of given axes is " << n_axis);
+    }
+    for (int j = 0; j < n_axis; ++j) {
+      if (ana.CanProve(param_shape->values[j] != data_shape->values[ndim - n_axis + j])) {
+        diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                           << call->op << " expects the parameter " << i
+                           << " to have the shape of the normalized axes of the data. However, "
+                              "its dimension "
+                           << j << " has length " << param_shape->values[j]
+                           << " while the data dimension " << ndim - n_axis + j << " has length "
+                           << data_shape->values[ndim - n_axis + j]);
+      }
+    }
+  }
+  if (!has_residual) {
+    return GetRef<ShapeExpr>(data_shape);
+  }
+  const auto* residual_shape = call->args.back()->shape().as<ShapeExprNode>();
+  if (residual_shape != nullptr) {
+    bool mismatch = static_cast<int>(residual_shape->values.size()) != ndim;
+    for (int i = 0; !mismatch && i < ndim; ++i) {
+      mismatch = ana.CanProve(residual_shape->values[i] != data_shape->values[i]);
+    }
+    if (mismatch) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << call->op << " expects the residual to have the shape of the data, "
+                         << GetRef<ShapeExpr>(data_shape) << ", but gets "
+                         << GetRef<ShapeExpr>(residual_shape));
+    }
+  }
+  // The sum of the data and the residual is returned too, as the input of the next residual.
+  return Tuple({GetRef<ShapeExpr>(data_shape), GetRef<ShapeExpr>(data_shape)});
+}
+
+Type InferTypeFusedNorm(const Call& call, DiagnosticContext diag_ctx) {
+  size_t num_params = NumFusedNormParams(call);
+  if (call->args.size() != num_params + 1 && call->args.size() != num_params + 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " should have " << num_params + 1 << " or "
+                       << num_params + 2 << " arguments");
+  }
+  std::vector<const DynTensorTypeNode*> types;
+  for (const Expr& arg : call->args) {
+    types.push_back(arg->checked_type().as<DynTensorTypeNode>());
+    if (types.back() == nullptr) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << call->op << " expects its inputs to have type DynTensorType, but "
+                         << "gets " << arg->checked_type()->GetTypeKey());
+    }
+  }
+  const auto* attrs = call->attrs.as<FusedNormAttrs>();
+  const DynTensorTypeNode* data_type = types[0];
+  DataType output_dtype = attrs->out_dtype.is_void() ? data_type->dtype : attrs->out_dtype;
+  DynTensorType output_type(data_type->ndim, output_dtype);
+  if (call->args.size() == num_params + 1) {
+    return output_type;
+  }
+  const DynTensorTypeNode* residual_type = types.back();
+  if (!data_type->IsUnknownDtype() && !residual_type->IsUnknownDtype() &&
+      residual_type->dtype != data_type->dtype) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects the residual to have the data type of the data, "
+                       << data_type->dtype << ", but gets " << residual_type->dtype);
+  }
+  return TupleType({output_type, GetRef<DynTensorType>(data_type)});
+}
+
 /* relax.nn.cross_entropy */
 RELAX_REGISTER_OP("relax.nn.cross_entropy")
     .set_num_inputs(2)
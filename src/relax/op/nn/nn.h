@@ -138,6 +138,21 @@ Expr InferShapeMatmul(const Call& call, DiagnosticContext diag_ctx);
 
 Type InferTypeMatmul(const Call& call, DiagnosticContext diag_ctx);
 
+/* relax.nn.grouped_matmul */
+Expr InferShapeGroupedMatmul(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeGroupedMatmul(const Call& call, DiagnosticContext diag_ctx);
+
+/* relax.nn.attention */
+Expr InferShapeAttention(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeAttention(const Call& call, DiagnosticContext diag_ctx);
+
+/* relax.nn.fused_layer_norm and relax.nn.rms_norm */
+Expr InferShapeFusedNorm(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeFusedNorm(const Call& call, DiagnosticContext diag_ctx);
+
 /* relax.nn.cross_entropy */
 Expr InferShapeCrossEntropy(const Call& call, DiagnosticContext diag_ctx);
 
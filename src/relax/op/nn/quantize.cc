@@ -0,0 +1,282 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/op/nn/quantize.cc
+ * \brief The weight-only quantization operators.
+ *
+ * The weights of shape (n, k) are quantized by groups of group_size consecutive weights of a row,
+ * each with the scale max(|w|) / (2^(bits - 1) - 1). The quantized weights are packed 8 / bits per
+ * uint8, from the low bits, with an offset of 2^(bits - 1), so that the packed weights have shape
+ * (n, k * bits / 8) and the scales have shape (n, k / group_size).
+ */
+
+#include "quantize.h"
+
+#include <tvm/relax/op_attr_types.h>
+
+#include "../make_op.h"
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_NODE_TYPE(WeightQuantizeAttrs);
+
+/*! \brief Check the attributes, and return the number of weights per packed byte. */
+static int CheckWeightQuantizeAttrs(const Call& call, DiagnosticContext diag_ctx) {
+  const auto* attrs = call->attrs.as<WeightQuantizeAttrs>();
+  if (attrs->bits != 4 && attrs->bits != 8) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " supports 4 or 8 bits, but gets " << attrs->bits);
+  }
+  int weights_per_byte = 8 / attrs->bits;
+  if (attrs->group_size <= 0 || attrs->group_size % weights_per_byte != 0) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects a positive group size multiple of "
+                       << weights_per_byte << ", but gets " << attrs->group_size);
+  }
+  return weights_per_byte;
+}
+
+/*! \brief The shape of the rank 2 argument i, or nullptr if unknown. */
+static const ShapeExprNode* GetMatrixShape(const Call& call, int i, DiagnosticContext diag_ctx) {
+  const auto* shape = call->args[i]->shape().as<ShapeExprNode>();
+  if (shape != nullptr && shape->values.size() != 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects the argument " << i << " to have rank 2, but "
+                       << "gets rank " << shape->values.size());
+  }
+  return shape;
+}
+
+/*! \brief Check that the packed weights and the scales are of the same rows of k weights. */
+static void CheckPackedWeight(const Call& call, const ShapeExprNode* packed_shape,
+                              const ShapeExprNode* scale_shape, const PrimExpr& k,
+                              DiagnosticContext diag_ctx) {
+  const auto* attrs = call->attrs.as<WeightQuantizeAttrs>();
+  arith::Analyzer ana;
+  if (ana.CanProve(packed_shape->values[0] != scale_shape->values[0]) ||
+      ana.CanProve(scale_shape->values[1] * attrs->group_size != k)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects scales of shape (n, k / group_size) for the "
+                       << "packed weights of shape " << GetRef<ShapeExpr>(packed_shape)
+                       << " of k = " << k << ", but gets " << GetRef<ShapeExpr>(scale_shape));
+  }
+}
+
+/*! \brief Check the data types of the packed weights and of the scales. */
+static void CheckPackedWeightType(const Call& call, const DynTensorTypeNode* packed_type,
+                                  const DynTensorTypeNode* scale_type,
+                                  DiagnosticContext diag_ctx) {
+  if (packed_type == nullptr || scale_type == nullptr) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects its inputs to have type DynTensorType");
+  }
+  if (!packed_type->IsUnknownDtype() && packed_type->dtype != DataType::UInt(8)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects the packed weights to be uint8, but gets "
+                       << packed_type->dtype);
+  }
+  if (!scale_type->IsUnknownDtype() && !scale_type->dtype.is_float()) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects floating point scales, but gets "
+                       << scale_type->dtype);
+  }
+}
+
+/* relax.nn.quantize_weight */
+RELAX_REGISTER_OP("relax.nn.quantize_weight")
+    .set_attrs_type<WeightQuantizeAttrs>()
+    .set_num_inputs(1)
+    .add_argument("weight", "Tensor", "The weights, of shape (n, k).")
+    .set_attr<FInferShape>("FInferShape", InferShapeQuantizeWeight)
+    .set_attr<FInferType>("FInferType", InferTypeQuantizeWeight);
+
+Expr MakeQuantizeWeight(Expr weight, int bits, int group_size) {
+  ObjectPtr<WeightQuantizeAttrs> attrs = make_object<WeightQuantizeAttrs>();
+  attrs->bits = bits;
+  attrs->group_size = group_size;
+
+  static const Op& op = Op::Get("relax.nn.quantize_weight");
+  return Call(op, {std::move(weight)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.quantize_weight").set_body_typed(MakeQuantizeWeight);
+
+Expr InferShapeQuantizeWeight(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizeWeight operator should have 1 argument");
+  }
+  int weights_per_byte = CheckWeightQuantizeAttrs(call, diag_ctx);
+  const ShapeExprNode* weight_shape = GetMatrixShape(call, 0, diag_ctx);
+  if (weight_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  const auto* attrs = call->attrs.as<WeightQuantizeAttrs>();
+  PrimExpr n = weight_shape->values[0];
+  PrimExpr k = weight_shape->values[1];
+  arith::Analyzer ana;
+  if (ana.CanProve(floormod(k, attrs->group_size) != 0)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizeWeight expects the rows of " << k
+                       << " weights to be divisible by the group size " << attrs->group_size);
+  }
+  return Tuple({ShapeExpr({n, floordiv(k, weights_per_byte)}),
+                ShapeExpr({n, floordiv(k, attrs->group_size)})});
+}
+
+Type InferTypeQuantizeWeight(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizeWeight operator should have 1 argument");
+  }
+  const auto* weight_type = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (weight_type == nullptr ||
+      (!weight_type->IsUnknownDtype() && !weight_type->dtype.is_float())) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizeWeight expects floating point weights of type DynTensorType");
+  }
+  return TupleType({DynTensorType(2, DataType::UInt(8)), DynTensorType(2, weight_type->dtype)});
+}
+
+/* relax.nn.dequantize_weight */
+RELAX_REGISTER_OP("relax.nn.dequantize_weight")
+    .set_attrs_type<WeightQuantizeAttrs>()
+    .set_num_inputs(2)
+    .add_argument("packed", "Tensor", "The packed weights, of shape (n, k * bits / 8).")
+    .add_argument("scale", "Tensor", "The scales, of shape (n, k / group_size).")
+    .set_attr<FInferShape>("FInferShape", InferShapeDequantizeWeight)
+    .set_attr<FInferType>("FInferType", InferTypeDequantizeWeight);
+
+Expr MakeDequantizeWeight(Expr packed, Expr scale, int bits, int group_size) {
+  ObjectPtr<WeightQuantizeAttrs> attrs = make_object<WeightQuantizeAttrs>();
+  attrs->bits = bits;
+  attrs->group_size = group_size;
+
+  static const Op& op = Op::Get("relax.nn.dequantize_weight");
+  return Call(op, {std::move(packed), std::move(scale)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.dequantize_weight").set_body_typed(MakeDequantizeWeight);
+
+Expr InferShapeDequantizeWeight(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "DequantizeWeight operator should have 2 arguments");
+  }
+  int weights_per_byte = CheckWeightQuantizeAttrs(call, diag_ctx);
+  const ShapeExprNode* packed_shape = GetMatrixShape(call, 0, diag_ctx);
+  const ShapeExprNode* scale_shape = GetMatrixShape(call, 1, diag_ctx);
+  if (packed_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  PrimExpr k = packed_shape->values[1] * weights_per_byte;
+  if (scale_shape != nullptr) {
+    CheckPackedWeight(call, packed_shape, scale_shape, k, diag_ctx);
+  }
+  return ShapeExpr({packed_shape->values[0], k});
+}
+
+Type InferTypeDequantizeWeight(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "DequantizeWeight operator should have 2 arguments");
+  }
+  const auto* packed_type = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  const auto* scale_type = call->args[1]->checked_type().as<DynTensorTypeNode>();
+  CheckPackedWeightType(call, packed_type, scale_type, diag_ctx);
+  return DynTensorType(2, scale_type->dtype);
+}
+
+/* relax.nn.quantized_dense */
+RELAX_REGISTER_OP("relax.nn.quantized_dense")
+    .set_attrs_type<WeightQuantizeAttrs>()
+    .set_num_inputs(3)
+    .add_argument("data", "Tensor", "The input data, of shape (..., k).")
+    .add_argument("packed", "Tensor", "The packed weights, of shape (n, k * bits / 8).")
+    .add_argument("scale", "Tensor", "The scales, of shape (n, k / group_size).")
+    .set_attr<FInferShape>("FInferShape", InferShapeQuantizedDense)
+    .set_attr<FInferType>("FInferType", InferTypeQuantizedDense);
+
+Expr MakeQuantizedDense(Expr data, Expr packed, Expr scale, int bits, int group_size,
+                        DataType out_dtype) {
+  ObjectPtr<WeightQuantizeAttrs> attrs = make_object<WeightQuantizeAttrs>();
+  attrs->bits = bits;
+  attrs->group_size = group_size;
+  attrs->out_dtype = out_dtype;
+
+  static const Op& op = Op::Get("relax.nn.quantized_dense");
+  return Call(op, {std::move(data), std::move(packed), std::move(scale)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.quantized_dense").set_body_typed(MakeQuantizedDense);
+
+Expr InferShapeQuantizedDense(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizedDense operator should have 3 arguments");
+  }
+  int weights_per_byte = CheckWeightQuantizeAttrs(call, diag_ctx);
+  const auto* data_shape = call->args[0]->shape().as<ShapeExprNode>();
+  const ShapeExprNode* packed_shape = GetMatrixShape(call, 1, diag_ctx);
+  const ShapeExprNode* scale_shape = GetMatrixShape(call, 2, diag_ctx);
+  if (data_shape == nullptr || packed_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  if (data_shape->values.empty()) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizedDense expects the data to have rank at least 1");
+  }
+  PrimExpr k = data_shape->values.back();
+  arith::Analyzer ana;
+  if (ana.CanProve(packed_shape->values[1] * weights_per_byte != k)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizedDense expects the packed weights of shape (n, k * bits / 8) "
+                       << "for the data of k = " << k << ", but gets "
+                       << GetRef<ShapeExpr>(packed_shape));
+  }
+  if (scale_shape != nullptr) {
+    CheckPackedWeight(call, packed_shape, scale_shape, k, diag_ctx);
+  }
+  Array<PrimExpr> output_shape = data_shape->values;
+  output_shape.Set(output_shape.size() - 1, packed_shape->values[0]);
+  return ShapeExpr(output_shape);
+}
+
+Type InferTypeQuantizedDense(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizedDense operator should have 3 arguments");
+  }
+  const auto* data_type = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  const auto* packed_type = call->args[1]->checked_type().as<DynTensorTypeNode>();
+  const auto* scale_type = call->args[2]->checked_type().as<DynTensorTypeNode>();
+  if (data_type == nullptr) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "QuantizedDense expects the data to have type DynTensorType");
+  }
+  CheckPackedWeightType(call, packed_type, scale_type, diag_ctx);
+  const auto* attrs = call->attrs.as<WeightQuantizeAttrs>();
+  DataType output_dtype = attrs->out_dtype.is_void() ? data_type->dtype : attrs->out_dtype;
+  return DynTensorType(data_type->ndim, output_dtype);
+}
+
+}  // namespace relax
+}  // namespace tvm
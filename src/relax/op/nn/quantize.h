@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/op/nn/quantize.h
+ * \brief The weight-only quantization operators.
+ */
+
+#ifndef TVM_RELAX_OP_NN_QUANTIZE_H_
+#define TVM_RELAX_OP_NN_QUANTIZE_H_
+
+#include <tvm/relax/expr.h>
+#include <tvm/relax/type.h>
+
+#include "../op_common.h"
+namespace tvm {
+namespace relax {
+
+/* relax.nn.quantize_weight */
+Expr InferShapeQuantizeWeight(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeQuantizeWeight(const Call& call, DiagnosticContext diag_ctx);
+
+/* relax.nn.dequantize_weight */
+Expr InferShapeDequantizeWeight(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeDequantizeWeight(const Call& call, DiagnosticContext diag_ctx);
+
+/* relax.nn.quantized_dense */
+Expr InferShapeQuantizedDense(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeQuantizedDense(const Call& call, DiagnosticContext diag_ctx);
+
+}  // namespace relax
+}  // namespace tvm
+#endif  // TVM_RELAX_OP_NN_QUANTIZE_H_
@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/op/nn/sparse_2in4.cc
+ * \brief The 2:4 structured sparsity operators.
+ *
+ * The weights of shape (n, k) keep 2 of each group of 4 consecutive weights of a row. The kept
+ * weights are packed in their order into the values of shape (n, k / 2). Their indices in the
+ * groups take 2 bits each, in the layout of the metadata operand of the m16n8k16 mma.sp of the
+ * sparse tensor cores: the metadata of shape (n / 16, k / 16, 8) and dtype uint32 has a word
+ * for the rows i and i + 8 of each 16x16 tile of the weights, whose low and high 16 bits are the
+ * 8 indices of the rows from the low bits.
+ */
+
+#include "sparse_2in4.h"
+
+#include <tvm/relax/op_attr_types.h>
+
+#include "../make_op.h"
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The rows and the columns of the tiles of the metadata. */
+static constexpr int kSparseTileSize = 16;
+
+/*! \brief The shape of the argument i of the given rank, or nullptr if unknown. */
+static const ShapeExprNode* GetSparseArgShape(const Call& call, int i, size_t rank,
+                                              DiagnosticContext diag_ctx) {
+  const auto* shape = call->args[i]->shape().as<ShapeExprNode>();
+  if (shape != nullptr && shape->values.size() != rank) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << call->op << " expects the argument " << i << " to have rank " << rank
+                       << ", but gets rank " << shape->values.size());
+  }
+  return shape;
+}
+
+/* relax.nn.sparse_pack_2in4 */
+RELAX_REGISTER_OP("relax.nn.sparse_pack_2in4")
+    .set_num_inputs(1)
+    .add_argument("weight", "Tensor", "The weights, of shape (n, k).")
+    .set_attr<FInferShape>("FInferShape", InferShapeSparsePack2in4)
+    .set_attr<FInferType>("FInferType", InferTypeSparsePack2in4);
+
+Expr MakeSparsePack2in4(Expr weight) {
+  static const Op& op = Op::Get("relax.nn.sparse_pack_2in4");
+  return Call(op, {std::move(weight)}, Attrs(), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.sparse_pack_2in4").set_body_typed(MakeSparsePack2in4);
+
+Expr InferShapeSparsePack2in4(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparsePack2in4 operator should have 1 argument");
+  }
+  const ShapeExprNode* weight_shape = GetSparseArgShape(call, 0, 2, diag_ctx);
+  if (weight_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  PrimExpr n = weight_shape->values[0];
+  PrimExpr k = weight_shape->values[1];
+  arith::Analyzer ana;
+  if (ana.CanProve(floormod(n, kSparseTileSize) != 0) ||
+      ana.CanProve(floormod(k, kSparseTileSize) != 0)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparsePack2in4 expects weights of dims divisible by "
+                       << kSparseTileSize << ", but gets " << GetRef<ShapeExpr>(weight_shape));
+  }
+  return Tuple({ShapeExpr({n, floordiv(k, 2)}),
+                ShapeExpr({floordiv(n, kSparseTileSize), floordiv(k, kSparseTileSize), 8})});
+}
+
+Type InferTypeSparsePack2in4(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparsePack2in4 operator should have 1 argument");
+  }
+  const auto* weight_type = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (weight_type == nullptr ||
+      (!weight_type->IsUnknownDtype() && !weight_type->dtype.is_float())) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparsePack2in4 expects floating point weights of type DynTensorType");
+  }
+  return TupleType({DynTensorType(2, weight_type->dtype), DynTensorType(3, DataType::UInt(32))});
+}
+
+/* relax.nn.sparse_dense_2in4 */
+RELAX_REGISTER_OP("relax.nn.sparse_dense_2in4")
+    .set_attrs_type<DenseAttrs>()
+    .set_num_inputs(3)
+    .add_argument("data", "Tensor", "The input data, of shape (..., k).")
+    .add_argument("values", "Tensor", "The kept weights, of shape (n, k / 2).")
+    .add_argument("metadata", "Tensor", "The indices of the kept weights, of shape "
+                                        "(n / 16, k / 16, 8).")
+    .set_attr<FInferShape>("FInferShape", InferShapeSparseDense2in4)
+    .set_attr<FInferType>("FInferType", InferTypeSparseDense2in4);
+
+Expr MakeSparseDense2in4(Expr data, Expr values, Expr metadata, DataType out_dtype) {
+  ObjectPtr<DenseAttrs> attrs = make_object<DenseAttrs>();
+  attrs->out_dtype = out_dtype;
+
+  static const Op& op = Op::Get("relax.nn.sparse_dense_2in4");
+  return Call(op, {std::move(data), std::move(values), std::move(metadata)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.sparse_dense_2in4").set_body_typed(MakeSparseDense2in4);
+
+Expr InferShapeSparseDense2in4(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 operator should have 3 arguments");
+  }
+  const auto* data_shape = call->args[0]->shape().as<ShapeExprNode>();
+  const ShapeExprNode* values_shape = GetSparseArgShape(call, 1, 2, diag_ctx);
+  const ShapeExprNode* metadata_shape = GetSparseArgShape(call, 2, 3, diag_ctx);
+  if (data_shape == nullptr || values_shape == nullptr) {
+    return RuntimeDepShape();
+  }
+  if (data_shape->values.empty()) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 expects the data to have rank at least 1");
+  }
+  PrimExpr n = values_shape->values[0];
+  PrimExpr k = data_shape->values.back();
+  arith::Analyzer ana;
+  if (ana.CanProve(values_shape->values[1] * 2 != k)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 expects the values of shape (n, k / 2) for the data of "
+                       << "k = " << k << ", but gets " << GetRef<ShapeExpr>(values_shape));
+  }
+  if (metadata_shape != nullptr &&
+      (ana.CanProve(metadata_shape->values[0] * kSparseTileSize != n) ||
+       ana.CanProve(metadata_shape->values[1] * kSparseTileSize != k) ||
+       ana.CanProve(metadata_shape->values[2] != 8))) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 expects the metadata of shape (n / 16, k / 16, 8) for "
+                       << "the weights of n = " << n << " and k = " << k << ", but gets "
+                       << GetRef<ShapeExpr>(metadata_shape));
+  }
+  Array<PrimExpr> output_shape = data_shape->values;
+  output_shape.Set(output_shape.size() - 1, n);
+  return ShapeExpr(output_shape);
+}
+
+Type InferTypeSparseDense2in4(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 operator should have 3 arguments");
+  }
+  const auto* data_type = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  const auto* values_type = call->args[1]->checked_type().as<DynTensorTypeNode>();
+  const auto* metadata_type = call->args[2]->checked_type().as<DynTensorTypeNode>();
+  if (data_type == nullptr || values_type == nullptr || metadata_type == nullptr) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 expects its inputs to have type DynTensorType");
+  }
+  if (!metadata_type->IsUnknownDtype() && metadata_type->dtype != DataType::UInt(32)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "SparseDense2in4 expects the metadata to be uint32, but gets "
+                       << metadata_type->dtype);
+  }
+  const auto* attrs = call->attrs.as<DenseAttrs>();
+  DataType output_dtype = attrs->out_dtype.is_void() ? data_type->dtype : attrs->out_dtype;
+  return DynTensorType(data_type->ndim, output_dtype);
+}
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/op/nn/sparse_2in4.h
+ * \brief The 2:4 structured sparsity operators.
+ */
+
+#ifndef TVM_RELAX_OP_NN_SPARSE_2IN4_H_
+#define TVM_RELAX_OP_NN_SPARSE_2IN4_H_
+
+#include <tvm/relax/expr.h>
+#include <tvm/relax/type.h>
+
+#include "../op_common.h"
+namespace tvm {
+namespace relax {
+
+/* relax.nn.sparse_pack_2in4 */
+Expr InferShapeSparsePack2in4(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeSparsePack2in4(const Call& call, DiagnosticContext diag_ctx);
+
+/* relax.nn.sparse_dense_2in4 */
+Expr InferShapeSparseDense2in4(const Call& call, DiagnosticContext diag_ctx);
+
+Type InferTypeSparseDense2in4(const Call& call, DiagnosticContext diag_ctx);
+
+}  // namespace relax
+}  // namespace tvm
+#endif  // TVM_RELAX_OP_NN_SPARSE_2IN4_H_
@@ -23,15 +23,18 @@
 #include <tvm/relay/op.h>
 
 #include "op_common.h"
+#include "tensor/unary.h"
 
 namespace tvm {
 namespace relax {
 
 TVM_REGISTER_NODE_TYPE(AllocTensorAttrs);
 TVM_REGISTER_NODE_TYPE(MemAllocStorageAttrs);
+TVM_REGISTER_NODE_TYPE(DeviceCopyAttrs);
 TVM_REGISTER_NODE_TYPE(MemAllocTensorAttrs);
 TVM_REGISTER_NODE_TYPE(VMAllocStorageAttrs);
 TVM_REGISTER_NODE_TYPE(VMAllocTensorAttrs);
+TVM_REGISTER_NODE_TYPE(VMAllocOutputAttrs);
 TVM_REGISTER_NODE_TYPE(ShapeHeapAttrs);
 
 bool EqualConstInt(const PrimExpr& lhs, int64_t value) {
@@ -210,6 +213,24 @@ Expr MakeShapeOf(Expr expr) {
 
 TVM_REGISTER_GLOBAL("relax.op.shape_of").set_body_typed(MakeShapeOf);
 
+// device_copy
+
+RELAX_REGISTER_OP("relax.device_copy")
+    .set_attrs_type<DeviceCopyAttrs>()
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The tensor to copy.")
+    .set_attr<FInferShape>("FInferShape", InferShapeUnaryBroadcast)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryBroadcast);
+
+Expr MakeDeviceCopy(Expr data, int64_t dst_device_index) {
+  auto attrs = make_object<DeviceCopyAttrs>();
+  attrs->dst_device_index = dst_device_index;
+  static const Op& op = Op::Get("relax.device_copy");
+  return Call(op, {data}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.device_copy").set_body_typed(MakeDeviceCopy);
+
 // alloc_tensor
 
 Expr InferShapeAllocTensor(const Call& call, DiagnosticContext diag_ctx) { return call->args[0]; }
@@ -328,10 +349,12 @@ RELAX_REGISTER_OP("relax.vm.builtin.alloc_storage")
     .add_argument("size", "Expr", "The size of the storage to allocate.")
     .set_attr<FInferType>("FInferType", ReturnObjectType);
 
-Expr MakeVMAllocStorage(Expr size, DataType dtype, int64_t runtime_device_index) {
+Expr MakeVMAllocStorage(Expr size, DataType dtype, int64_t runtime_device_index,
+                        std::string storage_scope) {
   auto attrs = make_object<VMAllocStorageAttrs>();
   attrs->dtype = std::move(dtype);
   attrs->runtime_device_index = std::move(runtime_device_index);
+  attrs->storage_scope = std::move(storage_scope);
   static const Op& op = Op::Get("relax.vm.builtin.alloc_storage");
   return Call(op, {size}, Attrs(attrs), {});
 }
@@ -369,6 +392,35 @@ Expr MakeVMAllocTensor(Expr storage, Expr shape, int offset, DataType dtype) {
 
 TVM_REGISTER_GLOBAL("relax.op.vm.builtin.alloc_tensor").set_body_typed(MakeVMAllocTensor);
 
+// vm alloc_output
+
+Type InferTypeVMAllocOutput(const Call& call, DiagnosticContext diag_ctx) {
+  auto attrs = call->attrs.as<VMAllocOutputAttrs>();
+  ICHECK(attrs != nullptr) << "must be VMAllocOutputAttrs , but got " << call->attrs->GetTypeKey();
+  if (const auto* output_shape = call->args[0].as<ShapeExprNode>()) {
+    return DynTensorType(output_shape->values.size(), attrs->dtype);
+  }
+  return DynTensorType::CreateUnknownNDim(attrs->dtype, Span());
+}
+
+RELAX_REGISTER_OP("relax.vm.builtin.alloc_output")
+    .set_attrs_type<VMAllocOutputAttrs>()
+    .set_num_inputs(1)
+    .add_argument("shape", "Expr", "The shape of the tensor to allocate.")
+    .set_attr<FInferShape>("FInferShape", InferShapeAllocTensor)
+    .set_attr<FInferType>("FInferType", InferTypeVMAllocOutput);
+
+Expr MakeVMAllocOutput(Expr shape, int output_index, DataType dtype, int64_t runtime_device_index) {
+  auto attrs = make_object<VMAllocOutputAttrs>();
+  attrs->output_index = output_index;
+  attrs->dtype = std::move(dtype);
+  attrs->runtime_device_index = runtime_device_index;
+  static const Op& op = Op::Get("relax.vm.builtin.alloc_output");
+  return Call(op, {shape}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.vm.builtin.alloc_output").set_body_typed(MakeVMAllocOutput);
+
 // vm store_shape
 
 RELAX_REGISTER_OP("relax.vm.builtin.store_shape")
@@ -64,6 +64,18 @@ bool EqualCheck(const PrimExpr& lhs, const PrimExpr& rhs);
       .set_attr<FInferType>("FInferType", InferTypeBinaryBroadcast)               \
       .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutBinaryEwise)
 
+/*! \brief The legalization of an op into a TOPI function of its single tensor argument. */
+#define RELAX_LEGALIZE_UNARY_TOPI(TOPIFunc)                                      \
+  [](const Attrs& attrs, const Array<te::Tensor>& inputs) -> Array<te::Tensor> { \
+    return {TOPIFunc(inputs[0])};                                                \
+  }
+
+/*! \brief The legalization of an op into a TOPI function of its two tensor arguments. */
+#define RELAX_LEGALIZE_BINARY_TOPI(TOPIFunc)                                     \
+  [](const Attrs& attrs, const Array<te::Tensor>& inputs) -> Array<te::Tensor> { \
+    return {TOPIFunc(inputs[0], inputs[1])};                                     \
+  }
+
 #define RELAX_REGISTER_UNARY_OP(OpName)                               \
   TVM_REGISTER_GLOBAL("relax.op." OpName).set_body_typed([](Expr e) { \
     static const Op& op = Op::Get("relax." OpName);                   \
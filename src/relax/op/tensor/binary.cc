@@ -24,18 +24,23 @@
 
 #include "binary.h"
 
+#include <tvm/topi/broadcast.h>
+
 namespace tvm {
 namespace relax {
 
 RELAX_REGISTER_BINARY_BROADCAST_OP("add")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_BINARY_TOPI(topi::add))
     .describe("Elementwise add with broadcasting")
     .set_support_level(1);
 
 RELAX_REGISTER_BINARY_BROADCAST_OP("subtract")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_BINARY_TOPI(topi::subtract))
     .describe("Elementwise subtract with broadcasting")
     .set_support_level(1);
 
 RELAX_REGISTER_BINARY_BROADCAST_OP("multiply")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_BINARY_TOPI(topi::multiply))
     .describe("Elementwise multiply with broadcasting")
     .set_support_level(1);
 
@@ -117,10 +122,12 @@ Type InferTypeBinaryBroadcast(const Call& call, DiagnosticContext diag_ctx) {
 }
 
 /* relax.divide */
-RELAX_REGISTER_BINARY_BROADCAST_OP("divide");
+RELAX_REGISTER_BINARY_BROADCAST_OP("divide")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_BINARY_TOPI(topi::divide));
 
 /* relax.floor_divide */
-RELAX_REGISTER_BINARY_BROADCAST_OP("floor_divide");
+RELAX_REGISTER_BINARY_BROADCAST_OP("floor_divide")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_BINARY_TOPI(topi::floor_divide));
 
 /* relax.less */
 RELAX_REGISTER_OP("relax.less")
@@ -128,7 +135,8 @@ RELAX_REGISTER_OP("relax.less")
     .add_argument("lhs", "Tensor", "The left operand of less.")
     .add_argument("rhs", "Tensor", "The right operand of less.")
     .set_attr<FInferShape>("FInferShape", InferShapeBinaryBroadcast)
-    .set_attr<FInferType>("FInferType", InferTypeLess);
+    .set_attr<FInferType>("FInferType", InferTypeLess)
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_BINARY_TOPI(topi::less));
 
 TVM_REGISTER_GLOBAL("relax.op.less").set_body_typed([](Expr lhs, Expr rhs) {
   static const Op& op = Op::Get("relax.less");
@@ -24,6 +24,8 @@
 
 #include "reduce.h"
 
+#include <tvm/topi/reduction.h>
+
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -159,8 +161,14 @@ Type InferTypeReduction(const Call& call, DiagnosticContext diag_ctx) {
   return DynTensorType(attrs->keepdims ? ndim : ndim - n_axis, type->dtype);
 }
 
+Array<te::Tensor> LegalizeSum(const Attrs& attrs, const Array<te::Tensor>& inputs) {
+  const auto* reduce_attrs = attrs.as<ReduceAttrs>();
+  Array<Integer> axis = reduce_attrs->axis.value_or(Array<Integer>());
+  return {topi::sum(inputs[0], axis, reduce_attrs->keepdims)};
+}
+
 /* relax.sum */
-RELAX_REGISTER_REDUCTION_OP("sum");
+RELAX_REGISTER_REDUCTION_OP("sum").set_attr<FLegalize>("FLegalize", LegalizeSum);
 
 /* relax.mean */
 RELAX_REGISTER_REDUCTION_OP("mean");
@@ -24,6 +24,9 @@
 
 #include "transform.h"
 
+#include <tvm/topi/elemwise.h>
+#include <tvm/topi/transform.h>
+
 #include <unordered_set>
 
 #include "unary.h"
@@ -34,13 +37,19 @@ namespace relax {
 /* relax.transpose */
 TVM_REGISTER_NODE_TYPE(TransposeAttrs);
 
+Array<te::Tensor> LegalizeTranspose(const Attrs& attrs, const Array<te::Tensor>& inputs) {
+  Array<Integer> axes = attrs.as<TransposeAttrs>()->axes.value_or(Array<Integer>());
+  return {topi::transpose(inputs[0], axes)};
+}
+
 RELAX_REGISTER_OP("relax.transpose")
     .set_attrs_type<TransposeAttrs>()
     .set_num_inputs(1)
     .add_argument("data", "nD Tensor", "input tensor to be transposed")
     .set_attr<FInferShape>("FInferShape", InferShapeTranspose)
     .set_attr<FInferType>("FInferType", InferTypeTranspose)
-    .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutTranspose);
+    .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutTranspose)
+    .set_attr<FLegalize>("FLegalize", LegalizeTranspose);
 
 Expr MakeTranspose(Expr data, Optional<Array<Integer>> axes) {
   ObjectPtr<TransposeAttrs> attrs = make_object<TransposeAttrs>();
@@ -732,13 +741,18 @@ Type InferTypeTrilu(const Call& call, DiagnosticContext diag_ctx) {
 /* relax.cast */
 TVM_REGISTER_NODE_TYPE(CastAttrs);
 
+Array<te::Tensor> LegalizeCast(const Attrs& attrs, const Array<te::Tensor>& inputs) {
+  return {topi::cast(inputs[0], attrs.as<CastAttrs>()->dtype)};
+}
+
 RELAX_REGISTER_OP("relax.cast")
     .set_attrs_type<CastAttrs>()
     .set_num_inputs(1)
     .add_argument("data", "Tensor", "The input tensor")
     .set_attr<FInferShape>("FInferShape", InferShapeCast)
     .set_attr<FInferType>("FInferType", InferTypeCast)
-    .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutUnaryEwise);
+    .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutUnaryEwise)
+    .set_attr<FLegalize>("FLegalize", LegalizeCast);
 
 Expr MakeCast(Expr data, DataType dtype) {
   ObjectPtr<CastAttrs> attrs = make_object<CastAttrs>();
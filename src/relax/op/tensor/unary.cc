@@ -24,6 +24,8 @@
 
 #include "unary.h"
 
+#include <tvm/topi/elemwise.h>
+
 #include "../make_op.h"
 
 namespace tvm {
@@ -56,25 +58,32 @@ Type InferTypeUnaryBroadcast(const Call& call, DiagnosticContext diag_ctx) {
 }
 
 /* relax.sin */
-RELAX_REGISTER_UNARY_OP("sin");
+RELAX_REGISTER_UNARY_OP("sin")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::sin));
 
 /* relax.cos */
-RELAX_REGISTER_UNARY_OP("cos");
+RELAX_REGISTER_UNARY_OP("cos")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::cos));
 
 /* relax.sqrt */
-RELAX_REGISTER_UNARY_OP("sqrt");
+RELAX_REGISTER_UNARY_OP("sqrt")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::sqrt));
 
 /* relax.log */
-RELAX_REGISTER_UNARY_OP("log");
+RELAX_REGISTER_UNARY_OP("log")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::log));
 
 /* relax.negative */
-RELAX_REGISTER_UNARY_OP("negative");
+RELAX_REGISTER_UNARY_OP("negative")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::negative));
 
 /* relax.tanh */
-RELAX_REGISTER_UNARY_OP("tanh");
+RELAX_REGISTER_UNARY_OP("tanh")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::tanh));
 
 /* relax.sigmoid */
-RELAX_REGISTER_UNARY_OP("sigmoid");
+RELAX_REGISTER_UNARY_OP("sigmoid")
+    .set_attr<FLegalize>("FLegalize", RELAX_LEGALIZE_UNARY_TOPI(topi::sigmoid));
 
 TVM_REGISTER_NODE_TYPE(UniqueAttrs);
 
@@ -87,7 +96,7 @@ RELAX_REGISTER_OP("relax.unique")
     .set_attrs_type<UniqueAttrs>()
     .set_attr<FInferShape>("FInferShape", InferShapeUnique)
     .set_attr<FInferType>("FInferType", InferTypeUnique)
-    .set_attr<FCallPacked>("FCallPacked", "relax.run.unique");
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.unique");
 
 Expr MakeUnique(Expr data, bool sorted, bool return_inverse, bool return_counts, int dim) {
   auto attrs = make_object<UniqueAttrs>();
@@ -39,11 +39,24 @@ namespace relax {
 // -->
 // gv0 = rx.call("relax.builtin.alloc_tensor", [n, m], dtype="float32")
 // rx.call_packed(func, x, gv0)
+//
+// The outputs are allocated on the device of the first tensor argument, where a tensor is on
+// device 0 unless it is copied onto another one by relax.device_copy.
 
 class CallTIRMutator : public ExprMutator {
  public:
   using ExprMutator::VisitExpr_;
+
+  void VisitBinding_(const VarBindingNode* binding) override {
+    int64_t device_index = DeviceOf(binding->value);
+    ExprMutator::VisitBinding_(binding);
+    if (device_index != 0) {
+      var_devices_[binding->var.get()] = device_index;
+    }
+  }
+
   Expr VisitExpr_(const CallNode* call) override {
+    int64_t device_index = DeviceOf(GetRef<Call>(call));
     // post-order mutation
     Expr expr = VisitExprPostOrder_(call);
     call = expr.as<CallNode>();
@@ -63,7 +76,7 @@ class CallTIRMutator : public ExprMutator {
           if (call->checked_type_.defined()) {
             auto output_type = Downcast<DynTensorType>(call->checked_type_);
             alloc_tensor_attr->dtype = output_type->dtype;
-            alloc_tensor_attr->runtime_device_index = 0;
+            alloc_tensor_attr->runtime_device_index = device_index;
             outs.push_back(builder_->Emit(
                 Call(alloc_tensor_op, {output_shape}, Attrs(alloc_tensor_attr)), "alloc"));
           } else {
@@ -91,7 +104,7 @@ class CallTIRMutator : public ExprMutator {
             auto output_type = Downcast<DynTensorType>(output_types->fields[i]);
             auto alloc_tensor_attr = make_object<AllocTensorAttrs>();
             alloc_tensor_attr->dtype = output_type->dtype;
-            alloc_tensor_attr->runtime_device_index = 0;
+            alloc_tensor_attr->runtime_device_index = device_index;
             outs.push_back(builder_->Emit(
                 Call(alloc_tensor_op, {Downcast<ShapeExpr>(output_shapes->fields[i])},
                      Attrs(alloc_tensor_attr)),
@@ -128,6 +141,34 @@ class CallTIRMutator : public ExprMutator {
 
     return GetRef<Expr>(call);
   }
+
+ private:
+  /*! \brief The device index of the tensors an expression evaluates to, before the rewrite. */
+  int64_t DeviceOf(const Expr& expr) const {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const Op& device_copy_op = Op::Get("relax.device_copy");
+    if (const auto* var = expr.as<VarNode>()) {
+      auto it = var_devices_.find(var);
+      return it == var_devices_.end() ? 0 : it->second;
+    } else if (const auto* call = expr.as<CallNode>()) {
+      if (call->op == device_copy_op) {
+        return call->attrs.as<DeviceCopyAttrs>()->dst_device_index;
+      } else if (call->op == call_tir_op) {
+        if (const auto* args = call->args[1].as<TupleNode>()) {
+          return args->fields.empty() ? 0 : DeviceOf(args->fields[0]);
+        }
+        return DeviceOf(call->args[1]);
+      }
+    } else if (const auto* get_item = expr.as<TupleGetItemNode>()) {
+      return DeviceOf(get_item->tuple);
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      return tuple->fields.empty() ? 0 : DeviceOf(tuple->fields[0]);
+    }
+    return 0;
+  }
+
+  /*! \brief The device index of the variables not on device 0. */
+  std::unordered_map<const VarNode*, int64_t> var_devices_;
 };
 
 Expr CallTIRRewrite(const Expr& e) { return CallTIRMutator().VisitExpr(e); }
@@ -0,0 +1,391 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/checkpoint_activations.cc
+ * \brief Recompute the activations of a dataflow block near their late uses, instead of keeping
+ * them alive from the forward to the backward pass, until the block fits a memory budget.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/type.h>
+#include <tvm/tir/function.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.CheckpointActivations.memory_budget", Integer);
+
+// ==================
+// CheckpointActivations
+// Split the uses of an activation at the peak of the memory live in a dataflow block: the uses
+// before the peak keep the activation, the uses after it get a recomputed copy, emitted right
+// before the first of them.
+// Example, with the peak at lv2:
+// lv0 = call_tir(exp, (x,), (n, m))
+// lv1 = call_tir(relu, (lv0,), (n, m))
+// lv2 = call_tir(matmul, (lv1, w), (n, m))
+// lv3 = call_tir(add, (lv0, lv2), (n, m))
+// -->
+// lv0 = call_tir(exp, (x,), (n, m))
+// lv1 = call_tir(relu, (lv0,), (n, m))
+// lv2 = call_tir(matmul, (lv1, w), (n, m))
+// lv0_remat = call_tir(exp, (x,), (n, m))
+// lv3 = call_tir(add, (lv0_remat, lv2), (n, m))
+//
+// The memory of a block is estimated as the bytes of the static-shape tensors bound in the block,
+// each live from its binding to its last use, which is the liveness VMGraphMemoryPlan reuses the
+// storages by. The parameters and the tensors bound before the block are not counted.
+//
+// An activation is recomputed when
+// - it is a call_tir of a PrimFunc which is not opaque, with a static-shape tensor output,
+// - it is a DataflowVar, so that all its uses are in the block,
+// - all its inputs are live at the recompute anyway, so that their lives are not extended.
+// Among them, the pass picks the one freeing the most bytes at the peak per recompute cost, which
+// is the number of output elements weighted by the op pattern, and repeats until the peak fits
+// the budget or no activation is live across the peak.
+
+/*! \brief The static number of elements of a tensor var, or -1 if it is unknown. */
+static int64_t StaticTensorElements(const Var& var) {
+  const auto* shape = var->shape_.as<ShapeExprNode>();
+  if (!var->checked_type_.as<DynTensorTypeNode>() || shape == nullptr) return -1;
+  int64_t elements = 1;
+  for (const PrimExpr& dim : shape->values) {
+    const auto* int_dim = dim.as<IntImmNode>();
+    if (int_dim == nullptr) return -1;
+    elements *= int_dim->value;
+  }
+  return elements;
+}
+
+/*! \brief The static size in bytes of a tensor var, or 0 if it is unknown. */
+static int64_t StaticTensorBytes(const Var& var) {
+  int64_t elements = StaticTensorElements(var);
+  if (elements < 0) return 0;
+  const auto* type = var->checked_type_.as<DynTensorTypeNode>();
+  if (type->IsUnknownDtype()) return 0;
+  return elements * ((type->dtype.bits() * type->dtype.lanes() + 7) / 8);
+}
+
+/*! \brief The var a binding defines, undefined for a match_shape without var. */
+static Var BindingVar(const Binding& binding) {
+  if (const auto* var_binding = binding.as<VarBindingNode>()) return var_binding->var;
+  return Downcast<MatchShape>(binding)->var;
+}
+
+/*! \brief The cost of computing an element of the output of an op pattern kind. */
+static double PatternCost(int kind) {
+  if (kind <= relay::kInjective) return 1.0;
+  if (kind == relay::kCommReduce) return 2.0;
+  // Matmul, conv and the like, whose elements each take a reduction over an input axis.
+  return 8.0;
+}
+
+class ActivationCheckpointPlanner {
+ public:
+  /*! \brief A value of an activation, the original binding or a recomputed copy. */
+  struct Version {
+    /*! \brief The index of the binding of the activation. */
+    int binding;
+    /*! \brief The position the version is computed at. */
+    int def;
+    /*! \brief The positions of the uses served by the version, in order. */
+    std::vector<int> uses;
+    /*! \brief The last position the version is live at. */
+    int last;
+    /*! \brief The uses by recomputed copies, which stay with the version. */
+    std::vector<int> pinned;
+    /*! \brief The versions of the inputs used by a recomputed copy, by input binding. */
+    std::unordered_map<int, int> inputs;
+  };
+
+  ActivationCheckpointPlanner(const IRModule& mod, const DataflowBlock& block, int64_t budget)
+      : mod_(mod), block_(block), budget_(budget), n_(block->bindings.size()) {}
+
+  /*!
+   * \brief Plan the recomputes.
+   * \return The versions, the first one of each binding being the original.
+   */
+  std::vector<Version> Plan() {
+    Init();
+    while (n_ > 0) {
+      std::vector<int64_t> live = Liveness();
+      int peak = std::max_element(live.begin(), live.end()) - live.begin();
+      if (live[peak] <= budget_) break;
+      int best = -1;
+      size_t best_split = 0;
+      double best_score = 0.0;
+      for (size_t v = 0; v < versions_.size(); ++v) {
+        const Version& version = versions_[v];
+        if (!recomputable_[version.binding]) continue;
+        auto it = std::upper_bound(version.uses.begin(), version.uses.end(), peak);
+        // The version must be used both before and after the peak.
+        if (it == version.uses.begin() || it == version.uses.end() || *std::prev(it) == peak) {
+          continue;
+        }
+        if (!version.pinned.empty() && version.pinned.back() >= *it) continue;
+        size_t split = it - version.uses.begin();
+        if (!InputsLiveAt(version.binding, *it, nullptr)) continue;
+        double score = bytes_[version.binding] / cost_[version.binding];
+        if (best == -1 || score > best_score) {
+          best = v;
+          best_split = split;
+          best_score = score;
+        }
+      }
+      if (best == -1) {
+        LOG(WARNING) << "CheckpointActivations cannot reduce the " << live[peak]
+                     << " bytes live in a dataflow block to the budget of " << budget_ << " bytes";
+        break;
+      }
+      Split(best, best_split);
+    }
+    return versions_;
+  }
+
+ private:
+  void Init() {
+    for (int i = 0; i < n_; ++i) {
+      Var var = BindingVar(block_->bindings[i]);
+      if (var.defined()) positions_[var.get()] = i;
+    }
+    bytes_.assign(n_, 0);
+    cost_.assign(n_, 0.0);
+    recomputable_.assign(n_, false);
+    args_.assign(n_, {});
+    std::vector<std::vector<int>> uses(n_);
+    for (int i = 0; i < n_; ++i) {
+      const Binding& binding = block_->bindings[i];
+      Var var = BindingVar(binding);
+      bytes_[i] = var.defined() ? StaticTensorBytes(var) : 0;
+      Expr value = binding.as<VarBindingNode>() ? Downcast<VarBinding>(binding)->value
+                                                : Downcast<MatchShape>(binding)->value;
+      for (int arg : UsedBindings(value)) {
+        if (uses[arg].empty() || uses[arg].back() != i) uses[arg].push_back(i);
+      }
+      if (const auto* var_binding = binding.as<VarBindingNode>()) {
+        InitRecompute(i, var_binding);
+      }
+    }
+    for (int i = 0; i < n_; ++i) {
+      Var var = BindingVar(block_->bindings[i]);
+      Version version;
+      version.binding = version.def = i;
+      version.uses = uses[i];
+      version.last = uses[i].empty() ? i : uses[i].back();
+      // The outputs of the block are live until its end.
+      if (var.defined() && !var.as<DataflowVarNode>()) version.last = n_ - 1;
+      versions_.push_back(std::move(version));
+    }
+  }
+
+  /*! \brief The indices of the bindings of the block whose vars an expression uses. */
+  std::vector<int> UsedBindings(const Expr& expr) const {
+    std::vector<int> ret;
+    PostOrderVisit(expr, [&](const ObjectRef& obj) {
+      if (const auto* var = obj.as<VarNode>()) {
+        auto it = positions_.find(var);
+        if (it != positions_.end()) ret.push_back(it->second);
+      }
+    });
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+  }
+
+  void InitRecompute(int i, const VarBindingNode* binding) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    if (!binding->var.as<DataflowVarNode>() || bytes_[i] == 0) return;
+    const auto* call = binding->value.as<CallNode>();
+    if (call == nullptr || call->op != call_tir_op) return;
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    if (gv == nullptr || !mod_->ContainGlobalVar(gv->name_hint)) return;
+    const auto* prim_func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>();
+    if (prim_func == nullptr) return;
+    tir::PrimFunc func = GetRef<tir::PrimFunc>(prim_func);
+    Optional<Integer> pattern = func->GetAttr<Integer>("op_pattern");
+    int kind = pattern.defined() ? pattern.value()->value : AnalyzeOpPatternKind(func);
+    if (kind >= relay::kTuple) return;
+    cost_[i] = PatternCost(kind) * std::max<int64_t>(StaticTensorElements(binding->var), 1);
+    args_[i] = UsedBindings(call->args[1]);
+    recomputable_[i] = true;
+  }
+
+  /*!
+   * \brief Whether the inputs of a binding are all live at a position, recording the versions
+   * live there.
+   */
+  bool InputsLiveAt(int binding, int pos, std::unordered_map<int, int>* inputs) const {
+    for (int arg : args_[binding]) {
+      int found = -1;
+      for (size_t v = 0; v < versions_.size(); ++v) {
+        const Version& version = versions_[v];
+        if (version.binding == arg && version.def <= pos && pos <= version.last) {
+          found = v;
+          break;
+        }
+      }
+      if (found == -1) return false;
+      if (inputs != nullptr) (*inputs)[arg] = found;
+    }
+    return true;
+  }
+
+  /*! \brief Recompute a version for its uses from a split on. */
+  void Split(int v, size_t split) {
+    Version copy;
+    copy.binding = versions_[v].binding;
+    copy.uses.assign(versions_[v].uses.begin() + split, versions_[v].uses.end());
+    copy.def = copy.uses.front();
+    copy.last = copy.uses.back();
+    InputsLiveAt(copy.binding, copy.def, &copy.inputs);
+    // The inputs are used at the copy, and must not be recomputed after it.
+    for (const auto& kv : copy.inputs) {
+      Version& input = versions_[kv.second];
+      auto pos = std::lower_bound(input.uses.begin(), input.uses.end(), copy.def);
+      if (pos == input.uses.end() || *pos != copy.def) input.uses.insert(pos, copy.def);
+      input.pinned.push_back(copy.def);
+      std::sort(input.pinned.begin(), input.pinned.end());
+    }
+    versions_[v].uses.resize(split);
+    versions_[v].last = versions_[v].uses.back();
+    // The versions are emitted in order, so the inputs of the copy come before it.
+    versions_.push_back(std::move(copy));
+  }
+
+  /*! \brief The bytes live at each position of the block. */
+  std::vector<int64_t> Liveness() const {
+    std::vector<int64_t> delta(n_ + 1, 0);
+    for (const Version& version : versions_) {
+      delta[version.def] += bytes_[version.binding];
+      delta[version.last + 1] -= bytes_[version.binding];
+    }
+    std::vector<int64_t> live(n_, 0);
+    int64_t sum = 0;
+    for (int i = 0; i < n_; ++i) {
+      sum += delta[i];
+      live[i] = sum;
+    }
+    return live;
+  }
+
+  IRModule mod_;
+  DataflowBlock block_;
+  int64_t budget_;
+  int n_;
+  std::unordered_map<const VarNode*, int> positions_;
+  std::vector<int64_t> bytes_;
+  std::vector<double> cost_;
+  std::vector<bool> recomputable_;
+  std::vector<std::vector<int>> args_;
+  std::vector<Version> versions_;
+};
+
+class ActivationCheckpointMutator : public ExprMutator {
+ public:
+  ActivationCheckpointMutator(const IRModule& mod, int64_t budget) : mod_(mod), budget_(budget) {}
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    using Version = ActivationCheckpointPlanner::Version;
+    DataflowBlock df_block = GetRef<DataflowBlock>(block);
+    std::vector<Version> versions = ActivationCheckpointPlanner(mod_, df_block, budget_).Plan();
+    int n = block->bindings.size();
+    if (static_cast<int>(versions.size()) == n) {
+      return ExprMutator::VisitBindingBlock_(block);
+    }
+
+    // The version serving each use, and the copies to emit before each binding.
+    std::vector<std::unordered_map<int, int>> served(n);
+    std::vector<std::vector<int>> recomputes(n);
+    for (size_t v = 0; v < versions.size(); ++v) {
+      for (int use : versions[v].uses) served[use][versions[v].binding] = v;
+      if (static_cast<int>(v) >= n && !versions[v].uses.empty()) {
+        recomputes[versions[v].def].push_back(v);
+      }
+    }
+    std::vector<Var> emitted(versions.size());
+    auto remap = [&](const std::unordered_map<int, int>& inputs) {
+      for (const auto& kv : inputs) {
+        var_remap_[BindingVar(block->bindings[kv.first])->vid] = emitted[kv.second];
+      }
+    };
+
+    builder_->BeginDataflowBlock();
+    for (int i = 0; i < n; ++i) {
+      for (int v : recomputes[i]) {
+        const Version& version = versions[v];
+        const auto* binding = block->bindings[version.binding].as<VarBindingNode>();
+        remap(version.inputs);
+        const Var& var = binding->var;
+        emitted[v] = builder_->Emit(VisitExpr(binding->value), var->name_hint() + "_remat");
+      }
+      remap(served[i]);
+      VisitBinding(block->bindings[i]);
+      Var var = BindingVar(block->bindings[i]);
+      if (!var.defined()) continue;
+      auto it = var_remap_.find(var->vid);
+      emitted[i] = it != var_remap_.end() ? it->second : var;
+    }
+    // The uses after the block refer to the original outputs, which are never recomputed.
+    for (int i = 0; i < n; ++i) {
+      if (emitted[i].defined()) var_remap_[BindingVar(block->bindings[i])->vid] = emitted[i];
+    }
+    return builder_->EndBlock();
+  }
+
+ private:
+  IRModule mod_;
+  int64_t budget_;
+};
+
+Function CheckpointActivations(const Function& func, const IRModule& mod, int64_t budget) {
+  if (budget < 0) {
+    return func;
+  }
+  return Downcast<Function>(ActivationCheckpointMutator(mod, budget).VisitExpr(func));
+}
+
+namespace transform {
+
+Pass CheckpointActivations(int64_t memory_budget) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        int64_t budget = memory_budget;
+        if (budget < 0) {
+          budget = pc->GetConfig<Integer>("relax.CheckpointActivations.memory_budget", Integer(-1))
+                       .value()
+                       ->value;
+        }
+        return relax::CheckpointActivations(f, m, budget);
+      };
+  return CreateFunctionPass(pass_func, 0, "CheckpointActivations", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.CheckpointActivations")
+    .set_body_typed(CheckpointActivations);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
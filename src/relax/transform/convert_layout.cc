@@ -21,11 +21,20 @@
  * \brief Automatic layout conversion pass, especially for axis swapping.
  */
 
+#include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "../op/make_op.h"
 #include "infer_layout_utils.h"
 
@@ -34,10 +43,229 @@ namespace relax {
 
 using tir::Layout;
 
+/*!
+ * \brief Plan the layout of the layout-agnostic ops globally, so that the total size of the tensors
+ * transposed is the smallest.
+ * \details Converting each op greedily to the layout of its inputs can transpose a tensor back and
+ * forth at a boundary, e.g. when an elementwise op between a converted conv2d and an op which
+ * cannot be converted takes another input in the initial layout. Instead, each op is assigned
+ * either the converted or the initial layout:
+ *  - the ops with desired layouts are converted,
+ *  - the params, the constants, the ops which cannot be converted and the other uses of the vars
+ *  (e.g. the function output) are in the initial layout,
+ *  - the other ops with a layout inference are free.
+ * A tensor is transposed once when any of its users is assigned a layout other than its producer,
+ * at the cost of its size. The assignment of the smallest total cost is a minimum cut of the
+ * dataflow graph, with each tensor modeled as a hyperedge.
+ * \note The planner only decides which free ops keep the initial layout. The converted layout
+ * of the others is still inferred op by op from their inputs.
+ */
+class LayoutAssignmentPlanner {
+ public:
+  /*!
+   * \brief Plan the layout assignment of a function.
+   * \return The binding vars of the free ops to keep in the initial layout.
+   */
+  static std::unordered_set<const VarNode*> Plan(
+      const Function& func, const Map<String, Array<String>>& desired_layouts) {
+    LayoutAssignmentPlanner planner;
+    planner.Build(func, desired_layouts);
+    std::vector<bool> converted = planner.MinCut();
+    std::unordered_set<const VarNode*> ret;
+    for (const auto& kv : planner.free_nodes_) {
+      if (!converted[kv.second]) ret.insert(kv.first);
+    }
+    return ret;
+  }
+
+ private:
+  static constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max() / 4;
+  /*! \brief The node of the converted layout. */
+  static constexpr int kSource = 0;
+  /*! \brief The node of the initial layout. */
+  static constexpr int kSink = 1;
+
+  struct Edge {
+    int to;
+    int64_t capacity;
+    size_t reverse;
+  };
+
+  int AddNode() {
+    graph_.emplace_back();
+    return static_cast<int>(graph_.size()) - 1;
+  }
+
+  void AddEdge(int from, int to, int64_t capacity) {
+    graph_[from].push_back({to, capacity, graph_[to].size()});
+    graph_[to].push_back({from, 0, graph_[from].size() - 1});
+  }
+
+  /*! \brief The size of a tensor, i.e. the cost to transpose it. */
+  static int64_t TensorSize(const Expr& expr) {
+    int64_t size = 1;
+    if (const auto* shape = expr->shape().as<ShapeExprNode>()) {
+      for (const PrimExpr& dim : shape->values) {
+        // The symbolic dims count as one.
+        if (const auto* int_dim = dim.as<IntImmNode>()) {
+          size *= std::max<int64_t>(int_dim->value, 1);
+        }
+      }
+    }
+    return size;
+  }
+
+  /*! \brief Get the node of a tensor producer, or -1 if the producer is not planned. */
+  int GetProducer(const Expr& expr) {
+    if (expr->IsInstance<ConstantNode>()) {
+      // The constants are transposed at each use, and are in the initial layout.
+      int node = AddNode();
+      AddEdge(node, kSink, kInfinity);
+      producers_.push_back({node, TensorSize(expr), {}});
+      return static_cast<int>(producers_.size()) - 1;
+    }
+    auto it = var2producer_.find(expr.get());
+    return it != var2producer_.end() ? it->second : -1;
+  }
+
+  void AddProducer(const Var& var, int node) {
+    var2producer_[var.get()] = static_cast<int>(producers_.size());
+    producers_.push_back({node, TensorSize(var), {}});
+  }
+
+  /*! \brief Record the uses of the vars in an expression by a node. */
+  void AddUses(const Expr& expr, int user) {
+    for (const Var& var : FreeVars(expr)) {
+      int producer = GetProducer(var);
+      if (producer >= 0) producers_[producer].users.push_back(user);
+    }
+  }
+
+  void Build(const Function& func, const Map<String, Array<String>>& desired_layouts) {
+    static const auto infer_layout_map = Op::GetAttrMap<FRelaxInferLayout>("FRelaxInferLayout");
+    AddNode();
+    AddNode();
+    for (const Var& param : func->params) {
+      if (param->checked_type()->IsInstance<DynTensorTypeNode>()) AddProducer(param, kSink);
+    }
+    const auto* seq = func->body.as<SeqExprNode>();
+    if (seq == nullptr) return;
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        const auto* var_binding = binding.as<VarBindingNode>();
+        if (var_binding == nullptr) {
+          AddUses(Downcast<MatchShape>(binding)->value, kSink);
+          continue;
+        }
+        const auto* call = var_binding->value.as<CallNode>();
+        const auto* op = call != nullptr ? call->op.as<OpNode>() : nullptr;
+        if (op == nullptr) {
+          AddUses(var_binding->value, kSink);
+          continue;
+        }
+        bool is_tensor = var_binding->var->checked_type()->IsInstance<DynTensorTypeNode>();
+        bool leaf_args = std::all_of(call->args.begin(), call->args.end(), [](const Expr& arg) {
+          return arg->IsInstance<VarNode>() || arg->IsInstance<ConstantNode>();
+        });
+        int node = -1;
+        if (!infer_layout_map.count(GetRef<Op>(op))) {
+          node = kSink;
+        } else if (desired_layouts.count(op->name)) {
+          node = kSource;
+        } else if (is_tensor && leaf_args) {
+          node = AddNode();
+          free_nodes_[var_binding->var.get()] = node;
+        }
+        if (node < 0) {
+          // The ops of tuples are converted greedily, and not planned.
+          continue;
+        }
+        for (const Expr& arg : call->args) {
+          int producer = GetProducer(arg);
+          if (producer >= 0) {
+            producers_[producer].users.push_back(node);
+          } else if (!arg->IsInstance<VarNode>()) {
+            AddUses(arg, kSink);
+          }
+        }
+        if (is_tensor) AddProducer(var_binding->var, node);
+      }
+    }
+    AddUses(seq->body, kSink);
+
+    // Each tensor is transposed once if any of its users is in the other layout than its producer.
+    for (const Producer& producer : producers_) {
+      if (producer.users.empty()) continue;
+      int to_initial = AddNode();
+      AddEdge(producer.node, to_initial, producer.cost);
+      int to_converted = AddNode();
+      AddEdge(to_converted, producer.node, producer.cost);
+      for (int user : producer.users) {
+        AddEdge(to_initial, user, kInfinity);
+        AddEdge(user, to_converted, kInfinity);
+      }
+    }
+  }
+
+  /*!
+   * \brief Compute the minimum cut between the converted and the initial layouts.
+   * \return Whether each node is on the side of the converted layout.
+   */
+  std::vector<bool> MinCut() {
+    std::vector<bool> reachable;
+    while (true) {
+      // Find the shortest augmenting path.
+      std::vector<std::pair<int, size_t>> parent(graph_.size(), {-1, 0});
+      reachable.assign(graph_.size(), false);
+      reachable[kSource] = true;
+      std::queue<int> queue;
+      queue.push(kSource);
+      while (!queue.empty() && !reachable[kSink]) {
+        int u = queue.front();
+        queue.pop();
+        for (size_t i = 0; i < graph_[u].size(); ++i) {
+          const Edge& e = graph_[u][i];
+          if (e.capacity > 0 && !reachable[e.to]) {
+            reachable[e.to] = true;
+            parent[e.to] = {u, i};
+            queue.push(e.to);
+          }
+        }
+      }
+      if (!reachable[kSink]) break;
+      int64_t flow = kInfinity;
+      for (int v = kSink; v != kSource; v = parent[v].first) {
+        flow = std::min(flow, graph_[parent[v].first][parent[v].second].capacity);
+      }
+      // The infinite capacities are never cut, since the fixed layouts are always separable.
+      ICHECK_LT(flow, kInfinity);
+      for (int v = kSink; v != kSource; v = parent[v].first) {
+        Edge& e = graph_[parent[v].first][parent[v].second];
+        e.capacity -= flow;
+        graph_[e.to][e.reverse].capacity += flow;
+      }
+    }
+    return reachable;
+  }
+
+  /*! \brief A tensor, with the node producing it and the nodes using it. */
+  struct Producer {
+    int node;
+    int64_t cost;
+    std::vector<int> users;
+  };
+
+  std::vector<std::vector<Edge>> graph_;
+  std::vector<Producer> producers_;
+  std::unordered_map<const Object*, int> var2producer_;
+  std::unordered_map<const VarNode*, int> free_nodes_;
+};
+
 class LayoutConvertMutator : public ExprMutator {
  public:
-  explicit LayoutConvertMutator(Map<String, Array<String>> desired_layouts)
-      : desired_layouts_(desired_layouts) {
+  explicit LayoutConvertMutator(Map<String, Array<String>> desired_layouts,
+                                std::unordered_set<const VarNode*> keep_initial = {})
+      : desired_layouts_(desired_layouts), keep_initial_(std::move(keep_initial)) {
     ObjectPtr<VarLayoutMapWrapperNode> var_layout_map = make_object<VarLayoutMapWrapperNode>();
     var_layout_map_ = VarLayoutMapWrapper(var_layout_map);
   }
@@ -187,7 +415,7 @@ class LayoutConvertMutator : public ExprMutator {
       if (op_node != nullptr) {
         Op op = Downcast<Op>(GetRef<Op>(op_node));
         const auto infer_layout_map = Op::GetAttrMap<FRelaxInferLayout>("FRelaxInferLayout");
-        if (infer_layout_map.count(op)) {
+        if (infer_layout_map.count(op) && !keep_initial_.count(binding->var.get())) {
           // Infer the layout convertion from the input layouts and the desired layouts.
           FRelaxInferLayout f = infer_layout_map[op];
           InferLayoutOutput res = f(GetRef<Call>(call_node), desired_layouts_, var_layout_map_);
@@ -232,20 +460,27 @@ class LayoutConvertMutator : public ExprMutator {
 
   VarLayoutMapWrapper var_layout_map_;
   Map<String, Array<String>> desired_layouts_;
+  /*! \brief The ops which keep the initial layout, as planned globally. */
+  std::unordered_set<const VarNode*> keep_initial_;
 };
 
-Expr ConvertLayout(const Function& f, Map<String, Array<String>> desired_layouts) {
-  LayoutConvertMutator mutator(desired_layouts);
+Expr ConvertLayout(const Function& f, Map<String, Array<String>> desired_layouts,
+                   bool global_assignment) {
+  std::unordered_set<const VarNode*> keep_initial;
+  if (global_assignment) {
+    keep_initial = LayoutAssignmentPlanner::Plan(f, desired_layouts);
+  }
+  LayoutConvertMutator mutator(desired_layouts, std::move(keep_initial));
   mutator.InitVarMap(f);
   return mutator.VisitExpr(f);
 }
 
 namespace transform {
 
-Pass ConvertLayoutPass(Map<String, Array<String>> desired_layouts) {
+Pass ConvertLayoutPass(Map<String, Array<String>> desired_layouts, bool global_assignment) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ConvertLayout(f, desired_layouts));
+        return Downcast<Function>(ConvertLayout(f, desired_layouts, global_assignment));
       };
   return CreateFunctionPass(pass_func, 0, "ConvertLayout", {});
 }
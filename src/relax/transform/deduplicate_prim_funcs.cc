@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/deduplicate_prim_funcs.cc
+ * \brief Merge the structurally equal TIR PrimFuncs of an IRModule into one.
+ */
+
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Merge the PrimFuncs which are structurally equal regardless of their global symbol, such
+ * as the ones fused from the identical layers of a model, so that each of them is tuned, built and
+ * linked once.
+ * \note Among the equal PrimFuncs, the one of the smallest name is kept as the canonical one, so
+ * that the result does not depend on the order of the functions in the module. The calls to the
+ * others are redirected to it.
+ */
+class PrimFuncDeduplicator : public ExprMutator {
+ public:
+  static IRModule Deduplicate(const IRModule& mod) {
+    std::vector<std::pair<GlobalVar, tir::PrimFunc>> prim_funcs;
+    for (const auto& kv : mod->functions) {
+      if (const auto* prim_func = kv.second.as<tir::PrimFuncNode>()) {
+        prim_funcs.emplace_back(kv.first, GetRef<tir::PrimFunc>(prim_func));
+      }
+    }
+    std::sort(prim_funcs.begin(), prim_funcs.end(), [](const auto& a, const auto& b) {
+      return a.first->name_hint < b.first->name_hint;
+    });
+
+    PrimFuncDeduplicator deduplicator;
+    std::unordered_map<tir::PrimFunc, GlobalVar, StructuralHash, StructuralEqual> canonical_gvs;
+    for (const auto& kv : prim_funcs) {
+      // The global symbol is the name of the function, which is not to be compared.
+      tir::PrimFunc key = WithoutAttr(kv.second, tvm::attr::kGlobalSymbol);
+      auto it = canonical_gvs.emplace(std::move(key), kv.first).first;
+      if (!it->second.same_as(kv.first)) {
+        deduplicator.gv_remap_.emplace(kv.first.get(), it->second);
+      }
+    }
+    if (deduplicator.gv_remap_.empty()) {
+      return mod;
+    }
+
+    IRModule ret = mod;
+    ret.CopyOnWrite();
+    for (const auto& kv : deduplicator.gv_remap_) {
+      ret->Remove(GetRef<GlobalVar>(kv.first));
+    }
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        ret->Update(kv.first, Downcast<Function>(deduplicator.VisitExpr(GetRef<Function>(func))));
+      }
+    }
+    return ret;
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const GlobalVarNode* op) final {
+    auto it = gv_remap_.find(op);
+    return it != gv_remap_.end() ? it->second : GetRef<Expr>(op);
+  }
+
+  /*! \brief The map from each duplicate PrimFunc to its canonical one. */
+  std::unordered_map<const GlobalVarNode*, GlobalVar> gv_remap_;
+};
+
+namespace transform {
+
+Pass DeduplicatePrimFuncs() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return PrimFuncDeduplicator::Deduplicate(mod); };
+  return CreateModulePass(pass_func, 0, "DeduplicatePrimFuncs", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.DeduplicatePrimFuncs").set_body_typed(DeduplicatePrimFuncs);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
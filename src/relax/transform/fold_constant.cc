@@ -23,17 +23,231 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/type.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FoldConstant.device_target", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FoldConstant.device_min_bytes", Integer);
+
+/*!
+ * \brief The compiled folding kernels, by their target and the structure of their PrimFuncs. The
+ * cache is shared by all the functions a FoldConstant pass is applied to.
+ */
+class FoldingKernelCache {
+ public:
+  /*!
+   * \brief Look up the kernel of a PrimFunc.
+   * \return Whether the PrimFunc has been built, with the kernel set to nullopt if it could not.
+   */
+  bool Get(const Target& target, const tir::PrimFunc& func, Optional<PackedFunc>* kernel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const KernelMap& kernels = kernels_[target->str()];
+    auto it = kernels.find(func);
+    if (it == kernels.end()) return false;
+    *kernel = it->second;
+    return true;
+  }
+
+  void Set(const Target& target, const tir::PrimFunc& func, Optional<PackedFunc> kernel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    kernels_[target->str()][func] = std::move(kernel);
+  }
+
+ private:
+  using KernelMap =
+      std::unordered_map<tir::PrimFunc, Optional<PackedFunc>, StructuralHash, StructuralEqual>;
+  std::mutex mutex_;
+  std::unordered_map<std::string, KernelMap> kernels_;
+};
+
+/*! \brief Run f(0), ..., f(n - 1) on a thread pool, or inline if there is only one. */
+void ParallelFor(int n, const std::function<void(int)>& f) {
+  if (n > 1) {
+    support::parallel_for(0, n, f);
+  } else if (n == 1) {
+    f(0);
+  }
+}
+
 class ConstantFolder : public ExprMutator {
  public:
-  explicit ConstantFolder(IRModule ctx_module) : ctx_module_(ctx_module) {}
+  ConstantFolder(IRModule ctx_module, std::shared_ptr<FoldingKernelCache> cache,
+                 Optional<Target> device_target, int64_t device_min_bytes)
+      : ctx_module_(ctx_module),
+        cache_(std::move(cache)),
+        device_target_(std::move(device_target)),
+        device_min_bytes_(device_min_bytes) {}
+
+  /*!
+   * \brief Fold the constant calls of a function. The calls which are foldable ahead of the
+   * mutation, i.e. the `call_tir`s whose arguments are constants or the results of such calls, are
+   * compiled and evaluated in parallel first, level by level of their dependencies.
+   */
+  Function Fold(const Function& func) {
+    FoldingPlanner planner(this);
+    planner(func);
+    EvaluateTasks(&planner.tasks);
+    return Downcast<Function>(VisitExpr(func));
+  }
 
  private:
+  /*! \brief A `call_tir` to be folded ahead of the mutation. */
+  struct FoldTask {
+    /*! \brief The call. */
+    const CallNode* call;
+    /*! \brief The called PrimFunc. */
+    tir::PrimFunc func;
+    /*! \brief The constant arguments, undefined for those produced by other tasks. */
+    std::vector<runtime::NDArray> args;
+    /*! \brief The tasks producing each argument, -1 for the constants. */
+    std::vector<int> producers;
+    /*! \brief The output shape and dtype. */
+    runtime::ShapeTuple shape;
+    DataType dtype;
+    /*! \brief The depth of the task in its dependencies. */
+    int level{0};
+    /*! \brief Whether the call is evaluated on the device target. */
+    bool on_device{false};
+    /*! \brief The output, undefined if the evaluation failed. */
+    runtime::NDArray result;
+  };
+
+  /*! \brief Collect the calls which are foldable ahead of the mutation. */
+  class FoldingPlanner : public ExprVisitor {
+   public:
+    explicit FoldingPlanner(ConstantFolder* folder) : folder_(folder) {}
+
+    void VisitBinding_(const VarBindingNode* binding) final {
+      ExprVisitor::VisitBinding_(binding);
+      static const Op& call_tir_op = Op::Get("relax.call_tir");
+      if (const auto* constant = binding->value.as<ConstantNode>()) {
+        var2const_[binding->var.get()] = constant->data;
+        return;
+      }
+      const auto* call = binding->value.as<CallNode>();
+      if (call == nullptr || !call->op.same_as(call_tir_op) || call->args.size() < 3 ||
+          call->type_args.size() != 1) {
+        return;
+      }
+      Optional<tir::PrimFunc> func = folder_->MatchPrimFunc(call->args[0]);
+      Optional<runtime::ShapeTuple> shape = MatchConstShape(call->args[2]);
+      const auto* args = call->args[1].as<TupleNode>();
+      const auto* ret_type = call->checked_type_.as<DynTensorTypeNode>();
+      if (!func || !shape || args == nullptr || ret_type == nullptr) return;
+
+      FoldTask task;
+      for (const Expr& arg : args->fields) {
+        if (const auto* constant = arg.as<ConstantNode>()) {
+          task.args.push_back(constant->data);
+          task.producers.push_back(-1);
+        } else if (var2const_.count(arg.get())) {
+          task.args.push_back(var2const_.at(arg.get()));
+          task.producers.push_back(-1);
+        } else if (var2task_.count(arg.get())) {
+          int producer = var2task_.at(arg.get());
+          task.args.push_back(runtime::NDArray());
+          task.producers.push_back(producer);
+          task.level = std::max(task.level, tasks[producer].level + 1);
+        } else {
+          return;
+        }
+      }
+      task.call = call;
+      task.func = func.value();
+      task.shape = shape.value();
+      task.dtype = ret_type->dtype;
+      var2task_[binding->var.get()] = tasks.size();
+      tasks.push_back(std::move(task));
+    }
+
+    std::vector<FoldTask> tasks;
+
+   private:
+    ConstantFolder* folder_;
+    std::unordered_map<const Object*, runtime::NDArray> var2const_;
+    std::unordered_map<const Object*, int> var2task_;
+  };
+
+  /*! \brief Compile the kernels of the tasks, and evaluate them level by level. */
+  void EvaluateTasks(std::vector<FoldTask>* tasks) {
+    if (tasks->empty()) return;
+    // Evaluate the large outputs on the device target if there is one.
+    for (FoldTask& task : *tasks) {
+      int64_t bytes = task.dtype.bytes() * task.dtype.lanes();
+      for (int64_t dim : task.shape) bytes *= dim;
+      task.on_device = device_target_.defined() && bytes >= device_min_bytes_;
+    }
+    BuildKernels(*tasks);
+    // Fall back to the CPU if a kernel cannot be built for the device target.
+    bool fall_back = false;
+    for (FoldTask& task : *tasks) {
+      if (task.on_device && !GetCachedBuild(task.func, device_target_.value()).defined()) {
+        task.on_device = false;
+        fall_back = true;
+      }
+    }
+    if (fall_back) BuildKernels(*tasks);
+
+    std::vector<std::vector<int>> levels;
+    for (size_t i = 0; i < tasks->size(); ++i) {
+      int level = (*tasks)[i].level;
+      if (static_cast<int>(levels.size()) <= level) levels.resize(level + 1);
+      levels[level].push_back(i);
+    }
+    for (const std::vector<int>& level : levels) {
+      ParallelFor(level.size(), [&](int i) {
+        FoldTask& task = (*tasks)[level[i]];
+        for (size_t j = 0; j < task.args.size(); ++j) {
+          if (task.producers[j] != -1) {
+            task.args[j] = (*tasks)[task.producers[j]].result;
+            if (!task.args[j].defined()) return;
+          }
+        }
+        Target target = task.on_device ? device_target_.value() : Target("llvm");
+        Optional<PackedFunc> kernel = GetCachedBuild(task.func, target);
+        if (!kernel) return;
+        Device dev{static_cast<DLDeviceType>(target->GetTargetDeviceType()), 0};
+        task.result = Evaluate(kernel.value(), task.args, task.shape, task.dtype, dev);
+      });
+    }
+    for (const FoldTask& task : *tasks) {
+      if (task.result.defined()) {
+        folded_.emplace(task.call, Constant(task.result));
+      }
+    }
+  }
+
+  /*! \brief Compile the kernels of the tasks which are not cached yet, in parallel. */
+  void BuildKernels(const std::vector<FoldTask>& tasks) {
+    std::vector<std::pair<Target, tir::PrimFunc>> to_build;
+    FoldingKernelCache pending;
+    for (const FoldTask& task : tasks) {
+      Target target = task.on_device ? device_target_.value() : Target("llvm");
+      Optional<PackedFunc> kernel;
+      if (cache_->Get(target, task.func, &kernel) || pending.Get(target, task.func, &kernel)) {
+        continue;
+      }
+      pending.Set(target, task.func, NullOpt);
+      to_build.emplace_back(target, task.func);
+    }
+    // The workers see the pass context of the caller, which configures the build.
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    ParallelFor(to_build.size(), [&](int i) {
+      With<transform::PassContext> scope(pass_ctx);
+      GetCachedBuild(to_build[i].second, to_build[i].first);
+    });
+  }
   /*!
    * \brief Pattern match expr to a constant shape and get runtime shape tuple from it.
    * \return The runtime shape tuple, or nullopt if it is not a constant shape.
@@ -82,18 +296,17 @@ class ConstantFolder : public ExprMutator {
 
   /*!
    * \brief Get a cached build version of func
+   * \param func The PrimFunc to be built
+   * \param target The target to build for
    * \return The cached func, nullopt if func cannot be built.
    */
-  Optional<PackedFunc> GetCachedBuild(tir::PrimFunc func) {
+  Optional<PackedFunc> GetCachedBuild(tir::PrimFunc func, Target target = Target("llvm")) {
     // TODO(tvm-team): consider another way of bulk extract and build PrimFunc once
     // would be helpful for future cases where PrimFunc recursively call into each other
-    Target eval_cpu_target{"llvm"};
-
-    auto it = func_build_cache_.find(func);
-    if (it != func_build_cache_.end()) {
-      return it->second;
-    }
     Optional<PackedFunc> build_func = NullOpt;
+    if (cache_->Get(target, func, &build_func)) {
+      return build_func;
+    }
 
     try {
       // Not all the primfunc can be directly built via llvm, for example, if a function is
@@ -101,37 +314,38 @@ class ConstantFolder : public ExprMutator {
       // now
       // TODO(Hongyi): further check and narrow the scope of foldable function
       runtime::Module rt_module =
-          build(LowerPrimFunc(func, "tir_function"), eval_cpu_target, eval_cpu_target);
+          build(LowerPrimFunc(func, "tir_function"), target, Target("llvm"));
       build_func = rt_module.GetFunction("tir_function");
     } catch (const tvm::Error& err) {
       // build failure may happen in which case we skip
       DLOG(WARNING) << "Build failure for function " << func << ", Error message: " << err.what();
     }
-    func_build_cache_[func] = build_func;
+    cache_->Set(target, func, build_func);
     return build_func;
   }
 
-  // Try constant evaluate the function call
-  // if failed return NullOpt
-  Optional<Expr> ConstEvaluateCallTIR(tir::PrimFunc tir_func, Array<runtime::NDArray> arr_args,
-                                      runtime::ShapeTuple shape, DataType ret_type) {
-    // obtain function from the cache.
-    Optional<PackedFunc> func = GetCachedBuild(tir_func);
-    if (!func) return NullOpt;
-
+  /*!
+   * \brief Run a kernel on a device, copying the arguments to and the output from the device
+   * \return The output on the CPU
+   */
+  static runtime::NDArray Evaluate(const PackedFunc& func,
+                                   const std::vector<runtime::NDArray>& args,
+                                   runtime::ShapeTuple shape, DataType ret_type, Device dev) {
     // here the vector size has an additional + 1 because we need to put ret_tensor at the end
-    std::vector<TVMValue> values(arr_args.size() + 1);
-    std::vector<int> type_codes(arr_args.size() + 1);
+    std::vector<TVMValue> values(args.size() + 1);
+    std::vector<int> type_codes(args.size() + 1);
 
-    DLDevice cpu_dev = {DLDeviceType::kDLCPU, 0};
-    runtime::NDArray ret_tensor = runtime::NDArray::Empty(shape, ret_type, cpu_dev);
+    runtime::NDArray ret_tensor = runtime::NDArray::Empty(shape, ret_type, dev);
 
     // avoid set rvalue ref which get de-allocated later, store args in a vector
     // where temp_args[i] are lvalue ref that is stable
-    std::vector<runtime::NDArray> temp_args(arr_args.begin(), arr_args.end());
+    std::vector<runtime::NDArray> temp_args;
+    for (const runtime::NDArray& arg : args) {
+      temp_args.push_back(arg->device.device_type == dev.device_type ? arg : arg.CopyTo(dev));
+    }
 
     size_t arg_offset = 0;
-    for (; arg_offset < arr_args.size(); ++arg_offset) {
+    for (; arg_offset < args.size(); ++arg_offset) {
       runtime::TVMArgsSetter(values.data(), type_codes.data())(arg_offset, temp_args[arg_offset]);
     }
     // set return value
@@ -139,8 +353,23 @@ class ConstantFolder : public ExprMutator {
 
     TVMRetValue ret;
     // invoke
-    func.value().CallPacked(TVMArgs(values.data(), type_codes.data(), values.size()), &ret);
-    return Constant(ret_tensor);
+    func.CallPacked(TVMArgs(values.data(), type_codes.data(), values.size()), &ret);
+    if (dev.device_type == kDLCPU) {
+      return ret_tensor;
+    }
+    return ret_tensor.CopyTo(Device{kDLCPU, 0});
+  }
+
+  // Try constant evaluate the function call
+  // if failed return NullOpt
+  Optional<Expr> ConstEvaluateCallTIR(tir::PrimFunc tir_func, Array<runtime::NDArray> arr_args,
+                                      runtime::ShapeTuple shape, DataType ret_type) {
+    // obtain function from the cache.
+    Optional<PackedFunc> func = GetCachedBuild(tir_func);
+    if (!func) return NullOpt;
+
+    std::vector<runtime::NDArray> args(arr_args.begin(), arr_args.end());
+    return Constant(Evaluate(func.value(), args, shape, ret_type, Device{kDLCPU, 0}));
   }
 
   Expr VisitCallTIR(Call call) {
@@ -166,6 +395,11 @@ class ConstantFolder : public ExprMutator {
   using ExprMutator::VisitExpr_;
 
   Expr VisitExpr_(const CallNode* call) final {
+    // The call has been folded ahead.
+    auto it = folded_.find(call);
+    if (it != folded_.end()) {
+      return it->second;
+    }
     // post-order mutation
     Call post_call = Downcast<Call>(VisitExprPostOrder_(call));
     static const Op& call_tir_op = Op::Get("relax.call_tir");
@@ -197,17 +431,33 @@ class ConstantFolder : public ExprMutator {
   // the context module to lookup functions
   IRModule ctx_module_;
   // cache for function build, via structural equality
-  std::unordered_map<tir::PrimFunc, Optional<runtime::PackedFunc>, StructuralHash, StructuralEqual>
-      func_build_cache_;
+  std::shared_ptr<FoldingKernelCache> cache_;
+  // the target to evaluate the large outputs on, if any
+  Optional<Target> device_target_;
+  // the minimum bytes of an output evaluated on the device target
+  int64_t device_min_bytes_;
+  // the calls folded ahead of the mutation
+  std::unordered_map<const CallNode*, Constant> folded_;
 };
 
 namespace transform {
 
 Pass FoldConstant() {
+  auto cache = std::make_shared<FoldingKernelCache>();
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        ConstantFolder folder(m);
-        return Downcast<Function>(folder(f));
+        Optional<String> device_target =
+            pc->GetConfig<String>("relax.FoldConstant.device_target", Optional<String>());
+        int64_t device_min_bytes =
+            pc->GetConfig<Integer>("relax.FoldConstant.device_min_bytes", Integer(1 << 20))
+                .value()
+                ->value;
+        Optional<Target> target;
+        if (device_target.defined()) {
+          target = Target(device_target.value());
+        }
+        ConstantFolder folder(m, cache, target, device_min_bytes);
+        return folder.Fold(f);
       };
   return CreateFunctionPass(pass_func, 0, "FoldConstant", {});
 }
@@ -29,8 +29,13 @@
 
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/function.h>
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "../../relay/analysis/graph_partitioner.h"
 #include "../../support/arena.h"
 
@@ -89,18 +94,20 @@ TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.max_depth", Integer);
 class GraphCreator : public ExprVisitor {
  public:
   /*!
-   * \brief Create a IndexedForwardGraph according to the input module. The graph will be used for
-   * graph partition and operator fusion.
+   * \brief Create a IndexedForwardGraph according to a dataflow block of the input module. The graph
+   * will be used for graph partition and operator fusion.
    * \param mod The module which the creation accords to
+   * \param block The dataflow block whose bindings are the nodes of the graph
    * \param arena The allocator of all the internal node objects
    * \return The created IndexedForwardGraph
+   * \note The blocks are never fused with each other, since the variables defined outside a block
+   * are external references to it. Hence a graph is created for each block on its own, which allows
+   * the blocks to be partitioned in parallel.
    */
-  static IndexedForwardGraph Create(IRModule mod, support::Arena* arena) {
-    // Since cross-function call is not supported yet, FuseOps only serves the entry function, whose
-    // name is "main".
-    auto relax_func = Downcast<Function>(mod->Lookup("main"));
+  static IndexedForwardGraph Create(IRModule mod, const DataflowBlock& block,
+                                    support::Arena* arena) {
     GraphCreator creator(mod, arena);
-    creator(relax_func);
+    creator.VisitBindingBlock_(block.get());
 
     // The algorithm of the graph creator ensures that each created node will be added to the
     // post-dfs order and will be set its op pattern. Thus we check whether all these containers
@@ -116,25 +123,6 @@ class GraphCreator : public ExprVisitor {
   explicit GraphCreator(IRModule mod, support::Arena* arena)
       : mod_(std::move(mod)), arena_(arena) {}
 
-  void VisitExpr_(const FunctionNode* func) final {
-    for (const Var& param : func->params) {
-      IndexedForwardGraph::Node* param_node = CreateNode(param.get());
-      // The parameter is passed in from the outside, and thus it's marked as an external reference,
-      // and it's pattern is `kOpaque`.
-      MarkAsExternRef(param_node);
-      SetNodePattern(param_node, OpPatternKind::kOpaque);
-      AddToPostDFSOrder(param_node, param.get());
-    }
-    ExprVisitor::VisitExpr_(func);
-  }
-
-  void VisitBindingBlock(const BindingBlock& block) final {
-    if (const auto* df_block = block.as<DataflowBlockNode>()) {
-      VisitBindingBlock_(df_block);
-    }
-    // We skip ordinary binding blocks since they might be impure (with side effect or control flow)
-  }
-
   // TODO(tvm-team): how to deal with MatchShape binding here
 
   void VisitBinding_(const VarBindingNode* binding) final {
@@ -240,6 +228,14 @@ class GraphCreator : public ExprVisitor {
       // Since we never fuse constants, the pattern of the constant is set to `kOpaque`.
       SetNodePattern(leaf_node, OpPatternKind::kOpaque);
       AddToPostDFSOrder(leaf_node, leaf_expr.get());
+    } else if (leaf_expr->IsInstance<VarNode>()) {
+      leaf_node = CreateNode(leaf_expr.get());
+      // The variable is defined outside the block (e.g. a function parameter or an output of a
+      // previous block), and thus it's marked as an external reference, and its pattern is
+      // `kOpaque`.
+      MarkAsExternRef(leaf_node);
+      SetNodePattern(leaf_node, OpPatternKind::kOpaque);
+      AddToPostDFSOrder(leaf_node, leaf_expr.get());
     } else {
       LOG(FATAL) << "The leaf Expr is supposed to be defined before, but got: " << leaf_expr
                  << " used before definition.";
@@ -343,6 +339,35 @@ class GraphCreator : public ExprVisitor {
   std::unordered_set<IndexedForwardGraph::Node*> initialized_nodes_;
 };
 
+/*!
+ * \brief Collect the dataflow blocks to be fused, i.e. the dataflow blocks at the top level of the
+ * Relax functions without attr kPrimitive.
+ */
+class DataflowBlockCollector : public ExprVisitor {
+ public:
+  static std::vector<DataflowBlock> Collect(const IRModule& mod) {
+    DataflowBlockCollector collector;
+    for (const auto& kv : mod->functions) {
+      const BaseFunc& func = kv.second;
+      if (func->IsInstance<relax::FunctionNode>() && !func->HasNonzeroAttr(attr::kPrimitive)) {
+        collector(Downcast<Function>(func));
+      }
+    }
+    return collector.blocks_;
+  }
+
+ private:
+  void VisitBindingBlock(const BindingBlock& block) final {
+    if (const auto* df_block = block.as<DataflowBlockNode>()) {
+      blocks_.push_back(GetRef<DataflowBlock>(df_block));
+    }
+    // We skip ordinary binding blocks since they might be impure (with side effect or control flow)
+  }
+
+  /*! \brief The collected dataflow blocks */
+  std::vector<DataflowBlock> blocks_;
+};
+
 /*!
  * \brief The ExprMutator used to create a new grouped function
  * \details The workflow of this ExprMutator is:
@@ -533,25 +558,19 @@ class FunctionCreator : public ExprMutator {
  */
 class OperatorFusor : public ExprMutator {
  public:
+  using Obj2Group = std::unordered_map<const Object*, GraphPartitioner::Group*>;
+
   /*!
-   * \brief Construct a new operator fusor. Given the indexed-forward graph and the graph partition
-   * result on that graph, the constructor creates a mapping from each leaf AST object
-   * (e.g. parameters, variables, constants) to the group of the node corresponding to the object
-   * in the graph.
+   * \brief Construct a new operator fusor. Given the graph partition result on the indexed-forward
+   * graph of each dataflow block, which maps each leaf AST object (e.g. parameters, variables,
+   * constants) to the group of the node corresponding to the object in the graph, the fusor groups
+   * the bindings of the block accordingly.
    * \param mod The IRModule to be transformed
-   * \param graph The indexed-forward graph of the input IRModule
-   * \param groups The grouped result of the group partition on the input indexed-forward graph.
+   * \param block2groups The mapping from each leaf AST object to its group, for each block
    */
-  explicit OperatorFusor(IRModule mod, const IndexedForwardGraph& graph,
-                         const std::vector<GraphPartitioner::Group*>& groups)
-      : ExprMutator(mod), mod_(std::move(mod)) {
-    for (int nid = 0; nid < static_cast<int>(graph.post_dfs_order.size()); ++nid) {
-      GraphPartitioner::Group* group_root = groups[nid]->FindRoot();
-      ICHECK(group_root != nullptr);
-      ICHECK(graph.post_dfs_order[nid]->ref != nullptr);
-      obj2group_[graph.post_dfs_order[nid]->ref] = group_root;
-    }
-  }
+  explicit OperatorFusor(IRModule mod,
+                         std::unordered_map<const DataflowBlockNode*, Obj2Group> block2groups)
+      : ExprMutator(mod), mod_(std::move(mod)), block2groups_(std::move(block2groups)) {}
 
   /*!
    * \brief The main transformation on the IRModule
@@ -580,6 +599,9 @@ class OperatorFusor : public ExprMutator {
   }
 
   BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    auto it_groups = block2groups_.find(block);
+    ICHECK(it_groups != block2groups_.end()) << "The dataflow block is expected to be partitioned";
+    obj2group_ = &it_groups->second;
     group2func_.clear();
 
     // Step 1. Collect the bindings for each grouped function.
@@ -723,8 +745,8 @@ class OperatorFusor : public ExprMutator {
    * \return The pointer to the group which the input var is in
    */
   GraphPartitioner::Group* GetGroupFromVar(const Var& var) {
-    const auto& it_group = obj2group_.find(var.get());
-    ICHECK(it_group != obj2group_.end());
+    const auto& it_group = obj2group_->find(var.get());
+    ICHECK(it_group != obj2group_->end());
     GraphPartitioner::Group* group = it_group->second;
     ICHECK(group->FindRoot() == group);
     return group;
@@ -750,37 +772,101 @@ class OperatorFusor : public ExprMutator {
   IRModule mod_;
   /*! \brief Internal arena. */
   support::Arena arena_;
-  /*! \brief The group assignment map. */
-  std::unordered_map<const Object*, GraphPartitioner::Group*> obj2group_;
+  /*! \brief The group assignment map of each dataflow block. */
+  std::unordered_map<const DataflowBlockNode*, Obj2Group> block2groups_;
+  /*! \brief The group assignment map of the dataflow block being visited. */
+  const Obj2Group* obj2group_ = nullptr;
   /*! \brief Internal function information map. */
   std::unordered_map<GraphPartitioner::Group*, FunctionCreator> group2func_;
 };
 
-IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth) {
-  support::Arena arena;
+/*!
+ * \brief Wrap the fusion policy into the callback of the graph partitioner, which passes the
+ * bindings of the candidate group to the policy.
+ * \param block The dataflow block being partitioned
+ * \param fusion_policy The policy deciding whether to commit a fusion, or NullOpt to commit all
+ * \return The callback of the graph partitioner
+ */
+GraphPartitioner::FCommit MakeFusionCallback(const DataflowBlock& block,
+                                             const Optional<runtime::PackedFunc>& fusion_policy) {
+  if (!fusion_policy.defined()) {
+    return nullptr;
+  }
+  std::unordered_map<const Object*, Binding> var2binding;
+  for (const Binding& binding : block->bindings) {
+    if (const auto* var_binding = binding.as<VarBindingNode>()) {
+      var2binding.emplace(var_binding->var.get(), binding);
+    }
+  }
+  runtime::PackedFunc policy = fusion_policy.value();
+  return [var2binding = std::move(var2binding),
+          policy](const std::vector<const Object*>& refs) -> bool {
+    // Only the bindings are passed, skipping the variables defined outside the block and the
+    // constants.
+    Array<Binding> bindings;
+    for (const Object* ref : refs) {
+      auto it = var2binding.find(ref);
+      if (it != var2binding.end()) {
+        bindings.push_back(it->second);
+      }
+    }
+    return policy(bindings);
+  };
+}
 
-  // Step 1. Create the indexed-forward graph according to the input IRModule.
-  IndexedForwardGraph graph = GraphCreator::Create(mod, &arena);
+IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth,
+                 Optional<runtime::PackedFunc> fusion_policy) {
+  // Step 1. Collect the dataflow blocks, which are partitioned independently of each other.
+  std::vector<DataflowBlock> blocks = DataflowBlockCollector::Collect(mod);
+  // The groups live in the arenas until the fusion is done.
+  std::vector<std::unique_ptr<support::Arena>> arenas(blocks.size());
+  std::vector<OperatorFusor::Obj2Group> obj2groups(blocks.size());
+
+  auto f_partition = [&](int i) {
+    arenas[i] = std::make_unique<support::Arena>();
+    // Step 2. Create the indexed-forward graph according to the dataflow block.
+    IndexedForwardGraph graph = GraphCreator::Create(mod, blocks[i], arenas[i].get());
+
+    // Step 3. Partition the graph by applying the fusion algorithm.
+    GraphPartitioner partitioner(arenas[i].get(), opt_level, max_fuse_depth,
+                                 MakeFusionCallback(blocks[i], fusion_policy));
+    std::vector<GraphPartitioner::Group*> groups = partitioner.Partition(graph);
+    for (int nid = 0; nid < static_cast<int>(graph.post_dfs_order.size()); ++nid) {
+      GraphPartitioner::Group* group_root = groups[nid]->FindRoot();
+      ICHECK(group_root != nullptr);
+      ICHECK(graph.post_dfs_order[nid]->ref != nullptr);
+      obj2groups[i][graph.post_dfs_order[nid]->ref] = group_root;
+    }
+  };
+  // The fusion policy may be a Python function, so that the blocks are partitioned one by one.
+  if (blocks.size() > 1 && !fusion_policy.defined()) {
+    support::parallel_for(0, blocks.size(), f_partition);
+  } else {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+      f_partition(i);
+    }
+  }
 
-  // Step 2. Partition the graph by applying the fusion algorithm.
-  std::vector<GraphPartitioner::Group*> groups =
-      GraphPartitioner(&arena, opt_level, max_fuse_depth).Partition(graph);
+  std::unordered_map<const DataflowBlockNode*, OperatorFusor::Obj2Group> block2groups;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    block2groups.emplace(blocks[i].get(), std::move(obj2groups[i]));
+  }
 
-  // Step 3. Transform the IRModule by fusing the operators in accordance with the graph partition
+  // Step 4. Transform the IRModule by fusing the operators in accordance with the graph partition
   // results.
-  mod = OperatorFusor(mod, graph, groups).Transform();
+  mod = OperatorFusor(mod, std::move(block2groups)).Transform();
 
   return mod;
 }
 
 namespace transform {
 
-Pass FuseOps(int fuse_opt_level) {
+Pass FuseOps(int fuse_opt_level, Optional<runtime::PackedFunc> fusion_policy) {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
       [=](IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relax.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue());
+        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue(), fusion_policy);
       };
   return CreateModulePass(/*pass_function=*/pass_func,  //
                           /*opt_level=*/0,              //
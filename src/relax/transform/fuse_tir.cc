@@ -18,6 +18,7 @@
  */
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/stmt_functor.h>
 
 #include "../../relay/analysis/graph_partitioner.h"
@@ -603,13 +604,39 @@ class TIRFuseMutator : public ExprMutator {
     // Since TIRFuseMutator will delete bunch of PrimFunc, we create an empty block builder.
     TIRFuseMutator mutator(mod);
     // Step 1. Fuse all primitive relax functions, store the result in `fused_tir_funcs_`
+    // Step 1.1. Group the structurally equal primitive functions (e.g. those of the identical
+    // layers of a model), so that each of them is fused only once.
+    std::vector<GlobalVar> unique_gvs;
+    std::vector<std::vector<GlobalVar>> duplicates;
+    std::unordered_map<BaseFunc, size_t, StructuralHash, StructuralEqual> func2index;
     for (const auto& kv : mod->functions) {
       const GlobalVar& gv = kv.first;
       const BaseFunc& func = kv.second;
       // Only fuse primitive relax functions
       if (func->IsInstance<relax::FunctionNode>() && func->HasNonzeroAttr(attr::kPrimitive)) {
-        tir::PrimFunc fused_tir = FusedTIRConstructor::GetFusedTIR(mod, gv);
-        mutator.fused_tir_funcs_.Set(gv, fused_tir);
+        auto it = func2index.emplace(func, unique_gvs.size()).first;
+        if (it->second == unique_gvs.size()) {
+          unique_gvs.push_back(gv);
+          duplicates.emplace_back();
+        }
+        duplicates[it->second].push_back(gv);
+      }
+    }
+    // Step 1.2. Construct the fused PrimFuncs in parallel, as they are independent.
+    std::vector<tir::PrimFunc> fused_tirs(unique_gvs.size());
+    auto f_fuse = [&](int i) {
+      fused_tirs[i] = FusedTIRConstructor::GetFusedTIR(mod, unique_gvs[i]);
+    };
+    if (unique_gvs.size() > 1) {
+      support::parallel_for(0, unique_gvs.size(), f_fuse);
+    } else if (unique_gvs.size() == 1) {
+      f_fuse(0);
+    }
+    // Step 1.3. Let the duplicates share the fused PrimFunc, which is then added to the new
+    // IRModule once since the block builder deduplicates the functions.
+    for (size_t i = 0; i < unique_gvs.size(); ++i) {
+      for (const GlobalVar& gv : duplicates[i]) {
+        mutator.fused_tir_funcs_.Set(gv, fused_tirs[i]);
       }
     }
 
@@ -0,0 +1,231 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/inplace_elementwise.cc
+ * \brief Let the elementwise kernels write their output to a dying input.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/memory.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+// ==================
+// InplaceElementwise
+// Reuse an input tensor as the output of an elementwise kernel when the input dies at the kernel.
+// Example:
+// alloc = relax.builtin.alloc_tensor((n, m), dtype="float32")
+// _ = relu(x, alloc)
+// lv0 = alloc
+// -->
+// _ = relu(x, x)
+// lv0 = x
+//
+// An input is reused when
+// - it is allocated by the function, rather than a parameter, a constant or a function output,
+// - it has the shape and dtype of the output,
+// - none of its aliases is used after the kernel.
+
+/*! \brief The bindings of a function in evaluation order, with their values. */
+class BindingCollector : public ExprVisitor {
+ public:
+  void VisitBinding_(const VarBindingNode* binding) final {
+    ExprVisitor::VisitBinding_(binding);
+    // Record after the value, so that the bindings nested in it come first.
+    positions[binding->var.get()] = bindings.size();
+    values[binding->var.get()] = binding->value;
+    bindings.push_back(binding);
+  }
+
+  std::vector<const VarBindingNode*> bindings;
+  std::unordered_map<const VarNode*, size_t> positions;
+  std::unordered_map<const VarNode*, Expr> values;
+};
+
+class InplaceElementwisePlanner {
+ public:
+  InplaceElementwisePlanner(const IRModule& mod, const Function& func) : mod_(mod) {
+    collector_.VisitExpr(func);
+    std::tie(users_, outputs_) = FunctionUseDef(func);
+    for (const Var& out : outputs_) {
+      output_set_.insert(out.get());
+    }
+    for (const VarBindingNode* binding : collector_.bindings) {
+      const VarNode* root = Root(binding->var.get());
+      aliases_[root].push_back(binding->var.get());
+    }
+  }
+
+  /*! \brief Plan the reuses, mapping each output allocation replaced to the input reused. */
+  std::unordered_map<const VarNode*, Var> Plan() {
+    std::unordered_map<const VarNode*, Var> ret;
+    for (size_t pos = 0; pos < collector_.bindings.size(); ++pos) {
+      const VarBindingNode* binding = collector_.bindings[pos];
+      const auto* call = binding->value.as<CallNode>();
+      if (call == nullptr || call->args.empty() || !IsElementwiseKernel(call->op)) continue;
+      const auto* out = call->args.back().as<VarNode>();
+      if (out == nullptr || GetAllocTensor(out) == nullptr) continue;
+      // Multiple outputs are not supported.
+      bool single_output = true;
+      for (size_t i = 0; i + 1 < call->args.size(); ++i) {
+        const auto* arg = call->args[i].as<VarNode>();
+        if (arg != nullptr && GetAllocTensor(arg) != nullptr) single_output = false;
+      }
+      if (!single_output) continue;
+
+      for (size_t i = 0; i + 1 < call->args.size(); ++i) {
+        const auto* arg = call->args[i].as<VarNode>();
+        if (arg == nullptr) continue;
+        const VarNode* root = Root(arg);
+        if (!SameAllocation(root, out) || !DiesAt(root, pos)) continue;
+        ret[out] = GetRef<Var>(arg);
+        // The output now lives on in the storage of the input.
+        for (const VarNode* alias : aliases_[out]) {
+          roots_[alias] = root;
+          aliases_[root].push_back(alias);
+        }
+        aliases_.erase(out);
+        break;
+      }
+    }
+    return ret;
+  }
+
+ private:
+  bool IsElementwiseKernel(const Expr& op) const {
+    const auto* gv = op.as<GlobalVarNode>();
+    if (gv == nullptr || !mod_->ContainGlobalVar(gv->name_hint)) return false;
+    const auto* prim_func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>();
+    if (prim_func == nullptr) return false;
+    tir::PrimFunc func = GetRef<tir::PrimFunc>(prim_func);
+    Optional<Integer> pattern = func->GetAttr<Integer>("op_pattern");
+    int kind = pattern.defined() ? pattern.value()->value : AnalyzeOpPatternKind(func);
+    return kind == relay::kElemWise;
+  }
+
+  /*! \brief The alloc_tensor a var is bound to, or nullptr. */
+  const CallNode* GetAllocTensor(const VarNode* var) const {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    auto it = collector_.values.find(var);
+    if (it == collector_.values.end()) return nullptr;
+    const auto* call = it->second.as<CallNode>();
+    return call != nullptr && call->op == alloc_tensor_op ? call : nullptr;
+  }
+
+  /*! \brief The var a var is an alias of through var bindings, itself if none. */
+  const VarNode* Root(const VarNode* var) {
+    auto it = roots_.find(var);
+    if (it != roots_.end()) return it->second;
+    const VarNode* root = var;
+    auto value = collector_.values.find(var);
+    if (value != collector_.values.end()) {
+      if (const auto* alias = value->second.as<VarNode>()) {
+        root = Root(alias);
+      }
+    }
+    roots_[var] = root;
+    return root;
+  }
+
+  bool SameAllocation(const VarNode* input, const VarNode* output) const {
+    const CallNode* input_alloc = GetAllocTensor(input);
+    const CallNode* output_alloc = GetAllocTensor(output);
+    if (input_alloc == nullptr || output_alloc == nullptr) return false;
+    const auto* input_attrs = input_alloc->attrs.as<AllocTensorAttrs>();
+    const auto* output_attrs = output_alloc->attrs.as<AllocTensorAttrs>();
+    return input_attrs->dtype == output_attrs->dtype &&
+           input_attrs->runtime_device_index == output_attrs->runtime_device_index &&
+           StructuralEqual()(input_alloc->args[0], output_alloc->args[0]);
+  }
+
+  /*! \brief Whether no alias of a root var is used after a binding, or returned. */
+  bool DiesAt(const VarNode* root, size_t pos) const {
+    auto it = aliases_.find(root);
+    if (it == aliases_.end()) return false;
+    std::unordered_set<const VarNode*> aliases(it->second.begin(), it->second.end());
+    for (const VarNode* alias : aliases) {
+      if (output_set_.count(alias)) return false;
+      for (const Var& user : users_.Get(GetRef<Var>(alias)).value_or({})) {
+        if (aliases.count(user.get())) continue;
+        auto user_pos = collector_.positions.find(user.get());
+        if (user_pos == collector_.positions.end() || user_pos->second > pos) return false;
+      }
+    }
+    return true;
+  }
+
+  IRModule mod_;
+  BindingCollector collector_;
+  Map<Var, Array<Var>> users_;
+  Array<Var> outputs_;
+  std::unordered_set<const VarNode*> output_set_;
+  std::unordered_map<const VarNode*, const VarNode*> roots_;
+  std::unordered_map<const VarNode*, std::vector<const VarNode*>> aliases_;
+};
+
+class InplaceElementwiseMutator : public ExprMutator {
+ public:
+  explicit InplaceElementwiseMutator(std::unordered_map<const VarNode*, Var> reuses)
+      : reuses_(std::move(reuses)) {}
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    auto it = reuses_.find(binding->var.get());
+    if (it != reuses_.end()) {
+      // Drop the allocation and let its uses refer to the reused input.
+      var_remap_[binding->var->vid] = it->second;
+      return;
+    }
+    ExprMutator::VisitBinding_(binding);
+  }
+
+ private:
+  std::unordered_map<const VarNode*, Var> reuses_;
+};
+
+Function InplaceElementwise(const Function& func, const IRModule& mod) {
+  std::unordered_map<const VarNode*, Var> reuses = InplaceElementwisePlanner(mod, func).Plan();
+  if (reuses.empty()) {
+    return func;
+  }
+  return Downcast<Function>(InplaceElementwiseMutator(std::move(reuses)).VisitExpr(func));
+}
+
+namespace transform {
+
+Pass InplaceElementwise() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) { return relax::InplaceElementwise(f, m); };
+  return CreateFunctionPass(pass_func, 0, "InplaceElementwise", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.InplaceElementwise").set_body_typed(InplaceElementwise);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
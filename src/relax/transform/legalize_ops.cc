@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/legalize_ops.cc
+ * \brief Legalize the operators with a C++ FLegalize into call_tir of the PrimFuncs of their TE.
+ */
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/type.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../te/operation/create_primfunc.h"
+#include "../ir/emit_te.h"
+
+namespace tvm {
+namespace relax {
+
+// ==================
+// LegalizeOps
+// Lower the calls of the operators with FLegalize into call_tir, as the Python legalizer does with
+// call_te in its map, leaving the other calls to it.
+// Example:
+// lv0 = relax.add(x, y)
+// -->
+// lv0 = relax.call_tir(add, (x, y), (n, m), dtype="float32")
+//
+// The legalization of a call depends only on its operator, attributes and the shapes and dtypes of
+// its arguments, so that the calls agreeing on them share one PrimFunc, built once.
+
+/*! \brief The PrimFunc legalizing the calls of a signature and how they call it. */
+struct LegalizedCall {
+  /*! \brief The PrimFunc, undefined if the FLegalize leaves the calls unlegalized. */
+  Optional<GlobalVar> gvar;
+  /*! \brief The output shape of the call_tir. */
+  Expr output_shape;
+  /*! \brief The output type of the call_tir. */
+  Type output_type;
+  /*! \brief The symbolic vars passed to the PrimFunc, if any. */
+  Optional<Expr> tir_vars;
+};
+
+class OpLegalizer : public ExprMutator {
+ public:
+  explicit OpLegalizer(IRModule mod) : ExprMutator(mod), mod_(std::move(mod)) {}
+
+  IRModule Transform() {
+    for (const auto& kv : mod_->functions) {
+      if (kv.second->IsInstance<FunctionNode>()) {
+        Function func = Downcast<Function>(VisitExpr(kv.second));
+        builder_->UpdateFunction(kv.first, func);
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const auto& flegalize_map = Op::GetAttrMap<FLegalize>("FLegalize");
+    Call call = Downcast<Call>(VisitExprPostOrder_(op));
+    const auto* op_node = call->op.as<OpNode>();
+    if (op_node == nullptr || !flegalize_map.count(GetRef<Op>(op_node))) {
+      return std::move(call);
+    }
+    // The tensor args of known shapes and dtypes are given to the TE as placeholders.
+    Array<te::Tensor> inputs;
+    for (const Expr& arg : call->args) {
+      if (!IsKnownTensor(arg)) {
+        return std::move(call);
+      }
+      inputs.push_back(TETensor(arg, "rxplaceholder"));
+    }
+    Array<ObjectRef> key = {call->op, call->attrs};
+    for (const te::Tensor& input : inputs) {
+      key.push_back(input->shape);
+      key.push_back(PrimType(input->dtype));
+    }
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+      Op op_ref = GetRef<Op>(op_node);
+      it = cache_.emplace(key, Legalize(op_ref, flegalize_map[op_ref], call->attrs, inputs)).first;
+    }
+    const LegalizedCall& legalized = it->second;
+    if (!legalized.gvar.defined()) {
+      return std::move(call);
+    }
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    Array<Expr> call_tir_args = {legalized.gvar.value(), Tuple(call->args),
+                                 legalized.output_shape};
+    if (legalized.tir_vars.defined()) {
+      call_tir_args.push_back(legalized.tir_vars.value());
+    }
+    return Call(call_tir_op, call_tir_args, {}, {legalized.output_type});
+  }
+
+ private:
+  static bool IsKnownTensor(const Expr& expr) {
+    if (expr->IsInstance<ConstantNode>()) {
+      return true;
+    }
+    const auto* type = expr->checked_type_.as<DynTensorTypeNode>();
+    return type != nullptr && !type->IsUnknownDtype() && expr->shape_.defined() &&
+           expr->shape_.value()->IsInstance<ShapeExprNode>();
+  }
+
+  LegalizedCall Legalize(const Op& op, const FLegalize& flegalize, const Attrs& attrs,
+                         const Array<te::Tensor>& inputs) {
+    LegalizedCall legalized;
+    Array<te::Tensor> outputs = flegalize(attrs, inputs);
+    if (outputs.empty()) {
+      return legalized;
+    }
+    Array<te::Tensor> tensors = inputs;
+    tensors.insert(tensors.end(), outputs.begin(), outputs.end());
+
+    // The vars of the shapes which are not a dim themselves are passed to the PrimFunc.
+    Array<tir::Var> used_vars;
+    std::unordered_set<const tir::VarNode*> seen_vars;
+    std::unordered_set<const tir::VarNode*> dim_vars;
+    for (const te::Tensor& tensor : tensors) {
+      for (const PrimExpr& dim : tensor->shape) {
+        if (const auto* var = dim.as<tir::VarNode>()) {
+          dim_vars.insert(var);
+        }
+        tir::PostOrderVisit(dim, [&](const ObjectRef& node) {
+          if (const auto* var = node.as<tir::VarNode>()) {
+            if (seen_vars.insert(var).second) {
+              used_vars.push_back(GetRef<tir::Var>(var));
+            }
+          }
+        });
+      }
+    }
+    Array<tir::Var> unbound_vars;
+    for (const tir::Var& var : used_vars) {
+      if (!dim_vars.count(var.get())) {
+        unbound_vars.push_back(var);
+      }
+    }
+
+    tir::PrimFunc func = tir::CreatePrimFunc(tensors, unbound_vars, DataType::Int(64));
+    func = WithoutAttr(std::move(func), tvm::attr::kGlobalSymbol);
+    std::string name = op->name;
+    legalized.gvar = builder_->AddFunction(func, name.substr(name.rfind('.') + 1));
+
+    if (outputs.size() == 1) {
+      legalized.output_shape = ShapeExpr(outputs[0]->shape);
+      legalized.output_type = DynTensorType(outputs[0]->shape.size(), outputs[0]->dtype);
+    } else {
+      Array<Expr> shapes;
+      Array<Type> types;
+      for (const te::Tensor& output : outputs) {
+        shapes.push_back(ShapeExpr(output->shape));
+        types.push_back(DynTensorType(output->shape.size(), output->dtype));
+      }
+      legalized.output_shape = Tuple(shapes);
+      legalized.output_type = TupleType(types);
+    }
+    if (!unbound_vars.empty()) {
+      legalized.tir_vars = ShapeExpr(Array<PrimExpr>(unbound_vars.begin(), unbound_vars.end()));
+    }
+    return legalized;
+  }
+
+  IRModule mod_;
+  /*! \brief The legalization of each signature, i.e. the op, attrs, shapes and dtypes. */
+  std::unordered_map<Array<ObjectRef>, LegalizedCall, StructuralHash, StructuralEqual> cache_;
+};
+
+namespace transform {
+
+Pass LegalizeOps() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return OpLegalizer(mod).Transform(); };
+  return CreateModulePass(pass_func, 0, "LegalizeOps", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.LegalizeOps").set_body_typed(LegalizeOps);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/lift_transform_params.cc
+ * \brief Lift the transformations of the weights out of a function into a separate function.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+// ==================
+// LiftTransformParams
+// Lift the bindings which only depend on the weights of a function, such as the layout rewrites
+// of the weights, into a function "<name>_transform_params", which takes the weights and returns
+// the transformed weights. The function then takes the transformed weights in place of the
+// weights, so that the transformations run once ahead of the deployment rather than on each call.
+// Example:
+// def main(x, w):  # num_input = 1
+//   with dataflow():
+//     lv0 = call_tir(transpose, (w,), ...)
+//     gv = call_tir(matmul, (x, lv0), ...)
+//   return gv
+// -->
+// def main_transform_params(w):
+//   with dataflow():
+//     lv0 = call_tir(transpose, (w,), ...)
+//     gv1 = (lv0,)
+//   return gv1
+// def main(x, lv0):  # num_input = 1
+//   with dataflow():
+//     gv = call_tir(matmul, (x, lv0), ...)
+//   return gv
+
+/*! \brief The bindings of a function to be lifted, and the lifted values the function uses. */
+class TransformParamsPlanner {
+ public:
+  explicit TransformParamsPlanner(const Function& func, int num_input) {
+    for (size_t i = num_input; i < func->params.size(); ++i) {
+      liftable_.insert(func->params[i].get());
+    }
+    const auto* seq = func->body.as<SeqExprNode>();
+    if (seq == nullptr) return;
+    for (const BindingBlock& block : seq->blocks) {
+      // Only the dataflow blocks are free of side effects.
+      bool is_dataflow = block->IsInstance<DataflowBlockNode>();
+      for (const Binding& binding : block->bindings) {
+        if (const auto* var_binding = binding.as<VarBindingNode>()) {
+          if (is_dataflow && IsLiftable(var_binding->value)) {
+            liftable_.insert(var_binding->var.get());
+            bindings.push_back(GetRef<VarBinding>(var_binding));
+          } else {
+            UseValue(var_binding->value);
+          }
+        } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+          UseValue(match_shape->value);
+        }
+      }
+    }
+    UseValue(seq->body);
+  }
+
+  /*! \brief The bindings to be lifted, in their order. */
+  Array<VarBinding> bindings;
+  /*! \brief The weights and the lifted variables used by the rest of the function. */
+  Array<Var> outputs;
+
+  bool IsLifted(const VarNode* var) const { return liftable_.count(var); }
+
+ private:
+  /*! \brief Whether a value only depends on the weights and the lifted variables. */
+  bool IsLiftable(const Expr& value) const {
+    // The symbolic shapes are bound by the runtime inputs.
+    if (!ShapeVars(value).empty()) return false;
+    if (value->IsInstance<FunctionNode>()) return false;
+    for (const Var& var : FreeVars(value)) {
+      if (!liftable_.count(var.get())) return false;
+    }
+    return true;
+  }
+
+  /*! \brief Record the weights and the lifted variables used by the rest of the function. */
+  void UseValue(const Expr& value) {
+    for (const Var& var : FreeVars(value)) {
+      if (liftable_.count(var.get()) && !output_set_.count(var.get())) {
+        output_set_.insert(var.get());
+        outputs.push_back(var);
+      }
+    }
+  }
+
+  std::unordered_set<const VarNode*> liftable_;
+  std::unordered_set<const VarNode*> output_set_;
+};
+
+/*! \brief Remove the lifted bindings, and let the uses of the outputs refer to the new params. */
+class TransformParamsRemover : public ExprMutator {
+ public:
+  explicit TransformParamsRemover(const TransformParamsPlanner& planner) : planner_(planner) {}
+
+  Function Rewrite(const Function& func, int num_input, Array<Var>* new_params) {
+    Array<Var> params(func->params.begin(), func->params.begin() + num_input);
+    for (const Var& output : planner_.outputs) {
+      Var param(output->name_hint(), NullOpt, output->checked_type_, output->span);
+      param->shape_ = output->shape_;
+      var_remap_[output->vid] = param;
+      params.push_back(param);
+      new_params->push_back(param);
+    }
+    Function updated(params, func->body, func->ret_type, func->ret_shape, func->attrs, func->span);
+    return Downcast<Function>(VisitExpr(updated));
+  }
+
+ private:
+  void VisitBinding_(const VarBindingNode* binding) final {
+    if (!planner_.IsLifted(binding->var.get())) {
+      ExprMutator::VisitBinding_(binding);
+    }
+  }
+
+  const TransformParamsPlanner& planner_;
+};
+
+IRModule LiftTransformParams(IRModule mod) {
+  IRModule ret = mod;
+  ret.CopyOnWrite();
+  for (const auto& kv : mod->functions) {
+    const auto* func_node = kv.second.as<FunctionNode>();
+    if (func_node == nullptr) continue;
+    Function func = GetRef<Function>(func_node);
+    Optional<Integer> num_input = func->GetAttr<Integer>(attr::kNumInput);
+    if (!num_input.defined()) continue;
+    int n = num_input.value()->value;
+    ICHECK(n >= 0 && n <= static_cast<int>(func->params.size()))
+        << "The function " << kv.first->name_hint << " has " << func->params.size()
+        << " parameters, but its attribute num_input is " << n;
+
+    TransformParamsPlanner planner(func, n);
+    if (planner.bindings.empty()) continue;
+
+    // Create the function computing the transformed weights.
+    BlockBuilder builder = BlockBuilder::Create(NullOpt);
+    builder->BeginDataflowBlock();
+    for (const VarBinding& binding : planner.bindings) {
+      builder->EmitNormalized(binding);
+    }
+    Array<Expr> outputs(planner.outputs.begin(), planner.outputs.end());
+    Var output = builder->EmitOutput(Tuple(outputs));
+    BindingBlock block = builder->EndBlock();
+    Expr body = builder->Normalize(SeqExpr({block}, output));
+    Array<Var> weights(func->params.begin() + n, func->params.end());
+    Function transform_func(/*params=*/weights,  //
+                            /*body=*/body,        //
+                            /*ret_type=*/output->checked_type_,
+                            /*ret_shape=*/RuntimeDepShape());
+
+    // Let the function take the transformed weights in place of the weights.
+    Array<Var> new_params;
+    Function updated = TransformParamsRemover(planner).Rewrite(func, n, &new_params);
+
+    GlobalVar transform_gv(kv.first->name_hint + "_transform_params");
+    transform_gv->checked_type_ = transform_func->checked_type_;
+    ret->Add(transform_gv, transform_func);
+    ret->Update(kv.first, updated);
+  }
+  return ret;
+}
+
+namespace transform {
+
+Pass LiftTransformParams() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) { return relax::LiftTransformParams(mod); };
+  return CreateModulePass(pass_func, 0, "LiftTransformParams", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.LiftTransformParams").set_body_typed(LiftTransformParams);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
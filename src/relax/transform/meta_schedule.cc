@@ -22,16 +22,121 @@
  * \brief Pass for meta_schedule tuning
  */
 #include <tvm/meta_schedule/database.h>
+#include <tvm/node/serialization.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/tuning_api.h>
 #include <tvm/tir/transform.h>
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "../../meta_schedule/utils.h"
 #include "../../printer/text_printer.h"
+#include "shape_bucket.h"
 
 namespace tvm {
 namespace relax {
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.MetaScheduleApplyDatabase.schedule_cache_dir", String);
+
+/*!
+ * \brief The on-disk cache of the scheduled PrimFuncs, which saves replaying the traces of the
+ * tuning records on every build. An entry is keyed by the hashes of the PrimFunc, the target and
+ * the best tuning record, so that it is invalidated once the tuning record is superseded.
+ */
+class ScheduleCache {
+ public:
+  explicit ScheduleCache(String dir) : dir_(dir) {}
+
+  /*! \brief Apply the best tuning record in the database to a PrimFunc, through the cache. */
+  Optional<IRModule> Query(const meta_schedule::Database& database, const IRModule& mod,
+                           const Target& target, const String& workload_name) const {
+    Optional<meta_schedule::TuningRecord> record =
+        database->QueryTuningRecord(mod, target, workload_name);
+    if (!record.defined()) {
+      return NullOpt;
+    }
+    std::string path = Path(mod, target, record.value());
+    if (Optional<IRModule> cached = Load(path, mod)) {
+      return cached;
+    }
+    Optional<tir::Schedule> sch = database->QuerySchedule(mod, target, workload_name);
+    if (!sch.defined()) {
+      return NullOpt;
+    }
+    IRModule new_mod = sch.value()->mod();
+    Save(path, mod, new_mod);
+    return new_mod;
+  }
+
+ private:
+  std::string Path(const IRModule& mod, const Target& target,
+                   const meta_schedule::TuningRecord& record) const {
+    uint64_t key = tvm::StructuralHash()(mod);
+    key = support::HashCombine(key, std::hash<std::string>()(target->str()));
+    key = support::HashCombine(key, record->workload->shash);
+    key = support::HashCombine(
+        key, std::hash<std::string>()(meta_schedule::JSONDumps(record->trace->AsJSON(false))));
+    std::ostringstream os;
+    os << dir_ << "/" << std::hex << key << ".json";
+    return os.str();
+  }
+
+  /*! \brief Load an entry, which holds the PrimFunc along with its schedule against collisions. */
+  static Optional<IRModule> Load(const std::string& path, const IRModule& mod) {
+    std::ifstream is(path);
+    if (!is.good()) {
+      return NullOpt;
+    }
+    std::string json((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    try {
+      Array<IRModule> entry = Downcast<Array<IRModule>>(LoadJSON(json));
+      if (entry.size() == 2 && tvm::StructuralEqual()(entry[0], mod)) {
+        return entry[1];
+      }
+    } catch (const std::runtime_error& e) {  // includes tvm::Error and dmlc::Error
+      LOG(WARNING) << "Ignoring the broken schedule cache entry " << path << ": " << e.what();
+    }
+    return NullOpt;
+  }
+
+  /*! \brief Save an entry, renamed into place so that concurrent builds never see it partial. */
+  static void Save(const std::string& path, const IRModule& mod, const IRModule& new_mod) {
+    // The temporary file is unique to the process and the thread, as the thread ids are only
+    // unique within a process.
+    std::ostringstream tmp_path;
+#ifdef _WIN32
+    tmp_path << path << ".tmp." << _getpid() << "." << std::this_thread::get_id();
+#else
+    tmp_path << path << ".tmp." << getpid() << "." << std::this_thread::get_id();
+#endif
+    {
+      std::ofstream os(tmp_path.str());
+      if (!os.good()) {
+        LOG(WARNING) << "Cannot write the schedule cache entry " << tmp_path.str();
+        return;
+      }
+      os << SaveJSON(Array<IRModule>{mod, new_mod});
+    }
+    if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+      LOG(WARNING) << "Cannot write the schedule cache entry " << path;
+      std::remove(tmp_path.str().c_str());
+    }
+  }
+
+  /*! \brief The directory of the cache. */
+  String dir_;
+};
+
 class MetaScheduleTuner {
  public:
   explicit MetaScheduleTuner(Target target, String work_dir, Integer max_trials_global,
@@ -85,7 +190,8 @@ class MetaScheduleTuner {
   const runtime::PackedFunc* normalize_mod_func_;
 };
 
-Pass MetaScheduleApplyDatabase(Optional<String> work_dir, String mod_eq_name) {
+Pass MetaScheduleApplyDatabase(Optional<String> work_dir, String mod_eq_name,
+                               Map<String, Array<Integer>> shape_buckets) {
   using tvm::meta_schedule::Database;
   Target target = Target::Current(false);
   const runtime::PackedFunc* normalize_mod_func_ =
@@ -107,16 +213,69 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir, String mod_eq_name) {
                                                        mod_eq_name);
     }
 
+    Optional<String> cache_dir = ctx->GetConfig<String>(
+        "relax.MetaScheduleApplyDatabase.schedule_cache_dir", Optional<String>());
+    auto f_query = [&](const IRModule& tir_mod, const String& name) -> Optional<IRModule> {
+      if (cache_dir.defined()) {
+        return ScheduleCache(cache_dir.value()).Query(database, tir_mod, target, name);
+      }
+      return database->QueryIRModule(tir_mod, target, name);
+    };
+    // Apply the records of the shape buckets of a PrimFunc to it, and dispatch over them.
+    auto f_query_buckets = [&](const tir::PrimFunc& prim_func, const String& name,
+                               const std::vector<ShapeBucket>& buckets) -> Optional<tir::PrimFunc> {
+      IRModule tir_mod = (*normalize_mod_func_)(prim_func);
+      std::vector<std::pair<ShapeBucket, tir::PrimFunc>> kernels;
+      for (const ShapeBucket& bucket : buckets) {
+        String bucket_name = ShapeBucketName(name, bucket);
+        IRModule bucket_mod = (*normalize_mod_func_)(SpecializeShapeBucket(prim_func, bucket));
+        Optional<meta_schedule::TuningRecord> record =
+            database->QueryTuningRecord(bucket_mod, target, bucket_name);
+        if (!record.defined()) {
+          LOG(WARNING) << "Tuning record is not found for shape bucket: " << bucket_name;
+          continue;
+        }
+        tir::Schedule sch = tir::Schedule::Traced(tir_mod, /*seed=*/-1, /*debug_mask=*/0,
+                                                  tir::ScheduleErrorRenderLevel::kDetail);
+        try {
+          GeneralizeShapeBucketTrace(record.value()->trace)
+              ->ApplyToSchedule(sch, /*remove_postproc=*/false);
+        } catch (const std::runtime_error& e) {  // includes tvm::Error and dmlc::Error
+          LOG(WARNING) << "Cannot apply the schedule of shape bucket " << bucket_name
+                       << " to the symbolic PrimFunc: " << e.what();
+          continue;
+        }
+        BaseFunc kernel = (*sch->mod()->functions.begin()).second;
+        kernels.emplace_back(bucket, Downcast<tir::PrimFunc>(kernel));
+      }
+      if (kernels.empty()) {
+        return NullOpt;
+      }
+      return MakeShapeBucketDispatcher(kernels);
+    };
+
     Map<GlobalVar, BaseFunc> result;
     for (const auto& iter : mod->functions) {
       GlobalVar gv = iter.first;
       BaseFunc base_func = iter.second;
       if (const auto* prim_func_node = base_func.as<tir::PrimFuncNode>()) {
         tir::PrimFunc prim_func = GetRef<tir::PrimFunc>(prim_func_node);
+        std::vector<ShapeBucket> buckets = GetShapeBuckets(prim_func, shape_buckets);
+        if (!buckets.empty()) {
+          Optional<tir::PrimFunc> dispatcher = f_query_buckets(prim_func, gv->name_hint, buckets);
+          if (dispatcher.defined()) {
+            result.Set(gv, WithAttrs(dispatcher.value(), {prim_func->attrs->dict}));
+            continue;
+          }
+          LOG(WARNING) << "Tuning record is not found for any shape bucket of primfunc: "
+                       << gv->name_hint;
+          result.Set(gv, base_func);
+          continue;
+        }
 
         IRModule tir_mod = (*normalize_mod_func_)(prim_func);
-        if (Optional<tir::Schedule> sch = database->QuerySchedule(tir_mod, target, gv->name_hint)) {
-          IRModule new_mod = sch.value()->mod();
+        if (Optional<IRModule> opt_mod = f_query(tir_mod, gv->name_hint)) {
+          IRModule new_mod = opt_mod.value();
           ICHECK_EQ(new_mod->functions.size(), 1);
           BaseFunc new_base_func = (*new_mod->functions.begin()).second;
           ICHECK(new_base_func->IsInstance<tir::PrimFuncNode>());
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/quantize_weights.cc
+ * \brief Rewrite the dense layers of constant weights into weight-only quantized dense layers.
+ */
+#include <tvm/relax/transform.h>
+
+#include "../op/make_op.h"
+#include "weight_rewriter.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Rewrite the dense and matmul calls of constant weights into quantized_dense calls.
+ *
+ * Example:
+ * lv0 = relax.nn.dense(x, w)
+ * -->
+ * lv1 = relax.nn.quantize_weight(w)
+ * lv2 = lv1[0]
+ * lv3 = lv1[1]
+ * lv0 = relax.nn.quantized_dense(x, lv2, lv3)
+ *
+ * The weights of the matmul calls are transposed first. The quantization of the constant weights
+ * is computed at compile time by FoldConstant, after the op legalizer.
+ */
+class WeightQuantizer : public ConstantWeightDenseRewriter {
+ public:
+  WeightQuantizer(int bits, int group_size) : bits_(bits), group_size_(group_size) {}
+
+ protected:
+  /*! \brief Whether the weights are float matrices whose rows divide into groups. */
+  bool IsRewritable(const runtime::NDArray& weight, bool transpose) const final {
+    if (weight->ndim != 2 || weight->dtype.code != kDLFloat || weight->dtype.lanes != 1) {
+      return false;
+    }
+    int64_t k = weight->shape[transpose ? 0 : 1];
+    return k % group_size_ == 0;
+  }
+
+  Expr RewriteDense(const Expr& data, const Expr& weight, DataType out_dtype) final {
+    Var quantized = builder_->Emit(MakeQuantizeWeight(weight, bits_, group_size_));
+    Var packed = builder_->Emit(TupleGetItem(quantized, 0));
+    Var scale = builder_->Emit(TupleGetItem(quantized, 1));
+    return MakeQuantizedDense(data, packed, scale, bits_, group_size_, out_dtype);
+  }
+
+ private:
+
+  /*! \brief The bits of the quantized weights. */
+  int bits_;
+  /*! \brief The number of consecutive weights of a row sharing a scale. */
+  int group_size_;
+};
+
+namespace transform {
+
+Pass QuantizeWeights(int bits, int group_size) {
+  CHECK(bits == 4 || bits == 8) << "ValueError: QuantizeWeights supports 4 or 8 bits, but gets "
+                                << bits;
+  CHECK(group_size > 0 && group_size % (8 / bits) == 0)
+      << "ValueError: QuantizeWeights expects a positive group size multiple of " << 8 / bits
+      << ", but gets " << group_size;
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(WeightQuantizer(bits, group_size).VisitExpr(f));
+      };
+  return CreateFunctionPass(pass_func, 0, "QuantizeWeights", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.QuantizeWeights").set_body_typed(QuantizeWeights);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
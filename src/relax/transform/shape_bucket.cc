@@ -0,0 +1,213 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file shape_bucket.cc
+ * \brief The shape buckets of the PrimFuncs with symbolic dims.
+ */
+#include "shape_bucket.h"
+
+#include <tvm/tir/schedule/instruction.h>
+#include <tvm/tir/stmt.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace tvm {
+namespace relax {
+
+std::vector<ShapeBucket> GetShapeBuckets(const tir::PrimFunc& func,
+                                         const Map<String, Array<Integer>>& shape_buckets) {
+  if (shape_buckets.empty()) {
+    return {};
+  }
+  // The symbolic dims, in the order of the params. A specialization substitutes the shapes of the
+  // buffers, so that a dim must be a plain var.
+  std::vector<tir::Var> dims;
+  std::unordered_set<const tir::VarNode*> seen;
+  for (const tir::Var& param : func->params) {
+    auto it = func->buffer_map.find(param);
+    if (it == func->buffer_map.end()) {
+      continue;
+    }
+    for (const PrimExpr& dim : (*it).second->shape) {
+      if (dim->IsInstance<IntImmNode>()) {
+        continue;
+      }
+      const auto* var = dim.as<tir::VarNode>();
+      if (var == nullptr) {
+        return {};
+      }
+      if (seen.insert(var).second) {
+        dims.push_back(GetRef<tir::Var>(var));
+      }
+    }
+  }
+  if (dims.empty()) {
+    return {};
+  }
+  // The combinations of the values, with the last dim varying the fastest.
+  std::vector<ShapeBucket> buckets{ShapeBucket()};
+  for (const tir::Var& dim : dims) {
+    auto it = shape_buckets.find(dim->name_hint);
+    if (it == shape_buckets.end() || (*it).second.empty()) {
+      return {};
+    }
+    std::vector<int64_t> values;
+    for (const Integer& value : (*it).second) {
+      CHECK_GT(value->value, 0) << "ValueError: The bucket values of the dim " << dim
+                                << " must be positive, but gets " << value;
+      values.push_back(value->value);
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    std::vector<ShapeBucket> next;
+    for (const ShapeBucket& bucket : buckets) {
+      for (int64_t value : values) {
+        next.push_back(bucket);
+        next.back().emplace_back(dim, value);
+      }
+    }
+    buckets = std::move(next);
+  }
+  return buckets;
+}
+
+tir::PrimFunc SpecializeShapeBucket(const tir::PrimFunc& func, const ShapeBucket& bucket) {
+  Map<tir::Var, PrimExpr> values;
+  for (const auto& kv : bucket) {
+    values.Set(kv.first, IntImm(kv.first.dtype(), kv.second));
+  }
+  Map<tir::Var, ObjectRef> param_map;
+  for (const tir::Var& param : func->params) {
+    auto it = func->buffer_map.find(param);
+    if (it == func->buffer_map.end()) {
+      continue;
+    }
+    tir::Buffer buffer = (*it).second;
+    Array<PrimExpr> shape;
+    bool specialized = false;
+    for (const PrimExpr& dim : buffer->shape) {
+      shape.push_back(tir::Substitute(dim, values));
+      specialized |= !shape.back().same_as(dim);
+    }
+    if (specialized) {
+      buffer.CopyOnWrite()->shape = shape;
+      param_map.Set(param, buffer);
+    }
+  }
+  return tir::Specialize(func, param_map);
+}
+
+std::string ShapeBucketName(const std::string& name, const ShapeBucket& bucket) {
+  std::string result = name;
+  for (const auto& kv : bucket) {
+    result += "_" + std::string(kv.first->name_hint) + std::to_string(kv.second);
+  }
+  return result;
+}
+
+/*! \brief Substitute the sampled tiles in the inputs of an instruction. */
+static Array<ObjectRef> SubstituteTiles(const Array<ObjectRef>& inputs,
+                                        const Map<tir::Var, PrimExpr>& tiles) {
+  Array<ObjectRef> result;
+  for (const ObjectRef& input : inputs) {
+    if (!input.defined()) {
+      result.push_back(input);
+    } else if (const auto* expr = input.as<PrimExprNode>()) {
+      result.push_back(tir::Substitute(GetRef<PrimExpr>(expr), tiles));
+    } else if (input->IsInstance<ArrayNode>()) {
+      result.push_back(SubstituteTiles(Downcast<Array<ObjectRef>>(input), tiles));
+    } else {
+      result.push_back(input);
+    }
+  }
+  return result;
+}
+
+tir::Trace GeneralizeShapeBucketTrace(const tir::Trace& trace) {
+  static const tir::InstructionKind& kind_sample_perfect_tile =
+      tir::InstructionKind::Get("SamplePerfectTile");
+  static const tir::InstructionKind& kind_split = tir::InstructionKind::Get("Split");
+  // A symbolic loop is not tiled by SamplePerfectTile, so the tiles are the decisions.
+  Map<tir::Var, PrimExpr> tiles;
+  Array<tir::Instruction> insts;
+  Map<tir::Instruction, ObjectRef> decisions;
+  for (const tir::Instruction& inst : trace->insts) {
+    auto it = trace->decisions.find(inst);
+    if (inst->kind.same_as(kind_sample_perfect_tile) && it != trace->decisions.end()) {
+      Array<Integer> decision = Downcast<Array<Integer>>((*it).second);
+      ICHECK_EQ(decision.size(), inst->outputs.size());
+      for (size_t i = 0; i < decision.size(); ++i) {
+        tir::Var tile = Downcast<tir::Var>(inst->outputs[i]);
+        tiles.Set(tile, IntImm(tile.dtype(), decision[i]->value));
+      }
+      continue;
+    }
+    Array<ObjectRef> inputs = SubstituteTiles(inst->inputs, tiles);
+    if (inst->kind.same_as(kind_split) && inputs.size() > 2) {
+      // The outer loop covers the rest of the extent, whatever the dims are.
+      inputs.Set(1, ObjectRef(nullptr));
+    }
+    tir::Instruction new_inst(inst->kind, inputs, inst->attrs, inst->outputs);
+    insts.push_back(new_inst);
+    if (it != trace->decisions.end()) {
+      decisions.Set(new_inst, (*it).second);
+    }
+  }
+  return tir::Trace(insts, decisions);
+}
+
+tir::PrimFunc MakeShapeBucketDispatcher(
+    const std::vector<std::pair<ShapeBucket, tir::PrimFunc>>& kernels) {
+  ICHECK(!kernels.empty());
+  if (kernels.size() == 1) {
+    return kernels[0].second;
+  }
+  // The root block of each kernel is kept as the block of its bucket, with its allocations and
+  // annotations.
+  auto bucket_body = [](const ShapeBucket& bucket, const tir::PrimFunc& kernel) -> tir::Stmt {
+    const auto* realize = kernel->body.as<tir::BlockRealizeNode>();
+    if (realize == nullptr) {
+      return kernel->body;
+    }
+    tir::BlockRealize new_realize = GetRef<tir::BlockRealize>(realize);
+    tir::Block block = new_realize->block;
+    block.CopyOnWrite()->name_hint = ShapeBucketName("bucket", bucket);
+    new_realize.CopyOnWrite()->block = block;
+    return std::move(new_realize);
+  };
+  tir::Stmt body = bucket_body(kernels.back().first, kernels.back().second);
+  for (int i = static_cast<int>(kernels.size()) - 2; i >= 0; --i) {
+    PrimExpr cond;
+    for (const auto& kv : kernels[i].first) {
+      PrimExpr bounded = kv.first <= IntImm(kv.first.dtype(), kv.second);
+      cond = cond.defined() ? cond && bounded : bounded;
+    }
+    body = tir::IfThenElse(cond, bucket_body(kernels[i].first, kernels[i].second), body);
+  }
+  tir::Block root(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{}, /*name_hint=*/"root", body);
+  tir::PrimFunc dispatcher = kernels.back().second;
+  dispatcher.CopyOnWrite()->body = tir::BlockRealize(/*iter_values=*/{}, Bool(true), root);
+  return dispatcher;
+}
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file shape_bucket.h
+ * \brief The shape buckets of the PrimFuncs with symbolic dims, which are tuned for a few
+ *  representative values of each dim and dispatched over by the runtime shape.
+ *
+ * A bucket binds each symbolic dim of a PrimFunc to one of its representative values. The
+ * PrimFunc specialized to a bucket is tuned as a static task, and the trace of its best record
+ * is applied back to the symbolic PrimFunc with the outer factor of every split inferred, so
+ * that the kernel of a bucket runs any shape. The dispatcher takes the kernel of the first
+ * bucket whose values bound the runtime dims, and the kernel of the last bucket otherwise.
+ */
+
+#ifndef TVM_RELAX_TRANSFORM_SHAPE_BUCKET_H_
+#define TVM_RELAX_TRANSFORM_SHAPE_BUCKET_H_
+
+#include <tvm/tir/function.h>
+#include <tvm/tir/schedule/trace.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The values of the symbolic dims of a PrimFunc in a bucket. */
+using ShapeBucket = std::vector<std::pair<tir::Var, int64_t>>;
+
+/*!
+ * \brief The buckets of a PrimFunc, in the order of dispatch.
+ * \param func The PrimFunc.
+ * \param shape_buckets The representative values of the symbolic dims, by name.
+ * \return The combinations of the values of its dims, or nothing if it has no symbolic dim, if
+ *  one of its dims has no representative value, or if a buffer is not shaped by plain dims.
+ */
+std::vector<ShapeBucket> GetShapeBuckets(const tir::PrimFunc& func,
+                                         const Map<String, Array<Integer>>& shape_buckets);
+
+/*! \brief Specialize a PrimFunc to the values of a bucket. */
+tir::PrimFunc SpecializeShapeBucket(const tir::PrimFunc& func, const ShapeBucket& bucket);
+
+/*! \brief The name of the task of a bucket, e.g. "fused_matmul_n128". */
+std::string ShapeBucketName(const std::string& name, const ShapeBucket& bucket);
+
+/*!
+ * \brief Make a trace tuned for a bucket applicable to the symbolic PrimFunc, by replacing the
+ *  sampled tiles by their decisions and the outer factor of every split by the inferred one.
+ */
+tir::Trace GeneralizeShapeBucketTrace(const tir::Trace& trace);
+
+/*!
+ * \brief Make the PrimFunc running the kernel of the bucket of the runtime shape.
+ * \param kernels The buckets and the kernels scheduled for them, in the order of dispatch. The
+ *  kernels have the params and the buffers of the symbolic PrimFunc.
+ */
+tir::PrimFunc MakeShapeBucketDispatcher(
+    const std::vector<std::pair<ShapeBucket, tir::PrimFunc>>& kernels);
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_TRANSFORM_SHAPE_BUCKET_H_
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/sparsify_weights.cc
+ * \brief Rewrite the dense layers of constant weights into 2:4 structured sparse dense layers.
+ */
+#include <tvm/relax/transform.h>
+
+#include "../op/make_op.h"
+#include "weight_rewriter.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Rewrite the dense and matmul calls of constant float16 weights into sparse_dense_2in4
+ * calls.
+ *
+ * Example:
+ * lv0 = relax.nn.dense(x, w)
+ * -->
+ * lv1 = relax.nn.sparse_pack_2in4(w)
+ * lv2 = lv1[0]
+ * lv3 = lv1[1]
+ * lv0 = relax.nn.sparse_dense_2in4(x, lv2, lv3)
+ *
+ * The weights of the matmul calls are transposed first. Without pruning, only the weights which
+ * already have at most 2 nonzeros in each group of 4 of a row are rewritten, so that the rewrite
+ * is exact. The packing of the constant weights is computed at compile time by FoldConstant,
+ * after the op legalizer.
+ */
+class WeightSparsifier : public ConstantWeightDenseRewriter {
+ public:
+  explicit WeightSparsifier(bool prune) : prune_(prune) {}
+
+ protected:
+  /*!
+   * \brief Whether the weights are float16 matrices of dims divisible into the tiles of the
+   * metadata, and, without pruning, have at most 2 nonzeros in each group of 4 of a row.
+   */
+  bool IsRewritable(const runtime::NDArray& weight, bool transpose) const final {
+    if (weight->ndim != 2 || weight->dtype.code != kDLFloat || weight->dtype.bits != 16 ||
+        weight->dtype.lanes != 1) {
+      return false;
+    }
+    int64_t n = weight->shape[transpose ? 1 : 0];
+    int64_t k = weight->shape[transpose ? 0 : 1];
+    if (n % 16 != 0 || k % 16 != 0) {
+      return false;
+    }
+    if (prune_) {
+      return true;
+    }
+    runtime::NDArray cpu_weight = weight.CopyTo(Device{kDLCPU, 0});
+    const auto* bits = reinterpret_cast<const uint16_t*>(
+        static_cast<const char*>(cpu_weight->data) + cpu_weight->byte_offset);
+    for (int64_t i = 0; i < n; ++i) {
+      for (int64_t j = 0; j < k; j += 4) {
+        int num_nonzeros = 0;
+        for (int64_t q = j; q < j + 4; ++q) {
+          // Both signed zeros are zeros.
+          num_nonzeros += (bits[transpose ? q * n + i : i * k + q] & 0x7fff) != 0;
+        }
+        if (num_nonzeros > 2) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  Expr RewriteDense(const Expr& data, const Expr& weight, DataType out_dtype) final {
+    Var packed = builder_->Emit(MakeSparsePack2in4(weight));
+    Var values = builder_->Emit(TupleGetItem(packed, 0));
+    Var metadata = builder_->Emit(TupleGetItem(packed, 1));
+    return MakeSparseDense2in4(data, values, metadata, out_dtype);
+  }
+
+ private:
+
+  /*! \brief Whether to prune the weights to the 2 of largest magnitude of each group of 4. */
+  bool prune_;
+};
+
+namespace transform {
+
+Pass SparsifyWeights(bool prune) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(WeightSparsifier(prune).VisitExpr(f));
+      };
+  return CreateFunctionPass(pass_func, 0, "SparsifyWeights", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.SparsifyWeights").set_body_typed(SparsifyWeights);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,288 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/specialize_closures.cc
+ * \brief Call the lifted functions of the closures known at compile time directly.
+ */
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+// ==================
+// SpecializeClosures
+// Replace the invocations of the closures whose function is known by direct calls of the lifted
+// function, with the captured variables as the trailing arguments, see LambdaLift.
+// Example:
+// clo = relax.make_closure(lifted_func_1, (x,))
+// res = relax.invoke_closure(clo, (y,))
+// -->
+// res = lifted_func_1(y, x)
+//
+// The closure is known when it is made in the function, or returned by a call of a global function
+// whose body only makes the closure of some of its parameters. The bindings making the closures
+// are removed once they have no other use, the closures passed around are kept.
+
+/*! \brief The lifted function and the captured variables of a closure. */
+struct KnownClosure {
+  GlobalVar func;
+  Array<Expr> captured;
+};
+
+/*! \brief The number of uses of the variables in an expression. */
+class VarUseCounter : public ExprVisitor {
+ public:
+  void VisitExpr_(const VarNode* op) final { ++uses[op]; }
+  void VisitExpr_(const DataflowVarNode* op) final { ++uses[op]; }
+
+  std::unordered_map<const VarNode*, int> uses;
+};
+
+class ClosureSpecializationPlanner : public ExprVisitor {
+ public:
+  explicit ClosureSpecializationPlanner(const IRModule& mod) : mod_(mod) {}
+
+  void Plan(const Function& func) {
+    this->VisitExpr(func);
+    // The uses of a binding removed go away with it, which may free the bindings it uses.
+    std::vector<const VarNode*> worklist;
+    for (const auto& kv : values_) {
+      if (IsPure(kv.second) && uses_[kv.first] == 0) worklist.push_back(kv.first);
+    }
+    while (!worklist.empty()) {
+      const VarNode* var = worklist.back();
+      worklist.pop_back();
+      if (!dead.insert(var).second) continue;
+      VarUseCounter counter;
+      counter.VisitExpr(values_.at(var));
+      for (const auto& kv : counter.uses) {
+        auto it = values_.find(kv.first);
+        if ((uses_[kv.first] -= kv.second) == 0 && it != values_.end() && IsPure(it->second)) {
+          worklist.push_back(kv.first);
+        }
+      }
+    }
+  }
+
+  void VisitBindingBlock_(const DataflowBlockNode* block) final {
+    const DataflowBlockNode* outer = dataflow_block_;
+    dataflow_block_ = block;
+    ExprVisitor::VisitBindingBlock_(block);
+    dataflow_block_ = outer;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    ExprVisitor::VisitBinding_(binding);
+    values_[binding->var.get()] = binding->value;
+    if (dataflow_block_ != nullptr) {
+      blocks_[binding->var.get()] = dataflow_block_;
+    }
+  }
+
+  void VisitExpr_(const VarNode* op) final { ++uses_[op]; }
+  void VisitExpr_(const DataflowVarNode* op) final { ++uses_[op]; }
+
+  void VisitExpr_(const CallNode* call) final {
+    ExprVisitor::VisitExpr_(call);
+    if (call->op != invoke_closure_op_) return;
+    const auto* closure_var = call->args[0].as<VarNode>();
+    if (closure_var == nullptr || !call->args[1]->IsInstance<TupleNode>()) return;
+    KnownClosure closure;
+    if (!Resolve(GetRef<Var>(closure_var), &closure)) return;
+    // The dataflow variables captured are only visible in their block.
+    for (const Expr& captured : closure.captured) {
+      const auto* var = captured.as<DataflowVarNode>();
+      if (var != nullptr && blocks_[var] != dataflow_block_) return;
+    }
+    specialized.emplace(call, closure);
+    // The invocation does not use the closure anymore.
+    --uses_[closure_var];
+  }
+
+  /*! \brief The invocations of the known closures. */
+  std::unordered_map<const CallNode*, KnownClosure> specialized;
+  /*! \brief The bindings of the closures and of their functions left without use. */
+  std::unordered_set<const VarNode*> dead;
+
+ private:
+  /*! \brief Follow the aliases of a variable to its value. */
+  Expr Value(Expr expr) const {
+    while (const auto* var = expr.as<VarNode>()) {
+      auto it = values_.find(var);
+      if (it == values_.end()) break;
+      expr = it->second;
+    }
+    return expr;
+  }
+
+  /*! \brief Whether a binding can be removed without effect once its variable is unused. */
+  bool IsPure(const Expr& value) const {
+    if (value->IsInstance<GlobalVarNode>()) return true;
+    if (const auto* call = value.as<CallNode>()) {
+      if (call->op == make_closure_op_) return true;
+      if (const auto* gvar = Value(call->op).as<GlobalVarNode>()) {
+        return ClosureOf(GetRef<GlobalVar>(gvar)).defined();
+      }
+    }
+    return false;
+  }
+
+  /*!
+   * \brief The make_closure call of a global function whose body only makes a closure of its
+   *  parameters.
+   */
+  Optional<Call> ClosureOf(const GlobalVar& gvar) const {
+    auto it = mod_->functions.find(gvar);
+    if (it == mod_->functions.end()) return NullOpt;
+    const auto* func = (*it).second.as<FunctionNode>();
+    if (func == nullptr) return NullOpt;
+    Expr body = func->body;
+    if (const auto* seq = body.as<SeqExprNode>()) {
+      // A single binding of the closure, returned.
+      size_t num_bindings = 0;
+      const VarBindingNode* binding = nullptr;
+      for (const BindingBlock& block : seq->blocks) {
+        num_bindings += block->bindings.size();
+        if (!block->bindings.empty()) binding = block->bindings.back().as<VarBindingNode>();
+      }
+      if (num_bindings == 0) {
+        body = seq->body;
+      } else if (num_bindings == 1 && binding != nullptr && binding->var.same_as(seq->body)) {
+        body = binding->value;
+      } else {
+        return NullOpt;
+      }
+    }
+    const auto* call = body.as<CallNode>();
+    if (call == nullptr || call->op != make_closure_op_ ||
+        !call->args[0]->IsInstance<GlobalVarNode>()) {
+      return NullOpt;
+    }
+    std::unordered_set<const VarNode*> params;
+    for (const Var& param : func->params) params.insert(param.get());
+    for (const Expr& captured : Downcast<Tuple>(call->args[1])->fields) {
+      const auto* var = captured.as<VarNode>();
+      if (var == nullptr || !params.count(var)) return NullOpt;
+    }
+    return GetRef<Call>(call);
+  }
+
+  /*!
+   * \brief Find the lifted function and the captured variables of a closure.
+   * \return Whether the closure is known.
+   */
+  bool Resolve(const Var& closure, KnownClosure* known) const {
+    const auto* call = Value(closure).as<CallNode>();
+    if (call == nullptr) return false;
+    if (call->op == make_closure_op_) {
+      const auto* gvar = call->args[0].as<GlobalVarNode>();
+      if (gvar == nullptr) return false;
+      *known = KnownClosure{GetRef<GlobalVar>(gvar), Downcast<Tuple>(call->args[1])->fields};
+      return true;
+    }
+    // A closure made by a global function, from the arguments of the call.
+    const auto* maker = Value(call->op).as<GlobalVarNode>();
+    if (maker == nullptr) return false;
+    Optional<Call> make_closure = ClosureOf(GetRef<GlobalVar>(maker));
+    if (!make_closure.defined()) return false;
+    const auto* func = mod_->Lookup(GetRef<GlobalVar>(maker)).as<FunctionNode>();
+    if (func->params.size() != call->args.size()) return false;
+    Array<Expr> captured;
+    for (const Expr& var : Downcast<Tuple>(make_closure.value()->args[1])->fields) {
+      for (size_t i = 0; i < func->params.size(); ++i) {
+        if (func->params[i].same_as(var)) captured.push_back(call->args[i]);
+      }
+    }
+    *known = KnownClosure{Downcast<GlobalVar>(make_closure.value()->args[0]), captured};
+    return true;
+  }
+
+  IRModule mod_;
+  std::unordered_map<const VarNode*, Expr> values_;
+  std::unordered_map<const VarNode*, int> uses_;
+  std::unordered_map<const VarNode*, const DataflowBlockNode*> blocks_;
+  const DataflowBlockNode* dataflow_block_{nullptr};
+  const Op& make_closure_op_ = Op::Get("relax.make_closure");
+  const Op& invoke_closure_op_ = Op::Get("relax.invoke_closure");
+};
+
+class ClosureSpecializer : public ExprMutator {
+ public:
+  explicit ClosureSpecializer(const ClosureSpecializationPlanner& plan) : plan_(plan) {}
+
+  using ExprMutator::VisitExpr_;
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    if (plan_.dead.count(binding->var.get())) return;
+    ExprMutator::VisitBinding_(binding);
+  }
+
+  Expr VisitExpr_(const CallNode* call) final {
+    auto it = plan_.specialized.find(call);
+    if (it == plan_.specialized.end()) {
+      return ExprMutator::VisitExpr_(call);
+    }
+    Array<Expr> args;
+    for (const Expr& arg : Downcast<Tuple>(call->args[1])->fields) {
+      args.push_back(this->VisitExpr(arg));
+    }
+    for (const Expr& captured : it->second.captured) {
+      args.push_back(this->VisitExpr(captured));
+    }
+    Call direct(it->second.func, args);
+    UpdateType(direct, call->checked_type_);
+    if (call->shape_.defined()) {
+      UpdateShape(direct, call->shape_);
+    }
+    return std::move(direct);
+  }
+
+ private:
+  const ClosureSpecializationPlanner& plan_;
+};
+
+Function SpecializeClosures(const Function& func, const IRModule& mod) {
+  ClosureSpecializationPlanner planner(mod);
+  planner.Plan(func);
+  if (planner.specialized.empty()) {
+    return func;
+  }
+  return Downcast<Function>(ClosureSpecializer(planner).VisitExpr(func));
+}
+
+namespace transform {
+
+Pass SpecializeClosures() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) { return relax::SpecializeClosures(f, m); };
+  return CreateFunctionPass(pass_func, 0, "SpecializeClosures", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.SpecializeClosures").set_body_typed(SpecializeClosures);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,251 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/specialize_shapes.cc
+ * \brief Specialize a Relax function with symbolic shapes, and its PrimFuncs, to the shapes of its
+ *  arguments.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "shape_bucket.h"
+
+namespace tvm {
+namespace relax {
+
+// ==================
+// SpecializeShapes
+// Bind the symbolic dims of a function to the dims of the given argument shapes, and call the
+// PrimFuncs specialized to the static shapes of their arguments.
+// Example, for x of shape (4, 8):
+// def main(x: Tensor((n, 8))):
+//   y = call_tir(exp, (x,), (n, 8))
+// --->
+// def main(x: Tensor((4, 8))):
+//   y = call_tir(exp_n4, (x,), (4, 8))
+
+class ShapeSpecializer : public ExprMutator {
+ public:
+  ShapeSpecializer(IRModule mod, const Function& func, const Array<ObjectRef>& shapes)
+      : ExprMutator(mod), mod_(mod) {
+    CHECK_EQ(func->params.size(), shapes.size())
+        << "ValueError: The function takes " << func->params.size() << " arguments, but "
+        << shapes.size() << " shapes are given";
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      if (!shapes[i].defined()) {
+        continue;
+      }
+      ShapeTuple shape = Downcast<ShapeTuple>(shapes[i]);
+      param_shapes_[func->params[i]->vid] = shape;
+      if (const auto* expr = func->params[i]->shape_.as<ShapeExprNode>()) {
+        BindDims(expr->values, shape, func->params[i]->name_hint());
+      }
+    }
+  }
+
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const ShapeExprNode* op) final {
+    Array<PrimExpr> values;
+    bool changed = false;
+    for (const PrimExpr& value : op->values) {
+      values.push_back(analyzer_.Simplify(tir::Substitute(value, dims_)));
+      changed |= !values.back().same_as(value);
+    }
+    return changed ? ShapeExpr(values, op->span) : GetRef<Expr>(op);
+  }
+
+  void VisitBinding_(const MatchShapeNode* binding) final {
+    // The dims matched on an argument are those of its shape
+    if (const auto* var = binding->value.as<VarNode>()) {
+      auto it = param_shapes_.find(var->vid);
+      if (it != param_shapes_.end() && binding->value->checked_type_.as<DynTensorTypeNode>()) {
+        BindDims(binding->pattern, it->second, var->name_hint());
+      }
+    }
+    ExprMutator::VisitBinding_(binding);
+  }
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    if (!call->op.same_as(call_tir_op)) {
+      return std::move(call);
+    }
+    Optional<GlobalVar> specialized = SpecializePrimFunc(call);
+    if (!specialized.defined()) {
+      return std::move(call);
+    }
+    call.CopyOnWrite()->args.Set(0, specialized.value());
+    return std::move(call);
+  }
+
+ private:
+  /*! \brief Bind the symbolic dims of a shape to the dims of the argument. */
+  void BindDims(const Array<PrimExpr>& pattern, const ShapeTuple& shape, const String& name) {
+    CHECK_EQ(pattern.size(), shape.size())
+        << "ValueError: The argument " << name << " has " << pattern.size()
+        << " dims, but the shape " << shape << " is given";
+    for (size_t i = 0; i < pattern.size(); ++i) {
+      PrimExpr dim = tir::Substitute(pattern[i], dims_);
+      if (const auto* var = dim.as<tir::VarNode>()) {
+        dims_.Set(GetRef<tir::Var>(var), IntImm(var->dtype, shape[i]));
+      } else if (const auto* imm = analyzer_.Simplify(dim).as<IntImmNode>()) {
+        CHECK_EQ(imm->value, shape[i]) << "ValueError: The dim " << i << " of the argument "
+                                       << name << " is " << imm->value << ", but "
+                                       << shape[i] << " is given";
+      }
+    }
+  }
+
+  /*! \brief The static dims of a shape expression, or an empty vector. */
+  static std::vector<int64_t> StaticShape(const Expr& expr) {
+    std::vector<int64_t> shape;
+    const auto* shape_expr = expr.as<ShapeExprNode>();
+    if (shape_expr == nullptr) {
+      return {};
+    }
+    for (const PrimExpr& value : shape_expr->values) {
+      const auto* imm = value.as<IntImmNode>();
+      if (imm == nullptr) {
+        return {};
+      }
+      shape.push_back(imm->value);
+    }
+    return shape;
+  }
+
+  /*!
+   * \brief The PrimFunc of a call_tir specialized to the static shapes of its arguments and
+   *  outputs, added to the module once per bucket of its dims, or nothing if there is none.
+   */
+  Optional<GlobalVar> SpecializePrimFunc(const Call& call) {
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    if (gv == nullptr || !mod_->ContainGlobalVar(gv->name_hint)) {
+      return NullOpt;
+    }
+    const auto* func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>();
+    if (func == nullptr) {
+      return NullOpt;
+    }
+    std::vector<Expr> shapes;
+    for (const Expr& arg : Downcast<Tuple>(call->args[1])->fields) {
+      shapes.push_back(arg->shape_.defined() ? Downcast<Expr>(arg->shape_.value()) : Expr());
+    }
+    if (const auto* outputs = call->args[2].as<TupleNode>()) {
+      for (const Expr& output : outputs->fields) {
+        shapes.push_back(output);
+      }
+    } else {
+      shapes.push_back(call->args[2]);
+    }
+    if (func->params.size() < shapes.size()) {
+      return NullOpt;
+    }
+    ShapeBucket bucket;
+    std::unordered_map<const tir::VarNode*, int64_t> bound;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      auto it = func->buffer_map.find(func->params[i]);
+      std::vector<int64_t> shape;
+      if (shapes[i].defined()) {
+        shape = StaticShape(shapes[i]);
+      }
+      if (it == func->buffer_map.end() || shape.size() != (*it).second->shape.size()) {
+        return NullOpt;
+      }
+      const Array<PrimExpr>& dims = (*it).second->shape;
+      for (size_t j = 0; j < dims.size(); ++j) {
+        if (const auto* var = dims[j].as<tir::VarNode>()) {
+          auto bound_it = bound.find(var);
+          if (bound_it == bound.end()) {
+            bound[var] = shape[j];
+            bucket.emplace_back(GetRef<tir::Var>(var), shape[j]);
+          } else if (bound_it->second != shape[j]) {
+            return NullOpt;
+          }
+        }
+      }
+    }
+    if (bucket.empty()) {
+      return NullOpt;
+    }
+    std::string name = ShapeBucketName(gv->name_hint, bucket);
+    if (mod_->ContainGlobalVar(name)) {
+      return mod_->GetGlobalVar(name);
+    }
+    tir::PrimFunc specialized = SpecializeShapeBucket(GetRef<tir::PrimFunc>(func), bucket);
+    if (specialized->GetAttr<String>(tvm::attr::kGlobalSymbol).defined()) {
+      specialized = WithAttr(std::move(specialized), tvm::attr::kGlobalSymbol, String(name));
+    }
+    GlobalVar new_gv(name);
+    mod_->Add(new_gv, specialized);
+    return new_gv;
+  }
+
+  /*! \brief The module, to which the specialized PrimFuncs are added. */
+  IRModule mod_;
+  /*! \brief The shapes of the arguments. */
+  std::unordered_map<Id, ShapeTuple, ObjectPtrHash, ObjectPtrEqual> param_shapes_;
+  /*! \brief The values of the symbolic dims. */
+  Map<tir::Var, PrimExpr> dims_;
+  /*! \brief The analyzer simplifying the dims. */
+  arith::Analyzer analyzer_;
+};
+
+IRModule SpecializeShapes(IRModule mod, String func_name, Array<ObjectRef> shapes) {
+  Optional<GlobalVar> gv;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<FunctionNode>()) {
+      Optional<String> gsymbol = func->GetAttr<String>(tvm::attr::kGlobalSymbol);
+      if (kv.first->name_hint == func_name ||
+          (gsymbol.defined() && gsymbol.value() == func_name)) {
+        gv = kv.first;
+      }
+    }
+  }
+  CHECK(gv.defined()) << "ValueError: Unknown Relax function: " << func_name;
+  Function func = Downcast<Function>(mod->Lookup(gv.value()));
+  IRModule result = GetRef<IRModule>(mod.CopyOnWrite());
+  ShapeSpecializer specializer(result, func, shapes);
+  result->Update(gv.value(), Downcast<Function>(specializer.VisitExpr(func)));
+  return result;
+}
+
+namespace transform {
+
+Pass SpecializeShapes(String func_name, Array<ObjectRef> shapes) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) {
+        return relax::SpecializeShapes(std::move(mod), func_name, shapes);
+      };
+  return CreateModulePass(pass_func, 0, "SpecializeShapes", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.SpecializeShapes").set_body_typed(SpecializeShapes);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
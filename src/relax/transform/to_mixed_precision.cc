@@ -25,6 +25,11 @@
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "../op/make_op.h"
 
 namespace tvm {
@@ -41,10 +46,24 @@ enum MixedTypeConversionCategory : int {
 using FTVMMixedPrecisionConversionType = runtime::TypedPackedFunc<Array<ObjectRef>(
     const Call& call_node, const std::string& out_dtype_str)>;
 
+/*! \brief The per-op overrides of the default mixed precision conversions of the ops. */
+struct MixedPrecisionPolicy {
+  /*! \brief The low precision dtype, e.g. float16 or bfloat16. */
+  DataType low_precision_type = DataType::Float(16);
+  /*! \brief The ops always computed in low precision, overriding their conversion category. */
+  std::unordered_set<std::string> always_ops;
+  /*! \brief The ops never computed in low precision, overriding their conversion category. */
+  std::unordered_set<std::string> never_ops;
+  /*! \brief The output (accumulation) dtypes of the ops which differ from the default one. */
+  std::unordered_map<std::string, DataType> out_dtypes;
+};
+
 class ToMixedPrecisionMutator : public ExprMutator {
  public:
-  explicit ToMixedPrecisionMutator(DLDataType output_dtype)
-      : expected_output_dtype_(output_dtype) {}
+  explicit ToMixedPrecisionMutator(DLDataType output_dtype, MixedPrecisionPolicy policy)
+      : low_precision_type_(policy.low_precision_type),
+        expected_output_dtype_(output_dtype),
+        policy_(std::move(policy)) {}
 
   void InitVarMap(const relax::Function& func) {
     for (const auto& param : func->params) {
@@ -57,15 +76,7 @@ class ToMixedPrecisionMutator : public ExprMutator {
   // Visit the use-site of a defined Var
   Expr VisitExpr_(const VarNode* op) {
     if (const auto* type = op->checked_type_.as<DynTensorTypeNode>()) {
-      auto it = var_map_.find(GetRef<Var>(op));
-      ICHECK(it != var_map_.end());
-      auto type_it = it->second.find(runtime::DLDataType2String(type->dtype));
-      if (type_it != it->second.end()) {
-        return type_it->second;
-      } else {
-        relax::Var cur_var = it->second.begin()->second;
-        return builder_->Emit(MakeCast(cur_var, type->dtype));
-      }
+      return CastVarToType(GetRef<Var>(op), type->dtype);
     } else {
       return ExprMutator::VisitExpr_(op);
     }
@@ -74,15 +85,7 @@ class ToMixedPrecisionMutator : public ExprMutator {
   // Visit the use-site of a defined DataflowVar
   Expr VisitExpr_(const DataflowVarNode* op) {
     if (const auto* type = op->checked_type_.as<DynTensorTypeNode>()) {
-      auto it = var_map_.find(GetRef<Var>(op));
-      ICHECK(it != var_map_.end());
-      auto type_it = it->second.find(runtime::DLDataType2String(type->dtype));
-      if (type_it != it->second.end()) {
-        return type_it->second;
-      } else {
-        relax::Var cur_var = it->second.begin()->second;
-        return builder_->Emit(MakeCast(cur_var, type->dtype));
-      }
+      return CastVarToType(GetRef<Var>(op), type->dtype);
     } else {
       return ExprMutator::VisitExpr_(op);
     }
@@ -112,20 +115,36 @@ class ToMixedPrecisionMutator : public ExprMutator {
         Op op = Downcast<Op>(cur_op);
         const auto attr_map =
             Op::GetAttrMap<FTVMMixedPrecisionConversionType>("FTVMMixedPrecisionConversionType");
-        if (attr_map.count(op)) {
-          FTVMMixedPrecisionConversionType func = attr_map[op];
-          Array<ObjectRef> op_descriptor =
-              func(GetRef<Call>(call_node), DLDataType2String(expected_output_dtype_));
-          ICHECK(op_descriptor.size() == 3)
-              << "got the wrong number of returned arguments (expected 3 got "
-              << op_descriptor.size() << ") from FTVMMixedPrecisionConversionType for "
-              << AsText(op, false);
+        bool always = policy_.always_ops.count(op->name);
+        bool never = policy_.never_ops.count(op->name);
+        if (attr_map.count(op) || always || never) {
+          auto out_dtype_it = policy_.out_dtypes.find(op->name);
+          DataType out_dtype = out_dtype_it != policy_.out_dtypes.end()
+                                   ? out_dtype_it->second
+                                   : DataType(expected_output_dtype_);
+          MixedTypeConversionCategory category = MIXED_PRECISION_FOLLOW;
+          bool out_dtype_adjustable = false;
+          Call adjusted_call = GetRef<Call>(call_node);
+          if (attr_map.count(op)) {
+            FTVMMixedPrecisionConversionType func = attr_map[op];
+            Array<ObjectRef> op_descriptor =
+                func(GetRef<Call>(call_node), DLDataType2String(out_dtype));
+            ICHECK(op_descriptor.size() == 3)
+                << "got the wrong number of returned arguments (expected 3 got "
+                << op_descriptor.size() << ") from FTVMMixedPrecisionConversionType for "
+                << AsText(op, false);
 
-          int64_t op_conversion_type = Downcast<Integer>(op_descriptor[0])->value;
-          MixedTypeConversionCategory category =
-              static_cast<MixedTypeConversionCategory>(op_conversion_type);
-          bool out_dtype_adjustable = Downcast<Bool>(op_descriptor[1])->value;
-          Call adjusted_call = Downcast<Call>(op_descriptor[2]);
+            int64_t op_conversion_type = Downcast<Integer>(op_descriptor[0])->value;
+            category = static_cast<MixedTypeConversionCategory>(op_conversion_type);
+            out_dtype_adjustable = Downcast<Bool>(op_descriptor[1])->value;
+            adjusted_call = Downcast<Call>(op_descriptor[2]);
+          }
+          // The policy overrides the conversion category registered for the op.
+          if (always) {
+            category = MIXED_PRECISION_ALWAYS;
+          } else if (never) {
+            category = MIXED_PRECISION_NEVER;
+          }
           if (category == MIXED_PRECISION_ALWAYS) {
             // LOG(INFO) << "MIXED_PRECISION_ALWAYS";
             // Cast inputs to fp16
@@ -136,7 +155,7 @@ class ToMixedPrecisionMutator : public ExprMutator {
               relax::Var accmulate = emit(
                   relax::Call(call_node->op, new_args, adjusted_call->attrs, call_node->type_args),
                   binding->var);
-              if (expected_output_dtype_ != low_precision_type_) {
+              if (out_dtype != low_precision_type_) {
                 // LOG(INFO) << "RECAST";
                 relax::Var cast_back =
                     emit(relax::MakeCast(accmulate, low_precision_type_), binding->var);
@@ -227,44 +246,18 @@ class ToMixedPrecisionMutator : public ExprMutator {
     for (const relax::Expr arg : args) {
       // arg is a tensor
       if (const relax::VarNode* var_node = arg.as<relax::VarNode>()) {
-        auto it = var_map_.find(GetRef<Var>(var_node));
-        if (it != var_map_.end()) {
-          auto itt = it->second.find(runtime::DLDataType2String(to_type));
-          if (itt == it->second.end()) {
-            // the input var is never casted to to_type before
-            relax::Var cur_var = it->second.begin()->second;
-            relax::Var casted_var = builder_->Emit(relax::MakeCast(cur_var, to_type));
-            new_args->push_back(casted_var);
-            UpdateVarMap(GetRef<Var>(var_node), to_type, casted_var);
-          } else {
-            // the input var is already casted to to_type before
-            new_args->push_back(itt->second);
-          }
+        if (var_map_.count(GetRef<Var>(var_node))) {
+          new_args->push_back(CastVarToType(GetRef<Var>(var_node), to_type));
         } else {
           auto itt = const_map_.find(GetRef<Var>(var_node));
           if (itt != const_map_.end()) {
-            if (DLDataType2String(
-                    itt->second->checked_type().as<relax::DynTensorTypeNode>()->dtype) ==
-                runtime::DLDataType2String(to_type)) {
-              new_args->push_back(itt->second);
-            } else {
-              relax::Var casted_var = builder_->Emit(relax::MakeCast(itt->second, to_type));
-              new_args->push_back(casted_var);
-            }
+            new_args->push_back(CastConstantToType(itt->second, to_type));
           } else {
             LOG(FATAL) << "Unknown var " << GetRef<Var>(var_node);
           }
         }
       } else if (const relax::ConstantNode* const_node = arg.as<relax::ConstantNode>()) {
-        if (DataType(const_node->data->dtype) != to_type) {
-          // the input constant is not of the right type
-          // we need to cast it
-          relax::Var casted_const =
-              builder_->Emit(relax::MakeCast(GetRef<Constant>(const_node), to_type));
-          new_args->push_back(casted_const);
-        } else {
-          new_args->push_back(arg);
-        }
+        new_args->push_back(CastConstantToType(GetRef<Constant>(const_node), to_type));
       } else if (const relax::TupleNode* tuple_node = arg.as<relax::TupleNode>()) {
         // the input is a tuple
         std::vector<Expr> new_tuple;
@@ -277,6 +270,40 @@ class ToMixedPrecisionMutator : public ExprMutator {
     // LOG(INFO) << "Done Casting";
   }
 
+  /*!
+   * \brief Get the value of a var in a dtype, casting it at most once for each dtype.
+   * \note The casted values are cached, so that a tensor used by several ops in the same dtype is
+   * not casted at each use site.
+   */
+  Var CastVarToType(const Var& var, DataType to_type) {
+    auto it = var_map_.find(var);
+    ICHECK(it != var_map_.end()) << "Unknown var " << var;
+    auto itt = it->second.find(runtime::DLDataType2String(to_type));
+    if (itt != it->second.end()) {
+      // the input var is already casted to to_type before
+      return itt->second;
+    }
+    // the input var is never casted to to_type before
+    relax::Var cur_var = it->second.begin()->second;
+    relax::Var casted_var = builder_->Emit(relax::MakeCast(cur_var, to_type));
+    UpdateVarMap(var, to_type, casted_var);
+    return casted_var;
+  }
+
+  /*! \brief Get a constant in a dtype, casting it at most once for each dtype. */
+  Expr CastConstantToType(const Constant& constant, DataType to_type) {
+    if (DataType(constant->data->dtype) == to_type) {
+      return constant;
+    }
+    std::unordered_map<std::string, Var>& casted = const_cast_map_[constant];
+    std::string type_str = runtime::DLDataType2String(to_type);
+    auto it = casted.find(type_str);
+    if (it == casted.end()) {
+      it = casted.emplace(type_str, builder_->Emit(relax::MakeCast(constant, to_type))).first;
+    }
+    return it->second;
+  }
+
   void UpdateVarMap(const Var& var, DataType from_type, const Var& casted_var) {
     // LOG(INFO) << "UpdateVarMap: " << var << " from_type: " << from_type
     // << " casted_var: " << casted_var << " "
@@ -292,32 +319,55 @@ class ToMixedPrecisionMutator : public ExprMutator {
     }
   }
 
-  DataType low_precision_type_ = DataType(DataType::TypeCode::kFloat, 16, 1);
+  DataType low_precision_type_;
   DataType full_precision_type_ = DataType(DataType::TypeCode::kFloat, 32, 1);
   std::unordered_map<relax::Var, std::unordered_map<std::string, relax::Var>, ObjectPtrHash,
                      ObjectPtrEqual>
       var_map_;
   std::unordered_map<relax::Var, relax::Constant, ObjectPtrHash, ObjectPtrEqual> const_map_;
+  /*! \brief The casts of each constant, by the dtype casted to. */
+  std::unordered_map<relax::Constant, std::unordered_map<std::string, relax::Var>, ObjectPtrHash,
+                     ObjectPtrEqual>
+      const_cast_map_;
   DataType expected_output_dtype_;
+  MixedPrecisionPolicy policy_;
 };  // namespace relax
 
-Expr ToMixedPrecision(const relax::Function& f, const runtime::String& out_dtype) {
-  ToMixedPrecisionMutator mutator(runtime::String2DLDataType(out_dtype));
+Expr ToMixedPrecision(const relax::Function& f, const runtime::String& out_dtype,
+                      MixedPrecisionPolicy policy) {
+  ToMixedPrecisionMutator mutator(runtime::String2DLDataType(out_dtype), std::move(policy));
   mutator.InitVarMap(f);
   return mutator.VisitExpr(f);
 }
 
 namespace transform {
 
-Pass ToMixedPrecisionPass(const runtime::String& out_dtype) {
+Pass ToMixedPrecision(const runtime::String& out_dtype, const runtime::String& low_precision_dtype,
+                      Array<runtime::String> always_ops, Array<runtime::String> never_ops,
+                      Map<runtime::String, runtime::String> op_out_dtypes) {
+  MixedPrecisionPolicy policy;
+  policy.low_precision_type = DataType(runtime::String2DLDataType(low_precision_dtype));
+  ICHECK(policy.low_precision_type.is_float() || policy.low_precision_type.is_bfloat16())
+      << "The low precision dtype must be a float type, but got " << low_precision_dtype;
+  for (const runtime::String& op : always_ops) {
+    policy.always_ops.insert(op);
+  }
+  for (const runtime::String& op : never_ops) {
+    ICHECK(!policy.always_ops.count(op))
+        << "The op " << op << " cannot be both always and never in low precision";
+    policy.never_ops.insert(op);
+  }
+  for (const auto& kv : op_out_dtypes) {
+    policy.out_dtypes.emplace(kv.first, DataType(runtime::String2DLDataType(kv.second)));
+  }
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ToMixedPrecision(f, out_dtype));
+        return Downcast<Function>(relax::ToMixedPrecision(f, out_dtype, policy));
       };
   return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
 }
 
-TVM_REGISTER_GLOBAL("relax.transform.ToMixedPrecision").set_body_typed(ToMixedPrecisionPass);
+TVM_REGISTER_GLOBAL("relax.transform.ToMixedPrecision").set_body_typed(ToMixedPrecision);
 
 }  // namespace transform
 
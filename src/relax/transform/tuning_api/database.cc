@@ -23,10 +23,12 @@
  */
 #include <tvm/relax/tuning_api.h>
 
+#include <map>
 #include <set>
 #include <thread>
 #include <unordered_map>
 
+#include "../../../meta_schedule/database/record_log.h"
 #include "../../../meta_schedule/utils.h"
 
 namespace tvm {
@@ -105,6 +107,19 @@ inline std::string get_database_key(int workload_idx, Target target) {
   return std::to_string(workload_idx) + "/" + target->str();
 }
 
+/*! \brief Whether two traces make the same decisions on the knobs of the same names. */
+inline bool SameDecisions(const Trace& a, const Trace& b) {
+  if (a->size != b->size) {
+    return false;
+  }
+  for (int i = 0; i < a->size; i++) {
+    if (a->knobs[i]->name != b->knobs[i]->name || a->decisions[i] != b->decisions[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*! \brief The default database implementation, which mimics two database tables with two files.
  */
 class JSONDatabaseNode : public DatabaseNode {
@@ -222,6 +237,21 @@ class JSONDatabaseNode : public DatabaseNode {
     return results;
   }
 
+  Optional<TuningRecord> GetTuningRecord(const meta_schedule::Workload& workload,
+                                         const Target& target, const Trace& trace) {
+    int idx = this->workloads2idx_.at(workload);
+    auto it = this->tuning_records_.find(get_database_key(idx, target));
+    if (it == this->tuning_records_.end()) {
+      return NullOpt;
+    }
+    for (const TuningRecord& record : it->second) {
+      if (SameDecisions(record->trace, trace)) {
+        return record;
+      }
+    }
+    return NullOpt;
+  }
+
   Array<FloatImm> GetMeasurementRecord(const meta_schedule::Workload& workload,
                                        const Target target) {
     int workload_idx = this->workloads2idx_.at(workload);
@@ -316,6 +346,242 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
   return Database(n);
 }
 
+/*!
+ * \brief The database on the indexed append-only logs shared with the meta schedule, which opens by
+ * reading the indices only, parses the records on demand, and is shared by the tuners appending to
+ * it at the same time. As in the JSON database, the records are keyed by the positions of their
+ * workloads, found by structural equality, and their targets. The index holds the hash of the key,
+ * and each record stores the key itself to tell apart the ones whose keys share a hash.
+ */
+class IndexedDatabaseNode : public DatabaseNode {
+ public:
+  using Entry = meta_schedule::RecordLog::Entry;
+
+  /*! \brief The path prefix of the logs. */
+  String path;
+  /*! \brief The log of the workloads. */
+  std::unique_ptr<meta_schedule::RecordLog> workload_log_;
+  /*! \brief The log of the tuning records. */
+  std::unique_ptr<meta_schedule::RecordLog> tuning_record_log_;
+  /*! \brief The log of the measurement records. */
+  std::unique_ptr<meta_schedule::RecordLog> measurement_record_log_;
+  /*! \brief The workloads in the order of the log, parsed on demand. */
+  std::vector<std::pair<Entry, Optional<meta_schedule::Workload>>> workloads_;
+  /*! \brief The positions of the workloads in the log by their hashes. */
+  std::unordered_map<uint64_t, std::vector<int64_t>> workload_ids_;
+  /*! \brief The tuning records by the hashes of their keys, sorted by the run time. */
+  std::unordered_map<uint64_t, std::multimap<double, Entry>> tuning_records_;
+  /*! \brief The measurement records by the hashes of their keys. */
+  std::unordered_map<uint64_t, std::vector<Entry>> measurement_records_;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path", &path);
+    // `workload_log_` is not visited
+    // `tuning_record_log_` is not visited
+    // `measurement_record_log_` is not visited
+    // `workloads_` is not visited
+    // `workload_ids_` is not visited
+    // `tuning_records_` is not visited
+    // `measurement_records_` is not visited
+  }
+
+  static constexpr const char* _type_key = "relax.tuning_api.IndexedDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(IndexedDatabaseNode, DatabaseNode);
+
+ public:
+  bool HasWorkload(const IRModule& mod) {
+    return FindWorkload(meta_schedule::Workload(mod, tvm::StructuralHash()(mod))) >= 0;
+  }
+
+  bool HasMeasurementRecord(const meta_schedule::Workload& workload, const Target& target) {
+    return GetMeasurementRecord(workload, target).size() > 0;
+  }
+
+  bool HasTuningRecord(const meta_schedule::Workload& workload, const Target& target) {
+    return GetTopK(workload, target, 1).size() > 0;
+  }
+
+  meta_schedule::Workload CommitWorkload(const IRModule& mod) {
+    meta_schedule::Workload workload(mod, tvm::StructuralHash()(mod));
+    int64_t id = FindWorkload(workload);
+    if (id < 0) {
+      std::string json = meta_schedule::JSONDumps(workload->AsJSON());
+      workload_log_->Append(workload->shash, 0.0, json);
+      Sync();
+      // Find the slot just appended, which may come along with the ones appended by others
+      for (int64_t i : workload_ids_[workload->shash]) {
+        auto& slot = workloads_[i];
+        if (!slot.second.defined() && workload_log_->Read(slot.first) == json) {
+          slot.second = workload;
+          break;
+        }
+      }
+      // An equal workload appended by others before this one is used by all
+      id = FindWorkload(workload);
+      ICHECK_GE(id, 0);
+    }
+    return workloads_[id].second.value();
+  }
+
+  void CommitMeasurementRecord(const meta_schedule::Workload& workload, const Target& target,
+                               const Array<FloatImm>& run_secs) {
+    std::string key = GetKey(workload, target);
+    CHECK(!key.empty()) << "ValueError: The workload is not committed to " << path;
+    if (HasMeasurementRecord(workload, target)) {
+      LOG(WARNING) << "Measurement record for " << key
+                   << " already exists. Use the existing one instead.";
+      return;
+    }
+    measurement_record_log_->Append(
+        std::hash<std::string>()(key), 0.0,
+        meta_schedule::JSONDumps(Array<ObjectRef>{String(key), run_secs}));
+  }
+
+  void CommitTuningRecord(const meta_schedule::Workload& workload, const Target& target,
+                          const TuningRecord& record) {
+    std::string key = GetKey(workload, target);
+    CHECK(!key.empty()) << "ValueError: The workload is not committed to " << path;
+    tuning_record_log_->Append(
+        std::hash<std::string>()(key),
+        SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({})),
+        meta_schedule::JSONDumps(Array<ObjectRef>{String(key), record->AsJSON()}));
+  }
+
+  Array<TuningRecord> GetTopK(const meta_schedule::Workload& workload, const Target& target,
+                              int top_k) {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    if (top_k == 0) {
+      return {};
+    }
+    std::string key = GetKey(workload, target);
+    Array<TuningRecord> results;
+    auto it = tuning_records_.find(std::hash<std::string>()(key));
+    if (it == tuning_records_.end()) {
+      return results;
+    }
+    results.reserve(top_k);
+    for (const auto& kv : it->second) {
+      if (Optional<ObjectRef> json = ReadRecord(tuning_record_log_.get(), kv.second, key)) {
+        results.push_back(TuningRecord::FromJSON(json.value()));
+        if (static_cast<int>(results.size()) == top_k) {
+          break;
+        }
+      }
+    }
+    return results;
+  }
+
+  Optional<TuningRecord> GetTuningRecord(const meta_schedule::Workload& workload,
+                                         const Target& target, const Trace& trace) {
+    std::string key = GetKey(workload, target);
+    auto it = tuning_records_.find(std::hash<std::string>()(key));
+    if (it == tuning_records_.end()) {
+      return NullOpt;
+    }
+    for (const auto& kv : it->second) {
+      if (Optional<ObjectRef> json = ReadRecord(tuning_record_log_.get(), kv.second, key)) {
+        TuningRecord record = TuningRecord::FromJSON(json.value());
+        if (SameDecisions(record->trace, trace)) {
+          return record;
+        }
+      }
+    }
+    return NullOpt;
+  }
+
+  Array<FloatImm> GetMeasurementRecord(const meta_schedule::Workload& workload,
+                                       const Target target) {
+    std::string key = GetKey(workload, target);
+    auto it = measurement_records_.find(std::hash<std::string>()(key));
+    if (it == measurement_records_.end()) {
+      return {};
+    }
+    // The first measurement record of a key is kept
+    for (const Entry& entry : it->second) {
+      if (Optional<ObjectRef> json = ReadRecord(measurement_record_log_.get(), entry, key)) {
+        return meta_schedule::AsFloatArray(json.value());
+      }
+    }
+    return {};
+  }
+
+ private:
+  /*!
+   * \brief Get the key of the records of a workload and a target, which syncs the logs. A workload
+   * not in the database gets no records.
+   */
+  std::string GetKey(const meta_schedule::Workload& workload, const Target& target) {
+    int64_t id = FindWorkload(workload);
+    return id < 0 ? std::string() : get_database_key(id, target);
+  }
+
+  /*!
+   * \brief Index the entries appended since the last sync. The records are synced first, so that
+   * the workloads they refer to, which are appended before them, are synced along.
+   */
+  void Sync() {
+    for (const Entry& entry : tuning_record_log_->Sync()) {
+      tuning_records_[entry.key].emplace(entry.score, entry);
+    }
+    for (const Entry& entry : measurement_record_log_->Sync()) {
+      measurement_records_[entry.key].push_back(entry);
+    }
+    for (const Entry& entry : workload_log_->Sync()) {
+      workload_ids_[entry.key].push_back(workloads_.size());
+      workloads_.emplace_back(entry, NullOpt);
+    }
+  }
+
+  /*!
+   * \brief Read a record of a log.
+   * \return The record, or NullOpt if it is of another key sharing the hash.
+   */
+  static Optional<ObjectRef> ReadRecord(meta_schedule::RecordLog* log, const Entry& entry,
+                                        const std::string& key) {
+    Array<ObjectRef> json = Downcast<Array<ObjectRef>>(meta_schedule::JSONLoads(log->Read(entry)));
+    ICHECK_EQ(json.size(), 2);
+    if (Downcast<String>(json[0]) != key) {
+      return NullOpt;
+    }
+    return json[1];
+  }
+
+  /*!
+   * \brief Find the first workload in the log structurally equal to the given one.
+   * \return The position of the workload in the log, or -1 if it is not found.
+   */
+  int64_t FindWorkload(const meta_schedule::Workload& workload) {
+    Sync();
+    auto it = workload_ids_.find(workload->shash);
+    if (it == workload_ids_.end()) {
+      return -1;
+    }
+    for (int64_t id : it->second) {
+      auto& slot = workloads_[id];
+      if (!slot.second.defined()) {
+        slot.second = meta_schedule::Workload::FromJSON(
+            meta_schedule::JSONLoads(workload_log_->Read(slot.first)));
+      }
+      if (WorkloadEqual()(slot.second.value(), workload)) {
+        return id;
+      }
+    }
+    return -1;
+  }
+};
+
+Database Database::IndexedDatabase(String path, int num_shards, bool allow_missing) {
+  ObjectPtr<IndexedDatabaseNode> n = make_object<IndexedDatabaseNode>();
+  n->path = path;
+  n->workload_log_ =
+      std::make_unique<meta_schedule::RecordLog>(path + "_workload", 1, allow_missing);
+  n->tuning_record_log_ = std::make_unique<meta_schedule::RecordLog>(path + "_tuning_record",
+                                                                     num_shards, allow_missing);
+  n->measurement_record_log_ = std::make_unique<meta_schedule::RecordLog>(
+      path + "_measurement_record", num_shards, allow_missing);
+  return Database(n);
+}
+
 /**************** FFI ****************/
 TVM_REGISTER_NODE_TYPE(TuningRecordNode);
 TVM_REGISTER_GLOBAL("relax.tuning_api.TuningRecord")
@@ -341,10 +607,15 @@ TVM_REGISTER_GLOBAL("relax.tuning_api.DatabaseCommitTuningRecord")
     .set_body_method<Database>(&DatabaseNode::CommitTuningRecord);
 TVM_REGISTER_GLOBAL("relax.tuning_api.DatabaseGetTopK")
     .set_body_method<Database>(&DatabaseNode::GetTopK);
+TVM_REGISTER_GLOBAL("relax.tuning_api.DatabaseGetTuningRecord")
+    .set_body_method<Database>(&DatabaseNode::GetTuningRecord);
 TVM_REGISTER_GLOBAL("relax.tuning_api.DatabaseGetMeasurementRecord")
     .set_body_method<Database>(&DatabaseNode::GetMeasurementRecord);
 
 TVM_REGISTER_NODE_TYPE(JSONDatabaseNode);
 TVM_REGISTER_GLOBAL("relax.tuning_api.DatabaseJSONDatabase").set_body_typed(Database::JSONDatabase);
+TVM_REGISTER_NODE_TYPE(IndexedDatabaseNode);
+TVM_REGISTER_GLOBAL("relax.tuning_api.DatabaseIndexedDatabase")
+    .set_body_typed(Database::IndexedDatabase);
 }  // namespace relax
 }  // namespace tvm
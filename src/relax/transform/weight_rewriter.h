@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file weight_rewriter.h
+ * \brief The rewrite of the dense layers of constant weights, shared by the passes which
+ *  compress the weights at compile time.
+ */
+
+#ifndef TVM_RELAX_TRANSFORM_WEIGHT_REWRITER_H_
+#define TVM_RELAX_TRANSFORM_WEIGHT_REWRITER_H_
+
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+
+#include <utility>
+
+#include "../op/make_op.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief A mutator which rewrites the dense and matmul calls of constant weights.
+ *
+ * The weights of the matmul calls, of shape (k, n), are transposed first, so that a subclass
+ * rewrites the dense of the data by the weights of shape (n, k) in any case.
+ */
+class ConstantWeightDenseRewriter : public ExprMutator {
+ public:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* call) final {
+    Call new_call = Downcast<Call>(VisitExprPostOrder_(call));
+    static const Op& dense_op = Op::Get("relax.nn.dense");
+    static const Op& matmul_op = Op::Get("relax.nn.matmul");
+
+    DataType out_dtype;
+    if (new_call->op.same_as(dense_op)) {
+      out_dtype = new_call->attrs.as<DenseAttrs>()->out_dtype;
+    } else if (new_call->op.same_as(matmul_op)) {
+      out_dtype = new_call->attrs.as<MatmulAttrs>()->out_dtype;
+    } else {
+      return std::move(new_call);
+    }
+    bool transpose = new_call->op.same_as(matmul_op);
+    const auto* weight = new_call->args[1].as<ConstantNode>();
+    if (weight == nullptr || !IsRewritable(weight->data, transpose)) {
+      return std::move(new_call);
+    }
+
+    Expr w = new_call->args[1];
+    if (transpose) {
+      w = builder_->Emit(MakeTranspose(w, NullOpt));
+    }
+    return RewriteDense(new_call->args[0], w, out_dtype);
+  }
+
+ protected:
+  /*!
+   * \brief Whether to rewrite the call of a constant weight.
+   * \param weight The weight.
+   * \param transpose Whether the weight is of shape (k, n), as the weight of a matmul.
+   */
+  virtual bool IsRewritable(const runtime::NDArray& weight, bool transpose) const = 0;
+
+  /*!
+   * \brief Rewrite the dense of the data by a constant weight, emitting its preprocessing.
+   * \param data The data.
+   * \param weight The weight, of shape (n, k).
+   * \param out_dtype The output dtype of the call.
+   * \return The expression of the result of the call.
+   */
+  virtual Expr RewriteDense(const Expr& data, const Expr& weight, DataType out_dtype) = 0;
+};
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_TRANSFORM_WEIGHT_REWRITER_H_
@@ -199,6 +199,34 @@ void GraphPartitioner::CommitFuse(IndexedForwardGraph::Node* src, IndexedForward
   CommitFuse_(src, sink, target);
 }
 
+bool GraphPartitioner::CheckCommit(const IndexedForwardGraph& graph,
+                                   IndexedForwardGraph::Node* src,
+                                   IndexedForwardGraph::Node* sink) {
+  if (fcommit_ == nullptr) return true;
+  // The fusion merges the groups of all the nodes from src to sink.
+  std::unordered_set<Group*> merged;
+  std::unordered_set<IndexedForwardGraph::Node*> visited{src};
+  std::vector<IndexedForwardGraph::Node*> stack{src};
+  while (!stack.empty()) {
+    IndexedForwardGraph::Node* node = stack.back();
+    stack.pop_back();
+    merged.insert(groups_[node->index]->FindRoot());
+    if (node == sink) continue;
+    for (auto link = node->outputs.head; link != nullptr; link = link->next) {
+      if (visited.insert(link->value.node).second) {
+        stack.push_back(link->value.node);
+      }
+    }
+  }
+  std::vector<const tvm::Object*> refs;
+  for (size_t nid = 0; nid < groups_.size(); ++nid) {
+    if (merged.count(groups_[nid]->FindRoot())) {
+      refs.push_back(graph.post_dfs_order[nid]->ref);
+    }
+  }
+  return fcommit_(refs);
+}
+
 size_t GraphPartitioner::CountNodesUptoSink_(IndexedForwardGraph::Node* src,
                                              IndexedForwardGraph::Node* sink) {
   if (src == sink || visited_.count(src)) return 0;
@@ -267,7 +295,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
         // dom_root_group can also be tuple, as in inception layers
         // CheckPath is needed to avoid fusing two intermediate tuples
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            CheckCommit(graph, graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -290,7 +319,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
         ICHECK(dom_node->parent->gnode != nullptr);
         // The fuse can be executed if all the intermediate ops are still broadcast.
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kBroadcast; };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            CheckCommit(graph, graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -310,7 +340,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
                     kind == kOutEWiseFusable);
           }
         };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            CheckCommit(graph, graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -320,7 +351,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
       if (phase != 1) continue;
       // Check if all path are injective.
       auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
-      if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+      if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+          CheckCommit(graph, graph_node, dom_node->parent->gnode)) {
         CommitFuse(graph_node, dom_node->parent->gnode);
       }
     } else {
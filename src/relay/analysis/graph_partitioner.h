@@ -24,6 +24,11 @@
 
 #include <tvm/relay/op_attr_types.h>
 
+#include <functional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "../../support/arena.h"
 
 namespace tvm {
@@ -154,8 +159,19 @@ class DominatorTree {
 
 class GraphPartitioner {
  public:
-  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth)
-      : arena_(arena), opt_level_(opt_level), max_fuse_depth_(max_fuse_depth) {}
+  /*!
+   * \brief The callback deciding whether to commit a fusion, given the references of the nodes
+   * in the group which the fusion would create, in post-dfs order. The fusion is committed when it
+   * returns true.
+   */
+  using FCommit = std::function<bool(const std::vector<const tvm::Object*>&)>;
+
+  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
+                            FCommit fcommit = nullptr)
+      : arena_(arena),
+        opt_level_(opt_level),
+        max_fuse_depth_(max_fuse_depth),
+        fcommit_(std::move(fcommit)) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -195,6 +211,8 @@ class GraphPartitioner {
   int opt_level_;
   /*! \brief The maximum number of operations in one fused function */
   size_t max_fuse_depth_;
+  /*! \brief The optional callback deciding whether to commit a fusion. */
+  FCommit fcommit_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -236,6 +254,16 @@ class GraphPartitioner {
    */
   void CommitFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
 
+  /*!
+   * \brief Check whether the callback, if any, accepts a fusion.
+   * \param graph The graph being partitioned.
+   * \param src The source node.
+   * \param sink The termination node.
+   * \note sink must be a post-dominator of src.
+   */
+  bool CheckCommit(const IndexedForwardGraph& graph, IndexedForwardGraph::Node* src,
+                   IndexedForwardGraph::Node* sink);
+
   size_t CountNodesUptoSink_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
 
   // Count the number of nodes in a fused subgraph if child is additionally fused.
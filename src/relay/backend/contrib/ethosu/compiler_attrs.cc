@@ -41,6 +41,7 @@ struct EthosUCompilerConfigNode : public tvm::AttrsNode<EthosUCompilerConfigNode
   String accelerator_config;
   bool enable_cascader;
   bool enable_striping;
+  String cache_dir;
   String dev_force_block_config;
   String dev_max_open_plans;
   String dev_max_closed_plans;
@@ -62,6 +63,11 @@ struct EthosUCompilerConfigNode : public tvm::AttrsNode<EthosUCompilerConfigNode
     TVM_ATTR_FIELD(enable_striping)
         .describe("Whether the cascader should be striping")
         .set_default(false);
+    TVM_ATTR_FIELD(cache_dir)
+        .describe(
+            "The directory of the cache of the encoded weights and of the cascader plans, which "
+            "are reused across builds; they are only cached in memory if empty")
+        .set_default("");
     String dev_warning = "Option is intended for development and debugging purposes only. ";
     TVM_ATTR_FIELD(dev_force_block_config)
         .describe((dev_warning + String("Force the block config to a given value; format = "
@@ -33,7 +33,9 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -42,6 +44,7 @@
 #include "../op/memory/device_copy.h"
 #include "../transforms/device_aware_visitors.h"
 #include "./te_compiler.h"
+#include "./token_allocator.h"
 #include "./utils.h"
 
 namespace tvm {
@@ -49,9 +52,16 @@ namespace relay {
 
 // TODO(@jroesch, @csullivan): declare directly elsewhere
 backend::StaticMemoryPlan GraphPlanMemory(const Function& func);
+backend::StaticMemoryPlan GraphPlanMemory(const Function& func, bool reuse_storage);
 
 namespace backend {
 
+/*!
+ * \brief The pass config option placing the storages of each device of the graph executor in one
+ *  arena, at byte offsets planned by the lifetimes of the tensors.
+ */
+constexpr const char* kGraphMemoryArenaOption = "relay.backend.graph_memory_arena";
+
 class GraphNode;
 class GraphInputNode;
 class GraphOpNode;
@@ -86,6 +96,9 @@ class GraphNodeRef {
 
   inline void Load(dmlc::JSONReader* reader) { LOG(FATAL) << "Not implemented."; }
 
+  int ident() const { return ident_; }
+  int index() const { return index_; }
+
  protected:
   int ident_;
   int index_{0};
@@ -191,7 +204,11 @@ class GraphOpNode : public GraphNode {
 class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<GraphNodeRef>> {
  public:
   GraphExecutorCodegen(runtime::Module* mod, const Array<Target>& targets)
-      : mod_(mod), config_(transform::PassContext::Current(), targets) {}
+      : mod_(mod), config_(transform::PassContext::Current(), targets) {
+    memory_arena_ = transform::PassContext::Current()
+                        ->GetConfig<Bool>(kGraphMemoryArenaOption, Bool(false))
+                        .value();
+  }
 
   StorageInfo GetStorageInfo(const Expr& e) {
     size_t count = memory_plan_->expr_to_storage_info.count(e);
@@ -242,7 +259,9 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     //
     // We need to unfortunately re-plan as the previous results have been invalidated by lowering
     // we will fix this in future refactors.
-    memory_plan_ = GraphPlanMemory(lowered_main_func);
+    // The tensors placed in an arena have storages of their own, which the arena overlaps by
+    // their lifetimes instead of reusing the storages whole.
+    memory_plan_ = GraphPlanMemory(lowered_main_func, !memory_arena_);
 
     // The graph planner also can not handle planning calls to global variables to we must remap
 
@@ -569,6 +588,12 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       node_row_ptr.push_back(num_entry);
     }
 
+    std::vector<int64_t> storage_offsets;
+    if (memory_arena_) {
+      storage_offsets = PlanStorageOffsets(shapes, dltypes, storage_ids, storage_scopes,
+                                           device_types, node_row_ptr);
+    }
+
     // verification if storage_scope contains any non global memory scope
     // in other case it's better not to write scopes to the JSON at all
     bool global_only_scope = true;
@@ -597,6 +622,10 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       attrs["storage_scope"].emplace_back(std::string("list_str"));
       attrs["storage_scope"].emplace_back(storage_scopes);
     }
+    if (storage_offsets.size()) {
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+    }
     attrs["dltype"].emplace_back(std::string("list_str"));
     attrs["dltype"].emplace_back(dltypes);
     writer->WriteObjectKeyValue("attrs", attrs);
@@ -604,6 +633,94 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     writer->EndObject();
   }
 
+  /*!
+   * \brief Place the storages of the global scope of each device in one arena, overlapping the
+   *  storages not live at the same time.
+   *
+   *  A storage is live from the first to the last operator writing or reading it, and the inputs,
+   *  the params and the outputs of the graph all along.
+   *
+   * \return The offset of the storage of each entry in the arena of its device, or -1 for the
+   *  storages of the other scopes, which are allocated on their own.
+   */
+  std::vector<int64_t> PlanStorageOffsets(const ShapeVector& shapes,
+                                          const std::vector<std::string>& dltypes,
+                                          const std::vector<size_t>& storage_ids,
+                                          const std::vector<std::string>& storage_scopes,
+                                          const std::vector<size_t>& device_types,
+                                          const std::vector<size_t>& node_row_ptr) {
+    size_t num_storages = 0;
+    for (size_t sid : storage_ids) {
+      num_storages = std::max(num_storages, sid + 1);
+    }
+    int64_t end = static_cast<int64_t>(nodes_.size());
+    std::vector<ArenaBlock> blocks(num_storages, ArenaBlock{0, end, -1, 0});
+    std::vector<bool> in_arena(num_storages, true);
+    std::vector<size_t> storage_devices(num_storages, 0);
+    auto use = [&](size_t eid, int64_t index) {
+      ArenaBlock& block = blocks[storage_ids[eid]];
+      block.first_use = std::min(block.first_use, index);
+      block.last_use = std::max(block.last_use, index);
+    };
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      bool is_input = nodes_[nid]->Type() == kGraphInputNode;
+      for (size_t eid = node_row_ptr[nid]; eid < node_row_ptr[nid + 1]; ++eid) {
+        use(eid, is_input ? 0 : nid);
+        if (is_input) {
+          use(eid, end);
+        }
+      }
+      if (nodes_[nid]->Type() == kGraphOpNode) {
+        for (const GraphNodeRef& input : static_cast<GraphOpNode*>(nodes_[nid].get())->inputs_) {
+          use(node_row_ptr[input.ident()] + input.index(), nid);
+        }
+      }
+    }
+    for (const GraphNodeRef& head : heads_) {
+      use(node_row_ptr[head.ident()] + head.index(), end);
+    }
+    for (size_t eid = 0; eid < storage_ids.size(); ++eid) {
+      size_t sid = storage_ids[eid];
+      if (!storage_scopes[eid].empty() && storage_scopes[eid] != "global") {
+        in_arena[sid] = false;
+      }
+      if (!device_types.empty()) {
+        storage_devices[sid] = device_types[eid];
+      }
+      DataType dtype(runtime::String2DLDataType(dltypes[eid]));
+      size_t size = TokenAllocator1D::DivRoundUp(dtype.bits() * dtype.lanes(), 8);
+      for (int64_t dim : shapes[eid]) {
+        size *= static_cast<size_t>(dim);
+      }
+      blocks[sid].size = std::max(blocks[sid].size, size);
+    }
+    // The storages of each device, by storage id.
+    std::map<size_t, std::vector<size_t>> arenas;
+    for (size_t sid = 0; sid < num_storages; ++sid) {
+      if (in_arena[sid]) {
+        arenas[storage_devices[sid]].push_back(sid);
+      }
+    }
+    std::vector<int64_t> storage_offsets(num_storages, -1);
+    for (const auto& kv : arenas) {
+      std::vector<ArenaBlock> arena_blocks;
+      for (size_t sid : kv.second) {
+        arena_blocks.push_back(blocks[sid]);
+      }
+      size_t arena_size = PlanArenaOffsets(&arena_blocks, runtime::kAllocAlignment);
+      VLOG(1) << "arena of device " << kv.first << ": " << arena_size << " bytes for "
+              << arena_blocks.size() << " storages";
+      for (size_t i = 0; i < kv.second.size(); ++i) {
+        storage_offsets[kv.second[i]] = arena_blocks[i].offset;
+      }
+    }
+    std::vector<int64_t> entry_offsets;
+    for (size_t sid : storage_ids) {
+      entry_offsets.push_back(storage_offsets[sid]);
+    }
+    return entry_offsets;
+  }
+
  protected:
   /*! \brief nodes */
   std::vector<GraphObjectPtr> nodes_;
@@ -625,6 +742,8 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
   std::unordered_map<std::string, int64_t> param_storage_ids_;
   /*! \brief plan memory of device result */
   StaticMemoryPlan memory_plan_;
+  /*! \brief Whether the storages of each device are placed in one arena. */
+  bool memory_arena_{false};
   /*! \brief the module name we use to mangle the function names */
   String mod_name_;
   /*! \brief function metadata */
@@ -708,6 +827,8 @@ runtime::Module CreateGraphCodegenMod() {
 TVM_REGISTER_GLOBAL("relay.build_module._GraphExecutorCodegen")
     .set_body([](TVMArgs args, TVMRetValue* rv) { *rv = CreateGraphCodegenMod(); });
 
+TVM_REGISTER_PASS_CONFIG_OPTION(kGraphMemoryArenaOption, Bool);
+
 }  // namespace backend
 }  // namespace relay
 }  // namespace tvm
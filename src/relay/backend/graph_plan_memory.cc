@@ -211,7 +211,11 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
 /*! \brief Associate storage with every expression, reusing storage where possible. */
 class StorageAllocator : public StorageAllocaBaseVisitor {
  public:
-  StorageAllocator() = default;
+  /*!
+   * \param reuse_storage Whether the tensors reuse the storages of the dead ones. Otherwise each
+   *  tensor has a storage of its own, e.g. to be placed in an arena by their lifetimes.
+   */
+  explicit StorageAllocator(bool reuse_storage = true) : allocator_(reuse_storage) {}
 
   /*!
    * \return total number of bytes allocated
@@ -356,11 +360,15 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
 
   class TokenAllocator {
    public:
+    explicit TokenAllocator(bool reuse_storage) : reuse_storage_(reuse_storage) {}
     StorageToken* Alloc(StorageToken* proto) {
       return Is2DStorage(proto) ? token_2d_.Alloc(proto, storage_ids_++)
                                 : token_1d_.Alloc(proto, storage_ids_++);
     }
     StorageToken* Request(StorageToken* proto) {
+      if (!reuse_storage_) {
+        return this->Alloc(proto);
+      }
       StorageToken* token =
           Is2DStorage(proto) ? token_2d_.Request(proto) : token_1d_.Request(proto);
       return token ? token : this->Alloc(proto);
@@ -381,6 +389,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     }
 
    private:
+    bool reuse_storage_;
     int64_t storage_ids_{0};
     TokenAllocator1D token_1d_;
     TokenAllocator2D token_2d_;
@@ -401,9 +410,15 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   TokenAllocator allocator_;
 };
 
-StaticMemoryPlan GraphPlanMemory(const Function& func) { return StorageAllocator().Plan(func); }
+StaticMemoryPlan GraphPlanMemory(const Function& func, bool reuse_storage) {
+  return StorageAllocator(reuse_storage).Plan(func);
+}
+
+StaticMemoryPlan GraphPlanMemory(const Function& func) { return GraphPlanMemory(func, true); }
 
-TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory").set_body_typed(GraphPlanMemory);
+TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory").set_body_typed([](const Function& func) {
+  return GraphPlanMemory(func);
+});
 
 }  // namespace relay
 }  // namespace tvm
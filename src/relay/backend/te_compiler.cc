@@ -100,18 +100,25 @@
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/relay/op_attr_types.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/te/schedule.h>
 #include <tvm/te/schedule_pass.h>
 #include <tvm/tir/transform.h>
+#include <tvm/tir/usmp/utils.h>
 #include <tvm/topi/tags.h>
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -133,6 +140,27 @@ using namespace tvm::relay::transform;
 
 TVM_REGISTER_OBJECT_TYPE(TECompilerNode);
 
+/*!
+ * \brief Whether a primitive function producing a single tensor is composed of elementwise and
+ * broadcast ops only, so that its output can be computed in-place of an input of the same shape.
+ */
+static bool IsInplaceSafe(const Function& func) {
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  if (!func->body->checked_type().as<TensorTypeNode>()) {
+    return false;
+  }
+  bool inplace_safe = true;
+  PostOrderVisit(func->body, [&inplace_safe](const Expr& expr) {
+    if (const auto* call = expr.as<CallNode>()) {
+      const auto* op = call->op.as<OpNode>();
+      if (op == nullptr || fpattern.get(GetRef<Op>(op), kOpaque) > kBroadcast) {
+        inplace_safe = false;
+      }
+    }
+  });
+  return inplace_safe;
+}
+
 class TECompilerImpl : public TECompilerNode {
  public:
   explicit TECompilerImpl(Optional<IRModule> opt_mod, Optional<String> opt_mod_name)
@@ -158,6 +186,61 @@ class TECompilerImpl : public TECompilerNode {
     return LowerInternal(key, global_var_supply_)->cached_func;
   }
 
+  void LowerParallel(const Array<CCacheKey>& keys, int num_threads) final {
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    // The instruments would run again in each thread entering the PassContext, and the databases
+    // of the tuning records are thread local.
+    if (!pass_ctx->instruments.empty() ||
+        pass_ctx->GetConfig<Bool>("relay.backend.use_auto_scheduler", Bool(false)).value() ||
+        pass_ctx->GetConfig<Bool>("relay.backend.use_meta_schedule", Bool(false)).value()) {
+      return;
+    }
+    std::vector<CCacheKey> pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::unordered_set<CCacheKey> seen;
+      for (const CCacheKey& key : keys) {
+        std::string config, cache_dir;
+        LoweredFuncCache::Entry entry;
+        if (cache_.count(key) || !seen.insert(key).second ||
+            key->source_func->GetAttr<String>(attr::kCompiler).defined() ||
+            (UseGlobalCache(key, &config, &cache_dir) &&
+             LoweredFuncCache::Global()->Lookup(key, config, cache_dir, &entry))) {
+          continue;
+        }
+        pending.push_back(key);
+      }
+    }
+    if (pending.size() < 2) return;
+    if (num_threads <= 0) {
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    // Lower each function with private name supplies, so that the names only depend on the
+    // function, and rename them in the order of keys.
+    String prefix = global_var_supply_->name_supply_->prefix_;
+    std::vector<CachedFunc> lowered(pending.size());
+    support::parallel_for_dynamic(
+        0, static_cast<int>(pending.size()), num_threads, [&](int thread_id, int i) {
+          With<transform::PassContext> ctx_scope(pass_ctx);
+          lowered[i] =
+              LowerPrimitive(pending[i], GlobalVarSupply(NameSupply(prefix)), NameSupply(""));
+        });
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < pending.size(); ++i) {
+      // The functions which cannot be renamed are lowered again in order by Lower.
+      if (cache_.count(pending[i]) || !IsRenamable(lowered[i])) continue;
+      LoweredFuncCache::Entry entry = MakeEntry(lowered[i], "", global_var_supply_);
+      CCacheValue value(make_object<CCacheValueNode>());
+      value->cached_func = RenameLowered(pending[i], entry.name, entry.func, global_var_supply_);
+      cache_[pending[i]] = value;
+      std::string config, cache_dir;
+      if (UseGlobalCache(pending[i], &config, &cache_dir)) {
+        entry.config = config;
+        LoweredFuncCache::Global()->Insert(pending[i], entry, cache_dir);
+      }
+    }
+  }
+
   // For now, build one module per function.
   PackedFunc JIT(const CCacheKey& key) final {
     CCacheValue value = LowerInternal(key, GlobalVarSupply(NameSupply("")));
@@ -387,29 +470,57 @@ class TECompilerImpl : public TECompilerNode {
       return value;
     }
 
+    std::string config, cache_dir;
+    bool use_global_cache = UseGlobalCache(key, &config, &cache_dir);
+    LoweredFuncCache::Entry entry;
+    if (use_global_cache && LoweredFuncCache::Global()->Lookup(key, config, cache_dir, &entry)) {
+      value->cached_func = RenameLowered(key, entry.name, entry.func, global_var_supply);
+      VLOG(1) << "reused the global lowering as:" << std::endl
+              << PrettyPrint(value->cached_func->prim_fn_var);
+      return value;
+    }
+
+    ICHECK(!value->cached_func.defined());
+    value->cached_func = LowerPrimitive(key, global_var_supply, constant_name_supply_);
+    VLOG(1) << "lowered to name:" << std::endl
+            << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
+            << "with definitions:" << std::endl
+            << PrettyPrint(value->cached_func->funcs);
+    if (use_global_cache && IsRenamable(value->cached_func)) {
+      LoweredFuncCache::Global()->Insert(
+          key, MakeEntry(value->cached_func, config, global_var_supply), cache_dir);
+    }
+    return value;
+  }
+
+  /*!
+   * \brief Schedule and lower a primitive function, without touching the caches.
+   * \note This is called concurrently by LowerParallel, with private name supplies.
+   */
+  static CachedFunc LowerPrimitive(const CCacheKey& key, GlobalVarSupply global_var_supply,
+                                   NameSupply constant_name_supply) {
     // Enforce use the target.
     With<Target> target_scope(key->target);
 
-    ICHECK(!value->cached_func.defined());
-    value->cached_func =
-        PrimFuncFor(key->source_func, key->target, global_var_supply, constant_name_supply_);
+    CachedFunc cached_func =
+        PrimFuncFor(key->source_func, key->target, global_var_supply, constant_name_supply);
 
-    if (value->cached_func->prim_func.defined()) {
+    if (cached_func->prim_func.defined()) {
       VLOG(1) << "Lowering PrimFunc";
-      IRModule lowered = tvm::LowerPrimFunc(value->cached_func->prim_func.value(),
-                                            value->cached_func->prim_fn_var->name_hint, false);
+      IRModule lowered = tvm::LowerPrimFunc(cached_func->prim_func.value(),
+                                            cached_func->prim_fn_var->name_hint, false);
       ICHECK_EQ(lowered->functions.size(), 1);
       for (const auto& kv : lowered->functions) {
-        value->cached_func->funcs->Add(value->cached_func->prim_fn_var, kv.second);
+        cached_func->funcs->Add(cached_func->prim_fn_var, kv.second);
       }
     } else {
       // NOTE: array will copy on write.
-      Array<te::Tensor> all_args = Array<te::Tensor>(value->cached_func->inputs);
-      for (te::Tensor arg : value->cached_func->outputs) {
+      Array<te::Tensor> all_args = Array<te::Tensor>(cached_func->inputs);
+      for (te::Tensor arg : cached_func->outputs) {
         all_args.push_back(arg);
       }
       Array<runtime::NDArray> all_consts;
-      for (auto kv : value->cached_func->constant_tensors) {
+      for (auto kv : cached_func->constant_tensors) {
         all_args.push_back(kv.second);
         all_consts.push_back(kv.first->data);
       }
@@ -421,7 +532,7 @@ class TECompilerImpl : public TECompilerNode {
       for (Var param : key->source_func->params) {
         if (!param->virtual_device()->memory_scope.empty()) {
           for (const auto& ttype : FlattenTupleType(param->checked_type())) {
-            te::Tensor x_ref = value->cached_func->inputs[i];
+            te::Tensor x_ref = cached_func->inputs[i];
             // verification if we have synced params and tensors
             ICHECK(ttype->dtype == x_ref->dtype && ttype->shape.size() == x_ref->shape.size())
                 << "function parameter does not correspond to prepared tensor";
@@ -435,18 +546,22 @@ class TECompilerImpl : public TECompilerNode {
       if (key->virtual_device != VirtualDevice::FullyUnconstrained() &&
           !key->virtual_device->memory_scope.empty() &&
           key->virtual_device->memory_scope != "global") {
-        ICHECK(value->cached_func->outputs.size() == 1)
+        ICHECK(cached_func->outputs.size() == 1)
             << "Expect only one output for defined memory scope";
-        te::Tensor x_ref = value->cached_func->outputs[0];
+        te::Tensor x_ref = cached_func->outputs[0];
         binds[x_ref] =
             tir::BufferWithOffsetAlignment(x_ref->shape, x_ref->dtype, x_ref->op->name, -1, 0,
                                            false, key->virtual_device->memory_scope);
       }
-      auto func_name = value->cached_func->prim_fn_var->name_hint;
+      auto func_name = cached_func->prim_fn_var->name_hint;
       VLOG(1) << "scheduling";
-      IRModule scheduled_module = tvm::LowerSchedule(value->cached_func->schedule, all_args,
+      IRModule scheduled_module = tvm::LowerSchedule(cached_func->schedule, all_args,
                                                      func_name, binds, global_var_supply);
       scheduled_module->Update(tir::transform::BindParams(all_consts)(scheduled_module));
+      // Let USMP share the storage of the output with an input of the elementwise operators.
+      transform::PassContext pass_ctx = transform::PassContext::Current();
+      bool inplace_safe = pass_ctx->GetConfig<Bool>(kUSMPEnableOption, Bool(false)).value() &&
+                          IsInplaceSafe(key->source_func);
       for (const auto& kv : scheduled_module->functions) {
         GlobalVar global_var = kv.first;
         auto func = kv.second;
@@ -456,17 +571,79 @@ class TECompilerImpl : public TECompilerNode {
         if (hash) {
           func = WithAttrs(Downcast<tir::PrimFunc>(func), {{String("hash"), hash.value()}});
         }
-        value->cached_func->funcs->Add(global_var, func);
+        if (inplace_safe && global_var->name_hint == func_name) {
+          func = WithAttr(Downcast<tir::PrimFunc>(func), tir::usmp::kInplaceSafeFuncAttr,
+                          Bool(true));
+        }
+        cached_func->funcs->Add(global_var, func);
       }
-      ICHECK(value->cached_func->funcs->Lookup(value->cached_func->prim_fn_var)
+      ICHECK(cached_func->funcs->Lookup(cached_func->prim_fn_var)
                  .as<tir::PrimFuncNode>());
     }
-    VLOG(1) << "lowered to name:" << std::endl
-            << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
-            << "with definitions:" << std::endl
-            << PrettyPrint(value->cached_func->funcs);
+    return cached_func;
+  }
 
-    return value;
+  /*!
+   * \brief Check whether the lowered function has no bound constants, which are named by the
+   *  constant_name_supply_ of the module, and no auxiliary functions, so that it can be lowered
+   *  aside and renamed.
+   */
+  static bool IsRenamable(const CachedFunc& cached_func) {
+    return cached_func->constant_tensors.empty() && cached_func->funcs->functions.size() == 1;
+  }
+
+  /*!
+   * \brief Get the name the lowered function was generated for, without the module prefix of
+   *  global_var_supply.
+   */
+  static std::string UnprefixedName(const CachedFunc& cached_func,
+                                    const GlobalVarSupply& global_var_supply) {
+    std::string name = cached_func->prim_fn_var->name_hint;
+    std::string prefix = global_var_supply->name_supply_->prefix_;
+    if (!prefix.empty() && name.compare(0, prefix.size() + 1, prefix + "_") == 0) {
+      name = name.substr(prefix.size() + 1);
+    }
+    return name;
+  }
+
+  static LoweredFuncCache::Entry MakeEntry(const CachedFunc& cached_func, const std::string& config,
+                                           const GlobalVarSupply& global_var_supply) {
+    return {config, UnprefixedName(cached_func, global_var_supply),
+            Downcast<tir::PrimFunc>(cached_func->funcs->Lookup(cached_func->prim_fn_var))};
+  }
+
+  /*! \brief Bind a function lowered aside to a fresh GlobalVar of global_var_supply. */
+  static CachedFunc RenameLowered(const CCacheKey& key, const std::string& name,
+                                  const tir::PrimFunc& func, GlobalVarSupply global_var_supply) {
+    GlobalVar global_var = global_var_supply->FreshGlobal(name);
+    global_var->checked_type_ = key->source_func->checked_type();
+    IRModule funcs(Map<GlobalVar, BaseFunc>(
+        {{global_var, WithAttr(func, tvm::attr::kGlobalSymbol, global_var->name_hint)}}));
+    return CachedFunc(key->target, global_var, {}, {}, te::Schedule{nullptr},
+                      tir::PrimFunc{nullptr}, {}, funcs);
+  }
+
+  /*!
+   * \brief Check whether the lowering of key is shared with the other TECompilers, which is not
+   *  the case when its buffers are bound to memory scopes not part of the key.
+   * \param key The key of the function.
+   * \param config The configuration key of the current PassContext.
+   * \param cache_dir The directory persisting the shared functions.
+   * \return Whether the lowering is shared.
+   */
+  static bool UseGlobalCache(const CCacheKey& key, std::string* config, std::string* cache_dir) {
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    *cache_dir = pass_ctx->GetConfig<String>(kTECompilerCacheDirOption, String("")).value();
+    bool use_global_cache =
+        (pass_ctx->GetConfig<Bool>(kTECompilerGlobalCacheOption, Bool(false)).value() ||
+         !cache_dir->empty()) &&
+        key->virtual_device == VirtualDevice::FullyUnconstrained() &&
+        std::all_of(key->source_func->params.begin(), key->source_func->params.end(),
+                    [](const Var& param) { return param->virtual_device()->memory_scope.empty(); });
+    if (use_global_cache) {
+      *config = LoweredFuncCache::ConfigKey(pass_ctx);
+    }
+    return use_global_cache;
   }
 
   // implement lowered shape func
@@ -552,6 +729,9 @@ TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_auto_scheduler", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule_dispatch", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.tir_converter", String);
+TVM_REGISTER_PASS_CONFIG_OPTION(kTECompilerGlobalCacheOption, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kTECompilerCacheDirOption, String);
+TVM_REGISTER_PASS_CONFIG_OPTION(kTECompilerNumThreadsOption, Integer);
 
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobal").set_body_typed([]() {
   return TECompiler::Global();
@@ -627,13 +807,19 @@ using AnalysisRemapping = std::unordered_map<Expr, Expr, ObjectHash, ObjectEqual
  */
 class LowerTensorExprMutator : public DeviceAwareExprMutator {
  public:
+  /*!
+   * \brief Constructor.
+   * \param collected_keys If not null, the keys of the primitive functions to lower are collected
+   *  into it instead of lowering them, and the result of the mutator is meaningless.
+   */
   LowerTensorExprMutator(IRModule module, ProcessFn process_fn, CompilationConfig config,
-                         TECompiler compiler)
+                         TECompiler compiler, Array<CCacheKey>* collected_keys = nullptr)
       : DeviceAwareExprMutator(module),
         module_(std::move(module)),
         process_fn_(std::move(process_fn)),
         config_(std::move(config)),
         compiler_(std::move(compiler)),
+        collected_keys_(collected_keys),
         debug_op_(Op::Get("debug")) {}
 
   /*!
@@ -877,6 +1063,19 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
 
     ICHECK(call_node->type_args.empty()) << "lowered functions cannot be polymorphic";
 
+    if (collected_keys_ != nullptr) {
+      // Only collect the functions of case 1 for TECompiler::LowerParallel.
+      const auto* function_node = primitive_func.as<FunctionNode>();
+      VirtualDevice virtual_device = GetVirtualDevice(GetRef<Call>(call_node));
+      if (function_node != nullptr && !function_node->HasNonzeroAttr(attr::kExtern) &&
+          !function_node->GetAttr<String>(attr::kCompiler).defined() &&
+          virtual_device->target.defined()) {
+        collected_keys_->push_back(
+            CCacheKey(GetRef<Function>(function_node), virtual_device->target, virtual_device));
+      }
+      return WithFields(GetRef<Call>(call_node), std::move(new_op), std::move(new_args));
+    }
+
     // Case 4: If the function has already been lowered we just need to update the call.
     if (const auto* prim_func_node = primitive_func.as<tir::PrimFuncNode>()) {
       // Function should already be Target annotated by this point
@@ -941,6 +1140,8 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
   // lowered for multiple device types, each which will be assigned a fresh var.
   std::unordered_map<const VarNode*, BaseFunc> primitive_functions_;
   TECompiler compiler_;
+  /*! \brief The keys collected instead of lowering the functions, if not null. */
+  Array<CCacheKey>* collected_keys_;
   // Cache ops that need to be frequently used later to reduce lookup overhead.
   const Op& debug_op_;
 };
@@ -948,6 +1149,17 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
 Pass LowerTensorExpr(TECompiler compiler, ProcessFn process_fn, CompilationConfig config) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function func, IRModule module, PassContext ctx) {
+        int num_threads = ctx->GetConfig<Integer>(kTECompilerNumThreadsOption, Integer(1))
+                              .value()
+                              .IntValue();
+        if (num_threads != 1) {
+          // Lower the primitive functions ahead on a pool of threads, for the mutator to find
+          // them in the cache.
+          Array<CCacheKey> keys;
+          LowerTensorExprMutator collect_te(module, [](BaseFunc) {}, config, compiler, &keys);
+          collect_te.Mutate(func);
+          TECompiler(compiler)->LowerParallel(keys, num_threads);
+        }
         LowerTensorExprMutator lower_te(module, process_fn, config, compiler);
         return Downcast<Function>(lower_te.Mutate(func));
       };
@@ -82,6 +82,14 @@ class TECompilerNode : public Object {
    */
   virtual CachedFunc Lower(const CCacheKey& key, const String mod_name) = 0;
 
+  /*!
+   * \brief Lower the primitive functions of keys on a pool of threads into the cache, so that the
+   *  subsequent calls to Lower only look them up. The functions are named in the order of keys.
+   * \param keys The keys of the functions to lower.
+   * \param num_threads The number of threads, or all the cores if not positive.
+   */
+  virtual void LowerParallel(const Array<CCacheKey>& keys, int num_threads) = 0;
+
   /* Return all functions which have been lowered by the compiler in an IRModule, annotated with
    * their target. */
   virtual IRModule GetLoweredFunctions() = 0;
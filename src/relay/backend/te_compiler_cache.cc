@@ -23,6 +23,7 @@
 #include <tvm/ir/name_supply.h>
 #include <tvm/ir/type_functor.h>
 #include <tvm/meta_schedule/database.h>
+#include <tvm/node/serialization.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/device_copy.h>
 #include <tvm/relay/expr.h>
@@ -43,10 +44,16 @@
 #include <tvm/tir/transform.h>
 #include <tvm/topi/tags.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <random>
+#include <sstream>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -1095,6 +1102,101 @@ std::tuple<Array<te::Tensor>, Array<runtime::NDArray>, std::string> LowerTECompu
   return std::make_tuple(tensor_outs, constants, lower_te_compute.candidate_name_);
 }
 
+LoweredFuncCache* LoweredFuncCache::Global() {
+  static LoweredFuncCache* inst = new LoweredFuncCache();
+  return inst;
+}
+
+std::string LoweredFuncCache::ConfigKey(const transform::PassContext& pass_ctx) {
+  std::vector<std::string> names;
+  for (const auto& kv : pass_ctx->config) {
+    // The options of the cache itself do not affect the lowering.
+    if (kv.first != kTECompilerGlobalCacheOption && kv.first != kTECompilerCacheDirOption) {
+      names.push_back(kv.first);
+    }
+  }
+  std::sort(names.begin(), names.end());
+  std::ostringstream os;
+  os << "opt_level=" << pass_ctx->opt_level << ";required_pass=" << pass_ctx->required_pass
+     << ";disabled_pass=" << pass_ctx->disabled_pass;
+  for (const std::string& name : names) {
+    os << ";" << name << "=" << pass_ctx->config[name];
+  }
+  return os.str();
+}
+
+std::string LoweredFuncCache::FilePath(const CCacheKey& key, const std::string& config,
+                                       const std::string& cache_dir) {
+  size_t hash = dmlc::HashCombine(key->Hash(), std::hash<std::string>()(config));
+  std::ostringstream os;
+  os << cache_dir << "/" << std::hex << hash << ".json";
+  return os.str();
+}
+
+bool LoweredFuncCache::Lookup(const CCacheKey& key, const std::string& config,
+                              const std::string& cache_dir, Entry* entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    for (const Entry& cached : it->second) {
+      if (cached.config == config) {
+        *entry = cached;
+        return true;
+      }
+    }
+  }
+  if (cache_dir.empty()) return false;
+  std::ifstream fs(FilePath(key, config, cache_dir));
+  if (!fs) return false;
+  std::string json((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  // The record is [source_func, target, config, name, func], whose file name is a hash which may
+  // collide.
+  Array<ObjectRef> record = Downcast<Array<ObjectRef>>(LoadJSON(json));
+  ICHECK_EQ(record.size(), 5U) << "Malformed lowered function record in " << cache_dir;
+  if (Downcast<String>(record[1]) != key->target->str() ||
+      Downcast<String>(record[2]) != config ||
+      !tvm::StructuralEqual()(record[0], key->source_func)) {
+    return false;
+  }
+  Entry loaded{config, Downcast<String>(record[3]), Downcast<tir::PrimFunc>(record[4])};
+  entries_[key].push_back(loaded);
+  *entry = loaded;
+  return true;
+}
+
+void LoweredFuncCache::Insert(const CCacheKey& key, const Entry& entry,
+                              const std::string& cache_dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key].push_back(entry);
+  if (cache_dir.empty()) return;
+  Array<ObjectRef> record{key->source_func, String(key->target->str()), String(entry.config),
+                          String(entry.name), entry.func};
+  std::string path = FilePath(key, entry.config, cache_dir);
+  // Write the record aside and rename it, so that the concurrent builds never read it partially.
+  std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream fs(tmp_path);
+    if (!fs) {
+      LOG(WARNING) << "Cannot persist lowered function " << entry.name << " into " << cache_dir;
+      return;
+    }
+    fs << SaveJSON(record);
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Cannot persist lowered function " << entry.name << " into " << path;
+    std::remove(tmp_path.c_str());
+  }
+}
+
+void LoweredFuncCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobalCacheClear").set_body_typed([]() {
+  LoweredFuncCache::Global()->Clear();
+});
+
 TVM_REGISTER_GLOBAL("relay.backend.LowerToTE").set_body_typed([](Function prim_func) {
   auto tgt = tvm::Target("ext_dev");
   LowerToTECompute lower_te_compute(tgt, NameSupply(""));
@@ -36,10 +36,12 @@
 #include <tvm/topi/elemwise.h>
 
 #include <functional>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "../transforms/infer_layout_utils.h"
 
@@ -245,6 +247,87 @@ inline CachedFunc PrimFuncFor(const Function& source_func, const Target& target)
 CachedFunc ShapeFuncFor(const Function& prim_func, const Target& target,
                         GlobalVarSupply global_var_supply);
 
+/*! \brief PassContext option to share the lowered functions across the TECompilers. */
+constexpr const char* kTECompilerGlobalCacheOption = "relay.backend.te_compiler_global_cache";
+/*!
+ * \brief PassContext option naming a directory to persist the lowered functions into, which
+ *  implies kTECompilerGlobalCacheOption.
+ */
+constexpr const char* kTECompilerCacheDirOption = "relay.backend.te_compiler_cache_dir";
+/*!
+ * \brief PassContext option for the number of threads lowering the primitive functions, all the
+ *  cores if not positive. Defaults to 1, lowering them in order.
+ */
+constexpr const char* kTECompilerNumThreadsOption = "relay.backend.te_compiler_num_threads";
+
+/*!
+ * \brief The process-wide cache of the scheduled and lowered primitive functions, optionally
+ *  backed by a directory, so that the builds of models sharing operators lower each of them once.
+ *
+ *  The entries are keyed by the CCacheKey and by the configuration of the PassContext, which
+ *  together determine the lowered TIR. The lowered functions are renamed by each TECompiler
+ *  reusing them.
+ */
+class LoweredFuncCache {
+ public:
+  /*! \brief A cached lowered function. */
+  struct Entry {
+    /*! \brief The configuration of the PassContext the function was lowered in. */
+    std::string config;
+    /*! \brief The name the function was generated for, without the prefix of the module. */
+    std::string name;
+    /*! \brief The lowered function. */
+    tir::PrimFunc func;
+  };
+
+  /*! \return The cache of the process. */
+  static LoweredFuncCache* Global();
+
+  /*!
+   * \brief Get the configuration of pass_ctx affecting the lowering, as a part of the keys.
+   * \param pass_ctx The PassContext.
+   * \return The canonical representation of the configuration.
+   */
+  static std::string ConfigKey(const transform::PassContext& pass_ctx);
+
+  /*!
+   * \brief Look up the lowered function of a key.
+   * \param key The key of the function.
+   * \param config The configuration key of ConfigKey.
+   * \param cache_dir The directory of the persisted functions, searched on a miss in the process
+   *  unless empty.
+   * \param entry The found entry.
+   * \return Whether the function was found.
+   */
+  bool Lookup(const CCacheKey& key, const std::string& config, const std::string& cache_dir,
+              Entry* entry);
+
+  /*!
+   * \brief Insert the lowered function of a key.
+   * \param key The key of the function.
+   * \param entry The entry to insert.
+   * \param cache_dir The directory to persist the entry into, unless empty.
+   */
+  void Insert(const CCacheKey& key, const Entry& entry, const std::string& cache_dir);
+
+  /*! \brief Clear the entries of the process, keeping the persisted ones. */
+  void Clear();
+
+ private:
+  /*! \return The file persisting the entry of key and config in cache_dir. */
+  static std::string FilePath(const CCacheKey& key, const std::string& config,
+                              const std::string& cache_dir);
+
+  struct KeyHash {
+    size_t operator()(const CCacheKey& key) const { return key->Hash(); }
+  };
+
+  /*! \brief The lock of the cache. */
+  std::mutex mutex_;
+  /*! \brief The entries of each key, for the distinct configurations. */
+  std::unordered_map<CCacheKey, std::vector<Entry>, KeyHash> entries_;
+};
+
 // implementations
 inline size_t CCacheKeyNode::Hash() const {
   if (hash_ != 0) return hash_;
@@ -197,5 +197,41 @@ runtime::Texture2DShape<int64_t> TokenAllocator2D::GetSize2D(StorageToken* proto
   return runtime::ApplyTexture2DFlattening<int64_t>(Shape{ttype->shape}, ttype->shape.size(), axis);
 }
 
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment) {
+  std::vector<size_t> order(blocks->size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const ArenaBlock& lhs = (*blocks)[a];
+    const ArenaBlock& rhs = (*blocks)[b];
+    return lhs.size != rhs.size ? lhs.size > rhs.size : lhs.first_use < rhs.first_use;
+  });
+  size_t arena_size = 0;
+  std::vector<const ArenaBlock*> placed;
+  for (size_t index : order) {
+    ArenaBlock& block = (*blocks)[index];
+    // The ranges of the placed blocks live at the same time, by increasing offset.
+    std::vector<std::pair<size_t, size_t>> conflicts;
+    for (const ArenaBlock* other : placed) {
+      if (other->first_use <= block.last_use && block.first_use <= other->last_use) {
+        conflicts.emplace_back(other->offset, other->offset + other->size);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    size_t offset = 0;
+    for (const auto& range : conflicts) {
+      if (offset + block.size <= range.first) {
+        break;
+      }
+      offset = std::max(offset, TokenAllocator1D::DivRoundUp(range.second, alignment) * alignment);
+    }
+    block.offset = offset;
+    arena_size = std::max(arena_size, offset + block.size);
+    placed.push_back(&block);
+  }
+  return arena_size;
+}
+
 }  // namespace relay
 }  // namespace tvm
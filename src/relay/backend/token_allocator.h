@@ -155,6 +155,28 @@ class TokenAllocator2D {
   std::unordered_set<int64_t> free_list_;
 };
 
+/*! \brief A block of memory live from its first to its last use, placed in an arena. */
+struct ArenaBlock {
+  /*! \brief The number of bytes. */
+  size_t size{0};
+  /*! \brief The index of the first operator using the block. */
+  int64_t first_use{0};
+  /*! \brief The index of the last operator using the block. */
+  int64_t last_use{0};
+  /*! \brief The offset of the block in the arena. */
+  size_t offset{0};
+};
+
+/*!
+ * \brief Place the blocks in one arena, each at the lowest offset where it does not overlap the
+ *  blocks live at the same time already placed, by decreasing size as the greedy_by_size
+ *  algorithm of USMP does.
+ * \param blocks The blocks, whose offsets are set.
+ * \param alignment The alignment of the offsets.
+ * \return The size of the arena.
+ */
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment);
+
 }  // namespace relay
 }  // namespace tvm
 
@@ -44,6 +44,21 @@ GlobalVar CandidateFunctionCache::GetGlobalSymbol(const Function& function) {
   return GetEntry(/*label=*/"", function).global_symbol;
 }
 
+void CandidateFunctionCache::LookupCost(const Function& function, const Target& target,
+                                        Entry* entry) const {
+  if (cost_cache_ != nullptr && entry->cost.is_unknown()) {
+    entry->cost = cost_cache_->Lookup(function, target);
+  }
+}
+
+void CandidateFunctionCache::SetCost(const Function& function, const Target& target, Cost cost,
+                                     Entry* entry) const {
+  entry->cost = cost;
+  if (cost_cache_ != nullptr) {
+    cost_cache_->Insert(function, target, cost);
+  }
+}
+
 }  // namespace collage
 }  // namespace relay
 }  // namespace tvm
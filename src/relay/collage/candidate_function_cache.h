@@ -34,6 +34,7 @@
 
 #include "../transforms/compiler_function_utils.h"
 #include "./cost.h"
+#include "./cost_cache.h"
 #include "./name_supply.h"
 
 namespace tvm {
@@ -49,8 +50,9 @@ namespace collage {
  */
 class CandidateFunctionCache : public transform::GlobalSymbolCache {
  public:
-  explicit CandidateFunctionCache(std::shared_ptr<NameSupply> name_supply)
-      : name_supply_(std::move(name_supply)) {}
+  explicit CandidateFunctionCache(std::shared_ptr<NameSupply> name_supply,
+                                  std::shared_ptr<CostCache> cost_cache = nullptr)
+      : name_supply_(std::move(name_supply)), cost_cache_(std::move(cost_cache)) {}
 
   struct Entry {
     GlobalVar global_symbol;
@@ -67,8 +69,22 @@ class CandidateFunctionCache : public transform::GlobalSymbolCache {
 
   GlobalVar GetGlobalSymbol(const Function& function) final;
 
+  /*!
+   * \brief Fills in the unknown cost of \p entry for \p function on \p target from the cost
+   * cache, if any.
+   */
+  void LookupCost(const Function& function, const Target& target, Entry* entry) const;
+
+  /*!
+   * \brief Sets the estimated \p cost of \p entry for \p function on \p target, and records it
+   * into the cost cache, if any.
+   */
+  void SetCost(const Function& function, const Target& target, Cost cost, Entry* entry) const;
+
  private:
   std::shared_ptr<NameSupply> name_supply_;
+  /*! \brief The costs estimated by the previous runs, if shared. */
+  std::shared_ptr<CostCache> cost_cache_;
   std::unordered_map<Function, Entry, StructuralHash, StructuralEqual> cache_;
 };
 
@@ -103,6 +103,16 @@ class CandidatePartitionNode : public Object {
   Cost EstimatedCost(const DataflowGraph& dataflow_graph, const CostEstimator& cost_estimator,
                      const std::shared_ptr<CandidateFunctionCache>& cache) const;
 
+  /*!
+   * \brief Extracts and validates the function of the candidate partition, as the first step of
+   * \p EstimatedCost. Returns null and sets the cost to invalid if the function cannot be
+   * rewritten. Otherwise returns the entry of the function in \p cache, the cost of which is yet
+   * to be estimated from \p mod as the cost of \p function if \p mod is set.
+   */
+  CandidateFunctionCache::Entry* PrepareEstimate(
+      const DataflowGraph& dataflow_graph, const std::shared_ptr<CandidateFunctionCache>& cache,
+      Function* function, IRModule* mod) const;
+
   /*!
    * \brief Returns a brief description of candidate suitable for debugging output.
    */
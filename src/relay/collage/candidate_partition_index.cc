@@ -24,6 +24,12 @@
 
 #include "./candidate_partition_index.h"
 
+#include <tvm/support/parallel_for.h>
+
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
 #include "./gather_partition_specs.h"
 #include "./prune_candidates.h"
 #include "./utils.h"
@@ -51,7 +57,56 @@ void CandidatePartitionIndex::Index(const Array<PartitionSpec>& partition_specs)
 }
 
 void CandidatePartitionIndex::EstimateAllCosts(
-    const CostEstimator cost_estimator, const std::shared_ptr<CandidateFunctionCache>& cache) {
+    const CostEstimator cost_estimator, const std::shared_ptr<CandidateFunctionCache>& cache,
+    int num_threads) {
+  if (num_threads != 1) {
+    // Extract the functions and assign their global symbols in order, so that the names do not
+    // depend on the threads, and only estimate the distinct unknown costs in parallel.
+    struct Estimate {
+      CandidateFunctionCache::Entry* entry;
+      Function function;
+      IRModule mod;
+      Target target;
+    };
+    std::vector<Estimate> estimates;
+    std::unordered_set<CandidateFunctionCache::Entry*> pending_entries;
+    std::vector<std::pair<CandidatePartition, CandidateFunctionCache::Entry*>> pending_candidates;
+    for (const auto& candidates : first_inside_index_to_candidates_) {
+      for (const auto& candidate : candidates) {
+        if (!candidate->cost_.is_unknown()) {
+          continue;
+        }
+        Function function;
+        IRModule mod;
+        CandidateFunctionCache::Entry* entry =
+            candidate->PrepareEstimate(*dataflow_graph_, cache, &function, &mod);
+        if (entry == nullptr) {
+          continue;
+        }
+        if (mod.defined() && pending_entries.insert(entry).second) {
+          estimates.push_back({entry, function, mod, candidate->target()});
+        }
+        pending_candidates.emplace_back(candidate, entry);
+      }
+    }
+    if (num_threads <= 0) {
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    LOG(INFO) << "Estimating " << estimates.size() << " distinct candidate functions on "
+              << num_threads << " threads";
+    std::vector<Cost> costs(estimates.size(), Cost::Unknown());
+    support::parallel_for_dynamic(0, static_cast<int>(estimates.size()), num_threads,
+                                  [&](int thread_id, int i) {
+                                    costs[i] = cost_estimator->Estimate(estimates[i].mod,
+                                                                        estimates[i].target);
+                                  });
+    for (size_t i = 0; i < estimates.size(); ++i) {
+      cache->SetCost(estimates[i].function, estimates[i].target, costs[i], estimates[i].entry);
+    }
+    for (const auto& [candidate, entry] : pending_candidates) {
+      candidate->cost_ = entry->cost;
+    }
+  }
   size_t n = 0;
   for (PostDfsIndex index = 0; index < dataflow_graph_->size(); ++index) {
     for (const auto& candidate : first_inside_index_to_candidates_[index]) {
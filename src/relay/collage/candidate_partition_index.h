@@ -57,9 +57,13 @@ class CandidatePartitionIndex {
     return first_inside_index_to_candidates_[index];
   }
 
-  /*! \brief Estimates the casts of all candidates in the index. Each candidate caches its cost. */
+  /*!
+   * \brief Estimates the casts of all candidates in the index. Each candidate caches its cost.
+   * The distinct functions are estimated on \p num_threads threads, all the cores if not positive,
+   * in which case \p cost_estimator must be thread safe.
+   */
   void EstimateAllCosts(const CostEstimator cost_estimator,
-                        const std::shared_ptr<CandidateFunctionCache>& cache);
+                        const std::shared_ptr<CandidateFunctionCache>& cache, int num_threads = 1);
 
   size_t size() const { return size_; }
 
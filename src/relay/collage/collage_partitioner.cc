@@ -39,6 +39,7 @@
 #include "./candidate_partition.h"
 #include "./candidate_partition_index.h"
 #include "./cost.h"
+#include "./cost_cache.h"
 #include "./cost_estimator.h"
 #include "./gather_partition_specs.h"
 #include "./name_supply.h"
@@ -55,6 +56,8 @@ namespace {
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.tvm_max_depth", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.byoc_max_depth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.num_estimation_threads", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.cost_cache_dir", String);
 
 /*!
  * \brief Represents the overall expression after some number of non-overlapping candidate
@@ -126,12 +129,13 @@ class Partitioner {
   explicit Partitioner(Array<PartitionSpec> partition_specs,
                        const std::unordered_map<const ExprNode*, VirtualDevice>* virtual_devices,
                        CostEstimator cost_estimator, std::shared_ptr<CandidateFunctionCache> cache,
-                       Expr expr)
+                       Expr expr, int num_estimation_threads = 1)
       : partition_specs_(std::move(partition_specs)),
         virtual_devices_(virtual_devices),
         cost_estimator_(std::move(cost_estimator)),
         cache_(std::move(cache)),
-        expr_(std::move(expr)) {}
+        expr_(std::move(expr)),
+        num_estimation_threads_(num_estimation_threads) {}
 
   Expr Partition() {
     // Establish core data structures.
@@ -150,10 +154,10 @@ class Partitioner {
     //  - There are no paths in which the candidate does not intersect candidates already
     //    applied on the path.
     //  - The Dijkstra search terminates early with a least cost path.
-    // So eager may result in more estimation overhead. However, eager could be made
-    // embarrassingly parallel.
+    // So eager may result in more estimation overhead. However, eager is embarrassingly
+    // parallel, see "relay.collage.num_estimation_threads".
     VLOG(1) << "Beginning eager cost estimation";
-    index_->EstimateAllCosts(cost_estimator_, cache_);
+    index_->EstimateAllCosts(cost_estimator_, cache_, num_estimation_threads_);
     VLOG(1) << "Finished eager cost estimation";
 
     // Setup initial state.
@@ -300,6 +304,8 @@ class Partitioner {
   std::shared_ptr<CandidateFunctionCache> cache_;
   /*! \brief The expression we will be partitioning. */
   Expr expr_;
+  /*! \brief The number of threads estimating the costs of the candidates. */
+  int num_estimation_threads_;
   /*! \brief Dataflow graph for overall expression. */
   std::unique_ptr<DataflowGraph> dataflow_graph_;
   /*! \brief Index of all avoilable candidates we are searching over. */
@@ -322,8 +328,17 @@ transform::Pass CollagePartition(CompilationConfig config, CostEstimator cost_es
         Array<PartitionSpec> partition_specs = GatherPartitionSpecs(config);
         VLOG(1) << "Gathered " << partition_specs.size() << " partition specs";
 
-        auto cache =
-            std::make_shared<CandidateFunctionCache>(std::make_shared<NameSupply>("collage"));
+        // The costs may be shared with the previous runs through a directory.
+        std::string cost_cache_dir =
+            ctxt->GetConfig<String>("relay.collage.cost_cache_dir", String("")).value();
+        std::shared_ptr<CostCache> cost_cache =
+            cost_cache_dir.empty() ? nullptr : std::make_shared<CostCache>(cost_cache_dir);
+        auto cache = std::make_shared<CandidateFunctionCache>(
+            std::make_shared<NameSupply>("collage"), std::move(cost_cache));
+        int num_estimation_threads =
+            ctxt->GetConfig<Integer>("relay.collage.num_estimation_threads", Integer(1))
+                .value()
+                .IntValue();
 
         IRModule out_mod = mod->ShallowCopy();
         for (const auto& kv : mod->functions) {
@@ -332,7 +347,7 @@ transform::Pass CollagePartition(CompilationConfig config, CostEstimator cost_es
             std::unordered_map<const ExprNode*, VirtualDevice> virtual_devices =
                 transform::RecoverVirtualDeviceMap(mod, function);
             Partitioner partitioner(partition_specs, &virtual_devices, cost_estimator, cache,
-                                    function);
+                                    function, num_estimation_threads);
             Function result = Downcast<Function>(partitioner.Partition());
             out_mod->Add(kv.first, result);
           }
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/collage/cost_cache.cc
+ * \brief A directory of the estimated costs of candidate partition functions, shared across runs.
+ */
+
+#include "./cost_cache.h"
+
+#include <tvm/node/serialization.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace tvm {
+namespace relay {
+namespace collage {
+
+std::string CostCache::FilePath(const Function& function, const Target& target) const {
+  size_t hash =
+      dmlc::HashCombine(StructuralHash()(function), std::hash<std::string>()(target->str()));
+  std::ostringstream os;
+  os << cache_dir_ << "/" << std::hex << hash << ".json";
+  return os.str();
+}
+
+Cost CostCache::Lookup(const Function& function, const Target& target) const {
+  std::ifstream fs(FilePath(function, target));
+  if (!fs) {
+    return Cost::Unknown();
+  }
+  std::string json((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  Array<ObjectRef> record = Downcast<Array<ObjectRef>>(LoadJSON(json));
+  ICHECK_EQ(record.size(), 3U) << "Malformed cost record in " << cache_dir_;
+  if (Downcast<String>(record[1]) != target->str() || !StructuralEqual()(record[0], function)) {
+    return Cost::Unknown();
+  }
+  double value = std::stod(Downcast<String>(record[2]));
+  return std::isinf(value) ? Cost::Invalid() : Cost::Value(value);
+}
+
+void CostCache::Insert(const Function& function, const Target& target, Cost cost) const {
+  if (cost.is_unknown()) {
+    return;
+  }
+  std::ostringstream cost_os;
+  if (cost.is_invalid()) {
+    cost_os << "inf";
+  } else {
+    cost_os << std::setprecision(std::numeric_limits<double>::max_digits10) << cost.value();
+  }
+  Array<ObjectRef> record{function, String(target->str()), String(cost_os.str())};
+  std::string path = FilePath(function, target);
+  // Write the record aside and rename it, so that the concurrent runs never read it partially.
+  std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream fs(tmp_path);
+    if (!fs) {
+      LOG(WARNING) << "Unable to record cost into " << cache_dir_;
+      return;
+    }
+    fs << SaveJSON(record);
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Unable to record cost into " << path;
+    std::remove(tmp_path.c_str());
+  }
+}
+
+}  // namespace collage
+}  // namespace relay
+}  // namespace tvm
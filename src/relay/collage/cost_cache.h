@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/collage/cost_cache.h
+ * \brief A directory of the estimated costs of candidate partition functions, shared across runs.
+ */
+
+#ifndef TVM_RELAY_COLLAGE_COST_CACHE_H_
+#define TVM_RELAY_COLLAGE_COST_CACHE_H_
+
+#include <tvm/relay/function.h>
+#include <tvm/target/target.h>
+
+#include <string>
+
+#include "./cost.h"
+
+namespace tvm {
+namespace relay {
+namespace collage {
+
+/*!
+ * \brief A cache of the estimated costs of the functions extracted to represent partitions,
+ * persisted into a directory so that the Collage runs over models sharing sub-graphs estimate each
+ * of them once per target.
+ *
+ * Each cost is recorded in its own file, named by the structural hash of the function and the
+ * target, and holding the JSON of [function, target, cost] so that hash collisions are detected.
+ */
+class CostCache {
+ public:
+  /*! \brief Constructs the cache of the existing directory \p cache_dir. */
+  explicit CostCache(std::string cache_dir) : cache_dir_(std::move(cache_dir)) {}
+
+  /*!
+   * \brief Returns the cost of \p function on \p target recorded by a previous estimation, or
+   * Cost::Unknown() if none.
+   */
+  Cost Lookup(const Function& function, const Target& target) const;
+
+  /*! \brief Records the \p cost of \p function on \p target, unless unknown. */
+  void Insert(const Function& function, const Target& target, Cost cost) const;
+
+ private:
+  /*! \brief Returns the file recording the cost of \p function on \p target. */
+  std::string FilePath(const Function& function, const Target& target) const;
+
+  /*! \brief The directory of the cost files. */
+  std::string cache_dir_;
+};
+
+}  // namespace collage
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_COLLAGE_COST_CACHE_H_
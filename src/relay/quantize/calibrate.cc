@@ -26,8 +26,15 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
 #include <numeric>
+#include <vector>
 
 #include "./quantize.h"
 
@@ -208,6 +215,220 @@ Expr CreateStatsCollector(const Expr& expr) { return StatsCollector().Collect(ex
 
 TVM_REGISTER_GLOBAL("relay._quantize.CreateStatsCollector").set_body_typed(CreateStatsCollector);
 
+/*!
+ * \brief The statistics of the outputs of a profile graph, accumulated across the calibration
+ * batches without keeping the outputs.
+ * \details The dataset is visited twice: the ranges of the outputs are accumulated first, which
+ * then bound the histograms accumulated on the second visit. The histogram of each output is the
+ * one of its values over all the batches, as if they were concatenated, and the batches can be
+ * accumulated concurrently, e.g. from several executors.
+ */
+class CalibrationStatsNode : public Object {
+ public:
+  /*! \brief The number of outputs of the profile graph. */
+  int num_outputs;
+  /*! \brief The number of bins of the histograms for KL divergence minimization. */
+  int num_bins;
+  /*! \brief The number of bins of the histograms of the absolute values, for percentiles. */
+  int num_abs_bins;
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("num_outputs", &num_outputs);
+    v->Visit("num_bins", &num_bins);
+    v->Visit("num_abs_bins", &num_abs_bins);
+  }
+
+  void Init() { stats_.resize(num_outputs); }
+
+  /*! \brief Accumulate the range of an output on a batch. */
+  void UpdateRange(int index, const runtime::NDArray& output) {
+    std::vector<float> data = GetData(index, output);
+    float min_val = std::numeric_limits<float>::infinity();
+    float max_val = -std::numeric_limits<float>::infinity();
+    for (float x : data) {
+      min_val = std::min(min_val, x);
+      max_val = std::max(max_val, x);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats& stats = stats_[index];
+    stats.min_val = std::min(stats.min_val, min_val);
+    stats.max_val = std::max(stats.max_val, max_val);
+    stats.size += data.size();
+  }
+
+  /*! \brief Accumulate the histograms of an output on a batch, within its accumulated range. */
+  void UpdateHistogram(int index, const runtime::NDArray& output) {
+    std::vector<float> data = GetData(index, output);
+    double lo, hi, abs_max;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      GetRange(stats_[index], &lo, &hi, &abs_max);
+    }
+    std::vector<int64_t> hist(num_bins, 0);
+    std::vector<int64_t> abs_hist(num_abs_bins, 0);
+    double norm = num_bins / (hi - lo);
+    double abs_norm = abs_max > 0 ? num_abs_bins / abs_max : 0.0;
+    for (float x : data) {
+      // as numpy.histogram, the values out of the range are ignored
+      if (x >= lo && x <= hi) {
+        ++hist[std::min(static_cast<int>((x - lo) * norm), num_bins - 1)];
+      }
+      double abs_x = std::abs(x);
+      if (abs_x <= abs_max) {
+        ++abs_hist[std::min(static_cast<int>(abs_x * abs_norm), num_abs_bins - 1)];
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats& stats = stats_[index];
+    stats.hist.resize(num_bins, 0);
+    stats.abs_hist.resize(num_abs_bins, 0);
+    for (int i = 0; i < num_bins; ++i) stats.hist[i] += hist[i];
+    for (int i = 0; i < num_abs_bins; ++i) stats.abs_hist[i] += abs_hist[i];
+  }
+
+  /*! \brief The threshold of each output minimizing the KL divergence of its quantization. */
+  Array<FloatImm> FindScalesByKL(int num_quantized_bins) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<double> scales(num_outputs, 0.0);
+    if (num_outputs == 0) return {};
+    support::parallel_for(0, num_outputs, [&](int index) {
+      const Stats& stats = stats_[index];
+      ICHECK_EQ(stats.hist.size(), static_cast<size_t>(num_bins))
+          << "The histogram of output " << index << " is not accumulated";
+      double lo, hi, abs_max;
+      GetRange(stats, &lo, &hi, &abs_max);
+      // The counts are scaled down to fit in the int histogram, which the KL divergence of the
+      // normalized distributions is insensitive to.
+      int64_t max_count = *std::max_element(stats.hist.begin(), stats.hist.end());
+      int64_t divisor = max_count / std::numeric_limits<int>::max() + 1;
+      std::vector<int> hist(num_bins);
+      std::vector<float> hist_edges(num_bins + 1);
+      for (int i = 0; i < num_bins; ++i) hist[i] = static_cast<int>(stats.hist[i] / divisor);
+      for (int i = 0; i <= num_bins; ++i) hist_edges[i] = lo + (hi - lo) * i / num_bins;
+      scales[index] = MinimizeKL(hist, hist_edges, num_bins, num_quantized_bins);
+    });
+    Array<FloatImm> ret;
+    for (double scale : scales) ret.push_back(FloatImm(DataType::Float(32), scale));
+    return ret;
+  }
+
+  /*!
+   * \brief The percentile of the absolute values of each output, up to the width of a bin of
+   * its histogram of the absolute values.
+   */
+  Array<FloatImm> FindScalesByPercentile(double percentile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Array<FloatImm> ret;
+    for (int index = 0; index < num_outputs; ++index) {
+      const Stats& stats = stats_[index];
+      ICHECK_EQ(stats.abs_hist.size(), static_cast<size_t>(num_abs_bins))
+          << "The histogram of output " << index << " is not accumulated";
+      double lo, hi, abs_max;
+      GetRange(stats, &lo, &hi, &abs_max);
+      // the value at the rank of the percentile, in the ascending order
+      int64_t rank = static_cast<int64_t>(stats.size * percentile);
+      int64_t count = 0;
+      double scale = abs_max;
+      for (int i = 0; i < num_abs_bins; ++i) {
+        count += stats.abs_hist[i];
+        if (count > rank) {
+          scale = std::min(abs_max, abs_max * (i + 1) / num_abs_bins);
+          break;
+        }
+      }
+      ret.push_back(FloatImm(DataType::Float(32), scale));
+    }
+    return ret;
+  }
+
+  static constexpr const char* _type_key = "relay.quantize.CalibrationStats";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CalibrationStatsNode, Object);
+
+ private:
+  /*! \brief The accumulated statistics of an output. */
+  struct Stats {
+    float min_val = std::numeric_limits<float>::infinity();
+    float max_val = -std::numeric_limits<float>::infinity();
+    int64_t size = 0;
+    std::vector<int64_t> hist;
+    std::vector<int64_t> abs_hist;
+  };
+
+  std::vector<float> GetData(int index, runtime::NDArray output) const {
+    ICHECK(index >= 0 && index < num_outputs) << "The output index " << index << " is out of range";
+    ICHECK(output.DataType() == DataType::Float(32))
+        << "TypeError: Expect float32 outputs to calibrate, but gets " << output.DataType();
+    if (output->device.device_type != kDLCPU) {
+      output = output.CopyTo(Device{kDLCPU, 0});
+    }
+    int64_t size = 1;
+    for (int64_t dim : output.Shape()) size *= dim;
+    const float* data = reinterpret_cast<const float*>(static_cast<const char*>(output->data) +
+                                                       output->byte_offset);
+    return std::vector<float>(data, data + size);
+  }
+
+  /*! \brief The symmetric range of the histogram of an output, as in _find_scale_by_kl. */
+  static void GetRange(const Stats& stats, double* lo, double* hi, double* abs_max) {
+    ICHECK_GT(stats.size, 0) << "The range of the output is not accumulated";
+    *abs_max = std::max(std::abs(stats.min_val), std::abs(stats.max_val));
+    // as numpy.histogram, an empty range is extended by 0.5 on both sides
+    *hi = *abs_max > 0 ? *abs_max : 0.5;
+    *lo = -*hi;
+  }
+
+  std::mutex mutex_;
+  std::vector<Stats> stats_;
+};
+
+/*!
+ * \brief Managed reference to CalibrationStatsNode.
+ * \sa CalibrationStatsNode
+ */
+class CalibrationStats : public ObjectRef {
+ public:
+  CalibrationStats(int num_outputs, int num_bins, int num_abs_bins) {
+    CHECK_GE(num_outputs, 0) << "ValueError: `num_outputs` must be non-negative";
+    CHECK_GT(num_bins, 0) << "ValueError: `num_bins` must be positive";
+    CHECK_GT(num_abs_bins, 0) << "ValueError: `num_abs_bins` must be positive";
+    ObjectPtr<CalibrationStatsNode> n = make_object<CalibrationStatsNode>();
+    n->num_outputs = num_outputs;
+    n->num_bins = num_bins;
+    n->num_abs_bins = num_abs_bins;
+    n->Init();
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CalibrationStats, ObjectRef, CalibrationStatsNode);
+};
+
+TVM_REGISTER_NODE_TYPE(CalibrationStatsNode);
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStats")
+    .set_body_typed([](int num_outputs, int num_bins, int num_abs_bins) {
+      return CalibrationStats(num_outputs, num_bins, num_abs_bins);
+    });
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsUpdateRange")
+    .set_body_typed([](CalibrationStats stats, int index, runtime::NDArray output) {
+      stats->UpdateRange(index, output);
+    });
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsUpdateHistogram")
+    .set_body_typed([](CalibrationStats stats, int index, runtime::NDArray output) {
+      stats->UpdateHistogram(index, output);
+    });
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsFindScalesByKL")
+    .set_body_typed([](CalibrationStats stats, int num_quantized_bins) {
+      return stats->FindScalesByKL(num_quantized_bins);
+    });
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsFindScalesByPercentile")
+    .set_body_typed([](CalibrationStats stats, double percentile) {
+      return stats->FindScalesByPercentile(percentile);
+    });
+
 TVM_REGISTER_GLOBAL("relay._quantize.FindScaleByKLMinimization")
     .set_body([](TVMArgs args, TVMRetValue* ret) {
       int* hist_ptr = static_cast<int*>(static_cast<void*>(args[0]));
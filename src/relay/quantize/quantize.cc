@@ -131,6 +131,7 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
       p->stream << "round_for_shift==" << op->round_for_shift << ", ";
       p->stream << "debug_enabled_ops==" << op->debug_enabled_ops << ", ";
       p->stream << "rounding==" << op->rounding << ", ";
+      p->stream << "calibrate_num_workers==" << op->calibrate_num_workers << ", ";
       p->stream << "partition_conversions==" << op->partition_conversions;
       p->stream << ")";
     });
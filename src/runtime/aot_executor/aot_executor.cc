@@ -28,6 +28,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/name_transforms.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <limits>
 #include <memory>
@@ -149,6 +150,10 @@ PackedFunc AotExecutor::GetFunction(const std::string& name,
   } else if (name == "get_num_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
+  } else if (name == "set_thread_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->thread_pool_ = args[0].operator std::string();
+    });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
   } else if (name == "get_input_index") {
@@ -178,6 +183,7 @@ void AotExecutor::Run() {
 
   TVMArgs args{call_values.get(), call_type_codes.get(), num_args};
   TVMRetValue rv;
+  threading::ThreadPoolScope thread_pool_scope(thread_pool_);
   pf.CallPacked(args, &rv);
 }
 
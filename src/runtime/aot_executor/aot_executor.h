@@ -139,6 +139,9 @@ class TVM_DLL AotExecutor : public ModuleNode {
 
   /*! \brief Holds one NDArray per function argument in the same order. */
   std::vector<NDArray> args_;
+
+  /*! \brief The named thread pool to run on, or empty for the default one. */
+  std::string thread_pool_;
 };
 
 }  // namespace runtime
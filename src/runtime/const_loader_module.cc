@@ -26,21 +26,179 @@
  * and/or interpretation more convenient. In addition, the clear separation of
  * code and constants significantly reduces the efforts for handling external
  * codegen and runtimes.
+ *
+ * A submodule is initialized at the first call of its function, or ahead of it by
+ * ModuleInitImports, which initializes the independent submodules in parallel.
+ *
+ * The constants of identical contents, e.g. the same weights bound to several subgraphs, share
+ * one NDArray, which is saved once and handed to each submodule without a copy.
+ *
+ * With a const alignment set for export, the data of the arrays is saved raw at aligned offsets
+ * of the module blob, so that the arrays loaded from a library view the blob in place, as it is
+ * mapped read-only and shared across the processes by the dynamic loader.
  */
+#include <dmlc/io.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/string.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "library_module.h"
 #include "meta_data.h"
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The number of arrays saved in place of the count of the arrays, marking the format in
+ *  which the arrays shared by several variables are saved once.
+ */
+constexpr uint64_t kSharedConstArraysMagic = 0xC0457A2A5EA7EDULL;
+
+/*!
+ * \brief The number of arrays saved in place of the count of the arrays, marking the format in
+ *  which the data of the arrays is saved raw at aligned offsets.
+ */
+constexpr uint64_t kAlignedConstArraysMagic = 0xC0457A2A11C3EDULL;
+
+/*! \brief The alignment of the module blob embedded in a library, see codegen_blob.cc. */
+constexpr int64_t kMaxConstAlignment = 4096;
+
+/*!
+ * \brief Save an array with its data at an offset aligned in the module blob, assuming the stream
+ *  is the one of the modules of a blob.
+ */
+static void SaveAlignedArray(dmlc::SeekStream* stream, NDArray arr, int64_t alignment) {
+  if (arr->device.device_type != kDLCPU) {
+    arr = arr.CopyTo(Device{kDLCPU, 0});
+  }
+  ICHECK(arr.IsContiguous()) << "Can only save contiguous constants";
+  stream->Write(arr->dtype);
+  stream->Write(std::vector<int64_t>(arr->shape, arr->shape + arr->ndim));
+  uint64_t nbytes = GetDataSize(*arr.operator->());
+  stream->Write(nbytes);
+  uint64_t pos = kModuleBlobHeaderBytes + stream->Tell() + sizeof(uint64_t);
+  uint64_t padding = (alignment - pos % alignment) % alignment;
+  stream->Write(padding);
+  std::vector<char> zeros(padding, 0);
+  stream->Write(zeros.data(), zeros.size());
+  stream->Write(static_cast<const char*>(arr->data) + arr->byte_offset, nbytes);
+}
+
+/*!
+ * \brief Load an array saved by SaveAlignedArray. It views the data in place when the stream is
+ *  the one of the module blob being loaded and the data is aligned as NDArrays require.
+ */
+static NDArray LoadAlignedArray(dmlc::Stream* stream) {
+  DLDataType dtype;
+  std::vector<int64_t> shape;
+  uint64_t nbytes, padding;
+  ICHECK(stream->Read(&dtype)) << "Loading the dtype of a constant failed";
+  ICHECK(stream->Read(&shape)) << "Loading the shape of a constant failed";
+  ICHECK(stream->Read(&nbytes)) << "Loading the size of a constant failed";
+  ICHECK(stream->Read(&padding)) << "Loading the padding of a constant failed";
+  std::vector<char> skipped(padding);
+  ICHECK_EQ(stream->Read(skipped.data(), padding), padding) << "Loading a constant failed";
+  const ModuleBlobContext* context = ModuleBlobContext::ThreadLocal();
+  auto* seek_stream = dynamic_cast<dmlc::SeekStream*>(stream);
+  if (context->stream == stream && seek_stream != nullptr && DMLC_IO_NO_ENDIAN_SWAP) {
+    const char* data = context->data + seek_stream->Tell();
+    if (reinterpret_cast<uintptr_t>(data) % kAllocAlignment == 0) {
+      /*! \brief The view of a constant, which keeps the owner of the blob alive. */
+      struct BlobView {
+        ObjectRef owner;
+        std::vector<int64_t> shape;
+        DLManagedTensor tensor;
+      };
+      auto* view = new BlobView{context->owner, shape, DLManagedTensor()};
+      DLTensor& tensor = view->tensor.dl_tensor;
+      tensor.data = const_cast<char*>(data);
+      tensor.device = Device{kDLCPU, 0};
+      tensor.ndim = static_cast<int>(view->shape.size());
+      tensor.dtype = dtype;
+      tensor.shape = view->shape.data();
+      tensor.strides = nullptr;
+      tensor.byte_offset = 0;
+      view->tensor.manager_ctx = view;
+      view->tensor.deleter = [](DLManagedTensor* self) {
+        delete static_cast<BlobView*>(self->manager_ctx);
+      };
+      seek_stream->Seek(seek_stream->Tell() + nbytes);
+      return NDArray::FromDLPack(&view->tensor);
+    }
+  }
+  NDArray arr = NDArray::Empty(shape, dtype, Device{kDLCPU, 0});
+  ICHECK_EQ(GetDataSize(*arr.operator->()), nbytes) << "Mismatched size of a constant";
+  ICHECK_EQ(stream->Read(arr->data, nbytes), nbytes) << "Loading the data of a constant failed";
+  if (!DMLC_IO_NO_ENDIAN_SWAP) {
+    size_t elem_bytes = (dtype.bits + 7) / 8;
+    dmlc::ByteSwap(arr->data, elem_bytes, nbytes / elem_bytes);
+  }
+  return arr;
+}
+
+/*!
+ * \brief Share one NDArray between the constant variables of identical contents. Only the
+ *  contiguous arrays on the host are compared, the others are kept as they are.
+ */
+static std::unordered_map<std::string, NDArray> DeduplicateConstants(
+    const std::unordered_map<std::string, NDArray>& const_var_ndarray) {
+  // The variables are visited by name, so that the shared array does not depend on the order of
+  // the hash map.
+  std::vector<std::string> names;
+  for (const auto& kv : const_var_ndarray) {
+    names.push_back(kv.first);
+  }
+  std::sort(names.begin(), names.end());
+  auto bytes_of = [](const NDArray& arr) {
+    return std::string_view(static_cast<const char*>(arr->data) + arr->byte_offset,
+                            GetDataSize(*arr.operator->()));
+  };
+  auto same_content = [&bytes_of](const NDArray& a, const NDArray& b) {
+    if (a->ndim != b->ndim || a.DataType() != b.DataType() ||
+        !std::equal(a->shape, a->shape + a->ndim, b->shape)) {
+      return false;
+    }
+    return bytes_of(a) == bytes_of(b);
+  };
+  std::unordered_map<size_t, std::vector<NDArray>> arrays_by_hash;
+  std::unordered_map<std::string, NDArray> result;
+  for (const std::string& name : names) {
+    NDArray arr = const_var_ndarray.at(name);
+    if (!arr.defined() || arr->device.device_type != kDLCPU || !arr.IsContiguous()) {
+      result[name] = arr;
+      continue;
+    }
+    std::vector<NDArray>& arrays = arrays_by_hash[std::hash<std::string_view>()(bytes_of(arr))];
+    auto it = std::find_if(arrays.begin(), arrays.end(),
+                           [&](const NDArray& other) { return same_content(arr, other); });
+    if (it != arrays.end()) {
+      VLOG(1) << "Constant '" << name << "' shares the array of an identical constant";
+      result[name] = *it;
+    } else {
+      arrays.push_back(arr);
+      result[name] = arr;
+    }
+  }
+  return result;
+}
+
 /*!
  * \brief The const-loader module is designed to manage initialization of the
  * imported submodules for the C++ runtime.
@@ -63,29 +221,33 @@ class ConstLoaderModuleNode : public ModuleNode {
             << "ConstLoaderModuleNode is missing entry for constant '" << var << "' for function '"
             << kv.first << "'";
       }
-      initialized_[kv.first] = false;
+      // The flags are constructed in place, they are only looked up afterwards.
+      init_flags_[kv.first];
     }
   }
 
   PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
     VLOG(1) << "ConstLoaderModuleNode::GetFunction(" << name << ")";
-    // Initialize and memoize the module.
-    // Usually, we have some warmup runs. The module initialization should be
-    // done at this stage. Therefore, runtime overhead is not a concern.
-    if (initialized_.count(name) && !initialized_.at(name)) {
-      this->InitSubModule(name);
-      initialized_[name] = true;
-    }
-
     // Run the module.
     // Normally we would only have a limited number of submodules. The runtime
     // symobl lookup overhead should be minimal.
     ICHECK(!this->imports().empty());
+    PackedFunc pf(nullptr);
     for (Module it : this->imports()) {
-      PackedFunc pf = it.GetFunction(name);
-      if (pf != nullptr) return pf;
+      pf = it.GetFunction(name);
+      if (pf != nullptr) break;
     }
-    return PackedFunc(nullptr);
+    auto it = init_flags_.find(name);
+    if (pf == nullptr || it == init_flags_.end()) {
+      return pf;
+    }
+    // Initialize and memoize the module at the first call, so that loading a module with many
+    // submodules does not initialize the ones that are never run.
+    std::once_flag* flag = &it->second;
+    return PackedFunc([sptr_to_self, this, flag, name, pf](TVMArgs args, TVMRetValue* rv) {
+      InitSubModuleOnce(flag, name);
+      pf.CallPacked(args, rv);
+    });
   }
 
   const char* type_key() const final { return "const_loader"; }
@@ -138,22 +300,152 @@ class ConstLoaderModuleNode : public ModuleNode {
     }
   }
 
+  /*! \brief Initialize a submodule unless it is, thread-safe. */
+  void InitSubModuleOnce(std::once_flag* flag, const std::string& symbol) {
+    std::call_once(*flag, [this, &symbol]() { this->InitSubModule(symbol); });
+  }
+
+  /*! \brief Initialize a submodule unless it is, by its symbol. */
+  void InitSubModuleOnce(const std::string& symbol) {
+    auto it = init_flags_.find(symbol);
+    ICHECK(it != init_flags_.end()) << "No constants known for function '" << symbol << "'";
+    InitSubModuleOnce(&it->second, symbol);
+  }
+
+  /*!
+   * \brief Initialize the submodules of const-loader modules in parallel. The submodules are
+   *  independent, each of them is initialized under its own flag.
+   * \param symbols The modules and the symbols of their submodules to be initialized.
+   * \param num_threads The number of threads, the number of cores if not positive.
+   */
+  static void InitSubModulesParallel(
+      const std::vector<std::pair<ConstLoaderModuleNode*, std::vector<std::string>>>& symbols,
+      int num_threads) {
+    std::vector<std::pair<ConstLoaderModuleNode*, const std::string*>> jobs;
+    for (const auto& kv : symbols) {
+      for (const std::string& symbol : kv.second) {
+        jobs.emplace_back(kv.first, &symbol);
+      }
+    }
+    if (num_threads <= 0) {
+      num_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    }
+    num_threads = std::min<int>(num_threads, jobs.size());
+    std::atomic<size_t> next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+      for (size_t i = next++; i < jobs.size(); i = next++) {
+        try {
+          jobs[i].first->InitSubModuleOnce(*jobs[i].second);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (error == nullptr) error = std::current_exception();
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /*! \brief The const-loader modules in the import tree of a module. */
+  static std::vector<ConstLoaderModuleNode*> CollectConstLoaders(const Module& mod) {
+    std::vector<ConstLoaderModuleNode*> loaders;
+    std::vector<const ModuleNode*> stack{mod.operator->()};
+    std::unordered_set<const ModuleNode*> visited;
+    while (!stack.empty()) {
+      const ModuleNode* node = stack.back();
+      stack.pop_back();
+      if (!visited.insert(node).second) {
+        continue;
+      }
+      if (const auto* loader = dynamic_cast<const ConstLoaderModuleNode*>(node)) {
+        loaders.push_back(const_cast<ConstLoaderModuleNode*>(loader));
+      }
+      for (const Module& import : node->imports()) {
+        stack.push_back(import.operator->());
+      }
+    }
+    return loaders;
+  }
+
+  /*!
+   * \brief Initialize the submodules of all the const-loader modules in the import tree of a
+   *  module in parallel.
+   */
+  static void InitImports(const Module& mod, int num_threads) {
+    std::vector<std::pair<ConstLoaderModuleNode*, std::vector<std::string>>> symbols;
+    for (ConstLoaderModuleNode* loader : CollectConstLoaders(mod)) {
+      symbols.emplace_back(loader, std::vector<std::string>());
+      for (const auto& kv : loader->const_vars_by_symbol_) {
+        symbols.back().second.push_back(kv.first);
+      }
+    }
+    InitSubModulesParallel(symbols, num_threads);
+  }
+
+  /*!
+   * \brief Set the alignment in the module blob of the data of the constants of all the
+   *  const-loader modules in the import tree of a module, for export.
+   * \param alignment The alignment in bytes, 0 to save the constants as NDArrays.
+   */
+  static void SetConstAlignment(const Module& mod, int64_t alignment) {
+    CHECK(alignment == 0 || (alignment >= static_cast<int64_t>(kAllocAlignment) &&
+                             alignment <= kMaxConstAlignment && (alignment & (alignment - 1)) == 0))
+        << "ValueError: The const alignment must be 0 or a power of two in [" << kAllocAlignment
+        << ", " << kMaxConstAlignment << "], but gets " << alignment;
+    for (ConstLoaderModuleNode* loader : CollectConstLoaders(mod)) {
+      loader->const_alignment_ = alignment;
+    }
+  }
+
   void SaveToBinary(dmlc::Stream* stream) final {
     std::vector<std::string> variables;
     std::vector<NDArray> const_var_ndarray;
+    std::vector<uint64_t> array_indices;
+    std::unordered_map<const Object*, uint64_t> array_index;
     for (const auto& it : const_var_ndarray_) {
       String var_name = it.first;
       variables.push_back(var_name);
-      const_var_ndarray.push_back(it.second);
+      auto inserted = array_index.emplace(it.second.get(), const_var_ndarray.size());
+      if (inserted.second) {
+        const_var_ndarray.push_back(it.second);
+      }
+      array_indices.push_back(inserted.first->second);
     }
 
     // Save all variables in the function.
     stream->Write(variables);
-    // Save all constant data.
+    // Save all constant data, the arrays shared by several variables once.
     uint64_t sz = static_cast<uint64_t>(const_var_ndarray.size());
-    stream->Write(sz);
-    for (uint64_t i = 0; i < sz; i++) {
-      const_var_ndarray[i].Save(stream);
+    auto* seek_stream = dynamic_cast<dmlc::SeekStream*>(stream);
+    if (const_alignment_ > 0 && seek_stream != nullptr && DMLC_IO_NO_ENDIAN_SWAP) {
+      stream->Write(kAlignedConstArraysMagic);
+      stream->Write(sz);
+      for (uint64_t i = 0; i < sz; i++) {
+        SaveAlignedArray(seek_stream, const_var_ndarray[i], const_alignment_);
+      }
+      stream->Write(array_indices);
+    } else {
+      if (sz != variables.size()) {
+        stream->Write(kSharedConstArraysMagic);
+      }
+      stream->Write(sz);
+      for (uint64_t i = 0; i < sz; i++) {
+        const_var_ndarray[i].Save(stream);
+      }
+      if (sz != variables.size()) {
+        stream->Write(array_indices);
+      }
     }
 
     // Save the symbol to list of required constant variables mapping
@@ -180,20 +472,44 @@ class ConstLoaderModuleNode : public ModuleNode {
     ICHECK(stream->Read(&variables)) << "Loading variable names failed";
     uint64_t sz;
     ICHECK(stream->Read(&sz, sizeof(sz))) << "Loading number of vars failed";
-    ICHECK_EQ(static_cast<size_t>(sz), variables.size())
-        << "The number of variables and ndarray counts must match";
+    bool aligned_arrays = sz == kAlignedConstArraysMagic;
+    bool shared_arrays = sz == kSharedConstArraysMagic || aligned_arrays;
+    if (shared_arrays) {
+      ICHECK(stream->Read(&sz, sizeof(sz))) << "Loading number of arrays failed";
+    } else {
+      ICHECK_EQ(static_cast<size_t>(sz), variables.size())
+          << "The number of variables and ndarray counts must match";
+    }
     // Load the list of ndarray.
     std::vector<NDArray> arrays;
     for (uint64_t i = 0; i < sz; i++) {
+      if (aligned_arrays) {
+        arrays.push_back(LoadAlignedArray(stream));
+        continue;
+      }
       NDArray temp;
       temp.Load(stream);
       arrays.push_back(temp);
     }
+    std::vector<uint64_t> array_indices;
+    if (shared_arrays) {
+      ICHECK(stream->Read(&array_indices)) << "Loading the arrays of the variables failed";
+      ICHECK_EQ(array_indices.size(), variables.size())
+          << "The number of variables and array indices must match";
+    } else {
+      for (uint64_t i = 0; i < sz; i++) {
+        array_indices.push_back(i);
+      }
+    }
 
     std::unordered_map<std::string, NDArray> const_var_ndarray;
-    for (uint64_t i = 0; i < sz; i++) {
+    for (size_t i = 0; i < variables.size(); i++) {
       ICHECK_EQ(const_var_ndarray.count(variables[i]), 0U);
-      const_var_ndarray[variables[i]] = arrays[i];
+      ICHECK_LT(array_indices[i], arrays.size());
+      const_var_ndarray[variables[i]] = arrays[array_indices[i]];
+    }
+    if (!shared_arrays) {
+      const_var_ndarray = DeduplicateConstants(const_var_ndarray);
     }
 
     // Load the symbol to list of required constant variables mapping
@@ -219,10 +535,12 @@ class ConstLoaderModuleNode : public ModuleNode {
 
  private:
   /*!
-   * \brief Record if a module is initialized. It is needed by imported
-   * modules using execution engine.
+   * \brief The flags of the initialization of the submodules, by symbol. It is needed by
+   * imported modules using execution engine.
    */
-  std::unordered_map<std::string, bool> initialized_;
+  std::unordered_map<std::string, std::once_flag> init_flags_;
+  /*! \brief The alignment of the data of the constants when saved, 0 to save them as NDArrays. */
+  int64_t const_alignment_ = 0;
   /*! \brief Variable name to NDArray mapping. */
   std::unordered_map<std::string, NDArray> const_var_ndarray_;
   /*! \brief Symbol name to required constant variables mapping. */
@@ -232,7 +550,8 @@ class ConstLoaderModuleNode : public ModuleNode {
 Module ConstLoaderModuleCreate(
     const std::unordered_map<std::string, NDArray>& const_var_ndarray,
     const std::unordered_map<std::string, std::vector<std::string>>& const_vars_by_symbol) {
-  auto n = make_object<ConstLoaderModuleNode>(const_var_ndarray, const_vars_by_symbol);
+  auto n = make_object<ConstLoaderModuleNode>(DeduplicateConstants(const_var_ndarray),
+                                              const_vars_by_symbol);
   return Module(n);
 }
 
@@ -240,6 +559,9 @@ TVM_REGISTER_GLOBAL("runtime.module.loadbinary_metadata")
     .set_body_typed(ConstLoaderModuleNode::LoadFromBinary);
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_const_loader")
     .set_body_typed(ConstLoaderModuleNode::LoadFromBinary);
+TVM_REGISTER_GLOBAL("runtime.ModuleInitImports").set_body_typed(ConstLoaderModuleNode::InitImports);
+TVM_REGISTER_GLOBAL("runtime.ModuleSetConstAlignment")
+    .set_body_typed(ConstLoaderModuleNode::SetConstAlignment);
 
 }  // namespace runtime
 }  // namespace tvm
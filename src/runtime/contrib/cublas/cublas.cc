@@ -21,9 +21,13 @@
  * \file Use external cblas library call.
  */
 #include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
 #include "../cblas/gemm_common.h"
 #include "cublas_utils.h"
 
@@ -343,6 +347,126 @@ inline void CallBatchGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl)
       algo));
 }
 
+/*!
+ * \brief Grouped matrix multiplication for row major, e.g. of the tokens routed to the experts of
+ *  a mixture of experts: Y[indptr[g]:indptr[g + 1]] = X[indptr[g]:indptr[g + 1]] * W[g].
+ *
+ * The groups are given by indptr, whose values are only known on the device, so that they may be
+ * computed by the model. With cuBLAS 12.5 or higher, the GEMMs of all the groups are launched at
+ * once by cublasGemmGroupedBatchedEx, and one by one otherwise.
+ */
+inline void CallGroupedGemm(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl) {
+  DLTensor* X = args[0];
+  DLTensor* W = args[1];
+  DLTensor* indptr = args[2];
+  DLTensor* Y = args[3];
+  bool transb = args.size() > 4 ? args[4] : false;
+  ICHECK_EQ(X->ndim, 2);
+  ICHECK_EQ(W->ndim, 3);
+  ICHECK_EQ(indptr->ndim, 1);
+  ICHECK_EQ(Y->ndim, 2);
+  ICHECK(IsContiguous(*X) && IsContiguous(*W) && IsContiguous(*Y))
+      << "grouped matmul expects contiguous tensors";
+  ICHECK(TypeMatch(indptr->dtype, kDLInt, 64)) << "grouped matmul expects int64 group offsets";
+  ICHECK(TypeEqual(X->dtype, W->dtype));
+  ICHECK(TypeEqual(X->dtype, Y->dtype) ||
+         (TypeMatch(X->dtype, kDLFloat, 16) && TypeMatch(Y->dtype, kDLFloat, 32)))
+      << "Unsupported data type";
+  ICHECK(TypeMatch(X->dtype, kDLFloat, 16) || TypeMatch(X->dtype, kDLFloat, 32) ||
+         TypeMatch(X->dtype, kDLFloat, 64))
+      << "Unsupported data type";
+
+  int num_groups = W->shape[0];
+  int K = X->shape[1];
+  int N = transb ? W->shape[1] : W->shape[2];
+  ICHECK_EQ(indptr->shape[0], num_groups + 1);
+  ICHECK_EQ(transb ? W->shape[2] : W->shape[1], K);
+  ICHECK_EQ(Y->shape[0], X->shape[0]);
+  ICHECK_EQ(Y->shape[1], N);
+
+  cudaStream_t stream = static_cast<cudaStream_t>(CUDAThreadEntry::ThreadLocal()->stream);
+  std::vector<int64_t> offsets(num_groups + 1);
+  CUDA_CALL(cudaMemcpyAsync(offsets.data(), static_cast<char*>(indptr->data) + indptr->byte_offset,
+                            offsets.size() * sizeof(int64_t), cudaMemcpyDefault, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+
+  int x_bytes = X->dtype.bits / 8;
+  int y_bytes = Y->dtype.bits / 8;
+  auto X_data = static_cast<char*>(X->data) + X->byte_offset;
+  auto W_data = static_cast<char*>(W->data) + W->byte_offset;
+  auto Y_data = static_cast<char*>(Y->data) + Y->byte_offset;
+  // The problems of the non-empty groups, in column major as Y[g]^T = W[g]^T * X[g]^T.
+  std::vector<int> m_array;
+  std::vector<const void*> a_array, b_array;
+  std::vector<void*> c_array;
+  for (int g = 0; g < num_groups; ++g) {
+    ICHECK(offsets[g] <= offsets[g + 1] && offsets[g + 1] <= X->shape[0])
+        << "ValueError: The offsets of the groups must be sorted and within the rows of X, but "
+        << "the group " << g << " spans the rows [" << offsets[g] << ", " << offsets[g + 1] << ")";
+    if (offsets[g] == offsets[g + 1]) continue;
+    m_array.push_back(offsets[g + 1] - offsets[g]);
+    a_array.push_back(W_data + static_cast<int64_t>(g) * K * N * x_bytes);
+    b_array.push_back(X_data + offsets[g] * K * x_bytes);
+    c_array.push_back(Y_data + offsets[g] * N * y_bytes);
+  }
+  int num_problems = m_array.size();
+  if (num_problems == 0) return;
+
+  cudaDataType_t cuda_in_type = GetCudaDataType(X->dtype);
+  cudaDataType_t cuda_out_type = GetCudaDataType(Y->dtype);
+  cublasOperation_t op_w = CUBLASBooleanToTranspose(transb);
+  int ld_w = transb ? K : N;
+  double alpha = args.size() > 5 ? args[5] : 1.0;
+  double beta = args.size() > 6 ? args[6] : 0.0;
+  bool is_double = TypeMatch(Y->dtype, kDLFloat, 64);
+  auto alpha_float = static_cast<float>(alpha);
+  auto beta_float = static_cast<float>(beta);
+  const void* alpha_ptr = is_double ? static_cast<const void*>(&alpha) : &alpha_float;
+  const void* beta_ptr = is_double ? static_cast<const void*>(&beta) : &beta_float;
+
+#if defined(CUBLAS_VERSION) && CUBLAS_VERSION >= 120500
+  if (TypeEqual(X->dtype, Y->dtype)) {
+    // The pointers of the matrices are read on the device, and the rest on the host.
+    std::vector<cublasOperation_t> trans_w(num_problems, op_w), trans_x(num_problems, CUBLAS_OP_N);
+    std::vector<int> n_array(num_problems, N), k_array(num_problems, K);
+    std::vector<int> lda_array(num_problems, ld_w), ldb_array(num_problems, K);
+    std::vector<int> ldc_array(num_problems, N), group_size(num_problems, 1);
+    std::vector<double> alpha_double(num_problems, alpha), beta_double(num_problems, beta);
+    std::vector<float> alpha_floats(num_problems, alpha_float);
+    std::vector<float> beta_floats(num_problems, beta_float);
+    std::vector<const void*> pointers;
+    pointers.insert(pointers.end(), a_array.begin(), a_array.end());
+    pointers.insert(pointers.end(), b_array.begin(), b_array.end());
+    pointers.insert(pointers.end(), c_array.begin(), c_array.end());
+    size_t pointer_bytes = pointers.size() * sizeof(void*);
+    Device dev = Y->device;
+    DeviceAPI* device_api = DeviceAPI::Get(dev);
+    auto device_pointers = static_cast<void**>(device_api->AllocWorkspace(dev, pointer_bytes));
+    CUDA_CALL(cudaMemcpyAsync(device_pointers, pointers.data(), pointer_bytes,
+                              cudaMemcpyHostToDevice, stream));
+    CHECK_CUBLAS_ERROR(cublasGemmGroupedBatchedEx(
+        hdl, trans_w.data(), trans_x.data(), n_array.data(), m_array.data(), k_array.data(),
+        is_double ? static_cast<const void*>(alpha_double.data()) : alpha_floats.data(),
+        device_pointers, cuda_in_type, lda_array.data(), device_pointers + num_problems,
+        cuda_in_type, ldb_array.data(),
+        is_double ? static_cast<const void*>(beta_double.data()) : beta_floats.data(),
+        device_pointers + 2 * num_problems, cuda_out_type, ldc_array.data(), num_problems,
+        group_size.data(), is_double ? CUBLAS_COMPUTE_64F : CUBLAS_COMPUTE_32F));
+    // The workspace is reused in stream order, after the GEMMs have read the pointers.
+    device_api->FreeWorkspace(dev, device_pointers);
+    return;
+  }
+#endif
+
+  cudaDataType_t compute_type = is_double ? CUDA_R_64F : CUDA_R_32F;
+  for (int i = 0; i < num_problems; ++i) {
+    CHECK_CUBLAS_ERROR(cublasGemmEx(hdl, op_w, CUBLAS_OP_N, N, m_array[i], K, alpha_ptr,
+                                    a_array[i], cuda_in_type, ld_w, b_array[i], cuda_in_type, K,
+                                    beta_ptr, c_array[i], cuda_out_type, N, compute_type,
+                                    CUBLAS_GEMM_DEFAULT));
+  }
+}
+
 // matrix multiplication for row major
 TVM_REGISTER_GLOBAL("tvm.contrib.cublas.matmul").set_body([](TVMArgs args, TVMRetValue* ret) {
   DLTensor* A = args[0];
@@ -405,5 +529,13 @@ TVM_REGISTER_GLOBAL("tvm.contrib.cublas.batch_matmul").set_body([](TVMArgs args,
   }
 });
 
+TVM_REGISTER_GLOBAL("tvm.contrib.cublas.grouped_matmul")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      CuBlasThreadEntry* entry_ptr = CuBlasThreadEntry::ThreadLocal();
+
+      CUBLASTryEnableTensorCore(entry_ptr->handle);
+      CallGroupedGemm(args, ret, entry_ptr->handle);
+    });
+
 }  // namespace contrib
 }  // namespace tvm
@@ -0,0 +1,273 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file Use external cuBLASLt library call, with the bias and activation epilogues fused.
+ */
+#include <dmlc/thread_local.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "../../cuda/cuda_common.h"
+#include "cublas_utils.h"
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+#if CUDART_VERSION >= 11030
+
+/*! \brief The bytes of the device workspace the algorithms may take. */
+static constexpr size_t kCublasLtWorkspaceBytes = 32 << 20;
+
+/*! \brief The descriptors of a matmul problem, with the algorithm the heuristic chose for it. */
+struct CublasLtMatmulPlan {
+  cublasLtMatmulDesc_t desc{nullptr};
+  cublasLtMatrixLayout_t layout_a{nullptr};
+  cublasLtMatrixLayout_t layout_b{nullptr};
+  cublasLtMatrixLayout_t layout_c{nullptr};
+  cublasLtMatmulAlgo_t algo;
+};
+
+struct CublasLtThreadEntry {
+  CublasLtThreadEntry() { CHECK_CUBLAS_ERROR(cublasLtCreate(&handle)); }
+
+  ~CublasLtThreadEntry() {
+    for (auto& kv : plans) {
+      cublasLtMatrixLayoutDestroy(kv.second.layout_a);
+      cublasLtMatrixLayoutDestroy(kv.second.layout_b);
+      cublasLtMatrixLayoutDestroy(kv.second.layout_c);
+      cublasLtMatmulDescDestroy(kv.second.desc);
+    }
+    for (auto& kv : workspaces) {
+      cudaFree(kv.second);
+    }
+    if (handle) {
+      cublasLtDestroy(handle);
+      handle = nullptr;
+    }
+  }
+
+  /*!
+   * \brief The workspace of a device and a stream, allocated at its first matmul and reused
+   *  by the next ones, which are ordered after it on the stream.
+   */
+  void* GetWorkspace(int device_id, cudaStream_t stream) {
+    void*& workspace = workspaces[std::make_pair(device_id, stream)];
+    if (workspace == nullptr) {
+      CUDA_CALL(cudaSetDevice(device_id));
+      CUDA_CALL(cudaMalloc(&workspace, kCublasLtWorkspaceBytes));
+    }
+    return workspace;
+  }
+
+  cublasLtHandle_t handle{nullptr};
+  /*! \brief The plans of the problems, by the problem they solve. */
+  std::unordered_map<std::string, CublasLtMatmulPlan> plans;
+  /*! \brief The workspaces, by the device and the stream they are used on. */
+  std::map<std::pair<int, cudaStream_t>, void*> workspaces;
+};  // CublasLtThreadEntry
+
+typedef dmlc::ThreadLocalStore<CublasLtThreadEntry> CublasLtThreadStore;
+
+/*!
+ * \brief The fused epilogue of an activation, optionally after a bias.
+ * \param activation The activation, "none", "relu" or "gelu".
+ * \param bias Whether a bias is added before the activation.
+ */
+inline cublasLtEpilogue_t GetEpilogue(const std::string& activation, bool bias) {
+  if (activation == "none") {
+    return bias ? CUBLASLT_EPILOGUE_BIAS : CUBLASLT_EPILOGUE_DEFAULT;
+  } else if (activation == "relu") {
+    return bias ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_RELU;
+  } else if (activation == "gelu") {
+    return bias ? CUBLASLT_EPILOGUE_GELU_BIAS : CUBLASLT_EPILOGUE_GELU;
+  }
+  LOG(FATAL) << "ValueError: Unknown cuBLASLt activation " << activation
+             << ", expect one of none, relu and gelu";
+  return CUBLASLT_EPILOGUE_DEFAULT;
+}
+
+/*!
+ * \brief Create the plan of a problem, with the algorithm chosen by the heuristic.
+ * \note The row-major product is computed as the column-major C^T = op(B)^T op(A)^T, so that
+ *  the bias of the columns of C is the bias of the rows of C^T, which the epilogue adds.
+ */
+CublasLtMatmulPlan CreatePlan(cublasLtHandle_t handle, int64_t batch, int64_t M, int64_t N,
+                              int64_t K, bool transa, bool transb, cudaDataType_t dtype,
+                              cublasLtEpilogue_t epilogue) {
+  CublasLtMatmulPlan plan;
+  cublasOperation_t op_a = transb ? CUBLAS_OP_T : CUBLAS_OP_N;
+  cublasOperation_t op_b = transa ? CUBLAS_OP_T : CUBLAS_OP_N;
+  CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&plan.desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+  CHECK_CUBLAS_ERROR(
+      cublasLtMatmulDescSetAttribute(plan.desc, CUBLASLT_MATMUL_DESC_TRANSA, &op_a, sizeof(op_a)));
+  CHECK_CUBLAS_ERROR(
+      cublasLtMatmulDescSetAttribute(plan.desc, CUBLASLT_MATMUL_DESC_TRANSB, &op_b, sizeof(op_b)));
+  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan.desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                    &epilogue, sizeof(epilogue)));
+  if (epilogue != CUBLASLT_EPILOGUE_DEFAULT && epilogue != CUBLASLT_EPILOGUE_RELU &&
+      epilogue != CUBLASLT_EPILOGUE_GELU) {
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan.desc, CUBLASLT_MATMUL_DESC_BIAS_DATA_TYPE, &dtype, sizeof(dtype)));
+  }
+
+  // The column-major layouts of B, A and C, i.e. of the row-major matrices transposed.
+  auto make_layout = [&](int64_t rows, int64_t cols, int64_t stride) {
+    cublasLtMatrixLayout_t layout = nullptr;
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&layout, dtype, rows, cols, rows));
+    if (batch > 1) {
+      int32_t batch_count = static_cast<int32_t>(batch);
+      CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
+          layout, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
+      CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
+          layout, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET, &stride, sizeof(stride)));
+    }
+    return layout;
+  };
+  plan.layout_a = transb ? make_layout(K, N, N * K) : make_layout(N, K, N * K);
+  plan.layout_b = transa ? make_layout(M, K, M * K) : make_layout(K, M, M * K);
+  plan.layout_c = make_layout(N, M, M * N);
+
+  cublasLtMatmulPreference_t pref = nullptr;
+  CHECK_CUBLAS_ERROR(cublasLtMatmulPreferenceCreate(&pref));
+  size_t workspace_bytes = kCublasLtWorkspaceBytes;
+  CHECK_CUBLAS_ERROR(cublasLtMatmulPreferenceSetAttribute(
+      pref, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_bytes, sizeof(workspace_bytes)));
+  cublasLtMatmulHeuristicResult_t heuristic;
+  int num_results = 0;
+  CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(handle, plan.desc, plan.layout_a,
+                                                    plan.layout_b, plan.layout_c, plan.layout_c,
+                                                    pref, 1, &heuristic, &num_results));
+  CHECK_CUBLAS_ERROR(cublasLtMatmulPreferenceDestroy(pref));
+  CHECK_GT(num_results, 0) << "ValueError: cuBLASLt has no algorithm for the matmul of "
+                           << "M=" << M << ", N=" << N << ", K=" << K << " with the epilogue "
+                           << static_cast<int>(epilogue);
+  plan.algo = heuristic.algo;
+  return plan;
+}
+
+/*!
+ * \brief Compute C = activation(op(A) op(B) + bias) in row major, of the 2D or the batched 3D
+ *  matrices, in one kernel.
+ *
+ *  The descriptors and the algorithm of each problem are created once per thread and reused by
+ *  its next matmuls, as is the workspace of each stream.
+ */
+void CallCublasLtMatmul(const DLTensor* A, const DLTensor* B, const DLTensor* bias,
+                        const DLTensor* C, bool transa, bool transb,
+                        const std::string& activation) {
+  int ndim = C->ndim;
+  ICHECK(ndim == 2 || ndim == 3) << "ValueError: cuBLASLt matmul expects 2D or 3D matrices";
+  ICHECK_EQ(A->ndim, ndim);
+  ICHECK_EQ(B->ndim, ndim);
+  ICHECK(A->strides == nullptr && B->strides == nullptr && C->strides == nullptr)
+      << "ValueError: cuBLASLt matmul expects compact matrices";
+  ICHECK(TypeEqual(A->dtype, B->dtype) && TypeEqual(A->dtype, C->dtype))
+      << "ValueError: cuBLASLt matmul expects the matrices of one dtype";
+  ICHECK(TypeMatch(C->dtype, kDLFloat, 16) || TypeMatch(C->dtype, kDLFloat, 32))
+      << "ValueError: cuBLASLt matmul expects float16 or float32 matrices";
+  int64_t batch = ndim == 3 ? C->shape[0] : 1;
+  int64_t M = transa ? A->shape[ndim - 1] : A->shape[ndim - 2];
+  int64_t K = transa ? A->shape[ndim - 2] : A->shape[ndim - 1];
+  int64_t N = transb ? B->shape[ndim - 2] : B->shape[ndim - 1];
+  ICHECK_EQ(transb ? B->shape[ndim - 1] : B->shape[ndim - 2], K);
+  ICHECK_EQ(C->shape[ndim - 2], M);
+  ICHECK_EQ(C->shape[ndim - 1], N);
+  if (ndim == 3) {
+    ICHECK(A->shape[0] == batch && B->shape[0] == batch)
+        << "ValueError: cuBLASLt batch matmul expects the matrices of one batch size";
+  }
+  if (bias != nullptr) {
+    ICHECK(bias->ndim == 1 && bias->shape[0] == N)
+        << "ValueError: The bias of cuBLASLt matmul must be a vector of the columns of C";
+    ICHECK(TypeEqual(bias->dtype, C->dtype));
+  }
+
+  CublasLtThreadEntry* entry = CublasLtThreadStore::Get();
+  cudaStream_t stream = static_cast<cudaStream_t>(CUDAThreadEntry::ThreadLocal()->stream);
+  cudaDataType_t dtype = GetCudaDataType(C->dtype);
+  cublasLtEpilogue_t epilogue = GetEpilogue(activation, bias != nullptr);
+
+  std::ostringstream key;
+  key << C->device.device_id << "_" << batch << "_" << M << "_" << N << "_" << K << "_" << transa
+      << transb << "_" << static_cast<int>(dtype) << "_" << static_cast<int>(epilogue);
+  auto it = entry->plans.find(key.str());
+  if (it == entry->plans.end()) {
+    it = entry->plans
+             .emplace(key.str(), CreatePlan(entry->handle, batch, M, N, K, transa, transb, dtype,
+                                            epilogue))
+             .first;
+  }
+  const CublasLtMatmulPlan& plan = it->second;
+  if (bias != nullptr) {
+    void* bias_ptr = static_cast<char*>(bias->data) + bias->byte_offset;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+        plan.desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias_ptr, sizeof(bias_ptr)));
+  }
+
+  float alpha = 1.0f;
+  float beta = 0.0f;
+  void* a_ptr = static_cast<char*>(A->data) + A->byte_offset;
+  void* b_ptr = static_cast<char*>(B->data) + B->byte_offset;
+  void* c_ptr = static_cast<char*>(C->data) + C->byte_offset;
+  void* workspace = entry->GetWorkspace(C->device.device_id, stream);
+  CHECK_CUBLAS_ERROR(cublasLtMatmul(entry->handle, plan.desc, &alpha, b_ptr, plan.layout_a, a_ptr,
+                                    plan.layout_b, &beta, c_ptr, plan.layout_c, c_ptr,
+                                    plan.layout_c, &plan.algo, workspace, kCublasLtWorkspaceBytes,
+                                    stream));
+}
+
+// matrix multiplication for row major, with a fused activation
+TVM_REGISTER_GLOBAL("tvm.contrib.cublaslt.matmul_activation")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      DLTensor* A = args[0];
+      DLTensor* B = args[1];
+      DLTensor* C = args[2];
+      bool transa = args[3];
+      bool transb = args[4];
+      std::string activation = args[5];
+      CallCublasLtMatmul(A, B, nullptr, C, transa, transb, activation);
+    });
+
+// matrix multiplication for row major, with a fused bias and activation
+TVM_REGISTER_GLOBAL("tvm.contrib.cublaslt.matmul_bias")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      DLTensor* A = args[0];
+      DLTensor* B = args[1];
+      DLTensor* bias = args[2];
+      DLTensor* C = args[3];
+      bool transa = args[4];
+      bool transb = args[5];
+      std::string activation = args[6];
+      CallCublasLtMatmul(A, B, bias, C, transa, transb, activation);
+    });
+
+#endif  // CUDART_VERSION >= 11030
+
+}  // namespace contrib
+}  // namespace tvm
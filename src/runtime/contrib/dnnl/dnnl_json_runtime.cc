@@ -20,14 +20,26 @@
 /*!
  * \file src/runtime/contrib/dnnl/dnnl_json_runtime.cc
  * \brief A simple JSON runtime for DNNL.
+ *
+ * The primitives of a subgraph of static shapes are built once at init. A subgraph of dynamic
+ * batch size, i.e. of shapes whose leading dimension is unknown (-1), gets its primitives built
+ * for the batch size of each call, and kept in an LRU cache of TVM_DNNL_NETWORK_CACHE_CAPACITY
+ * (16 by default) batch sizes.
  */
 
+#include <dmlc/parameter.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../json/json_node.h"
@@ -52,9 +64,15 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   DNNLJSONRuntime(const std::string& symbol_name, const std::string& graph_json,
                   const Array<String> const_names)
       : JSONRuntimeBase(symbol_name, graph_json, const_names),
+        network_cache_capacity_(std::max(1, dmlc::GetEnv("TVM_DNNL_NETWORK_CACHE_CAPACITY", 16))),
         next_unique_eid_offset_(data_entry_.size()),
         run_arg_eid_(input_var_eid_) {
     for (const auto e : outputs_) run_arg_eid_.push_back(EntryID(e));
+    for (auto nid : input_nodes_) {
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (const auto& shape : nodes_[nid].GetOpShape()) run_arg_shape_.push_back(shape);
+    }
+    for (const auto e : outputs_) run_arg_shape_.push_back(nodes_[e.id_].GetOpShape()[e.index_]);
   }
 
   const char* type_key() const override { return "dnnl_json"; }
@@ -65,18 +83,21 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     // Setup constants entries for weights.
     SetupConstants(consts);
-    BuildEngine();
+    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
+    stream_ = dnnl::stream(engine_);
+    if (!HasDynamicBatch()) static_network_ = BuildNetwork(-1);
   }
 
   /* Unused stub implementation */
   void Run() override { LOG(FATAL) << "Unreachable code"; }
 
-  /* Thread safe implementation of Run. Keep runtime instance immutable */
-  void Run(const TVMArgs& args) const {
+  /* Thread safe implementation of Run. The networks are immutable once built */
+  void Run(const TVMArgs& args) {
     auto arg_data_provider = makeIODataProvider(args);
-    auto mem_solver = tensor_registry_.MakeSolver(arg_data_provider);
+    auto network = GetNetwork(arg_data_provider);
+    auto mem_solver = network->tensor_registry.MakeSolver(arg_data_provider);
     // Execute primitives one by one
-    for (const auto& act : net_) {
+    for (const auto& act : network->net) {
       auto prim = std::get<0>(act);
       auto arg_reqs = std::get<1>(act);
 
@@ -133,6 +154,89 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   }
 
  private:
+  /* The primitives of the subgraph for a batch size, with the registry of their memory. */
+  struct Network {
+    TensorRegistry::ActionQue net;
+    TensorRegistry tensor_registry;
+  };
+
+  /* Whether the leading dimension of the shapes is dynamic. The other dimensions must be known. */
+  bool HasDynamicBatch() const {
+    bool is_dynamic = false;
+    for (const auto& node : nodes_) {
+      if (node.GetOpType() == "const") continue;
+      for (const auto& shape : node.GetOpShape()) {
+        for (size_t i = 0; i < shape.size(); ++i) {
+          if (shape[i] != -1) continue;
+          CHECK_EQ(i, 0U) << "ValueError: the DNNL JSON runtime supports a dynamic batch size, "
+                          << "but " << node.GetOpName() << " has a dynamic dimension " << i;
+          is_dynamic = true;
+        }
+      }
+    }
+    return is_dynamic;
+  }
+
+  /* The batch size of a call, checking its argument shapes against those of the subgraph. */
+  int64_t GetBatchSize(const TensorRegistry::DLTensorProvider& arg_data_provider) const {
+    int64_t batch_size = -1;
+    for (size_t i = 0; i < run_arg_shape_.size(); ++i) {
+      const DLTensor* arg = arg_data_provider(run_arg_eid_[i]);
+      const auto& shape = run_arg_shape_[i];
+      CHECK_EQ(static_cast<size_t>(arg->ndim), shape.size())
+          << "ValueError: argument " << i << " of " << symbol_name_ << " is expected to have rank "
+          << shape.size();
+      for (size_t j = 0; j < shape.size(); ++j) {
+        if (shape[j] != -1) {
+          CHECK_EQ(arg->shape[j], shape[j]) << "ValueError: argument " << i << " of "
+                                            << symbol_name_ << " has a mismatched dimension " << j;
+        } else if (batch_size == -1) {
+          batch_size = arg->shape[j];
+        } else {
+          CHECK_EQ(arg->shape[j], batch_size)
+              << "ValueError: the arguments of " << symbol_name_ << " have distinct batch sizes";
+        }
+      }
+    }
+    CHECK_NE(batch_size, -1) << "ValueError: " << symbol_name_ << " has no dynamic argument";
+    return batch_size;
+  }
+
+  /* The network of the batch size of a call, from the cache or else built. */
+  std::shared_ptr<const Network> GetNetwork(
+      const TensorRegistry::DLTensorProvider& arg_data_provider) {
+    if (static_network_ != nullptr) return static_network_;
+    int64_t batch_size = GetBatchSize(arg_data_provider);
+    std::lock_guard<std::mutex> lock(network_cache_mutex_);
+    auto it = network_cache_index_.find(batch_size);
+    if (it != network_cache_index_.end()) {
+      // Move the network to the front, as the most recently used.
+      network_cache_.splice(network_cache_.begin(), network_cache_, it->second);
+      return it->second->second;
+    }
+    auto network = BuildNetwork(batch_size);
+    network_cache_.emplace_front(batch_size, network);
+    network_cache_index_[batch_size] = network_cache_.begin();
+    if (network_cache_.size() > network_cache_capacity_) {
+      network_cache_index_.erase(network_cache_.back().first);
+      network_cache_.pop_back();
+    }
+    return network;
+  }
+
+  /* Build the network of the batch size, or of the static shapes with -1. */
+  std::shared_ptr<const Network> BuildNetwork(int64_t batch_size) {
+    batch_size_ = batch_size;
+    net_.clear();
+    next_unique_eid_offset_ = data_entry_.size();
+    BuildEngine();
+    auto network = std::make_shared<Network>();
+    network->net = std::move(net_);
+    network->tensor_registry = std::move(tensor_registry_);
+    net_.clear();
+    return network;
+  }
+
   const std::map<std::string, dnnl::algorithm> elt_name2algo{
       {"abs", dnnl::algorithm::eltwise_abs},
       {"exp", dnnl::algorithm::eltwise_exp},
@@ -247,9 +351,6 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   // Build up the engine based on the input graph.
   void BuildEngine() {
-    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
-    stream_ = dnnl::stream(engine_);
-
     std::set<uint32_t> io_eid_set(run_arg_eid_.begin(), run_arg_eid_.end());
     tensor_registry_ = TensorRegistry(engine_, io_eid_set);
 
@@ -808,6 +909,13 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     return AttrConvert<T>(attr);
   }
 
+  /* The shape of a node output, with the batch size of the network being built */
+  std::vector<int64_t> GetShape(uint32_t nid, uint32_t idx) const {
+    auto shape = nodes_[nid].GetOpShape()[idx];
+    if (!shape.empty() && shape[0] == -1) shape[0] = batch_size_;
+    return shape;
+  }
+
   TensorRequisite GetInput(const size_t& nid, const int idx) {
     if (idx == -1) return {};  // -1 reserved value for empty input.
 
@@ -816,7 +924,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     ICHECK_LT(idx, node.GetInputs().size());
     auto data_entry = node.GetInputs()[idx];
 
-    auto shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
+    auto shape = GetShape(data_entry.id_, data_entry.index_);
     auto dtype = nodes_[data_entry.id_].GetOpDataType()[data_entry.index_];
     auto eid = node_row_ptr_[data_entry.id_] + data_entry.index_;
     auto const_dl_tensor = data_entry_[eid];
@@ -845,7 +953,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     const JSONGraphNode& node = nodes_[nid];
 
     ICHECK_LT(idx, node.GetNumOutput());
-    auto shape = node.GetOpShape()[idx];
+    auto shape = GetShape(nid, idx);
     auto dtype = node.GetOpDataType()[idx];
     auto eid = node_row_ptr_[nid] + static_cast<uint32_t>(idx);
 
@@ -918,14 +1026,28 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   dnnl::engine engine_;
   /* The dnnl stream. */
   dnnl::stream stream_;
-  /* The network layers that are represented in dnnl primitives. */
+  /* The network layers that are represented in dnnl primitives, while they are built. */
   TensorRegistry::ActionQue net_;
-  /* Storage for all memory objects */
+  /* Storage for all memory objects, while the network is built */
   TensorRegistry tensor_registry_;
+  /* The batch size of the network being built, -1 for static shapes */
+  int64_t batch_size_ = -1;
+  /* The network of the static shapes, built at init */
+  std::shared_ptr<const Network> static_network_;
+  /* The networks of the dynamic batch sizes, the most recently used first */
+  std::list<std::pair<int64_t, std::shared_ptr<const Network>>> network_cache_;
+  /* Map of batch size to its position in network_cache_ */
+  std::unordered_map<int64_t, decltype(network_cache_)::iterator> network_cache_index_;
+  /* Guards the network cache, and the build of the networks */
+  std::mutex network_cache_mutex_;
+  /* Max number of networks in the cache */
+  size_t network_cache_capacity_;
   /* Generator of new unique eid which doesn't match with existing data entry */
   uint32_t next_unique_eid_offset_;
   /* Map of Run arg idx to corresponding eid */
   std::vector<uint32_t> run_arg_eid_;
+  /* Map of Run arg idx to its shape in the graph, -1 for the dynamic dimensions */
+  std::vector<std::vector<int64_t>> run_arg_shape_;
 };
 
 runtime::Module DNNLJSONRuntimeCreate(String symbol_name, String graph_json,
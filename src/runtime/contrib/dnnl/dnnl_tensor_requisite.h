@@ -26,12 +26,14 @@
 #define TVM_RUNTIME_CONTRIB_DNNL_DNNL_TENSOR_REQUISITE_H_
 
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/ndarray.h>
 
 #include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
@@ -596,12 +598,27 @@ class TensorRegistry {
 
   /*!
    * \brief Construct memory solver for all registered TRs.
+   *
+   * The external IO buffers are used in place, without copies. The intermediate buffers and the
+   * memory objects are allocated by the first call only: a solver returns them to a pool when it
+   * is destroyed, and the next call reuses them with its own IO buffers bound. The calls running
+   * concurrently get distinct intermediate buffers.
+   *
    * \param ext_provider callback to resolve external IO buffers
    * \return memory solver object to match ArgId to dnnl::memory objects
    */
   MemSolver MakeSolver(const DLTensorProvider& ext_provider) const {
-    return MemSolverImpl(eng_, ext_provider, const_mem_collection_, ext_mem_collection_,
-                         tmp_mem_collection_, tmp_mem_mapping_);
+    std::unique_ptr<MemSolverImpl> impl = solver_pool_->Acquire();
+    if (impl == nullptr) {
+      impl.reset(new MemSolverImpl(eng_, const_mem_collection_, ext_mem_collection_,
+                                   tmp_mem_collection_, tmp_mem_mapping_));
+    }
+    impl->BindExternal(ext_provider);
+    std::shared_ptr<SolverPool> pool = solver_pool_;
+    std::shared_ptr<MemSolverImpl> solver(impl.release(), [pool](MemSolverImpl* released) {
+      pool->Release(std::unique_ptr<MemSolverImpl>(released));
+    });
+    return [solver](const ArgId& ar) { return (*solver)(ar); };
   }
 
   void MarkInplace(const TensorRequisite& tr, const TensorRequisite& shared) {
@@ -658,15 +675,11 @@ class TensorRegistry {
   /*! \brief Implementation of memory solver */
   class MemSolverImpl {
    public:
-    MemSolverImpl(const dnnl::engine& eng, const DLTensorProvider& ext_data_provider,
-                  const std::vector<dnnl::memory>& const_mems,
+    MemSolverImpl(const dnnl::engine& eng, const std::vector<dnnl::memory>& const_mems,
                   const std::vector<std::pair<uint32_t, dnnl::memory::desc>>& ext_mems,
                   const std::vector<dnnl::memory::desc>& tmp_mem_descs,
                   const std::map<size_t, size_t>& tmp_mem_mapping)
-        : eng_(eng),
-          ext_data_provider_(ext_data_provider),
-          const_mems_(const_mems),
-          ext_mems_(ext_mems) {
+        : const_mems_(const_mems), ext_mems_(ext_mems) {
       // Construct temp memory objects on the fly. While we have no scratchpads
       // support on VM/GraphExecutor level.
       tmp_mems_.resize(tmp_mem_descs.size());
@@ -675,11 +688,26 @@ class TensorRegistry {
 
         if (found != tmp_mem_mapping.end()) {
           auto reuse_hdl = tmp_mems_[found->second].get_data_handle();
-          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng_, reuse_hdl);
+          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng, reuse_hdl);
         } else {
-          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng_);
+          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng);
         }
       }
+      // The memory objects of the external buffers are bound to the buffers of each call.
+      for (const auto& eid_and_desc : ext_mems) {
+        ext_mem_objs_.emplace_back(eid_and_desc.second, eng, DNNL_MEMORY_NONE);
+      }
+    }
+
+    /*! \brief Bind the memory objects of the external buffers to the buffers of a call. */
+    void BindExternal(const DLTensorProvider& ext_data_provider) {
+      for (size_t i = 0; i < ext_mems_.size(); i++) {
+        auto ext_dl_tensor = ext_data_provider(ext_mems_[i].first);
+        ICHECK(ext_dl_tensor->data);
+        ICHECK(IsContiguous(*ext_dl_tensor)) << "DNNL expects compact input and output tensors";
+        ext_mem_objs_[i].set_data_handle(static_cast<char*>(ext_dl_tensor->data) +
+                                         ext_dl_tensor->byte_offset);
+      }
     }
 
     /*! \brief Find memory object associated with provided ArgId */
@@ -689,25 +717,39 @@ class TensorRegistry {
           return const_mems_.at(ar.idx_);
         case TMP_STORAGE:
           return tmp_mems_.at(ar.idx_);
-        case EXT_EID: {
-          auto eid_and_desc = ext_mems_.at(ar.idx_);
-          auto eid = eid_and_desc.first;
-          auto desc = eid_and_desc.second;
-
-          auto ext_dl_tensor = ext_data_provider_(eid);
-          ICHECK(ext_dl_tensor->data);
-          return dnnl::memory{desc, eng_, ext_dl_tensor->data};
-        }
+        case EXT_EID:
+          return ext_mem_objs_.at(ar.idx_);
       }
       return {};
     }
 
    private:
-    const dnnl::engine& eng_;
-    const DLTensorProvider& ext_data_provider_;
     const std::vector<dnnl::memory>& const_mems_;
     const std::vector<std::pair<uint32_t, dnnl::memory::desc>>& ext_mems_;
     std::vector<dnnl::memory> tmp_mems_;
+    /* Memory objects of ext_mems_, bound to the buffers of the current call */
+    std::vector<dnnl::memory> ext_mem_objs_;
+  };
+
+  /*! \brief Pool of the solvers of the finished calls, whose memory the next calls reuse. */
+  class SolverPool {
+   public:
+    std::unique_ptr<MemSolverImpl> Acquire() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (solvers_.empty()) return nullptr;
+      std::unique_ptr<MemSolverImpl> solver = std::move(solvers_.back());
+      solvers_.pop_back();
+      return solver;
+    }
+
+    void Release(std::unique_ptr<MemSolverImpl> solver) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      solvers_.push_back(std::move(solver));
+    }
+
+   private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<MemSolverImpl>> solvers_;
   };
 
   ArgId MakeArgReq(ArgReqFlag flag, uint32_t idx) { return {flag, idx}; }
@@ -737,6 +779,9 @@ class TensorRegistry {
 
   /* Execution stream use to reorder const data */
   dnnl::stream stream_;
+
+  /* Solvers reused across calls. Shared with the solvers in use, which return to it. */
+  std::shared_ptr<SolverPool> solver_pool_ = std::make_shared<SolverPool>();
 };
 
 }  // namespace contrib
@@ -0,0 +1,230 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file Use external hipBLASLt library call, with the bias and activation epilogues fused.
+ */
+#include <dmlc/thread_local.h>
+#include <hipblaslt/hipblaslt.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "../../rocm/rocm_common.h"
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+#define CHECK_HIPBLASLT_ERROR(fn)                                                     \
+  do {                                                                                \
+    hipblasStatus_t error = static_cast<hipblasStatus_t>(fn);                        \
+    CHECK_EQ(error, HIPBLAS_STATUS_SUCCESS) << "hipBLASLt: " << static_cast<int>(error); \
+  } while (0)
+
+/*! \brief The bytes of the device workspace the algorithms may take. */
+static constexpr uint64_t kHipBlasLtWorkspaceBytes = 32 << 20;
+
+struct HipBlasLtThreadEntry {
+  HipBlasLtThreadEntry() { CHECK_HIPBLASLT_ERROR(hipblasLtCreate(&handle)); }
+
+  ~HipBlasLtThreadEntry() {
+    if (handle) {
+      hipblasLtDestroy(handle);
+      handle = nullptr;
+    }
+  }
+
+  hipblasLtHandle_t handle{nullptr};
+  /*! \brief The algorithms chosen by the heuristic, by the problem they solve. */
+  std::unordered_map<std::string, hipblasLtMatmulAlgo_t> algos;
+};  // HipBlasLtThreadEntry
+
+typedef dmlc::ThreadLocalStore<HipBlasLtThreadEntry> HipBlasLtThreadStore;
+
+inline hipDataType GetHipDataType(DLDataType type) {
+  if (TypeMatch(type, kDLFloat, 16)) return HIP_R_16F;
+  if (TypeMatch(type, kDLFloat, 32)) return HIP_R_32F;
+  if (TypeMatch(type, kDLBfloat, 16)) return HIP_R_16BF;
+  LOG(FATAL) << "ValueError: hipBLASLt does not support the dtype " << DLDataType2String(type);
+  return HIP_R_32F;
+}
+
+/*!
+ * \brief The fused epilogue of an activation, optionally after a bias.
+ * \param activation The activation, "none", "relu" or "gelu".
+ * \param bias Whether a bias is added before the activation.
+ */
+inline hipblasLtEpilogue_t GetEpilogue(const std::string& activation, bool bias) {
+  if (activation == "none") {
+    return bias ? HIPBLASLT_EPILOGUE_BIAS : HIPBLASLT_EPILOGUE_DEFAULT;
+  } else if (activation == "relu") {
+    return bias ? HIPBLASLT_EPILOGUE_RELU_BIAS : HIPBLASLT_EPILOGUE_RELU;
+  } else if (activation == "gelu") {
+    return bias ? HIPBLASLT_EPILOGUE_GELU_BIAS : HIPBLASLT_EPILOGUE_GELU;
+  }
+  LOG(FATAL) << "ValueError: Unknown hipBLASLt activation " << activation
+             << ", expect one of none, relu and gelu";
+  return HIPBLASLT_EPILOGUE_DEFAULT;
+}
+
+/*!
+ * \brief Compute C = activation(op(A) op(B) + bias) in row major, of the 2D or the batched 3D
+ *  matrices, in one kernel.
+ * \note The row-major product is computed as the column-major C^T = op(B)^T op(A)^T, so that
+ *  the bias of the columns of C is the bias of the rows of C^T, which the epilogue adds.
+ */
+void CallHipBlasLtMatmul(const DLTensor* A, const DLTensor* B, const DLTensor* bias,
+                         const DLTensor* C, bool transa, bool transb,
+                         const std::string& activation) {
+  int ndim = C->ndim;
+  ICHECK(ndim == 2 || ndim == 3) << "ValueError: hipBLASLt matmul expects 2D or 3D matrices";
+  ICHECK_EQ(A->ndim, ndim);
+  ICHECK_EQ(B->ndim, ndim);
+  ICHECK(A->strides == nullptr && B->strides == nullptr && C->strides == nullptr)
+      << "ValueError: hipBLASLt matmul expects compact matrices";
+  ICHECK(TypeEqual(A->dtype, B->dtype) && TypeEqual(A->dtype, C->dtype))
+      << "ValueError: hipBLASLt matmul expects the matrices of one dtype";
+  int64_t batch = ndim == 3 ? C->shape[0] : 1;
+  int64_t M = transa ? A->shape[ndim - 1] : A->shape[ndim - 2];
+  int64_t K = transa ? A->shape[ndim - 2] : A->shape[ndim - 1];
+  int64_t N = transb ? B->shape[ndim - 2] : B->shape[ndim - 1];
+  ICHECK_EQ(transb ? B->shape[ndim - 1] : B->shape[ndim - 2], K);
+  ICHECK_EQ(C->shape[ndim - 2], M);
+  ICHECK_EQ(C->shape[ndim - 1], N);
+  if (bias != nullptr) {
+    ICHECK(bias->ndim == 1 && bias->shape[0] == N)
+        << "ValueError: The bias of hipBLASLt matmul must be a vector of the columns of C";
+    ICHECK(TypeEqual(bias->dtype, C->dtype));
+  }
+
+  HipBlasLtThreadEntry* entry = HipBlasLtThreadStore::Get();
+  hipDataType dtype = GetHipDataType(C->dtype);
+  hipblasOperation_t op_a = transb ? HIPBLAS_OP_T : HIPBLAS_OP_N;
+  hipblasOperation_t op_b = transa ? HIPBLAS_OP_T : HIPBLAS_OP_N;
+  hipblasLtEpilogue_t epilogue = GetEpilogue(activation, bias != nullptr);
+
+  hipblasLtMatmulDesc_t desc = nullptr;
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatmulDescCreate(&desc, HIPBLAS_COMPUTE_32F, HIP_R_32F));
+  CHECK_HIPBLASLT_ERROR(
+      hipblasLtMatmulDescSetAttribute(desc, HIPBLASLT_MATMUL_DESC_TRANSA, &op_a, sizeof(op_a)));
+  CHECK_HIPBLASLT_ERROR(
+      hipblasLtMatmulDescSetAttribute(desc, HIPBLASLT_MATMUL_DESC_TRANSB, &op_b, sizeof(op_b)));
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatmulDescSetAttribute(desc, HIPBLASLT_MATMUL_DESC_EPILOGUE,
+                                                        &epilogue, sizeof(epilogue)));
+  if (bias != nullptr) {
+    void* bias_ptr = static_cast<char*>(bias->data) + bias->byte_offset;
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatmulDescSetAttribute(
+        desc, HIPBLASLT_MATMUL_DESC_BIAS_POINTER, &bias_ptr, sizeof(bias_ptr)));
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatmulDescSetAttribute(
+        desc, HIPBLASLT_MATMUL_DESC_BIAS_DATA_TYPE, &dtype, sizeof(dtype)));
+  }
+
+  // The column-major layouts of B, A and C, i.e. of the row-major matrices transposed.
+  auto make_layout = [&](int64_t rows, int64_t cols, int64_t stride) {
+    hipblasLtMatrixLayout_t layout = nullptr;
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatrixLayoutCreate(&layout, dtype, rows, cols, rows));
+    if (batch > 1) {
+      int32_t batch_count = static_cast<int32_t>(batch);
+      CHECK_HIPBLASLT_ERROR(hipblasLtMatrixLayoutSetAttribute(
+          layout, HIPBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
+      CHECK_HIPBLASLT_ERROR(hipblasLtMatrixLayoutSetAttribute(
+          layout, HIPBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET, &stride, sizeof(stride)));
+    }
+    return layout;
+  };
+  hipblasLtMatrixLayout_t layout_a = transb ? make_layout(K, N, N * K) : make_layout(N, K, N * K);
+  hipblasLtMatrixLayout_t layout_b = transa ? make_layout(M, K, M * K) : make_layout(K, M, M * K);
+  hipblasLtMatrixLayout_t layout_c = make_layout(N, M, M * N);
+
+  // The algorithm of a problem is chosen once by the heuristic.
+  std::ostringstream key;
+  key << batch << "_" << M << "_" << N << "_" << K << "_" << transa << transb << "_"
+      << static_cast<int>(dtype) << "_" << static_cast<int>(epilogue);
+  auto it = entry->algos.find(key.str());
+  if (it == entry->algos.end()) {
+    hipblasLtMatmulPreference_t pref = nullptr;
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatmulPreferenceCreate(&pref));
+    uint64_t workspace_bytes = kHipBlasLtWorkspaceBytes;
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatmulPreferenceSetAttribute(
+        pref, HIPBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_bytes,
+        sizeof(workspace_bytes)));
+    hipblasLtMatmulHeuristicResult_t heuristic;
+    int num_results = 0;
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatmulAlgoGetHeuristic(entry->handle, desc, layout_a,
+                                                          layout_b, layout_c, layout_c, pref, 1,
+                                                          &heuristic, &num_results));
+    CHECK_HIPBLASLT_ERROR(hipblasLtMatmulPreferenceDestroy(pref));
+    CHECK_GT(num_results, 0) << "ValueError: hipBLASLt has no algorithm for the matmul of "
+                             << "M=" << M << ", N=" << N << ", K=" << K << " with the "
+                             << activation << " epilogue";
+    it = entry->algos.emplace(key.str(), heuristic.algo).first;
+  }
+
+  float alpha = 1.0f;
+  float beta = 0.0f;
+  void* a_ptr = static_cast<char*>(A->data) + A->byte_offset;
+  void* b_ptr = static_cast<char*>(B->data) + B->byte_offset;
+  void* c_ptr = static_cast<char*>(C->data) + C->byte_offset;
+  DeviceAPI* device_api = DeviceAPI::Get(C->device);
+  void* workspace = device_api->AllocWorkspace(C->device, kHipBlasLtWorkspaceBytes);
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatmul(entry->handle, desc, &alpha, b_ptr, layout_a, a_ptr,
+                                        layout_b, &beta, c_ptr, layout_c, c_ptr, layout_c,
+                                        &it->second, workspace, kHipBlasLtWorkspaceBytes,
+                                        ROCMThreadEntry::ThreadLocal()->stream));
+  device_api->FreeWorkspace(C->device, workspace);
+
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatrixLayoutDestroy(layout_a));
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatrixLayoutDestroy(layout_b));
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatrixLayoutDestroy(layout_c));
+  CHECK_HIPBLASLT_ERROR(hipblasLtMatmulDescDestroy(desc));
+}
+
+// matrix multiplication for row major, with a fused activation
+TVM_REGISTER_GLOBAL("tvm.contrib.hipblaslt.matmul").set_body([](TVMArgs args, TVMRetValue* ret) {
+  DLTensor* A = args[0];
+  DLTensor* B = args[1];
+  DLTensor* C = args[2];
+  bool transa = args[3];
+  bool transb = args[4];
+  std::string activation = args[5];
+  CallHipBlasLtMatmul(A, B, nullptr, C, transa, transb, activation);
+});
+
+// matrix multiplication for row major, with a fused bias and activation
+TVM_REGISTER_GLOBAL("tvm.contrib.hipblaslt.matmul_bias")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      DLTensor* A = args[0];
+      DLTensor* B = args[1];
+      DLTensor* bias = args[2];
+      DLTensor* C = args[3];
+      bool transa = args[4];
+      bool transb = args[5];
+      std::string activation = args[6];
+      CallHipBlasLtMatmul(A, B, bias, C, transa, transb, activation);
+    });
+
+}  // namespace contrib
+}  // namespace tvm
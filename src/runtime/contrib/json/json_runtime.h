@@ -214,11 +214,13 @@ class JSONRuntimeBase : public ModuleNode {
 
   /*!
    * \brief Set up the constants/weights for inference by binding their DLTensor pointer to
-   * the corresponding data entry.
+   * the corresponding data entry. The constants are borrowed rather than copied, and may be
+   * shared with the other subgraphs.
    *
    * \param consts A list of constant NDArray to be used.
    */
   void SetupConstants(const Array<NDArray>& consts) {
+    consts_ = consts;
     for (size_t i = 0; i < consts.size(); ++i) {
       data_entry_[EntryID(const_idx_[i], 0)] = consts[i].operator->();
     }
@@ -273,6 +275,8 @@ class JSONRuntimeBase : public ModuleNode {
   std::vector<uint32_t> input_var_eid_;
   /*! \brief input const node index. */
   std::vector<uint32_t> const_idx_;
+  /*! \brief The constants bound to the data entries, kept alive with the module. */
+  Array<NDArray> consts_;
   /*! \brief Indicate if the engine has been initialized. */
   bool initialized_{false};
   /*! \brief Initializer mutex*/
@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/nccl/nccl.cc
+ * \brief The collectives of the relax VM on CUDA, by NCCL.
+ */
+#include <nccl.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/ccl.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+#define NCCL_CALL(cmd)                                                            \
+  {                                                                               \
+    ncclResult_t r = (cmd);                                                       \
+    CHECK_EQ(r, ncclSuccess) << "NCCLError: " #cmd " failed with error: "         \
+                             << ncclGetErrorString(r);                            \
+  }
+
+static ncclDataType_t AsNCCLDataType(DLDataType dtype) {
+  DataType type(dtype);
+  if (type == DataType::Float(16)) {
+    return ncclFloat16;
+  } else if (type == DataType::Float(32)) {
+    return ncclFloat32;
+  } else if (type == DataType::Float(64)) {
+    return ncclFloat64;
+  } else if (type == DataType::Int(8)) {
+    return ncclInt8;
+  } else if (type == DataType::UInt(8)) {
+    return ncclUint8;
+  } else if (type == DataType::Int(32)) {
+    return ncclInt32;
+  } else if (type == DataType::Int(64)) {
+    return ncclInt64;
+  }
+  LOG(FATAL) << "ValueError: NCCL does not support " << type;
+  return ncclFloat32;
+}
+
+static ncclRedOp_t AsNCCLRedOp(ReduceKind kind) {
+  switch (kind) {
+    case ReduceKind::kSum:
+      return ncclSum;
+    case ReduceKind::kProd:
+      return ncclProd;
+    case ReduceKind::kMin:
+      return ncclMin;
+    case ReduceKind::kMax:
+      return ncclMax;
+  }
+  LOG(FATAL) << "ValueError: Unknown reduction " << static_cast<int>(kind);
+  return ncclSum;
+}
+
+/*! \brief The elements of a tensor. */
+static size_t NumElements(const DLTensor* tensor) {
+  size_t size = 1;
+  for (int i = 0; i < tensor->ndim; ++i) {
+    size *= tensor->shape[i];
+  }
+  return size;
+}
+
+/*! \brief The first byte of a tensor. */
+static void* DataPtr(const DLTensor* tensor) {
+  return static_cast<char*>(tensor->data) + tensor->byte_offset;
+}
+
+/*!
+ * \brief The communicator of a worker on a CUDA device.
+ *
+ *  The workers of a group in this process share the NCCL unique id generated by the first one to
+ *  join. The collectives run on the current stream of the thread, where the kernels run.
+ */
+class NCCLCommunicatorObj : public CommunicatorObj {
+ public:
+  NCCLCommunicatorObj(const std::string& group, int world_size, int rank, Device device) {
+    this->world_size = world_size;
+    this->rank = rank;
+    this->device = device;
+    ncclUniqueId id = GetUniqueId(group, world_size);
+    CUDA_CALL(cudaSetDevice(device.device_id));
+    // Returns once all the ranks of the group have called it.
+    NCCL_CALL(ncclCommInitRank(&comm_, world_size, id, rank));
+  }
+
+  ~NCCLCommunicatorObj() { ncclCommDestroy(comm_); }
+
+  void AllReduce(const DLTensor* send, DLTensor* recv, ReduceKind kind) final {
+    NCCL_CALL(ncclAllReduce(DataPtr(send), DataPtr(recv), NumElements(send),
+                            AsNCCLDataType(send->dtype), AsNCCLRedOp(kind), comm_, Stream()));
+  }
+
+  void AllGather(const DLTensor* send, DLTensor* recv) final {
+    NCCL_CALL(ncclAllGather(DataPtr(send), DataPtr(recv), NumElements(send),
+                            AsNCCLDataType(send->dtype), comm_, Stream()));
+  }
+
+  void ReduceScatter(const DLTensor* send, DLTensor* recv, ReduceKind kind) final {
+    NCCL_CALL(ncclReduceScatter(DataPtr(send), DataPtr(recv), NumElements(recv),
+                                AsNCCLDataType(send->dtype), AsNCCLRedOp(kind), comm_, Stream()));
+  }
+
+ private:
+  static cudaStream_t Stream() { return CUDAThreadEntry::ThreadLocal()->stream; }
+
+  /*! \brief Get the unique id of a group, generated by its first worker to join. */
+  static ncclUniqueId GetUniqueId(const std::string& group, int world_size) {
+    struct PendingGroup {
+      ncclUniqueId id;
+      int num_joined;
+    };
+    static std::mutex mutex;
+    static std::unordered_map<std::string, PendingGroup> pending;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pending.find(group);
+    if (it == pending.end()) {
+      PendingGroup new_group;
+      NCCL_CALL(ncclGetUniqueId(&new_group.id));
+      new_group.num_joined = 0;
+      it = pending.emplace(group, new_group).first;
+    }
+    ncclUniqueId id = it->second.id;
+    // The name is free for another group once all the workers have the id.
+    if (++it->second.num_joined == world_size) {
+      pending.erase(it);
+    }
+    return id;
+  }
+
+  /*! \brief The NCCL communicator. */
+  ncclComm_t comm_;
+};
+
+TVM_REGISTER_GLOBAL("vm.ccl.create_communicator.cuda")
+    .set_body_typed([](String group, int world_size, int rank, Device device) {
+      return Communicator(make_object<NCCLCommunicatorObj>(group, world_size, rank, device));
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -22,9 +22,14 @@
  */
 
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <type_traits>
 #include <vector>
 
 #include "../../../../3rdparty/compiler-rt/builtin_fp16.h"
@@ -62,6 +67,156 @@ bool CompareDescend(const std::pair<int64_t, float16>& lhs,
   return lhs.second.to_float() > rhs.second.to_float();
 }
 
+/*!
+ * \brief Run f(begin, end) over ranges of the rows [0, num_rows) on the threads of the runtime.
+ * The rows run on the calling thread when they are too few elements to amortize the launch.
+ */
+void ParallelForRows(int64_t num_rows, int64_t row_size,
+                     const std::function<void(int64_t, int64_t)>& f) {
+  constexpr int64_t kMinParallelElements = 1 << 15;
+  if (num_rows < 2 || num_rows * row_size < kMinParallelElements ||
+      threading::MaxConcurrency() < 2) {
+    f(0, num_rows);
+    return;
+  }
+  struct ParallelTask {
+    static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+      ParallelTask* task = static_cast<ParallelTask*>(cdata);
+      int64_t begin = task->num_rows * task_id / penv->num_task;
+      int64_t end = task->num_rows * (task_id + 1) / penv->num_task;
+      if (begin < end) (*task->f)(begin, end);
+      return 0;
+    }
+
+    const std::function<void(int64_t, int64_t)>* f;
+    int64_t num_rows;
+  };
+  ParallelTask task{&f, num_rows};
+  int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
+  ICHECK_EQ(res, 0) << "sort: TVMBackendParallelLaunch failed";
+}
+
+/*!
+ * \brief The key of a value for the radix sort, whose unsigned order is the order of the values.
+ * Only defined for the types with such a key.
+ */
+template <typename DataType, typename = void>
+struct RadixKey {
+  static constexpr bool kDefined = false;
+};
+
+template <typename DataType>
+struct RadixKey<DataType, typename std::enable_if<std::is_integral<DataType>::value &&
+                                                  std::is_signed<DataType>::value &&
+                                                  sizeof(DataType) >= 4>::type> {
+  static constexpr bool kDefined = true;
+  using Type = typename std::make_unsigned<DataType>::type;
+  static Type Get(DataType value) {
+    // Flip the sign bit, so that the negative values come first.
+    return static_cast<Type>(value) ^ (Type(1) << (sizeof(Type) * 8 - 1));
+  }
+};
+
+template <typename DataType>
+struct RadixKey<DataType, typename std::enable_if<std::is_floating_point<DataType>::value>::type> {
+  static constexpr bool kDefined = true;
+  using Type = typename std::conditional<sizeof(DataType) == 4, uint32_t, uint64_t>::type;
+  static Type Get(DataType value) {
+    constexpr Type kSignBit = Type(1) << (sizeof(Type) * 8 - 1);
+    // -0 and 0 are equal, as in the comparisons.
+    if (value == 0) return kSignBit;
+    Type bits;
+    std::memcpy(&bits, &value, sizeof(Type));
+    // Flip all the bits of the negative values, whose magnitude orders them backward.
+    return (bits & kSignBit) ? ~bits : bits | kSignBit;
+  }
+};
+
+/*! \brief The rows shorter than this are sorted by comparisons rather than by radix. */
+constexpr int64_t kMinRadixSortSize = 256;
+
+/*!
+ * \brief Stable sort of the row of (index, value) pairs by a least significant digit radix sort
+ * of the keys of the values, one byte at a time. The loops over the keys are contiguous so that
+ * the compiler can vectorize the histograms, and the bytes shared by all the keys are skipped.
+ */
+template <typename DataType>
+void RadixSort(std::vector<std::pair<int64_t, DataType>>* sorter, bool is_ascend) {
+  using Key = typename RadixKey<DataType>::Type;
+  size_t size = sorter->size();
+  std::vector<Key> keys(size), keys_buf(size);
+  std::vector<int64_t> order(size), order_buf(size);
+  for (size_t i = 0; i < size; ++i) {
+    Key key = RadixKey<DataType>::Get((*sorter)[i].second);
+    // The descending order is the ascending order of the complemented keys, and stays stable.
+    keys[i] = is_ascend ? key : ~key;
+    order[i] = i;
+  }
+  for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+    size_t counts[257] = {0};
+    for (size_t i = 0; i < size; ++i) {
+      ++counts[((keys[i] >> shift) & 0xFF) + 1];
+    }
+    if (counts[((keys[0] >> shift) & 0xFF) + 1] == size) continue;
+    for (int b = 0; b < 256; ++b) {
+      counts[b + 1] += counts[b];
+    }
+    for (size_t i = 0; i < size; ++i) {
+      size_t pos = counts[(keys[i] >> shift) & 0xFF]++;
+      keys_buf[pos] = keys[i];
+      order_buf[pos] = order[i];
+    }
+    keys.swap(keys_buf);
+    order.swap(order_buf);
+  }
+  std::vector<std::pair<int64_t, DataType>> sorted(size);
+  for (size_t i = 0; i < size; ++i) {
+    sorted[i] = (*sorter)[order[i]];
+  }
+  sorter->swap(sorted);
+}
+
+/*! \brief Stable sort of a row of (index, value) pairs by value. */
+template <typename DataType>
+void SortRow(std::vector<std::pair<int64_t, DataType>>* sorter, bool is_ascend) {
+  if constexpr (RadixKey<DataType>::kDefined) {
+    if (static_cast<int64_t>(sorter->size()) >= kMinRadixSortSize) {
+      RadixSort(sorter, is_ascend);
+      return;
+    }
+  }
+  if (is_ascend) {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareAscend<DataType>);
+  } else {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareDescend<DataType>);
+  }
+}
+
+/*!
+ * \brief Sort the first k pairs of a row as the stable sort would, with a partial selection when k
+ * is small enough against the length of the row.
+ */
+template <typename DataType>
+void TopKRow(std::vector<std::pair<int64_t, DataType>>* sorter, int64_t k, bool is_ascend) {
+  constexpr int64_t kPartialSortRatio = 8;
+  if (k * kPartialSortRatio > static_cast<int64_t>(sorter->size())) {
+    SortRow(sorter, is_ascend);
+    return;
+  }
+  // The ties are broken by index, as kept by the stable sort.
+  auto compare = [is_ascend](const std::pair<int64_t, DataType>& lhs,
+                             const std::pair<int64_t, DataType>& rhs) {
+    if (is_ascend ? CompareAscend<DataType>(lhs, rhs) : CompareDescend<DataType>(lhs, rhs)) {
+      return true;
+    }
+    if (is_ascend ? CompareAscend<DataType>(rhs, lhs) : CompareDescend<DataType>(rhs, lhs)) {
+      return false;
+    }
+    return lhs.first < rhs.first;
+  };
+  std::partial_sort(sorter->begin(), sorter->begin() + k, sorter->end(), compare);
+}
+
 // Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
@@ -79,7 +234,6 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
   auto dtype = input->dtype;
   auto data_ptr = static_cast<float*>(input->data);
   auto sort_num_ptr = static_cast<int32_t*>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
   int64_t axis_mul_before = 1;
   int64_t axis_mul_after = 1;
 
@@ -106,8 +260,12 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
     }
   }
 
-  for (int64_t i = 0; i < axis_mul_before; ++i) {
-    for (int64_t j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(axis_mul_before * axis_mul_after, input->shape[axis], [&](int64_t begin,
+                                                                            int64_t end) {
+    std::vector<std::pair<int32_t, float>> sorter;
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       sorter.clear();
       int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
       int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
@@ -141,7 +299,7 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
             k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
       }
     }
-  }
+  });
 });
 
 template <typename DataType, typename OutType>
@@ -150,7 +308,6 @@ void sort_impl(
     std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
   auto data_ptr = static_cast<DataType*>(input->data);
   auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
 
   int axis_mul_before = 1;
   int axis_mul_after = 1;
@@ -162,24 +319,24 @@ void sort_impl(
     }
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(axis_mul_before * axis_mul_after, input->shape[axis], [&](int64_t begin,
+                                                                            int64_t end) {
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       sorter.clear();
       int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
       for (int64_t k = 0; k < input->shape[axis]; ++k) {
         int64_t full_idx = base_idx + k * axis_mul_after;
         sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
       }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
+      SortRow(&sorter, is_ascend);
       for (int64_t k = 0; k < input->shape[axis]; ++k) {
         epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
       }
     }
-  }
+  });
 }
 
 template <typename DataType, typename OutType>
@@ -346,7 +503,6 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
       (out_values == nullptr) ? nullptr : static_cast<DataType*>(out_values->data);
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
 
   int axis_mul_before = 1;
   int axis_mul_after = 1;
@@ -361,8 +517,12 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
     k = input->shape[axis];
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(axis_mul_before * axis_mul_after, input->shape[axis], [&](int64_t begin,
+                                                                            int64_t end) {
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       sorter.clear();
       int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
       int64_t dst_base_idx = i * k * axis_mul_after + j;
@@ -370,12 +530,8 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
         int64_t full_idx = src_base_idx + kk * axis_mul_after;
         sorter.emplace_back(std::make_pair(kk, data_ptr[full_idx]));
       }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
       int64_t cnt = k > 0 ? k : input->shape[axis];
+      TopKRow(&sorter, cnt, is_ascend);
       for (int64_t kk = 0; kk < cnt; ++kk) {
         if (indices_ptr != nullptr) {
           indices_ptr[dst_base_idx + kk * axis_mul_after] =
@@ -386,7 +542,7 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
         }
       }
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
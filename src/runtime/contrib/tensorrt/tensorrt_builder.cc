@@ -24,11 +24,17 @@
 
 #include "tensorrt_builder.h"
 
+#include <dmlc/parameter.h>
 #include <tvm/runtime/ndarray.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <random>
 #include <string>
 
+#include "../../file_utils.h"
 #include "tensorrt_logger.h"
 #include "tensorrt_ops.h"
 #include "tensorrt_utils.h"
@@ -37,6 +43,59 @@ namespace tvm {
 namespace runtime {
 namespace contrib {
 
+#if TRT_VERSION_GE(8, 0, 0)
+TensorRTTimingCache* TensorRTTimingCache::Global() {
+  static TensorRTTimingCache* inst = new TensorRTTimingCache();
+  return inst;
+}
+
+nvinfer1::ITimingCache* TensorRTTimingCache::Attach(nvinfer1::IBuilderConfig* config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!loaded_) {
+    loaded_ = true;
+    std::string path = dmlc::GetEnv("TVM_TENSORRT_TIMING_CACHE", std::string(""));
+    std::ifstream infile(path, std::ios::binary);
+    if (!path.empty() && infile.good()) {
+      infile.close();
+      LOG(INFO) << "Loading TensorRT timing cache from " << path;
+      LoadBinaryFromFile(path, &serialized_);
+    }
+  }
+  nvinfer1::ITimingCache* cache = config->createTimingCache(serialized_.data(), serialized_.size());
+  if (cache == nullptr) {
+    // The cache of another device or TensorRT version is rejected.
+    LOG(WARNING) << "Discarding an incompatible TensorRT timing cache";
+    serialized_.clear();
+    cache = config->createTimingCache(nullptr, 0);
+  }
+  ICHECK(cache) << "Creating the TensorRT timing cache failed";
+  ICHECK(config->setTimingCache(*cache, /*ignoreMismatch=*/false));
+  return cache;
+}
+
+void TensorRTTimingCache::Merge(nvinfer1::IBuilderConfig* config,
+                                const nvinfer1::ITimingCache& cache) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The shared cache may have grown with the builds that finished meanwhile.
+  nvinfer1::ITimingCache* merged =
+      config->createTimingCache(serialized_.data(), serialized_.size());
+  ICHECK(merged) << "Creating the TensorRT timing cache failed";
+  ICHECK(merged->combine(cache, /*ignoreMismatch=*/false));
+  nvinfer1::IHostMemory* serialized = merged->serialize();
+  serialized_.assign(static_cast<const char*>(serialized->data()), serialized->size());
+  serialized->destroy();
+  merged->destroy();
+
+  std::string path = dmlc::GetEnv("TVM_TENSORRT_TIMING_CACHE", std::string(""));
+  if (path.empty()) return;
+  // Write to a temporary file first, so that the other processes never read a partial cache.
+  std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+  SaveBinaryToFile(tmp_path, serialized_);
+  ICHECK_EQ(std::rename(tmp_path.c_str(), path.c_str()), 0)
+      << "Saving the TensorRT timing cache to " << path << " failed";
+}
+#endif
+
 TensorRTBuilder::TensorRTBuilder(TensorRTLogger* logger,
                                  const std::vector<const DLTensor*>& data_entry,
                                  size_t max_workspace_size, bool use_implicit_batch, bool use_fp16,
@@ -187,10 +246,14 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
     auto profile = builder_->createOptimizationProfile();
     for (int i = 0; i < network_->getNbInputs(); ++i) {
       auto name = network_->getInput(i)->getName();
-      const uint32_t entry_id = entry_id_map_[name];
-      std::vector<int64_t> shape(data_entry_[entry_id]->shape,
-                                 data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
-      auto dims = VectorToTrtDims(shape);
+      auto dims = network_->getInput(i)->getDimensions();
+      // The static inputs are known before the first run, when the engine builds at module init.
+      if (std::any_of(dims.d, dims.d + dims.nbDims, [](int dim) { return dim < 0; })) {
+        const uint32_t entry_id = entry_id_map_[name];
+        std::vector<int64_t> shape(data_entry_[entry_id]->shape,
+                                   data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
+        dims = VectorToTrtDims(shape);
+      }
 
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, dims);
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX, dims);
@@ -203,7 +266,14 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
     }
     config_->addOptimizationProfile(profile);
   }
+#if TRT_VERSION_GE(8, 0, 0)
+  nvinfer1::ITimingCache* timing_cache = TensorRTTimingCache::Global()->Attach(config_);
+#endif
   nvinfer1::ICudaEngine* engine = builder_->buildEngineWithConfig(*network_, *config_);
+#if TRT_VERSION_GE(8, 0, 0)
+  TensorRTTimingCache::Global()->Merge(config_, *timing_cache);
+  timing_cache->destroy();
+#endif
 #else
   nvinfer1::ICudaEngine* engine = builder_->buildCudaEngine(*network_);
 #endif
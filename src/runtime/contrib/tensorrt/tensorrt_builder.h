@@ -27,6 +27,7 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -54,6 +55,42 @@ struct TensorRTEngineAndContext {
   std::vector<std::string> outputs;
 };
 
+#if TRT_VERSION_GE(8, 0, 0)
+/*!
+ * \brief The timing cache shared by all the engine builds of the process, so that TensorRT times
+ * the tactics of each layer configuration once rather than for every engine. When
+ * TVM_TENSORRT_TIMING_CACHE is set to a file, the cache is loaded from it by the first build and
+ * saved to it after each build, to be shared across processes.
+ */
+class TensorRTTimingCache {
+ public:
+  /*! \brief The timing cache of the process. */
+  static TensorRTTimingCache* Global();
+
+  /*!
+   * \brief Attach a copy of the shared cache to the config of a build.
+   * \param config The builder config.
+   * \return The cache of the build, to merge back with Merge() once the build is done.
+   */
+  nvinfer1::ITimingCache* Attach(nvinfer1::IBuilderConfig* config);
+
+  /*!
+   * \brief Merge the timings of a finished build into the shared cache, and save it.
+   * \param config The builder config of the build.
+   * \param cache The cache of the build.
+   */
+  void Merge(nvinfer1::IBuilderConfig* config, const nvinfer1::ITimingCache& cache);
+
+ private:
+  /*! \brief Guards the serialized cache, as the engines may build concurrently. */
+  std::mutex mutex_;
+  /*! \brief Whether the cache was loaded from TVM_TENSORRT_TIMING_CACHE. */
+  bool loaded_ = false;
+  /*! \brief The serialized cache. */
+  std::string serialized_;
+};
+#endif
+
 /*!
  * \brief Converts a JSONRuntime graph into a TensorRT engine and execution context. Inputs,
  * constants, layers, and outputs can be added to construct the TensorRT network definition.
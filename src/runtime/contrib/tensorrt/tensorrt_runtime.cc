@@ -26,10 +26,15 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../file_utils.h"
@@ -56,6 +61,50 @@ struct PairHash {
 
 using namespace tvm::runtime::json;
 
+#ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+/*!
+ * \brief Bounds the number of the engines of the process building at the same time to
+ * TVM_TENSORRT_MAX_PARALLEL_BUILDS (4 by default), as each build may take its max_workspace_size
+ * of device memory to time the tactics.
+ */
+class TensorRTBuildSlots {
+ public:
+  /*! \brief Holds a build slot for its lifetime. */
+  class Guard {
+   public:
+    Guard() { Global()->Acquire(); }
+    ~Guard() { Global()->Release(); }
+  };
+
+ private:
+  TensorRTBuildSlots()
+      : num_free_(std::max(1, dmlc::GetEnv("TVM_TENSORRT_MAX_PARALLEL_BUILDS", 4))) {}
+
+  static TensorRTBuildSlots* Global() {
+    static TensorRTBuildSlots* inst = new TensorRTBuildSlots();
+    return inst;
+  }
+
+  void Acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return num_free_ > 0; });
+    --num_free_;
+  }
+
+  void Release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++num_free_;
+    }
+    cv_.notify_one();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int num_free_;
+};
+#endif  // TVM_GRAPH_EXECUTOR_TENSORRT
+
 class TensorRTRuntime : public JSONRuntimeBase {
  public:
   /*!
@@ -97,10 +146,42 @@ class TensorRTRuntime : public JSONRuntimeBase {
    */
   const char* type_key() const final { return "tensorrt"; }
 
+  /*!
+   * \brief Save the module, followed by its serialized engines (and those it was loaded with when
+   * it has built none), so that the loaded module does not build them again.
+   *
+   * \param stream The stream to save the module to.
+   */
+  void SaveToBinary(dmlc::Stream* stream) final {
+    JSONRuntimeBase::SaveToBinary(stream);
+    SerializeEngines();
+    stream->Write(engine_plans_);
+    stream->Write(engine_metas_);
+  }
+
+  /*!
+   * \brief Load a module saved by SaveToBinary.
+   *
+   * \param strm The stream to load the module from.
+   * \return The module, whose serialized engines are deserialized when it initializes.
+   */
+  static Module LoadFromBinary(void* strm) {
+    dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+    Module mod = JSONRuntimeBase::LoadFromBinary<TensorRTRuntime>(strm);
+    auto* n = static_cast<TensorRTRuntime*>(mod.operator->());
+    ICHECK(stream->Read(&n->engine_plans_)) << "Loading the serialized engines failed";
+    ICHECK(stream->Read(&n->engine_metas_)) << "Loading the metadata of the engines failed";
+    ICHECK_EQ(n->engine_plans_.size(), n->engine_metas_.size());
+    return mod;
+  }
+
   /*!
    * \brief Initialize runtime. Create TensorRT layer from JSON
    * representation.
    *
+   * The engines come, in order of preference, from the module binary, from
+   * TVM_TENSORRT_CACHE_DIR, or else from a build started in the background.
+   *
    * \param consts The constant params from compiled model.
    */
   void Init(const Array<NDArray>& consts) override {
@@ -108,7 +189,9 @@ class TensorRTRuntime : public JSONRuntimeBase {
         << "The number of input constants must match the number of required.";
     LoadGlobalAttributes();
     SetupConstants(consts);
-    GetCachedEnginesFromDisk();
+    if (!LoadSerializedEngines() && !GetCachedEnginesFromDisk()) {
+      BuildEngineAsync();
+    }
   }
 
   void LoadGlobalAttributes() {
@@ -150,6 +233,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   ~TensorRTRuntime() override {
     VLOG(1) << "Destroying TensorRT runtime";
+    if (pending_build_.valid()) pending_build_.wait();
     DestroyEngines();
     VLOG(1) << "Destroyed TensorRT runtime";
   }
@@ -275,6 +359,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * already built, do nothing.
    */
   TensorRTEngineAndContext& GetOrBuildEngine() {
+    WaitForEngineBuild();
     int batch_size = GetBatchSize();
     int compatible_engine_batch_size = -1;
     bool find_engine_flag = FindCompatibleEngine(batch_size, &compatible_engine_batch_size);
@@ -312,10 +397,46 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
     VLOG(1) << "Finished building TensorRT engine for subgraph " << symbol_name_
             << " with batch size " << batch_size;
-    CacheEngineToDisk();
+    CacheEngineToDisk(batch_size);
     return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
   }
 
+  /*!
+   * \brief Start building the engine of the static input shapes in the background, so that the
+   * engines of all the subgraphs build in parallel while the modules initialize, rather than one
+   * after another at their first runs. Disabled with TVM_TENSORRT_BUILD_AT_INIT=0, and skipped
+   * for INT8, which calibrates on the inputs of the first runs, and for dynamic input shapes.
+   */
+  void BuildEngineAsync() {
+    if (!dmlc::GetEnv("TVM_TENSORRT_BUILD_AT_INIT", true) ||
+        dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false)) {
+      return;
+    }
+    // The batch size of GetBatchSize(), from the first input.
+    int batch_size = -1;
+    for (auto nid : input_nodes_) {
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (const auto& shape : nodes_[nid].GetOpShape()) {
+        if (std::any_of(shape.begin(), shape.end(), [](int64_t dim) { return dim < 0; })) return;
+        if (batch_size < 0) batch_size = shape.empty() ? 1 : shape[0];
+      }
+    }
+    if (batch_size <= 0) return;
+    pending_build_ = std::async(std::launch::async, [this, batch_size]() {
+      TensorRTBuildSlots::Guard slot;
+      VLOG(1) << "Building TensorRT engine for subgraph " << symbol_name_ << " with batch size "
+              << batch_size << " at init";
+      BuildEngineFromJson(batch_size);
+      max_batch_size_ = batch_size;
+      CacheEngineToDisk(batch_size);
+    });
+  }
+
+  /*! \brief Wait for the engine build started at init, rethrowing its error. */
+  void WaitForEngineBuild() {
+    if (pending_build_.valid()) pending_build_.get();
+  }
+
   void BuildEngineFromJson(int batch_size) {
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
     TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
@@ -365,16 +486,73 @@ class TensorRTRuntime : public JSONRuntimeBase {
     infile.close();
     std::string serialized_engine;
     LoadBinaryFromFile(path, &serialized_engine);
-    // Deserialize engine
+    std::string serialized_meta;
+    LoadBinaryFromFile(cache_dir + "/" + key + ".meta", &serialized_meta);
+    if (!DeserializeEngine(serialized_engine, serialized_meta)) return false;
+    LOG(INFO) << "finished loading engine and context ... ";
+    return true;
+  }
+
+  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
+   * directory so it can be loaded later.
+   */
+  void CacheEngineToDisk(int batch_size) {
+    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (cache_dir.empty()) return;
+    std::string key = GetSubgraphKey();
+    std::string path = cache_dir + "/" + key + ".plan";
+    DLOG(INFO) << "Caching TensorRT engine to " << path;
+    std::string serialized_engine, serialized_meta;
+    SerializeEngine(batch_size, &serialized_engine, &serialized_meta);
+    SaveBinaryToFile(path, serialized_engine);
+    SaveBinaryToFile(cache_dir + "/" + key + ".meta", serialized_meta);
+  }
+
+  /*! \brief Deserialize the engines the module was loaded with, if they are compatible with the
+   * device and the TensorRT version. */
+  bool LoadSerializedEngines() {
+    if (engine_plans_.empty()) return false;
+    for (size_t i = 0; i < engine_plans_.size(); ++i) {
+      if (!DeserializeEngine(engine_plans_[i], engine_metas_[i])) {
+        DestroyEngines();
+        max_batch_size_ = -1;
+        return false;
+      }
+    }
+    VLOG(1) << "Loaded " << engine_plans_.size() << " serialized TensorRT engine(s) for subgraph "
+            << symbol_name_;
+    return true;
+  }
+
+  /*! \brief Serialize the built engines into engine_plans_ and engine_metas_, if any. */
+  void SerializeEngines() {
+    WaitForEngineBuild();
+    if (trt_engine_cache_.empty()) return;
+    engine_plans_.clear();
+    engine_metas_.clear();
+    for (const auto& it : trt_engine_cache_) {
+      std::string plan, meta;
+      SerializeEngine(it.first.second, &plan, &meta);
+      engine_plans_.push_back(std::move(plan));
+      engine_metas_.push_back(std::move(meta));
+    }
+  }
+
+  /*!
+   * \brief Deserialize an engine and its metadata into trt_engine_cache_.
+   * \return False if TensorRT rejects the engine, e.g. built for another device.
+   */
+  bool DeserializeEngine(const std::string& serialized_engine, const std::string& serialized_meta) {
     nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
     TensorRTEngineAndContext engine_and_context;
     engine_and_context.engine =
-        runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
+        runtime->deserializeCudaEngine(serialized_engine.data(), serialized_engine.size(), nullptr);
+    if (engine_and_context.engine == nullptr) {
+      LOG(WARNING) << "Discarding an incompatible serialized TensorRT engine for subgraph "
+                   << symbol_name_;
+      return false;
+    }
     engine_and_context.context = engine_and_context.engine->createExecutionContext();
-    // Load metadata
-    std::string meta_path = cache_dir + "/" + key + ".meta";
-    std::string serialized_meta;
-    LoadBinaryFromFile(meta_path, &serialized_meta);
     std::istringstream is(serialized_meta);
     dmlc::JSONReader reader(&is);
     dmlc::JSONObjectReadHelper helper;
@@ -384,39 +562,25 @@ class TensorRTRuntime : public JSONRuntimeBase {
     helper.DeclareField("batch_size", &batch_size);
     helper.ReadAllFields(&reader);
     trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
-    max_batch_size_ = batch_size;
-    LOG(INFO) << "finished loading engine and context ... ";
+    max_batch_size_ = std::max(max_batch_size_, batch_size);
     return true;
   }
 
-  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
-   * directory so it can be loaded later.
-   */
-  void CacheEngineToDisk() {
-    int batch_size = GetBatchSize();
-    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
-    if (cache_dir.empty()) return;
-    std::string key = GetSubgraphKey();
-    std::string path = cache_dir + "/" + key + ".plan";
-    DLOG(INFO) << "Caching TensorRT engine to " << path;
-    // Serialize engine to disk
-    nvinfer1::IHostMemory* serialized_engine =
-        trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].engine->serialize();
-    SaveBinaryToFile(path, std::string(static_cast<const char*>(serialized_engine->data()),
-                                       serialized_engine->size()));
-    serialized_engine->destroy();
-    // Serialize metadata
+  /*! \brief Serialize the engine of the batch size and its metadata. */
+  void SerializeEngine(int batch_size, std::string* serialized_engine,
+                       std::string* serialized_meta) {
+    const auto& engine_and_context = trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    nvinfer1::IHostMemory* serialized = engine_and_context.engine->serialize();
+    serialized_engine->assign(static_cast<const char*>(serialized->data()), serialized->size());
+    serialized->destroy();
     std::ostringstream os;
     dmlc::JSONWriter writer(&os);
     writer.BeginObject();
-    writer.WriteObjectKeyValue("inputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].inputs);
-    writer.WriteObjectKeyValue("outputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].outputs);
+    writer.WriteObjectKeyValue("inputs", engine_and_context.inputs);
+    writer.WriteObjectKeyValue("outputs", engine_and_context.outputs);
     writer.WriteObjectKeyValue("batch_size", batch_size);
     writer.EndObject();
-    std::string meta_path = cache_dir + "/" + key + ".meta";
-    SaveBinaryToFile(meta_path, os.str());
+    *serialized_meta = os.str();
   }
 
   std::string GetSubgraphKey() {
@@ -475,6 +639,9 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief TensorRT logger. */
   TensorRTLogger logger_;
 
+  /*! \brief The engine build started at init, if any, which Run waits for. */
+  std::future<void> pending_build_;
+
 #else   // TVM_GRAPH_EXECUTOR_TENSORRT
   void Run() override {
     LOG(FATAL) << "TensorRT runtime is not enabled. "
@@ -488,9 +655,21 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   bool GetCachedEnginesFromDisk() { return false; }
 
-  void CacheEngineToDisk() {}
+  void CacheEngineToDisk(int batch_size) {}
+
+  bool LoadSerializedEngines() { return false; }
+
+  void SerializeEngines() {}
+
+  void BuildEngineAsync() {}
 #endif  // TVM_GRAPH_EXECUTOR_TENSORRT
 
+  /*! \brief The serialized engines the module was loaded with or built, saved with the module. */
+  std::vector<std::string> engine_plans_;
+
+  /*! \brief The metadata of the serialized engines, as in the .meta files of the disk cache. */
+  std::vector<std::string> engine_metas_;
+
   bool use_implicit_batch_;
 
   size_t max_workspace_size_;
@@ -522,7 +701,7 @@ runtime::Module TensorRTRuntimeCreate(const String& symbol_name, const String& g
 TVM_REGISTER_GLOBAL("runtime.tensorrt_runtime_create").set_body_typed(TensorRTRuntimeCreate);
 
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_tensorrt")
-    .set_body_typed(JSONRuntimeBase::LoadFromBinary<TensorRTRuntime>);
+    .set_body_typed(TensorRTRuntime::LoadFromBinary);
 
 }  // namespace contrib
 }  // namespace runtime
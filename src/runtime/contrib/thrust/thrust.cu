@@ -27,7 +27,9 @@
 #include <thrust/gather.h>
 #include <thrust/scan.h>
 #include <thrust/sequence.h>
+#include <thrust/unique.h>
 
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 #include <dlpack/dlpack.h>
 #include <algorithm>
@@ -390,5 +392,48 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.sum_scan")
   }
 });
 
+// Returns the unique elements of the flattened input, sorted or in the reverse order of their
+// first occurrences as on CPU.
+template<typename DataType>
+NDArray thrust_unique(NDArray data, bool sorted) {
+  int64_t size = 1;
+  for (int i = 0; i < data->ndim; ++i) size *= data->shape[i];
+  thrust::device_ptr<DataType> data_ptr(static_cast<DataType *>(data->data));
+  thrust::device_vector<DataType> values(data_ptr, data_ptr + size);
+  thrust::device_vector<int64_t> indices(size);
+  thrust::sequence(indices.begin(), indices.end());
+
+  // The stable sort keeps the first occurrence of an element at the front of its run.
+  thrust::stable_sort_by_key(values.begin(), values.end(), indices.begin());
+  auto ends = thrust::unique_by_key(values.begin(), values.end(), indices.begin());
+  int64_t num_unique = ends.first - values.begin();
+  if (!sorted) {
+    thrust::sort_by_key(indices.begin(), indices.begin() + num_unique, values.begin(),
+                        thrust::greater<int64_t>());
+  }
+
+  NDArray ret = NDArray::Empty({num_unique}, data->dtype, data->device);
+  thrust::device_ptr<DataType> ret_ptr(static_cast<DataType *>(ret->data));
+  thrust::copy(values.begin(), values.begin() + num_unique, ret_ptr);
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.unique.cuda")
+.set_body_typed([](NDArray data, bool sorted) -> NDArray {
+  auto dtype = DLDataType2String(data->dtype);
+  if (dtype == "int32") {
+    return thrust_unique<int>(data, sorted);
+  } else if (dtype == "int64") {
+    return thrust_unique<int64_t>(data, sorted);
+  } else if (dtype == "float32") {
+    return thrust_unique<float>(data, sorted);
+  } else if (dtype == "float64") {
+    return thrust_unique<double>(data, sorted);
+  }
+  LOG(FATAL) << "Unsupported data dtype: " << dtype
+             << ". Supported data dtypes are int32, int64, float32, and float64";
+  return NDArray();
+});
+
 }  // namespace contrib
 }  // namespace tvm
@@ -25,8 +25,14 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "workspace_pool.h"
 
@@ -34,18 +40,94 @@
 #include <android/api-level.h>
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TVM_CPU_MAPPED_ALLOC 1
+#endif
+
 namespace tvm {
 namespace runtime {
+
+/*!
+ * \brief The placement of the large CPU allocations, e.g. of the weights, read from the
+ *  environment variables TVM_CPU_HUGE_PAGES and TVM_CPU_NUMA_POLICY, and set by the packed
+ *  function "device_api.cpu.set_alloc_mode".
+ */
+struct CPUAllocMode {
+  /*! \brief The pages backing an allocation. */
+  enum class HugePages : int {
+    /*! \brief The default pages of the allocator. */
+    kNone = 0,
+    /*! \brief The transparent huge pages, by madvise on a range aligned to a huge page. */
+    kTransparent = 1,
+    /*! \brief The reserved huge pages by MAP_HUGETLB, or the transparent ones if none is left. */
+    kExplicit = 2,
+  };
+  /*! \brief The NUMA nodes of an allocation, those of the CPUs the allocating thread runs on. The
+   *  main thread shares the affinity of the thread pool once the pool is configured. */
+  enum class NUMAPolicy : int {
+    /*! \brief The first-touch placement of the kernel. */
+    kNone = 0,
+    /*! \brief Bound to the nodes. */
+    kLocal = 1,
+    /*! \brief Interleaved page by page across the nodes. */
+    kInterleave = 2,
+  };
+
+  static HugePages ParseHugePages(const std::string& value) {
+    if (value.empty() || value == "none") return HugePages::kNone;
+    if (value == "transparent") return HugePages::kTransparent;
+    if (value == "explicit") return HugePages::kExplicit;
+    LOG(FATAL) << "ValueError: Unknown huge pages \"" << value
+               << "\", expect one of \"none\", \"transparent\" and \"explicit\"";
+    return HugePages::kNone;
+  }
+
+  static NUMAPolicy ParseNUMAPolicy(const std::string& value) {
+    if (value.empty() || value == "none") return NUMAPolicy::kNone;
+    if (value == "local") return NUMAPolicy::kLocal;
+    if (value == "interleave") return NUMAPolicy::kInterleave;
+    LOG(FATAL) << "ValueError: Unknown NUMA policy \"" << value
+               << "\", expect one of \"none\", \"local\" and \"interleave\"";
+    return NUMAPolicy::kNone;
+  }
+};
+
 class CPUDeviceAPI final : public DeviceAPI {
  public:
+  CPUDeviceAPI() {
+    const char* huge_pages = getenv("TVM_CPU_HUGE_PAGES");
+    const char* numa_policy = getenv("TVM_CPU_NUMA_POLICY");
+    SetAllocMode(CPUAllocMode::ParseHugePages(huge_pages ? huge_pages : ""),
+                 CPUAllocMode::ParseNUMAPolicy(numa_policy ? numa_policy : ""));
+  }
+
   void SetDevice(Device dev) final {}
   void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final {
     if (kind == kExist) {
       *rv = 1;
     }
   }
+
+  /*! \brief Set the placement of the allocations from now on. */
+  void SetAllocMode(CPUAllocMode::HugePages huge_pages, CPUAllocMode::NUMAPolicy numa_policy) {
+    huge_pages_.store(static_cast<int>(huge_pages), std::memory_order_relaxed);
+    numa_policy_.store(static_cast<int>(numa_policy), std::memory_order_relaxed);
+  }
+
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
     void* ptr;
+#ifdef TVM_CPU_MAPPED_ALLOC
+    if (nbytes >= kHugePageBytes) {
+      if ((ptr = AllocMappedSpace(nbytes, alignment)) != nullptr) {
+        return ptr;
+      }
+    }
+#endif
 #if _MSC_VER
     ptr = _aligned_malloc(nbytes, alignment);
     if (ptr == nullptr) throw std::bad_alloc();
@@ -61,6 +143,21 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
 
   void FreeDataSpace(Device dev, void* ptr) final {
+#ifdef TVM_CPU_MAPPED_ALLOC
+    size_t length = 0;
+    {
+      std::lock_guard<std::mutex> lock(mapped_mutex_);
+      auto it = mapped_.find(ptr);
+      if (it != mapped_.end()) {
+        length = it->second;
+        mapped_.erase(it);
+      }
+    }
+    if (length != 0) {
+      munmap(ptr, length);
+      return;
+    }
+#endif
 #if _MSC_VER
     _aligned_free(ptr);
 #else
@@ -86,6 +183,142 @@ class CPUDeviceAPI final : public DeviceAPI {
                       TVMStreamHandle stream) final {
     memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
   }
+
+ private:
+  /*! \brief The size of a huge page, and the least size of an allocation placed by the mode. */
+  static constexpr size_t kHugePageBytes = 2 << 20;
+
+#ifdef TVM_CPU_MAPPED_ALLOC
+  /*! \brief The maximum number of NUMA nodes. */
+  static constexpr int kMaxNUMANodes = 1024;
+
+  /*!
+   * \brief Map the pages of a large allocation as the allocation mode specifies.
+   * \return The allocation, or nullptr if the mode is the default or the mapping fails.
+   */
+  void* AllocMappedSpace(size_t nbytes, size_t alignment) {
+    auto huge_pages =
+        static_cast<CPUAllocMode::HugePages>(huge_pages_.load(std::memory_order_relaxed));
+    auto numa_policy =
+        static_cast<CPUAllocMode::NUMAPolicy>(numa_policy_.load(std::memory_order_relaxed));
+    if (huge_pages == CPUAllocMode::HugePages::kNone &&
+        numa_policy == CPUAllocMode::NUMAPolicy::kNone) {
+      return nullptr;
+    }
+    size_t page = huge_pages == CPUAllocMode::HugePages::kNone
+                      ? static_cast<size_t>(sysconf(_SC_PAGESIZE))
+                      : kHugePageBytes;
+    if (alignment > page) {
+      return nullptr;
+    }
+    size_t length = (nbytes + page - 1) / page * page;
+    void* ptr = MAP_FAILED;
+    if (huge_pages == CPUAllocMode::HugePages::kExplicit) {
+      ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (ptr == MAP_FAILED) {
+      // Over-map by a huge page to align the range, and unmap the ends
+      size_t padding = huge_pages == CPUAllocMode::HugePages::kNone ? 0 : page;
+      char* base = static_cast<char*>(mmap(nullptr, length + padding, PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (base == MAP_FAILED) {
+        return nullptr;
+      }
+      char* begin = base + (page - reinterpret_cast<uintptr_t>(base) % page) % page;
+      if (begin != base) {
+        munmap(base, begin - base);
+      }
+      if (begin + length != base + length + padding) {
+        munmap(begin + length, base + padding - begin);
+      }
+      ptr = begin;
+      if (huge_pages != CPUAllocMode::HugePages::kNone) {
+        madvise(ptr, length, MADV_HUGEPAGE);
+      }
+    }
+    if (numa_policy != CPUAllocMode::NUMAPolicy::kNone) {
+      BindNUMANodes(ptr, length, numa_policy);
+    }
+    std::lock_guard<std::mutex> lock(mapped_mutex_);
+    mapped_[ptr] = length;
+    return ptr;
+  }
+
+  /*! \brief Bind the pages of a range, before they are touched, to the NUMA nodes of the CPUs
+   *  the current thread may run on. */
+  static void BindNUMANodes(void* ptr, size_t length, CPUAllocMode::NUMAPolicy numa_policy) {
+    const std::vector<int>& cpu_nodes = CPUNUMANodes();
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (cpu_nodes.empty() || sched_getaffinity(0, sizeof(cpuset), &cpuset) != 0) {
+      return;
+    }
+    unsigned long nodemask[kMaxNUMANodes / 64] = {0};  // NOLINT(runtime/int)
+    bool any = false;
+    for (int cpu = 0; cpu < static_cast<int>(cpu_nodes.size()) && cpu < CPU_SETSIZE; ++cpu) {
+      int node = cpu_nodes[cpu];
+      if (node >= 0 && node < kMaxNUMANodes && CPU_ISSET(cpu, &cpuset)) {
+        nodemask[node / 64] |= 1UL << (node % 64);
+        any = true;
+      }
+    }
+    if (!any) {
+      return;
+    }
+    int mode = numa_policy == CPUAllocMode::NUMAPolicy::kInterleave ? MPOL_INTERLEAVE : MPOL_BIND;
+    if (syscall(SYS_mbind, ptr, length, mode, nodemask, kMaxNUMANodes + 1, 0) != 0) {
+      static std::once_flag warned;
+      std::call_once(warned, [] { LOG(WARNING) << "mbind failed, using the default placement"; });
+    }
+  }
+
+  /*! \brief The NUMA node of each CPU, or -1 if unknown, read once from sysfs. */
+  static const std::vector<int>& CPUNUMANodes() {
+    static const std::vector<int> cpu_nodes = [] {
+      std::vector<int> result;
+      for (int node = 0; node < kMaxNUMANodes; ++node) {
+        std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!fin) {
+          continue;
+        }
+        // A list of ranges, e.g. "0-15,32-47"
+        std::string ranges;
+        std::getline(fin, ranges);
+        size_t pos = 0;
+        while (pos < ranges.size()) {
+          size_t end = ranges.find(',', pos);
+          std::string range = ranges.substr(pos, end == std::string::npos ? end : end - pos);
+          pos = end == std::string::npos ? ranges.size() : end + 1;
+          if (range.empty()) {
+            continue;
+          }
+          size_t dash = range.find('-');
+          int first = std::stoi(range.substr(0, dash));
+          int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+          if (static_cast<int>(result.size()) <= last) {
+            result.resize(last + 1, -1);
+          }
+          for (int cpu = first; cpu <= last; ++cpu) {
+            result[cpu] = node;
+          }
+        }
+      }
+      return result;
+    }();
+    return cpu_nodes;
+  }
+
+  /*! \brief The length of the mapping of each allocation by AllocMappedSpace. */
+  std::unordered_map<void*, size_t> mapped_;
+  /*! \brief The mutex of `mapped_`. */
+  std::mutex mapped_mutex_;
+#endif
+  /*! \brief The CPUAllocMode::HugePages of the allocations. */
+  std::atomic<int> huge_pages_{0};
+  /*! \brief The CPUAllocMode::NUMAPolicy of the allocations. */
+  std::atomic<int> numa_policy_{0};
+
 };
 
 struct CPUWorkspacePool : public WorkspacePool {
@@ -104,5 +337,17 @@ TVM_REGISTER_GLOBAL("device_api.cpu").set_body([](TVMArgs args, TVMRetValue* rv)
   DeviceAPI* ptr = CPUDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
 });
+
+/*!
+ * \brief Set the placement of the CPU allocations of at least a huge page from now on, e.g. to
+ *  interleave the weights across the NUMA nodes while loading them.
+ *  args[0] is the huge pages, "none", "transparent" or "explicit", and args[1] is the NUMA
+ *  policy, "none", "local" or "interleave". The allocations are placed as usual off Linux.
+ */
+TVM_REGISTER_GLOBAL("device_api.cpu.set_alloc_mode")
+    .set_body_typed([](std::string huge_pages, std::string numa_policy) {
+      CPUDeviceAPI::Global()->SetAllocMode(CPUAllocMode::ParseHugePages(huge_pages),
+                                           CPUAllocMode::ParseNUMAPolicy(numa_policy));
+    });
 }  // namespace runtime
 }  // namespace tvm
@@ -397,6 +397,9 @@ int TVMFuncFree(TVMFunctionHandle func) {
 int RPCTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_val,
                      int* ret_type_code);
 
+int RPCBatchTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_val,
+                          int* ret_type_code);
+
 // Sends CRT max packet size.
 int RPCGetCRTMaxPacketSize(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_value,
                            int* ret_type_codes) {
@@ -456,6 +459,10 @@ tvm_crt_error_t TVMInitializeRuntime() {
     error = TVMFuncRegisterGlobal("runtime.RPCTimeEvaluator", &RPCTimeEvaluator, 0);
   }
 
+  if (error == kTvmErrorNoError) {
+    error = TVMFuncRegisterGlobal("runtime.RPCBatchTimeEvaluator", &RPCBatchTimeEvaluator, 0);
+  }
+
   if (error == kTvmErrorNoError) {
     error = TVMFuncRegisterGlobal("tvm.rpc.server.GetCRTMaxPacketSize", &RPCGetCRTMaxPacketSize, 0);
   }
@@ -474,6 +481,9 @@ tvm_crt_error_t TVMInitializeRuntime() {
 typedef struct {
   uint16_t function_index;
   TVMFunctionHandle func_to_time;
+  // The functions timed in turn, either func_to_time or those of RPCBatchTimeEvaluator.
+  TVMFunctionHandle* funcs_to_time;
+  int num_funcs_to_time;
   DLDevice device;
   int number;
   int repeat;
@@ -485,10 +495,8 @@ typedef struct {
 
 static time_evaluator_state_t g_time_evaluator_state;
 
-int RPCTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_val,
-                     int* ret_type_code) {
-  ret_val[0].v_handle = NULL;
-  ret_type_code[0] = kTVMNullptr;
+// Check the arguments shared by RPCTimeEvaluator and RPCBatchTimeEvaluator and set up the state.
+static int SetTimeEvaluatorState(TVMValue* args, int* type_codes, int num_args) {
   if (num_args < 11) {
     TVMAPIErrorf("not enough args");
     return kTvmErrorFunctionCallNumArguments;
@@ -501,8 +509,6 @@ int RPCTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* re
     return kTvmErrorFunctionCallWrongArgType;
   }
 
-  TVMModuleHandle mod = (TVMModuleHandle)args[0].v_handle;
-  const char* name = args[1].v_str;
   g_time_evaluator_state.device.device_type = args[2].v_int64;
   g_time_evaluator_state.device.device_id = args[3].v_int64;
   g_time_evaluator_state.number = args[4].v_int64;
@@ -511,12 +517,44 @@ int RPCTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* re
   g_time_evaluator_state.limit_zero_time_iterations = args[7].v_int64;
   g_time_evaluator_state.cooldown_interval_ms = args[8].v_int64;
   g_time_evaluator_state.repeats_to_cooldown = args[9].v_int64;
+  return kTvmErrorNoError;
+}
 
-  int ret_code =
+// Release the functions of the last RPCBatchTimeEvaluator, if any.
+static tvm_crt_error_t ReleaseTimeEvaluatorFuncs() {
+  tvm_crt_error_t err = kTvmErrorNoError;
+  if (g_time_evaluator_state.funcs_to_time != NULL &&
+      g_time_evaluator_state.funcs_to_time != &g_time_evaluator_state.func_to_time) {
+    DLDevice dev = {kDLCPU, 0};
+    err = TVMPlatformMemoryFree(g_time_evaluator_state.funcs_to_time, dev);
+  }
+  g_time_evaluator_state.funcs_to_time = NULL;
+  g_time_evaluator_state.num_funcs_to_time = 0;
+  return err;
+}
+
+int RPCTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_val,
+                     int* ret_type_code) {
+  ret_val[0].v_handle = NULL;
+  ret_type_code[0] = kTVMNullptr;
+  int ret_code = SetTimeEvaluatorState(args, type_codes, num_args);
+  if (ret_code != 0) {
+    return ret_code;
+  }
+
+  TVMModuleHandle mod = (TVMModuleHandle)args[0].v_handle;
+  const char* name = args[1].v_str;
+  ret_code = ReleaseTimeEvaluatorFuncs();
+  if (ret_code != 0) {
+    return ret_code;
+  }
+  ret_code =
       TVMModGetFunction(mod, name, /* query_imports */ 0, &g_time_evaluator_state.func_to_time);
   if (ret_code != 0) {
     return ret_code;
   }
+  g_time_evaluator_state.funcs_to_time = &g_time_evaluator_state.func_to_time;
+  g_time_evaluator_state.num_funcs_to_time = 1;
 
   g_time_evaluator_state.function_index++;
   ret_val[0].v_handle =
@@ -525,79 +563,126 @@ int RPCTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* re
   return kTvmErrorNoError;
 }
 
-tvm_crt_error_t RunTimeEvaluator(tvm_function_index_t function_index, TVMValue* args,
-                                 int* type_codes, int num_args, TVMValue* ret_val,
-                                 int* ret_type_code) {
-  if (function_index != g_time_evaluator_state.function_index) {
-    return kTvmErrorTimeEvaluatorBadHandle;
+// Like RPCTimeEvaluator, but args[1] is a comma-separated list of the names of the functions, which
+// are timed in turn on the same arguments by a single call of the returned function. This lets a
+// host measure several candidates loaded in one firmware image in one round-trip.
+int RPCBatchTimeEvaluator(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_val,
+                          int* ret_type_code) {
+  ret_val[0].v_handle = NULL;
+  ret_type_code[0] = kTVMNullptr;
+  int ret_code = SetTimeEvaluatorState(args, type_codes, num_args);
+  if (ret_code != 0) {
+    return ret_code;
   }
 
-  // TODO(areusch): should *really* rethink needing to return doubles
-  DLDevice result_byte_dev = {kDLCPU, 0};
-  TVMByteArray* result_byte_arr = NULL;
-  tvm_crt_error_t err =
-      TVMPlatformMemoryAllocate(sizeof(TVMByteArray), result_byte_dev, (void*)&result_byte_arr);
-  if (err != kTvmErrorNoError) {
-    goto release_and_return;
+  TVMModuleHandle mod = (TVMModuleHandle)args[0].v_handle;
+  const char* names = args[1].v_str;
+  ret_code = ReleaseTimeEvaluatorFuncs();
+  if (ret_code != 0) {
+    return ret_code;
   }
-  result_byte_arr->data = NULL;
-  size_t data_size = sizeof(double) * g_time_evaluator_state.repeat;
-  err = TVMPlatformMemoryAllocate(data_size, result_byte_dev, (void**)&result_byte_arr->data);
-  if (err != kTvmErrorNoError) {
-    goto release_and_return;
+
+  int num_funcs = 1;
+  size_t names_size = 0;
+  for (; names[names_size] != '\0'; names_size++) {
+    if (names[names_size] == ',') {
+      num_funcs++;
+    }
   }
-  result_byte_arr->size = data_size;
 
+  DLDevice dev = {kDLCPU, 0};
+  char* name = NULL;
+  TVMFunctionHandle* funcs = NULL;
+  ret_code = TVMPlatformMemoryAllocate(num_funcs * sizeof(TVMFunctionHandle), dev, (void**)&funcs);
+  if (ret_code != kTvmErrorNoError) {
+    return ret_code;
+  }
+  ret_code = TVMPlatformMemoryAllocate(names_size + 1, dev, (void**)&name);
+  if (ret_code != kTvmErrorNoError) {
+    TVMPlatformMemoryFree(funcs, dev);
+    return ret_code;
+  }
+
+  // Look up each name in turn, copied so that it is NUL-terminated.
+  const char* begin = names;
+  int idx;
+  for (idx = 0; idx < num_funcs; idx++) {
+    const char* end = strchr(begin, ',');
+    size_t name_size = end != NULL ? (size_t)(end - begin) : strlen(begin);
+    memcpy(name, begin, name_size);
+    name[name_size] = '\0';
+    ret_code = TVMModGetFunction(mod, name, /* query_imports */ 0, &funcs[idx]);
+    if (ret_code != 0) {
+      break;
+    }
+    begin = end + 1;
+  }
+  TVMPlatformMemoryFree(name, dev);
+  if (ret_code != 0) {
+    TVMPlatformMemoryFree(funcs, dev);
+    return ret_code;
+  }
+  g_time_evaluator_state.funcs_to_time = funcs;
+  g_time_evaluator_state.num_funcs_to_time = num_funcs;
+
+  g_time_evaluator_state.function_index++;
+  ret_val[0].v_handle =
+      EncodeFunctionHandle(kTimeEvaluatorModuleIndex, g_time_evaluator_state.function_index);
+  ret_type_code[0] = kTVMPackedFuncHandle;
+  return kTvmErrorNoError;
+}
+
+// Time one function, writing the mean seconds of each of the `repeat` measurements to `results`.
+static tvm_crt_error_t TimeFunction(TVMFunctionHandle func_to_time, TVMValue* args,
+                                    int* type_codes, int num_args, TVMValue* ret_val,
+                                    int* ret_type_code, double* results) {
   // skip first time call, to activate lazy compilation components.
-  err = TVMFuncCall(g_time_evaluator_state.func_to_time, args, type_codes, num_args, ret_val,
-                    ret_type_code);
+  tvm_crt_error_t err =
+      TVMFuncCall(func_to_time, args, type_codes, num_args, ret_val, ret_type_code);
   if (err != kTvmErrorNoError) {
-    goto release_and_return;
+    return err;
   }
 
+  int number = g_time_evaluator_state.number;
   double min_repeat_seconds = ((double)g_time_evaluator_state.min_repeat_ms) / 1000;
-  double* iter = (double*)result_byte_arr->data;
   for (int i = 0; i < g_time_evaluator_state.repeat; i++) {
     double curr_res_seconds = 0.0;
     int absolute_zero_times = 0;
     // do-while structure ensures we run even when `min_repeat_ms` isn't set (i.e., is 0).
     do {
       if (curr_res_seconds > 0.0) {
-        double a = (min_repeat_seconds / (curr_res_seconds / g_time_evaluator_state.number) + 1);
+        double a = (min_repeat_seconds / (curr_res_seconds / number) + 1);
         const double golden_ratio = 1.618;
-        double b = g_time_evaluator_state.number * golden_ratio;
-        g_time_evaluator_state.number = (int64_t)(a > b ? a : b);
+        double b = number * golden_ratio;
+        number = (int64_t)(a > b ? a : b);
       }
       err = TVMPlatformBeforeMeasurement();
       if (err != kTvmErrorNoError) {
-        goto release_and_return;
+        return err;
       }
       err = TVMPlatformTimerStart();
       if (err != kTvmErrorNoError) {
-        goto release_and_return;
+        return err;
       }
 
-      for (int j = 0; j < g_time_evaluator_state.number; j++) {
-        err = TVMFuncCall(g_time_evaluator_state.func_to_time, args, type_codes, num_args, ret_val,
-                          ret_type_code);
+      for (int j = 0; j < number; j++) {
+        err = TVMFuncCall(func_to_time, args, type_codes, num_args, ret_val, ret_type_code);
         if (err != kTvmErrorNoError) {
-          goto release_and_return;
+          return err;
         }
       }
       err = TVMPlatformTimerStop(&curr_res_seconds);
       if (err != kTvmErrorNoError) {
-        goto release_and_return;
+        return err;
       }
       err = TVMPlatformAfterMeasurement();
       if (err != kTvmErrorNoError) {
-        goto release_and_return;
+        return err;
       }
       if (fpclassify(curr_res_seconds) == FP_ZERO) absolute_zero_times++;
     } while (curr_res_seconds < min_repeat_seconds &&
              absolute_zero_times < g_time_evaluator_state.limit_zero_time_iterations);
-    double mean_exec_seconds = curr_res_seconds / g_time_evaluator_state.number;
-    *iter = mean_exec_seconds;
-    iter++;
+    results[i] = curr_res_seconds / number;
     if (g_time_evaluator_state.cooldown_interval_ms > 0 &&
         (i % g_time_evaluator_state.repeats_to_cooldown) == 0) {
 #if defined(_WIN32) || defined(WIN32)
@@ -608,19 +693,58 @@ tvm_crt_error_t RunTimeEvaluator(tvm_function_index_t function_index, TVMValue*
       TVMAPIErrorf(
           "No support for non-zero cooldown_interval_ms for this platform: Use "
           "cooldown_interval_ms = 0");
-      goto release_and_return;
+      return kTvmErrorFunctionCallNotImplemented;
 #endif
     }
   }
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t RunTimeEvaluator(tvm_function_index_t function_index, TVMValue* args,
+                                 int* type_codes, int num_args, TVMValue* ret_val,
+                                 int* ret_type_code) {
+  if (function_index != g_time_evaluator_state.function_index ||
+      g_time_evaluator_state.num_funcs_to_time == 0) {
+    return kTvmErrorTimeEvaluatorBadHandle;
+  }
+
+  // TODO(areusch): should *really* rethink needing to return doubles
+  DLDevice result_byte_dev = {kDLCPU, 0};
+  TVMByteArray* result_byte_arr = NULL;
+  tvm_crt_error_t err =
+      TVMPlatformMemoryAllocate(sizeof(TVMByteArray), result_byte_dev, (void*)&result_byte_arr);
+  if (err != kTvmErrorNoError) {
+    return err;
+  }
+  result_byte_arr->data = NULL;
+  // The `repeat` results of each function in turn.
+  size_t data_size =
+      sizeof(double) * g_time_evaluator_state.repeat * g_time_evaluator_state.num_funcs_to_time;
+  err = TVMPlatformMemoryAllocate(data_size, result_byte_dev, (void**)&result_byte_arr->data);
+  if (err != kTvmErrorNoError) {
+    goto release_and_return;
+  }
+  result_byte_arr->size = data_size;
+
+  double* results = (double*)result_byte_arr->data;
+  for (int idx = 0; idx < g_time_evaluator_state.num_funcs_to_time; idx++) {
+    err = TimeFunction(g_time_evaluator_state.funcs_to_time[idx], args, type_codes, num_args,
+                       ret_val, ret_type_code, results + idx * g_time_evaluator_state.repeat);
+    if (err != kTvmErrorNoError) {
+      goto release_and_return;
+    }
+  }
 
   *ret_type_code = kTVMBytes;
   ret_val->v_handle = result_byte_arr;
   return err;
 
 release_and_return : {
-  tvm_crt_error_t release_err =
-      TVMPlatformMemoryFree((void*)result_byte_arr->data, result_byte_dev);
-  if (release_err != kTvmErrorNoError) {
+  tvm_crt_error_t release_err = kTvmErrorNoError;
+  if (result_byte_arr->data != NULL) {
+    release_err = TVMPlatformMemoryFree((void*)result_byte_arr->data, result_byte_dev);
+  }
+  if (release_err == kTvmErrorNoError) {
     release_err = TVMPlatformMemoryFree((void*)result_byte_arr, result_byte_dev);
   }
 
@@ -60,4 +60,7 @@
 /*! \brief Enable checks to enforce the stack allocator with a FIFO ordering. Off by default */
 // #define TVM_CRT_STACK_ALLOCATOR_ENABLE_FIFO_CHECK
 
+/*! \brief log2 of the largest size class of the TLSF allocator, which serves up to 16MB. */
+// #define TVM_CRT_TLSF_FL_INDEX_MAX 24
+
 #endif  // TVM_RUNTIME_CRT_CRT_CONFIG_TEMPLATE_H_
@@ -723,16 +723,81 @@ int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader) {
   return status;
 }
 
+/*!
+ * \brief Check a precomputed execution plan and use it instead of the graph nodes.
+ * \param executor The graph executor.
+ * \param plan The execution plan, which must outlive the executor.
+ * \return 0 on success.
+ */
+int TVMGraphExecutor_LoadPlan(TVMGraphExecutor* executor, const TVMGraphExecutorPlan* plan) {
+  uint32_t idx, arg;
+  for (idx = 0; idx < plan->ops_count; ++idx) {
+    const TVMGraphExecutorPlanOp* op = plan->ops + idx;
+    if (op->args_count >= TVM_CRT_MAX_ARGS) {
+      fprintf(stderr, "too many arguments: expected less than %d args, but got %d.\n",
+              TVM_CRT_MAX_ARGS, op->args_count);
+      return -1;
+    }
+    if (op->args_offset + op->args_count > plan->args_count) {
+      fprintf(stderr, "invalid plan: the arguments of op %d are out of bounds.\n", idx);
+      return -1;
+    }
+    for (arg = op->args_offset; arg < op->args_offset + op->args_count; ++arg) {
+      if (plan->args[arg] >= plan->entries_count) {
+        fprintf(stderr, "invalid plan: argument %d of op %d is out of bounds.\n", arg, idx);
+        return -1;
+      }
+    }
+  }
+  for (idx = 0; idx < plan->entries_count; ++idx) {
+    const TVMGraphExecutorPlanEntry* entry = plan->entries + idx;
+    if (entry->storage_id >= plan->storage_count || entry->ndim > TVM_CRT_MAX_NDIM) {
+      fprintf(stderr, "invalid plan: entry %d is out of bounds.\n", idx);
+      return -1;
+    }
+  }
+  for (idx = 0; idx < plan->inputs_count; ++idx) {
+    if (plan->input_entries[idx] >= plan->entries_count) {
+      fprintf(stderr, "invalid plan: input %d is out of bounds.\n", idx);
+      return -1;
+    }
+  }
+  for (idx = 0; idx < plan->outputs_count; ++idx) {
+    if (plan->output_entries[idx] >= plan->entries_count) {
+      fprintf(stderr, "invalid plan: output %d is out of bounds.\n", idx);
+      return -1;
+    }
+  }
+  executor->plan = plan;
+  return 0;
+}
+
 uint32_t TVMGraphExecutor_GetEntryId(TVMGraphExecutor* executor, uint32_t nid, uint32_t index) {
   return executor->node_row_ptr[nid] + index;
 }
 
+/*!
+ * \brief Get the data entry id of an input.
+ * \param executor The graph executor.
+ * \param index The index of the input.
+ * \return The data entry id of the input.
+ */
+uint32_t TVMGraphExecutor_GetInputEntryId(TVMGraphExecutor* executor, uint32_t index) {
+  if (executor->plan != NULL) {
+    return executor->plan->input_entries[index];
+  }
+  return TVMGraphExecutor_GetEntryId(executor, executor->input_nodes[index], 0);
+}
+
 /*!
  * \brief Get the number of input tensors allocated.
  * \param executor The graph executor.
  * \return the number of input tensors allocated.
  */
 int TVMGraphExecutor_GetNumInputs(TVMGraphExecutor* executor) {
+  if (executor->plan != NULL) {
+    return executor->plan->inputs_count;
+  }
   return executor->input_nodes_count;
 }
 
@@ -745,9 +810,12 @@ int TVMGraphExecutor_GetNumInputs(TVMGraphExecutor* executor) {
 int TVMGraphExecutor_GetInputIndex(TVMGraphExecutor* executor, const char* name) {
   uint32_t i;
   int32_t rv = -1;
-  for (i = 0; i < executor->input_nodes_count; ++i) {
-    uint32_t nid = executor->input_nodes[i];
-    if (!strcmp(executor->nodes[nid].name, name)) {
+  uint32_t inputs_count = TVMGraphExecutor_GetNumInputs(executor);
+  for (i = 0; i < inputs_count; ++i) {
+    const char* input_name = executor->plan != NULL
+                                 ? executor->plan->input_names[i]
+                                 : executor->nodes[executor->input_nodes[i]].name;
+    if (!strcmp(input_name, name)) {
       rv = i;
       break;
     }
@@ -764,10 +832,10 @@ int TVMGraphExecutor_GetInputIndex(TVMGraphExecutor* executor, const char* name)
  */
 void TVMGraphExecutor_SetInput(TVMGraphExecutor* executor, const char* name, DLTensor* data_in) {
   uint32_t index = TVMGraphExecutor_GetInputIndex(executor, name);
-  if (index >= executor->input_nodes_count) {
+  if (index >= TVMGraphExecutor_GetNumInputs(executor)) {
     fprintf(stderr, "given index is greater than num of input nodes.\n");
   }
-  uint32_t eid = TVMGraphExecutor_GetEntryId(executor, executor->input_nodes[index], 0);
+  uint32_t eid = TVMGraphExecutor_GetInputEntryId(executor, index);
   executor->data_entry[eid].dl_tensor.data = data_in->data;
 }
 
@@ -792,21 +860,28 @@ int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_bl
   memcpy(&reserved, bptr, sizeof(reserved));
   bptr += sizeof(reserved);
 
-  // read names
+  // read names, of at most as many params as nodes, or inputs of a plan
   char* names = NULL;
   DLDevice dev = {kDLCPU, 0};
+  uint32_t max_names_count =
+      executor->plan != NULL ? executor->plan->inputs_count : executor->nodes_count;
   tvm_crt_error_t err = TVMPlatformMemoryAllocate(
-      TVM_CRT_MAX_STRLEN_PARAM_NAME * executor->nodes_count, dev, (void**)&names);
+      TVM_CRT_MAX_STRLEN_PARAM_NAME * max_names_count, dev, (void**)&names);
   if (err != kTvmErrorNoError) {
     fprintf(stderr, "memory allocate error: %08x", err);
     status = -1;
     return status;
   }
-  memset(names, 0, TVM_CRT_MAX_STRLEN_PARAM_NAME * executor->nodes_count);
+  memset(names, 0, TVM_CRT_MAX_STRLEN_PARAM_NAME * max_names_count);
   uint64_t names_count;
   int idx;
   memcpy(&names_count, bptr, sizeof(names_count));
   bptr += sizeof(names_count);
+  if (names_count > max_names_count) {
+    fprintf(stderr, "Invalid parameters file format\n");
+    TVMPlatformMemoryFree(names, dev);
+    return -1;
+  }
   for (idx = 0; idx < names_count; idx++) {
     uint64_t name_length;
     memcpy(&name_length, bptr, sizeof(name_length));
@@ -834,7 +909,7 @@ int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_bl
         TVMGraphExecutor_GetInputIndex(executor, names + TVM_CRT_MAX_STRLEN_PARAM_NAME * idx);
     CHECK_GT(in_idx, 0, "Found param for non-existent input: %s\n",
              names + TVM_CRT_MAX_STRLEN_PARAM_NAME * idx);
-    uint32_t eid = TVMGraphExecutor_GetEntryId(executor, executor->input_nodes[in_idx], 0);
+    uint32_t eid = TVMGraphExecutor_GetInputEntryId(executor, in_idx);
     if (!(eid < executor->data_entry_count)) {
       fprintf(stderr, "`entry_id`=%d is greater than expected(%d).\n", eid,
               executor->data_entry_count);
@@ -896,13 +971,23 @@ void TVMGraphExecutor_Run(TVMGraphExecutor* executor) {
  * \param executor The graph executor.
  * \return the number of output tensors allocated.
  */
-int TVMGraphExecutor_GetNumOutputs(TVMGraphExecutor* executor) { return executor->outputs_count; }
+int TVMGraphExecutor_GetNumOutputs(TVMGraphExecutor* executor) {
+  if (executor->plan != NULL) {
+    return executor->plan->outputs_count;
+  }
+  return executor->outputs_count;
+}
 
 int TVMGraphExecutor_GetOutput(TVMGraphExecutor* executor, const int32_t idx, DLTensor* out) {
   int status = 0;
-  uint32_t nid = executor->outputs[idx].node_id;
-  uint32_t index = executor->outputs[idx].index;
-  uint32_t eid = TVMGraphExecutor_GetEntryId(executor, nid, index);
+  uint32_t eid;
+  if (executor->plan != NULL) {
+    eid = executor->plan->output_entries[idx];
+  } else {
+    uint32_t nid = executor->outputs[idx].node_id;
+    uint32_t index = executor->outputs[idx].index;
+    eid = TVMGraphExecutor_GetEntryId(executor, nid, index);
+  }
 
   // copy data section to allocated output tensor
   int32_t elem_bytes = out->dtype.bits / 8;
@@ -915,7 +1000,92 @@ int TVMGraphExecutor_GetOutput(TVMGraphExecutor* executor, const int32_t idx, DL
   return status;
 }
 
+/*!
+ * \brief Allocate the storage pool and the data entries from a precomputed execution plan.
+ * \param executor The graph executor.
+ * \return 0 on success.
+ */
+int TVMGraphExecutor_SetupPlanStorage(TVMGraphExecutor* executor) {
+  const TVMGraphExecutorPlan* plan = executor->plan;
+  TVMPackedFunc lookup_linked_param;
+  int lookup_linked_param_valid;
+  uint32_t idx;
+
+  {
+    TVMArgs temp_args;
+    temp_args.values[0].v_int64 = 0;
+    temp_args.tcodes[0] = kTVMArgInt;
+    temp_args.values_count = 1;
+    lookup_linked_param_valid =
+        (TVMPackedFunc_InitModuleFunc(&lookup_linked_param, executor->module_handle,
+                                      "_lookup_linked_param", &temp_args) == 0);
+  }
+
+  DLDevice alloc_dev = {kDLCPU, 0};
+  tvm_crt_error_t err =
+      TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutorStorageEntry) * plan->storage_count,
+                                alloc_dev, (void**)&executor->storage_pool);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memset(executor->storage_pool, 0, sizeof(TVMGraphExecutorStorageEntry) * plan->storage_count);
+  DLDevice dev = executor->devices[0];
+  for (idx = 0; idx < plan->storage_count; idx++) {
+    TVMGraphExecutorStorageEntry* storage = &executor->storage_pool[idx];
+    if (lookup_linked_param_valid) {
+      lookup_linked_param.args.values[0].v_int64 = idx;
+      CHECK_EQ(lookup_linked_param.Call(&lookup_linked_param), 0, "lookup_linked_param");
+
+      void* linked_param_data = lookup_linked_param.ret_value.values[0].v_handle;
+      if (linked_param_data != NULL) {
+        // A linked param is stored as a flat array of bytes, viewed by its entry.
+        storage->is_linked_param = 1;
+        DLTensor* tensor = &storage->array.dl_tensor;
+        tensor->data = linked_param_data;
+        tensor->device = dev;
+        tensor->ndim = 1;
+        tensor->shape = NULL;
+        tensor->strides = NULL;
+        tensor->byte_offset = 0;
+        executor->storage_pool_count++;
+        continue;
+      }
+    }
+    DLDataType dtype = {kDLFloat, 32, 1};
+    int64_t shape[TVM_CRT_MAX_NDIM] = {
+        0,
+    };
+    shape[0] = (plan->storage_sizes[idx] + 3) / 4;
+    int status = TVMNDArray_Empty(1, shape, dtype, dev, &storage->array);
+    CHECK_EQ(status, 0, "fail to create storage_pool with idx=%d\n", idx);
+    executor->storage_pool_count++;
+  }
+
+  executor->data_entry_count = plan->entries_count;
+  err = TVMPlatformMemoryAllocate(sizeof(TVMNDArray) * executor->data_entry_count, alloc_dev,
+                                  (void**)&executor->data_entry);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  for (idx = 0; idx < executor->data_entry_count; ++idx) {
+    const TVMGraphExecutorPlanEntry* entry = plan->entries + idx;
+    int status = TVMNDArray_CreateView(&(executor->storage_pool[entry->storage_id].array),
+                                       plan->shapes + entry->shape_offset, entry->ndim,
+                                       entry->dtype, &executor->data_entry[idx]);
+    CHECK_EQ(status, 0, "fail to create for node with idx=%d, storage_id=%u\n", idx,
+             entry->storage_id);
+
+    TVMNDArray_IncrementReference(&executor->data_entry[idx]);
+  }
+  return 0;
+}
+
 int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
+  if (executor->plan != NULL) {
+    return TVMGraphExecutor_SetupPlanStorage(executor);
+  }
   TVMPackedFunc lookup_linked_param;
   int lookup_linked_param_valid;
   uint32_t idx;
@@ -1051,7 +1221,49 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
   return 0;
 }
 
+/*!
+ * \brief Create the operators from a precomputed execution plan.
+ * \param executor The graph executor.
+ * \return 0 on success.
+ */
+int TVMGraphExecutor_SetupPlanOpExecs(TVMGraphExecutor* executor) {
+  const TVMGraphExecutorPlan* plan = executor->plan;
+  int status = 0;
+  uint32_t op_idx, idx;
+  executor->op_execs_count = plan->ops_count;
+  DLDevice dev = {kDLCPU, 0};
+  tvm_crt_error_t err = TVMPlatformMemoryAllocate(sizeof(TVMPackedFunc) * executor->op_execs_count,
+                                                  dev, (void**)&executor->op_execs);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  for (op_idx = 0; op_idx < plan->ops_count; op_idx++) {
+    const TVMGraphExecutorPlanOp* op = plan->ops + op_idx;
+    DLTensorPtr args[TVM_CRT_MAX_ARGS];
+    for (idx = 0; idx < op->args_count; idx++) {
+      args[idx] = &(executor->data_entry[plan->args[op->args_offset + idx]].dl_tensor);
+    }
+    TVMOpParam param;
+    memset(&param, 0, sizeof(param));
+    strncpy(param.func_name, op->func_name, TVM_CRT_MAX_STRLEN_FUNCTION_NAME - 1);
+    param.flatten_data = op->flatten_data;
+#if TVM_CRT_DEBUG
+    printf("tvm_op: creating %s with op_idx=%d\n", param.func_name, op_idx);
+#endif  // TVM_CRT_DEBUG
+    status = TVMGraphExecutor_CreateTVMOp(executor, &param, args, op->args_count,
+                                          &executor->op_execs[op_idx]);
+    if (status != 0) {
+      break;
+    }
+  }
+  return status;
+}
+
 int TVMGraphExecutor_SetupOpExecs(TVMGraphExecutor* executor) {
+  if (executor->plan != NULL) {
+    return TVMGraphExecutor_SetupPlanOpExecs(executor);
+  }
   int status = 0;
   uint32_t nid, idx;
   executor->op_execs_count = executor->nodes_count;
@@ -1201,6 +1413,31 @@ int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
   return TVMGraphExecutor_Init(*executor, sym_json, module_handle, devs);
 }
 
+int TVMGraphExecutor_CreateFromPlan(const TVMGraphExecutorPlan* plan,
+                                    TVMModuleHandle module_handle, const DLDevice* devs,
+                                    TVMGraphExecutor** executor) {
+  DLDevice dev = {kDLCPU, 0};
+  tvm_crt_error_t err = TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutor), dev, (void**)executor);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+
+  memset(*executor, 0, sizeof(TVMGraphExecutor));
+  int status = TVMGraphExecutor_LoadPlan(*executor, plan);
+  if (status != 0) {
+    return status;
+  }
+  (*executor)->module_handle = module_handle;
+  (*executor)->devices[0] = devs[0];
+
+  status = TVMGraphExecutor_SetupStorage(*executor);
+  if (status != 0) {
+    return status;
+  }
+  return TVMGraphExecutor_SetupOpExecs(*executor);
+}
+
 int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
   int status = 0;
   int32_t idx;
@@ -1212,9 +1449,12 @@ int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
     }
   }
   DLDevice dev = {kDLCPU, 0};
-  status = TVMPlatformMemoryFree(executor->nodes, dev);
-  if (status != 0) {
-    return status;
+  // The graph of a plan is not copied.
+  if (executor->plan == NULL) {
+    status = TVMPlatformMemoryFree(executor->nodes, dev);
+    if (status != 0) {
+      return status;
+    }
   }
   status = TVMGraphExecutorGraphAttr_Release(&(executor->attrs));
   if (status != 0) {
@@ -1234,17 +1474,19 @@ int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
       return status;
     }
   }
-  status = TVMPlatformMemoryFree(executor->input_nodes, dev);
-  if (status != 0) {
-    return status;
-  }
-  status = TVMPlatformMemoryFree(executor->node_row_ptr, dev);
-  if (status != 0) {
-    return status;
-  }
-  status = TVMPlatformMemoryFree(executor->outputs, dev);
-  if (status != 0) {
-    return status;
+  if (executor->plan == NULL) {
+    status = TVMPlatformMemoryFree(executor->input_nodes, dev);
+    if (status != 0) {
+      return status;
+    }
+    status = TVMPlatformMemoryFree(executor->node_row_ptr, dev);
+    if (status != 0) {
+      return status;
+    }
+    status = TVMPlatformMemoryFree(executor->outputs, dev);
+    if (status != 0) {
+      return status;
+    }
   }
   status = TVMPlatformMemoryFree(executor->storage_pool, dev);
   if (status != 0) {
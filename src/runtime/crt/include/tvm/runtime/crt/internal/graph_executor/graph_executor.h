@@ -106,6 +106,8 @@ typedef struct TVMGraphExecutor {
   /*! \brief Operator on each node. */
   TVMPackedFunc* op_execs;
   uint32_t op_execs_count;
+  /*! \brief The precomputed execution plan, used instead of the graph nodes if not NULL. */
+  const TVMGraphExecutorPlan* plan;
 } TVMGraphExecutor;
 
 typedef DLTensor* DLTensorPtr;
@@ -122,6 +124,8 @@ int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpPara
                                      DLTensorPtr* args, const uint32_t args_count,
                                      TVMPackedFunc* pf);
 int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader);
+int TVMGraphExecutor_LoadPlan(TVMGraphExecutor* executor, const TVMGraphExecutorPlan* plan);
+uint32_t TVMGraphExecutor_GetInputEntryId(TVMGraphExecutor* executor, uint32_t index);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/crt/include/tvm/runtime/crt/internal/memory/tlsf_allocator.h
+ * \brief Defines data types and functions used in the TLSF memory manager.
+ *     Exposed for testing.
+ */
+
+#ifndef TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/stack_allocator.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include "crt_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief log2 of the largest size class, which holds blocks below twice its size. */
+#ifndef TVM_CRT_TLSF_FL_INDEX_MAX
+#define TVM_CRT_TLSF_FL_INDEX_MAX 24
+#endif
+
+/*! \brief log2 of the number of second-level size classes in a first-level one. */
+#define TLSF_SL_INDEX_LOG2 4
+/*! \brief The number of second-level size classes in a first-level one. */
+#define TLSF_SL_INDEX_COUNT (1 << TLSF_SL_INDEX_LOG2)
+/*! \brief log2 of the alignment of the payloads and of their sizes. */
+#define TLSF_ALIGNMENT_LOG2 4
+/*! \brief The alignment of the payloads and of their sizes. */
+#define TLSF_ALIGNMENT_BYTES (1 << TLSF_ALIGNMENT_LOG2)
+/*! \brief log2 of the size below which the second-level classes split the sizes linearly. */
+#define TLSF_SMALL_BLOCK_LOG2 (TLSF_SL_INDEX_LOG2 + TLSF_ALIGNMENT_LOG2)
+/*! \brief The number of first-level size classes; the first holds the small blocks. */
+#define TLSF_FL_INDEX_COUNT (TVM_CRT_TLSF_FL_INDEX_MAX - TLSF_SMALL_BLOCK_LOG2 + 2)
+
+#if TLSF_ALIGNMENT_BYTES < TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES
+#error "The TLSF allocator aligns the allocations to less than TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES"
+#endif
+
+/*!
+ * \brief The header of a block of the pool, followed by its payload.
+ *
+ * The free blocks keep the links of their free list at the beginning of their payload.
+ */
+typedef struct TLSFBlock {
+  /*! \brief The block just before this one in the pool, or NULL for the first block. */
+  struct TLSFBlock* prev_phys;
+  /*! \brief The bytes of the payload; the lowest bit is set when the block is free. */
+  size_t size;
+} TLSFBlock;
+
+/*! \brief The bytes of a block header, padded to keep the payloads aligned. */
+#define TLSF_HEADER_BYTES \
+  ((sizeof(TLSFBlock) + TLSF_ALIGNMENT_BYTES - 1) / TLSF_ALIGNMENT_BYTES * TLSF_ALIGNMENT_BYTES)
+
+/*! \brief The links of a free block to the other free blocks of its size class. */
+typedef struct TLSFFreeLinks {
+  TLSFBlock* next;
+  TLSFBlock* prev;
+} TLSFFreeLinks;
+
+/*!
+ * \brief TLSF memory manager
+ *  Keeps a free list per size class, and a bitmap of the non-empty lists per level to find the
+ *  smallest class fitting a request with two bit scans.
+ */
+typedef struct TLSFMemoryManager {
+  // Public interface for this object.
+  MemoryManagerInterface interface;
+  // Bit fl is set when a list of the first-level class fl is not empty.
+  uint32_t fl_bitmap;
+  // Bit sl of sl_bitmap[fl] is set when the list of (fl, sl) is not empty.
+  uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+  // The heads of the free lists.
+  TLSFBlock* free_lists[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+  // The first block of the pool.
+  TLSFBlock* first_block;
+  // The empty used block ending the pool, which is never merged.
+  TLSFBlock* sentinel;
+  // The bytes of the blocks of the pool, headers included.
+  size_t pool_bytes;
+  // The bytes of the used blocks, headers included.
+  size_t used_bytes;
+  // The largest used_bytes so far.
+  size_t peak_used_bytes;
+} TLSFMemoryManager;
+
+/*!
+ * \brief Compute the size class of a block size.
+ * \param size The payload bytes, a multiple of TLSF_ALIGNMENT_BYTES.
+ * \param fl Pointer, set to the first-level index.
+ * \param sl Pointer, set to the second-level index.
+ */
+void TLSFMapping(size_t size, int* fl, int* sl);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
@@ -0,0 +1,314 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file tlsf_allocator.c
+ * \brief Two-level segregated fit memory manager
+ *
+ * The free blocks are kept in lists by size class: the first level splits the sizes by powers of
+ * two, and the second level splits each power of two linearly. A request is rounded up to the
+ * next class, so that the head of any non-empty list at or above it fits the request, found by
+ * scanning the bitmaps of the non-empty lists. A freed block is merged with its free neighbours
+ * in the pool, so that no two free blocks are adjacent.
+ *
+ * To maximize portability, thread-safe feature has been dropped for now.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/logging.h>
+#include <tvm/runtime/crt/platform.h>
+
+#define TLSF_ROUND_UP(qty, modulo) (((qty) + ((modulo)-1)) / (modulo) * (modulo))
+
+/*! \brief The bit of the size of a block set when it is free. */
+#define TLSF_BLOCK_FREE_BIT ((size_t)1)
+/*! \brief The largest request, which still maps to a size class once rounded up. */
+#define TLSF_MAX_REQUEST_BYTES ((size_t)1 << TVM_CRT_TLSF_FL_INDEX_MAX)
+/*! \brief The largest block, in the last size class. */
+#define TLSF_MAX_BLOCK_BYTES (((size_t)2 << TVM_CRT_TLSF_FL_INDEX_MAX) - TLSF_ALIGNMENT_BYTES)
+
+// index of the most significant bit set in a nonzero value
+static int TLSF_Fls(size_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long)value);  // NOLINT(*)
+#else
+  int bit = 0;
+  while (value >>= 1) {
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+// index of the least significant bit set in a nonzero bitmap
+static int TLSF_Ffs(uint32_t bitmap) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(bitmap);
+#else
+  int bit = 0;
+  while (!(bitmap & 1)) {
+    bitmap >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+static size_t TLSFBlock_Size(const TLSFBlock* block) { return block->size & ~TLSF_BLOCK_FREE_BIT; }
+
+static int TLSFBlock_IsFree(const TLSFBlock* block) {
+  return (block->size & TLSF_BLOCK_FREE_BIT) != 0;
+}
+
+static uint8_t* TLSFBlock_Payload(TLSFBlock* block) { return (uint8_t*)block + TLSF_HEADER_BYTES; }
+
+static TLSFBlock* TLSFBlock_Next(TLSFBlock* block) {
+  return (TLSFBlock*)(TLSFBlock_Payload(block) + TLSFBlock_Size(block));
+}
+
+static TLSFFreeLinks* TLSFBlock_Links(TLSFBlock* block) {
+  return (TLSFFreeLinks*)TLSFBlock_Payload(block);
+}
+
+void TLSFMapping(size_t size, int* fl, int* sl) {
+  if (size < ((size_t)1 << TLSF_SMALL_BLOCK_LOG2)) {
+    *fl = 0;
+    *sl = (int)(size >> TLSF_ALIGNMENT_LOG2);
+  } else {
+    int msb = TLSF_Fls(size);
+    *fl = msb - TLSF_SMALL_BLOCK_LOG2 + 1;
+    *sl = (int)(size >> (msb - TLSF_SL_INDEX_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+  }
+}
+
+static void TLSF_InsertFree(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSFMapping(TLSFBlock_Size(block), &fl, &sl);
+  TLSFBlock* head = mgr->free_lists[fl][sl];
+  TLSFFreeLinks* links = TLSFBlock_Links(block);
+  links->next = head;
+  links->prev = NULL;
+  if (head != NULL) {
+    TLSFBlock_Links(head)->prev = block;
+  }
+  mgr->free_lists[fl][sl] = block;
+  mgr->fl_bitmap |= (uint32_t)1 << fl;
+  mgr->sl_bitmap[fl] |= (uint32_t)1 << sl;
+  block->size |= TLSF_BLOCK_FREE_BIT;
+}
+
+static void TLSF_RemoveFree(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSFMapping(TLSFBlock_Size(block), &fl, &sl);
+  TLSFFreeLinks* links = TLSFBlock_Links(block);
+  if (links->next != NULL) {
+    TLSFBlock_Links(links->next)->prev = links->prev;
+  }
+  if (links->prev != NULL) {
+    TLSFBlock_Links(links->prev)->next = links->next;
+  } else {
+    mgr->free_lists[fl][sl] = links->next;
+    if (links->next == NULL) {
+      mgr->sl_bitmap[fl] &= ~((uint32_t)1 << sl);
+      if (mgr->sl_bitmap[fl] == 0) {
+        mgr->fl_bitmap &= ~((uint32_t)1 << fl);
+      }
+    }
+  }
+  block->size &= ~TLSF_BLOCK_FREE_BIT;
+}
+
+// find a free block of at least the given payload bytes, in constant time
+static TLSFBlock* TLSF_FindFree(TLSFMemoryManager* mgr, size_t size) {
+  // round up to the next size class, whose blocks all fit the request
+  if (size >= ((size_t)1 << TLSF_SMALL_BLOCK_LOG2)) {
+    size += ((size_t)1 << (TLSF_Fls(size) - TLSF_SL_INDEX_LOG2)) - 1;
+  }
+  int fl, sl;
+  TLSFMapping(size, &fl, &sl);
+  uint32_t sl_bitmap = mgr->sl_bitmap[fl] & (~(uint32_t)0 << sl);
+  if (sl_bitmap == 0) {
+    uint32_t fl_bitmap = mgr->fl_bitmap & (~(uint32_t)0 << (fl + 1));
+    if (fl_bitmap == 0) {
+      return NULL;
+    }
+    fl = TLSF_Ffs(fl_bitmap);
+    sl_bitmap = mgr->sl_bitmap[fl];
+  }
+  sl = TLSF_Ffs(sl_bitmap);
+  return mgr->free_lists[fl][sl];
+}
+
+/*!
+ * \brief Allocate memory from manager
+ * \param interface Pointer to this structure.
+ * \param num_bytes Number of bytes requested.
+ * \param dev Execution device that will be used with the allocated memory. Must be {kDLCPU, 0}.
+ * \param out_ptr A pointer to which is written a pointer to the newly-allocated memory.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TLSFMemoryManager_Allocate(MemoryManagerInterface* interface, size_t num_bytes,
+                                           DLDevice dev, void** out_ptr) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+
+  *out_ptr = NULL;
+  if (num_bytes > TLSF_MAX_REQUEST_BYTES) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t size = TLSF_ROUND_UP(num_bytes == 0 ? 1 : num_bytes, TLSF_ALIGNMENT_BYTES);
+  TLSFBlock* block = TLSF_FindFree(mgr, size);
+  if (block == NULL) {
+#if TVM_CRT_DEBUG > 1
+    TVMLogf("insufficient memory, size=%zu, used=%zu / %zu", num_bytes, mgr->used_bytes,
+            mgr->pool_bytes);
+#endif
+    return kTvmErrorPlatformNoMemory;
+  }
+  TLSF_RemoveFree(mgr, block);
+
+  // split off the rest of the block when it holds a block of its own
+  size_t block_size = TLSFBlock_Size(block);
+  if (block_size >= size + TLSF_HEADER_BYTES + TLSF_ALIGNMENT_BYTES) {
+    TLSFBlock* rest = (TLSFBlock*)(TLSFBlock_Payload(block) + size);
+    rest->prev_phys = block;
+    rest->size = block_size - size - TLSF_HEADER_BYTES;
+    block->size = size;
+    TLSFBlock_Next(rest)->prev_phys = rest;
+    TLSF_InsertFree(mgr, rest);
+  }
+
+  mgr->used_bytes += TLSF_HEADER_BYTES + TLSFBlock_Size(block);
+  if (mgr->used_bytes > mgr->peak_used_bytes) {
+    mgr->peak_used_bytes = mgr->used_bytes;
+  }
+  mgr->interface.vleak_size++;
+  *out_ptr = TLSFBlock_Payload(block);
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("allocate: addr=%p, size=%zu, used=%zu / %zu, vleak=%d\n", *out_ptr,
+          TLSFBlock_Size(block), mgr->used_bytes, mgr->pool_bytes, mgr->interface.vleak_size);
+#endif  // TVM_CRT_DEBUG
+  return kTvmErrorNoError;
+}
+
+/*!
+ * \brief Free the memory.
+ * \param interface Pointer to this structure.
+ * \param ptr A pointer returned from TVMPlatformMemoryAllocate which should be free'd.
+ * \param dev Execution device passed to TVMPlatformMemoryAllocate. Fixed to {kDLCPU, 0}.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TLSFMemoryManager_Free(MemoryManagerInterface* interface, void* ptr, DLDevice dev) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+
+  uint8_t* data = (uint8_t*)ptr;
+  if (data < TLSFBlock_Payload(mgr->first_block) || data >= (uint8_t*)mgr->sentinel ||
+      (uintptr_t)data % TLSF_ALIGNMENT_BYTES != 0) {
+    return kTvmErrorPlatformBadFree;
+  }
+  TLSFBlock* block = (TLSFBlock*)(data - TLSF_HEADER_BYTES);
+  if (TLSFBlock_IsFree(block)) {
+    return kTvmErrorPlatformBadFree;
+  }
+  mgr->used_bytes -= TLSF_HEADER_BYTES + TLSFBlock_Size(block);
+  mgr->interface.vleak_size--;
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("release: addr=%p, size=%zu, used=%zu / %zu, vleak=%d", ptr, TLSFBlock_Size(block),
+          mgr->used_bytes, mgr->pool_bytes, mgr->interface.vleak_size);
+#endif  // TVM_CRT_DEBUG
+
+  // merge with the free neighbours; the sentinel is never free
+  TLSFBlock* next = TLSFBlock_Next(block);
+  if (TLSFBlock_IsFree(next)) {
+    TLSF_RemoveFree(mgr, next);
+    block->size += TLSF_HEADER_BYTES + TLSFBlock_Size(next);
+  }
+  TLSFBlock* prev = block->prev_phys;
+  if (prev != NULL && TLSFBlock_IsFree(prev)) {
+    TLSF_RemoveFree(mgr, prev);
+    prev->size += TLSF_HEADER_BYTES + TLSFBlock_Size(block);
+    block = prev;
+  }
+  TLSFBlock_Next(block)->prev_phys = block;
+  TLSF_InsertFree(mgr, block);
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** interface, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes) {
+  uintptr_t pool_begin = (uintptr_t)memory_pool;
+  uintptr_t pool_end = pool_begin + memory_pool_size_bytes;
+  uintptr_t manager_begin = TLSF_ROUND_UP(pool_begin, TLSF_ALIGNMENT_BYTES);
+  uintptr_t blocks_begin =
+      TLSF_ROUND_UP(manager_begin + sizeof(TLSFMemoryManager), TLSF_ALIGNMENT_BYTES);
+  // the first block needs room for its header, the smallest payload and the sentinel header
+  if (pool_end < blocks_begin + 2 * TLSF_HEADER_BYTES + TLSF_ALIGNMENT_BYTES) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t block_size = (pool_end - blocks_begin - 2 * TLSF_HEADER_BYTES) / TLSF_ALIGNMENT_BYTES *
+                      TLSF_ALIGNMENT_BYTES;
+  if (block_size > TLSF_MAX_BLOCK_BYTES) {
+    block_size = TLSF_MAX_BLOCK_BYTES;
+  }
+
+  TLSFMemoryManager* manager = (TLSFMemoryManager*)manager_begin;
+  memset(manager, 0, sizeof(TLSFMemoryManager));
+  manager->interface.Allocate = TLSFMemoryManager_Allocate;
+  manager->interface.Free = TLSFMemoryManager_Free;
+
+  TLSFBlock* block = (TLSFBlock*)blocks_begin;
+  block->prev_phys = NULL;
+  block->size = block_size;
+  TLSFBlock* sentinel = TLSFBlock_Next(block);
+  sentinel->prev_phys = block;
+  sentinel->size = 0;
+  manager->first_block = block;
+  manager->sentinel = sentinel;
+  manager->pool_bytes = TLSF_HEADER_BYTES + block_size;
+  TLSF_InsertFree(manager, block);
+
+  *interface = &manager->interface;
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManagerGetStats(MemoryManagerInterface* interface,
+                                          TLSFMemoryManagerStats* stats) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+  stats->pool_bytes = mgr->pool_bytes;
+  stats->used_bytes = mgr->used_bytes;
+  stats->peak_used_bytes = mgr->peak_used_bytes;
+  stats->largest_free_bytes = 0;
+  if (mgr->fl_bitmap != 0) {
+    // the largest free block is in the last non-empty list
+    int fl = TLSF_Fls(mgr->fl_bitmap);
+    int sl = TLSF_Fls(mgr->sl_bitmap[fl]);
+    for (TLSFBlock* block = mgr->free_lists[fl][sl]; block != NULL;
+         block = TLSFBlock_Links(block)->next) {
+      if (TLSFBlock_Size(block) > stats->largest_free_bytes) {
+        stats->largest_free_bytes = TLSFBlock_Size(block);
+      }
+    }
+  }
+  return kTvmErrorNoError;
+}
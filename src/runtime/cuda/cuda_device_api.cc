@@ -28,7 +28,11 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
+#include <set>
+#include <utility>
 
 #include "cuda_common.h"
 
@@ -163,7 +167,10 @@ class CUDADeviceAPI final : public DeviceAPI {
       if (dev_from.device_id == dev_to.device_id) {
         GPUCopy(from, to, size, cudaMemcpyDeviceToDevice, cu_stream);
       } else {
-        cudaMemcpyPeerAsync(to, dev_to.device_id, from, dev_from.device_id, size, cu_stream);
+        // The copy goes over the peer link once the access is enabled, instead of via the host.
+        EnablePeerAccess(dev_from.device_id, dev_to.device_id);
+        CUDA_CALL(
+            cudaMemcpyPeerAsync(to, dev_to.device_id, from, dev_from.device_id, size, cu_stream));
       }
     } else if (dev_from.device_type == kDLCUDA && dev_to.device_type == kDLCPU) {
       CUDA_CALL(cudaSetDevice(dev_from.device_id));
@@ -211,11 +218,13 @@ class CUDADeviceAPI final : public DeviceAPI {
   }
 
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final {
-    return CUDAThreadEntry::ThreadLocal()->pool.AllocWorkspace(dev, size);
+    CUDAThreadEntry* entry = CUDAThreadEntry::ThreadLocal();
+    return entry->pool.AllocWorkspace(dev, size, entry->stream);
   }
 
   void FreeWorkspace(Device dev, void* data) final {
-    CUDAThreadEntry::ThreadLocal()->pool.FreeWorkspace(dev, data);
+    CUDAThreadEntry* entry = CUDAThreadEntry::ThreadLocal();
+    entry->pool.FreeWorkspace(dev, data, entry->stream);
   }
 
   static CUDADeviceAPI* Global() {
@@ -234,6 +243,36 @@ class CUDADeviceAPI final : public DeviceAPI {
       CUDA_CALL(cudaMemcpy(to, from, size, kind));
     }
   }
+  /*!
+   * \brief Enable the access of a device to the memory of another one, in both directions, if the
+   *  pair supports it. Each pair is checked once per process.
+   */
+  static void EnablePeerAccess(int device_a, int device_b) {
+    static std::mutex mutex;
+    static std::set<std::pair<int, int>> checked;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!checked.insert({std::min(device_a, device_b), std::max(device_a, device_b)}).second) {
+      return;
+    }
+    int current;
+    CUDA_CALL(cudaGetDevice(&current));
+    std::pair<int, int> pairs[] = {{device_a, device_b}, {device_b, device_a}};
+    for (const auto& pair : pairs) {
+      int can_access = 0;
+      CUDA_CALL(cudaDeviceCanAccessPeer(&can_access, pair.first, pair.second));
+      if (can_access) {
+        CUDA_CALL(cudaSetDevice(pair.first));
+        cudaError_t err = cudaDeviceEnablePeerAccess(pair.second, 0);
+        if (err == cudaErrorPeerAccessAlreadyEnabled) {
+          // Enabled by another library in the process, which clears the error.
+          cudaGetLastError();
+        } else {
+          CUDA_CALL(err);
+        }
+      }
+    }
+    CUDA_CALL(cudaSetDevice(current));
+  }
 };
 
 typedef dmlc::ThreadLocalStore<CUDAThreadEntry> CUDAThreadStore;
@@ -300,5 +339,10 @@ TVM_DLL String GetCudaFreeMemory() {
 
 TVM_REGISTER_GLOBAL("runtime.GetCudaFreeMemory").set_body_typed(GetCudaFreeMemory);
 
+// The stream of the calling thread, for the kernels compiled outside of TVM, e.g. by BYOC.
+TVM_REGISTER_GLOBAL("runtime.get_cuda_stream").set_body_typed([]() {
+  return static_cast<void*>(CUDAThreadEntry::ThreadLocal()->stream);
+});
+
 }  // namespace runtime
 }  // namespace tvm
@@ -27,8 +27,13 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
 #include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -41,10 +46,77 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief Split a PTX module into a module per kernel, so that each kernel is JIT-compiled by the
+ *  driver on its own.
+ *
+ *  A kernel module is the module-scope directives of the PTX, such as .version, .target and the
+ *  .extern .shared arrays, followed by the kernel. A module with device functions or global
+ *  variables is not split, as they would be duplicated into every kernel module.
+ *
+ * \param ptx The PTX module.
+ * \return The PTX of each kernel by name, or empty if the module is not split.
+ */
+static std::unordered_map<std::string, std::string> SplitPTX(const std::string& ptx) {
+  std::ostringstream header;
+  std::vector<std::pair<std::string, std::string>> kernels;
+  std::istringstream is(ptx);
+  std::string line;
+  int depth = 0;
+  bool in_kernel = false;
+  bool has_body = false;
+  while (std::getline(is, line)) {
+    if (depth == 0 && !in_kernel) {
+      size_t pos = line.find(".entry");
+      if (pos != std::string::npos) {
+        size_t begin = line.find_first_not_of(" \t", pos + 6);
+        size_t end = line.find_first_of(" \t(", begin);
+        if (begin == std::string::npos) {
+          return {};
+        }
+        kernels.emplace_back(line.substr(begin, end - begin), "");
+        in_kernel = true;
+        has_body = false;
+      } else if (line.find(".func") != std::string::npos ||
+                 line.find(".global") != std::string::npos) {
+        return {};
+      }
+    }
+    for (char c : line) {
+      if (c == '{') {
+        ++depth;
+        has_body = true;
+      } else if (c == '}') {
+        --depth;
+      }
+    }
+    if (in_kernel) {
+      kernels.back().second += line + "\n";
+      if (has_body && depth == 0) {
+        in_kernel = false;
+      }
+    } else {
+      header << line << "\n";
+    }
+  }
+  if (depth != 0 || in_kernel || kernels.size() < 2) {
+    return {};
+  }
+  std::unordered_map<std::string, std::string> result;
+  for (const auto& kv : kernels) {
+    result[kv.first] = header.str() + kv.second;
+  }
+  return result;
+}
+
 // Module to support thread-safe multi-GPU execution.
 // cuModule is a per-GPU module
 // The runtime will contain a per-device module table
 // The modules will be lazily loaded
+//
+// A PTX module with several kernels is split into a module per kernel, so that the first call to
+// a kernel only JIT-compiles that kernel. The kernels can also be loaded ahead of their first call
+// by a pool of threads in the background, see StartWarmUp.
 class CUDAModuleNode : public runtime::ModuleNode {
  public:
   explicit CUDAModuleNode(std::string data, std::string fmt,
@@ -52,15 +124,76 @@ class CUDAModuleNode : public runtime::ModuleNode {
                           std::string cuda_source)
       : data_(data), fmt_(fmt), fmap_(fmap), cuda_source_(cuda_source) {
     std::fill(module_.begin(), module_.end(), nullptr);
+    if (fmt_ == "ptx") {
+      for (auto& kv : SplitPTX(data_)) {
+        auto kernel = std::make_unique<Kernel>();
+        kernel->ptx = std::move(kv.second);
+        std::fill(kernel->module.begin(), kernel->module.end(), nullptr);
+        kernels_.emplace(kv.first, std::move(kernel));
+      }
+    }
   }
   // destructor
   ~CUDAModuleNode() {
+    stop_warm_up_ = true;
+    for (std::thread& worker : warm_up_workers_) {
+      worker.join();
+    }
     for (size_t i = 0; i < module_.size(); ++i) {
       if (module_[i] != nullptr) {
         CUDA_CALL(cudaSetDevice(static_cast<int>(i)));
         CUDA_DRIVER_CALL(cuModuleUnload(module_[i]));
       }
     }
+    for (auto& kv : kernels_) {
+      for (size_t i = 0; i < kv.second->module.size(); ++i) {
+        if (kv.second->module[i] != nullptr) {
+          CUDA_CALL(cudaSetDevice(static_cast<int>(i)));
+          CUDA_DRIVER_CALL(cuModuleUnload(kv.second->module[i]));
+        }
+      }
+    }
+  }
+
+  /*!
+   * \brief Load every kernel onto a device in the background, on a pool of threads.
+   * \param device_id The device.
+   * \param num_threads The number of threads.
+   * \note The kernels called before they are loaded are loaded on the calling thread. The threads
+   *  stop in between kernels when the module is destroyed.
+   */
+  void StartWarmUp(int device_id, int num_threads) {
+    if (kernels_.empty()) {
+      // The module is loaded as a whole, on a single thread.
+      num_threads = 1;
+    }
+    auto names = std::make_shared<std::vector<std::string>>();
+    for (const auto& kv : kernels_) {
+      names->push_back(kv.first);
+    }
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    for (int i = 0; i < num_threads; ++i) {
+      warm_up_workers_.emplace_back([this, device_id, names, next]() {
+        try {
+          CUDA_CALL(cudaSetDevice(device_id));
+          // Initialize the primary context of the device on this thread.
+          CUDA_CALL(cudaFree(nullptr));
+          if (names->empty()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            LoadModule(device_id);
+            return;
+          }
+          for (size_t j = (*next)++; j < names->size() && !stop_warm_up_; j = (*next)++) {
+            Kernel* kernel = kernels_.at((*names)[j]).get();
+            std::lock_guard<std::mutex> lock(kernel->mutex);
+            LoadKernel(kernel, device_id);
+          }
+        } catch (const std::runtime_error& e) {
+          // The error is raised again by the call to the kernel.
+          LOG(WARNING) << "Failed to load the CUDA module in the background: " << e.what();
+        }
+      });
+    }
   }
 
   const char* type_key() const final { return "cuda"; }
@@ -99,13 +232,20 @@ class CUDAModuleNode : public runtime::ModuleNode {
 
   // get a CUfunction from primary context in device_id
   CUfunction GetFunc(int device_id, const std::string& func_name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // must recheck under the lock scope
-    if (module_[device_id] == nullptr) {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
+    CUmodule module;
+    auto it = kernels_.find(func_name);
+    if (it != kernels_.end()) {
+      // The kernels of a split module are loaded under locks of their own, so that they are
+      // JIT-compiled in parallel.
+      Kernel* kernel = it->second.get();
+      std::lock_guard<std::mutex> lock(kernel->mutex);
+      module = LoadKernel(kernel, device_id);
+    } else {
+      std::lock_guard<std::mutex> lock(mutex_);
+      module = LoadModule(device_id);
     }
     CUfunction func;
-    CUresult result = cuModuleGetFunction(&func, module_[device_id], func_name.c_str());
+    CUresult result = cuModuleGetFunction(&func, module, func_name.c_str());
     if (result != CUDA_SUCCESS) {
       const char* msg;
       cuGetErrorName(result, &msg);
@@ -116,10 +256,7 @@ class CUDAModuleNode : public runtime::ModuleNode {
   // get a global var from primary context in device_id
   CUdeviceptr GetGlobal(int device_id, const std::string& global_name, size_t expect_nbytes) {
     std::lock_guard<std::mutex> lock(mutex_);
-    // must recheck under the lock scope
-    if (module_[device_id] == nullptr) {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
-    }
+    LoadModule(device_id);
     CUdeviceptr global;
     size_t nbytes;
 
@@ -134,6 +271,32 @@ class CUDAModuleNode : public runtime::ModuleNode {
   }
 
  private:
+  /*! \brief A kernel of a split PTX module. */
+  struct Kernel {
+    /*! \brief The PTX module of the kernel alone. */
+    std::string ptx;
+    /*! \brief The loaded module per GPU. */
+    std::array<CUmodule, kMaxNumGPUs> module;
+    /*! \brief The mutex guarding the loading. */
+    std::mutex mutex;
+  };
+
+  // load the whole module onto device_id, under mutex_
+  CUmodule LoadModule(int device_id) {
+    // must recheck under the lock scope
+    if (module_[device_id] == nullptr) {
+      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
+    }
+    return module_[device_id];
+  }
+  // load a kernel onto device_id, under the mutex of the kernel
+  CUmodule LoadKernel(Kernel* kernel, int device_id) {
+    if (kernel->module[device_id] == nullptr) {
+      CUDA_DRIVER_CALL(cuModuleLoadData(&(kernel->module[device_id]), kernel->ptx.c_str()));
+    }
+    return kernel->module[device_id];
+  }
+
   // the binary data
   std::string data_;
   // The format
@@ -146,6 +309,12 @@ class CUDAModuleNode : public runtime::ModuleNode {
   std::array<CUmodule, kMaxNumGPUs> module_;
   // internal mutex when updating the module
   std::mutex mutex_;
+  // the kernels of the split PTX module, or empty if the module is loaded as a whole.
+  std::unordered_map<std::string, std::unique_ptr<Kernel>> kernels_;
+  // the threads loading the kernels in the background.
+  std::vector<std::thread> warm_up_workers_;
+  // whether the background threads are to stop.
+  std::atomic<bool> stop_warm_up_{false};
 };
 
 // a wrapped function class to get packed func.
@@ -263,6 +432,22 @@ Module CUDAModuleCreate(std::string data, std::string fmt,
   return Module(n);
 }
 
+/*!
+ * \brief Create a module loaded from a file or a binary, and start loading its kernels onto the
+ *  current device in the background on TVM_CUDA_WARMUP_THREADS threads, if it is set.
+ */
+static Module CUDAModuleCreateWithWarmUp(std::string data, std::string fmt,
+                                         std::unordered_map<std::string, FunctionInfo> fmap) {
+  auto n = make_object<CUDAModuleNode>(data, fmt, fmap, std::string());
+  const char* num_threads = std::getenv("TVM_CUDA_WARMUP_THREADS");
+  if (num_threads != nullptr && std::atoi(num_threads) > 0) {
+    int device_id;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    n->StartWarmUp(device_id, std::atoi(num_threads));
+  }
+  return Module(n);
+}
+
 // Load module from module.
 Module CUDAModuleLoadFile(const std::string& file_name, const std::string& format) {
   std::string data;
@@ -271,7 +456,7 @@ Module CUDAModuleLoadFile(const std::string& file_name, const std::string& forma
   std::string meta_file = GetMetaFilePath(file_name);
   LoadBinaryFromFile(file_name, &data);
   LoadMetaDataFromFile(meta_file, &fmap);
-  return CUDAModuleCreate(data, fmt, fmap, std::string());
+  return CUDAModuleCreateWithWarmUp(data, fmt, fmap);
 }
 
 Module CUDAModuleLoadBinary(void* strm) {
@@ -282,7 +467,7 @@ Module CUDAModuleLoadBinary(void* strm) {
   stream->Read(&fmt);
   stream->Read(&fmap);
   stream->Read(&data);
-  return CUDAModuleCreate(data, fmt, fmap, std::string());
+  return CUDAModuleCreateWithWarmUp(data, fmt, fmap);
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_cubin").set_body_typed(CUDAModuleLoadFile);
@@ -28,6 +28,13 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <fstream>
 #include <unordered_map>
 #include <vector>
@@ -247,5 +254,44 @@ TVM_REGISTER_GLOBAL("runtime.LoadParams").set_body_typed([](const String& s) {
   return ::tvm::runtime::LoadParams(s);
 });
 
+MappedFile::MappedFile(const std::string& file_name) {
+#ifndef _WIN32
+  int fd = open(file_name.c_str(), O_RDONLY);
+  ICHECK_GE(fd, 0) << "Cannot open " << file_name;
+  struct stat st;
+  ICHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << file_name;
+  size_ = static_cast<size_t>(st.st_size);
+  void* ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  ICHECK(ptr != MAP_FAILED) << "Cannot map " << file_name;
+  data_ = static_cast<char*>(ptr);
+#else
+  LoadBinaryFromFile(file_name, &buffer_);
+  data_ = const_cast<char*>(buffer_.data());
+  size_ = buffer_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  munmap(data_, size_);
+#endif
+}
+
+/*! \brief The NDArray deleter of the arrays viewing a mapped file. */
+static void MappedArrayDeleter(Object* obj) {
+  auto* ptr = static_cast<NDArray::Container*>(obj);
+  delete static_cast<std::shared_ptr<MappedFile>*>(ptr->manager_ctx);
+  delete ptr;
+}
+
+NDArray MappedFile::View(const std::shared_ptr<MappedFile>& file, uint64_t offset,
+                         ShapeTuple shape, DLDataType dtype) {
+  auto* container = new NDArray::Container(file->data() + offset, shape, dtype, Device{kDLCPU, 0});
+  container->manager_ctx = new std::shared_ptr<MappedFile>(file);
+  container->SetDeleter(MappedArrayDeleter);
+  return NDArray(GetObjectPtr<Object>(container));
+}
+
 }  // namespace runtime
 }  // namespace tvm
@@ -27,6 +27,7 @@
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -129,6 +130,37 @@ std::string SaveParams(const Map<String, NDArray>& params);
  * \param params Parameters to save.
  */
 void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+
+/*!
+ * \brief A file mapped in memory, with a copy-on-write private mapping.
+ * \note Falls back to reading the whole file where mmap is not available.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_name);
+  ~MappedFile();
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /*!
+   * \brief View a part of a mapped file as a CPU NDArray, which keeps the file mapped while alive.
+   * \param file The mapped file.
+   * \param offset The offset of the data in the file.
+   * \param shape The shape of the array.
+   * \param dtype The dtype of the array.
+   * \return The array.
+   */
+  static NDArray View(const std::shared_ptr<MappedFile>& file, uint64_t offset, ShapeTuple shape,
+                      DLDataType dtype);
+
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+#ifdef _WIN32
+  std::string buffer_;
+#endif
+};
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_FILE_UTILS_H_
@@ -22,6 +22,7 @@
  */
 #include "graph_executor.h"
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/data_type.h>
@@ -31,12 +32,18 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -59,12 +66,67 @@ constexpr auto Is2DStorage = IsTextureStorage;
  * \brief Run all the operations one by one.
  */
 void GraphExecutor::Run() {
+  // The operators of a named thread pool cannot launch tasks nested in the tasks of the graph
+  if (parallel_ && thread_pool_.empty()) {
+    RunParallel();
+    return;
+  }
+  threading::ThreadPoolScope thread_pool_scope(thread_pool_);
   // setup the array and requirements.
   for (size_t i = 0; i < op_execs_.size(); ++i) {
     if (op_execs_[i]) op_execs_[i]();
   }
 }
 
+void GraphExecutor::RunParallel() {
+  if (sched_pending_ == nullptr) {
+    SetupParallelSchedule();
+  }
+  uint32_t num_ops = sched_nodes_.size();
+  sched_claimed_.store(0, std::memory_order_relaxed);
+  sched_filled_.store(0, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < num_ops; ++i) {
+    sched_pending_[i].store(sched_num_deps_[i], std::memory_order_relaxed);
+    sched_ready_[i].store(-1, std::memory_order_relaxed);
+  }
+  for (uint32_t i = 0; i < num_ops; ++i) {
+    if (sched_num_deps_[i] == 0) {
+      sched_ready_[sched_filled_.fetch_add(1, std::memory_order_relaxed)].store(
+          i, std::memory_order_relaxed);
+    }
+  }
+  bool work_stealing = threading::IsWorkStealing();
+  threading::SetWorkStealing(true);
+  TVMBackendParallelLaunch(
+      [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+        static_cast<GraphExecutor*>(cdata)->RunReadyOps();
+        return 0;
+      },
+      this, 0);
+  threading::SetWorkStealing(work_stealing);
+}
+
+void GraphExecutor::RunReadyOps() {
+  uint32_t num_ops = sched_nodes_.size();
+  // Every thread claims the next slot of the ready operators, waiting for it to be filled if the
+  // operators ready so far are all claimed. The slots claimed before are either running or waiting
+  // for their operators, whose dependencies are running, until all the operators are claimed.
+  for (uint32_t slot = sched_claimed_.fetch_add(1); slot < num_ops;
+       slot = sched_claimed_.fetch_add(1)) {
+    int32_t op;
+    while ((op = sched_ready_[slot].load(std::memory_order_acquire)) < 0) {
+      std::this_thread::yield();
+    }
+    uint32_t nid = sched_nodes_[op];
+    if (op_execs_[nid]) op_execs_[nid]();
+    for (uint32_t succ : sched_successors_[op]) {
+      if (sched_pending_[succ].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        sched_ready_[sched_filled_.fetch_add(1)].store(succ, std::memory_order_release);
+      }
+    }
+  }
+}
+
 /*!
  * \brief Initialize the graph executor with graph and device.
  * \param graph_json The execution graph.
@@ -291,6 +353,207 @@ void GraphExecutor::LoadParams(dmlc::Stream* strm) {
   }
 }
 
+/*! \brief A stream reading a file, the runtime not linking the filesystems of dmlc. */
+class FileReadStream : public dmlc::SeekStream {
+ public:
+  explicit FileReadStream(const std::string& file_name)
+      : fs_(file_name, std::ios::in | std::ios::binary) {
+    CHECK(!fs_.fail()) << "ValueError: Cannot open the parameters file " << file_name;
+  }
+
+  size_t Read(void* ptr, size_t size) final {
+    fs_.read(static_cast<char*>(ptr), size);
+    return static_cast<size_t>(fs_.gcount());
+  }
+  void Write(const void* ptr, size_t size) final { LOG(FATAL) << "FileReadStream is read-only"; }
+  void Seek(size_t pos) final {
+    fs_.clear();
+    fs_.seekg(pos);
+  }
+  size_t Tell() final { return static_cast<size_t>(fs_.tellg()); }
+
+ private:
+  std::ifstream fs_;
+};
+
+/*!
+ * \brief Uploads the tensors of a params file into their device storage chunk by chunk, through
+ *  two host staging buffers uploaded on a stream each, so that the upload of a chunk overlaps
+ *  the read of the next one.
+ */
+class ParamUploader {
+ public:
+  /*! \brief The size of a staging buffer. */
+  static constexpr size_t kChunkBytes = 4 << 20;
+
+  ~ParamUploader() { Reset(); }
+
+  /*!
+   * \brief Copy the data of a tensor into its storage.
+   * \param strm The stream at the start of the data, read when the data is not mapped.
+   * \param mapped The data mapped in memory, which must stay mapped until Finish, or nullptr.
+   * \param dst The storage.
+   * \param nbytes The size of the data.
+   */
+  void Upload(dmlc::Stream* strm, const char* mapped, const NDArray& dst, size_t nbytes) {
+    if (dst->device.device_type == kDLCPU) {
+      char* data = static_cast<char*>(dst->data) + dst->byte_offset;
+      if (mapped != nullptr) {
+        std::memcpy(data, mapped, nbytes);
+      } else {
+        ICHECK_EQ(strm->Read(data, nbytes), nbytes) << "Invalid parameters file format";
+      }
+      return;
+    }
+    if (api_ == nullptr || dev_.device_type != dst->device.device_type ||
+        dev_.device_id != dst->device.device_id) {
+      Reset();
+      dev_ = dst->device;
+      api_ = DeviceAPI::Get(dev_);
+      Device host = dev_.device_type == kDLCUDA ? Device{kDLCUDAHost, 0} : Device{kDLCPU, 0};
+      for (Staging& staging : staging_) {
+        staging.stream = api_->CreateStream(dev_);
+        staging.buffer = NDArray::Empty({static_cast<int64_t>(kChunkBytes)}, DataType::UInt(8),
+                                        host);
+      }
+    }
+    if (mapped != nullptr) {
+      CopyChunk(mapped, dst, 0, nbytes, staging_[0].stream);
+      staging_[0].pending = true;
+      return;
+    }
+    for (size_t offset = 0; offset < nbytes; offset += kChunkBytes) {
+      size_t size = std::min(kChunkBytes, nbytes - offset);
+      Staging& staging = staging_[next_];
+      next_ ^= 1;
+      if (staging.pending) {
+        api_->StreamSync(dev_, staging.stream);
+      }
+      char* data = static_cast<char*>(staging.buffer->data);
+      ICHECK_EQ(strm->Read(data, size), size) << "Invalid parameters file format";
+      CopyChunk(data, dst, offset, size, staging.stream);
+      staging.pending = true;
+    }
+  }
+
+  /*! \brief Wait for the uploads. */
+  void Finish() {
+    for (Staging& staging : staging_) {
+      if (staging.pending) {
+        api_->StreamSync(dev_, staging.stream);
+        staging.pending = false;
+      }
+    }
+  }
+
+ private:
+  /*! \brief A staging buffer and the stream it is uploaded on. */
+  struct Staging {
+    NDArray buffer;
+    TVMStreamHandle stream{nullptr};
+    bool pending{false};
+  };
+
+  void CopyChunk(const char* src, const NDArray& dst, size_t offset, size_t size,
+                 TVMStreamHandle stream) {
+    int64_t shape = static_cast<int64_t>(size);
+    DLTensor from{const_cast<char*>(src), Device{kDLCPU, 0}, 1, DataType::UInt(8), &shape,
+                  nullptr, 0};
+    DLTensor to{dst->data, dst->device, 1, DataType::UInt(8), &shape, nullptr,
+                dst->byte_offset + offset};
+    api_->CopyDataFromTo(&from, &to, stream);
+  }
+
+  void Reset() {
+    if (api_ == nullptr) return;
+    Finish();
+    for (Staging& staging : staging_) {
+      api_->FreeStream(dev_, staging.stream);
+      staging = Staging();
+    }
+    api_ = nullptr;
+  }
+
+  Device dev_{kDLCPU, 0};
+  DeviceAPI* api_{nullptr};
+  Staging staging_[2];
+  int next_{0};
+};
+
+void GraphExecutor::LoadParamsFromFile(const std::string& file_name, bool use_mmap) {
+  std::shared_ptr<MappedFile> mapped;
+  std::unique_ptr<dmlc::SeekStream> strm;
+  if (use_mmap) {
+    mapped = std::make_shared<MappedFile>(file_name);
+    strm = std::make_unique<dmlc::MemoryFixedSizeStream>(mapped->data(), mapped->size());
+  } else {
+    strm = std::make_unique<FileReadStream>(file_name);
+  }
+  uint64_t header, reserved;
+  ICHECK(strm->Read(&header)) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
+  std::vector<std::string> names;
+  ICHECK(strm->Read(&names)) << "Invalid parameters file format";
+  uint64_t sz;
+  strm->Read(&sz);
+  size_t size = static_cast<size_t>(sz);
+  ICHECK(size == names.size()) << "Invalid parameters file format";
+  ParamUploader uploader;
+  for (size_t i = 0; i < size; ++i) {
+    // The header of the tensor, see NDArray::Load
+    uint64_t tensor_header, tensor_reserved;
+    Device dev;
+    int ndim;
+    DLDataType dtype;
+    ICHECK(strm->Read(&tensor_header)) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&tensor_reserved)) << "Invalid DLTensor file format";
+    ICHECK(tensor_header == kTVMNDArrayMagic) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&dev)) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&ndim)) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(&dtype)) << "Invalid DLTensor file format";
+    std::vector<int64_t> shape(ndim);
+    if (ndim != 0) {
+      ICHECK(strm->ReadArray(&shape[0], ndim)) << "Invalid DLTensor file format";
+    }
+    int64_t data_byte_size;
+    ICHECK(strm->Read(&data_byte_size)) << "Invalid DLTensor file format";
+    size_t data_offset = strm->Tell();
+    size_t data_end = data_offset + static_cast<size_t>(data_byte_size);
+    param_names_.insert(names[i]);
+    int in_idx = GetInputIndex(names[i]);
+    if (in_idx < 0) {
+      strm->Seek(data_end);
+      continue;
+    }
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    NDArray dst = data_entry_[eid];
+    CHECK_EQ(GetDataSize(*dst.operator->()), static_cast<size_t>(data_byte_size))
+        << "ValueError: The size of the parameter " << names[i] << " mismatches its input";
+    bool is_2d = !attrs_.storage_scope.empty() && details::Is2DStorage(attrs_.storage_scope[eid]);
+    if (!DMLC_IO_NO_ENDIAN_SWAP || is_2d) {
+      // The tensor is swapped or laid out as a texture on the host first
+      NDArray host = NDArray::Empty(ShapeTuple(shape), dtype, Device{kDLCPU, 0});
+      if (mapped != nullptr) {
+        std::memcpy(host->data, mapped->data() + data_offset, data_byte_size);
+      } else {
+        ICHECK_EQ(strm->Read(host->data, data_byte_size), static_cast<size_t>(data_byte_size))
+            << "Invalid DLTensor file format";
+      }
+      if (!DMLC_IO_NO_ENDIAN_SWAP) {
+        int elem_bytes = (dtype.bits + 7) / 8;
+        dmlc::ByteSwap(host->data, elem_bytes, data_byte_size / elem_bytes);
+      }
+      dst.CopyFrom(host);
+    } else {
+      uploader.Upload(strm.get(), mapped != nullptr ? mapped->data() + data_offset : nullptr, dst,
+                      data_byte_size);
+    }
+    strm->Seek(data_end);
+  }
+  uploader.Finish();
+}
+
 void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm) {
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
@@ -313,6 +576,12 @@ void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm)
     const DLTensor* tmp = data_entry_[eid].operator->();
     data_alignment_[eid] = details::GetDataAlignment(*tmp);
   }
+  // Free the storage of the params, which no entry views any more
+  for (NDArray& storage : storage_pool_) {
+    if (storage.defined() && storage.use_count() == 1) {
+      storage = NDArray();
+    }
+  }
   this->SetupOpExecs();
 }
 
@@ -393,6 +662,9 @@ void GraphExecutor::SetupStorage() {
     pool_entry[sid].param_data_entry = i;
     pool_entry[sid].device_type = device_type;
     pool_entry[sid].scope = storage_scope;
+    if (!attrs_.storage_offset.empty()) {
+      pool_entry[sid].offset = attrs_.storage_offset[i];
+    }
 
     DLDataType t = vtype[i];
     if (!details::Is2DStorage(storage_scope)) {
@@ -425,15 +697,61 @@ void GraphExecutor::SetupStorage() {
     }
   }
 
-  // Allocate the space.
-  for (const auto& pit : pool_entry) {
-    // This for loop is very fast since there are usually only a couple of
+  // The storages planned at an offset in the arena of their device are views into it, when the
+  // device memory is addressable. The others are allocated on their own.
+  auto find_device = [this](const PoolEntry& pit) {
+    // This lookup is very fast since there are usually only a couple of
     // devices available on the same hardware.
     const auto& cit = std::find_if(devices_.begin(), devices_.end(), [&pit](const Device& d) {
       return pit.device_type == static_cast<int>(d.device_type);
     });
-    Device dev = cit == devices_.end() ? devices_[0] : *cit;
-    if (pit.linked_param.defined()) {
+    return cit == devices_.end() ? devices_[0] : *cit;
+  };
+  auto in_arena = [&find_device](const PoolEntry& pit) {
+    if (pit.offset < 0 || pit.linked_param.defined() || details::Is2DStorage(pit.scope)) {
+      return false;
+    }
+    switch (find_device(pit).device_type) {
+      case kDLCPU:
+      case kDLCUDA:
+      case kDLCUDAHost:
+      case kDLCUDAManaged:
+      case kDLROCM:
+      case kDLROCMHost:
+        return true;
+      default:
+        return false;
+    }
+  };
+  std::map<int, int64_t> arena_bytes;
+  for (const auto& pit : pool_entry) {
+    if (in_arena(pit)) {
+      int64_t& bytes = arena_bytes[pit.device_type];
+      bytes = std::max(bytes, pit.offset + pit.shape[0]);
+    }
+  }
+  std::map<int, NDArray> arenas;
+  for (const auto& pit : pool_entry) {
+    if (in_arena(pit) && !arenas.count(pit.device_type)) {
+      int64_t size = (arena_bytes[pit.device_type] + 3) / 4;
+      arenas[pit.device_type] = NDArray::Empty({size}, pit.dtype, find_device(pit));
+    }
+  }
+
+  // Allocate the space.
+  storage_overlaps_.assign(pool_entry.size(), {});
+  std::map<int, std::vector<uint32_t>> arena_sids;
+  for (const auto& pit : pool_entry) {
+    Device dev = find_device(pit);
+    if (in_arena(pit)) {
+      NDArray arena = arenas[pit.device_type];
+      arena_sids[pit.device_type].push_back(storage_pool_.size());
+      NDArray view = arena.CreateView({(pit.shape[0] + 3) / 4}, pit.dtype);
+      // The kernels expect no byte_offset, so the view points at its offset instead.
+      const_cast<DLTensor*>(view.operator->())->data =
+          static_cast<char*>(arena->data) + pit.offset;
+      storage_pool_.push_back(view);
+    } else if (pit.linked_param.defined()) {
       storage_pool_.push_back(pit.linked_param);
     } else {
       std::vector<int64_t> shape = pit.shape;
@@ -447,6 +765,21 @@ void GraphExecutor::SetupStorage() {
       storage_pool_.push_back(NDArray::Empty(shape, pit.dtype, dev, mem_scope));
     }
   }
+  // The storages of an arena whose byte ranges overlap, swept by their offsets.
+  for (auto& kv : arena_sids) {
+    std::vector<uint32_t>& sids = kv.second;
+    std::sort(sids.begin(), sids.end(), [&pool_entry](uint32_t lhs, uint32_t rhs) {
+      return pool_entry[lhs].offset < pool_entry[rhs].offset;
+    });
+    for (size_t i = 0; i < sids.size(); ++i) {
+      const PoolEntry& lhs = pool_entry[sids[i]];
+      for (size_t j = i + 1; j < sids.size(); ++j) {
+        if (pool_entry[sids[j]].offset >= lhs.offset + lhs.shape[0]) break;
+        storage_overlaps_[sids[i]].push_back(sids[j]);
+        storage_overlaps_[sids[j]].push_back(sids[i]);
+      }
+    }
+  }
 
   // Assign the pooled entries. A unified memory pool is used to simplifiy
   // memory assignment for each node entry. The allocated memory on each device
@@ -463,6 +796,66 @@ void GraphExecutor::SetupStorage() {
   }
 }
 
+void GraphExecutor::SetupParallelSchedule() {
+  // The users of a storage since it is last written, by the index of the operators.
+  struct StorageUse {
+    int32_t writer = -1;
+    std::vector<uint32_t> readers;
+  };
+  std::unordered_map<int, StorageUse> storage_uses;
+  std::vector<int32_t> sched_index(this->GetNumOfNodes(), -1);
+  sched_nodes_.clear();
+  sched_successors_.clear();
+  sched_num_deps_.clear();
+  for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
+    const auto& inode = nodes_[nid];
+    if (inode.op_type == "null") continue;
+    uint32_t op = sched_nodes_.size();
+    sched_index[nid] = op;
+    sched_nodes_.push_back(nid);
+    sched_successors_.emplace_back();
+    std::unordered_set<uint32_t> deps;
+    for (const auto& e : inode.inputs) {
+      if (sched_index[e.node_id] >= 0) {
+        deps.insert(sched_index[e.node_id]);
+      }
+      storage_uses[attrs_.storage_id[this->entry_id(e)]].readers.push_back(op);
+    }
+    // The outputs of a nop alias its inputs, which it does not write
+    if (inode.param.func_name != "__nop") {
+      for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+        // The storage reused by the outputs must be done with by its previous users, and so must
+        // the storages it overlaps in the arena
+        uint32_t sid = attrs_.storage_id[this->entry_id(nid, index)];
+        StorageUse& use = storage_uses[sid];
+        if (use.writer >= 0) {
+          deps.insert(use.writer);
+        }
+        deps.insert(use.readers.begin(), use.readers.end());
+        if (sid < storage_overlaps_.size()) {
+          for (uint32_t other : storage_overlaps_[sid]) {
+            auto it = storage_uses.find(other);
+            if (it == storage_uses.end()) continue;
+            if (it->second.writer >= 0) {
+              deps.insert(it->second.writer);
+            }
+            deps.insert(it->second.readers.begin(), it->second.readers.end());
+          }
+        }
+        use.writer = op;
+        use.readers.clear();
+      }
+    }
+    deps.erase(op);
+    for (uint32_t dep : deps) {
+      sched_successors_[dep].push_back(op);
+    }
+    sched_num_deps_.push_back(deps.size());
+  }
+  sched_pending_ = std::make_unique<std::atomic<int32_t>[]>(sched_nodes_.size());
+  sched_ready_ = std::make_unique<std::atomic<int32_t>[]>(sched_nodes_.size());
+}
+
 void GraphExecutor::SetupOpExecs() {
   op_execs_.resize(this->GetNumOfNodes());
   input_dltensors_.resize(num_node_entries());
@@ -629,6 +1022,22 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "set_parallel") {
+    // Run the independent operators in parallel, see RunParallel.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      bool parallel = args[0];
+      for (const Device& dev : devices_) {
+        CHECK(!parallel || dev.device_type == kDLCPU)
+            << "ValueError: Running the operators in parallel is only supported on CPU, but the "
+               "graph runs on "
+            << dev;
+      }
+      this->parallel_ = parallel;
+    });
+  } else if (name == "set_thread_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->thread_pool_ = args[0].operator std::string();
+    });
   } else if (name == "run_from_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -661,6 +1070,11 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       this->LoadParams(args[0].operator std::string());
     });
+  } else if (name == "load_params_from_file") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      bool use_mmap = args.num_args > 1 ? args[1].operator bool() : false;
+      this->LoadParamsFromFile(args[0].operator std::string(), use_mmap);
+    });
   } else if (name == "share_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       const auto& module = args[0].operator Module();
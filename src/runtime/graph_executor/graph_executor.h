@@ -31,6 +31,7 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -88,6 +89,17 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   const char* type_key() const final { return "GraphExecutor"; }
   void Run();
+  /*!
+   * \brief Run the operators as soon as their dependencies are done, with the independent ones
+   *  running at the same time on the threads of the work-stealing thread pool.
+   *
+   *  An operator depends on the producers of its inputs, and on the previous users of the storage
+   *  its outputs reuse, which the memory plan assumes to be done by then.
+   *
+   * \note The operators launching their own parallel tasks run them nested in the tasks of the
+   *  graph, so they must not use the parallel barrier.
+   */
+  void RunParallel();
 
   /*!
    * \brief Initialize the graph executor with graph and device.
@@ -184,12 +196,23 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param param_blob A binary blob of parameter.
    */
   void LoadParams(const std::string& param_blob);
+  /*!
+   * \brief Load parameters from a file, streaming each tensor into the storage of its input.
+   * \param file_name The file of the parameters, in the format of SaveParams.
+   * \param use_mmap Whether to map the file in memory, and copy the tensors from the mapping,
+   *  instead of reading it in chunks.
+   * \note No tensor is loaded whole on the host. The chunks read for a device are staged in two
+   *  host buffers, each uploaded on a stream of its own, so that the upload of a chunk overlaps
+   *  the read of the next one.
+   */
+  void LoadParamsFromFile(const std::string& file_name, bool use_mmap);
 
   /*!
    * \brief Share parameters from pre-existing GraphExecutor instance.
    * \param other A GraphExecutor instance, previously with |LoadParams| called with the
    * identical input |param_blob|.
    * \param strm The input stream.
+   * \note The storage planned for the shared parameters alone is freed.
    */
   void ShareParams(const GraphExecutor& other, dmlc::Stream* strm);
 
@@ -210,6 +233,8 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     int param_data_entry;
     NDArray linked_param;
     std::string scope;
+    /*! \brief The byte offset of the entry in the arena of its device, or -1. */
+    int64_t offset{-1};
     //    PoolEntry(int s, int dev_type, void* pre_linked_param) :
     //        size(s), device_type(dev_type), pre_linked_param(std::move(pre_linked_param)) {}
   };
@@ -306,6 +331,8 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     std::vector<int> device_index;
     std::vector<std::string> dltype;
     std::vector<std::string> storage_scope;
+    /*! \brief The byte offset of the storage of each entry in the arena of its device, or -1. */
+    std::vector<int64_t> storage_offset;
     std::vector<std::vector<int64_t>> shape;
     // The graph attribute fields.
     void Load(dmlc::JSONReader* reader) {
@@ -357,6 +384,14 @@ class TVM_DLL GraphExecutor : public ModuleNode {
           ICHECK(reader->NextArrayItem());
           reader->Read(&device_index);
           ICHECK(!reader->NextArrayItem());
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          ICHECK(!reader->NextArrayItem());
         } else {
           reader->BeginArray();
           ICHECK(reader->NextArrayItem());
@@ -415,6 +450,10 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   void SetupStorage();
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*! \brief Set up the dependencies of the operators for RunParallel. */
+  void SetupParallelSchedule();
+  /*! \brief Run the operators getting ready in RunParallel, on one of its threads. */
+  void RunReadyOps();
   /*!
    * \brief Check the legality of external DLTensor*.
    * \param external The external DLTensor*.
@@ -463,12 +502,36 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<Device> devices_;
   /*! \brief Common storage pool for all devices. */
   std::vector<NDArray> storage_pool_;
+  /*!
+   * \brief The other storages each storage overlaps in the arena of its device, which the parallel
+   *  schedule orders as if they were the same storage.
+   */
+  std::vector<std::vector<uint32_t>> storage_overlaps_;
   /*! \brief Data entry of each node. */
   std::vector<NDArray> data_entry_;
   /*! \brief Data alignment of each node. */
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()>> op_execs_;
+  /*! \brief The named thread pool to run the operators on, or empty for the default one. */
+  std::string thread_pool_;
+  /*!
+   * \brief Whether Run runs the independent operators in parallel, which only applies to the graphs
+   *  on CPU run on the default thread pool.
+   */
+  bool parallel_{false};
+  /*! \brief The operator nodes scheduled by RunParallel, in topological order. */
+  std::vector<uint32_t> sched_nodes_;
+  /*! \brief The indices in sched_nodes_ of the operators depending on each operator. */
+  std::vector<std::vector<uint32_t>> sched_successors_;
+  /*! \brief The number of the operators each operator depends on. */
+  std::vector<int32_t> sched_num_deps_;
+  /*! \brief The number of the dependencies of each operator not done yet in the current run. */
+  std::unique_ptr<std::atomic<int32_t>[]> sched_pending_;
+  /*! \brief The operators in the order they get ready in the current run, or -1 if not yet. */
+  std::unique_ptr<std::atomic<int32_t>[]> sched_ready_;
+  /*! \brief The number of the slots of sched_ready_ claimed and filled in the current run. */
+  std::atomic<uint32_t> sched_claimed_{0}, sched_filled_{0};
   /*! \brief Linked parameter lookup function. */
   PackedFunc lookup_linked_param_;
   /*! \brief Module's _lookup_linked_param function, used by DefaultLookupLinkedParam. */
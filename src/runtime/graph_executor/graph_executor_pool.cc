@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file graph_executor_pool.cc
+ * \brief A pool of graph executors sharing one copy of the params, each with its own activation
+ *  storage, leased to the serving threads one at a time.
+ */
+#include <dmlc/memory_io.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "./graph_executor.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief The executors of a graph on the same devices. The first one loads the params, which the
+ *  others share, so that the memory of an executor is only its activations.
+ *
+ *  A serving thread leases an executor for a request and returns it afterwards. Only the lease
+ *  and the return are serialized, the leased executors run concurrently.
+ */
+class GraphExecutorPool : public ModuleNode {
+ public:
+  GraphExecutorPool(const std::string& graph_json, const Module& lib,
+                    const std::vector<Device>& devices, int num_instances,
+                    const std::string& param_blob) {
+    CHECK_GT(num_instances, 0) << "ValueError: The pool needs at least one executor";
+    for (int i = 0; i < num_instances; ++i) {
+      auto exec = make_object<GraphExecutor>();
+      exec->Init(graph_json, lib, devices);
+      if (!param_blob.empty()) {
+        dmlc::MemoryStringStream strm(const_cast<std::string*>(&param_blob));
+        if (i == 0) {
+          exec->LoadParams(&strm);
+        } else {
+          exec->ShareParams(*static_cast<GraphExecutor*>(instances_[0].operator->()), &strm);
+        }
+      }
+      instances_.push_back(Module(exec));
+      free_.push_back(i);
+    }
+  }
+
+  const char* type_key() const final { return "GraphExecutorPool"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "lease") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int64_t timeout_ms = args.num_args > 0 ? args[0].operator int64_t() : -1;
+        Module exec = this->Lease(timeout_ms);
+        if (exec.defined()) {
+          *rv = exec;
+        }
+      });
+    } else if (name == "release") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->Release(args[0].operator Module());
+      });
+    } else if (name == "num_instances") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int64_t>(instances_.size());
+      });
+    } else if (name == "num_available") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        *rv = static_cast<int64_t>(free_.size());
+      });
+    }
+    return PackedFunc();
+  }
+
+  /*!
+   * \brief Lease an executor.
+   * \param timeout_ms The time to wait for an executor in milliseconds, or -1 to wait forever.
+   * \return The executor, or an undefined module if none is returned in time.
+   */
+  Module Lease(int64_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto available = [this] { return !free_.empty(); };
+    if (timeout_ms < 0) {
+      cv_.wait(lock, available);
+    } else if (!cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), available)) {
+      return Module();
+    }
+    int index = free_.back();
+    free_.pop_back();
+    return instances_[index];
+  }
+
+  /*! \brief Return a leased executor to the pool. */
+  void Release(const Module& exec) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      int index = -1;
+      for (int i = 0, n = instances_.size(); i < n; ++i) {
+        if (instances_[i].same_as(exec)) {
+          index = i;
+          break;
+        }
+      }
+      CHECK_GE(index, 0) << "ValueError: The executor does not belong to the pool";
+      CHECK(std::find(free_.begin(), free_.end(), index) == free_.end())
+          << "ValueError: The executor is returned twice";
+      free_.push_back(index);
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  /*! \brief The executors, the first of which owns the params. */
+  std::vector<Module> instances_;
+  /*! \brief The indices of the executors not leased. */
+  std::vector<int> free_;
+  /*! \brief Guards free_. */
+  std::mutex mutex_;
+  /*! \brief Notified when an executor is returned. */
+  std::condition_variable cv_;
+};
+
+/*!
+ * \brief args[0] is the graph json, args[1] the kernel library, args[2] the number of executors,
+ *  args[3] the serialized params, and the rest the device types and ids, as for
+ *  tvm.graph_executor.create.
+ */
+TVM_REGISTER_GLOBAL("tvm.graph_executor.create_pool").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.num_args, 6) << "The expected number of arguments for graph_executor.create_pool "
+                                 "is at least 6, but it has "
+                              << args.num_args;
+  std::string param_blob = args[3].type_code() == kTVMNullptr ? "" : args[3].operator std::string();
+  const auto& devices = GetAllDevice(args, 4);
+  *rv = Module(make_object<GraphExecutorPool>(args[0], args[1], devices, args[2], param_blob));
+});
+
+}  // namespace runtime
+}  // namespace tvm
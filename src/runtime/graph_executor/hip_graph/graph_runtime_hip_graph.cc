@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file graph_runtime_hip_graph.cc
+ */
+
+#include <tvm/runtime/registry.h>
+
+#include "../../rocm/rocm_common.h"
+#include "../graph_executor.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Graph executor with HIP Graph Support.
+ *
+ *  This is the extension of GraphExecutor class used for HIP graph launch
+ *  instead of HIP kernel launch on ROCm, the counterpart of
+ *  GraphExecutorHipGraph. The graph is constructed with the HIP stream
+ *  capture API, which captures the series of operations on a HIP stream.
+ */
+class GraphExecutorHipGraph : public GraphExecutor {
+ public:
+  /*!
+   * \brief Begin HIP graph capture on stream, the stream enters capture mode.
+   */
+  void StartCapture() {
+    const Device& dev = data_entry_[entry_id(0, 0)]->device;
+
+    TVMStreamCreate(dev.device_type, dev.device_id, &capture_stream_);
+    TVMSetStream(dev.device_type, dev.device_id, capture_stream_);
+
+    ROCM_CALL(hipStreamBeginCapture(static_cast<hipStream_t>(capture_stream_),
+                                     hipStreamCaptureModeGlobal));
+  }
+
+  /*!
+   * \brief Launch the instantiated graph on stream
+   */
+  void RunHipGraph() {
+    hipStream_t hip_stream = static_cast<hipStream_t>(capture_stream_);
+    ROCM_CALL(hipGraphLaunch(hip_graph_exec_, hip_stream));
+    ROCM_CALL(hipStreamSynchronize(hip_stream));
+  }
+
+  /*!
+   * \brief End HIP graph capture on stream, a graph will be created and
+   * instantiated.
+   */
+  void EndCapture() {
+    hipGraph_t graph;
+    ROCM_CALL(hipStreamEndCapture(static_cast<hipStream_t>(capture_stream_), &graph));
+
+    hipGraphNode_t* nodes = NULL;
+    size_t numNodes = 0;
+    ROCM_CALL(hipGraphGetNodes(graph, nodes, &numNodes));
+    LOG(INFO) << "Num of nodes in the hip graph created using stream capture API = " << numNodes;
+
+    ROCM_CALL(hipGraphInstantiate(&hip_graph_exec_, graph, NULL, NULL, 0));
+  }
+
+  /*!
+   * \brief GetFunction Get the function based on input.
+   * \param name The function which needs to be invoked.
+   * \param sptr_to_self Packed function pointer.
+   */
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self);
+
+ private:
+  /*! \brief The HIP stream on which to capture a HIP graph. */
+  TVMStreamHandle capture_stream_;
+  /*! \brief The captured HIP graph will be instantiated to this. */
+  hipGraphExec_t hip_graph_exec_;
+};
+
+PackedFunc GraphExecutorHipGraph::GetFunction(const std::string& name,
+                                               const ObjectPtr<Object>& sptr_to_self) {
+  // The functions are named as those of GraphExecutorCudaGraph, to share its Python interface.
+  if (name == "run_cuda_graph") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->RunHipGraph(); });
+  } else if (name == "start_capture") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->StartCapture(); });
+  } else if (name == "end_capture") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->EndCapture(); });
+  } else {
+    return GraphExecutor::GetFunction(name, sptr_to_self);
+  }
+}
+
+Module GraphExecutorHipGraphCreate(const std::string& sym_json, const tvm::runtime::Module& m,
+                                    const std::vector<Device>& devs,
+                                    PackedFunc lookup_linked_param_func) {
+  auto exec = make_object<GraphExecutorHipGraph>();
+  exec->Init(sym_json, m, devs, lookup_linked_param_func);
+  return Module(exec);
+}
+
+TVM_REGISTER_GLOBAL("tvm.graph_executor_hip_graph.create")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_GE(args.num_args, 4)
+          << "The expected number of arguments for graph_executor.create is "
+             "at least 4, but it has "
+          << args.num_args;
+      PackedFunc lookup_linked_param_func;
+      int dev_start_arg = 2;
+      if (args[2].type_code() == kTVMPackedFuncHandle) {
+        lookup_linked_param_func = args[2];
+        dev_start_arg++;
+      }
+
+      *rv = GraphExecutorHipGraphCreate(args[0], args[1], GetAllDevice(args, dev_start_arg),
+                                         lookup_linked_param_func);
+    });
+}  // namespace runtime
+}  // namespace tvm
@@ -287,6 +287,16 @@ TVM_REGISTER_GLOBAL("device_api.hexagon.free_nd").set_body([](TVMArgs args, TVMR
   *rv = static_cast<int32_t>(0);
 });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.parallel_launch")
+    .set_body_typed([](void* flambda, void* cdata, int num_task) {
+      auto lambda = reinterpret_cast<FTVMParallelLambda>(flambda);
+      HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
+      if (!api->HasThreadManager()) {
+        return HexagonThreadManager::RunSingleTask(lambda, cdata);
+      }
+      return api->ThreadManager()->ParallelLaunch(lambda, cdata, num_task);
+    });
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.acquire_resources")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
       HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
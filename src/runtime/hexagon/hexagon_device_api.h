@@ -167,6 +167,9 @@ class HexagonDeviceAPI final : public DeviceAPI {
     return runtime_threads.get();
   }
 
+  //! \brief Whether the thread manager has been created by AcquireResources.
+  bool HasThreadManager() const { return runtime_threads != nullptr; }
+
   HexagonUserDMA* UserDMA() {
     CHECK(runtime_dma) << "runtime_dma has not been created";
     return runtime_dma.get();
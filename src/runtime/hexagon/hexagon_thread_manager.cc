@@ -23,6 +23,12 @@ namespace tvm {
 namespace runtime {
 namespace hexagon {
 
+//! \brief Stride between the sync counters of the tasks, as `TVMBackendParallelBarrier` reads them.
+static constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
+
+//! \brief Whether the thread is running a task of a parallel loop.
+static thread_local bool in_parallel_task = false;
+
 HexagonThreadManager::HexagonThreadManager(unsigned num_threads, unsigned thread_stack_size_bytes,
                                            unsigned thread_pipe_size_words,
                                            const std::vector<HardwareResourceType> hw_resources) {
@@ -40,6 +46,12 @@ HexagonThreadManager::HexagonThreadManager(unsigned num_threads, unsigned thread
 
   hw_resources_ = hw_resources;
   CheckResources();
+  for (unsigned i = 0; i < hw_resources_.size(); i++) {
+    if ((hw_resources_[i] == HVX_0) || (hw_resources_[i] == HVX_1) ||
+        (hw_resources_[i] == HVX_2) || (hw_resources_[i] == HVX_3)) {
+      hvx_threads_.push_back(reinterpret_cast<TVMStreamHandle>(i));
+    }
+  }
 
   if (create_resource_managers_) {
     DLOG(INFO) << "Initialize hardware resource managers";
@@ -264,6 +276,68 @@ void HexagonThreadManager::WaitOnThreads() {
   }
 }
 
+int HexagonThreadManager::RunSingleTask(FTVMParallelLambda flambda, void* cdata) {
+  std::atomic<int> sync_counter{0};
+  TVMParallelGroupEnv env;
+  env.num_task = 1;
+  env.sync_handle = &sync_counter;
+  return (*flambda)(0, &env, cdata) == 0 ? 0 : -1;
+}
+
+int HexagonThreadManager::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  // The tasks of a nested launch would wait in the pipe of the thread running them
+  if (in_parallel_task || hvx_threads_.empty()) {
+    return RunSingleTask(flambda, cdata);
+  }
+  if (num_task == 0) {
+    num_task = hvx_threads_.size();
+  }
+  // The tasks meet at barriers, so all of them must run at once
+  CHECK_LE(num_task, static_cast<int>(hvx_threads_.size()))
+      << "Cannot launch " << num_task << " parallel tasks on " << hvx_threads_.size()
+      << " HVX threads";
+
+  // In case Start() was never explicitly called, call it now to prevent deadlock
+  if (qurt_sem_get_val(&start_semaphore_) == 0) {
+    Start();
+  }
+
+  std::unique_ptr<std::atomic<int>[]> sync_counter(new std::atomic<int>[num_task * kSyncStride]);
+  for (int i = 0; i < num_task; i++) {
+    sync_counter[i * kSyncStride].store(0, std::memory_order_relaxed);
+  }
+  TVMParallelGroupEnv env;
+  env.num_task = num_task;
+  env.sync_handle = sync_counter.get();
+  std::atomic<int> num_failed{0};
+  qurt_sem_t done;
+  qurt_sem_init_val(&done, 0);
+
+  std::vector<ParallelTask> tasks(num_task);
+  for (int i = 0; i < num_task; i++) {
+    tasks[i] = {flambda, cdata, i, &env, &num_failed, &done};
+    bool success = Dispatch(hvx_threads_[i], thread_parallel_task, &tasks[i]);
+    while (!success) {
+      success = Dispatch(hvx_threads_[i], thread_parallel_task, &tasks[i]);
+    }
+  }
+  for (int i = 0; i < num_task; i++) {
+    qurt_sem_down(&done);
+  }
+  qurt_sem_destroy(&done);
+  return num_failed.load() == 0 ? 0 : -1;
+}
+
+void HexagonThreadManager::thread_parallel_task(void* task) {
+  ParallelTask* pt = static_cast<ParallelTask*>(task);
+  in_parallel_task = true;
+  if ((*pt->flambda)(pt->task_id, pt->env, pt->cdata) != 0) {
+    pt->num_failed->fetch_add(1);
+  }
+  in_parallel_task = false;
+  qurt_sem_add(pt->done, 1);
+}
+
 void HexagonThreadManager::CheckSemaphore(unsigned syncID) {
   if (semaphores_.find(syncID) == semaphores_.end()) {
     semaphores_[syncID] = reinterpret_cast<qurt_sem_t*>(malloc(sizeof(qurt_sem_t)));
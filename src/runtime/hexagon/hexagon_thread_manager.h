@@ -20,10 +20,12 @@
 #ifndef TVM_RUNTIME_HEXAGON_HEXAGON_THREAD_MANAGER_H_
 #define TVM_RUNTIME_HEXAGON_HEXAGON_THREAD_MANAGER_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -144,6 +146,18 @@ class HexagonThreadManager {
   //! \brief Unblock threads to start execution if `Start` has not already been called; blocking
   //! call to wait until all threads have empty pipes.
   void WaitOnThreads();
+  /*!
+   * \brief Blocking run of the tasks of a parallel loop, one task per thread holding an HVX
+   * instance; the backend of `TVMBackendParallelLaunch` on Hexagon. A launch from within a task,
+   * or without HVX threads, runs the loop on the calling thread as a single task.
+   * \param flambda The body of the parallel loop.
+   * \param cdata The closure of the body.
+   * \param num_task The number of tasks, or 0 for one per HVX thread.
+   * \returns 0 if all the tasks succeeded, -1 otherwise.
+   */
+  int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task);
+  //! \brief Run the body of a parallel loop on the calling thread as a single task.
+  static int RunSingleTask(FTVMParallelLambda flambda, void* cdata);
 
  private:
   struct ThreadContext {
@@ -184,6 +198,9 @@ class HexagonThreadManager {
   //! \brief Void function executed by a thread to exit at time of destruction.
   static void thread_exit(void* context);
 
+  //! \brief Void function executed by a thread to run a task of a parallel loop.
+  static void thread_parallel_task(void* task);
+
   //! \brief Void function executed by each thread as `main`.
   static void thread_main(void* context);
 
@@ -225,6 +242,21 @@ class HexagonThreadManager {
     Command(voidfunc f, void* args) : f(f), args(args) {}
   };
 
+  /*!
+   * \brief A task of a parallel loop; sent via pipe to the HVX threads by `ParallelLaunch`.
+   */
+  struct ParallelTask {
+    FTVMParallelLambda flambda;
+    void* cdata;
+    int task_id;
+    TVMParallelGroupEnv* env;
+    std::atomic<int>* num_failed;
+    qurt_sem_t* done;
+  };
+
+  //! \brief Stream handles of the threads holding an HVX instance.
+  std::vector<TVMStreamHandle> hvx_threads_;
+
   //! \brief List of hardware resources
   std::vector<HardwareResourceType> hw_resources_;
 
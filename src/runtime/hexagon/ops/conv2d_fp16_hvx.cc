@@ -20,12 +20,14 @@
 #include <HAP_compute_res.h>
 #include <hexagon_types.h>
 #include <hvx_hexagon_protos.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/device_api.h>
 
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
+#include <functional>
 
 #include "tvm/runtime/hexagon/ops/conv2d.h"
 
@@ -148,6 +150,31 @@ inline HVX_Vector computeOuputVector(HVX_Vector act_vec, HVX_Vector wgt_vec) {
 
 static int round_down(int v, int base) { return v - (v % base); }
 
+/**
+ * @brief Run the body for each index in [0, extent), split into contiguous
+ * chunks across the HVX threads by TVMBackendParallelLaunch
+ *
+ * @param extent Number of indices
+ * @param body Function of an index; the indices must be independent
+ */
+static void parallel_for(int extent, const std::function<void(int)>& body) {
+  struct Closure {
+    int extent;
+    const std::function<void(int)>* body;
+  } closure{extent, &body};
+  auto task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    auto* closure = static_cast<Closure*>(cdata);
+    int chunk = (closure->extent + penv->num_task - 1) / penv->num_task;
+    int end = std::min(closure->extent, (task_id + 1) * chunk);
+    for (int i = task_id * chunk; i < end; ++i) {
+      (*closure->body)(i);
+    }
+    return 0;
+  };
+  int ret = TVMBackendParallelLaunch(task, &closure, 0);
+  ICHECK_EQ(ret, 0) << "Parallel launch failed";
+}
+
 /**
  * @brief Compute the convolution of inputs from cr_act, and weights from
  * cr_filt to update the output to cr_out. The goal is to have an efficient
@@ -373,7 +400,8 @@ void conv_layer_fp16_hvx(DLTensor& cr_out, const DLTensor& cr_act,  // NOLINT(*)
     }
   };
 
-  for (int out_c = 0; out_c < cr_filt.shape[3]; ++out_c) {
+  // The output channel chunks are computed in parallel, each on its own HVX instance
+  parallel_for(cr_filt.shape[3], [&](int out_c) {
     for (int out_act_y = 0; out_act_y < out_height / 8; ++out_act_y) {
       int out_y = out_act_y;
       for (int out_act_x = 0; out_act_x < out_width / 4; ++out_act_x) {
@@ -396,7 +424,7 @@ void conv_layer_fp16_hvx(DLTensor& cr_out, const DLTensor& cr_act,  // NOLINT(*)
       }
       computePartialWidth(out_y, out_c, h);
     }
-  }
+  });
 }
 }  // namespace hexagon
 }  // namespace runtime
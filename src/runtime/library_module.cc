@@ -71,8 +71,23 @@ class ModuleInternal {
   static std::vector<Module>* GetImportsAddr(ModuleNode* node) { return &(node->imports_); }
 };
 
-PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
-  return PackedFunc([faddr, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+/*! \brief The packed function calling a TVMBackendPackedCFunc, which can be told apart. */
+class WrappedPackedCFuncObj : public PackedFuncObj {
+ public:
+  WrappedPackedCFuncObj(TVMBackendPackedCFunc faddr, ObjectPtr<Object> sptr_to_self)
+      : PackedFuncObj(Call), faddr_(faddr), sptr_to_self_(std::move(sptr_to_self)) {}
+
+  static TVMBackendPackedCFunc Get(const PackedFunc& func) {
+    // The call function of the base object identifies the wrapped functions.
+    FCallPacked* PackedFuncObj::*f_call_packed = &WrappedPackedCFuncObj::f_call_packed_;
+    const PackedFuncObj* obj = func.get();
+    if (obj == nullptr || obj->*f_call_packed != Call) return nullptr;
+    return static_cast<const WrappedPackedCFuncObj*>(obj)->faddr_;
+  }
+
+ private:
+  static void Call(const PackedFuncObj* obj, TVMArgs args, TVMRetValue* rv) {
+    TVMBackendPackedCFunc faddr = static_cast<const WrappedPackedCFuncObj*>(obj)->faddr_;
     TVMValue ret_value;
     int ret_type_code = kTVMNullptr;
     int ret = (*faddr)(const_cast<TVMValue*>(args.values), const_cast<int*>(args.type_codes),
@@ -81,7 +96,19 @@ PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>&
     if (ret_type_code != kTVMNullptr) {
       *rv = TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
     }
-  });
+  }
+
+  TVMBackendPackedCFunc faddr_;
+  /*! \brief Keep the module of the function alive. */
+  ObjectPtr<Object> sptr_to_self_;
+};
+
+PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
+  return PackedFunc(make_object<WrappedPackedCFuncObj>(faddr, sptr_to_self));
+}
+
+TVMBackendPackedCFunc GetWrappedPackedCFunc(const PackedFunc& func) {
+  return WrappedPackedCFuncObj::Get(func);
 }
 
 void InitContextFunctions(std::function<void*(const char*)> fgetsymbol) {
@@ -130,11 +157,17 @@ Module LoadModuleFromBinary(const std::string& type_key, dmlc::Stream* stream) {
  * \param root_module the output root module
  * \param dso_ctx_addr the output dso module
  */
+ModuleBlobContext* ModuleBlobContext::ThreadLocal() {
+  static thread_local ModuleBlobContext context;
+  return &context;
+}
+
 void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib,
                        PackedFuncWrapper packed_func_wrapper, runtime::Module* root_module,
                        runtime::ModuleNode** dso_ctx_addr = nullptr) {
   ICHECK(mblob != nullptr);
   uint64_t nbytes = 0;
+  static_assert(sizeof(nbytes) == kModuleBlobHeaderBytes);
   for (size_t i = 0; i < sizeof(nbytes); ++i) {
     uint64_t c = mblob[i];
     nbytes |= (c & 0xffUL) << (i * 8);
@@ -142,6 +175,15 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib,
   dmlc::MemoryFixedSizeStream fs(const_cast<char*>(mblob + sizeof(nbytes)),
                                  static_cast<size_t>(nbytes));
   dmlc::Stream* stream = &fs;
+  // The blob is mapped with the library, so the modules may view it in place.
+  struct BlobContextScope {
+    explicit BlobContextScope(ModuleBlobContext context)
+        : saved(std::move(*ModuleBlobContext::ThreadLocal())) {
+      *ModuleBlobContext::ThreadLocal() = std::move(context);
+    }
+    ~BlobContextScope() { *ModuleBlobContext::ThreadLocal() = std::move(saved); }
+    ModuleBlobContext saved;
+  } blob_context_scope(ModuleBlobContext{stream, mblob + sizeof(nbytes), ObjectRef(lib)});
   uint64_t size;
   ICHECK(stream->Read(&size));
   std::vector<Module> modules;
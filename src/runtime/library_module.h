@@ -44,6 +44,28 @@ namespace runtime {
  */
 Module LoadModuleFromBinary(const std::string& type_key, dmlc::Stream* stream);
 
+/*!
+ * \brief The module blob being loaded on the current thread. The modules loaded from its stream
+ *  may view the bytes of the blob in place, as they live as long as the owner.
+ */
+struct ModuleBlobContext {
+  /*! \brief The stream over the blob, nullptr when no blob is being loaded. */
+  dmlc::Stream* stream{nullptr};
+  /*! \brief The bytes at the start of the stream. */
+  const char* data{nullptr};
+  /*! \brief The object owning the bytes, e.g. the library the blob is embedded in. */
+  ObjectRef owner;
+
+  /*! \brief The context of the current thread. */
+  static ModuleBlobContext* ThreadLocal();
+};
+
+/*!
+ * \brief The number of bytes preceding the stream of the modules in a module blob, which hold the
+ *  size of the stream.
+ */
+constexpr size_t kModuleBlobHeaderBytes = sizeof(uint64_t);
+
 /*!
  * \brief Library is the common interface
  *  for storing data in the form of shared libaries.
@@ -72,6 +94,14 @@ class Library : public Object {
  */
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& mptr);
 
+/*!
+ * \brief Get the function address wrapped by WrapPackedFunc, for the callers invoking it
+ *  directly with the packed arguments they built.
+ * \param func The packed function.
+ * \return The function address, nullptr when func does not come from WrapPackedFunc.
+ */
+TVMBackendPackedCFunc GetWrappedPackedCFunc(const PackedFunc& func);
+
 /*!
  * \brief Utility to initialize conext function symbols during startup
  * \param fgetsymbol A symbol lookup function.
@@ -103,13 +103,20 @@ class AutoReleasePoolWrapper {
 
 /*!
  * \brief Structure for error handling in queues
+ *
+ * \note The kernels launched on a stream are encoded into one pending command buffer, which is
+ * only committed when the stream is synchronized or the host accesses the memory. The
+ * consecutive kernels share one serial compute encoder, so that they run in order.
  */
 class Stream {
  public:
   explicit Stream(id<MTLDevice> device) : error_happened_(false) {
     queue_ = [device newCommandQueue];
   }
-  ~Stream() { [queue_ release]; }
+  ~Stream() {
+    Flush();
+    [queue_ release];
+  }
   id<MTLCommandBuffer> GetCommandBuffer() {
     id<MTLCommandBuffer> cb = [queue_ commandBuffer];
     [cb addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
@@ -117,12 +124,57 @@ class Stream {
     }];
     return cb;
   }
+  /*! \brief Get the pending command buffer, ending its compute encoder to encode other commands. */
+  id<MTLCommandBuffer> GetPendingCommandBuffer() {
+    EndComputeEncoder();
+    if (pending_command_buffer_ == nil) {
+      pending_command_buffer_ = [GetCommandBuffer() retain];
+    }
+    return pending_command_buffer_;
+  }
+  /*! \brief Get the compute encoder of the pending command buffer to encode a kernel. */
+  id<MTLComputeCommandEncoder> GetPendingComputeEncoder() {
+    if (pending_compute_encoder_ == nil) {
+      pending_compute_encoder_ = [[GetPendingCommandBuffer() computeCommandEncoder] retain];
+    }
+    return pending_compute_encoder_;
+  }
+  /*! \brief Whether some commands are encoded but not committed. */
+  bool HasPendingCommands() const { return pending_command_buffer_ != nil; }
+  /*! \brief Commit the pending command buffer, if any, without waiting for it. */
+  void Flush() {
+    EndComputeEncoder();
+    if (pending_command_buffer_ != nil) {
+      [pending_command_buffer_ commit];
+      [pending_command_buffer_ release];
+      pending_command_buffer_ = nil;
+    }
+  }
+  /*! \brief Commit the pending commands and wait until all the commands of the queue complete. */
+  void Synchronize() {
+    // The command buffers of a queue complete in order, so the last one is waited for.
+    id<MTLCommandBuffer> cb = [GetPendingCommandBuffer() retain];
+    Flush();
+    [cb waitUntilCompleted];
+    [cb release];
+  }
   bool HasErrorHappened() { return error_happened_; }
 
  private:
   void SetErrorStatus() { error_happened_ = true; }
+  void EndComputeEncoder() {
+    if (pending_compute_encoder_ != nil) {
+      [pending_compute_encoder_ endEncoding];
+      [pending_compute_encoder_ release];
+      pending_compute_encoder_ = nil;
+    }
+  }
   // Queue
   id<MTLCommandQueue> queue_;
+  // The command buffer the commands are encoded into until it is committed
+  id<MTLCommandBuffer> pending_command_buffer_{nil};
+  // The compute encoder of the kernels of the pending command buffer
+  id<MTLComputeCommandEncoder> pending_compute_encoder_{nil};
   // Check if error happened in one previous run
   bool error_happened_;
 };
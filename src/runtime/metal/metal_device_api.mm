@@ -179,15 +179,10 @@ void* MetalWorkspace::AllocDataSpace(Device device, size_t nbytes, size_t alignm
   AUTORELEASEPOOL {
     this->Init();
     id<MTLDevice> dev = GetDevice(device);
-    // GPU memory only
-    MTLResourceOptions storage_mode = MTLResourceStorageModePrivate;
-    /*
-    #if TARGET_OS_IPHONE
-    storage_mode = MTLResourceStorageModeShared;
-    #else
-    storage_mode = MTLResourceStorageModeManaged;
-    #endif
-    */
+    // The memory of Apple silicon is unified, where the buffers are shared with the host to be
+    // copied and viewed without staging. Otherwise GPU memory only.
+    MTLResourceOptions storage_mode =
+        dev.hasUnifiedMemory ? MTLResourceStorageModeShared : MTLResourceStorageModePrivate;
     buf = [dev newBufferWithLength:nbytes options:storage_mode];
     ICHECK(buf != nil);
   };
@@ -196,6 +191,13 @@ void* MetalWorkspace::AllocDataSpace(Device device, size_t nbytes, size_t alignm
 
 void MetalWorkspace::FreeDataSpace(Device dev, void* ptr) {
   AUTORELEASEPOOL {
+    // The pending kernels of the thread may use the buffer, whose content must be kept until
+    // they complete.
+    std::vector<Stream*>& streams = MetalThreadEntry::ThreadLocal()->stream;
+    if (static_cast<size_t>(dev.device_id) < streams.size() && streams[dev.device_id] != nullptr &&
+        streams[dev.device_id]->HasPendingCommands()) {
+      streams[dev.device_id]->Synchronize();
+    }
     // MTLBuffer PurgeableState should be set to empty before manual
     // release in order to prevent memory leak
     [(id<MTLBuffer>)ptr setPurgeableState:MTLPurgeableStateEmpty];
@@ -221,35 +223,35 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "Error! Some problems on GPU happaned! Cannot copy data to current stream";
     }
-    id<MTLCommandBuffer> cb = s->GetCommandBuffer();
     int from_dev_type = static_cast<int>(dev_from.device_type);
     int to_dev_type = static_cast<int>(dev_to.device_type);
 
+    // The device to device copies are batched with the kernels. The host accesses wait for the
+    // pending commands, which may use the buffer.
     if (from_dev_type == kDLMetal && to_dev_type == kDLMetal) {
       ICHECK_EQ(dev_from.device_id, dev_to.device_id) << "Metal disallow cross device copy.";
-      id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
+      id<MTLBlitCommandEncoder> encoder = [s->GetPendingCommandBuffer() blitCommandEncoder];
       [encoder copyFromBuffer:(id<MTLBuffer>)(from)
                  sourceOffset:from_offset
                      toBuffer:(id<MTLBuffer>)(to)destinationOffset:to_offset
                          size:size];
       [encoder endEncoding];
-      [cb commit];
     } else if (from_dev_type == kDLMetal && to_dev_type == kDLCPU) {
       // copy to a local buffer before get into global buffer.
       id<MTLBuffer> from_buf = (id<MTLBuffer>)(from);
       if (from_buf.storageMode != MTLStorageModeShared) {
         id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_from, size);
-        id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
+        id<MTLBlitCommandEncoder> encoder = [s->GetPendingCommandBuffer() blitCommandEncoder];
         [encoder copyFromBuffer:from_buf
                    sourceOffset:from_offset
                        toBuffer:temp
               destinationOffset:0
                            size:size];
         [encoder endEncoding];
-        [cb commit];
-        [cb waitUntilCompleted];
+        s->Synchronize();
         memcpy(static_cast<char*>(to) + to_offset, static_cast<char*>([temp contents]), size);
       } else {
+        s->Synchronize();
         memcpy(static_cast<char*>(to) + to_offset,
                static_cast<char*>([from_buf contents]) + from_offset, size);
       }
@@ -258,16 +260,16 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
       if (to_buf.storageMode != MTLStorageModeShared) {
         id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_to, size);
         memcpy([temp contents], static_cast<const char*>(from) + from_offset, size);
-        id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
+        id<MTLBlitCommandEncoder> encoder = [s->GetPendingCommandBuffer() blitCommandEncoder];
         [encoder copyFromBuffer:temp
                    sourceOffset:0
                        toBuffer:to_buf
               destinationOffset:to_offset
                            size:size];
         [encoder endEncoding];
-        [cb commit];
-        [cb waitUntilCompleted];
+        s->Synchronize();
       } else {
+        s->Synchronize();
         memcpy(static_cast<char*>([to_buf contents]) + to_offset,
                static_cast<const char*>(from) + from_offset, size);
       }
@@ -296,10 +298,8 @@ void MetalWorkspace::FreeStream(Device dev, TVMStreamHandle stream) {
 void MetalWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   AUTORELEASEPOOL {
     Stream* s = CastStreamOrGetCurrent(stream, dev.device_id);
-    // commit an empty command buffer and wait until it completes.
-    id<MTLCommandBuffer> cb = s->GetCommandBuffer();
-    [cb commit];
-    [cb waitUntilCompleted];
+    // commit the pending commands, or an empty command buffer, and wait until it completes.
+    s->Synchronize();
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "Error! Some problems on GPU happaned!";
     }
@@ -353,6 +353,40 @@ TVM_REGISTER_GLOBAL("device_api.metal").set_body([](TVMArgs args, TVMRetValue* r
   *rv = static_cast<void*>(ptr);
 });
 
+// View an array in the shared storage of a unified memory device as a host array, which the host
+// reads and writes without copies. The host accesses are ordered with the kernels by syncing the
+// stream of the device.
+TVM_REGISTER_GLOBAL("metal.HostView").set_body_typed([](NDArray arr) {
+  CHECK_EQ(arr->device.device_type, kDLMetal)
+      << "ValueError: Expect an array on Metal, but gets one on " << arr->device;
+  CHECK(arr.IsContiguous()) << "ValueError: Only a contiguous array can be viewed on the host";
+  id<MTLBuffer> buf = (id<MTLBuffer>)(arr->data);
+  CHECK(buf.storageMode == MTLStorageModeShared)
+      << "ValueError: Only an array in the shared storage can be viewed on the host, which is "
+      << "allocated on a device of unified memory";
+  /*! \brief The host view of an array, which keeps the array alive. */
+  struct HostView {
+    NDArray owner;
+    std::vector<int64_t> shape;
+    DLManagedTensor tensor;
+  };
+  auto* view = new HostView{arr, std::vector<int64_t>(arr->shape, arr->shape + arr->ndim),
+                            DLManagedTensor()};
+  DLTensor& tensor = view->tensor.dl_tensor;
+  tensor.data = [buf contents];
+  tensor.device = Device{kDLCPU, 0};
+  tensor.ndim = arr->ndim;
+  tensor.dtype = arr->dtype;
+  tensor.shape = view->shape.data();
+  tensor.strides = nullptr;
+  tensor.byte_offset = arr->byte_offset;
+  view->tensor.manager_ctx = view;
+  view->tensor.deleter = [](DLManagedTensor* self) {
+    delete static_cast<HostView*>(self->manager_ctx);
+  };
+  return NDArray::FromDLPack(&view->tensor);
+});
+
 TVM_REGISTER_GLOBAL("metal.ResetGlobalState").set_body_typed([]() {
   MetalWorkspace::Global()->ReinitializeStreams();
 });
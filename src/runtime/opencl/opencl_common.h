@@ -58,9 +58,11 @@
 #include <CL/opencl.h>
 #endif
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -409,8 +411,19 @@ class OpenCLModuleNode : public ModuleNode {
   // install a new kernel to thread local entry
   cl_kernel InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThreadEntry* t,
                           const std::string& func_name, const KTRefEntry& e);
+  /*!
+   * \brief Build the programs of all the kernels for every device in the background.
+   * \param num_threads The number of threads building the programs in parallel.
+   */
+  void StartWarmUp(int num_threads);
 
  private:
+  // get the program of a kernel on a device, building it if needed
+  cl_program GetProgram(cl::OpenCLWorkspace* w, const std::string& func_name, int device_id);
+  // build the program of a kernel from source, through the program binary cache
+  cl_program BuildProgramFromSource(cl::OpenCLWorkspace* w, const std::string& func_name,
+                                    int device_id);
+
   // The workspace, need to keep reference to use it in destructor.
   // In case of static destruction order problem.
   cl::OpenCLWorkspace* workspace_;
@@ -420,8 +433,14 @@ class OpenCLModuleNode : public ModuleNode {
   std::string fmt_;
   // function information table.
   std::unordered_map<std::string, FunctionInfo> fmap_;
-  // Module local mutex
+  // Module local mutex, guarding kernels_
   std::mutex build_lock_;
+  // Mutex per kernel, guarding its programs, so that different kernels build in parallel.
+  std::unordered_map<std::string, std::unique_ptr<std::mutex>> program_locks_;
+  // The threads building the programs in the background.
+  std::vector<std::thread> warm_up_workers_;
+  // Whether the background threads are to stop.
+  std::atomic<bool> stop_warm_up_{false};
   // The OpenCL source.
   std::string source_;
   // Mapping from primitive name to cl program for each device.
@@ -25,6 +25,11 @@
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -34,6 +39,89 @@
 
 namespace tvm {
 namespace runtime {
+namespace cl {
+std::string GetPlatformInfo(cl_platform_id pid, cl_platform_info param_name);
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
+}  // namespace cl
+
+/*!
+ * \brief The on-device cache of the OpenCL program binaries, reused across process starts, in the
+ *  directory given by TVM_OPENCL_PROGRAM_CACHE_DIR.
+ *
+ *  An entry is addressed by the hash of its key, which is the kernel source along with the
+ *  platform, the device and the driver version, so that a driver update misses the cache. The
+ *  entry stores its key, which is compared on lookup against hash collisions.
+ */
+class OpenCLProgramCache {
+ public:
+  OpenCLProgramCache(cl::OpenCLWorkspace* w, int device_id, const std::string& source) {
+    const char* dir = std::getenv("TVM_OPENCL_PROGRAM_CACHE_DIR");
+    if (dir == nullptr || dir[0] == '\0') {
+      return;
+    }
+    cl_device_id dev = w->devices[device_id];
+    std::ostringstream key;
+    key << cl::GetPlatformInfo(w->platform_id, CL_PLATFORM_NAME) << "\n"
+        << cl::GetDeviceInfo(dev, CL_DEVICE_NAME) << "\n"
+        << cl::GetDeviceInfo(dev, CL_DEVICE_VERSION) << "\n"
+        << cl::GetDeviceInfo(dev, CL_DRIVER_VERSION) << "\n"
+        << source;
+    key_ = key.str();
+    std::ostringstream path;
+    path << dir << "/" << std::hex << std::hash<std::string>()(key_) << ".clbin";
+    path_ = path.str();
+  }
+
+  /*! \brief Whether the cache is enabled. */
+  bool enabled() const { return !path_.empty(); }
+
+  /*! \brief Load the binary of the program, or return false on a miss. */
+  bool Load(std::string* binary) const {
+    std::ifstream is(path_, std::ios::binary);
+    if (!is.good()) {
+      return false;
+    }
+    uint64_t key_size = 0;
+    is.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+    if (!is.good() || key_size != key_.size()) {
+      return false;
+    }
+    std::string entry_key(key_size, '\0');
+    is.read(&entry_key[0], key_size);
+    if (!is.good() || entry_key != key_) {
+      return false;
+    }
+    binary->assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    return !binary->empty();
+  }
+
+  /*! \brief Save the binary of the program, renamed into place so that it is never seen partial. */
+  void Save(const std::string& binary) const {
+    std::ostringstream tmp_path;
+    tmp_path << path_ << ".tmp." << std::this_thread::get_id();
+    {
+      std::ofstream os(tmp_path.str(), std::ios::binary);
+      if (!os.good()) {
+        LOG(WARNING) << "Cannot write the OpenCL program cache entry " << tmp_path.str();
+        return;
+      }
+      uint64_t key_size = key_.size();
+      os.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+      os.write(key_.data(), key_.size());
+      os.write(binary.data(), binary.size());
+    }
+    if (std::rename(tmp_path.str().c_str(), path_.c_str()) != 0) {
+      LOG(WARNING) << "Cannot write the OpenCL program cache entry " << path_;
+      std::remove(tmp_path.str().c_str());
+    }
+  }
+
+ private:
+  /*! \brief The key of the entry. */
+  std::string key_;
+  /*! \brief The path of the entry, or empty if the cache is disabled. */
+  std::string path_;
+};
 
 class OpenCLWrappedFunc {
  public:
@@ -109,6 +197,10 @@ class OpenCLWrappedFunc {
 };
 
 OpenCLModuleNode::~OpenCLModuleNode() {
+  stop_warm_up_ = true;
+  for (std::thread& worker : warm_up_workers_) {
+    worker.join();
+  }
   {
     // free the kernel ids in global table.
     std::lock_guard<std::mutex> lock(workspace_->mu);
@@ -211,28 +303,96 @@ void OpenCLModuleNode::Init() {
   // zero initialize cl_program pointers for each device kernel
   for (auto& kv : parsed_kernels_) {
     programs_.insert({kv.first, std::vector<cl_program>(workspace_->devices.size(), nullptr)});
+    program_locks_.emplace(kv.first, std::make_unique<std::mutex>());
   }
 }
 
-cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThreadEntry* t,
-                                          const std::string& func_name, const KTRefEntry& e) {
-  std::lock_guard<std::mutex> lock(build_lock_);
-  int device_id = t->device.device_id;
-  if (programs_[func_name][device_id] == nullptr) {
-    // create program
+void OpenCLModuleNode::StartWarmUp(int num_threads) {
+  // The tasks are the pairs of a kernel and a device, taken in turn by the threads.
+  auto tasks = std::make_shared<std::vector<std::pair<std::string, int>>>();
+  for (const auto& kv : parsed_kernels_) {
+    for (size_t device_id = 0; device_id < workspace_->devices.size(); ++device_id) {
+      tasks->emplace_back(kv.first, static_cast<int>(device_id));
+    }
+  }
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  for (int i = 0; i < num_threads; ++i) {
+    warm_up_workers_.emplace_back([this, tasks, next]() {
+      try {
+        for (size_t j = (*next)++; j < tasks->size() && !stop_warm_up_; j = (*next)++) {
+          GetProgram(workspace_, (*tasks)[j].first, (*tasks)[j].second);
+        }
+      } catch (const std::runtime_error& e) {
+        // The error is raised again by the call to the kernel.
+        LOG(WARNING) << "Failed to build the OpenCL programs in the background: " << e.what();
+      }
+    });
+  }
+}
+
+cl_program OpenCLModuleNode::BuildProgramFromSource(cl::OpenCLWorkspace* w,
+                                                    const std::string& func_name, int device_id) {
+  const std::string& source = parsed_kernels_.at(func_name);
+  cl_device_id dev = w->devices[device_id];
+  OpenCLProgramCache cache(w, device_id, source);
+  std::string binary;
+  if (cache.enabled() && cache.Load(&binary)) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(binary.data());
+    size_t len = binary.length();
+    cl_int binary_status, err;
+    cl_program program =
+        clCreateProgramWithBinary(w->context, 1, &dev, &len, &s, &binary_status, &err);
+    if (err == CL_SUCCESS && binary_status == CL_SUCCESS &&
+        clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr) == CL_SUCCESS) {
+      return program;
+    }
+    // The driver rejects the cached binary, which is rebuilt from source and replaced.
+    if (err == CL_SUCCESS) {
+      OPENCL_CALL(clReleaseProgram(program));
+    }
+  }
+  const char* s = source.c_str();
+  size_t len = source.length();
+  cl_int err;
+  cl_program program = clCreateProgramWithSource(w->context, 1, &s, &len, &err);
+  OPENCL_CHECK_ERROR(err);
+  err = clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr);
+  if (err != CL_SUCCESS) {
+    size_t len;
+    std::string log;
+    clGetProgramBuildInfo(program, dev, CL_PROGRAM_BUILD_LOG, 0, nullptr, &len);
+    log.resize(len);
+    clGetProgramBuildInfo(program, dev, CL_PROGRAM_BUILD_LOG, len, &log[0], nullptr);
+    LOG(FATAL) << "OpenCL build error for device=" << dev << "\n" << log;
+  }
+  if (cache.enabled()) {
+    size_t binary_size = 0;
+    OPENCL_CALL(clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binary_size),
+                                 &binary_size, nullptr));
+    if (binary_size != 0) {
+      binary.resize(binary_size);
+      unsigned char* data = reinterpret_cast<unsigned char*>(&binary[0]);
+      OPENCL_CALL(clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(data), &data, nullptr));
+      cache.Save(binary);
+    }
+  }
+  return program;
+}
+
+cl_program OpenCLModuleNode::GetProgram(cl::OpenCLWorkspace* w, const std::string& func_name,
+                                        int device_id) {
+  std::lock_guard<std::mutex> lock(*program_locks_.at(func_name));
+  cl_program& program = programs_.at(func_name)[device_id];
+  if (program == nullptr) {
     if (fmt_ == "cl") {
-      const char* s = parsed_kernels_[func_name].c_str();
-      size_t len = parsed_kernels_[func_name].length();
-      cl_int err;
-      programs_[func_name][device_id] = clCreateProgramWithSource(w->context, 1, &s, &len, &err);
-      OPENCL_CHECK_ERROR(err);
+      program = BuildProgramFromSource(w, func_name, device_id);
+      return program;
     } else if (fmt_ == "xclbin" || fmt_ == "awsxclbin" || fmt_ == "aocx") {
       const unsigned char* s = (const unsigned char*)data_.c_str();
       size_t len = data_.length();
       cl_int err;
       cl_device_id dev = w->devices[device_id];
-      programs_[func_name][device_id] =
-          clCreateProgramWithBinary(w->context, 1, &dev, &len, &s, nullptr, &err);
+      program = clCreateProgramWithBinary(w->context, 1, &dev, &len, &s, nullptr, &err);
       OPENCL_CHECK_ERROR(err);
     } else {
       LOG(FATAL) << "Unknown OpenCL format " << fmt_;
@@ -240,24 +400,30 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
     // build program
     cl_int err;
     cl_device_id dev = w->devices[device_id];
-    err = clBuildProgram(programs_[func_name][device_id], 1, &dev, nullptr, nullptr, nullptr);
+    err = clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr);
     if (err != CL_SUCCESS) {
       size_t len;
       std::string log;
-      clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, 0, nullptr,
-                            &len);
+      clGetProgramBuildInfo(program, dev, CL_PROGRAM_BUILD_LOG, 0, nullptr, &len);
       log.resize(len);
-      clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, len,
-                            &log[0], nullptr);
+      clGetProgramBuildInfo(program, dev, CL_PROGRAM_BUILD_LOG, len, &log[0], nullptr);
       LOG(FATAL) << "OpenCL build error for device=" << dev << "\n" << log;
     }
   }
+  return program;
+}
+
+cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThreadEntry* t,
+                                          const std::string& func_name, const KTRefEntry& e) {
+  int device_id = t->device.device_id;
+  cl_program program = GetProgram(w, func_name, device_id);
   // build kernel
   cl_int err;
-  cl_kernel kernel = clCreateKernel(programs_[func_name][device_id], func_name.c_str(), &err);
+  cl_kernel kernel = clCreateKernel(program, func_name.c_str(), &err);
   OPENCL_CHECK_ERROR(err);
   t->kernel_table[e.kernel_id].kernel = kernel;
   t->kernel_table[e.kernel_id].version = e.version;
+  std::lock_guard<std::mutex> lock(build_lock_);
   kernels_.push_back(kernel);
   return kernel;
 }
@@ -269,6 +435,21 @@ Module OpenCLModuleCreate(std::string data, std::string fmt,
   return Module(n);
 }
 
+/*!
+ * \brief Create a module loaded from a file or a binary, and start building its programs in the
+ *  background on TVM_OPENCL_WARMUP_THREADS threads, if it is set.
+ */
+static Module OpenCLModuleCreateWithWarmUp(std::string data, std::string fmt,
+                                           std::unordered_map<std::string, FunctionInfo> fmap) {
+  auto n = make_object<OpenCLModuleNode>(data, fmt, fmap, std::string());
+  n->Init();
+  const char* num_threads = std::getenv("TVM_OPENCL_WARMUP_THREADS");
+  if (num_threads != nullptr && std::atoi(num_threads) > 0) {
+    n->StartWarmUp(std::atoi(num_threads));
+  }
+  return Module(n);
+}
+
 // Load module from module.
 Module OpenCLModuleLoadFile(const std::string& file_name, const std::string& format) {
   std::string data;
@@ -277,7 +458,7 @@ Module OpenCLModuleLoadFile(const std::string& file_name, const std::string& for
   std::string meta_file = GetMetaFilePath(file_name);
   LoadBinaryFromFile(file_name, &data);
   LoadMetaDataFromFile(meta_file, &fmap);
-  return OpenCLModuleCreate(data, fmt, fmap, std::string());
+  return OpenCLModuleCreateWithWarmUp(data, fmt, fmap);
 }
 
 Module OpenCLModuleLoadBinary(void* strm) {
@@ -288,7 +469,7 @@ Module OpenCLModuleLoadBinary(void* strm) {
   stream->Read(&fmt);
   stream->Read(&fmap);
   stream->Read(&data);
-  return OpenCLModuleCreate(data, fmt, fmap, std::string());
+  return OpenCLModuleCreateWithWarmUp(data, fmt, fmap);
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_cl").set_body_typed(OpenCLModuleLoadFile);
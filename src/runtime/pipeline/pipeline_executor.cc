@@ -21,6 +21,10 @@
  * \file pipeline_executor.cc
  */
 #include "pipeline_executor.h"
+
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <functional>
 namespace tvm {
 namespace runtime {
 /*!
@@ -85,6 +89,9 @@ PackedFunc PipelineExecutor::GetFunction(const std::string& name,
   } else if (name == "get_execute_count") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetExecutionCount(); });
+  } else if (name == "get_pipeline_metrics") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetMetrics(); });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
     return PackedFunc();
@@ -148,58 +155,93 @@ void PipelineExecutor::Run() { pipeline_scheduler_.PipelineRun(runtimes_); }
  * \brief return A list of global output data.
  */
 Array<NDArray> PipelineExecutor::GetOutput(void) { return pipeline_scheduler_.PipelineGetOutput(); }
+/*!
+ * \brief Return the metrics of the pipeline in the JSON format.
+ */
+std::string PipelineExecutor::GetMetrics() { return pipeline_scheduler_.PipelineGetMetrics(); }
+/*!
+ * \brief Parse a device in the form of "device_type,device_id".
+ * \param dev The device string.
+ * \return The device type and the device id.
+ */
+static std::pair<int, int> ParseDevice(const std::string& dev) {
+  std::istringstream istr(dev);
+  std::string str;
+  int device_type = 1, device_id = 0;
+  if (getline(istr, str, ',')) {
+    device_type = stoi(str);
+  }
+  if (getline(istr, str, ',')) {
+    device_id = stoi(str);
+  }
+  return std::make_pair(device_type, device_id);
+}
 /*!
  * \brief Use the mod_config information to create a graph runtime list.
  * \param mod_config The config information that generates by the export library function call.
+ * \param replicas The copies of each graph runtime on the replica devices of mod_config.
  */
-std::vector<Module> PipelineExecutor::CreateGraphModules(const ModuleConfig& mod_config) {
+std::vector<Module> PipelineExecutor::CreateGraphModules(
+    const ModuleConfig& mod_config, std::vector<std::vector<Module>>* replicas) {
   const PackedFunc* graph_executor_create = Registry::Get("tvm.graph_executor.create");
+  const PackedFunc* relax_vm_stage = Registry::Get("tvm.pipeline_executor.relax_vm_stage");
   std::vector<Module> ret;
   ret.resize(mod_config.size());
+  replicas->resize(mod_config.size());
   for (auto config : mod_config) {
     // Load library.
     auto lib = Module::LoadFromFile(config.second.lib_name.c_str());
-
-    // Read json.
-    std::ifstream ifJson(config.second.json_name.c_str());
-    if (ifJson.fail()) {
-      LOG(FATAL) << "json file not found: " << config.second.json_name;
-    }
-    const std::string json((std::istreambuf_iterator<char>(ifJson)),
-                           std::istreambuf_iterator<char>());
-
-    // Create a graph executor.
-    std::istringstream istr(config.second.dev);
-    std::string str;
-    int device_type = 1, device_id = 0;
-    while (getline(istr, str, ';')) {
-      std::istringstream istr_dev(str);
-      std::string str_temp;
-      if (getline(istr_dev, str_temp)) {
-        device_type = stoi(str_temp);
+    std::function<Module(const std::string&)> create_module;
+    std::string json;
+    std::string params;
+    TVMByteArray params_arr;
+    if (!config.second.vm_func.empty()) {
+      // Create a relax VM running the function, with the CPU running the shape functions.
+      create_module = [&](const std::string& dev) {
+        std::pair<int, int> device = ParseDevice(dev);
+        Module vm = lib.GetFunction("vm_load_executable")();
+        auto vm_initialization = vm.GetFunction("vm_initialization");
+        int pooled = relax_vm::AllocatorType::kPooled;
+        if (device.first == kDLCPU) {
+          vm_initialization(device.first, device.second, pooled);
+        } else {
+          vm_initialization(device.first, device.second, pooled, static_cast<int>(kDLCPU), 0,
+                            pooled);
+        }
+        return (*relax_vm_stage)(vm, config.second.vm_func).operator Module();
+      };
+    } else {
+      // Read json.
+      std::ifstream ifJson(config.second.json_name.c_str());
+      if (ifJson.fail()) {
+        LOG(FATAL) << "json file not found: " << config.second.json_name;
       }
-      if (getline(istr_dev, str_temp)) {
-        device_id = stoi(str_temp);
+      json.assign(std::istreambuf_iterator<char>(ifJson), std::istreambuf_iterator<char>());
+
+      // Load parameters.
+      const char* params_file_name = config.second.params_name.c_str();
+      std::ifstream if_param(params_file_name);
+      if (if_param.fail()) {
+        LOG(FATAL) << "params file not found: " << params_file_name;
       }
-    }
-    Module graph_module = (*graph_executor_create)(json, lib, device_type, device_id);
+      params.assign(std::istreambuf_iterator<char>(if_param), std::istreambuf_iterator<char>());
+      params_arr.data = params.c_str();
+      params_arr.size = params.length();
 
-    // Load parameters.
-    TVMByteArray params_arr;
-    const char* params_file_name = config.second.params_name.c_str();
-    std::ifstream if_param(params_file_name);
-    if (if_param.fail()) {
-      LOG(FATAL) << "params file not found: " << params_file_name;
+      create_module = [&](const std::string& dev) {
+        std::pair<int, int> device = ParseDevice(dev);
+        Module graph_module = (*graph_executor_create)(json, lib, device.first, device.second);
+        auto load_params = graph_module.GetFunction("load_params");
+        load_params(params_arr);
+        return graph_module;
+      };
+    }
+    // Put a module created on the device into the vector, and the ones created on each replica
+    // device into the replicas.
+    ret[config.first] = create_module(config.second.dev);
+    for (const std::string& dev : config.second.replica_devs) {
+      (*replicas)[config.first].push_back(create_module(dev));
     }
-    const std::string params((std::istreambuf_iterator<char>(if_param)),
-                             std::istreambuf_iterator<char>());
-    params_arr.data = params.c_str();
-    params_arr.size = params.length();
-    auto load_params = graph_module.GetFunction("load_params");
-    load_params(params_arr);
-
-    // Put a graph executor module into the vector.
-    ret[config.first] = graph_module;
   }
   return ret;
 }
@@ -220,7 +262,7 @@ void PipelineExecutor::SetParam(std::string param_group_name, std::string param_
   int index = runtime->GetInputIndex(param_key_name);
   ICHECK(index >= 0) << "Parameter name " << param_key_name << " does not exist in module "
                      << module_index;
-  runtime->SetInput(index, data_in);
+  runtime->SetParam(index, data_in);
 }
 /*!
  * \brief Return the input index and module index for a given input name.
@@ -241,8 +283,10 @@ int PipelineExecutor::GetExecutionCount() { return runtimes_.back()->GetExecutio
  *  and config in JSON format.
  * \param modules The module list used for building the pipeline.
  * \param pipeline_json The configuration of modules dependencies.
+ * \param replicas The copies of each module on the other devices.
  */
-void PipelineExecutor::Init(const std::vector<Module>& modules, const std::string& pipeline_json) {
+void PipelineExecutor::Init(const std::vector<Module>& modules, const std::string& pipeline_json,
+                            const std::vector<std::vector<Module>>& replicas) {
   ICHECK(!modules.empty()) << "The graph executor module list is empty.";
   // Use JSONReader to load pipeline configuration.
   std::istringstream is(pipeline_json);
@@ -252,20 +296,25 @@ void PipelineExecutor::Init(const std::vector<Module>& modules, const std::strin
   num_outputs_ = pipeline_config_.GetGlobalOutputNum();
   // Initialize the pipeline function class used for pipeline thread pool management
   // and schedule etc. This function returns a list of runtime.
-  global_runtime_ =
-      pipeline_scheduler_.PipelineInit(modules, pipeline_config_, input_connection_config_);
+  global_runtime_ = pipeline_scheduler_.PipelineInit(modules, replicas, pipeline_config_,
+                                                     input_connection_config_, queue_capacity_);
   runtimes_ = global_runtime_->GetRuntimeList();
   return;
 }
 
-Module PipelineExecutorCreate(const Array<Module>& m, const std::string& pipeline_json) {
+Module PipelineExecutorCreate(const Array<Module>& m, const std::string& pipeline_json,
+                              const Array<Array<Module>>& replicas) {
   ICHECK(!m.empty()) << "The module list is empty.";
   auto exec = make_object<PipelineExecutor>();
   std::vector<Module> graph_modules;
   for (auto mod : m) {
     graph_modules.push_back(mod);
   }
-  exec->Init(graph_modules, pipeline_json);
+  std::vector<std::vector<Module>> graph_replicas;
+  for (auto mods : replicas) {
+    graph_replicas.emplace_back(mods.begin(), mods.end());
+  }
+  exec->Init(graph_modules, pipeline_json, graph_replicas);
   return Module(exec);
 }
 
@@ -275,13 +324,16 @@ Module PipelineExecutorLoad(const std::string& load_json, const std::string& pip
   dmlc::JSONReader reader(&is);
   ModuleConfig& mod_config = exec->LoadModuleConfig(&reader);
   ICHECK(!mod_config.empty()) << "The module config is empty.";
-  std::vector<Module> modules = exec->CreateGraphModules(mod_config);
-  exec->Init(modules, pipeline_json);
+  std::vector<std::vector<Module>> replicas;
+  std::vector<Module> modules = exec->CreateGraphModules(mod_config, &replicas);
+  exec->Init(modules, pipeline_json, replicas);
   return Module(exec);
 }
 
 TVM_REGISTER_GLOBAL("tvm.pipeline_executor.create").set_body([](TVMArgs args, TVMRetValue* rv) {
-  *rv = PipelineExecutorCreate(args[0], args[1]);
+  // The optional third argument lists the replicas of each module.
+  Array<Array<Module>> replicas = args.size() > 2 ? args[2] : Array<Array<Module>>();
+  *rv = PipelineExecutorCreate(args[0], args[1], replicas);
 });
 
 TVM_REGISTER_GLOBAL("tvm.pipeline_executor.load").set_body([](TVMArgs args, TVMRetValue* rv) {
@@ -56,13 +56,18 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
    * \brief Initialize the pipeline executor with module array and JSON text.
    * \param modules The module list used for building pipeline.
    * \param pipeline_json The configuration of modules dependencies.
+   * \param replicas The copies of each module on the other devices, which share the runs of the
+   *  module in the pipeline.
    */
-  void Init(const std::vector<Module>& modules, const std::string& pipeline_json);
+  void Init(const std::vector<Module>& modules, const std::string& pipeline_json,
+            const std::vector<std::vector<Module>>& replicas = {});
   /*!
    * \brief Use the information of mod_config to create a list of graph executor.
    * \param mod_config The configuration information generated by the library export function call.
+   * \param replicas The copies of each graph executor on the replica devices of mod_config.
    */
-  std::vector<Module> CreateGraphModules(const ModuleConfig& mod_config);
+  std::vector<Module> CreateGraphModules(const ModuleConfig& mod_config,
+                                         std::vector<std::vector<Module>>* replicas);
   /*!
    * \brief Give frontends an access to packed functions.
    * \param name The name of the function.
@@ -121,6 +126,11 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
    * \return A list of output data.
    */
   Array<NDArray> GetOutput();
+  /*!
+   * \brief Get the metrics of each backend runtime and the queue depths in the JSON format.
+   * \return The metrics.
+   */
+  std::string GetMetrics();
   /*!
    * \brief A pipeline params with a specific name correspond with the params of a specific
    *  backend module, this function return the module index for the params name.
@@ -146,6 +156,8 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
       std::string json_name;
       std::string params_name;
       std::string dev;
+      std::vector<std::string> replica_devs;
+      std::string vm_func;
       while (reader->NextObjectItem(&key)) {
         if (key == "mod_idx") {
           reader->Read(&mod_idx);
@@ -157,6 +169,10 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
           reader->Read(&params_name);
         } else if (key == "dev") {
           reader->Read(&dev);
+        } else if (key == "replica_devs") {
+          reader->Read(&replica_devs);
+        } else if (key == "vm_func") {
+          reader->Read(&vm_func);
         } else {
           LOG(FATAL) << "do not support key " << key;
         }
@@ -164,9 +180,14 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
       ICHECK(mod_idx >= 0) << "Invalid mod_idx value " << mod_idx;
       // Load the lib, json, and params information.
       ICHECK(!lib_name.empty()) << "lib_name is empty.";
-      ICHECK(!json_name.empty()) << "json_name is empty.";
-      ICHECK(!params_name.empty()) << "params_name is empty.";
+      // A relax VM executable carries its own graph and parameters.
+      if (vm_func.empty()) {
+        ICHECK(!json_name.empty()) << "json_name is empty.";
+        ICHECK(!params_name.empty()) << "params_name is empty.";
+      }
       mod_config_[mod_idx] = GraphModuleLoadInfo(lib_name, json_name, params_name, dev);
+      mod_config_[mod_idx].replica_devs = replica_devs;
+      mod_config_[mod_idx].vm_func = vm_func;
     }
     return mod_config_;
   }
@@ -184,6 +205,8 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
   ModuleConfig mod_config_;
   /*!\brief How many outputs are in this pipeline executor.*/
   size_t num_outputs_ = 0;
+  /*!\brief The capacity of the queues forwarding the data between the runtimes.*/
+  int queue_capacity_ = kDefaultQueueCapacity;
   /*!The list of backend runtime module.*/
   std::vector<std::shared_ptr<BackendRuntime>> runtimes_;
   std::shared_ptr<GlobalRuntime> global_runtime_;
@@ -198,6 +221,9 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
         reader->Read(&input_connection_config_);
       } else if (key == "param_connection") {
         reader->Read(&param_connection_config_);
+      } else if (key == "queue_capacity") {
+        reader->Read(&queue_capacity_);
+        ICHECK_GT(queue_capacity_, 0) << "Invalid queue_capacity value " << queue_capacity_;
       } else {
         LOG(FATAL) << "do not support key " << key;
       }
@@ -18,6 +18,8 @@
  */
 #include "pipeline_scheduler.h"
 
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -26,20 +28,27 @@ namespace runtime {
 /*!
  * \brief Initialize the pipeline.
  * \param modules The list of graph executor modules.
+ * \param replicas The copies of each graph executor module on the other devices.
  * \param pipeline_conf The dependency information of each graph executor module.
+ * \param input_connection_config The map of global input and subgraph input.
+ * \param queue_capacity The capacity of the forwarding queues.
  */
 std::shared_ptr<GlobalRuntime> PipelineScheduler::PipelineInit(
-    const std::vector<Module>& modules, const ConfigPipelineExecution& pipeline_config,
-    const InputConnectionConfig& input_connection_config) {
+    const std::vector<Module>& modules, const std::vector<std::vector<Module>>& replicas,
+    const ConfigPipelineExecution& pipeline_config,
+    const InputConnectionConfig& input_connection_config, int queue_capacity) {
   std::vector<std::shared_ptr<BackendRuntime>> runtimes;
   graph_modules_ = modules;
   // Creating a list of runtimes.
   for (size_t i = 0; i < graph_modules_.size(); i++) {
-    auto run_item = std::make_shared<BackendRuntime>(graph_modules_[i], i);
+    auto run_item = std::make_shared<BackendRuntime>(
+        graph_modules_[i], i, i < replicas.size() ? replicas[i] : std::vector<Module>());
+    run_item->SetQueueCapacity(queue_capacity);
     runtimes.push_back(run_item);
   }
   // Creating the global runtime to represent the pipeline executor.
   global_runtime_ = std::make_shared<GlobalRuntime>(GLOBAL_MODULE_INDEX);
+  global_runtime_->SetQueueCapacity(queue_capacity);
   // Initializing the data structures used by pipeline logic.
   global_runtime_->InitializePipeline(input_connection_config, runtimes);
   // Creating a list of NDArray in order to storage the outputs data.
@@ -70,8 +79,27 @@ void PipelineScheduler::PipelineRun(const std::vector<std::shared_ptr<BackendRun
  * \brief Get a list of output.
  */
 Array<NDArray> PipelineScheduler::PipelineGetOutput() {
-  bool ret = global_runtime_->GetOutput(&output_arrays_);
-  return ret ? output_arrays_ : Array<NDArray>{};
+  // The undefined outputs, of the relax VM stages, are filled in a copy of the list.
+  Array<NDArray> outputs = output_arrays_;
+  bool ret = global_runtime_->GetOutput(&outputs);
+  return ret ? outputs : Array<NDArray>{};
+}
+/*!
+ * \brief Get the metrics of the pipeline in the JSON format.
+ */
+std::string PipelineScheduler::PipelineGetMetrics() {
+  std::ostringstream os;
+  os << "{\"input_backpressure_us\": " << global_runtime_->GetBackpressureNanos() / 1000
+     << ", \"stages\": [";
+  std::vector<std::shared_ptr<BackendRuntime>> runtimes = global_runtime_->GetRuntimeList();
+  for (size_t i = 0; i < runtimes.size(); ++i) {
+    os << (i == 0 ? "" : ", ");
+    runtimes[i]->WriteMetrics(&os);
+  }
+  os << "], \"outputs\": ";
+  global_runtime_->WriteInputQueueMetrics(&os);
+  os << "}";
+  return os.str();
 }
 }  // namespace runtime
 }  // namespace tvm
@@ -39,11 +39,16 @@ class PipelineScheduler {
   /*!
    * \brief Initialize the pipeline.
    * \param modules The list of graph executor module.
+   * \param replicas The copies of each graph executor module on the other devices.
    * \param pipeline_config The dependency information of each graph executor module.
+   * \param input_connection_config The map of global input and subgraph input.
+   * \param queue_capacity The capacity of the forwarding queues.
    */
   std::shared_ptr<GlobalRuntime> PipelineInit(const std::vector<Module>& modules,
+                                              const std::vector<std::vector<Module>>& replicas,
                                               const ConfigPipelineExecution& pipeline_config,
-                                              const InputConnectionConfig& input_connection_config);
+                                              const InputConnectionConfig& input_connection_config,
+                                              int queue_capacity);
   /*!
    * \brief Running the pipeline logic.
    * \param runtimes A list of backend runtime modules.
@@ -53,6 +58,10 @@ class PipelineScheduler {
    * \brief Get a list of outputs.
    */
   Array<NDArray> PipelineGetOutput();
+  /*!
+   * \brief Get the metrics of the pipeline in the JSON format.
+   */
+  std::string PipelineGetMetrics();
 
  private:
   /*!\brief The list of graph executors.*/
@@ -26,10 +26,12 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -176,6 +178,15 @@ class DataNotify {
    */
   bool GetExitState(void) { return exit_state_.load(std::memory_order_acquire); }
 };
+/*!\brief The type key of the pipeline stage running a relax VM function.*/
+constexpr const char* kRelaxVMStageTypeKey = "PipelineRelaxVMStage";
+/*!
+ * \brief A tensor forwarded by reference, which its producer never writes into again, e.g. an
+ *  output of a relax VM function.
+ */
+struct SharedTensor {
+  NDArray array;
+};
 /*!\brief The container used to store the forwarding data of the pipeline.*/
 class QueueData {
  public:
@@ -187,19 +198,34 @@ class QueueData {
     SetAsDataOwner(false);
   }
   QueueData() { SetAsDataOwner(true); }
-  /*!\brief Doing a deep copy for the 'QueueData' structure.*/
+  /*!
+   * \brief Doing a deep copy for the 'QueueData' structure, or taking the reference of a shared
+   *  tensor when this container owns its data.
+   */
   QueueData& operator=(const QueueData& data) {
-    CreateCopyFrom(data.GetDLData());
+    if (data.shared_.defined() && IsDataOwner()) {
+      shared_ = data.shared_;
+    } else {
+      shared_ = NDArray();
+      CreateCopyFrom(data.GetDLData());
+    }
     return *this;
   }
   QueueData& operator=(const NDArray& from) {
+    shared_ = NDArray();
     CreateCopyFrom(const_cast<DLTensor*>(from.operator->()));
     return *this;
   }
   QueueData& operator=(const DLTensor* from) {
+    shared_ = NDArray();
     CreateCopyFrom(from);
     return *this;
   }
+  /*!\brief Taking the reference of a shared tensor without copying it.*/
+  QueueData& operator=(const SharedTensor& from) {
+    shared_ = from.array;
+    return *this;
+  }
   /*!\brief Create a deep copy of the 'DLTensor' data.*/
   DLTensor* CreateCopyFrom(const DLTensor* from) {
     if (!from) {
@@ -225,7 +251,11 @@ class QueueData {
     return data_;
   }
   /*!\brief Return a pointer to the 'DLTensor' data.*/
-  DLTensor* GetDLData() const { return data_; }
+  DLTensor* GetDLData() const {
+    return shared_.defined() ? const_cast<DLTensor*>(shared_.operator->()) : data_;
+  }
+  /*!\brief Return the shared tensor, or an undefined one if the data is copied.*/
+  const NDArray& GetSharedTensor() const { return shared_; }
   ~QueueData() {
     if (IsDataOwner() && data_) {
       TVMArrayFree(data_);
@@ -236,6 +266,8 @@ class QueueData {
  private:
   /*!\brief Pointer to the forwarding data.*/
   DLTensor* data_ = nullptr;
+  /*!\brief The shared tensor forwarded by reference.*/
+  NDArray shared_;
   /*!\brief Whether this container is the owner of the 'data_'.*/
   bool is_data_owner_ = false;
   /*!\brief Set the current container as the owner of the 'data_'.*/
@@ -670,6 +702,12 @@ struct ParamConnectionConfig {
 using ForwardQueue = SPSCLockFreeQueue<QueueData, ModuleInterfaceID>;
 using ForwardQueueMap =
     std::unordered_map<ModuleInterfaceID, std::shared_ptr<ForwardQueue>, ModuleIDHash>;
+/*!\brief The default max number of the elements in a forwarding queue.*/
+constexpr int kDefaultQueueCapacity = 1023;
+/*!\brief Converting a duration into nanoseconds.*/
+inline int64_t DurationNanos(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
 /*!\brief The basic class for runtime.*/
 class BasicRuntime {
   using ModuleInputPairList = std::vector<std::pair<std::shared_ptr<BasicRuntime>, int>>;
@@ -678,6 +716,29 @@ class BasicRuntime {
   explicit BasicRuntime(int runtime_idx) : runtime_idx_(runtime_idx) {}
   /*!\brief Return the index of the current module.*/
   int GetModuleIndex() { return runtime_idx_; }
+  /*!\brief Setting the capacity of the forwarding queues created by this runtime.*/
+  void SetQueueCapacity(int capacity) {
+    ICHECK_GT(capacity, 0) << "The queue capacity must be positive, but got " << capacity;
+    queue_capacity_ = capacity;
+  }
+  /*!\brief The time in nanoseconds this runtime was blocked on the full forwarding queues.*/
+  int64_t GetBackpressureNanos() const { return backpressure_ns_.load(std::memory_order_relaxed); }
+  /*!
+   * \brief Writing the depths of the input queues in the JSON format.
+   * \param os The stream to write into.
+   */
+  void WriteInputQueueMetrics(std::ostream* os) const {
+    *os << "[";
+    bool first = true;
+    for (const auto& queue_pair : input_queue_) {
+      const auto& queue = queue_pair.second;
+      *os << (first ? "" : ", ") << "{\"index\": " << queue_pair.first
+          << ", \"depth\": " << queue->Size() << ", \"max_depth\": " << queue->MaxSize()
+          << ", \"capacity\": " << queue->Capacity() << "}";
+      first = false;
+    }
+    *os << "]";
+  }
   /*!\brief Setting the data into this runtime via the input index.*/
   virtual void SetInput(const int index, DLTensor* data_in) {}
   /*!
@@ -722,6 +783,14 @@ class BasicRuntime {
   std::unordered_map<int, ForwardQueueMap> forward_queue_;
   /*!\brief The state of the pipeline.*/
   std::atomic<PipelineState> pipeline_state_{STOPPED};
+  /*!\brief The capacity of the forwarding queues created by this runtime.*/
+  int queue_capacity_ = kDefaultQueueCapacity;
+  /*!\brief The time in nanoseconds this runtime was blocked on the full forwarding queues.*/
+  std::atomic<int64_t> backpressure_ns_{0};
+  /*!\brief Setting the state of the pipeline.*/
+  void SetPipelineState(PipelineState state) {
+    pipeline_state_.store(state, std::memory_order_release);
+  }
   /*!
    * \brief Generate the ID of an input queue.
    * \param runtime_index The index of backend runtime.
@@ -736,11 +805,12 @@ class BasicRuntime {
    * \param forward_queue_map The map includes the id and the queue.
    * \param child_runtime The child runtime.
    * \param child_input_index The child runtime index.
-   * \param data The data is used for forwarding.
+   * \param data The data is used for forwarding, either a tensor to copy or a shared tensor.
    */
+  template <typename DataType>
   bool ForwardData(const ForwardQueueMap* forward_queue_map,
                    std::shared_ptr<BasicRuntime> child_runtime, int child_input_index,
-                   const DLTensor* data) {
+                   const DataType& data) {
     auto child_runtime_index = child_runtime->GetModuleIndex();
     auto queue_id = GenerateQueueID(child_runtime_index, child_input_index, INPUT);
     if (forward_queue_map->find(queue_id) == forward_queue_map->end()) {
@@ -749,14 +819,19 @@ class BasicRuntime {
                  << runtime_idx_;
     }
     auto forward_queue = forward_queue_map->at(queue_id);
-    // If the queue is full, keep try until the push get success or the pipeline run into
-    // a STOP state.
-    while (!forward_queue->Push<const DLTensor*>(data)) {
-      if (PipelineIsStop()) {
-        LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
-                  << " into stop.";
-        return false;
+    // If the queue is full, block until the child runtime polls a data from the queue or the
+    // pipeline run into a STOP state.
+    if (!forward_queue->Push<DataType>(data)) {
+      auto start = std::chrono::steady_clock::now();
+      while (!forward_queue->Push<DataType>(data)) {
+        if (PipelineIsStop()) {
+          LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
+                    << " into stop.";
+          return false;
+        }
+        forward_queue->WaitNotFull(std::chrono::milliseconds(1));
       }
+      backpressure_ns_ += DurationNanos(std::chrono::steady_clock::now() - start);
     }
     child_runtime->ParentNotify(child_input_index);
     return true;
@@ -778,7 +853,7 @@ class BasicRuntime {
                  << " is already created!";
       return;
     }
-    auto queue = std::make_shared<ForwardQueue>(queue_id);
+    auto queue = std::make_shared<ForwardQueue>(queue_id, queue_capacity_);
     queue_map[queue_id] = queue;
     // Use the created queue as the consumer queue for the input interface of this forwarding
     // pair.
@@ -803,14 +878,61 @@ class BasicRuntime {
  */
 class BackendRuntime : public BasicRuntime {
  private:
+  /*!
+   * \brief A copy of the graph executor module running on a device of its own. The runs of a
+   *  runtime with several replicas are dispatched to the replicas in turn, each running them
+   *  on a thread of its own.
+   */
+  struct Replica {
+    /*!\brief The graph executor module.*/
+    Module module;
+    /*!\brief The packed functions.*/
+    tvm::runtime::PackedFunc set_input;
+    tvm::runtime::PackedFunc get_input;
+    tvm::runtime::PackedFunc get_output;
+    tvm::runtime::PackedFunc run;
+    /*!\brief The thread running the dispatched runs.*/
+    std::thread thread;
+    /*!\brief The mutex and the condition variable guarding the states below.*/
+    std::mutex mutex;
+    std::condition_variable cv;
+    /*!\brief Whether a run is dispatched to the replica and not forwarded yet.*/
+    bool busy = false;
+    /*!\brief Whether the thread should exit or not.*/
+    bool exit = false;
+    /*!\brief The sequence number of the dispatched run.*/
+    uint64_t seq = 0;
+  };
   /*!The cpu affinity settings for this runtime.*/
   std::string cpu_affinity_ = "";
   /*!\brief The Runtime module of a backend graph executor.*/
   Module module_;
+  /*!
+   * \brief Whether the module runs a relax VM function, whose outputs are forwarded by reference
+   *  and whose inputs are set by reference, without copying them into preallocated tensors.
+   */
+  bool shares_tensors_ = false;
   /*\brief The thread is associated with the current runtime*/
   std::thread thread_;
   /*!\brief The execution count of the 'RunPipeline' function. */
-  uint32_t pipeline_execution_count_ = 0;
+  std::atomic<uint32_t> pipeline_execution_count_{0};
+  /*!\brief The replicas of the module, including the module itself as the first one.*/
+  std::vector<std::unique_ptr<Replica>> replicas_;
+  /*!\brief The replica which the next run is dispatched to.*/
+  size_t next_replica_ = 0;
+  /*!\brief The sequence number of the next dispatched run.*/
+  uint64_t dispatch_seq_ = 0;
+  /*!\brief The sequence number of the next run to forward the outputs of.*/
+  uint64_t forward_seq_ = 0;
+  /*!\brief The mutex and the condition variable keeping the forwarding in the dispatch order.*/
+  std::mutex forward_mutex_;
+  std::condition_variable forward_cv_;
+  /*!\brief The time in nanoseconds spent in running the module.*/
+  std::atomic<int64_t> busy_ns_{0};
+  /*!\brief The time in nanoseconds spent in waiting for the input data.*/
+  std::atomic<int64_t> wait_input_ns_{0};
+  /*!\brief The time of the first run, or the epoch when there is no run yet.*/
+  std::atomic<std::chrono::steady_clock::time_point> first_run_time_{};
   /*!
    *\brief In order to transfer data from one backend runtime to another, we need a local
    * tensor variable as a medium. "input_tensor_local_copy_" is a map including
@@ -834,7 +956,12 @@ class BackendRuntime : public BasicRuntime {
       // Only launching the worker thread for the runtimes after the first runtime.
       thread_ = std::thread([&]() {
         this->SetCPUAffinity();
-        while (!this->WaitAndLoadPipelineData()) {
+        while (true) {
+          auto start = std::chrono::steady_clock::now();
+          if (this->WaitAndLoadPipelineData()) {
+            break;
+          }
+          wait_input_ns_ += DurationNanos(std::chrono::steady_clock::now() - start);
           if (!this->RunPipeline()) {
             break;
           }
@@ -842,23 +969,92 @@ class BackendRuntime : public BasicRuntime {
         VLOG(1) << "Runtime " << this->runtime_idx_ << " exit.";
       });
     }
+    if (replicas_.size() > 1) {
+      for (auto& replica : replicas_) {
+        Replica* replica_ptr = replica.get();
+        replica->thread = std::thread([this, replica_ptr]() { this->ReplicaLoop(replica_ptr); });
+      }
+    }
     return;
   }
-  /*!\brief Setting the state of the pipeline.*/
-  void SetPipelineState(PipelineState state) {
-    pipeline_state_.store(state, std::memory_order_release);
-  }
   /*!\brief Stopping the threads in pipeline.*/
   void StopPipeline() {
     SetPipelineState(STOPPING);
     for (auto notify : parents_notify_) {
       notify.second->ExitNotify();
     }
+    { std::lock_guard<std::mutex> lock(forward_mutex_); }
+    forward_cv_.notify_all();
     if (thread_.joinable()) {
       thread_.join();
     }
+    for (auto& replica : replicas_) {
+      {
+        std::lock_guard<std::mutex> lock(replica->mutex);
+        replica->exit = true;
+      }
+      replica->cv.notify_all();
+      if (replica->thread.joinable()) {
+        replica->thread.join();
+      }
+    }
     SetPipelineState(STOPPED);
   }
+  /*!\brief Waiting for the replica which the next run is dispatched to to become idle.*/
+  Replica* WaitIdleReplica() {
+    Replica* replica = replicas_[next_replica_].get();
+    std::unique_lock<std::mutex> lock(replica->mutex);
+    replica->cv.wait(lock, [replica] { return !replica->busy; });
+    return replica;
+  }
+  /*!\brief Dispatching a run to the next replica, whose inputs are already set.*/
+  void DispatchToReplica() {
+    Replica* replica = WaitIdleReplica();
+    {
+      std::lock_guard<std::mutex> lock(replica->mutex);
+      replica->busy = true;
+      replica->seq = dispatch_seq_++;
+    }
+    replica->cv.notify_all();
+    next_replica_ = (next_replica_ + 1) % replicas_.size();
+  }
+  /*!
+   * \brief The loop of the thread of a replica, which runs the dispatched runs and forwards their
+   *  outputs in the dispatch order.
+   */
+  void ReplicaLoop(Replica* replica) {
+    this->SetCPUAffinity();
+    while (true) {
+      uint64_t seq;
+      {
+        std::unique_lock<std::mutex> lock(replica->mutex);
+        replica->cv.wait(lock, [replica] { return replica->busy || replica->exit; });
+        if (!replica->busy) {
+          break;
+        }
+        seq = replica->seq;
+      }
+      auto start = std::chrono::steady_clock::now();
+      replica->run();
+      busy_ns_ += DurationNanos(std::chrono::steady_clock::now() - start);
+      {
+        std::unique_lock<std::mutex> lock(forward_mutex_);
+        forward_cv_.wait(lock, [&] { return forward_seq_ == seq || PipelineIsStop(); });
+        if (forward_seq_ == seq) {
+          if (ForwardingOutputDataToChildren(replica->get_output)) {
+            pipeline_execution_count_++;
+          }
+          forward_seq_++;
+        }
+      }
+      forward_cv_.notify_all();
+      {
+        std::lock_guard<std::mutex> lock(replica->mutex);
+        replica->busy = false;
+      }
+      replica->cv.notify_all();
+    }
+  }
   /*!
    * \brief Waiting for the internal forwarding data.
    * \return Returning 'true' when getting a 'exit' notification otherwise returning 'false'.
@@ -900,7 +1096,11 @@ class BackendRuntime : public BasicRuntime {
     if (!queue->Poll<QueueData>(&data)) {
       return false;
     }
-    SetInput(input_index, data.GetDLData());
+    if (shares_tensors_ && data.GetSharedTensor().defined()) {
+      SetSharedInput(input_index, data.GetSharedTensor());
+    } else {
+      SetInput(input_index, data.GetDLData());
+    }
     return true;
   }
   /*!
@@ -908,21 +1108,29 @@ class BackendRuntime : public BasicRuntime {
    * \return bool Return false when the "PipelineIsStop" function returns true or this function
    *  reaches some errors. Otherwise, return true.
    */
-  bool ForwardingOutputDataToChildren(void) {
+  bool ForwardingOutputDataToChildren(const PackedFunc& get_output) {
     for (auto child : children_) {
       auto output_idx = child.first;
       if (forward_queue_.find(output_idx) == forward_queue_.end()) {
         LOG(FATAL) << "Not find the forwarding queue map for output(" << output_idx << ")!";
         return false;
       }
-      NDArray output = GetOutput(output_idx);
+      NDArray output = get_output(output_idx);
       auto forward_queue_map = forward_queue_[output_idx];
       // Notifying the 'children runtime' that the forwarding data are ready.
       for (auto module_pair : child.second) {
         auto child_runtime = module_pair.first;
         auto child_input_index = module_pair.second;
-        auto output_data = const_cast<DLTensor*>(output.operator->());
-        if (!ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data)) {
+        bool forwarded;
+        if (shares_tensors_) {
+          forwarded = ForwardData(&forward_queue_map, child_runtime, child_input_index,
+                                  SharedTensor{output});
+        } else {
+          auto output_data = const_cast<const DLTensor*>(output.operator->());
+          forwarded =
+              ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data);
+        }
+        if (!forwarded) {
           return false;
         }
       }
@@ -985,7 +1193,15 @@ class BackendRuntime : public BasicRuntime {
   }
 
  public:
-  BackendRuntime(Module mod, int mod_idx) : BasicRuntime(mod_idx), module_(mod) {
+  /*!
+   * \brief Constructing the runtime.
+   * \param mod The graph executor module.
+   * \param mod_idx The index of the runtime.
+   * \param replicas The copies of the module on the other devices, which share the runs of the
+   *  runtime with the module.
+   */
+  BackendRuntime(Module mod, int mod_idx, const std::vector<Module>& replicas = {})
+      : BasicRuntime(mod_idx), module_(mod) {
     get_input_index_ = module_.GetFunction("get_input_index");
     get_num_output_ = module_.GetFunction("get_num_outputs");
     get_num_inputs_ = module_.GetFunction("get_num_inputs");
@@ -993,6 +1209,18 @@ class BackendRuntime : public BasicRuntime {
     get_input_ = module_.GetFunction("get_input");
     get_output_ = module_.GetFunction("get_output");
     run_ = module_.GetFunction("run");
+    shares_tensors_ = std::string(module_->type_key()) == kRelaxVMStageTypeKey;
+    std::vector<Module> copies{module_};
+    copies.insert(copies.end(), replicas.begin(), replicas.end());
+    for (Module& copy : copies) {
+      auto replica = std::make_unique<Replica>();
+      replica->module = copy;
+      replica->set_input = copy.GetFunction("set_input");
+      replica->get_input = copy.GetFunction("get_input");
+      replica->get_output = copy.GetFunction("get_output");
+      replica->run = copy.GetFunction("run");
+      replicas_.push_back(std::move(replica));
+    }
   }
   ~BackendRuntime() {
     for (auto data : input_tensor_local_copy_) {
@@ -1005,6 +1233,25 @@ class BackendRuntime : public BasicRuntime {
    * \return The times of using pipeline function.
    */
   int GetExecutionCount() const { return pipeline_execution_count_; }
+  /*!
+   * \brief Writing the metrics of this runtime in the JSON format.
+   * \param os The stream to write into.
+   */
+  void WriteMetrics(std::ostream* os) const {
+    uint32_t executions = pipeline_execution_count_;
+    double throughput = 0;
+    auto first_run_time = first_run_time_.load();
+    if (executions > 0 && first_run_time != std::chrono::steady_clock::time_point()) {
+      double elapsed = DurationNanos(std::chrono::steady_clock::now() - first_run_time) * 1e-9;
+      throughput = elapsed > 0 ? executions / elapsed : 0;
+    }
+    *os << "{\"index\": " << runtime_idx_ << ", \"replicas\": " << replicas_.size()
+        << ", \"executions\": " << executions << ", \"throughput\": " << throughput
+        << ", \"busy_us\": " << busy_ns_ / 1000 << ", \"wait_input_us\": " << wait_input_ns_ / 1000
+        << ", \"backpressure_us\": " << GetBackpressureNanos() / 1000 << ", \"inputs\": ";
+    WriteInputQueueMetrics(os);
+    *os << "}";
+  }
   /*!
    * \brief Initializing data structures for the pipeline execution.
    * \param config The pipeline configueration.
@@ -1062,8 +1309,14 @@ class BackendRuntime : public BasicRuntime {
     }
     notify->second->Notify();
   }
-  /*!\brief Creating a NDArray containing same shape and data type with a module output. */
+  /*!
+   * \brief Creating a NDArray containing same shape and data type with a module output, or an
+   *  undefined one if the outputs are only known after a run.
+   */
   NDArray CreateFromOutput(int idx) {
+    if (shares_tensors_) {
+      return NDArray();
+    }
     NDArray data = get_output_(idx);
     return CreateNDArrayFromDLTensor(const_cast<DLTensor*>(data.operator->()));
   }
@@ -1073,9 +1326,29 @@ class BackendRuntime : public BasicRuntime {
   int NumInputs() const { return get_num_inputs_(); }
   /*!\brief Setting the data to this runtime via input index.*/
   void SetInput(const int index, DLTensor* data_in) {
-    NDArray input = get_input_(index);
-    DLTensor* dltensor_input = const_cast<DLTensor*>(input.operator->());
-    CopyFromTo(data_in, dltensor_input);
+    // The inputs of a replicated runtime go to the replica which the next run is dispatched to.
+    Replica* replica = replicas_.size() > 1 ? WaitIdleReplica() : replicas_[0].get();
+    SetReplicaInput(replica, index, data_in);
+  }
+  /*!\brief Setting a shared tensor to this runtime via input index, without copying it.*/
+  void SetSharedInput(const int index, const NDArray& data_in) {
+    Replica* replica = replicas_.size() > 1 ? WaitIdleReplica() : replicas_[0].get();
+    replica->set_input(index, data_in);
+  }
+  /*!\brief Setting a parameter to all the replicas via the input index.*/
+  void SetParam(const int index, DLTensor* data_in) {
+    for (auto& replica : replicas_) {
+      SetReplicaInput(replica.get(), index, data_in);
+    }
+  }
+  /*!\brief Copying the data into an input of a replica.*/
+  void SetReplicaInput(Replica* replica, const int index, DLTensor* data_in) {
+    if (shares_tensors_) {
+      replica->set_input(index, data_in);
+      return;
+    }
+    NDArray input = replica->get_input(index);
+    CopyFromTo(data_in, const_cast<DLTensor*>(input.operator->()));
   }
   /*!\brief Setting the data to the current runtime moduel via the input name. */
   void SetInput(const std::string name, DLTensor* data_in) {
@@ -1095,8 +1368,17 @@ class BackendRuntime : public BasicRuntime {
    * \return Returning false if the forwarding function failed. Otherwise, returning true.;
    */
   bool RunPipeline() {
+    if (first_run_time_.load() == std::chrono::steady_clock::time_point()) {
+      first_run_time_.store(std::chrono::steady_clock::now());
+    }
+    if (replicas_.size() > 1) {
+      DispatchToReplica();
+      return !PipelineIsStop();
+    }
+    auto start = std::chrono::steady_clock::now();
     Run();
-    bool ret = ForwardingOutputDataToChildren();
+    busy_ns_ += DurationNanos(std::chrono::steady_clock::now() - start);
+    bool ret = ForwardingOutputDataToChildren(get_output_);
     pipeline_execution_count_++;
     return ret;
   }
@@ -1156,18 +1438,38 @@ class GlobalRuntime : public BasicRuntime {
     for (auto queue_pair : input_queue_) {
       auto output_index = queue_pair.first;
       auto queue = queue_pair.second;
-      QueueData data(const_cast<DLTensor*>(((*outputs)[output_index]).operator->()));
+      NDArray output = (*outputs)[output_index];
+      if (!output.defined()) {
+        // The output of a relax VM stage is handed over by reference.
+        QueueData data;
+        if (!queue->Poll<QueueData>(&data)) {
+          LOG(FATAL) << "There is no data in the data queue, it should not happen!";
+        }
+        const NDArray& shared = data.GetSharedTensor();
+        outputs->Set(output_index, shared.defined() ? shared : CopyToNDArray(data.GetDLData()));
+        continue;
+      }
+      QueueData data(const_cast<DLTensor*>(output.operator->()));
       if (!queue->Poll<QueueData>(&data)) {
         LOG(FATAL) << "There is no data in the data queue, it should not happen!";
       }
     }
     return true;
   }
+  /*!\brief Copying a tensor into a new NDArray.*/
+  static NDArray CopyToNDArray(const DLTensor* from) {
+    std::vector<int64_t> shape(from->shape, from->shape + from->ndim);
+    NDArray ret = NDArray::Empty(ShapeTuple(shape), from->dtype, from->device);
+    ret.CopyFrom(from);
+    return ret;
+  }
   /*!\brief Initialized the data structures for pipeline.*/
   void InitializePipeline(InputConnectionConfig input_config,
                           const std::vector<std::shared_ptr<BackendRuntime>> runtimes) {
     input_config_ = input_config;
     runtimes_ = runtimes;
+    // Running, so that the pipeline inputs block on the full forwarding queues.
+    SetPipelineState(RUNNING);
     for (auto child_runtime : runtimes) {
       int runtime_idx = child_runtime->GetModuleIndex();
       input_config.VisitConfig(
@@ -1207,6 +1509,10 @@ struct GraphModuleLoadInfo {
   std::string json_name;
   std::string params_name;
   std::string dev;
+  /*!\brief The devices of the copies of the module sharing its runs.*/
+  std::vector<std::string> replica_devs;
+  /*!\brief The function to run if the library is a relax VM executable, otherwise empty.*/
+  std::string vm_func;
 };
 /*! The Module information of each module.The 'int' is module index. */
 using ModuleConfig = std::unordered_map<int, GraphModuleLoadInfo>;
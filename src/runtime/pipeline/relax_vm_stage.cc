@@ -0,0 +1,235 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relax_vm_stage.cc
+ * \brief A pipeline stage running a function of a relax VM.
+ */
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <string>
+#include <vector>
+
+#include "pipeline_struct.h"
+namespace tvm {
+namespace runtime {
+/*!
+ * \brief A pipeline stage running a function of a relax VM, behind the interface of the graph
+ *  executor which the backend runtimes of the pipeline use.
+ *
+ *  The outputs of a run are the tensors newly returned by the function, so the pipeline hands
+ *  them over to the next stages by reference. An input tensor on the device of the VM is used as
+ *  it is. An input tensor on another device is copied onto the device of the VM on a stream of
+ *  its own, which the run then waits for on the device, so that the copy does not block the
+ *  thread of the stage.
+ */
+class RelaxVMStage : public ModuleNode {
+ public:
+  /*!
+   * \brief Constructing the stage.
+   * \param vm The initialized relax VM.
+   * \param func_name The name of the function to run.
+   */
+  RelaxVMStage(Module vm, std::string func_name) : vm_(vm), func_name_(func_name) {
+    CHECK_EQ(std::string(vm->type_key()), "relax.VirtualMachine")
+        << "ValueError: Expect a relax VM, but got " << vm->type_key();
+    auto* vm_ptr = static_cast<relax_vm::VirtualMachine*>(vm.operator->());
+    ICHECK(!vm_ptr->devices.empty()) << "The VirtualMachine is not initialized.";
+    device_ = vm_ptr->devices[0];
+    set_input_zero_copy_ = vm_->GetFunction("set_input_zero_copy", false);
+    invoke_stateful_ = vm_->GetFunction("invoke_stateful", false);
+    get_output_arity_ = vm_->GetFunction("get_output_arity", false);
+    get_output_ = vm_->GetFunction("get_output", false);
+    PackedFunc get_function_arity = vm_->GetFunction("get_function_arity", false);
+    PackedFunc get_function_param_name = vm_->GetFunction("get_function_param_name", false);
+    int arity = get_function_arity(func_name_);
+    for (int i = 0; i < arity; ++i) {
+      param_names_.push_back(get_function_param_name(func_name_, i));
+    }
+    inputs_.resize(arity);
+    if (device_.device_type != kDLCPU) {
+      copy_stream_ = DeviceAPI::Get(device_)->CreateStream(device_);
+    }
+  }
+  ~RelaxVMStage() {
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->FreeStream(device_, copy_stream_);
+    }
+  }
+
+  const char* type_key() const final { return kRelaxVMStageTypeKey; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "get_num_inputs") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int>(param_names_.size());
+      });
+    } else if (name == "get_input_index") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->GetInputIndex(args[0].operator String());
+      });
+    } else if (name == "get_input") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = inputs_.at(this->InputIndexOf(args[0]));
+      });
+    } else if (name == "set_input") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->SetInput(this->InputIndexOf(args[0]), args[1]);
+      });
+    } else if (name == "run") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+    } else if (name == "get_num_outputs") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        CHECK(ran_) << "ValueError: The outputs of " << func_name_ << " are known after a run";
+        *rv = static_cast<int>(outputs_.size());
+      });
+    } else if (name == "get_output") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int index = args[0];
+        CHECK(index >= 0 && index < static_cast<int>(outputs_.size()))
+            << "ValueError: Invalid output index " << index << " of " << func_name_;
+        *rv = outputs_[index];
+      });
+    }
+    return PackedFunc();
+  }
+
+ private:
+  /*!\brief Return the index of an input name, or -1 if the function has no such input.*/
+  int GetInputIndex(const std::string& name) const {
+    for (size_t i = 0; i < param_names_.size(); ++i) {
+      if (param_names_[i] == name) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  /*!\brief Return the index of an input given by either its name or its index.*/
+  int InputIndexOf(const TVMArgValue& arg) const {
+    if (String::CanConvertFrom(arg)) {
+      std::string name = arg.operator String();
+      int index = GetInputIndex(name);
+      CHECK_GE(index, 0) << "ValueError: Unknown input " << name << " of " << func_name_;
+      return index;
+    }
+    int index = arg;
+    CHECK(index >= 0 && index < static_cast<int>(inputs_.size()))
+        << "ValueError: Invalid input index " << index << " of " << func_name_;
+    return index;
+  }
+  /*!\brief Return whether a tensor lives on the device of the VM.*/
+  bool OnDevice(const DLTensor* tensor) const {
+    return tensor->device.device_type == device_.device_type &&
+           tensor->device.device_id == device_.device_id;
+  }
+  /*!\brief Setting an input, either by reference or by copying it onto the device of the VM.*/
+  void SetInput(int index, const TVMArgValue& arg) {
+    if (arg.type_code() == kTVMNDArrayHandle) {
+      NDArray input = arg;
+      if (OnDevice(input.operator->())) {
+        inputs_[index] = input;
+        return;
+      }
+      // The input is kept alive until the run, which waits for the copy, is done.
+      NDArray buffer = NDArray::Empty(input.Shape(), input.DataType(), device_);
+      NDArray::CopyFromTo(input.operator->(), const_cast<DLTensor*>(buffer.operator->()),
+                          copy_stream_);
+      copy_sources_.push_back(input);
+      inputs_[index] = buffer;
+      return;
+    }
+    // The producer of a bare tensor may write into it again once this returns, so the copy is
+    // done before returning.
+    DLTensor* input = arg;
+    std::vector<int64_t> shape(input->shape, input->shape + input->ndim);
+    NDArray buffer = NDArray::Empty(ShapeTuple(shape), input->dtype, device_);
+    NDArray::CopyFromTo(input, const_cast<DLTensor*>(buffer.operator->()), nullptr);
+    DeviceAPI::Get(device_)->StreamSync(device_, nullptr);
+    if (input->device.device_type != kDLCPU && !OnDevice(input)) {
+      DeviceAPI::Get(input->device)->StreamSync(input->device, nullptr);
+    }
+    inputs_[index] = buffer;
+  }
+  /*!\brief Running the function on the inputs.*/
+  void Run() {
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+      CHECK(inputs_[i].defined()) << "ValueError: The input " << param_names_[i] << " of "
+                                  << func_name_ << " is not set";
+    }
+    DeviceAPI* device_api = DeviceAPI::Get(device_);
+    if (!copy_sources_.empty() && copy_stream_ != nullptr) {
+      device_api->SyncStreamFromTo(device_, copy_stream_, nullptr);
+    }
+    std::vector<TVMValue> values(inputs_.size() + 1);
+    std::vector<int> tcodes(inputs_.size() + 1);
+    TVMArgsSetter setter(values.data(), tcodes.data());
+    setter(0, func_name_);
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+      setter(i + 1, inputs_[i]);
+    }
+    TVMRetValue rv;
+    set_input_zero_copy_.CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &rv);
+    invoke_stateful_(func_name_);
+    outputs_.clear();
+    int arity = get_output_arity_(func_name_);
+    if (arity < 0) {
+      outputs_.push_back(get_output_(func_name_));
+    } else {
+      for (int i = 0; i < arity; ++i) {
+        outputs_.push_back(get_output_(func_name_, i));
+      }
+    }
+    // The outputs are ready for the stages on the other devices once the device is synchronized,
+    // and the sources of the copies are no longer read.
+    device_api->StreamSync(device_, nullptr);
+    copy_sources_.clear();
+    ran_ = true;
+  }
+
+  /*!\brief The relax VM.*/
+  Module vm_;
+  /*!\brief The name of the function.*/
+  std::string func_name_;
+  /*!\brief The device of the VM.*/
+  Device device_;
+  /*!\brief The functions of the VM.*/
+  PackedFunc set_input_zero_copy_, invoke_stateful_, get_output_arity_, get_output_;
+  /*!\brief The names of the inputs of the function.*/
+  std::vector<std::string> param_names_;
+  /*!\brief The inputs of the next run.*/
+  std::vector<NDArray> inputs_;
+  /*!\brief The tensors on the other devices being copied into the inputs.*/
+  std::vector<NDArray> copy_sources_;
+  /*!\brief The stream copying the inputs from the other devices, or null on CPU.*/
+  TVMStreamHandle copy_stream_ = nullptr;
+  /*!\brief The outputs of the last run.*/
+  std::vector<NDArray> outputs_;
+  /*!\brief Whether the function has run.*/
+  bool ran_ = false;
+};
+
+TVM_REGISTER_GLOBAL("tvm.pipeline_executor.relax_vm_stage")
+    .set_body_typed([](Module vm, String func_name) {
+      return Module(make_object<RelaxVMStage>(vm, func_name));
+    });
+}  // namespace runtime
+}  // namespace tvm
@@ -18,28 +18,44 @@
  */
 #ifndef TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
 #define TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <memory>
+#include <mutex>
 #include <thread>
 /*!\brief A single producer and single consumer lock free queue.
  */
 template <typename SlotType, typename IDType = int, int QueueLength = 1024>
 class SPSCLockFreeQueue {
  public:
-  explicit SPSCLockFreeQueue(IDType id) : id_(id) {}
-  /*A read barrier enforcing the CPU to performe the reads before this barrier.*/
-  inline void read_barrier() { std::atomic_thread_fence(std::memory_order_acquire); }
-  /*A write barrier enforcing the CPU to performe the writes before this barrier.*/
-  inline void write_barrier() { std::atomic_thread_fence(std::memory_order_release); }
+  /*!
+   * \brief Constructing the queue.
+   * \param id The ID of the queue.
+   * \param capacity The max number of the elements in the queue.
+   */
+  explicit SPSCLockFreeQueue(IDType id, size_t capacity = QueueLength - 1)
+      : len_(capacity + 1), queue_(new SlotType[capacity + 1]), id_(id) {}
   /*!\brief Checking whether the queue is full.*/
-  bool Full() {
-    read_barrier();
-    return ((tail_ + 1) % len_) == head_;
+  bool Full() const {
+    return ((tail_.load(std::memory_order_acquire) + 1) % len_) ==
+           head_.load(std::memory_order_acquire);
   }
   /*!brief Checking whether the queue is empty.*/
-  bool Empty() {
-    read_barrier();
-    return head_ == tail_;
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+  /*!\brief The number of the elements in the queue.*/
+  size_t Size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return (tail + len_ - head) % len_;
   }
+  /*!\brief The max number of the elements ever in the queue at the same time.*/
+  size_t MaxSize() const { return max_size_.load(std::memory_order_relaxed); }
+  /*!\brief The max number of the elements the queue holds.*/
+  size_t Capacity() const { return len_ - 1; }
   /*!
    * \brief Pushing the data into the queue. Only a single producer will call this function.
    * \param data The data which is pushed into the queue.
@@ -48,9 +64,13 @@ class SPSCLockFreeQueue {
   template <typename data_type>
   bool Push(const data_type& data) {
     if (Full()) return false;
-    queue_[tail_] = data;
-    write_barrier();
-    tail_ = (tail_ + 1) % len_;
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    queue_[tail] = data;
+    tail_.store((tail + 1) % len_, std::memory_order_release);
+    size_t size = Size();
+    if (size > max_size_.load(std::memory_order_relaxed)) {
+      max_size_.store(size, std::memory_order_relaxed);
+    }
     return true;
   }
   /*!
@@ -62,22 +82,48 @@ class SPSCLockFreeQueue {
   template <typename data_type>
   bool Poll(data_type* data) {
     if (Empty()) return false;
-    *data = queue_[head_];
-    write_barrier();
-    head_ = (head_ + 1) % len_;
+    size_t head = head_.load(std::memory_order_relaxed);
+    *data = queue_[head];
+    // The sequentially consistent store pairs with the one of 'producer_waiting_', so that either
+    // the consumer sees the waiting producer or the producer sees the freed slot.
+    head_.store((head + 1) % len_, std::memory_order_seq_cst);
+    if (producer_waiting_.load(std::memory_order_seq_cst)) {
+      { std::lock_guard<std::mutex> lock(mutex_); }
+      not_full_.notify_one();
+    }
     return true;
   }
+  /*!
+   * \brief Blocking the producer until the queue is not full.
+   * \param timeout The max time to wait.
+   * \return Return false when the queue is still full after the timeout. Otherwise, return true.
+   */
+  template <typename Rep, typename Period>
+  bool WaitNotFull(const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    producer_waiting_.store(true, std::memory_order_seq_cst);
+    bool not_full = not_full_.wait_for(lock, timeout, [this]() { return !Full(); });
+    producer_waiting_.store(false, std::memory_order_relaxed);
+    return not_full;
+  }
 
  private:
   /*!\brief The pointer points to the first slot with valid data in the queue.*/
-  size_t head_ = 0;
+  std::atomic<size_t> head_{0};
   /*!\brief The end of the queue at which elements are added.*/
-  size_t tail_ = 0;
+  std::atomic<size_t> tail_{0};
+  /*!\brief The max number of the elements ever in the queue at the same time.*/
+  std::atomic<size_t> max_size_{0};
   /*!\brief The length of the queue.*/
-  size_t len_ = QueueLength;
+  size_t len_;
   /*!\brief The queue used to store the data.*/
-  SlotType queue_[QueueLength];
+  std::unique_ptr<SlotType[]> queue_;
   /*!\brief The ID of the queue.*/
   IDType id_;
+  /*!\brief Whether the producer is blocked on a full queue.*/
+  std::atomic<bool> producer_waiting_{false};
+  /*!\brief The mutex and the condition variable used to wake up the blocked producer.*/
+  std::mutex mutex_;
+  std::condition_variable not_full_;
 };
 #endif  // TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
@@ -32,8 +32,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <numeric>
 #include <thread>
@@ -656,6 +658,101 @@ std::string DeviceString(Device dev) {
   return DeviceName(dev.device_type) + std::to_string(dev.device_id);
 }
 
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::BucketOf(uint64_t nanos) {
+  if (nanos < 4) {
+    return static_cast<int>(nanos);
+  }
+  // The power of two, then the quarter of it the duration falls into.
+  int exp = 63;
+  while ((nanos >> exp) == 0) {
+    --exp;
+  }
+  int quarter = static_cast<int>((nanos >> (exp - 2)) & 3);
+  return (exp - 1) * 4 + quarter;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int bucket) {
+  if (bucket < 4) {
+    return bucket;
+  }
+  int exp = bucket / 4 + 1;
+  uint64_t quarter = bucket % 4;
+  if (exp == 63 && quarter == 3) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return ((5 + quarter) << (exp - 2)) - 1;
+}
+
+void LatencyHistogram::Record(int64_t nanos) {
+  uint64_t value = nanos > 0 ? nanos : 0;
+  buckets_[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  int64_t max = max_.load(std::memory_order_relaxed);
+  while (max < nanos && !max_.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+double LatencyHistogram::MeanNanos() const {
+  int64_t count = Count();
+  return count == 0 ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / count;
+}
+
+int64_t LatencyHistogram::PercentileNanos(double quantile) const {
+  // Read the buckets once, since the concurrent records may change them and the count.
+  uint64_t counts[kNumBuckets];
+  uint64_t total = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = std::max<uint64_t>(1, std::ceil(quantile * total));
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min<uint64_t>(BucketUpperBound(i), MaxNanos());
+    }
+  }
+  return MaxNanos();
+}
+
+Timer DeferredTimers::Start(Device dev) {
+  auto it = factories_.find(dev.device_type);
+  if (it == factories_.end()) {
+    it = factories_
+             .emplace(dev.device_type,
+                      Registry::Get(std::string("profiling.timer.") + DeviceName(dev.device_type)))
+             .first;
+  }
+  if (it->second == nullptr) {
+    // Without a timer of its own the device is synchronized, as by `Timer::Start`.
+    return Timer::Start(dev);
+  }
+  Timer timer = (*it->second)(dev);
+  timer->Start();
+  return timer;
+}
+
+void DeferredTimers::Flush() {
+  for (auto& kv : pending_) {
+    kv.second->Record(kv.first->SyncAndGetElapsedNanos());
+  }
+  pending_.clear();
+}
+
 Report Profiler::Report() {
   // sync all timers and normalize rows
   std::vector<std::unordered_map<String, ObjectRef>> rows;
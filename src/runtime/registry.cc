@@ -27,8 +27,10 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include "runtime_base.h"
@@ -37,17 +39,27 @@ namespace tvm {
 namespace runtime {
 
 struct Registry::Manager {
-  // map storing the functions.
-  // We deliberately used raw pointer.
-  // This is because PackedFunc can contain callbacks into the host language (Python) and the
-  // resource can become invalid because of indeterministic order of destruction and forking.
-  // The resources will only be recycled during program exit.
-  std::unordered_map<std::string, Registry*> fmap;
-  // mutex
-  std::mutex mutex;
+  // The functions are split in shards by the hash of their names, each with a reader-writer
+  // lock, so that the lookups of running models on several threads do not wait for each other.
+  struct Shard {
+    // map storing the functions.
+    // We deliberately used raw pointer.
+    // This is because PackedFunc can contain callbacks into the host language (Python) and the
+    // resource can become invalid because of indeterministic order of destruction and forking.
+    // The resources will only be recycled during program exit.
+    std::unordered_map<std::string, Registry*> fmap;
+    // mutex
+    std::shared_mutex mutex;
+  };
+  static constexpr size_t kNumShards = 16;
+  std::array<Shard, kNumShards> shards;
 
   Manager() {}
 
+  Shard& GetShard(const std::string& name) {
+    return shards[std::hash<std::string>()(name) % kNumShards];
+  }
+
   static Manager* Global() {
     // We deliberately leak the Manager instance, to avoid leak sanitizers
     // complaining about the entries in Manager::fmap being leaked at program
@@ -63,42 +75,43 @@ Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
 }
 
 Registry& Registry::Register(const std::string& name, bool can_override) {  // NOLINT(*)
-  Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  if (m->fmap.count(name)) {
+  Manager::Shard& shard = Manager::Global()->GetShard(name);
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  if (shard.fmap.count(name)) {
     ICHECK(can_override) << "Global PackedFunc " << name << " is already registered";
   }
 
   Registry* r = new Registry();
   r->name_ = name;
-  m->fmap[name] = r;
+  shard.fmap[name] = r;
   return *r;
 }
 
 bool Registry::Remove(const std::string& name) {
-  Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return false;
-  m->fmap.erase(it);
+  Manager::Shard& shard = Manager::Global()->GetShard(name);
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  auto it = shard.fmap.find(name);
+  if (it == shard.fmap.end()) return false;
+  shard.fmap.erase(it);
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
-  Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
+  Manager::Shard& shard = Manager::Global()->GetShard(name);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
+  auto it = shard.fmap.find(name);
+  if (it == shard.fmap.end()) return nullptr;
   return &(it->second->func_);
 }
 
 std::vector<std::string> Registry::ListNames() {
   Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
   std::vector<std::string> keys;
-  keys.reserve(m->fmap.size());
-  for (const auto& kv : m->fmap) {
-    keys.push_back(kv.first);
+  for (Manager::Shard& shard : m->shards) {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    for (const auto& kv : shard.fmap) {
+      keys.push_back(kv.first);
+    }
   }
   return keys;
 }
@@ -0,0 +1,298 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/batching.cc
+ * \brief Dynamic batching of the concurrent requests to a relax VM function.
+ */
+
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Gather the concurrent requests to a VM function into batches, run the function once per
+ *  batch and scatter the results back.
+ *
+ *  Every argument of the function is batched along its first dimension, which must be symbolic in
+ *  the function. A batch starts with the oldest request, and takes the later ones with the same
+ *  dtypes and other dimensions as long as the batch stays within `max_batch_size` rows. It runs
+ *  once it is full or the oldest request has waited for `max_delay_us` microseconds.
+ *
+ *  A batch of a single request runs on the request tensors as they are. Otherwise the arguments are
+ *  concatenated into the batch tensors. The results handed back are views into the batch outputs,
+ *  so that they are never copied, which requires every output to be batched too.
+ *
+ * \note The batches run on a worker thread, in an execution context of the VM of its own.
+ */
+class DynamicBatcher {
+ public:
+  DynamicBatcher(Module vm, std::string func_name, int64_t max_batch_size, int64_t max_delay_us)
+      : func_name_(func_name), max_batch_size_(max_batch_size), max_delay_(max_delay_us) {
+    CHECK_GT(max_batch_size, 0) << "ValueError: max_batch_size must be positive";
+    CHECK_GE(max_delay_us, 0) << "ValueError: max_delay_us must be non-negative";
+    VirtualMachine* vm_ptr = static_cast<VirtualMachine*>(vm.operator->());
+    ICHECK(!vm_ptr->devices.empty()) << "The VirtualMachine is not initialized.";
+    device_ = vm_ptr->devices[0];
+    vm_ = Module(vm_ptr->CreateContext());
+    set_input_ = vm_->GetFunction("set_input", false);
+    invoke_stateful_ = vm_->GetFunction("invoke_stateful", false);
+    get_output_arity_ = vm_->GetFunction("get_output_arity", false);
+    get_output_ = vm_->GetFunction("get_output", false);
+    worker_ = std::thread([this]() { this->WorkerLoop(); });
+  }
+
+  ~DynamicBatcher() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+  /*! \brief Submit a request and wait for its results. */
+  void Run(TVMArgs args, TVMRetValue* rv) {
+    CHECK_GT(args.size(), 0) << "ValueError: Dynamic batching requires the function to take inputs";
+    auto request = std::make_shared<Request>();
+    std::ostringstream key;
+    for (int i = 0; i < args.size(); ++i) {
+      ICHECK_EQ(args[i].type_code(), kTVMNDArrayHandle)
+          << "ValueError: Dynamic batching only supports NDArray inputs, but argument " << i
+          << " is " << ArgTypeCode2Str(args[i].type_code());
+      NDArray arr = args[i];
+      CHECK_GE(arr->ndim, 1) << "ValueError: Argument " << i << " has no batch dimension";
+      if (i == 0) {
+        request->num_rows = arr->shape[0];
+      } else {
+        CHECK_EQ(arr->shape[0], request->num_rows)
+            << "ValueError: The arguments of a request must have the same batch size";
+      }
+      key << arr.DataType() << "[";
+      for (int d = 1; d < arr->ndim; ++d) {
+        key << arr->shape[d] << ",";
+      }
+      key << "];";
+      request->args.push_back(arr);
+    }
+    request->key = key.str();
+    request->arrival = Clock::now();
+    std::future<ObjectRef> future = request->result.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(request));
+    }
+    cv_.notify_all();
+    *rv = future.get();
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /*! \brief A request waiting in the queue. */
+  struct Request {
+    /*! \brief The arguments. */
+    std::vector<NDArray> args;
+    /*! \brief The dtypes and the dimensions other than the batch one, to batch by. */
+    std::string key;
+    /*! \brief The batch size of the arguments. */
+    int64_t num_rows;
+    /*! \brief The arrival time. */
+    Clock::time_point arrival;
+    /*! \brief The output of the request. */
+    std::promise<ObjectRef> result;
+  };
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      Clock::time_point deadline = queue_.front()->arrival + max_delay_;
+      cv_.wait_until(lock, deadline,
+                     [this]() { return stop_ || NumRowsReady() >= max_batch_size_; });
+      std::vector<std::shared_ptr<Request>> batch = TakeBatch();
+      lock.unlock();
+      try {
+        RunBatch(batch);
+      } catch (...) {
+        for (const std::shared_ptr<Request>& request : batch) {
+          request->result.set_exception(std::current_exception());
+        }
+      }
+      lock.lock();
+    }
+  }
+
+  /*! \brief The number of queued rows which can be batched with the oldest request. */
+  int64_t NumRowsReady() const {
+    int64_t num_rows = 0;
+    for (const std::shared_ptr<Request>& request : queue_) {
+      if (request->key == queue_.front()->key) {
+        num_rows += request->num_rows;
+      }
+    }
+    return num_rows;
+  }
+
+  /*! \brief Take the oldest request and the later ones batched with it out of the queue. */
+  std::vector<std::shared_ptr<Request>> TakeBatch() {
+    std::vector<std::shared_ptr<Request>> batch{queue_.front()};
+    queue_.pop_front();
+    int64_t num_rows = batch[0]->num_rows;
+    for (auto it = queue_.begin(); it != queue_.end() && num_rows < max_batch_size_;) {
+      if ((*it)->key == batch[0]->key && num_rows + (*it)->num_rows <= max_batch_size_) {
+        num_rows += (*it)->num_rows;
+        batch.push_back(std::move(*it));
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return batch;
+  }
+
+  void RunBatch(const std::vector<std::shared_ptr<Request>>& batch) {
+    size_t num_args = batch[0]->args.size();
+    int64_t num_rows = 0;
+    for (const std::shared_ptr<Request>& request : batch) {
+      num_rows += request->num_rows;
+    }
+    // Step 1. Set the inputs, concatenated along the batch dimension if there are several requests
+    std::vector<NDArray> inputs;
+    if (batch.size() == 1) {
+      inputs = batch[0]->args;
+    } else {
+      for (size_t i = 0; i < num_args; ++i) {
+        const NDArray& first = batch[0]->args[i];
+        std::vector<int64_t> shape(first.Shape().begin(), first.Shape().end());
+        shape[0] = num_rows;
+        NDArray input = NDArray::Empty(ShapeTuple(shape), first.DataType(), device_);
+        DLTensor dst = *input.operator->();
+        for (const std::shared_ptr<Request>& request : batch) {
+          const NDArray& arg = request->args[i];
+          shape[0] = arg->shape[0];
+          dst.shape = shape.data();
+          NDArray::CopyFromTo(arg.operator->(), &dst);
+          dst.byte_offset += GetDataSize(*arg.operator->());
+        }
+        inputs.push_back(input);
+      }
+    }
+    std::vector<TVMValue> values(num_args + 1);
+    std::vector<int> tcodes(num_args + 1);
+    TVMArgsSetter setter(values.data(), tcodes.data());
+    setter(0, func_name_);
+    for (size_t i = 0; i < num_args; ++i) {
+      setter(i + 1, inputs[i]);
+    }
+    TVMRetValue rv;
+    set_input_.CallPacked(TVMArgs(values.data(), tcodes.data(), num_args + 1), &rv);
+    // Step 2. Run the function
+    invoke_stateful_(func_name_);
+    // Step 3. Scatter the outputs
+    int arity = get_output_arity_(func_name_);
+    std::vector<NDArray> outputs;
+    if (arity < 0) {
+      outputs.push_back(get_output_(func_name_));
+    } else {
+      for (int i = 0; i < arity; ++i) {
+        outputs.push_back(get_output_(func_name_, i));
+      }
+    }
+    std::vector<std::vector<ObjectRef>> results(batch.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      NDArray output = outputs[i];
+      CHECK(output->ndim >= 1 && output->shape[0] == num_rows)
+          << "ValueError: Output " << i << " of " << func_name_ << " is not batched";
+      if (batch.size() == 1) {
+        results[0].push_back(output);
+        continue;
+      }
+      std::vector<int64_t> shape(output.Shape().begin(), output.Shape().end());
+      size_t byte_offset = output->byte_offset;
+      for (size_t j = 0; j < batch.size(); ++j) {
+        shape[0] = batch[j]->num_rows;
+        NDArray view = output.CreateView(ShapeTuple(shape), output->dtype);
+        const_cast<DLTensor*>(view.operator->())->byte_offset = byte_offset;
+        byte_offset += GetDataSize(*view.operator->());
+        results[j].push_back(view);
+      }
+    }
+    for (size_t j = 0; j < batch.size(); ++j) {
+      if (arity < 0) {
+        batch[j]->result.set_value(results[j][0]);
+      } else {
+        batch[j]->result.set_value(ADT::Tuple(results[j]));
+      }
+    }
+  }
+
+  /*! \brief The execution context of the VM running the batches. */
+  Module vm_;
+  /*! \brief The name of the batched function. */
+  std::string func_name_;
+  /*! \brief The max number of rows of a batch. */
+  int64_t max_batch_size_;
+  /*! \brief The max time the oldest request waits for a batch to fill up. */
+  std::chrono::microseconds max_delay_;
+  /*! \brief The device the function runs on. */
+  Device device_;
+  /*! \brief The functions of the VM context. */
+  PackedFunc set_input_, invoke_stateful_, get_output_arity_, get_output_;
+  /*! \brief The requests waiting for a batch, oldest first. */
+  std::deque<std::shared_ptr<Request>> queue_;
+  /*! \brief Whether the batcher is being destroyed. */
+  bool stop_{false};
+  /*! \brief The mutex guarding the queue. */
+  std::mutex mutex_;
+  /*! \brief The condition variable notified on new requests and on stop. */
+  std::condition_variable cv_;
+  /*! \brief The worker thread running the batches. */
+  std::thread worker_;
+};
+
+TVM_REGISTER_GLOBAL("vm.batching.make_batcher")
+    .set_body_typed([](Module vm, String func_name, int64_t max_batch_size, int64_t max_delay_us) {
+      auto batcher = std::make_shared<DynamicBatcher>(vm, func_name, max_batch_size, max_delay_us);
+      return PackedFunc([batcher](TVMArgs args, TVMRetValue* rv) { batcher->Run(args, rv); });
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -19,6 +19,7 @@
 /*!
  * \file src/runtime/relax_vm/builtin.cc
  */
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/adt.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/device_api.h>
@@ -26,11 +27,20 @@
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/bytecode.h>
 #include <tvm/runtime/relax_vm/memory_manager.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../runtime_base.h"
+#include "../texture.h"
+#include "scoped_allocator.h"
+
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
@@ -39,7 +49,10 @@ using tvm::runtime::NDArray;
 
 TVM_REGISTER_GLOBAL("vm.builtin.shape_of").set_body_method(&NDArray::Shape);
 
-TVM_REGISTER_GLOBAL("vm.builtin.copy").set_body_typed([](NDArray src) { return src; });
+TVM_REGISTER_GLOBAL("vm.builtin.copy").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // The registers may hold tensors, tuples or shapes.
+  *rv = args[0];
+});
 
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_shape_heap")
     .set_body_typed([](void* vm_ptr, ShapeTuple size) {
@@ -47,6 +60,24 @@ TVM_REGISTER_GLOBAL("vm.builtin.alloc_shape_heap")
       return NDArray::Empty(size, DLDataType{kDLInt, 64, 1}, vm->devices[0]);
     });
 
+// Make stream `stream[0]` of the VM's compute device the current stream.
+TVM_REGISTER_GLOBAL("vm.builtin.stream_switch")
+    .set_body_typed([](void* vm_ptr, ShapeTuple stream) {
+      ICHECK_EQ(stream.size(), 1);
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      Device dev = vm->devices[0];
+      DeviceAPI::Get(dev)->SetStream(dev, vm->GetStream(0, stream[0]));
+    });
+
+// Make the work later issued to stream `streams[1]` wait for the work issued to `streams[0]`.
+TVM_REGISTER_GLOBAL("vm.builtin.stream_sync").set_body_typed([](void* vm_ptr, ShapeTuple streams) {
+  ICHECK_EQ(streams.size(), 2);
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  Device dev = vm->devices[0];
+  DeviceAPI::Get(dev)->SyncStreamFromTo(dev, vm->GetStream(0, streams[0]),
+                                        vm->GetStream(0, streams[1]));
+});
+
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_closure").set_body([](TVMArgs args, TVMRetValue* rv) {
   std::vector<ObjectRef> cap_vars;
   for (int i = 1; i < args.size(); ++i) {
@@ -98,76 +129,150 @@ TVM_REGISTER_GLOBAL("vm.builtin.store_shape")
     });
 
 TVM_REGISTER_GLOBAL("vm.builtin.load_shape").set_body_typed([](NDArray heap, ShapeTuple indexes) {
-  int64_t* heap_data = reinterpret_cast<int64_t*>(heap.ToDLPack()->dl_tensor.data);
-  std::vector<int64_t> shape;
-  for (size_t i = 0; i < indexes.size(); ++i) {
-    int64_t heap_idx = indexes[i];
-    ICHECK(heap_idx >= 0 && heap_idx < heap.Shape()[0]);
-    shape.push_back(heap_data[heap_idx]);
-  }
-  return ShapeTuple(shape);
+  const int64_t* heap_data = static_cast<const int64_t*>(heap->data);
+  int64_t heap_size = heap->shape[0];
+  return ShapeTuple::Make(indexes.size(), [&](int64_t* shape) {
+    for (size_t i = 0; i < indexes.size(); ++i) {
+      int64_t heap_idx = indexes[i];
+      ICHECK(heap_idx >= 0 && heap_idx < heap_size);
+      shape[i] = heap_data[heap_idx];
+    }
+  });
 });
 
-TVM_REGISTER_GLOBAL("vm.builtin.alloc_storage")
-    .set_body_typed([](void* vm_ptr, ShapeTuple buffer_size, Index device_index,
-                       DLDataType dtype_hint) {
-      ICHECK_EQ(buffer_size.size(), 1);
-      int alignment = runtime::kAllocAlignment;
-      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
-      ICHECK_LT(device_index, vm->devices.size())
-          << "The device index is out of VM physical devices list";
+/*! \brief Resolve the device index of an allocation, where -1 refers to the host. */
+static Index ResolveDeviceIndex(VirtualMachine* vm, Index device_index) {
+  ICHECK_LT(device_index, vm->devices.size())
+      << "The device index is out of VM physical devices list";
+  if (device_index == -1) {
+    // Allocate on host. Host is always the last element of vm->devices.
+    device_index = vm->devices.size() - 1;
+  }
+  return device_index;
+}
 
-      if (device_index == -1) {
-        // Allocate on host. Host is always the last element of vm->devices.
-        device_index = vm->devices.size() - 1;
-      }
+/*!
+ * \brief Allocate a storage of the given bytes on a resolved device of the VM, in the given
+ *  storage scope of the device.
+ */
+static Storage AllocStorage(VirtualMachine* vm, int64_t size, Index device_index,
+                            DLDataType dtype_hint, const std::string& scope = "global") {
+  int alignment = runtime::kAllocAlignment;
+  auto storage_obj = runtime::SmallObjAllocator().make_object<StorageObj>();
+  Allocator* alloc = nullptr;
+  if (scope == "global") {
+    alloc = vm->allocators[device_index];
+    ICHECK(alloc) << "Did you forget to init the VirtualMachine with devices?";
+  } else {
+    alloc = MemoryManager::GetOrCreateScopedAllocator(vm->devices[device_index], scope);
+  }
+  storage_obj->buffer = alloc->Alloc(size, alignment, dtype_hint);
+  Storage storage(storage_obj);
+  if (vm->storage_recorder != nullptr) {
+    vm->storage_recorder->push_back(storage);
+  }
+  return storage;
+}
 
-      int64_t size_imm = buffer_size[0];
+/*!
+ * \brief Allocate a 2D image of a texture scope on a resolved device of the VM, whose extent is
+ *  (height, width, channel) as planned by VMGraphMemoryPlan.
+ */
+static Storage AllocTextureStorage(VirtualMachine* vm, ShapeTuple extent, Index device_index,
+                                   DLDataType dtype_hint, const std::string& scope) {
+  CHECK(IsTextureStorage(scope)) << "ValueError: A storage sized by a 2D image extent must be of "
+                                 << "a texture scope, but gets " << scope;
+  Allocator* alloc = MemoryManager::GetOrCreateScopedAllocator(vm->devices[device_index], scope);
+  ICHECK_EQ(alloc->type(), kScoped);
+  auto storage_obj = runtime::SmallObjAllocator().make_object<StorageObj>();
+  storage_obj->buffer = static_cast<ScopedAllocator*>(alloc)->AllocTexture(extent, dtype_hint);
+  Storage storage(storage_obj);
+  if (vm->storage_recorder != nullptr) {
+    vm->storage_recorder->push_back(storage);
+  }
+  return storage;
+}
 
-      auto storage_obj = runtime::SimpleObjAllocator().make_object<StorageObj>();
-      auto* alloc = vm->allocators[device_index];
-      ICHECK(alloc) << "Did you forget to init the VirtualMachine with devices?";
-      storage_obj->buffer = alloc->Alloc(size_imm, alignment, dtype_hint);
-      Storage storage(storage_obj);
-      return storage;
-    });
+// The storage scope is an optional last argument, "global" by default. The size is a number of
+// bytes, or the (height, width, channel) extent of a 2D image of a texture scope.
+TVM_REGISTER_GLOBAL("vm.builtin.alloc_storage").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK(args.size() == 4 || args.size() == 5)
+      << "ValueError: vm.builtin.alloc_storage expects 4 or 5 arguments, but got " << args.size();
+  VirtualMachine* vm = static_cast<VirtualMachine*>(args[0].operator void*());
+  ShapeTuple buffer_size = args[1];
+  Index device_index = ResolveDeviceIndex(vm, args[2]);
+  DLDataType dtype_hint = args[3];
+  std::string scope = args.size() == 5 ? args[4].operator std::string() : "global";
+  if (buffer_size.size() == 3) {
+    *rv = AllocTextureStorage(vm, buffer_size, device_index, dtype_hint, scope);
+    return;
+  }
+  ICHECK_EQ(buffer_size.size(), 1);
+  *rv = AllocStorage(vm, buffer_size[0], device_index, dtype_hint, scope);
+});
 
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_tensor").set_body_method<Storage>(&StorageObj::AllocNDArray);
 
+TVM_REGISTER_GLOBAL("vm.builtin.to_device")
+    .set_body_typed([](void* vm_ptr, NDArray src, Index device_index) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      return vm->CopyToDevice(src, ResolveDeviceIndex(vm, device_index));
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.alloc_output")
+    .set_body_typed([](void* vm_ptr, ShapeTuple shape, Index output_index, Index device_index,
+                       DLDataType dtype) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      device_index = ResolveDeviceIndex(vm, device_index);
+      // Hand out the buffer bound by `set_output_zero_copy`, if any
+      NDArray bound = vm->GetBoundOutput(output_index);
+      if (bound.defined()) {
+        const Device& dev = vm->devices[device_index];
+        std::vector<int64_t> bound_shape(bound.Shape().begin(), bound.Shape().end());
+        std::vector<int64_t> output_shape(shape.begin(), shape.end());
+        CHECK(bound_shape == output_shape && bound.DataType() == DataType(dtype) &&
+              bound->device.device_type == dev.device_type &&
+              bound->device.device_id == dev.device_id)
+            << "ValueError: The buffer bound to output " << output_index << " is "
+            << profiling::ShapeString(bound_shape, bound->dtype) << " on " << bound->device
+            << ", but the output is " << profiling::ShapeString(output_shape, dtype) << " on "
+            << dev;
+        return bound;
+      }
+      int64_t size = (dtype.bits * dtype.lanes + 7) / 8;
+      for (int64_t dim : shape) {
+        size *= dim;
+      }
+      Storage storage = AllocStorage(vm, size, device_index, dtype);
+      return storage->AllocNDArray(0, shape, dtype);
+    });
+
 TVM_REGISTER_GLOBAL("vm.binary_broadcast_shape_infer")
     .set_body_typed([](ShapeTuple lhs_shape, ShapeTuple rhs_shape) {
-      std::vector<int64_t> output_shape;
       size_t ndim0 = lhs_shape.size();
       size_t ndim1 = rhs_shape.size();
-      size_t i = 1;
-      for (; i <= std::min(ndim0, ndim1); ++i) {
-        int64_t lhs_dim = lhs_shape[ndim0 - i];
-        int64_t rhs_dim = rhs_shape[ndim1 - i];
-        ICHECK(lhs_dim == rhs_dim || lhs_dim == 1 || rhs_dim == 1);
-        output_shape.push_back(std::max(lhs_dim, rhs_dim));
-      }
       size_t max_ndim = std::max(ndim0, ndim1);
-      ShapeTuple& longer_shape = (ndim0 > ndim1) ? lhs_shape : rhs_shape;
-      for (; i <= max_ndim; ++i) {
-        output_shape.push_back(longer_shape[max_ndim - i]);
-      }
-      return ShapeTuple(output_shape.rbegin(), output_shape.rend());
+      const ShapeTuple& longer_shape = (ndim0 > ndim1) ? lhs_shape : rhs_shape;
+      // Fill the output from the innermost dimension.
+      return ShapeTuple::Make(max_ndim, [&](int64_t* output_shape) {
+        size_t i = 1;
+        for (; i <= std::min(ndim0, ndim1); ++i) {
+          int64_t lhs_dim = lhs_shape[ndim0 - i];
+          int64_t rhs_dim = rhs_shape[ndim1 - i];
+          ICHECK(lhs_dim == rhs_dim || lhs_dim == 1 || rhs_dim == 1);
+          output_shape[max_ndim - i] = std::max(lhs_dim, rhs_dim);
+        }
+        for (; i <= max_ndim; ++i) {
+          output_shape[max_ndim - i] = longer_shape[max_ndim - i];
+        }
+      });
     });
 
 TVM_REGISTER_GLOBAL("vm.call_tir_dyn").set_body([](TVMArgs args, TVMRetValue* rv) {
   void* vm_ptr = args[0];
   VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
   runtime::String func_name = args[1];
-
-  PackedFunc func{nullptr};
-  if (vm->lib.defined()) {
-    func = vm->lib.value()->GetFunction(func_name, true);
-  }
-  if (!func.defined()) {
-    const PackedFunc* p_func = Registry::Get(func_name);
-    CHECK(p_func != nullptr);
-    func = *(p_func);
-  }
+  const PackedFunc& func = vm->GetCallTIRDynKernel(func_name);
 
   ShapeTuple to_unpack = args[args.size() - 1];
   size_t num_tensor_args = args.size() - 3;
@@ -194,6 +299,238 @@ TVM_REGISTER_GLOBAL("vm.runtime.TupleGetItem")
       return adt[idx];
     });
 
+// The TupleGetItem instruction, for the compiled functions which make it a call.
+TVM_REGISTER_GLOBAL("vm.builtin.tuple_getitem").set_body_typed([](runtime::ADT adt, int64_t idx) {
+  CHECK_LT(idx, adt.size()) << "ValueError: Tuple index " << idx << " out of range for a tuple of "
+                            << adt.size() << " fields";
+  return adt[idx];
+});
+
+//-------------------------------------------------
+// Compiled functions
+//-------------------------------------------------
+
+// Call a Relax function of the VM by name, from the native code of a compiled VM function.
+TVM_REGISTER_GLOBAL("vm.builtin.call_vm_func").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // args[0]: vm; args[1]: function name; args[2, 3, ...]: function arguments
+  void* vm_ptr = args[0];
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  std::string func_name = args[1];
+  PackedFunc func = vm->GetFunction(func_name, GetObjectPtr<Object>(vm));
+  func.CallPacked(TVMArgs(args.values + 2, args.type_codes + 2, args.size() - 2), rv);
+});
+
+// Read the condition of an If of a compiled VM function, like the If instruction does.
+TVM_REGISTER_GLOBAL("vm.builtin.read_if_cond").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // args[0]: vm; args[1]: condition
+  void* vm_ptr = args[0];
+  TVMRetValue cond;
+  cond = args[1];
+  *rv = static_cast<VirtualMachine*>(vm_ptr)->ReadCondition(cond);
+});
+
+//-------------------------------------------------
+// Paged KV cache
+//-------------------------------------------------
+
+/*!
+ * \brief A cache of the keys or values of the tokens decoded so far, kept in fixed-size pages.
+ *
+ *  Appending a token copies only the token itself, and allocates a page only once every
+ *  `page_size` tokens, or never when a page freed by `paged_kv_cache_clear` can be reused.
+ *  The cache object is passed in and out of the decoding function, so that it persists across
+ *  the calls of the VM without its data being returned and fed back as tensors.
+ */
+class PagedKVCacheObj : public Object {
+ public:
+  /*! \brief The device of the pages. */
+  Device device;
+  /*! \brief The dtype of the tokens. */
+  DLDataType dtype;
+  /*! \brief The shape of a token, e.g. (num_heads, head_dim). */
+  std::vector<int64_t> token_shape;
+  /*! \brief The number of tokens per page. */
+  int64_t page_size;
+  /*! \brief The number of tokens in the cache. */
+  int64_t num_tokens{0};
+  /*! \brief The pages in use, each of shape (page_size, *token_shape). */
+  std::vector<NDArray> pages;
+  /*! \brief The pages freed for reuse. */
+  std::vector<NDArray> free_pages;
+  /*! \brief The contiguous copy of the tokens handed out by `View`, grown geometrically. */
+  NDArray view_buffer;
+  /*! \brief The number of leading tokens which are up to date in the view buffer. */
+  int64_t num_viewed{0};
+
+  /*! \brief Append the tokens of shape (n, *token_shape). */
+  void Append(const NDArray& data) {
+    CHECK(DataType(data->dtype) == DataType(dtype) &&
+          data->ndim == static_cast<int>(token_shape.size()) + 1 &&
+          std::equal(token_shape.begin(), token_shape.end(), data->shape + 1))
+        << "ValueError: Cannot append "
+        << profiling::ShapeString(std::vector<int64_t>(data->shape, data->shape + data->ndim),
+                                  data->dtype)
+        << " to a KV cache of tokens " << profiling::ShapeString(token_shape, dtype);
+    int64_t num_rows = data->shape[0];
+    for (int64_t copied = 0; copied < num_rows;) {
+      int64_t row_in_page = num_tokens % page_size;
+      if (row_in_page == 0 && num_tokens / page_size == static_cast<int64_t>(pages.size())) {
+        pages.push_back(NewPage());
+      }
+      int64_t chunk = std::min(num_rows - copied, page_size - row_in_page);
+      CopyRows(*data.operator->(), copied, *pages[num_tokens / page_size].operator->(),
+               row_in_page, chunk);
+      copied += chunk;
+      num_tokens += chunk;
+    }
+  }
+
+  /*!
+   * \brief Get the tokens as a contiguous tensor of shape (num_tokens, *token_shape).
+   * \note The view shares its buffer with the later views, whose leading tokens are the same
+   *  unless the cache is cleared in between.
+   */
+  NDArray View() {
+    if (num_tokens == 0 && !view_buffer.defined()) {
+      return NDArray::Empty(TokensShape(0), dtype, device);
+    }
+    int64_t capacity = view_buffer.defined() ? view_buffer->shape[0] : 0;
+    if (capacity < num_tokens) {
+      capacity = std::max(num_tokens, capacity * 2);
+      capacity = (capacity + page_size - 1) / page_size * page_size;
+      view_buffer = NDArray::Empty(TokensShape(capacity), dtype, device);
+      num_viewed = 0;
+    }
+    // Only the tokens appended since the last view are copied
+    while (num_viewed < num_tokens) {
+      int64_t row_in_page = num_viewed % page_size;
+      int64_t chunk = std::min(num_tokens - num_viewed, page_size - row_in_page);
+      CopyRows(*pages[num_viewed / page_size].operator->(), row_in_page,
+               *view_buffer.operator->(), num_viewed, chunk);
+      num_viewed += chunk;
+    }
+    return view_buffer.CreateView(TokensShape(num_tokens), dtype);
+  }
+
+  /*! \brief Remove all the tokens, keeping the pages for reuse. */
+  void Clear() {
+    free_pages.insert(free_pages.end(), pages.begin(), pages.end());
+    pages.clear();
+    num_tokens = 0;
+    num_viewed = 0;
+  }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.PagedKVCache";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PagedKVCacheObj, Object);
+
+ private:
+  ShapeTuple TokensShape(int64_t num_rows) const {
+    return ShapeTuple::Make(token_shape.size() + 1, [&](int64_t* shape) {
+      shape[0] = num_rows;
+      std::copy(token_shape.begin(), token_shape.end(), shape + 1);
+    });
+  }
+
+  NDArray NewPage() {
+    if (free_pages.empty()) {
+      return NDArray::Empty(TokensShape(page_size), dtype, device);
+    }
+    NDArray page = free_pages.back();
+    free_pages.pop_back();
+    return page;
+  }
+
+  /*! \brief Copy the rows of the tokens between two compact tensors. */
+  void CopyRows(DLTensor src, int64_t src_row, DLTensor dst, int64_t dst_row,
+                int64_t num_rows) const {
+    ShapeTuple tokens_shape = TokensShape(num_rows);
+    std::vector<int64_t> shape(tokens_shape.begin(), tokens_shape.end());
+    int64_t row_bytes = GetDataSize(src) / std::max<int64_t>(src.shape[0], 1);
+    src.byte_offset += src_row * row_bytes;
+    dst.byte_offset += dst_row * row_bytes;
+    src.shape = shape.data();
+    dst.shape = shape.data();
+    NDArray::CopyFromTo(&src, &dst);
+  }
+};
+
+/*! \brief Managed reference to PagedKVCacheObj. */
+class PagedKVCache : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PagedKVCache, ObjectRef, PagedKVCacheObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(PagedKVCacheObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_create")
+    .set_body_typed([](NDArray init_data, int64_t page_size) {
+      CHECK_GE(init_data->ndim, 1) << "ValueError: The initial data of a KV cache must be of "
+                                      "shape (num_tokens, *token_shape)";
+      CHECK_GT(page_size, 0) << "ValueError: The page size of a KV cache must be positive";
+      ObjectPtr<PagedKVCacheObj> n = make_object<PagedKVCacheObj>();
+      n->device = init_data->device;
+      n->dtype = init_data->dtype;
+      n->token_shape.assign(init_data->shape + 1, init_data->shape + init_data->ndim);
+      n->page_size = page_size;
+      n->Append(init_data);
+      return PagedKVCache(n);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_append")
+    .set_body_typed([](PagedKVCache cache, NDArray data) {
+      cache->Append(data);
+      return cache;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_view").set_body_typed([](PagedKVCache cache) {
+  return cache->View();
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_pages").set_body_typed([](PagedKVCache cache) {
+  return ADT::Tuple(std::vector<ObjectRef>(cache->pages.begin(), cache->pages.end()));
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_length").set_body_typed([](PagedKVCache cache) {
+  return cache->num_tokens;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_clear").set_body_typed([](PagedKVCache cache) {
+  cache->Clear();
+  return cache;
+});
+
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
+
+//-------------------------------------------------
+// AnyList, the register files and constant pool of the compiled VM functions
+//-------------------------------------------------
+
+int TVMBackendAnyListSetPackedArg(void* anylist, int index, TVMValue* args, int* type_codes,
+                                  int arg_offset) {
+  using namespace tvm::runtime;
+  API_BEGIN();
+  auto* list = static_cast<TVMRetValue*>(anylist);
+  TVMArgsSetter setter(args, type_codes);
+  setter(arg_offset, list[index]);
+  API_END();
+}
+
+int TVMBackendAnyListResetItem(void* anylist, int index) {
+  using namespace tvm::runtime;
+  API_BEGIN();
+  auto* list = static_cast<TVMRetValue*>(anylist);
+  list[index] = nullptr;
+  API_END();
+}
+
+int TVMBackendAnyListMoveFromPackedReturn(void* anylist, int index, TVMValue* args,
+                                          int* type_codes, int ret_offset) {
+  using namespace tvm::runtime;
+  API_BEGIN();
+  auto* list = static_cast<TVMRetValue*>(anylist);
+  list[index] = TVMRetValue::MoveFromCHost(args[ret_offset], type_codes[ret_offset]);
+  API_END();
+}
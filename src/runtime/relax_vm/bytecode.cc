@@ -63,6 +63,41 @@ Instruction Instruction::If(RegName cond, Index false_offset) {
   instr.false_offset = false_offset;
   return instr;
 }
+
+Instruction Instruction::MakeTuple(Index num_fields, Instruction::Arg* fields, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::MakeTuple;
+  instr.dst = dst;
+  instr.num_args = num_fields;
+  instr.args = fields;
+  return instr;
+}
+
+Instruction Instruction::TupleGetItem(RegName tuple, Index field_index, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::TupleGetItem;
+  instr.dst = dst;
+  instr.tuple = tuple;
+  instr.field_index = field_index;
+  return instr;
+}
+
+Instruction Instruction::ShapeOf(RegName tensor, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::ShapeOf;
+  instr.dst = dst;
+  instr.tensor = tensor;
+  return instr;
+}
+
+Instruction Instruction::InvokeClosure(Index num_args, Instruction::Arg* args, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::InvokeClosure;
+  instr.dst = dst;
+  instr.num_args = num_args;
+  instr.args = args;
+  return instr;
+}
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
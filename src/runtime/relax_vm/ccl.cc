@@ -0,0 +1,371 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/ccl.cc
+ * \brief The collectives of the relax VM, and their shared-memory ring implementation on CPU.
+ */
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/ccl.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+ReduceKind ParseReduceKind(const std::string& name) {
+  if (name == "sum") {
+    return ReduceKind::kSum;
+  } else if (name == "prod") {
+    return ReduceKind::kProd;
+  } else if (name == "min") {
+    return ReduceKind::kMin;
+  } else if (name == "max") {
+    return ReduceKind::kMax;
+  }
+  LOG(FATAL) << "ValueError: Unknown reduction " << name
+             << ", which is expected to be one of sum, prod, min and max";
+  return ReduceKind::kSum;
+}
+
+Communicator Communicator::Create(const std::string& group, int world_size, int rank,
+                                  Device device) {
+  CHECK_GT(world_size, 0) << "ValueError: The world size must be positive";
+  CHECK(rank >= 0 && rank < world_size)
+      << "ValueError: The rank " << rank << " is out of the world size " << world_size;
+  std::string name = std::string("vm.ccl.create_communicator.") + DeviceName(device.device_type);
+  const PackedFunc* create = Registry::Get(name);
+  CHECK(create != nullptr) << "ValueError: The collectives on " << device
+                           << " are not enabled, e.g. by USE_NCCL on CUDA";
+  return (*create)(group, world_size, rank, device);
+}
+
+TVM_REGISTER_OBJECT_TYPE(CommunicatorObj);
+
+/*! \brief The elements of a tensor. */
+static int64_t NumElements(const DLTensor* tensor) {
+  int64_t size = 1;
+  for (int i = 0; i < tensor->ndim; ++i) {
+    size *= tensor->shape[i];
+  }
+  return size;
+}
+
+/*! \brief The bytes of an element of a tensor. */
+static int64_t ElementBytes(const DLTensor* tensor) {
+  return (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+}
+
+/*! \brief The first byte of a tensor. */
+static char* DataPtr(const DLTensor* tensor) {
+  return static_cast<char*>(tensor->data) + tensor->byte_offset;
+}
+
+template <typename T>
+static void ReduceInto(T* dst, const T* src, int64_t n, ReduceKind kind) {
+  switch (kind) {
+    case ReduceKind::kSum:
+      for (int64_t i = 0; i < n; ++i) dst[i] += src[i];
+      break;
+    case ReduceKind::kProd:
+      for (int64_t i = 0; i < n; ++i) dst[i] *= src[i];
+      break;
+    case ReduceKind::kMin:
+      for (int64_t i = 0; i < n; ++i) dst[i] = std::min(dst[i], src[i]);
+      break;
+    case ReduceKind::kMax:
+      for (int64_t i = 0; i < n; ++i) dst[i] = std::max(dst[i], src[i]);
+      break;
+  }
+}
+
+/*! \brief Reduce n elements of src into dst. */
+static void Reduce(char* dst, const char* src, int64_t n, DLDataType dtype, ReduceKind kind) {
+  DataType type(dtype);
+  if (type == DataType::Float(32)) {
+    ReduceInto(reinterpret_cast<float*>(dst), reinterpret_cast<const float*>(src), n, kind);
+  } else if (type == DataType::Float(64)) {
+    ReduceInto(reinterpret_cast<double*>(dst), reinterpret_cast<const double*>(src), n, kind);
+  } else if (type == DataType::Int(32)) {
+    ReduceInto(reinterpret_cast<int32_t*>(dst), reinterpret_cast<const int32_t*>(src), n, kind);
+  } else if (type == DataType::Int(64)) {
+    ReduceInto(reinterpret_cast<int64_t*>(dst), reinterpret_cast<const int64_t*>(src), n, kind);
+  } else {
+    LOG(FATAL) << "ValueError: The collectives on CPU do not reduce " << type;
+  }
+}
+
+/*!
+ * \brief A group of workers in this process, sharing the buffers the collectives work on.
+ */
+class CPUGroup {
+ public:
+  explicit CPUGroup(int world_size)
+      : world_size(world_size), buffers(world_size, nullptr), joined(world_size, false) {}
+
+  /*! \brief Wait until all the workers reach the barrier. */
+  void Barrier() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    int64_t generation = generation_;
+    if (++num_arrived_ == world_size) {
+      num_arrived_ = 0;
+      ++generation_;
+      cv_.notify_all();
+    } else {
+      cv_.wait(lock, [this, generation]() { return generation_ != generation; });
+    }
+  }
+
+  /*!
+   * \brief Join a group, or create it if this is its first worker.
+   * \param name The name of the group.
+   * \param world_size The number of workers in the group.
+   * \param rank The rank of the worker joining.
+   * \return The group, shared by the communicators of its workers.
+   */
+  static std::shared_ptr<CPUGroup> Join(const std::string& name, int world_size, int rank) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<CPUGroup>> groups;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<CPUGroup> group = groups[name].lock();
+    if (group == nullptr) {
+      group = std::make_shared<CPUGroup>(world_size);
+      groups[name] = group;
+    }
+    CHECK_EQ(group->world_size, world_size)
+        << "ValueError: The group " << name << " has a world size of " << group->world_size;
+    CHECK(!group->joined[rank]) << "ValueError: The rank " << rank << " of the group " << name
+                                << " has joined already";
+    group->joined[rank] = true;
+    return group;
+  }
+
+  /*! \brief The number of workers. */
+  const int world_size;
+  /*! \brief The buffer each worker works on in the running collective, by rank. */
+  std::vector<char*> buffers;
+  /*! \brief Whether each rank has joined the group. */
+  std::vector<bool> joined;
+
+ private:
+  /*! \brief The mutex guarding the barrier. */
+  std::mutex mutex_;
+  /*! \brief The condition variable notified when all the workers reach the barrier. */
+  std::condition_variable cv_;
+  /*! \brief The number of workers waiting at the barrier. */
+  int num_arrived_{0};
+  /*! \brief The number of times all the workers have reached the barrier. */
+  int64_t generation_{0};
+};
+
+/*!
+ * \brief The communicator of a worker on CPU, which runs the ring algorithms on the buffers of the
+ *  workers shared in memory.
+ *
+ *  The buffers of the workers are split into world_size chunks. Each step of a ring, a worker reads
+ *  a chunk from the buffer of the previous rank into its own, while the next rank reads another
+ *  chunk of its buffer, and the steps are separated by barriers. Reducing takes world_size - 1
+ *  steps, after which chunk i of rank i is the reduction of all the chunks i, and gathering takes
+ *  another world_size - 1 steps to pass the complete chunks around.
+ */
+class CPUCommunicatorObj : public CommunicatorObj {
+ public:
+  CPUCommunicatorObj(const std::string& group, int world_size, int rank, Device device) {
+    this->world_size = world_size;
+    this->rank = rank;
+    this->device = device;
+    group_ = CPUGroup::Join(group, world_size, rank);
+    group_->Barrier();
+  }
+
+  void AllReduce(const DLTensor* send, DLTensor* recv, ReduceKind kind) final {
+    int64_t num_elems = NumElements(send);
+    CHECK_EQ(NumElements(recv), num_elems) << "ValueError: The allreduce result has another size";
+    if (DataPtr(recv) != DataPtr(send)) {
+      std::memcpy(DataPtr(recv), DataPtr(send), num_elems * ElementBytes(send));
+    }
+    Publish(DataPtr(recv));
+    ReduceRing(num_elems, send->dtype, kind);
+    GatherRing(num_elems, ElementBytes(send));
+  }
+
+  void AllGather(const DLTensor* send, DLTensor* recv) final {
+    int64_t num_elems = NumElements(send);
+    CHECK_EQ(NumElements(recv), num_elems * world_size)
+        << "ValueError: The allgather result is expected to be " << world_size
+        << " times as large as the input";
+    int64_t elem_bytes = ElementBytes(send);
+    std::memcpy(DataPtr(recv) + rank * num_elems * elem_bytes, DataPtr(send),
+                num_elems * elem_bytes);
+    Publish(DataPtr(recv));
+    GatherRing(num_elems * world_size, elem_bytes);
+  }
+
+  void ReduceScatter(const DLTensor* send, DLTensor* recv, ReduceKind kind) final {
+    int64_t num_elems = NumElements(send);
+    CHECK_EQ(num_elems % world_size, 0)
+        << "ValueError: The reduce_scatter input is expected to split into " << world_size
+        << " parts evenly";
+    CHECK_EQ(NumElements(recv) * world_size, num_elems)
+        << "ValueError: The reduce_scatter result is expected to be " << world_size
+        << " times smaller than the input";
+    int64_t elem_bytes = ElementBytes(send);
+    scratch_.resize(num_elems * elem_bytes);
+    std::memcpy(scratch_.data(), DataPtr(send), num_elems * elem_bytes);
+    Publish(scratch_.data());
+    ReduceRing(num_elems, send->dtype, kind);
+    std::memcpy(DataPtr(recv), scratch_.data() + ChunkBegin(rank, num_elems) * elem_bytes,
+                (num_elems / world_size) * elem_bytes);
+  }
+
+ private:
+  /*! \brief The rank i steps after this one around the ring, or the chunk of that index. */
+  int Ring(int i) const { return ((rank + i) % world_size + world_size) % world_size; }
+  /*! \brief The first element of a chunk of a buffer of num_elems elements. */
+  int64_t ChunkBegin(int chunk, int64_t num_elems) const {
+    return chunk * num_elems / world_size;
+  }
+
+  /*! \brief Hand the buffer of this worker to the others for the coming collective. */
+  void Publish(char* buffer) {
+    group_->buffers[rank] = buffer;
+    group_->Barrier();
+  }
+
+  /*! \brief Reduce chunk i of the buffers into the buffer of rank i. */
+  void ReduceRing(int64_t num_elems, DLDataType dtype, ReduceKind kind) {
+    int64_t elem_bytes = (dtype.bits * dtype.lanes + 7) / 8;
+    char* prev = group_->buffers[Ring(-1)];
+    char* self = group_->buffers[rank];
+    for (int step = 0; step < world_size - 1; ++step) {
+      int chunk = Ring(-step - 2);
+      int64_t begin = ChunkBegin(chunk, num_elems);
+      int64_t end = ChunkBegin(chunk + 1, num_elems);
+      Reduce(self + begin * elem_bytes, prev + begin * elem_bytes, end - begin, dtype, kind);
+      group_->Barrier();
+    }
+  }
+
+  /*! \brief Copy chunk i of the buffer of rank i into the buffers of all the workers. */
+  void GatherRing(int64_t num_elems, int64_t elem_bytes) {
+    char* prev = group_->buffers[Ring(-1)];
+    char* self = group_->buffers[rank];
+    for (int step = 0; step < world_size - 1; ++step) {
+      int chunk = Ring(-step - 1);
+      int64_t begin = ChunkBegin(chunk, num_elems);
+      int64_t end = ChunkBegin(chunk + 1, num_elems);
+      std::memcpy(self + begin * elem_bytes, prev + begin * elem_bytes, (end - begin) * elem_bytes);
+      group_->Barrier();
+    }
+  }
+
+  /*! \brief The group of the workers. */
+  std::shared_ptr<CPUGroup> group_;
+  /*! \brief The buffer reduce_scatter works on. */
+  std::vector<char> scratch_;
+};
+
+TVM_REGISTER_GLOBAL("vm.ccl.create_communicator.cpu")
+    .set_body_typed([](String group, int world_size, int rank, Device device) {
+      return Communicator(make_object<CPUCommunicatorObj>(group, world_size, rank, device));
+    });
+
+/*!
+ * \brief Get the communicator of a VM for a collective on a tensor.
+ * \param vm The VM.
+ * \param data The input of the collective.
+ * \return The communicator.
+ */
+static Communicator GetCommunicator(VirtualMachine* vm, const NDArray& data) {
+  CHECK(vm->communicator.defined())
+      << "ValueError: The collectives require the VM to join a group of workers, by "
+         "set_ccl_config before vm_initialization";
+  const Device& device = vm->communicator->device;
+  CHECK(data->device.device_type == device.device_type &&
+        data->device.device_id == device.device_id)
+      << "ValueError: The collectives of the group run on " << device << ", but the tensor is on "
+      << data->device;
+  CHECK(data.IsContiguous()) << "ValueError: The collectives require contiguous tensors";
+  return vm->communicator;
+}
+
+/*! \brief Allocate the result of a collective on the device of the communicator. */
+static NDArray AllocResult(VirtualMachine* vm, const NDArray& data, std::vector<int64_t> shape) {
+  const Device& device = vm->communicator->device;
+  for (size_t i = 0; i < vm->devices.size(); ++i) {
+    if (vm->devices[i].device_type == device.device_type &&
+        vm->devices[i].device_id == device.device_id) {
+      return vm->allocators[i]->Empty(shape, data.DataType(), device);
+    }
+  }
+  return NDArray::Empty(ShapeTuple(shape), data.DataType(), device);
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.allreduce")
+    .set_body_typed([](void* vm_ptr, NDArray data, String kind) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      Communicator comm = GetCommunicator(vm, data);
+      std::vector<int64_t> shape(data.Shape().begin(), data.Shape().end());
+      NDArray result = AllocResult(vm, data, shape);
+      comm->AllReduce(data.operator->(), const_cast<DLTensor*>(result.operator->()),
+                      ParseReduceKind(kind));
+      return result;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.allgather").set_body_typed([](void* vm_ptr, NDArray data) {
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  Communicator comm = GetCommunicator(vm, data);
+  CHECK_GE(data->ndim, 1) << "ValueError: allgather concatenates along the first dimension";
+  std::vector<int64_t> shape(data.Shape().begin(), data.Shape().end());
+  shape[0] *= comm->world_size;
+  NDArray result = AllocResult(vm, data, shape);
+  comm->AllGather(data.operator->(), const_cast<DLTensor*>(result.operator->()));
+  return result;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.reduce_scatter")
+    .set_body_typed([](void* vm_ptr, NDArray data, String kind) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      Communicator comm = GetCommunicator(vm, data);
+      CHECK_GE(data->ndim, 1) << "ValueError: reduce_scatter splits the first dimension";
+      CHECK_EQ(data->shape[0] % comm->world_size, 0)
+          << "ValueError: reduce_scatter splits the first dimension into " << comm->world_size
+          << " parts evenly, but the input has " << data->shape[0] << " rows";
+      std::vector<int64_t> shape(data.Shape().begin(), data.Shape().end());
+      shape[0] /= comm->world_size;
+      NDArray result = AllocResult(vm, data, shape);
+      comm->ReduceScatter(data.operator->(), const_cast<DLTensor*>(result.operator->()),
+                          ParseReduceKind(kind));
+      return result;
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
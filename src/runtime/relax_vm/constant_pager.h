@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file tvm/runtime/relax_vm/constant_pager.h
+ * \brief Upload the constants of the relax VM to the device on demand, within a memory budget.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_CONSTANT_PAGER_H_
+#define TVM_RUNTIME_RELAX_VM_CONSTANT_PAGER_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <list>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Keep the NDArray constants of an executable resident on a device on demand.
+ *
+ * A constant is uploaded on its first use and stays resident until the
+ * least recently used constants have to be evicted to fit the budget.
+ * Prefetched constants are uploaded on a copy stream of their own, so that
+ * the upload overlaps with the kernels issued in the meantime.
+ *
+ * \note Not thread-safe, each VM owns its own pager.
+ */
+class ConstantPager {
+ public:
+  /*!
+   * \param host_constants The constant pool, with NDArrays resident on the host.
+   * \param dev The device to upload the constants to.
+   * \param budget The budget in bytes of the device copies of the constants.
+   */
+  ConstantPager(const std::vector<TVMRetValue>* host_constants, Device dev, size_t budget)
+      : host_constants_(host_constants), dev_(dev), budget_(budget) {
+    entries_.resize(host_constants->size());
+  }
+
+  ~ConstantPager() {
+    if (copy_stream_ != nullptr) {
+      DeviceAPI* api = DeviceAPI::Get(dev_);
+      api->StreamSync(dev_, copy_stream_);
+      api->FreeStream(dev_, copy_stream_);
+    }
+  }
+
+  /*! \brief Start the next call, the constants it uses are not evicted until the following one. */
+  void BeginCall() { ++epoch_; }
+
+  /*!
+   * \brief Get the device copy of a constant, uploading it if it is not resident.
+   * \param index The index of the constant in the pool.
+   * \return The device copy.
+   */
+  const NDArray& Get(Index index) {
+    Entry& entry = entries_[index];
+    if (!entry.array.defined()) {
+      Upload(index, nullptr);
+    } else if (entry.pending) {
+      DeviceAPI::Get(dev_)->StreamSync(dev_, copy_stream_);
+      for (Entry& e : entries_) e.pending = false;
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+    } else {
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+    }
+    entry.epoch = epoch_;
+    return entry.array;
+  }
+
+  /*!
+   * \brief Start uploading a constant ahead of its use.
+   * \param index The index of the constant in the pool.
+   */
+  void Prefetch(Index index) {
+    if (entries_[index].array.defined()) return;
+    if (copy_stream_ == nullptr) {
+      copy_stream_ = DeviceAPI::Get(dev_)->CreateStream(dev_);
+    }
+    Upload(index, copy_stream_);
+    entries_[index].pending = copy_stream_ != nullptr;
+  }
+
+  /*! \return The bytes of device memory held by the resident constants. */
+  size_t resident_bytes() const { return resident_bytes_; }
+
+ private:
+  /*! \brief The state of a constant. */
+  struct Entry {
+    /*! \brief The device copy, undefined when not resident. */
+    NDArray array;
+    /*! \brief Whether the upload may still be in flight on the copy stream. */
+    bool pending{false};
+    /*! \brief The last call which used the constant. */
+    uint64_t epoch{0};
+    /*! \brief The position in the LRU list. */
+    std::list<Index>::iterator lru_pos;
+  };
+
+  void Upload(Index index, TVMStreamHandle stream) {
+    NDArray host = (*host_constants_)[index].operator NDArray();
+    size_t nbytes = GetDataSize(*host.operator->());
+    EvictFor(nbytes);
+    Entry& entry = entries_[index];
+    entry.array = NDArray::Empty(host.Shape(), host.DataType(), dev_);
+    NDArray::CopyFromTo(host.operator->(), const_cast<DLTensor*>(entry.array.operator->()),
+                        stream);
+    lru_.push_front(index);
+    entry.lru_pos = lru_.begin();
+    entry.epoch = epoch_;
+    resident_bytes_ += nbytes;
+  }
+
+  /*! \brief Evict the least recently used constants until the given bytes fit the budget. */
+  void EvictFor(size_t nbytes) {
+    bool synced = false;
+    while (!lru_.empty() && resident_bytes_ + nbytes > budget_) {
+      Entry& victim = entries_[lru_.back()];
+      // The constants of the current call stay, the budget is exceeded if they do not fit.
+      if (victim.epoch == epoch_) break;
+      if (victim.pending && !synced) {
+        // Do not hand the memory back while an upload may still write into it.
+        DeviceAPI::Get(dev_)->StreamSync(dev_, copy_stream_);
+        synced = true;
+      }
+      resident_bytes_ -= GetDataSize(*victim.array.operator->());
+      victim.array = NDArray();
+      victim.pending = false;
+      lru_.pop_back();
+    }
+  }
+
+  /*! \brief The constant pool on the host. */
+  const std::vector<TVMRetValue>* host_constants_;
+  /*! \brief The device the constants are uploaded to. */
+  Device dev_;
+  /*! \brief The device memory budget in bytes. */
+  size_t budget_;
+  /*! \brief The bytes held by the resident constants. */
+  size_t resident_bytes_{0};
+  /*! \brief The state of each constant of the pool. */
+  std::vector<Entry> entries_;
+  /*! \brief The resident constants, most recently used first. */
+  std::list<Index> lru_;
+  /*! \brief The current call. */
+  uint64_t epoch_{1};
+  /*! \brief The stream of the prefetches, created on the first one. */
+  TVMStreamHandle copy_stream_{nullptr};
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_CONSTANT_PAGER_H_
@@ -22,11 +22,18 @@
  */
 
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/relax_vm/executable.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
 #include "../file_utils.h"
@@ -38,6 +45,18 @@ namespace relax_vm {
 /*! \brief The magic number for the serialized VM bytecode file  */
 constexpr uint64_t kTVMVMBytecodeMagic = 0xD225DE2F4214151D;
 
+/*! \brief The magic number for the executable files with a constant blob. */
+constexpr uint64_t kTVMVMConstantBlobMagic = 0xD225DE2F4214151E;
+
+/*! \brief The version of the file format with a constant blob. */
+constexpr uint64_t kTVMVMConstantBlobFormatVersion = 1;
+
+/*! \brief The alignment of the constant blob in the file, so that it can be mapped. */
+constexpr uint64_t kConstantBlobAlignment = 4096;
+
+/*! \brief The size of the chunks the constants are uploaded to the devices by. */
+constexpr size_t kConstantUploadChunkSize = 64 << 20;
+
 /*! \brief Possible types in the constant pool */
 enum ConstantType : int {
   kNDArray = 0,
@@ -45,8 +64,44 @@ enum ConstantType : int {
   kShapeTuple = 2,
   kString = 3,
   kInt = 4,
+  kNDArrayRef = 5,
 };
 
+inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+/*!
+ * \brief Copy a host constant to a device, in chunks staged through pinned memory when the
+ *  device supports it, so that the driver does not stage the whole pageable buffer itself.
+ */
+NDArray UploadConstant(const NDArray& src, Device dev) {
+  NDArray dst = NDArray::Empty(src.Shape(), src.DataType(), dev);
+  size_t nbytes = GetDataSize(*src.operator->());
+  Device pinned_dev{kDLCUDAHost, 0};
+  DeviceAPI* pinned_api = nullptr;
+  if (src->device.device_type == kDLCPU && dev.device_type == kDLCUDA &&
+      nbytes > kConstantUploadChunkSize) {
+    pinned_api = DeviceAPI::Get(pinned_dev, true);
+  }
+  if (pinned_api == nullptr) {
+    dst.CopyFrom(src);
+    return dst;
+  }
+  DLDataType byte_type{kDLUInt, 8, 1};
+  void* staging =
+      pinned_api->AllocDataSpace(pinned_dev, kConstantUploadChunkSize, kAllocAlignment, byte_type);
+  for (size_t offset = 0; offset < nbytes; offset += kConstantUploadChunkSize) {
+    int64_t chunk = static_cast<int64_t>(std::min(kConstantUploadChunkSize, nbytes - offset));
+    std::memcpy(staging, static_cast<const char*>(src->data) + src->byte_offset + offset, chunk);
+    DLTensor from{staging, pinned_dev, 1, byte_type, &chunk, nullptr, 0};
+    DLTensor to{dst->data, dev, 1, byte_type, &chunk, nullptr, offset};
+    DeviceAPI::Get(dev)->CopyDataFromTo(&from, &to, nullptr);
+  }
+  pinned_api->FreeDataSpace(pinned_dev, staging);
+  return dst;
+}
+
 #define STREAM_CHECK(val, section)                                          \
   ICHECK(val) << "Invalid VM file format in the " << section << " section." \
               << "\n";
@@ -69,6 +124,11 @@ PackedFunc Executable::GetFunction(const std::string& name, const ObjectPtr<Obje
   } else if (name == "as_python") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->AsPython(); });
+  } else if (name == "get_memory_footprint") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args.size() > 0 ? args[0].operator std::string() : "";
+      *rv = this->GetMemoryFootprint(func_name);
+    });
   } else if (name == "vm_load_executable") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       ObjectPtr<VirtualMachine> vm = make_object<VirtualMachine>();
@@ -80,6 +140,73 @@ PackedFunc Executable::GetFunction(const std::string& name, const ObjectPtr<Obje
   return nullptr;
 }
 
+std::shared_ptr<const std::vector<TVMRetValue>> Executable::GetDeviceConstants(Device dev) {
+  std::lock_guard<std::mutex> lock(device_constants_mutex_);
+  for (const auto& it : device_constants_) {
+    if (it.first.device_type == dev.device_type && it.first.device_id == dev.device_id) {
+      return it.second;
+    }
+  }
+  auto pool = std::make_shared<std::vector<TVMRetValue>>();
+  pool->reserve(constants.size());
+  for (const auto& constant : constants) {
+    if (constant.type_code() != kTVMNDArrayHandle) {
+      pool->push_back(constant);
+      continue;
+    }
+    NDArray nd_array = constant.operator NDArray();
+    if (nd_array->device.device_type == dev.device_type &&
+        nd_array->device.device_id == dev.device_id) {
+      pool->push_back(constant);
+    } else {
+      TVMRetValue copied;
+      copied = UploadConstant(nd_array, dev);
+      pool->push_back(copied);
+    }
+  }
+  device_constants_.emplace_back(dev, pool);
+  return pool;
+}
+
+Map<String, ShapeTuple> Executable::GetMemoryFootprint(const std::string& func_name) const {
+  std::vector<const VMFunction*> funcs;
+  if (func_name.empty()) {
+    for (const VMFunction& func : global_funcs) {
+      funcs.push_back(&func);
+    }
+  } else {
+    auto it = global_map.find(func_name);
+    CHECK(it != global_map.end()) << "ValueError: Unknown function: " << func_name;
+    funcs.push_back(&global_funcs[it->second]);
+  }
+  // The functions do not run at the same time, so a device needs the most any of them plans.
+  std::map<Index, std::pair<int64_t, int64_t>> devices;
+  for (const VMFunction* func : funcs) {
+    for (const VMMemoryFootprint& footprint : func->memory) {
+      std::pair<int64_t, int64_t>& device = devices[footprint.device_index];
+      device.first = std::max(device.first, footprint.static_bytes);
+      device.second = std::max(device.second, footprint.num_dynamic_allocs);
+    }
+  }
+  std::vector<int64_t> device_index, activation_bytes, num_dynamic_allocs;
+  for (const auto& kv : devices) {
+    device_index.push_back(kv.first);
+    activation_bytes.push_back(kv.second.first);
+    num_dynamic_allocs.push_back(kv.second.second);
+  }
+  int64_t constant_bytes = 0;
+  for (const TVMRetValue& constant : constants) {
+    if (constant.type_code() == kTVMNDArrayHandle) {
+      constant_bytes += GetDataSize(*constant.operator NDArray().operator->());
+    }
+  }
+  return {{"device_index", ShapeTuple(device_index)},
+          {"activation_bytes", ShapeTuple(activation_bytes)},
+          {"num_dynamic_allocs", ShapeTuple(num_dynamic_allocs)},
+          {"constant_bytes", ShapeTuple({constant_bytes})},
+          {"workspace_bytes", ShapeTuple({workspace_bytes})}};
+}
+
 std::string Executable::Stats() const {
   std::ostringstream oss;
   oss << "Relax VM executable statistics:" << std::endl;
@@ -151,6 +278,20 @@ std::string Executable::Stats() const {
   }
   oss << "]" << std::endl;
 
+  // Get the planned memory, in bytes.
+  Map<String, ShapeTuple> footprint = GetMemoryFootprint("");
+  oss << "  Memory (bytes): constants " << footprint["constant_bytes"][0] << ", workspace "
+      << footprint["workspace_bytes"][0] << ", activations [";
+  ShapeTuple device_index = footprint["device_index"];
+  for (size_t i = 0; i < device_index.size(); ++i) {
+    oss << "device " << device_index[i] << ": " << footprint["activation_bytes"][i] << " (+"
+        << footprint["num_dynamic_allocs"][i] << " dynamic), ";
+  }
+  if (!device_index.empty()) {
+    oss.seekp(-2, oss.cur);
+  }
+  oss << "]" << std::endl;
+
   return oss.str();
 }
 
@@ -183,6 +324,29 @@ Instruction Executable::GetInstruction(Index i) const {
       Index false_offset = instr_data[offset + 2];
       return Instruction::If(cond, false_offset);
     }
+    case Opcode::MakeTuple: {
+      RegName dst = instr_data[offset + 1];
+      Index num_fields = instr_data[offset + 2];
+      ExecWord* fields = const_cast<ExecWord*>(&instr_data[offset + 3]);
+      return Instruction::MakeTuple(num_fields, reinterpret_cast<Instruction::Arg*>(fields), dst);
+    }
+    case Opcode::TupleGetItem: {
+      RegName dst = instr_data[offset + 1];
+      RegName tuple = instr_data[offset + 2];
+      Index field_index = instr_data[offset + 3];
+      return Instruction::TupleGetItem(tuple, field_index, dst);
+    }
+    case Opcode::ShapeOf: {
+      RegName dst = instr_data[offset + 1];
+      RegName tensor = instr_data[offset + 2];
+      return Instruction::ShapeOf(tensor, dst);
+    }
+    case Opcode::InvokeClosure: {
+      RegName dst = instr_data[offset + 1];
+      Index num_args = instr_data[offset + 2];
+      ExecWord* args = const_cast<ExecWord*>(&instr_data[offset + 3]);
+      return Instruction::InvokeClosure(num_args, reinterpret_cast<Instruction::Arg*>(args), dst);
+    }
     default:
       LOG(FATAL) << "should never hit this case: " << static_cast<int>(op);
       break;
@@ -209,7 +373,7 @@ void LoadHeader(dmlc::Stream* strm) {
   STREAM_CHECK(version == TVM_VERSION, "version");
 }
 
-void Executable::SaveToBinary(dmlc::Stream* stream) {
+std::string Executable::SaveSections(std::vector<NDArray>* blob) {
   std::string code;
   // Initialize the stream object.
   dmlc::MemoryStringStream strm(&code);
@@ -221,7 +385,7 @@ void Executable::SaveToBinary(dmlc::Stream* stream) {
   SaveGlobalSection(&strm);
 
   // Constant section.
-  SaveConstantSection(&strm);
+  SaveConstantSection(&strm, blob);
 
   // Packedfunc names section.
   SavePackedFuncNames(&strm);
@@ -229,51 +393,104 @@ void Executable::SaveToBinary(dmlc::Stream* stream) {
   // Code section.
   SaveCodeSection(&strm);
 
-  stream->Write(code);
+  // Memory section.
+  SaveMemorySection(&strm);
+
+  return code;
 }
 
+void Executable::SaveToBinary(dmlc::Stream* stream) { stream->Write(SaveSections(nullptr)); }
+
 void Executable::SaveToFile(const std::string& file_name, const std::string& format) {
-  std::string data;
-  dmlc::MemoryStringStream writer(&data);
-  dmlc::SeekStream* strm = &writer;
-  Executable::SaveToBinary(strm);
-  runtime::SaveBinaryToFile(file_name, data);
+  // File layout: magic, format version, blob offset, the sections, then the page-aligned blob
+  // with the payload of every NDArray constant.
+  std::vector<NDArray> blob;
+  std::string code = SaveSections(&blob);
+  std::string head;
+  dmlc::MemoryStringStream writer(&head);
+  dmlc::Stream* strm = &writer;
+  uint64_t blob_offset = AlignUp(sizeof(uint64_t) * 4 + code.size(), kConstantBlobAlignment);
+  strm->Write(kTVMVMConstantBlobMagic);
+  strm->Write(kTVMVMConstantBlobFormatVersion);
+  strm->Write(blob_offset);
+  strm->Write(code);
+
+  std::ofstream fs(file_name, std::ios::out | std::ios::binary);
+  ICHECK(!fs.fail()) << "Cannot open " << file_name;
+  fs.write(head.data(), head.size());
+  fs.write(std::string(blob_offset - head.size(), '\0').data(), blob_offset - head.size());
+  // Lay out the arrays the same way as SaveConstantSection refers to them.
+  uint64_t blob_size = 0;
+  for (const NDArray& array : blob) {
+    uint64_t offset = AlignUp(blob_size, kAllocAlignment);
+    fs.write(std::string(offset - blob_size, '\0').data(), offset - blob_size);
+    NDArray host = array->device.device_type == kDLCPU ? array : array.CopyTo(Device{kDLCPU, 0});
+    size_t nbytes = GetDataSize(*host.operator->());
+    fs.write(static_cast<const char*>(host->data) + host->byte_offset, nbytes);
+    blob_size = offset + nbytes;
+  }
+  ICHECK(!fs.fail()) << "Failed to write " << file_name;
 }
 
-Module Executable::LoadFromBinary(void* stream) {
-  std::string code;
-  static_cast<dmlc::Stream*>(stream)->Read(&code);
-  dmlc::MemoryStringStream strm(&code);
-
+Module Executable::LoadSections(dmlc::Stream* strm, const std::shared_ptr<MappedFile>& file,
+                                uint64_t blob_offset) {
   ObjectPtr<Executable> exec = make_object<Executable>();
 
   // Load header.
-  LoadHeader(&strm);
+  LoadHeader(strm);
 
   // Global section.
-  exec->LoadGlobalSection(&strm);
+  exec->LoadGlobalSection(strm);
 
   // Constant section.
-  exec->LoadConstantSection(&strm);
+  exec->LoadConstantSection(strm, file, blob_offset);
 
   // Packedfunc names section.
-  exec->LoadPackedFuncNames(&strm);
+  exec->LoadPackedFuncNames(strm);
 
   // Code section.
-  exec->LoadCodeSection(&strm);
+  exec->LoadCodeSection(strm);
+
+  // Memory section.
+  exec->LoadMemorySection(strm);
 
   return Module(exec);
 }
 
+Module Executable::LoadFromBinary(void* stream) {
+  std::string code;
+  static_cast<dmlc::Stream*>(stream)->Read(&code);
+  dmlc::MemoryStringStream strm(&code);
+  return LoadSections(&strm, nullptr, 0);
+}
+
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_relax.Executable")
     .set_body_typed(Executable::LoadFromBinary);
 
 Module Executable::LoadFromFile(const std::string& file_name) {
-  std::string data;
-  runtime::LoadBinaryFromFile(file_name, &data);
-  dmlc::MemoryStringStream reader(&data);
-  dmlc::Stream* strm = &reader;
-  return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  auto file = std::make_shared<MappedFile>(file_name);
+  uint64_t magic = 0;
+  if (file->size() >= sizeof(magic)) {
+    std::memcpy(&magic, file->data(), sizeof(magic));
+  }
+  if (magic != kTVMVMConstantBlobMagic) {
+    // A file written without a constant blob.
+    dmlc::MemoryFixedSizeStream reader(file->data(), file->size());
+    dmlc::Stream* strm = &reader;
+    return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  }
+  dmlc::MemoryFixedSizeStream reader(file->data(), file->size());
+  dmlc::Stream* head = &reader;
+  uint64_t version, blob_offset, code_size;
+  STREAM_CHECK(head->Read(&magic), "header");
+  STREAM_CHECK(head->Read(&version), "header");
+  STREAM_CHECK(version == kTVMVMConstantBlobFormatVersion, "version");
+  STREAM_CHECK(head->Read(&blob_offset), "header");
+  STREAM_CHECK(head->Read(&code_size), "header");
+  size_t code_begin = sizeof(uint64_t) * 4;
+  STREAM_CHECK(code_begin + code_size <= blob_offset && blob_offset <= file->size(), "header");
+  dmlc::MemoryFixedSizeStream strm(file->data() + code_begin, code_size);
+  return LoadSections(&strm, file, blob_offset);
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_relax.Executable")
@@ -304,10 +521,22 @@ void Executable::SaveGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::SaveConstantSection(dmlc::Stream* strm) {
+void Executable::SaveConstantSection(dmlc::Stream* strm, std::vector<NDArray>* blob) {
   strm->Write(static_cast<uint64_t>(this->constants.size()));
+  uint64_t blob_size = 0;
   for (const auto& it : this->constants) {
-    if (it.IsObjectRef<runtime::NDArray>()) {
+    if (it.IsObjectRef<runtime::NDArray>() && blob != nullptr) {
+      NDArray array = it.operator NDArray();
+      uint64_t offset = AlignUp(blob_size, kAllocAlignment);
+      uint64_t nbytes = GetDataSize(*array.operator->());
+      strm->Write(ConstantType::kNDArrayRef);
+      strm->Write(array.DataType().operator DLDataType());
+      strm->Write(std::vector<int64_t>(array.Shape().begin(), array.Shape().end()));
+      strm->Write(offset);
+      strm->Write(nbytes);
+      blob->push_back(array);
+      blob_size = offset + nbytes;
+    } else if (it.IsObjectRef<runtime::NDArray>()) {
       strm->Write(ConstantType::kNDArray);
       runtime::SaveDLTensor(strm, it.operator DLTensor*());
     } else if (it.IsObjectRef<ShapeTuple>()) {
@@ -359,7 +588,8 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+void Executable::LoadConstantSection(dmlc::Stream* strm, const std::shared_ptr<MappedFile>& file,
+                                     uint64_t blob_offset) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
@@ -376,6 +606,18 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
       TVMRetValue cell;
       cell = ndarray;
       this->constants.push_back(cell);
+    } else if (constant_type == ConstantType::kNDArrayRef) {
+      std::vector<int64_t> shape;
+      uint64_t offset, nbytes;
+      STREAM_CHECK(strm->Read(&dtype), "constant");
+      STREAM_CHECK(strm->Read(&shape), "constant");
+      STREAM_CHECK(strm->Read(&offset), "constant");
+      STREAM_CHECK(strm->Read(&nbytes), "constant");
+      ICHECK(file != nullptr) << "The constant blob is only supported when loading from a file";
+      STREAM_CHECK(blob_offset + offset + nbytes <= file->size(), "constant");
+      TVMRetValue cell;
+      cell = MappedFile::View(file, blob_offset + offset, ShapeTuple(shape), dtype);
+      this->constants.push_back(cell);
     } else if (constant_type == ConstantType::kShapeTuple) {
       uint64_t size;
       strm->Read(&size);
@@ -426,6 +668,35 @@ void Executable::LoadCodeSection(dmlc::Stream* strm) {
   STREAM_CHECK(strm->Read(&(this->instr_data)), "instr data");
 }
 
+void Executable::SaveMemorySection(dmlc::Stream* strm) {
+  strm->Write(this->workspace_bytes);
+  for (const auto& func : this->global_funcs) {
+    std::vector<int64_t> memory;
+    for (const VMMemoryFootprint& footprint : func.memory) {
+      memory.push_back(footprint.device_index);
+      memory.push_back(footprint.static_bytes);
+      memory.push_back(footprint.num_dynamic_allocs);
+    }
+    strm->Write(memory);
+  }
+}
+
+void Executable::LoadMemorySection(dmlc::Stream* strm) {
+  // The executables saved before the memory section was added end with the code section.
+  if (!strm->Read(&(this->workspace_bytes))) {
+    this->workspace_bytes = -1;
+    return;
+  }
+  for (auto& func : this->global_funcs) {
+    std::vector<int64_t> memory;
+    STREAM_CHECK(strm->Read(&memory), "memory");
+    STREAM_CHECK(memory.size() % 3 == 0, "memory");
+    for (size_t i = 0; i < memory.size(); i += 3) {
+      func.memory.push_back(VMMemoryFootprint{memory[i], memory[i + 1], memory[i + 2]});
+    }
+  }
+}
+
 template <typename T>
 std::string StrJoin(T* items, int offset, int cnt, std::string delim = ", ",
                     std::function<std::string(T)> repr = std::to_string) {
@@ -517,6 +788,28 @@ String Executable::AsText() const {
              << instr.false_offset << "\n";
           break;
         }
+        case Opcode::MakeTuple: {
+          os << std::setw(6) << std::left << "tuple" << " in: " << std::setw(12) << std::left
+             << StrJoin<Instruction::Arg>(instr.args, 0, instr.num_args, ", ", InstrArgToStr)
+             << " dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::TupleGetItem: {
+          os << std::setw(6) << std::left << "get" << RegNameToStr(instr.tuple) << "["
+             << instr.field_index << "] dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::ShapeOf: {
+          os << std::setw(6) << std::left << "shape" << RegNameToStr(instr.tensor)
+             << " dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::InvokeClosure: {
+          os << std::setw(6) << std::left << "invoke" << " in: " << std::setw(12) << std::left
+             << StrJoin<Instruction::Arg>(instr.args, 0, instr.num_args, ", ", InstrArgToStr)
+             << " dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
         default:
           LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
           break;
@@ -562,6 +855,32 @@ String Executable::AsPython() const {
           os << "    ib.emit_if(ib.r(" << instr.cond << "), " << instr.false_offset << ")\n";
           break;
         }
+        case Opcode::MakeTuple: {
+          os << "    ib.emit_tuple(["
+             << StrJoin<Instruction::Arg>(instr.args, 0, instr.num_args, ", ", InstrArgToPyStr)
+             << "], dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::TupleGetItem: {
+          os << "    ib.emit_tuple_get_item(ib.r(" << instr.tuple << "), " << instr.field_index
+             << ", dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::ShapeOf: {
+          os << "    ib.emit_shape_of(ib.r(" << instr.tensor << "), dst=ib.r(" << instr.dst
+             << "))\n";
+          break;
+        }
+        case Opcode::InvokeClosure: {
+          os << "    ib.emit_invoke_closure("
+             << InstrArgToPyStr(instr.args[0]) << ", args=["
+             << StrJoin<Instruction::Arg>(instr.args, 1, instr.num_args - 1, ", ",
+                                          InstrArgToPyStr)
+             << "]";
+          if (instr.dst != Instruction::kVoidArg) os << ", dst=ib.r(" << instr.dst << ")";
+          os << ")\n";
+          break;
+        }
         default:
           LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
           break;
@@ -21,13 +21,17 @@
  * \file tvm/runtime/relax_vm/memory_manager.cc
  * \brief Allocate and manage memory for the Relay VM.
  */
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/memory_manager.h>
 
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
+#include "scoped_allocator.h"
+#include "size_class_allocator.h"
 
 namespace tvm {
 namespace runtime {
@@ -37,9 +41,10 @@ static void BufferDeleter(Object* obj) {
   auto* ptr = static_cast<runtime::NDArray::Container*>(obj);
   ICHECK(ptr->manager_ctx != nullptr);
   Buffer* buffer = reinterpret_cast<Buffer*>(ptr->manager_ctx);
-  MemoryManager::GetAllocator(buffer->device)->Free(*(buffer));
+  MemoryManager::GetAllocator(buffer->device, buffer->scope)->Free(*(buffer));
   delete buffer;
-  delete ptr;
+  ptr->runtime::NDArray::Container::~Container();
+  SmallObjAllocator::Free(ptr, sizeof(runtime::NDArray::Container));
 }
 
 void StorageObj::Deleter(Object* obj) {
@@ -55,7 +60,8 @@ void StorageObj::Deleter(Object* obj) {
   // reference count from allocation.
   StorageObj* storage = reinterpret_cast<StorageObj*>(ptr->manager_ctx);
   storage->DecRef();
-  delete ptr;
+  ptr->runtime::NDArray::Container::~Container();
+  SmallObjAllocator::Free(ptr, sizeof(runtime::NDArray::Container));
 }
 
 inline void VerifyDataType(DLDataType dtype) {
@@ -81,7 +87,8 @@ runtime::NDArray StorageObj::AllocNDArray(uint64_t offset, ShapeTuple shape, DLD
 
   // critical zone: allocate header, cannot throw
   runtime::NDArray::Container* container =
-      new runtime::NDArray::Container(nullptr, shape, dtype, this->buffer.device);
+      new (SmallObjAllocator::Alloc(sizeof(runtime::NDArray::Container)))
+          runtime::NDArray::Container(nullptr, shape, dtype, this->buffer.device);
 
   container->SetDeleter(StorageObj::Deleter);
   size_t needed_size = runtime::GetDataSize(container->dl_tensor);
@@ -117,7 +124,24 @@ MemoryManager* MemoryManager::Global() {
   return inst;
 }
 
+Device MemoryManager::PinnedHostDevice(Device dev) {
+  switch (dev.device_type) {
+    case kDLCPU:
+    case kDLCUDAHost:
+      return dev;
+    case kDLCUDA:
+      return Device{kDLCUDAHost, dev.device_id};
+    default:
+      LOG(FATAL) << "ValueError: Page-locked host memory is not supported for "
+                 << runtime::DeviceName(dev.device_type);
+  }
+  return dev;
+}
+
 Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
+  if (type == kPinnedHost) {
+    dev = PinnedHostDevice(dev);
+  }
   MemoryManager* m = MemoryManager::Global();
   std::lock_guard<std::mutex> lock(m->mutex_);
   if (m->allocators_.find(dev) == m->allocators_.end()) {
@@ -135,6 +159,18 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
         alloc.reset(new PooledAllocator(dev));
         break;
       }
+      case kSizeClass: {
+        DLOG(INFO) << "New size-class allocator for " << runtime::DeviceName(dev.device_type)
+                   << "(" << dev.device_id << ")";
+        alloc.reset(new SizeClassAllocator(dev));
+        break;
+      }
+      case kPinnedHost: {
+        DLOG(INFO) << "New pinned host allocator for " << runtime::DeviceName(dev.device_type)
+                   << "(" << dev.device_id << ")";
+        alloc.reset(new PooledAllocator(dev, PooledAllocator::kDefaultPageSize, kPinnedHost));
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
@@ -143,7 +179,9 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
     return ret;
   }
   auto alloc = m->allocators_.at(dev).get();
-  if (alloc->type() != type) {
+  // The host memory of the CPU stages its transfers as it is, whichever allocator it comes from.
+  bool cpu_staging = type == kPinnedHost && dev.device_type == kDLCPU;
+  if (alloc->type() != type && !cpu_staging) {
     LOG(WARNING) << "The type of existing allocator for " << runtime::DeviceName(dev.device_type)
                  << "(" << dev.device_id << ") is different from the request type ("
                  << alloc->type() << " vs " << type << ")";
@@ -151,21 +189,52 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
   return alloc;
 }
 
-Allocator* MemoryManager::GetAllocator(Device dev) {
+Allocator* MemoryManager::GetOrCreateScopedAllocator(Device dev, const std::string& scope) {
+  ICHECK_NE(scope, "global") << "The global memory is allocated by GetOrCreateAllocator";
   MemoryManager* m = MemoryManager::Global();
   std::lock_guard<std::mutex> lock(m->mutex_);
+  std::unique_ptr<Allocator>& alloc = m->scoped_allocators_[dev][scope];
+  if (alloc == nullptr) {
+    DLOG(INFO) << "New " << scope << " allocator for " << runtime::DeviceName(dev.device_type)
+               << "(" << dev.device_id << ")";
+    alloc.reset(new ScopedAllocator(dev, scope));
+  }
+  return alloc.get();
+}
+
+Allocator* MemoryManager::GetAllocator(Device dev, const std::string& scope) {
+  MemoryManager* m = MemoryManager::Global();
+  if (scope != "global") {
+    std::lock_guard<std::mutex> lock(m->mutex_);
+    auto it = m->scoped_allocators_.find(dev);
+    if (it == m->scoped_allocators_.end() || !it->second.count(scope)) {
+      LOG(FATAL) << "Allocator for " << scope << " of " << runtime::DeviceName(dev.device_type)
+                 << "(" << dev.device_id << ") has not been created yet.";
+    }
+    return it->second.at(scope).get();
+  }
+  // The allocators are never removed, so each thread can remember them without the lock.
+  // This lookup runs on every storage release.
+  thread_local std::unordered_map<Device, Allocator*> cache;
+  auto cached = cache.find(dev);
+  if (cached != cache.end()) {
+    return cached->second;
+  }
+  std::lock_guard<std::mutex> lock(m->mutex_);
   auto it = m->allocators_.find(dev);
   if (it == m->allocators_.end()) {
     LOG(FATAL) << "Allocator for " << runtime::DeviceName(dev.device_type) << "(" << dev.device_id
                << ") has not been created yet.";
   }
+  cache.emplace(dev, it->second.get());
   return it->second.get();
 }
 
 runtime::NDArray Allocator::Empty(std::vector<int64_t> shape, DLDataType dtype, DLDevice dev) {
   VerifyDataType(dtype);
   runtime::NDArray::Container* container =
-      new runtime::NDArray::Container(nullptr, shape, dtype, dev);
+      new (SmallObjAllocator::Alloc(sizeof(runtime::NDArray::Container)))
+          runtime::NDArray::Container(nullptr, shape, dtype, dev);
   container->SetDeleter(BufferDeleter);
   size_t size = runtime::GetDataSize(container->dl_tensor);
   size_t alignment = GetDataAlignment(container->dl_tensor);
@@ -176,6 +245,44 @@ runtime::NDArray Allocator::Empty(std::vector<int64_t> shape, DLDataType dtype,
   return runtime::NDArray(runtime::GetObjectPtr<Object>(container));
 }
 
+TVM_REGISTER_GLOBAL("vm.memory_manager.stats").set_body_typed([](Device dev) {
+  // Serialize to JSON, since the profiling counters are not visible from the frontend.
+  std::ostringstream os;
+  os << "{";
+  bool first = true;
+  for (const auto& kv : MemoryManager::GetAllocator(dev)->Stats()) {
+    if (!first) os << ", ";
+    first = false;
+    os << "\"" << kv.first << "\": ";
+    if (const auto* count = kv.second.as<profiling::CountNode>()) {
+      os << count->value;
+    } else if (const auto* ratio = kv.second.as<profiling::RatioNode>()) {
+      os << ratio->ratio;
+    } else {
+      LOG(FATAL) << "Unsupported allocator statistic " << kv.first << ": "
+                 << kv.second->GetTypeKey();
+    }
+  }
+  os << "}";
+  return String(os.str());
+});
+
+TVM_REGISTER_GLOBAL("vm.memory_manager.pinned_empty")
+    .set_body_typed([](ShapeTuple shape, DLDataType dtype, Device dev) {
+      Allocator* alloc = MemoryManager::GetOrCreateAllocator(dev, kPinnedHost);
+      std::vector<int64_t> dims(shape.begin(), shape.end());
+      return alloc->Empty(dims, dtype, MemoryManager::PinnedHostDevice(dev));
+    });
+
+TVM_REGISTER_GLOBAL("vm.memory_manager.set_high_water_mark")
+    .set_body_typed([](Device dev, int64_t high_water_mark) {
+      Allocator* alloc = MemoryManager::GetAllocator(dev);
+      ICHECK_EQ(alloc->type(), kSizeClass)
+          << "The high-water mark is only supported by the size-class allocator";
+      ICHECK_GE(high_water_mark, 0);
+      static_cast<SizeClassAllocator*>(alloc)->SetHighWaterMark(high_water_mark);
+    });
+
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
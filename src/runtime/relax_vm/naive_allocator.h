@@ -24,6 +24,7 @@
 #define TVM_RUNTIME_RELAX_VM_NAIVE_ALLOCATOR_H_
 
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/relax_vm/memory_manager.h>
 
 #include <atomic>
@@ -53,6 +54,14 @@ class NaiveAllocator final : public Allocator {
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
   }
 
+  Map<String, ObjectRef> Stats() const override {
+    int64_t used_memory = used_memory_.load(std::memory_order_relaxed);
+    Map<String, ObjectRef> stats;
+    stats.Set("bytes_in_use", ObjectRef(make_object<profiling::CountNode>(used_memory)));
+    stats.Set("bytes_reserved", ObjectRef(make_object<profiling::CountNode>(used_memory)));
+    return stats;
+  }
+
  private:
   std::atomic<size_t> used_memory_;
   Device device_;
@@ -24,37 +24,89 @@
 #define TVM_RUNTIME_RELAX_VM_POOLED_ALLOCATOR_H_
 
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/relax_vm/memory_manager.h>
 
+#include <algorithm>
 #include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
+/*!
+ * \brief A pooled allocator which recycles the freed buffers by rounded size.
+ *
+ * Each thread keeps a small cache of freed buffers in front of the shared pool, so that the
+ * storage churn of concurrent VMs does not serialize on the pool lock. A thread returns its
+ * buffers to the shared pool in batches once its cache of a size fills up, and at exit. Freezing
+ * the allocator and releasing its unused memory drain the caches of all the threads.
+ *
+ * Once frozen, e.g. after the warm-up runs of a model, the allocator serves every buffer from one
+ * arena holding as many buffers of each size as it has allocated from the device at most, and
+ * fails fast when the arena has none left instead of allocating from the device mid-request.
+ */
 class PooledAllocator final : public Allocator {
  public:
   static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief The buffers of a size a thread caches before returning a batch to the pool. */
+  static constexpr size_t kThreadCacheLimit = 8;
+  /*! \brief The number of buffers moved between a thread cache and the pool at a time. */
+  static constexpr size_t kThreadCacheBatch = 4;
 
-  explicit PooledAllocator(Device dev, size_t page_size = kDefaultPageSize)
-      : Allocator(kPooled), page_size_(page_size), used_memory_(0), device_(dev) {}
+  explicit PooledAllocator(Device dev, size_t page_size = kDefaultPageSize,
+                           AllocatorType type = kPooled)
+      : Allocator(type),
+        page_size_(page_size),
+        used_memory_(0),
+        bytes_in_use_(0),
+        device_(dev),
+        pool_(std::make_shared<Pool>()) {}
 
-  ~PooledAllocator() { ReleaseAll(); }
+  ~PooledAllocator() {
+    ReleaseAll();
+    if (arena_.data != nullptr) {
+      runtime::DeviceAPI::Get(device_)->FreeDataSpace(device_, arena_.data);
+    }
+  }
 
   Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
-    auto&& it = memory_pool_.find(size);
-    if (it != memory_pool_.end() && !it->second.empty()) {
-      auto&& pool = it->second;
-      auto ret = pool.back();
-      pool.pop_back();
-      return ret;
+    if (frozen_.load(std::memory_order_acquire)) {
+      return AllocFrozen(size);
     }
+    bytes_in_use_.fetch_add(size, std::memory_order_relaxed);
+    ThreadCache& cache = LocalCache();
     Buffer buf;
+    if (cache.Pop(size, &buf)) {
+      return buf;
+    }
+    // The pool lock is never taken with the lock of a cache held, see DrainCaches.
+    std::vector<Buffer> batch;
+    {
+      std::lock_guard<std::mutex> lock(pool_->mu);
+      auto it = pool_->buffers.find(size);
+      if (it != pool_->buffers.end()) {
+        auto& pool = it->second;
+        size_t n = std::min(pool.size(), kThreadCacheBatch);
+        batch.assign(pool.end() - n, pool.end());
+        pool.resize(pool.size() - n);
+      }
+    }
+    if (!batch.empty()) {
+      buf = batch.back();
+      batch.pop_back();
+      cache.Push(size, batch.begin(), batch.end());
+      return buf;
+    }
     buf.device = device_;
     buf.size = size;
     try {
@@ -69,29 +121,255 @@ class PooledAllocator final : public Allocator {
     }
 
     used_memory_.fetch_add(size, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(pool_->mu);
+      size_t& num_allocated = pool_->num_allocated[size];
+      size_t& peak = pool_->peak_allocated[size];
+      peak = std::max(peak, ++num_allocated);
+    }
     DLOG(INFO) << "allocate " << size << " B, used memory " << used_memory_ << " B";
     return buf;
   }
 
   void Free(const Buffer& buffer) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
-    if (memory_pool_.find(buffer.size) == memory_pool_.end()) {
-      memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
+    if (frozen_.load(std::memory_order_acquire)) {
+      return FreeFrozen(buffer);
+    }
+    bytes_in_use_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    std::vector<Buffer> batch;
+    {
+      ThreadCache& cache = LocalCache();
+      std::lock_guard<std::mutex> lock(cache.mu);
+      std::vector<Buffer>& cached = cache.buffers[buffer.size];
+      cached.push_back(buffer);
+      if (cached.size() > kThreadCacheLimit) {
+        // Return the least recently freed buffers, and keep the hot ones in the thread.
+        batch.assign(cached.begin(), cached.begin() + kThreadCacheBatch);
+        cached.erase(cached.begin(), cached.begin() + kThreadCacheBatch);
+      }
+    }
+    if (!batch.empty()) {
+      std::lock_guard<std::mutex> lock(pool_->mu);
+      auto& pool = pool_->buffers[buffer.size];
+      pool.insert(pool.end(), batch.begin(), batch.end());
     }
-    memory_pool_.at(buffer.size).push_back(buffer);
     DLOG(INFO) << "reclaim buffer " << buffer.size;
   }
 
+  Map<String, ObjectRef> Stats() const override {
+    int64_t bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    int64_t bytes_reserved = used_memory_.load(std::memory_order_relaxed);
+    Map<String, ObjectRef> stats;
+    stats.Set("bytes_in_use", ObjectRef(make_object<profiling::CountNode>(bytes_in_use)));
+    stats.Set("bytes_reserved", ObjectRef(make_object<profiling::CountNode>(bytes_reserved)));
+    std::lock_guard<std::mutex> lock(pool_->mu);
+    int64_t arena_bytes = arena_.size;
+    stats.Set("arena_bytes", ObjectRef(make_object<profiling::CountNode>(arena_bytes)));
+    return stats;
+  }
+
+  void Freeze() override {
+    std::lock_guard<std::mutex> lock(pool_->mu);
+    CHECK(!frozen_.load(std::memory_order_relaxed))
+        << "ValueError: The allocator is already frozen";
+    // The idle buffers make room for the arena, the ones in use are released when freed.
+    DrainCaches();
+    for (auto& it : pool_->buffers) {
+      for (const Buffer& buf : it.second) {
+        runtime::DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+      }
+      used_memory_.fetch_sub(it.first * it.second.size(), std::memory_order_relaxed);
+      pool_->num_allocated[it.first] -= it.second.size();
+    }
+    pool_->buffers.clear();
+    // Lay out the buffers of each size the allocator has needed at once, by increasing size.
+    std::map<size_t, size_t> slots(pool_->peak_allocated.begin(), pool_->peak_allocated.end());
+    size_t arena_size = 0;
+    for (const auto& it : slots) {
+      arena_size += it.first * it.second;
+    }
+    if (arena_size > 0) {
+      arena_.data = runtime::DeviceAPI::Get(device_)->AllocDataSpace(
+          device_, arena_size, page_size_, DLDataType{kDLUInt, 8, 1});
+    }
+    arena_.size = arena_size;
+    size_t offset = 0;
+    for (const auto& it : slots) {
+      for (size_t i = 0; i < it.second; ++i, offset += it.first) {
+        arena_.free[it.first].push_back(static_cast<char*>(arena_.data) + offset);
+      }
+    }
+    used_memory_.fetch_add(arena_size, std::memory_order_relaxed);
+    frozen_.store(true, std::memory_order_release);
+    DLOG(INFO) << "freeze in an arena of " << arena_size << " B";
+  }
+
+  void Unfreeze() override {
+    std::lock_guard<std::mutex> lock(pool_->mu);
+    CHECK(frozen_.load(std::memory_order_relaxed)) << "ValueError: The allocator is not frozen";
+    CHECK_EQ(arena_.num_in_use, 0) << "ValueError: " << arena_.num_in_use
+                                   << " buffers of the frozen arena are still in use";
+    if (arena_.data != nullptr) {
+      runtime::DeviceAPI::Get(device_)->FreeDataSpace(device_, arena_.data);
+    }
+    used_memory_.fetch_sub(arena_.size, std::memory_order_relaxed);
+    arena_ = Arena();
+    frozen_.store(false, std::memory_order_release);
+  }
+
  private:
+  struct ThreadCache;
+
+  /*! \brief The buffers shared by all threads. */
+  struct Pool {
+    std::mutex mu;
+    std::unordered_map<size_t, std::vector<Buffer>> buffers;
+    /*! \brief The caches of the threads, which register and unregister with the lock held. */
+    std::unordered_set<ThreadCache*> caches;
+    /*! \brief The number of buffers of each size allocated from the device and not released. */
+    std::unordered_map<size_t, size_t> num_allocated;
+    /*! \brief The most buffers of each size allocated from the device at once. */
+    std::unordered_map<size_t, size_t> peak_allocated;
+  };
+
+  /*! \brief The memory of a frozen allocator, carved into buffers of the sizes it has needed. */
+  struct Arena {
+    void* data{nullptr};
+    size_t size{0};
+    /*! \brief The free buffers of the arena, by size. */
+    std::map<size_t, std::vector<void*>> free;
+    /*! \brief The number of buffers of the arena handed out and not freed yet. */
+    size_t num_in_use{0};
+  };
+
+  Buffer AllocFrozen(size_t size) {
+    std::lock_guard<std::mutex> lock(pool_->mu);
+    // A larger buffer serves the request when there is none of its size left.
+    auto it = arena_.free.lower_bound(size);
+    CHECK(it != arena_.free.end())
+        << "The frozen allocator of " << runtime::DeviceName(device_.device_type) << "("
+        << device_.device_id << ") has no buffer of " << size << " B left in its arena of "
+        << arena_.size << " B. Warm it up with the largest inputs before freezing it.";
+    Buffer buf;
+    buf.device = device_;
+    buf.size = it->first;
+    buf.data = it->second.back();
+    it->second.pop_back();
+    if (it->second.empty()) {
+      arena_.free.erase(it);
+    }
+    ++arena_.num_in_use;
+    bytes_in_use_.fetch_add(buf.size, std::memory_order_relaxed);
+    return buf;
+  }
+
+  void FreeFrozen(const Buffer& buffer) {
+    std::lock_guard<std::mutex> lock(pool_->mu);
+    bytes_in_use_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    char* data = static_cast<char*>(buffer.data);
+    char* begin = static_cast<char*>(arena_.data);
+    if (begin != nullptr && data >= begin && data < begin + arena_.size) {
+      arena_.free[buffer.size].push_back(buffer.data);
+      --arena_.num_in_use;
+      return;
+    }
+    // A buffer allocated before the allocator was frozen.
+    runtime::DeviceAPI::Get(buffer.device)->FreeDataSpace(buffer.device, buffer.data);
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    --pool_->num_allocated[buffer.size];
+  }
+
+  /*!
+   * \brief The buffers cached by a thread, returned to the pool when the thread exits.
+   * \note Its lock is only contended when another thread drains the caches, and is taken after
+   *  the pool lock, never before.
+   */
+  struct ThreadCache {
+    std::weak_ptr<Pool> pool;
+    std::mutex mu;
+    std::unordered_map<size_t, std::vector<Buffer>> buffers;
+
+    bool Pop(size_t size, Buffer* buf) {
+      std::lock_guard<std::mutex> lock(mu);
+      auto it = buffers.find(size);
+      if (it == buffers.end() || it->second.empty()) {
+        return false;
+      }
+      *buf = it->second.back();
+      it->second.pop_back();
+      return true;
+    }
+
+    template <typename Iter>
+    void Push(size_t size, Iter begin, Iter end) {
+      std::lock_guard<std::mutex> lock(mu);
+      auto& cached = buffers[size];
+      cached.insert(cached.end(), begin, end);
+    }
+
+    ~ThreadCache() {
+      auto owner = pool.lock();
+      if (owner == nullptr) {
+        // The allocator is gone, release the buffers to the device directly.
+        for (auto const& it : buffers) {
+          for (auto const& buf : it.second) {
+            runtime::DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+          }
+        }
+        return;
+      }
+      std::lock_guard<std::mutex> lock(owner->mu);
+      owner->caches.erase(this);
+      for (auto& it : buffers) {
+        auto& pool = owner->buffers[it.first];
+        pool.insert(pool.end(), it.second.begin(), it.second.end());
+      }
+    }
+  };
+
+  /*! \brief Get the cache of the calling thread for this allocator. */
+  ThreadCache& LocalCache() {
+    thread_local std::unordered_map<const PooledAllocator*, ThreadCache> caches;
+    auto it = caches.find(this);
+    // A cache of a destroyed allocator at the same address is stale.
+    if (it != caches.end() && it->second.pool.lock() != pool_) {
+      caches.erase(it);
+      it = caches.end();
+    }
+    if (it == caches.end()) {
+      it = caches.emplace(std::piecewise_construct, std::forward_as_tuple(this),
+                          std::forward_as_tuple())
+               .first;
+      it->second.pool = pool_;
+      std::lock_guard<std::mutex> lock(pool_->mu);
+      pool_->caches.insert(&it->second);
+    }
+    return it->second;
+  }
+
+  /*! \brief Return the caches of all the threads to the pool, with the pool lock held. */
+  void DrainCaches() {
+    for (ThreadCache* cache : pool_->caches) {
+      std::lock_guard<std::mutex> lock(cache->mu);
+      for (auto& it : cache->buffers) {
+        auto& pool = pool_->buffers[it.first];
+        pool.insert(pool.end(), it.second.begin(), it.second.end());
+      }
+      cache->buffers.clear();
+    }
+  }
+
   void ReleaseAll() {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
-    for (auto const& it : memory_pool_) {
+    std::lock_guard<std::mutex> lock(pool_->mu);
+    DrainCaches();
+    for (auto const& it : pool_->buffers) {
       auto const& pool = it.second;
       for (auto const& buf : pool) {
         runtime::DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
       }
+      pool_->num_allocated[it.first] -= pool.size();
     }
-    memory_pool_.clear();
+    pool_->buffers.clear();
     used_memory_ = 0;
     DLOG(INFO) << "release all buffers";
   }
@@ -99,9 +377,14 @@ class PooledAllocator final : public Allocator {
  private:
   size_t page_size_;
   std::atomic<size_t> used_memory_;
-  std::unordered_map<size_t, std::vector<Buffer> > memory_pool_;
-  std::recursive_mutex mu_;
+  /*! \brief The bytes of the buffers handed out and not freed yet. */
+  std::atomic<size_t> bytes_in_use_;
   Device device_;
+  std::shared_ptr<Pool> pool_;
+  /*! \brief Whether the allocator is frozen, serving the buffers from the arena. */
+  std::atomic<bool> frozen_{false};
+  /*! \brief The arena of the frozen allocator, guarded by the lock of the pool. */
+  Arena arena_;
 };
 
 }  // namespace relax_vm
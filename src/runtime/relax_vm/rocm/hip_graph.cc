@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/rocm/hip_graph.cc
+ * \brief HIP graph capture and replay of relax VM functions on ROCm.
+ */
+
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../rocm/rocm_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The state of one VM function invocation captured into a HIP graph. */
+struct HIPGraphCapturedState {
+  /*! \brief The static input buffers read by the graph. */
+  std::vector<NDArray> inputs;
+  /*! \brief The result of the captured invocation, rewritten in place by every replay. */
+  RegType outputs;
+  /*! \brief The storage allocated during capture, kept alive for the lifetime of the graph. */
+  std::vector<ObjectRef> storage;
+  /*! \brief The instantiated graph. */
+  hipGraphExec_t exec{nullptr};
+
+  ~HIPGraphCapturedState() {
+    if (exec != nullptr) {
+      ROCM_CALL(hipGraphExecDestroy(exec));
+    }
+  }
+};
+
+/*!
+ * \brief Capture a static-shape VM function into HIP graphs and replay them.
+ *
+ *  A graph is captured per distinct set of input shapes and dtypes. Replaying
+ *  a graph copies the inputs into the captured input buffers and launches the
+ *  graph, so that none of the kernels is launched individually.
+ *
+ * \note The function must not synchronize with the host, e.g. through data
+ *  dependent control flow, since that is not allowed during stream capture.
+ *  The outputs of a replay are overwritten by the next replay with the same shapes.
+ */
+class HIPGraphRunner {
+ public:
+  HIPGraphRunner(Module vm, std::string func_name)
+      : vm_(vm), func_name_(func_name), func_(vm->GetFunction(func_name, false)) {
+    VirtualMachine* vm_ptr = static_cast<VirtualMachine*>(vm_.operator->());
+    ICHECK(!vm_ptr->devices.empty()) << "The VirtualMachine is not initialized.";
+    device_ = vm_ptr->devices[0];
+    ICHECK_EQ(device_.device_type, kDLROCM)
+        << "ValueError: HIP graph capture requires the VM to run on a ROCm device, but got "
+        << DeviceName(device_.device_type);
+    ROCM_CALL(hipSetDevice(device_.device_id));
+    ROCM_CALL(hipStreamCreate(&stream_));
+  }
+
+  ~HIPGraphRunner() {
+    cache_.clear();
+    ROCM_CALL(hipStreamDestroy(stream_));
+  }
+
+  void Run(TVMArgs args, TVMRetValue* rv) {
+    std::string key = GetShapeKey(args);
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+      it = cache_.emplace(key, Capture(args)).first;
+    }
+    HIPGraphCapturedState* state = it->second.get();
+    for (int i = 0; i < args.size(); ++i) {
+      NDArray arr = args[i];
+      NDArray::CopyFromTo(arr.operator->(), const_cast<DLTensor*>(state->inputs[i].operator->()),
+                          stream_);
+    }
+    ROCM_CALL(hipGraphLaunch(state->exec, stream_));
+    ROCM_CALL(hipStreamSynchronize(stream_));
+    *rv = state->outputs;
+  }
+
+ private:
+  /*! \brief The cache key of the input shapes, dtypes and devices. */
+  static std::string GetShapeKey(TVMArgs args) {
+    std::ostringstream os;
+    for (int i = 0; i < args.size(); ++i) {
+      ICHECK_EQ(args[i].type_code(), kTVMNDArrayHandle)
+          << "ValueError: HIP graph capture only supports NDArray inputs, but argument " << i
+          << " is " << ArgTypeCode2Str(args[i].type_code());
+      NDArray arr = args[i];
+      os << arr.DataType() << arr->device.device_type << ":" << arr->device.device_id << "[";
+      for (int64_t dim : arr.Shape()) {
+        os << dim << ",";
+      }
+      os << "];";
+    }
+    return os.str();
+  }
+
+  std::unique_ptr<HIPGraphCapturedState> Capture(TVMArgs args) {
+    auto state = std::make_unique<HIPGraphCapturedState>();
+    std::vector<TVMValue> values(args.size());
+    std::vector<int> tcodes(args.size());
+    TVMArgsSetter setter(values.data(), tcodes.data());
+    for (int i = 0; i < args.size(); ++i) {
+      NDArray arr = args[i];
+      state->inputs.push_back(NDArray::Empty(arr.Shape(), arr.DataType(), device_));
+      setter(i, state->inputs.back());
+    }
+
+    // Warm up with the real inputs, so that lazy initialization such as module
+    // loading and allocator pool growth happens outside of the capture.
+    TVMRetValue warmup;
+    func_.CallPacked(args, &warmup);
+    ROCM_CALL(hipDeviceSynchronize());
+
+    VirtualMachine* vm_ptr = static_cast<VirtualMachine*>(vm_.operator->());
+    ICHECK(vm_ptr->storage_recorder == nullptr) << "Nested HIP graph capture is not supported.";
+    ROCMThreadEntry* thread_entry = ROCMThreadEntry::ThreadLocal();
+    hipStream_t prev_stream = thread_entry->stream;
+    thread_entry->stream = stream_;
+    vm_ptr->storage_recorder = &state->storage;
+
+    hipGraph_t graph;
+    ROCM_CALL(hipStreamBeginCapture(stream_, hipStreamCaptureModeRelaxed));
+    try {
+      func_.CallPacked(TVMArgs(values.data(), tcodes.data(), args.size()), &state->outputs);
+    } catch (...) {
+      hipStreamEndCapture(stream_, &graph);
+      vm_ptr->storage_recorder = nullptr;
+      thread_entry->stream = prev_stream;
+      throw;
+    }
+    ROCM_CALL(hipStreamEndCapture(stream_, &graph));
+    vm_ptr->storage_recorder = nullptr;
+    thread_entry->stream = prev_stream;
+
+    ROCM_CALL(hipGraphInstantiate(&state->exec, graph, nullptr, nullptr, 0));
+    ROCM_CALL(hipGraphDestroy(graph));
+    DLOG(INFO) << "Captured HIP graph of " << func_name_ << " with " << state->storage.size()
+               << " storage allocations";
+    return state;
+  }
+
+  /*! \brief The VM module. */
+  Module vm_;
+  /*! \brief The name of the captured function. */
+  std::string func_name_;
+  /*! \brief The VM function. */
+  PackedFunc func_;
+  /*! \brief The device the graphs run on. */
+  Device device_;
+  /*! \brief The stream used for capture and replay. */
+  hipStream_t stream_{nullptr};
+  /*! \brief The captured graphs, keyed by the input shapes. */
+  std::unordered_map<std::string, std::unique_ptr<HIPGraphCapturedState>> cache_;
+};
+
+TVM_REGISTER_GLOBAL("vm.hip_graph.make_runner")
+    .set_body_typed([](Module vm, String func_name) {
+      auto runner = std::make_shared<HIPGraphRunner>(vm, func_name);
+      return PackedFunc([runner](TVMArgs args, TVMRetValue* rv) { runner->Run(args, rv); });
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
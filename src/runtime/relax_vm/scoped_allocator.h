@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file tvm/runtime/relax_vm/scoped_allocator.h
+ * \brief The allocator of the memory of a storage scope other than "global" of a device.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_SCOPED_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_SCOPED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <atomic>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Allocate the memory of a storage scope through the device API, which manages the memory
+ *  of the scope, e.g. the VTCM pool of Hexagon for "global.vtcm". The blocks are not pooled, as
+ *  they are typically planned ahead by VMGraphMemoryPlan and scarce.
+ */
+class ScopedAllocator final : public Allocator {
+ public:
+  ScopedAllocator(Device dev, std::string scope)
+      : Allocator(kScoped), used_memory_(0), device_(dev), scope_(std::move(scope)) {}
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    Buffer buf;
+    buf.device = device_;
+    buf.size = nbytes;
+    buf.scope = scope_;
+    // A flat array of bytes, which the scoped allocations of the device APIs are laid out as.
+    int64_t shape = nbytes;
+    buf.data = runtime::DeviceAPI::Get(device_)->AllocDataSpace(
+        device_, 1, &shape, DLDataType{kDLUInt, 8, 1}, String(scope_));
+    CHECK(buf.data != nullptr) << "ValueError: Failed to allocate " << nbytes << " bytes of "
+                               << scope_ << " on " << device_;
+    used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    DLOG(INFO) << "allocate " << nbytes << " B of " << scope_ << ", used memory " << used_memory_
+               << " B";
+    return buf;
+  }
+
+  /*!
+   * \brief Allocate a 2D image of a texture scope, e.g. "global.texture" on OpenCL, which the
+   *  planned texture storages are allocated as.
+   * \param shape The extent of the image, (height, width, channel).
+   * \param type_hint The dtype of the texels.
+   */
+  Buffer AllocTexture(ShapeTuple shape, DLDataType type_hint) {
+    CHECK_EQ(shape.size(), 3) << "ValueError: A texture is allocated with a shape of "
+                              << "(height, width, channel), but gets a shape of rank "
+                              << shape.size();
+    Buffer buf;
+    buf.device = device_;
+    buf.size = (type_hint.bits * type_hint.lanes + 7) / 8;
+    for (int64_t dim : shape) {
+      buf.size *= dim;
+    }
+    buf.scope = scope_;
+    buf.data = runtime::DeviceAPI::Get(device_)->AllocDataSpace(
+        device_, static_cast<int>(shape.size()), shape.data(), type_hint, String(scope_));
+    CHECK(buf.data != nullptr) << "ValueError: Failed to allocate a " << shape[0] << "x"
+                               << shape[1] << " texture of " << scope_ << " on " << device_;
+    used_memory_.fetch_add(buf.size, std::memory_order_relaxed);
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    runtime::DeviceAPI::Get(device_)->FreeDataSpace(buffer.device, buffer.data);
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    DLOG(INFO) << "free " << buffer.size << " B of " << scope_ << ", used memory " << used_memory_
+               << " B";
+  }
+
+  Map<String, ObjectRef> Stats() const override {
+    int64_t used_memory = used_memory_.load(std::memory_order_relaxed);
+    Map<String, ObjectRef> stats;
+    stats.Set("bytes_in_use", ObjectRef(make_object<profiling::CountNode>(used_memory)));
+    stats.Set("bytes_reserved", ObjectRef(make_object<profiling::CountNode>(used_memory)));
+    return stats;
+  }
+
+ private:
+  std::atomic<size_t> used_memory_;
+  Device device_;
+  std::string scope_;
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_SCOPED_ALLOCATOR_H_
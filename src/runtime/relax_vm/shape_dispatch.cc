@@ -0,0 +1,240 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/shape_dispatch.cc
+ * \brief Dispatch of the calls to a relax VM function by the shapes of their arguments.
+ */
+
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Record the histogram of the argument shapes of the calls to a VM function, and dispatch
+ *  the calls with the shapes of a specialization to the function of its VM.
+ *
+ *  The specializations are compiled from the function with its shapes bound, e.g. by
+ *  `relax.ShapeSpecializer` on a background thread, and may be added while the calls go on. The
+ *  calls with any other shapes run the generic function.
+ *
+ *  The shapes of a call are those of its tensor and shape arguments, the other arguments have no
+ *  shape and are not told apart. The histogram counts at most `max_num_shapes` distinct shapes,
+ *  the calls with further shapes are only counted in total.
+ */
+class ShapeDispatcherNode : public ModuleNode {
+ public:
+  ShapeDispatcherNode(Module vm, std::string func_name, int64_t max_num_shapes)
+      : func_name_(func_name), max_num_shapes_(max_num_shapes) {
+    CHECK_GT(max_num_shapes, 0) << "ValueError: max_num_shapes must be positive";
+    generic_ = vm->GetFunction(func_name, false);
+    CHECK(generic_ != nullptr) << "ValueError: Unknown function: " << func_name;
+  }
+
+  const char* type_key() const final { return "relax.vm.ShapeDispatcher"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "invoke") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Invoke(args, rv); });
+    } else if (name == "get_shape_histogram") {
+      // The distinct shapes of the calls, and the numbers of calls with them as a ShapeTuple in
+      // the same order. The shapes have a ShapeTuple for each argument, or None for the arguments
+      // without a shape.
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Array<ObjectRef> shapes;
+        std::vector<int64_t> counts;
+        for (const auto& kv : entries_) {
+          shapes.push_back(kv.second.shapes);
+          counts.push_back(kv.second.count);
+        }
+        *rv = Array<ObjectRef>{shapes, ShapeTuple(counts)};
+      });
+    } else if (name == "get_num_calls") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        *rv = num_calls_;
+      });
+    } else if (name == "add_specialization") {
+      // Dispatch the calls with the given shapes to the function of the given VM, which must be
+      // initialized on the device of the generic one.
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK_EQ(args.size(), 2);
+        Array<ObjectRef> shapes = args[0];
+        Module vm = args[1];
+        PackedFunc func = vm->GetFunction(func_name_, false);
+        CHECK(func != nullptr) << "ValueError: The specialized VM has no function " << func_name_;
+        std::vector<int64_t> key = MakeKey(shapes);
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[key];
+        entry.shapes = shapes;
+        entry.vm = vm;
+        entry.specialized = func;
+      });
+    } else if (name == "clear_specializations") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& kv : entries_) {
+          kv.second.vm = Module(nullptr);
+          kv.second.specialized = nullptr;
+        }
+      });
+    } else if (name == "get_num_specializations") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t count = 0;
+        for (const auto& kv : entries_) {
+          count += kv.second.specialized != nullptr;
+        }
+        *rv = count;
+      });
+    }
+    return PackedFunc(nullptr);
+  }
+
+ private:
+  /*! \brief The calls with some shapes, and their specialization if any. */
+  struct Entry {
+    /*! \brief The shapes of the arguments. */
+    Array<ObjectRef> shapes;
+    /*! \brief The number of calls with the shapes. */
+    int64_t count{0};
+    /*! \brief The VM of the specialization, kept alive for its function. */
+    Module vm{nullptr};
+    /*! \brief The specialized function, or nullptr. */
+    PackedFunc specialized{nullptr};
+  };
+
+  struct KeyHash {
+    size_t operator()(const std::vector<int64_t>& key) const {
+      size_t hash = key.size();
+      for (int64_t value : key) {
+        hash ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  /*! \brief The key of the shapes, the rank and the dims of each shape, or -1 for no shape. */
+  static std::vector<int64_t> MakeKey(const Array<ObjectRef>& shapes) {
+    std::vector<int64_t> key;
+    for (const ObjectRef& shape : shapes) {
+      if (const auto* tuple = shape.as<ShapeTupleObj>()) {
+        key.push_back(tuple->size);
+        key.insert(key.end(), tuple->data, tuple->data + tuple->size);
+      } else {
+        CHECK(!shape.defined()) << "TypeError: Expect a shape or None, but gets "
+                                << shape->GetTypeKey();
+        key.push_back(-1);
+      }
+    }
+    return key;
+  }
+
+  static const DLTensor* GetTensor(const TVMArgValue& arg) {
+    if (arg.type_code() == kTVMDLTensorHandle) {
+      return arg.operator DLTensor*();
+    } else if (arg.IsObjectRef<NDArray>()) {
+      return arg.operator NDArray().operator->();
+    }
+    return nullptr;
+  }
+
+  void Invoke(TVMArgs args, TVMRetValue* rv) {
+    std::vector<int64_t> key;
+    for (int i = 0; i < args.size(); ++i) {
+      if (const DLTensor* tensor = GetTensor(args[i])) {
+        key.push_back(tensor->ndim);
+        key.insert(key.end(), tensor->shape, tensor->shape + tensor->ndim);
+      } else if (args[i].IsObjectRef<ShapeTuple>()) {
+        ShapeTuple shape = args[i];
+        key.push_back(shape.size());
+        key.insert(key.end(), shape.begin(), shape.end());
+      } else {
+        key.push_back(-1);
+      }
+    }
+    PackedFunc func = generic_;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++num_calls_;
+      auto it = entries_.find(key);
+      if (it == entries_.end() && static_cast<int64_t>(entries_.size()) < max_num_shapes_) {
+        it = entries_.emplace(key, Entry()).first;
+        it->second.shapes = MakeShapes(args);
+      }
+      if (it != entries_.end()) {
+        ++it->second.count;
+        if (it->second.specialized != nullptr) {
+          func = it->second.specialized;
+        }
+      }
+    }
+    func.CallPacked(args, rv);
+  }
+
+  static Array<ObjectRef> MakeShapes(TVMArgs args) {
+    Array<ObjectRef> shapes;
+    for (int i = 0; i < args.size(); ++i) {
+      if (const DLTensor* tensor = GetTensor(args[i])) {
+        shapes.push_back(ShapeTuple(tensor->shape, tensor->shape + tensor->ndim));
+      } else if (args[i].IsObjectRef<ShapeTuple>()) {
+        shapes.push_back(args[i].operator ShapeTuple());
+      } else {
+        shapes.push_back(ObjectRef(nullptr));
+      }
+    }
+    return shapes;
+  }
+
+  /*! \brief The name of the dispatched function. */
+  std::string func_name_;
+  /*! \brief The max number of distinct shapes recorded. */
+  int64_t max_num_shapes_;
+  /*! \brief The generic function of the VM. */
+  PackedFunc generic_;
+  /*! \brief The recorded shapes. */
+  std::unordered_map<std::vector<int64_t>, Entry, KeyHash> entries_;
+  /*! \brief The number of calls. */
+  int64_t num_calls_{0};
+  /*! \brief The mutex guarding the entries, as the specializations are added from other threads. */
+  std::mutex mutex_;
+};
+
+TVM_REGISTER_GLOBAL("vm.shape_dispatch.make_dispatcher")
+    .set_body_typed([](Module vm, String func_name, int64_t max_num_shapes) {
+      return Module(make_object<ShapeDispatcherNode>(vm, func_name, max_num_shapes));
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
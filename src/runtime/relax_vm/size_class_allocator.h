@@ -0,0 +1,297 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file tvm/runtime/relax_vm/size_class_allocator.h
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_SIZE_CLASS_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_SIZE_CLASS_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief A caching allocator which rounds the requests to size classes and serves them by
+ *  best fit from cached blocks, splitting the larger blocks and merging the freed neighbors.
+ *
+ * The device memory is reserved by segments. Small requests share segments of
+ * kSmallSegmentSize, larger ones get a segment of their own, and the two kinds are
+ * cached apart so that small requests do not split up the large blocks. Sizes are
+ * rounded up to four classes per power of two, which bounds the rounding waste to 25%.
+ * The free segments are handed back to the device when the cached bytes exceed the
+ * high-water mark, or when the device runs out of memory.
+ */
+class SizeClassAllocator final : public Allocator {
+ public:
+  /*! \brief The granularity of the blocks, and the largest supported alignment. */
+  static constexpr size_t kBlockSize = 512;
+  /*! \brief The largest request served from a shared segment. */
+  static constexpr size_t kSmallSizeLimit = 1 << 20;
+  /*! \brief The size of the segments shared by the small requests. */
+  static constexpr size_t kSmallSegmentSize = 2 << 20;
+
+  explicit SizeClassAllocator(Device dev,
+                              size_t high_water_mark = std::numeric_limits<size_t>::max())
+      : Allocator(kSizeClass), device_(dev), high_water_mark_(high_water_mark) {}
+
+  ~SizeClassAllocator() { ReleaseCached(0); }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    ICHECK_LE(alignment, kBlockSize) << "SizeClassAllocator supports alignments up to "
+                                     << kBlockSize << " bytes, but got " << alignment;
+    size_t size = RoundSize(nbytes);
+    bool small = size <= kSmallSizeLimit;
+    ++num_allocs_;
+    Block* block = nullptr;
+    FreeSet& pool = free_blocks_[small];
+    auto it = pool.lower_bound(std::make_pair(size, static_cast<char*>(nullptr)));
+    if (it != pool.end()) {
+      ++num_hits_;
+      block = blocks_.at(it->second).get();
+      RemoveFree(block);
+    } else {
+      block = NewSegment(small ? kSmallSegmentSize : size, small, type_hint);
+    }
+    if (block->size - size >= kBlockSize) {
+      Split(block, size);
+    }
+    block->allocated = true;
+    block->requested = nbytes;
+    bytes_in_use_ += block->size;
+    bytes_requested_ += nbytes;
+
+    Buffer buf;
+    buf.device = device_;
+    buf.size = block->size;
+    buf.data = block->ptr;
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = blocks_.find(static_cast<char*>(buffer.data));
+    ICHECK(it != blocks_.end() && it->second->allocated)
+        << "SizeClassAllocator got a buffer it did not allocate";
+    Block* block = it->second.get();
+    block->allocated = false;
+    bytes_in_use_ -= block->size;
+    bytes_requested_ -= block->requested;
+    // Coalesce with the free neighbors, so that the segment can be handed back once all free.
+    if (block->next != nullptr && !block->next->allocated) {
+      Block* next = block->next;
+      RemoveFree(next);
+      Absorb(block, next);
+    }
+    if (block->prev != nullptr && !block->prev->allocated) {
+      Block* prev = block->prev;
+      RemoveFree(prev);
+      Absorb(prev, block);
+      block = prev;
+    }
+    InsertFree(block);
+    if (bytes_cached_ > high_water_mark_) {
+      ReleaseCached(high_water_mark_);
+    }
+  }
+
+  Map<String, ObjectRef> Stats() const override {
+    std::lock_guard<std::mutex> lock(mu_);
+    size_t largest_free = 0;
+    for (const FreeSet& pool : free_blocks_) {
+      if (!pool.empty()) largest_free = std::max(largest_free, pool.rbegin()->first);
+    }
+    Map<String, ObjectRef> stats;
+    stats.Set("bytes_in_use", ObjectRef(make_object<profiling::CountNode>(bytes_in_use_)));
+    stats.Set("bytes_requested", ObjectRef(make_object<profiling::CountNode>(bytes_requested_)));
+    stats.Set("bytes_cached", ObjectRef(make_object<profiling::CountNode>(bytes_cached_)));
+    stats.Set("bytes_reserved", ObjectRef(make_object<profiling::CountNode>(bytes_reserved_)));
+    stats.Set("num_allocs", ObjectRef(make_object<profiling::CountNode>(num_allocs_)));
+    stats.Set("num_hits", ObjectRef(make_object<profiling::CountNode>(num_hits_)));
+    // The share of the allocations served from the cached blocks.
+    double hit_rate = num_allocs_ == 0 ? 0.0 : static_cast<double>(num_hits_) / num_allocs_;
+    stats.Set("hit_rate", ObjectRef(make_object<profiling::RatioNode>(hit_rate)));
+    // The share of the cached bytes which the largest request that fits could not use.
+    double fragmentation =
+        bytes_cached_ == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free) / bytes_cached_;
+    stats.Set("fragmentation", ObjectRef(make_object<profiling::RatioNode>(fragmentation)));
+    // The share of the bytes in use lost to the size-class rounding.
+    double internal_fragmentation =
+        bytes_in_use_ == 0 ? 0.0
+                           : 1.0 - static_cast<double>(bytes_requested_) / bytes_in_use_;
+    stats.Set("internal_fragmentation",
+              ObjectRef(make_object<profiling::RatioNode>(internal_fragmentation)));
+    return stats;
+  }
+
+  /*!
+   * \brief Set the high-water mark of the cached bytes.
+   * \param high_water_mark The bytes the free blocks may hold before the free segments are
+   *  handed back to the device.
+   */
+  void SetHighWaterMark(size_t high_water_mark) {
+    std::lock_guard<std::mutex> lock(mu_);
+    high_water_mark_ = high_water_mark;
+    if (bytes_cached_ > high_water_mark_) {
+      ReleaseCached(high_water_mark_);
+    }
+  }
+
+  /*! \brief Round a request up to its size class. */
+  static size_t RoundSize(size_t nbytes) {
+    if (nbytes <= kBlockSize) return kBlockSize;
+    // Four classes per power of two: round up to a multiple of a quarter of the power of two.
+    size_t power = 1;
+    while (power <= (nbytes - 1) / 2) power <<= 1;
+    size_t step = std::max(power / 4, kBlockSize);
+    return (nbytes + step - 1) / step * step;
+  }
+
+ private:
+  /*! \brief A contiguous piece of a segment. */
+  struct Block {
+    /*! \brief The start of the block. */
+    char* ptr{nullptr};
+    /*! \brief The size of the block. */
+    size_t size{0};
+    /*! \brief The bytes requested for the block when allocated. */
+    size_t requested{0};
+    /*! \brief Whether the block is allocated. */
+    bool allocated{false};
+    /*! \brief Whether the block belongs to a segment shared by small requests. */
+    bool small{false};
+    /*! \brief The neighbors in the same segment. */
+    Block* prev{nullptr};
+    Block* next{nullptr};
+  };
+
+  /*! \brief The free blocks ordered by (size, start), for the best fit. */
+  using FreeSet = std::set<std::pair<size_t, char*>>;
+
+  Block* NewSegment(size_t segment_size, bool small, DLDataType type_hint) {
+    void* data = nullptr;
+    try {
+      data = DeviceAPI::Get(device_)->AllocDataSpace(device_, segment_size, kBlockSize, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "SizeClassAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all cached memory and reallocate...";
+      ReleaseCached(0);
+      data = DeviceAPI::Get(device_)->AllocDataSpace(device_, segment_size, kBlockSize, type_hint);
+    }
+    bytes_reserved_ += segment_size;
+    auto block = std::make_unique<Block>();
+    block->ptr = static_cast<char*>(data);
+    block->size = segment_size;
+    block->small = small;
+    Block* ret = block.get();
+    blocks_.emplace(ret->ptr, std::move(block));
+    return ret;
+  }
+
+  void InsertFree(Block* block) {
+    free_blocks_[block->small].emplace(block->size, block->ptr);
+    bytes_cached_ += block->size;
+  }
+
+  void RemoveFree(Block* block) {
+    free_blocks_[block->small].erase(std::make_pair(block->size, block->ptr));
+    bytes_cached_ -= block->size;
+  }
+
+  /*! \brief Split a block, keeping its first bytes and caching the rest. */
+  void Split(Block* block, size_t size) {
+    auto rest = std::make_unique<Block>();
+    rest->ptr = block->ptr + size;
+    rest->size = block->size - size;
+    rest->small = block->small;
+    rest->prev = block;
+    rest->next = block->next;
+    if (block->next != nullptr) block->next->prev = rest.get();
+    block->next = rest.get();
+    block->size = size;
+    InsertFree(rest.get());
+    blocks_.emplace(rest->ptr, std::move(rest));
+  }
+
+  /*! \brief Merge the next neighbor into a block, neither of them being cached. */
+  void Absorb(Block* block, Block* next) {
+    block->size += next->size;
+    block->next = next->next;
+    if (next->next != nullptr) next->next->prev = block;
+    blocks_.erase(next->ptr);
+  }
+
+  /*! \brief Hand the free segments back to the device until the cached bytes fit the limit. */
+  void ReleaseCached(size_t limit) {
+    std::vector<Block*> segments;
+    for (const FreeSet& pool : free_blocks_) {
+      for (const auto& it : pool) {
+        Block* block = blocks_.at(it.second).get();
+        if (block->prev == nullptr && block->next == nullptr) segments.push_back(block);
+      }
+    }
+    // Release the largest segments first.
+    std::sort(segments.begin(), segments.end(),
+              [](const Block* a, const Block* b) { return a->size > b->size; });
+    for (Block* block : segments) {
+      if (bytes_cached_ <= limit) break;
+      RemoveFree(block);
+      bytes_reserved_ -= block->size;
+      DeviceAPI::Get(device_)->FreeDataSpace(device_, block->ptr);
+      blocks_.erase(block->ptr);
+    }
+  }
+
+  /*! \brief The device the memory is allocated on. */
+  Device device_;
+  /*! \brief The bytes the free blocks may hold before the free segments are released. */
+  size_t high_water_mark_;
+  /*! \brief Every block, allocated or free, by its start. */
+  std::unordered_map<char*, std::unique_ptr<Block>> blocks_;
+  /*! \brief The free blocks of the large segments, and of the small ones. */
+  FreeSet free_blocks_[2];
+  /*! \brief The usage counters. */
+  size_t bytes_in_use_{0};
+  size_t bytes_requested_{0};
+  size_t bytes_cached_{0};
+  size_t bytes_reserved_{0};
+  int64_t num_allocs_{0};
+  int64_t num_hits_{0};
+  /*! \brief Guards the state of the allocator. */
+  mutable std::mutex mu_;
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_SIZE_CLASS_ALLOCATOR_H_
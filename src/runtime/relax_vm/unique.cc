@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/unique.cc
+ * \brief The builtin computing the unique elements of a tensor, of a size only known at runtime.
+ *
+ * The elements are sorted together with their indices, so that the first element of each run of
+ * equal elements is its first occurrence. On CPU the elements are sorted by chunks on the threads
+ * of the runtime, and the chunks are merged pairwise. The tensors on the other devices are handled
+ * by "vm.builtin.unique.<device>", e.g. with Thrust on CUDA.
+ */
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief Run f(0), ..., f(num_items - 1) on the threads of the runtime. */
+static void ParallelRun(int num_items, const std::function<void(int)>& f) {
+  struct ParallelTask {
+    static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+      ParallelTask* task = static_cast<ParallelTask*>(cdata);
+      for (int i = task_id; i < task->num_items; i += penv->num_task) {
+        (*task->f)(i);
+      }
+      return 0;
+    }
+
+    const std::function<void(int)>* f;
+    int num_items;
+  };
+
+  ParallelTask task{&f, num_items};
+  // The pool runs at most one task per worker, each running the items of its stride.
+  int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
+  ICHECK_EQ(res, 0) << "unique: TVMBackendParallelLaunch failed";
+}
+
+/*! \brief Sort the items by chunks in parallel, then merge the sorted chunks pairwise. */
+template <typename T>
+static void ParallelSort(std::vector<T>* items) {
+  // Below this size, the launch of the threads costs more than sorting serially.
+  constexpr int64_t kMinChunkSize = 1 << 14;
+  int64_t size = items->size();
+  int num_chunks = std::min<int64_t>(threading::MaxConcurrency(), size / kMinChunkSize);
+  if (num_chunks <= 1) {
+    std::sort(items->begin(), items->end());
+    return;
+  }
+  std::vector<int64_t> bounds;
+  for (int i = 0; i <= num_chunks; ++i) {
+    bounds.push_back(size * i / num_chunks);
+  }
+  ParallelRun(num_chunks, [&](int i) {
+    std::sort(items->begin() + bounds[i], items->begin() + bounds[i + 1]);
+  });
+  while (bounds.size() > 2) {
+    int num_merges = (bounds.size() - 1) / 2;
+    ParallelRun(num_merges, [&](int i) {
+      std::inplace_merge(items->begin() + bounds[2 * i], items->begin() + bounds[2 * i + 1],
+                         items->begin() + bounds[2 * i + 2]);
+    });
+    std::vector<int64_t> merged_bounds;
+    for (size_t i = 0; i < bounds.size(); i += 2) {
+      merged_bounds.push_back(bounds[i]);
+    }
+    if (merged_bounds.back() != bounds.back()) {
+      merged_bounds.push_back(bounds.back());
+    }
+    bounds = std::move(merged_bounds);
+  }
+}
+
+template <typename T>
+static NDArray UniqueCPU(const NDArray& data, bool sorted) {
+  int64_t size = 1;
+  for (int i = 0; i < data->ndim; ++i) {
+    size *= data->shape[i];
+  }
+  const T* values =
+      reinterpret_cast<const T*>(static_cast<const char*>(data->data) + data->byte_offset);
+  // The elements with their indices, so that the first of each run of equal elements is the first
+  // occurrence of the element.
+  std::vector<std::pair<T, int64_t>> items(size);
+  for (int64_t i = 0; i < size; ++i) {
+    items[i] = {values[i], i};
+  }
+  ParallelSort(&items);
+  auto end = std::unique(items.begin(), items.end(),
+                         [](const std::pair<T, int64_t>& a, const std::pair<T, int64_t>& b) {
+                           return a.first == b.first;
+                         });
+  items.erase(end, items.end());
+  if (!sorted) {
+    // The unsorted elements are in the reverse order of their first occurrences.
+    std::sort(items.begin(), items.end(),
+              [](const std::pair<T, int64_t>& a, const std::pair<T, int64_t>& b) {
+                return a.second > b.second;
+              });
+  }
+
+  int64_t num_unique = items.size();
+  NDArray ret = NDArray::Empty({num_unique}, data->dtype, data->device);
+  T* ret_values = static_cast<T*>(ret->data);
+  for (int64_t i = 0; i < num_unique; ++i) {
+    ret_values[i] = items[i].first;
+  }
+  return ret;
+}
+
+NDArray Unique(NDArray data, bool sorted, bool return_inverse, bool return_counts, int dim) {
+  CHECK(!return_inverse && !return_counts && dim < 0)
+      << "ValueError: unique only supports the flattened unique elements, without the inverse "
+      << "indices and the counts";
+  if (data->device.device_type != kDLCPU) {
+    std::string name = "vm.builtin.unique." + std::string(DeviceName(data->device.device_type));
+    const PackedFunc* f = Registry::Get(name);
+    CHECK(f != nullptr) << "ValueError: unique is not supported on " << data->device
+                        << ", as " << name << " is not registered";
+    return (*f)(data, sorted);
+  }
+  CHECK(data.IsContiguous()) << "ValueError: unique expects a contiguous tensor";
+
+  DLDataType dtype = data->dtype;
+  CHECK_EQ(dtype.lanes, 1) << "ValueError: unique does not support vector types";
+  if (dtype.code == kDLInt) {
+    switch (dtype.bits) {
+      case 8:
+        return UniqueCPU<int8_t>(data, sorted);
+      case 16:
+        return UniqueCPU<int16_t>(data, sorted);
+      case 32:
+        return UniqueCPU<int32_t>(data, sorted);
+      case 64:
+        return UniqueCPU<int64_t>(data, sorted);
+    }
+  } else if (dtype.code == kDLUInt) {
+    switch (dtype.bits) {
+      case 8:
+        return UniqueCPU<uint8_t>(data, sorted);
+      case 16:
+        return UniqueCPU<uint16_t>(data, sorted);
+      case 32:
+        return UniqueCPU<uint32_t>(data, sorted);
+      case 64:
+        return UniqueCPU<uint64_t>(data, sorted);
+    }
+  } else if (dtype.code == kDLFloat) {
+    switch (dtype.bits) {
+      case 32:
+        return UniqueCPU<float>(data, sorted);
+      case 64:
+        return UniqueCPU<double>(data, sorted);
+    }
+  }
+  LOG(FATAL) << "ValueError: unique does not support the data type " << DLDataType2String(dtype);
+  return NDArray();
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.unique").set_body_typed(Unique);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
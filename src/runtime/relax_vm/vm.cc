@@ -21,25 +21,37 @@
  * \file src/runtime/relax_vm/vm.cc
  */
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+#include "../library_module.h"
+#include "./constant_pager.h"
+
+/*!
+ * \brief Whether to use computed-goto (threaded) dispatch in the VM loop.
+ *  Compilers without the labels-as-values extension fall back to the switch loop.
+ */
+#ifndef TVM_RELAX_VM_THREADED_DISPATCH
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_RELAX_VM_THREADED_DISPATCH 1
+#else
+#define TVM_RELAX_VM_THREADED_DISPATCH 0
+#endif
+#endif
 
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
-inline TVMRetValue CopyConstantTo(TVMRetValue src, const DLDevice& dev) {
-  NDArray nd_array = src.operator tvm::runtime::NDArray();
-  if (nd_array->device.device_type == dev.device_type &&
-      nd_array->device.device_id == dev.device_id) {
-    return src;
-  }
-  TVMRetValue ret;
-  ret = nd_array.CopyTo(dev);
-  return ret;
-}
-
 VMFunction VirtualMachine::LookupVMFunction(const std::string& func_name) {
   ICHECK(exec_) << "The executable is not created yet.";
   const auto& m = this->exec_->global_map;
@@ -78,6 +90,22 @@ ObjectRef IndexIntoNestedObject(ObjectRef obj, TVMArgs args, int starting_arg_id
   return obj;
 }
 
+/*! \brief Whether the output, or each of its fields, is the buffer bound to it. */
+inline bool IsBoundOutput(const ObjectRef& out, const std::vector<NDArray>& bound) {
+  if (const auto* adt = out.as<ADTObj>()) {
+    if (adt->size != bound.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < adt->size; ++i) {
+      if (!bound[i].defined() || !(*adt)[i].same_as(bound[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return bound.size() == 1 && bound[0].defined() && out.same_as(bound[0]);
+}
+
 PackedFunc VirtualMachine::GetFunction(const std::string& name,
                                        const ObjectPtr<Object>& sptr_to_self) {
   if (name == "vm_initialization") {
@@ -98,17 +126,50 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
         alloc_types.push_back(AllocatorType(type));
       }
       this->Init(devices, alloc_types);
-
-      // Copy NDArray constants to the devices
-      // TODO(tvm-team): support multiple devices
-      this->constants.reserve(exec_->constants.size());
-      for (const auto& constant : exec_->constants) {
-        if (constant.type_code() != kTVMNDArrayHandle) {
-          this->constants.push_back(constant);
-        } else {
-          this->constants.push_back(CopyConstantTo(constant, devices[0]));
-        }
-      }
+    });
+  } else if (name == "set_constant_paging") {
+    // Upload the constants on first use within a device memory budget, instead of all of them
+    // at initialization. Takes the budget in bytes and the number of upcoming calls whose
+    // constants are prefetched, and must be called before vm_initialization.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 2);
+      ICHECK(devices.empty()) << "set_constant_paging must be called before vm_initialization";
+      int64_t budget = args[0];
+      int lookahead = args[1];
+      ICHECK_GE(budget, 0);
+      ICHECK_GE(lookahead, 0);
+      this->constant_budget_ = budget;
+      this->constant_lookahead_ = lookahead;
+    });
+  } else if (name == "set_ccl_config") {
+    // Join a group of workers running the shards of the model, by its name, the number of workers
+    // and the rank of this one. The communicator of the group is created by vm_initialization,
+    // which returns once all the workers have joined.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 3);
+      ICHECK(devices.empty()) << "set_ccl_config must be called before vm_initialization";
+      this->ccl_group_ = args[0].operator std::string();
+      this->ccl_world_size_ = args[1];
+      this->ccl_rank_ = args[2];
+      CHECK(!ccl_group_.empty()) << "ValueError: The group of workers must be named";
+    });
+  } else if (name == "set_thread_pool") {
+    // Run the parallel kernels on a named thread pool, e.g. of the cores reserved for this model.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 1);
+      this->thread_pool_ = args[0].operator std::string();
+    });
+  } else if (name == "set_replicate_constants") {
+    // Copy the host constants on the thread pool instead of sharing those of the executable, e.g.
+    // for a replica per NUMA node. Must be called before vm_initialization.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 1);
+      ICHECK(devices.empty()) << "set_replicate_constants must be called before vm_initialization";
+      this->replicate_constants_ = args[0];
+    });
+  } else if (name == "create_context") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = Module(this->CreateContext());
     });
   } else if (name == "save_function") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -182,6 +243,19 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       }
       outputs_[func_name] = this->Invoke(gf_idx, inputs_[func_name]);
     });
+  } else if (name == "invoke_zero_copy") {
+    // Like set_input_zero_copy followed by invoke_stateful, in a single call. Returns whether each
+    // tensor of the output is the buffer bound to it, in which case the caller need not get the
+    // output.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      SetInput(func_name, args, 1, true);
+      Index gf_idx = exec_->global_map.at(func_name);
+      RegType out = this->Invoke(gf_idx, inputs_[func_name]);
+      outputs_[func_name] = out;
+      auto it = bound_outputs_.find(gf_idx);
+      *rv = it != bound_outputs_.end() && IsBoundOutput(out.AsObjectRef<ObjectRef>(), it->second);
+    });
   } else if (name == "get_output_arity") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       std::string func_name = args[0];
@@ -208,9 +282,197 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       }
       *rv = obj;
     });
+  } else if (name == "capture_cuda_graph") {
+    // Return a function that captures `func_name` into CUDA graphs keyed by
+    // the input shapes, and replays the captured graph on later calls. A VM on
+    // ROCm captures HIP graphs instead.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      LookupVMFunction(func_name);
+      bool rocm = !devices.empty() && devices[0].device_type == kDLROCM;
+      const PackedFunc* make_runner =
+          Registry::Get(rocm ? "vm.hip_graph.make_runner" : "vm.cuda_graph.make_runner");
+      ICHECK(make_runner != nullptr) << "ValueError: `capture_cuda_graph` requires TVM to be built "
+                                     << "with " << (rocm ? "ROCm" : "CUDA") << ".";
+      *rv = (*make_runner)(Module(sptr_to_self), func_name);
+    });
+  } else if (name == "freeze_allocators" || name == "unfreeze_allocators") {
+    // Freeze the allocators of the devices after the warm-up runs, so that the later runs are
+    // served from their arenas without allocating from the devices, or unfreeze them. The
+    // allocators are shared by the VMs on the same devices, which must not run meanwhile.
+    bool freeze = name == "freeze_allocators";
+    return PackedFunc([sptr_to_self, this, freeze](TVMArgs args, TVMRetValue* rv) {
+      ICHECK(!allocators.empty()) << "The VM is not initialized yet.";
+      if (!freeze) {
+        // The result of the last call may hold a buffer of the arena.
+        return_value_ = nullptr;
+      }
+      std::unordered_set<Allocator*> visited;
+      for (Allocator* alloc : allocators) {
+        if (visited.insert(alloc).second) {
+          freeze ? alloc->Freeze() : alloc->Unfreeze();
+        }
+      }
+    });
+  } else if (name == "make_batcher") {
+    // Return a function that gathers the concurrent calls of `func_name` into batches.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      int64_t max_batch_size = args[1];
+      int64_t max_delay_us = args[2];
+      LookupVMFunction(func_name);
+      static const PackedFunc* make_batcher = Registry::Get("vm.batching.make_batcher");
+      ICHECK(make_batcher != nullptr);
+      *rv = (*make_batcher)(Module(sptr_to_self), func_name, max_batch_size, max_delay_us);
+    });
+  } else if (name == "make_shape_dispatcher") {
+    // Return a module recording the argument shapes of the calls of `func_name`, and dispatching
+    // the calls to the VMs of the functions specialized for their shapes.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      int64_t max_num_shapes = args[1];
+      LookupVMFunction(func_name);
+      static const PackedFunc* make_dispatcher = Registry::Get("vm.shape_dispatch.make_dispatcher");
+      ICHECK(make_dispatcher != nullptr);
+      *rv = (*make_dispatcher)(Module(sptr_to_self), func_name, max_num_shapes);
+    });
+  } else if (name == "profile") {
+    // Run a function once with every call timed on its device and its allocations recorded, and
+    // return the profiling report. The trace of the run is kept for `get_chrome_trace`.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_GE(args.size(), 1);
+      std::string func_name = args[0];
+      const auto& m = exec_->global_map;
+      if (m.find(func_name) == m.end()) {
+        LOG(FATAL) << "ValueError: Unknown function: " << func_name;
+      }
+      std::vector<RegType> inputs(args.size() - 1);
+      for (int i = 1; i < args.size(); ++i) {
+        SetInputTensorWithIndex(inputs, args[i], i - 1, devices[0]);
+      }
+      *rv = this->Profile(m.at(func_name), inputs);
+    });
+  } else if (name == "profile_with_collectors") {
+    // Same as `profile`, with the metrics of the given collectors added to each call, e.g. the
+    // hardware counters of the kernels. The collectors cannot go through RPC.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_GE(args.size(), 2);
+      std::string func_name = args[0];
+      const auto& m = exec_->global_map;
+      if (m.find(func_name) == m.end()) {
+        LOG(FATAL) << "ValueError: Unknown function: " << func_name;
+      }
+      Array<profiling::MetricCollector> collectors = args[1];
+      std::vector<RegType> inputs(args.size() - 2);
+      for (int i = 2; i < args.size(); ++i) {
+        SetInputTensorWithIndex(inputs, args[i], i - 2, devices[0]);
+      }
+      *rv = this->Profile(m.at(func_name), inputs, {collectors.begin(), collectors.end()});
+    });
+  } else if (name == "get_chrome_trace") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->ChromeTrace(); });
+  } else if (name == "set_sampling") {
+    // Time a fraction of the top-level invocations, and every `call_stride`-th call of them, on
+    // the device timers without synchronizing, into latency histograms shared with the contexts
+    // created afterwards. A rate of 0 turns sampling off.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 2);
+      ICHECK(exec_) << "The executable is not loaded yet.";
+      double invocation_rate = args[0];
+      int64_t call_stride = args[1];
+      CHECK(invocation_rate >= 0.0 && invocation_rate <= 1.0)
+          << "ValueError: invocation_rate must be in [0, 1], but gets " << invocation_rate;
+      CHECK_GE(call_stride, 1) << "ValueError: call_stride must be positive";
+      // The pending timers refer to the histograms about to be replaced.
+      sample_timers_.Flush();
+      sample_credit_ = 0.0;
+      if (invocation_rate == 0.0) {
+        sampling_ = nullptr;
+        return;
+      }
+      auto state = std::make_shared<SamplingState>();
+      state->invocation_rate = invocation_rate;
+      state->call_stride = call_stride;
+      state->function_latency =
+          std::make_unique<profiling::LatencyHistogram[]>(exec_->global_funcs.size());
+      state->call_latency =
+          std::make_unique<profiling::LatencyHistogram[]>(exec_->func_names.size());
+      sampling_ = std::move(state);
+    });
+  } else if (name == "get_sampled_stats") {
+    // The latency histograms may be read while the contexts sharing them keep recording. The
+    // timers of the last sampled invocation of each other context are read at its next one.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      sample_timers_.Flush();
+      *rv = this->SampledStats();
+    });
+  } else if (name == "reset_sampled_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      if (sampling_ == nullptr) return;
+      sample_timers_.Flush();
+      for (size_t i = 0; i < exec_->global_funcs.size(); ++i) {
+        sampling_->function_latency[i].Reset();
+      }
+      for (size_t i = 0; i < exec_->func_names.size(); ++i) {
+        sampling_->call_latency[i].Reset();
+      }
+    });
   } else if (name == "set_input") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetInput(args[0], args, 1); });
+  } else if (name == "set_input_zero_copy") {
+    // Like set_input, but the inputs must be on the device already and are never copied.
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetInput(args[0], args, 1, true); });
+  } else if (name == "set_input_dlpack") {
+    // Like set_input, but the inputs are the handles of DLManagedTensors, whose ownership is taken,
+    // so that the tensors of another framework or language binding on the device are not copied.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<NDArray> arrays;
+      arrays.reserve(args.size());
+      std::vector<TVMValue> values(args.size());
+      std::vector<int> tcodes(args.size());
+      values[0] = args.values[0];
+      tcodes[0] = args.type_codes[0];
+      TVMArgsSetter setter(values.data(), tcodes.data());
+      for (int i = 1; i < args.size(); ++i) {
+        void* handle = args[i];
+        CHECK(handle != nullptr) << "ValueError: Input " << i - 1 << " is a null DLManagedTensor";
+        arrays.push_back(NDArray::FromDLPack(static_cast<DLManagedTensor*>(handle)));
+        setter(i, arrays.back());
+      }
+      SetInput(args[0], TVMArgs(values.data(), tcodes.data(), args.size()), 1);
+    });
+  } else if (name == "set_output_zero_copy") {
+    // Bind a buffer to a tensor of the output of a function, which the function then writes its
+    // result into instead of allocating one. Takes the function name, the index of the tensor in
+    // the output (0 if the output is not a tuple) and the buffer, or None to unbind it.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 3);
+      std::string func_name = args[0];
+      int index = args[1];
+      const auto& m = exec_->global_map;
+      if (m.find(func_name) == m.end()) {
+        LOG(FATAL) << "ValueError: Unknown function: " << func_name;
+      }
+      CHECK_GE(index, 0) << "ValueError: Invalid output index " << index;
+      std::vector<NDArray>& bound = bound_outputs_[m.at(func_name)];
+      if (static_cast<size_t>(index) >= bound.size()) {
+        bound.resize(index + 1);
+      }
+      if (args[2].type_code() == kTVMNullptr) {
+        bound[index] = NDArray(nullptr);
+      } else if (args[2].type_code() == kTVMDLTensorHandle) {
+        DLTensor* tensor = args[2];
+        CHECK(NDArray::AbilityOfZeroCopyForDLTensor(tensor, tensor->device))
+            << "ValueError: The buffer bound to output " << index << " of " << func_name
+            << " is not aligned";
+        bound[index] = NDArray::FromExternalDLTensor(*tensor);
+      } else {
+        bound[index] = args[2].operator NDArray();
+      }
+    });
   } else if (name == "get_function_arity") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       std::string func_name = args[0];
@@ -244,11 +506,7 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
                    << " must be used to invoke a function!";
         return;
       } else {
-        std::vector<RegType> inputs(args.size());
-        for (int i = 0; i < args.size(); ++i) {
-          inputs[i] = args[i];
-        }
-        *rv = this->Invoke(gf_idx, inputs);
+        *rv = this->Invoke(gf_idx, args);
       }
     });
   } else {
@@ -261,61 +519,273 @@ void VirtualMachine::LoadExecutable(ObjectPtr<Executable> exec) {
   this->exec_ = exec;
   CHECK_LE(exec_->imports().size(), 1);
   this->lib = exec_->imports().empty() ? Optional<Module>(NullOpt) : exec_->imports()[0];
+  this->PredecodeInstructions();
+  // The functions compiled to native code are found in the kernel library by their symbol.
+  native_funcs_.assign(exec_->global_funcs.size(), nullptr);
+  if (this->lib.defined()) {
+    for (size_t i = 0; i < exec_->global_funcs.size(); ++i) {
+      native_funcs_[i] =
+          this->lib.value()->GetFunction("__vmtir__" + exec_->global_funcs[i].name, true);
+    }
+  }
 }
 
-RegType VirtualMachine::Invoke(Index gf_idx, const std::vector<RegType>& args) {
+void VirtualMachine::PredecodeInstructions() {
+  // Size the function table up front so that decoded instructions
+  // can hold stable pointers into it.
+  func_table_.clear();
+  func_table_.resize(exec_->func_names.size(), nullptr);
+  call_tir_dyn_kernels_.clear();
+
+  size_t num_instrs = exec_->instr_offset.size();
+  instrs_.clear();
+  instrs_.reserve(num_instrs + 1);
+  for (size_t i = 0; i < num_instrs; ++i) {
+    DecodedInstruction instr(exec_->GetInstruction(i));
+    if (instr.op == Opcode::Call) {
+      ICHECK_LT(static_cast<size_t>(instr.func_idx), func_table_.size())
+          << "Call instruction at pc " << i << " refers to unknown packed function "
+          << instr.func_idx;
+      instr.func = &func_table_[instr.func_idx];
+    }
+    instrs_.push_back(instr);
+  }
+  // Terminate the stream so that running past the last instruction is caught.
+  DecodedInstruction sentinel;
+  sentinel.op = static_cast<Opcode>(0);
+  instrs_.push_back(sentinel);
+}
+
+VMFrame* VirtualMachine::PushInvokeFrame(Index gf_idx, size_t num_args) {
   const VMFunction& gfunc = exec_->global_funcs[gf_idx];
   // Get the curr instr which might be a potential caller.
-  Instruction curr_instr = exec_->GetInstruction(pc_);
+  const DecodedInstruction& curr_instr = instrs_[pc_];
   PushFrame(this->pc_, gfunc);
   // Get new frame and set the caller info.
   VMFrame* curr_frame = frames_.back().get();
-  if (curr_instr.op == Opcode::Call) {
+  curr_frame->func_index = gf_idx;
+  if (curr_instr.op == Opcode::Call || curr_instr.op == Opcode::InvokeClosure) {
     curr_frame->caller_return_register = curr_instr.dst;
+  } else {
+    // Invoked from outside of the dispatch loop, e.g. by the native code of a compiled function.
+    curr_frame->caller_return_register = Instruction::kVoidArg;
   }
 
   // load arguments to the register file
-  ICHECK_EQ(static_cast<size_t>(gfunc.num_args), args.size())
+  ICHECK_EQ(static_cast<size_t>(gfunc.num_args), num_args)
       << "ValueError: Invoking function " << gfunc.name << " requires " << gfunc.num_args
-      << " inputs but only " << args.size() << " inputs are provided.";
+      << " inputs but only " << num_args << " inputs are provided.";
+  return curr_frame;
+}
+
+RegType VirtualMachine::Invoke(Index gf_idx, const std::vector<RegType>& args) {
+  threading::ThreadPoolScope thread_pool_scope(thread_pool_);
+  VMFrame* curr_frame = PushInvokeFrame(gf_idx, args.size());
   for (size_t i = 0; i < args.size(); ++i) {
-    WriteRegister(frames_.back().get(), i, args[i]);
+    WriteRegister(curr_frame, i, args[i]);
   }
-  // set program counter
-  pc_ = gfunc.start_instr;
-  RunLoop();
+  RunFunction(gf_idx);
+  return return_value_;
+}
+
+RegType VirtualMachine::Invoke(Index gf_idx, TVMArgs args) {
+  threading::ThreadPoolScope thread_pool_scope(thread_pool_);
+  VMFrame* curr_frame = PushInvokeFrame(gf_idx, args.size());
+  for (int i = 0; i < args.size(); ++i) {
+    curr_frame->register_file[i] = args[i];
+  }
+  RunFunction(gf_idx);
   return return_value_;
 }
 
+void VirtualMachine::RunFunction(Index gf_idx) {
+  // set program counter
+  pc_ = exec_->global_funcs[gf_idx].start_instr;
+  // The native code makes the calls directly, so the profiled runs, the paged constants and the
+  // per-call device switches still go through the dispatch loop.
+  bool native = native_funcs_[gf_idx] != nullptr && profiler_ == nullptr &&
+                constant_pager_ == nullptr && !multi_device_;
+  auto run = [this, gf_idx, native]() { native ? RunNative(gf_idx) : RunLoop(); };
+  // Only the top-level invocations are sampled, together with the nested ones they run.
+  if (sampling_ == nullptr || frames_.size() != 1) {
+    run();
+    return;
+  }
+  sample_credit_ += sampling_->invocation_rate;
+  sampling_run_ = sample_credit_ >= 1.0;
+  if (!sampling_run_) {
+    run();
+    return;
+  }
+  sample_credit_ -= 1.0;
+  // The timers of the earlier sampled invocations have finished by now in the common case.
+  sample_timers_.Flush();
+  Timer timer = sample_timers_.Start(devices[0]);
+  run();
+  timer->Stop();
+  sample_timers_.Add(timer, &sampling_->function_latency[gf_idx]);
+  sampling_run_ = false;
+}
+
 void VirtualMachine::Init(const std::vector<Device>& devices,
                           const std::vector<AllocatorType>& alloc_types) {
-  // TODO(@yuchen): support multi-device heterogeneous execution
-  ICHECK_LT(devices.size(), 3)
-      << "Currently relax vm only supports at most 2 devices (host + device)";
   ICHECK_EQ(devices.size(), alloc_types.size());
 
   this->devices.reserve(devices.size());
   this->allocators.reserve(alloc_types.size());
   for (size_t i = 0; i < devices.size(); i++) {
+    CHECK_NE(alloc_types[i], kPinnedHost)
+        << "ValueError: The pinned host allocator only allocates the staging buffers of transfers";
     auto alloc = MemoryManager::GetOrCreateAllocator(devices[i], alloc_types[i]);
     this->devices.push_back(devices[i]);
     this->allocators.push_back(alloc);
   }
+  this->alloc_types_ = alloc_types;
+  if (!ccl_group_.empty() && !communicator.defined()) {
+    communicator = Communicator::Create(ccl_group_, ccl_world_size_, ccl_rank_, devices[0]);
+  }
+  // Slot 0 of every pool stands for the default stream.
+  streams_.assign(devices.size(), std::vector<TVMStreamHandle>(1, nullptr));
+  multi_device_ = std::count_if(devices.begin(), devices.end(), [](const Device& dev) {
+                    return dev.device_type != kDLCPU;
+                  }) > 1;
+
+  // The constants are copied to the first device once per executable, and onto the other devices
+  // consuming them on first use, see CopyToDevice.
+  ICHECK(exec_) << "The executable is not loaded yet.";
+  if (constant_budget_ >= 0 && devices[0].device_type != kDLCPU) {
+    // Keep the constants on the host, the pager uploads them on demand.
+    ObjectPtr<Executable> exec = exec_;
+    this->constants = std::shared_ptr<const std::vector<TVMRetValue>>(
+        &exec_->constants, [exec](const std::vector<TVMRetValue>*) {});
+    this->constant_pager_ =
+        std::make_unique<ConstantPager>(&exec_->constants, devices[0], constant_budget_);
+  } else {
+    this->constants = exec_->GetDeviceConstants(devices[0]);
+    if (replicate_constants_ && devices[0].device_type == kDLCPU) {
+      if (replica_constants_ == nullptr) {
+        replica_constants_ = ReplicateConstants(*this->constants);
+      }
+      this->constants = replica_constants_;
+    }
+    for (const TVMRetValue& constant : *this->constants) {
+      if (constant.type_code() == kTVMNDArrayHandle) {
+        constant_copies_.emplace(constant.operator NDArray().get(), std::vector<NDArray>());
+      }
+    }
+  }
+  // Resolve the callees and call arguments ahead of the first request.
+  this->ResolveFuncTable();
+  this->PrepareCallArgTemplates();
 }
 
-void VirtualMachine::PrepareFuncTable(Index func_index) {
-  // fast path, function already in cache;
+std::shared_ptr<const std::vector<TVMRetValue>> VirtualMachine::ReplicateConstants(
+    const std::vector<TVMRetValue>& constants) {
+  auto pool = std::make_shared<std::vector<TVMRetValue>>(constants);
+  auto f_copy = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    std::vector<TVMRetValue>* pool = static_cast<std::vector<TVMRetValue>*>(cdata);
+    try {
+      for (size_t i = task_id; i < pool->size(); i += penv->num_task) {
+        TVMRetValue& constant = (*pool)[i];
+        if (constant.type_code() == kTVMNDArrayHandle) {
+          NDArray src = constant.operator NDArray();
+          constant = src.CopyTo(src->device);
+        }
+      }
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to replicate the constants: " << e.what();
+      return -1;
+    }
+    return 0;
+  };
+  // A named pool runs all the tasks on its own workers, pinned to its CPUs, so that the copies
+  // are first touched there.
+  threading::ThreadPoolScope thread_pool_scope(thread_pool_);
+  CHECK_EQ(TVMBackendParallelLaunch(f_copy, pool.get(), 0), 0)
+      << "RuntimeError: Failed to replicate the constants";
+  return pool;
+}
 
-  if (static_cast<Index>(func_table_.size()) > func_index && func_table_[func_index] != nullptr)
-    return;
+ObjectPtr<VirtualMachine> VirtualMachine::CreateContext() {
+  ICHECK(exec_) << "The executable is not loaded yet.";
+  ICHECK(!devices.empty()) << "The VirtualMachine is not initialized yet.";
+  ObjectPtr<VirtualMachine> ctx = make_object<VirtualMachine>();
+  ctx->LoadExecutable(exec_);
+  ctx->constant_budget_ = constant_budget_;
+  ctx->constant_lookahead_ = constant_lookahead_;
+  ctx->thread_pool_ = thread_pool_;
+  ctx->replicate_constants_ = replicate_constants_;
+  ctx->replica_constants_ = replica_constants_;
+  ctx->sampling_ = sampling_;
+  // The contexts are of the same worker, sharing its communicator.
+  ctx->communicator = communicator;
+  ctx->Init(devices, alloc_types_);
+  return ctx;
+}
 
-  if (static_cast<Index>(func_table_.size()) <= func_index) {
-    func_table_.resize(func_index + 1, nullptr);
+VirtualMachine::VirtualMachine() = default;
+
+VirtualMachine::~VirtualMachine() {
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    for (size_t j = 1; j < streams_[i].size(); ++j) {
+      if (streams_[i][j] != nullptr) {
+        DeviceAPI::Get(devices[i])->FreeStream(devices[i], streams_[i][j]);
+      }
+    }
   }
+}
 
-  const std::string& func_name = exec_->func_names[func_index];
+const PackedFunc& VirtualMachine::GetCallTIRDynKernel(const String& func_name) {
+  auto it = call_tir_dyn_kernels_.find(func_name);
+  if (it != call_tir_dyn_kernels_.end()) return it->second;
+  PackedFunc func = ResolvePackedFunc(func_name, false);
+  return call_tir_dyn_kernels_.emplace(func_name, func).first->second;
+}
 
-  // lookup function and populate
+NDArray VirtualMachine::CopyToDevice(const NDArray& src, Index device_index) {
+  ICHECK_LT(device_index, devices.size()) << "The device index is out of VM physical devices list";
+  const Device& dev = devices[device_index];
+  if (src->device.device_type == dev.device_type && src->device.device_id == dev.device_id) {
+    return src;
+  }
+  auto it = constant_copies_.find(src.get());
+  if (it != constant_copies_.end()) {
+    it->second.resize(devices.size());
+    if (it->second[device_index].defined()) {
+      return it->second[device_index];
+    }
+  }
+  NDArray dst = allocators[device_index]->Empty(
+      std::vector<int64_t>(src->shape, src->shape + src->ndim), src->dtype, dev);
+  NDArray::CopyFromTo(src.operator->(), const_cast<DLTensor*>(dst.operator->()), nullptr);
+  if (src->device.device_type != kDLCPU && dev.device_type != kDLCPU) {
+    // A peer copy is ordered on the source device, while the kernels reading the tensor run on
+    // the target one.
+    DeviceAPI::Get(src->device)->StreamSync(src->device, nullptr);
+  }
+  if (it != constant_copies_.end()) {
+    it->second[device_index] = dst;
+  }
+  return dst;
+}
+
+TVMStreamHandle VirtualMachine::GetStream(Index device_index, Index stream_index) {
+  ICHECK_LT(device_index, streams_.size()) << "The device index is out of VM physical devices list";
+  ICHECK_GE(stream_index, 0);
+  if (stream_index == 0 || devices[device_index].device_type == kDLCPU) {
+    return nullptr;
+  }
+  std::vector<TVMStreamHandle>& pool = streams_[device_index];
+  if (static_cast<size_t>(stream_index) >= pool.size()) {
+    pool.resize(stream_index + 1, nullptr);
+  }
+  if (pool[stream_index] == nullptr) {
+    pool[stream_index] = DeviceAPI::Get(devices[device_index])->CreateStream(devices[device_index]);
+  }
+  return pool[stream_index];
+}
+
+PackedFunc VirtualMachine::ResolvePackedFunc(const std::string& func_name, bool allow_missing) {
   PackedFunc func{nullptr};
   if (this->lib.defined()) {
     func = this->lib.value()->GetFunction(func_name, true);
@@ -324,19 +794,93 @@ void VirtualMachine::PrepareFuncTable(Index func_index) {
     const PackedFunc* p_func = Registry::Get(func_name);
     if (p_func == nullptr) {
       const auto& m = exec_->global_map;
-      ICHECK(m.find(func_name) != m.end())
-          << "Error: Cannot find function " << func_name
-          << " in either Relax VM kernel library, or in TVM runtime PackedFunc registry, or in "
-             "global Relax functions of the VM executable";
+      if (m.find(func_name) == m.end()) {
+        ICHECK(allow_missing)
+            << "Error: Cannot find function " << func_name
+            << " in either Relax VM kernel library, or in TVM runtime PackedFunc registry, or in "
+               "global Relax functions of the VM executable";
+        return PackedFunc(nullptr);
+      }
       func = this->GetFunction(func_name, GetObjectPtr<Object>(this));
     } else {
       func = *(p_func);
     }
   }
-  func_table_[func_index] = func;
+  return func;
 }
 
-void VirtualMachine::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
+void VirtualMachine::PrepareFuncTable(Index func_index) {
+  // fast path, function already in cache;
+
+  if (static_cast<Index>(func_table_.size()) > func_index && func_table_[func_index] != nullptr)
+    return;
+
+  if (static_cast<Index>(func_table_.size()) <= func_index) {
+    func_table_.resize(func_index + 1, nullptr);
+  }
+
+  // lookup function and populate
+  func_table_[func_index] = ResolvePackedFunc(exec_->func_names[func_index], false);
+}
+
+void VirtualMachine::ResolveFuncTable() {
+  ICHECK_EQ(func_table_.size(), exec_->func_names.size());
+  for (size_t i = 0; i < func_table_.size(); ++i) {
+    if (func_table_[i] == nullptr) {
+      func_table_[i] = ResolvePackedFunc(exec_->func_names[i], true);
+    }
+  }
+}
+
+void VirtualMachine::PrepareCallArgTemplates() {
+  size_t num_calls = 0;
+  for (const DecodedInstruction& instr : instrs_) {
+    if (instr.op == Opcode::Call) ++num_calls;
+  }
+  // Reserve up front: decoded instructions keep pointers into the template list.
+  call_arg_templates_.clear();
+  call_arg_templates_.reserve(num_calls);
+  for (DecodedInstruction& instr : instrs_) {
+    if (instr.op != Opcode::Call) continue;
+    CallArgTemplate tmpl;
+    tmpl.values.resize(instr.num_args);
+    tmpl.tcodes.resize(instr.num_args);
+    runtime::TVMArgsSetter setter(tmpl.values.data(), tmpl.tcodes.data());
+    for (Index i = 0; i < instr.num_args; ++i) {
+      Instruction::Arg arg = instr.args[i];
+      switch (arg.kind()) {
+        case Instruction::kRegister: {
+          if (arg.value() == Instruction::kVMRegister) {
+            setter(i, this);
+          } else {
+            tmpl.reg_args.emplace_back(i, arg.value());
+          }
+          break;
+        }
+        case Instruction::kImmediate: {
+          setter(i, arg.value());
+          break;
+        }
+        case Instruction::kConstIdx: {
+          const TVMRetValue& constant = (*this->constants)[arg.value()];
+          if (constant_pager_ != nullptr && constant.type_code() == kTVMNDArrayHandle) {
+            tmpl.const_args.emplace_back(i, arg.value());
+          } else {
+            setter(i, constant);
+          }
+          break;
+        }
+        default: {
+          LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+        }
+      }
+    }
+    call_arg_templates_.push_back(std::move(tmpl));
+    instr.arg_template = &call_arg_templates_.back();
+  }
+}
+
+void VirtualMachine::RunInstrCall(VMFrame* curr_frame, const DecodedInstruction& instr) {
   DLOG(INFO) << "\n  pc = " << pc_ << ", execute: " << exec_->func_names[instr.func_idx];
 
   // Use the call arg stack from the current frame to increase reuse
@@ -350,84 +894,503 @@ void VirtualMachine::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   std::vector<int>& tcodes = curr_frame->call_arg_tcodes;
 
   runtime::TVMArgsSetter setter(values.data(), tcodes.data());
-  for (Index i = 0; i < instr.num_args; ++i) {
-    Instruction::Arg arg = instr.args[i];
-    switch (arg.kind()) {
-      case Instruction::kRegister: {
-        if (arg.value() == Instruction::kVMRegister) {
-          setter(i, this);
-        } else {
-          setter(i, ReadRegister(curr_frame, arg.value()));
-        }
-        break;
-      }
-      case Instruction::kImmediate: {
-        setter(i, arg.value());
-        break;
-      }
-      case Instruction::kConstIdx: {
-        setter(i, this->constants[arg.value()]);
-        break;
+  if (instr.arg_template != nullptr) {
+    // fast path: start from the prebuilt arguments and only patch the registers.
+    const CallArgTemplate& tmpl = *instr.arg_template;
+    std::copy(tmpl.values.begin(), tmpl.values.end(), values.begin());
+    std::copy(tmpl.tcodes.begin(), tmpl.tcodes.end(), tcodes.begin());
+    for (const auto& reg_arg : tmpl.reg_args) {
+      setter(reg_arg.first, curr_frame->register_file[reg_arg.second]);
+    }
+    if (!tmpl.const_args.empty()) {
+      constant_pager_->BeginCall();
+      for (const auto& const_arg : tmpl.const_args) {
+        setter(const_arg.first, constant_pager_->Get(const_arg.second));
       }
-      default: {
-        LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+    }
+  } else {
+    // slow path: the VM has not been initialized with the constant pool yet.
+    for (Index i = 0; i < instr.num_args; ++i) {
+      Instruction::Arg arg = instr.args[i];
+      switch (arg.kind()) {
+        case Instruction::kRegister: {
+          if (arg.value() == Instruction::kVMRegister) {
+            setter(i, this);
+          } else {
+            setter(i, ReadRegister(curr_frame, arg.value()));
+          }
+          break;
+        }
+        case Instruction::kImmediate: {
+          setter(i, arg.value());
+          break;
+        }
+        case Instruction::kConstIdx: {
+          setter(i, (*this->constants)[arg.value()]);
+          break;
+        }
+        default: {
+          LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+        }
       }
     }
   }
   TVMArgs args(values.data(), tcodes.data(), values.size());
   TVMRetValue ret;
   // prepare and invoke
-  this->PrepareFuncTable(instr.func_idx);
-  func_table_[instr.func_idx].CallPacked(args, &ret);
+  if (*instr.func == nullptr) {
+    this->PrepareFuncTable(instr.func_idx);
+  }
+  Index call_pc = pc_;
+  if (multi_device_) {
+    // The kernels run on the current device of the thread, i.e. the one of their tensors.
+    for (int i = 0; i < args.size(); ++i) {
+      if (tcodes[i] == kTVMNDArrayHandle || tcodes[i] == kTVMDLTensorHandle) {
+        const DLTensor* tensor = args[i].operator DLTensor*();
+        if (tensor->device.device_type != kDLCPU) {
+          DeviceAPI::Get(tensor->device)->SetDevice(tensor->device);
+          break;
+        }
+      }
+    }
+  }
+  if (profiler_ != nullptr) {
+    this->RunProfiledCall(instr, args, &ret);
+  } else if (sampling_run_) {
+    this->RunSampledCall(instr, args, &ret);
+  } else if (TVMBackendPackedCFunc faddr = GetWrappedPackedCFunc(*instr.func)) {
+    // The kernels of the library take the argument stack as it is, without the PackedFunc.
+    TVMValue ret_value;
+    int ret_type_code = kTVMNullptr;
+    int status = (*faddr)(values.data(), tcodes.data(), instr.num_args, &ret_value,
+                          &ret_type_code, nullptr);
+    ICHECK_EQ(status, 0) << TVMGetLastError();
+    if (ret_type_code != kTVMNullptr) {
+      ret = TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
+    }
+  } else {
+    instr.func->CallPacked(args, &ret);
+  }
 
   // save the return value to the register
   if (instr.dst != Instruction::kVoidArg) {
     WriteRegister(curr_frame, instr.dst, ret);
   }
+  if (constant_lookahead_ > 0 && constant_pager_ != nullptr) {
+    this->PrefetchConstants(call_pc);
+  }
   // increment pc
   pc_++;
 }
 
-int64_t VirtualMachine::LoadScalarInt(RegName reg) const {
-  int64_t result = 0;
-  VMFrame* curr_frame = frames_.back().get();
-  const RegType& obj = ReadRegister(curr_frame, reg);
-  NDArray ndarray = obj.operator tvm::runtime::NDArray();
-  NDArray ndarray_host = ndarray.CopyTo(devices[0]);
+void VirtualMachine::RunProfiledCall(const DecodedInstruction& instr, TVMArgs args,
+                                     TVMRetValue* ret) {
+  using Clock = std::chrono::steady_clock;
+  // Wait for the work queued on every stream, so that the time of a call is its own.
+  auto sync = [this]() {
+    for (size_t i = 0; i < devices.size(); ++i) {
+      // Slot 0 is the default stream, the other null slots are streams not created yet.
+      for (size_t j = 0; j < streams_[i].size(); ++j) {
+        if (j == 0 || streams_[i][j] != nullptr) {
+          DeviceAPI::Get(devices[i])->StreamSync(devices[i], streams_[i][j]);
+        }
+      }
+    }
+  };
+  // The call runs on the device of its first tensor argument, or on the first device.
+  Device dev = devices[0];
+  std::vector<NDArray> tensors;
+  for (int i = 0; i < args.size(); ++i) {
+    if (args.type_codes[i] == kTVMNDArrayHandle) {
+      NDArray tensor = args[i];
+      if (tensors.empty()) dev = tensor->device;
+      tensors.push_back(tensor);
+    }
+  }
+  String shapes = profiling::ShapeString(tensors);
+  const std::string& name = exec_->func_names[instr.func_idx];
+  sync();
+  int64_t bytes_before = AllocatedBytes();
+  Clock::time_point start = Clock::now();
+  profiler_->StartCall(name, dev, {{"Argument Shapes", shapes}});
+  instr.func->CallPacked(args, ret);
+  int64_t bytes_after = AllocatedBytes();
+  int64_t bytes_allocated = bytes_after - bytes_before;
+  // The counters of the collectors are read once the kernels of the call are done.
+  sync();
+  profiler_->StopCall(
+      {{"Allocated Bytes", ObjectRef(make_object<profiling::CountNode>(bytes_allocated))}});
+  Clock::time_point end = Clock::now();
+  using Micros = std::chrono::duration<double, std::micro>;
+  trace_.push_back(TraceEvent{name, dev, Micros(start - trace_start_).count(),
+                              Micros(end - start).count(), shapes, bytes_after, bytes_allocated});
+}
 
-  switch (ndarray_host->dtype.bits) {
-    case 1: {
-      result = reinterpret_cast<bool*>(ndarray_host->data)[0];
+void VirtualMachine::RunSampledCall(const DecodedInstruction& instr, TVMArgs args,
+                                    TVMRetValue* ret) {
+  if (sampled_call_count_++ % sampling_->call_stride != 0) {
+    instr.func->CallPacked(args, ret);
+    return;
+  }
+  // The call runs on the device of its first tensor argument, or on the first device.
+  Device dev = devices[0];
+  for (int i = 0; i < args.size(); ++i) {
+    if (args.type_codes[i] == kTVMNDArrayHandle) {
+      dev = args[i].operator NDArray()->device;
       break;
     }
-    case 8: {
-      result = reinterpret_cast<int8_t*>(ndarray_host->data)[0];
-      break;
+  }
+  Timer timer = sample_timers_.Start(dev);
+  instr.func->CallPacked(args, ret);
+  timer->Stop();
+  sample_timers_.Add(timer, &sampling_->call_latency[instr.func_idx]);
+}
+
+std::string VirtualMachine::SampledStats() const {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  auto write = [&os](const std::vector<std::string>& names,
+                     const profiling::LatencyHistogram* histograms) {
+    const char* sep = "";
+    for (size_t i = 0; i < names.size(); ++i) {
+      const profiling::LatencyHistogram& histogram = histograms[i];
+      if (histogram.Count() == 0) continue;
+      os << sep << "\"" << names[i] << "\": {\"count\": " << histogram.Count()
+         << ", \"mean_us\": " << histogram.MeanNanos() / 1e3
+         << ", \"p50_us\": " << histogram.PercentileNanos(0.5) / 1e3
+         << ", \"p90_us\": " << histogram.PercentileNanos(0.9) / 1e3
+         << ", \"p99_us\": " << histogram.PercentileNanos(0.99) / 1e3
+         << ", \"max_us\": " << histogram.MaxNanos() / 1e3 << "}";
+      sep = ", ";
+    }
+  };
+  std::vector<std::string> function_names;
+  for (const VMFunction& func : exec_->global_funcs) {
+    function_names.push_back(func.name);
+  }
+  os << "{\"functions\": {";
+  if (sampling_ != nullptr) write(function_names, sampling_->function_latency.get());
+  os << "}, \"calls\": {";
+  if (sampling_ != nullptr) write(exec_->func_names, sampling_->call_latency.get());
+  os << "}}";
+  return os.str();
+}
+
+profiling::Report VirtualMachine::Profile(
+    Index gf_idx, const std::vector<RegType>& args,
+    const std::vector<profiling::MetricCollector>& collectors) {
+  ICHECK(profiler_ == nullptr) << "The VirtualMachine is being profiled already.";
+  std::vector<Device> devs;
+  for (Device dev : devices) {
+    auto same = [dev](Device other) { return std::equal_to<Device>()(dev, other); };
+    if (std::find_if(devs.begin(), devs.end(), same) == devs.end()) {
+      devs.push_back(dev);
+    }
+  }
+  profiler_ = std::make_unique<profiling::Profiler>(
+      devs, collectors,
+      std::unordered_map<String, ObjectRef>{{String("Executor"), String("Relax VM")}});
+  trace_.clear();
+  profiler_->Start();
+  trace_start_ = std::chrono::steady_clock::now();
+  try {
+    this->Invoke(gf_idx, args);
+  } catch (...) {
+    profiler_ = nullptr;
+    throw;
+  }
+  profiler_->Stop();
+  profiling::Report report = profiler_->Report();
+  profiler_ = nullptr;
+  return report;
+}
+
+int64_t VirtualMachine::AllocatedBytes() const {
+  int64_t bytes = 0;
+  for (size_t i = 0; i < allocators.size(); ++i) {
+    // Skip an allocator shared with an earlier device.
+    if (std::find(allocators.begin(), allocators.begin() + i, allocators[i]) !=
+        allocators.begin() + i) {
+      continue;
+    }
+    Map<String, ObjectRef> stats = allocators[i]->Stats();
+    auto it = stats.find("bytes_in_use");
+    if (it != stats.end()) {
+      bytes += (*it).second.as<profiling::CountNode>()->value;
+    }
+  }
+  return bytes;
+}
+
+std::string VirtualMachine::ChromeTrace() const {
+  // The calls of each device go to a track of their own, and the bytes in use to a counter.
+  std::vector<Device> tracks;
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  const char* sep = "";
+  for (const TraceEvent& event : trace_) {
+    auto same = [&event](Device dev) { return std::equal_to<Device>()(event.device, dev); };
+    size_t tid = std::find_if(tracks.begin(), tracks.end(), same) - tracks.begin();
+    if (tid == tracks.size()) {
+      tracks.push_back(event.device);
+    }
+    os << sep << "{\"name\": \"" << event.name << "\", \"cat\": \"call\", \"ph\": \"X\", "
+       << "\"pid\": 0, \"tid\": " << tid << ", \"ts\": " << event.start_us
+       << ", \"dur\": " << event.duration_us << ", \"args\": {\"Argument Shapes\": \""
+       << event.shapes << "\", \"Allocated Bytes\": " << event.bytes_allocated << "}}";
+    os << ", {\"name\": \"Bytes In Use\", \"ph\": \"C\", \"pid\": 0, \"ts\": "
+       << event.start_us + event.duration_us << ", \"args\": {\"bytes\": " << event.bytes_in_use
+       << "}}";
+    sep = ", ";
+  }
+  for (size_t tid = 0; tid < tracks.size(); ++tid) {
+    os << sep << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << tid
+       << ", \"args\": {\"name\": \"" << tracks[tid] << "\"}}";
+  }
+  os << "]}";
+  return os.str();
+}
+
+void VirtualMachine::PrefetchConstants(Index pc) {
+  // Look ahead along the straight-line code, the sentinel stops at the end of the stream.
+  int num_calls = 0;
+  for (Index i = pc + 1; num_calls < constant_lookahead_; ++i) {
+    const DecodedInstruction& instr = instrs_[i];
+    // The tuple and shape instructions make no calls, nor use the constants on the device.
+    if (instr.op == Opcode::MakeTuple || instr.op == Opcode::TupleGetItem ||
+        instr.op == Opcode::ShapeOf) {
+      continue;
+    }
+    if (instr.op != Opcode::Call) break;
+    ++num_calls;
+    if (instr.arg_template == nullptr) continue;
+    for (const auto& const_arg : instr.arg_template->const_args) {
+      constant_pager_->Prefetch(const_arg.second);
+    }
+  }
+}
+
+int64_t VirtualMachine::ReadCondition(const RegType& cond) {
+  // The ints and bools stay in the registers on the host, e.g. the constant conditions.
+  if (cond.type_code() == kDLInt) {
+    return cond.operator int64_t();
+  }
+  NDArray ndarray = cond.operator tvm::runtime::NDArray();
+  int64_t numel = 1;
+  for (int i = 0; i < ndarray->ndim; ++i) numel *= ndarray->shape[i];
+  CHECK_EQ(numel, 1) << "ValueError: The condition of If expects a scalar, but gets a tensor of "
+                     << numel << " elements";
+  NDArray ndarray_host = ndarray;
+  const Device& dev = ndarray->device;
+  if (dev.device_type != kDLCPU && dev.device_type != kDLCUDAHost &&
+      dev.device_type != kDLROCMHost) {
+    NDArray& staging =
+        scalar_readbacks_[{dev.device_type, dev.device_id, DLDataType2String(ndarray->dtype)}];
+    if (!staging.defined()) {
+      if (dev.device_type == kDLCUDA) {
+        Allocator* alloc = MemoryManager::GetOrCreateAllocator(dev, kPinnedHost);
+        staging = alloc->Empty(std::vector<int64_t>{}, ndarray->dtype,
+                               MemoryManager::PinnedHostDevice(dev));
+      } else {
+        staging = NDArray::Empty({}, ndarray->dtype, Device{kDLCPU, 0});
+      }
     }
-    case 16: {
-      result = reinterpret_cast<int16_t*>(ndarray_host->data)[0];
+    ndarray.CopyToAsync(staging, nullptr);
+    DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+    ndarray_host = staging;
+  }
+
+  switch (ndarray_host->dtype.bits) {
+    case 1:
+      return reinterpret_cast<bool*>(ndarray_host->data)[0];
+    case 8:
+      return reinterpret_cast<int8_t*>(ndarray_host->data)[0];
+    case 16:
+      return reinterpret_cast<int16_t*>(ndarray_host->data)[0];
+    case 32:
+      return reinterpret_cast<int32_t*>(ndarray_host->data)[0];
+    case 64:
+      return reinterpret_cast<int64_t*>(ndarray_host->data)[0];
+    default:
+      LOG(FATAL) << "Unknown scalar int type: " << DLDataType2String(ndarray_host->dtype);
+  }
+  return 0;
+}
+
+int64_t VirtualMachine::LoadScalarInt(RegName reg) {
+  return ReadCondition(ReadRegister(frames_.back().get(), reg));
+}
+
+inline RegType VirtualMachine::ReadArg(VMFrame* frame, Instruction::Arg arg) {
+  switch (arg.kind()) {
+    case Instruction::kRegister: {
+      if (arg.value() == Instruction::kVMRegister) {
+        RegType vm;
+        vm = static_cast<void*>(this);
+        return vm;
+      }
+      return ReadRegister(frame, arg.value());
+    }
+    case Instruction::kImmediate: {
+      RegType imm;
+      imm = arg.value();
+      return imm;
+    }
+    case Instruction::kConstIdx: {
+      const TVMRetValue& constant = (*this->constants)[arg.value()];
+      if (constant_pager_ != nullptr && constant.type_code() == kTVMNDArrayHandle) {
+        RegType paged;
+        paged = constant_pager_->Get(arg.value());
+        return paged;
+      }
+      return constant;
+    }
+    default:
+      LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+  }
+  return RegType();
+}
+
+inline void VirtualMachine::RunInstrTupleOrShape(VMFrame* curr_frame,
+                                                 const DecodedInstruction& instr) {
+  switch (instr.op) {
+    case Opcode::MakeTuple: {
+      std::vector<ObjectRef> fields;
+      fields.reserve(instr.num_args);
+      for (Index i = 0; i < instr.num_args; ++i) {
+        fields.push_back(ReadArg(curr_frame, instr.args[i]).operator ObjectRef());
+      }
+      RegType tuple;
+      tuple = ADT::Tuple(fields);
+      WriteRegister(curr_frame, instr.dst, tuple);
       break;
     }
-    case 32: {
-      result = reinterpret_cast<int32_t*>(ndarray_host->data)[0];
+    case Opcode::TupleGetItem: {
+      ADT tuple = ReadRegister(curr_frame, instr.tuple);
+      CHECK_LT(static_cast<size_t>(instr.field_index), tuple.size())
+          << "ValueError: TupleGetItem at pc " << pc_ << " gets field " << instr.field_index
+          << " of a tuple of " << tuple.size() << " fields";
+      RegType field;
+      field = tuple[instr.field_index];
+      WriteRegister(curr_frame, instr.dst, field);
       break;
     }
-    case 64: {
-      result = reinterpret_cast<int64_t*>(ndarray_host->data)[0];
+    case Opcode::ShapeOf: {
+      NDArray tensor = ReadRegister(curr_frame, instr.tensor);
+      RegType shape;
+      shape = tensor.Shape();
+      WriteRegister(curr_frame, instr.dst, shape);
       break;
     }
     default:
-      LOG(FATAL) << "Unknown scalar int type: " << DLDataType2String(ndarray_host->dtype);
+      LOG(FATAL) << "ValueError: Not a tuple or shape instruction at pc " << pc_;
+  }
+  pc_++;
+}
+
+void VirtualMachine::RunInstrInvokeClosure(VMFrame* curr_frame, const DecodedInstruction& instr) {
+  VMClosure closure = ReadArg(curr_frame, instr.args[0]);
+  auto it = exec_->global_map.find(closure->func_name);
+  CHECK(it != exec_->global_map.end())
+      << "ValueError: Unknown function of the closure: " << closure->func_name;
+  Index gf_idx = it->second;
+  size_t num_args = instr.num_args - 1;
+  // The arguments are read from the caller frame, which stays in place while the callee runs.
+  VMFrame* callee_frame = PushInvokeFrame(gf_idx, num_args + closure->free_vars.size());
+  for (size_t i = 0; i < num_args; ++i) {
+    WriteRegister(callee_frame, i, ReadArg(curr_frame, instr.args[i + 1]));
+  }
+  for (size_t i = 0; i < closure->free_vars.size(); ++i) {
+    RegType free_var;
+    free_var = closure->free_vars[i];
+    WriteRegister(callee_frame, num_args + i, free_var);
+  }
+  // The Ret of the callee writes the destination register and restores the pc.
+  RunFunction(gf_idx);
+  pc_++;
+}
+
+#if TVM_RELAX_VM_THREADED_DISPATCH
+
+void VirtualMachine::RunLoop() {
+  // Dispatch table indexed by opcode, see Opcode in bytecode.h.
+  static void* const kDispatchTable[] = {
+      &&op_invalid,        &&op_call,           &&op_ret,
+      &&op_goto,           &&op_if,             &&op_tuple_or_shape /* MakeTuple */,
+      &&op_tuple_or_shape /* TupleGetItem */,   &&op_tuple_or_shape /* ShapeOf */,
+      &&op_invoke_closure};
+  constexpr int kNumOpcodes = sizeof(kDispatchTable) / sizeof(kDispatchTable[0]);
+
+  VMFrame* curr_frame = frames_.back().get();
+  const DecodedInstruction* instr = nullptr;
+
+#define RELAX_VM_DISPATCH()                                       \
+  {                                                               \
+    DCHECK_LT(static_cast<size_t>(pc_), instrs_.size());          \
+    instr = &instrs_[pc_];                                        \
+    int op = static_cast<int>(instr->op);                         \
+    goto* kDispatchTable[(op >= 0 && op < kNumOpcodes) ? op : 0]; \
+  }
+
+  RELAX_VM_DISPATCH();
+
+op_call: {
+  this->RunInstrCall(curr_frame, *instr);
+  RELAX_VM_DISPATCH();
+}
+op_ret: {
+  // If we have hit the point from which we started
+  // running, we should return to the caller breaking
+  // the dispatch loop.
+  return_value_ = ReadRegister(curr_frame, instr->result);
+  RegName caller_return_register = curr_frame->caller_return_register;
+  PopFrame();
+  if (frames_.size() != 0 && caller_return_register != Instruction::kVoidArg) {
+    // return from a local call.
+    // Update the current frame to be the parent frame.
+    curr_frame = frames_.back().get();
+    WriteRegister(curr_frame, caller_return_register, return_value_);
   }
-  return result;
+  return;
+}
+op_goto: {
+  pc_ += instr->pc_offset;
+  RELAX_VM_DISPATCH();
+}
+op_if: {
+  int64_t cond_val = LoadScalarInt(instr->cond);
+  if (cond_val != 0) {
+    pc_++;
+  } else {
+    ICHECK_GT(instr->false_offset, 1);
+    pc_ += instr->false_offset;
+  }
+  RELAX_VM_DISPATCH();
+}
+op_tuple_or_shape: {
+  this->RunInstrTupleOrShape(curr_frame, *instr);
+  RELAX_VM_DISPATCH();
+}
+op_invoke_closure: {
+  this->RunInstrInvokeClosure(curr_frame, *instr);
+  RELAX_VM_DISPATCH();
+}
+op_invalid: {
+  LOG(FATAL) << "run into invalide section, pc = " << pc_;
+}
+#undef RELAX_VM_DISPATCH
 }
 
+#else
+
+// Fallback switch-based dispatch loop for compilers without computed goto.
 void VirtualMachine::RunLoop() {
   VMFrame* curr_frame = frames_.back().get();
 
   while (true) {
     ICHECK_LT(static_cast<size_t>(pc_), exec_->instr_offset.size()) << "run into invalide section";
-    Instruction instr = exec_->GetInstruction(pc_);
+    const DecodedInstruction& instr = instrs_[pc_];
     switch (instr.op) {
       case Opcode::Call: {
         this->RunInstrCall(curr_frame, instr);
@@ -440,7 +1403,7 @@ void VirtualMachine::RunLoop() {
         return_value_ = ReadRegister(curr_frame, instr.result);
         RegName caller_return_register = curr_frame->caller_return_register;
         PopFrame();
-        if (frames_.size() == 0) {
+        if (frames_.size() == 0 || caller_return_register == Instruction::kVoidArg) {
           // directly return if no frame in the call stack.
         } else {
           // return from a local call.
@@ -464,17 +1427,69 @@ void VirtualMachine::RunLoop() {
         }
         break;
       }
+      case Opcode::MakeTuple:
+      case Opcode::TupleGetItem:
+      case Opcode::ShapeOf: {
+        this->RunInstrTupleOrShape(curr_frame, instr);
+        break;
+      }
+      case Opcode::InvokeClosure: {
+        this->RunInstrInvokeClosure(curr_frame, instr);
+        break;
+      }
+      default:
+        LOG(FATAL) << "run into invalide section, pc = " << pc_;
     }
   }
 }
 
+#endif  // TVM_RELAX_VM_THREADED_DISPATCH
+
+void VirtualMachine::RunNative(Index gf_idx) {
+  VMFrame* curr_frame = frames_.back().get();
+  Index ret_reg = exec_->global_funcs[gf_idx].register_file_size;
+  curr_frame->register_file.resize(ret_reg + 1);
+  // The functions invoked by the native code are not called by an instruction.
+  pc_ = static_cast<Index>(instrs_.size()) - 1;
+  native_funcs_[gf_idx](static_cast<void*>(this),
+                        static_cast<void*>(curr_frame->register_file.data()),
+                        const_cast<void*>(static_cast<const void*>(this->constants->data())));
+  return_value_ = std::move(curr_frame->register_file[ret_reg]);
+  RegName caller_return_register = curr_frame->caller_return_register;
+  PopFrame();
+  if (frames_.size() != 0 && caller_return_register != Instruction::kVoidArg) {
+    WriteRegister(frames_.back().get(), caller_return_register, return_value_);
+  }
+}
+
 void VirtualMachine::PushFrame(Index ret_pc, const VMFunction& vm_func) {
-  frames_.emplace_back(std::make_unique<VMFrame>(ret_pc, vm_func.register_file_size));
+  if (frame_pool_.empty()) {
+    frames_.emplace_back(std::make_unique<VMFrame>(ret_pc, vm_func.register_file_size));
+  } else {
+    // reuse a recycled frame, which keeps the storage of previous calls.
+    frames_.emplace_back(std::move(frame_pool_.back()));
+    frame_pool_.pop_back();
+    frames_.back()->Reset(ret_pc, vm_func.register_file_size);
+  }
+}
+
+NDArray VirtualMachine::GetBoundOutput(Index output_index) const {
+  if (bound_outputs_.empty() || frames_.empty()) {
+    return NDArray(nullptr);
+  }
+  auto it = bound_outputs_.find(frames_.back()->func_index);
+  if (it == bound_outputs_.end() || static_cast<size_t>(output_index) >= it->second.size()) {
+    return NDArray(nullptr);
+  }
+  return it->second[output_index];
 }
 
 void VirtualMachine::PopFrame() {
   ICHECK_GT(frames_.size(), 0);
   pc_ = frames_.back()->return_pc;
+  // release the register values so that they do not outlive the call.
+  frames_.back()->Clear();
+  frame_pool_.emplace_back(std::move(frames_.back()));
   frames_.pop_back();
 }
 
@@ -486,7 +1501,7 @@ inline RegType VirtualMachine::ReadRegister(VMFrame* frame, Index r) const {
   return frame->register_file[r];
 }
 
-void VirtualMachine::SetInput(std::string func_name, TVMArgs args, int offset) {
+void VirtualMachine::SetInput(std::string func_name, TVMArgs args, int offset, bool zero_copy) {
   const auto& m = exec_->global_map;
   if (m.find(func_name) != m.end()) {
     Index gf_idx = m.at(func_name);
@@ -497,9 +1512,9 @@ void VirtualMachine::SetInput(std::string func_name, TVMArgs args, int offset) {
     std::vector<RegType> func_args(params_num);
     for (int i = offset; i < args.size(); ++i) {
       int index = i - offset;
-      SetInputTensorWithIndex(func_args, args[i], index, devices[0]);
+      SetInputTensorWithIndex(func_args, args[i], index, devices[0], zero_copy);
     }
-    inputs_.emplace(func_name, func_args);
+    inputs_[func_name] = std::move(func_args);
   } else {
     LOG(FATAL) << "ValueError: Unknown function: " << func_name;
   }
@@ -528,14 +1543,37 @@ inline ObjectRef CopyTo(ObjectRef src, const DLDevice& dev) {
   }
 }
 
+/*! \brief Check that the tensors of an input are on a device, so that they need no copy. */
+inline void CheckOnDevice(const ObjectRef& src, const DLDevice& dev, int index) {
+  if (const auto* adt = src.as<ADTObj>()) {
+    for (size_t i = 0; i < adt->size; i++) {
+      CheckOnDevice((*adt)[i], dev, index);
+    }
+    return;
+  }
+  ICHECK(src->IsInstance<NDArray::ContainerType>())
+      << "VM data must be NDArray or a list of NDArray, but received: " << src->_type_key;
+  const DLDevice& src_dev = Downcast<NDArray>(src)->device;
+  CHECK(src_dev.device_type == dev.device_type && src_dev.device_id == dev.device_id)
+      << "ValueError: Input " << index << " is on " << src_dev << ", which cannot be set without "
+      << "a copy to " << dev;
+}
+
 void VirtualMachine::SetInputTensorWithIndex(std::vector<RegType>& func_args,
-                                             const TVMArgValue& inp_tensor, int index, Device dev) {
+                                             const TVMArgValue& inp_tensor, int index, Device dev,
+                                             bool zero_copy) {
   if (inp_tensor.type_code() == kTVMDLTensorHandle) {
     if (NDArray::AbilityOfZeroCopyForDLTensor(inp_tensor, dev)) {
       func_args[index] = NDArray::FromExternalDLTensor(*inp_tensor);
     } else {
+      CHECK(!zero_copy) << "ValueError: Input " << index << " is not an aligned tensor on " << dev
+                        << ", which cannot be set without a copy";
       func_args[index] = NDArray::NewFromDLTensor(inp_tensor, dev);
     }
+  } else if (zero_copy) {
+    ObjectRef obj = inp_tensor;
+    CheckOnDevice(obj, dev, index);
+    func_args[index] = obj;
   } else {
     func_args[index] = CopyTo(inp_tensor, dev);
   }
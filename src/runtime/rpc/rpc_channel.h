@@ -53,6 +53,24 @@ class RPCChannel {
    * \return The actual bytes received.
    */
   virtual size_t Recv(void* data, size_t size) = 0;
+  /*!
+   * \brief Send a header followed by a payload over to the channel, which saves copying the
+   *  payload into a buffer after the header. The default sends the header alone while there is
+   *  any of it left, so the caller sends again until both are sent.
+   *
+   * \param header The header pointer.
+   * \param header_size The size of the header.
+   * \param data The payload pointer.
+   * \param size The size of the payload.
+   * \return The actual bytes sent, counted from the start of the header.
+   */
+  virtual size_t SendGather(const void* header, size_t header_size, const void* data,
+                            size_t size) {
+    if (header_size != 0) {
+      return Send(header, header_size);
+    }
+    return Send(data, size);
+  }
 };
 
 /*!
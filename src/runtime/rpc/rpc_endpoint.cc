@@ -101,6 +101,15 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   /*! \brief Finish the copy ack stage. */
   void FinishCopyAck() { this->SwitchToState(kRecvPacketNumBytes); }
 
+  /*!
+   * \brief Set the function to take the exceptions returned by the remote, which are thrown
+   *  when it is not set.
+   * \param fexception The function taking the exception message.
+   */
+  void SetExceptionHandler(std::function<void(const std::string&)> fexception) {
+    fexception_ = fexception;
+  }
+
   /*!
    * \brief Enter the io loop until the next event.
    * \param client_mode Whether we are in the client.
@@ -373,6 +382,10 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
       // switch to the state before sending exception.
       this->SwitchToState(kRecvPacketNumBytes);
       std::string msg = args[0];
+      if (fexception_ != nullptr) {
+        fexception_(msg);
+        return;
+      }
       LOG(FATAL) << "RPCError: Error caught from RPC call:\n" << msg;
     }
 
@@ -619,8 +632,18 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   std::string* remote_key_;
   // function to flush the writer.
   std::function<void()> flush_writer_;
+  // function to take the exceptions returned by the remote.
+  std::function<void(const std::string&)> fexception_;
 };
 
+/*! \brief Pass an error message to an async callback. */
+static void SendAsyncException(const RPCSession::FAsyncCallback& callback, const std::string& msg) {
+  TVMValue value;
+  value.v_str = msg.c_str();
+  int32_t tcode = kTVMStr;
+  callback(RPCCode::kException, TVMArgs(&value, &tcode, 1));
+}
+
 RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn) {
   RPCCode code = RPCCode::kCallFunc;
 
@@ -649,40 +672,241 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
   return code;
 }
 
+void RPCEndpoint::FlushWriter() {
+  while (writer_.bytes_available() != 0) {
+    size_t n = writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+    if (n == 0) break;
+  }
+}
+
+void RPCEndpoint::SendWithPayload(const void* payload, uint64_t nbytes) {
+  if (nbytes == 0) {
+    FlushWriter();
+    return;
+  }
+  // The header is small, and taken out of the ring buffer to be sent along with the payload.
+  std::string header(writer_.bytes_available(), '\0');
+  writer_.Read(&header[0], header.size());
+  const char* data = static_cast<const char*>(payload);
+  uint64_t total = header.size() + nbytes;
+  uint64_t sent = 0;
+  while (sent < total) {
+    size_t n;
+    if (sent < header.size()) {
+      n = channel_->SendGather(header.data() + sent, header.size() - sent, data, nbytes);
+    } else {
+      n = channel_->Send(data + (sent - header.size()), total - sent);
+    }
+    CHECK_NE(n, 0) << "Channel closes before the payload to " << name_ << " is sent";
+    sent += n;
+  }
+}
+
 void RPCEndpoint::Init() {
   // callback to flush the writer.
-  auto flush_writer = [this]() {
-    while (writer_.bytes_available() != 0) {
-      size_t n = writer_.ReadWithCallback(
-          [this](const void* data, size_t size) { return channel_->Send(data, size); },
-          writer_.bytes_available());
-      if (n == 0) break;
-    }
-  };
+  auto flush_writer = [this]() { this->FlushWriter(); };
 
   // Event handler
   handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer);
 
   // Quick function to for syscall remote.
   syscall_remote_ = PackedFunc([this](TVMArgs all_args, TVMRetValue* rv) {
-    std::lock_guard<std::mutex> lock(mutex_);
     RPCCode code = static_cast<RPCCode>(all_args[0].operator int());
     TVMArgs args(all_args.values + 1, all_args.type_codes + 1, all_args.num_args - 1);
+    auto write_packet = [this, code, args]() {
+      uint64_t packet_nbytes =
+          sizeof(code) +
+          handler_->PackedSeqGetNumBytes(args.values, args.type_codes, args.num_args, true);
+
+      // All packet begins with packet nbytes
+      handler_->Write(packet_nbytes);
+      handler_->Write(code);
+      handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
+    };
+    auto set_return = [rv](TVMArgs args) {
+      ICHECK_EQ(args.size(), 1);
+      *rv = args[0];
+    };
 
-    uint64_t packet_nbytes = sizeof(code) + handler_->PackedSeqGetNumBytes(
-                                                args.values, args.type_codes, args.num_args, true);
+    if (async_mode_) {
+      PostRequestAndWait(
+          [this, write_packet](RPCSession::FAsyncCallback callback) {
+            PendingRequest request;
+            request.callback = std::move(callback);
+            PostRequest(write_packet, std::move(request));
+          },
+          set_return);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_packet();
+    code = HandleUntilReturnEvent(true, set_return);
+    ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
+  });
+}
 
-    // All packet begins with packet nbytes
-    handler_->Write(packet_nbytes);
-    handler_->Write(code);
-    handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
+void RPCEndpoint::EnableAsync(int max_inflight) {
+  CHECK_GT(max_inflight, 0) << "ValueError: max_inflight must be positive, but gets "
+                            << max_inflight;
+  // No synchronous request is in flight once the lock is held.
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK(channel_) << "Expected connection to server " << name_
+                  << " to be active, but the connection was previously closed";
+  {
+    std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+    max_inflight_ = max_inflight;
+  }
+  pending_cv_.notify_all();
+  if (!async_mode_) {
+    receiver_ = std::thread([this]() { this->ReceiverLoop(); });
+    async_mode_ = true;
+  }
+}
 
-    code = HandleUntilReturnEvent(true, [rv](TVMArgs args) {
-      ICHECK_EQ(args.size(), 1);
-      *rv = args[0];
+void RPCEndpoint::PostRequest(const std::function<void()>& fwrite, PendingRequest request,
+                              const void* payload, uint64_t payload_nbytes) {
+  ICHECK(std::this_thread::get_id() != receiver_.get_id())
+      << "InternalError: Cannot post an RPC request on the receiver thread";
+  std::vector<RPCSession::FAsyncCallback> retired;
+  {
+    std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+    retired.swap(retired_);
+  }
+  // Release the values held by the completed requests, which may post requests themselves.
+  retired.clear();
+
+  // The requests are sent in the order they are pending, as the remote replies in that order.
+  std::lock_guard<std::mutex> lock(mutex_);
+  {
+    std::unique_lock<std::mutex> pending_lock(pending_mutex_);
+    pending_cv_.wait(pending_lock, [this]() {
+      return !closed_error_.empty() || pending_.size() < max_inflight_;
     });
-    ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
+    if (!closed_error_.empty()) {
+      std::string msg = closed_error_;
+      pending_lock.unlock();
+      if (request.callback != nullptr) {
+        SendAsyncException(request.callback, msg);
+      }
+      return;
+    }
+    fwrite();
+    pending_.push_back(std::move(request));
+  }
+  // A failed send leaves the request to the receiver, which fails it once the connection closes.
+  try {
+    SendWithPayload(payload, payload_nbytes);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to send an RPC request to " << name_ << ": " << e.what();
+  }
+}
+
+void RPCEndpoint::PostRequestAndWait(const std::function<void(RPCSession::FAsyncCallback)>& fpost,
+                                     const RPCSession::FEncodeReturn& setreturn) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  std::string error;
+  fpost([&](RPCCode status, TVMArgs args) {
+    if (status == RPCCode::kException) {
+      error = args[0].operator std::string();
+    } else if (setreturn != nullptr) {
+      try {
+        setreturn(args);
+      } catch (const std::exception& e) {
+        error = e.what();
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+    }
+    cv.notify_all();
   });
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&done]() { return done; });
+  if (!error.empty()) {
+    LOG(FATAL) << "RPCError: Error caught from RPC call:\n" << error;
+  }
+}
+
+void RPCEndpoint::ReceiverLoop() {
+  // Every reply is the one of the oldest pending request.
+  auto complete = [this](RPCCode status, TVMArgs args) {
+    PendingRequest request;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      ICHECK(!pending_.empty()) << "InternalError: Received a reply without a pending request";
+      request = std::move(pending_.front());
+      pending_.pop_front();
+    }
+    pending_cv_.notify_all();
+    TVMValue value;
+    int32_t tcode = kTVMNullptr;
+    value.v_handle = nullptr;
+    if (request.to_bytes != nullptr && status == RPCCode::kReturn) {
+      // The data of the copy ack follows, which is all received along with the packet.
+      ICHECK_EQ(args.size(), 0) << "InternalError: Expect the data of a copy from the remote";
+      handler_->ReadArray(reinterpret_cast<char*>(request.to_bytes), request.nbytes);
+      handler_->FinishCopyAck();
+      args = TVMArgs(&value, &tcode, 1);
+    }
+    if (request.callback != nullptr) {
+      request.callback(status, args);
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      retired_.push_back(std::move(request.callback));
+    }
+  };
+  handler_->SetExceptionHandler([&complete](const std::string& msg) {
+    TVMValue value;
+    value.v_str = msg.c_str();
+    int32_t tcode = kTVMStr;
+    complete(RPCCode::kException, TVMArgs(&value, &tcode, 1));
+  });
+
+  std::string error = "The connection is closed by the remote";
+  try {
+    while (true) {
+      size_t bytes_needed = handler_->BytesNeeded();
+      if (bytes_needed != 0) {
+        size_t n = reader_.WriteWithCallback(
+            [this](void* data, size_t size) { return channel_->Recv(data, size); }, bytes_needed);
+        if (n == 0) break;
+      }
+      RPCCode code = handler_->HandleNextEvent(
+          true, false, [&complete](TVMArgs args) { complete(RPCCode::kReturn, args); });
+      if (code == RPCCode::kCopyAck) {
+        complete(RPCCode::kReturn, TVMArgs(nullptr, nullptr, 0));
+      } else if (code == RPCCode::kShutdown) {
+        break;
+      }
+    }
+  } catch (const std::exception& e) {
+    error = e.what();
+  }
+  FailPendingRequests(error);
+}
+
+void RPCEndpoint::FailPendingRequests(const std::string& msg) {
+  std::deque<PendingRequest> pending;
+  std::string error = "RPCSessionError: The connection to " + name_ + " is closed: " + msg;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    closed_error_ = error;
+    pending.swap(pending_);
+  }
+  pending_cv_.notify_all();
+  for (const PendingRequest& request : pending) {
+    if (request.callback != nullptr) {
+      SendAsyncException(request.callback, error);
+    }
+  }
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  for (PendingRequest& request : pending) {
+    retired_.push_back(std::move(request.callback));
+  }
 }
 
 /*!
@@ -710,6 +934,11 @@ RPCEndpoint::~RPCEndpoint() { this->Shutdown(); }
 
 void RPCEndpoint::Shutdown() {
   if (channel_ != nullptr) {
+    // In the async mode, the shutdown is sent after the pending requests.
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (async_mode_) {
+      lock.lock();
+    }
     RPCCode code = RPCCode::kShutdown;
     uint64_t packet_nbytes = sizeof(code);
 
@@ -718,14 +947,15 @@ void RPCEndpoint::Shutdown() {
 
     // flush all writing buffer to output channel.
     try {
-      while (writer_.bytes_available() != 0) {
-        size_t n = writer_.ReadWithCallback(
-            [this](const void* data, size_t size) { return channel_->Send(data, size); },
-            writer_.bytes_available());
-        if (n == 0) break;
-      }
+      FlushWriter();
     } catch (const Error& e) {
     }
+    // The receiver stops once the remote closes the connection on shutdown.
+    if (receiver_.joinable()) {
+      receiver_.join();
+      std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+      retired_.clear();
+    }
     channel_.reset(nullptr);
   }
 }
@@ -785,6 +1015,14 @@ void RPCEndpoint::InitRemoteSession(TVMArgs args) {
 void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
                            const int* arg_type_codes, int num_args,
                            RPCSession::FEncodeReturn encode_return) {
+  if (async_mode_) {
+    PostRequestAndWait(
+        [&](RPCSession::FAsyncCallback callback) {
+          this->AsyncCallFunc(h, arg_values, arg_type_codes, num_args, callback);
+        },
+        encode_return);
+    return;
+  }
   std::lock_guard<std::mutex> lock(mutex_);
 
   handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
@@ -805,6 +1043,14 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
 }
 
 void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+  if (async_mode_) {
+    PostRequestAndWait(
+        [&](RPCSession::FAsyncCallback callback) {
+          this->AsyncCopyToRemote(from_bytes, to, nbytes, callback);
+        },
+        nullptr);
+    return;
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   RPCCode code = RPCCode::kCopyToRemote;
 
@@ -820,11 +1066,19 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, to);
   handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
+  SendWithPayload(from_bytes, nbytes);
   ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
 }
 
 void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
+  if (async_mode_) {
+    PostRequestAndWait(
+        [&](RPCSession::FAsyncCallback callback) {
+          this->AsyncCopyFromRemote(from, to_bytes, nbytes, callback);
+        },
+        nullptr);
+    return;
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   RPCCode code = RPCCode::kCopyFromRemote;
 
@@ -846,6 +1100,93 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   handler_->FinishCopyAck();
 }
 
+void RPCEndpoint::AsyncCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                                const int* arg_type_codes, int num_args,
+                                RPCSession::FAsyncCallback callback) {
+  ICHECK(async_mode_) << "InternalError: The endpoint is not in the async mode";
+  handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
+  PendingRequest request;
+  request.callback = std::move(callback);
+  PostRequest(
+      [&]() {
+        RPCCode code = RPCCode::kCallFunc;
+        uint64_t handle = reinterpret_cast<uint64_t>(h);
+        uint64_t packet_nbytes =
+            sizeof(code) + sizeof(handle) +
+            handler_->PackedSeqGetNumBytes(arg_values, arg_type_codes, num_args, true);
+
+        handler_->Write(packet_nbytes);
+        handler_->Write(code);
+        handler_->Write(handle);
+        handler_->SendPackedSeq(arg_values, arg_type_codes, num_args, true);
+      },
+      std::move(request));
+}
+
+void RPCEndpoint::AsyncCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                                    RPCSession::FAsyncCallback on_complete) {
+  ICHECK(async_mode_) << "InternalError: The endpoint is not in the async mode";
+  RPCCode code = RPCCode::kCopyToRemote;
+  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
+  ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
+      << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
+      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+
+  PendingRequest request;
+  request.callback = std::move(on_complete);
+  PostRequest(
+      [&]() {
+        uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
+        handler_->Write(overhead + nbytes);
+        handler_->Write(code);
+        RPCReference::SendDLTensor(handler_, to);
+        handler_->Write(nbytes);
+      },
+      std::move(request), from_bytes, nbytes);
+}
+
+void RPCEndpoint::AsyncCopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                      RPCSession::FAsyncCallback on_complete) {
+  ICHECK(async_mode_) << "InternalError: The endpoint is not in the async mode";
+  RPCCode code = RPCCode::kCopyFromRemote;
+  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
+  ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
+      << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
+      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+
+  PendingRequest request;
+  request.callback = std::move(on_complete);
+  request.to_bytes = to_bytes;
+  request.nbytes = nbytes;
+  PostRequest(
+      [&]() {
+        handler_->Write(RemoteCopyCalculatePacketOverheadSize(from, code, nbytes));
+        handler_->Write(code);
+        RPCReference::SendDLTensor(handler_, from);
+        handler_->Write(nbytes);
+      },
+      std::move(request));
+}
+
+void RPCEndpoint::AsyncFreeHandle(void* handle, int type_code) {
+  ICHECK(async_mode_) << "InternalError: The endpoint is not in the async mode";
+  TVMValue values[2];
+  int tcodes[2];
+  TVMArgsSetter setter(values, tcodes);
+  setter(0, handle);
+  setter(1, type_code);
+  PostRequest(
+      [&]() {
+        RPCCode code = RPCCode::kFreeHandle;
+        uint64_t packet_nbytes =
+            sizeof(code) + handler_->PackedSeqGetNumBytes(values, tcodes, 2, true);
+        handler_->Write(packet_nbytes);
+        handler_->Write(code);
+        handler_->SendPackedSeq(values, tcodes, 2, true);
+      },
+      PendingRequest());
+}
+
 // SysCallEventHandler functions
 void RPCGetGlobalFunc(RPCSession* handler, TVMArgs args, TVMRetValue* rv) {
   std::string name = args[0];
@@ -1013,11 +1354,20 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
   }
 
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
+    if (endpoint_->async_mode()) {
+      // The blocks are pipelined, and only the last one is waited for.
+      endpoint_->PostRequestAndWait(
+          [&](FAsyncCallback callback) {
+            this->AsyncCopyToRemote(local_from_bytes, remote_to, nbytes, callback);
+          },
+          nullptr);
+      return;
+    }
     RPCCode code = RPCCode::kCopyToRemote;
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
     uint64_t rpc_max_size = GetRPCMaxTransferSize();
     ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
+    const uint64_t block_size = std::min(rpc_max_size - overhead, transfer_chunk_bytes_);
     uint64_t block_count = 0;
     const uint64_t num_blocks = nbytes / block_size;
     void* from_bytes;
@@ -1039,11 +1389,19 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
+    if (endpoint_->async_mode()) {
+      endpoint_->PostRequestAndWait(
+          [&](FAsyncCallback callback) {
+            this->AsyncCopyFromRemote(remote_from, local_to_bytes, nbytes, callback);
+          },
+          nullptr);
+      return;
+    }
     RPCCode code = RPCCode::kCopyFromRemote;
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
     uint64_t rpc_max_size = GetRPCMaxTransferSize();
     ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
+    const uint64_t block_size = std::min(rpc_max_size - overhead, transfer_chunk_bytes_);
     uint64_t block_count = 0;
     const uint64_t num_blocks = nbytes / block_size;
     void* to_bytes;
@@ -1064,7 +1422,57 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     }
   }
 
+  void AsyncCallFunc(PackedFuncHandle func, const TVMValue* arg_values, const int* arg_type_codes,
+                     int num_args, FAsyncCallback callback) final {
+    if (!endpoint_->async_mode()) {
+      RPCSession::AsyncCallFunc(func, arg_values, arg_type_codes, num_args, callback);
+      return;
+    }
+    endpoint_->AsyncCallFunc(func, arg_values, arg_type_codes, num_args, callback);
+  }
+
+  void AsyncCopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes,
+                         FAsyncCallback on_complete) final {
+    if (!endpoint_->async_mode()) {
+      RPCSession::AsyncCopyToRemote(local_from_bytes, remote_to, nbytes, on_complete);
+      return;
+    }
+    RPCCode code = RPCCode::kCopyToRemote;
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
+    ForEachBlock(nbytes, std::min(rpc_max_size - overhead, transfer_chunk_bytes_), on_complete,
+                 [&](uint64_t offset, uint64_t block_nbytes, FAsyncCallback callback) {
+                   remote_to->byte_offset = offset;
+                   endpoint_->AsyncCopyToRemote(static_cast<uint8_t*>(local_from_bytes) + offset,
+                                                remote_to, block_nbytes, callback);
+                 });
+  }
+
+  void AsyncCopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes,
+                           FAsyncCallback on_complete) final {
+    if (!endpoint_->async_mode()) {
+      RPCSession::AsyncCopyFromRemote(remote_from, local_to_bytes, nbytes, on_complete);
+      return;
+    }
+    RPCCode code = RPCCode::kCopyFromRemote;
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
+    ForEachBlock(nbytes, std::min(rpc_max_size - overhead, transfer_chunk_bytes_), on_complete,
+                 [&](uint64_t offset, uint64_t block_nbytes, FAsyncCallback callback) {
+                   remote_from->byte_offset = offset;
+                   endpoint_->AsyncCopyFromRemote(remote_from,
+                                                  static_cast<uint8_t*>(local_to_bytes) + offset,
+                                                  block_nbytes, callback);
+                 });
+  }
+
   void FreeHandle(void* handle, int type_code) final {
+    if (endpoint_->async_mode()) {
+      endpoint_->AsyncFreeHandle(handle, type_code);
+      return;
+    }
     endpoint_->SysCallRemote(RPCCode::kFreeHandle, handle, type_code);
   }
 
@@ -1131,7 +1539,59 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   void Shutdown() final { endpoint_->Shutdown(); }
 
+  /*! \return The client endpoint of the session. */
+  const std::shared_ptr<RPCEndpoint>& endpoint() const { return endpoint_; }
+
+  /*!
+   * \brief Set the max bytes of data a copy sends in one packet, which bounds the buffers of a
+   *  large copy held by either side. The remote may limit the packets further.
+   * \param nbytes The max bytes of a chunk, or 0 for no limit.
+   */
+  void SetTransferChunkSize(int64_t nbytes) {
+    CHECK_GE(nbytes, 0) << "ValueError: The transfer chunk size must be non-negative";
+    transfer_chunk_bytes_ = nbytes == 0 ? UINT64_MAX : static_cast<uint64_t>(nbytes);
+  }
+
  private:
+  /*!
+   * \brief Post a copy in blocks of at most block_size bytes, and complete it once the replies of
+   *  all the blocks come back, which are in the order of the blocks.
+   */
+  template <typename FPostBlock>
+  static void ForEachBlock(uint64_t nbytes, uint64_t block_size, FAsyncCallback on_complete,
+                           FPostBlock fpost_block) {
+    if (nbytes == 0) {
+      TVMValue value;
+      int32_t tcode = kTVMNullptr;
+      value.v_handle = nullptr;
+      on_complete(RPCCode::kReturn, TVMArgs(&value, &tcode, 1));
+      return;
+    }
+    auto error = std::make_shared<std::string>();
+    FAsyncCallback on_block = [error](RPCCode status, TVMArgs args) {
+      if (status == RPCCode::kException && error->empty()) {
+        *error = args[0].operator std::string();
+      }
+    };
+    for (uint64_t offset = 0; offset < nbytes; offset += block_size) {
+      uint64_t block_nbytes = std::min(block_size, nbytes - offset);
+      if (offset + block_nbytes < nbytes) {
+        fpost_block(offset, block_nbytes, on_block);
+        continue;
+      }
+      fpost_block(offset, block_nbytes, [error, on_block, on_complete](RPCCode status,
+                                                                        TVMArgs args) {
+        on_block(status, args);
+        if (error->empty()) {
+          on_complete(status, args);
+        } else {
+          SendAsyncException(on_complete, *error);
+        }
+      });
+    }
+  }
+
+
   uint64_t GetRPCMaxTransferSize() {
     if (rpc_chunk_max_size_bytes_ > 0) {
       return (uint64_t)rpc_chunk_max_size_bytes_;
@@ -1155,12 +1615,25 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  uint64_t transfer_chunk_bytes_ = kRPCTransferChunkBytesDefault;
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
   return std::make_shared<RPCClientSession>(endpoint);
 }
 
+TVM_REGISTER_GLOBAL("rpc.SetTransferChunkSize").set_body_typed([](Module sess, int64_t nbytes) {
+  auto* client = dynamic_cast<RPCClientSession*>(RPCModuleGetSession(sess).get());
+  CHECK(client != nullptr) << "ValueError: The transfer chunk size requires an RPC client session";
+  client->SetTransferChunkSize(nbytes);
+});
+
+TVM_REGISTER_GLOBAL("rpc.EnableAsync").set_body_typed([](Module sess, int max_inflight) {
+  auto* client = dynamic_cast<RPCClientSession*>(RPCModuleGetSession(sess).get());
+  CHECK(client != nullptr) << "ValueError: The async mode requires an RPC client session";
+  client->endpoint()->EnableAsync(max_inflight);
+});
+
 uint64_t RemoteCopyCalculatePacketOverheadSize(DLTensor* tensor, RPCCode code, uint64_t nbytes) {
   uint64_t shape_bytes = tensor->ndim * sizeof(int64_t);
   uint64_t to_data = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(tensor->data));
@@ -26,10 +26,15 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "../../support/ring_buffer.h"
 #include "../minrpc/rpc_reference.h"
@@ -48,6 +53,8 @@ const int kRPCTrackerMagic = 0x2f271;
 const int kRPCSuccess = kRPCMagic + 0;
 // cannot found matched key in server
 const int kRPCMismatch = kRPCMagic + 2;
+// default max bytes of data a copy sends in one packet
+const uint64_t kRPCTransferChunkBytesDefault = 16 << 20;
 
 /*! \brief Enumeration code for the RPC tracker */
 enum class TrackerCode : int {
@@ -163,6 +170,64 @@ class RPCEndpoint {
    */
   void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
 
+  /*!
+   * \brief Switch the client endpoint to the async mode.
+   *
+   *  In the async mode, a request is sent without waiting for the replies of the ones sent
+   *  before it, so that the requests are pipelined over the connection. The remote serves the
+   *  requests in the order they are sent, so a receiver thread takes each reply as the one of the
+   *  oldest pending request, whose sequence number is its position in the queue, and completes
+   *  it. The synchronous calls keep working, and wait for their own replies in the queue.
+   *
+   * \param max_inflight The max number of pending requests, beyond which sending blocks.
+   */
+  void EnableAsync(int max_inflight);
+  /*! \return Whether the endpoint is in the async mode. */
+  bool async_mode() const { return async_mode_; }
+  /*!
+   * \brief Asynchronously call into remote function, in the async mode.
+   * \param handle The function handle
+   * \param arg_values The argument values, which are sent before returning.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param callback The callback of the return value or exception, called on the receiver thread.
+   */
+  void AsyncCallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
+                     const int* arg_type_codes, int num_args,
+                     RPCSession::FAsyncCallback callback);
+  /*!
+   * \brief Asynchronously copy bytes into remote array content, in the async mode.
+   * \param from_bytes The source host data, which is sent before returning.
+   * \param to The target array.
+   * \param nbytes The size of the memory in bytes.
+   * \param on_complete The callback to signal copy complete.
+   */
+  void AsyncCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                         RPCSession::FAsyncCallback on_complete);
+  /*!
+   * \brief Asynchronously copy bytes from remote array content, in the async mode.
+   * \param from The source array.
+   * \param to_bytes The target host data, which must stay alive until on_complete is called.
+   * \param nbytes The size of the memory in bytes.
+   * \param on_complete The callback to signal copy complete.
+   */
+  void AsyncCopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                           RPCSession::FAsyncCallback on_complete);
+  /*!
+   * \brief Free a remote handle without waiting for the reply, in the async mode.
+   *  A handle is only freed once it is no longer used, so nothing waits for the reply.
+   * \param handle The remote handle.
+   * \param type_code The type code of the underlying type.
+   */
+  void AsyncFreeHandle(void* handle, int type_code);
+  /*!
+   * \brief Post requests in the async mode and wait for their completion.
+   * \param fpost The function posting the requests, given the callback to complete them with.
+   * \param setreturn The function to receive the return value encodings, or null.
+   */
+  void PostRequestAndWait(const std::function<void(RPCSession::FAsyncCallback)>& fpost,
+                          const RPCSession::FEncodeReturn& setreturn);
+
   /*!
    * \brief Call a remote defined system function with arguments.
    * \param fcode The function code.
@@ -186,11 +251,31 @@ class RPCEndpoint {
 
  private:
   class EventHandler;
+  /*! \brief A request waiting for its reply in the async mode. */
+  struct PendingRequest {
+    /*! \brief The callback of the reply, or null if the reply is dropped. */
+    RPCSession::FAsyncCallback callback;
+    /*! \brief The target host data of a copy from the remote, or null. */
+    void* to_bytes{nullptr};
+    /*! \brief The size of the target host data. */
+    uint64_t nbytes{0};
+  };
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
   // Initalization
   void Init();
+  // Send the written requests to the channel.
+  void FlushWriter();
+  // Send the written requests followed by a payload straight from its own memory.
+  void SendWithPayload(const void* payload, uint64_t nbytes);
+  // Post a request in the async mode, whose packet is written by fwrite and ends with a payload.
+  void PostRequest(const std::function<void()>& fwrite, PendingRequest request,
+                   const void* payload = nullptr, uint64_t payload_nbytes = 0);
+  // Receive the replies of the pending requests in the async mode.
+  void ReceiverLoop();
+  // Fail the pending requests once the connection is closed.
+  void FailPendingRequests(const std::string& msg);
   // Internal channel.
   std::unique_ptr<RPCChannel> channel_;
 
@@ -208,6 +293,23 @@ class RPCEndpoint {
   std::string remote_key_;
   // Invoked when the RPC session is terminated
   TypedPackedFunc<void()> fcleanup_;
+  // Whether the endpoint is in the async mode.
+  std::atomic<bool> async_mode_{false};
+  // The max number of pending requests in the async mode.
+  size_t max_inflight_{0};
+  // The mutex guarding the pending requests, in the order they are sent.
+  std::mutex pending_mutex_;
+  // Notified when a pending request completes.
+  std::condition_variable pending_cv_;
+  // The pending requests, in the order they are sent.
+  std::deque<PendingRequest> pending_;
+  // The callbacks of the completed requests, released off the receiver thread, since releasing
+  // the values they hold may free remote handles, which posts requests.
+  std::vector<RPCSession::FAsyncCallback> retired_;
+  // The error the connection is closed with, after which no request is accepted.
+  std::string closed_error_;
+  // The thread receiving the replies in the async mode.
+  std::thread receiver_;
 };
 
 /*!
@@ -27,9 +27,15 @@
 #include <tvm/runtime/registry.h>
 
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #if defined(_M_X64) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
@@ -78,6 +84,106 @@ NDArray NDArrayFromRemoteOpaqueHandle(std::shared_ptr<RPCSession> sess, void* ha
   return NDArray(GetObjectPtr<Object>(data));
 }
 
+/*!
+ * \brief The result of an asynchronous RPC request, which completes on the receiver thread of the
+ *  session once the reply comes back.
+ */
+class RPCFutureObj : public Object {
+ public:
+  /*! \brief The objects kept alive along with the future, e.g. the arrays of a copy. */
+  std::vector<ObjectRef> keep_alive;
+
+  /*! \brief Complete the future with a value. */
+  void SetValue(TVMRetValue value) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      value_ = std::move(value);
+      done_ = true;
+    }
+    cv_.notify_all();
+  }
+  /*! \brief Complete the future with an error returned by the remote. */
+  void SetError(std::string error) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::move(error);
+      done_ = true;
+    }
+    cv_.notify_all();
+  }
+  /*! \brief Complete the future with the reply of a request. */
+  void SetReply(RPCCode status, TVMArgs args) {
+    if (status == RPCCode::kException) {
+      SetError(args[0].operator std::string());
+    } else {
+      SetValue(TVMRetValue());
+    }
+  }
+  /*! \return Whether the future is complete. */
+  bool Done() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_;
+  }
+  /*! \brief Wait for the future to complete, and return its value or throw its error. */
+  TVMRetValue Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return done_; });
+    if (!error_.empty()) {
+      LOG(FATAL) << "RPCError: Error caught from RPC call:\n" << error_;
+    }
+    return value_;
+  }
+
+  static constexpr const char* _type_key = "rpc.RPCFuture";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RPCFutureObj, Object);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_{false};
+  TVMRetValue value_;
+  std::string error_;
+};
+
+/*! \brief Managed reference to RPCFutureObj. */
+class RPCFuture : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(RPCFuture, ObjectRef, RPCFutureObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(RPCFutureObj);
+
+class RPCWrappedFunc;
+
+/*!
+ * \brief The remote functions by the PackedFuncs wrapping them, so that the PackedFuncs can be
+ *  called asynchronously.
+ */
+class RPCWrappedFuncTable {
+ public:
+  static RPCWrappedFuncTable* Global() {
+    static RPCWrappedFuncTable inst;
+    return &inst;
+  }
+  void Insert(const Object* packed_func, const RPCWrappedFunc* wf) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_[packed_func] = wf;
+  }
+  void Erase(const Object* packed_func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_.erase(packed_func);
+  }
+  const RPCWrappedFunc* Find(const Object* packed_func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = table_.find(packed_func);
+    return it == table_.end() ? nullptr : it->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<const Object*, const RPCWrappedFunc*> table_;
+};
+
 /*!
  * \brief A wrapped remote function as a PackedFunc.
  */
@@ -86,6 +192,66 @@ class RPCWrappedFunc : public Object {
   RPCWrappedFunc(void* handle, std::shared_ptr<RPCSession> sess) : handle_(handle), sess_(sess) {}
 
   void operator()(TVMArgs args, TVMRetValue* rv) const {
+    WithRemoteArgs(args, [&](const TVMValue* values, const int* type_codes) {
+      auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
+      sess_->CallFunc(handle_, values, type_codes, args.size(), set_return);
+    });
+  }
+
+  /*!
+   * \brief Call the function without waiting for its return, which is pipelined with the other
+   *  requests of the session in its async mode.
+   * \param self The PackedFunc wrapping this function, kept alive until the call completes.
+   * \param args The arguments.
+   * \return The future of the return value.
+   */
+  RPCFuture AsyncCall(PackedFunc self, TVMArgs args) const {
+    RPCFuture future(make_object<RPCFutureObj>());
+    future->keep_alive.push_back(self);
+    WithRemoteArgs(args, [&](const TVMValue* values, const int* type_codes) {
+      sess_->AsyncCallFunc(handle_, values, type_codes, args.size(),
+                           [this, future](RPCCode status, TVMArgs args) {
+                             if (status == RPCCode::kException) {
+                               future->SetError(args[0].operator std::string());
+                               return;
+                             }
+                             TVMRetValue rv;
+                             try {
+                               this->WrapRemoteReturnToValue(args, &rv);
+                             } catch (const std::exception& e) {
+                               future->SetError(e.what());
+                               return;
+                             }
+                             future->SetValue(std::move(rv));
+                           });
+    });
+    return future;
+  }
+
+  /*! \brief Wrap the function as a PackedFunc. */
+  static PackedFunc Wrap(void* handle, std::shared_ptr<RPCSession> sess) {
+    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess);
+    PackedFunc f([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    wf->packed_func_ = f.get();
+    RPCWrappedFuncTable::Global()->Insert(wf->packed_func_, wf.get());
+    return f;
+  }
+
+  ~RPCWrappedFunc() {
+    if (packed_func_ != nullptr) {
+      RPCWrappedFuncTable::Global()->Erase(packed_func_);
+    }
+    try {
+      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
+    } catch (const Error& e) {
+      // fault tolerance to remote close
+    }
+  }
+
+ private:
+  // translate the arguments to their remote variant, and call f with them.
+  template <typename F>
+  void WithRemoteArgs(TVMArgs args, F f) const {
     std::vector<TVMValue> values(args.values, args.values + args.size());
     std::vector<int> type_codes(args.type_codes, args.type_codes + args.size());
     std::vector<std::unique_ptr<DLTensor>> temp_dltensors;
@@ -125,21 +291,13 @@ class RPCWrappedFunc : public Object {
         }
       }
     }
-    auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
-    sess_->CallFunc(handle_, values.data(), type_codes.data(), args.size(), set_return);
+    f(values.data(), type_codes.data());
   }
 
-  ~RPCWrappedFunc() {
-    try {
-      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
-    } catch (const Error& e) {
-      // fault tolerance to remote close
-    }
-  }
-
- private:
   // remote function handle
   void* handle_{nullptr};
+  // The PackedFunc wrapping the function.
+  const Object* packed_func_{nullptr};
   // pointer to the session.
   std::shared_ptr<RPCSession> sess_;
 
@@ -242,8 +400,7 @@ class RPCModuleNode final : public ModuleNode {
 
   PackedFunc WrapRemoteFunc(RPCSession::PackedFuncHandle handle) {
     if (handle == nullptr) return PackedFunc();
-    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
-    return PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    return RPCWrappedFunc::Wrap(handle, sess_);
   }
 
   // The module handle
@@ -285,8 +442,7 @@ void RPCWrappedFunc::WrapRemoteReturnToValue(TVMArgs args, TVMRetValue* rv) cons
   if (tcode == kTVMPackedFuncHandle) {
     ICHECK_EQ(args.size(), 2);
     void* handle = args[1];
-    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
-    *rv = PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    *rv = RPCWrappedFunc::Wrap(handle, sess_);
   } else if (tcode == kTVMModuleHandle) {
     ICHECK_EQ(args.size(), 2);
     void* handle = args[1];
@@ -448,6 +604,74 @@ TVM_REGISTER_GLOBAL("rpc.SessTableIndex").set_body([](TVMArgs args, TVMRetValue*
   *rv = static_cast<RPCModuleNode*>(m.operator->())->sess()->table_index();
 });
 
+// functions of the async mode of a session.
+TVM_REGISTER_GLOBAL("rpc.AsyncCall").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK_GE(args.size(), 1) << "ValueError: Expect the remote function to call";
+  PackedFunc f = args[0];
+  const RPCWrappedFunc* wf = RPCWrappedFuncTable::Global()->Find(f.get());
+  CHECK(wf != nullptr) << "ValueError: Expect a function of an RPC session";
+  *rv = wf->AsyncCall(f, TVMArgs(args.values + 1, args.type_codes + 1, args.size() - 1));
+});
+
+/*! \brief The remote view of an array of an RPC session. */
+static DLTensor RemoteTensor(const NDArray& arr, std::shared_ptr<RPCSession>* sess) {
+  CHECK(IsRPCSessionDevice(arr->device)) << "ValueError: Expect an array of an RPC session";
+  CHECK(arr.IsContiguous()) << "ValueError: Expect a contiguous array";
+  const RemoteSpace* space = static_cast<const RemoteSpace*>(arr->data);
+  *sess = space->sess;
+  DLTensor tensor = *arr.operator->();
+  tensor.device = RemoveRPCSessionMask(arr->device);
+  tensor.data = space->data;
+  return tensor;
+}
+
+/*! \brief The local bytes of a host array to copy with an array of an RPC session. */
+static char* LocalBytes(const NDArray& local, const NDArray& remote) {
+  CHECK_EQ(local->device.device_type, kDLCPU) << "ValueError: Expect a local CPU array";
+  CHECK(local.IsContiguous()) << "ValueError: Expect a contiguous array";
+  CHECK_EQ(GetDataSize(*local.operator->()), GetDataSize(*remote.operator->()))
+      << "ValueError: The arrays to copy differ in size";
+  return static_cast<char*>(local->data) + local->byte_offset;
+}
+
+TVM_REGISTER_GLOBAL("rpc.AsyncCopyToRemote").set_body_typed([](NDArray from, NDArray to) {
+  std::shared_ptr<RPCSession> sess;
+  DLTensor remote_to = RemoteTensor(to, &sess);
+  RPCFuture future(make_object<RPCFutureObj>());
+  future->keep_alive = {from, to};
+  sess->AsyncCopyToRemote(
+      LocalBytes(from, to), &remote_to, GetDataSize(remote_to),
+      [future](RPCCode status, TVMArgs args) { future->SetReply(status, args); });
+  return future;
+});
+
+TVM_REGISTER_GLOBAL("rpc.AsyncCopyFromRemote").set_body_typed([](NDArray from, NDArray to) {
+  std::shared_ptr<RPCSession> sess;
+  DLTensor remote_from = RemoteTensor(from, &sess);
+  RPCFuture future(make_object<RPCFutureObj>());
+  future->keep_alive = {from, to};
+  sess->AsyncCopyFromRemote(&remote_from, LocalBytes(to, from), GetDataSize(remote_from),
+                            [future, to](RPCCode status, TVMArgs args) {
+                              if (status == RPCCode::kException) {
+                                future->SetReply(status, args);
+                              } else {
+                                TVMRetValue rv;
+                                rv = to;
+                                future->SetValue(std::move(rv));
+                              }
+                            });
+  return future;
+});
+
+TVM_REGISTER_GLOBAL("rpc.FutureDone").set_body_typed([](RPCFuture future) {
+  return future->Done();
+});
+
+TVM_REGISTER_GLOBAL("rpc.FutureResult").set_body([](TVMArgs args, TVMRetValue* rv) {
+  RPCFuture future = args[0];
+  *rv = future->Wait();
+});
+
 TVM_REGISTER_GLOBAL("tvm.rpc.NDArrayFromRemoteOpaqueHandle")
     .set_body_typed([](Module mod, void* remote_array, DLTensor* template_tensor, Device dev,
                        void* ndarray_handle) -> NDArray {
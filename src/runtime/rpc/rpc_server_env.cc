@@ -23,6 +23,19 @@
  */
 #include <tvm/runtime/registry.h>
 
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
 #include "../file_utils.h"
 
 namespace tvm {
@@ -35,6 +48,61 @@ std::string RPCGetPath(const std::string& name) {
   return (*f)(name);
 }
 
+/*!
+ * \brief Get the path of a file in the content-addressed cache of the uploads, which persists
+ *  across the sessions and the servers on the device.
+ *
+ *  The cache lives in TVM_RPC_CACHE_DIR if set, or in `rpc_cache` of the TVM cache directory.
+ * \param digest The hex digest of the content of the file.
+ */
+std::string RPCGetCachePath(const std::string& digest) {
+  CHECK(!digest.empty() && digest.find_first_not_of("0123456789abcdef") == std::string::npos)
+      << "ValueError: Expect the lowercase hex digest of an upload, but got " << digest;
+  const char* env_cache_dir = getenv("TVM_RPC_CACHE_DIR");
+  std::string dir = env_cache_dir ? env_cache_dir : GetCacheDir() + "/rpc_cache";
+  // Creating the parent directories one by one, ignoring the ones which exist.
+  size_t pos = 0;
+  do {
+    pos = dir.find('/', pos + 1);
+    std::string parent = dir.substr(0, pos);
+#ifdef _WIN32
+    _mkdir(parent.c_str());
+#else
+    mkdir(parent.c_str(), 0777);
+#endif
+  } while (pos != std::string::npos);
+  return dir + "/" + digest;
+}
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.upload_from_cache")
+    .set_body_typed([](std::string file_name, std::string digest) {
+      std::string cache_path = RPCGetCachePath(digest);
+      if (!std::ifstream(cache_path).good()) {
+        return false;
+      }
+      CopyFile(cache_path, RPCGetPath(file_name));
+      return true;
+    });
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.upload_to_cache").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::string file_name = RPCGetPath(args[0]);
+  std::string cache_path = RPCGetCachePath(args[1]);
+  std::string data = args[2];
+  SaveBinaryToFile(file_name, data);
+  // The file is renamed into the cache once complete, so that the servers reading the cache at the
+  // same time never see a partial file.
+#ifdef _WIN32
+  std::string temp_path = cache_path + ".tmp" + std::to_string(_getpid());
+#else
+  std::string temp_path = cache_path + ".tmp" + std::to_string(getpid());
+#endif
+  SaveBinaryToFile(temp_path, data);
+  if (std::rename(temp_path.c_str(), cache_path.c_str()) != 0) {
+    // Another server has cached the same content in the meantime.
+    std::remove(temp_path.c_str());
+  }
+});
+
 TVM_REGISTER_GLOBAL("tvm.rpc.server.upload").set_body([](TVMArgs args, TVMRetValue* rv) {
   std::string file_name = RPCGetPath(args[0]);
   std::string data = args[1];
@@ -52,6 +52,14 @@ class SockChannel final : public RPCChannel {
     }
     return static_cast<size_t>(n);
   }
+  size_t SendGather(const void* header, size_t header_size, const void* data,
+                    size_t size) final {
+    ssize_t n = sock_.SendGather(header, header_size, data, size);
+    if (n == -1) {
+      support::Socket::Error("SockChannel::SendGather");
+    }
+    return static_cast<size_t>(n);
+  }
   size_t Recv(void* data, size_t size) final {
     ssize_t n = sock_.Recv(data, size);
     if (n == -1) {
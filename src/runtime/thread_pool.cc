@@ -32,8 +32,14 @@
 #if TVM_THREADPOOL_USE_OPENMP
 #include <omp.h>
 #endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <memory>
@@ -41,6 +47,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "../support/utils.h"
@@ -60,6 +67,103 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+constexpr int kDefaultTasksPerThread = 4;
+
+int GetTasksPerThread() {
+  const char* val = getenv("TVM_THREAD_POOL_TASKS_PER_THREAD");
+  if (!val) {
+    return kDefaultTasksPerThread;
+  }
+  return std::max(atoi(val), 1);
+}
+
+bool GetWorkStealing() {
+  const char* val = getenv("TVM_THREAD_POOL_WORK_STEALING");
+  return val && atoi(val) != 0;
+}
+
+// The least spin budget a worker adapts to after idling.
+constexpr uint32_t kMinSpinCount = 1000;
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*!
+ * \brief A spin budget adapting to the traffic: it doubles, up to the configured spin count, when
+ *  the work comes while spinning, and halves when the thread has to park, so that the threads
+ *  stay responsive under steady traffic, and soon stop burning the cores when it is intermittent.
+ */
+class AdaptiveSpin {
+ public:
+  explicit AdaptiveSpin(uint32_t max_count)
+      : max_count_(max_count), count_(max_count), min_count_(std::min(kMinSpinCount, max_count)) {}
+
+  // The number of iterations to spin before parking.
+  uint32_t count() const { return count_; }
+  // Record whether the work came while spinning.
+  void Update(bool hit) {
+    if (hit) {
+      count_ = std::min(max_count_, std::max(count_, 1u) * 2);
+    } else {
+      count_ = std::max(min_count_, count_ / 2);
+    }
+  }
+
+ private:
+  uint32_t max_count_;
+  uint32_t count_;
+  uint32_t min_count_;
+};
+
+/*!
+ * \brief An atomic word to park threads on until it changes, which is a futex on Linux, and a
+ *  condition variable elsewhere.
+ */
+class ParkingWord {
+ public:
+  explicit ParkingWord(int32_t value) : word(value) {}
+
+  /*!
+   * \brief Park the calling thread while the word holds the expected value, until woken.
+   * \note The thread may also return spuriously, so the callers wait in a loop.
+   */
+  void Park(int32_t expected) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr,
+            nullptr, 0);
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (word.load() == expected) {
+      cv_.wait(lock);
+    }
+#endif
+  }
+
+  /*! \brief Wake all the threads parked on the word, after it changes. */
+  void WakeAll() {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr,
+            nullptr, 0);
+#else
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+#endif
+  }
+
+  std::atomic<int32_t> word;
+  static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t), "The futex needs a plain word");
+
+#if !defined(__linux__)
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+#endif
+};
+
 }  // namespace
 
 // stride in the page, fit to cache line.
@@ -72,7 +176,7 @@ class ParallelLauncher {
  public:
   // Reset the task request.
   void Init(FTVMParallelLambda flambda, void* cdata, int num_task, bool need_sync) {
-    num_pending_.store(num_task);
+    num_pending_.word.store(num_task);
     this->cdata = cdata;
     this->flambda = flambda;
     this->env.num_task = num_task;
@@ -80,10 +184,12 @@ class ParallelLauncher {
     // reshape
     if (static_cast<size_t>(num_task) > par_errors_.size()) {
       par_errors_.resize(num_task + 1);
-      if (need_sync) {
-        delete[] sync_counter_;
-        sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
-      }
+    }
+    // The launches without sync may have grown the errors without the counters
+    if (need_sync && num_task > num_sync_counters_) {
+      delete[] sync_counter_;
+      sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
+      num_sync_counters_ = num_task;
     }
     if (need_sync) {
       for (int i = 0; i < num_task; ++i) {
@@ -95,11 +201,22 @@ class ParallelLauncher {
     }
   }
   ~ParallelLauncher() { delete[] sync_counter_; }
-  // Wait n jobs to finish
+  // Wait n jobs to finish, spinning for a while before parking
   int WaitForJobs() {
-    while (num_pending_.load() != 0) {
+    static uint32_t spin_count = GetSpinCount();
+    thread_local AdaptiveSpin spin(spin_count);
+    uint32_t i = 0;
+    for (; i < spin.count() && num_pending_.word.load() != 0; ++i) {
       tvm::runtime::threading::Yield();
     }
+    spin.Update(i < spin.count());
+    if (num_pending_.word.load() != 0) {
+      waiting_.store(true);
+      for (int32_t n; (n = num_pending_.word.load()) != 0;) {
+        num_pending_.Park(n);
+      }
+      waiting_.store(false);
+    }
     if (!has_error_.load()) return 0;
     std::ostringstream os;
     for (size_t i = 0; i < par_errors_.size(); ++i) {
@@ -113,12 +230,34 @@ class ParallelLauncher {
   }
   // Signal that one job has finished.
   void SignalJobError(int task_id) {
-    num_pending_.fetch_sub(1);
     par_errors_[task_id] = TVMGetLastError();
     has_error_.store(true);
+    SignalJobFinish();
   }
   // Signal that one job has finished.
-  void SignalJobFinish() { num_pending_.fetch_sub(1); }
+  void SignalJobFinish() {
+    if (num_pending_.word.fetch_sub(1) == 1 && waiting_.load()) {
+      num_pending_.WakeAll();
+    }
+  }
+  // Open the tasks for the threads to claim one by one.
+  void OpenTasks() {
+    num_participants_.store(0);
+    next_task_.store(0);
+  }
+  // Whether there are tasks not claimed yet.
+  bool HasUnclaimedTasks() const { return next_task_.load() < env.num_task; }
+  // Claim a task, or return a task id no less than the number of tasks if none is left.
+  int ClaimTask() { return next_task_.fetch_add(1); }
+  // Join or leave the threads claiming the tasks.
+  void Join() { num_participants_.fetch_add(1); }
+  void Leave() { num_participants_.fetch_sub(1); }
+  // Wait until the joined threads leave, after all the tasks are claimed.
+  void WaitForParticipants() {
+    while (num_participants_.load() != 0) {
+      tvm::runtime::threading::Yield();
+    }
+  }
   // Get thread local version of the store.
   static ParallelLauncher* ThreadLocal() { return dmlc::ThreadLocalStore<ParallelLauncher>::Get(); }
   // The parallel lambda
@@ -132,12 +271,20 @@ class ParallelLauncher {
   bool is_worker{false};
 
  private:
-  // The pending jobs.
-  std::atomic<int32_t> num_pending_;
+  // The pending jobs, which the launching thread parks on.
+  ParkingWord num_pending_{0};
+  // Whether the launching thread may be parked.
+  std::atomic<bool> waiting_{false};
   // Whether error has been countered.
   std::atomic<bool> has_error_;
   // The counter page.
   std::atomic<int32_t>* sync_counter_{nullptr};
+  // The number of the counters in the page.
+  int num_sync_counters_{0};
+  // The next task to claim, in the work-stealing thread pool.
+  std::atomic<int32_t> next_task_{0};
+  // The threads claiming the tasks, in the work-stealing thread pool.
+  std::atomic<int32_t> num_participants_{0};
   // The error message
   std::vector<std::string> par_errors_;
 };
@@ -163,28 +310,43 @@ class SpscTaskQueue {
     while (!Enqueue(input)) {
       tvm::runtime::threading::Yield();
     }
-    if (pending_.fetch_add(1) == -1) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      cv_.notify_one();
+    if (pending_.word.fetch_add(1) == -1) {
+      pending_.WakeAll();
     }
   }
 
   /*!
    * \brief Pop a task out of the queue and condition wait if no tasks.
    * \param output The pointer to the task to be dequeued.
-   * \param spin_count The number of iterations to spin before sleep.
+   * \param spin The spin budget before sleep, adapted to whether the task comes while spinning.
+   * \param warm_until The time in microseconds until which to keep spinning regardless.
    * \return Whether pop is successful (true) or we need to exit now (false).
    */
-  bool Pop(Task* output, uint32_t spin_count) {
-    // Busy wait a bit when the queue is empty.
-    // If a new task comes to the queue quickly, this wait avoid the worker from sleeping.
-    // The default spin count is set by following the typical omp convention
-    for (uint32_t i = 0; i < spin_count && pending_.load() == 0; ++i) {
-      tvm::runtime::threading::Yield();
-    }
-    if (pending_.fetch_sub(1) == 0) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      cv_.wait(lock, [this] { return pending_.load() >= 0 || exit_now_.load(); });
+  bool Pop(Task* output, AdaptiveSpin* spin, const std::atomic<int64_t>* warm_until) {
+    while (true) {
+      // Busy wait a bit when the queue is empty.
+      // If a new task comes to the queue quickly, this wait avoid the worker from sleeping.
+      // The default spin count is set by following the typical omp convention
+      uint32_t i = 0;
+      for (; pending_.word.load() == 0 && !exit_now_.load(std::memory_order_relaxed); ++i) {
+        if (i >= spin->count() && NowMicros() >= warm_until->load(std::memory_order_relaxed)) {
+          break;
+        }
+        tvm::runtime::threading::Yield();
+      }
+      spin->Update(i < spin->count() || pending_.word.load() != 0);
+      if (pending_.word.fetch_sub(1) != 0) {
+        break;
+      }
+      // Park until a task comes, or until woken to spin for a warm up
+      while (pending_.word.load() < 0 && !exit_now_.load() && !warm_up_.exchange(false)) {
+        pending_.Park(-1);
+      }
+      // Back to spinning if woken with no task, unless a task comes in the meantime
+      int32_t parked = -1;
+      if (exit_now_.load() || !pending_.word.compare_exchange_strong(parked, 0)) {
+        break;
+      }
     }
     if (exit_now_.load(std::memory_order_relaxed)) {
       return false;
@@ -201,9 +363,16 @@ class SpscTaskQueue {
    * \brief Signal to terminate the worker.
    */
   void SignalForKill() {
-    std::lock_guard<std::mutex> lock(mutex_);
     exit_now_.store(true);
-    cv_.notify_all();
+    pending_.WakeAll();
+  }
+
+  /*!
+   * \brief Wake the worker if it is parked, to spin for the tasks to come.
+   */
+  void SignalForWarmUp() {
+    warm_up_.store(true);
+    pending_.WakeAll();
   }
 
  protected:
@@ -243,17 +412,14 @@ class SpscTaskQueue {
   std::atomic<uint32_t> tail_;
 
   cache_line_pad_t pad3_;
-  // pending tasks in the queue
-  std::atomic<int8_t> pending_{0};
+  // pending tasks in the queue, or -1 if the consumer is parked
+  ParkingWord pending_{0};
 
   cache_line_pad_t pad4_;
   // signal for exit now
   std::atomic<bool> exit_now_{false};
-
-  // internal mutex
-  std::mutex mutex_;
-  // cv for consumer
-  std::condition_variable cv_;
+  // signal for the parked consumer to spin
+  std::atomic<bool> warm_up_{false};
 };
 
 // The thread pool
@@ -267,6 +433,13 @@ class ThreadPool {
     Init();
   }
 
+  // A named pool shared by the threads bound to it, whose workers run all the tasks
+  ThreadPool(int num_workers, std::vector<unsigned int> cpus)
+      : num_workers_(num_workers), exclude_worker0_(false), shared_(true), cpus_(std::move(cpus)) {
+    ICHECK_GT(num_workers, 0) << "ValueError: A thread pool needs at least one worker";
+    Init();
+  }
+
   ~ThreadPool() {
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
       q->SignalForKill();
@@ -288,6 +461,11 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    // The queues of the workers take one launching thread at a time
+    std::unique_lock<std::mutex> lock(launch_mutex_, std::defer_lock);
+    if (shared_) {
+      lock.lock();
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -331,6 +509,13 @@ class ThreadPool {
 
   int32_t NumThreads() const { return num_workers_used_; }
 
+  void WarmUp(int64_t duration_us) {
+    warm_until_.store(NowMicros() + duration_us);
+    for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
+      q->SignalForWarmUp();
+    }
+  }
+
  private:
   // Shared initialization code
   void Init() {
@@ -341,7 +526,14 @@ class ThreadPool {
     threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
         num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
         exclude_worker0_ /* include_main_thread */);
-    num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    if (!shared_) {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    } else if (!cpus_.empty()) {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kSpecifyOneCorePerThread,
+                                              num_workers_, exclude_worker0_, cpus_);
+    } else {
+      num_workers_used_ = num_workers_;
+    }
   }
 
   // Internal worker function.
@@ -352,8 +544,9 @@ class ThreadPool {
     // Initialize the spin count (from envvar TVM_THREAD_POOL_SPIN_COUNT) on
     // the global first use of the ThreadPool.
     // TODO(tulloch): should we make this configurable via standard APIs?
-    static size_t spin_count = GetSpinCount();
-    while (queue->Pop(&task, spin_count)) {
+    static uint32_t spin_count = GetSpinCount();
+    AdaptiveSpin spin(spin_count);
+    while (queue->Pop(&task, &spin, &warm_until_)) {
       ICHECK(task.launcher != nullptr);
       TVMParallelGroupEnv* penv = &(task.launcher->env);
       void* cdata = task.launcher->cdata;
@@ -369,10 +562,268 @@ class ThreadPool {
   int num_workers_used_;
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
+  // whether the pool is a named one shared by the threads bound to it
+  bool shared_{false};
+  // the CPUs to bind the workers of a named pool to
+  std::vector<unsigned int> cpus_;
+  // the mutex serializing the launches on a named pool
+  std::mutex launch_mutex_;
+  // the time in microseconds until which the workers keep spinning, after a warm up
+  std::atomic<int64_t> warm_until_{0};
   std::vector<std::unique_ptr<SpscTaskQueue>> queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
 };
 
+class WorkStealingThreadPool;
+
+/*!
+ * \brief The named thread pools, and the binding of each thread to one of them.
+ */
+class NamedThreadPools {
+ public:
+  static NamedThreadPools* Global() {
+    static NamedThreadPools* inst = new NamedThreadPools();
+    return inst;
+  }
+
+  void Create(const std::string& name, int num_threads, std::vector<unsigned int> cpus) {
+    ICHECK(!name.empty()) << "ValueError: The name of a thread pool must not be empty";
+    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(num_threads, std::move(cpus));
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK(!pools_.count(name)) << "ValueError: The thread pool already exists: " << name;
+    pools_.emplace(name, std::move(pool));
+  }
+
+  void Remove(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK(pools_.erase(name)) << "ValueError: Unknown thread pool: " << name;
+  }
+
+  std::shared_ptr<ThreadPool> Get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pools_.find(name);
+    ICHECK(it != pools_.end()) << "ValueError: Unknown thread pool: " << name;
+    return it->second;
+  }
+
+  /*! \brief The thread local binding to a named pool. */
+  struct Binding {
+    std::string name;
+    std::shared_ptr<ThreadPool> pool;
+  };
+
+  static Binding* ThreadLocal() { return dmlc::ThreadLocalStore<Binding>::Get(); }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<ThreadPool>> pools_;
+};
+
+/*!
+ * \brief Thread local context of the work-stealing thread pool.
+ */
+struct WorkStealingContext {
+  // Whether the launches from this thread go to the work-stealing thread pool.
+  bool enabled{GetWorkStealing()};
+  // The pool whose worker this thread is, or nullptr.
+  WorkStealingThreadPool* pool{nullptr};
+  // The number of tasks running on the stack of this thread.
+  int task_depth{0};
+  // The number of launches waiting on the stack of this thread.
+  int launch_depth{0};
+  // The launchers of the launches on the stack, reused across the launches.
+  std::vector<std::unique_ptr<ParallelLauncher>> launchers;
+
+  static WorkStealingContext* ThreadLocal() {
+    return dmlc::ThreadLocalStore<WorkStealingContext>::Get();
+  }
+};
+
+/*!
+ * \brief The thread pool of chunked self-scheduling. Rather than assigning the tasks of a launch to
+ *  fixed workers, the launch is opened for the launching thread and the idle workers to claim its
+ *  tasks one by one, so that the threads done early take more of the tasks of an imbalanced loop.
+ *  The launches that leave the number of tasks to the runtime are split into several tasks per
+ *  thread for the purpose. A launch inside a task is a nested launch, whose tasks are claimed by
+ *  the launching thread and the workers idle at the time.
+ */
+class WorkStealingThreadPool {
+ public:
+  WorkStealingThreadPool()
+      : num_workers_(tvm::runtime::threading::MaxConcurrency()),
+        tasks_per_thread_(GetTasksPerThread()) {
+    Init();
+  }
+
+  ~WorkStealingThreadPool() { Shutdown(); }
+
+  void Reset() {
+    Shutdown();
+    Init();
+  }
+
+  int Launch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+    WorkStealingContext* ctx = WorkStealingContext::ThreadLocal();
+    bool nested = ctx->task_depth > 0;
+    if (num_task == 0) {
+      num_task = num_workers_used_ * tasks_per_thread_;
+    }
+    if (static_cast<int>(ctx->launchers.size()) == ctx->launch_depth) {
+      ctx->launchers.emplace_back(std::make_unique<ParallelLauncher>());
+    }
+    ParallelLauncher* launcher = ctx->launchers[ctx->launch_depth++].get();
+    // The barrier needs all the tasks to run at the same time, which only the outermost launches
+    // of no more tasks than the threads guarantee
+    bool need_sync = !nested && num_task <= num_workers_used_;
+    launcher->Init(flambda, cdata, num_task, need_sync);
+    launcher->OpenTasks();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_.push_back(launcher);
+      num_open_.fetch_add(1);
+    }
+    cv_.notify_all();
+    RunTasks(launcher, ctx);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_.erase(std::find(open_.begin(), open_.end(), launcher));
+      num_open_.fetch_sub(1);
+    }
+    int res = launcher->WaitForJobs();
+    launcher->WaitForParticipants();
+    --ctx->launch_depth;
+    return res;
+  }
+
+  static WorkStealingThreadPool* ThreadLocal() {
+    // The nested launches on a worker go to the pool of the worker
+    if (WorkStealingThreadPool* pool = WorkStealingContext::ThreadLocal()->pool) {
+      return pool;
+    }
+    return dmlc::ThreadLocalStore<WorkStealingThreadPool>::Get();
+  }
+
+  void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
+                                 const std::vector<unsigned int>& cpus) {
+    num_workers_used_ = threads_->Configure(mode, nthreads, /*exclude_worker0=*/true, cpus);
+    num_workers_used_ = std::min(num_workers_, num_workers_used_);
+  }
+
+  int32_t NumThreads() const { return num_workers_used_; }
+
+  void WarmUp(int64_t duration_us) {
+    warm_until_.store(NowMicros() + duration_us);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++warm_up_count_;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  void Init() {
+    exit_now_ = false;
+    // The launching thread works as worker 0
+    threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
+        num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
+        /*exclude_worker0=*/true);
+    num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, true);
+  }
+
+  void Shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_now_ = true;
+    }
+    cv_.notify_all();
+    threads_.reset();
+  }
+
+  // Claim the tasks of a launch and run them, until no task is left.
+  static void RunTasks(ParallelLauncher* launcher, WorkStealingContext* ctx) {
+    for (int task_id; (task_id = launcher->ClaimTask()) < launcher->env.num_task;) {
+      ++ctx->task_depth;
+      if ((*launcher->flambda)(task_id, &launcher->env, launcher->cdata) == 0) {
+        launcher->SignalJobFinish();
+      } else {
+        launcher->SignalJobError(task_id);
+      }
+      --ctx->task_depth;
+    }
+  }
+
+  // Find the innermost open launch with unclaimed tasks, and join it. Requires the mutex.
+  ParallelLauncher* JoinLaunch() {
+    for (auto it = open_.rbegin(); it != open_.rend(); ++it) {
+      if ((*it)->HasUnclaimedTasks()) {
+        (*it)->Join();
+        return *it;
+      }
+    }
+    return nullptr;
+  }
+
+  // Internal worker function.
+  void RunWorker(int worker_id) {
+    WorkStealingContext* ctx = WorkStealingContext::ThreadLocal();
+    // The nested launches of the tasks run on a worker go to this pool as well, rather than to a
+    // classic pool of its own
+    ctx->enabled = true;
+    ctx->pool = this;
+    static uint32_t spin_count = GetSpinCount();
+    AdaptiveSpin spin(spin_count);
+    while (true) {
+      // Busy wait a bit for a launch to open, before sleeping
+      for (uint32_t i = 0; num_open_.load() == 0; ++i) {
+        if (i >= spin.count() && NowMicros() >= warm_until_.load(std::memory_order_relaxed)) {
+          break;
+        }
+        tvm::runtime::threading::Yield();
+      }
+      spin.Update(num_open_.load() != 0);
+      ParallelLauncher* launcher = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t warm_up_count = warm_up_count_;
+        cv_.wait(lock, [this, &launcher, warm_up_count] {
+          return exit_now_ || (launcher = JoinLaunch()) != nullptr ||
+                 warm_up_count_ != warm_up_count;
+        });
+        if (exit_now_) {
+          return;
+        }
+        if (launcher == nullptr) {
+          // Woken to spin for a warm up
+          continue;
+        }
+      }
+      RunTasks(launcher, ctx);
+      launcher->Leave();
+    }
+  }
+
+  int num_workers_;
+  // number of workers used (can be restricted with affinity pref)
+  int num_workers_used_;
+  // number of tasks per thread of the launches leaving it to the runtime
+  int tasks_per_thread_;
+  // the launches open for claiming tasks, from the outermost to the innermost
+  std::vector<ParallelLauncher*> open_;
+  // the number of the open launches, to spin on without the mutex
+  std::atomic<int> num_open_{0};
+  // signal for exit now, guarded by the mutex
+  bool exit_now_{false};
+  // the number of warm ups, guarded by the mutex
+  uint64_t warm_up_count_{0};
+  // the time in microseconds until which the workers keep spinning, after a warm up
+  std::atomic<int64_t> warm_until_{0};
+  // the mutex guarding the open launches
+  std::mutex mutex_;
+  // cv for the workers to wait for a launch
+  std::condition_variable cv_;
+  std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
+};
+
 /*!
  * \brief args[0] is the AffinityMode, args[1] is the number of threads.
  *  args2 is a list of CPUs which is used to set the CPU affinity.
@@ -396,6 +847,34 @@ TVM_REGISTER_GLOBAL("runtime.NumThreads").set_body_typed([]() -> int32_t {
   return threading::NumThreads();
 });
 
+/*!
+ * \brief args[0] is the name of the pool, args[1] is the number of threads.
+ *  args2 is a list of CPUs which is used to set the CPU affinity.
+ */
+TVM_REGISTER_GLOBAL("runtime.threading.CreateThreadPool")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      std::vector<unsigned int> cpus;
+      if (args.num_args >= 3) {
+        Array<String> cpu_array = args[2];
+        for (auto cpu : cpu_array) {
+          ICHECK(IsNumber(cpu)) << "The CPU core information '" << cpu << "' is not a number.";
+          cpus.push_back(std::stoi(cpu));
+        }
+      }
+      threading::CreateThreadPool(args[0], args[1], cpus);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.threading.RemoveThreadPool")
+    .set_body_typed([](std::string name) { threading::RemoveThreadPool(name); });
+
+TVM_REGISTER_GLOBAL("runtime.threading.WarmUp").set_body_typed([](int64_t duration_us) {
+  threading::WarmUpThreadPool(duration_us);
+});
+
+TVM_REGISTER_GLOBAL("runtime.threading.BindThreadPool").set_body_typed([](std::string name) {
+  return String(threading::BindThreadPool(name));
+});
+
 namespace threading {
 
 #if TVM_THREADPOOL_USE_OPENMP
@@ -448,7 +927,13 @@ static void ConfigureOMP(tvm::runtime::threading::ThreadGroup::AffinityMode mode
 
 #endif
 
-void ResetThreadPool() { tvm::runtime::ThreadPool::ThreadLocal()->Reset(); }
+void ResetThreadPool() {
+  if (WorkStealingContext::ThreadLocal()->enabled) {
+    tvm::runtime::WorkStealingThreadPool::ThreadLocal()->Reset();
+  } else {
+    tvm::runtime::ThreadPool::ThreadLocal()->Reset();
+  }
+}
 /*!
  * \brief configure the CPU id affinity
  * \param mode The preferred CPU type (1 = big, -1 = little, -2 = kSpecifyOneCorePerThread,
@@ -461,17 +946,68 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
                        std::vector<unsigned int> cpus) {
   tvm::runtime::threading::SetMaxConcurrency(cpus.size());
 #if !TVM_THREADPOOL_USE_OPENMP
-  tvm::runtime::ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads, cpus);
+  if (WorkStealingContext::ThreadLocal()->enabled) {
+    tvm::runtime::WorkStealingThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads,
+                                                                                   cpus);
+  } else {
+    tvm::runtime::ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads, cpus);
+  }
 #else
   ConfigureOMP(mode, nthreads, cpus);
 #endif
 }
-int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+int32_t NumThreads() {
+  if (const std::shared_ptr<ThreadPool>& pool = NamedThreadPools::ThreadLocal()->pool) {
+    return pool->NumThreads();
+  }
+  if (WorkStealingContext::ThreadLocal()->enabled) {
+    return tvm::runtime::WorkStealingThreadPool::ThreadLocal()->NumThreads();
+  }
+  return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads();
+}
+void SetWorkStealing(bool enable) { WorkStealingContext::ThreadLocal()->enabled = enable; }
+bool IsWorkStealing() { return WorkStealingContext::ThreadLocal()->enabled; }
+void CreateThreadPool(const std::string& name, int num_threads, std::vector<unsigned int> cpus) {
+  NamedThreadPools::Global()->Create(name, num_threads, std::move(cpus));
+}
+void RemoveThreadPool(const std::string& name) { NamedThreadPools::Global()->Remove(name); }
+void WarmUpThreadPool(int64_t duration_us) {
+#if !TVM_THREADPOOL_USE_OPENMP
+  if (const std::shared_ptr<ThreadPool>& pool = NamedThreadPools::ThreadLocal()->pool) {
+    pool->WarmUp(duration_us);
+  } else if (WorkStealingContext::ThreadLocal()->enabled) {
+    tvm::runtime::WorkStealingThreadPool::ThreadLocal()->WarmUp(duration_us);
+  } else {
+    tvm::runtime::ThreadPool::ThreadLocal()->WarmUp(duration_us);
+  }
+#endif
+}
+std::string BindThreadPool(const std::string& name) {
+  NamedThreadPools::Binding* binding = NamedThreadPools::ThreadLocal();
+  std::string prev = std::move(binding->name);
+  binding->pool = name.empty() ? nullptr : NamedThreadPools::Global()->Get(name);
+  binding->name = name;
+  return prev;
+}
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
 
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+#if defined(__hexagon__)
+  // The tasks run on the threads of the Hexagon runtime holding the HVX instances
+  static const tvm::runtime::PackedFunc* hexagon_launch =
+      tvm::runtime::Registry::Get("device_api.hexagon.parallel_launch");
+  if (hexagon_launch != nullptr) {
+    return (*hexagon_launch)(reinterpret_cast<void*>(flambda), cdata, num_task);
+  }
+#endif
+#if !TVM_THREADPOOL_USE_OPENMP
+  // The named pool bound to the thread has its own number of workers
+  if (const auto& pool = tvm::runtime::NamedThreadPools::ThreadLocal()->pool) {
+    return pool->Launch(flambda, cdata, num_task, 1);
+  }
+#endif
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_workers == 1) {
     std::atomic<int32_t> sync_counter{0};
@@ -482,6 +1018,9 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
+    if (tvm::runtime::WorkStealingContext::ThreadLocal()->enabled) {
+      return tvm::runtime::WorkStealingThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task);
+    }
     int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
     return res;
 #else
@@ -503,6 +1042,9 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
 #pragma omp barrier
 #else
   using tvm::runtime::kSyncStride;
+  ICHECK(penv->sync_handle != nullptr)
+      << "Parallel barrier is not supported in a nested launch, or in a launch of more tasks than "
+      << "the threads, in the work-stealing thread pool";
   int num_task = penv->num_task;
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
@@ -235,6 +235,18 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
   } else if (name == "set_outputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetOutputs(args[0], args); });
+  } else if (name == "set_storage_arena") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      storage_arena_.enabled = args[0];
+      if (!storage_arena_.enabled) {
+        storage_arena_.plan.clear();
+        storage_arena_.regions.clear();
+      }
+    });
+  } else if (name == "get_num_storage_allocs") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = storage_arena_.num_allocs;
+    });
   } else if (name == "load_late_bound_consts") {
     return PackedFunc([this](TVMArgs args, TVMRetValue* rv) {
       CHECK_EQ(args.size(), 1);
@@ -624,11 +636,105 @@ std::vector<Index> VirtualMachine::GetOutputTensorRegIndices() {
   return reg_indices;
 }
 
+void VirtualMachine::BeginStorageArena() {
+  StorageArena& arena = storage_arena_;
+  arena.trace.clear();
+  arena.active = -1;
+  arena.num_allocs = 0;
+  if (!arena.enabled || arena.plan.empty()) {
+    return;
+  }
+  auto is_free = [](const std::vector<Storage>& regions) {
+    return std::all_of(regions.begin(), regions.end(), [](const Storage& region) {
+      return !region.defined() || region.use_count() == 1;
+    });
+  };
+  for (size_t i = 0; i < arena.regions.size(); ++i) {
+    if (is_free(arena.regions[i])) {
+      arena.active = static_cast<int>(i);
+      return;
+    }
+  }
+  constexpr size_t kMaxRegionSets = 2;
+  if (arena.regions.size() >= kMaxRegionSets) {
+    return;
+  }
+  std::vector<int64_t> bytes(devices_.size(), 0);
+  std::vector<int64_t> alignment(devices_.size(), 1);
+  for (const StorageAlloc& alloc : arena.plan) {
+    bytes[alloc.device_index] = std::max(bytes[alloc.device_index], alloc.offset + alloc.size);
+    alignment[alloc.device_index] = std::max(alignment[alloc.device_index], alloc.alignment);
+  }
+  std::vector<Storage> regions(devices_.size());
+  for (size_t i = 0; i < devices_.size(); ++i) {
+    if (bytes[i] > 0) {
+      auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
+      storage_obj->buffer = GetAllocator(i)->Alloc(bytes[i], alignment[i], DataType::UInt(8));
+      regions[i] = Storage(storage_obj);
+      ++arena.num_allocs;
+    }
+  }
+  arena.regions.push_back(std::move(regions));
+  arena.active = static_cast<int>(arena.regions.size()) - 1;
+}
+
+Storage VirtualMachine::AllocateStorage(Index device_index, int64_t size, int64_t alignment,
+                                        DLDataType dtype_hint) {
+  StorageArena& arena = storage_arena_;
+  size_t k = arena.trace.size();
+  arena.trace.push_back(StorageAlloc{device_index, size, alignment, 0});
+  auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
+  if (arena.active >= 0 && k < arena.plan.size() && arena.plan[k].device_index == device_index &&
+      arena.plan[k].size == size && arena.plan[k].alignment == alignment) {
+    const Storage& region = arena.regions[arena.active][device_index];
+    storage_obj->buffer = region->buffer;
+    storage_obj->buffer.data = static_cast<char*>(region->buffer.data) + arena.plan[k].offset;
+    storage_obj->buffer.size = size;
+    storage_obj->parent = region;
+    return Storage(storage_obj);
+  }
+  // The invocation makes other allocations than the plan, which is replaced at its end.
+  arena.active = -1;
+  Allocator* allocator = GetAllocator(device_index);
+  ICHECK(allocator) << "Did you forget to init the VirtualMachine with devices?";
+  storage_obj->buffer = allocator->Alloc(size, alignment, dtype_hint);
+  ++arena.num_allocs;
+  return Storage(storage_obj);
+}
+
+void VirtualMachine::EndStorageArena() {
+  StorageArena& arena = storage_arena_;
+  if (!arena.enabled) {
+    return;
+  }
+  auto same_alloc = [](const StorageAlloc& a, const StorageAlloc& b) {
+    return a.device_index == b.device_index && a.size == b.size && a.alignment == b.alignment;
+  };
+  if (arena.plan.size() == arena.trace.size() &&
+      std::equal(arena.plan.begin(), arena.plan.end(), arena.trace.begin(), same_alloc)) {
+    return;
+  }
+  // The storage is carved out of the regions back to back, as the allocations of an invocation
+  // may be alive at once.
+  std::vector<int64_t> offsets(devices_.size(), 0);
+  for (StorageAlloc& alloc : arena.trace) {
+    int64_t alignment = std::max<int64_t>(alloc.alignment, 1);
+    int64_t& offset = offsets[alloc.device_index];
+    alloc.offset = (offset + alignment - 1) / alignment * alignment;
+    offset = alloc.offset + alloc.size;
+  }
+  arena.plan = std::move(arena.trace);
+  arena.trace.clear();
+  // The storage still alive keeps the regions of the previous plan.
+  arena.regions.clear();
+}
+
 void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices) {
   ICHECK(this->exec_);
   ICHECK(this->code_);
   pc_ = 0;
   Index frame_start = frames_.size();
+  BeginStorageArena();
   while (true) {
   main_loop:
     auto const& instr = code_[this->pc_];
@@ -824,15 +930,12 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
         auto alignment = instr.alloc_storage.alignment;
 
-        auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
-        Allocator* allocator = GetAllocator(instr.alloc_storage.device_index);
-        ICHECK(allocator) << "Did you forget to init the VirtualMachine with devices?";
         VLOG(2) << "allocating with allocation_size=" << size << ", alignment=" << alignment
                 << ", dtype_hint=" << DLDataType2String(instr.alloc_storage.dtype_hint)
                 << ", device_index=" << instr.alloc_storage.device_index;
 
-        storage_obj->buffer = allocator->Alloc(size, alignment, instr.alloc_storage.dtype_hint);
-        Storage storage(storage_obj);
+        Storage storage = AllocateStorage(instr.alloc_storage.device_index, size, alignment,
+                                          instr.alloc_storage.dtype_hint);
         WriteRegister(instr.dst, storage);
         OpStopHook();
         pc_++;
@@ -861,6 +964,7 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         auto caller_return_register = frames_.back().caller_return_register;
 
         if (PopFrame() == frame_start) {
+          EndStorageArena();
           return;
           // Otherwise we are just returning from a local call.
         } else {
@@ -20,7 +20,13 @@
 #include "vulkan_device.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <mutex>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -245,6 +251,7 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
   enabled_extensions = SelectEnabledExtensions();
   device_properties = VulkanDeviceProperties(instance, *this);
   CreateVkDevice(instance);
+  CreatePipelineCache();
 
   // Currently, any exceptions called after this point will prevent
   // vkDestroyDevice from being called in the destructor.  If this
@@ -347,11 +354,72 @@ VulkanDevice::~VulkanDevice() {
   staging_buffer_per_thread.Clear();
   uniform_buffer_per_thread.Clear();
 
+  if (pipeline_cache_ != VK_NULL_HANDLE) {
+    SavePipelineCache();
+    vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
+  }
   if (device_) {
     vkDestroyDevice(device_, nullptr);
   }
 }
 
+void VulkanDevice::CreatePipelineCache() {
+  std::string initial_data;
+  const char* cache_dir = std::getenv("TVM_VULKAN_PIPELINE_CACHE_DIR");
+  if (cache_dir != nullptr && cache_dir[0] != '\0') {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device_, &properties);
+    std::ostringstream path;
+    path << cache_dir << "/" << std::hex << properties.vendorID << "_" << properties.deviceID
+         << "_";
+    for (uint8_t byte : properties.pipelineCacheUUID) {
+      path << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+    }
+    path << ".bin";
+    pipeline_cache_path_ = path.str();
+    std::ifstream is(pipeline_cache_path_, std::ios::binary);
+    if (is.good()) {
+      initial_data.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    }
+  }
+  // The driver validates the header of the initial data, and starts
+  // from an empty cache if it is incompatible.
+  VkPipelineCacheCreateInfo cache_cinfo;
+  cache_cinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  cache_cinfo.pNext = nullptr;
+  cache_cinfo.flags = 0;
+  cache_cinfo.initialDataSize = initial_data.size();
+  cache_cinfo.pInitialData = initial_data.data();
+  VULKAN_CALL(vkCreatePipelineCache(device_, &cache_cinfo, nullptr, &pipeline_cache_));
+}
+
+void VulkanDevice::SavePipelineCache() const {
+  if (pipeline_cache_path_.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(pipeline_cache_mutex_);
+  size_t size = 0;
+  VULKAN_CALL(vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr));
+  std::string data(size, '\0');
+  VULKAN_CALL(vkGetPipelineCacheData(device_, pipeline_cache_, &size, &data[0]));
+  data.resize(size);
+  // Renamed into place, so that concurrent processes never load a partial cache.
+  std::ostringstream tmp_path;
+  tmp_path << pipeline_cache_path_ << ".tmp." << std::this_thread::get_id();
+  {
+    std::ofstream os(tmp_path.str(), std::ios::binary);
+    if (!os.good()) {
+      LOG(WARNING) << "Cannot write the Vulkan pipeline cache " << tmp_path.str();
+      return;
+    }
+    os.write(data.data(), data.size());
+  }
+  if (std::rename(tmp_path.str().c_str(), pipeline_cache_path_.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the Vulkan pipeline cache " << pipeline_cache_path_;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
 VulkanDevice::VulkanDevice(VulkanDevice&& other) { do_swap(std::move(other)); }
 
 VulkanDevice& VulkanDevice::operator=(VulkanDevice&& other) {
@@ -382,6 +450,8 @@ void VulkanDevice::do_swap(VulkanDevice&& other) {
   std::swap(physical_device_, other.physical_device_);
   std::swap(enabled_extensions, other.enabled_extensions);
   std::swap(device_, other.device_);
+  std::swap(pipeline_cache_, other.pipeline_cache_);
+  std::swap(pipeline_cache_path_, other.pipeline_cache_path_);
 }
 
 bool VulkanDevice::SupportsCompute() const { return queue_family_index != uint32_t(-1); }
@@ -232,6 +232,17 @@ class VulkanDevice {
 
   VkQueue Queue() const { return queue; }
 
+  /*! \brief The pipeline cache of the device, which the compute pipelines are created through */
+  VkPipelineCache PipelineCache() const { return pipeline_cache_; }
+
+  /*! \brief Write the pipeline cache to disk, if TVM_VULKAN_PIPELINE_CACHE_DIR is set
+   *
+   * The cache is written when the device is destroyed, and may be
+   * written earlier, e.g. when a module which created new pipelines
+   * is unloaded.  Safe to call from multiple CPU threads.
+   */
+  void SavePipelineCache() const;
+
  private:
   /*! \brief Helper function for move assignment/construction
    *
@@ -260,6 +271,15 @@ class VulkanDevice {
    */
   void CreateVkDevice(const VulkanInstance& instance);
 
+  /*! \brief Initialize the VkPipelineCache
+   *
+   * The cache is loaded from TVM_VULKAN_PIPELINE_CACHE_DIR, if it is
+   * set, in a file named by the vendor, the device and the pipeline
+   * cache UUID of the driver, so that a driver update starts from an
+   * empty cache.
+   */
+  void CreatePipelineCache();
+
   //! \brief Handle to the Vulkan API physical device
   VkPhysicalDevice physical_device_{nullptr};
 
@@ -274,6 +294,15 @@ class VulkanDevice {
   //! \brief Handle to the Vulkan API logical device
   VkDevice device_{nullptr};
 
+  //! \brief Handle to the Vulkan API pipeline cache
+  VkPipelineCache pipeline_cache_{VK_NULL_HANDLE};
+
+  //! \brief The file the pipeline cache persists in, or empty if it is not persisted
+  std::string pipeline_cache_path_;
+
+  //! \brief Mutex to serialize the writes of the pipeline cache
+  mutable std::mutex pipeline_cache_mutex_;
+
   //! \brief Mutex to protect access to queue
   mutable std::mutex queue_mutex;
 
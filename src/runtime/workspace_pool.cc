@@ -23,6 +23,8 @@
  */
 #include "workspace_pool.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 namespace tvm {
@@ -33,90 +35,74 @@ constexpr size_t kWorkspacePageSize = 4 << 10;
 
 class WorkspacePool::Pool {
  public:
-  // constructor
-  Pool() {
-    // safe guard header on each list.
-    Entry e;
-    e.data = nullptr;
-    e.size = 0;
-    free_list_.push_back(e);
-    allocated_.push_back(e);
-  }
   // allocate from pool
-  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
+  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes, TVMStreamHandle stream) {
     // Allocate align to page.
     nbytes = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
     if (nbytes == 0) nbytes = kWorkspacePageSize;
-    Entry e;
     DLDataType type;
     type.code = kDLUInt;
     type.bits = 8;
     type.lanes = 1;
-    if (free_list_.size() == 2) {
+    // Find the smallest fit, preferring the entries last used on the same stream, whose reuse is
+    // ordered after their last use by the stream itself.
+    auto fit = free_list_.end();
+    for (auto it = std::lower_bound(free_list_.begin(), free_list_.end(), nbytes,
+                                    [](const Entry& e, size_t size) { return e.size < size; });
+         it != free_list_.end(); ++it) {
+      if (fit == free_list_.end()) fit = it;
+      if (it->stream == stream) {
+        fit = it;
+        break;
+      }
+    }
+    Entry e;
+    if (fit != free_list_.end()) {
+      e = *fit;
+      free_list_.erase(fit);
+      if (e.stream != stream) {
+        // Gate the reuse on the work queued on the other stream, without blocking the host.
+        device->SyncStreamFromTo(dev, e.stream, stream);
+      }
+    } else if (!free_list_.empty()) {
+      // resize the page
       e = free_list_.back();
       free_list_.pop_back();
-      if (e.size < nbytes) {
-        // resize the page
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
-    } else if (free_list_.size() == 1) {
+      device->FreeDataSpace(dev, e.data);
       e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
       e.size = nbytes;
     } else {
-      if (free_list_.back().size >= nbytes) {
-        // find smallest fit
-        auto it = free_list_.end() - 2;
-        for (; it->size >= nbytes; --it) {
-        }
-        e = *(it + 1);
-        free_list_.erase(it + 1);
-      } else {
-        // resize the page
-        e = free_list_.back();
-        free_list_.pop_back();
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
+      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
+      e.size = nbytes;
     }
+    e.stream = stream;
     allocated_.push_back(e);
     return e.data;
   }
   // free resource back to pool
-  void Free(void* data) {
+  void Free(void* data, TVMStreamHandle stream) {
     Entry e;
-    if (allocated_.back().data == data) {
+    if (!allocated_.empty() && allocated_.back().data == data) {
       // quick path, last allocated.
       e = allocated_.back();
       allocated_.pop_back();
     } else {
-      int index = static_cast<int>(allocated_.size()) - 2;
-      for (; index > 0 && allocated_[index].data != data; --index) {
-      }
-      ICHECK_GT(index, 0) << "trying to free things that has not been allocated";
-      e = allocated_[index];
-      allocated_.erase(allocated_.begin() + index);
-    }
-    if (free_list_.back().size < e.size) {
-      free_list_.push_back(e);
-    } else if (free_list_.size() == 2) {
-      free_list_.push_back(free_list_.back());
-      free_list_[1] = e;
-    } else {
-      size_t i = free_list_.size() - 1;
-      free_list_.resize(free_list_.size() + 1);
-      for (; e.size < free_list_[i].size; --i) {
-        free_list_[i + 1] = free_list_[i];
-      }
-      free_list_[i + 1] = e;
+      auto it = std::find_if(allocated_.rbegin(), allocated_.rend(),
+                             [data](const Entry& e) { return e.data == data; });
+      ICHECK(it != allocated_.rend()) << "trying to free things that has not been allocated";
+      e = *it;
+      allocated_.erase(std::next(it).base());
     }
+    // The kernels queued on the stream may still use the entry.
+    e.stream = stream;
+    free_list_.insert(std::upper_bound(free_list_.begin(), free_list_.end(), e.size,
+                                       [](size_t size, const Entry& e) { return size < e.size; }),
+                      e);
   }
   // Release all resources
   void Release(Device dev, DeviceAPI* device) {
-    for (size_t i = 1; i < free_list_.size(); ++i) {
-      device->FreeDataSpace(dev, free_list_[i].data);
+    for (const Entry& e : free_list_) {
+      device->FreeDataSpace(dev, e.data);
     }
     free_list_.clear();
   }
@@ -126,6 +112,8 @@ class WorkspacePool::Pool {
   struct Entry {
     void* data;
     size_t size;
+    /*! \brief The stream the entry was last used on. */
+    TVMStreamHandle stream;
   };
   /*! \brief List of free items, sorted from small to big size */
   std::vector<Entry> free_list_;
@@ -148,19 +136,19 @@ WorkspacePool::~WorkspacePool() {
   }
 }
 
-void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
+void* WorkspacePool::AllocWorkspace(Device dev, size_t size, TVMStreamHandle stream) {
   if (static_cast<size_t>(dev.device_id) >= array_.size()) {
     array_.resize(dev.device_id + 1, nullptr);
   }
   if (array_[dev.device_id] == nullptr) {
     array_[dev.device_id] = new Pool();
   }
-  return array_[dev.device_id]->Alloc(dev, device_, size);
+  return array_[dev.device_id]->Alloc(dev, device_, size, stream);
 }
 
-void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
+void WorkspacePool::FreeWorkspace(Device dev, void* ptr, TVMStreamHandle stream) {
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
-  array_[dev.device_id]->Free(ptr);
+  array_[dev.device_id]->Free(ptr, stream);
 }
 
 }  // namespace runtime
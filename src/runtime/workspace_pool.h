@@ -41,6 +41,10 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  The workspace is freed as soon as the work using it is queued on a stream. A free
+ *  entry is reused without synchronization on the stream it was last used on, and on
+ *  another stream once that stream waits for the work queued on the former.
  */
 class TVM_DLL WorkspacePool {
  public:
@@ -56,15 +60,17 @@ class TVM_DLL WorkspacePool {
    * \brief Allocate temporal workspace.
    * \param dev The device of allocation.
    * \param size The size to be allocated.
+   * \param stream The stream the workspace is used on.
    */
-  void* AllocWorkspace(Device dev, size_t size);
+  void* AllocWorkspace(Device dev, size_t size, TVMStreamHandle stream = nullptr);
   /*!
    * \brief Free temporal workspace in backend execution.
    *
    * \param dev The device of allocation.
    * \param ptr The pointer to be freed.
+   * \param stream The stream the workspace was used on.
    */
-  void FreeWorkspace(Device dev, void* ptr);
+  void FreeWorkspace(Device dev, void* ptr, TVMStreamHandle stream = nullptr);
 
  private:
   class Pool;
@@ -171,6 +171,10 @@
 #define TVM_INFO_USE_MIOPEN "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_HIPBLASLT
+#define TVM_INFO_USE_HIPBLASLT "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_ROCBLAS
 #define TVM_INFO_USE_ROCBLAS "NOT-FOUND"
 #endif
@@ -183,6 +187,10 @@
 #define TVM_INFO_USE_NNPACK "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_NCCL
+#define TVM_INFO_USE_NCCL "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_RANDOM
 #define TVM_INFO_USE_RANDOM "NOT-FOUND"
 #endif
@@ -281,6 +289,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_HEXAGON_SDK", TVM_INFO_USE_HEXAGON_SDK},
       {"USE_HEXAGON_GTEST", TVM_INFO_USE_HEXAGON_GTEST},
       {"USE_HEXAGON_EXTERNAL_LIBS", TVM_INFO_USE_HEXAGON_EXTERNAL_LIBS},
+      {"USE_HIPBLASLT", TVM_INFO_USE_HIPBLASLT},
       {"USE_IOS_RPC", TVM_INFO_USE_IOS_RPC},
       {"USE_KHRONOS_SPIRV", TVM_INFO_USE_KHRONOS_SPIRV},
       {"USE_LIBBACKTRACE", TVM_INFO_USE_LIBBACKTRACE},
@@ -292,6 +301,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_MIOPEN", TVM_INFO_USE_MIOPEN},
       {"USE_MKL", TVM_INFO_USE_MKL},
       {"USE_MSVC_MT", TVM_INFO_USE_MSVC_MT},
+      {"USE_NCCL", TVM_INFO_USE_NCCL},
       {"USE_NNPACK", TVM_INFO_USE_NNPACK},
       {"USE_OPENCL", TVM_INFO_USE_OPENCL},
       {"USE_OPENCL_GTEST", TVM_INFO_USE_OPENCL_GTEST},
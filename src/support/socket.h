@@ -46,6 +46,7 @@
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 #include <tvm/runtime/logging.h>
@@ -502,6 +503,37 @@ class TCPSocket : public Socket {
     return RetryCallOnEINTR(
         [&]() { return send(sockfd, buf, static_cast<sock_size_t>(len), flag); });
   }
+  /*!
+   * \brief send a header and a payload in one scatter-gather write, without copying them into
+   *  a buffer together
+   * \param header the pointer to the header
+   * \param header_len the size of the header
+   * \param data the pointer to the payload
+   * \param len the size of the payload
+   * \return size of data actually sent, counted from the start of the header
+   *         return -1 if error occurs
+   */
+  ssize_t SendGather(const void* header, size_t header_len, const void* data, size_t len) {
+#ifdef _WIN32
+    WSABUF bufs[2];
+    bufs[0].buf = const_cast<char*>(reinterpret_cast<const char*>(header));
+    bufs[0].len = static_cast<ULONG>(header_len);
+    bufs[1].buf = const_cast<char*>(reinterpret_cast<const char*>(data));
+    bufs[1].len = static_cast<ULONG>(len);
+    DWORD nsent = 0;
+    if (WSASend(sockfd, bufs, 2, &nsent, 0, nullptr, nullptr) != 0) {
+      return -1;
+    }
+    return static_cast<ssize_t>(nsent);
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<void*>(header);
+    iov[0].iov_len = header_len;
+    iov[1].iov_base = const_cast<void*>(data);
+    iov[1].iov_len = len;
+    return RetryCallOnEINTR([&]() { return writev(sockfd, iov, 2); });
+#endif
+  }
   /*!
    * \brief receive data using the socket
    * \param buf_ the pointer to the buffer
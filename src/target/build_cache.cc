@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file build_cache.cc
+ * \brief The on-disk cache of the compiled kernels, shared across builds.
+ */
+#include "build_cache.h"
+
+#include <tvm/ir/transform.h>
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+namespace tvm {
+namespace codegen {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("codegen.cache_dir", String);
+
+std::unique_ptr<BuildCache> BuildCache::Current() {
+  Optional<String> dir =
+      transform::PassContext::Current()->GetConfig<String>("codegen.cache_dir", Optional<String>());
+  if (!dir.defined()) {
+    return nullptr;
+  }
+  return std::make_unique<BuildCache>(dir.value());
+}
+
+std::string BuildCache::Path(const std::string& key) const {
+  std::ostringstream os;
+  os << dir_ << "/" << std::hex << std::hash<std::string>()(key) << ".bin";
+  return os.str();
+}
+
+Optional<String> BuildCache::Load(const std::string& key) const {
+  std::string path = Path(key);
+  std::ifstream is(path, std::ios::binary);
+  if (!is.good()) {
+    return NullOpt;
+  }
+  // An entry is the size of the key, the key, then the output.
+  uint64_t key_size = 0;
+  is.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+  if (!is.good() || key_size != key.size()) {
+    return NullOpt;
+  }
+  std::string entry_key(key_size, '\0');
+  is.read(&entry_key[0], key_size);
+  if (!is.good() || entry_key != key) {
+    return NullOpt;
+  }
+  std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  return String(data);
+}
+
+void BuildCache::Save(const std::string& key, const std::string& data) const {
+  std::string path = Path(key);
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << std::this_thread::get_id();
+  {
+    std::ofstream os(tmp_path.str(), std::ios::binary);
+    if (!os.good()) {
+      LOG(WARNING) << "Cannot write the build cache entry " << tmp_path.str();
+      return;
+    }
+    uint64_t key_size = key.size();
+    os.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    os.write(key.data(), key.size());
+    os.write(data.data(), data.size());
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the build cache entry " << path;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+}  // namespace codegen
+}  // namespace tvm
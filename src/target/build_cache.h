@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file build_cache.h
+ * \brief The on-disk cache of the compiled kernels, shared across builds.
+ */
+#ifndef TVM_TARGET_BUILD_CACHE_H_
+#define TVM_TARGET_BUILD_CACHE_H_
+
+#include <tvm/runtime/container/optional.h>
+#include <tvm/runtime/container/string.h>
+
+#include <memory>
+#include <string>
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief The on-disk cache of the compiled kernels, such as LLVM bitcode and PTX, in the directory
+ *  given by the PassContext config "codegen.cache_dir".
+ *
+ *  An entry is addressed by the hash of its key, which is the full content the output depends on,
+ *  e.g. the source code along with the target and the compiler flags. The entry stores its key,
+ *  which is compared on lookup against hash collisions.
+ */
+class BuildCache {
+ public:
+  /*!
+   * \brief Get the cache of the current PassContext.
+   * \return The cache, or null when "codegen.cache_dir" is not set.
+   */
+  static std::unique_ptr<BuildCache> Current();
+
+  explicit BuildCache(std::string dir) : dir_(dir) {}
+
+  /*!
+   * \brief Look up an entry.
+   * \param key The key.
+   * \return The cached output, or NullOpt on a miss.
+   */
+  Optional<String> Load(const std::string& key) const;
+
+  /*!
+   * \brief Save an entry, renamed into place so that concurrent builds never see it partial.
+   * \param key The key.
+   * \param data The output.
+   */
+  void Save(const std::string& key, const std::string& data) const;
+
+ private:
+  std::string Path(const std::string& key) const;
+
+  /*! \brief The directory of the cache. */
+  std::string dir_;
+};
+
+}  // namespace codegen
+}  // namespace tvm
+
+#endif  // TVM_TARGET_BUILD_CACHE_H_
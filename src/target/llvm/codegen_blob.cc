@@ -84,10 +84,13 @@ std::unique_ptr<llvm::Module> CodeGenBlob(const std::string& data, bool system_l
     tvm_dev_mblob->setSection(".lrodata");
   }
 
+  // The blob is page-aligned, so that the constants saved at aligned offsets of it are viewed in
+  // place when loaded, see const_loader_module.cc.
+  const unsigned blob_alignment = 4096;
 #if TVM_LLVM_VERSION >= 100
-  tvm_dev_mblob->setAlignment(llvm::Align(1));
+  tvm_dev_mblob->setAlignment(llvm::Align(blob_alignment));
 #else
-  tvm_dev_mblob->setAlignment(1);
+  tvm_dev_mblob->setAlignment(blob_alignment);
 #endif
 
   if (triple.isOSWindows()) {
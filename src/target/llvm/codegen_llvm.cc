@@ -157,7 +157,9 @@ void CodeGenLLVM::InitTarget() {
   module_->setTargetTriple(tm->getTargetTriple().str());
   module_->setDataLayout(tm->createDataLayout());
   data_layout_.reset(new llvm::DataLayout(module_.get()));
-  if (native_vector_bits_ == 0) {
+  if (int vector_width = llvm_target_->GetVectorWidth()) {
+    native_vector_bits_ = vector_width;
+  } else if (native_vector_bits_ == 0) {
     const auto& arch = tm->getTargetTriple().getArch();
     if (arch == llvm::Triple::x86_64) {
       // for avx512
@@ -991,6 +993,38 @@ void CodeGenLLVM::SetTargetAttributes(llvm::Function* func) {
   if (!features.empty()) {
     func->addFnAttr("target-features", features);
   }
+#if TVM_LLVM_VERSION >= 130
+  // Pin vscale to the vector width, so that LLVM lowers the fixed-width vectors onto the scalable
+  // registers of SVE or RVV.
+  if (int vscale = GetVScale()) {
+    func->addFnAttr(
+        llvm::Attribute::getWithVScaleRangeArgs(*llvm_target_->GetContext(), vscale, vscale));
+  }
+#endif
+}
+
+int CodeGenLLVM::GetVScale() const {
+  int vector_width = llvm_target_->GetVectorWidth();
+  if (vector_width == 0) {
+    return 0;
+  }
+  auto has_feature = [this](const std::string& prefix) {
+    for (const std::string& feature : llvm_target_->GetTargetFeatures()) {
+      if (feature.compare(0, prefix.size(), prefix) == 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  llvm::Triple triple(llvm_target_->GetTargetTriple());
+  // The scalable registers are vscale times 128 bits on AArch64, and 64 bits on RISC-V.
+  if (triple.getArch() == llvm::Triple::aarch64 && has_feature("+sve")) {
+    return vector_width / 128;
+  }
+  if (triple.isRISCV() && (has_feature("+v") || has_feature("+zve"))) {
+    return vector_width / 64;
+  }
+  return 0;
 }
 
 void CodeGenLLVM::EmitFloat16ConversionBuiltins(bool use_float16_abi) {
@@ -1301,6 +1335,14 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
     llvm::Value* v = MakeValue(op->args[0]);
     int l = GetVectorNumElements(v);
     return CreateVecSlice(v, l / 2, l / 2);
+  } else if (op->op.same_as(builtin::vscale())) {
+#if TVM_LLVM_VERSION >= 110
+    llvm::Function* f = GetIntrinsicDecl(llvm::Intrinsic::vscale, DTypeToLLVMType(op->dtype), {});
+    return builder_->CreateCall(f);
+#else
+    LOG(FATAL) << "vscale requires LLVM 11 or newer";
+    return nullptr;
+#endif
   } else if (op->op.same_as(builtin::vectorcombine())) {
     llvm::Value* v0 = MakeValue(op->args[0]);
     llvm::Value* v1 = MakeValue(op->args[1]);
@@ -1597,13 +1639,44 @@ void CodeGenLLVM::BufferAccessHelper(
   }
 }
 
+/*!
+ * \brief Check that a predicated buffer access is a single contiguous vector, which is masked as a
+ *  whole by the predicate.
+ */
+static void CheckPredicatedAccess(const Buffer& buffer, const Array<PrimExpr>& indices) {
+  const auto* ramp = indices.back().as<RampNode>();
+  CHECK(ramp != nullptr && is_one(ramp->stride) && buffer->dtype.lanes() == 1)
+      << "ValueError: The predicated access of " << buffer->name
+      << " must be a contiguous vector of scalar elements, but got the index " << indices.back();
+}
+
 llvm::Value* CodeGenLLVM::VisitExpr_(const BufferLoadNode* op) {
   DataType value_dtype = op->dtype;
 
   std::vector<llvm::Value*> loads;
 
-  auto make_load = [this, &loads](TypedPointer buffer_ptr, int /* subelement_i */, int alignment,
-                                  bool is_volatile) {
+  llvm::Value* predicate = nullptr;
+  if (op->predicate.defined()) {
+    CheckPredicatedAccess(op->buffer, op->indices);
+    predicate = MakeValue(op->predicate.value());
+  }
+
+  auto make_load = [this, &loads, predicate](TypedPointer buffer_ptr, int /* subelement_i */,
+                                             int alignment,
+                                             bool is_volatile) -> llvm::Instruction* {
+    if (predicate != nullptr) {
+      // The masked out lanes are not read, so that they may be out of the bounds of the buffer.
+#if TVM_LLVM_VERSION >= 130
+      auto load = builder_->CreateMaskedLoad(buffer_ptr.type, buffer_ptr.addr,
+                                             llvm::Align(alignment), predicate);
+#elif TVM_LLVM_VERSION >= 110
+      auto load = builder_->CreateMaskedLoad(buffer_ptr.addr, llvm::Align(alignment), predicate);
+#else
+      auto load = builder_->CreateMaskedLoad(buffer_ptr.addr, alignment, predicate);
+#endif
+      loads.push_back(load);
+      return load;
+    }
 #if TVM_LLVM_VERSION >= 110
     auto load = builder_->CreateAlignedLoad(buffer_ptr.type, buffer_ptr.addr,
                                             llvm::Align(alignment), is_volatile);
@@ -1707,8 +1780,22 @@ void CodeGenLLVM::VisitStmt_(const BufferStoreNode* op) {
 
   llvm::Value* value = MakeValue(op->value);
 
-  auto make_store = [this, value](TypedPointer buffer_ptr, int subelement_i, int alignment,
-                                  bool is_volatile) {
+  llvm::Value* predicate = nullptr;
+  if (op->predicate.defined()) {
+    CheckPredicatedAccess(op->buffer, op->indices);
+    predicate = MakeValue(op->predicate.value());
+  }
+
+  auto make_store = [this, value, predicate](TypedPointer buffer_ptr, int subelement_i,
+                                             int alignment,
+                                             bool is_volatile) -> llvm::Instruction* {
+    if (predicate != nullptr) {
+#if TVM_LLVM_VERSION >= 110
+      return builder_->CreateMaskedStore(value, buffer_ptr.addr, llvm::Align(alignment), predicate);
+#else
+      return builder_->CreateMaskedStore(value, buffer_ptr.addr, alignment, predicate);
+#endif
+    }
     llvm::Value* to_store = value;
     if (subelement_i != -1) {
       to_store = builder_->CreateExtractElement(value, subelement_i);
@@ -390,11 +390,17 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
                                    llvm::ArrayRef<llvm::Type*> arg_types);
   /*!
    * \brief Set target-related attributes on the LLVM function \p func. This
-   *        includes "target-cpu" and "target-features" if present.
+   *        includes "target-cpu" and "target-features" if present, and the
+   *        vscale range pinned by "vector-width" on SVE and RVV targets.
    *
    * \param func The function to set attributes on.
    */
   void SetTargetAttributes(llvm::Function* func);
+  /*!
+   * \brief Get the vscale given by the "vector-width" of an SVE or RVV target.
+   * \return The vscale, or 0 if the target has no scalable vectors or no vector width.
+   */
+  int GetVScale() const;
   /*!
    * \brief Emit LLVM IR for conversion functions __extendhfsf2 and __truncsfhf2
    *        into the current llvm::Module.
@@ -242,6 +242,13 @@ LLVMTargetInfo::LLVMTargetInfo(LLVMInstance& instance, const Target& target) {
     opt_level_ = defaults::opt_level;
   }
 
+  if (const Optional<Integer>& v = target->GetAttr<Integer>("vector-width")) {
+    vector_width_ = v.value()->value;
+    ICHECK(vector_width_ > 0 && vector_width_ % 128 == 0)
+        << "ValueError: -vector-width must be a positive multiple of 128, but got "
+        << vector_width_;
+  }
+
   target_options_.UseInitArray = true;
 
   // Fast math options
@@ -362,6 +369,10 @@ std::string LLVMTargetInfo::str() const {
 #endif
   }
 
+  if (vector_width_ != 0) {
+    os << " -vector-width=" << vector_width_;
+  }
+
   if (opt_level_ != defaults::opt_level) {
     os << " -opt-level=";
     switch (opt_level_) {
@@ -217,6 +217,11 @@ class LLVMTargetInfo {
    * \return optimization level for this target
    */
   llvm::CodeGenOpt::Level GetOptLevel() const { return opt_level_; }
+  /*!
+   * \brief Get the width of the vector registers
+   * \return the width in bits given by the "vector-width" attribute, or 0 if not given
+   */
+  int GetVectorWidth() const { return vector_width_; }
 
   /*!
    * \class Option
@@ -283,6 +288,7 @@ class LLVMTargetInfo {
   llvm::TargetOptions target_options_;
   llvm::FastMathFlags fast_math_flags_;
   llvm::CodeGenOpt::Level opt_level_;
+  int vector_width_ = 0;
   llvm::Reloc::Model reloc_model_ = llvm::Reloc::PIC_;
   llvm::CodeModel::Model code_model_ = llvm::CodeModel::Small;
   std::shared_ptr<llvm::TargetMachine> target_machine_;
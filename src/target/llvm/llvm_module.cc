@@ -28,6 +28,7 @@
 #include <dmlc/io.h>
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>  // Force linking of MCJIT
@@ -41,13 +42,17 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/serialization.h>
 #include <tvm/relay/runtime.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/string.h>
@@ -57,6 +62,8 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
@@ -72,6 +79,7 @@
 
 #include "../../runtime/file_utils.h"
 #include "../../runtime/library_module.h"
+#include "../build_cache.h"
 #include "../func_registry_generator.h"
 #include "codegen_blob.h"
 #include "codegen_cpu.h"
@@ -85,6 +93,44 @@ using runtime::PackedFunc;
 using runtime::TVMArgs;
 using runtime::TVMRetValue;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("codegen.llvm.num_partitions", Integer);
+
+/*! \brief Serialize an LLVM module into bitcode. */
+static std::string EncodeBitcode(const llvm::Module& module) {
+  std::string data;
+  llvm::raw_string_ostream os(data);
+#if TVM_LLVM_VERSION <= 60
+  llvm::WriteBitcodeToFile(&module, os);
+#else
+  llvm::WriteBitcodeToFile(module, os);
+#endif
+  os.flush();
+  return data;
+}
+
+/*! \brief Deserialize an LLVM module from bitcode, or return null if the bitcode is broken. */
+static std::unique_ptr<llvm::Module> DecodeBitcode(const std::string& data,
+                                                   LLVMInstance* llvm_instance) {
+  auto parsed = llvm::parseBitcodeFile(llvm::MemoryBufferRef(data, "TVMMod"),
+                                       *llvm_instance->GetContext());
+  if (!parsed) {
+    LOG(WARNING) << "Failed to read the LLVM bitcode: " << llvm::toString(parsed.takeError());
+    return nullptr;
+  }
+  return std::move(parsed.get());
+}
+
+/*!
+ * \brief The key of a module in the build cache, which is everything its LLVM module depends on.
+ */
+static std::string BuildCacheKey(const IRModule& mod, const Target& target) {
+  std::ostringstream os;
+  os << "llvm " << TVM_LLVM_VERSION << " tvm " << TVM_VERSION << "\n"
+     << target->str() << "\n"
+     << SaveJSON(mod);
+  return os.str();
+}
+
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode();
@@ -106,6 +152,10 @@ class LLVMModuleNode final : public runtime::ModuleNode {
 
  private:
   void LazyInitJIT();
+  std::unique_ptr<llvm::Module> BuildPartitions(const std::vector<PrimFunc>& funcs,
+                                                const std::string& entry_func,
+                                                const Target& target, int num_partitions,
+                                                bool system_lib, bool target_c_runtime);
   bool IsCompatibleWithHost(const llvm::TargetMachine* tm) const;
   void* GetGlobalAddr(const std::string& name, const LLVMTarget& llvm_target) const;
   void* GetFunctionAddr(const std::string& name, const LLVMTarget& llvm_target) const;
@@ -304,19 +354,44 @@ void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
     }
     funcs.push_back(f);
   }
+  std::unique_ptr<BuildCache> cache = BuildCache::Current();
+  std::string cache_key;
+  if (cache != nullptr) {
+    cache_key = BuildCacheKey(mod, target);
+    if (Optional<String> bitcode = cache->Load(cache_key)) {
+      module_owning_ptr_ = DecodeBitcode(bitcode.value(), llvm_instance_.get());
+      if (module_owning_ptr_ != nullptr) {
+        module_ = module_owning_ptr_.get();
+        return;
+      }
+    }
+  }
   // TODO(@jroesch): follow up on this condition.
   // ICHECK(funcs.size() > 0);
-  // TODO(tqchen): remove the entry function behavior as it does not
-  // makes sense when we start to use multiple modules.
-  cg->Init("TVMMod", llvm_target.get(), system_lib, system_lib, target_c_runtime);
-  cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
-
-  cg->AddFunctionsOrdered(funcs.begin(), funcs.end());
-  if (entry_func.length() != 0) {
-    cg->AddMainFunction(entry_func);
+  int num_partitions = tvm::transform::PassContext::Current()
+                           ->GetConfig<Integer>("codegen.llvm.num_partitions", Integer(1))
+                           .value()
+                           ->value;
+  if (num_partitions <= 0) {
+    num_partitions = runtime::threading::MaxConcurrency();
   }
+  num_partitions = std::min<int>(num_partitions, funcs.size());
+  if (num_partitions > 1) {
+    module_owning_ptr_ = BuildPartitions(funcs, entry_func, target, num_partitions, system_lib,
+                                         target_c_runtime);
+  } else {
+    // TODO(tqchen): remove the entry function behavior as it does not
+    // makes sense when we start to use multiple modules.
+    cg->Init("TVMMod", llvm_target.get(), system_lib, system_lib, target_c_runtime);
+    cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
+
+    cg->AddFunctionsOrdered(funcs.begin(), funcs.end());
+    if (entry_func.length() != 0) {
+      cg->AddMainFunction(entry_func);
+    }
 
-  module_owning_ptr_ = cg->Finish();
+    module_owning_ptr_ = cg->Finish();
+  }
   module_ = module_owning_ptr_.get();
   llvm_target->SetTargetMetadata(module_);
   module_->addModuleFlag(llvm::Module::Override, "Debug Info Version",
@@ -331,6 +406,66 @@ void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   LOG_IF(FATAL, llvm::verifyModule(*module_, &verify_errors))
       << "LLVM module verification failed with the following errors: \n"
       << verify_errors.str();
+  if (cache != nullptr) {
+    cache->Save(cache_key, EncodeBitcode(*module_));
+  }
+}
+
+std::unique_ptr<llvm::Module> LLVMModuleNode::BuildPartitions(const std::vector<PrimFunc>& funcs,
+                                                              const std::string& entry_func,
+                                                              const Target& target,
+                                                              int num_partitions, bool system_lib,
+                                                              bool target_c_runtime) {
+  // Split the functions sorted by name into contiguous partitions, so that the linked module keeps
+  // them in order.
+  std::vector<PrimFunc> sorted = funcs;
+  std::sort(sorted.begin(), sorted.end(), [](const PrimFunc& a, const PrimFunc& b) {
+    return a->GetAttr<String>(tvm::attr::kGlobalSymbol).value() <
+           b->GetAttr<String>(tvm::attr::kGlobalSymbol).value();
+  });
+  // Each partition is generated and optimized in an LLVM context of its own, and handed back as
+  // bitcode, since the modules of different contexts cannot be linked directly.
+  std::vector<std::string> bitcodes(num_partitions);
+  // Creating and destroying a target saves and restores the global LLVM options.
+  static std::mutex target_mutex;
+  support::parallel_for_dynamic(0, num_partitions, num_partitions, [&](int thread_id, int part) {
+    size_t begin = part * sorted.size() / num_partitions;
+    size_t end = (part + 1) * sorted.size() / num_partitions;
+    LLVMInstance llvm_instance;
+    std::unique_ptr<LLVMTarget> llvm_target;
+    {
+      std::lock_guard<std::mutex> lock(target_mutex);
+      llvm_target = std::make_unique<LLVMTarget>(llvm_instance, target);
+    }
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(llvm_target.get());
+    cg->Init("TVMMod", llvm_target.get(), system_lib, system_lib, target_c_runtime);
+    cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
+    cg->AddFunctionsOrdered(sorted.begin() + begin, sorted.begin() + end);
+    for (size_t i = begin; i < end; ++i) {
+      if (sorted[i]->GetAttr<String>(tvm::attr::kGlobalSymbol).value() == entry_func) {
+        cg->AddMainFunction(entry_func);
+      }
+    }
+    std::unique_ptr<llvm::Module> module = cg->Finish();
+    bitcodes[part] = EncodeBitcode(*module);
+    module.reset();
+    cg.reset();
+    std::lock_guard<std::mutex> lock(target_mutex);
+    llvm_target.reset();
+  });
+  // Link the partitions into one module in the context of this one.
+  std::unique_ptr<llvm::Module> linked;
+  for (int part = 0; part < num_partitions; ++part) {
+    std::unique_ptr<llvm::Module> module = DecodeBitcode(bitcodes[part], llvm_instance_.get());
+    ICHECK(module != nullptr) << "Failed to read back partition " << part << " of the LLVM module";
+    if (linked == nullptr) {
+      linked = std::move(module);
+    } else {
+      ICHECK(!llvm::Linker::linkModules(*linked, std::move(module)))
+          << "Failed to link partition " << part << " of the LLVM module";
+    }
+  }
+  return linked;
 }
 
 void LLVMModuleNode::Init(std::unique_ptr<llvm::Module> module,
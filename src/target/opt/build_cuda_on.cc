@@ -30,9 +30,13 @@
 #include <nvrtc.h>
 
 #include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
 
 #include "../../runtime/cuda/cuda_common.h"
 #include "../../runtime/cuda/cuda_module.h"
+#include "../build_cache.h"
 #include "../build_common.h"
 #include "../source/codegen_cuda.h"
 
@@ -102,6 +106,23 @@ std::string NVRTCCompile(const std::string& code, bool include_path = false) {
     compile_params.push_back(include_option);
   }
 
+  std::unique_ptr<BuildCache> cache = BuildCache::Current();
+  std::string cache_key;
+  if (cache != nullptr) {
+    int nvrtc_major, nvrtc_minor;
+    NVRTC_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+    std::ostringstream os;
+    os << "nvrtc " << nvrtc_major << "." << nvrtc_minor << "\n";
+    for (const auto& string : compile_params) {
+      os << string << " ";
+    }
+    os << "\n" << code;
+    cache_key = os.str();
+    if (Optional<String> ptx = cache->Load(cache_key)) {
+      return ptx.value();
+    }
+  }
+
   for (const auto& string : compile_params) {
     param_cstrings.push_back(string.c_str());
   }
@@ -122,6 +143,9 @@ std::string NVRTCCompile(const std::string& code, bool include_path = false) {
   NVRTC_CALL(nvrtcGetPTX(prog, &ptx[0]));
   NVRTC_CALL(nvrtcDestroyProgram(&prog));
 
+  if (cache != nullptr) {
+    cache->Save(cache_key, ptx);
+  }
   return ptx;
 }
 
@@ -150,7 +174,18 @@ runtime::Module BuildCUDA(IRModule mod, Target target) {
   const auto* f_enter = Registry::Get("target.TargetEnterScope");
   (*f_enter)(target);
   if (const auto* f = Registry::Get("tvm_callback_cuda_compile")) {
-    ptx = (*f)(code).operator std::string();
+    // The callback compiles for the target in scope, which is part of the key.
+    std::unique_ptr<BuildCache> cache = BuildCache::Current();
+    std::string cache_key = "tvm_callback_cuda_compile\n" + target->str() + "\n" + code;
+    Optional<String> cached = cache != nullptr ? cache->Load(cache_key) : NullOpt;
+    if (cached.defined()) {
+      ptx = cached.value();
+    } else {
+      ptx = (*f)(code).operator std::string();
+      if (cache != nullptr) {
+        cache->Save(cache_key, ptx);
+      }
+    }
     // Dirty matching to check PTX vs cubin.
     // TODO(tqchen) more reliable checks
     if (ptx[0] != '/') fmt = "cubin";
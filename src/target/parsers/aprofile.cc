@@ -125,11 +125,18 @@ static TargetFeatures GetFeatures(TargetJSON target) {
   bool dotprod_support = arch_version >= 8.2 && arch_version <= 8.3;
   bool has_dotprod = (dotprod_default && !dotprod_disable) || (dotprod_support && dotprod_flag);
 
+  bool sve_flag = HasFlag(mcpu, mattr, "+sve");
+  bool sve_disable = HasFlag(mcpu, mattr, "+nosve");
+  bool sve_default = arch_version >= 9.0;
+  bool sve_support = arch_version >= 8.2;
+  bool has_sve = is_aarch64 && ((sve_default && !sve_disable) || (sve_support && sve_flag));
+
   return {
       {"is_aarch64", Bool(is_aarch64)},
       {"has_asimd", Bool(has_asimd)},
       {"has_dotprod", Bool(has_dotprod)},
       {"has_matmul_i8", Bool(has_i8mm)},
+      {"has_sve", Bool(has_sve)},
   };
 }
 
@@ -903,6 +903,73 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
   } else if (op->op.same_as(builtin::ptx_wait_group())) {
     std::string N = this->PrintExpr(op->args[0]);
     this->stream << "__asm__ __volatile__(\"cp.async.wait_group " + N + ";\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_cp_async_bulk())) {
+    std::string dst = this->PrintExpr(op->args[0]);
+    std::string dst_offset = this->PrintExpr(op->args[1]);
+    std::string src = this->PrintExpr(op->args[2]);
+    std::string src_offset = this->PrintExpr(op->args[3]);
+    std::string size = this->PrintExpr(op->args[4]);
+    std::string barrier = this->PrintExpr(op->args[5]);
+    std::string barrier_offset = this->PrintExpr(op->args[6]);
+    this->stream << PrintCpAsyncBulkAssembly(dst, dst_offset, src, src_offset, size, barrier,
+                                             barrier_offset);
+  } else if (op->op.same_as(builtin::ptx_init_barrier_thread_count())) {
+    this->stream << PrintInitBarrierThreadCountAssembly(this->PrintExpr(op->args[0]),
+                                                        this->PrintExpr(op->args[1]),
+                                                        this->PrintExpr(op->args[2]));
+  } else if (op->op.same_as(builtin::ptx_arrive_barrier_expect_tx())) {
+    this->stream << PrintArriveBarrierExpectTxAssembly(this->PrintExpr(op->args[0]),
+                                                       this->PrintExpr(op->args[1]),
+                                                       this->PrintExpr(op->args[2]));
+  } else if (op->op.same_as(builtin::ptx_wait_barrier())) {
+    this->stream << PrintWaitBarrierAssembly(this->PrintExpr(op->args[0]),
+                                             this->PrintExpr(op->args[1]),
+                                             this->PrintExpr(op->args[2]));
+  } else if (op->op.same_as(builtin::ptx_fence_barrier_init())) {
+    this->stream << "__asm__ __volatile__(\"fence.mbarrier_init.release.cluster;\" ::: "
+                    "\"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_fence_proxy_async())) {
+    this->stream << "__asm__ __volatile__(\"fence.proxy.async.shared::cta;\" ::: \"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma())) {
+    // arg 0: shape: m64nNk16
+    // arg 1: A precision: fp16, bf16
+    // arg 2: B precision: fp16, bf16
+    // arg 3: C precision: fp32, fp16
+    // arg 4: A multiplicand in shared memory
+    // arg 5: A multiplicand index
+    // arg 6: A leading byte offset
+    // arg 7: A stride byte offset
+    // arg 8: B multiplicand in shared memory
+    // arg 9: B multiplicand index
+    // arg 10: B leading byte offset
+    // arg 11: B stride byte offset
+    // arg 12: C accumulator
+    // arg 13: C accumulator index
+    // arg 14: whether to accumulate into C
+    // arg 15: whether A is transposed
+    // arg 16: whether B is transposed
+    ICHECK_EQ(op->args.size(), 17U);
+    std::string shape = Downcast<StringImm>(op->args[0])->value;
+    std::string A_dtype = Downcast<StringImm>(op->args[1])->value;
+    std::string B_dtype = Downcast<StringImm>(op->args[2])->value;
+    std::string C_dtype = Downcast<StringImm>(op->args[3])->value;
+    bool trans_a = Downcast<Bool>(op->args[15])->value;
+    bool trans_b = Downcast<Bool>(op->args[16])->value;
+    this->stream << PrintWGMMAAssembly(
+        shape, A_dtype, B_dtype, C_dtype, this->PrintExpr(op->args[4]),
+        this->PrintExpr(op->args[5]), this->PrintExpr(op->args[6]), this->PrintExpr(op->args[7]),
+        this->PrintExpr(op->args[8]), this->PrintExpr(op->args[9]), this->PrintExpr(op->args[10]),
+        this->PrintExpr(op->args[11]), this->PrintExpr(op->args[12]),
+        this->PrintExpr(op->args[13]), this->PrintExpr(op->args[14]), trans_a, trans_b);
+  } else if (op->op.same_as(builtin::ptx_wgmma_fence())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.fence.sync.aligned;\" ::: \"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_commit_group())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.commit_group.sync.aligned;\" ::: "
+                    "\"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_wait_group())) {
+    std::string N = this->PrintExpr(op->args[0]);
+    this->stream << "__asm__ __volatile__(\"wgmma.wait_group.sync.aligned " + N +
+                        ";\" ::: \"memory\");\n\n";
   } else {
     CodeGenC::VisitExpr_(op, os);
   }
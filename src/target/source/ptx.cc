@@ -661,5 +661,198 @@ std::string PrintCpAsyncAssembly(const std::string& shared_ptr,
   return asm_code;
 }
 
+std::string PrintCpAsyncBulkAssembly(const std::string& shared_ptr,
+                                     const std::string& shared_elem_offset,
+                                     const std::string& global_ptr,
+                                     const std::string& global_elem_offset,
+                                     const std::string& bytes, const std::string& barrier_ptr,
+                                     const std::string& barrier_elem_offset) {
+  std::string asm_code = R"(
+  {
+    unsigned int smem_addr;
+    unsigned int barrier_addr;
+    __asm__ __volatile__(
+      "{ .reg .u64 addr; cvta.to.shared.u64 addr, %1; cvt.u32.u64 %0, addr; }\n"
+      : "=r"(smem_addr)
+      : "l"((void *)({smem_addr}))
+    );
+    __asm__ __volatile__(
+      "{ .reg .u64 addr; cvta.to.shared.u64 addr, %1; cvt.u32.u64 %0, addr; }\n"
+      : "=r"(barrier_addr)
+      : "l"((void *)({barrier}))
+    );
+    __asm__ __volatile__(
+      "cp.async.bulk.shared::cluster.global.mbarrier::complete_tx::bytes [%0], [%1], %2, [%3];"
+      :: "r"(smem_addr), "l"((void*)({global_ptr})), "r"((unsigned int)({bytes})),
+         "r"(barrier_addr)
+      : "memory"
+    );
+  }
+)";
+  Replacer replacer;
+  replacer.register_rule("{smem_addr}", shared_ptr + " + " + shared_elem_offset);
+  replacer.register_rule("{global_ptr}", global_ptr + " + " + global_elem_offset);
+  replacer.register_rule("{bytes}", bytes);
+  replacer.register_rule("{barrier}", barrier_ptr + " + " + barrier_elem_offset);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
+/*!
+ * \brief Print an mbarrier instruction taking the shared address of the barrier and one operand.
+ */
+inline std::string PrintBarrierAssembly(const std::string& instruction,
+                                        const std::string& barrier_ptr,
+                                        const std::string& barrier_elem_offset,
+                                        const std::string& operand) {
+  std::string asm_code = R"(
+  {
+    unsigned int barrier_addr;
+    __asm__ __volatile__(
+      "{ .reg .u64 addr; cvta.to.shared.u64 addr, %1; cvt.u32.u64 %0, addr; }\n"
+      : "=r"(barrier_addr)
+      : "l"((void *)({barrier}))
+    );
+    __asm__ __volatile__(
+      {instruction}
+      :: "r"(barrier_addr), "r"((unsigned int)({operand}))
+      : "memory"
+    );
+  }
+)";
+  Replacer replacer;
+  replacer.register_rule("{instruction}", instruction);
+  replacer.register_rule("{barrier}", barrier_ptr + " + " + barrier_elem_offset);
+  replacer.register_rule("{operand}", operand);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
+std::string PrintInitBarrierThreadCountAssembly(const std::string& barrier_ptr,
+                                                const std::string& barrier_elem_offset,
+                                                const std::string& thread_count) {
+  return PrintBarrierAssembly(R"("mbarrier.init.shared.b64 [%0], %1;")", barrier_ptr,
+                              barrier_elem_offset, thread_count);
+}
+
+std::string PrintArriveBarrierExpectTxAssembly(const std::string& barrier_ptr,
+                                               const std::string& barrier_elem_offset,
+                                               const std::string& byte_count) {
+  return PrintBarrierAssembly(R"("mbarrier.arrive.expect_tx.shared.b64 _, [%0], %1;")",
+                              barrier_ptr, barrier_elem_offset, byte_count);
+}
+
+std::string PrintWaitBarrierAssembly(const std::string& barrier_ptr,
+                                     const std::string& barrier_elem_offset,
+                                     const std::string& phase) {
+  // The labels are local to the braces, so that the loop can be inlined several times.
+  std::string instruction = R"("{\n"
+      ".reg .pred done;\n"
+      "WAIT:\n"
+      "mbarrier.try_wait.parity.shared.b64 done, [%0], %1;\n"
+      "@!done bra WAIT;\n"
+      "}\n")";
+  return PrintBarrierAssembly(instruction, barrier_ptr, barrier_elem_offset, phase);
+}
+
+/*!
+ * \brief Print the 64-bit descriptor of a matrix in shared memory without swizzling.
+ */
+inline std::string PrintMatrixDescriptor(const std::string& name, const std::string& addr,
+                                         const std::string& leading_byte_offset,
+                                         const std::string& stride_byte_offset) {
+  std::stringstream ss;
+  ss << "    unsigned long long " << name << " = "
+     << "((unsigned long long)((" << addr << " & 0x3FFFF) >> 4)) | "
+     << "((unsigned long long)((((unsigned int)(" << leading_byte_offset
+     << ")) & 0x3FFFF) >> 4) << 16) | "
+     << "((unsigned long long)((((unsigned int)(" << stride_byte_offset
+     << ")) & 0x3FFFF) >> 4) << 32);\n";
+  return ss.str();
+}
+
+std::string PrintWGMMAAssembly(const std::string& shape, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& a_ptr, const std::string& a_offset,
+                               const std::string& a_leading_byte_offset,
+                               const std::string& a_stride_byte_offset,
+                               const std::string& b_ptr, const std::string& b_offset,
+                               const std::string& b_leading_byte_offset,
+                               const std::string& b_stride_byte_offset,
+                               const std::string& c_ptr, const std::string& c_offset,
+                               const std::string& scale_d, bool trans_a, bool trans_b) {
+  auto [m, n, k] = ptx::ParseMMAShape(shape);
+  ptx::DataType dtype_a = ptx::DTypeFromString(A_dtype), dtype_b = ptx::DTypeFromString(B_dtype),
+                dtype_c = ptx::DTypeFromString(C_dtype);
+  CHECK(m == 64 && k == 16 && n % 8 == 0 && n >= 8 && n <= 256)
+      << "wgmma only supports the shapes m64nNk16 with N a multiple of 8 up to 256, but got "
+      << shape;
+  CHECK(dtype_a == dtype_b &&
+        (dtype_a == ptx::DataType::kFloat16 || dtype_a == ptx::DataType::kBFloat16))
+      << "wgmma only supports the multiplicands of fp16 or bf16, but got " << A_dtype << " and "
+      << B_dtype;
+  CHECK(dtype_c == ptx::DataType::kFloat32 ||
+        (dtype_c == ptx::DataType::kFloat16 && dtype_a == ptx::DataType::kFloat16))
+      << "wgmma only supports the accumulators of fp32, or fp16 with fp16 multiplicands, but got "
+      << C_dtype;
+  // Each thread of the warpgroup holds m * n / 128 accumulators, packed in the 32-bit registers.
+  int num_regs = m * n * ptx::DTypeBits(dtype_c) / 32 / 128;
+  std::stringstream templates, outputs;
+  templates << "{";
+  for (int i = 0; i < num_regs; ++i) {
+    templates << (i ? ", " : "") << "%" << i;
+    if (dtype_c == ptx::DataType::kFloat32) {
+      outputs << (i ? ", " : "") << "\"+f\"(((float *)(" << c_ptr << " + " << c_offset << "))["
+              << i << "])";
+    } else {
+      outputs << (i ? ", " : "") << "\"+r\"(((unsigned *)(" << c_ptr << " + " << c_offset
+              << "))[" << i << "])";
+    }
+  }
+  templates << "}, %" << num_regs << ", %" << num_regs + 1 << ", p, 1, 1, " << trans_a << ", "
+            << trans_b;
+  std::string asm_code = R"(
+  {
+    unsigned int a_addr, b_addr;
+    __asm__ __volatile__(
+      "{ .reg .u64 addr; cvta.to.shared.u64 addr, %1; cvt.u32.u64 %0, addr; }\n"
+      : "=r"(a_addr)
+      : "l"((void *)({a_smem}))
+    );
+    __asm__ __volatile__(
+      "{ .reg .u64 addr; cvta.to.shared.u64 addr, %1; cvt.u32.u64 %0, addr; }\n"
+      : "=r"(b_addr)
+      : "l"((void *)({b_smem}))
+    );
+{descriptors}    __asm__ __volatile__(
+      "{\n"
+      ".reg .pred p;\n"
+      "setp.ne.b32 p, %{scale_d_index}, 0;\n"
+      "wgmma.mma_async.sync.aligned{.shape}{.dtype}{.atype}{.btype} {templates};\n"
+      "}\n"
+      : {outputs}
+      : "l"(desc_a), "l"(desc_b), "r"((int)({scale_d}))
+    );
+  }
+)";
+  Replacer replacer;
+  replacer.register_rule("{a_smem}", a_ptr + " + " + a_offset);
+  replacer.register_rule("{b_smem}", b_ptr + " + " + b_offset);
+  replacer.register_rule(
+      "{descriptors}",
+      PrintMatrixDescriptor("desc_a", "a_addr", a_leading_byte_offset, a_stride_byte_offset) +
+          PrintMatrixDescriptor("desc_b", "b_addr", b_leading_byte_offset, b_stride_byte_offset));
+  replacer.register_rule("{scale_d_index}", std::to_string(num_regs + 2));
+  replacer.register_rule("{.shape}", "." + shape);
+  replacer.register_rule("{.dtype}", ptx::DTypeToString(dtype_c));
+  replacer.register_rule("{.atype}", ptx::DTypeToString(dtype_a));
+  replacer.register_rule("{.btype}", ptx::DTypeToString(dtype_b));
+  replacer.register_rule("{templates}", templates.str());
+  replacer.register_rule("{outputs}", outputs.str());
+  replacer.register_rule("{scale_d}", scale_d);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
 }  // namespace codegen
 }  // namespace tvm
@@ -92,6 +92,85 @@ std::string PrintCpAsyncAssembly(const std::string& shared_ptr,
                                  const std::string& global_ptr,
                                  const std::string& global_elem_offset, const std::string& bytes);
 
+/*!
+ * \brief Print ptx cp.async.bulk assembly string given parameters.
+ * \param shared_ptr: The pointer to the destination shared memory.
+ * \param shared_elem_offset: The offset into the shared memory.
+ * \param global_ptr: The pointer to the global memory.
+ * \param global_elem_offset: The offset into the global memory.
+ * \param bytes: The number of bytes to copy, a multiple of 16.
+ * \param barrier_ptr: The pointer to the mbarrier in shared memory completing the copy.
+ * \param barrier_elem_offset: The offset of the mbarrier.
+ */
+std::string PrintCpAsyncBulkAssembly(const std::string& shared_ptr,
+                                     const std::string& shared_elem_offset,
+                                     const std::string& global_ptr,
+                                     const std::string& global_elem_offset,
+                                     const std::string& bytes, const std::string& barrier_ptr,
+                                     const std::string& barrier_elem_offset);
+
+/*!
+ * \brief Print ptx mbarrier.init assembly string given parameters.
+ * \param barrier_ptr: The pointer to the mbarrier in shared memory.
+ * \param barrier_elem_offset: The offset of the mbarrier.
+ * \param thread_count: The number of the threads arriving at the mbarrier in each phase.
+ */
+std::string PrintInitBarrierThreadCountAssembly(const std::string& barrier_ptr,
+                                                const std::string& barrier_elem_offset,
+                                                const std::string& thread_count);
+
+/*!
+ * \brief Print ptx mbarrier.arrive.expect_tx assembly string given parameters.
+ * \param barrier_ptr: The pointer to the mbarrier in shared memory.
+ * \param barrier_elem_offset: The offset of the mbarrier.
+ * \param byte_count: The number of bytes the async copies of the phase complete.
+ */
+std::string PrintArriveBarrierExpectTxAssembly(const std::string& barrier_ptr,
+                                               const std::string& barrier_elem_offset,
+                                               const std::string& byte_count);
+
+/*!
+ * \brief Print ptx mbarrier.try_wait.parity assembly string given parameters.
+ * \param barrier_ptr: The pointer to the mbarrier in shared memory.
+ * \param barrier_elem_offset: The offset of the mbarrier.
+ * \param phase: The parity of the phase to wait for.
+ */
+std::string PrintWaitBarrierAssembly(const std::string& barrier_ptr,
+                                     const std::string& barrier_elem_offset,
+                                     const std::string& phase);
+
+/*!
+ * \brief Print warpgroup-level wgmma assembly string given parameters, with both multiplicands in
+ *  shared memory described by the descriptors without swizzling.
+ * \param shape The shape string m64nNk16.
+ * \param A_dtype The data type of multiplicand A.
+ * \param B_dtype The data type of multiplicand B.
+ * \param C_dtype The data type of accumulator C.
+ * \param a_ptr Pointer to the shared buffer A.
+ * \param a_offset The offset of the first element in A.
+ * \param a_leading_byte_offset The bytes between the core matrices of A along the leading dim.
+ * \param a_stride_byte_offset The bytes between the core matrices of A along the strided dim.
+ * \param b_ptr Pointer to the shared buffer B.
+ * \param b_offset The offset of the first element in B.
+ * \param b_leading_byte_offset The bytes between the core matrices of B along the leading dim.
+ * \param b_stride_byte_offset The bytes between the core matrices of B along the strided dim.
+ * \param c_ptr Pointer to the local buffer of the accumulators.
+ * \param c_offset The offset of the first accumulator in C.
+ * \param scale_d Whether to accumulate into C, or to overwrite it.
+ * \param trans_a Whether A is transposed.
+ * \param trans_b Whether B is transposed.
+ */
+std::string PrintWGMMAAssembly(const std::string& shape, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& a_ptr, const std::string& a_offset,
+                               const std::string& a_leading_byte_offset,
+                               const std::string& a_stride_byte_offset,
+                               const std::string& b_ptr, const std::string& b_offset,
+                               const std::string& b_leading_byte_offset,
+                               const std::string& b_stride_byte_offset,
+                               const std::string& c_ptr, const std::string& c_offset,
+                               const std::string& scale_d, bool trans_a, bool trans_b);
+
 }  // namespace codegen
 }  // namespace tvm
 
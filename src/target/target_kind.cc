@@ -265,6 +265,13 @@ TVM_REGISTER_TARGET_KIND("llvm", kDLCPU)
     .add_attr_option<String>("mfloat-abi")
     .add_attr_option<String>("mabi")
     .add_attr_option<Integer>("num-cores")
+    // The width of the vector registers in bits, e.g. of SVE or RVV
+    .add_attr_option<Integer>("vector-width")
+    // The sizes of the data caches and of their lines in bytes
+    .add_attr_option<Integer>("l1-cache-size")
+    .add_attr_option<Integer>("l2-cache-size")
+    .add_attr_option<Integer>("l3-cache-size")
+    .add_attr_option<Integer>("cache-line-size")
     // Fast math flags, see https://llvm.org/docs/LangRef.html#fast-math-flags
     .add_attr_option<Bool>("fast-math")  // implies all the below
     .add_attr_option<Bool>("fast-math-nnan")
@@ -421,6 +428,7 @@ TVM_REGISTER_TARGET_KIND("hexagon", kDLHexagon)
     .add_attr_option<String>("mtriple")
     .add_attr_option<Array<String>>("llvm-options")
     .add_attr_option<Integer>("num-cores")
+    .add_attr_option<Integer>("vtcm-capacity")
     .set_default_keys({"hexagon"});
 
 TVM_REGISTER_TARGET_KIND("stackvm", kDLCPU);
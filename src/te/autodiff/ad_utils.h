@@ -130,6 +130,15 @@ TVM_DLL arith::IntConstraintsTransform SimplifyDomain(const arith::IntConstraint
 TVM_DLL Tensor RemoveJacobianAndLiftNonzeroCond(const Tensor& tensor,
                                                 const Map<Var, Range>& vranges = Map<Var, Range>());
 
+/*!
+ * \brief Differentiate an expression wrt the element of a tensor.
+ * \param expr The expression to differentiate.
+ * \param input The input tensor.
+ * \param indices The indices of the element of the input.
+ * \return The derivative of the expression wrt `input(indices)`.
+ */
+PrimExpr Jacobian(const PrimExpr& expr, const Tensor& input, const Array<PrimExpr>& indices);
+
 }  // namespace te
 }  // namespace tvm
 #endif  // TVM_TE_AUTODIFF_AD_UTILS_H_
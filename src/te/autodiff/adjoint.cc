@@ -29,7 +29,12 @@
  *        (2) multiply the Jacobian (PartialAdjoint),
  *        (3) and sum them together to get the adjoint of the input itself.
  *        The three steps are computed recursively.
+ *        A consumer accessing the tensor once at affine indices, e.g. an elementwise op, a
+ *        transpose, a strided slice or a broadcast, gets its product computed directly, without
+ *        building the Jacobian.
  */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/te/autodiff.h>
 #include <tvm/tir/stmt_functor.h>
@@ -37,6 +42,7 @@
 #include <tvm/topi/transform.h>
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "ad_utils.h"
@@ -61,7 +67,132 @@ Tensor Identity(const Tensor& output) {
   return te::compute(shape, func, "identity");
 }
 
+/*!
+ * \brief Compute the vector-Jacobian product of a consumer accessing the input once, with each
+ *  index affine in at most one of its axes and each axis in at most one index, by inverting the
+ *  access. The axes of the output the access does not depend on are summed over.
+ * \return The product, or an undefined tensor if the consumer does not access the input this way.
+ */
+Tensor DirectVectorJacobianProduct(const Tensor& output, const Tensor& input, const Tensor& head) {
+  const ComputeOpNode* op = output->op.as<ComputeOpNode>();
+  if (op == nullptr || !op->reduce_axis.empty()) {
+    return Tensor();
+  }
+  PrimExpr body = op->body[output->value_index];
+  if (body->IsInstance<ReduceNode>() || !body.dtype().is_float()) {
+    return Tensor();
+  }
+  const ProducerLoadNode* access = nullptr;
+  int num_accesses = 0;
+  tir::PostOrderVisit(body, [&](const ObjectRef& node) {
+    if (const auto* load = node.as<ProducerLoadNode>()) {
+      if (load->producer == input) {
+        access = load;
+        ++num_accesses;
+      }
+    }
+  });
+  if (num_accesses != 1) {
+    return Tensor();
+  }
+  Array<Var> axis_vars;
+  for (const IterVar& iv : op->axis) {
+    axis_vars.push_back(iv->var);
+  }
+  // For each index of the access, the axis it depends on, if any, with its scale and offset
+  std::vector<int> index_axis;
+  std::vector<int64_t> index_scale;
+  std::vector<PrimExpr> index_offset;
+  std::vector<bool> axis_used(axis_vars.size(), false);
+  for (const PrimExpr& index : access->indices) {
+    Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, axis_vars);
+    if (coeffs.empty()) {
+      return Tensor();
+    }
+    int axis = -1;
+    int64_t scale = 0;
+    for (size_t k = 0; k < axis_vars.size(); ++k) {
+      const auto* coeff = coeffs[k].as<IntImmNode>();
+      if (coeff == nullptr) {
+        return Tensor();
+      }
+      if (coeff->value != 0) {
+        if (axis != -1 || axis_used[k]) {
+          return Tensor();
+        }
+        axis = k;
+        scale = coeff->value;
+        axis_used[k] = true;
+      }
+    }
+    index_axis.push_back(axis);
+    index_scale.push_back(scale);
+    index_offset.push_back(coeffs.back());
+  }
+
+  // The derivative of the body wrt the only access, where the indices of the access are trivially
+  // equal to themselves
+  arith::Analyzer analyzer;
+  PrimExpr derivative = analyzer.Simplify(Jacobian(body, input, access->indices));
+
+  size_t num_prefix_dims = head->shape.size() - output->shape.size();
+  Array<PrimExpr> result_shape(head->shape.begin(), head->shape.begin() + num_prefix_dims);
+  for (const PrimExpr& e : input->shape) {
+    result_shape.push_back(e);
+  }
+  auto func = [&](const Array<Var>& indices) {
+    arith::Analyzer analyzer;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      analyzer.Bind(indices[i], Range::FromMinExtent(0, result_shape[i]));
+    }
+    // Invert the access: each axis takes the value the index depending on it equals the input
+    // index with, and the others are summed over.
+    Map<Var, PrimExpr> vmap;
+    PrimExpr cond = const_true();
+    for (size_t i = 0; i < index_axis.size(); ++i) {
+      PrimExpr j = indices[num_prefix_dims + i] - index_offset[i];
+      if (index_axis[i] == -1) {
+        cond = cond && (j == 0);
+        continue;
+      }
+      const IterVar& iv = op->axis[index_axis[i]];
+      PrimExpr value = j;
+      if (index_scale[i] != 1) {
+        PrimExpr scale = make_const(j.dtype(), index_scale[i]);
+        cond = cond && (floormod(j, scale) == 0);
+        value = floordiv(j, scale);
+      }
+      cond = cond && (value >= iv->dom->min) && (value < iv->dom->min + iv->dom->extent);
+      vmap.Set(iv->var, value);
+    }
+    Array<IterVar> sum_axes;
+    for (size_t k = 0; k < axis_vars.size(); ++k) {
+      if (!axis_used[k]) {
+        IterVar iv = reduce_axis(op->axis[k]->dom, axis_vars[k]->name_hint + ".sum");
+        sum_axes.push_back(iv);
+        vmap.Set(axis_vars[k], iv->var);
+      }
+    }
+    Array<PrimExpr> head_indices(indices.begin(), indices.begin() + num_prefix_dims);
+    for (const Var& var : axis_vars) {
+      head_indices.push_back(vmap[var]);
+    }
+    PrimExpr res = Substitute(Mul(head(head_indices), derivative), vmap);
+    cond = analyzer.Simplify(cond);
+    if (!is_one(cond)) {
+      // Not a select, the head is out of bounds where the condition does not hold
+      res = if_then_else(cond, res, make_zero(res.dtype()));
+    }
+    return sum_axes.empty() ? res : sum(res, sum_axes);
+  };
+  return te::compute(result_shape, func, output->op->name + "." + input->op->name + ".grad");
+}
+
 Tensor VectorJacobianProduct(const Tensor& output, const Tensor& input, const Tensor& head) {
+  Tensor direct = DirectVectorJacobianProduct(output, input, head);
+  if (direct.defined()) {
+    return direct;
+  }
   Tensor jac = Jacobian(output, input);
   Tensor result = topi::tensordot(head, jac, /*axes=*/output->shape.size(),
                                   output->op->name + "." + input->op->name + ".grad");
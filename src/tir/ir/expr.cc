@@ -1097,7 +1097,8 @@ void BufferLoadNode::LegalizeDType() {
   this->dtype = buffer->dtype.with_lanes(index_lanes * buffer_lanes);
 }
 
-BufferLoad::BufferLoad(Buffer buffer, Array<PrimExpr> indices, Span span) {
+BufferLoad::BufferLoad(Buffer buffer, Array<PrimExpr> indices, Optional<PrimExpr> predicate,
+                       Span span) {
   ICHECK_EQ(buffer->shape.size(), indices.size())
       << "Buffer " << buffer->name << " is " << buffer->shape.size()
       << "-dimensional, cannot be indexed with the " << indices.size()
@@ -1106,15 +1107,22 @@ BufferLoad::BufferLoad(Buffer buffer, Array<PrimExpr> indices, Span span) {
   ObjectPtr<BufferLoadNode> node = make_object<BufferLoadNode>();
   node->buffer = std::move(buffer);
   node->indices = std::move(indices);
+  node->predicate = std::move(predicate);
   node->span = std::move(span);
   node->LegalizeDType();
+  if (node->predicate.defined()) {
+    DataType predicate_dtype = node->predicate.value().dtype();
+    CHECK(predicate_dtype.is_bool() && predicate_dtype.lanes() == node->dtype.lanes())
+        << "ValueError: The predicate of a load of " << node->dtype << " from "
+        << node->buffer->name << " must be a boolean vector of " << node->dtype.lanes()
+        << " lanes, but got " << predicate_dtype;
+  }
   data_ = std::move(node);
 }
 
 TVM_REGISTER_GLOBAL("tir.BufferLoad")
-    .set_body_typed([](Buffer buffer, Array<PrimExpr> indices, Span span) {
-      return BufferLoad(buffer, indices, span);
-    });
+    .set_body_typed([](Buffer buffer, Array<PrimExpr> indices, Optional<PrimExpr> predicate,
+                       Span span) { return BufferLoad(buffer, indices, predicate, span); });
 
 TVM_REGISTER_NODE_TYPE(BufferLoadNode);
 
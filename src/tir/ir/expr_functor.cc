@@ -40,6 +40,9 @@ void ExprVisitor::VisitExpr_(const LoadNode* op) {
 
 void ExprVisitor::VisitExpr_(const BufferLoadNode* op) {
   VisitArray(op->indices, [this](const PrimExpr& e) { this->VisitExpr(e); });
+  if (op->predicate.defined()) {
+    this->VisitExpr(op->predicate.value());
+  }
 }
 
 void ExprVisitor::VisitExpr_(const ProducerLoadNode* op) {
@@ -133,10 +136,12 @@ PrimExpr ExprMutator::VisitExpr_(const LoadNode* op) {
 PrimExpr ExprMutator::VisitExpr_(const BufferLoadNode* op) {
   auto fmutate = [this](const PrimExpr& e) { return this->VisitExpr(e); };
   Array<PrimExpr> indices = op->indices.Map(fmutate);
-  if (indices.same_as(op->indices)) {
+  Optional<PrimExpr> predicate =
+      op->predicate.defined() ? Optional<PrimExpr>(fmutate(op->predicate.value())) : NullOpt;
+  if (indices.same_as(op->indices) && predicate.same_as(op->predicate)) {
     return GetRef<PrimExpr>(op);
   } else {
-    return BufferLoad(op->buffer, indices);
+    return BufferLoad(op->buffer, indices, predicate);
   }
 }
 
@@ -23,12 +23,24 @@
  */
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
 namespace tvm {
 namespace tir {
 namespace transform {
 
+// The number of threads running a PrimFuncPass over the functions of a module, all the available
+// ones if non-positive. The functions are rewritten one at a time by default.
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.prim_func_pass_num_threads", Integer);
+
 /*!
  * \brief Function level pass that applies transformations to all
  *        TIR functions within the module.
@@ -53,6 +65,17 @@ class PrimFuncPassNode : public PassNode {
    */
   IRModule operator()(IRModule mod, const PassContext& pass_ctx) const final;
 
+  /*!
+   * \brief Run the pass on the PrimFuncs of a module concurrently.
+   *
+   * \param mod The module that an optimization pass runs on.
+   * \param pass_ctx The context that an optimization pass executes on.
+   * \param num_threads The number of threads.
+   *
+   * \return Return the updated module.
+   */
+  IRModule RunParallel(IRModule mod, const PassContext& pass_ctx, int num_threads) const;
+
   /*!
    * \brief Get the pass information/meta data.
    */
@@ -88,6 +111,21 @@ PrimFuncPass::PrimFuncPass(
 // Perform Module -> Module optimizations at the PrimFunc level.
 IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx) const {
   ICHECK(mod.defined());
+  int num_threads = pass_ctx->GetConfig<Integer>("tir.prim_func_pass_num_threads", Integer(1))
+                        .value()
+                        ->value;
+  if (num_threads <= 0) {
+    num_threads = runtime::threading::MaxConcurrency();
+  }
+  if (num_threads > 1) {
+    int num_funcs = 0;
+    for (const auto& kv : mod->functions) {
+      num_funcs += kv.second->IsInstance<PrimFuncNode>();
+    }
+    if (num_funcs > 1) {
+      return RunParallel(mod, pass_ctx, std::min(num_threads, num_funcs));
+    }
+  }
   std::vector<ObjectRef> deleted_list;
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
@@ -113,6 +151,53 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   return mod;
 }
 
+IRModule PrimFuncPassNode::RunParallel(IRModule mod, const PassContext& pass_ctx,
+                                       int num_threads) const {
+  std::vector<GlobalVar> gvars;
+  std::vector<PrimFunc> funcs;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<PrimFuncNode>()) {
+      gvars.push_back(kv.first);
+      funcs.push_back(GetRef<PrimFunc>(func));
+    }
+  }
+  // The workers only read the module, which is updated once they are all done, so that it is never
+  // shared mutably. Each worker enters the pass context and the target of the caller, as they are
+  // thread-local, but without the instruments, which run on the calling thread around the pass.
+  ObjectPtr<PassContextNode> worker_ctx_node = make_object<PassContextNode>(*pass_ctx.operator->());
+  worker_ctx_node->instruments = {};
+  PassContext worker_ctx(worker_ctx_node);
+  Optional<Target> target = Target::Current(true);
+  std::vector<std::exception_ptr> errors(funcs.size());
+  support::parallel_for_dynamic(0, funcs.size(), num_threads, [&](int thread_id, int i) {
+    try {
+      With<PassContext> ctx_scope(worker_ctx);
+      if (target.defined()) {
+        With<Target> target_scope(target.value());
+        funcs[i] = pass_func(std::move(funcs[i]), mod, worker_ctx);
+      } else {
+        funcs[i] = pass_func(std::move(funcs[i]), mod, worker_ctx);
+      }
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  });
+  for (const std::exception_ptr& error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+  IRModuleNode* mod_ptr = mod.CopyOnWrite();
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    if (funcs[i].defined()) {
+      mod_ptr->functions.Set(gvars[i], funcs[i]);
+    } else {
+      mod_ptr->functions.erase(gvars[i]);
+    }
+  }
+  return mod;
+}
+
 Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
     int opt_level, String name, tvm::Array<String> required, bool traceable) {
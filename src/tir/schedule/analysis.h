@@ -655,6 +655,15 @@ bool NeedsMultiLevelTiling(const ScheduleState& self, const StmtSRef& block_sref
  */
 bool IsSpatialPrimFunc(const PrimFunc& func);
 
+/*!
+ * \brief Get the products of the extents of the spatial and of the reduction loops of a block.
+ * \param self The schedule state.
+ * \param block_sref The block to be checked.
+ * \return The two products, or (-1, -1) if a loop is dynamic or neither spatial nor reduction.
+ */
+std::pair<int64_t, int64_t> GetCumulativeSpaceAndReductionLength(const tir::ScheduleState& self,
+                                                                 const tir::StmtSRef& block_sref);
+
 /*!
  * \brief Checks if the rfactor or cross thread reduction is beneficial to the given block.
  * \param self The schedule state.
@@ -2032,6 +2032,12 @@ bool CheckAutoTensorizeApplicable(const ScheduleState& state, const tir::StmtSRe
   const BlockRealize& block = tir::GetBlockRealize(state, block_sref);
   arith::Analyzer analyzer;
   auto desc_info = tir::ExtractTensorIntrinDescInfo(&analyzer, desc_func);
+  // Skip the comparison if the signatures tell the blocks apart
+  std::optional<uint64_t> block_signature = AutoTensorizeSignature(block->block);
+  std::optional<uint64_t> desc_signature = AutoTensorizeSignature(desc_info.desc_block->block);
+  if (block_signature && desc_signature && *block_signature != *desc_signature) {
+    return false;
+  }
 
   return extractor->VisitStmt(block->block, desc_info.desc_block->block);
 }
@@ -2070,5 +2076,13 @@ TVM_REGISTER_GLOBAL("tir.schedule.GetAutoTensorizeMappingInfo")
       return GetAutoTensorizeMappingInfo(sch->state(), sch->GetSRef(block), desc_func);
     });
 
+TVM_REGISTER_GLOBAL("tir.schedule.GetAutoTensorizeSignature")
+    .set_body_typed([](Block block) -> Optional<IntImm> {
+      if (std::optional<uint64_t> signature = AutoTensorizeSignature(block)) {
+        return IntImm(DataType::Int(64), static_cast<int64_t>(*signature));
+      }
+      return NullOpt;
+    });
+
 }  // namespace tir
 }  // namespace tvm
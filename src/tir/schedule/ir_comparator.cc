@@ -18,6 +18,10 @@
  */
 #include "./ir_comparator.h"
 
+#include <cstring>
+
+#include "../../support/utils.h"
+
 namespace tvm {
 
 namespace tir {
@@ -695,5 +699,59 @@ bool AutoTensorizeComparator::CompareBufferAccess(const T* lhs, const T* rhs) {
   return true;
 }
 
+/******** AutoTensorize Signature ********/
+
+class AutoTensorizeSignatureHasher : public ExprVisitor {
+ public:
+  static std::optional<uint64_t> Hash(const Block& block) {
+    for (const IterVar& iter : block->iter_vars) {
+      if (iter->iter_type != IterVarType::kDataPar && iter->iter_type != IterVarType::kCommReduce) {
+        return std::nullopt;
+      }
+    }
+    const auto* store = block->body.as<BufferStoreNode>();
+    if (store == nullptr) {
+      return std::nullopt;
+    }
+    AutoTensorizeSignatureHasher hasher;
+    hasher.HashBuffer(store->buffer);
+    hasher.VisitExpr(store->value);
+    return hasher.hash_;
+  }
+
+ private:
+  void VisitExpr(const PrimExpr& expr) final {
+    hash_ = support::HashCombine(hash_, expr->type_index());
+    hash_ = support::HashCombine(hash_, expr.dtype().code());
+    ExprVisitor::VisitExpr(expr);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final { HashBuffer(op->buffer); }
+
+  void VisitExpr_(const IntImmNode* op) final { hash_ = support::HashCombine(hash_, op->value); }
+
+  void VisitExpr_(const FloatImmNode* op) final {
+    uint64_t bits;
+    std::memcpy(&bits, &op->value, sizeof(bits));
+    hash_ = support::HashCombine(hash_, bits);
+  }
+
+  /*! \brief Hash a buffer by its dtype and the order of its first access. */
+  void HashBuffer(const Buffer& buffer) {
+    auto it = buffer_indices_.emplace(buffer.get(), buffer_indices_.size()).first;
+    hash_ = support::HashCombine(hash_, it->second);
+    hash_ = support::HashCombine(hash_, buffer->dtype.code());
+    hash_ = support::HashCombine(hash_, buffer->dtype.bits());
+    hash_ = support::HashCombine(hash_, buffer->dtype.lanes());
+  }
+
+  uint64_t hash_{0};
+  std::unordered_map<const BufferNode*, size_t> buffer_indices_;
+};
+
+std::optional<uint64_t> AutoTensorizeSignature(const Block& block) {
+  return AutoTensorizeSignatureHasher::Hash(block);
+}
+
 }  // namespace tir
 }  // namespace tvm
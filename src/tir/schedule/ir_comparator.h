@@ -19,6 +19,7 @@
 #ifndef TVM_TIR_SCHEDULE_IR_COMPARATOR_H_
 #define TVM_TIR_SCHEDULE_IR_COMPARATOR_H_
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -158,6 +159,19 @@ class AutoTensorizeComparator : public TensorizeComparator {
   Map<Var, arith::IntSet> inner_iter_dom_map_;
 };
 
+/*!
+ * \brief The signature of a block for auto tensorization, which hashes what
+ * `AutoTensorizeComparator` requires to be equal: the arithmetic operations and their dtype codes,
+ * the constants, the dtypes of the buffers and the order in which the buffers are accessed. The
+ * loops and the buffer indices are not hashed. A workload block and the block of a tensor intrin
+ * with different signatures never match, so that the intrinsics can be filtered before the full
+ * comparison.
+ * \param block The compute block of the workload or of the description of a tensor intrin.
+ * \return The signature, or nothing if the block is not a single buffer store of data parallel
+ * and reduction iters, in which case the comparison decides.
+ */
+std::optional<uint64_t> AutoTensorizeSignature(const Block& block);
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -180,13 +180,13 @@ void UpdateSRef(ScheduleStateNode* self, StmtSRefNode* sref, const StmtNode* new
 class BlockInfoCollector : private StmtVisitor {
  public:
   static void Collect(ScheduleStateNode* self, const Stmt& stmt) {
-    BlockInfoCollector collector(self);
+    BlockInfoCollector collector(self, stmt.get());
     collector.VisitStmt(stmt);
   }
 
  private:
-  explicit BlockInfoCollector(ScheduleStateNode* self)
-      : self_(self), srefs_{}, block2realize_{}, block_frames_{} {
+  explicit BlockInfoCollector(ScheduleStateNode* self, const StmtNode* root)
+      : self_(self), root_(root), srefs_{}, block2realize_{}, block_frames_{} {
     block_frames_.emplace({});
   }
 
@@ -205,27 +205,53 @@ class BlockInfoCollector : private StmtVisitor {
   }
 
   void MakeBlockInfo(StmtSRef scope_root) {
-    bool is_root_block = srefs_.empty();
     // Calculate `BlockInfo::scope`
     Array<StmtSRef> child_block_srefs = std::move(block_frames_.back());
     BlockInfo& info = self_->block_info[scope_root] = BlockInfo(BlockScope(child_block_srefs));
     // Set `affine_binding`
-    if (is_root_block) {
+    SetAffineBinding(scope_root, &info);
+    // Set `region_cover` to true, will be updated on its scope block
+    info.region_cover = true;
+    // Set `stage_pipeline` and `region_cover` for its intermediate children
+    info.scope->stage_pipeline =
+        CheckRegionCoverAndStagePipeline(info, scope_root, child_block_srefs);
+  }
+
+  void SetAffineBinding(const StmtSRef& block_sref, BlockInfo* info) {
+    if (srefs_.empty()) {
       // If the block doesn't have outer loops and BlockRealize,
       // then we set the affine binding flag as true only if the block has no block vars
-      const BlockNode* block = TVM_SREF_TO_BLOCK(scope_root);
-      if (block->iter_vars.empty()) info.affine_binding = true;
+      const BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+      if (block->iter_vars.empty()) info->affine_binding = true;
     } else {
-      info.affine_binding =
-          IsAffineBinding(/*realize=*/block2realize_.at(scope_root->stmt),
+      info->affine_binding =
+          IsAffineBinding(/*realize=*/block2realize_.at(block_sref->stmt),
                           /*loop_var_ranges=*/LoopDomainOfSRefTreePath(srefs_.back()),
                           /*analyzer=*/&analyzer_);
     }
+  }
+
+  /*!
+   * \brief Reuse the BlockInfo of a block whose subtree is not changed since it was calculated.
+   * The scope of the block and the info of the blocks inside only depend on the block itself, and
+   * only the flags depending on the outer scope are updated.
+   * \return Whether the BlockInfo is reused
+   */
+  bool ReuseBlockInfo(const BlockRealizeNode* realize) {
+    if (realize == root_) {
+      return false;
+    }
+    StmtSRef sref = self_->stmt2ref.at(realize->block.get());
+    auto it = self_->block_info.find(sref);
+    if (it == self_->block_info.end() || it->second.subtree_modified) {
+      return false;
+    }
+    BlockInfo& info = it->second;
+    SetAffineBinding(sref, &info);
     // Set `region_cover` to true, will be updated on its scope block
     info.region_cover = true;
-    // Set `stage_pipeline` and `region_cover` for its intermediate children
-    info.scope->stage_pipeline =
-        CheckRegionCoverAndStagePipeline(info, scope_root, child_block_srefs);
+    block_frames_.back().push_back(sref);
+    return true;
   }
 
   bool CheckRegionCoverAndStagePipeline(const BlockInfo& info, const StmtSRef& scope_root,
@@ -366,9 +392,12 @@ class BlockInfoCollector : private StmtVisitor {
   }
 
   void VisitStmt_(const BlockRealizeNode* realize) final {
-    block_frames_.emplace_back();
     const BlockNode* block = realize->block.get();
     block2realize_.emplace(block, GetRef<BlockRealize>(realize));
+    if (ReuseBlockInfo(realize)) {
+      return;
+    }
+    block_frames_.emplace_back();
     // Recursive visit
     PushSRef(block);
     VisitStmt(block->body);  // `block->init` is not visited
@@ -388,6 +417,8 @@ class BlockInfoCollector : private StmtVisitor {
 
   /*! \brief The ScheduleStateNode we are operating on */
   ScheduleStateNode* self_;
+  /*! \brief The statement to be collected, whose BlockInfo is always recalculated */
+  const StmtNode* root_;
   /*! \brief The stack frame used to indicate the current scope */
   std::vector<StmtSRef> srefs_;
   /*! \brief The BlockRealize corresponding to blocks */
@@ -793,6 +824,7 @@ class SRefUpdater : public StmtVisitor {
       new_info.scope->stage_pipeline = info.scope->stage_pipeline;
       info.scope = std::move(new_info.scope);
     }
+    info.subtree_modified = true;
   }
 
   /*! \brief The schedule state class to be worked on */
@@ -951,6 +983,15 @@ void ScheduleStateNode::Replace(const tir::StmtSRef& _src_sref, const Stmt& tgt_
     // Step 1.3. Update the sref tree, inserting newly created srefs and properly handle reused
     // srefs in `tgt_stmt`
     SRefUpdater::Update(this, src_sref->parent, reused_srefs, tgt_stmt);
+    // Step 1.4. Mark the subtrees of the ancestor blocks as modified
+    for (const StmtSRefNode* p = src_sref->parent; p != nullptr; p = p->parent) {
+      if (p->stmt->IsInstance<BlockNode>()) {
+        auto it = this->block_info.find(GetRef<StmtSRef>(p));
+        if (it != this->block_info.end()) {
+          it->second.subtree_modified = true;
+        }
+      }
+    }
   }
   // Step 2. Set the ancestors' children properly
   //   Iteratively visit the ancestors, creating new ones whose `body`s are properly fixed.
@@ -0,0 +1,450 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_software_pipeline.cc
+ * \brief Annotate the shared memory and VTCM staging loops for software pipelining, and prefetch
+ *  the data of the next iteration of the loops on CPU.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/bound.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The default shared memory of a thread block, when the target does not tell it. */
+static constexpr int64_t kDefaultMaxSharedMemoryPerBlock = 48 * 1024;
+/*! \brief The max number of stages of a pipeline of synchronous copies, i.e. double buffering. */
+static constexpr int kMaxSyncStages = 2;
+/*! \brief The max number of stages of a pipeline of asynchronous copies. */
+static constexpr int kMaxAsyncStages = 3;
+/*! \brief The VTCM of Hexagon, when the target does not tell it. */
+static constexpr int64_t kDefaultVtcmCapacity = 4 * 1024 * 1024;
+/*! \brief The max number of stages of a pipeline of DMA copies into VTCM, i.e. ping-pong. */
+static constexpr int kMaxDMAStages = 2;
+/*! \brief The size of a cache line on CPU. */
+static constexpr int64_t kCacheLineBytes = 64;
+/*! \brief The max number of cache lines prefetched per iteration of a CPU loop. */
+static constexpr int64_t kMaxPrefetchLines = 64;
+
+/*! \brief The buffers read and written by a statement of a loop body. */
+class StmtAccessCollector : public StmtExprVisitor {
+ public:
+  static StmtAccessCollector Collect(const Stmt& stmt) {
+    StmtAccessCollector collector;
+    collector(stmt);
+    return collector;
+  }
+
+  std::unordered_set<const BufferNode*> reads;
+  std::unordered_set<const BufferNode*> writes;
+  /*! \brief Whether the statement accesses memory through a pointer, not telling the buffer. */
+  bool opaque_access = false;
+  /*! \brief Whether the statement has a pipelined loop of its own. */
+  bool nested_pipeline = false;
+
+ private:
+  void VisitExpr_(const BufferLoadNode* op) final {
+    reads.insert(op->buffer.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    writes.insert(op->buffer.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::tvm_access_ptr()) || op->op.same_as(builtin::address_of()) ||
+        !op->op->IsInstance<OpNode>()) {
+      opaque_access = true;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    if (op->annotations.count(attr::software_pipeline_stage)) {
+      nested_pipeline = true;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+};
+
+/*!
+ * \brief Annotate the loops staging the global memory into the shared memory, or into the VTCM on
+ *  Hexagon, with the stages of the software pipeline, for InjectSoftwarePipeline to rewrite.
+ *
+ *  A loop is pipelined if its body starts with copies from the global memory into staging buffers
+ *  allocated in the body, and continues with the computation reading them, e.g. the reduction
+ *  loop of a tiled matmul. The copies are stage 0 and the computation is the last stage, so that
+ *  the copies of the next iterations overlap the computation of this one. The number of stages is
+ *  the largest allowed by the copies, the shared memory of a thread block or the VTCM, and the
+ *  loop extent. If "tir.use_async_copy" is set, the copies run asynchronously, with cp.async on
+ *  CUDA from sm_80, and with the user DMA engine into ping-pong VTCM buffers on Hexagon, which
+ *  LowerAsyncDMA lowers to the DMA copies and the waits on the DMA queue.
+ *
+ *  The loops already annotated, and the loops having a pipelined loop, are kept as they are.
+ */
+class SoftwarePipelinePlanner : public StmtMutator {
+ public:
+  static Stmt Plan(Stmt body, const Optional<Target>& target, bool use_async_copy) {
+    SoftwarePipelinePlanner planner;
+    if (target.defined() && target.value()->kind->name == "hexagon") {
+      planner.vtcm_ = true;
+      planner.max_staging_bytes_ = kDefaultVtcmCapacity;
+      if (auto capacity = target.value()->GetAttr<Integer>("vtcm-capacity")) {
+        if (capacity.value()->value > 0) {
+          planner.max_staging_bytes_ = capacity.value()->value;
+        }
+      }
+      planner.async_copy_ = use_async_copy;
+    } else if (target.defined()) {
+      if (auto limit = target.value()->GetAttr<Integer>("max_shared_memory_per_block")) {
+        planner.max_staging_bytes_ = limit.value()->value;
+      }
+      if (auto arch = target.value()->GetAttr<String>("arch")) {
+        std::string name = arch.value();
+        planner.async_copy_ = use_async_copy && target.value()->kind->name == "cuda" &&
+                              name.rfind("sm_", 0) == 0 && std::stoi(name.substr(3)) >= 80;
+      }
+    }
+    planner.staging_bytes_ = planner.StagingBytes(body);
+    return planner(std::move(body));
+  }
+
+ private:
+  /*! \brief Whether a buffer is in the memory the copies stage the global memory into. */
+  bool IsStaging(const Buffer& buffer) const {
+    String scope = buffer.scope();
+    if (vtcm_) {
+      return scope == "global.vtcm";
+    }
+    return scope == "shared" || scope == "shared.dyn";
+  }
+
+  /*! \brief The bytes of a buffer of constant shape, or -1. */
+  static int64_t BufferBytes(const Buffer& buffer) {
+    int64_t bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+    for (const PrimExpr& dim : buffer->shape) {
+      const auto* extent = dim.as<IntImmNode>();
+      if (extent == nullptr) {
+        return -1;
+      }
+      bytes *= extent->value;
+    }
+    return bytes;
+  }
+
+  /*! \brief The bytes of all the staging buffers allocated in a statement. */
+  int64_t StagingBytes(const Stmt& stmt) const {
+    int64_t bytes = 0;
+    PostOrderVisit(stmt, [this, &bytes](const ObjectRef& obj) {
+      if (const auto* block = obj.as<BlockNode>()) {
+        for (const Buffer& buffer : block->alloc_buffers) {
+          if (IsStaging(buffer)) {
+            bytes += std::max<int64_t>(BufferBytes(buffer), 0);
+          }
+        }
+      }
+    });
+    return bytes;
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(StmtMutator::VisitStmt_(op));
+    if (loop->kind != ForKind::kSerial || loop->annotations.count(attr::software_pipeline_stage) ||
+        loop->annotations.count(attr::software_pipeline_order)) {
+      return std::move(loop);
+    }
+    const auto* extent = loop->extent.as<IntImmNode>();
+    if (extent == nullptr || extent->value < 2) {
+      return std::move(loop);
+    }
+    // Flatten the body the way InjectSoftwarePipeline does.
+    Stmt body = loop->body;
+    std::unordered_set<const BufferNode*> allocs;
+    if (const auto* realize = body.as<BlockRealizeNode>()) {
+      for (const Buffer& buffer : realize->block->alloc_buffers) {
+        allocs.insert(buffer.get());
+      }
+      body = realize->block->body;
+    }
+    const auto* seq = body.as<SeqStmtNode>();
+    if (seq == nullptr) {
+      return std::move(loop);
+    }
+    std::vector<Stmt> children;
+    for (const Stmt& stmt : seq->seq) {
+      const auto* realize = stmt.as<BlockRealizeNode>();
+      if (realize && is_one(realize->predicate) &&
+          realize->block->body->IsInstance<SeqStmtNode>()) {
+        for (const Buffer& buffer : realize->block->alloc_buffers) {
+          allocs.insert(buffer.get());
+        }
+        for (const Stmt& child : realize->block->body.as<SeqStmtNode>()->seq) {
+          children.push_back(child);
+        }
+      } else {
+        children.push_back(stmt);
+      }
+    }
+    // Step 1. Split the children into the leading copies and the computation.
+    std::vector<StmtAccessCollector> accesses;
+    std::unordered_set<const BufferNode*> written;
+    for (const Stmt& child : children) {
+      accesses.push_back(StmtAccessCollector::Collect(child));
+      if (accesses.back().opaque_access || accesses.back().nested_pipeline) {
+        return std::move(loop);
+      }
+      written.insert(accesses.back().writes.begin(), accesses.back().writes.end());
+    }
+    auto is_copy = [&](const StmtAccessCollector& access) {
+      if (access.writes.empty() || access.reads.empty()) {
+        return false;
+      }
+      for (const BufferNode* buffer : access.writes) {
+        if (!allocs.count(buffer) || !IsStaging(GetRef<Buffer>(buffer))) {
+          return false;
+        }
+      }
+      for (const BufferNode* buffer : access.reads) {
+        if (GetRef<Buffer>(buffer).scope() != "global" || written.count(buffer)) {
+          return false;
+        }
+      }
+      return true;
+    };
+    size_t num_copies = 0;
+    while (num_copies < children.size() && is_copy(accesses[num_copies])) {
+      ++num_copies;
+    }
+    if (num_copies == 0 || num_copies == children.size()) {
+      return std::move(loop);
+    }
+    std::unordered_set<const BufferNode*> staged;
+    int64_t staged_bytes = 0;
+    for (size_t i = 0; i < num_copies; ++i) {
+      for (const BufferNode* buffer : accesses[i].writes) {
+        if (staged.insert(buffer).second) {
+          int64_t bytes = BufferBytes(GetRef<Buffer>(buffer));
+          if (bytes < 0) {
+            return std::move(loop);
+          }
+          staged_bytes += bytes;
+        }
+      }
+    }
+    bool reads_staged = false;
+    for (size_t i = num_copies; i < children.size(); ++i) {
+      for (const BufferNode* buffer : accesses[i].writes) {
+        if (staged.count(buffer)) {
+          return std::move(loop);
+        }
+      }
+      for (const BufferNode* buffer : accesses[i].reads) {
+        reads_staged |= staged.count(buffer) > 0;
+      }
+    }
+    if (!reads_staged) {
+      return std::move(loop);
+    }
+    // Step 2. Pick the number of stages, each of which keeps a version of the staged buffers.
+    int max_stages = kMaxSyncStages;
+    if (async_copy_) {
+      max_stages = vtcm_ ? kMaxDMAStages : kMaxAsyncStages;
+    }
+    int64_t num_stages = std::min<int64_t>(max_stages, extent->value);
+    while (num_stages >= 2 &&
+           staging_bytes_ + (num_stages - 1) * staged_bytes > max_staging_bytes_) {
+      --num_stages;
+    }
+    if (num_stages < 2) {
+      return std::move(loop);
+    }
+    staging_bytes_ += (num_stages - 1) * staged_bytes;
+    // Step 3. Annotate the loop.
+    Array<Integer> stages;
+    Array<Integer> orders;
+    for (size_t i = 0; i < children.size(); ++i) {
+      stages.push_back(Integer(i < num_copies ? 0 : num_stages - 1));
+      orders.push_back(Integer(i));
+    }
+    For::ContainerType* n = loop.CopyOnWrite();
+    n->annotations.Set(attr::software_pipeline_stage, stages);
+    n->annotations.Set(attr::software_pipeline_order, orders);
+    if (async_copy_) {
+      n->annotations.Set(attr::software_pipeline_async_stages, Array<Integer>{Integer(0)});
+    }
+    return std::move(loop);
+  }
+
+  /*! \brief Whether the copies run asynchronously. */
+  bool async_copy_ = false;
+  /*! \brief Whether the copies stage the global memory into the VTCM of Hexagon. */
+  bool vtcm_ = false;
+  /*! \brief The bytes of the staging memory allocated in the function, with the extra versions. */
+  int64_t staging_bytes_ = 0;
+  /*! \brief The shared memory of a thread block, or the VTCM. */
+  int64_t max_staging_bytes_ = kDefaultMaxSharedMemoryPerBlock;
+};
+
+/*!
+ * \brief Prefetch the parts of the global buffers read by the next iteration of the loops on CPU.
+ *
+ *  A serial loop having inner loops prefetches the region of every parameter buffer that its next
+ *  iteration reads, if the region is of constant shape and moves with the loop, and spans at most
+ *  kMaxPrefetchLines cache lines. The last iteration prefetches its own region again.
+ */
+class CPUPrefetchInjector : public StmtMutator {
+ public:
+  static Stmt Inject(const PrimFunc& func) {
+    CPUPrefetchInjector injector;
+    for (const auto& kv : func->buffer_map) {
+      injector.params_.push_back(kv.second);
+    }
+    return injector(func->body);
+  }
+
+ private:
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(StmtMutator::VisitStmt_(op));
+    bool has_inner_loop = false;
+    PostOrderVisit(loop->body, [&has_inner_loop](const ObjectRef& obj) {
+      has_inner_loop |= obj->IsInstance<ForNode>();
+    });
+    if (loop->kind != ForKind::kSerial || !has_inner_loop || !is_const_int(loop->extent)) {
+      return std::move(loop);
+    }
+    PrimExpr next = min(loop->loop_var + 1, loop->min + loop->extent - 1);
+    std::vector<Stmt> prefetches;
+    StmtAccessCollector access = StmtAccessCollector::Collect(loop->body);
+    for (const Buffer& buffer : params_) {
+      if (!access.reads.count(buffer.get())) {
+        continue;
+      }
+      Region region = arith::DomainTouched(loop->body, buffer, true, false);
+      if (region.empty() || region.size() != buffer->shape.size()) {
+        continue;
+      }
+      if (Optional<Stmt> prefetch = Prefetch(buffer, region, loop->loop_var, next)) {
+        prefetches.push_back(prefetch.value());
+      }
+    }
+    if (prefetches.empty()) {
+      return std::move(loop);
+    }
+    prefetches.push_back(loop->body);
+    loop.CopyOnWrite()->body = SeqStmt(prefetches);
+    return std::move(loop);
+  }
+
+  /*! \brief Prefetch the region read at the next iteration, one address per cache line. */
+  Optional<Stmt> Prefetch(const Buffer& buffer, const Region& region, const Var& loop_var,
+                          const PrimExpr& next) {
+    bool moves = false;
+    int64_t num_lines = 1;
+    int64_t elems_per_line = std::max<int64_t>(kCacheLineBytes / buffer->dtype.bytes(), 1);
+    std::vector<int64_t> extents;
+    for (size_t i = 0; i < region.size(); ++i) {
+      if (!region[i].defined()) {
+        return NullOpt;
+      }
+      const auto* extent = analyzer_.Simplify(region[i]->extent).as<IntImmNode>();
+      if (extent == nullptr || UsesVar(region[i]->extent, [&](const VarNode* v) {
+            return v == loop_var.get();
+          })) {
+        return NullOpt;
+      }
+      moves |= UsesVar(region[i]->min, [&](const VarNode* v) { return v == loop_var.get(); });
+      int64_t num = extent->value;
+      if (i + 1 == region.size()) {
+        num = (num + elems_per_line - 1) / elems_per_line;
+      }
+      extents.push_back(num);
+      num_lines *= num;
+    }
+    if (!moves || num_lines > kMaxPrefetchLines) {
+      return NullOpt;
+    }
+    Map<Var, PrimExpr> vmap{{loop_var, next}};
+    std::vector<Var> vars;
+    Array<PrimExpr> indices;
+    for (size_t i = 0; i < region.size(); ++i) {
+      PrimExpr begin = analyzer_.Simplify(Substitute(region[i]->min, vmap));
+      vars.push_back(Var("prefetch." + buffer->name + "." + std::to_string(i), begin.dtype()));
+      if (i + 1 == region.size()) {
+        indices.push_back(begin + vars.back() * make_const(begin.dtype(), elems_per_line));
+      } else {
+        indices.push_back(begin + vars.back());
+      }
+    }
+    PrimExpr load = BufferLoad(buffer, indices);
+    PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {load});
+    Stmt stmt = Evaluate(Call(buffer->dtype, builtin::prefetch(), {address, 0, 3, 1}));
+    for (int i = static_cast<int>(vars.size()) - 1; i >= 0; --i) {
+      stmt = For(vars[i], make_zero(vars[i].dtype()), make_const(vars[i].dtype(), extents[i]),
+                 ForKind::kSerial, stmt);
+    }
+    return stmt;
+  }
+
+  /*! \brief The parameter buffers of the function. */
+  std::vector<Buffer> params_;
+  /*! \brief The analyzer simplifying the regions. */
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass AutoSoftwarePipeline() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined()) {
+      target = Target::Current(true);
+    }
+    bool use_async_copy = ctx->GetConfig<Bool>("tir.use_async_copy", Bool(false)).value();
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePipelinePlanner::Plan(std::move(n->body), target, use_async_copy);
+    if (target.defined() && target.value()->GetTargetDeviceType() == kDLCPU) {
+      n->body = CPUPrefetchInjector::Inject(f);
+    }
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.AutoSoftwarePipeline", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.AutoSoftwarePipeline").set_body_typed(AutoSoftwarePipeline);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
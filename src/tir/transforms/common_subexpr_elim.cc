@@ -120,42 +120,6 @@ bool CommonSubexpressionEliminator::CanContainEligibleComputations(const PrimExp
   return true;
 }
 
-/*!
- * \brief Implements an order on pairs (expression,frequency). First attempts to compare them
-          using the size of the expression. If it is the same, decides something else still
-          deterministic.
- * \param a The first pair
- * \param b The second pair
- * \return A boolean telling if the first pair `a` comes before the second pair `b`
- * \note We need this order to be deterministic in order to have a fully deterministic pass,
- *       as we will deal with elements that are coming from a hashtable, but the order in which
- *       they appeared in the hashtable was based on some runtime addresses, so it can potentially
- *       change with every execution.
- */
-bool CommonSubexpressionEliminator::OrderOnExprAndFrequency(std::pair<PrimExpr, size_t> a,
-                                                            std::pair<PrimExpr, size_t> b) {
-  size_t a_size = CalculateExprComplexity(a.first);
-  size_t b_size = CalculateExprComplexity(b.first);
-
-  // Criteria 1 - Size of the expression comes first
-  // `a` comes before `b` if the size of `a` is bigger
-  if (a_size > b_size) {
-    return true;
-  }
-  // `a` does NOT come before `b` if the size of `b` is bigger
-  if (b_size > a_size) {
-    return false;
-  }
-
-  // Criteria 2 - If they had the same size, use the lexicographic order as a last resort
-  // as we need a deterministic order
-  std::stringstream a_stream;
-  std::stringstream b_stream;
-  a_stream << a.first;
-  b_stream << b.first;
-  return (a_stream.str().compare(b_stream.str()) < 0);
-}
-
 /*!
  * \brief Generates a new fresh variable, whose name will be cse_var_i.
  * \param type_annotation The type of the new variable to generate
@@ -236,43 +200,42 @@ PrimExpr CommonSubexpressionEliminator::VisitExpr(const PrimExpr& expr) {
   ComputationTable table_syntactic_comp_done_by_expr = ComputationsDoneBy::GetComputationsDoneBy(
       expr, IsEligibleComputation, CanContainEligibleComputations);
 
-  // Transform the hashtable of *syntactic* eligible computations into a vector of pairs
-  // containing *semantic* entities, i.e. where equivalent computations are merged.
-  std::vector<std::pair<PrimExpr, size_t>> semantic_comp_done_by_expr =
-      SyntacticToSemanticComputations(table_syntactic_comp_done_by_expr, identify_equiv_terms_);
-
-  // Sort the vector of semantic entities by decreasing size
-  std::sort(semantic_comp_done_by_expr.begin(), semantic_comp_done_by_expr.end(),
-            OrderOnExprAndFrequency);
+  // Transform the hashtable of *syntactic* eligible computations into a table of *semantic*
+  // entities, i.e. where equivalent computations are merged, sorted by decreasing size.
+  SemanticComputationTable semantic_comp_done_by_expr(table_syntactic_comp_done_by_expr,
+                                                      identify_equiv_terms_);
 
   // For each computation done (considering them from biggest to smallest)
   for (size_t i = 0; i < semantic_comp_done_by_expr.size(); i++) {
-    std::pair<PrimExpr, size_t>& computation_and_nb = semantic_comp_done_by_expr[i];
+    PrimExpr computation = semantic_comp_done_by_expr.GetComputation(i);
+    // The normal form of the computation, computed once for all the comparisons below
+    PrimExpr normal_form = semantic_comp_done_by_expr.GetNormalForm(i);
+    size_t nb_times_seen = semantic_comp_done_by_expr.GetNbTimesSeen(i);
 
     bool ident_equiv_terms = identify_equiv_terms_;  // To avoid the capture of "this"
 
     // The predicate later used (when doing replacements) to select expressions that are
-    // equivalent to the current computation (`computation_and_nb.first`)
+    // equivalent to the current computation (`computation`)
     std::function<bool(const PrimExpr&)> predicate_selector =
-        [computation_and_nb, ident_equiv_terms](const PrimExpr& current_expr) {
-          // `current_expr` should be equivalent to `computation_and_nb.first`, but we also check
+        [normal_form, ident_equiv_terms](const PrimExpr& current_expr) {
+          // `current_expr` should be equivalent to `computation`, but we also check
           // that `current_expr` is an eligible computation even if we know that
-          // `computation_and_nb.first` is eligible by construction, in case that one day the
+          // `computation` is eligible by construction, in case that one day the
           // equivalence relation would not preserve the eligibility any more (even though that
           // would probably be a very weird equivalence).
-          return (EquivalentTerms(current_expr, computation_and_nb.first, ident_equiv_terms) &&
+          return (EqualTerms(NormalizeTerm(current_expr, ident_equiv_terms), normal_form) &&
                   IsEligibleComputation(current_expr));
         };
 
     // See if there is a pair (`var`, `value`) in the context where `value` is semantically
-    // equivalent to `computation_and_nb.first`
+    // equivalent to `computation`
     auto it_on_var = std::find_if(
         context_.begin(), context_.end(),
-        [computation_and_nb, ident_equiv_terms](const std::pair<Var, MaybeValue>& var_and_value) {
+        [normal_form, ident_equiv_terms](const std::pair<Var, MaybeValue>& var_and_value) {
           // Note : safe to call value() as we check has_value() just before
           return (var_and_value.second.has_value() &&
-                  EquivalentTerms(var_and_value.second.value(), computation_and_nb.first,
-                                  ident_equiv_terms));
+                  EqualTerms(NormalizeTerm(var_and_value.second.value(), ident_equiv_terms),
+                             normal_form));
         });
 
     // Case where we have a perfectly equivalent computation already available in a variable
@@ -292,7 +255,7 @@ PrimExpr CommonSubexpressionEliminator::VisitExpr(const PrimExpr& expr) {
 
       // --- Chunk needed for reusing the UndefinedVars() analysis ---
       // 1 - Wraps the computation into a statement
-      Stmt computation_wrapped_in_stmt = Evaluate(computation_and_nb.first);
+      Stmt computation_wrapped_in_stmt = Evaluate(computation);
       // 2.1 - Transform the context into a vector of variables instead of pairs
       std::function<Var(const std::pair<Var, MaybeValue>&)> forget_value =
           [](const std::pair<Var, MaybeValue>& pair) { return pair.first; };
@@ -307,16 +270,16 @@ PrimExpr CommonSubexpressionEliminator::VisitExpr(const PrimExpr& expr) {
       // Check if we can introduce it : if it contains no undefined variables and if we want
       // to introduce it according to the predicate
       if (vars_undefined.empty() &&
-          PredicateIntroVarForComputation(computation_and_nb.first, computation_and_nb.second)) {
+          PredicateIntroVarForComputation(computation, nb_times_seen)) {
         // Create a new variable for this computation
-        Var new_var = GenerateNewVar(computation_and_nb.first.dtype());
+        Var new_var = GenerateNewVar(computation.dtype());
         // Replace in the current `result` everything that is selected by the selector with
         // the new variable, without diving into expressions in which we don't have the
         // right to dive.
         result = ReplaceSelectedExpr::ReplaceSelectedExprInExpr(result, predicate_selector, new_var,
                                                                 CanContainEligibleComputations);
         // Build a let-in that introduces the new variable in the current `result`
-        result = Let(new_var, computation_and_nb.first, result);
+        result = Let(new_var, computation, result);
         // We don't add the variable to the context because the invariant is that the
         // context is the context in which 'result' makes sense, and we've just updated it.
       } else {
@@ -334,12 +297,11 @@ PrimExpr CommonSubexpressionEliminator::VisitExpr(const PrimExpr& expr) {
         // Computing the direct subexpressions will return a small number of direct
         // subexpressions (typically 0 to 3)
         std::vector<PrimExpr> direct_subexprs = DirectSubexpr::GetDirectSubexpressions(
-            computation_and_nb.first, IsEligibleComputation, CanContainEligibleComputations);
+            computation, IsEligibleComputation, CanContainEligibleComputations);
         // The following insertion will maintain `semantic_comp_done_by_expr` sorted (by
         // decreasing size/complexity), and it will only insert at locations > i as the
         // direct subexprs are necessarily smaller than the current computation.
-        InsertVectorToSortedSemanticComputations(&semantic_comp_done_by_expr, direct_subexprs,
-                                                 identify_equiv_terms_);
+        semantic_comp_done_by_expr.Insert(direct_subexprs);
       }
     }
     // Note : we do not remove the current element, as we never look back in the local vector
@@ -416,43 +378,42 @@ Stmt CommonSubexpressionEliminator::VisitStmt(const Stmt& stmt) {
   ComputationTable table_syntactic_comp_done_by_stmt = ComputationsDoneBy::GetComputationsDoneBy(
       stmt, IsEligibleComputation, CanContainEligibleComputations);
 
-  // Transform the hashtable of *syntactic* eligible computations into a vector of pairs
-  // containing *semantic* entities, i.e. where equivalent computations are merged.
-  std::vector<std::pair<PrimExpr, size_t>> semantic_comp_done_by_stmt =
-      SyntacticToSemanticComputations(table_syntactic_comp_done_by_stmt, identify_equiv_terms_);
-
-  // Sort the vector of semantic entities by decreasing size
-  std::sort(semantic_comp_done_by_stmt.begin(), semantic_comp_done_by_stmt.end(),
-            OrderOnExprAndFrequency);
+  // Transform the hashtable of *syntactic* eligible computations into a table of *semantic*
+  // entities, i.e. where equivalent computations are merged, sorted by decreasing size.
+  SemanticComputationTable semantic_comp_done_by_stmt(table_syntactic_comp_done_by_stmt,
+                                                      identify_equiv_terms_);
 
   // For each computation done (considering them from biggest to smallest)
   for (size_t i = 0; i < semantic_comp_done_by_stmt.size(); i++) {
-    std::pair<PrimExpr, size_t>& computation_and_nb = semantic_comp_done_by_stmt[i];
+    PrimExpr computation = semantic_comp_done_by_stmt.GetComputation(i);
+    // The normal form of the computation, computed once for all the comparisons below
+    PrimExpr normal_form = semantic_comp_done_by_stmt.GetNormalForm(i);
+    size_t nb_times_seen = semantic_comp_done_by_stmt.GetNbTimesSeen(i);
 
     bool ident_equiv_terms = identify_equiv_terms_;  // To avoid the capture of "this"
 
     // The predicate later used (when doing replacements) to select expressions that are
-    // equivalent to the current computation (`computation_and_nb.first`)
+    // equivalent to the current computation (`computation`)
     std::function<bool(const PrimExpr&)> predicate_selector =
-        [computation_and_nb, ident_equiv_terms](const PrimExpr& current_expr) {
-          // `current_expr` should be equivalent to `computation_and_nb.first`, but we also check
+        [normal_form, ident_equiv_terms](const PrimExpr& current_expr) {
+          // `current_expr` should be equivalent to `computation`, but we also check
           // that `current_expr` is an eligible computation even if we know that
-          // `computation_and_nb.first` is eligible by construction, in case that one day the
+          // `computation` is eligible by construction, in case that one day the
           // equivalence relation would not preserve the eligibility any more (even though that
           // would probably be a very weird equivalence).
-          return (EquivalentTerms(current_expr, computation_and_nb.first, ident_equiv_terms) &&
+          return (EqualTerms(NormalizeTerm(current_expr, ident_equiv_terms), normal_form) &&
                   IsEligibleComputation(current_expr));
         };
 
     // See if there is a pair (`var`, `value`) in the context where `value` is semantically
-    // equivalent to `computation_and_nb.first`
+    // equivalent to `computation`
     auto it_on_var = std::find_if(
         context_.begin(), context_.end(),
-        [computation_and_nb, ident_equiv_terms](const std::pair<Var, MaybeValue>& var_and_value) {
+        [normal_form, ident_equiv_terms](const std::pair<Var, MaybeValue>& var_and_value) {
           // Note : safe to call value() as we check has_value() just before
           return (var_and_value.second.has_value() &&
-                  EquivalentTerms(var_and_value.second.value(), computation_and_nb.first,
-                                  ident_equiv_terms));
+                  EqualTerms(NormalizeTerm(var_and_value.second.value(), ident_equiv_terms),
+                             normal_form));
         });
 
     // Case where we have a perfectly equivalent computation already available in a variable
@@ -472,7 +433,7 @@ Stmt CommonSubexpressionEliminator::VisitStmt(const Stmt& stmt) {
 
       // --- Chunk needed for reusing the UndefinedVars() analysis ---
       // 1 - Wraps the computation into a statement
-      Stmt computation_wrapped_in_stmt = Evaluate(computation_and_nb.first);
+      Stmt computation_wrapped_in_stmt = Evaluate(computation);
       // 2.1 - Transform the context into a vector of variables instead of pairs
       std::function<Var(const std::pair<Var, MaybeValue>&)> forget_value =
           [](const std::pair<Var, MaybeValue>& pair) { return pair.first; };
@@ -487,9 +448,9 @@ Stmt CommonSubexpressionEliminator::VisitStmt(const Stmt& stmt) {
       // Check if we can introduce it : if it contains no undefined variables and if we want
       // to introduce it according to the predicate
       if (vars_undefined.empty() &&
-          PredicateIntroVarForComputation(computation_and_nb.first, computation_and_nb.second)) {
+          PredicateIntroVarForComputation(computation, nb_times_seen)) {
         // Create a new variable for this computation
-        Var new_var = GenerateNewVar(computation_and_nb.first.dtype());
+        Var new_var = GenerateNewVar(computation.dtype());
         variables_created = true;
         // Replace in the current `result` everything that is selected by the selector with
         // the new variable, without diving into expressions in which we don't have the
@@ -497,7 +458,7 @@ Stmt CommonSubexpressionEliminator::VisitStmt(const Stmt& stmt) {
         result = ReplaceSelectedExpr::ReplaceSelectedExprInStmt(result, predicate_selector, new_var,
                                                                 CanContainEligibleComputations);
         // Build a let-in that introduces the new variable in the current `result`
-        result = LetStmt(new_var, computation_and_nb.first, result);
+        result = LetStmt(new_var, computation, result);
         // We don't add the variable to the context because the invariant is that the
         // context is the context in which 'result' makes sense, and we've just updated it.
       } else {
@@ -515,12 +476,11 @@ Stmt CommonSubexpressionEliminator::VisitStmt(const Stmt& stmt) {
         // Computing the direct subexpressions will return a small number of direct
         // subexpressions (typically 0 to 3)
         std::vector<PrimExpr> direct_subexprs = DirectSubexpr::GetDirectSubexpressions(
-            computation_and_nb.first, IsEligibleComputation, CanContainEligibleComputations);
+            computation, IsEligibleComputation, CanContainEligibleComputations);
         // The following insertion will maintain `semantic_comp_done_by_stmt` sorted (by
         // decreasing size/complexity), and it will only insert at locations > i as the
         // direct subexprs are necessarily smaller than the current computation.
-        InsertVectorToSortedSemanticComputations(&semantic_comp_done_by_stmt, direct_subexprs,
-                                                 identify_equiv_terms_);
+        semantic_comp_done_by_stmt.Insert(direct_subexprs);
       }
     }
     // Note : we do not remove the current element, as we never look back in the local vector
@@ -37,6 +37,8 @@
 #include <tvm/tir/transform.h>  // For the declaration of the pass
 
 #include <algorithm>      // For std::find_if
+#include <sstream>        // For the string representation of the expressions
+#include <string>
 #include <unordered_map>  // For the hashtable datatype
 #include <utility>
 #include <vector>
@@ -874,55 +876,66 @@ bool PredicateIntroVarForComputation(const PrimExpr& computation, size_t nb_time
 }
 
 /*!
- * \brief Inserts a pair (expr,nb) to a sorted vector of such pairs (which is sorted by decreasing
-          size of expressions) and maintain the vector sorted while doing so.
- */
-void InsertElemToSortedSemanticComputations(std::vector<std::pair<PrimExpr, size_t>>* sorted_vec,
-                                            const std::pair<PrimExpr, size_t>& pair) {
-  if (sorted_vec == nullptr) {
-    return;
+ * \brief Builds the table of semantic computations from a hashtable of syntactic computations,
+          with a single computation of the size and of the string representation of each of them.
+ * \param table The table of syntactic computations
+ * \param identify_equiv_terms Whether the equivalent computations are merged
+ */
+SemanticComputationTable::SemanticComputationTable(const ComputationTable& table,
+                                                   bool identify_equiv_terms)
+    : identify_equiv_terms_(identify_equiv_terms) {
+  std::vector<std::pair<PrimExpr, size_t>> semantic_comps =
+      SyntacticToSemanticComputations(table, identify_equiv_terms);
+  // The sort keys, the size of the expression first, and then their string representation as a
+  // last resort as we need a deterministic order
+  std::vector<std::pair<size_t, std::string>> keys;
+  keys.reserve(semantic_comps.size());
+  for (const auto& elem : semantic_comps) {
+    std::stringstream stream;
+    stream << elem.first;
+    keys.emplace_back(CalculateExprComplexity(elem.first), stream.str());
+  }
+  std::vector<size_t> order(semantic_comps.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) {
+    if (keys[a].first != keys[b].first) {
+      return keys[a].first > keys[b].first;
+    }
+    return keys[a].second.compare(keys[b].second) < 0;
+  });
+
+  entries_.reserve(order.size());
+  nb_times_seen_.reserve(order.size());
+  for (size_t i : order) {
+    const PrimExpr& computation = semantic_comps[i].first;
+    // The representants of the classes are distinct modulo the equivalence, and so are their
+    // normal forms
+    PrimExpr normal_form = NormalizeTerm(computation, identify_equiv_terms);
+    entries_.push_back({computation, normal_form, keys[i].first});
+    nb_times_seen_[normal_form] = semantic_comps[i].second;
   }
-  // Find the insertion point using std::lower_bound on a comparison that uses
-  // CalculateExprComplexity(), which computes the "size" of an expr.
-  // std::lower_boud returns an iterator pointing to the first element on which the comparison
-  // does not return true with the given value (`pair` here), i.e, an iterator pointing to the
-  // first element that is not greater or equal than `pair`, i.e, the first element that is
-  // strictly smaller than `pair`.
-  auto insertion_point = std::lower_bound(
-      sorted_vec->begin(), sorted_vec->end(), pair,
-      [](const std::pair<PrimExpr, size_t>& left, const std::pair<PrimExpr, size_t>& right) {
-        return (CalculateExprComplexity(left.first) >= CalculateExprComplexity(right.first));
-      });
-  sorted_vec->insert(insertion_point, pair);
 }
 
-/*!
- * \brief Inserts a vector of expressions into a sorted vector of computations (which is sorted by
-          decreasing size of the expression) and maintain the vector sorted while doing so.
- */
-void InsertVectorToSortedSemanticComputations(std::vector<std::pair<PrimExpr, size_t>>* sorted_vec,
-                                              const std::vector<PrimExpr>& vec_to_add,
-                                              bool identify_equiv_terms) {
-  if (sorted_vec == nullptr) {
-    return;
-  }
-  for (auto elem_to_add : vec_to_add) {
-    // See if the current element to add (or an equivalent one) is already present
-    // in the sorted vector
-    auto it_found =
-        std::find_if(sorted_vec->begin(), sorted_vec->end(),
-                     [elem_to_add, identify_equiv_terms](std::pair<PrimExpr, size_t> elem) {
-                       return EquivalentTerms(elem.first, elem_to_add, identify_equiv_terms);
-                     });
-
-    // If we found `elem_to_add` (or an equivalent expression) already in sorted_vec
-    if (it_found != sorted_vec->end()) {
-      // then we just increase its associated count
+void SemanticComputationTable::Insert(const std::vector<PrimExpr>& computations) {
+  for (const PrimExpr& computation : computations) {
+    PrimExpr normal_form = NormalizeTerm(computation, identify_equiv_terms_);
+    // If the computation (or an equivalent one) is already in the table, we just increase the
+    // count of its equivalence class
+    auto it_found = nb_times_seen_.find(normal_form);
+    if (it_found != nb_times_seen_.end()) {
       it_found->second++;
-    } else {
-      // Otherwise we add the pair (`elem_to_add`,1) at the right place
-      InsertElemToSortedSemanticComputations(sorted_vec, {elem_to_add, 1});
+      continue;
     }
+    nb_times_seen_[normal_form] = 1;
+    // Otherwise it is inserted after all the computations that are at least as big
+    size_t complexity = CalculateExprComplexity(computation);
+    auto insertion_point =
+        std::partition_point(entries_.begin(), entries_.end(), [complexity](const Entry& entry) {
+          return entry.complexity >= complexity;
+        });
+    entries_.insert(insertion_point, {computation, normal_form, complexity});
   }
 }
 
@@ -208,11 +208,42 @@ std::vector<B> VectorMap(const std::vector<A>& input, std::function<B(const A&)>
 template std::vector<Var> VectorMap(const std::vector<std::pair<Var, MaybeValue>>&,
                                     std::function<Var(const std::pair<Var, MaybeValue>&)>);
 
-void InsertElemToSortedSemanticComputations(std::vector<std::pair<PrimExpr, size_t>>* sorted_vec,
-                                            const std::pair<PrimExpr, size_t>& pair);
-void InsertVectorToSortedSemanticComputations(std::vector<std::pair<PrimExpr, size_t>>* sorted_vec,
-                                              const std::vector<PrimExpr>& vec_to_add,
-                                              bool identify_equiv_terms);
+/*!
+ * \brief A table of semantic computations, sorted by decreasing size (and then by their string
+          representation, for determinism). The number of times each equivalence class is seen is
+          kept in a hashtable keyed by the normal form of the class, so that counting a computation
+          seen again is a constant time lookup instead of a scan of the table with a normalization
+          of each of its entries.
+ */
+class SemanticComputationTable {
+ public:
+  SemanticComputationTable(const ComputationTable& table, bool identify_equiv_terms);
+
+  /*! \brief The number of computations in the table */
+  size_t size() const { return entries_.size(); }
+  /*! \brief The i-th biggest computation, the representant of its equivalence class */
+  const PrimExpr& GetComputation(size_t i) const { return entries_[i].computation; }
+  /*! \brief The normal form of the i-th biggest computation */
+  const PrimExpr& GetNormalForm(size_t i) const { return entries_[i].normal_form; }
+  /*! \brief The number of times the i-th biggest computation (or an equivalent one) is seen */
+  size_t GetNbTimesSeen(size_t i) const { return nb_times_seen_.at(entries_[i].normal_form); }
+  /*!
+   * \brief Count the given computations, inserting the ones not equivalent to any computation of
+            the table at their place in the order.
+   */
+  void Insert(const std::vector<PrimExpr>& computations);
+
+ private:
+  struct Entry {
+    PrimExpr computation;
+    PrimExpr normal_form;
+    size_t complexity;
+  };
+  std::vector<Entry> entries_;
+  // The number of times each equivalence class is seen, keyed by its normal form
+  ComputationTable nb_times_seen_;
+  bool identify_equiv_terms_;
+};
 
 }  // namespace tir
 }  // namespace tvm
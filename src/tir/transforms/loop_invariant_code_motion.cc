@@ -0,0 +1,361 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file loop_invariant_code_motion.cc
+ * \brief Hoist the loop-invariant index arithmetic out of the loops.
+ *
+ * The index and address computations of a loop body that do not depend on the loop are bound to
+ * variables before the loop, innermost loops first. Only pure integer arithmetic that cannot trap
+ * is hoisted, together with the let bindings of such values. Inside GPU kernels, the number of the
+ * values hoisted and live at once along a loop nest is bounded by a register budget, the biggest
+ * computations of the innermost loops being hoisted first.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../runtime/thread_storage_scope.h"
+
+namespace tvm {
+namespace tir {
+
+struct LoopInvariantCodeMotionConfigNode
+    : public tvm::AttrsNode<LoopInvariantCodeMotionConfigNode> {
+  int register_budget;
+
+  TVM_DECLARE_ATTRS(LoopInvariantCodeMotionConfigNode,
+                    "tir.transform.LoopInvariantCodeMotionConfig") {
+    TVM_ATTR_FIELD(register_budget)
+        .describe(
+            "The maximum number of the values hoisted and live at once along a loop nest of a GPU "
+            "kernel, or -1 for no limit")
+        .set_default(8);
+  }
+};
+
+class LoopInvariantCodeMotionConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(LoopInvariantCodeMotionConfig, Attrs,
+                                            LoopInvariantCodeMotionConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(LoopInvariantCodeMotionConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.LoopInvariantCodeMotion", LoopInvariantCodeMotionConfig);
+
+/*! \brief Collect the variables defined in a statement. */
+class DefinedVarCollector : public StmtExprVisitor {
+ public:
+  static std::unordered_set<const VarNode*> Collect(const Stmt& stmt) {
+    DefinedVarCollector collector;
+    collector(stmt);
+    return std::move(collector.defined_);
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    defined_.insert(op->loop_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const LetStmtNode* op) final {
+    defined_.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const AllocateNode* op) final {
+    defined_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const AllocateConstNode* op) final {
+    defined_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (const auto* iv = op->node.as<IterVarNode>()) {
+      defined_.insert(iv->var.get());
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitExpr_(const LetNode* op) final {
+    defined_.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  std::unordered_set<const VarNode*> defined_;
+};
+
+/*!
+ * \brief Find the loop-invariant computations of a loop body, the maximal pure integer
+ *  expressions that use no variable defined in the loop, and the let bindings of such values.
+ */
+class InvariantCollector : public StmtExprVisitor {
+ public:
+  InvariantCollector(const ForNode* loop, std::unordered_set<const VarNode*> variant_vars)
+      : variant_vars_(std::move(variant_vars)) {
+    variant_vars_.insert(loop->loop_var.get());
+  }
+
+  /*! \brief The hoisted let bindings, in the order of their definitions. */
+  std::vector<const LetStmtNode*> hoisted_lets;
+  /*! \brief The invariant computations, in the order of their first occurrences. */
+  std::vector<PrimExpr> computations;
+  /*! \brief The number of occurrences of each invariant computation. */
+  std::unordered_map<PrimExpr, int, StructuralHash, ExprDeepEqual> occurrences;
+
+  /*! \brief Whether an expression is a hoistable invariant integer computation. */
+  bool IsInvariant(const PrimExpr& expr) {
+    auto it = memo_.find(expr.get());
+    if (it != memo_.end()) {
+      return it->second;
+    }
+    bool invariant = CheckInvariant(expr);
+    memo_[expr.get()] = invariant;
+    return invariant;
+  }
+
+ private:
+  bool CheckInvariant(const PrimExpr& expr) {
+    DataType dtype = expr.dtype();
+    if (!(dtype.is_int() || dtype.is_uint()) || dtype.lanes() != 1) {
+      return false;
+    }
+    if (expr->IsInstance<IntImmNode>()) {
+      return true;
+    }
+    if (const auto* var = expr.as<VarNode>()) {
+      return !variant_vars_.count(var);
+    }
+    if (const auto* op = expr.as<CastNode>()) {
+      return IsInvariant(op->value);
+    }
+#define TVM_LICM_BINARY_OP(Node)                        \
+  if (const auto* op = expr.as<Node>()) {               \
+    return IsInvariant(op->a) && IsInvariant(op->b);    \
+  }
+    TVM_LICM_BINARY_OP(AddNode)
+    TVM_LICM_BINARY_OP(SubNode)
+    TVM_LICM_BINARY_OP(MulNode)
+    TVM_LICM_BINARY_OP(MinNode)
+    TVM_LICM_BINARY_OP(MaxNode)
+#undef TVM_LICM_BINARY_OP
+    // The divisions hoisted out of the conditions guarding them must not trap.
+#define TVM_LICM_DIVISION_OP(Node)                                            \
+  if (const auto* op = expr.as<Node>()) {                                     \
+    const auto* divisor = op->b.as<IntImmNode>();                             \
+    return divisor != nullptr && divisor->value > 0 && IsInvariant(op->a);    \
+  }
+    TVM_LICM_DIVISION_OP(DivNode)
+    TVM_LICM_DIVISION_OP(ModNode)
+    TVM_LICM_DIVISION_OP(FloorDivNode)
+    TVM_LICM_DIVISION_OP(FloorModNode)
+#undef TVM_LICM_DIVISION_OP
+    return false;
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    // The binding moves out of the loop with its value.
+    if (IsInvariant(op->value)) {
+      hoisted_lets.push_back(op);
+      variant_vars_.erase(op->var.get());
+      memo_.clear();
+    } else {
+      this->VisitExpr(op->value);
+    }
+    this->VisitStmt(op->body);
+  }
+
+  void VisitExpr(const PrimExpr& expr) final {
+    if (!expr->IsInstance<VarNode>() && !expr->IsInstance<IntImmNode>() && IsInvariant(expr) &&
+        SideEffect(expr) <= CallEffectKind::kPure) {
+      if (occurrences[expr]++ == 0) {
+        computations.push_back(expr);
+      }
+      return;
+    }
+    StmtExprVisitor::VisitExpr(expr);
+  }
+
+  /*! \brief The variables defined in the loop, whose values may change across its iterations. */
+  std::unordered_set<const VarNode*> variant_vars_;
+  /*! \brief Whether each visited expression is invariant. */
+  std::unordered_map<const Object*, bool> memo_;
+};
+
+/*! \brief Replace the hoisted computations and let bindings of a loop body by their variables. */
+class InvariantReplacer : public StmtExprMutator {
+ public:
+  InvariantReplacer(const std::unordered_map<PrimExpr, Var, StructuralHash, ExprDeepEqual>& vars,
+                    const std::unordered_set<const LetStmtNode*>& hoisted_lets)
+      : vars_(vars), hoisted_lets_(hoisted_lets) {}
+
+ private:
+  PrimExpr VisitExpr(const PrimExpr& expr) final {
+    auto it = vars_.find(expr);
+    if (it != vars_.end()) {
+      return it->second;
+    }
+    return StmtExprMutator::VisitExpr(expr);
+  }
+
+  Stmt VisitStmt_(const LetStmtNode* op) final {
+    if (hoisted_lets_.count(op)) {
+      return this->VisitStmt(op->body);
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  const std::unordered_map<PrimExpr, Var, StructuralHash, ExprDeepEqual>& vars_;
+  const std::unordered_set<const LetStmtNode*>& hoisted_lets_;
+};
+
+class LoopInvariantHoister : public StmtExprMutator {
+ public:
+  static Stmt Hoist(Stmt stmt, const LoopInvariantCodeMotionConfig& config) {
+    LoopInvariantHoister hoister(config);
+    return hoister(std::move(stmt));
+  }
+
+ private:
+  explicit LoopInvariantHoister(const LoopInvariantCodeMotionConfig& config)
+      : register_budget_(config->register_budget) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent && !in_gpu_kernel_) {
+      in_gpu_kernel_ = true;
+      Stmt stmt = StmtExprMutator::VisitStmt_(op);
+      in_gpu_kernel_ = false;
+      return stmt;
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    // The inner loops first, which run the most often and so get the registers first.
+    int outer_live = live_;
+    live_ = 0;
+    For loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    int inner_live = live_;
+
+    int budget = -1;
+    if (in_gpu_kernel_ && register_budget_ >= 0) {
+      budget = std::max(register_budget_ - inner_live, 0);
+    }
+    const auto* extent = loop->extent.as<IntImmNode>();
+    Stmt result = loop;
+    int num_hoisted = 0;
+    if (extent == nullptr || extent->value > 1) {
+      result = HoistOutOf(loop, budget, &num_hoisted);
+    }
+    live_ = std::max(outer_live, inner_live + num_hoisted);
+    return result;
+  }
+
+  /*!
+   * \brief Hoist the invariant computations of a loop out of it.
+   * \param loop The loop.
+   * \param budget The maximum number of the computations to hoist, or -1 for no limit.
+   * \param num_hoisted The number of the computations hoisted.
+   * \return The loop, preceded by the bindings of the hoisted values.
+   */
+  Stmt HoistOutOf(const For& loop, int budget, int* num_hoisted) {
+    InvariantCollector collector(loop.get(), DefinedVarCollector::Collect(loop->body));
+    collector(loop->body);
+    if (collector.computations.empty() && collector.hoisted_lets.empty()) {
+      return loop;
+    }
+    // The biggest and most repeated computations save the most per iteration.
+    std::vector<std::pair<size_t, size_t>> order;
+    for (size_t i = 0; i < collector.computations.size(); ++i) {
+      const PrimExpr& computation = collector.computations[i];
+      order.emplace_back(
+          CalculateExprComplexity(computation) * collector.occurrences.at(computation), i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    if (budget >= 0 && static_cast<int>(order.size()) > budget) {
+      order.resize(budget);
+    }
+    std::sort(order.begin(), order.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    std::unordered_map<PrimExpr, Var, StructuralHash, ExprDeepEqual> vars;
+    std::vector<std::pair<Var, PrimExpr>> bindings;
+    for (const auto& [saving, index] : order) {
+      const PrimExpr& computation = collector.computations[index];
+      Var var("licm_var_" + std::to_string(++num_vars_), computation.dtype());
+      vars[computation] = var;
+      bindings.emplace_back(var, computation);
+    }
+    std::unordered_set<const LetStmtNode*> hoisted_lets(collector.hoisted_lets.begin(),
+                                                        collector.hoisted_lets.end());
+    Stmt body = InvariantReplacer(vars, hoisted_lets)(loop->body);
+    Stmt result = For(loop->loop_var, loop->min, loop->extent, loop->kind, body,
+                      loop->thread_binding, loop->annotations, loop->span);
+    // The hoisted computations may use the variables of the hoisted let bindings.
+    for (auto it = bindings.rbegin(); it != bindings.rend(); ++it) {
+      result = LetStmt(it->first, it->second, result);
+    }
+    for (auto it = collector.hoisted_lets.rbegin(); it != collector.hoisted_lets.rend(); ++it) {
+      result = LetStmt((*it)->var, (*it)->value, result);
+    }
+    *num_hoisted = bindings.size();
+    return result;
+  }
+
+  /*! \brief The register budget of the GPU kernels. */
+  int register_budget_;
+  /*! \brief Whether the statement visited is in a GPU kernel. */
+  bool in_gpu_kernel_{false};
+  /*! \brief The maximum number of the values hoisted and live at once in the visited loops. */
+  int live_{0};
+  /*! \brief The number of the variables introduced. */
+  int num_vars_{0};
+};
+
+namespace transform {
+
+Pass LoopInvariantCodeMotion() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<LoopInvariantCodeMotionConfig>("tir.LoopInvariantCodeMotion");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<LoopInvariantCodeMotionConfig>();
+    }
+    auto* n = f.CopyOnWrite();
+    n->body = LoopInvariantHoister::Hoist(std::move(n->body), cfg.value());
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.LoopInvariantCodeMotion", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.LoopInvariantCodeMotion")
+    .set_body_typed(LoopInvariantCodeMotion);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
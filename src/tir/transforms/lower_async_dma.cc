@@ -158,6 +158,19 @@ class AsyncDMALowerer : public StmtExprMutator {
         return analyzer.Simplify(Substitute(std::move(expr), loop_var_remap));
       });
 
+      // 5) the copy is contiguous, the DMA engine copying the whole range from the base addresses
+      arith::Analyzer analyzer;
+      auto is_contiguous = [&](const PrimExpr& index, const PrimExpr& base) {
+        return analyzer.CanProveEqual(index - base, for_loop->loop_var);
+      };
+      if (!is_zero(for_loop->min) ||
+          !is_contiguous(bufferstorenode->indices[0], store_index[0]) ||
+          !is_contiguous(bufferloadnode->indices[0], load_index[0])) {
+        DLOG(INFO) << "AsyncDMALowerer exiting because the `ForNode` does not copy a contiguous "
+                      "range of elements";
+        return StmtExprMutator::VisitStmt_(op);
+      }
+
       // now that we are about to perform the `copy` transform
       // save queue ID for inspection in `wait` transform
       queue_ids_.insert(queue_id);
@@ -45,6 +45,20 @@ bool IsBoundToThreadIdx(const ForNode* loop) {
   return scope.rank == 1 && scope.dim_index >= 0;
 }
 
+/*!
+ * \brief Checks if a loop is bound to blockIdx.x/y/z
+ * \brief loop The loop to be checked
+ * \return True if the loop is bound to blockIdx.x/y/z
+ */
+bool IsBoundToBlockIdx(const ForNode* loop) {
+  if (!loop->thread_binding.defined()) {
+    return false;
+  }
+  runtime::ThreadScope scope =
+      runtime::ThreadScope::Create(loop->thread_binding.value()->thread_tag);
+  return scope.rank == 0;
+}
+
 /*!
  * \brief Check the dominant property of a block:
  * the block is the only writer of its output, dominating the reader of its output buffers
@@ -511,14 +525,15 @@ class CrossThreadReductionTransformer : public StmtMutator {
            "the deepest statements, which violates the condition.";
 
     // Condition 2. All the reduction-related loops that are bound to thread axes should only be
-    // bound to `threadIdx.x/y/z`.
+    // bound to `threadIdx.x/y/z` or, for a reduction across the blocks, `blockIdx.x/y/z`.
     int n_bound_reduction_loops = 0;
     for (const ForNode* reduction_loop : reduction_loops) {
       if (reduction_loop->thread_binding.defined()) {
         ++n_bound_reduction_loops;
-        CHECK(IsBoundToThreadIdx(reduction_loop))
+        CHECK(IsBoundToThreadIdx(reduction_loop) || IsBoundToBlockIdx(reduction_loop))
             << "ValueError: Cross-thread reduction requires all the reduction-related loops that "
-               "are bound to GPU thread axes to only be bound `threadIdx.x/y/z`. However, loop "
+               "are bound to GPU thread axes to only be bound `threadIdx.x/y/z` or "
+               "`blockIdx.x/y/z`. However, loop "
             << reduction_loop->loop_var->name_hint << " violates the condition.";
       }
     }
@@ -70,6 +70,9 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       thread_extents_.push_back(op);
       Stmt ret = StmtExprMutator::VisitStmt_(op);
       thread_extents_.pop_back();
+      if (thread_extents_.empty() && grid_flag_.defined()) {
+        ret = WrapGridReduceKernel(ret);
+      }
       return ret;
     } else if (op->attr_key == attr::reduce_scope) {
       const CommReducerNode* combiner = op->node.as<CommReducerNode>();
@@ -92,6 +95,33 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       return stmt;
     }
   }
+  Stmt VisitStmt_(const SeqStmtNode* op) final {
+    Array<Stmt> seq;
+    for (size_t i = 0; i < op->seq.size(); ++i) {
+      bool had_grid_reduce = grid_flag_.defined();
+      seq.push_back(this->VisitStmt(op->seq[i]));
+      if (!had_grid_reduce && grid_flag_.defined() && i + 1 < op->seq.size()) {
+        // Only the last block of a group holds the result of the grid-level reduction, so the
+        // statements after it run in that block alone.
+        Array<Stmt> rest;
+        for (size_t j = i + 1; j < op->seq.size(); ++j) {
+          rest.push_back(this->VisitStmt(op->seq[j]));
+        }
+        seq.push_back(GuardGridReduceRest(SeqStmt::Flatten(rest)));
+        break;
+      }
+    }
+    return SeqStmt::Flatten(seq);
+  }
+  Stmt VisitStmt_(const ForNode* op) final {
+    if (thread_extents_.empty()) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    ++kernel_loop_depth_;
+    Stmt ret = StmtExprMutator::VisitStmt_(op);
+    --kernel_loop_depth_;
+    return ret;
+  }
   Stmt VisitStmt_(const AllocateNode* op) final {
     Stmt stmt = StmtExprMutator::VisitStmt_(op);
     op = stmt.as<AllocateNode>();
@@ -136,7 +166,7 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     {
       auto it = buf_remap_.find(op->buffer.get());
       if (it != buf_remap_.end()) {
-        return BufferLoad(it->second, op->indices, op->span);
+        return BufferLoad(it->second, op->indices, op->predicate, op->span);
       }
     }
 
@@ -149,7 +179,7 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
                                op->buffer->buffer_type, op->buffer->axis_separators,
                                op->buffer->span);
         buf_remap_[op->buffer.get()] = remapped_buffer;
-        return BufferLoad(remapped_buffer, op->indices, op->span);
+        return BufferLoad(remapped_buffer, op->indices, op->predicate, op->span);
       }
     }
     return StmtExprMutator::VisitExpr_(op);
@@ -172,7 +202,7 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     {
       auto it = buf_remap_.find(store->buffer.get());
       if (it != buf_remap_.end()) {
-        return BufferStore(it->second, store->value, store->indices, store->span);
+        return BufferStore(it->second, store->value, store->indices, store->predicate, store->span);
       }
     }
 
@@ -185,7 +215,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
                                store->buffer->offset_factor, store->buffer->buffer_type,
                                store->buffer->axis_separators, store->buffer->span);
         buf_remap_[store->buffer.get()] = remapped_buffer;
-        return BufferStore(remapped_buffer, store->value, store->indices, store->span);
+        return BufferStore(remapped_buffer, store->value, store->indices, store->predicate,
+                           store->span);
       }
     }
 
@@ -252,7 +283,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
 
     size_t nmatch = 0;
-    std::vector<ThreadEntry> vred, vpar;
+    std::vector<ThreadEntry> vred, vpar, vred_grid;
+    std::vector<std::pair<Var, PrimExpr>> vpar_grid;
     for (const AttrStmtNode* attr : thread_extents_) {
       ThreadEntry e;
       IterVar iv = Downcast<IterVar>(attr->node);
@@ -275,9 +307,32 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
         } else {
           vpar.push_back(e);
         }
+      } else if (reduce_set.count(iv->var.get())) {
+        // blockIdx in the reduce set, a grid-level reduction.
+        const auto* ptr = attr->value.as<IntImmNode>();
+        ICHECK(ptr) << "Need constant extent for reduce set " << iv;
+        e.extent = static_cast<int>(ptr->value);
+        if (e.extent == 1) {
+          continue;
+        }
+        vred_grid.push_back(e);
+        ++nmatch;
+      } else {
+        vpar_grid.emplace_back(iv->var, attr->value);
       }
     }
     ICHECK_EQ(nmatch, reduce_set.size()) << "Not all reduce index are presented in the context";
+    if (!vred_grid.empty()) {
+      return MakeGridAllreduce(combiner, values, types, buffers, vred, vpar, vred_grid, vpar_grid);
+    }
+    return MakeBlockAllreduce(combiner, values, types, buffers, vred, vpar);
+  }
+
+  // make allreduce among the threads of a block.
+  Stmt MakeBlockAllreduce(const CommReducerNode* combiner, const std::vector<PrimExpr>& values,
+                          const std::vector<DataType>& types, const std::vector<Buffer>& buffers,
+                          std::vector<ThreadEntry> vred, std::vector<ThreadEntry> vpar) {
+    size_t size = values.size();
     std::sort(vred.begin(), vred.end());
     std::sort(vpar.begin(), vpar.end());
     // the size of each index.
@@ -512,6 +567,225 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     return body;
   }
 
+  // make allreduce across the blocks of a grid.
+  //
+  // Each block reduces among its threads, and publishes its partial result to a global
+  // workspace.  The last block of a group of blocks to arrive, as counted by an atomic counter,
+  // reduces the partial results of the group:
+  //
+  // block_allreduce(v) -> r
+  // if reduce_index == 0: partial[group][block_reduce_index] = r
+  // __threadfence(); sync
+  // if thread 0: is_last = atomicAdd(&counter[group], 1) == num_reduce_blocks - 1
+  // sync
+  // if is_last:
+  //   acc = fold(partial[group][reduce_index::reduce_extent])
+  //   block_allreduce(acc) -> r
+  //   if thread 0: counter[group] = 0
+  // sync
+  //
+  // The counters are zeroed by a kernel launched before, and left zeroed by the last blocks.
+  // No co-residency of the blocks is required.
+  Stmt MakeGridAllreduce(const CommReducerNode* combiner, const std::vector<PrimExpr>& values,
+                         const std::vector<DataType>& types, const std::vector<Buffer>& buffers,
+                         std::vector<ThreadEntry> vred, std::vector<ThreadEntry> vpar,
+                         std::vector<ThreadEntry> vred_grid,
+                         const std::vector<std::pair<Var, PrimExpr>>& vpar_grid) {
+    CHECK_EQ(target_->kind->name, "cuda")
+        << "ValueError: The reduction across blockIdx is only supported on CUDA, but the target is "
+        << target_->kind->name;
+    CHECK(!grid_flag_.defined())
+        << "ValueError: A kernel supports at most one reduction across blockIdx";
+    CHECK_EQ(kernel_loop_depth_, 0)
+        << "ValueError: The reduction across blockIdx cannot be inside a loop of the kernel";
+    size_t size = values.size();
+    std::sort(vred.begin(), vred.end());
+    std::sort(vpar.begin(), vpar.end());
+    std::sort(vred_grid.begin(), vred_grid.end());
+    int reduce_extent, group_extent, num_reduce_blocks;
+    PrimExpr reduce_index = FlattenThread(vred, &reduce_extent);
+    PrimExpr group_index = FlattenThread(vpar, &group_extent);
+    PrimExpr block_reduce_index = FlattenThread(vred_grid, &num_reduce_blocks);
+    PrimExpr block_group_index = make_zero(DataType::Int(32));
+    PrimExpr num_block_groups = make_const(DataType::Int(32), 1);
+    for (const auto& [var, extent] : vpar_grid) {
+      block_group_index = block_group_index + var * num_block_groups;
+      num_block_groups = num_block_groups * extent;
+    }
+    block_group_index = analyzer_.Simplify(block_group_index);
+    num_block_groups = analyzer_.Simplify(num_block_groups);
+
+    std::vector<Stmt> seq;
+    seq.push_back(MakeBlockAllreduce(combiner, values, types, buffers, vred, vpar));
+    std::vector<BufferLoad> block_results = GetAllreduceResults(buffers);
+
+    // Publish the partial results.
+    PrimExpr partial_base =
+        analyzer_.Simplify((block_group_index * group_extent + group_index) * num_reduce_blocks);
+    PrimExpr is_reduce_leader = analyzer_.Simplify(reduce_index == 0);
+    PrimExpr is_block_leader = analyzer_.Simplify(reduce_index == 0 && group_index == 0);
+    std::vector<Buffer> partials(size);
+    std::vector<Stmt> publishes;
+    for (size_t i = 0; i < size; ++i) {
+      partials[i] = decl_buffer({analyzer_.Simplify(num_block_groups * group_extent *
+                                                    num_reduce_blocks)},
+                                types[i], "red_partial" + std::to_string(i), "global");
+      publishes.push_back(
+          BufferStore(partials[i], block_results[i], {partial_base + block_reduce_index}));
+    }
+    seq.push_back(IfThenElse(is_reduce_leader, SeqStmt::Flatten(publishes)));
+    seq.push_back(Evaluate(
+        Call(DataType::Int(32), builtin::call_extern(), {StringImm("__threadfence")})));
+    seq.push_back(SyncThread("shared"));
+
+    // Count the arrived blocks of the group.
+    Buffer counter = decl_buffer({num_block_groups}, DataType::Int(32), "red_counter", "global");
+    Buffer flag = decl_buffer({1}, DataType::Int(32), "red_is_last", "shared");
+    PrimExpr arrived =
+        Call(DataType::Int(32), builtin::call_extern(),
+             {StringImm("atomicAdd"),
+              Call(DataType::Handle(), builtin::address_of(),
+                   {BufferLoad(counter, {block_group_index})}),
+              make_const(DataType::Int(32), 1)});
+    seq.push_back(IfThenElse(
+        is_block_leader,
+        BufferStore(flag, Cast(DataType::Int(32), arrived == num_reduce_blocks - 1), {0})));
+    seq.push_back(SyncThread("shared"));
+
+    // The last block folds the partial results in its threads, and reduces among them.
+    std::vector<Buffer> accs(size);
+    std::vector<PrimExpr> acc_values(size);
+    std::vector<Stmt> fin;
+    Var j("j", DataType::Int(32));
+    PrimExpr partial_index = j * reduce_extent + reduce_index;
+    Array<PrimExpr> a, b;
+    for (size_t i = 0; i < size; ++i) {
+      accs[i] = decl_buffer({1}, types[i], "red_acc" + std::to_string(i), "local");
+      acc_values[i] = BufferLoad(accs[i], {0});
+      fin.push_back(BufferStore(accs[i], combiner->identity_element[i], {0}));
+      a.push_back(acc_values[i]);
+      b.push_back(BufferLoad(partials[i], {partial_base + partial_index}));
+    }
+    Array<PrimExpr> ret = (*combiner)(a, b);
+    std::vector<Stmt> folds;
+    for (size_t i = 0; i < size; ++i) {
+      folds.push_back(BufferStore(accs[i], ret[i], {0}));
+    }
+    Stmt fold = SeqStmt::Flatten(folds);
+    if (num_reduce_blocks % reduce_extent != 0) {
+      fold = IfThenElse(partial_index < num_reduce_blocks, fold);
+    }
+    fin.push_back(For(j, 0, (num_reduce_blocks + reduce_extent - 1) / reduce_extent,
+                      ForKind::kSerial, fold));
+    fin.push_back(MakeBlockAllreduce(combiner, acc_values, types, accs, vred, vpar));
+    std::vector<BufferLoad> grid_results = GetAllreduceResults(accs);
+    for (size_t i = 0; i < size; ++i) {
+      fin.push_back(
+          BufferStore(block_results[i]->buffer, grid_results[i], block_results[i]->indices));
+    }
+    fin.push_back(
+        IfThenElse(is_block_leader, BufferStore(counter, make_zero(DataType::Int(32)),
+                                                {block_group_index})));
+    Stmt body = SeqStmt::Flatten(fin);
+    // The reduction among the threads of the last block is built here, so are its allocations.
+    for (size_t i = 0; i < size; ++i) {
+      const VarNode* acc_var = accs[i]->data.get();
+      auto it = alloc_remap_.find(acc_var);
+      if (it != alloc_remap_.end()) {
+        const AllocateNode* repl = it->second.as<AllocateNode>();
+        new_storage_scopes_[repl->buffer_var.get()] = warp_allocs_.count(repl) ? "local" : "shared";
+        body = Allocate(repl->buffer_var, repl->dtype, repl->extents, repl->condition, body);
+        warp_allocs_.erase(repl);
+        alloc_remap_.erase(it);
+      }
+      load_remap_.erase(acc_var);
+      var_remap_.erase(acc_var);
+      store_remap_.erase(accs[i].get());
+      body = Allocate(accs[i]->data, types[i], {1}, const_true(types[i].lanes()), body);
+    }
+    seq.push_back(IfThenElse(BufferLoad(flag, {0}) != 0, body));
+    seq.push_back(SyncThread("shared"));
+
+    Stmt grid_reduce = SeqStmt::Flatten(seq);
+    for (const Buffer& partial : partials) {
+      // Bypass the caches of the other SMs holding stale partial results.
+      grid_reduce = AttrStmt(partial->data, attr::volatile_scope, 1, grid_reduce);
+    }
+    grid_flag_ = flag;
+    grid_counter_ = counter;
+    grid_partials_ = partials;
+    for (const ThreadEntry& e : vred_grid) {
+      grid_reduce_vars_.push_back(e.iv->var);
+    }
+    return grid_reduce;
+  }
+
+  // The results of an allreduce among the threads of a block, by the destination buffers.
+  std::vector<BufferLoad> GetAllreduceResults(const std::vector<Buffer>& buffers) {
+    std::vector<BufferLoad> results;
+    for (const Buffer& buf : buffers) {
+      auto it = load_remap_.find(buf->data.get());
+      if (it != load_remap_.end()) {
+        results.push_back(Downcast<BufferLoad>(it->second));
+      } else {
+        results.push_back(BufferLoad(buf, {0}));
+      }
+    }
+    return results;
+  }
+
+  // Run the statements after a grid-level reduction in the last block of the group, where the
+  // blockIdx of the reduction reads as 0, as it would in the other blocks.
+  Stmt GuardGridReduceRest(Stmt rest) {
+    Map<Var, PrimExpr> vmap;
+    for (const Var& var : grid_reduce_vars_) {
+      vmap.Set(var, make_zero(var.dtype()));
+    }
+    return IfThenElse(BufferLoad(grid_flag_.value(), {0}) != 0, Substitute(rest, vmap));
+  }
+
+  // Allocate the flag of the last block in the kernel, and the global workspaces of a grid-level
+  // reduction outside, zeroing the counters before the kernel.
+  Stmt WrapGridReduceKernel(Stmt kernel) {
+    const auto* attr = kernel.as<AttrStmtNode>();
+    ICHECK(attr);
+    Buffer flag = grid_flag_.value();
+    Buffer counter = grid_counter_.value();
+    kernel = AttrStmt(attr->node, attr->attr_key, attr->value,
+                      Allocate(flag->data, flag->dtype, flag->shape, const_true(), attr->body));
+    Stmt ret = SeqStmt({MakeCounterInit(counter), kernel});
+    ret = Allocate(counter->data, counter->dtype, counter->shape, const_true(), ret);
+    for (const Buffer& partial : grid_partials_) {
+      ret = Allocate(partial->data, partial->dtype, partial->shape,
+                     const_true(partial->dtype.lanes()), ret);
+    }
+    grid_flag_ = NullOpt;
+    grid_counter_ = NullOpt;
+    grid_partials_.clear();
+    grid_reduce_vars_.clear();
+    return ret;
+  }
+
+  // A kernel zeroing the counters of a grid-level reduction.
+  static Stmt MakeCounterInit(const Buffer& counter) {
+    PrimExpr num = counter->shape[0];
+    int num_threads = 256;
+    if (const auto* imm = num.as<IntImmNode>()) {
+      num_threads = std::min(num_threads, static_cast<int>(imm->value));
+    }
+    IterVar bx(Range::FromMinExtent(0, floordiv(num + (num_threads - 1), num_threads)),
+               Var("blockIdx.x"), kThreadIndex, "blockIdx.x");
+    IterVar tx(Range::FromMinExtent(0, make_const(DataType::Int(32), num_threads)),
+               Var("threadIdx.x"), kThreadIndex, "threadIdx.x");
+    PrimExpr index = bx->var * num_threads + tx->var;
+    Stmt body = BufferStore(counter, make_zero(DataType::Int(32)), {index});
+    if (!is_zero(floormod(num, num_threads))) {
+      body = IfThenElse(index < num, body);
+    }
+    body = AttrStmt(tx, attr::thread_extent, tx->dom->extent, body);
+    return AttrStmt(bx, attr::thread_extent, bx->dom->extent, body);
+  }
+
   // make allreduce.
   Stmt MakeBufAllreduce(const CommReducerNode* combiner, const std::vector<DataType>& types,
                         const Array<Buffer>& shared_bufs, PrimExpr reduce_index,
@@ -737,6 +1011,16 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   std::unordered_map<const BufferNode*, Buffer> buf_remap_;
   // Allocate from warp reductions
   std::unordered_set<const void*> warp_allocs_;
+  // The depth of the loops in the kernel.
+  int kernel_loop_depth_{0};
+  // The flag of the last block of the grid-level reduction in the kernel.
+  Optional<Buffer> grid_flag_;
+  // The counters of the arrived blocks of the grid-level reduction in the kernel.
+  Optional<Buffer> grid_counter_;
+  // The partial results of the blocks of the grid-level reduction in the kernel.
+  std::vector<Buffer> grid_partials_;
+  // The blockIdx of the grid-level reduction in the kernel.
+  std::vector<Var> grid_reduce_vars_;
   // Internal analyzer
   arith::Analyzer analyzer_;
 };
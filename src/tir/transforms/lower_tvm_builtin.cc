@@ -309,6 +309,14 @@ class BuiltinLower : public StmtExprMutator {
       return MakeCallPacked(op, /* use_string_lookup */ false);
     } else if (op->op.same_as(builtin::tvm_call_trace_packed())) {
       return MakeCallTracePacked(op);
+    } else if (op->op.same_as(builtin::anylist_setitem_call_packed())) {
+      return MakeAnyListSetItemCallPacked(op, /* use_string_lookup */ true);
+    } else if (op->op.same_as(builtin::anylist_setitem_call_cpacked())) {
+      return MakeAnyListSetItemCallPacked(op, /* use_string_lookup */ false);
+    } else if (op->op.same_as(builtin::anylist_resetitem())) {
+      return Call(op->dtype, builtin::call_extern(),
+                  {StringImm("TVMBackendAnyListResetItem"), op->args[0],
+                   cast(DataType::Int(32), op->args[1])});
     } else if (op->op.same_as(builtin::tvm_stack_make_shape())) {
       return MakeShape(op);
     } else if (op->op.same_as(builtin::tvm_stack_make_array())) {
@@ -432,13 +440,25 @@ class BuiltinLower : public StmtExprMutator {
       arg_count--;
     }
 
-    scope.run_sizes.arg_stack += arg_count;
+    // The return value of a cpacked call is after the slot of the resource handle.
+    scope.run_sizes.arg_stack += use_string_lookup ? arg_count : arg_count + 1;
     // Specially handle the buffer packed intrinsic
     PrimExpr expr = StmtExprMutator::VisitExpr_(op);
     op = expr.as<CallNode>();
     for (size_t i = 1; i < arg_count; ++i) {
       PrimExpr stack_index = ConstInt32(arg_stack_begin + i - 1);
       PrimExpr arg = op->args[i];
+      // An item of an AnyList is passed as it is, with its own type code.
+      if (const auto* item = arg.as<CallNode>()) {
+        if (item->op.same_as(builtin::anylist_getitem())) {
+          prep_seq.emplace_back(Evaluate(Call(
+              DataType::Int(32), builtin::call_extern(),
+              {StringImm("TVMBackendAnyListSetPackedArg"), item->args[0],
+               cast(DataType::Int(32), item->args[1]), scope.stack_value, scope.stack_tcode->data,
+               stack_index})));
+          continue;
+        }
+      }
       DataType t = arg.dtype();
       DataType api_type = APIType(t);
       if (t != api_type) {
@@ -484,6 +504,28 @@ class BuiltinLower : public StmtExprMutator {
     return Call(op->dtype, builtin_call, packed_args);
   }
 
+  // anylist_setitem_call_packed(list, index, name, args...), the packed call followed by the move
+  // of its return value into the list.
+  PrimExpr MakeAnyListSetItemCallPacked(const CallNode* op, bool use_string_lookup) {
+    Array<PrimExpr> call_args(op->args.begin() + 2, op->args.end());
+    if (!use_string_lookup) {
+      // The resource handle of the cpacked call.
+      call_args.push_back(make_zero(DataType::Handle()));
+    }
+    auto builtin_call =
+        use_string_lookup ? builtin::tvm_call_packed() : builtin::tvm_call_cpacked();
+    Call call = Downcast<Call>(
+        MakeCallPacked(Call(DataType::Int(32), builtin_call, call_args).get(), use_string_lookup));
+    auto& scope = alloca_scope_.back();
+    prep_seq_stack_.back().emplace_back(Evaluate(call));
+    // The return value is on the stack right after the arguments.
+    PrimExpr ret_offset = call->args[4];
+    return Call(op->dtype, builtin::call_extern(),
+                {StringImm("TVMBackendAnyListMoveFromPackedReturn"), VisitExpr(op->args[0]),
+                 cast(DataType::Int(32), VisitExpr(op->args[1])), scope.stack_value,
+                 scope.stack_tcode->data, ret_offset});
+  }
+
   PrimExpr MakeCallTracePacked(const CallNode* op) {
     ICHECK(!alloca_scope_.empty());
     auto& scope = alloca_scope_.back();
@@ -21,14 +21,25 @@
  * \file merge_dynamic_shared_memory_allocations.cc
  * \brief Each GPU kernel is allowed to have only one dynamic shared memory allocation.
  * This pass merges multiple TIR-level dynamic shared memory allocations into one allocation.
+ *
+ * When all the allocations have constant sizes, the offsets of the buffers are packed by the
+ * memory planning algorithms of USMP, so that any two buffers whose live ranges do not intersect
+ * can overlap, rather than only the buffers freed before another is allocated.
  */
+#include <tvm/ir/memory_pools.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
+#include <tvm/tir/usmp/algorithms.h>
+#include <tvm/tir/usmp/utils.h>
 
+#include <algorithm>
+#include <list>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "../../runtime/thread_storage_scope.h"
 #include "../../support/arena.h"
@@ -248,11 +259,19 @@ class DynamicSharedMemoryRewriter : public StmtExprMutator {
     DynSharedMemLinearAccessPatternFinder finder;
     finder(stmt);
     this->LivenessAnalysis(finder.linear_seq_);
-    this->PlanMemory(finder.linear_seq_);
+    if (!this->PackOffsets(finder.linear_seq_)) {
+      this->PlanMemory(finder.linear_seq_);
+    }
   }
 
  private:
   Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent && !allocated_ && packed_) {
+      allocated_ = true;
+      Allocate new_body(merged_buf_var_, DataType::UInt(8), {merged_alloc_size_}, const_true(),
+                        StmtExprMutator::VisitStmt(op->body));
+      return AttrStmt(op->node, op->attr_key, op->value, new_body, op->span);
+    }
     if (op->attr_key == attr::thread_extent && !allocated_) {
       // Allocate one dynamic shared memory allocation at the beginning of thread scope
       int max_layer_num = 0;
@@ -442,6 +461,88 @@ class DynamicSharedMemoryRewriter : public StmtExprMutator {
     }
   }
 
+  /*!
+   * \brief Pack the offsets of the buffers of constant sizes by their live ranges.
+   * \param seq the linear pattern of storage access
+   * \return Whether the offsets are packed, false if any of the buffers has a symbolic size.
+   */
+  bool PackOffsets(const std::vector<StmtEntry>& seq) {
+    // The live range of each buffer, from its gen point to its kill point in the sequence. As in
+    // PlanMemory, the buffers killed at a statement are freed before the ones it generates.
+    std::unordered_map<const VarNode*, std::pair<size_t, size_t>> live_ranges;
+    std::vector<const VarNode*> buffers;
+    for (size_t i = 0; i < seq.size(); ++i) {
+      auto it = event_map_.find(seq[i].stmt);
+      if (it == event_map_.end()) continue;
+      if (seq[i].scope_pair_offset >= 0) {
+        for (const VarNode* var : it->second.gen) {
+          if (!live_ranges.count(var)) {
+            buffers.push_back(var);
+            live_ranges[var] = {2 * i + 1, 2 * seq.size()};
+          }
+        }
+      }
+      if (seq[i].scope_pair_offset <= 0) {
+        for (const VarNode* var : it->second.kill) {
+          live_ranges[var].second = std::max(2 * i, live_ranges[var].first);
+        }
+      }
+    }
+    if (buffers.empty()) {
+      return false;
+    }
+    int alignment = kSharedMemoryAlignment;
+    for (const VarNode* var : buffers) {
+      const AllocateNode* alloc = dyn_shmem_allocs_.at(var);
+      if (alloc->ConstantAllocationSize() == 0) {
+        return false;
+      }
+      alignment = std::max(alignment, alloc->dtype.bytes() * alloc->dtype.lanes());
+    }
+    PoolInfo pool = WorkspacePoolInfo(merged_buf_var_->name_hint, {});
+    std::vector<usmp::BufferInfo> buffer_infos;
+    for (const VarNode* var : buffers) {
+      const AllocateNode* alloc = dyn_shmem_allocs_.at(var);
+      int64_t size_bytes =
+          alloc->ConstantAllocationSize() * alloc->dtype.bytes() * alloc->dtype.lanes();
+      buffer_infos.push_back(
+          usmp::BufferInfo(var->name_hint, Integer(size_bytes), {pool}, Integer(alignment)));
+    }
+    // Two buffers conflict if their live ranges intersect.
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      Array<ObjectRef> conflicts;
+      for (size_t j = 0; j < buffers.size(); ++j) {
+        const auto& a = live_ranges[buffers[i]];
+        const auto& b = live_ranges[buffers[j]];
+        if (i != j && a.first <= b.second && b.first <= a.second) {
+          conflicts.push_back(buffer_infos[j]);
+        }
+      }
+      buffer_infos[i]->conflicts = conflicts;
+    }
+    // Keep the tighter of the two greedy plans.
+    Array<usmp::BufferInfo> buffer_info_arr(buffer_infos.begin(), buffer_infos.end());
+    Map<usmp::BufferInfo, usmp::PoolAllocation> best_plan;
+    int64_t best_size = -1;
+    for (const auto& algo : {usmp::algo::GreedyBySize, usmp::algo::GreedyByConflicts}) {
+      Map<usmp::BufferInfo, usmp::PoolAllocation> plan = algo(buffer_info_arr, Integer(0));
+      int64_t size = 0;
+      for (const usmp::BufferInfo& info : buffer_infos) {
+        size = std::max(size, plan[info]->byte_offset->value + info->size_bytes->value);
+      }
+      if (best_size < 0 || size < best_size) {
+        best_size = size;
+        best_plan = plan;
+      }
+    }
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      buffer_byte_offsets_[buffers[i]] = Integer(best_plan[buffer_infos[i]]->byte_offset);
+    }
+    merged_alloc_size_ = Integer((best_size + alignment - 1) / alignment * alignment);
+    packed_ = true;
+    return true;
+  }
+
   /*!
    * \brief Memory plan algorithm
    * \param seq the linear pattern of storage access
@@ -599,6 +700,10 @@ class DynamicSharedMemoryRewriter : public StmtExprMutator {
   std::unordered_map<const BufferNode*, Buffer> buffer_remap_;
   // The flag indicating whether the merged buffer has been allocated
   bool allocated_{false};
+  // The flag indicating whether the offsets are packed by their live ranges
+  bool packed_{false};
+  // The alignment of the buffers in the merged buffer, for vectorized accesses of 128 bits
+  static constexpr int kSharedMemoryAlignment = 16;
   // Locations of free ops.
   std::unordered_map<const Object*, EventEntry> event_map_;
   // constant size free map.
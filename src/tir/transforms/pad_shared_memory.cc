@@ -0,0 +1,260 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file pad_shared_memory.cc
+ * \brief Pad the rows of the shared memory buffers to avoid the bank conflicts.
+ *
+ * The threads of a warp reading or writing the same columns of different rows of a shared buffer,
+ * as the copies from global memory bound across the rows and the tensor core loads of tiles do,
+ * hit the same bank when the rows are a multiple of the 128 bytes of the banks apart. This pass
+ * finds such buffers and annotates their rows with the storage alignment of the schedule
+ * primitive storage_align, so that the rows are an odd number of accesses apart, which
+ * CompactBufferAllocation then applies to the strides of the buffers, rewriting the indexing.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../runtime/thread_storage_scope.h"
+#include "../schedule/utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The bytes of the 32 banks of 4 bytes of shared memory. */
+static constexpr int kBankBytes = 128;
+/*! \brief The widest access of a thread to shared memory, in bytes. */
+static constexpr int kMaxAccessBytes = 16;
+
+/*! \brief The access pattern of a shared buffer with at least two dimensions. */
+struct SharedAccessInfo {
+  /*! \brief The first block writing the buffer, which carries the alignment. */
+  const BlockNode* writer = nullptr;
+  /*! \brief The index of the buffer in the writes of the writer. */
+  int write_index = -1;
+  /*! \brief Whether the threads access different rows. */
+  bool cross_row = false;
+  /*! \brief The widest access of a thread, in bytes. */
+  int access_bytes = 0;
+  /*! \brief Whether the buffer has a storage alignment already. */
+  bool aligned = false;
+};
+
+/*! \brief Collect the access patterns of the shared buffers. */
+class SharedAccessCollector : public StmtExprVisitor {
+ public:
+  static std::unordered_map<const BufferNode*, SharedAccessInfo> Collect(const Stmt& body) {
+    SharedAccessCollector collector;
+    collector(body);
+    return std::move(collector.infos_);
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    if (IsThreadIdx(GetThreadScope(op))) {
+      thread_vars_.insert(op->loop_var.get());
+    } else if (op->kind == ForKind::kVectorized) {
+      if (const auto* extent = op->extent.as<IntImmNode>()) {
+        vector_lanes_[op->loop_var.get()] = extent->value;
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      if (IsThreadIdx(runtime::ThreadScope::Create(iv->thread_tag))) {
+        thread_vars_.insert(iv->var.get());
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BlockRealizeNode* op) final {
+    for (size_t i = 0; i < op->iter_values.size(); ++i) {
+      iter_bindings_.Set(op->block->iter_vars[i]->var,
+                         Substitute(op->iter_values[i], iter_bindings_));
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BlockNode* op) final {
+    for (const Buffer& buffer : op->alloc_buffers) {
+      runtime::StorageScope scope = runtime::StorageScope::Create(buffer.scope());
+      if (scope.rank == runtime::StorageRank::kShared && buffer->shape.size() >= 2) {
+        infos_.emplace(buffer.get(), SharedAccessInfo());
+      }
+    }
+    for (size_t i = 0; i < op->writes.size(); ++i) {
+      auto it = infos_.find(op->writes[i]->buffer.get());
+      if (it != infos_.end() && it->second.writer == nullptr) {
+        it->second.writer = op;
+        it->second.write_index = i;
+      }
+    }
+    auto it = op->annotations.find(attr::buffer_dim_align);
+    if (it != op->annotations.end()) {
+      for (const StorageAlignTuple& align : Downcast<StorageAlignAnnotation>((*it).second)) {
+        auto info = infos_.find(op->writes[align[0]->value]->buffer.get());
+        if (info != infos_.end()) {
+          info->second.aligned = true;
+        }
+      }
+    }
+    // A tile of several rows matched by an intrinsic is accessed across the rows by the warp.
+    for (const MatchBufferRegion& match : op->match_buffers) {
+      auto info = infos_.find(match->source->buffer.get());
+      if (info == infos_.end()) {
+        continue;
+      }
+      const Range& rows = match->source->region[match->source->region.size() - 2];
+      if (!is_one(rows->extent)) {
+        info->second.cross_row = true;
+        info->second.access_bytes = kMaxAccessBytes;
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    VisitAccess(op->buffer, op->indices, op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    VisitAccess(op->buffer, op->indices, op->value.dtype());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitAccess(const Buffer& buffer, const Array<PrimExpr>& indices, DataType dtype) {
+    auto it = infos_.find(buffer.get());
+    if (it == infos_.end()) {
+      return;
+    }
+    SharedAccessInfo& info = it->second;
+    size_t ndim = indices.size();
+    PrimExpr row = Substitute(indices[ndim - 2], iter_bindings_);
+    PrimExpr column = Substitute(indices[ndim - 1], iter_bindings_);
+    if (UsesVar(row, [this](const VarNode* v) { return thread_vars_.count(v); })) {
+      info.cross_row = true;
+    }
+    int64_t lanes = 1;
+    for (const auto& [var, extent] : vector_lanes_) {
+      if (UsesVar(column, [var = var](const VarNode* v) { return v == var; })) {
+        lanes *= extent;
+      }
+    }
+    int64_t bytes = std::min<int64_t>(dtype.bytes() * dtype.lanes() * lanes, kMaxAccessBytes);
+    info.access_bytes = std::max(info.access_bytes, static_cast<int>(bytes));
+  }
+
+  /*! \brief The bindings of the block iter vars, in terms of the loop vars. */
+  Map<Var, PrimExpr> iter_bindings_;
+  /*! \brief The vars of the loops bound to threadIdx. */
+  std::unordered_set<const VarNode*> thread_vars_;
+  /*! \brief The lanes of the vectorized loops. */
+  std::unordered_map<const VarNode*, int64_t> vector_lanes_;
+  /*! \brief The access patterns of the shared buffers. */
+  std::unordered_map<const BufferNode*, SharedAccessInfo> infos_;
+};
+
+/*! \brief Annotate the storage alignment of the rows of the shared buffers accessed across them. */
+class SharedMemoryPadder : public StmtMutator {
+ public:
+  static Stmt Pad(Stmt body) {
+    SharedMemoryPadder padder;
+    for (const auto& [buffer, info] : SharedAccessCollector::Collect(body)) {
+      if (!info.cross_row || info.aligned || info.writer == nullptr) {
+        continue;
+      }
+      int elem_bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+      if (elem_bytes > kMaxAccessBytes) {
+        continue;
+      }
+      int access_bytes = std::max(info.access_bytes, elem_bytes);
+      // The rows an odd number of accesses apart hit distinct banks already.
+      const auto* row = buffer->shape.back().as<IntImmNode>();
+      if (row != nullptr && (row->value * elem_bytes) % access_bytes == 0 &&
+          (row->value * elem_bytes / access_bytes) % 2 == 1) {
+        continue;
+      }
+      int ndim = buffer->shape.size();
+      padder.aligns_[info.writer].push_back(
+          {Integer(info.write_index), Integer(ndim - 2), Integer(kBankBytes / elem_bytes),
+           Integer(access_bytes / elem_bytes)});
+    }
+    if (padder.aligns_.empty()) {
+      return body;
+    }
+    return padder(std::move(body));
+  }
+
+ private:
+  Stmt VisitStmt_(const BlockNode* op) final {
+    Block block = Downcast<Block>(StmtMutator::VisitStmt_(op));
+    auto it = aligns_.find(op);
+    if (it == aligns_.end()) {
+      return std::move(block);
+    }
+    StorageAlignAnnotation aligns;
+    auto annotation = block->annotations.find(attr::buffer_dim_align);
+    if (annotation != block->annotations.end()) {
+      aligns = Downcast<StorageAlignAnnotation>((*annotation).second);
+    }
+    std::vector<StorageAlignTuple> new_aligns = it->second;
+    std::sort(new_aligns.begin(), new_aligns.end(),
+              [](const StorageAlignTuple& a, const StorageAlignTuple& b) {
+                return a[0]->value < b[0]->value;
+              });
+    for (const StorageAlignTuple& align : new_aligns) {
+      aligns.push_back(align);
+    }
+    block.CopyOnWrite()->annotations.Set(attr::buffer_dim_align, aligns);
+    return std::move(block);
+  }
+
+  /*! \brief The storage alignments to annotate, by the writers of the buffers. */
+  std::unordered_map<const BlockNode*, std::vector<StorageAlignTuple>> aligns_;
+};
+
+namespace transform {
+
+Pass PadSharedMemory() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    n->body = SharedMemoryPadder::Pad(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.PadSharedMemory", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.PadSharedMemory").set_body_typed(PadSharedMemory);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
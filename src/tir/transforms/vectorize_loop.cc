@@ -152,6 +152,103 @@ class VecAllocAccess : public StmtExprMutator {
 };
 
 // We use ExprFunctor directly instead of StmtExprMutator
+/*!
+ * \brief Mask the buffer accesses of a vectorized statement by a vector predicate.
+ *
+ *  Every store of the statement must write a contiguous vector of the lanes of the predicate,
+ *  and every vector load must read one. The scalar loads, which do not depend on the vectorized
+ *  loop, are only allowed when the first lane is known to be active whenever any lane is, i.e.
+ *  for a predicate of the form ramp(base, 1, lanes) < broadcast(bound, lanes), and the accesses
+ *  are then guarded by base < bound.
+ */
+class BufferAccessPredicator : public StmtExprMutator {
+ public:
+  /*!
+   * \brief Mask the buffer accesses of a statement.
+   * \param stmt The vectorized statement.
+   * \param predicate The vector predicate.
+   * \return The statement with masked accesses, or NullOpt if some access cannot be masked.
+   */
+  static Optional<Stmt> Predicate(const Stmt& stmt, const PrimExpr& predicate) {
+    BufferAccessPredicator predicator(predicate);
+    Stmt body = predicator(stmt);
+    if (predicator.failed_) {
+      return NullOpt;
+    }
+    if (predicator.has_scalar_load_) {
+      const auto* lt = predicate.as<LTNode>();
+      const auto* ramp = lt ? lt->a.as<RampNode>() : nullptr;
+      const auto* bound = lt ? lt->b.as<BroadcastNode>() : nullptr;
+      if (!ramp || !bound || !is_one(ramp->stride)) {
+        return NullOpt;
+      }
+      body = IfThenElse(ramp->base < bound->value, body);
+    }
+    return body;
+  }
+
+ private:
+  explicit BufferAccessPredicator(PrimExpr predicate)
+      : predicate_(predicate), lanes_(predicate.dtype().lanes()) {}
+
+  Stmt VisitStmt(const Stmt& stmt) final {
+    if (!stmt->IsInstance<BufferStoreNode>() && !stmt->IsInstance<SeqStmtNode>()) {
+      failed_ = true;
+      return stmt;
+    }
+    return StmtExprMutator::VisitStmt(stmt);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    BufferStore store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    if (!IsContiguous(store->buffer, store->indices, store->value.dtype().lanes()) ||
+        store->predicate.defined()) {
+      failed_ = true;
+      return std::move(store);
+    }
+    store.CopyOnWrite()->predicate = predicate_;
+    return std::move(store);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    BufferLoad load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    if (load->dtype.lanes() == 1) {
+      has_scalar_load_ = true;
+      return std::move(load);
+    }
+    if (!IsContiguous(load->buffer, load->indices, load->dtype.lanes()) ||
+        load->predicate.defined()) {
+      failed_ = true;
+      return std::move(load);
+    }
+    load.CopyOnWrite()->predicate = predicate_;
+    return std::move(load);
+  }
+
+  /*! \brief Whether an access is a contiguous vector of the lanes of the predicate. */
+  bool IsContiguous(const Buffer& buffer, const Array<PrimExpr>& indices, int lanes) const {
+    if (lanes != lanes_ || buffer->dtype.lanes() != 1) {
+      return false;
+    }
+    for (size_t i = 0; i + 1 < indices.size(); ++i) {
+      if (indices[i].dtype().is_vector()) {
+        return false;
+      }
+    }
+    const auto* ramp = indices.back().as<RampNode>();
+    return ramp && ramp->lanes == lanes_ && is_one(ramp->stride);
+  }
+
+  /*! \brief The vector predicate. */
+  PrimExpr predicate_;
+  /*! \brief The lanes of the predicate. */
+  int lanes_;
+  /*! \brief Whether some access cannot be masked. */
+  bool failed_{false};
+  /*! \brief Whether the statement has a scalar load. */
+  bool has_scalar_load_{false};
+};
+
 // This is because the transformation can change the dtype of the Expr
 // The existing ExprMutator transformation rules may not be well defined.
 class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExpr&)> {
@@ -159,7 +256,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool enable_predication = false)
+      : var_(var), var_lanes_(var_lanes), enable_predication_(enable_predication) {
     ramp_ = Ramp(IntImm(var->dtype, 0), IntImm(var->dtype, 1), var_lanes);
   }
 
@@ -485,6 +583,11 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   // IfThenElse
   Stmt VisitStmt_(const IfThenElseNode* op) final {
     ICHECK(!op->condition.dtype().is_vector());
+    if (enable_predication_ && !op->else_case) {
+      if (Optional<Stmt> predicated = PredicateBufferAccesses(op)) {
+        return predicated.value();
+      }
+    }
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
       return Scalarize(GetRef<Stmt>(op));
@@ -501,6 +604,44 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
       return IfThenElse(condition, then_case, else_case);
     }
   }
+  /*!
+   * \brief Vectorize a guarded statement into buffer accesses masked by the vectorized guard,
+   *  e.g. the tail of a split loop, instead of scalarizing it.
+   * \return The masked statement, or NullOpt if the guard is not a vector of the lanes of the
+   *  loop, or some access cannot be masked.
+   */
+  Optional<Stmt> PredicateBufferAccesses(const IfThenElseNode* op) {
+    // Only the stores are masked, so they are checked before the let bindings of the body get
+    // vectorized.
+    Array<Stmt> stores;
+    if (const auto* seq = op->then_case.as<SeqStmtNode>()) {
+      stores = seq->seq;
+    } else {
+      stores = {op->then_case};
+    }
+    for (const Stmt& stmt : stores) {
+      if (!stmt->IsInstance<BufferStoreNode>()) {
+        return NullOpt;
+      }
+    }
+    PrimExpr condition = op->condition;
+    if (const auto* call = condition.as<CallNode>()) {
+      if (call->op.same_as(builtin::likely())) {
+        condition = call->args[0];
+      }
+    }
+    PrimExpr predicate = this->VisitExpr(condition);
+    if (need_scalarize_ || predicate.dtype().lanes() != var_lanes_) {
+      need_scalarize_ = false;
+      return NullOpt;
+    }
+    Stmt then_case = StmtMutator::VisitStmt(op->then_case);
+    if (need_scalarize_) {
+      need_scalarize_ = false;
+      return NullOpt;
+    }
+    return BufferAccessPredicator::Predicate(then_case, predicate);
+  }
   // While
   Stmt VisitStmt_(const WhileNode* op) final {
     LOG(FATAL) << "A while loop inside a vectorized loop not supported.";
@@ -587,6 +728,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   int var_lanes_;
   // ramp representing the var.
   PrimExpr ramp_;
+  // whether to mask the accesses guarded by a vector condition, instead of scalarizing them.
+  bool enable_predication_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
   // Let binding
@@ -656,6 +799,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool enable_predication = false)
+      : enable_predication_(enable_predication) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
@@ -663,11 +809,15 @@ class LoopVectorizer : public StmtMutator {
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        enable_predication_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool enable_predication_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -689,12 +839,16 @@ Stmt SkipVectorize(Stmt stmt) { return VectorizeSkipper()(std::move(stmt)); }
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_buffer_level_predication", Bool);
+
 // TODO(tvm-team): Make it as a target property.
 Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      bool enable_predication =
+          ctx->GetConfig<Bool>("tir.enable_buffer_level_predication", Bool(false)).value();
+      n->body = LoopVectorizer(enable_predication)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
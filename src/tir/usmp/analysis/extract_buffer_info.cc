@@ -26,6 +26,7 @@
  * conflicts between other tir.allocate nodes.
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/node/structural_equal.h>
 #include <tvm/relay/executor.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/tir/builtin.h>
@@ -34,7 +35,10 @@
 #include <tvm/tir/usmp/analysis.h>
 #include <tvm/tir/usmp/utils.h>
 
+#include <algorithm>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../../../runtime/thread_storage_scope.h"
 
@@ -42,6 +46,223 @@ namespace tvm {
 namespace tir {
 namespace usmp {
 
+using VarAliasMap = std::unordered_map<Var, Var, ObjectPtrHash, ObjectPtrEqual>;
+
+/*!
+ * \brief The visitor class to find the intermediate allocates of the main function
+ * that can share the storage of an input of the call that produces them.
+ *
+ * An output of a call to an operator annotated with kInplaceSafeFuncAttr is aliased to
+ * an input of the call of the same size, dtype and shape that the operator only reads,
+ * when the call is the first use of the output and the last use of the input. Only the
+ * allocates outside of loops that are passed to the operators as arguments and not used
+ * otherwise are considered, so that the calls define their liveness. The aliasing is
+ * transitive along chains of such calls.
+ */
+class InplaceAliasFinder : public StmtExprVisitor {
+ public:
+  static VarAliasMap Find(const PrimFunc& main_func, const Map<String, PrimFunc>& functions) {
+    InplaceAliasFinder finder(functions);
+    finder(main_func->body);
+    return finder.FindAliases();
+  }
+
+ private:
+  explicit InplaceAliasFinder(const Map<String, PrimFunc>& functions) : functions_(functions) {}
+
+  /*! \brief The calls of an allocate, by their index in the order of calls. */
+  struct Uses {
+    int first_call = -1;
+    int last_call = -1;
+    /*! \brief Whether the allocate is used other than as an argument of a call. */
+    bool escaped = false;
+  };
+
+  struct CallInfo {
+    PrimFunc func;
+    Array<PrimExpr> args;
+  };
+
+  void VisitStmt_(const AllocateNode* op) final {
+    const auto& type = Downcast<PointerType>(op->buffer_var->type_annotation);
+    const auto& storage_scope = runtime::StorageScope::Create(type->storage_scope);
+    if (loop_depth_ == 0 && storage_scope.rank == runtime::StorageRank::kGlobal &&
+        op->annotations.count(kPoolCandidatesAllocateAttr) &&
+        !op->annotations.count(kInputTensorAllocate) &&
+        !op->annotations.count(kOutputTensorAllocate) && CalculateExtentsSize(op).defined()) {
+      allocates_[op->buffer_var] = op;
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    loop_depth_ += 1;
+    StmtExprVisitor::VisitStmt_(op);
+    loop_depth_ -= 1;
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    PrimFunc func;
+    Array<PrimExpr> args;
+    if (op->op.same_as(builtin::call_extern()) || op->op.same_as(builtin::tvm_call_cpacked())) {
+      String func_name = Downcast<StringImm>(op->args[0])->value;
+      if (functions_.count(func_name)) {
+        func = functions_[func_name];
+        args = Array<PrimExpr>(op->args.begin() + 1, op->args.end());
+      }
+    } else if (op->op->IsInstance<PrimFuncNode>()) {
+      func = Downcast<PrimFunc>(op->op);
+      args = op->args;
+    }
+    // The calls in loops extend the liveness of their arguments to the loops.
+    if (!func.defined() || loop_depth_ > 0) {
+      StmtExprVisitor::VisitExpr_(op);
+      return;
+    }
+    int call_idx = calls_.size();
+    calls_.push_back(CallInfo{func, args});
+    for (const PrimExpr& arg : args) {
+      const auto* var = arg.as<VarNode>();
+      if (var != nullptr && allocates_.count(GetRef<Var>(var))) {
+        Uses& uses = uses_[GetRef<Var>(var)];
+        if (uses.first_call == -1) {
+          uses.first_call = call_idx;
+        }
+        uses.last_call = call_idx;
+      } else {
+        VisitExpr(arg);
+      }
+    }
+  }
+
+  void VisitExpr_(const VarNode* op) final {
+    auto var = GetRef<Var>(op);
+    if (allocates_.count(var)) {
+      uses_[var].escaped = true;
+    }
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    if (allocates_.count(op->buffer_var)) {
+      uses_[op->buffer_var].escaped = true;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  /*! \brief Get the data vars of the params of a PrimFunc not only read by it. */
+  static std::unordered_set<const VarNode*> GetWrittenParams(const PrimFunc& func) {
+    std::unordered_set<const VarNode*> written;
+    PostOrderVisit(func->body, [&written](const ObjectRef& node) {
+      if (const auto* store = node.as<BufferStoreNode>()) {
+        written.insert(store->buffer->data.get());
+      } else if (const auto* var = node.as<VarNode>()) {
+        // The data var used other than in a BufferLoad could be written through.
+        written.insert(var);
+      } else if (const auto* call = node.as<CallNode>()) {
+        if (call->op.same_as(builtin::address_of())) {
+          if (const auto* load = call->args[0].as<BufferLoadNode>()) {
+            written.insert(load->buffer->data.get());
+          }
+        }
+      }
+    });
+    return written;
+  }
+
+  /*! \brief Whether two buffers have the same dtype and constant shapes of the same size. */
+  static bool IsSameLayout(const Buffer& a, const Buffer& b) {
+    if (a->dtype != b->dtype) {
+      return false;
+    }
+    auto f_size = [](const Buffer& buffer) -> int64_t {
+      int64_t size = 1;
+      for (const PrimExpr& dim : buffer->shape) {
+        const auto* imm = dim.as<IntImmNode>();
+        if (imm == nullptr) {
+          return -1;
+        }
+        size *= imm->value;
+      }
+      return size;
+    };
+    int64_t size = f_size(a);
+    return size != -1 && size == f_size(b);
+  }
+
+  VarAliasMap FindAliases() const {
+    VarAliasMap aliases;
+    for (int call_idx = 0; call_idx < static_cast<int>(calls_.size()); ++call_idx) {
+      const CallInfo& call = calls_[call_idx];
+      if (!call.func->GetAttr<Bool>(kInplaceSafeFuncAttr).value_or(Bool(false))) {
+        continue;
+      }
+      std::unordered_set<const VarNode*> written = GetWrittenParams(call.func);
+      size_t num_params = std::min(call.args.size(), call.func->params.size());
+      std::unordered_map<const VarNode*, int> num_occurrences;
+      for (const PrimExpr& arg : call.args) {
+        if (const auto* var = arg.as<VarNode>()) {
+          num_occurrences[var] += 1;
+        }
+      }
+      std::unordered_set<const VarNode*> taken;
+      for (size_t out_idx = 0; out_idx < num_params; ++out_idx) {
+        Optional<Buffer> out_buffer = call.func->buffer_map.Get(call.func->params[out_idx]);
+        const auto* out_var = call.args[out_idx].as<VarNode>();
+        // The output is produced by this call, and passed to it only once.
+        if (!out_buffer || out_var == nullptr || !written.count(out_buffer.value()->data.get()) ||
+            num_occurrences[out_var] != 1) {
+          continue;
+        }
+        auto out_uses = uses_.find(GetRef<Var>(out_var));
+        if (out_uses == uses_.end() || out_uses->second.escaped ||
+            out_uses->second.first_call != call_idx) {
+          continue;
+        }
+        const AllocateNode* out_allocate = allocates_.at(GetRef<Var>(out_var));
+        for (size_t in_idx = 0; in_idx < num_params; ++in_idx) {
+          Optional<Buffer> in_buffer = call.func->buffer_map.Get(call.func->params[in_idx]);
+          const auto* in_var = call.args[in_idx].as<VarNode>();
+          if (!in_buffer || in_var == nullptr || in_var == out_var || taken.count(in_var) ||
+              written.count(in_buffer.value()->data.get()) ||
+              !IsSameLayout(in_buffer.value(), out_buffer.value())) {
+            continue;
+          }
+          // The input is not used after this call.
+          auto in_uses = uses_.find(GetRef<Var>(in_var));
+          if (in_uses == uses_.end() || in_uses->second.escaped ||
+              in_uses->second.last_call != call_idx) {
+            continue;
+          }
+          const AllocateNode* in_allocate = allocates_.at(GetRef<Var>(in_var));
+          if (CalculateExtentsSize(in_allocate)->value !=
+                  CalculateExtentsSize(out_allocate)->value ||
+              !StructuralEqual()(in_allocate->annotations[kPoolCandidatesAllocateAttr],
+                                 out_allocate->annotations[kPoolCandidatesAllocateAttr])) {
+            continue;
+          }
+          auto root = aliases.find(GetRef<Var>(in_var));
+          aliases[GetRef<Var>(out_var)] =
+              root != aliases.end() ? root->second : GetRef<Var>(in_var);
+          taken.insert(in_var);
+          break;
+        }
+      }
+    }
+    return aliases;
+  }
+
+  /*! \brief The PrimFuncs of the IRModule by name. */
+  const Map<String, PrimFunc>& functions_;
+  /*! \brief The candidate allocates of the main function. */
+  std::unordered_map<Var, const AllocateNode*, ObjectPtrHash, ObjectPtrEqual> allocates_;
+  /*! \brief The uses of the candidate allocates. */
+  std::unordered_map<Var, Uses, ObjectPtrHash, ObjectPtrEqual> uses_;
+  /*! \brief The calls to the PrimFuncs, in order. */
+  std::vector<CallInfo> calls_;
+  /*! \brief The depth of the loops being visited. */
+  int loop_depth_ = 0;
+};
+
 /*!
  * \brief The visitor class to obtain buffer information
  *
@@ -81,6 +302,7 @@ class BufferInfoExtractor : public StmtExprVisitor {
   void VisitStmt_(const ForNode* op) override;
 
   void UpdateAliases(const Array<PrimExpr>& args, const PrimFunc& func);
+  Var ResolveInplaceAlias(const Var& var) const;
   void RecordAllocateNodeInfo(const AllocateNode* op);
   void RecordAllocateConstNodeInfo(const AllocateConstNode* op);
   void VisitPrimFunc(const PrimFunc& func, const Call& call);
@@ -126,6 +348,15 @@ class BufferInfoExtractor : public StmtExprVisitor {
    * that only one BufferInfo object is created.
    */
   std::unordered_map<tir::Var, AllocateInfo, ObjectPtrHash, ObjectPtrEqual> allocate_infos;
+  /*!
+   * \brief The buffer variables of the outputs computed in-place to the buffer variables
+   * of the inputs whose storage they share.
+   */
+  VarAliasMap inplace_aliases_;
+  /*!
+   * \brief The allocate nodes of the outputs computed in-place.
+   */
+  std::unordered_map<tir::Var, Allocate, ObjectPtrHash, ObjectPtrEqual> inplace_allocates_;
   /*!
    * \brief Indicates a count of stmts visited so far to use as a metric of liveness
    */
@@ -228,6 +459,11 @@ void BufferInfoExtractor::VisitStmt(const Stmt& n) {
 }
 
 void BufferInfoExtractor::RecordAllocateNodeInfo(const AllocateNode* op) {
+  // The outputs computed in-place are accounted to the inputs they alias.
+  if (inplace_aliases_.count(op->buffer_var)) {
+    inplace_allocates_[op->buffer_var] = GetRef<Allocate>(op);
+    return;
+  }
   auto size_bytes = CalculateExtentsSize(op);
   // We only statically memory plan only allocates with known
   // compile time sizes.
@@ -394,8 +630,13 @@ void BufferInfoExtractor::VisitStmt_(const BufferStoreNode* op) {
   StmtExprVisitor::VisitStmt_(op);
 }
 
+Var BufferInfoExtractor::ResolveInplaceAlias(const Var& var) const {
+  auto it = inplace_aliases_.find(var);
+  return it != inplace_aliases_.end() ? it->second : var;
+}
+
 void BufferInfoExtractor::VisitExpr_(const VarNode* op) {
-  auto var = GetRef<Var>(op);
+  auto var = ResolveInplaceAlias(GetRef<Var>(op));
   Call current_call = scope_stack_.top().call;
   PrimFunc current_primfunc = scope_stack_.top().func;
   if (allocate_infos.count(var)) {
@@ -460,7 +701,7 @@ void BufferInfoExtractor::UpdateAliases(const Array<PrimExpr>& args, const PrimF
         allocate_infos[param_buf] = allocate_infos[load->buffer_var];
       }
     } else if (arg->IsInstance<VarNode>()) {
-      auto var = Downcast<Var>(arg);
+      auto var = ResolveInplaceAlias(Downcast<Var>(arg));
       if (allocate_infos.count(var)) {
         allocate_infos[param_buf] = allocate_infos[var];
       }
@@ -505,6 +746,7 @@ void BufferInfoExtractor::VisitExpr_(const CallNode* op) {
 }
 
 BufferInfoAnalysis BufferInfoExtractor::operator()(const PrimFunc& main_func) {
+  inplace_aliases_ = InplaceAliasFinder::Find(main_func, functions_);
   VisitPrimFunc(main_func, Call());
 
   // Create a vector of liveness events
@@ -615,7 +857,15 @@ BufferInfoAnalysis BufferInfoExtractor::operator()(const PrimFunc& main_func) {
                  [&srch](const auto& c) { return srch.end() == srch.find(c); });
     buf->conflicts.Assign(conflicts.begin(), conflicts.end());
   }
-  return BufferInfoAnalysis(this->buffer_info_map_, max_open_set_size);
+
+  Map<Stmt, Stmt> inplace_aliases;
+  for (const auto& kv : inplace_allocates_) {
+    auto it = allocate_infos.find(inplace_aliases_.at(kv.first));
+    if (it != allocate_infos.end()) {
+      inplace_aliases.Set(kv.second, it->second.Allocate);
+    }
+  }
+  return BufferInfoAnalysis(this->buffer_info_map_, max_open_set_size, inplace_aliases);
 }
 
 BufferInfoAnalysis ExtractBufferInfo(const PrimFunc& main_func, const IRModule& mod) {
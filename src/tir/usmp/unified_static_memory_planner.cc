@@ -84,6 +84,12 @@ IRModule PlanMemory(const IRModule& mod, String algo, bool use_workspace_io,
 
   Map<Stmt, PoolAllocation> stmt_pool_allocations = AssignStmtPoolAllocations(
       buffer_info_analysis->buffer_info_stmts, buffer_info_pool_allocations);
+  // The outputs computed in-place share the pool allocations of the inputs they alias.
+  for (const auto& kv : buffer_info_analysis->inplace_aliases) {
+    if (stmt_pool_allocations.count(kv.second)) {
+      stmt_pool_allocations.Set(kv.first, stmt_pool_allocations[kv.second]);
+    }
+  }
 
   module = transform::ConvertPoolAllocationsToOffsets(stmt_pool_allocations)(module);
   if (use_workspace_io) {
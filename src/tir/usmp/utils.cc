@@ -78,10 +78,12 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
     });
 
 BufferInfoAnalysis::BufferInfoAnalysis(Map<BufferInfo, tir::Stmt> buffer_info_stmts,
-                                       Integer memory_pressure) {
+                                       Integer memory_pressure,
+                                       Map<tir::Stmt, tir::Stmt> inplace_aliases) {
   auto bufinfo_analysis_node = make_object<BufferInfoAnalysisNode>();
   bufinfo_analysis_node->buffer_info_stmts = buffer_info_stmts;
   bufinfo_analysis_node->memory_pressure = memory_pressure;
+  bufinfo_analysis_node->inplace_aliases = inplace_aliases;
   data_ = std::move(bufinfo_analysis_node);
 }
 
@@ -96,7 +98,8 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
       auto* node = static_cast<const BufferInfoAnalysisNode*>(ref.get());
       p->stream << "BufferInfoAnalysisNode(\n"
                 << "buffer_info_stmts=" << node->buffer_info_stmts
-                << ",\n  memory_pressure=" << node->memory_pressure << ")";
+                << ",\n  memory_pressure=" << node->memory_pressure
+                << ",\n  inplace_aliases=" << node->inplace_aliases.size() << ")";
     });
 
 PoolAllocation::PoolAllocation(PoolInfo pool_info, Integer byte_offset) {
@@ -18,8 +18,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/logging.h>
 
+#include <atomic>
+
 #include "../src/runtime/hexagon/hexagon_device_api.h"
 #include "../src/runtime/hexagon/hexagon_thread_manager.h"
 
@@ -359,3 +362,42 @@ TEST_F(HexagonThreadManagerTest, threads_for_resource_types) {
   thread = reinterpret_cast<TVMStreamHandle>(6);
   EXPECT_THROW(thread_manager->GetResourceTypeForStreamHandle(thread), InternalError);
 }
+
+struct ParallelSum {
+  std::vector<int> ids;
+  std::atomic<int> barrier_ok{0};
+};
+
+int parallel_sum_task(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  ParallelSum* sum = static_cast<ParallelSum*>(cdata);
+  sum->ids[task_id] = task_id + 1;
+  TVMBackendParallelBarrier(task_id, penv);
+  // after the barrier, the writes of all the tasks are visible
+  int total = 0;
+  for (int i = 0; i < penv->num_task; i++) {
+    total += sum->ids[i];
+  }
+  if (total == penv->num_task * (penv->num_task + 1) / 2) {
+    sum->barrier_ok.fetch_add(1);
+  }
+  return 0;
+}
+
+// Validate parallel launch on the HVX threads of the global manager
+TEST_F(HexagonThreadManagerTest, parallel_launch_hvx) {
+  HexagonThreadManager* thread_manager = HexagonDeviceAPI::Global()->ThreadManager();
+  ParallelSum sum;
+  sum.ids.resize(4);
+  CHECK_EQ(thread_manager->ParallelLaunch(parallel_sum_task, &sum, 0), 0);
+  CHECK_EQ(sum.barrier_ok.load(), 4);
+  EXPECT_THROW(thread_manager->ParallelLaunch(parallel_sum_task, &sum, 5), InternalError);
+}
+
+// Validate parallel launch on a manager without HVX threads runs a single task
+TEST_F(HexagonThreadManagerTest, parallel_launch_no_hvx) {
+  ParallelSum sum;
+  sum.ids.resize(1);
+  CHECK_EQ(htm->ParallelLaunch(parallel_sum_task, &sum, 0), 0);
+  CHECK_EQ(sum.ids[0], 1);
+  CHECK_EQ(sum.barrier_ok.load(), 1);
+}
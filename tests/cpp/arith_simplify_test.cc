@@ -54,6 +54,39 @@ TEST(Simplify, Mod) {
   ICHECK(tvm::tir::is_zero(es));
 }
 
+TEST(Simplify, Memo) {
+  tvm::arith::Analyzer ana;
+  tvm::StructuralEqual checker;
+  auto x = tvm::te::var("x");
+  auto e = tvm::min(x, 10);
+  auto outer = ana.Simplify(e);
+  int64_t hits = ana.simplify_memo_hits;
+  ICHECK(ana.Simplify(e).same_as(outer));
+  ICHECK_EQ(ana.simplify_memo_hits, hits + 1);
+  {
+    tvm::With<tvm::arith::ConstraintContext> ctx(&ana, x < 5);
+    ICHECK(checker(ana.Simplify(e), x));
+  }
+  // The memo of the epoch out of the constraint is used again.
+  hits = ana.simplify_memo_hits;
+  ICHECK(ana.Simplify(e).same_as(outer));
+  ICHECK_EQ(ana.simplify_memo_hits, hits + 1);
+  // A new binding invalidates the memoized results.
+  ana.Bind(x, tvm::Range(0, 3));
+  ICHECK(checker(ana.Simplify(e), x));
+}
+
+TEST(Simplify, DeepExpr) {
+  tvm::arith::Analyzer ana;
+  auto x = tvm::te::var("x");
+  tvm::PrimExpr e = x;
+  // The deep operands are simplified ahead, so that the recursion stays shallow.
+  for (int i = 0; i < 10000; ++i) {
+    e = tvm::tir::Add(e, 1);
+  }
+  ICHECK(tvm::StructuralEqual()(ana.rewrite_simplify(e), x + 10000));
+}
+
 TEST(ConstantFold, Broadcast) {
   tvm::StructuralEqual checker;
   auto i32x4 = tvm::tir::Broadcast(tvm::IntImm(tvm::DataType::Int(32), 10), 4);
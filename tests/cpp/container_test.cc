@@ -22,6 +22,7 @@
 #include <tvm/runtime/container/adt.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
@@ -32,6 +33,7 @@
 #include <iterator>
 #include <new>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -111,6 +113,44 @@ TEST(ADT, Constructor) {
   ASSERT_EQ(Downcast<ADT>(v1[1]).size(), 0);
 }
 
+TEST(ADT, SmallObjAllocatorAcrossThreads) {
+  // The tuples made by a thread and released by another go back to the heap or to the free lists
+  // of the releasing thread.
+  std::vector<ADT> tuples;
+  std::thread maker([&tuples]() {
+    for (int i = 0; i < 1000; ++i) {
+      std::vector<ObjectRef> fields(i % 40, ShapeTuple({i, i + 1}));
+      tuples.push_back(ADT(i, fields));
+    }
+  });
+  maker.join();
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(tuples[i].tag(), i);
+    ASSERT_EQ(tuples[i].size(), i % 40);
+    if (i % 40 != 0) {
+      ASSERT_EQ(Downcast<ShapeTuple>(tuples[i][0])[1], i + 1);
+    }
+  }
+  tuples.clear();
+  ADT tuple = ADT::Tuple(std::vector<ObjectRef>{ShapeTuple({1, 2, 3})});
+  ASSERT_EQ(Downcast<ShapeTuple>(tuple[0]).size(), 3);
+}
+
+TEST(ShapeTuple, InlineStorage) {
+  std::vector<int64_t> dims{2, 3, 4};
+  ShapeTuple reversed(dims.rbegin(), dims.rend());
+  ASSERT_EQ(reversed.size(), 3);
+  ASSERT_EQ(reversed[0], 4);
+  ASSERT_EQ(reversed[2], 2);
+  ShapeTuple squares = ShapeTuple::Make(4, [](int64_t* data) {
+    for (int64_t i = 0; i < 4; ++i) data[i] = i * i;
+  });
+  ASSERT_EQ(squares.size(), 4);
+  ASSERT_EQ(squares.back(), 9);
+  ASSERT_TRUE(ShapeTuple().empty());
+  ASSERT_EQ(ShapeTuple(dims)[1], 3);
+}
+
 TEST(InplaceArrayBase, BadExceptionSafety) {
   auto wrong_init = []() {
     TestErrorSwitch f1{false};
@@ -24,6 +24,8 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/transform.h>
 
+#include "../src/runtime/library_module.h"
+
 TEST(PackedFunc, Basic) {
   using namespace tvm;
   using namespace tvm::tir;
@@ -307,3 +309,22 @@ TEST(TypedPackedFunc, RValue) {
     tf(1, true);
   }
 }
+
+namespace {
+int AddOne(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_value, int* ret_type_code,
+           void*) {
+  ret_value->v_int64 = args[0].v_int64 + 1;
+  *ret_type_code = kTVMArgInt;
+  return 0;
+}
+}  // namespace
+
+TEST(PackedFunc, WrappedPackedCFunc) {
+  using namespace tvm::runtime;
+  PackedFunc wrapped = WrapPackedFunc(AddOne, nullptr);
+  int64_t res = wrapped(41);
+  ICHECK_EQ(res, 42);
+  ICHECK(GetWrappedPackedCFunc(wrapped) == AddOne);
+  ICHECK(GetWrappedPackedCFunc(PackedFunc([](TVMArgs args, TVMRetValue* rv) {})) == nullptr);
+  ICHECK(GetWrappedPackedCFunc(PackedFunc(nullptr)) == nullptr);
+}
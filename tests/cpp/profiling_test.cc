@@ -22,6 +22,7 @@
 
 #include <chrono>
 #include <thread>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
@@ -37,5 +38,42 @@ TEST(DefaultTimer, Basic) {
   int64_t elapsed = t->SyncAndGetElapsedNanos();
   CHECK_GT(elapsed, 9 * 1e6);
 }
+
+TEST(LatencyHistogram, Percentile) {
+  profiling::LatencyHistogram histogram;
+  EXPECT_EQ(histogram.PercentileNanos(0.5), 0);
+  for (int64_t i = 1; i <= 1000; ++i) {
+    histogram.Record(i * 1000);
+  }
+  EXPECT_EQ(histogram.Count(), 1000);
+  EXPECT_EQ(histogram.MaxNanos(), 1000000);
+  EXPECT_DOUBLE_EQ(histogram.MeanNanos(), 500500.0);
+  // The percentiles are the upper bounds of their buckets, at most 25% above the true ones.
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    double exact = quantile * 1000000;
+    EXPECT_GE(histogram.PercentileNanos(quantile), exact);
+    EXPECT_LE(histogram.PercentileNanos(quantile), exact * 1.25);
+  }
+  EXPECT_EQ(histogram.PercentileNanos(1.0), 1000000);
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0);
+}
+
+TEST(LatencyHistogram, Concurrent) {
+  profiling::LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&histogram, t]() {
+      for (int i = 0; i < 10000; ++i) {
+        histogram.Record(t * 10000 + i);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(histogram.Count(), 40000);
+  EXPECT_EQ(histogram.MaxNanos(), 39999);
+}
 }  // namespace runtime
 }  // namespace tvm
@@ -0,0 +1,300 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relax_vm_dispatch_bench_test.cc
+ * \brief Micro-benchmarks of the dispatch overhead of the relax VM interpreter.
+ *
+ * Each scenario runs a straight-line function of kNumOps instructions of one kind, the calls
+ * of no-op packed functions, the tuple, shape and closure instructions, and the branches. The
+ * time of an invocation of an empty function is subtracted to get the cost per instruction.
+ * The number of iterations is read from TVM_RELAX_VM_BENCH_ITERS, small by default so that
+ * the scenarios also run as tests.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/relax/exec_builder.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/executable.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/*! \brief The number of heap allocations of the process. */
+std::atomic<uint64_t> num_heap_allocs{0};
+
+}  // namespace
+
+// Count the allocations made through the global operator new, the memory pools of the runtime
+// are only counted when they grow.
+void* operator new(std::size_t size) {
+  num_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+using namespace tvm;
+using namespace tvm::runtime;
+using namespace tvm::runtime::relax_vm;
+using tvm::relax::ExecBuilder;
+using tvm::relax::ExecBuilderNode;
+
+/*! \brief The number of instructions of a scenario. */
+constexpr int kNumOps = 256;
+
+TVM_REGISTER_GLOBAL("test.relax_vm_bench.identity").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = args[0];
+});
+
+/*! \brief The CPU cycles of the thread, -1 when the hardware counters are not available. */
+class CycleCounter {
+ public:
+  CycleCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~CycleCounter() {
+#ifdef __linux__
+    if (fd_ >= 0) close(fd_);
+#endif
+  }
+
+  void Start() {
+#ifdef __linux__
+    if (fd_ < 0) return;
+    ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  int64_t Stop() {
+#ifdef __linux__
+    if (fd_ < 0) return -1;
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    int64_t cycles = 0;
+    if (read(fd_, &cycles, sizeof(cycles)) != sizeof(cycles)) return -1;
+    return cycles;
+#else
+    return -1;
+#endif
+  }
+
+ private:
+  int fd_{-1};
+};
+
+/*! \brief The cost of an invocation of a function. */
+struct InvokeCost {
+  double ns;
+  double allocs;
+  double cycles;
+};
+
+int NumIterations() {
+  const char* iters = std::getenv("TVM_RELAX_VM_BENCH_ITERS");
+  return iters != nullptr ? std::max(std::atoi(iters), 1) : 200;
+}
+
+ObjectPtr<VirtualMachine> MakeVM(ObjectPtr<Executable> exec) {
+  auto vm = make_object<VirtualMachine>();
+  vm->LoadExecutable(exec);
+  vm->Init({Device{kDLCPU, 0}}, {AllocatorType::kPooled});
+  return vm;
+}
+
+InvokeCost MeasureInvoke(const PackedFunc& func, const std::vector<TVMRetValue>& args,
+                         TVMRetValue* result) {
+  std::vector<TVMValue> values(args.size());
+  std::vector<int> type_codes(args.size());
+  TVMArgsSetter setter(values.data(), type_codes.data());
+  for (size_t i = 0; i < args.size(); ++i) {
+    setter(i, args[i]);
+  }
+  TVMArgs targs(values.data(), type_codes.data(), static_cast<int>(args.size()));
+  // Warm up the frames, the register files and the pools.
+  for (int i = 0; i < 8; ++i) {
+    func.CallPacked(targs, result);
+  }
+  int iters = NumIterations();
+  CycleCounter counter;
+  uint64_t allocs_begin = num_heap_allocs.load(std::memory_order_relaxed);
+  counter.Start();
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iters; ++i) {
+    func.CallPacked(targs, result);
+  }
+  auto end = std::chrono::steady_clock::now();
+  int64_t cycles = counter.Stop();
+  uint64_t allocs = num_heap_allocs.load(std::memory_order_relaxed) - allocs_begin;
+  InvokeCost cost;
+  cost.ns = std::chrono::duration<double, std::nano>(end - begin).count() / iters;
+  cost.allocs = static_cast<double>(allocs) / iters;
+  cost.cycles = cycles < 0 ? -1 : static_cast<double>(cycles) / iters;
+  return cost;
+}
+
+/*!
+ * \brief Run a scenario and report its cost.
+ * \param name The name of the scenario.
+ * \param vm The VM of the executable, whose "main" runs kNumOps instructions and "empty" none,
+ *  with the same parameters.
+ * \param args The arguments of the functions.
+ * \return The result of main.
+ */
+TVMRetValue RunScenario(const std::string& name, const ObjectPtr<VirtualMachine>& vm,
+                        const std::vector<TVMRetValue>& args) {
+  TVMRetValue result;
+  InvokeCost base = MeasureInvoke(vm->GetFunction("empty", vm), args, &result);
+  InvokeCost cost = MeasureInvoke(vm->GetFunction("main", vm), args, &result);
+  double ns_per_op = std::max(cost.ns - base.ns, 0.0) / kNumOps;
+  double cycles_per_op =
+      cost.cycles < 0 || base.cycles < 0 ? -1 : std::max(cost.cycles - base.cycles, 0.0) / kNumOps;
+  std::cout << "[relax_vm_bench] " << std::left << std::setw(14) << name << std::right
+            << std::fixed << std::setprecision(2) << " invoke " << std::setw(9) << base.ns
+            << " ns, " << std::setw(7) << ns_per_op << " ns/instr, " << std::setw(7)
+            << cycles_per_op << " cycles/instr, " << std::setw(7) << cost.allocs
+            << " allocs/invoke" << std::endl;
+  EXPECT_GE(cost.allocs, 0);
+  return result;
+}
+
+template <typename... Args>
+std::vector<TVMRetValue> MakeArgs(Args&&... values) {
+  std::vector<TVMRetValue> args;
+  ((args.emplace_back(), args.back() = std::forward<Args>(values)), ...);
+  return args;
+}
+
+void EmitEmpty(const ExecBuilder& builder, int64_t num_inputs) {
+  builder->EmitFunction("empty", num_inputs, {});
+  builder->EmitRet(0);
+}
+
+NDArray MakeTensor() { return NDArray::Empty({2, 3}, DataType::Float(32), Device{kDLCPU, 0}); }
+
+}  // namespace
+
+TEST(RelaxVMDispatchBench, Call) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  EmitEmpty(builder, 1);
+  builder->EmitFunction("main", 1, {});
+  for (int i = 0; i < kNumOps; ++i) {
+    builder->EmitCall("test.relax_vm_bench.identity", {Instruction::Arg(Instruction::kRegister, 0)},
+                      1);
+  }
+  builder->EmitRet(1);
+  NDArray x = MakeTensor();
+  TVMRetValue result = RunScenario("call", MakeVM(builder->Get()), MakeArgs(x));
+  EXPECT_TRUE(result.operator NDArray().same_as(x));
+}
+
+TEST(RelaxVMDispatchBench, Tuple) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  EmitEmpty(builder, 1);
+  builder->EmitFunction("main", 1, {});
+  for (int i = 0; i < kNumOps / 2; ++i) {
+    builder->EmitTuple(
+        {Instruction::Arg(Instruction::kRegister, 0), Instruction::Arg(Instruction::kRegister, 0)},
+        1);
+    builder->EmitTupleGetItem(1, 1, 2);
+  }
+  builder->EmitRet(2);
+  NDArray x = MakeTensor();
+  TVMRetValue result = RunScenario("tuple", MakeVM(builder->Get()), MakeArgs(x));
+  EXPECT_TRUE(result.operator NDArray().same_as(x));
+}
+
+TEST(RelaxVMDispatchBench, ShapeOf) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  EmitEmpty(builder, 1);
+  builder->EmitFunction("main", 1, {});
+  for (int i = 0; i < kNumOps; ++i) {
+    builder->EmitShapeOf(0, 1);
+  }
+  builder->EmitRet(1);
+  TVMRetValue result = RunScenario("shape_of", MakeVM(builder->Get()), MakeArgs(MakeTensor()));
+  ShapeTuple shape = Downcast<ShapeTuple>(result.operator ObjectRef());
+  EXPECT_EQ(shape, ShapeTuple({2, 3}));
+}
+
+TEST(RelaxVMDispatchBench, InvokeClosure) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  EmitEmpty(builder, 2);
+  builder->EmitFunction("identity", 1, {});
+  builder->EmitRet(0);
+  builder->EmitFunction("main", 2, {});
+  // Each invocation runs the Ret of the callee too.
+  for (int i = 0; i < kNumOps / 2; ++i) {
+    builder->EmitInvokeClosure(1, {Instruction::Arg(Instruction::kRegister, 0)}, 2);
+  }
+  builder->EmitRet(2);
+  NDArray x = MakeTensor();
+  TVMRetValue result = RunScenario("invoke_closure", MakeVM(builder->Get()),
+                                   MakeArgs(x, VMClosure("identity", {})));
+  EXPECT_TRUE(result.operator NDArray().same_as(x));
+}
+
+TEST(RelaxVMDispatchBench, ControlFlow) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  EmitEmpty(builder, 2);
+  builder->EmitFunction("main", 2, {});
+  // Both targets of the branches are the next instruction.
+  for (int i = 0; i < kNumOps / 2; ++i) {
+    builder->EmitIf(1, 1);
+    builder->EmitGoto(1);
+  }
+  builder->EmitRet(0);
+  NDArray x = MakeTensor();
+  TVMRetValue result =
+      RunScenario("control_flow", MakeVM(builder->Get()), MakeArgs(x, static_cast<int64_t>(1)));
+  EXPECT_TRUE(result.operator NDArray().same_as(x));
+}
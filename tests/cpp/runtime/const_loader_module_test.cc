@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <dmlc/memory_io.h>
+#include <gtest/gtest.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../src/runtime/const_loader_module.h"
+#include "../../../src/runtime/library_module.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+/*! \brief A submodule recording the constants it is initialized with. */
+class RecordingModuleNode : public ModuleNode {
+ public:
+  const char* type_key() const final { return "test_recording"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "__init_subgraph") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        consts = args[0];
+        ++num_inits;
+        *rv = 0;
+      });
+    } else if (name == "subgraph") {
+      return PackedFunc([sptr_to_self](TVMArgs args, TVMRetValue* rv) {});
+    }
+    return PackedFunc(nullptr);
+  }
+
+  Array<NDArray> consts;
+  int num_inits = 0;
+};
+
+NDArray MakeConst(float value) {
+  NDArray arr = NDArray::Empty({4}, DataType::Float(32), {kDLCPU, 0});
+  for (int i = 0; i < 4; ++i) {
+    static_cast<float*>(arr->data)[i] = value;
+  }
+  return arr;
+}
+
+/*! \brief Run the subgraph under a const-loader module and get the constants it is given. */
+Array<NDArray> InitSubgraph(Module const_loader) {
+  auto recording = make_object<RecordingModuleNode>();
+  const_loader.Import(Module(recording));
+  PackedFunc subgraph = const_loader.GetFunction("subgraph");
+  EXPECT_EQ(recording->num_inits, 0);
+  subgraph();
+  subgraph();
+  EXPECT_EQ(recording->num_inits, 1);
+  return recording->consts;
+}
+
+TEST(ConstLoaderModule, SharedConstants) {
+  std::unordered_map<std::string, NDArray> const_var_ndarray = {
+      {"w0", MakeConst(1.0f)}, {"w1", MakeConst(1.0f)}, {"w2", MakeConst(2.0f)}};
+  std::unordered_map<std::string, std::vector<std::string>> const_vars_by_symbol = {
+      {"subgraph", {"w0", "w1", "w2"}}};
+  Module const_loader = ConstLoaderModuleCreate(const_var_ndarray, const_vars_by_symbol);
+  Array<NDArray> consts = InitSubgraph(const_loader);
+  ASSERT_EQ(consts.size(), 3);
+  EXPECT_TRUE(consts[0].same_as(consts[1]));
+  EXPECT_FALSE(consts[0].same_as(consts[2]));
+
+  // The shared array is saved once, and shared again when loaded.
+  std::string blob;
+  dmlc::MemoryStringStream stream(&blob);
+  const_loader->SaveToBinary(&stream);
+  stream.Seek(0);
+  const PackedFunc* load = Registry::Get("runtime.module.loadbinary_const_loader");
+  ASSERT_NE(load, nullptr);
+  Module loaded = (*load)(static_cast<void*>(&stream));
+  Array<NDArray> loaded_consts = InitSubgraph(loaded);
+  ASSERT_EQ(loaded_consts.size(), 3);
+  EXPECT_TRUE(loaded_consts[0].same_as(loaded_consts[1]));
+  EXPECT_FALSE(loaded_consts[0].same_as(loaded_consts[2]));
+  EXPECT_EQ(static_cast<float*>(loaded_consts[2]->data)[3], 2.0f);
+}
+
+TEST(ConstLoaderModule, AlignedConstantsInPlace) {
+  std::unordered_map<std::string, NDArray> const_var_ndarray = {
+      {"w0", MakeConst(1.0f)}, {"w1", MakeConst(3.0f)}};
+  std::unordered_map<std::string, std::vector<std::string>> const_vars_by_symbol = {
+      {"subgraph", {"w0", "w1"}}};
+  Module const_loader = ConstLoaderModuleCreate(const_var_ndarray, const_vars_by_symbol);
+  const PackedFunc* set_const_alignment = Registry::Get("runtime.ModuleSetConstAlignment");
+  ASSERT_NE(set_const_alignment, nullptr);
+  (*set_const_alignment)(const_loader, 256);
+  std::string blob;
+  dmlc::MemoryStringStream out(&blob);
+  const_loader->SaveToBinary(&out);
+
+  // Lay the stream out as in a module blob, after the header and at an aligned address.
+  constexpr size_t kAlignment = 4096;
+  std::vector<char> buffer(blob.size() + kModuleBlobHeaderBytes + kAlignment);
+  uintptr_t misalignment = reinterpret_cast<uintptr_t>(buffer.data()) % kAlignment;
+  char* base = buffer.data() + (kAlignment - misalignment);
+  char* data = base + kModuleBlobHeaderBytes;
+  std::memcpy(data, blob.data(), blob.size());
+  dmlc::MemoryFixedSizeStream in(data, blob.size());
+  ModuleBlobContext* context = ModuleBlobContext::ThreadLocal();
+  context->stream = &in;
+  context->data = data;
+  const PackedFunc* load = Registry::Get("runtime.module.loadbinary_const_loader");
+  Module loaded = (*load)(static_cast<void*>(&in));
+  *context = ModuleBlobContext();
+
+  Array<NDArray> consts = InitSubgraph(loaded);
+  ASSERT_EQ(consts.size(), 2);
+  for (const NDArray& arr : consts) {
+    const char* arr_data = static_cast<const char*>(arr->data);
+    EXPECT_GE(arr_data, data);
+    EXPECT_LT(arr_data, data + blob.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arr_data) % 256, 0u);
+  }
+  EXPECT_EQ(static_cast<float*>(consts[1]->data)[0], 3.0f);
+
+  // Out of a module blob, the constants are copied.
+  dmlc::MemoryStringStream copy_in(&blob);
+  Array<NDArray> copied = InitSubgraph((*load)(static_cast<void*>(&copy_in)));
+  ASSERT_EQ(copied.size(), 2);
+  EXPECT_EQ(static_cast<float*>(copied[0]->data)[0], 1.0f);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
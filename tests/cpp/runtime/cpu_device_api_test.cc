@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+void CheckLargeAllocation() {
+  // Larger than a huge page, and not a multiple of it
+  int64_t num_elements = (3 << 20) + 7;
+  NDArray array = NDArray::Empty({num_elements}, DataType::Int(32), {kDLCPU, 0});
+  int32_t* data = static_cast<int32_t*>(array->data);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % kAllocAlignment, 0u);
+  for (int64_t i = 0; i < num_elements; ++i) {
+    data[i] = static_cast<int32_t>(i);
+  }
+  NDArray copy = array.CopyTo({kDLCPU, 0});
+  const int32_t* copy_data = static_cast<const int32_t*>(copy->data);
+  EXPECT_EQ(copy_data[0], 0);
+  EXPECT_EQ(copy_data[num_elements - 1], num_elements - 1);
+}
+
+TEST(CPUDeviceAPI, AllocMode) {
+  const PackedFunc* set_alloc_mode = Registry::Get("device_api.cpu.set_alloc_mode");
+  ASSERT_NE(set_alloc_mode, nullptr);
+  std::vector<std::string> huge_pages = {"none", "transparent", "explicit"};
+  std::vector<std::string> numa_policies = {"none", "local", "interleave"};
+  for (const std::string& huge_page : huge_pages) {
+    for (const std::string& numa_policy : numa_policies) {
+      (*set_alloc_mode)(huge_page, numa_policy);
+      CheckLargeAllocation();
+    }
+  }
+  (*set_alloc_mode)("none", "none");
+}
+
+TEST(CPUDeviceAPI, InvalidAllocMode) {
+  const PackedFunc* set_alloc_mode = Registry::Get("device_api.cpu.set_alloc_mode");
+  ASSERT_NE(set_alloc_mode, nullptr);
+  EXPECT_THROW((*set_alloc_mode)("huge", "none"), Error);
+  EXPECT_THROW((*set_alloc_mode)("none", "remote"), Error);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "../../../src/runtime/workspace_pool.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+/*! \brief A device API on the host recording the allocations and the stream synchronizations. */
+class RecordingDeviceAPI : public DeviceAPI {
+ public:
+  void SetDevice(Device dev) final {}
+  void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final {}
+  void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    ++num_allocs;
+    return std::malloc(nbytes);
+  }
+  void FreeDataSpace(Device dev, void* ptr) final { std::free(ptr); }
+  void StreamSync(Device dev, TVMStreamHandle stream) final { ++num_stream_syncs; }
+  void SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst) final {
+    stream_waits.emplace_back(event_src, event_dst);
+  }
+
+  int num_allocs = 0;
+  int num_stream_syncs = 0;
+  std::vector<std::pair<TVMStreamHandle, TVMStreamHandle>> stream_waits;
+};
+
+TVMStreamHandle Stream(intptr_t id) { return reinterpret_cast<TVMStreamHandle>(id); }
+
+TEST(WorkspacePool, StreamOrderedReuse) {
+  RecordingDeviceAPI device_api;
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, &device_api);
+  void* a = pool.AllocWorkspace(dev, 1024, Stream(1));
+  void* b = pool.AllocWorkspace(dev, 1024, Stream(2));
+  // Freed out of order, each on its own stream.
+  pool.FreeWorkspace(dev, a, Stream(1));
+  pool.FreeWorkspace(dev, b, Stream(2));
+  // Each stream reuses the entry it last used, without any synchronization.
+  EXPECT_EQ(pool.AllocWorkspace(dev, 1024, Stream(2)), b);
+  EXPECT_EQ(pool.AllocWorkspace(dev, 1024, Stream(1)), a);
+  EXPECT_TRUE(device_api.stream_waits.empty());
+  pool.FreeWorkspace(dev, a, Stream(1));
+  pool.FreeWorkspace(dev, b, Stream(2));
+
+  // Another stream waits for the last use of the entry it reuses, on the device.
+  void* c = pool.AllocWorkspace(dev, 1024, Stream(3));
+  EXPECT_TRUE(c == a || c == b);
+  ASSERT_EQ(device_api.stream_waits.size(), 1U);
+  EXPECT_EQ(device_api.stream_waits[0].first, c == a ? Stream(1) : Stream(2));
+  EXPECT_EQ(device_api.stream_waits[0].second, Stream(3));
+  pool.FreeWorkspace(dev, c, Stream(3));
+  EXPECT_EQ(device_api.num_allocs, 2);
+  EXPECT_EQ(device_api.num_stream_syncs, 0);
+}
+
+TEST(WorkspacePool, SmallestFit) {
+  RecordingDeviceAPI device_api;
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, &device_api);
+  void* small = pool.AllocWorkspace(dev, 4096);
+  void* large = pool.AllocWorkspace(dev, 4 * 4096);
+  pool.FreeWorkspace(dev, small);
+  pool.FreeWorkspace(dev, large);
+  EXPECT_EQ(pool.AllocWorkspace(dev, 2 * 4096), large);
+  EXPECT_EQ(pool.AllocWorkspace(dev, 100), small);
+  EXPECT_EQ(device_api.num_allocs, 2);
+  pool.FreeWorkspace(dev, small);
+  pool.FreeWorkspace(dev, large);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
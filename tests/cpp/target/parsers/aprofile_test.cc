@@ -82,6 +82,7 @@ TEST(AProfileParser, ParseTargetDefaults) {
   ASSERT_EQ(Downcast<Bool>(features.at("has_asimd")), false);
   ASSERT_EQ(Downcast<Bool>(features.at("has_dotprod")), false);
   ASSERT_EQ(Downcast<Bool>(features.at("has_matmul_i8")), false);
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), false);
 }
 
 TEST(AProfileParser, IsAArch64Triple) {
@@ -281,6 +282,34 @@ TEST_P(AProfileOptionalDotProd, OptionalDotProdSupport) {
   ASSERT_EQ(Downcast<Bool>(features.at("has_dotprod")), true);
 }
 
+TEST(AProfileParser, NoSVESupport) {
+  TargetJSON target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {"+v8.0a", "+sve"});
+  TargetFeatures features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), false);
+
+  target = ParseTargetWithAttrs("", "armv8a-arm-none-eabi", {"+v9a"});
+  features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), false);
+}
+
+TEST(AProfileParser, SVESupport) {
+  TargetJSON target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {"+v8.2a"});
+  TargetFeatures features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), false);
+
+  target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {"+v8.2a", "+sve"});
+  features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), true);
+
+  target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {"+v9a"});
+  features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), true);
+
+  target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {"+v9a", "+nosve"});
+  features = Downcast<TargetFeatures>(target.at("features"));
+  ASSERT_EQ(Downcast<Bool>(features.at("has_sve")), false);
+}
+
 TEST(AProfileParser, ArchVersionInvalidLetter) {
   std::string arch_attr = "+v" + std::to_string(defaultDotProd) + "b";
   TargetJSON target = ParseTargetWithAttrs("", "aarch64-arm-none-eabi", {arch_attr});
@@ -185,3 +185,71 @@ TEST(ThreadingBackend, TVMBackendAffinityConfigure) {
     t->join();
   }
 }
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  // The thread pool is selected per launching thread
+  std::thread t([]() {
+    tvm::runtime::threading::SetWorkStealing(true);
+    for (int j = 0; j < 3; ++j) {
+      std::atomic<size_t> acc(0);
+      TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+    // Each task launches an inner parallel loop, which used to be rejected
+    std::atomic<size_t> acc(0);
+    std::atomic<int> num_outer_tasks(0);
+    std::pair<std::atomic<size_t>*, std::atomic<int>*> cdata(&acc, &num_outer_tasks);
+    auto nested_task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+      auto* data = reinterpret_cast<std::pair<std::atomic<size_t>*, std::atomic<int>*>*>(cdata);
+      data->second->fetch_add(1);
+      return TVMBackendParallelLaunch(atomic_add_task_id, data->first, 0);
+    };
+    EXPECT_EQ(TVMBackendParallelLaunch(nested_task, &cdata, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), num_outer_tasks.load() * N * (N - 1) / 2);
+    tvm::runtime::threading::SetWorkStealing(false);
+  });
+  t.join();
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealingNestedOnWorkers) {
+  // The nested launches from the workers go to the same work-stealing pool, whichever thread
+  // runs the outer task
+  std::thread t([]() {
+    tvm::runtime::threading::SetWorkStealing(true);
+    struct NestedData {
+      std::atomic<size_t> acc{0};
+      std::atomic<int> num_outer_tasks{0};
+      std::atomic<int> num_classic_launches{0};
+    } data;
+    auto nested_task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+      auto* data = reinterpret_cast<NestedData*>(cdata);
+      data->num_outer_tasks.fetch_add(1);
+      if (!tvm::runtime::threading::IsWorkStealing()) {
+        data->num_classic_launches.fetch_add(1);
+      }
+      return TVMBackendParallelLaunch(atomic_add_task_id, &data->acc, 0);
+    };
+    for (int j = 0; j < 3; ++j) {
+      data.acc = 0;
+      data.num_outer_tasks = 0;
+      EXPECT_EQ(TVMBackendParallelLaunch(nested_task, &data, 0), 0);
+      EXPECT_EQ(data.acc.load(), data.num_outer_tasks.load() * N * (N - 1) / 2);
+    }
+    EXPECT_EQ(data.num_classic_launches.load(), 0);
+    tvm::runtime::threading::SetWorkStealing(false);
+  });
+  t.join();
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchAfterIdle) {
+  // The workers park while idle between the launches, and spin again after a warm up
+  for (int j = 0; j < 4; ++j) {
+    if (j % 2 == 1) {
+      tvm::runtime::threading::WarmUpThreadPool(10000);
+    }
+    std::atomic<size_t> acc(0);
+    TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+}
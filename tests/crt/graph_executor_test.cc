@@ -112,4 +112,56 @@ TEST(TVMGraphExecutor_Load, Parse) {
   EXPECT_EQ(executor.nodes_count, 3);
 }
 
+// The execution plan of kJson.
+const TVMGraphExecutorPlanOp kPlanOps[] = {{"tvmgen_default_fused_add", 0, 3, 0}};
+const uint32_t kPlanArgs[] = {0, 1, 2};
+const TVMGraphExecutorPlanEntry kPlanEntries[] = {
+    {0, 0, 2, {kDLFloat, 32, 1}}, {1, 2, 2, {kDLFloat, 32, 1}}, {2, 4, 2, {kDLFloat, 32, 1}}};
+const int64_t kPlanShapes[] = {10, 5, 1, 5, 10, 5};
+const uint32_t kPlanStorageSizes[] = {200, 20, 200};
+const char* const kPlanInputNames[] = {"x", "p0"};
+const uint32_t kPlanInputEntries[] = {0, 1};
+const uint32_t kPlanOutputEntries[] = {2};
+
+TVMGraphExecutorPlan MakePlan() {
+  TVMGraphExecutorPlan plan;
+  plan.ops = kPlanOps;
+  plan.ops_count = 1;
+  plan.args = kPlanArgs;
+  plan.args_count = 3;
+  plan.entries = kPlanEntries;
+  plan.entries_count = 3;
+  plan.shapes = kPlanShapes;
+  plan.storage_sizes = kPlanStorageSizes;
+  plan.storage_count = 3;
+  plan.input_names = kPlanInputNames;
+  plan.input_entries = kPlanInputEntries;
+  plan.inputs_count = 2;
+  plan.output_entries = kPlanOutputEntries;
+  plan.outputs_count = 1;
+  return plan;
+}
+
+// Check a precomputed plan can be loaded without parsing any JSON.
+TEST(TVMGraphExecutor_LoadPlan, Valid) {
+  TVMGraphExecutorPlan plan = MakePlan();
+  TVMGraphExecutor executor;
+  memset(&executor, 0, sizeof(executor));
+  EXPECT_EQ(TVMGraphExecutor_LoadPlan(&executor, &plan), 0);
+  EXPECT_EQ(TVMGraphExecutor_GetNumInputs(&executor), 2);
+  EXPECT_EQ(TVMGraphExecutor_GetInputIndex(&executor, "p0"), 1);
+  EXPECT_EQ(TVMGraphExecutor_GetNumOutputs(&executor), 1);
+}
+
+// Check a plan referring to an entry out of bounds is rejected.
+TEST(TVMGraphExecutor_LoadPlan, OutOfBounds) {
+  const uint32_t args[] = {0, 1, 3};
+  TVMGraphExecutorPlan plan = MakePlan();
+  plan.args = args;
+  TVMGraphExecutor executor;
+  memset(&executor, 0, sizeof(executor));
+  EXPECT_NE(TVMGraphExecutor_LoadPlan(&executor, &plan), 0);
+  EXPECT_EQ(executor.plan, nullptr);
+}
+
 }  // namespace
@@ -0,0 +1,154 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include <vector>
+
+#include "crt_config.h"
+
+static constexpr const size_t kMemoryPoolSizeBytes = 32 * 1024;
+
+class TLSFAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(memory_pool, 0, sizeof(memory_pool));
+    ASSERT_EQ(TLSFMemoryManagerCreate(&interface, memory_pool, kMemoryPoolSizeBytes),
+              kTvmErrorNoError);
+    dev_ = {kDLCPU, 0};
+  }
+
+  TLSFMemoryManagerStats Stats() {
+    TLSFMemoryManagerStats stats;
+    EXPECT_EQ(TLSFMemoryManagerGetStats(interface, &stats), kTvmErrorNoError);
+    return stats;
+  }
+
+  uint8_t memory_pool[kMemoryPoolSizeBytes];
+  MemoryManagerInterface* interface;
+  DLDevice dev_;
+};
+
+TEST(TLSFMappingTest, SizeClasses) {
+  int fl, sl;
+  TLSFMapping(TLSF_ALIGNMENT_BYTES, &fl, &sl);
+  EXPECT_EQ(fl, 0);
+  EXPECT_EQ(sl, 1);
+  TLSFMapping((1 << TLSF_SMALL_BLOCK_LOG2) - TLSF_ALIGNMENT_BYTES, &fl, &sl);
+  EXPECT_EQ(fl, 0);
+  EXPECT_EQ(sl, TLSF_SL_INDEX_COUNT - 1);
+  TLSFMapping(1 << TLSF_SMALL_BLOCK_LOG2, &fl, &sl);
+  EXPECT_EQ(fl, 1);
+  EXPECT_EQ(sl, 0);
+  // the last second-level class of a power of two
+  TLSFMapping((2 << TLSF_SMALL_BLOCK_LOG2) - TLSF_ALIGNMENT_BYTES, &fl, &sl);
+  EXPECT_EQ(fl, 1);
+  EXPECT_EQ(sl, TLSF_SL_INDEX_COUNT - 1);
+  TLSFMapping(size_t(1) << TVM_CRT_TLSF_FL_INDEX_MAX, &fl, &sl);
+  EXPECT_EQ(fl, TLSF_FL_INDEX_COUNT - 1);
+}
+
+TEST_F(TLSFAllocatorTest, AllocFree) {
+  EXPECT_EQ(interface->vleak_size, 0);
+  size_t pool_bytes = Stats().pool_bytes;
+  EXPECT_GT(pool_bytes, kMemoryPoolSizeBytes - sizeof(TLSFMemoryManager) - 64);
+
+  void* a;
+  void* b;
+  ASSERT_EQ(interface->Allocate(interface, 1, dev_, &a), kTvmErrorNoError);
+  ASSERT_EQ(interface->Allocate(interface, 100, dev_, &b), kTvmErrorNoError);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES, 0);
+  EXPECT_GE(reinterpret_cast<uint8_t*>(b), reinterpret_cast<uint8_t*>(a) + TLSF_ALIGNMENT_BYTES);
+  EXPECT_EQ(interface->vleak_size, 2);
+
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, b, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->vleak_size, 0);
+  // the freed blocks are merged back into one
+  TLSFMemoryManagerStats stats = Stats();
+  EXPECT_EQ(stats.used_bytes, 0);
+  EXPECT_EQ(stats.largest_free_bytes + TLSF_HEADER_BYTES, stats.pool_bytes);
+}
+
+TEST_F(TLSFAllocatorTest, BadFree) {
+  void* a;
+  ASSERT_EQ(interface->Allocate(interface, 64, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, static_cast<uint8_t*>(a) + 1, dev_),
+            kTvmErrorPlatformBadFree);
+  EXPECT_EQ(interface->Free(interface, memory_pool, dev_), kTvmErrorPlatformBadFree);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  // double free
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorPlatformBadFree);
+}
+
+TEST_F(TLSFAllocatorTest, OutOfMemory) {
+  void* a;
+  EXPECT_EQ(interface->Allocate(interface, kMemoryPoolSizeBytes, dev_, &a),
+            kTvmErrorPlatformNoMemory);
+  EXPECT_EQ(a, nullptr);
+  EXPECT_EQ(interface->vleak_size, 0);
+}
+
+TEST_F(TLSFAllocatorTest, PeakUsage) {
+  void* a;
+  void* b;
+  ASSERT_EQ(interface->Allocate(interface, 1024, dev_, &a), kTvmErrorNoError);
+  ASSERT_EQ(interface->Allocate(interface, 2048, dev_, &b), kTvmErrorNoError);
+  size_t peak = Stats().used_bytes;
+  EXPECT_GE(peak, 3072);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, b, dev_), kTvmErrorNoError);
+  ASSERT_EQ(interface->Allocate(interface, 16, dev_, &a), kTvmErrorNoError);
+  TLSFMemoryManagerStats stats = Stats();
+  EXPECT_LT(stats.used_bytes, peak);
+  EXPECT_EQ(stats.peak_used_bytes, peak);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+}
+
+// Interleaved allocations and frees in any order do not fragment the pool for good.
+TEST_F(TLSFAllocatorTest, NoFragmentation) {
+  size_t full = Stats().largest_free_bytes;
+  for (int round = 0; round < 4; round++) {
+    std::vector<void*> ptrs;
+    for (int i = 0;; i++) {
+      void* a;
+      if (interface->Allocate(interface, 48 + (i * 37 + round * 11) % 700, dev_, &a) !=
+          kTvmErrorNoError) {
+        break;
+      }
+      ptrs.push_back(a);
+    }
+    ASSERT_GT(ptrs.size(), 20);
+    // free every other block, then the rest
+    for (size_t i = 0; i < ptrs.size(); i += 2) {
+      EXPECT_EQ(interface->Free(interface, ptrs[i], dev_), kTvmErrorNoError);
+    }
+    for (size_t i = 1; i < ptrs.size(); i += 2) {
+      EXPECT_EQ(interface->Free(interface, ptrs[i], dev_), kTvmErrorNoError);
+    }
+    EXPECT_EQ(interface->vleak_size, 0);
+    EXPECT_EQ(Stats().largest_free_bytes, full);
+  }
+  void* a;
+  ASSERT_EQ(interface->Allocate(interface, full / 2, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+}
@@ -143,6 +143,30 @@ def verify_batch_matmul(Ashape, Bshape, Cshape, in_dtype, out_dtype, rtol=1e-5):
     )
 
 
+def verify_grouped_matmul(offsets, num_groups, k, n, transb, in_dtype, out_dtype, rtol=1e-5):
+    m = offsets[-1]
+    w_shape = (num_groups, n, k) if transb else (num_groups, k, n)
+    A = te.placeholder((m, k), name="A", dtype=in_dtype)
+    B = te.placeholder(w_shape, name="B", dtype=in_dtype)
+    indptr = te.placeholder((num_groups + 1,), name="indptr", dtype="int64")
+    C = cublas.grouped_matmul(A, B, indptr, transb=transb, dtype=out_dtype)
+    s = te.create_schedule(C.op)
+
+    dev = tvm.cuda(0)
+    f = tvm.build(s, [A, B, indptr, C], "cuda")
+    a = np.random.uniform(size=(m, k)).astype(in_dtype)
+    b = np.random.uniform(size=w_shape).astype(in_dtype)
+    c = tvm.nd.array(np.zeros((m, n), dtype=out_dtype), dev)
+    f(tvm.nd.array(a, dev), tvm.nd.array(b, dev), tvm.nd.array(np.array(offsets), dev), c)
+
+    expected = np.zeros((m, n), dtype=out_dtype)
+    for g in range(num_groups):
+        b_g = b[g].T if transb else b[g]
+        rows = slice(offsets[g], offsets[g + 1])
+        expected[rows] = a[rows].astype(out_dtype) @ b_g.astype(out_dtype)
+    tvm.testing.assert_allclose(c.numpy(), expected, rtol=rtol)
+
+
 @tvm.testing.requires_cuda
 def test_matmul_add():
     verify_matmul_add("float", "float", rtol=1e-3)
@@ -156,6 +180,19 @@ def test_matmul_add_igemm():
     verify_matmul_add_igemm("int8", "int32")
 
 
+@tvm.testing.requires_cuda
+def test_grouped_matmul():
+    if not tvm.get_global_func("tvm.contrib.cublas.grouped_matmul", True):
+        print("skip because extern function is not available")
+        return
+
+    offsets = [0, 16, 16, 80, 96]
+    verify_grouped_matmul(offsets, 4, 64, 32, False, "float32", "float32", rtol=1e-3)
+    verify_grouped_matmul(offsets, 4, 64, 32, True, "float32", "float32", rtol=1e-3)
+    verify_grouped_matmul(offsets, 4, 64, 32, False, "float16", "float16", rtol=1e-2)
+    verify_grouped_matmul(offsets, 4, 64, 32, True, "float16", "float32", rtol=1e-2)
+
+
 @tvm.testing.requires_cuda
 def test_batch_matmul():
     if not tvm.get_global_func("tvm.contrib.cublas.matmul", True):
@@ -959,5 +959,41 @@ def test_conv2d_bwd():
     )
 
 
+
+def test_profile_database(tmp_path):
+    from tvm.contrib.cutlass.gen_gemm import CutlassGemmProfiler
+    from tvm.contrib.cutlass.gen_tensor_op import ProfileDatabase
+
+    db_path = str(tmp_path / "profile_db.json")
+    args = (256, 128, 64, "float16", "float16", "float16", "row", "row", "col", False)
+
+    def profiler(evaluate):
+        # Forget the databases opened in this process, to read the file.
+        ProfileDatabase._databases.clear()
+        gemm_profiler = CutlassGemmProfiler(80, "cutlass", str(tmp_path / "bin"), db_path)
+        gemm_profiler.engine.compile_all = lambda ops, use_multiprocessing: None
+        gemm_profiler.engine.evaluate = evaluate
+        return gemm_profiler
+
+    runtimes = {}
+
+    def evaluate(op, _):
+        runtimes[op["name"]] = float(len(runtimes) % 5 + 1)
+        return runtimes[op["name"]]
+
+    best = profiler(evaluate).select_op(*args)
+    assert best["runtime"] == min(runtimes.values())
+
+    def fail(op, _):
+        assert False, "The profiled workload should be read from the database"
+
+    assert profiler(fail).select_op(*args)["name"] == best["name"]
+
+    # Another dtype is a different workload.
+    evaluated = []
+    profiler(lambda op, _: evaluated.append(op) or 1.0).select_op(*args[:3], "float32", *args[4:])
+    assert evaluated
+
+
 if __name__ == "__main__":
     tvm.testing.main()
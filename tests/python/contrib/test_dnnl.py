@@ -949,6 +949,30 @@ def test_dense(run_module, dtype="float32"):
     run_and_verify_func(config, run_module=run_module, dtype=dtype)
 
 
+def test_dense_repeated_runs(run_module, dtype="float32"):
+    # The intermediate buffers of the subgraph are reused by the next runs, with new inputs.
+    x_shape = (4, 16)
+    k_shape = (32, 16)
+    dense, dic, param_lst = get_dense_bias(x_shape, k_shape, activation="gelu", dtype=dtype)
+    params = {x: np.random.uniform(-1, 1, dic[x]).astype(dtype) for x in param_lst}
+    mod = partition_for_dnnl(tvm.IRModule.from_expr(dense), params)
+    check_dnnl_used(mod)
+    if not run_module:
+        return
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm", params=params)
+        ref_lib = relay.build(tvm.IRModule.from_expr(dense), target="llvm", params=params)
+    rt_mod = tvm.contrib.graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    ref_rt_mod = tvm.contrib.graph_executor.GraphModule(ref_lib["default"](tvm.cpu()))
+    for _ in range(3):
+        x = np.random.uniform(-1, 1, x_shape).astype(dtype)
+        rt_mod.run(x=x)
+        ref_rt_mod.run(x=x)
+        tvm.testing.assert_allclose(
+            rt_mod.get_output(0).numpy(), ref_rt_mod.get_output(0).numpy(), rtol=1e-5, atol=1e-5
+        )
+
+
 def test_dense_pattern(run_module, dtype="float32"):
     x_shape = (1, 16)
     k_shape = (32, 16)
@@ -16,11 +16,15 @@
 # under the License.
 # pylint: disable=wrong-import-position, invalid-name
 
+from unittest.mock import patch
+
 import pytest
 
 pytest.importorskip("ethosu.vela")
 
+import tvm
 import tvm.contrib.ethosu.cascader as cs
+from tvm.contrib.ethosu.cascader import scheduler
 
 from . import infra
 
@@ -79,5 +83,41 @@ def test_compute_cycles_annotation(SRAM, FLASH, TwoConv2DTE):
         assert op_attrs.pragma_values[0] == compute_cycles_hint
 
 
+def test_cascade_reuses_plans(SRAM, FLASH, TwoConv2DTE):
+    device_config = cs.EthosuDeviceConfig("ethos-u55-256")
+    options = infra.make_options(
+        cascade_region=SRAM,
+        max_proposals=64,
+        stripe_factors=4,
+        max_plan_size=10,
+        max_open_plans=8,
+        max_closed_plans=32,
+        always_copy_size=1024,
+        disable_pareto_plans=False,
+        disable_pareto_proposals=False,
+        enable_striping=True,
+    )
+    sch, te_graph, const_dict = TwoConv2DTE
+
+    def _stages(sch):
+        return [(stage.op.name, len(stage.leaf_iter_vars)) for stage in sch.stages]
+
+    scheduler.PLAN_CACHE.clear()
+    cs.search_plans([(te_graph, const_dict)], options, SRAM, FLASH, [SRAM], device_config)
+    with patch.object(scheduler, "generate_proposals") as mock_generate_proposals:
+        cs.cascade(sch, te_graph, const_dict, options, SRAM, FLASH, [SRAM], device_config)
+        cached_sch = tvm.te.create_schedule([t.op for t in te_graph.outputs])
+        cs.cascade(cached_sch, te_graph, const_dict, options, SRAM, FLASH, [SRAM], device_config)
+        mock_generate_proposals.assert_not_called()
+    assert _stages(cached_sch) == _stages(sch)
+
+    # The plans are searched again without the cache
+    scheduler.PLAN_CACHE.clear()
+    searched_sch = tvm.te.create_schedule([t.op for t in te_graph.outputs])
+    cs.cascade(searched_sch, te_graph, const_dict, options, SRAM, FLASH, [SRAM], device_config)
+    assert _stages(searched_sch) == _stages(sch)
+    scheduler.PLAN_CACHE.clear()
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -386,6 +386,41 @@ def test_compress_weights():
         verify(tv, mock_obj)
 
 
+def test_compress_weights_cache(tmp_path):
+    values = np.arange(2 * 3 * 3 * 4, dtype=np.int8).reshape(2, 3, 3, 4)
+
+    def compress(block_depth):
+        return vela_api.compress_weights(
+            weights=values,
+            weights_zp=np.int64(1),
+            weights_layout="OHWI",
+            ifm_bitdepth=8,
+            block_depth=block_depth,
+            dilation=(1, 1),
+            accel_config=vapi.NpuAccelerator.Ethos_U55_256,
+            is_depthwise=False,
+        )
+
+    vela_api.WEIGHTS_CACHE.clear()
+    config = {"relay.ext.ethos-u.options": {"cache_dir": str(tmp_path)}}
+    with tvm.transform.PassContext(config=config):
+        with patch("ethosu.vela.api.npu_encode_weights") as mock_npu_encode_weights:
+            mock_npu_encode_weights.return_value = bytearray(b"\x01\x02\x03")
+            assert compress(8) == bytearray(b"\x01\x02\x03")
+            assert compress(8) == bytearray(b"\x01\x02\x03")
+            mock_npu_encode_weights.assert_called_once()
+            # The weights are encoded again for other parameters
+            compress(16)
+            assert mock_npu_encode_weights.call_count == 2
+
+        # A new process reuses the weights from the cache directory
+        vela_api.WEIGHTS_CACHE.clear()
+        with patch("ethosu.vela.api.npu_encode_weights") as mock_npu_encode_weights:
+            assert compress(8) == bytearray(b"\x01\x02\x03")
+            mock_npu_encode_weights.assert_not_called()
+    vela_api.WEIGHTS_CACHE.clear()
+
+
 def test_pack_biases():
     test_vecs = [
         {
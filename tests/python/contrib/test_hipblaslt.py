@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import te
+from tvm.contrib import hipblaslt
+
+
+def _reference(a, b, bias, transa, transb, activation):
+    if transa:
+        a = np.swapaxes(a, -1, -2)
+    if transb:
+        b = np.swapaxes(b, -1, -2)
+    c = np.matmul(a, b)
+    if bias is not None:
+        c = c + bias
+    if activation == "relu":
+        c = np.maximum(c, 0)
+    return c
+
+
+def verify_matmul(ashape, bshape, transa, transb, with_bias, activation, dtype="float32"):
+    if not tvm.get_global_func("tvm.contrib.hipblaslt.matmul", True):
+        pytest.skip("skip because extern function is not available")
+    A = te.placeholder(ashape, name="A", dtype=dtype)
+    B = te.placeholder(bshape, name="B", dtype=dtype)
+    m = bshape[-2] if transb else bshape[-1]
+    bias = te.placeholder((m,), name="bias", dtype=dtype) if with_bias else None
+    lib = hipblaslt.batch_matmul if len(ashape) == 3 else hipblaslt.matmul
+    C = lib(A, B, bias, transa, transb, activation)
+    s = te.create_schedule(C.op)
+    args = [A, B] + ([bias] if with_bias else []) + [C]
+    dev = tvm.rocm(0)
+    f = tvm.build(s, args, "rocm")
+    a = np.random.uniform(-1, 1, size=ashape).astype(dtype)
+    b = np.random.uniform(-1, 1, size=bshape).astype(dtype)
+    bias_np = np.random.uniform(-1, 1, size=(m,)).astype(dtype) if with_bias else None
+    nd_args = [tvm.nd.array(a, dev), tvm.nd.array(b, dev)]
+    if with_bias:
+        nd_args.append(tvm.nd.array(bias_np, dev))
+    c = tvm.nd.array(np.zeros([int(x) for x in C.shape], dtype=dtype), dev)
+    f(*nd_args, c)
+    ref = _reference(a, b, bias_np, transa, transb, activation)
+    rtol = 1e-2 if dtype == "float16" else 1e-5
+    tvm.testing.assert_allclose(c.numpy(), ref, rtol=rtol, atol=rtol)
+
+
+@tvm.testing.requires_rocm
+@pytest.mark.parametrize("transa,transb", [(False, False), (True, False), (False, True)])
+@pytest.mark.parametrize("activation", ["none", "relu"])
+def test_matmul(transa, transb, activation):
+    ashape = (64, 128) if transa else (128, 64)
+    bshape = (96, 64) if transb else (64, 96)
+    verify_matmul(ashape, bshape, transa, transb, False, activation)
+
+
+@tvm.testing.requires_rocm
+@pytest.mark.parametrize("activation", ["none", "relu"])
+@pytest.mark.parametrize("dtype", ["float32", "float16"])
+def test_matmul_bias(activation, dtype):
+    verify_matmul((128, 64), (64, 96), False, False, True, activation, dtype)
+
+
+@tvm.testing.requires_rocm
+def test_batch_matmul_bias():
+    verify_matmul((4, 32, 64), (4, 64, 48), False, False, True, "relu")
+    verify_matmul((4, 32, 64), (4, 48, 64), False, True, True, "none")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -91,6 +91,55 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def test_argsort_topk_large():
+    # Long rows take the radix sort, and many rows are sorted in parallel.
+    def build(dshape, dtype, k, is_ascend):
+        data = te.placeholder(dshape, name="data", dtype=dtype)
+        argsort = te.extern(
+            dshape,
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.argsort", ins[0], outs[0], 1, is_ascend
+            ),
+            dtype="int32",
+            name="argsort",
+        )
+        topk_shape = (dshape[0], k)
+        topk = te.extern(
+            [topk_shape, topk_shape],
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.topk", ins[0], outs[0], outs[1], k, 1, "both", is_ascend
+            ),
+            dtype=[dtype, "int32"],
+            name="topk",
+        )
+        s = te.create_schedule([argsort.op, topk.op])
+        return tvm.build(s, [data, argsort, topk[0], topk[1]], "llvm")
+
+    dev = tvm.cpu(0)
+    for dshape, dtype, k in [((4, 4096), "float32", 10), ((512, 300), "int32", 100)]:
+        for is_ascend in [True, False]:
+            f = build(dshape, dtype, k, is_ascend)
+            if dtype == "int32":
+                # Ties, to check that the sort is stable.
+                np_data = np.random.randint(-50, 50, size=dshape).astype(dtype)
+            else:
+                np_data = np.random.uniform(-1, 1, size=dshape).astype(dtype)
+            key = np_data if is_ascend else -np_data
+            np_indices = np.argsort(key, axis=1, kind="stable").astype("int32")
+            a = tvm.nd.array(np_data, dev)
+            indices = tvm.nd.empty(dshape, "int32", dev)
+            values_k = tvm.nd.empty((dshape[0], k), dtype, dev)
+            indices_k = tvm.nd.empty((dshape[0], k), "int32", dev)
+            f(a, indices, values_k, indices_k)
+            tvm.testing.assert_allclose(indices.numpy(), np_indices)
+            tvm.testing.assert_allclose(indices_k.numpy(), np_indices[:, :k])
+            tvm.testing.assert_allclose(
+                values_k.numpy(), np.take_along_axis(np_data, np_indices[:, :k], axis=1)
+            )
+
+
 def test_sort_by_key_gpu():
     size = 6
     keys = te.placeholder((size,), name="keys", dtype="int32")
@@ -126,4 +175,5 @@ def test_sort_by_key_gpu():
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_argsort_topk_large()
     test_sort_by_key_gpu()
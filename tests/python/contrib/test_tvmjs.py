@@ -0,0 +1,58 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import json
+import os
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.contrib import tvmjs, utils
+
+
+def test_dump_ndarray_cache():
+    params = [
+        np.random.uniform(size=(256, 1024)).astype("float32"),
+        tvm.nd.array(np.arange(16, dtype="int32")),
+        np.random.uniform(size=(256, 1024)).astype("float16"),
+    ]
+    temp = utils.tempdir()
+    manifest = tvmjs.dump_ndarray_cache(params, temp.path, shard_cap_mb=1)
+    with open(temp.relpath("ndarray-cache.json")) as infile:
+        assert json.load(infile) == manifest
+
+    # The first parameter fills a shard, the next two fit together in the second one.
+    shards = manifest["records"]
+    assert [[rec["name"] for rec in shard["records"]] for shard in shards] == [
+        ["param_0"],
+        ["param_1", "param_2"],
+    ]
+    for shard in shards:
+        with open(os.path.join(temp.path, shard["dataPath"]), "rb") as infile:
+            data = infile.read()
+        assert len(data) == shard["nbytes"]
+        for rec in shard["records"]:
+            expected = params[int(rec["name"].split("_")[-1])]
+            if isinstance(expected, tvm.nd.NDArray):
+                expected = expected.numpy()
+            begin = rec["byteOffset"]
+            arr = np.frombuffer(data[begin : begin + rec["nbytes"]], dtype=rec["dtype"])
+            np.testing.assert_equal(arr.reshape(rec["shape"]), expected)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
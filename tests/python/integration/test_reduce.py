@@ -674,5 +674,38 @@ def test_reduce_storage_reuse():
     tvm.testing.assert_allclose(buff_b.numpy(), ref, rtol=1e-5)
 
 
+@tvm.testing.requires_cuda
+def test_reduce_across_blocks():
+    """Test reduction across the blocks of a grid in one kernel."""
+    target = tvm.target.Target("cuda")
+    dev = tvm.device(target.kind.name, 0)
+    num_rows, num_cols, num_blocks, num_thread = 4, 32768, 16, 128
+
+    placeholder_a = te.placeholder((num_rows, num_cols), name="A")
+    axis_k = te.reduce_axis((0, num_cols), name="k")
+    result_b = te.compute(
+        (num_rows,), lambda i: te.sum(placeholder_a[i, axis_k], axis=axis_k), name="B"
+    )
+    schedule = te.create_schedule(result_b.op)
+    axis_ko, axis_ki = schedule[result_b].split(axis_k, factor=num_thread)
+    axis_kb, axis_ko = schedule[result_b].split(axis_ko, nparts=num_blocks)
+    schedule[result_b].bind(result_b.op.axis[0], te.thread_axis("blockIdx.x"))
+    schedule[result_b].bind(axis_kb, te.thread_axis("blockIdx.y"))
+    schedule[result_b].bind(axis_ki, te.thread_axis("threadIdx.x"))
+
+    func = tvm.build(schedule, [placeholder_a, result_b], target)
+    source = func.imported_modules[0].get_source()
+    assert "atomicAdd" in source
+    assert "__threadfence" in source
+
+    inp = np.random.uniform(size=(num_rows, num_cols)).astype("float32")
+    buff_a = tvm.nd.array(inp, dev)
+    buff_b = tvm.nd.array(np.zeros(num_rows, dtype="float32"), dev)
+    # The counters are left zeroed for the next run.
+    for _ in range(2):
+        func(buff_a, buff_b)
+        tvm.testing.assert_allclose(buff_b.numpy(), np.sum(inp, axis=1), rtol=1e-4)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
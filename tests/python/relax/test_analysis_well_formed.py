@@ -392,5 +392,47 @@ def test_ANF():
     assert not rx.analysis.well_formed(mod)
 
 
+def test_analysis_manager():
+    v0 = rx.Var("v0", [m, n], type_anno)
+    v1 = rx.Var("v1", [m, n], type_anno)
+    v2 = rx.Var("v2", [m, n], type_anno)
+    bb = rx.BlockBuilder()
+    with bb.function("func1", [v0]):
+        with bb.dataflow():
+            lv0 = bb.emit(rx.op.add(v0, v0))
+            gv0 = bb.emit_output(lv0)
+        bb.emit_func_output(gv0)
+    with bb.function("func2", [v1]):
+        gv0 = bb.emit(rx.op.subtract(v1, v1))
+        bb.emit_func_output(gv0)
+    mod = bb.get()
+    manager = rx.analysis.AnalysisManager()
+    assert manager.well_formed(mod)
+    assert manager.num_cached_functions == 2
+
+    # Only the function a pass changed is dropped and checked again.
+    bb = rx.BlockBuilder()
+    with bb.function("func1", [v2]):
+        gv0 = bb.emit(rx.op.multiply(v2, v2))
+        bb.emit_func_output(gv0)
+    gv_func1 = mod.get_global_var("func1")
+    gv_func2 = mod.get_global_var("func2")
+    new_mod = tvm.IRModule({gv_func1: bb.get()["func1"], gv_func2: mod["func2"]})
+    manager.invalidate(new_mod)
+    assert manager.num_cached_functions == 1
+    assert manager.well_formed(new_mod)
+    assert manager.num_cached_functions == 2
+
+    # The params shared across the cached functions are checked against the module.
+    dup_mod = tvm.IRModule({gv_func1: mod["func1"], rx.GlobalVar("func3"): mod["func1"]})
+    assert not manager.well_formed(dup_mod)
+
+    # The use-def chains are reused in its scope.
+    block = mod["func1"].body.blocks[0]
+    with manager:
+        assert rx.analysis.udchain(block).same_as(rx.analysis.udchain(block))
+    assert not rx.analysis.udchain(block).same_as(rx.analysis.udchain(block))
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
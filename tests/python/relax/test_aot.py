@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax, tir, topi
+
+import numpy as np
+
+
+def _example():
+    x = relax.Var("x", (2, 4), relax.DynTensorType(2, "float32"))
+    const_one = relax.const(1, "float32")
+
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        v0 = bb.emit_te(topi.exp, x)
+        v1 = bb.emit_te(topi.reshape, v0, (8,))
+        v2 = bb.emit_te(topi.nn.relu, v1)
+        v3 = bb.emit_te(topi.add, v2, const_one)
+        v4 = bb.emit_te(topi.log, v3)
+        bb.emit_func_output(v4)
+    return bb.get()
+
+
+def _example_np(x_np):
+    y_np = np.reshape(np.exp(x_np), (8,))
+    return np.log(np.maximum(y_np, 0.0) + 1)
+
+
+def test_aot_lower_main():
+    mod = _example()
+    mod = relax.transform.ToNonDataflow()(mod)
+    mod = relax.transform.CallTIRRewrite()(mod)
+    mod = relax.transform.AttachGlobalSymbol()(mod)
+    mod = relax.transform.AOTLowerMain("default")(mod)
+
+    assert all(isinstance(func, tir.PrimFunc) for func in mod.functions.values())
+    main = mod["__tvm_main__"]
+    assert main.attrs["global_symbol"] == "tvmgen_default___tvm_main__"
+    assert len(main.attrs["input_vars"]) == 1
+    assert len(main.attrs["output_vars"]) == 1
+
+    calls = []
+    tir.stmt_functor.post_order_visit(
+        main.body,
+        lambda n: calls.append(n)
+        if isinstance(n, tir.Call) and n.op.same_as(tvm.ir.Op.get("tir.tvm_call_cpacked"))
+        else None,
+    )
+    assert len(calls) == 5
+    # The last kernel writes the output buffer directly.
+    assert calls[-1].args[-2].same_as(main.buffer_map[main.params[1]].data)
+
+
+@pytest.mark.parametrize("enable_usmp", [True, False])
+def test_aot_build(enable_usmp):
+    with tvm.transform.PassContext(config={"tir.usmp.enable": enable_usmp}):
+        aot_mod = relax.aot.build(_example(), "llvm")
+
+    x_np = np.random.rand(2, 4).astype("float32")
+    y = aot_mod(x_np)
+    tvm.testing.assert_allclose(y.numpy(), _example_np(x_np), rtol=1e-5, atol=1e-5)
+
+
+def test_aot_build_tuple_output():
+    x = relax.Var("x", (4,), relax.DynTensorType(1, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        v0 = bb.emit_te(topi.exp, x)
+        v1 = bb.emit_te(topi.log, v0)
+        bb.emit_func_output(relax.Tuple([v0, v1, x]))
+
+    aot_mod = relax.aot.build(bb.get(), "llvm")
+    x_np = np.random.rand(4).astype("float32") + 1
+    y0, y1, y2 = aot_mod(x_np)
+    tvm.testing.assert_allclose(y0.numpy(), np.exp(x_np), rtol=1e-5, atol=1e-5)
+    tvm.testing.assert_allclose(y1.numpy(), x_np, rtol=1e-5, atol=1e-5)
+    tvm.testing.assert_allclose(y2.numpy(), x_np, rtol=1e-5, atol=1e-5)
+
+
+def test_aot_symbolic_shape():
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4], relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        v0 = bb.emit_te(topi.exp, x)
+        bb.emit_func_output(v0)
+
+    with pytest.raises(tvm.TVMError):
+        relax.aot.build(bb.get(), "llvm")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
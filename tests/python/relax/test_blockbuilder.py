@@ -363,6 +363,35 @@ def test_normalize():
     )
 
 
+def test_normalize_memoized():
+    x = rx.Var("x", [2, 3], rx.DynTensorType(ndim=2, dtype="float32"))
+    num_memo_hits = tvm.get_global_func("relax.BlockBuilderNumNormalizeMemoHits")
+
+    def build_and_renormalize():
+        bb = rx.BlockBuilder()
+        with bb.function("main", [x]):
+            gv = bb.emit(rx.op.add(rx.op.multiply(x, x), x))
+            bb.emit_func_output(gv)
+        num_build_hits = num_memo_hits(bb)
+        func = bb.get()["main"]
+        # The memo is cleared once the function is added, so the function is normalized anew
+        first, second = bb.normalize(func), bb.normalize(func)
+        assert num_memo_hits(bb) == num_build_hits
+        return func, first, second, num_build_hits
+
+    # The values of the two bindings, normalized when emitted, are not normalized again along
+    # with the function body
+    func, first, second, num_build_hits = build_and_renormalize()
+    assert num_build_hits >= 2
+    # The normal form is a fixed point, whether or not the normalization is memoized.
+    assert first.same_as(func) and second.same_as(func)
+    with tvm.transform.PassContext(config={"relax.BlockBuilder.memoize_normalize": False}):
+        func_no_memo, first, second, num_build_hits = build_and_renormalize()
+    assert num_build_hits == 0
+    assert first.same_as(func_no_memo) and second.same_as(func_no_memo)
+    assert_structural_equal(func, func_no_memo)
+
+
 def test_call_te():
     bb = rx.BlockBuilder()
     dtype = rx.DynTensorType(ndim=2, dtype="float32")
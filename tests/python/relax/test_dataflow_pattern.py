@@ -819,6 +819,67 @@ def test_nested_diamond():
         assert ctx.match_dfb(DiamondInDiamond["main"].body.blocks[0])
 
 
+def test_match_bindings():
+    @R.function
+    def simple_chain(x: R.Tensor((32, 32), "float32")) -> R.Tensor:
+        with R.dataflow():
+            lv0 = R.call_tir("tir_relu", (x), (32, 32), dtype="float32")
+            lv1 = R.call_tir("tir_sigmoid", (lv0), (32, 32), dtype="float32")
+            lv2 = R.add(lv1, lv0)
+            lv3 = R.call_tir("tir_neg", (lv2), (32, 32), dtype="float32")
+            R.output(lv3)
+        return lv3
+
+    dfb = simple_chain.body.blocks[0]
+    lv0, lv1, lv2, lv3 = [binding.var for binding in dfb.bindings]
+    patterns = [
+        is_call_tir_extern("tir_sigmoid"),
+        is_op("relax.add")(is_call_tir_extern("tir_relu"), wildcard()),
+        is_call_tir_extern("tir_relu") | is_call_tir_extern("tir_neg"),
+        is_call_tir_extern("tir_sigmoid", [wildcard()]),
+    ]
+    matched = match_bindings(patterns, dfb)
+    # The first matching pattern wins, and the commutative add is matched as well.
+    assert matched == {lv0: 2, lv1: 0, lv2: 1, lv3: 2}
+    assert matched == {
+        var: next(i for i, p in enumerate(patterns) if p.match(var, get_var2val(simple_chain)))
+        for var in [lv0, lv1, lv2, lv3]
+    }
+
+
+def test_rewrite_bindings():
+    @R.function
+    def negatives(x: R.Tensor((32, 32), "float32"), y: R.Tensor((32, 32), "float32")):
+        with R.dataflow():
+            lv0 = R.negative(y)
+            lv1 = R.negative(lv0)
+            lv2 = R.negative(lv1)
+            lv3 = R.add(x, lv2)
+            gv = R.negative(lv3)
+            R.output(gv)
+        return gv
+
+    inner = wildcard()
+    lhs, rhs = wildcard(), wildcard()
+    rules = [
+        (is_op("relax.negative")(is_op("relax.negative")(inner)), lambda _, m: m[inner]),
+        (
+            is_op("relax.add")(lhs, is_op("relax.negative")(rhs)),
+            lambda _, m: rx.op.subtract(m[lhs], m[rhs]),
+        ),
+    ]
+    func = rewrite_bindings(rules, negatives)
+    assert rx.analysis.well_formed(tvm.IRModule({rx.GlobalVar("main"): func}))
+    bindings = func.body.blocks[0].bindings
+    # The users of the rewritten bindings are matched again, and the unused bindings are removed.
+    x, y = negatives.params
+    assert len(bindings) == 3
+    assert bindings[0].value.same_as(y)
+    assert [b.value.op.name for b in bindings[1:]] == ["relax.subtract", "relax.negative"]
+    assert bindings[1].value.args[0].same_as(x)
+    assert bindings[1].value.args[1].same_as(bindings[0].var)
+
+
 def test_incremental_solving():
     @R.function
     def simple_chain(x: R.Tensor((32, 32), "float32")) -> R.Tensor:
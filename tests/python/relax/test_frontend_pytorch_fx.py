@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+
+torch = pytest.importorskip("torch")
+
+from tvm.relax.frontend import TorchFXTranslator  # pylint: disable=wrong-import-position
+
+
+class LinearConv(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.conv = torch.nn.Conv2d(3, 4, 3)
+        self.linear = torch.nn.Linear(6, 5)
+
+    def forward(self, x):
+        return self.linear(self.conv(x))
+
+
+def _run(mod, *args):
+    vm = relax.VirtualMachine(relax.vm.build(mod, "llvm"), tvm.cpu())
+    return vm["main"](*[tvm.nd.array(arg) for arg in args]).numpy()
+
+
+def test_keep_params_as_input():
+    model = LinearConv().eval()
+    input_info = {"x": ((1, 3, 8, 8), "float32")}
+    mod, params = TorchFXTranslator().from_pytorch(model, input_info, keep_params_as_input=True)
+
+    func = mod["main"]
+    assert func.attrs["num_input"] == 1
+    assert [param.name_hint for param in func.params] == [
+        "x",
+        "conv_weight",
+        "conv_bias",
+        "linear_weight",
+        "linear_bias",
+    ]
+    # The parameters are views of the torch tensors, not copies.
+    for name, param in model.named_parameters():
+        view = params[name.replace(".", "_")]
+        assert view.handle.contents.data == param.data.data_ptr()
+
+    x_np = np.random.uniform(size=(1, 3, 8, 8)).astype("float32")
+    with torch.no_grad():
+        expected = model(torch.from_numpy(x_np)).numpy()
+    bound = relax.transform.BindParams("main", params)(mod)
+    tvm.testing.assert_allclose(_run(bound, x_np), expected, rtol=1e-5, atol=1e-5)
+    # The same as the import with the parameters bound as constants.
+    eager = TorchFXTranslator().from_pytorch(model, input_info)
+    tvm.testing.assert_allclose(_run(eager, x_np), expected, rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
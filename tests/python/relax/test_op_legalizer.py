@@ -15,8 +15,11 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
 import pytest
 import tvm
+import tvm.testing
+from tvm import relax
 from tvm.relax.transform import OperatorLegalizer
 from tvm.script import ir as I, relax as R, tir as T
 
@@ -171,6 +174,36 @@ def test_add():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_legalize_ops_shares_prim_funcs():
+    @I.ir_module
+    class Adds:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), "float32"),
+            y: R.Tensor((2, 3), "float32"),
+            z: R.Tensor((3,), "float32"),
+            w: R.Tensor((4, 3, 3, 3), "float32"),
+        ) -> R.Tensor(None, "float32", ndim=2):
+            lv0: R.Tensor((2, 3), "float32") = R.add(x, y)
+            lv1: R.Tensor((2, 3), "float32") = R.add(lv0, y)
+            lv2: R.Tensor((2, 3), "float32") = R.add(lv1, z)
+            lv3: R.Tensor((4, 3, 3, 3), "float32") = R.nn.conv2d(w, w, kernel_size=[3, 3])
+            return lv2
+
+    mod = relax.transform.LegalizeOps()(Adds)
+    # The adds of the same shapes share one PrimFunc, and conv2d is left to the Python legalizer.
+    prim_funcs = [func for func in mod.functions.values() if isinstance(func, tvm.tir.PrimFunc)]
+    assert len(prim_funcs) == 2
+    bindings = mod["main"].body.blocks[0].bindings
+    assert bindings[0].value.args[0].same_as(bindings[1].value.args[0])
+    assert not bindings[0].value.args[0].same_as(bindings[2].value.args[0])
+    assert bindings[3].value.op == tvm.ir.Op.get("relax.nn.conv2d")
+
+    mod = OperatorLegalizer(Adds).transform()
+    bindings = mod["main"].body.blocks[0].bindings
+    assert all(binding.value.op == tvm.ir.Op.get("relax.call_tir") for binding in bindings)
+
+
 def test_subtract():
     @I.ir_module
     class Subtract:
@@ -2700,6 +2733,200 @@ def test_image_resize2d():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def _grouped_matmul_module(transpose_w):
+    m = tvm.tir.Var("m", "int64")
+    x = relax.Var("x", [m, 8], relax.DynTensorType(ndim=2, dtype="float32"))
+    w_shape = [3, 6, 8] if transpose_w else [3, 8, 6]
+    w = relax.Var("w", w_shape, relax.DynTensorType(ndim=3, dtype="float32"))
+    indptr = relax.Var("indptr", [4], relax.DynTensorType(ndim=1, dtype="int64"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w, indptr]):
+        gv = bb.emit(relax.op.nn.grouped_matmul(x, w, indptr, transpose_w=transpose_w))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+@pytest.mark.parametrize("transpose_w", [False, True])
+def test_grouped_matmul(transpose_w):
+    mod = OperatorLegalizer(_grouped_matmul_module(transpose_w)).transform()
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    # The sizes of the groups change from a call to the next, and a group may be empty.
+    for offsets in [[0, 2, 2, 7], [0, 4, 5, 6]]:
+        x = np.random.uniform(size=(offsets[-1], 8)).astype("float32")
+        w = np.random.uniform(size=(3, 6, 8) if transpose_w else (3, 8, 6)).astype("float32")
+        indptr = np.array(offsets, dtype="int64")
+        out = vm["main"](tvm.nd.array(x), tvm.nd.array(w), tvm.nd.array(indptr))
+
+        expected = np.zeros((offsets[-1], 6), dtype="float32")
+        for g in range(3):
+            w_g = w[g].T if transpose_w else w[g]
+            expected[offsets[g] : offsets[g + 1]] = x[offsets[g] : offsets[g + 1]] @ w_g
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5)
+
+
+def test_grouped_matmul_cublas():
+    with tvm.target.Target("cuda -libs=cublas"):
+        mod = OperatorLegalizer(_grouped_matmul_module(False)).transform()
+    assert "tvm.contrib.cublas.grouped_matmul" in mod["grouped_matmul_cublas"].script()
+
+
+def _np_attention(q, k, v, bias, scale, causal_mask):
+    # The scores of shape (batch, num_heads, seq_len, seq_len_kv).
+    scores = np.einsum("bqnh,bknh->bnqk", q, k) * scale
+    if bias is not None:
+        scores = scores + bias
+    seq_len, seq_len_kv = q.shape[1], k.shape[1]
+    if causal_mask:
+        offset = seq_len_kv - seq_len if causal_mask == "BottomRight" else 0
+        mask = np.arange(seq_len_kv)[None, :] <= np.arange(seq_len)[:, None] + offset
+        scores = np.where(mask, scores, -np.inf)
+    scores = scores - scores.max(axis=-1, keepdims=True)
+    probs = np.exp(scores)
+    probs = probs / probs.sum(axis=-1, keepdims=True)
+    return np.einsum("bnqk,bknh->bqnh", probs, v)
+
+
+@pytest.mark.parametrize("causal_mask", [None, "TopLeft", "BottomRight"])
+@pytest.mark.parametrize("with_bias", [False, True])
+def test_attention(causal_mask, with_bias):
+    # More queries and keys than a block and a tile, which do not divide them.
+    s = tvm.tir.Var("s", "int64")
+    shapes = {"q": [2, s, 3, 16], "k": [2, 150, 3, 16], "v": [2, 150, 3, 8]}
+    if with_bias:
+        shapes["bias"] = [1, 3, s, 150]
+    params = [
+        relax.Var(name, shape, relax.DynTensorType(ndim=4, dtype="float32"))
+        for name, shape in shapes.items()
+    ]
+    bb = relax.BlockBuilder()
+    with bb.function("main", params):
+        gv = bb.emit(relax.op.nn.attention(*params, scale=0.3, causal_mask=causal_mask))
+        bb.emit_func_output(gv)
+    mod = OperatorLegalizer(bb.get()).transform()
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    for seq_len in [1, 130]:
+        inputs = {
+            name: np.random.uniform(-1, 1, [seq_len if dim is s else dim for dim in shape])
+            .astype("float32")
+            for name, shape in shapes.items()
+        }
+        out = vm["main"](*[tvm.nd.array(x) for x in inputs.values()])
+        expected = _np_attention(
+            inputs["q"], inputs["k"], inputs["v"], inputs.get("bias"), 0.3, causal_mask
+        )
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-4, atol=1e-5)
+
+
+def test_attention_dropout():
+    shapes = [[1, 70, 2, 8], [1, 90, 2, 8], [1, 90, 2, 8]]
+    params = [
+        relax.Var(name, shape, relax.DynTensorType(ndim=4, dtype="float32"))
+        for name, shape in zip(["q", "k", "v"], shapes)
+    ]
+    bb = relax.BlockBuilder()
+    with bb.function("main", params):
+        gv = bb.emit(relax.op.nn.attention(*params, dropout_rate=0.5, seed=7))
+        bb.emit_func_output(gv)
+    mod = OperatorLegalizer(bb.get()).transform()
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    # With values of ones, the outputs are the kept fractions of the probabilities, rescaled.
+    q = np.random.uniform(-1, 1, shapes[0]).astype("float32")
+    k = np.random.uniform(-1, 1, shapes[1]).astype("float32")
+    v = np.ones(shapes[2], "float32")
+    out = vm["main"](tvm.nd.array(q), tvm.nd.array(k), tvm.nd.array(v)).numpy()
+    assert 0.5 < out.mean() < 1.5 and (out >= 0).all()
+    # The mask only depends on the seed and the indices.
+    again = vm["main"](tvm.nd.array(q), tvm.nd.array(k), tvm.nd.array(v)).numpy()
+    tvm.testing.assert_allclose(out, again)
+
+
+@pytest.mark.parametrize("with_residual", [False, True])
+@pytest.mark.parametrize("is_layer_norm", [False, True])
+def test_fused_norm(with_residual, is_layer_norm):
+    n = tvm.tir.Var("n", "int64")
+    shapes = {"x": [n, 3, 100], "gamma": [3, 100]}
+    if is_layer_norm:
+        shapes["beta"] = [3, 100]
+    if with_residual:
+        shapes["residual"] = [n, 3, 100]
+    params = [
+        relax.Var(name, shape, relax.DynTensorType(ndim=len(shape), dtype="float32"))
+        for name, shape in shapes.items()
+    ]
+    bb = relax.BlockBuilder()
+    with bb.function("main", params):
+        residual = params[-1] if with_residual else None
+        if is_layer_norm:
+            gv = relax.op.nn.fused_layer_norm(*params[:3], residual, axis=[1, 2], epsilon=1e-3)
+        else:
+            gv = relax.op.nn.rms_norm(*params[:2], residual, axis=[1, 2], epsilon=1e-3)
+        bb.emit_func_output(bb.emit(gv))
+    mod = OperatorLegalizer(bb.get()).transform()
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    inputs = {
+        name: np.random.uniform(-1, 1, [5 if dim is n else dim for dim in shape]).astype("float32")
+        for name, shape in shapes.items()
+    }
+    # An offset, which a one-pass sum of squares would lose to cancellation.
+    inputs["x"] += 100
+    out = vm["main"](*[tvm.nd.array(x) for x in inputs.values()])
+    h = inputs["x"] + inputs["residual"] if with_residual else inputs["x"]
+    if is_layer_norm:
+        mean = h.mean(axis=(1, 2), keepdims=True)
+        var = h.var(axis=(1, 2), keepdims=True)
+        expected = (h - mean) / np.sqrt(var + 1e-3) * inputs["gamma"] + inputs["beta"]
+    else:
+        expected = h / np.sqrt((h * h).mean(axis=(1, 2), keepdims=True) + 1e-3) * inputs["gamma"]
+    if with_residual:
+        tvm.testing.assert_allclose(out[1].numpy(), h, rtol=1e-6)
+        out = out[0]
+    tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-4, atol=1e-4)
+
+
+@pytest.mark.parametrize("bits", [4, 8])
+def test_weight_quantization(bits):
+    n = tvm.tir.Var("n", "int64")
+    x = relax.Var("x", [n, 64], relax.DynTensorType(ndim=2, dtype="float32"))
+    w = relax.Var("w", [24, 64], relax.DynTensorType(ndim=2, dtype="float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w]):
+        quantized = bb.emit(relax.op.nn.quantize_weight(w, bits=bits, group_size=16))
+        packed = bb.emit(relax.TupleGetItem(quantized, 0))
+        scale = bb.emit(relax.TupleGetItem(quantized, 1))
+        weight = bb.emit(relax.op.nn.dequantize_weight(packed, scale, bits, group_size=16))
+        out = bb.emit(relax.op.nn.quantized_dense(x, packed, scale, bits, group_size=16))
+        gv = bb.emit(relax.Tuple([packed, weight, out]))
+        bb.emit_func_output(gv)
+    mod = OperatorLegalizer(bb.get()).transform()
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    x_np = np.random.uniform(-1, 1, (5, 64)).astype("float32")
+    w_np = np.random.uniform(-1, 1, (24, 64)).astype("float32")
+    packed, weight, out = vm["main"](tvm.nd.array(x_np), tvm.nd.array(w_np))
+
+    offset = 1 << (bits - 1)
+    groups = w_np.reshape(24, 4, 16)
+    scale_np = np.abs(groups).max(axis=-1, keepdims=True) / (offset - 1)
+    q = np.clip(np.round(groups / scale_np), -offset, offset - 1).reshape(24, 64)
+    # The integers are packed from the low bits of the bytes, with an offset.
+    unpacked = (q + offset).astype("uint8")
+    if bits == 4:
+        unpacked = unpacked[:, 0::2] | (unpacked[:, 1::2] << 4)
+    np.testing.assert_equal(packed.numpy(), unpacked)
+    expected_weight = (q.reshape(24, 4, 16) * scale_np).reshape(24, 64)
+    tvm.testing.assert_allclose(weight.numpy(), expected_weight, rtol=1e-6, atol=1e-6)
+    tvm.testing.assert_allclose(out.numpy(), x_np @ expected_weight.T, rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     # Todo: test_split_by_indices
     # Todo: test_split_by_n_section
@@ -89,6 +89,53 @@ def test_if():
     check_roundtrip(foo)
 
 
+def test_nested_indent():
+    @R.function
+    def foo(cond: R.Tensor((), "bool"), x: R.Tensor((1,), "float32")) -> R.Tensor:
+        @R.function
+        def bar(c: R.Tensor((), "bool"), y: R.Tensor((1,), "float32")) -> R.Tensor:
+            if c:
+                if c:
+                    w = R.add(y, y)
+                else:
+                    w = R.multiply(y, y)
+                z = R.add(w, w)
+            else:
+                z = R.multiply(y, y)
+            return z
+
+        if cond:
+            r = bar(cond, x)
+        else:
+            r = R.add(x, x)
+        return r
+
+    check_roundtrip(foo)
+    # each scope is indented by one level more than the line opening it
+    lines = [line for line in foo.script().splitlines() if line.strip()]
+    for line, next_line in zip(lines[:-1], lines[1:]):
+        if line.endswith(":"):
+            indent = len(line) - len(line.lstrip())
+            assert len(next_line) - len(next_line.lstrip()) == indent + 4
+
+
+def test_long_concat():
+    x = relax.Var("x", [4], relax.DynTensorType(1, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        lvs = [x]
+        for _ in range(300):
+            lvs.append(bb.emit(relax.op.add(lvs[-1], x)))
+        gv = bb.emit(relax.Tuple(lvs[1:]))
+        bb.emit_func_output(gv)
+    func = bb.get()["main"]
+
+    check_roundtrip(func)
+    text = func.script()
+    assert text.count("R.add(") == 300
+    assert text == func.script()
+
+
 def test_tuple():
     @R.function
     def foo(x: R.Tensor(ndim=2), y: R.Tensor((32,), "float32")):
@@ -66,13 +66,7 @@ def run_cpu(mod, func_name, *input):
     return vm[func_name](*input)
 
 
-def test_unique():
-
-    # TODO(prakalp): also add test for compiling and running on cuda device.
-    data_numpy = np.random.randint(0, 16, (16, 16))
-    data = tvm.nd.array(data_numpy)
-    result, result_sorted = run_cpu(InputModule, "foo", data)
-
+def check_unique(data_numpy, result, result_sorted):
     expected_output_sorted, indices = np.unique(data_numpy, return_index=True)
     expected_output = [data_numpy.flatten()[index] for index in sorted(indices, reverse=True)]
 
@@ -80,6 +74,32 @@ def test_unique():
     np.testing.assert_array_equal(expected_output, result.numpy())
 
 
+def test_unique():
+    data_numpy = np.random.randint(0, 16, (16, 16))
+    data = tvm.nd.array(data_numpy)
+    result, result_sorted = run_cpu(InputModule, "foo", data)
+    check_unique(data_numpy, result, result_sorted)
+
+    # Large enough to be sorted on several threads.
+    data_numpy = np.random.randint(-1000, 1000, (512, 512))
+    result, result_sorted = run_cpu(InputModule, "foo", tvm.nd.array(data_numpy))
+    check_unique(data_numpy, result, result_sorted)
+
+
+@tvm.testing.requires_cuda
+def test_unique_cuda():
+    if not tvm.get_global_func("vm.builtin.unique.cuda", True):
+        print("skip because thrust is not enabled")
+        return
+
+    dev = tvm.cuda(0)
+    ex = relax.vm.build(InputModule, tvm.target.Target("cuda"))
+    vm = relax.VirtualMachine(ex, dev)
+    data_numpy = np.random.randint(-1000, 1000, (64, 64))
+    result, result_sorted = vm["foo"](tvm.nd.array(data_numpy, dev))
+    check_unique(data_numpy, result, result_sorted)
+
+
 @tvm.script.ir_module
 class PrintTest:
     @R.function
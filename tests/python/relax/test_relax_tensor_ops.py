@@ -533,6 +533,143 @@ def test_matmul_fail_on_not_broadcastable():
             bb.emit_func_output(gv)
 
 
+def test_grouped_matmul():
+    m = tvm.tir.Var("m", "int64")
+    x = relax.Var("x", [m, 16], relax.DynTensorType(ndim=2, dtype="float16"))
+    w = relax.Var("w", [4, 32, 16], relax.DynTensorType(ndim=3, dtype="float16"))
+    indptr = relax.Var("indptr", [5], relax.DynTensorType(ndim=1, dtype="int64"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w, indptr]):
+        gv = bb.emit(
+            relax.op.nn.grouped_matmul(x, w, indptr, transpose_w=True, out_dtype="float32")
+        )
+        bb.emit_func_output(gv)
+
+    assert gv.shape_.values[0].same_as(m) and int(gv.shape_.values[1]) == 32
+    assert gv.checked_type.ndim == 2 and gv.checked_type.dtype == "float32"
+
+
+def test_grouped_matmul_fail_on_incompatible_groups():
+    x = relax.Var("x", [8, 16], relax.DynTensorType(ndim=2, dtype="float32"))
+    w = relax.Var("w", [4, 16, 32], relax.DynTensorType(ndim=3, dtype="float32"))
+    indptr = relax.Var("indptr", [4], relax.DynTensorType(ndim=1, dtype="int64"))
+    bb = relax.BlockBuilder()
+    with pytest.raises(DiagnosticError):
+        with bb.function("main", [x, w, indptr]):
+            gv = bb.emit(relax.op.nn.grouped_matmul(x, w, indptr))
+            bb.emit_func_output(gv)
+
+
+def test_attention():
+    s = tvm.tir.Var("s", "int64")
+    q = relax.Var("q", [2, s, 4, 16], relax.DynTensorType(ndim=4, dtype="float16"))
+    k = relax.Var("k", [2, 10, 4, 16], relax.DynTensorType(ndim=4, dtype="float16"))
+    v = relax.Var("v", [2, 10, 4, 8], relax.DynTensorType(ndim=4, dtype="float16"))
+    bias = relax.Var("bias", [1, 4, s, 10], relax.DynTensorType(ndim=4, dtype="float16"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [q, k, v, bias]):
+        gv = bb.emit(relax.op.nn.attention(q, k, v, bias, causal_mask="TopLeft"))
+        bb.emit_func_output(gv)
+
+    assert [str(dim) for dim in gv.shape_.values] == ["2", "s", "4", "8"]
+    assert gv.checked_type.ndim == 4 and gv.checked_type.dtype == "float16"
+
+
+def test_attention_fail_on_incompatible_heads():
+    q = relax.Var("q", [2, 6, 4, 16], relax.DynTensorType(ndim=4, dtype="float32"))
+    k = relax.Var("k", [2, 10, 3, 16], relax.DynTensorType(ndim=4, dtype="float32"))
+    v = relax.Var("v", [2, 10, 4, 8], relax.DynTensorType(ndim=4, dtype="float32"))
+    bb = relax.BlockBuilder()
+    with pytest.raises(DiagnosticError):
+        with bb.function("main", [q, k, v]):
+            gv = bb.emit(relax.op.nn.attention(q, k, v))
+            bb.emit_func_output(gv)
+
+
+def test_rms_norm_with_residual():
+    n = tvm.tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4, 64], relax.DynTensorType(ndim=3, dtype="float16"))
+    weight = relax.Var("weight", [64], relax.DynTensorType(ndim=1, dtype="float16"))
+    residual = relax.Var("residual", [n, 4, 64], relax.DynTensorType(ndim=3, dtype="float16"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, weight, residual]):
+        gv = bb.emit(relax.op.nn.rms_norm(x, weight, residual, out_dtype="float32"))
+        bb.emit_func_output(gv)
+
+    assert [str(dim) for dim in gv.shape_[0].values] == ["n", "4", "64"]
+    assert gv.checked_type.fields[0].dtype == "float32"
+    assert gv.checked_type.fields[1].dtype == "float16"
+
+
+def test_fused_layer_norm_fail_on_leading_axis():
+    x = relax.Var("x", [2, 4, 64], relax.DynTensorType(ndim=3, dtype="float32"))
+    gamma = relax.Var("gamma", [4], relax.DynTensorType(ndim=1, dtype="float32"))
+    beta = relax.Var("beta", [4], relax.DynTensorType(ndim=1, dtype="float32"))
+    bb = relax.BlockBuilder()
+    with pytest.raises(DiagnosticError):
+        with bb.function("main", [x, gamma, beta]):
+            gv = bb.emit(relax.op.nn.fused_layer_norm(x, gamma, beta, axis=1))
+            bb.emit_func_output(gv)
+
+
+def test_quantized_dense():
+    n = tvm.tir.Var("n", "int64")
+    w = relax.Var("w", [24, 64], relax.DynTensorType(ndim=2, dtype="float16"))
+    x = relax.Var("x", [n, 3, 64], relax.DynTensorType(ndim=3, dtype="float16"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w]):
+        quantized = bb.emit(relax.op.nn.quantize_weight(w, bits=4, group_size=32))
+        packed = bb.emit(relax.TupleGetItem(quantized, 0))
+        scale = bb.emit(relax.TupleGetItem(quantized, 1))
+        gv = bb.emit(relax.op.nn.quantized_dense(x, packed, scale, bits=4, group_size=32))
+        bb.emit_func_output(gv)
+
+    assert [str(dim) for dim in packed.shape_.values] == ["24", "32"]
+    assert packed.checked_type.dtype == "uint8"
+    assert [str(dim) for dim in scale.shape_.values] == ["24", "2"]
+    assert scale.checked_type.dtype == "float16"
+    assert [str(dim) for dim in gv.shape_.values] == ["n", "3", "24"]
+    assert gv.checked_type.dtype == "float16"
+
+
+def test_quantize_weight_fail_on_ungrouped_rows():
+    w = relax.Var("w", [24, 40], relax.DynTensorType(ndim=2, dtype="float32"))
+    bb = relax.BlockBuilder()
+    with pytest.raises(DiagnosticError):
+        with bb.function("main", [w]):
+            gv = bb.emit(relax.op.nn.quantize_weight(w, bits=4, group_size=32))
+            bb.emit_func_output(gv)
+
+
+def test_sparse_dense_2in4():
+    n = tvm.tir.Var("n", "int64")
+    w = relax.Var("w", [32, 64], relax.DynTensorType(ndim=2, dtype="float16"))
+    x = relax.Var("x", [n, 3, 64], relax.DynTensorType(ndim=3, dtype="float16"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w]):
+        packed = bb.emit(relax.op.nn.sparse_pack_2in4(w))
+        values = bb.emit(relax.TupleGetItem(packed, 0))
+        metadata = bb.emit(relax.TupleGetItem(packed, 1))
+        gv = bb.emit(relax.op.nn.sparse_dense_2in4(x, values, metadata, out_dtype="float32"))
+        bb.emit_func_output(gv)
+
+    assert [str(dim) for dim in values.shape_.values] == ["32", "32"]
+    assert values.checked_type.dtype == "float16"
+    assert [str(dim) for dim in metadata.shape_.values] == ["2", "4", "8"]
+    assert metadata.checked_type.dtype == "uint32"
+    assert [str(dim) for dim in gv.shape_.values] == ["n", "3", "32"]
+    assert gv.checked_type.dtype == "float32"
+
+
+def test_sparse_pack_2in4_fail_on_untiled_dims():
+    w = relax.Var("w", [24, 64], relax.DynTensorType(ndim=2, dtype="float16"))
+    bb = relax.BlockBuilder()
+    with pytest.raises(DiagnosticError):
+        with bb.function("main", [w]):
+            gv = bb.emit(relax.op.nn.sparse_pack_2in4(w))
+            bb.emit_func_output(gv)
+
+
 def test_adaptive_avg_pool2d():
     @R.function
     def expected(x: R.Tensor((2, 64, 8, 9), "float32")) -> R.Tensor(None, "float32", ndim=4):
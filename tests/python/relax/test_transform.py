@@ -321,6 +321,30 @@ def test_call_tir_rewrite():
     assert s2.op.global_symbol == "test.op.identity"
 
 
+def test_call_tir_rewrite_device_copy():
+    @tvm.script.ir_module
+    class TestCallTIRRewriteDeviceCopy:
+        @R.function
+        def foo(x: R.Tensor(("m", "n"), "float32")):
+            m, n = T.var("int64"), T.var("int64")
+            y = R.device_copy(x, dst_device_index=1)
+            gv0 = R.call_tir("test.op.identity", (y,), (m, n), dtype="float32")
+            gv1 = R.call_tir("test.op.identity", (gv0,), (m, n), dtype="float32")
+            gv2 = R.call_tir("test.op.identity", (x,), (m, n), dtype="float32")
+            return (gv1, gv2)
+
+    new_mod = relax.transform.CallTIRRewrite()(TestCallTIRRewriteDeviceCopy)
+    devices = [
+        binding.value.attrs.runtime_device_index
+        for binding in new_mod["foo"].body.blocks[0].bindings
+        if isinstance(binding.value, relax.Call)
+        and isinstance(binding.value.op, tvm.ir.Op)
+        and binding.value.op.name == "relax.builtin.alloc_tensor"
+    ]
+    # The outputs follow their first argument onto the device it is copied to.
+    assert devices == [1, 1, 0]
+
+
 def test_vm_memory_lower():
     @tvm.script.ir_module
     class TestVMMemoryLower:
@@ -355,6 +379,58 @@ def test_vm_memory_lower():
     assert s4.op.global_symbol == "test.op.identity"
 
 
+def test_vm_stream_assign():
+    @tvm.script.ir_module
+    class TestVMStreamAssign:
+        @T.prim_func
+        def tir_add(
+            x: T.Buffer[(4,), "float32"], y: T.Buffer[(4,), "float32"], z: T.Buffer[(4,), "float32"]
+        ) -> None:
+            T.func_attr({"global_symbol": "tir_add"})
+            for i in T.serial(4):
+                with T.block("add"):
+                    vi = T.axis.spatial(4, i)
+                    z[vi] = x[vi] + y[vi]
+
+        @R.function
+        def foo(x: R.Tensor((4,), "float32"), y: R.Tensor((4,), "float32")):
+            lv0 = R.call_tir(tir_add, (x, y), (4,), dtype="float32")
+            lv1 = R.call_tir(tir_add, (x, y), (4,), dtype="float32")
+            gv0 = R.call_tir(tir_add, (lv0, lv1), (4,), dtype="float32")
+            return gv0
+
+    lowered = tvm.transform.Sequential(
+        [
+            relax.transform.ToNonDataflow(),
+            relax.transform.CallTIRRewrite(),
+            relax.transform.VMMemoryLower(),
+        ]
+    )(TestVMStreamAssign)
+    with tvm.transform.PassContext(config={"relax.VMStreamAssign.num_streams": 2}):
+        new_mod = relax.transform.VMStreamAssign()(lowered)
+
+    issued = []
+    for binding in new_mod["foo"].body.blocks[0].bindings:
+        value = binding.value
+        if isinstance(value, relax.Call) and isinstance(value.op, relax.ExternFunc):
+            issued.append((value.op.global_symbol, [int(v) for v in value.args[0].values]))
+        elif isinstance(value, relax.Call) and isinstance(value.op, relax.GlobalVar):
+            issued.append(value.op.name_hint)
+    assert issued == [
+        ("vm.builtin.stream_sync", [0, 1]),
+        "tir_add",
+        ("vm.builtin.stream_switch", [1]),
+        "tir_add",
+        ("vm.builtin.stream_sync", [0, 1]),
+        "tir_add",
+        ("vm.builtin.stream_sync", [1, 0]),
+        ("vm.builtin.stream_switch", [0]),
+    ]
+
+    # a single stream leaves the function untouched
+    assert_structural_equal(relax.transform.VMStreamAssign()(lowered), lowered)
+
+
 def test_vm_shape_lowering():
     @tvm.script.ir_module
     class TestVMShapeLower:
@@ -392,6 +468,71 @@ def test_vm_shape_lowering():
     assert s5.op.name == "relax.vm.builtin.load_shape"
 
 
+def test_vm_shape_lowering_fused_shape_func():
+    @tvm.script.ir_module
+    class TestVMShapeLower:
+        @R.function
+        def foo(x: R.Tensor(dtype="float32")):
+            m, n = T.var("int64"), T.var("int64")
+            R.match_shape(x, (n, m))
+            lv0 = R.call_tir("test.op.identity", (x,), (n * 2, m), dtype="float32")
+            lv1 = R.call_tir("test.op.identity", (lv0,), (n * 2, m * 3), dtype="float32")
+            gv0 = R.call_tir("test.op.identity", (lv1,), (n, m * 3), dtype="float32")
+            return gv0
+
+    new_mod = relax.transform.VMShapeLower()(TestVMShapeLower)
+
+    # all the shapes after the match_shape are computed by a single shape function
+    shape_funcs = [gv for gv in new_mod.get_global_vars() if gv.name_hint.startswith("shape_func")]
+    assert len(shape_funcs) == 1
+    calls = [
+        binding.value
+        for block in new_mod["foo"].body.blocks
+        for binding in block.bindings
+        if isinstance(binding.value, relax.Call)
+    ]
+    assert len([call for call in calls if call.op == shape_funcs[0]]) == 1
+    load_shape_calls = [
+        call
+        for call in calls
+        if isinstance(call.op, tvm.ir.Op) and call.op.name == "relax.vm.builtin.load_shape"
+    ]
+    assert len(load_shape_calls) >= 3
+
+
+def test_vm_shape_lowering_if_branches():
+    n, m = tvm.tir.Var("n", "int64"), tvm.tir.Var("m", "int64")
+    x = relax.Var("x", [n, m], relax.DynTensorType(2, "float32"))
+    cond = relax.Var("cond", [], relax.DynTensorType(0, "bool"))
+    bb = relax.BlockBuilder()
+    with bb.function("foo", [x, cond]):
+        bb.emit(relax.If(cond, relax.ShapeExpr([n * 2, m]), relax.ShapeExpr([n, m * 3])))
+        gv0 = bb.emit(relax.call_tir("test.op.identity", (x,), (n * 2, m), dtype="float32"))
+        bb.emit_func_output(gv0)
+
+    new_mod = relax.transform.VMShapeLower()(bb.get())
+
+    def shape_func_calls(bindings):
+        return [
+            binding.value
+            for binding in bindings
+            if isinstance(binding.value, relax.Call)
+            and isinstance(binding.value.op, tvm.ir.GlobalVar)
+            and binding.value.op.name_hint.startswith("shape_func")
+        ]
+
+    bindings = [binding for block in new_mod["foo"].body.blocks for binding in block.bindings]
+    (if_index,) = [i for i, binding in enumerate(bindings) if isinstance(binding.value, relax.If)]
+    if_node = bindings[if_index].value
+    # each branch computes its own shape
+    for branch in [if_node.true_branch, if_node.false_branch]:
+        assert isinstance(branch, relax.SeqExpr)
+        assert len(shape_func_calls(branch.blocks[0].bindings)) == 1
+    # the shape computed by the true branch is computed again after the if, as the false
+    # branch may run instead
+    assert len(shape_func_calls(bindings[if_index + 1 :])) == 1
+
+
 def test_vm_static_shape_lowering():
     @tvm.script.ir_module
     class TestVMStaticShapeLower:
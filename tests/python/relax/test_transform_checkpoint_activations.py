@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax, topi
+
+
+def _forward_backward():
+    # Every tensor takes 64 bytes, and 5 of them are live at lv4.
+    x = relax.Var("x", (4, 4), relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.exp, x)
+            lv1 = bb.emit_te(topi.nn.relu, lv0)
+            lv2 = bb.emit_te(topi.exp, lv1)
+            lv3 = bb.emit_te(topi.nn.relu, lv2)
+            lv4 = bb.emit_te(topi.add, lv3, lv2)
+            lv5 = bb.emit_te(topi.multiply, lv4, lv1)
+            gv = bb.emit_output(bb.emit_te(topi.add, lv5, lv0))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def _reference(x_np):
+    lv0 = np.exp(x_np)
+    lv1 = np.maximum(lv0, 0.0)
+    lv2 = np.exp(lv1)
+    lv3 = np.maximum(lv2, 0.0)
+    return (lv3 + lv2) * lv1 + lv0
+
+
+def _bindings(func):
+    return [binding for block in func.body.blocks for binding in block.bindings]
+
+
+def test_recompute_at_late_use():
+    mod = _forward_backward()
+    after = relax.transform.CheckpointActivations(memory_budget=256)(mod)
+    before_bindings = _bindings(mod["main"])
+    after_bindings = _bindings(after["main"])
+    assert len(after_bindings) == len(before_bindings) + 1
+    # exp(x) is recomputed right before the last add, from the parameter
+    remat, last = after_bindings[-3:-1]
+    assert remat.var.name_hint.endswith("_remat")
+    tvm.ir.assert_structural_equal(remat.value, before_bindings[0].value)
+    assert last.value.args[1][1].same_as(remat.var)
+    assert after_bindings[1].value.args[1][0].same_as(after_bindings[0].var)
+
+    # relu(exp(x)) is not recomputed for a lower budget, since exp(x) is dead by then
+    lower = relax.transform.CheckpointActivations(memory_budget=192)(mod)
+    tvm.ir.assert_structural_equal(lower, after)
+
+
+def test_fits_budget():
+    mod = _forward_backward()
+    after = relax.transform.CheckpointActivations(memory_budget=320)(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+    # the pass does nothing without a budget
+    tvm.ir.assert_structural_equal(relax.transform.CheckpointActivations()(mod), mod)
+
+
+def test_build_with_budget():
+    mod = _forward_backward()
+    with tvm.transform.PassContext(config={"relax.CheckpointActivations.memory_budget": 256}):
+        ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_np = np.random.rand(4, 4).astype("float32")
+    res = vm["main"](tvm.nd.array(x_np))
+    tvm.testing.assert_allclose(res.numpy(), _reference(x_np), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
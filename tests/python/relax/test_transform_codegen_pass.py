@@ -213,6 +213,46 @@ def test_mix_use_tensorrt_and_tvm():
     check_roundtrip(ex0, dev, inputs, expected)
 
 
+@tvm.testing.requires_gpu
+def test_engine_built_at_compile_time():
+    @tvm.script.ir_module
+    class InputModule:
+        @R.function
+        def relax_func(
+            x: R.Tensor((16, 16), "float32"), y: R.Tensor((16, 16), "float32")
+        ) -> R.Tensor((16, 16), "float32"):
+            z1 = relax.multiply(x, y)
+            z2 = relax.add(z1, z1)
+            return z2
+
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"), y: R.Tensor((16, 16), "float32")
+        ) -> R.Tensor((16, 16), "float32"):
+            lv0: R.Tensor((16, 16), "float32") = relax_func(x, y)
+            return lv0
+
+    mod = InputModule
+    np0 = np.random.rand(16, 16).astype(np.float32)
+    np1 = np.random.rand(16, 16).astype(np.float32)
+    inputs = [tvm.nd.array(np0, dev), tvm.nd.array(np1, dev)]
+    expected = tvm.nd.array(np0 * np1 * 2, dev)
+
+    new_relax_func = mod["relax_func"].with_attr("Codegen", "tensorrt")
+    new_relax_func = new_relax_func.with_attr("global_symbol", "trt_relax_func")
+    mod["relax_func"] = new_relax_func
+
+    # The engine is serialized in the exported library, and deserialized with the loaded one.
+    config = {"relax.ext.tensorrt.options": {"build_engine_at_compile_time": True}}
+    with tvm.transform.PassContext(config=config):
+        seq = tvm.transform.Sequential(
+            [relax.transform.RunCodegen(), relax.transform.RemoveUnusedFunctions()]
+        )
+        new_mod = seq(mod)
+    ex0 = relax.vm.build(new_mod, target, params={})
+    check_roundtrip(ex0, dev, inputs, expected)
+
+
 # TODO(@sunggg):  test with more complex patterns (e.g., multiple annots, mixed codegens, different ops, const binding)
 
 if __name__ == "__main__":
@@ -1202,6 +1202,64 @@ def test_conv2d_resize2d():
     tvm.ir.assert_structural_equal(mod, conv2d_resize2d)
 
 
+def _num_transposes(func):
+    transpose_op = tvm.ir.Op.get("relax.transpose")
+    return sum(
+        1
+        for block in func.body.blocks
+        for binding in block.bindings
+        if isinstance(binding.value, relax.Call) and binding.value.op == transpose_op
+    )
+
+
+def test_global_assignment():
+    @I.ir_module
+    class Conv2dAdd:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3, 28, 28), "float32"),
+            w: R.Tensor((4, 3, 3, 3), "float32"),
+            bias: R.Tensor((2, 4, 26, 26), "float32"),
+        ) -> R.Tensor(None, "float32", ndim=4):
+            gv: R.Tensor((2, 4, 26, 26), "float32") = R.nn.conv2d(
+                x, w, kernel_size=[3, 3], out_dtype="float32"
+            )
+            gv2: R.Tensor((2, 4, 26, 26), "float32") = R.add(gv, bias)
+            return gv2
+
+    desired_layouts = {"relax.nn.conv2d": ["NHWC", "OHWI"]}
+    greedy = ConvertLayout(desired_layouts)(Conv2dAdd)
+    planned = ConvertLayout(desired_layouts, global_assignment=True)(Conv2dAdd)
+    # Converting the add transposes both the bias and the output, rather than the conv2d output.
+    assert _num_transposes(greedy["main"]) == 4
+    assert _num_transposes(planned["main"]) == 3
+    add = planned["main"].body.blocks[0].bindings[-1].value
+    assert add.op == tvm.ir.Op.get("relax.add")
+    assert add.args[1].same_as(planned["main"].params[2])
+
+    @I.ir_module
+    class Conv2dAddReLUConv2d:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3, 28, 28), "float32"),
+            w: R.Tensor((4, 3, 3, 3), "float32"),
+            bias: R.Tensor((2, 4, 26, 26), "float32"),
+        ) -> R.Tensor(None, "float32", ndim=4):
+            gv: R.Tensor((2, 4, 26, 26), "float32") = R.nn.conv2d(
+                x, w, kernel_size=[3, 3], out_dtype="float32"
+            )
+            gv2: R.Tensor((2, 4, 26, 26), "float32") = R.add(gv, bias)
+            gv3: R.Tensor((2, 4, 26, 26), "float32") = R.nn.relu(gv2)
+            gv4: R.Tensor((2, 4, 24, 24), "float32") = R.nn.conv2d(
+                gv3, w, kernel_size=[3, 3], out_dtype="float32"
+            )
+            return gv4
+
+    # Between two conv2ds, the ops follow the converted layout as greedily.
+    planned = ConvertLayout(desired_layouts, global_assignment=True)(Conv2dAddReLUConv2d)
+    tvm.ir.assert_structural_equal(planned, conv2d_add_relu_conv2d)
+
+
 if __name__ == "__main__":
     test_conv2d()
     test_conv2d_relu()
@@ -1226,3 +1284,4 @@ if __name__ == "__main__":
     test_conv2d_batchnorm()
     test_conv2d_layernorm()
     test_conv2d_resize2d()
+    test_global_assignment()
@@ -0,0 +1,131 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax, tir
+from tvm.relax.cublaslt import partition_for_cublaslt
+
+has_cublaslt = pytest.mark.skipif(
+    not tvm.get_global_func("tvm.contrib.cublaslt.matmul_bias", True),
+    reason="cuBLASLt fused matmul not enabled",
+)
+
+
+def get_dense_bias_module(batch, activation, dtype="float16"):
+    type_anno = relax.DynTensorType(ndim=2, dtype=dtype)
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [batch, 64], type_anno)
+    w = relax.Var("w", [32, 64], type_anno)
+    b = relax.Var("b", [32], relax.DynTensorType(ndim=1, dtype=dtype))
+    with bb.function("main", [x, w, b]):
+        with bb.dataflow():
+            out = bb.emit(relax.op.nn.dense(x, w))
+            out = relax.op.add(out, b)
+            if activation is not None:
+                out = activation(bb.emit(out))
+            out = bb.emit_output(out)
+        bb.emit_func_output(out)
+    return bb.get()
+
+
+def get_codegen_funcs(mod):
+    return [
+        func
+        for func in mod.functions.values()
+        if isinstance(func, relax.Function) and func.attrs and "Codegen" in func.attrs
+    ]
+
+
+def test_partition_dense_bias_relu():
+    mod = partition_for_cublaslt(get_dense_bias_module(tir.Var("n", "int64"), relax.op.nn.relu))
+    funcs = get_codegen_funcs(mod)
+    assert len(funcs) == 1
+    assert funcs[0].attrs["Codegen"] == "cublaslt"
+    ops = [binding.value.op.name for binding in funcs[0].body.blocks[0].bindings]
+    assert ops == ["relax.nn.dense", "relax.add", "relax.nn.relu"]
+    # The chain is replaced by one call, with the operands of the kernel.
+    bindings = mod["main"].body.blocks[0].bindings
+    assert len(bindings) == 1
+    assert len(bindings[0].value.args) == 3
+
+
+@pytest.mark.parametrize("approximate_gelu", [False, True])
+def test_partition_dense_bias_gelu(approximate_gelu):
+    mod = get_dense_bias_module(tir.Var("n", "int64"), relax.op.nn.gelu)
+    funcs = get_codegen_funcs(partition_for_cublaslt(mod, approximate_gelu=approximate_gelu))
+    assert len(funcs) == 1
+    ops = [binding.value.op.name for binding in funcs[0].body.blocks[0].bindings]
+    # The exact gelu is left out of the epilogue, which is its tanh approximation.
+    expected = ["relax.nn.dense", "relax.add"] + (["relax.nn.gelu"] if approximate_gelu else [])
+    assert ops == expected
+
+
+def test_partition_skips_shared_intermediate():
+    type_anno = relax.DynTensorType(ndim=2, dtype="float16")
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 64], type_anno)
+    w = relax.Var("w", [32, 64], type_anno)
+    with bb.function("main", [x, w]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.nn.dense(x, w))
+            lv1 = bb.emit(relax.op.nn.relu(lv0))
+            out = bb.emit_output(relax.op.add(lv0, lv1))
+        bb.emit_func_output(out)
+    mod = partition_for_cublaslt(bb.get())
+    # The dense result is also used by the add, so only the dense is offloaded.
+    funcs = get_codegen_funcs(mod)
+    assert len(funcs) == 1
+    ops = [binding.value.op.name for binding in funcs[0].body.blocks[0].bindings]
+    assert ops == ["relax.nn.dense"]
+
+
+@tvm.testing.requires_cuda
+@has_cublaslt
+@pytest.mark.parametrize("activation", [None, "relu", "gelu"])
+def test_dense_bias_activation_dynamic_batch(activation):
+    ops = {"relu": relax.op.nn.relu, "gelu": relax.op.nn.gelu}
+    mod = get_dense_bias_module(tir.Var("n", "int64"), ops.get(activation))
+    seq = tvm.transform.Sequential(
+        [relax.transform.RunCodegen(), relax.transform.RemoveUnusedFunctions()]
+    )
+    target = tvm.target.Target("cuda")
+    ex = relax.vm.build(seq(partition_for_cublaslt(mod, approximate_gelu=True)), target)
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev)
+
+    w_np = np.random.uniform(-1, 1, (32, 64)).astype("float16")
+    b_np = np.random.uniform(-1, 1, (32,)).astype("float16")
+    # The plan of each batch size is created once, and reused when the batch size comes back.
+    for batch in [8, 3, 8]:
+        x_np = np.random.uniform(-1, 1, (batch, 64)).astype("float16")
+        out = vm["main"](tvm.nd.array(x_np, dev), tvm.nd.array(w_np, dev), tvm.nd.array(b_np, dev))
+        expected = x_np.astype("float32") @ w_np.astype("float32").T + b_np.astype("float32")
+        if activation == "relu":
+            expected = np.maximum(expected, 0)
+        elif activation == "gelu":
+            # The tanh approximation of the GELU epilogue, opted in by approximate_gelu.
+            inner = np.sqrt(2 / np.pi) * (expected + 0.044715 * expected**3)
+            expected = 0.5 * expected * (1 + np.tanh(inner))
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-2, atol=1e-2)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
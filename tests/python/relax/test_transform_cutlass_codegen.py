@@ -338,6 +338,54 @@ def test_cutlass_conv2d():
                 counter += 1
 
 
+def constructAttention(b, s, s_kv, n, h, h_v, causal_mask):
+    shapes = [(b, s, n, h), (b, s_kv, n, h), (b, s_kv, n, h_v)]
+    params = [
+        relax.Var(name, shape, relax.DynTensorType(ndim=4, dtype="float16"))
+        for name, shape in zip(["q", "k", "v"], shapes)
+    ]
+    bb = relax.BlockBuilder()
+    with bb.function("main", params):
+        gv = bb.emit(relax.op.nn.attention(*params, causal_mask=causal_mask))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_cutlass_attention():
+    b, s, s_kv, n, h, h_v = 2, 100, 120, 4, 64, 64
+    for causal_mask in [None, "BottomRight"]:
+        mod = tvm.relax.cutlass.partition_for_cutlass_attention(
+            constructAttention(b, s, s_kv, n, h, h_v, causal_mask)
+        )
+        names = [gv.name_hint for gv in mod.get_global_vars()]
+        assert any(name.startswith("fused_attention_cutlass") for name in names)
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            with tvm.target.Target("cutlass -sm=80 -tmp_dir=%s" % tmp_dir):
+                mod = relax.transform.RunCodegen()(mod)
+            mod = relax.transform.RemoveUnusedFunctions()(mod)
+            executable = relax_build(OperatorLegalizer(mod).transform(), target)
+            executable.mod.export_library(PKG_FILE, cc="nvcc")
+        dev = tvm.cuda()
+        q = np.random.uniform(-1, 1, (b, s, n, h)).astype("float16")
+        k = np.random.uniform(-1, 1, (b, s_kv, n, h)).astype("float16")
+        v = np.random.uniform(-1, 1, (b, s_kv, n, h_v)).astype("float16")
+        result = f_run(
+            tvm.runtime.load_module(PKG_FILE),
+            dev,
+            *[tvm.nd.array(x, dev) for x in [q, k, v]],
+        )
+
+        scores = np.einsum("bqnh,bknh->bnqk", q.astype("float32"), k.astype("float32"))
+        scores = scores / np.sqrt(h)
+        if causal_mask:
+            mask = np.arange(s_kv)[None, :] <= np.arange(s)[:, None] + s_kv - s
+            scores = np.where(mask, scores, -np.inf)
+        probs = np.exp(scores - scores.max(axis=-1, keepdims=True))
+        probs = probs / probs.sum(axis=-1, keepdims=True)
+        expected = np.einsum("bnqk,bknh->bqnh", probs, v.astype("float32"))
+        np.testing.assert_allclose(result.numpy(), expected, rtol=1e-2, atol=1e-2)
+
+
 if __name__ == "__main__":
     test_cutlass_dense()
     test_cutlass_dense_bias()
@@ -347,3 +395,4 @@ if __name__ == "__main__":
     test_cutlass_batch_dense_bias()
     test_cutlass_batch_dense2_bias()
     test_cutlass_conv2d()
+    test_cutlass_attention()
@@ -0,0 +1,121 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.ir import assert_structural_equal
+
+import tvm.script
+from tvm.script import tir as T, relax as R
+
+
+def test_merge_equal_prim_funcs():
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def exp1(x: T.handle, y: T.handle) -> None:
+            T.func_attr({"global_symbol": "exp1"})
+            A = T.match_buffer(x, (4, 4))
+            B = T.match_buffer(y, (4, 4))
+            for i, j in T.grid(4, 4):
+                with T.block("exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.exp(A[vi, vj])
+
+        @T.prim_func
+        def exp(x: T.handle, y: T.handle) -> None:
+            T.func_attr({"global_symbol": "exp"})
+            A = T.match_buffer(x, (4, 4))
+            B = T.match_buffer(y, (4, 4))
+            for i, j in T.grid(4, 4):
+                with T.block("exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.exp(A[vi, vj])
+
+        @T.prim_func
+        def log(x: T.handle, y: T.handle) -> None:
+            T.func_attr({"global_symbol": "log"})
+            A = T.match_buffer(x, (4, 4))
+            B = T.match_buffer(y, (4, 4))
+            for i, j in T.grid(4, 4):
+                with T.block("log"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.log(A[vi, vj])
+
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32")) -> R.Tensor:
+            gv0 = R.call_tir("exp", (x,), (4, 4), dtype="float32")
+            gv1 = R.call_tir("exp1", (gv0,), (4, 4), dtype="float32")
+            gv2 = R.call_tir("log", (gv1,), (4, 4), dtype="float32")
+            return gv2
+
+    @tvm.script.ir_module
+    class Expected:
+        @T.prim_func
+        def exp(x: T.handle, y: T.handle) -> None:
+            T.func_attr({"global_symbol": "exp"})
+            A = T.match_buffer(x, (4, 4))
+            B = T.match_buffer(y, (4, 4))
+            for i, j in T.grid(4, 4):
+                with T.block("exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.exp(A[vi, vj])
+
+        @T.prim_func
+        def log(x: T.handle, y: T.handle) -> None:
+            T.func_attr({"global_symbol": "log"})
+            A = T.match_buffer(x, (4, 4))
+            B = T.match_buffer(y, (4, 4))
+            for i, j in T.grid(4, 4):
+                with T.block("log"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.log(A[vi, vj])
+
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32")) -> R.Tensor:
+            gv0 = R.call_tir("exp", (x,), (4, 4), dtype="float32")
+            gv1 = R.call_tir("exp", (gv0,), (4, 4), dtype="float32")
+            gv2 = R.call_tir("log", (gv1,), (4, 4), dtype="float32")
+            return gv2
+
+    after = relax.transform.DeduplicatePrimFuncs()(Before)
+    assert_structural_equal(after, Expected)
+
+
+def test_no_duplicate():
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def exp(x: T.handle, y: T.handle) -> None:
+            A = T.match_buffer(x, (4, 4))
+            B = T.match_buffer(y, (4, 4))
+            for i, j in T.grid(4, 4):
+                with T.block("exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.exp(A[vi, vj])
+
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32")) -> R.Tensor:
+            gv0 = R.call_tir("exp", (x,), (4, 4), dtype="float32")
+            return gv0
+
+    after = relax.transform.DeduplicatePrimFuncs()(Before)
+    assert after.same_as(Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax, tir
+
+has_dnnl_codegen = pytest.mark.skipif(
+    not tvm.get_global_func("relax.ext.dnnl", True),
+    reason="DNNL codegen not available",
+)
+has_dnnl_runtime = pytest.mark.skipif(
+    not tvm.get_global_func("runtime.DNNLJSONRuntimeCreate", True),
+    reason="DNNL runtime not available",
+)
+
+pytestmark = [has_dnnl_codegen, has_dnnl_runtime]
+
+
+def get_dense_relu_module(batch):
+    type_anno = relax.DynTensorType(ndim=2, dtype="float32")
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [batch, 16], type_anno)
+    w = relax.Var("w", [8, 16], type_anno)
+    attrs = {"Codegen": "dnnl", "global_symbol": "dnnl_dense_relu"}
+    with bb.function("dense_relu", [x, w], attrs):
+        lv0 = bb.emit(relax.op.nn.dense(x, w))
+        bb.emit_func_output(bb.emit(relax.op.nn.relu(lv0)))
+    dense_relu = bb.get().get_global_var("dense_relu")
+
+    x = relax.Var("x", [batch, 16], type_anno)
+    w = relax.Var("w", [8, 16], type_anno)
+    with bb.function("main", [x, w]):
+        out = bb.emit(relax.Call(dense_relu, [x, w]))
+        bb.emit_func_output(out)
+    return bb.get()
+
+
+def test_dense_relu_dynamic_batch():
+    mod = get_dense_relu_module(tir.Var("n", "int64"))
+    seq = tvm.transform.Sequential(
+        [relax.transform.RunCodegen(), relax.transform.RemoveUnusedFunctions()]
+    )
+    ex = relax.vm.build(seq(mod), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    w_np = np.random.uniform(-1, 1, (8, 16)).astype("float32")
+    # The primitives are built for each batch size, and reused when the batch size comes back.
+    for batch in [2, 5, 2]:
+        x_np = np.random.uniform(-1, 1, (batch, 16)).astype("float32")
+        out = vm["main"](tvm.nd.array(x_np), tvm.nd.array(w_np))
+        expected = np.maximum(x_np @ w_np.T, 0)
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5, atol=1e-5)
+
+
+def test_dense_relu_static():
+    mod = get_dense_relu_module(4)
+    mod = relax.transform.RunCodegen()(mod)
+    ex = relax.vm.build(relax.transform.RemoveUnusedFunctions()(mod), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    x_np = np.random.uniform(-1, 1, (4, 16)).astype("float32")
+    w_np = np.random.uniform(-1, 1, (8, 16)).astype("float32")
+    out = vm["main"](tvm.nd.array(x_np), tvm.nd.array(w_np))
+    tvm.testing.assert_allclose(out.numpy(), np.maximum(x_np @ w_np.T, 0), rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -276,5 +276,58 @@ def test_int32_fold():
     tvm.ir.assert_structural_equal(after, expected)
 
 
+def test_independent_folds_on_device_target():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def addone(A: T.Buffer[(16, 16), "float32"], B: T.Buffer[(16, 16), "float32"]) -> None:
+            for i, j in T.grid(16, 16):
+                with T.block("addone"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @T.prim_func
+        def add(
+            A: T.Buffer[(16, 16), "float32"],
+            B: T.Buffer[(16, 16), "float32"],
+            C: T.Buffer[(16, 16), "float32"],
+        ) -> None:
+            for i, j in T.grid(16, 16):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = A[vi, vj] + B[vi, vj]
+
+        @R.function
+        def before(c0: R.Tensor((16, 16), "float32"), c1: R.Tensor((16, 16), "float32")):
+            lv0 = relax.call_tir(addone, (c0,), (16, 16), dtype="float32")
+            lv1 = relax.call_tir(addone, (c1,), (16, 16), dtype="float32")
+            lv2 = relax.call_tir(add, (lv0, lv1), (16, 16), dtype="float32")
+            return lv2
+
+        @R.function
+        def expected(
+            c2: R.Tensor((16, 16), "float32"),
+            c3: R.Tensor((16, 16), "float32"),
+            c4: R.Tensor((16, 16), "float32"),
+        ):
+            lv0 = c2
+            lv1 = c3
+            lv2 = c4
+            return c4
+
+    c0_np = np.arange((16 * 16)).astype("float32").reshape(16, 16)
+    c1_np = c0_np * 2
+    before = gen_mod(Module, "before", {"c0": c0_np, "c1": c1_np})
+    expected = gen_mod(
+        Module, "expected", {"c2": c0_np + 1, "c3": c1_np + 1, "c4": c0_np + c1_np + 2}
+    )
+
+    # The two addones are evaluated in parallel, and then the add, all on the device target.
+    config = {"relax.FoldConstant.device_target": "llvm", "relax.FoldConstant.device_min_bytes": 0}
+    with tvm.transform.PassContext(config=config):
+        after = relax.transform.FoldConstant()(before)
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -773,5 +773,80 @@ def test_softmax():
     _check(before(), expected())
 
 
+def test_fuse_multiple_dataflow_blocks():
+    """The dataflow blocks are partitioned separately, and the identical groups share a function."""
+
+    def before():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.add, x, relax.const(1, "float32"))
+                gv0 = bb.emit_output(bb.call_te(topi.exp, lv0))
+            with bb.dataflow():
+                lv1 = bb.emit_te(topi.add, gv0, relax.const(1, "float32"))
+                gv1 = bb.emit_output(bb.call_te(topi.exp, lv1))
+            bb.emit_func_output(gv1)
+
+        return bb.get()
+
+    def expected():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+        p0 = relax.Var("p0", (), relax.DynTensorType(0, "float32"))
+
+        with bb.function("fused_add_exp", [x, p0], attrs={"Primitive": 1}):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.add, x, p0)
+                gv = bb.emit_output(bb.call_te(topi.exp, lv0))
+            bb.emit_func_output(gv)
+        fused_add_exp = bb.get().get_global_var("fused_add_exp")
+
+        x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                gv0 = bb.emit_output(relax.Call(fused_add_exp, [x, relax.const(1, "float32")]))
+            with bb.dataflow():
+                gv1 = bb.emit_output(relax.Call(fused_add_exp, [gv0, relax.const(1, "float32")]))
+            bb.emit_func_output(gv1)
+
+        return bb.get()
+
+    _check(before(), expected())
+
+
+def test_fusion_policy():
+    """The fusion policy decides whether to commit the candidate groups."""
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, relax.const(1, "float32"))
+            lv1 = bb.emit_te(topi.exp, lv0)
+            gv = bb.emit_output(bb.call_te(topi.squeeze, lv1))
+        bb.emit_func_output(gv)
+    mod = relax.transform.AnnotateTIROpPattern()(bb.get())
+
+    candidates = []
+
+    def fusion_policy(bindings):
+        candidates.append([binding.var for binding in bindings])
+        # Refuse the groups of more than two bindings.
+        return len(bindings) <= 2
+
+    after = relax.transform.FuseOps(fusion_policy=fusion_policy)(mod)
+    # add is fused into exp, and then the fusion of squeeze is refused in each phase.
+    assert len(candidates[0]) == 2 and all(len(c) == 3 for c in candidates[1:])
+    assert candidates[0][0].same_as(lv0) and candidates[0][1].same_as(lv1)
+
+    fused = [gv for gv, func in after.functions.items() if func.attrs and "Primitive" in func.attrs]
+    assert len(fused) == 1
+    fused_bindings = after[fused[0]].body.blocks[0].bindings
+    assert len(fused_bindings) == 2
+    main_bindings = after["main"].body.blocks[0].bindings
+    assert len(main_bindings) == 2
+    assert main_bindings[0].value.op.same_as(fused[0])
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -572,5 +572,48 @@ def test_fuse_return_partial_result():
     _check(before(), expected())
 
 
+def test_fuse_structurally_equal_subfunctions():
+    def before():
+        bb = relax.BlockBuilder()
+        x1 = relax.Var("x1", [10, 20], relax.DynTensorType(2, "float32"))
+        with bb.function("fused_exp_squeeze", [x1], attrs={"Primitive": True}):
+            with bb.dataflow():
+                lv1 = bb.emit_te(topi.exp, x1)
+                gv = bb.emit_output(bb.call_te(topi.squeeze, lv1))
+            bb.emit_func_output(gv)
+        mod = bb.get()
+        func_gv = mod.get_global_var("fused_exp_squeeze")
+        # The same subfunction under another name, as left by the fusion of identical layers.
+        copy_gv = relax.GlobalVar("fused_exp_squeeze1")
+        relax.expr._update_type(copy_gv, func_gv.checked_type)
+
+        x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit(relax.Call(func_gv, [x]))
+                gv = bb.emit_output(relax.Call(copy_gv, [lv0]))
+            bb.emit_func_output(gv)
+        mod = bb.get()
+        mod[copy_gv] = mod[func_gv]
+        return mod
+
+    def expected():
+        def fused_exp_squeeze(x):
+            exp = topi.exp(x)
+            squeeze = topi.squeeze(exp)
+            return squeeze
+
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(fused_exp_squeeze, x)
+                gv = bb.emit_output(bb.call_te(fused_exp_squeeze, lv0))
+            bb.emit_func_output(gv)
+        return bb.get()
+
+    _check(before(), expected())
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
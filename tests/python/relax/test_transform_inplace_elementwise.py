@@ -0,0 +1,108 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax, topi
+import numpy as np
+
+
+def _lower(mod):
+    mod = relax.transform.ToNonDataflow()(mod)
+    mod = relax.transform.CallTIRRewrite()(mod)
+    return mod
+
+
+def _kernel_calls(func):
+    calls = []
+    for block in func.body.blocks:
+        for binding in block.bindings:
+            value = binding.value
+            if isinstance(value, relax.Call) and isinstance(value.op, tvm.ir.GlobalVar):
+                calls.append(value)
+    return calls
+
+
+def _num_alloc_tensors(func):
+    alloc_tensor_op = tvm.ir.Op.get("relax.builtin.alloc_tensor")
+    return sum(
+        1
+        for block in func.body.blocks
+        for binding in block.bindings
+        if isinstance(binding.value, relax.Call) and binding.value.op == alloc_tensor_op
+    )
+
+
+def test_elementwise_chain():
+    x = relax.Var("x", (2, 4), relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.exp, x)
+            lv1 = bb.emit_te(topi.nn.relu, lv0)
+            gv = bb.emit_output(bb.emit_te(topi.log, lv1))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    before = _lower(mod)
+    after = relax.transform.InplaceElementwise()(before)
+    assert _num_alloc_tensors(before["main"]) == 3
+    # the parameter is not overwritten, relu and log write to the output of exp in place
+    assert _num_alloc_tensors(after["main"]) == 1
+    exp_call, relu_call, log_call = _kernel_calls(after["main"])
+    assert exp_call.args[0].same_as(after["main"].params[0])
+    assert relu_call.args[0].same_as(relu_call.args[1])
+    assert log_call.args[0].same_as(log_call.args[1])
+
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(relax.vm.build(mod, "llvm"), dev)
+    x_np = np.random.rand(2, 4).astype("float32")
+    x_nd = tvm.nd.array(x_np, dev)
+    res = vm["main"](x_nd)
+    tvm.testing.assert_allclose(res.numpy(), np.log(np.maximum(np.exp(x_np), 0.0)), rtol=1e-5)
+    # the input is untouched
+    tvm.testing.assert_allclose(x_nd.numpy(), x_np)
+
+
+def test_live_input_not_reused():
+    x = relax.Var("x", (2, 4), relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.exp, x)
+            lv1 = bb.emit_te(topi.nn.relu, lv0)
+            lv2 = bb.emit_te(topi.add, lv0, lv1)
+            gv = bb.emit_output(bb.emit_te(topi.reshape, lv2, (8,)))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    after = relax.transform.InplaceElementwise()(_lower(mod))
+    _, relu_call, add_call, reshape_call = _kernel_calls(after["main"])
+    # exp's output is still used by add after relu, and reshape is not elementwise
+    assert not relu_call.args[0].same_as(relu_call.args[1])
+    assert add_call.args[0].same_as(add_call.args[2])
+    assert not reshape_call.args[0].same_as(reshape_call.args[1])
+
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(relax.vm.build(mod, "llvm"), dev)
+    x_np = np.random.rand(2, 4).astype("float32")
+    res = vm["main"](tvm.nd.array(x_np, dev))
+    y_np = np.exp(x_np)
+    tvm.testing.assert_allclose(res.numpy(), (y_np + np.maximum(y_np, 0.0)).reshape(8), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax, topi
+from tvm.relax import prepack
+
+
+def _get_module():
+    x = relax.Var("x", (4, 8), relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", (16, 8), relax.DynTensorType(2, "float32"))
+    bias = relax.Var("bias", (16,), relax.DynTensorType(1, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w, bias], attrs={"num_input": 1}):
+        with bb.dataflow():
+            wt = bb.emit_te(topi.transpose, w)
+            lv0 = bb.emit_te(topi.matmul, x, wt)
+            gv = bb.emit_output(bb.emit_te(topi.add, lv0, bias))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_lift_weight_transform():
+    mod = relax.transform.LiftTransformParams()(_get_module())
+    transform_func = mod["main_transform_params"]
+    main = mod["main"]
+    # The transpose is lifted, and the bias is forwarded as it is.
+    assert len(transform_func.params) == 2
+    assert len(transform_func.body.blocks[0].bindings) == 2
+    assert len(main.params) == 3
+    assert [p.shape[0].value for p in main.params[1:]] == [8, 16]
+    assert len(main.body.blocks[0].bindings) == 2
+
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(relax.vm.build(mod, "llvm"), dev)
+    x_np = np.random.rand(4, 8).astype("float32")
+    w_np = np.random.rand(16, 8).astype("float32")
+    bias_np = np.random.rand(16).astype("float32")
+    params = [tvm.nd.array(w_np, dev), tvm.nd.array(bias_np, dev)]
+
+    # The prepacked weights are persisted, and only reloaded for the same weights.
+    param_bytes = prepack.save_prepacked_params(prepack.prepack_params(vm, params), params)
+    prepacked = prepack.load_prepacked_params(param_bytes, params)
+    res = vm["main"](tvm.nd.array(x_np, dev), *prepacked)
+    tvm.testing.assert_allclose(res.numpy(), x_np @ w_np.T + bias_np, rtol=1e-5)
+    with pytest.raises(ValueError):
+        prepack.load_prepacked_params(param_bytes, [params[1], params[0]])
+
+
+def test_no_num_input():
+    mod = _get_module()
+    mod["main"] = mod["main"].without_attr("num_input")
+    after = relax.transform.LiftTransformParams()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -15,8 +15,11 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import os
 import tempfile
 
+import numpy as np
+
 import tvm
 import tvm.testing
 import tvm.meta_schedule as ms
@@ -111,5 +114,135 @@ def test_ms_tuning_primfunc():
             assert not tvm.ir.structural_equal(mod, out_mod)
 
 
+@ms.utils.derived_object
+class ScheduleCountingDatabase(ms.database.PyDatabase):
+    """A database which counts the schedules replayed from the records of another"""
+
+    def __init__(self, database):
+        super().__init__()
+        self.database = database
+        self.num_schedules = 0
+
+    def has_workload(self, mod):
+        return self.database.has_workload(mod)
+
+    def commit_workload(self, mod):
+        return self.database.commit_workload(mod)
+
+    def commit_tuning_record(self, record):
+        self.database.commit_tuning_record(record)
+
+    def get_top_k(self, workload, top_k):
+        return self.database.get_top_k(workload, top_k)
+
+    def get_all_tuning_records(self):
+        return self.database.get_all_tuning_records()
+
+    def query_tuning_record(self, mod, target, workload_name=None):
+        return self.database.query_tuning_record(mod, target, workload_name)
+
+    def query_schedule(self, mod, target, workload_name=None):
+        self.num_schedules += 1
+        return self.database.query_schedule(mod, target, workload_name)
+
+    def query_ir_module(self, mod, target, workload_name=None):
+        self.num_schedules += 1
+        return self.database.query_ir_module(mod, target, workload_name)
+
+    def __len__(self):
+        return len(self.database)
+
+
+def test_ms_apply_database_schedule_cache():
+    mod = InputModule
+    with tempfile.TemporaryDirectory() as work_dir:
+        cache_dir = os.path.join(work_dir, "schedule_cache")
+        os.mkdir(cache_dir)
+        with target, transform.PassContext(opt_level=0):
+            relax.transform.MetaScheduleTuneTIR(work_dir=work_dir, max_trials_global=4)(mod)
+            out_mod = relax.transform.MetaScheduleApplyDatabase(work_dir)(mod)
+        database = ScheduleCountingDatabase(
+            ms.database.JSONDatabase(work_dir=work_dir, allow_missing=False)
+        )
+        config = {"relax.MetaScheduleApplyDatabase.schedule_cache_dir": cache_dir}
+        num_schedules = []
+        for _ in range(2):
+            with target, database, transform.PassContext(opt_level=0, config=config):
+                cached_mod = relax.transform.MetaScheduleApplyDatabase()(mod)
+            tvm.ir.assert_structural_equal(out_mod, cached_mod)
+            num_schedules.append(database.num_schedules)
+        # The first build replays the scheduled PrimFuncs and caches them, the second one loads
+        # them from the cache without replaying any record
+        assert num_schedules[0] > 0
+        assert num_schedules[0] == num_schedules[1]
+        assert len(os.listdir(cache_dir)) == num_schedules[0]
+
+
+@tvm.script.ir_module
+class DynamicModule:
+    @T.prim_func
+    def tir_matmul(x: T.handle, y: T.handle, z: T.handle) -> None:
+        T.func_attr({"global_symbol": "tir_matmul"})
+        n = T.var("int64")
+        A = T.match_buffer(x, (n, 32))
+        B = T.match_buffer(y, (32, 32))
+        C = T.match_buffer(z, (n, 32))
+
+        for (i0, j0, k0) in T.grid(n, 32, 32):
+            with T.block():
+                i, j, k = T.axis.remap("SSR", [i0, j0, k0])
+                with T.init():
+                    C[i, j] = 0.0
+                C[i, j] += A[i, k] * B[j, k]
+
+    @R.function
+    def main(x: R.Tensor(dtype="float32"), w: R.Tensor((32, 32), "float32")) -> R.Tensor:
+        with R.dataflow():
+            n = T.var("int64")
+            R.match_shape(x, (n, 32))
+            lv0 = R.call_tir(tir_matmul, (x, w), (n, 32), dtype="float32")
+            R.output(lv0)
+        return lv0
+
+
+def test_ms_shape_bucket_tuning():
+    mod = DynamicModule
+    shape_buckets = {"n": [64, 16]}
+    tasks = ms.relax_integration.extract_tasks(mod, target, shape_buckets=shape_buckets)
+    assert sorted(task.task_name for task in tasks) == ["tir_matmul_n16", "tir_matmul_n64"]
+    # The dims without bucket values are left symbolic.
+    (task,) = ms.relax_integration.extract_tasks(mod, target, shape_buckets={"m": [16]})
+    assert task.task_name == "tir_matmul"
+
+    with tempfile.TemporaryDirectory() as work_dir:
+        database = ms.relax_integration.tune_relax(
+            mod,
+            {},
+            target,
+            work_dir,
+            max_trials_global=8,
+            max_trials_per_task=4,
+            num_trials_per_iter=2,
+            shape_buckets=shape_buckets,
+        )
+        with target, database, PassContext(opt_level=0):
+            out_mod = relax.transform.MetaScheduleApplyDatabase(shape_buckets=shape_buckets)(mod)
+
+    # The smaller bucket is dispatched to first.
+    dispatch = out_mod["tir_matmul"].body.block.body
+    assert isinstance(dispatch, tvm.tir.IfThenElse)
+    assert dispatch.then_case.block.name_hint == "bucket_n16"
+    assert dispatch.else_case.block.name_hint == "bucket_n64"
+
+    # The kernels of the buckets run any shape.
+    ex = relax.vm.build(out_mod, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    w_np = np.random.rand(32, 32).astype("float32")
+    for n in [7, 16, 40, 100]:
+        x_np = np.random.rand(n, 32).astype("float32")
+        res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(w_np))
+        np.testing.assert_allclose(res.numpy(), x_np @ w_np.T, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
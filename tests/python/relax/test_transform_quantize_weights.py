@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.transform import OperatorLegalizer
+
+
+def _np_quantize(w, bits, group_size):
+    """The dequantized weights of the group-wise quantization of w."""
+    offset = 1 << (bits - 1)
+    groups = w.reshape(w.shape[0], -1, group_size)
+    scale = np.abs(groups).max(axis=-1, keepdims=True) / (offset - 1)
+    q = np.clip(np.round(groups / np.where(scale > 0, scale, 1)), -offset, offset - 1)
+    return (q * scale).reshape(w.shape)
+
+
+def build_dense(x_shape, w, use_matmul):
+    """A dense, or a matmul, of the data by the constant weights w of shape (n, k), then a relu.
+    The data is of the dtype of the weights."""
+    dtype = str(w.dtype)
+    x = relax.Var("x", x_shape, relax.DynTensorType(ndim=len(x_shape), dtype=dtype))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            if use_matmul:
+                lv = bb.emit(relax.op.nn.matmul(x, relax.const(w.T.copy())))
+            else:
+                lv = bb.emit(relax.op.nn.dense(x, relax.const(w)))
+            gv = bb.emit_output(relax.op.nn.relu(lv))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def get_ops(mod):
+    """The names of the ops called by the main function."""
+    ops = []
+
+    def fvisit(expr):
+        if isinstance(expr, relax.Call) and isinstance(expr.op, tvm.ir.Op):
+            ops.append(expr.op.name)
+
+    relax.analysis.post_order_visit(mod["main"], fvisit)
+    return ops
+
+
+@pytest.mark.parametrize("bits", [4, 8])
+@pytest.mark.parametrize("use_matmul", [False, True])
+def test_quantize_weights(bits, use_matmul):
+    w = np.random.uniform(-1, 1, (24, 64)).astype("float32")
+    mod = relax.transform.QuantizeWeights(bits=bits, group_size=32)(
+        build_dense([3, 64], w, use_matmul)
+    )
+    ops = get_ops(mod)
+    assert "relax.nn.quantized_dense" in ops and "relax.nn.quantize_weight" in ops
+    assert "relax.nn.dense" not in ops and "relax.nn.matmul" not in ops
+
+    # The quantization of the weights is folded at compile time.
+    mod = relax.transform.FoldConstant()(OperatorLegalizer(mod).transform())
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = np.random.uniform(-1, 1, (3, 64)).astype("float32")
+    expected = np.maximum(x @ _np_quantize(w, bits, 32).T, 0)
+    tvm.testing.assert_allclose(vm["main"](tvm.nd.array(x)).numpy(), expected, rtol=1e-4, atol=1e-4)
+
+
+def test_quantize_weights_skip_ungrouped_rows():
+    w = np.random.uniform(-1, 1, (24, 40)).astype("float32")
+    mod = relax.transform.QuantizeWeights(bits=4, group_size=32)(build_dense([3, 40], w, False))
+    assert "relax.nn.dense" in get_ops(mod) and "relax.nn.quantized_dense" not in get_ops(mod)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,146 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.transform import OperatorLegalizer
+
+from test_transform_quantize_weights import build_dense, get_ops
+
+
+def _np_indices_2in4(w):
+    """The indices of the 2 weights of largest magnitude of each group of 4, in their order."""
+    groups = np.abs(w.astype("float32")).reshape(w.shape[0], -1, 4)
+    kept = np.argsort(-groups, axis=-1, kind="stable")[..., :2]
+    return np.sort(kept, axis=-1)
+
+
+def _np_prune_2in4(w):
+    indices = _np_indices_2in4(w)
+    groups = w.reshape(w.shape[0], -1, 4)
+    pruned = np.zeros_like(groups)
+    np.put_along_axis(pruned, indices, np.take_along_axis(groups, indices, axis=-1), axis=-1)
+    return pruned.reshape(w.shape)
+
+
+def _np_pack_2in4(w):
+    """The values and the metadata of sparse_pack_2in4."""
+    n, k = w.shape
+    indices = _np_indices_2in4(w)
+    values = np.take_along_axis(w.reshape(n, -1, 4), indices, axis=-1).reshape(n, k // 2)
+    # The 2-bit indices of the rows i and i + 8 of each 16x16 tile, from the low bits.
+    bits = indices.reshape(n // 16, 2, 8, k // 16, 8).astype("uint32")
+    shifts = np.arange(8, dtype="uint32") * 2
+    words = (bits << shifts).sum(axis=-1, dtype="uint32")
+    metadata = words[:, 0] | (words[:, 1] << np.uint32(16))
+    return values, metadata.transpose(0, 2, 1)
+
+
+def _random_2in4(n, k):
+    w = np.random.uniform(-1, 1, (n, k)).astype("float16")
+    return _np_prune_2in4(w)
+
+
+def _run(mod, x):
+    # The packing of the weights is folded at compile time.
+    mod = relax.transform.FoldConstant()(OperatorLegalizer(mod).transform())
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    return vm["main"](tvm.nd.array(x)).numpy()
+
+
+def test_sparse_pack_2in4():
+    w = np.random.uniform(-1, 1, (32, 64)).astype("float16")
+    x = relax.Var("w", [32, 64], relax.DynTensorType(ndim=2, dtype="float16"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        gv = bb.emit(relax.op.nn.sparse_pack_2in4(x))
+        bb.emit_func_output(gv)
+    ex = relax.vm.build(OperatorLegalizer(bb.get()).transform(), "llvm")
+    values, metadata = relax.VirtualMachine(ex, tvm.cpu())["main"](tvm.nd.array(w))
+
+    expected_values, expected_metadata = _np_pack_2in4(w)
+    np.testing.assert_equal(values.numpy(), expected_values)
+    np.testing.assert_equal(metadata.numpy(), expected_metadata)
+
+
+@pytest.mark.parametrize("use_matmul", [False, True])
+def test_sparsify_weights(use_matmul):
+    w = _random_2in4(32, 64)
+    mod = relax.transform.SparsifyWeights()(build_dense([3, 64], w, use_matmul))
+    ops = get_ops(mod)
+    assert "relax.nn.sparse_dense_2in4" in ops and "relax.nn.sparse_pack_2in4" in ops
+    assert "relax.nn.dense" not in ops and "relax.nn.matmul" not in ops
+
+    x = np.random.uniform(-1, 1, (3, 64)).astype("float16")
+    expected = np.maximum(x.astype("float32") @ w.astype("float32").T, 0)
+    tvm.testing.assert_allclose(_run(mod, x), expected, rtol=2e-2, atol=2e-2)
+
+
+def test_sparsify_weights_prune():
+    w = np.random.uniform(-1, 1, (32, 64)).astype("float16")
+    # The dense weights are only rewritten when pruning.
+    mod = relax.transform.SparsifyWeights()(build_dense([3, 64], w, False))
+    assert "relax.nn.dense" in get_ops(mod) and "relax.nn.sparse_dense_2in4" not in get_ops(mod)
+    mod = relax.transform.SparsifyWeights(prune=True)(build_dense([3, 64], w, False))
+    assert "relax.nn.sparse_dense_2in4" in get_ops(mod)
+
+    x = np.random.uniform(-1, 1, (3, 64)).astype("float16")
+    expected = np.maximum(x.astype("float32") @ _np_prune_2in4(w).astype("float32").T, 0)
+    tvm.testing.assert_allclose(_run(mod, x), expected, rtol=2e-2, atol=2e-2)
+
+
+def test_sparsify_weights_skip_untiled_dims():
+    w = _random_2in4(24, 64)
+    mod = relax.transform.SparsifyWeights(prune=True)(build_dense([3, 64], w, False))
+    assert "relax.nn.dense" in get_ops(mod) and "relax.nn.sparse_dense_2in4" not in get_ops(mod)
+
+
+@tvm.testing.requires_cuda_compute_version(8)
+def test_sparse_dense_2in4_tensor_core():
+    dev = tvm.cuda()
+    target = tvm.target.Target("cuda -arch=sm_%s" % dev.compute_version.replace(".", ""))
+    n, k = 80, 64
+    w = _random_2in4(n, k)
+    values_np, metadata_np = _np_pack_2in4(w)
+    m = tvm.tir.Var("m", "int64")
+    x = relax.Var("x", [m, k], relax.DynTensorType(ndim=2, dtype="float16"))
+    values = relax.Var("values", [n, k // 2], relax.DynTensorType(ndim=2, dtype="float16"))
+    metadata = relax.Var("metadata", [n // 16, k // 16, 8], relax.DynTensorType(3, "uint32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, values, metadata]):
+        gv = bb.emit(relax.op.nn.sparse_dense_2in4(x, values, metadata, out_dtype="float32"))
+        bb.emit_func_output(gv)
+    with target:
+        mod = OperatorLegalizer(bb.get()).transform()
+    ex = relax.vm.build(mod, target)
+    vm = relax.VirtualMachine(ex, dev)
+
+    # The rows of the data past the tiles of 8 are masked.
+    for rows in [8, 13]:
+        x_np = np.random.uniform(-1, 1, (rows, k)).astype("float16")
+        out = vm["main"](
+            tvm.nd.array(x_np, dev), tvm.nd.array(values_np, dev), tvm.nd.array(metadata_np, dev)
+        )
+        expected = x_np.astype("float32") @ w.astype("float32").T
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-3, atol=1e-3)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
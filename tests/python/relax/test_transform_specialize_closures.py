@@ -0,0 +1,97 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import relax as R
+
+
+def _bindings(func):
+    return [binding for block in func.body.blocks for binding in block.bindings]
+
+
+def test_closure_made_in_function():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def lifted_func_0(x: R.Tensor((2, 3), "float32"), env: R.Tensor((2, 3), "float32")):
+            r = R.add(x, env)
+            return r
+
+        @R.function
+        def main(x: R.Tensor((2, 3), "float32"), y: R.Tensor((2, 3), "float32")):
+            clo = R.make_closure(lifted_func_0, (x,))
+            res = R.invoke_closure(clo, (y,), type_args=(R.Tensor(ndim=2, dtype="float32")))
+            return res
+
+    after = relax.transform.SpecializeClosures()(Before)
+    main = after["main"]
+    (binding,) = _bindings(main)
+    assert binding.value.op.same_as(after.get_global_var("lifted_func_0"))
+    x, y = main.params
+    assert binding.value.args[0].same_as(y) and binding.value.args[1].same_as(x)
+
+
+def test_closure_made_by_function():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((2, 3), "float32"), y: R.Tensor((2, 3), "float32")):
+            @R.function
+            def outer_func(c1: R.Tensor((2, 3), "float32")):
+                @R.function
+                def inner_func(x1: R.Tensor((2, 3), "float32")):
+                    s: R.Tensor((2, 3), "float32") = R.add(x1, c1)
+                    return s
+
+                return inner_func
+
+            in_call = outer_func(x)
+            res = in_call(y)
+            return res
+
+    lifted = relax.transform.LambdaLift()(Before)
+    after = relax.transform.SpecializeClosures()(lifted)
+    # The closure and its function are gone, the lifted inner function is called directly.
+    (binding,) = _bindings(after["main"])
+    assert isinstance(binding.value.op, relax.GlobalVar)
+    assert "make_closure" not in after["main"].script()
+
+    ex = relax.vm.build(relax.transform.RemoveUnusedFunctions()(after), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_np = np.random.rand(2, 3).astype("float32")
+    y_np = np.random.rand(2, 3).astype("float32")
+    res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+    tvm.testing.assert_allclose(res.numpy(), x_np + y_np, rtol=1e-6)
+
+
+def test_unknown_closure_kept():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(clo: R.Object, y: R.Tensor((2, 3), "float32")):
+            res = R.invoke_closure(clo, (y,), type_args=(R.Tensor(ndim=2, dtype="float32")))
+            return res
+
+    after = relax.transform.SpecializeClosures()(Before)
+    tvm.ir.assert_structural_equal(after, Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
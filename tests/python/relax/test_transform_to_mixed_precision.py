@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
 import tvm
 from tvm import relax
 from tvm.relax.transform import ToMixedPrecision
@@ -254,6 +255,50 @@ def test_concat_matmul():
     tvm.ir.assert_structural_equal(mod, concat_matmul)
 
 
+def _casts(func):
+    cast_op = tvm.ir.Op.get("relax.cast")
+    return [
+        binding.value
+        for block in func.body.blocks
+        for binding in block.bindings
+        if isinstance(binding.value, relax.Call) and binding.value.op == cast_op
+    ]
+
+
+def _get_matmul_twice():
+    x = relax.Var("x", (2, 4), relax.DynTensorType(2, "float32"))
+    c = relax.const(np.random.rand(4, 4).astype("float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        lv0 = bb.emit(relax.op.nn.matmul(x, c, out_dtype="float32"))
+        lv1 = bb.emit(relax.op.nn.matmul(x, c, out_dtype="float32"))
+        gv = bb.emit(relax.op.add(lv0, lv1))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_cast_once_per_dtype():
+    mod = ToMixedPrecision()(_get_matmul_twice())
+    casts = _casts(mod["main"])
+    # x and the constant are each casted to float16 once, the output of each matmul to float16
+    # once for both uses by the add, and the function output back to float32
+    assert len(casts) == 5
+    assert sum(isinstance(cast.args[0], relax.Constant) for cast in casts) == 1
+
+
+def test_policy():
+    mod = ToMixedPrecision(never_ops=["relax.nn.matmul"])(_get_matmul_twice())
+    assert len(_casts(mod["main"])) == 0
+
+    mod = ToMixedPrecision(
+        low_precision_dtype="bfloat16", op_out_dtypes={"relax.nn.matmul": "bfloat16"}
+    )(_get_matmul_twice())
+    casts = _casts(mod["main"])
+    # the matmuls accumulate in bfloat16, so that only the inputs and the function output are
+    # casted
+    assert [str(cast.attrs.dtype) for cast in casts] == ["bfloat16", "bfloat16", "float32"]
+
+
 if __name__ == "__main__":
     test_conv2d()
     test_conv2d_relu()
@@ -261,3 +306,5 @@ if __name__ == "__main__":
     test_gemm_add_silu()
     test_concat()
     test_concat_matmul()
+    test_cast_once_per_dtype()
+    test_policy()
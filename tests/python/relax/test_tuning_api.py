@@ -36,6 +36,7 @@ from tvm.relax.transform.tuning_api import (
     Trace,
     TuningRecord,
     JSONDatabase,
+    IndexedDatabase,
     default_generate_candidate,
     default_consider_eval_passes,
     default_evaluate,
@@ -381,6 +382,56 @@ def test_database():
         assert len(new_tuning_records) == 0
 
 
+def test_indexed_database():
+    def equal_measurement_record(a: List[float], b: List[float]):
+        assert len(a) == len(b)
+        for i in range(len(a)):
+            assert isclose(a[i], b[i], rel_tol=1e-5)
+
+    mod1, mod2 = setup_test_const_folding()
+    knob = Knob("test", {"noapply": Choice()})
+    target = tvm.target.Target("llvm")
+    records = [
+        TuningRecord(Trace(mod1, [knob], ["noapply"]), run_secs)
+        for run_secs in [[0.3], [0.1], [0.2]]
+    ]
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = osp.join(tmpdir, "database")
+        database = IndexedDatabase(path)
+        workload1 = database.commit_workload(mod1)
+        database.commit_measurement_record(workload1, target, [1.0, 0.9])
+        for record in records:
+            database.commit_tuning_record(workload1, target, record)
+
+        # The records appended are visible to the reopened database
+        new_database = IndexedDatabase(path)
+        assert new_database.has_workload(mod1)
+        assert not new_database.has_workload(mod2)
+        workload1 = new_database.commit_workload(mod1)
+        assert new_database.has_measurement_record(workload1, target)
+        assert len(new_database.get_measurement_record(workload1, target)) == 2
+        assert new_database.has_tuning_record(workload1, target)
+        top_k = new_database.get_top_k(workload1, target, top_k=2)
+        assert len(top_k) == 2
+        equal_measurement_record(top_k[0].run_secs, [0.1])
+        equal_measurement_record(top_k[1].run_secs, [0.2])
+        workload2 = new_database.commit_workload(mod2)
+        assert not new_database.has_tuning_record(workload2, target)
+        assert len(new_database.get_top_k(workload2, target, top_k=2)) == 0
+        # The records are kept apart by both the workload and the target
+        other_target = tvm.target.Target("llvm -mcpu=skylake")
+        assert not new_database.has_tuning_record(workload1, other_target)
+        assert not new_database.has_measurement_record(workload1, other_target)
+        new_database.commit_tuning_record(workload1, other_target, records[0])
+        new_database.commit_tuning_record(workload2, target, records[2])
+        top_k = new_database.get_top_k(workload1, other_target, top_k=2)
+        assert len(top_k) == 1
+        equal_measurement_record(top_k[0].run_secs, [0.3])
+        assert len(new_database.get_top_k(workload1, target, top_k=4)) == 3
+        assert len(new_database.get_top_k(workload2, target, top_k=4)) == 1
+
+
 def test_default_functions():
     mod = setup_test()
     assert isinstance(mod, tvm.IRModule)
@@ -407,6 +458,19 @@ def test_default_functions():
             default_evaluate(candidates, "llvm --num-cores=16")
             assert PassContext.current().num_evals == 2
 
+            # The evaluated traces are recorded, so that the same decisions are not measured again.
+            workload = database.commit_workload(mod)
+            target = tvm.target.Target("llvm --num-cores=16")
+            for candidate in candidates:
+                record = database.get_tuning_record(workload, target, candidate)
+                assert record is not None
+                assert record.run_secs is not None
+            new_candidates = default_generate_candidate([knob], trace)
+            default_evaluate(new_candidates, "llvm --num-cores=16")
+            assert PassContext.current().num_evals == 4
+            for candidate, new_candidate in zip(candidates, new_candidates):
+                assert isclose(candidate.perf, new_candidate.perf)
+
             # Test with multiple knobs
             candidates = default_generate_candidate([knob, knob], trace)
             assert len(candidates) == 4
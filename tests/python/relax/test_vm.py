@@ -14,11 +14,13 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
 import os
 from typing import Any, Callable, List, Tuple
 
 import sys
 import tempfile
+import threading
 import numpy as np
 import pytest
 import tvm
@@ -151,6 +153,28 @@ def test_vm_exec_serialize_export_library():
     assert ex.as_text() == loaded_exec.as_text()
 
 
+def test_vm_exec_save_load_constant_blob():
+    ib = relax.ExecBuilder()
+    weight = tvm.nd.array(np.random.rand(3, 4).astype(np.float32))
+    with ib.function("main", num_inputs=1):
+        w = ib.emit_constant(weight)
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.c(w)], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    ex = ib.get()
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.bin")
+    ex.mod.save(path_exec)
+    load_from_file = tvm.get_global_func("relax.ExecutableLoadFromFile")
+    loaded_exec = relax.vm.Executable(load_from_file(path_exec))
+    assert ex.as_text() == loaded_exec.as_text()
+
+    inp = tvm.nd.array(np.random.rand(3, 4).astype(np.float32))
+    vm = relax.VirtualMachine(loaded_exec, tvm.cpu())
+    res = vm["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy() + weight.numpy(), rtol=1e-7, atol=1e-7)
+
+
 def test_vm_checker():
     ib = relax.ExecBuilder()
     with pytest.raises(TVMError):
@@ -220,6 +244,19 @@ def test_vm_shapeof():
         assert s == shape[i]
 
 
+def test_vm_shape_builtins():
+    shape = tvm.runtime.ShapeTuple
+    broadcast = tvm.get_global_func("vm.binary_broadcast_shape_infer")
+    assert list(broadcast(shape([4, 1, 3]), shape([5, 1]))) == [4, 5, 3]
+    assert list(broadcast(shape([2]), shape([]))) == [2]
+    with pytest.raises(TVMError):
+        broadcast(shape([2, 3]), shape([4]))
+
+    heap = tvm.nd.array(np.array([7, 8, 9], dtype="int64"))
+    load_shape = tvm.get_global_func("vm.builtin.load_shape")
+    assert list(load_shape(heap, shape([2, 0]))) == [9, 7]
+
+
 def test_vm_storage():
     dtype = tvm.DataType("float32")
     shape = (4, 6)
@@ -239,6 +276,177 @@ def test_vm_storage():
     assert res.shape == shape
 
 
+def test_vm_storage_multithread():
+    dtype = tvm.DataType("float32")
+    shape = (4, 6)
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=0):
+        ib.emit_call(
+            "vm.builtin.alloc_storage", args=[ib.vm_state(), (96,), ib.imm(0), dtype], dst=ib.r(1)
+        )
+        ib.emit_call(
+            "vm.builtin.alloc_tensor", args=[ib.r(1), ib.imm(0), shape, dtype], dst=ib.r(2)
+        )
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    contexts = [vm.create_context() for _ in range(4)]
+    errors = []
+
+    def run(ctx):
+        try:
+            # storage freed by one thread may be reused by another through the shared pool
+            live = []
+            for i in range(64):
+                res = ctx["main"]()
+                assert res.shape == shape
+                live.append(res)
+                if i % 16 == 15:
+                    live.clear()
+        except Exception as err:  # pylint: disable=broad-except
+            errors.append(err)
+
+    threads = [threading.Thread(target=run, args=(ctx,)) for ctx in contexts]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors
+
+
+def test_vm_size_class_allocator():
+    dtype = tvm.DataType("float32")
+    shape = (4, 6)
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=0):
+        ib.emit_call(
+            "vm.builtin.alloc_storage", args=[ib.vm_state(), (96,), ib.imm(0), dtype], dst=ib.r(1)
+        )
+        ib.emit_call(
+            "vm.builtin.alloc_tensor", args=[ib.r(1), ib.imm(0), shape, dtype], dst=ib.r(2)
+        )
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+    # use a device of its own, as the allocator of a device is created once per process
+    dev = tvm.cpu(1)
+    vm = relax.VirtualMachine(ex, dev, memory_cfg="size_class")
+    res = vm["main"]()
+    assert res.shape == shape
+    stats = relax.VirtualMachine.memory_stats(dev)
+    assert stats["num_allocs"] == 1
+    assert stats["num_hits"] == 0
+    assert stats["bytes_requested"] == 96
+    assert stats["bytes_in_use"] == 512
+    del res
+    stats = relax.VirtualMachine.memory_stats(dev)
+    assert stats["bytes_in_use"] == 0
+    assert stats["bytes_cached"] == stats["bytes_reserved"]
+    assert stats["fragmentation"] == 0.0
+    # the freed block is served again from the cache
+    res = vm["main"]()
+    stats = relax.VirtualMachine.memory_stats(dev)
+    assert stats["num_allocs"] == 2
+    assert stats["num_hits"] == 1
+    assert stats["hit_rate"] == 0.5
+    del res
+    tvm.get_global_func("vm.memory_manager.set_high_water_mark")(dev, 0)
+    stats = relax.VirtualMachine.memory_stats(dev)
+    assert stats["bytes_cached"] == 0
+    assert stats["bytes_reserved"] == 0
+
+
+def test_vm_freeze_allocators():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", (n, 16), relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.exp, x)
+            gv = bb.emit_output(bb.emit_te(topi.add, lv0, x))
+        bb.emit_func_output(gv)
+    ex = relax.vm.build(bb.get(), "llvm")
+    # use a device of its own, as the allocator of a device is shared by the whole process
+    dev = tvm.cpu(4)
+    vm = relax.VirtualMachine(ex, dev, memory_cfg="pooled")
+
+    x_np = np.random.rand(1024, 16).astype("float32")
+    vm.freeze_allocators("main", [(tvm.nd.array(x_np, dev),)])
+    try:
+        assert relax.VirtualMachine.memory_stats(dev)["arena_bytes"] > 0
+        # The warmed up shapes, and the smaller ones, are served from the arena.
+        for rows in [1024, 8]:
+            res = vm["main"](tvm.nd.array(x_np[:rows], dev))
+            tvm.testing.assert_allclose(res.numpy(), np.exp(x_np[:rows]) + x_np[:rows], rtol=1e-6)
+            del res
+        # A larger shape than the warm-up fails instead of allocating from the device.
+        with pytest.raises(TVMError):
+            vm["main"](tvm.nd.array(np.random.rand(4096, 16).astype("float32"), dev))
+    finally:
+        vm.unfreeze_allocators()
+    assert relax.VirtualMachine.memory_stats(dev)["arena_bytes"] == 0
+
+
+def test_vm_freeze_allocators_drains_thread_caches():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (1024, 16), relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            gv = bb.emit_output(bb.emit_te(topi.exp, x))
+        bb.emit_func_output(gv)
+    ex = relax.vm.build(bb.get(), "llvm")
+    # use a device of its own, as the allocator of a device is shared by the whole process
+    dev = tvm.cpu(5)
+    vm = relax.VirtualMachine(ex, dev, memory_cfg="pooled")
+
+    # The warm-up thread keeps the buffers it freed in its cache while it is alive.
+    warmed_up, done = threading.Event(), threading.Event()
+
+    def warm_up():
+        res = vm["main"](tvm.nd.array(np.random.rand(1024, 16).astype("float32"), dev))
+        del res
+        warmed_up.set()
+        done.wait()
+
+    thread = threading.Thread(target=warm_up)
+    thread.start()
+    warmed_up.wait()
+    try:
+        vm.freeze_allocators()
+        try:
+            stats = relax.VirtualMachine.memory_stats(dev)
+            # The cached buffers of the other thread are released for the arena.
+            assert stats["arena_bytes"] > 0
+            assert stats["bytes_reserved"] == stats["arena_bytes"]
+        finally:
+            vm.unfreeze_allocators()
+    finally:
+        done.set()
+        thread.join()
+
+
+def test_vm_pinned_host_allocator():
+    # use a device of its own, as the allocator of a device is created once per process
+    dev = tvm.cpu(2)
+    arr = relax.VirtualMachine.pinned_empty((4, 6), "float32", dev)
+    assert arr.shape == (4, 6)
+    assert arr.device == dev
+    data = np.random.rand(4, 6).astype("float32")
+    arr.copyfrom(data)
+    tvm.testing.assert_allclose(arr.numpy(), data)
+    assert relax.VirtualMachine.memory_stats(dev)["bytes_in_use"] == 4096
+    del arr
+    assert relax.VirtualMachine.memory_stats(dev)["bytes_in_use"] == 0
+
+
+@tvm.testing.requires_cuda
+def test_vm_pinned_host_allocator_cuda():
+    arr = relax.VirtualMachine.pinned_empty((4, 6), "float32", tvm.cuda(0))
+    assert arr.device == tvm.device("cuda_host", 0)
+    data = np.random.rand(4, 6).astype("float32")
+    arr.copyfrom(data)
+    tvm.testing.assert_allclose(arr.copyto(tvm.cuda(0)).numpy(), data)
+
+
 def test_vm_copy():
     @tvm.script.ir_module
     class TestVMMove:
@@ -256,6 +464,37 @@ def test_vm_copy():
     tvm.testing.assert_allclose(res.numpy(), inp.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_create_context():
+    ib = relax.ExecBuilder()
+    weight = tvm.nd.array(np.random.rand(4).astype(np.float32))
+    with ib.function("main", num_inputs=1):
+        w = ib.emit_constant(weight)
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.c(w)], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    contexts = [vm.create_context() for _ in range(4)]
+
+    inputs = [tvm.nd.array(np.random.rand(4).astype(np.float32)) for _ in contexts]
+    results = [None] * len(contexts)
+
+    def run(i):
+        results[i] = contexts[i]["main"](inputs[i])
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(contexts))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    for inp, res in zip(inputs, results):
+        expected = inp.numpy() + weight.numpy()
+        tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-7, atol=1e-7)
+    # the original VM is still usable
+    res = vm["main"](inputs[0])
+    expected = inputs[0].numpy() + weight.numpy()
+    tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-7, atol=1e-7)
+
+
 def test_vm_goto():
     ib = relax.ExecBuilder()
     with ib.function("main", num_inputs=2):
@@ -305,7 +544,26 @@ def test_vm_if():
     tvm.testing.assert_allclose(res.numpy(), a.numpy() + b.numpy(), rtol=1e-7, atol=1e-7)
 
 
-def test_vm_compile_if():
+def test_vm_if_int_cond():
+    # The condition is an int register on the host rather than a tensor.
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=2):
+        ib.emit_call("vm.builtin.copy", args=[ib.imm(0)], dst=ib.r(2))
+        ib.emit_if(ib.r(2), 3)
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(3))
+        ib.emit_goto(2)
+        ib.emit_call("test.vm.mul", args=[ib.r(0), ib.r(1)], dst=ib.r(3))
+        ib.emit_ret(ib.r(3))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    a = tvm.nd.array(np.random.rand(4))
+    b = tvm.nd.array(np.random.rand(4))
+    res = vm["main"](a, b)
+    tvm.testing.assert_allclose(res.numpy(), a.numpy() * b.numpy(), rtol=1e-7, atol=1e-7)
+
+
+@pytest.mark.parametrize("exec_mode", ["bytecode", "compiled"])
+def test_vm_compile_if(exec_mode):
     @tvm.script.ir_module
     class TestVMCompileIf:
         @R.function
@@ -318,7 +576,7 @@ def test_vm_compile_if():
 
     mod = TestVMCompileIf
     target = tvm.target.Target("llvm", host="llvm")
-    ex = relax.vm.build(mod, target)
+    ex = relax.vm.build(mod, target, exec_mode=exec_mode)
     vm = relax.VirtualMachine(ex, tvm.cpu())
     inp = tvm.nd.array(np.random.rand(3, 4))
     res = vm["ife"](tvm.nd.array(1), inp)
@@ -435,6 +693,83 @@ def test_vm_compile_stage3():
     tvm.testing.assert_allclose(res.numpy(), inp.numpy(), rtol=1e-7, atol=1e-7)
 
 
+@tvm.script.ir_module
+class TestVMDeviceCopy:
+    @R.function
+    def foo(x: R.Tensor((32, 16), "float32")) -> R.Tensor:
+        y = R.device_copy(x, dst_device_index=-1)
+        z = R.call_tir("test.vm.identity", (y), (32, 16), dtype="float32")
+        return z
+
+
+def test_vm_device_copy():
+    ex = relax.vm.build(TestVMDeviceCopy, tvm.target.Target("llvm", host="llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    inp = tvm.nd.array(np.random.rand(32, 16).astype(np.float32))
+    res = vm["foo"](inp)
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy(), rtol=1e-7, atol=1e-7)
+
+
+@tvm.testing.requires_cuda
+def test_vm_device_copy_cuda():
+    ex = relax.vm.build(TestVMDeviceCopy, tvm.target.Target("cuda", host="llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cuda())
+    data = np.random.rand(32, 16).astype(np.float32)
+    res = vm["foo"](tvm.nd.array(data, tvm.cuda()))
+    # The kernel runs on the copy on the host, where its output is allocated.
+    assert res.device == tvm.cpu()
+    tvm.testing.assert_allclose(res.numpy(), data, rtol=1e-7, atol=1e-7)
+
+
+@tvm.script.ir_module
+class TestVMCollectives:
+    @R.function
+    def allreduce(x: R.Tensor((4, 3), "float32")):
+        y = R.ccl.allreduce(x, op_type="sum")
+        return y
+
+    @R.function
+    def allgather(x: R.Tensor((4, 3), "float32")):
+        y = R.ccl.allgather(x, num_workers=2)
+        return y
+
+    @R.function
+    def reduce_scatter(x: R.Tensor((4, 3), "float32")):
+        y = R.ccl.reduce_scatter(x, num_workers=2, op_type="max")
+        return y
+
+
+def test_vm_collectives_cpu():
+    ex = relax.vm.build(TestVMCollectives, tvm.target.Target("llvm", host="llvm"))
+    inputs = [np.random.rand(4, 3).astype("float32") for _ in range(2)]
+    results = [None, None]
+
+    def worker(rank):
+        vm = relax.VirtualMachine(ex, tvm.cpu(), ccl_config=("test_vm_collectives", 2, rank))
+        x = tvm.nd.array(inputs[rank])
+        names = ["allreduce", "allgather", "reduce_scatter"]
+        results[rank] = [vm[name](x).numpy() for name in names]
+
+    threads = [threading.Thread(target=worker, args=(rank,)) for rank in range(2)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    maximum = np.maximum(inputs[0], inputs[1])
+    for rank in range(2):
+        allreduce, allgather, reduce_scatter = results[rank]
+        tvm.testing.assert_allclose(allreduce, inputs[0] + inputs[1], rtol=1e-6)
+        tvm.testing.assert_allclose(allgather, np.concatenate(inputs), rtol=1e-6)
+        tvm.testing.assert_allclose(reduce_scatter, maximum[rank * 2 : rank * 2 + 2], rtol=1e-6)
+
+
+def test_vm_collectives_require_group():
+    ex = relax.vm.build(TestVMCollectives, tvm.target.Target("llvm", host="llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    with pytest.raises(TVMError):
+        vm["allreduce"](tvm.nd.array(np.zeros((4, 3), "float32")))
+
+
 def test_vm_compile_e2e():
     @tvm.script.ir_module
     class TestVMCompileE2E:
@@ -651,6 +986,38 @@ def test_vm_emit_te_constant_param_cpu():
     tvm.testing.assert_allclose(add_res.numpy(), x_np + c_np, rtol=1e-7, atol=1e-7)
 
 
+def test_vm_memory_footprint():
+    c_np = np.random.rand(4, 8).astype("float32")
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", (4, 8), relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", (n, 8), relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, relax.const(c_np, "float32"))
+            gv = bb.emit_output(bb.emit_te(topi.exp, lv0))
+        bb.emit_func_output(gv)
+    with bb.function("dyn", [y]):
+        with bb.dataflow():
+            gv = bb.emit_output(bb.emit_te(topi.exp, y))
+        bb.emit_func_output(gv)
+    ex = relax.vm.build(bb.get(), "llvm")
+
+    footprint = ex.memory_footprint("main")
+    assert footprint["constant_bytes"] == c_np.nbytes
+    assert footprint["workspace_bytes"] == 0
+    assert footprint["devices"][0]["activation_bytes"] >= c_np.nbytes
+    assert footprint["devices"][0]["num_dynamic_allocs"] == 0
+    # The allocations of symbolic size are only counted.
+    assert ex.memory_footprint("dyn")["devices"][0]["num_dynamic_allocs"] > 0
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.so")
+    ex.mod.export_library(path_exec)
+    loaded_exec = relax.vm.Executable(tvm.runtime.load_module(path_exec))
+    assert loaded_exec.memory_footprint() == ex.memory_footprint()
+
+
 @tvm.testing.requires_gpu
 def test_vm_emit_te_constant_param_gpu():
     x_np = np.random.rand(2, 2).astype("float32")
@@ -678,6 +1045,417 @@ def test_vm_emit_te_constant_param_gpu():
     tvm.testing.assert_allclose(add_res.numpy(), x_np + c_np, rtol=1e-7, atol=1e-7)
 
 
+@tvm.testing.requires_cuda
+def test_vm_capture_cuda_graph():
+    c_np = np.random.rand(2, 2).astype("float32")
+
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (2, 2), relax.DynTensorType(2, "float32"))
+    c = relax.const(c_np, "float32")
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, c)
+            lv1 = bb.emit_te(topi.multiply, lv0, c)
+            gv = bb.emit_output(lv1)
+        bb.emit_func_output(gv)
+
+    mod = bb.get()
+    sch = tvm.tir.Schedule(mod, debug_mask="all")
+    for block, func in [("T_add", "add"), ("T_multiply", "multiply")]:
+        loops = sch.get_loops(sch.get_block(name=block, func_name=func))
+        sch.bind(loops[0], "threadIdx.x")
+
+    exec = relax.vm.build(sch.mod, "cuda")
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(exec, dev)
+    f = vm.capture_cuda_graph("main")
+    for _ in range(3):
+        x_np = np.random.rand(2, 2).astype("float32")
+        res = f(tvm.nd.array(x_np, dev))
+        tvm.testing.assert_allclose(res.numpy(), (x_np + c_np) * c_np, rtol=1e-7, atol=1e-7)
+
+
+@tvm.testing.requires_cuda
+def test_vm_constant_paging():
+    c_np = [np.random.rand(16).astype("float32") for _ in range(4)]
+
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (16,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv = x
+            for c in c_np:
+                lv = bb.emit_te(topi.add, lv, relax.const(c, "float32"))
+            gv = bb.emit_output(lv)
+        bb.emit_func_output(gv)
+
+    mod = bb.get()
+    sch = tvm.tir.Schedule(mod, debug_mask="all")
+    for gv in mod.get_global_vars():
+        if isinstance(mod[gv], tvm.tir.PrimFunc):
+            loops = sch.get_loops(sch.get_block(name="T_add", func_name=gv.name_hint))
+            sch.bind(loops[0], "threadIdx.x")
+
+    exec = relax.vm.build(sch.mod, "cuda")
+    dev = tvm.cuda()
+    # the budget only holds two of the four constants at a time
+    vm = relax.VirtualMachine(exec, dev, constant_budget=2 * 16 * 4, constant_prefetch=1)
+    for _ in range(2):
+        x_np = np.random.rand(16).astype("float32")
+        res = vm["main"](tvm.nd.array(x_np, dev))
+        tvm.testing.assert_allclose(res.numpy(), x_np + sum(c_np), rtol=1e-6, atol=1e-6)
+
+
+def test_vm_thread_pool():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (1024,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+
+    mod = bb.get()
+    sch = tvm.tir.Schedule(mod, debug_mask="all")
+    for gv in mod.get_global_vars():
+        if isinstance(mod[gv], tvm.tir.PrimFunc):
+            (loop,) = sch.get_loops(sch.get_block(name="T_add", func_name=gv.name_hint))
+            sch.parallel(loop)
+    ex = relax.vm.build(sch.mod, "llvm")
+
+    create_pool = tvm.get_global_func("runtime.threading.CreateThreadPool")
+    remove_pool = tvm.get_global_func("runtime.threading.RemoveThreadPool")
+    create_pool("test_vm_pool_a", 2)
+    create_pool("test_vm_pool_b", 2)
+    try:
+        vms = [
+            relax.VirtualMachine(ex, tvm.cpu(), thread_pool=name)
+            for name in ["test_vm_pool_a", "test_vm_pool_b"]
+        ]
+        errors = []
+
+        def run(vm):
+            try:
+                for _ in range(10):
+                    x_np = np.random.rand(1024).astype("float32")
+                    res = vm["main"](tvm.nd.array(x_np))
+                    tvm.testing.assert_allclose(res.numpy(), x_np + x_np, rtol=1e-6, atol=1e-6)
+            except Exception as err:  # pylint: disable=broad-except
+                errors.append(err)
+
+        threads = [threading.Thread(target=run, args=(vm,)) for vm in vms]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        assert not errors, errors
+    finally:
+        remove_pool("test_vm_pool_a")
+        remove_pool("test_vm_pool_b")
+
+
+def test_vm_numa_replicas():
+    c_np = [np.random.rand(16).astype("float32") for _ in range(2)]
+
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (16,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv = x
+            for c in c_np:
+                lv = bb.emit_te(topi.add, lv, relax.const(c, "float32"))
+            gv = bb.emit_output(lv)
+        bb.emit_func_output(gv)
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    replicas = relax.NUMAReplicas(ex, num_threads_per_node=2, pool_prefix="test_vm_numa")
+    try:
+        assert replicas.num_replicas == len(relax.vm.numa_node_cpus()) >= 1
+        for vm in replicas:
+            x_np = np.random.rand(16).astype("float32")
+            res = vm["main"](tvm.nd.array(x_np))
+            tvm.testing.assert_allclose(res.numpy(), x_np + sum(c_np), rtol=1e-6, atol=1e-6)
+    finally:
+        replicas.close()
+
+
+def test_vm_zero_copy():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (16,), relax.DynTensorType(1, "float32"))
+    y = relax.Var("y", (16,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x, y]):
+        lv0 = bb.emit_te(topi.add, x, y)
+        lv1 = bb.emit_te(topi.multiply, x, y)
+        bb.emit_func_output(relax.Tuple([lv0, lv1]))
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_np = np.random.rand(16).astype("float32")
+    y_np = np.random.rand(16).astype("float32")
+    out0 = tvm.nd.empty((16,), "float32")
+    out1 = tvm.nd.empty((16,), "float32")
+    vm.set_input_zero_copy("main", tvm.nd.array(x_np), tvm.nd.array(y_np))
+    vm.set_output_zero_copy("main", 0, out0)
+    vm.set_output_zero_copy("main", 1, out1)
+    vm.invoke_stateful("main")
+    res = vm.get_outputs("main")
+    assert res[0].same_as(out0)
+    assert res[1].same_as(out1)
+    tvm.testing.assert_allclose(out0.numpy(), x_np + y_np, rtol=1e-6, atol=1e-6)
+    tvm.testing.assert_allclose(out1.numpy(), x_np * y_np, rtol=1e-6, atol=1e-6)
+
+    # The unbound output is allocated by the VM again
+    vm.set_output_zero_copy("main", 1, None)
+    vm.invoke_stateful("main")
+    res = vm.get_outputs("main")
+    assert res[0].same_as(out0)
+    assert not res[1].same_as(out1)
+    tvm.testing.assert_allclose(res[1].numpy(), x_np * y_np, rtol=1e-6, atol=1e-6)
+
+    # A buffer of another shape is rejected
+    vm.set_output_zero_copy("main", 1, tvm.nd.empty((8,), "float32"))
+    with pytest.raises(ValueError):
+        vm.invoke_stateful("main")
+
+
+def test_vm_bind_call():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (16,), relax.DynTensorType(1, "float32"))
+    y = relax.Var("y", (16,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x, y]):
+        lv0 = bb.emit_te(topi.add, x, y)
+        lv1 = bb.emit_te(topi.multiply, x, y)
+        bb.emit_func_output(relax.Tuple([lv0, lv1]))
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    out0 = tvm.nd.empty((16,), "float32")
+    out1 = tvm.nd.empty((16,), "float32")
+    call = vm.bind_call("main", [out0, out1])
+    for _ in range(2):
+        x_np = np.random.rand(16).astype("float32")
+        y_np = np.random.rand(16).astype("float32")
+        res = call(tvm.nd.array(x_np), tvm.nd.array(y_np))
+        assert res[0].same_as(out0)
+        assert res[1].same_as(out1)
+        tvm.testing.assert_allclose(out0.numpy(), x_np + y_np, rtol=1e-6, atol=1e-6)
+        tvm.testing.assert_allclose(out1.numpy(), x_np * y_np, rtol=1e-6, atol=1e-6)
+
+    # Without the output buffers, the output is got from the VM
+    res = vm.bind_call("main")(tvm.nd.array(x_np), tvm.nd.array(y_np))
+    tvm.testing.assert_allclose(res[1].numpy(), x_np * y_np, rtol=1e-6, atol=1e-6)
+    with pytest.raises(ValueError):
+        call(tvm.nd.array(x_np))
+    with pytest.raises(TypeError):
+        call(x_np, y_np)
+
+
+def test_vm_profile():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (16,), relax.DynTensorType(1, "float32"))
+    y = relax.Var("y", (16,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x, y]):
+        lv0 = bb.emit_te(topi.add, x, y)
+        lv1 = bb.emit_te(topi.multiply, lv0, y)
+        bb.emit_func_output(lv1)
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_np = np.random.rand(16).astype("float32")
+    y_np = np.random.rand(16).astype("float32")
+    vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+    report = vm.profile("main", tvm.nd.array(x_np), tvm.nd.array(y_np))
+    names = [call["Name"] for call in report.calls]
+    assert "add" in names
+    assert "multiply" in names
+    assert "vm.builtin.alloc_storage" in names
+    assert "Allocated Bytes" in report.calls[0]
+
+    trace = json.loads(vm.chrome_trace())
+    calls = [event for event in trace["traceEvents"] if event["ph"] == "X"]
+    assert [event["name"] for event in calls] == names
+    assert all(event["dur"] >= 0 for event in calls)
+    assert any(event["ph"] == "C" for event in trace["traceEvents"])
+
+    # Without any collector, the report has the same calls.
+    report = vm.profile("main", tvm.nd.array(x_np), tvm.nd.array(y_np), collectors=[])
+    assert [call["Name"] for call in report.calls] == names
+
+
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is None,
+    reason="PAPI profiling not enabled",
+)
+def test_vm_profile_papi():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (1024,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x]):
+        lv0 = bb.emit_te(topi.multiply, x, x)
+        bb.emit_func_output(lv0)
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_nd = tvm.nd.array(np.random.rand(1024).astype("float32"))
+    vm["main"](x_nd)
+    metrics = ["PAPI_TOT_INS", "PAPI_TOT_CYC"]
+    report = vm.profile(
+        "main",
+        x_nd,
+        collectors=[tvm.runtime.profiling.PAPIMetricCollector({tvm.cpu(): metrics})],
+    )
+    calls = [call for call in report.calls if call["Name"] == "multiply"]
+    assert len(calls) == 1
+    for metric in metrics:
+        assert calls[0][metric].value > 0
+
+
+def test_vm_sampling():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", (16,), relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x]):
+        lv0 = bb.emit_te(topi.add, x, x)
+        lv1 = bb.emit_te(topi.multiply, lv0, x)
+        bb.emit_func_output(lv1)
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_nd = tvm.nd.array(np.random.rand(16).astype("float32"))
+    vm.set_sampling(invocation_rate=0.25, call_stride=1)
+    for _ in range(8):
+        vm["main"](x_nd)
+    stats = vm.sampled_stats()
+    assert stats["functions"]["main"]["count"] == 2
+    assert stats["calls"]["add"]["count"] == 2
+    assert stats["calls"]["multiply"]["count"] == 2
+    main = stats["functions"]["main"]
+    assert 0 <= main["p50_us"] <= main["p99_us"] <= main["max_us"]
+
+    vm.reset_sampled_stats()
+    assert vm.sampled_stats()["functions"] == {}
+    vm.set_sampling(invocation_rate=0)
+    vm["main"](x_nd)
+    assert vm.sampled_stats() == {"functions": {}, "calls": {}}
+
+
+def test_vm_batcher():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+
+    ex = relax.vm.build(bb.get(), "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    batcher = vm.make_batcher("main", max_batch_size=8, max_delay_us=100000)
+    inputs = [np.random.rand(i % 3 + 1, 4).astype("float32") for i in range(8)]
+    results = [None] * len(inputs)
+    errors = []
+
+    def run(i):
+        try:
+            results[i] = batcher(tvm.nd.array(inputs[i])).numpy()
+        except Exception as err:  # pylint: disable=broad-except
+            errors.append(err)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(inputs))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors, errors
+    for x_np, res in zip(inputs, results):
+        tvm.testing.assert_allclose(res, x_np + x_np, rtol=1e-6, atol=1e-6)
+
+
+def test_vm_shape_specialization():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    specialized_mod = relax.transform.SpecializeShapes("main", [(2, 4)])(mod)
+    assert "add_n2" in [gv.name_hint for gv in specialized_mod.get_global_vars()]
+    assert [int(dim) for dim in specialized_mod["main"].params[0].shape.values] == [2, 4]
+
+    ex = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    dispatcher = vm.make_shape_dispatcher("main")
+    inputs = [np.random.rand(2, 4).astype("float32") for _ in range(3)]
+    inputs.append(np.random.rand(3, 4).astype("float32"))
+    for x_np in inputs:
+        tvm.testing.assert_allclose(dispatcher(tvm.nd.array(x_np)).numpy(), x_np + x_np)
+    assert dispatcher.num_calls == 4
+    assert dispatcher.shape_histogram() == [(((2, 4),), 3), (((3, 4),), 1)]
+
+    specializer = relax.ShapeSpecializer(dispatcher, mod, "llvm", tvm.cpu(), min_calls=2)
+    assert specializer.step() == 1
+    assert specializer.specialized == [((2, 4),)]
+    assert specializer.step() == 0
+    assert dispatcher.num_specializations == 1
+    # The hot shape runs the specialization, the others keep running the generic function.
+    for x_np in inputs:
+        tvm.testing.assert_allclose(dispatcher(tvm.nd.array(x_np)).numpy(), x_np + x_np)
+    dispatcher.clear_specializations()
+    assert dispatcher.num_specializations == 0
+    # The cleared shapes are specialized again
+    assert specializer.specialized == []
+    assert specializer.step() == 1
+    assert specializer.specialized == [((2, 4),)]
+    assert dispatcher.num_specializations == 1
+    for x_np in inputs:
+        tvm.testing.assert_allclose(dispatcher(tvm.nd.array(x_np)).numpy(), x_np + x_np)
+
+
+def test_vm_paged_kv_cache():
+    @tvm.script.ir_module
+    class TestKVCache:
+        @R.function
+        def decode(cache: R.Object, k: R.Tensor((1, 2), "float32")):
+            cache1 = R.call_packed("vm.builtin.paged_kv_cache_append", cache, k, type_args=R.Object)
+            view = R.call_packed(
+                "vm.builtin.paged_kv_cache_view",
+                cache1,
+                type_args=R.Tensor(ndim=2, dtype="float32"),
+            )
+            return view
+
+    ex = relax.vm.build(TestKVCache, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    f_create = tvm.get_global_func("vm.builtin.paged_kv_cache_create")
+    f_length = tvm.get_global_func("vm.builtin.paged_kv_cache_length")
+    f_pages = tvm.get_global_func("vm.builtin.paged_kv_cache_pages")
+    f_clear = tvm.get_global_func("vm.builtin.paged_kv_cache_clear")
+
+    init = np.random.rand(3, 2).astype("float32")
+    cache = f_create(tvm.nd.array(init), 4)
+    tokens = [init]
+    for _ in range(6):
+        k = np.random.rand(1, 2).astype("float32")
+        tokens.append(k)
+        view = vm["decode"](cache, tvm.nd.array(k))
+        tvm.testing.assert_allclose(view.numpy(), np.concatenate(tokens), rtol=1e-7, atol=1e-7)
+    assert f_length(cache) == 9
+    assert len(f_pages(cache)) == 3
+
+    # The cleared pages are reused
+    f_clear(cache)
+    assert f_length(cache) == 0
+    k = np.random.rand(1, 2).astype("float32")
+    view = vm["decode"](cache, tvm.nd.array(k))
+    tvm.testing.assert_allclose(view.numpy(), k, rtol=1e-7, atol=1e-7)
+    assert len(f_pages(cache)) == 1
+
+    # An empty cache, which holds no page yet, views as no token
+    f_view = tvm.get_global_func("vm.builtin.paged_kv_cache_view")
+    empty = f_create(tvm.nd.array(np.zeros((0, 2), "float32")), 4)
+    assert f_view(empty).shape == (0, 2)
+    assert len(f_pages(empty)) == 0
+    f_clear(cache)
+    assert f_view(cache).shape == (0, 2)
+
+
 def test_vm_relax_symbolic_shape():
     bb = relax.BlockBuilder()
     n = tir.Var("n", "int64")
@@ -892,6 +1670,26 @@ def test_vm_if_cond_const():
     tvm.testing.assert_allclose(res.numpy(), inp.numpy())
 
 
+@pytest.mark.parametrize("exec_mode", ["bytecode", "compiled"])
+def test_vm_if_cond_const_on_host(exec_mode):
+    @tvm.script.ir_module
+    class TestVMIfCondConstOnHost:
+        @R.function
+        def main(x: R.Tensor((3, 4), "float32")) -> R.Tensor:
+            if relax.const(False, dtype="bool"):
+                ret = R.call_packed("test.vm.add", x, x, type_args=(R.Tensor))
+            else:
+                ret = R.call_packed("test.vm.mul", x, x, type_args=(R.Tensor))
+            return ret
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(TestVMIfCondConstOnHost, target, exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    inp = tvm.nd.array(np.random.rand(3, 4).astype("float32"))
+    res = vm["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy() * inp.numpy(), rtol=1e-7, atol=1e-7)
+
+
 def test_sub_func_call():
     @tvm.script.ir_module
     class TestVMSubFunction:
@@ -977,6 +1775,88 @@ def test_recursion():
     tvm.testing.assert_allclose(res.numpy(), np.power(2.0, recursion_runs), rtol=1e-7, atol=1e-7)
 
 
+@pytest.mark.parametrize("exec_mode", ["bytecode", "compiled"])
+def test_tail_recursion_loop(exec_mode):
+    @tvm.script.ir_module
+    class TestVMTailRecursion:
+        @R.function
+        def fib(
+            n: R.Tensor((1,), "float32"), a: R.Tensor((1,), "float32"), b: R.Tensor((1,), "float32")
+        ) -> R.Tensor:
+            cond = R.call_packed(
+                "test.vm.equal_zero", n, type_args=(R.Tensor(ndim=1, dtype="float32"))
+            )
+            if cond:
+                res = a
+            else:
+                n1 = R.call_packed(
+                    "test.vm.subtract_one", n, type_args=(R.Tensor(ndim=1, dtype="float32"))
+                )
+                s = R.call_packed(
+                    "test.vm.add", a, b, type_args=(R.Tensor(ndim=1, dtype="float32"))
+                )
+                # b reads the parameter a, which is overwritten first.
+                res = fib(n1, s, a)
+            return res
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(TestVMTailRecursion, target, exec_mode=exec_mode)
+    # The tail call is a jump back to the start of the function, not a call.
+    assert 'emit_call("fib"' not in ex.as_python()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    steps = 100
+    res = vm["fib"](
+        tvm.nd.array(np.full((1,), steps, "float32")),
+        tvm.nd.array(np.ones((1,), "float32")),
+        tvm.nd.array(np.zeros((1,), "float32")),
+    )
+    a, b = 1.0, 0.0
+    for _ in range(steps):
+        a, b = a + b, a
+    tvm.testing.assert_allclose(res.numpy(), [a], rtol=1e-5)
+
+
+def test_vm_compiled_exec_mode():
+    @tvm.script.ir_module
+    class TestVMCompiled:
+        @T.prim_func
+        def tir_add(x: T.handle, y: T.handle, z: T.handle) -> None:
+            T.func_attr({"global_symbol": "tir_add"})
+            n = T.var("int32")
+            A = T.match_buffer(x, (n,))
+            B = T.match_buffer(y, (n,))
+            C = T.match_buffer(z, (n,))
+            for i in T.serial(n):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    C[vi] = A[vi] + B[vi]
+
+        @R.function
+        def double(x: R.Tensor(("n",), "float32")) -> R.Tensor:
+            n = T.var("int64")
+            gv0 = R.call_tir(tir_add, (x, x), (n,), dtype="float32")
+            return gv0
+
+        @R.function
+        def main(x: R.Tensor(("n",), "float32"), y: R.Tensor(("n",), "float32")) -> R.Tensor:
+            n = T.var("int64")
+            gv0 = R.call_tir(tir_add, (x, y), (n,), dtype="float32")
+            gv1 = double(gv0)
+            return gv1
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(TestVMCompiled, target, exec_mode="compiled")
+    assert ex.mod.imported_modules[0].get_function("__vmtir__main", query_imports=True)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    for n in [4, 7]:
+        x_inp = tvm.nd.array(np.random.rand(n).astype(np.float32))
+        y_inp = tvm.nd.array(np.random.rand(n).astype(np.float32))
+        res = vm["main"](x_inp, y_inp)
+        expected = (x_inp.numpy() + y_inp.numpy()) * 2
+        tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+
 def test_vm_closure():
     @tvm.script.ir_module
     class TestClosure:
@@ -1028,6 +1908,58 @@ def test_vm_invoke_closure():
     )
 
 
+def test_vm_tuple_shape_closure_instrs():
+    ib = relax.ExecBuilder()
+    with ib.function("lifted_func_1", num_inputs=2):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    with ib.function("main", num_inputs=2):
+        x = ib.emit_constant("lifted_func_1")
+        ib.emit_call("vm.builtin.alloc_closure", args=[ib.c(x), ib.r(1)], dst=ib.r(2))
+        ib.emit_invoke_closure(ib.r(2), args=[ib.r(0)], dst=ib.r(3))
+        ib.emit_shape_of(ib.r(3), dst=ib.r(4))
+        ib.emit_tuple([ib.r(3), ib.r(4)], dst=ib.r(5))
+        ib.emit_tuple_get_item(ib.r(5), 1, dst=ib.r(6))
+        ib.emit_tuple([ib.r(3), ib.r(6)], dst=ib.r(7))
+        ib.emit_ret(ib.r(7))
+
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_inp = tvm.nd.array(np.random.rand(2, 3))
+    y_inp = tvm.nd.array(np.random.rand(2, 3))
+    res, shape = vm["main"](x_inp, y_inp)
+    tvm.testing.assert_allclose(res.numpy(), x_inp.numpy() + y_inp.numpy())
+    assert list(shape) == [2, 3]
+
+
+def test_vm_codegen_tuple_closure_instrs():
+    @tvm.script.ir_module
+    class TestClosure:
+        @R.function
+        def lifted_func_1(x: R.Tensor((2, 3), "float32"), env: R.Tensor((2, 3), "float32")):
+            return R.call_packed("test.vm.add", x, env, type_args=(R.Tensor))
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), "float32"),
+            y: R.Tensor((2, 3), "float32"),
+        ):
+            clo = R.make_closure(lifted_func_1, (x,))
+            res = R.invoke_closure(clo, (y,), type_args=(R.Tensor))
+            t = (res, x)
+            return t[0]
+
+    ex = relax.vm.build(TestClosure, "llvm")
+    # The tuples and the closure call are instructions, not calls to the builtins.
+    text = ex.as_text()
+    assert "vm.builtin.invoke_closure" not in text and "runtime.Tuple" not in text
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_inp = tvm.nd.array(np.random.rand(2, 3))
+    y_inp = tvm.nd.array(np.random.rand(2, 3))
+    res = vm["main"](x_inp, y_inp)
+    tvm.testing.assert_allclose(res.numpy(), x_inp.numpy() + y_inp.numpy())
+
+
 def test_time_evaluator():
     @tvm.script.ir_module
     class TestTimeEvaluator:
@@ -18,6 +18,7 @@ import tvm
 import tvm.testing
 from tvm import relax, topi
 from tvm.ir import IRModule
+from tvm.script import relax as R, tir as T
 
 import numpy as np
 
@@ -67,5 +68,198 @@ def test_minimum_example():
     tvm.testing.assert_allclose(y_relax.numpy(), y_np, rtol=1e-5, atol=1e-5)
 
 
+def _symbolic_example():
+    n = tvm.tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4], relax.DynTensorType(2, "float32"))
+
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        v0 = bb.emit_te(topi.exp, x)
+        v1 = bb.emit_te(topi.nn.relu, v0)
+        v2 = bb.emit_te(topi.exp, v1)
+        v3 = bb.emit_te(topi.log, v2)
+        bb.emit_func_output(v3)
+    return bb.get()
+
+
+def _storage_sizes(func):
+    sizes = []
+    for block in func.body.blocks:
+        for binding in block.bindings:
+            value = binding.value
+            if isinstance(value, relax.Call) and value.op == tvm.ir.Op.get(
+                "relax.memory.alloc_storage"
+            ):
+                sizes.append(value.args[0].values[0])
+    return sizes
+
+
+def _check_symbolic_example(mod):
+    dev = tvm.cpu(0)
+    exec = relax.vm.build(mod, "llvm")
+    vm = relax.VirtualMachine(exec, dev)
+    for n in [3, 16]:
+        x_np = np.random.rand(n, 4).astype("float32")
+        y_np = np.log(np.exp(np.maximum(np.exp(x_np), 0.0)))
+        y_relax = vm["main"](tvm.nd.array(x_np, dev))
+        tvm.testing.assert_allclose(y_relax.numpy(), y_np, rtol=1e-5, atol=1e-5)
+
+
+def test_symbolic_shape_upper_bound():
+    mod = _symbolic_example()
+    mod["main"] = mod["main"].with_attr("tir_var_upper_bound", {"n": 16})
+    planned = relax.transform.VMGraphMemoryPlan()(apply_initializing_passes(mod))
+    # the three intermediate tensors share two storages sized by the upper bound of n
+    sizes = _storage_sizes(planned["main"])
+    assert len(sizes) == 2
+    assert all(isinstance(size, tvm.tir.IntImm) and size.value == 16 * 4 * 4 for size in sizes)
+    _check_symbolic_example(mod)
+
+
+def test_symbolic_shape_runtime_size():
+    mod = _symbolic_example()
+    planned = relax.transform.VMGraphMemoryPlan()(apply_initializing_passes(mod))
+    # without a bound, the tensors of the same symbolic size share storages sized at runtime
+    sizes = _storage_sizes(planned["main"])
+    assert len(sizes) == 2
+    assert all(not isinstance(size, tvm.tir.IntImm) for size in sizes)
+    _check_symbolic_example(mod)
+
+
+def test_offset_packing():
+    x = relax.Var("x", (2, 4), relax.DynTensorType(2, "float32"))
+
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        v0 = bb.emit_te(topi.exp, x)
+        v1 = bb.emit_te(topi.reshape, v0, (8,))
+        v2 = bb.emit_te(topi.nn.relu, v1)
+        v3 = bb.emit_te(topi.concatenate, [v1, v2])
+        v4 = bb.emit_te(topi.log, v3)
+        bb.emit_func_output(v4)
+    mod = bb.get()
+
+    with tvm.transform.PassContext(config={"relax.VMGraphMemoryPlan.offset_packing": True}):
+        planned = relax.transform.VMGraphMemoryPlan()(apply_initializing_passes(mod))
+        exec = relax.vm.build(mod, "llvm")
+    # the intermediates share one storage, where v1, v2 and v3 are live together and v2 reuses
+    # the offset of v0
+    sizes = _storage_sizes(planned["main"])
+    assert len(sizes) == 1
+    offsets = set()
+    for block in planned["main"].body.blocks:
+        for binding in block.bindings:
+            value = binding.value
+            if isinstance(value, relax.Call) and value.op == tvm.ir.Op.get(
+                "relax.memory.alloc_tensor"
+            ):
+                offsets.add(value.attrs.offset)
+    assert len(offsets) == 3
+
+    dev = tvm.cpu(0)
+    vm = relax.VirtualMachine(exec, dev)
+    x_np = np.random.rand(2, 4).astype("float32")
+    y_np = np.reshape(np.exp(x_np), (8,))
+    y_np = np.log(np.concatenate([y_np, np.maximum(y_np, 0.0)]))
+    y_relax = vm["main"](tvm.nd.array(x_np, dev))
+    tvm.testing.assert_allclose(y_relax.numpy(), y_np, rtol=1e-5, atol=1e-5)
+
+
+def test_vtcm_placement():
+    x = relax.Var("x", (2, 4), relax.DynTensorType(2, "float32"))
+
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        v0 = bb.emit_te(topi.exp, x)
+        v1 = bb.emit_te(topi.nn.relu, v0)
+        v2 = bb.emit_te(topi.nn.pad, v1, pad_before=[0, 1], pad_after=[0, 1], pad_value=1)
+        v3 = bb.emit_te(topi.log, v2)
+        v4 = bb.emit_te(topi.exp, v3)
+        bb.emit_func_output(v4)
+    mod = bb.get()
+
+    with tvm.transform.PassContext(config={"relax.VMGraphMemoryPlan.vtcm_capacity": 128}):
+        planned = relax.transform.VMGraphMemoryPlan()(apply_initializing_passes(mod))
+    scopes = {}
+    for block in planned["main"].body.blocks:
+        for binding in block.bindings:
+            value = binding.value
+            if isinstance(value, relax.Call) and value.op == tvm.ir.Op.get(
+                "relax.memory.alloc_storage"
+            ):
+                size = value.args[0].values[0].value
+                scopes.setdefault(value.attrs.storage_scope, []).append(size)
+    # the 32-byte tensors fit a quarter of the capacity and go to VTCM, the padded ones do not
+    assert scopes["global.vtcm"] == [32, 32]
+    assert scopes["global"] and all(size == 48 for size in scopes["global"])
+
+
+def test_texture_planning():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def to_texture(a: T.handle, b: T.handle) -> None:
+            A = T.match_buffer(a, (2, 8, 8, 4), dtype="float32")
+            B = T.match_buffer(b, (2, 8, 8, 4), dtype="float32", scope="global.texture")
+            for i, j, k, c in T.grid(2, 8, 8, 4):
+                with T.block("copy"):
+                    vi, vj, vk, vc = T.axis.remap("SSSS", [i, j, k, c])
+                    B[vi, vj, vk, vc] = A[vi, vj, vk, vc]
+
+        @T.prim_func
+        def relu_texture(a: T.handle, b: T.handle) -> None:
+            A = T.match_buffer(a, (2, 8, 8, 4), dtype="float32", scope="global.texture")
+            B = T.match_buffer(b, (2, 8, 8, 4), dtype="float32", scope="global.texture")
+            for i, j, k, c in T.grid(2, 8, 8, 4):
+                with T.block("relu"):
+                    vi, vj, vk, vc = T.axis.remap("SSSS", [i, j, k, c])
+                    B[vi, vj, vk, vc] = T.max(A[vi, vj, vk, vc], T.float32(0))
+
+        @T.prim_func
+        def slice_texture(a: T.handle, b: T.handle) -> None:
+            A = T.match_buffer(a, (2, 8, 8, 4), dtype="float32", scope="global.texture")
+            B = T.match_buffer(b, (1, 8, 8, 4), dtype="float32", scope="global.texture")
+            for i, j, k, c in T.grid(1, 8, 8, 4):
+                with T.block("slice"):
+                    vi, vj, vk, vc = T.axis.remap("SSSS", [i, j, k, c])
+                    B[vi, vj, vk, vc] = A[vi, vj, vk, vc]
+
+        @T.prim_func
+        def from_texture(a: T.handle, b: T.handle) -> None:
+            A = T.match_buffer(a, (1, 8, 8, 4), dtype="float32", scope="global.texture")
+            B = T.match_buffer(b, (1, 8, 8, 4), dtype="float32")
+            for i, j, k, c in T.grid(1, 8, 8, 4):
+                with T.block("copy"):
+                    vi, vj, vk, vc = T.axis.remap("SSSS", [i, j, k, c])
+                    B[vi, vj, vk, vc] = A[vi, vj, vk, vc]
+
+        @R.function
+        def main(x: R.Tensor((2, 8, 8, 4), "float32")):
+            t0 = relax.call_tir(to_texture, (x,), (2, 8, 8, 4), dtype="float32")
+            t1 = relax.call_tir(relu_texture, (t0,), (2, 8, 8, 4), dtype="float32")
+            t2 = relax.call_tir(slice_texture, (t1,), (1, 8, 8, 4), dtype="float32")
+            y = relax.call_tir(from_texture, (t2,), (1, 8, 8, 4), dtype="float32")
+            return y
+
+    planned = relax.transform.VMGraphMemoryPlan()(apply_initializing_passes(Module))
+    storages = []
+    for block in planned["main"].body.blocks:
+        for binding in block.bindings:
+            value = binding.value
+            if isinstance(value, relax.Call) and value.op == tvm.ir.Op.get(
+                "relax.memory.alloc_storage"
+            ):
+                extent = [dim.value for dim in value.args[0].values]
+                storages.append((value.attrs.storage_scope, extent))
+    # the images are sized by their (height, width, channel) extents, and the sliced tensor
+    # reuses the image of the first one, which covers it
+    assert storages == [("global.texture", [16, 8, 4]), ("global.texture", [16, 8, 4])]
+
+
 if __name__ == "__main__":
     test_minimum_example()
+    test_offset_packing()
+    test_vtcm_placement()
+    test_texture_planning()
+    test_symbolic_shape_upper_bound()
+    test_symbolic_shape_runtime_size()
@@ -325,6 +325,36 @@ def test_reshape_nop():
 
 
 @tvm.testing.uses_gpu
+def test_memory_arena():
+    x = relay.var("x", shape=(16, 8))
+    y = relay.exp(x)
+    z0 = relay.sqrt(relay.abs(y))
+    z1 = relay.log(relay.add(y, relay.const(1.0)))
+    out = relay.concatenate([relay.negative(z0), relay.tanh(z1)], axis=0)
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    x_data = np.random.rand(16, 8).astype("float32")
+
+    def run(config):
+        with tvm.transform.PassContext(opt_level=0, config=config):
+            lib = relay.build(mod, "llvm")
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_input(x=x_data)
+        gmod.run()
+        return json.loads(lib.get_graph_json()), gmod.get_output(0).numpy()
+
+    graph_json, expected = run({})
+    assert "storage_offset" not in graph_json["attrs"]
+    graph_json, out = run({"relay.backend.graph_memory_arena": True})
+    offsets = graph_json["attrs"]["storage_offset"][1]
+    storage_ids = graph_json["attrs"]["storage_id"][1]
+    # Each tensor has its own storage, at an aligned offset of the arena.
+    assert len(set(storage_ids)) == len(storage_ids)
+    assert all(offset >= 0 and offset % 64 == 0 for offset in offsets)
+    # The tensors with disjoint lifetimes share the bytes of the arena.
+    assert len(set(offsets)) < len(offsets)
+    tvm.testing.assert_allclose(out, expected)
+
+
 def test_gru_like():
     def unit(rnn_dim):
         X = relay.var("X", shape=(1, rnn_dim))
@@ -260,6 +260,32 @@ def test_extern_gcc_consts(check_result):
     check_result(mod, inputs, shape, expected_result, target="llvm")
 
 
+def test_extern_gcc_consts_init_imports():
+    shape = (8, 8)
+    dtype = "float32"
+    x = relay.var("x", shape=shape)
+    y_data = [np.random.uniform(0, 1, shape).astype(dtype) for _ in range(4)]
+    out = x
+    for i, data in enumerate(y_data):
+        x0 = relay.var("x0", shape=shape)
+        f = relay.Function([x0], x0 + relay.const(data, dtype))
+        f = set_external_func_attr(f, "ccompiler", "ccompiler_%d" % i)
+        out = relay.Call(f, [out])
+    mod = tvm.IRModule.from_expr(out)
+
+    with tvm.transform.PassContext(opt_level=3):
+        factory = relay.build(mod, target="llvm")
+    lib = update_lib(factory.lib)
+    # The submodules are initialized in parallel ahead of the first run, and only once.
+    lib.init_imports(num_threads=4)
+    lib.init_imports()
+    rt_mod = tvm.contrib.graph_executor.create(factory.graph_json, lib, tvm.cpu())
+    x_data = np.random.rand(*shape).astype(dtype)
+    rt_mod.set_input("x", x_data)
+    rt_mod.run()
+    tvm.testing.assert_allclose(rt_mod.get_output(0).numpy(), x_data + sum(y_data), rtol=1e-5)
+
+
 @pytest.mark.skipif(
     not tvm.get_global_func("relay.ext.dnnl", True),
     reason="skip because DNNL codegen is not available",
@@ -173,6 +173,42 @@ def test_calibrate_percentile():
         relay.quantize.quantize(mod, params, dataset)
 
 
+@pytest.mark.parametrize("calibrate_mode", ["kl_divergence", "percentile"])
+def test_calibrate_parallel(calibrate_mode):
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    # The workers calibrate to the same scales as a serial run over the same dataset
+    quantized = []
+    for num_workers in [1, 2]:
+        with relay.quantize.qconfig(
+            calibrate_mode=calibrate_mode, calibrate_num_workers=num_workers
+        ):
+            quantized.append(relay.quantize.quantize(mod, params, dataset))
+    tvm.ir.assert_structural_equal(quantized[0], quantized[1])
+
+
+def test_calibration_stats_streaming():
+    from tvm.relay.quantize import _quantize
+    from tvm.relay.quantize.kl_divergence import _find_scale_by_kl
+    from tvm.relay.quantize._calibrate import _find_scale_by_percentile
+
+    np.random.seed(0)
+    batches = [np.random.normal(size=(4, 1000)).astype("float32") for _ in range(5)]
+    stats = _quantize.CalibrationStats(1, 8001, 16384)
+    for batch in batches:
+        _quantize.CalibrationStatsUpdateRange(stats, 0, tvm.nd.array(batch))
+    for batch in batches:
+        _quantize.CalibrationStatsUpdateHistogram(stats, 0, tvm.nd.array(batch))
+    # The statistics of the batches are the ones of their concatenation, up to a bin.
+    data = np.concatenate(batches).reshape(-1)
+    abs_max = np.abs(data).max()
+    (kl_scale,) = _quantize.CalibrationStatsFindScalesByKL(stats, 255)
+    assert abs(kl_scale.value - _find_scale_by_kl(data)) <= 2 * abs_max / 8001 + 1e-6
+    (percentile_scale,) = _quantize.CalibrationStatsFindScalesByPercentile(stats, 0.99999)
+    expected = _find_scale_by_percentile(data)
+    assert expected <= percentile_scale.value <= expected + abs_max / 16384 + 1e-6
+
+
 ####################################
 # Quant/Dequant Partitioning Tests #
 ####################################
@@ -23,6 +23,7 @@ from tvm.target import make_compilation_config
 from tvm.relay.collage import MockCostEstimator
 from unittest.mock import patch
 from tvm.relay.dataflow_pattern import is_op, wildcard
+from tvm.contrib import utils
 
 
 # We'll reuse the target kind "example_target_hook" (registered in
@@ -679,5 +680,43 @@ def test_pruning_heuristic(mock_get_pattern_table):
     run_collage(mod, targets, cost_estimator, expected_mod, tvm_max_depth=4, byoc_max_depth=4)
 
 
+@patch("tvm.relay.op.contrib.get_pattern_table", wraps=_mock_get_pattern_table)
+def test_parallel_estimation_and_cost_cache(mock_get_pattern_table):
+    mod_txt = """
+      #[version = "0.0.5"]
+      def @main(%x: Tensor[(10, 10), float32]) {
+        %0 = nn.relu(%x);
+        %1 = abs(%0);
+        %2 = nn.relu(%1);
+        add(%1, %2)
+      }
+    """
+    mod = tvm.parser.fromtext(mod_txt)
+    targets = [
+        tvm.target.Target("llvm"),
+        tvm.target.Target("example_target_hook"),
+    ]
+
+    def partition(cost_estimator, num_threads, cost_cache_dir=""):
+        ctxt = {
+            "relay.collage.num_estimation_threads": num_threads,
+            "relay.collage.cost_cache_dir": cost_cache_dir,
+        }
+        pass_ctxt = tvm.transform.PassContext(config=ctxt)
+        with pass_ctxt:
+            config = make_compilation_config(pass_ctxt, targets)
+            return CollagePartition(config, cost_estimator)(InferType()(mod))
+
+    target_costs = {"llvm": 3, "example_target_hook": 2}
+    sequential_mod = partition(MockCostEstimator(target_costs), 1)
+    temp = utils.tempdir()
+    parallel_mod = partition(MockCostEstimator(target_costs), 4, temp.temp_dir)
+    tvm.ir.assert_structural_equal(parallel_mod, sequential_mod, map_free_vars=True)
+    assert len(temp.listdir()) > 0
+    # All the costs are recorded, so the estimator, which knows no target, is never invoked.
+    cached_mod = partition(MockCostEstimator({}), 1, temp.temp_dir)
+    tvm.ir.assert_structural_equal(cached_mod, sequential_mod, map_free_vars=True)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -16,11 +16,13 @@
 # under the License.
 """ Instrument test cases.
 """
+import json
+
 import pytest
 import tvm
 import tvm.relay
 from tvm.relay import op
-from tvm.ir.instrument import PassTimingInstrument, pass_instrument
+from tvm.ir.instrument import PassProfilingInstrument, PassTimingInstrument, pass_instrument
 
 
 def get_test_model():
@@ -59,6 +61,28 @@ def test_pass_timing_instrument():
     assert profiles == ""
 
 
+def test_pass_profiling_instrument():
+    profiling = PassProfilingInstrument()
+    seq = tvm.transform.Sequential(
+        [tvm.relay.transform.ToANormalForm(), tvm.relay.transform.InferType()], name="seq"
+    )
+    with tvm.transform.PassContext(instruments=[profiling]):
+        seq(get_test_model())
+        profiles = profiling.render()
+        trace = json.loads(profiling.render_chrome_trace())
+
+    lines = profiles.splitlines()
+    assert lines[0].startswith("seq: ")
+    # The passes of the Sequential are nested under it.
+    assert lines[1].startswith("\tToANormalForm: ")
+    assert "nodes" in lines[1]
+    events = {event["name"]: event for event in trace["traceEvents"]}
+    assert set(events) == {"seq", "ToANormalForm", "InferType"}
+    assert events["seq"]["ph"] == "X"
+    assert events["ToANormalForm"]["ts"] >= events["seq"]["ts"]
+    assert events["InferType"]["args"]["num_nodes_before"] > 0
+
+
 instrument_definition_type = tvm.testing.parameter("decorator", "subclass")
 
 
@@ -21,7 +21,7 @@ import time
 import numpy as np
 import tvm
 import tvm.testing
-from tvm import relay
+from tvm import relax, relay, topi
 from tvm.relay import transform, build_module
 from tvm.relay.testing import run_opt_pass
 from tvm.contrib import graph_executor, pipeline_executor, pipeline_executor_build
@@ -623,5 +623,105 @@ def test_pipeline():
             reset_cpu_affinity(affinity)
 
 
+def test_pipeline_queue_capacity_and_replicas():
+    if pipeline_executor_build.pipeline_executor_build_enabled():
+        (mod1, mod2, mod3), dshape = get_split_mod()
+        pipe_config = pipeline_executor_build.PipelineConfig()
+        pipe_config["input"]["data_a"].connect(pipe_config[mod1]["input"]["data_0"])
+        pipe_config["input"]["data_b"].connect(pipe_config[mod2]["input"]["data_1"])
+        pipe_config[mod1]["output"][0].connect(pipe_config[mod2]["input"]["data_n_0"])
+        pipe_config[mod1]["output"][1].connect(pipe_config[mod3]["input"]["data_n_2"])
+        pipe_config[mod2]["output"][0].connect(pipe_config[mod3]["input"]["data_n_1"])
+        pipe_config[mod3]["output"][0].connect(pipe_config["output"]["0"])
+        for mod in [mod1, mod2, mod3]:
+            pipe_config[mod].target = "llvm"
+            pipe_config[mod].dev = tvm.cpu(0)
+        # The runs of mod2 are shared by a copy of it.
+        pipe_config[mod2].replica_devs = [tvm.cpu(0)]
+        pipe_config.queue_capacity = 4
+        mconfig = pipe_config.get_config()
+        assert mconfig["queue_capacity"] == 4
+
+        with tvm.transform.PassContext(opt_level=3):
+            pipeline_mod_factory = pipeline_executor_build.build(pipe_config)
+        pipeline_module = pipeline_executor.PipelineModule(pipeline_mod_factory)
+
+        datas = [np.full(dshape, 3 + i).astype("float32") for i in range(3)]
+        expected_outputs = [
+            run_modules(
+                mconfig["module_connection"], tvm.cpu(), "llvm", "data_0", data, mod2, "data_1", data
+            )
+            for data in datas
+        ]
+        # The runs in flight fit in the queues, so none of them is blocked forever.
+        for data in datas:
+            pipeline_module.set_input("data_a", tvm.nd.array(data))
+            pipeline_module.set_input("data_b", tvm.nd.array(data))
+            pipeline_module.run()
+        # The outputs of the replicated mod2 come out in the order of the inputs.
+        for expected_output in expected_outputs:
+            outputs = pipeline_module.get_output()
+            tvm.testing.assert_allclose(expected_output[0], outputs[0].numpy())
+
+        # A stage counts a run after forwarding its outputs.
+        for _ in range(100):
+            metrics = pipeline_module.stage_metrics()
+            stages = metrics["stages"]
+            if all(stage["executions"] == len(datas) for stage in stages):
+                break
+            time.sleep(0.01)
+        assert [stage["replicas"] for stage in stages] == [1, 2, 1]
+        assert [stage["executions"] for stage in stages] == [len(datas)] * 3
+        for stage in stages:
+            assert stage["throughput"] > 0
+            for queue in stage["inputs"]:
+                assert queue["capacity"] == 4
+                assert 0 < queue["max_depth"] <= 4
+        assert metrics["outputs"][0]["depth"] == 0
+
+
+def get_relax_split_mod(dshape):
+    mods = []
+    for op in [topi.add, topi.multiply]:
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", dshape, relax.DynTensorType(len(dshape), "float32"))
+        y = relax.Var("y", dshape, relax.DynTensorType(len(dshape), "float32"))
+        with bb.function("main", [x, y]):
+            gv = bb.emit_te(op, x, y)
+            bb.emit_func_output(gv)
+        mods.append(bb.get())
+    return mods
+
+
+def test_pipeline_relax_vm_stages():
+    if pipeline_executor_build.pipeline_executor_build_enabled():
+        dshape = (3, 3)
+        mod1, mod2 = get_relax_split_mod(dshape)
+        pipe_config = pipeline_executor_build.PipelineConfig()
+        pipe_config["input"]["data_a"].connect(pipe_config[mod1]["input"]["x"])
+        pipe_config["input"]["data_b"].connect(pipe_config[mod1]["input"]["y"])
+        pipe_config["input"]["data_c"].connect(pipe_config[mod2]["input"]["y"])
+        pipe_config[mod1]["output"][0].connect(pipe_config[mod2]["input"]["x"])
+        pipe_config[mod2]["output"][0].connect(pipe_config["output"]["0"])
+        for mod in [mod1, mod2]:
+            pipe_config[mod].target = "llvm"
+            pipe_config[mod].dev = tvm.cpu(0)
+        pipe_config[mod2].replica_devs = [tvm.cpu(0)]
+        mconfig = pipe_config.get_config()
+        assert [conf["vm_func"] for conf in mconfig["module_connection"].values()] == ["main"] * 2
+
+        pipeline_mod_factory = pipeline_executor_build.build(pipe_config)
+        pipeline_module = pipeline_executor.PipelineModule(pipeline_mod_factory)
+        datas = [np.full(dshape, 3 + i).astype("float32") for i in range(3)]
+        for data in datas:
+            pipeline_module.set_input("data_a", tvm.nd.array(data))
+            pipeline_module.set_input("data_b", tvm.nd.array(data))
+            pipeline_module.set_input("data_c", tvm.nd.array(data))
+            pipeline_module.run()
+        for data in datas:
+            outputs = pipeline_module.get_output()
+            tvm.testing.assert_allclose((data + data) * data, outputs[0].numpy())
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
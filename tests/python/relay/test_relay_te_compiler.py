@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
 import tvm
 from tvm import te
@@ -24,6 +26,7 @@ from tvm import topi
 from tvm.relay.backend import te_compiler
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
+from tvm.contrib import graph_executor, utils
 
 
 @autotvm.register_topi_compute("test/conv2d_1")
@@ -284,6 +287,68 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+def test_compile_global_cache():
+    def get_mod(shape, unary):
+        x = relay.var("x", shape=shape)
+        y = unary(relay.add(x, x))
+        return tvm.IRModule.from_expr(relay.Function([x], y))
+
+    def run(mod, inp):
+        lib = relay.build(mod, target="llvm")
+        rt = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        rt.set_input("x", inp)
+        rt.run()
+        return rt.get_output(0).numpy()
+
+    inp = np.random.uniform(size=(8,)).astype("float32")
+    temp = utils.tempdir()
+    config = {"relay.backend.te_compiler_cache_dir": temp.temp_dir}
+    with tvm.transform.PassContext(opt_level=0, config=config):
+        res_exp = run(get_mod((8,), relay.exp), inp)
+        num_records = len(temp.listdir())
+        assert num_records > 0
+        # The add is reused, and only the negative is lowered.
+        res_neg = run(get_mod((8,), relay.negative), inp)
+        assert len(temp.listdir()) == num_records + 1
+        te_compiler.clear_global_cache()
+        res_persisted = run(get_mod((8,), relay.exp), inp)
+        assert len(temp.listdir()) == num_records + 1
+    tvm.testing.assert_allclose(res_exp, np.exp(inp + inp), rtol=1e-5)
+    tvm.testing.assert_allclose(res_neg, -(inp + inp), rtol=1e-5)
+    tvm.testing.assert_allclose(res_persisted, res_exp, rtol=1e-5)
+    te_compiler.clear_global_cache()
+
+
+def test_compile_parallel():
+    x = relay.var("x", shape=(1, 3, 16, 16))
+    w = relay.var("w", shape=(8, 3, 3, 3))
+    y = relay.nn.relu(relay.nn.conv2d(x, w, padding=(1, 1)))
+    y = relay.exp(relay.nn.max_pool2d(y)) + relay.sigmoid(y)
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], y))
+    params = {
+        "w": np.random.uniform(size=(8, 3, 3, 3)).astype("float32"),
+    }
+    inp = np.random.uniform(size=(1, 3, 16, 16)).astype("float32")
+
+    def build(num_threads):
+        config = {"relay.backend.te_compiler_num_threads": num_threads}
+        with tvm.transform.PassContext(opt_level=0, config=config):
+            lib = relay.build(mod, target="llvm", params=params)
+        rt = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        rt.set_input("x", inp)
+        rt.run()
+        return lib.get_graph_json(), rt.get_output(0).numpy()
+
+    graph_seq, res_seq = build(1)
+    graph_par, res_par = build(4)
+    # The lowered functions are named deterministically.
+    assert graph_par == build(4)[0]
+    assert sorted(json.loads(graph_par)["nodes"], key=str) == sorted(
+        json.loads(graph_seq)["nodes"], key=str
+    )
+    tvm.testing.assert_allclose(res_par, res_seq, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +358,5 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_compile_global_cache()
+    test_compile_parallel()
@@ -1563,5 +1563,30 @@ def test_load_late_bound_consts_via_map_with_no_late_bound_consts():
     tvm.testing.assert_allclose(expected, actual.numpy())
 
 
+def test_storage_arena():
+    x = relay.var("x", shape=(16, 16), dtype="float32")
+    y = relay.nn.relu(relay.exp(x) + x)
+    mod = tvm.IRModule.from_expr(relay.Function([x], y * relay.const(2.0)))
+    vm_exec = vm.compile(mod, target="llvm")
+    vm_obj = runtime.vm.VirtualMachine(vm_exec, tvm.cpu())
+    vm_obj.set_storage_arena(True)
+
+    x_data = np.random.rand(16, 16).astype("float32")
+    expected = np.maximum(np.exp(x_data) + x_data, 0) * 2
+    outputs = []
+    for i in range(4):
+        outputs.append(vm_obj.invoke("main", x_data + i))
+        if i == 0:
+            assert vm_obj.get_num_storage_allocs() > 0
+    # The outputs alive hold on to the regions, so that the arena allocates another set.
+    for i, out in enumerate(outputs):
+        x_i = x_data + i
+        tvm.testing.assert_allclose(out.numpy(), np.maximum(np.exp(x_i) + x_i, 0) * 2, rtol=1e-5)
+    outputs = []
+    for _ in range(4):
+        tvm.testing.assert_allclose(vm_obj.invoke("main", x_data).numpy(), expected, rtol=1e-5)
+        assert vm_obj.get_num_storage_allocs() == 0
+
+
 if __name__ == "__main__":
     tvm.testing.main()
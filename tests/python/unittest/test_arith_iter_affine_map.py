@@ -1066,5 +1066,26 @@ def test_overlapped_fuse():
     assert_iter_sum_failure([5 * x + 2 * y], var_dom([(x, 4), (y, 3)]), check_level="surjective")
 
 
+
+def test_split_of_same_fused_sum():
+    x = tvm.tir.Var("x", "int32")
+    y = tvm.tir.Var("y", "int32")
+    z = tvm.tir.Var("z", "int32")
+    fld = tvm.tir.floordiv
+    flm = tvm.tir.floormod
+    dom_map = var_dom([(x, 4), (y, 4), (z, 2)])
+
+    # the splits share the fusion of the sum
+    fused = x * 8 + y * 2 + z
+    assert_iter_sum_pattern({fld(fused, 4): (8, 0), flm(fused, 4): (4, 0)}, dom_map)
+    assert_iter_sum_pattern({fld(fused, 4) * 4 + flm(fused, 4): (32, 0)}, dom_map)
+    assert_iter_sum_pattern(
+        {fld(fused, 8): (4, 0), fld(flm(fused, 8), 2): (4, 0), flm(fused, 2): (2, 0)},
+        dom_map,
+        check_level="bijective",
+    )
+    assert_iter_sum_failure([fld(fused, 4), flm(fused, 8)], dom_map)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -38,6 +38,28 @@ def test_apply_steps():
     tvm.lower(sch, tensors, simple_mode=True)
 
 
+def test_apply_steps_shared_prefix():
+    dag, s = get_tiled_matmul()
+    C = s.stage_ops[2]
+    expected = []
+    states = []
+    for i in range(3):
+        # The states share the steps of the tiling, and are applied after it is cached.
+        state = s.copy()
+        state.parallel(C, state[C].iters[i])
+        state.vectorize(C, state[C].iters[7])
+        dag.apply_steps_from_state(s)
+        sch, tensors = dag.apply_steps_from_state(state)
+        states.append(state)
+        expected.append(str(tvm.lower(sch, tensors, simple_mode=True)))
+    fresh_dag = auto_scheduler.ComputeDAG(dag.tensors)
+    for state, script in zip(states, expected):
+        sch, tensors = fresh_dag.apply_steps_from_state(state)
+        assert str(tvm.lower(sch, tensors, simple_mode=True)) == script
+        sch, tensors = dag.apply_steps_from_state(state)
+        assert str(tvm.lower(sch, tensors, simple_mode=True)) == script
+
+
 def test_infer_bound():
     dag, s = get_tiled_matmul()
     s = dag.infer_bound_from_state(s)
@@ -151,6 +173,7 @@ def test_invalid_compute_dag():
 
 if __name__ == "__main__":
     test_apply_steps()
+    test_apply_steps_shared_prefix()
     test_infer_bound()
     test_estimate_flop()
     test_stage_order()
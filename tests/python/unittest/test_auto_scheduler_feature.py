@@ -49,6 +49,11 @@ def test_cpu_matmul():
     task = auto_scheduler.SearchTask(compute_dag=dag, workload_key="test", target=target)
     names = auto_scheduler.feature.get_per_store_feature_names()
     fea = auto_scheduler.feature.get_per_store_features_from_states([s], task)[0]
+    # The features of a state extracted again are cached.
+    fea_again = auto_scheduler.feature.get_per_store_features_from_states([s], task)[0]
+    assert len(fea_again) == len(fea)
+    for stage, stage_again in zip(fea, fea_again):
+        assert all(fequal(x, y) for x, y in zip(stage, stage_again))
 
     stage_0 = fea[0]
     assert len(stage_0) == len(names), "%d vs %d" % (len(stage_0), len(names))
@@ -361,6 +361,38 @@ def test_platform_timer():
         assert len(result.results) == 3
 
 
+@tvm.testing.requires_micro
+def test_batch_time_evaluator():
+    """Verify several candidates flashed in one image are timed in a single call."""
+    import tvm.micro
+
+    temp_dir = tvm.contrib.utils.tempdir()
+    candidates = []
+    for split in [1, 2, 4]:
+        A = tvm.te.placeholder((8,), dtype="float32", name="A")
+        B = tvm.te.compute(A.shape, lambda i: tvm.te.exp(A[i]), name="B")
+        s = tvm.te.create_schedule(B.op)
+        s[B].split(B.op.axis[0], factor=split)
+        candidates.append((s, [A, B]))
+    with tvm.transform.PassContext(opt_level=3, config={"tir.disable_vectorize": True}):
+        mod, names = tvm.micro.build_candidates(candidates, Target(TARGET, TARGET))
+    assert names == ["candidate_0", "candidate_1", "candidate_2"]
+
+    with _make_session(temp_dir, mod) as sess:
+        A_data = tvm.nd.array(np.ones((8,), dtype="float32"), device=sess.device)
+        B_data = tvm.nd.array(np.zeros((8,), dtype="float32"), device=sess.device)
+        time_eval_f = sess.batch_time_evaluator(names, number=200, repeat=3)
+        results = time_eval_f(A_data, B_data)
+        assert len(results) == 3
+        for result in results:
+            assert len(result.results) == 3
+            assert result.mean > 0
+        np.testing.assert_allclose(B_data.numpy(), np.exp(A_data.numpy()), rtol=1e-5)
+
+        with pytest.raises(ValueError):
+            sess.batch_time_evaluator(["candidate_0,candidate_1"])
+
+
 @tvm.testing.requires_micro
 def test_autotune():
     """Verify that autotune works with micro."""
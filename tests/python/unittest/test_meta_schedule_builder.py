@@ -31,7 +31,11 @@ from tvm.meta_schedule.builder import (
     BuilderResult,
     LocalBuilder,
     PyBuilder,
+    RPCBuilder,
 )
+from tvm.meta_schedule.builder.rpc_builder import init_build_server
+from tvm.meta_schedule.runner import RPCConfig
+from tvm.meta_schedule.testing.local_rpc import LocalRPC
 from tvm.runtime import Module
 from tvm.script import tir as T
 from tvm.target import Target
@@ -225,5 +229,26 @@ def test_meta_schedule_missing_build_func():
         LocalBuilder(f_build="wrong-name")
 
 
+def test_meta_schedule_rpc_build():
+    """Test meta schedule builder dispatching the builds to an RPC build server"""
+    builder_inputs = [
+        BuilderInput(MatmulModule, Target("llvm")),
+        BuilderInput(MatmulReluModule, Target("llvm")),
+    ]
+    with LocalRPC(server_init_callback=init_build_server) as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+        )
+        builder = RPCBuilder(rpc_config)
+        assert builder.max_workers == 1
+        builder_results = builder.build(builder_inputs)
+    assert len(builder_results) == len(builder_inputs)
+    _check_build_results(builder_results)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
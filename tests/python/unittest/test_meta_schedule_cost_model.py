@@ -26,7 +26,13 @@ from typing import List
 import numpy as np
 import tvm
 import tvm.testing
-from tvm.meta_schedule.cost_model import PyCostModel, RandomModel, XGBModel
+from tvm.meta_schedule.cost_model import (
+    GBDTModel,
+    PyCostModel,
+    RandomModel,
+    RooflineModel,
+    XGBModel,
+)
 from tvm.meta_schedule.cost_model.xgb_model import PackSum, _get_custom_call_back
 from tvm.meta_schedule.feature_extractor import RandomFeatureExtractor
 from tvm.meta_schedule.runner import RunnerResult
@@ -231,6 +237,53 @@ def test_meta_schedule_xgb_model_reupdate():
     model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
 
 
+def test_meta_schedule_gbdt_model():
+    extractor = RandomFeatureExtractor()
+    model = GBDTModel(extractor=extractor, num_warmup_samples=2, num_trees_per_update=5)
+    update_sample_count = 20
+    predict_sample_count = 30
+    for i in range(3):
+        model.update(
+            TuneContext(),
+            [_dummy_candidate() for i in range(update_sample_count)],
+            [_dummy_result() for i in range(update_sample_count)],
+        )
+        # The trees are grown upon the existing ones.
+        assert model.num_trees == 5 * (i + 1)
+    with tempfile.NamedTemporaryFile() as path:
+        model.save(path.name)
+        random_state = extractor.random_state
+        res1 = model.predict(
+            TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)]
+        )
+        reloaded = GBDTModel(extractor=extractor, num_warmup_samples=2, num_trees_per_update=5)
+        reloaded.load(path.name)
+        extractor.random_state = random_state
+        res2 = reloaded.predict(
+            TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)]
+        )
+    assert res1.shape == (predict_sample_count,)
+    assert (res1 == res2).all()
+    assert reloaded.num_trees == model.num_trees
+
+
+def test_meta_schedule_gbdt_model_retrain():
+    model = GBDTModel(
+        extractor=RandomFeatureExtractor(),
+        num_warmup_samples=0,
+        num_trees_per_update=4,
+        max_num_trees=8,
+    )
+    for _ in range(3):
+        model.update(
+            TuneContext(),
+            [_dummy_candidate() for i in range(10)],
+            [_dummy_result() for i in range(10)],
+        )
+    # The third update exceeds the maximum number of trees, and the ensemble is retrained.
+    assert model.num_trees == 4
+
+
 def xgb_version_check():
 
     # pylint: disable=import-outside-toplevel
@@ -329,5 +382,52 @@ def test_meta_schedule_xgb_model_callback_as_function():
     assert np.allclose(pred1, pred2, rtol=1e-3, atol=1e-3)
 
 
+def test_meta_schedule_roofline_model():
+    model = RooflineModel(peak_flops=1e12, bandwidth={"global": 1e11}, num_cores=8)
+    # 2 * 1024^3 FLOPs and 4 accesses of 4 bytes per iteration of the serial loop nest
+    serial = Schedule(Matmul)
+    assert np.isclose(model.estimate_time(serial.mod), 16 * 1024**3 / 1e11 * 8)
+    parallel = Schedule(Matmul)
+    i, _, _ = parallel.get_loops(parallel.get_block("matmul"))
+    parallel.parallel(i)
+    scores = model.predict(
+        TuneContext(), [MeasureCandidate(serial, []), MeasureCandidate(parallel, [])]
+    )
+    assert np.allclose(scores, [1 / 8, 1])
+
+
+def test_meta_schedule_roofline_model_blend():
+    @derived_object
+    class ConstantCostModel(PyCostModel):
+        def load(self, path: str) -> None:
+            pass
+
+        def save(self, path: str) -> None:
+            pass
+
+        def update(
+            self,
+            context: TuneContext,
+            candidates: List[MeasureCandidate],
+            results: List[RunnerResult],
+        ) -> None:
+            pass
+
+        def predict(self, context: TuneContext, candidates: List[MeasureCandidate]) -> np.ndarray:
+            return np.full(len(candidates), 0.5)
+
+    model = RooflineModel(
+        peak_flops=1e12,
+        bandwidth={"global": 1e11},
+        base_model=ConstantCostModel(),
+        num_warmup_samples=4,
+    )
+    candidates = [_dummy_candidate() for _ in range(8)]
+    assert np.allclose(model.predict(TuneContext(), candidates), 1.0)
+    # Half way through the warmup, the scores are the average of both models
+    model.update(TuneContext(), [_dummy_candidate() for _ in range(2)], [_dummy_result()] * 2)
+    assert np.allclose(model.predict(TuneContext(), candidates), 0.75)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
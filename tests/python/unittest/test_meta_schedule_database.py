@@ -413,6 +413,89 @@ def test_meta_schedule_database_reload():
             _equal_record(ret[1], records[2])
 
 
+def test_meta_schedule_indexed_database_reload():
+    mod: IRModule = Matmul
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = ms.database.IndexedDatabase(work_dir=tmpdir, num_shards=4)
+        token = database.commit_workload(mod)
+        trace = _create_schedule(mod, _schedule_matmul).trace
+        records = [
+            ms.database.TuningRecord(
+                trace,
+                token,
+                run_secs,
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            )
+            for run_secs in [[7.0, 8.0, 9.0], [1.0, 2.0, 3.0], None, [4.0, 5.0, 6.0]]
+        ]
+        for record in records:
+            database.commit_tuning_record(record)
+        assert len(database) == 4
+        # A new log keeps the number of shards it is created with
+        new_database = ms.database.IndexedDatabase(database.path, num_shards=8)
+        assert new_database.has_workload(mod)
+        token = new_database.commit_workload(mod)
+        assert len(new_database) == 4
+        ret = new_database.get_top_k(token, 4)
+        assert len(ret) == 3
+        _equal_record(ret[0], records[1])
+        _equal_record(ret[1], records[3])
+        _equal_record(ret[2], records[0])
+        assert len(new_database.get_all_tuning_records()) == 4
+
+
+def test_meta_schedule_indexed_database_workloads():
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = ms.database.IndexedDatabase(work_dir=tmpdir)
+        trace = _create_schedule(Matmul, _schedule_matmul).trace
+        for mod, run_secs in [(Matmul, [2.0]), (MatmulRelu, [1.0])]:
+            database.commit_tuning_record(
+                ms.database.TuningRecord(
+                    trace,
+                    database.commit_workload(mod),
+                    run_secs,
+                    tvm.target.Target("llvm"),
+                    ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+                )
+            )
+        # The records are kept apart by the workloads they are committed with
+        new_database = ms.database.IndexedDatabase(database.path)
+        for mod, run_secs in [(Matmul, [2.0]), (MatmulRelu, [1.0])]:
+            (record,) = new_database.get_top_k(new_database.commit_workload(mod), 2)
+            assert [float(t) for t in record.run_secs] == run_secs
+            tvm.ir.assert_structural_equal(record.workload.mod, mod)
+        for record in new_database.get_all_tuning_records():
+            mod = Matmul if [float(t) for t in record.run_secs] == [2.0] else MatmulRelu
+            tvm.ir.assert_structural_equal(record.workload.mod, mod)
+
+
+def test_meta_schedule_indexed_database_concurrent_append():
+    mod: IRModule = Matmul
+    with tempfile.TemporaryDirectory() as tmpdir:
+        db_1 = ms.database.IndexedDatabase(work_dir=tmpdir)
+        db_2 = ms.database.IndexedDatabase(work_dir=tmpdir)
+        token_1 = db_1.commit_workload(mod)
+        assert db_2.has_workload(mod)
+        token_2 = db_2.commit_workload(mod)
+        trace = _create_schedule(mod, _schedule_matmul).trace
+        for database, token, run_secs in [(db_1, token_1, [2.0]), (db_2, token_2, [1.0])]:
+            database.commit_tuning_record(
+                ms.database.TuningRecord(
+                    trace,
+                    token,
+                    run_secs,
+                    tvm.target.Target("llvm"),
+                    ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+                )
+            )
+        for database, token in [(db_1, token_1), (db_2, token_2)]:
+            assert len(database) == 2
+            ret = database.get_top_k(token, 2)
+            assert [float(t) for t in ret[0].run_secs] == [1.0]
+            assert [float(t) for t in ret[1].run_secs] == [2.0]
+
+
 def test_meta_schedule_database_union():
     mod: IRModule = Matmul
     target = tvm.target.Target("llvm")
@@ -1610,5 +1610,25 @@ def test_negative_extent():
     assert named_features["B0.unique_bytes"] == 0
 
 
+def test_feature_cache():
+    def _schedule():
+        sch = tir.Schedule(matmul, debug_mask="all")
+        i, j, k = sch.get_loops(sch.get_block("C"))
+        sch.reorder(k, i, j)
+        return sch
+
+    context = _make_context(tvm.target.Target("llvm"))
+    candidates = [_make_candidate(_schedule) for _ in range(3)]
+    candidates.append(_make_candidate(lambda: tir.Schedule(matmul, debug_mask="all")))
+    cached = ms.feature_extractor.PerStoreFeature().extract_from(context, candidates)
+    uncached = ms.feature_extractor.PerStoreFeature(feature_cache_size=0).extract_from(
+        context, candidates
+    )
+    # The structurally equal candidates hit the cache, and get the same features as without it.
+    for feature, expected in zip(cached, uncached):
+        assert_allclose(feature.numpy(), expected.numpy(), rtol=1e-5, atol=1e-5)
+    assert_allclose(cached[0].numpy(), cached[2].numpy())
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -22,12 +22,14 @@ from typing import List
 
 import pytest
 import tvm
+import tvm.meta_schedule as ms
 import tvm.testing
 from tvm._ffi import register_func
 from tvm.error import TVMError
 from tvm.meta_schedule import TuneContext
 from tvm.meta_schedule.schedule_rule import PyScheduleRule
 from tvm.meta_schedule.space_generator import PostOrderApply
+from tvm.meta_schedule.testing.space_generation import get_rules
 from tvm.meta_schedule.utils import derived_object
 from tvm.script import tir as T
 from tvm.target import Target
@@ -259,6 +261,31 @@ def test_meta_schedule_post_order_apply_double():
         _check_correct(sch)
 
 
+def test_meta_schedule_post_order_apply_parallel_branches():
+    mod = Matmul
+
+    def _design_space(num_threads: int) -> List[str]:
+        context = TuneContext(
+            mod=mod,
+            target=Target("llvm --num-cores=16"),
+            task_name="Parallel Branches Task",
+            space_generator=PostOrderApply(
+                sch_rules=get_rules("llvm", ms.ScheduleRule),
+                postprocs=[],
+                mutator_probs={},
+            ),
+            rand_state=42,
+            num_threads=num_threads,
+        )
+        return [str(sch.trace) for sch in context.generate_design_space()]
+
+    # The next rules are applied to the branches forked by a rule in parallel, keeping the order
+    # and the random decisions of the sequential generation
+    sequential = _design_space(num_threads=1)
+    assert len(sequential) > 1
+    assert _design_space(num_threads=4) == sequential
+
+
 def test_meta_schedule_post_order_apply_multiple():
     mod = Matmul
     context = TuneContext(
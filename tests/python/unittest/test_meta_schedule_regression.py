@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-docstring
+"""Test the regression detection of the tuned kernels"""
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm.script import tir as T
+from tvm.target import Target
+from tvm.tir import Schedule
+
+
+# pylint: disable=no-member,invalid-name,unused-variable,no-self-argument
+@T.prim_func
+def matmul(a: T.handle, b: T.handle, c: T.handle) -> None:
+    T.func_attr({"global_symbol": "main", "tir.noalias": True})
+    A = T.match_buffer(a, (32, 32), "float32")
+    B = T.match_buffer(b, (32, 32), "float32")
+    C = T.match_buffer(c, (32, 32), "float32")
+    for i, j, k in T.grid(32, 32, 32):
+        with T.block("matmul"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C[vi, vj] = 0.0
+            C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+
+@T.prim_func
+def add(a: T.handle, b: T.handle) -> None:
+    T.func_attr({"global_symbol": "main", "tir.noalias": True})
+    A = T.match_buffer(a, (32,), "float32")
+    B = T.match_buffer(b, (32,), "float32")
+    for i in T.serial(32):
+        with T.block("add"):
+            vi = T.axis.spatial(32, i)
+            B[vi] = A[vi] + 1.0
+
+
+# pylint: enable=no-member,invalid-name,unused-variable,no-self-argument
+
+
+def _commit(database, func, run_secs):
+    mod = tvm.IRModule({"main": func})
+    database.commit_tuning_record(
+        ms.database.TuningRecord(
+            Schedule(mod).trace,
+            database.commit_workload(mod),
+            run_secs,
+            Target("llvm"),
+            ms.arg_info.ArgInfo.from_prim_func(func=func),
+        )
+    )
+
+
+def test_detect_regressions():
+    database = ms.database.MemoryDatabase()
+    # The stored latency of the matmul is unreachable, and the one of the add is never exceeded
+    _commit(database, matmul, [1e-12, 2e-12, 3e-12])
+    _commit(database, add, [100.0])
+    regressions = ms.regression.detect_regressions(database, "llvm --num-cores=1")
+    assert len(regressions) == 1
+    (regression,) = regressions
+    tvm.ir.assert_structural_equal(regression.workload.mod, tvm.IRModule({"main": matmul}))
+    assert regression.stored_sec == 2e-12
+    assert regression.measured_sec is not None
+    assert regression.slowdown > 1.1
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -47,6 +47,7 @@ from tvm.meta_schedule.runner.rpc_runner import (
 from tvm.meta_schedule.runner.rpc_runner import (
     default_alloc_argument as rpc_default_alloc_argument,
 )
+from tvm.meta_schedule.runner.utils import confidence_intervals_separate
 from tvm.meta_schedule.testing.local_rpc import LocalRPC
 from tvm.meta_schedule.utils import (
     derived_object,
@@ -226,6 +227,53 @@ def test_meta_schedule_local_single_run():
     _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_confidence_intervals_separate():
+    """Test the separation of the confidence intervals of the mean costs"""
+    assert not confidence_intervals_separate([1.0], [2.0])
+    assert confidence_intervals_separate([1.0, 1.01, 0.99], [2.0, 2.01, 1.99])
+    assert confidence_intervals_separate([2.0, 2.01, 1.99], [1.0, 1.01, 0.99])
+    assert not confidence_intervals_separate([1.0, 1.5, 2.0], [1.2, 1.6, 1.9])
+
+
+def test_meta_schedule_local_adaptive_runs():
+    """Test meta schedule local runner for the adaptive measurement"""
+    # Build the module
+    mod = MatmulModule
+    builder = LocalBuilder()
+    (builder_result,) = builder.build([BuilderInput(mod, Target("llvm"))])
+    assert builder_result.artifact_path is not None
+    assert builder_result.error_msg is None
+
+    runner_input = RunnerInput(
+        builder_result.artifact_path,
+        "llvm",
+        [
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        ],
+    )
+
+    evaluator_config = EvaluatorConfig(
+        number=1,
+        repeat=2,
+        min_repeat_ms=0,
+        enable_cpu_cache_flush=False,
+        adaptive=True,
+        max_repeat=6,
+    )
+    runner = LocalRunner(timeout_sec=100, evaluator_config=evaluator_config)
+    # The first run has nothing to compare with, and the ones after it repeat until they are
+    # provably faster or slower than the fastest one so far, if ever
+    (first_future,) = runner.run([runner_input])
+    assert len(first_future.result().run_secs) == 2
+    for runner_future in runner.run([runner_input, runner_input]):
+        runner_result = runner_future.result()
+        assert runner_result.error_msg is None
+        assert 2 <= len(runner_result.run_secs) <= 6
+    _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_rpc_multiple_runs():
     """Test meta schedule rpc runner for multiple runs"""
     # Build the module
@@ -295,6 +343,79 @@ def test_meta_schedule_rpc_multiple_runs():
         _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_rpc_batched_runs():
+    """Test meta schedule rpc runner for the runs batched in sessions"""
+    # Build the module
+    mods = [
+        MatmulModule,
+        MatmulReluModule,
+        BatchMatmulModule,
+    ]
+    builder = LocalBuilder()
+    builder_inputs = [BuilderInput(mod, Target("llvm")) for mod in mods]
+    builder_results = builder.build(builder_inputs)
+    for builder_result in builder_results:
+        assert builder_result.artifact_path is not None
+        assert builder_result.error_msg is None
+
+    args_infos = [
+        [
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        ],
+        [
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        ],
+        [
+            TensorInfo("float32", [16, MATMUL_M, MATMUL_M]),
+            TensorInfo("float32", [16, MATMUL_M, MATMUL_M]),
+            TensorInfo("float32", [16, MATMUL_M, MATMUL_M]),
+        ],
+    ]
+
+    runner_inputs = [
+        RunnerInput(builder_results[i].artifact_path, "llvm", args_infos[i])
+        for i in range(len(mods))
+    ]
+    # A candidate failing to load does not fail the others in its batch
+    runner_inputs.insert(1, RunnerInput("/non/existent/artifact.tar", "llvm", args_infos[0]))
+
+    with LocalRPC() as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+        )
+        evaluator_config = EvaluatorConfig(
+            number=1,
+            repeat=1,
+            min_repeat_ms=0,
+            enable_cpu_cache_flush=False,
+        )
+        runner = RPCRunner(rpc_config, evaluator_config, batch_size=2)
+        # Run the module
+        runner_futures = runner.run(runner_inputs)
+        runner_results = [runner_future.result() for runner_future in runner_futures]
+
+    assert runner_results[1].error_msg is not None
+    assert runner_results[1].run_secs is None
+    for runner_result in runner_results[:1] + runner_results[2:]:
+        assert runner_result.error_msg is None
+        for result in runner_result.run_secs:
+            if isinstance(result, FloatImm):
+                result = result.value
+            assert isinstance(result, float)
+            assert result >= 0.0
+
+    for builder_result in builder_results:
+        _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_local_multiple_runs():
     """Test meta schedule local runner for multiple runs"""
     # Build the module
@@ -757,9 +757,44 @@ def test_gpu_argmax_32():
     )
 
 
+def test_gpu_cross_block_reduction():
+    @T.prim_func
+    def row_sum(A: T.Buffer[(4, 32768), "float32"], B: T.Buffer[(4,), "float32"]) -> None:
+        for i0, i1 in T.grid(4, 32768):
+            with T.block("B"):
+                i, k = T.axis.remap("SR", [i0, i1])
+                with T.init():
+                    B[i] = T.float32(0)
+                B[i] = B[i] + A[i, k]
+
+    def thread_tags(sch):
+        tags = set()
+
+        def visit(node):
+            if isinstance(node, tvm.tir.For) and node.thread_binding is not None:
+                tags.add(node.thread_binding.thread_tag)
+
+        tvm.tir.stmt_functor.post_order_visit(sch.mod["main"].body, visit)
+        return tags
+
+    actual = generate_design_space(
+        kind="cuda",
+        mod=row_sum,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=ms.schedule_rule.CrossThreadReduction,
+    )
+    assert len(actual) == 3
+    assert sorted(map(sorted, map(thread_tags, actual))) == [
+        [],
+        ["blockIdx.x", "blockIdx.y", "threadIdx.x"],
+        ["threadIdx.x"],
+    ]
+
+
 if __name__ == "__main__":
     test_gpu_softmax_mn()
     test_gpu_softmax_mn_after_inline()
     test_gpu_batch_norm_bmn()
     test_gpu_argmax()
     test_gpu_argmax_32()
+    test_gpu_cross_block_reduction()
@@ -0,0 +1,77 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.testing import te_workload
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.script import tir as T
+from tvm.target import Target
+from tvm.te import create_prim_func
+
+
+@T.prim_func
+def gemv(
+    A: T.Buffer[(1, 4096), "float16"],
+    B: T.Buffer[(4096, 4096), "float16"],
+    C: T.Buffer[(1, 4096), "float16"],
+) -> None:
+    T.func_attr({"global_symbol": "main", "tir.noalias": True})
+    for i, j, k in T.grid(1, 4096, 4096):
+        with T.block("C"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C[vi, vj] = T.float16(0)
+            C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vj, vk]
+
+
+def _design_space(mod):
+    return generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[ms.schedule_rule.GEMV()],
+    )
+
+
+def test_cuda_gemv():
+    sketches = _design_space(gemv)
+    assert len(sketches) == 2
+    scheduled = [sch for sch in sketches if "threadIdx.x" in sch.mod.script()]
+    assert len(scheduled) == 1
+    sch = scheduled[0]
+    script = sch.mod.script()
+    assert "threadIdx.y" in script and "blockIdx.x" in script
+    # Both the matrix and the vector are loaded in vectors into the registers.
+    assert script.count('scope="local"') >= 2
+    assert script.count("T.vectorized(") == 2
+    assert sch.get(sch.get_block("C")).annotations["schedule_rule"] == "None"
+    num_samples = len([inst for inst in sch.trace.insts if inst.kind.name == "SampleCategorical"])
+    assert num_samples == 3
+
+
+def test_cuda_gemm_not_gemv():
+    mod = create_prim_func(te_workload.matmul(n=512, m=512, k=512))
+    sketches = _design_space(mod)
+    assert len(sketches) == 1
+    assert "threadIdx.x" not in sketches[0].mod.script()
+
+
+if __name__ == "__main__":
+    test_cuda_gemv()
+    test_cuda_gemm_not_gemv()
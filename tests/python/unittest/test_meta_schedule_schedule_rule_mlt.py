@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 # pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
 from tvm import meta_schedule as ms
 from tvm import target, te
 from tvm.meta_schedule.testing import te_workload
@@ -268,6 +269,30 @@ def test_cpu_matmul_relu():
     )
 
 
+def test_cpu_matmul_cache_fitting_tiles():
+    mod = te.create_prim_func(te_workload.matmul(512, 512, 512))
+    actual = generate_design_space(
+        kind="llvm",
+        mod=mod,
+        target=Target(
+            "llvm -num-cores=1 -l1-cache-size=32768 -l2-cache-size=1048576 "
+            "-l3-cache-size=33554432 -cache-line-size=64"
+        ),
+        types=ms.schedule_rule.MultiLevelTiling,
+    )
+    # The innermost tile of j spans a cache line, the tiles of (i, j, k) inside the first and the
+    # second outer spatial levels, (32, 32, 32) and (128, 64, 512), fit half of the L1 and the L2
+    expected = [[4, 4, 32, 1], [8, 2, 2, 16], [16, 32]]
+    assert len(actual) == 3
+    for sch in actual:
+        decisions = [
+            [int(v) for v in sch.trace.decisions[inst]]
+            for inst in sch.trace.insts
+            if inst.kind.name == "SamplePerfectTile"
+        ]
+        assert decisions == expected
+
+
 def test_cuda_matmul():
     @T.prim_func
     def cuda_matmul_0(
@@ -623,6 +648,117 @@ def test_multi_level_tiling_hexagon():
     )
 
 
+def test_multi_level_tiling_hexagon_vtcm_pipeline():
+    target_hexagon = target.hexagon("v69", num_cores=4)
+    mod = te.create_prim_func(
+        te_workload.matmul(128, 128, 128, in_dtype="float16", out_dtype="float16")
+    )
+    actual = generate_design_space(
+        kind="hexagon",
+        mod=mod,
+        target=Target(target_hexagon, host=target_hexagon),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.MultiLevelTilingWideVector(
+                structure="SRSRS",
+                vector_length_in_bits=1024,
+                max_innermost_factor=64,
+                reuse_read=ms.schedule_rule.ReuseType(req="may", levels=[2], scope="global.vtcm"),
+                reuse_write=None,
+                use_software_pipeline=True,
+            )
+        ],
+    )
+    # The sketch reading the inputs in place, and the one staging them into VTCM.
+    assert len(actual) == 2
+    num_staged = 0
+    for sch in actual:
+        vtcm_buffers = []
+        pipelined = []
+
+        def _visit(node):
+            if isinstance(node, tvm.tir.Block):
+                vtcm_buffers.extend(b for b in node.alloc_buffers if b.scope() == "global.vtcm")
+            elif isinstance(node, tvm.tir.For) and "software_pipeline_stage" in node.annotations:
+                pipelined.append(node)
+
+        tvm.tir.stmt_functor.post_order_visit(sch.mod["main"].body, _visit)
+        if not vtcm_buffers:
+            assert not pipelined
+            continue
+        num_staged += 1
+        assert len(vtcm_buffers) == 2
+        # The loop of the copies is pipelined unless it has a single iteration.
+        for loop in pipelined:
+            assert [int(s) for s in loop.annotations["software_pipeline_stage"]] == [0, 0, 1]
+            assert [int(s) for s in loop.annotations["software_pipeline_async_stages"]] == [0]
+    assert num_staged == 1
+
+
+def test_cuda_matmul_split_k():
+    # A decoding GEMM, whose reduction is much longer than its outputs.
+    mod = te.create_prim_func(te_workload.matmul(n=1, m=256, k=4096))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3080"),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.MultiLevelTilingSplitK(
+                split_factors=[2, 4, 8, 16, 3],
+                max_spatial_extent=16384,
+                min_reduction_extent=1024,
+                structure="SSSRRSRS",
+                tile_binds=["blockIdx.x", "vthread.x", "threadIdx.x"],
+                max_innermost_factor=64,
+                vector_load_lens=[1, 2, 3, 4, 8, 16],
+                reuse_read=ms.schedule_rule.ReuseType(req="must", levels=[4], scope="shared"),
+                reuse_write=ms.schedule_rule.ReuseType(req="must", levels=[3], scope="local"),
+            )
+        ],
+    )
+    # The sketch tiling the partial sums of the partitions, and the one without split-K.
+    assert len(actual) == 2
+
+    def _block_names(sch):
+        names = []
+
+        def _visit(node):
+            if isinstance(node, tvm.tir.Block):
+                names.append(node.name_hint)
+
+        tvm.tir.stmt_functor.post_order_visit(sch.mod["main"].body, _visit)
+        return names
+
+    split_k, plain = actual
+    assert "C_rf" in _block_names(split_k)
+    assert "C_rf" not in _block_names(plain)
+    # The number of partitions is sampled from the factors dividing the reduction.
+    (sample,) = [inst for inst in split_k.trace.insts if inst.kind.name == "SampleCategorical"]
+    assert [int(c) for c in sample.attrs[0]] == [2, 4, 8, 16]
+    assert not [inst for inst in plain.trace.insts if inst.kind.name == "SampleCategorical"]
+
+    # No split-K for a GEMM with enough outputs.
+    mod = te.create_prim_func(te_workload.matmul(n=512, m=512, k=4096))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3080"),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.MultiLevelTilingSplitK(
+                split_factors=[2, 4, 8, 16],
+                max_spatial_extent=16384,
+                min_reduction_extent=1024,
+                structure="SSSRRSRS",
+                tile_binds=["blockIdx.x", "vthread.x", "threadIdx.x"],
+            )
+        ],
+    )
+    assert len(actual) == 1
+    assert "C_rf" not in _block_names(actual[0])
+
+
 def test_cache_read_specify_consumer():
     A, B, C = te_workload.matmul(512, 512, 512)
     mod = te.create_prim_func([A, B, C + A])
@@ -649,7 +785,9 @@ def test_cache_read_specify_consumer():
 if __name__ == "__main__":
     test_cpu_matmul()
     test_cpu_matmul_relu()
+    test_cpu_matmul_cache_fitting_tiles()
     test_cuda_matmul()
     test_cuda_matmul_relu()
     test_cuda_sum_with_trivial_block_iter()
     test_multi_level_tiling_hexagon()
+    test_cuda_matmul_split_k()
@@ -18,6 +18,7 @@
 # pylint: disable=missing-function-docstring
 from typing import List
 
+import numpy as np
 import pytest
 import tvm
 import tvm.testing
@@ -47,6 +48,22 @@ class Matmul:
                     C[vi, vj] = 0.0 # type: ignore
                 C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
 
+
+@tvm.script.ir_module
+class Matmul64:
+    @T.prim_func
+    def main(a: T.handle, b: T.handle, c: T.handle) -> None: # type: ignore
+        T.func_attr({"global_symbol": "main"})
+        A = T.match_buffer(a, (64, 64), "float32")
+        B = T.match_buffer(b, (64, 64), "float32")
+        C = T.match_buffer(c, (64, 64), "float32")
+        for i, j, k in T.grid(64, 64, 64):
+            with T.block("matmul"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = 0.0 # type: ignore
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
 # fmt: on
 # pylint: enable=missing-class-docstring,invalid-name,no-member,line-too-long,too-many-nested-blocks,no-self-argument
 
@@ -306,9 +323,76 @@ def test_meta_schedule_evolutionary_search_fail_init_population():  # pylint: di
     assert candidates is None
 
 
+def test_meta_schedule_evolutionary_search_warm_start():  # pylint: disable = invalid-name
+    @derived_object
+    class CountingModel(ms.cost_model.PyCostModel):
+        num_updated = 0
+        updated_mods = []
+
+        def load(self, path: str) -> None:
+            pass
+
+        def save(self, path: str) -> None:
+            pass
+
+        def update(self, context, candidates, results) -> None:
+            self.num_updated += len(candidates)
+            self.updated_mods.append(context.mod)
+
+        def predict(self, context, candidates):
+            return np.random.rand(len(candidates))
+
+    target = tvm.target.Target("llvm")
+    database = ms.database.MemoryDatabase()
+    workload = database.commit_workload(Matmul64)
+    for i in range(8):
+        sch = Schedule(Matmul64, seed=i)
+        _schedule_matmul(sch)
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                sch.trace,
+                workload,
+                run_secs=[float(i + 1)],
+                target=target,
+                args_info=ms.arg_info.ArgInfo.from_prim_func(Matmul64["main"]),
+            )
+        )
+    context = ms.TuneContext(
+        mod=Matmul,
+        space_generator=ms.space_generator.ScheduleFn(
+            sch_fn=_schedule_matmul,
+            sch_rules=[],
+            postprocs=[],
+            mutator_probs={},
+        ),
+        search_strategy=ms.search_strategy.EvolutionarySearch(
+            population_size=5,
+            init_measured_ratio=0.6,
+            num_warm_start_workloads=1,
+        ),
+        target=target,
+        num_threads=1,
+    )
+    cost_model = CountingModel()
+    context.search_strategy.pre_tuning(
+        max_trials=10,
+        num_trials_per_iter=5,
+        design_spaces=context.space_generator.generate_design_space(context.mod),
+        database=database,
+        cost_model=cost_model,
+    )
+    # The cost model is pretrained on the best records of the 64x64 matmul, up to the population
+    assert cost_model.num_updated == 5
+    # They are given with the context of their own workload, so that they are normalized apart
+    assert len(cost_model.updated_mods) == 1
+    tvm.ir.assert_structural_equal(cost_model.updated_mods[0], Matmul64)
+    context.search_strategy.post_tuning()
+
+
 if __name__ == "__main__":
     test_meta_schedule_replay_func(ms.search_strategy.ReplayFunc)
     test_meta_schedule_replay_func(ms.search_strategy.ReplayTrace)
     test_meta_schedule_evolutionary_search()
     test_meta_schedule_evolutionary_search_early_stop()
     test_meta_schedule_evolutionary_search_fail_init_population()
+    test_meta_schedule_evolutionary_search_warm_start()
@@ -106,5 +106,25 @@ def test_meta_schedule_design_space_generator_NIE():
         generator._initialize_with_tune_context(TuneContext())
 
 
+def test_meta_schedule_space_generator_wide_vector_rules():
+    from tvm.meta_schedule.schedule_rule import (  # pylint: disable=import-outside-toplevel
+        MultiLevelTiling,
+        MultiLevelTilingWideVector,
+    )
+
+    def rule_types(target):
+        context = TuneContext(
+            mod=Matmul,
+            target=target,
+            space_generator=ScheduleFn(sch_fn=schedule_matmul),
+        )
+        return [type(rule) for rule in context.space_generator.sch_rules]
+
+    assert MultiLevelTiling in rule_types("llvm")
+    assert MultiLevelTilingWideVector in rule_types(
+        "llvm -mtriple=aarch64-linux-gnu -mattr=+sve -vector-width=512"
+    )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
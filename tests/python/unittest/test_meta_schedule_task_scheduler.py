@@ -231,6 +231,55 @@ def test_meta_schedule_task_scheduler_multiple():
         )
 
 
+@pytest.mark.parametrize("scheduler_type", ["round-robin", "gradient"])
+def test_meta_schedule_task_scheduler_pipelined(scheduler_type):
+    num_trials_per_iter = 6
+    max_trials_per_task = 32
+    tasks = [
+        ms.TuneContext(
+            MatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="Matmul",
+            rand_state=42,
+        ),
+        ms.TuneContext(
+            BatchMatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_batch_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="BatchMatmul",
+            rand_state=0x114514,
+        ),
+    ]
+    database = ms.database.MemoryDatabase()
+    scheduler = ms.task_scheduler.TaskScheduler.create(scheduler_type)
+    scheduler.tune(
+        tasks,
+        [1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=num_trials_per_iter,
+        cost_model=None,
+        pipeline_depth=3,
+    )
+    # The batches generated ahead of the measurement stay within the budget of each task
+    assert len(database) == max_trials_per_task * len(tasks)
+    for task in tasks:
+        assert (
+            len(database.get_top_k(database.commit_workload(task.mod), 100000))
+            == max_trials_per_task
+        )
+    for task in scheduler.tasks_:
+        assert task.is_terminated
+        assert task.runner_futures is None
+
+
 def test_meta_schedule_task_scheduler_NIE():  # pylint: disable=invalid-name
     @ms.derived_object
     class NIETaskScheduler(ms.task_scheduler.PyTaskScheduler):
@@ -439,6 +488,8 @@ def test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy()
 if __name__ == "__main__":
     test_meta_schedule_task_scheduler_single()
     test_meta_schedule_task_scheduler_multiple()
+    test_meta_schedule_task_scheduler_pipelined("round-robin")
+    test_meta_schedule_task_scheduler_pipelined("gradient")
     test_meta_schedule_task_scheduler_NIE()
     test_meta_schedule_task_scheduler_avoid_cyclic()
     test_meta_schedule_task_scheduler_override_next_task_id_only()
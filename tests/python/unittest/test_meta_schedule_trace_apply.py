@@ -3531,5 +3531,69 @@ def test_dense_add_gpu_different_name():
     verify(Dense, apply_anchor_trace, DenseAdd_different_name, "cuda", DenseAdd_scheduled_gpu)
 
 
+def test_adapted_tiles():
+    def matmul(n):
+        @T.prim_func
+        def main(
+            A: T.Buffer[(n, n), "float32"],
+            B: T.Buffer[(n, n), "float32"],
+            C: T.Buffer[(n, n), "float32"],
+        ) -> None:
+            T.func_attr({"global_symbol": "main", "tir.noalias": True})
+            for i, j, k in T.grid(n, n, n):
+                with T.block("C"):
+                    vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+        return tvm.IRModule({"main": main})
+
+    record_sch = Schedule(matmul(64))
+    i, j, _ = record_sch.get_loops(record_sch.get_block("C"))
+    record_sch.split(i, record_sch.sample_perfect_tile(i, n=3, decision=[2, 4, 8]))
+    record_sch.split(j, record_sch.sample_perfect_tile(j, n=2, decision=[16, 4]))
+
+    sch = Schedule(matmul(24))
+    ms.trace_apply.apply_trace_with_adapted_tiles(sch, record_sch.trace)
+    # The inner factors are kept as far as they divide the new extent
+    extents = [loop.extent.value for loop in map(sch.get, sch.get_loops(sch.get_block("C")))]
+    assert extents == [1, 3, 8, 6, 4, 24]
+
+
+def test_replay_traces_resumed():
+    @T.prim_func
+    def matmul(
+        A: T.Buffer[(64, 64), "float32"],
+        B: T.Buffer[(64, 64), "float32"],
+        C: T.Buffer[(64, 64), "float32"],
+    ) -> None:
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i, j, k in T.grid(64, 64, 64):
+            with T.block("C"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+    mod = tvm.IRModule({"main": matmul})
+    record_sch = Schedule(mod)
+    i, j, _ = record_sch.get_loops(record_sch.get_block("C"))
+    record_sch.split(i, record_sch.sample_perfect_tile(i, n=3, decision=[2, 4, 8]))
+    record_sch.split(j, record_sch.sample_perfect_tile(j, n=2, decision=[16, 4]))
+    trace = record_sch.trace
+    # The mutant keeps the tiles of i, and samples those of j anew after the checkpoint before them
+    sample_j = [inst for inst in trace.insts if inst.kind.name == "SamplePerfectTile"][-1]
+    mutant = tvm.tir.Trace(
+        trace.insts, {inst: d for inst, d in trace.decisions.items() if not inst.same_as(sample_j)}
+    )
+    for seed in [1, 42]:
+        _, resumed = ms.trace_apply.replay_traces(mod, [trace, mutant], seed)
+        expected = Schedule(mod, seed=seed)
+        mutant.apply_to_schedule(expected, remove_postproc=True)
+        tvm.ir.assert_structural_equal(resumed.mod, expected.mod)
+        assert str(resumed.trace) == str(expected.trace)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,76 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import json
+
+import pytest
+
+import tvm.testing
+from tvm.micro import generate_graph_executor_plan
+
+
+def _graph(func_name="tvmgen_default_fused_add"):
+    return {
+        "nodes": [
+            {"op": "null", "name": "x", "inputs": []},
+            {"op": "null", "name": "p0", "inputs": []},
+            {
+                "op": "tvm_op",
+                "name": func_name,
+                "attrs": {
+                    "num_outputs": "1",
+                    "num_inputs": "2",
+                    "flatten_data": "0",
+                    "func_name": func_name,
+                },
+                "inputs": [[0, 0, 0], [1, 0, 0]],
+            },
+        ],
+        "arg_nodes": [0, 1],
+        "heads": [[2, 0, 0]],
+        "attrs": {
+            "dltype": ["list_str", ["float32", "float32", "float32"]],
+            "storage_id": ["list_int", [0, 1, 0]],
+            "shape": ["list_shape", [[10, 5], [1, 5], [10, 5]]],
+        },
+        "node_row_ptr": [0, 1, 2, 3],
+    }
+
+
+def test_generate_graph_executor_plan():
+    source = generate_graph_executor_plan(json.dumps(_graph()), name="add")
+    assert "#include <tvm/runtime/crt/graph_executor.h>" in source
+    assert '{"tvmgen_default_fused_add", 0, 3, 0},' in source
+    assert "static const uint32_t add_args[] = {\n    0,\n    1,\n    2,\n};" in source
+    # The entries share the storage of x, sized by its largest entry.
+    assert "    {0, 4, 2, {2, 32, 1}},\n};" in source
+    assert "static const uint32_t add_storage_sizes[] = {\n    200,\n    20,\n};" in source
+    assert 'static const char* const add_input_names[] = {\n    "x",\n    "p0",\n};' in source
+    assert source.endswith(
+        "const TVMGraphExecutorPlan add_plan = {\n"
+        "    add_ops,\n    1,\n    add_args,\n    3,\n    add_entries,\n    3,\n"
+        "    add_shapes,\n    add_storage_sizes,\n    2,\n    add_input_names,\n"
+        "    add_input_entries,\n    2,\n    add_output_entries,\n    1,\n};\n"
+    )
+
+
+def test_generate_graph_executor_plan_unsupported():
+    with pytest.raises(ValueError, match="__copy"):
+        generate_graph_executor_plan(json.dumps(_graph("__copy")))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -19,6 +19,7 @@ import tvm.testing
 import sys
 import pytest
 from tvm import te
+from tvm.contrib import utils
 import numpy as np
 
 
@@ -195,5 +196,32 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+def test_save_load_binary():
+    dtype = "float32"
+    buf = tvm.tir.decl_buffer((16,), dtype)
+    np_data = np.random.rand(16).astype(dtype)
+    alloc_const = tvm.tir.AllocateConst(
+        buf.data, dtype, (16,), tvm.nd.array(np_data), tvm.tir.Evaluate(0)
+    )
+    node = {
+        "stmt": alloc_const,
+        "stmt_again": alloc_const,
+        "small": tvm.nd.array(np.arange(3).astype("int8")),
+        "name": "binary",
+    }
+    file_name = utils.tempdir().relpath("node.bin")
+    tvm.ir.save_binary(node, file_name)
+    loaded = tvm.ir.load_binary(file_name)
+    tvm.ir.assert_structural_equal(node, loaded)
+    assert loaded["stmt"].same_as(loaded["stmt_again"])
+    np.testing.assert_array_equal(np_data, loaded["stmt"].data.numpy())
+    np.testing.assert_array_equal(np.arange(3), loaded["small"].numpy())
+
+    with open(file_name, "wb") as f:
+        f.write(tvm.ir.save_json(node).encode())
+    with pytest.raises(ValueError):
+        tvm.ir.load_binary(file_name)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
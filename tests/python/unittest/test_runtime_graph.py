@@ -19,6 +19,8 @@ import tvm.testing
 from tvm import te, runtime
 import numpy as np
 import json
+import threading
+import pytest
 from tvm import rpc
 from tvm import relay
 from tvm.contrib import utils, graph_executor
@@ -118,6 +120,73 @@ def test_graph_simple():
     check_sharing()
 
 
+@tvm.testing.requires_llvm
+def test_graph_parallel():
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    s[B].parallel(B.op.axis[0])
+    C = te.placeholder((n,), name="C")
+    D = te.compute(A.shape, lambda *i: A(*i) * C(*i), name="D")
+    s_mul = te.create_schedule(D.op)
+    mlib = tvm.build(s, [A, B], "llvm", name="myadd")
+    mlib.import_module(tvm.build(s_mul, [A, C, D], "llvm", name="mymul"))
+
+    def add(name, src):
+        return {
+            "op": "tvm_op",
+            "name": name,
+            "inputs": [[src, 0, 0]],
+            "attrs": {
+                "func_name": "myadd",
+                "flatten_data": "1",
+                "num_inputs": "1",
+                "num_outputs": "1",
+            },
+        }
+
+    # x -> a -> b, and c reusing the storage of a once b is done with it
+    nodes = [
+        {"op": "null", "name": "x", "inputs": []},
+        add("a", 0),
+        add("b", 1),
+        add("c", 0),
+        {
+            "op": "tvm_op",
+            "name": "d",
+            "inputs": [[2, 0, 0], [3, 0, 0]],
+            "attrs": {
+                "func_name": "mymul",
+                "flatten_data": "1",
+                "num_inputs": "2",
+                "num_outputs": "1",
+            },
+        },
+    ]
+    shape = (n,)
+    graph = json.dumps(
+        {
+            "nodes": nodes,
+            "arg_nodes": [0],
+            "node_row_ptr": [0, 1, 2, 3, 4, 5],
+            "heads": [[4, 0, 0]],
+            "attrs": {
+                "shape": ["list_shape", [shape] * 5],
+                "dltype": ["list_str", ["float32"] * 5],
+                "storage_id": ["list_int", [0, 1, 2, 1, 3]],
+            },
+        }
+    )
+    mod = graph_executor.create(graph, mlib, tvm.cpu(0))
+    mod.set_parallel()
+    for _ in range(10):
+        a = np.random.uniform(size=shape).astype("float32")
+        mod.run(x=a)
+        out = mod.get_output(0, tvm.nd.empty(shape))
+        tvm.testing.assert_allclose(out.numpy(), (a + 2) * (a + 1), rtol=1e-6)
+
+
 def test_load_unexpected_params():
     # Test whether graph_executor.load_params works if parameters
     # are provided that are not an expected input.
@@ -138,6 +207,69 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+def test_load_params_from_file():
+    x = relay.var("x", shape=(1, 10))
+    w = relay.var("w", shape=(1, 10))
+    func = relay.Function([x, w], relay.add(x, w))
+    w_np = np.random.uniform(size=(1, 10)).astype("float32")
+    graph, lib, params = relay.build(func, target="llvm", params={"w": w_np})
+    params["w_unknown"] = tvm.nd.array(np.ones((3,)).astype("float32"))
+
+    temp = utils.tempdir()
+    path = temp.relpath("params.bin")
+    with open(path, "wb") as fo:
+        fo.write(runtime.save_param_dict(params))
+    for use_mmap in [False, True]:
+        mod = graph_executor.create(graph, lib, tvm.cpu(0))
+        mod.load_params_from_file(path, use_mmap=use_mmap)
+        x_np = np.random.uniform(size=(1, 10)).astype("float32")
+        mod.run(x=x_np)
+        out = mod.get_output(0, tvm.nd.empty((1, 10)))
+        tvm.testing.assert_allclose(out.numpy(), x_np + w_np, rtol=1e-6)
+
+
+def test_graph_executor_pool():
+    x = relay.var("x", shape=(1, 10))
+    w = relay.var("w", shape=(1, 10))
+    func = relay.Function([x, w], relay.add(x, w))
+    w_np = np.random.uniform(size=(1, 10)).astype("float32")
+    graph, lib, params = relay.build(func, target="llvm", params={"w": w_np})
+
+    pool = graph_executor.GraphExecutorPool(
+        graph, lib, tvm.cpu(0), 3, runtime.save_param_dict(params)
+    )
+    assert pool.num_instances == 3
+    errors = []
+
+    def serve():
+        try:
+            for _ in range(10):
+                x_np = np.random.uniform(size=(1, 10)).astype("float32")
+                with pool.lease() as mod:
+                    mod.run(x=x_np)
+                    out = mod.get_output(0).numpy()
+                tvm.testing.assert_allclose(out, x_np + w_np, rtol=1e-6)
+        except Exception as err:  # pylint: disable=broad-except
+            errors.append(err)
+
+    threads = [threading.Thread(target=serve) for _ in range(6)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors, errors
+    assert pool.num_available == 3
+
+    leased = [pool.acquire() for _ in range(3)]
+    assert pool.acquire(timeout_ms=10) is None
+    for mod in leased:
+        pool.release(mod)
+    with pytest.raises(tvm.TVMError):
+        pool.release(leased[0])
+
+
 if __name__ == "__main__":
     test_graph_simple()
     test_load_unexpected_params()
+    test_load_params_from_file()
+    test_graph_executor_pool()
@@ -17,6 +17,7 @@
 import tvm
 from tvm import te
 import tvm.testing
+import hashlib
 import multiprocessing
 import os
 import stat
@@ -430,6 +431,72 @@ def test_rpc_return_ndarray():
     run_arr_test()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_async():
+    server = rpc.Server(key="x1")
+    client = rpc.connect("127.0.0.1", server.port, key="x1")
+    client.enable_async(max_inflight=4)
+
+    addone = client.get_function("rpc.test.addone")
+    futures = [client.async_call(addone, i) for i in range(16)]
+    assert [future.result() for future in futures] == list(range(1, 17))
+    # The synchronous calls wait for their replies behind the pending requests.
+    assert addone(10) == 11
+
+    future = client.async_call(client.get_function("rpc.test.except"), "abc")
+    with pytest.raises(tvm._ffi.base.TVMError):
+        future.result()
+    f2 = client.get_function("rpc.test.strcat")
+    assert client.async_call(f2, "abc", 11).result() == "abc:11"
+
+    dev = client.cpu(0)
+    datas = [np.random.uniform(size=(1024, 64)).astype("float32") for _ in range(4)]
+    remote_arrays = [tvm.nd.empty(data.shape, data.dtype, dev) for data in datas]
+    uploads = [client.async_copy_to_remote(x, y) for x, y in zip(datas, remote_arrays)]
+    downloads = [client.async_copy_from_remote(y) for y in remote_arrays]
+    for upload, download, data in zip(uploads, downloads, datas):
+        upload.result()
+        np.testing.assert_equal(download.result().numpy(), data)
+    assert all(future.done() for future in uploads + downloads)
+    np.testing.assert_equal(remote_arrays[0].numpy(), datas[0])
+
+
+@tvm.testing.requires_rpc
+def test_rpc_upload_cache(monkeypatch):
+    temp = utils.tempdir()
+    # The servers inherit the cache directory from the environment.
+    monkeypatch.setenv("TVM_RPC_CACHE_DIR", temp.relpath("rpc_cache"))
+    blob = bytearray(np.random.randint(0, 10, size=(1024)))
+    digest = hashlib.sha256(blob).hexdigest()
+    for _ in range(2):
+        server = rpc.Server(key="x1")
+        client = rpc.connect("127.0.0.1", server.port, key="x1")
+        hit = client.get_function("tvm.rpc.server.upload_from_cache")("probe.bin", digest)
+        client.upload(blob, "dat.bin", use_cache=True)
+        assert client.download("dat.bin") == blob
+        server.terminate()
+    # The second server finds the content cached by the first one.
+    assert hit
+    assert os.listdir(temp.relpath("rpc_cache")) == [digest]
+
+
+@tvm.testing.requires_rpc
+def test_rpc_transfer_chunks():
+    server = rpc.Server(key="x1")
+    client = rpc.connect("127.0.0.1", server.port, key="x1")
+    dev = client.cpu(0)
+    data = np.random.uniform(size=(1000, 77)).astype("float32")
+    for chunk_size in [0, 4096, 1000]:
+        client.set_transfer_chunk_size(chunk_size)
+        remote_array = tvm.nd.array(data, dev)
+        np.testing.assert_equal(remote_array.numpy(), data)
+    client.enable_async(max_inflight=2)
+    remote_array = tvm.nd.array(data, dev)
+    np.testing.assert_equal(remote_array.numpy(), data)
+    with pytest.raises(tvm._ffi.base.TVMError):
+        client.set_transfer_chunk_size(-1)
+
+
 @tvm.testing.requires_rpc
 def test_local_func():
     client = rpc.LocalSession()
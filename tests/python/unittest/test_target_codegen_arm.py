@@ -98,6 +98,26 @@ def test_vmlal_s16():
     check_broadcast_correct_assembly(64)
 
 
+def test_sve_vector_width():
+    target = "llvm -mtriple=aarch64-linux-gnu -mattr=+v8.2a,+sve -vector-width=512"
+    assert tvm.target.Target(target).features.has_sve
+
+    n = 64
+    A = te.placeholder((n,), dtype="float32", name="A")
+    B = te.compute(A.shape, lambda i: A[i] * tvm.tir.vscale().astype("float32"), name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=16)
+    s[B].vectorize(xi)
+    f = tvm.build(s, [A, B], target)
+
+    # The 16 float lanes fill up an SVE register of the pinned vscale.
+    llvm_ir = f.get_source("ll")
+    assert "vscale_range(4,4)" in llvm_ir
+    assert "llvm.vscale.i32" in llvm_ir
+    assert "<16 x float>" in llvm_ir
+
+
 if __name__ == "__main__":
     test_popcount()
     test_vmlal_s16()
+    test_sve_vector_width()
@@ -1044,5 +1044,45 @@ def test_try_unaligned_vector_load():
     assert np.allclose(c, expected), f"expected={expected}\nactual={c}"
 
 
+@tvm.testing.requires_cuda
+def test_cuda_lazy_ptx_kernels(monkeypatch):
+    """Check the kernels of a PTX module are loaded lazily, and in the background."""
+    from tvm.contrib import nvcc, utils
+
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    C = te.compute((n,), lambda i: B[i] * 2.0, name="C")
+    s = te.create_schedule(C.op)
+    for stage in [B, C]:
+        bx, tx = s[stage].split(stage.op.axis[0], factor=64)
+        s[stage].bind(bx, te.thread_axis("blockIdx.x"))
+        s[stage].bind(tx, te.thread_axis("threadIdx.x"))
+
+    tvm.register_func(
+        "tvm_callback_cuda_compile", lambda code: nvcc.compile_cuda(code, "ptx"), override=True
+    )
+    try:
+        f = tvm.build(s, [A, C], "cuda")
+    finally:
+        tvm.register_func(
+            "tvm_callback_cuda_compile", nvcc.tvm_callback_cuda_compile, override=True
+        )
+    assert f.imported_modules[0].get_source("ptx").count(".entry") == 2
+
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    f.export_library(path)
+    dev = tvm.cuda(0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    for num_threads in ["0", "2"]:
+        monkeypatch.setenv("TVM_CUDA_WARMUP_THREADS", num_threads)
+        loaded = tvm.runtime.load_module(path)
+        a = tvm.nd.array(a_np, dev)
+        c = tvm.nd.empty((n,), "float32", dev)
+        loaded(a, c)
+        tvm.testing.assert_allclose(c.numpy(), (a_np + 1.0) * 2.0, rtol=1e-5)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
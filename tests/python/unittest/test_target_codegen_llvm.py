@@ -204,6 +204,27 @@ def test_llvm_vadd_pipeline():
     check_llvm(512, 2)
 
 
+@tvm.testing.requires_llvm
+def test_llvm_predicated_tail():
+    n = 13
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] + tvm.tir.const(1, A.dtype), name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=4)
+    s[B].vectorize(xi)
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    llvm_ir = f.get_source()
+    assert "llvm.masked.load" in llvm_ir
+    assert "llvm.masked.store" in llvm_ir
+
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=(n,)).astype(A.dtype), dev)
+    b = tvm.nd.empty((n,), B.dtype, dev)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
 @tvm.testing.requires_llvm
 def test_llvm_madd_pipeline():
     def check_llvm(nn, base, stride):
@@ -859,6 +880,53 @@ def test_llvm_order_functions():
     assert matches == sorted(matches)
 
 
+@tvm.testing.requires_llvm
+def test_llvm_num_partitions():
+    """Check the functions generated in parallel partitions are linked into one module."""
+    n = 16
+    names = ["add_%d" % i for i in range(5)]
+    funcs = {}
+    for i, name in enumerate(names):
+        A = te.placeholder((n,), name="A")
+        B = te.compute((n,), lambda j: A[j] + i, name="B")
+        s = te.create_schedule(B.op)
+        funcs[name] = tvm.lower(s, [A, B], name=name)[name]
+    mod = tvm.IRModule(functions=funcs)
+    with tvm.transform.PassContext(config={"codegen.llvm.num_partitions": 3}):
+        lib = tvm.build(mod, target="llvm")
+    ir_text = lib.get_source("ll")
+    matches = re.findall(r"^define[^@]*@([a-zA-Z][a-zA-Z0-9_]*)", ir_text, re.MULTILINE)
+    assert matches == sorted(names)
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float32"), dev)
+    for i, name in enumerate(names):
+        b = tvm.nd.empty((n,), "float32", dev)
+        lib[name](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + i, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_build_cache():
+    """Check a module built again is taken from the build cache."""
+    n = 16
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+    s = te.create_schedule(B.op)
+    cache_dir = utils.tempdir()
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float32"), dev)
+    sources = []
+    for _ in range(2):
+        with tvm.transform.PassContext(config={"codegen.cache_dir": cache_dir.temp_dir}):
+            f = tvm.build(s, [A, B], target="llvm", name="double")
+        sources.append(f.get_source("ll"))
+        assert len(cache_dir.listdir()) == 1
+        b = tvm.nd.empty((n,), "float32", dev)
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() * 2.0, rtol=1e-5)
+    assert sources[0] == sources[1]
+
+
 @tvm.testing.requires_llvm
 @tvm.testing.skip_if_32bit
 def test_llvm_import():
@@ -76,6 +76,42 @@ def test_metal_erf():
     check_erf(dev, 1, "float16")
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_metal
+def test_metal_batched_kernels():
+    target = "metal"
+    n = 64
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    s[B].bind(s[B].op.axis[0], tx)
+    fun = tvm.build(s, [A, B], target)
+
+    dev = tvm.device(target, 0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.empty((n,), "float32", dev)
+    c = tvm.nd.empty((n,), "float32", dev)
+    # the dependent kernels are batched into one command buffer, committed by the copy
+    for _ in range(4):
+        fun(a, b)
+        fun(b, c)
+        fun(c, a)
+    tvm.testing.assert_allclose(a.numpy(), a_np + 12, rtol=1e-5)
+
+    try:
+        view = tvm.get_global_func("metal.HostView")(a)
+    except tvm.TVMError:
+        # the device does not have a unified memory
+        return
+    dev.sync()
+    tvm.testing.assert_allclose(view.numpy(), a_np + 12, rtol=1e-5)
+    view.copyfrom(a_np)
+    fun(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a_np + 1, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_metal_inf_nan()
     test_metal_erf()
+    test_metal_batched_kernels()
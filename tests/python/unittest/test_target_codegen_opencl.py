@@ -184,6 +184,40 @@ def test_opencl_type_casting():
     check_type_casting(dev, 16, "float32")
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_opencl
+def test_opencl_program_cache(monkeypatch):
+    """Check the program binaries are cached, and the programs are built in the background."""
+    from tvm.contrib import utils
+    import numpy as np
+
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    C = te.compute((n,), lambda i: B[i] * 2.0, name="C")
+    s = te.create_schedule(C.op)
+    for stage in [B, C]:
+        bx, tx = s[stage].split(stage.op.axis[0], factor=16)
+        s[stage].bind(bx, te.thread_axis("blockIdx.x"))
+        s[stage].bind(tx, te.thread_axis("threadIdx.x"))
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    tvm.build(s, [A, C], target).export_library(path)
+    cache_dir = utils.tempdir()
+    monkeypatch.setenv("TVM_OPENCL_PROGRAM_CACHE_DIR", cache_dir.temp_dir)
+
+    dev = tvm.device(target, 0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    for num_threads in ["0", "2"]:
+        monkeypatch.setenv("TVM_OPENCL_WARMUP_THREADS", num_threads)
+        lib = tvm.runtime.load_module(path)
+        a = tvm.nd.array(a_np, dev)
+        c = tvm.nd.empty((n,), "float32", dev)
+        lib(a, c)
+        tvm.testing.assert_allclose(c.numpy(), (a_np + 1.0) * 2.0, rtol=1e-5)
+        assert len([f for f in cache_dir.listdir() if f.endswith(".clbin")]) == 2
+
+
 if __name__ == "__main__":
     test_opencl_ternary_expression()
     test_opencl_inf_nan()
@@ -249,6 +249,28 @@ def test_topi():
     check_grad(R, [X, W], data_range=(-1, 1))
 
 
+def test_direct_adjoint():
+    X = te.placeholder((4, 6, 8), name="X")
+
+    def check_direct(R, inputs, args=[]):
+        check_grad(R, inputs, args)
+        # The gradients only sum over the axes the inputs are broadcast along
+        grads = te.gradient(R, inputs, head=topi.full_like(R, 1.0))
+        for grad in grads:
+            assert len(grad.op.reduce_axis) < len(R.shape)
+
+    check_direct(topi.transpose(X, (2, 0, 1)), [X])
+    check_grad(topi.strided_slice(X, [1, 0, 7], [3, 6, 0], [1, 2, -3]), [X])
+    check_direct(topi.flip(X, axis=1), [X])
+    check_direct(topi.expand_dims(X, 1), [X])
+    check_direct(topi.nn.pad(X, [0, 1, 2], [1, 0, 2]), [X])
+
+    Y = te.placeholder((4, 1, 8), name="Y")
+    check_direct(topi.broadcast_to(Y, (4, 6, 8)), [Y])
+    W = te.placeholder((4, 6, 8), name="W")
+    check_direct(topi.exp(X) * W, [X, W])
+
+
 def test_stride_dilation():
     X = te.placeholder((1, 2, 10, 10), name="X")
     W = te.placeholder((2, 2, 1, 1), name="W")
@@ -348,4 +370,5 @@ def test_reduction_init():
 if __name__ == "__main__":
     test_basic_operation()
     test_topi()
+    test_direct_adjoint()
     test_stride_dilation()
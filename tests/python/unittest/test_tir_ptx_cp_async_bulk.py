@@ -0,0 +1,70 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm.script import tir as T
+import numpy as np
+import tvm.testing
+
+
+@T.prim_func
+def ptx_cp_async_bulk(A: T.Buffer[(32, 128), "float16"], B: T.Buffer[(32, 128), "float16"]) -> None:
+    T.func_attr({"global_symbol": "default_function", "tir.noalias": True})
+    bx = T.env_thread("blockIdx.x")
+    tx = T.env_thread("threadIdx.x")
+    T.launch_thread(bx, 1)
+    T.launch_thread(tx, 32)
+    with T.block():
+        A_shared = T.alloc_buffer([32, 128], "float16", scope="shared")
+        barrier = T.alloc_buffer([1], "uint64", scope="shared")
+        T.reads(A[0:32, 0:128])
+        T.writes(B[0:32, 0:128])
+
+        if tx == 0:
+            T.evaluate(T.ptx_init_barrier_thread_count(barrier.data, 0, 1, dtype=""))
+            T.evaluate(T.ptx_fence_barrier_init(dtype=""))
+        T.evaluate(T.tvm_storage_sync("shared", dtype="int32"))
+
+        if tx == 0:
+            T.evaluate(T.ptx_arrive_barrier_expect_tx(barrier.data, 0, 8192, dtype=""))
+            T.evaluate(
+                T.ptx_cp_async_bulk(
+                    A_shared.data, 0, A.data, 0, 8192, barrier.data, 0, dtype="float16"
+                )
+            )
+        T.evaluate(T.ptx_wait_barrier(barrier.data, 0, 0, dtype=""))
+
+        for i in range(128):
+            B[tx, i] = A_shared[tx, i]
+
+
+@tvm.testing.requires_cuda_compute_version(9)
+def test_ptx_cp_async_bulk():
+    f = ptx_cp_async_bulk
+
+    mod = tvm.build(f, target="cuda")
+    assert "cp.async.bulk.shared::cluster.global" in mod.imported_modules[0].get_source()
+    A_np = np.random.rand(32, 128).astype("float16")
+    B_np = np.zeros((32, 128)).astype("float16")
+    dev = tvm.cuda(0)
+    A_nd = tvm.nd.array(A_np, device=dev)
+    B_nd = tvm.nd.array(B_np, device=dev)
+    mod(A_nd, B_nd)
+    tvm.testing.assert_allclose(B_nd.numpy(), A_np)
+
+
+if __name__ == "__main__":
+    test_ptx_cp_async_bulk()
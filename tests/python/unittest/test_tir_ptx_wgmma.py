@@ -0,0 +1,102 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm.script import tir as T
+import numpy as np
+import tvm.testing
+
+
+@T.prim_func
+def wgmma_m64n8k16_f16f16f32(
+    A: T.Buffer[(64, 16), "float16"],
+    B: T.Buffer[(8, 16), "float16"],
+    C: T.Buffer[(64, 8), "float32"],
+) -> None:
+    T.func_attr({"global_symbol": "default_function", "tir.noalias": True})
+    bx = T.env_thread("blockIdx.x")
+    tx = T.env_thread("threadIdx.x")
+    T.launch_thread(bx, 1)
+    T.launch_thread(tx, 128)
+    with T.block():
+        # The multiplicands in the core matrices of 8 rows of 8 elements, K-major.
+        A_shared = T.alloc_buffer([8, 2, 8, 8], "float16", scope="shared")
+        B_shared = T.alloc_buffer([1, 2, 8, 8], "float16", scope="shared")
+        accum = T.alloc_buffer([4], "float32", scope="local")
+        T.reads(A[0:64, 0:16], B[0:8, 0:16])
+        T.writes(C[0:64, 0:8])
+
+        for j in range(8):
+            A_shared[tx // 16, tx % 2, tx // 2 % 8, j] = A[tx // 2, tx % 2 * 8 + j]
+        if tx < 16:
+            for j in range(8):
+                B_shared[0, tx % 2, tx // 2, j] = B[tx // 2, tx % 2 * 8 + j]
+        T.evaluate(T.ptx_fence_proxy_async(dtype=""))
+        T.evaluate(T.tvm_storage_sync("shared", dtype="int32"))
+
+        T.evaluate(T.ptx_wgmma_fence(dtype=""))
+        T.evaluate(
+            T.ptx_wgmma(
+                "m64n8k16",
+                "fp16",
+                "fp16",
+                "fp32",
+                A_shared.data,
+                0,
+                128,
+                256,
+                B_shared.data,
+                0,
+                128,
+                256,
+                accum.data,
+                0,
+                0,
+                False,
+                False,
+                dtype="float32",
+            )
+        )
+        T.evaluate(T.ptx_wgmma_commit_group(dtype=""))
+        T.evaluate(T.ptx_wgmma_wait_group(0, dtype=""))
+
+        # Warp w holds the rows 16w to 16w + 15, in the layout of mma m16n8.
+        for i in range(4):
+            C[tx // 32 * 16 + tx % 32 // 4 + i // 2 * 8, tx % 4 * 2 + i % 2] = accum[i]
+
+
+@tvm.testing.requires_cuda_compute_version(9)
+def test_wgmma_m64n8k16_f16f16f32():
+    f = wgmma_m64n8k16_f16f16f32
+
+    mod = tvm.build(f, target="cuda -arch=sm_90a")
+    assert "wgmma.mma_async.sync.aligned.m64n8k16.f32.f16.f16" in mod.imported_modules[
+        0
+    ].get_source()
+    A_np = np.random.uniform(-1, 1, [64, 16]).astype("float16")
+    B_np = np.random.uniform(-1, 1, [8, 16]).astype("float16")
+    C_np = np.zeros([64, 8]).astype("float32")
+    dev = tvm.cuda(0)
+    A_nd = tvm.nd.array(A_np, device=dev)
+    B_nd = tvm.nd.array(B_np, device=dev)
+    C_nd = tvm.nd.array(C_np, device=dev)
+    mod(A_nd, B_nd, C_nd)
+    golden = np.matmul(A_np.astype("float32"), B_np.astype("float32").T)
+    tvm.testing.assert_allclose(C_nd.numpy(), golden, rtol=1e-3, atol=1e-3)
+
+
+if __name__ == "__main__":
+    test_wgmma_m64n8k16_f16f16f32()
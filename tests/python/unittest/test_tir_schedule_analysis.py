@@ -31,6 +31,7 @@ from tvm.tir import Evaluate, For, ForKind, IndexMap, Var, decl_buffer, floordiv
 from tvm.tir.analysis import expr_deep_equal
 from tvm.tir.schedule.analysis import (
     get_auto_tensorize_mapping_info,
+    get_auto_tensorize_signature,
     suggest_index_map,
     get_tensorize_loop_mapping,
     TensorizeInfo,
@@ -395,5 +396,29 @@ def test_get_auto_tensorize_mapping_info_matmul(n, m, k, expected):
     check_index_map(matmul, "C", WMMA_SYNC_16x16x16_f16f16f32_INTRIN, expected)
 
 
+def test_auto_tensorize_signature():
+    def desc_block(intrin_name):
+        blocks = []
+
+        def fvisit(stmt):
+            if isinstance(stmt, tvm.tir.Block) and stmt.name_hint != "root":
+                blocks.append(stmt)
+
+        pre_order_visit(TensorIntrin.get(intrin_name).desc.body, fvisit)
+        return blocks[0]
+
+    s = Schedule(create_prim_func(te_workload.matmul(512, 512, 512, "float16", "float32")))
+    block = s.get_block("C")
+    signature = get_auto_tensorize_signature(s.get(block))
+    # The loops are not signed, so the smaller intrin applies to the larger workload.
+    matching = WMMA_SYNC_16x16x16_f16f16f32_INTRIN
+    assert get_auto_tensorize_signature(desc_block(matching)) == signature
+    assert get_auto_tensorize_mapping_info(s, block, TensorIntrin.get(matching).desc) is not None
+    # The intrin accumulating in float16 is skipped before the comparison.
+    mismatched = WMMA_SYNC_16x16x16_f16f16f16_INTRIN
+    assert get_auto_tensorize_signature(desc_block(mismatched)) != signature
+    assert get_auto_tensorize_mapping_info(s, block, TensorIntrin.get(mismatched).desc) is None
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -394,6 +394,52 @@ def test_seq_length_mismatch():
     assert rhs_path == expected_rhs_path
 
 
+def test_structural_memo():
+    x = te.var("x")
+    func_0 = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 1))
+    func_1 = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 1))
+    func_2 = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 2))
+    expected_hash = tvm.ir.structural_hash(func_0)
+    with tvm.ir.StructuralMemo() as memo:
+        for _ in range(2):
+            assert tvm.ir.structural_hash(func_0) == expected_hash
+            assert tvm.ir.structural_equal(func_0, func_1)
+            assert not tvm.ir.structural_equal(func_0, func_2)
+        assert memo.num_hits() == 3
+        # The memo holds no result of the assert mode, which reports the mismatch.
+        with pytest.raises(ValueError):
+            tvm.ir.assert_structural_equal(func_0, func_2)
+        assert memo.num_hits() == 3
+        with tvm.ir.StructuralMemo():
+            assert tvm.ir.structural_hash(func_0, map_free_vars=True) == tvm.ir.structural_hash(
+                func_1, map_free_vars=True
+            )
+    assert tvm.ir.structural_hash(func_0) == expected_hash
+
+
+def test_structural_memo_module_mutated_in_place():
+    x = te.var("x")
+    func_0 = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 1))
+    func_1 = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 2))
+    mod = tvm.IRModule({"main": func_0})
+    other = tvm.IRModule({"main": func_0})
+    with tvm.ir.StructuralMemo() as memo:
+        hash_0 = tvm.ir.structural_hash(mod)
+        assert tvm.ir.structural_equal(mod, other)
+        assert tvm.ir.structural_hash(mod) == hash_0
+        assert memo.num_hits() == 1
+        # The module is the same object after the update, but hashes and compares anew.
+        mod[mod.get_global_var("main")] = func_1
+        assert tvm.ir.structural_hash(mod) == tvm.ir.structural_hash(tvm.IRModule({"main": func_1}))
+        assert tvm.ir.structural_hash(mod) != hash_0
+        assert not tvm.ir.structural_equal(mod, other)
+        # The array holds the module, which it cannot tell was updated, so it is not memoized.
+        mods = [mod]
+        tvm.ir.structural_hash(mods)
+        tvm.ir.structural_hash(mods)
+    assert memo.num_hits() == 2
+
+
 if __name__ == "__main__":
     test_exprs()
     test_prim_func()
@@ -404,3 +450,5 @@ if __name__ == "__main__":
     test_buffer_storage_scope()
     test_buffer_load_store()
     test_while()
+    test_structural_memo()
+    test_structural_memo_module_mutated_in_place()
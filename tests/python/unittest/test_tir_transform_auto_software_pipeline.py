@@ -0,0 +1,173 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _staging_loop(annotations=None, target=None):
+    @T.prim_func
+    def func(A: T.Buffer[(16, 16), "float32"], C: T.Buffer[(16, 16), "float32"]):
+        for tx in T.thread_binding(0, 16, thread="threadIdx.x"):
+            for i in T.serial(0, 16, annotations=annotations):
+                with T.block("compute"):
+                    T.reads(A[tx, i])
+                    T.writes(C[tx, i])
+                    B = T.alloc_buffer((16, 1), dtype="float32", scope="shared")
+                    with T.block():
+                        T.reads(A[tx, i])
+                        T.writes(B[tx, 0])
+                        B[tx, 0] = A[tx, i] * T.float32(2)
+                    with T.block():
+                        T.reads(B[tx, 0])
+                        T.writes(C[tx, i])
+                        C[tx, i] = B[tx, 0] + T.float32(1)
+
+    if target is not None:
+        func = func.with_attr("target", tvm.target.Target(target))
+    return func
+
+
+def _pipelined_loop(func):
+    loops = []
+
+    def _visit(node):
+        if isinstance(node, tvm.tir.For) and node.kind == tvm.tir.ForKind.SERIAL:
+            loops.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, _visit)
+    return loops[-1]
+
+
+def test_double_buffering():
+    mod = tvm.IRModule.from_expr(_staging_loop())
+    mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    loop = _pipelined_loop(mod["main"])
+    assert [int(s) for s in loop.annotations["software_pipeline_stage"]] == [0, 1]
+    assert [int(s) for s in loop.annotations["software_pipeline_order"]] == [0, 1]
+    assert "software_pipeline_async_stages" not in loop.annotations
+
+    expected = tvm.IRModule.from_expr(
+        _staging_loop({"software_pipeline_stage": [0, 1], "software_pipeline_order": [0, 1]})
+    )
+    lower = tvm.transform.Sequential(
+        [tvm.tir.transform.InjectSoftwarePipeline(), tvm.tir.transform.Simplify()]
+    )
+    tvm.ir.assert_structural_equal(lower(mod)["main"], lower(expected)["main"])
+
+
+def test_async_copy():
+    mod = tvm.IRModule.from_expr(_staging_loop(target="cuda -arch=sm_80"))
+    with tvm.transform.PassContext(config={"tir.use_async_copy": True}):
+        mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    loop = _pipelined_loop(mod["main"])
+    assert [int(s) for s in loop.annotations["software_pipeline_stage"]] == [0, 2]
+    assert [int(s) for s in loop.annotations["software_pipeline_async_stages"]] == [0]
+
+
+def test_shared_memory_bound():
+    # The shared buffer takes 64 bytes, so that there is no room for a second version of it.
+    target = tvm.target.Target("cuda -arch=sm_70 -max_shared_memory_per_block=100")
+    mod = tvm.IRModule.from_expr(_staging_loop(target=target))
+    mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    assert "software_pipeline_stage" not in _pipelined_loop(mod["main"]).annotations
+
+
+def _vtcm_staging_loop(target):
+    @T.prim_func
+    def func(A: T.Buffer[(16, 128), "int8"], C: T.Buffer[(16, 128), "int8"]):
+        for i in T.serial(0, 16):
+            with T.block("compute"):
+                T.reads(A[i, 0:128])
+                T.writes(C[i, 0:128])
+                A_vtcm = T.alloc_buffer((128,), dtype="int8", scope="global.vtcm")
+                with T.block():
+                    T.reads(A[i, 0:128])
+                    T.writes(A_vtcm[0:128])
+                    for j in T.serial(0, 128):
+                        A_vtcm[j] = A[i, j]
+                with T.block():
+                    T.reads(A_vtcm[0:128])
+                    T.writes(C[i, 0:128])
+                    for j in T.serial(0, 128):
+                        C[i, j] = A_vtcm[j] + T.int8(1)
+
+    return func.with_attr("target", tvm.target.Target(target))
+
+
+def test_hexagon_dma_ping_pong():
+    mod = tvm.IRModule.from_expr(_vtcm_staging_loop("hexagon"))
+    with tvm.transform.PassContext(config={"tir.use_async_copy": True}):
+        mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    loop = _pipelined_loop(mod["main"])
+    assert [int(s) for s in loop.annotations["software_pipeline_stage"]] == [0, 1]
+    assert [int(s) for s in loop.annotations["software_pipeline_async_stages"]] == [0]
+
+
+def test_hexagon_vtcm_bound():
+    # The VTCM buffer takes 128 bytes, so that there is no room for a second version of it.
+    mod = tvm.IRModule.from_expr(_vtcm_staging_loop("hexagon -vtcm-capacity=200"))
+    with tvm.transform.PassContext(config={"tir.use_async_copy": True}):
+        mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    assert "software_pipeline_stage" not in _pipelined_loop(mod["main"]).annotations
+
+
+@T.prim_func
+def _loop_carried_staging(A: T.Buffer[(16, 16), "float32"]):
+    for tx in T.thread_binding(0, 16, thread="threadIdx.x"):
+        for i in T.serial(0, 15):
+            with T.block():
+                B = T.alloc_buffer((16, 1), dtype="float32", scope="shared")
+                with T.block():
+                    B[tx, 0] = A[tx, i]
+                with T.block():
+                    A[tx, i + 1] = B[tx, 0] + T.float32(1)
+
+
+def test_loop_carried_dependency():
+    mod = tvm.IRModule.from_expr(_loop_carried_staging)
+    mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    assert "software_pipeline_stage" not in _pipelined_loop(mod["main"]).annotations
+
+
+@T.prim_func
+def _cpu_rows(A: T.Buffer[(64, 16), "float32"], C: T.Buffer[(64, 16), "float32"]):
+    T.func_attr({"target": T.target("llvm")})
+    for i in T.serial(0, 64):
+        for j in T.serial(0, 16):
+            with T.block():
+                C[i, j] = A[i, j] * T.float32(2)
+
+
+def test_cpu_prefetch():
+    mod = tvm.IRModule.from_expr(_cpu_rows)
+    mod = tvm.tir.transform.AutoSoftwarePipeline()(mod)
+    prefetches = []
+
+    def _visit(node):
+        if isinstance(node, tvm.tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            prefetches.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, _visit)
+    # The next row of A takes one cache line, and C is only written.
+    assert len(prefetches) == 1
+    load = prefetches[0].args[0].args[0]
+    assert load.buffer.same_as(mod["main"].buffer_map[mod["main"].params[0]])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,142 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+class BaseBeforeAfter:
+    register_budget = tvm.testing.parameter(8)
+
+    def test_hoist(self, register_budget):
+        before_mod = tvm.IRModule.from_expr(self.before)
+        config = {"tir.LoopInvariantCodeMotion": {"register_budget": register_budget}}
+        with tvm.transform.PassContext(config=config):
+            after_mod = tvm.tir.transform.LoopInvariantCodeMotion()(before_mod)
+        tvm.ir.assert_structural_equal(after_mod["main"], self.expected)
+
+
+class TestHoistIndex(BaseBeforeAfter):
+    """The row offset is computed once per row"""
+
+    @T.prim_func
+    def before(A: T.Buffer[(256,), "float32"], B: T.Buffer[(256,), "float32"]):
+        for i in T.serial(16):
+            for j in T.serial(16):
+                B[i * 16 + j] = A[i * 16 + j] + T.float32(1)
+
+    @T.prim_func
+    def expected(A: T.Buffer[(256,), "float32"], B: T.Buffer[(256,), "float32"]):
+        for i in T.serial(16):
+            row = i * 16
+            for j in T.serial(16):
+                B[row + j] = A[row + j] + T.float32(1)
+
+
+class TestHoistAcrossNest(BaseBeforeAfter):
+    """A value invariant in the whole nest moves out of every loop"""
+
+    @T.prim_func
+    def before(A: T.Buffer[(1024,), "float32"], n: T.int32):
+        for i in T.serial(16):
+            for j in T.serial(16):
+                A[n * 32 + i * 16 + j] = T.float32(0)
+
+    @T.prim_func
+    def expected(A: T.Buffer[(1024,), "float32"], n: T.int32):
+        base = n * 32
+        for i in T.serial(16):
+            row = base + i * 16
+            for j in T.serial(16):
+                A[row + j] = T.float32(0)
+
+
+class TestHoistLet(BaseBeforeAfter):
+    """The let bindings of invariant values move out with them"""
+
+    @T.prim_func
+    def before(A: T.Buffer[(256,), "float32"], n: T.int32):
+        for j in T.serial(16):
+            offset = n * 16
+            A[offset + j] = T.float32(0)
+
+    @T.prim_func
+    def expected(A: T.Buffer[(256,), "float32"], n: T.int32):
+        offset = n * 16
+        for j in T.serial(16):
+            A[offset + j] = T.float32(0)
+
+
+class TestNoHoistDivisionByVar(BaseBeforeAfter):
+    """A division by a variable may trap, though invariant"""
+
+    @T.prim_func
+    def before(A: T.Buffer[(256,), "int32"], n: T.int32):
+        for j in T.serial(16):
+            if n != 0:
+                A[j] = T.floordiv(j, 16) + T.floordiv(255, n)
+
+    expected = before
+
+
+class TestNoHoistTrivialLoop(BaseBeforeAfter):
+    """A loop of a single iteration has nothing to save"""
+
+    @T.prim_func
+    def before(A: T.Buffer[(256,), "float32"], n: T.int32):
+        for j in T.serial(1):
+            A[n * 16 + j] = T.float32(0)
+
+    expected = before
+
+
+class TestRegisterBudget(BaseBeforeAfter):
+    """In a GPU kernel, only the biggest values within the budget are hoisted"""
+
+    register_budget = tvm.testing.parameter(1)
+
+    @T.prim_func
+    def before(A: T.Buffer[(1024,), "float32"], B: T.Buffer[(1024,), "float32"], n: T.int32):
+        tx = T.env_thread("threadIdx.x")
+        T.launch_thread(tx, 32)
+        for k in T.serial(8):
+            B[tx * 8 + k] = A[tx * 4 + n + k]
+
+    @T.prim_func
+    def expected(A: T.Buffer[(1024,), "float32"], B: T.Buffer[(1024,), "float32"], n: T.int32):
+        tx = T.env_thread("threadIdx.x")
+        T.launch_thread(tx, 32)
+        offset = tx * 4 + n
+        for k in T.serial(8):
+            B[tx * 8 + k] = A[offset + k]
+
+
+class TestUnlimitedRegisterBudget(TestRegisterBudget):
+    register_budget = tvm.testing.parameter(-1)
+
+    @T.prim_func
+    def expected(A: T.Buffer[(1024,), "float32"], B: T.Buffer[(1024,), "float32"], n: T.int32):
+        tx = T.env_thread("threadIdx.x")
+        T.launch_thread(tx, 32)
+        store = tx * 8
+        load = tx * 4 + n
+        for k in T.serial(8):
+            B[store + k] = A[load + k]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -726,6 +726,34 @@ def reduction_loop_bound_to_blockidx(a: T.handle, b: T.handle) -> None:
                 B[vi] = B[vi] + A[vi, vk]
 
 
+@T.prim_func
+def lowered_reduction_loop_bound_to_blockidx(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, [128, 128], dtype="float32")
+    B = T.match_buffer(b, [128], dtype="float32")
+    reduce_temp0 = T.alloc_buffer([1], dtype="float32", strides=[1], scope="local")
+    for i in T.serial(0, 128):
+        for k in T.thread_binding(0, 128, thread="blockIdx.x"):
+            with T.block("B_cross_thread_reduction"):
+                vi, vk = T.axis.remap("SR", [i, k])
+                T.reads([A[vi, vk]])
+                T.writes([reduce_temp0[0]])
+                T.attr(
+                    T.comm_reducer(lambda x, y: x + y, [T.float32(0)]),
+                    "reduce_scope",
+                    T.reinterpret(T.uint64(0), dtype="handle"),
+                )
+                T.evaluate(
+                    T.tvm_thread_allreduce(
+                        T.uint32(1), A[vi, vk], True, reduce_temp0[0], k, dtype="handle"
+                    )
+                )
+            with T.block("B_write_back"):
+                vi = T.axis.spatial(128, i)
+                T.reads([reduce_temp0[0]])
+                T.writes([B[vi]])
+                B[vi] = reduce_temp0[0]
+
+
 @T.prim_func
 def different_access_indices(a: T.handle, b: T.handle) -> None:
     A = T.match_buffer(a, [128, 128, 128], dtype="float32")
@@ -1321,7 +1349,7 @@ def test_reduction_block_not_deepest():
 
 
 def test_reduction_loop_bound_to_blockidx():
-    _check_fail(reduction_loop_bound_to_blockidx)
+    _check(reduction_loop_bound_to_blockidx, lowered_reduction_loop_bound_to_blockidx)
 
 
 def test_different_access_indices():
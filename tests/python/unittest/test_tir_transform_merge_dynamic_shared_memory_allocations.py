@@ -326,8 +326,51 @@ def test_dyn_shared_more_dtype():
         check_target(target)
 
 
+def test_dyn_shared_pack_by_live_range():
+    """Test the offsets of the buffers packed by their live ranges"""
+    n = 256
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.placeholder((n,), name="B", dtype="float32")
+
+    def test_device_ir(A, B, C):
+        ib = tvm.tir.ir_builder.create()
+
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(tx, "thread_extent", n)
+
+        A_sh = ib.allocate(A.dtype, (n,), scope="shared.dyn", name="A_sh")  # 1024 bytes
+        B_sh = ib.allocate(B.dtype, (32,), scope="shared.dyn", name="B_sh")  # 128 bytes
+        C_sh = ib.allocate(C.dtype, (128,), scope="shared.dyn", name="C_sh")  # 512 bytes
+
+        Aptr = ib.buffer_ptr(A)
+        Bptr = ib.buffer_ptr(B)
+        Cptr = ib.buffer_ptr(C)
+
+        A_sh[tx] = Aptr[tx]
+        Cptr[tx] = A_sh[tx]
+
+        # B_sh takes the place of A_sh, and C_sh, live with B_sh, fits in the rest of it.
+        B_sh[tx % 32] = Bptr[tx]
+        C_sh[tx % 128] = B_sh[tx % 32]
+        Cptr[tx] += C_sh[tx % 128] + B_sh[tx % 32]
+        return ib.get()
+
+    C = te.extern(
+        (n,),
+        [A, B],
+        lambda ins, outs: test_device_ir(ins[0], ins[1], outs[0]),
+        name="vadd",
+        dtype="float32",
+    )
+    s = te.create_schedule(C.op)
+
+    mod = run_passes(s, [A, B, C])
+    verify_single_allocation(mod["main"].body, n * 4)
+
+
 if __name__ == "__main__":
     test_matmul_dyn_shared()
     test_dyn_shared_vectorized_store()
     test_dyn_shared_reuse_and_merge()
     test_dyn_shared_more_dtype()
+    test_dyn_shared_pack_by_live_range()
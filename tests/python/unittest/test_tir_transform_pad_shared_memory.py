@@ -0,0 +1,100 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+# pylint: disable=no-member,invalid-name,unused-variable,unexpected-keyword-arg
+
+
+def _check(original, transformed):
+    mod = tvm.IRModule.from_expr(original)
+    mod = tvm.tir.transform.PadSharedMemory()(mod)
+    tvm.ir.assert_structural_equal(mod["main"], transformed, True)
+
+
+@T.prim_func
+def transpose(A: T.Buffer[(64, 64), "float32"], B: T.Buffer[(64, 64), "float32"]) -> None:
+    A_shared = T.alloc_buffer([64, 64], dtype="float32", scope="shared")
+    for i in T.thread_binding(64, thread="threadIdx.y"):
+        for j in T.thread_binding(64, thread="threadIdx.x"):
+            with T.block("A_shared"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                A_shared[vi, vj] = A[vi, vj]
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A_shared[vj, vi]
+
+
+@T.prim_func
+def transpose_padded(A: T.Buffer[(64, 64), "float32"], B: T.Buffer[(64, 64), "float32"]) -> None:
+    A_shared = T.alloc_buffer([64, 64], dtype="float32", scope="shared")
+    for i in T.thread_binding(64, thread="threadIdx.y"):
+        for j in T.thread_binding(64, thread="threadIdx.x"):
+            with T.block("A_shared"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                T.block_attr({"buffer_dim_align": [[0, 0, 32, 1]]})
+                A_shared[vi, vj] = A[vi, vj]
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A_shared[vj, vi]
+
+
+@T.prim_func
+def transpose_odd_rows(A: T.Buffer[(64, 65), "float32"], B: T.Buffer[(65, 64), "float32"]) -> None:
+    A_shared = T.alloc_buffer([64, 65], dtype="float32", scope="shared")
+    for i in T.thread_binding(64, thread="threadIdx.y"):
+        for j in T.thread_binding(65, thread="threadIdx.x"):
+            with T.block("A_shared"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                A_shared[vi, vj] = A[vi, vj]
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vj, vi] = A_shared[vi, vj]
+
+
+def test_pad_rows_read_across_threads():
+    _check(transpose, transpose_padded)
+
+
+def test_keep_aligned():
+    _check(transpose_padded, transpose_padded)
+
+
+def test_keep_odd_rows():
+    _check(transpose_odd_rows, transpose_odd_rows)
+
+
+def test_compact_padded_strides():
+    mod = tvm.IRModule.from_expr(transpose)
+    mod = tvm.tir.transform.PadSharedMemory()(mod)
+    mod = tvm.tir.transform.CompactBufferAllocation()(mod)
+    strides = []
+
+    def visit(node):
+        if isinstance(node, tvm.tir.Block):
+            for buf in node.alloc_buffers:
+                if buf.name == "A_shared":
+                    strides.append([int(stride) for stride in buf.strides])
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    assert strides == [[65, 1]]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
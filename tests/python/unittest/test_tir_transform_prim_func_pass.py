@@ -63,6 +63,33 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def test_parallel_prim_func_pass():
+    funcs = {}
+    for i in range(8):
+        x = te.var("x")
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + i - i)).with_attr(
+            "global_symbol", "func%d" % i
+        )
+    funcs["dropped"] = tvm.tir.PrimFunc([], tvm.tir.Evaluate(0))
+    mod = tvm.IRModule(funcs)
+
+    @tvm.tir.transform.prim_func_pass(opt_level=0)
+    def simplify(func, mod, ctx):
+        assert int(ctx.config["tir.prim_func_pass_num_threads"]) == 4
+        if len(func.params) == 0:
+            return None
+        return tvm.tir.transform.Simplify()(tvm.IRModule({"main": func}))["main"]
+
+    with tvm.transform.PassContext(config={"tir.prim_func_pass_num_threads": 4}):
+        after = simplify(mod)
+    assert "dropped" not in [gvar.name_hint for gvar in after.get_global_vars()]
+    for i in range(8):
+        func = after["func%d" % i]
+        assert tvm.ir.structural_equal(func.body, tvm.tir.Evaluate(func.params[0]))
+    assert len(mod.functions) == 9
+
+
 if __name__ == "__main__":
     test_cow_pass()
     test_prim_func_pass()
+    test_parallel_prim_func_pass()
@@ -171,6 +171,45 @@ def test_vectorize_if_then_else():
     assert isinstance(stmt.body.value.args[2], tvm.tir.Broadcast)
 
 
+def _split_tail_loop(with_scalar_load=False):
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, tvm.tir.indexdiv(n + 3, 4)) as k:
+        with ib.for_range(0, 4, kind="vectorize") as i:
+            with ib.if_scope(tvm.tir.likely(k * 4 + i < n)):
+                B[k * 4 + i] = A[k * 4 + i] + (A[0] if with_scalar_load else 1.0)
+    return tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B, n], ib.get()))
+
+
+def test_vectorize_tail_predication():
+    mod = _split_tail_loop()
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    assert isinstance(stmt.body, tvm.tir.BufferStore)
+    assert stmt.body.value.dtype == "float32x4"
+    assert stmt.body.predicate.dtype == "boolx4"
+    assert stmt.body.value.a.predicate.dtype == "boolx4"
+
+    # The guarded accesses are scalarized by default.
+    stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt.body, tvm.tir.For)
+
+
+def test_vectorize_tail_predication_scalar_load():
+    mod = _split_tail_loop(with_scalar_load=True)
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    # The scalar load runs once the first lane is active.
+    assert isinstance(stmt.body, tvm.tir.IfThenElse)
+    assert not stmt.body.condition.dtype.startswith("boolx")
+    assert stmt.body.then_case.predicate.dtype == "boolx4"
+    assert stmt.body.then_case.value.b.value.predicate is None
+
+
 def test_vectorize_while_fail():
     """A while loop inside a vectorized loop should fail."""
 
@@ -234,5 +273,7 @@ if __name__ == "__main__":
     test_vectorize_with_le_cond()
     test_vectorize_with_ge_cond()
     test_vectorize_let()
+    test_vectorize_tail_predication()
+    test_vectorize_tail_predication_scalar_load()
     test_vectorize_while_fail()
     test_vectorize_dtype_mismatch()
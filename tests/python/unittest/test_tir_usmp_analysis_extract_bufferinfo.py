@@ -1689,5 +1689,93 @@ def test_multiple_calls_to_same_primfunc():
     )
 
 
+# fmt: off
+@tvm.script.ir_module
+class InplaceStructure:
+    @T.prim_func
+    def tvmgen_default_fused_cast(placeholder: T.handle, T_cast: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_fused_cast", "tir.noalias": True})
+        placeholder_1 = T.match_buffer(placeholder, [64], dtype="uint8")
+        T_cast_1 = T.match_buffer(T_cast, [64], dtype="int16")
+        for ax0 in T.serial(0, 64):
+            T_cast_1[ax0] = T.cast(placeholder_1[ax0], "int16")
+
+    @T.prim_func
+    def tvmgen_default_fused_subtract_clip(placeholder_2: T.handle, placeholder_3: T.handle, T_clip: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_fused_subtract_clip", "tir.noalias": True})
+        placeholder_4 = T.match_buffer(placeholder_2, [64], dtype="int16")
+        placeholder_5 = T.match_buffer(placeholder_3, [1], dtype="int16")
+        T_clip_1 = T.match_buffer(T_clip, [64], dtype="int16")
+        for ax0 in T.serial(0, 64):
+            T_clip_1[ax0] = T.max(placeholder_4[ax0] - placeholder_5[0], T.int16(0))
+
+    @T.prim_func
+    def tvmgen_default_fused_cast_1(placeholder_6: T.handle, T_cast_2: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_fused_cast_1", "tir.noalias": True})
+        placeholder_7 = T.match_buffer(placeholder_6, [64], dtype="int16")
+        T_cast_3 = T.match_buffer(T_cast_2, [64], dtype="uint8")
+        for ax0 in T.serial(0, 64):
+            T_cast_3[ax0] = T.cast(placeholder_7[ax0], "uint8")
+
+    @T.prim_func
+    def run_model(input: T.handle, output: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_run_model", "runner_function": True})
+        sid_1 = T.allocate([128], "int8", "global")
+        sid_2 = T.allocate([128], "int8", "global")
+        T.evaluate(T.call_extern("tvmgen_default_fused_cast", input, sid_1, dtype="int32"))
+        T.evaluate(T.call_extern("tvmgen_default_fused_subtract_clip", sid_1, T.lookup_param("p0", dtype="handle"), sid_2, dtype="int32"))
+        T.evaluate(T.call_extern("tvmgen_default_fused_cast_1", sid_2, output, dtype="int32"))
+    __tvm_meta__ = None
+# fmt: on
+
+
+def _get_inplace_structure(target, pool_infos, inplace_safe):
+    """helper to get InplaceStructure with the elementwise operator optionally in-place safe"""
+    tir_mod = _assign_targets_to_primfuncs_irmodule(InplaceStructure, target)
+    if inplace_safe:
+        tir_mod["tvmgen_default_fused_subtract_clip"] = tir_mod[
+            "tvmgen_default_fused_subtract_clip"
+        ].with_attr(usmp_utils.INPLACE_SAFE_FUNC_ATTR, True)
+    return _assign_poolinfos_to_allocates_in_irmodule(tir_mod, pool_infos)
+
+
+@pytest.mark.parametrize("inplace_safe", [True, False])
+def test_inplace_alias(inplace_safe):
+    target = Target("c")
+    global_workspace_pool = WorkspacePoolInfo("global_workspace", [target])
+    tir_mod = _get_inplace_structure(target, [global_workspace_pool], inplace_safe)
+    buffer_info_analysis = tvm.tir.usmp.analysis.extract_buffer_info(tir_mod["run_model"], tir_mod)
+    buffer_info_map = _replace_stmt_with_buf_var_names(buffer_info_analysis.buffer_info_stmts)
+    allocates = _get_allocates(tir_mod["run_model"])
+
+    if inplace_safe:
+        # The output of the elementwise operator is computed in the storage of its input
+        assert set(buffer_info_map.keys()) == {"sid_1"}
+        assert buffer_info_analysis.memory_pressure == 128
+        assert len(buffer_info_analysis.inplace_aliases) == 1
+        assert buffer_info_analysis.inplace_aliases[allocates["sid_2"]].same_as(allocates["sid_1"])
+        assert len(buffer_info_map["sid_1"].conflicts) == 0
+    else:
+        assert set(buffer_info_map.keys()) == {"sid_1", "sid_2"}
+        assert buffer_info_analysis.memory_pressure == 256
+        assert len(buffer_info_analysis.inplace_aliases) == 0
+        _verify_conflicts("sid_1", ["sid_2"], buffer_info_map)
+        _verify_conflicts("sid_2", ["sid_1"], buffer_info_map)
+
+
+@pytest.mark.parametrize("inplace_safe, pool_size", [(True, 128), (False, 256)])
+def test_inplace_alias_pool_allocations(inplace_safe, pool_size):
+    target = Target("c")
+    global_workspace_pool = WorkspacePoolInfo("global_workspace", [target])
+    tir_mod = _get_inplace_structure(target, [global_workspace_pool], inplace_safe)
+    tir_mod = tir_mod.with_attr("executor", tvm.relay.backend.Executor("aot"))
+    tir_mod = tir_mod.with_attr("runtime", tvm.relay.backend.Runtime("crt"))
+    tir_mod["__tvm_main__"] = tir_mod["run_model"]
+
+    usmp_pass = tvm.get_global_func("tir.transform.UnifiedStaticMemoryPlanner")
+    tir_mod = usmp_pass()(tir_mod)
+    pool_args = tir_mod["__tvm_main__"].attrs["pool_args"]
+    assert [allocated_pool_info.allocated_size for allocated_pool_info in pool_args] == [pool_size]
+
 if __name__ == "__main__":
     pytest.main([__file__] + sys.argv[1:])
@@ -125,6 +125,7 @@ class Environment(object):
     DEBUG_DUMP_UOP = 1 << 2
     DEBUG_SKIP_READ_BARRIER = 1 << 3
     DEBUG_SKIP_WRITE_BARRIER = 1 << 4
+    DEBUG_SKIP_STREAM_CACHE = 1 << 6
     # memory scopes
     inp_scope = "local.inp_buffer"
     wgt_scope = "local.wgt_buffer"
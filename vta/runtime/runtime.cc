@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -509,6 +510,8 @@ class UopQueue : public BaseQueue<VTAUop> {
     cache_idx_ = 0;
     BaseQueue<VTAUop>::Reset();
   }
+  /*! \return The kernels in the buffer, in the order they are copied to the FPGA buffer. */
+  const std::vector<UopKernel*>& kernels() const { return cache_; }
   void AutoReadBarrier() { ReadBarrier(); }
   /*! \brief Writer barrier to make sure that data written by CPU is visible to VTA. */
   void ReadBarrier() {
@@ -649,6 +652,59 @@ class InsnQueue : public BaseQueue<VTAGenericInsn> {
   }
   // create a new instruction for a store stage
   VTAMemInsn* CreateStoreInsn() { return reinterpret_cast<VTAMemInsn*>(Create(kStoreStage)); }
+  /*!
+   * \brief Mark the last instruction as an unpadded 2D load that later loads can be merged into.
+   * \param memory_type The memory the load is to, which the 2-bit field may not hold.
+   */
+  void MarkMergeableLoad(int memory_type) {
+    mergeable_load_end_ = dram_buffer_.size();
+    mergeable_memory_type_ = memory_type;
+  }
+  /*!
+   * \brief Merge an unpadded 2D load into the last instruction, if it is a mergeable load to the
+   *  same memory that the new one continues in both DRAM and SRAM, either with more rows of the
+   *  same shape or by extending a single row, so that adjacent loads are issued as one DMA.
+   * \return Whether the load is merged.
+   */
+  bool MergeLoad(int memory_type, uint32_t sram_base, uint32_t dram_base, uint32_t x_size,
+                 uint32_t y_size, uint32_t x_stride) {
+    constexpr uint32_t kMaxSize = (1U << VTA_MEMOP_SIZE_BIT_WIDTH) - 1;
+    constexpr uint32_t kMaxStride = (1U << VTA_MEMOP_STRIDE_BIT_WIDTH) - 1;
+    if (mergeable_load_end_ == 0 || mergeable_load_end_ != dram_buffer_.size() ||
+        mergeable_memory_type_ != memory_type) {
+      return false;
+    }
+    // The merged load would take the pops pending before the new one
+    PipelineStage stage = GetMemPipelineStage(memory_type);
+    if (pending_pop_prev_[stage] || pending_pop_next_[stage]) return false;
+    VTAMemInsn* prev = reinterpret_cast<VTAMemInsn*>(&dram_buffer_.back());
+    if (prev->push_prev_dep || prev->push_next_dep) return false;
+    if (prev->x_size == x_size && prev->x_stride == x_stride) {
+      if (dram_base != prev->dram_base + prev->y_size * x_stride ||
+          sram_base != prev->sram_base + prev->y_size * x_size || prev->y_size + y_size > kMaxSize) {
+        return false;
+      }
+      prev->y_size += y_size;
+      return true;
+    }
+    if (prev->y_size == 1 && y_size == 1) {
+      uint32_t merged_size = prev->x_size + x_size;
+      if (dram_base != prev->dram_base + prev->x_size ||
+          sram_base != prev->sram_base + prev->x_size || merged_size > kMaxSize ||
+          merged_size > kMaxStride) {
+        return false;
+      }
+      prev->x_size = merged_size;
+      prev->x_stride = merged_size;
+      return true;
+    }
+    return false;
+  }
+  /*! \brief Reset the buffer and forget the mergeable load. */
+  void Reset() {
+    BaseQueue<VTAGenericInsn>::Reset();
+    mergeable_load_end_ = 0;
+  }
   // Rewrite instruction stream to force serial execution
   void RewriteForceSerial() {
     int insn_count = count();
@@ -916,6 +972,8 @@ class InsnQueue : public BaseQueue<VTAGenericInsn> {
   /*! \return Add new instruction to the buffer. */
   VTAGenericInsn* NextInsn() {
     VTAGenericInsn insn;
+    // Clear the unused fields, so that identical streams compare equal byte by byte
+    memset(&insn, 0, sizeof(insn));
     dram_buffer_.push_back(insn);
     return &dram_buffer_.back();
   }
@@ -990,10 +1048,197 @@ class InsnQueue : public BaseQueue<VTAGenericInsn> {
   // Pending pop of each isntruction queue, qid=0 is not used
   int pending_pop_prev_[4];
   int pending_pop_next_[4];
+  // The size of the buffer just after the last mergeable load, 0 if there is none
+  size_t mergeable_load_end_{0};
+  // The memory of the last mergeable load
+  int mergeable_memory_type_{0};
   static constexpr int kElemBytes = sizeof(VTAGenericInsn);
   static constexpr int kMaxElems = kMaxBytes / kElemBytes;
 };
 
+/*!
+ * \brief The cache of the instruction streams run on the device, with their micro-ops, in device
+ *  memory. A stream is identified by its instructions, with the DRAM addresses of the loads and
+ *  stores of data masked, and by its micro-op kernels, so that a layer invoked again on other
+ *  buffers is replayed with only these addresses patched, instead of staging and copying all of
+ *  its instructions and micro-ops again.
+ */
+class InsnStreamCache {
+ public:
+  ~InsnStreamCache() {
+    for (Entry& entry : entries_) {
+      VTAMemFree(entry.buff);
+    }
+  }
+  /*!
+   * \brief Find the cached stream of the same layer, and patch its addresses to the ones of
+   *  the stream.
+   * \param insns The instructions of the stream.
+   * \param count The number of instructions.
+   * \param kernels The micro-op kernels the stream loads, in their order in the micro-op buffer.
+   * \return The physical address of the patched instructions, or 0 if the stream is not cached.
+   */
+  vta_phy_addr_t Replay(const VTAGenericInsn* insns, uint32_t count,
+                        const std::vector<UopKernel*>& kernels) {
+    size_t hash = Hash(insns, count, kernels);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->hash != hash || !it->Match(insns, count, kernels)) continue;
+      // Patch the addresses that differ, and copy the range of the patched instructions only
+      uint32_t begin = count, end = 0;
+      for (uint32_t i = 0; i < count; ++i) {
+        const VTAMemInsn* insn = reinterpret_cast<const VTAMemInsn*>(insns + i);
+        VTAMemInsn* cached = reinterpret_cast<VTAMemInsn*>(&it->insns[i]);
+        if (IsDataMemInsn(insn) && cached->dram_base != insn->dram_base) {
+          cached->dram_base = insn->dram_base;
+          begin = std::min(begin, i);
+          end = i + 1;
+        }
+      }
+      if (begin < end) {
+        size_t offset = begin * sizeof(VTAGenericInsn);
+        size_t size = (end - begin) * sizeof(VTAGenericInsn);
+        VTAMemCopyFromHost(static_cast<char*>(it->buff) + offset, it->insns.data() + begin, size);
+        if (!kBufferCoherent && kAlwaysCache) {
+          VTAFlushCache(static_cast<char*>(it->buff) + offset, it->buff_phy + offset, size);
+        }
+      }
+      // Keep the most recently used stream first
+      entries_.splice(entries_.begin(), entries_, it);
+      return entries_.front().buff_phy;
+    }
+    return 0;
+  }
+  /*!
+   * \brief Copy a stream and its micro-ops to the device memory of a new entry, evicting the
+   *  least recently used entry if the cache is full.
+   * \param insns The instructions of the stream.
+   * \param count The number of instructions.
+   * \param kernels The micro-op kernels the stream loads, in their order in the micro-op buffer.
+   * \param uop_phy_addr The physical address of the micro-op buffer the stream loads from.
+   * \return The physical address of the instructions of the entry.
+   */
+  vta_phy_addr_t Insert(const VTAGenericInsn* insns, uint32_t count,
+                        const std::vector<UopKernel*>& kernels, vta_phy_addr_t uop_phy_addr) {
+    if (entries_.size() >= kMaxEntries) {
+      VTAMemFree(entries_.back().buff);
+      entries_.pop_back();
+    }
+    entries_.emplace_front();
+    Entry& entry = entries_.front();
+    entry.hash = Hash(insns, count, kernels);
+    entry.insns.assign(insns, insns + count);
+    entry.kernels = kernels;
+    // The micro-ops follow the instructions, laid out as in the micro-op buffer
+    size_t insn_bytes = count * sizeof(VTAGenericInsn);
+    size_t uop_offset = (insn_bytes + ALLOC_ALIGNMENT - 1) / ALLOC_ALIGNMENT * ALLOC_ALIGNMENT;
+    size_t uop_bytes = 0;
+    for (UopKernel* kernel : kernels) {
+      uop_bytes += kernel->size() * sizeof(VTAUop);
+    }
+    size_t buff_size = uop_offset + uop_bytes;
+    entry.buff = VTAMemAlloc(buff_size, kBufferCoherent || kAlwaysCache);
+    CHECK(entry.buff != nullptr);
+    entry.buff_phy = VTAMemGetPhyAddr(entry.buff);
+    // Redirect the micro-op loads to the micro-ops of the entry
+    vta_phy_addr_t uop_base = uop_phy_addr / sizeof(VTAUop);
+    entry.uop_shift = (entry.buff_phy + uop_offset) / sizeof(VTAUop) - uop_base;
+    for (VTAGenericInsn& generic : entry.insns) {
+      VTAMemInsn* insn = reinterpret_cast<VTAMemInsn*>(&generic);
+      if (IsUopLoad(insn)) {
+        insn->dram_base = insn->dram_base + entry.uop_shift;
+      }
+    }
+    std::vector<char> host(buff_size, 0);
+    memcpy(host.data(), entry.insns.data(), insn_bytes);
+    size_t offset = uop_offset;
+    for (UopKernel* kernel : kernels) {
+      size_t ksize = kernel->size() * sizeof(VTAUop);
+      memcpy(host.data() + offset, kernel->data(), ksize);
+      offset += ksize;
+    }
+    VTAMemCopyFromHost(entry.buff, host.data(), buff_size);
+    if (!kBufferCoherent && kAlwaysCache) {
+      VTAFlushCache(entry.buff, entry.buff_phy, buff_size);
+    }
+    return entry.buff_phy;
+  }
+
+ private:
+  struct Entry {
+    /*! \brief The hash of the masked stream. */
+    size_t hash{0};
+    /*! \brief The instructions as in the device memory, with the addresses last patched. */
+    std::vector<VTAGenericInsn> insns;
+    /*! \brief The micro-op kernels of the stream. */
+    std::vector<UopKernel*> kernels;
+    /*! \brief The device memory of the instructions and the micro-ops. */
+    void* buff{nullptr};
+    /*! \brief The physical address of the device memory. */
+    vta_phy_addr_t buff_phy{0};
+    /*! \brief The shift of the micro-op loads to the micro-ops in the device memory. */
+    vta_phy_addr_t uop_shift{0};
+
+    bool Match(const VTAGenericInsn* other, uint32_t count,
+               const std::vector<UopKernel*>& other_kernels) const {
+      if (insns.size() != count || kernels != other_kernels) return false;
+      for (uint32_t i = 0; i < count; ++i) {
+        VTAGenericInsn a = Masked(insns[i]);
+        VTAGenericInsn b = Masked(other[i]);
+        VTAMemInsn* insn = reinterpret_cast<VTAMemInsn*>(&a);
+        if (IsUopLoad(insn)) {
+          insn->dram_base = insn->dram_base - uop_shift;
+        }
+        if (memcmp(&a, &b, sizeof(VTAGenericInsn)) != 0) return false;
+      }
+      return true;
+    }
+  };
+
+  // NOTE: a no-op load of the compute stage has the memory type of micro-ops and no address
+  static bool IsUopLoad(const VTAMemInsn* insn) {
+    return insn->opcode == VTA_OPCODE_LOAD && insn->memory_type == VTA_MEM_ID_UOP &&
+           insn->x_size != 0;
+  }
+  // NOTE: the memory type of a store is not checked, as VTA_MEM_ID_OUT does not fit its field
+  static bool IsDataMemInsn(const VTAMemInsn* insn) {
+    return insn->opcode == VTA_OPCODE_STORE ||
+           (insn->opcode == VTA_OPCODE_LOAD && insn->memory_type != VTA_MEM_ID_UOP);
+  }
+  // The instruction with the DRAM address masked, if it is a load or a store of data
+  static VTAGenericInsn Masked(const VTAGenericInsn& generic) {
+    VTAGenericInsn masked = generic;
+    VTAMemInsn* insn = reinterpret_cast<VTAMemInsn*>(&masked);
+    if (IsDataMemInsn(insn)) {
+      insn->dram_base = 0;
+    }
+    return masked;
+  }
+  static size_t Hash(const VTAGenericInsn* insns, uint32_t count,
+                     const std::vector<UopKernel*>& kernels) {
+    size_t hash = count;
+    auto combine = [&hash](size_t value) {
+      hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    for (uint32_t i = 0; i < count; ++i) {
+      VTAGenericInsn masked = Masked(insns[i]);
+      uint64_t words[sizeof(VTAGenericInsn) / sizeof(uint64_t)];
+      memcpy(words, &masked, sizeof(words));
+      for (uint64_t word : words) {
+        combine(std::hash<uint64_t>()(word));
+      }
+    }
+    for (UopKernel* kernel : kernels) {
+      combine(std::hash<UopKernel*>()(kernel));
+    }
+    return hash;
+  }
+
+  // The maximum number of cached streams
+  static constexpr size_t kMaxEntries = 32;
+  // The cached streams, the most recently used first
+  std::list<Entry> entries_;
+};
+
 /*!
  * \brief The command queue object that handles the request.
  */
@@ -1046,12 +1291,19 @@ class CommandQueue {
                     uint32_t x_stride, uint32_t x_pad_before, uint32_t y_pad_before,
                     uint32_t x_pad_after, uint32_t y_pad_after, uint32_t dst_sram_index,
                     uint32_t dst_memory_type) {
+    DataBuffer* src = DataBuffer::FromHandle(src_dram_addr);
+    uint32_t dram_base = src->phy_addr() / GetElemBytes(dst_memory_type) + src_elem_offset;
+    bool padded = x_pad_before || y_pad_before || x_pad_after || y_pad_after;
+    // Merge the load into the previous one if it continues it
+    if (!padded && insn_queue_.MergeLoad(dst_memory_type, dst_sram_index, dram_base, x_size,
+                                         y_size, x_stride)) {
+      return;
+    }
     VTAMemInsn* insn = insn_queue_.CreateMemInsn(dst_memory_type);
     insn->opcode = VTA_OPCODE_LOAD;
     insn->memory_type = dst_memory_type;
     insn->sram_base = dst_sram_index;
-    DataBuffer* src = DataBuffer::FromHandle(src_dram_addr);
-    insn->dram_base = src->phy_addr() / GetElemBytes(dst_memory_type) + src_elem_offset;
+    insn->dram_base = dram_base;
     insn->y_size = y_size;
     insn->x_size = x_size;
     insn->x_stride = x_stride;
@@ -1059,6 +1311,9 @@ class CommandQueue {
     insn->y_pad_1 = y_pad_after;
     insn->x_pad_0 = x_pad_before;
     insn->x_pad_1 = x_pad_after;
+    if (!padded) {
+      insn_queue_.MarkMergeableLoad(dst_memory_type);
+    }
     this->CheckInsnOverFlow();
   }
 
@@ -1117,9 +1372,6 @@ class CommandQueue {
     CHECK(!insn_queue_.PendingPop());
     // Check if there are no instruction to execute at all
     if (insn_queue_.count() == 0) return;
-    // Synchronization for the queues
-    uop_queue_.AutoReadBarrier();
-    insn_queue_.AutoReadBarrier();
     // Dump instructions if debug enabled
     if (debug_flag_ & VTA_DEBUG_DUMP_INSN) {
       insn_queue_.DumpInsn();
@@ -1130,8 +1382,21 @@ class CommandQueue {
 
     // Make sure that we don't exceed contiguous physical memory limits
     CHECK(insn_queue_.count() * sizeof(VTAGenericInsn) <= VTA_MAX_XFER);
-    int timeout =
-        VTADeviceRun(device_, insn_queue_.dram_phy_addr(), insn_queue_.count(), wait_cycles);
+    // Replay the cached stream of the same layer if any, or synchronize the queues
+    vta_phy_addr_t insn_phy_addr = 0;
+    if (!(debug_flag_ & VTA_DEBUG_SKIP_STREAM_CACHE)) {
+      insn_phy_addr =
+          stream_cache_.Replay(insn_queue_.data(), insn_queue_.count(), uop_queue_.kernels());
+      if (insn_phy_addr == 0) {
+        insn_phy_addr = stream_cache_.Insert(insn_queue_.data(), insn_queue_.count(),
+                                             uop_queue_.kernels(), uop_queue_.dram_phy_addr());
+      }
+    } else {
+      uop_queue_.AutoReadBarrier();
+      insn_queue_.AutoReadBarrier();
+      insn_phy_addr = insn_queue_.dram_phy_addr();
+    }
+    int timeout = VTADeviceRun(device_, insn_phy_addr, insn_queue_.count(), wait_cycles);
     CHECK_EQ(timeout, 0);
     // Reset buffers
     uop_queue_.Reset();
@@ -1293,6 +1558,8 @@ class CommandQueue {
   UopQueue<VTA_MAX_XFER, kBufferCoherent, kAlwaysCache> uop_queue_;
   // instruction queue
   InsnQueue<VTA_MAX_XFER, kBufferCoherent, kAlwaysCache> insn_queue_;
+  // The instruction streams run on the device
+  InsnStreamCache stream_cache_;
   // Device handle
   VTADeviceHandle device_{nullptr};
 };
@@ -41,6 +41,7 @@ extern "C" {
 #define VTA_DEBUG_SKIP_READ_BARRIER (1 << 3)
 #define VTA_DEBUG_SKIP_WRITE_BARRIER (1 << 4)
 #define VTA_DEBUG_FORCE_SERIAL (1 << 5)
+#define VTA_DEBUG_SKIP_STREAM_CACHE (1 << 6)
 
 #define ALLOC_ALIGNMENT 64
 
@@ -81,6 +81,48 @@ def test_save_load_out():
     vta.testing.run(_run)
 
 
+def test_stream_replay():
+    """Test a layer replayed from the cached instruction stream on other buffers"""
+
+    def _run(env, remote):
+        n = 6
+        x = te.placeholder((n, n, env.BATCH, env.BLOCK_OUT), name="x", dtype=env.acc_dtype)
+        x_buf = te.compute((n, n, env.BATCH, env.BLOCK_OUT), lambda *i: x(*i), "x_buf")
+        y_buf = te.compute((n, n, env.BATCH, env.BLOCK_OUT), lambda *i: x_buf(*i) + 1, "y_buf")
+        y = te.compute(
+            (n, n, env.BATCH, env.BLOCK_OUT), lambda *i: y_buf(*i).astype(env.inp_dtype), "y"
+        )
+        # schedule
+        s = te.create_schedule(y.op)
+        s[x_buf].set_scope(env.acc_scope)
+        s[x_buf].pragma(x_buf.op.axis[0], env.dma_copy)
+        s[y_buf].set_scope(env.acc_scope)
+        s[y_buf].pragma(y_buf.op.axis[0], env.alu)
+        s[y].pragma(y.op.axis[0], env.dma_copy)
+
+        with vta.build_config():
+            m = vta.build(s, [x, y], tvm.target.Target("ext_dev", host=env.target_host))
+
+        if not remote:
+            return
+        temp = utils.tempdir()
+        m.save(temp.relpath("stream_replay.o"))
+        remote.upload(temp.relpath("stream_replay.o"))
+        f = remote.load_module("stream_replay.o")
+        dev = remote.ext_dev(0)
+        buffers = []
+        for _ in range(2):
+            x_np = np.random.randint(1, 10, size=(n, n, env.BATCH, env.BLOCK_OUT)).astype(x.dtype)
+            y_nd = tvm.nd.empty(x_np.shape, device=dev, dtype=y.dtype)
+            buffers.append((x_np, tvm.nd.array(x_np, dev), y_nd))
+        # The same layer on other buffers, then on the first ones again
+        for x_np, x_nd, y_nd in buffers + buffers[:1]:
+            f(x_nd, y_nd)
+            np.testing.assert_equal((x_np + 1).astype(y.dtype), y_nd.numpy())
+
+    vta.testing.run(_run)
+
+
 def test_padded_load():
     """Test padded load."""
 
@@ -562,6 +604,7 @@ def test_runtime_array():
 if __name__ == "__main__":
     test_runtime_array()
     test_save_load_out()
+    test_stream_replay()
     test_padded_load()
     test_gemm()
     test_alu()
@@ -43,6 +43,12 @@
 #include "src/runtime/object.cc"
 #include "src/runtime/profiling.cc"
 #include "src/runtime/registry.cc"
+#include "src/runtime/relax_vm/builtin.cc"
+#include "src/runtime/relax_vm/bytecode.cc"
+#include "src/runtime/relax_vm/ccl.cc"
+#include "src/runtime/relax_vm/executable.cc"
+#include "src/runtime/relax_vm/memory_manager.cc"
+#include "src/runtime/relax_vm/vm.cc"
 #include "src/runtime/rpc/rpc_channel.cc"
 #include "src/runtime/rpc/rpc_endpoint.cc"
 #include "src/runtime/rpc/rpc_event_impl.cc"
@@ -63,6 +69,18 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
 
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) { return 0; }
 
+namespace tvm {
+namespace runtime {
+namespace threading {
+// There is only the calling thread, and no named thread pool.
+std::string BindThreadPool(const std::string& name) {
+  CHECK(name.empty()) << "ValueError: The wasm runtime has no thread pool " << name;
+  return "";
+}
+}  // namespace threading
+}  // namespace runtime
+}  // namespace tvm
+
 // --- Environment PackedFuncs for testing ---
 namespace tvm {
 namespace runtime {
@@ -111,5 +129,61 @@ TVM_REGISTER_GLOBAL("testing.object_use_count").set_body([](TVMArgs args, TVMRet
   // and get another value.
   *ret = (obj.use_count() - 1);
 });
+
+/*!
+ * \brief The parameters fetched by the JS side, by name.
+ *
+ * The parameters are uploaded to the device shard by shard as they arrive, so the functions
+ * needing only the first ones can run before all of them are fetched.
+ */
+class NDArrayCache {
+ public:
+  static NDArrayCache* Global() {
+    static NDArrayCache* inst = new NDArrayCache();
+    return inst;
+  }
+
+  static void Update(String name, NDArray arr, bool override) {
+    NDArrayCache* pool = Global();
+    if (!override) {
+      CHECK_EQ(pool->pool_.count(name), 0) << "ValueError: " << name << " is already in the cache";
+    }
+    pool->pool_.Set(name, arr);
+  }
+
+  static Optional<NDArray> Get(String name) {
+    NDArrayCache* pool = Global();
+    auto it = pool->pool_.find(name);
+    if (it == pool->pool_.end()) return NullOpt;
+    return (*it).second;
+  }
+
+  static void Remove(String name) { Global()->pool_.erase(name); }
+
+  static void Clear() { Global()->pool_.clear(); }
+
+ private:
+  Map<String, NDArray> pool_;
+};
+
+TVM_REGISTER_GLOBAL("tvmjs.ndarray_cache.get").set_body_typed(NDArrayCache::Get);
+TVM_REGISTER_GLOBAL("tvmjs.ndarray_cache.update").set_body_typed(NDArrayCache::Update);
+TVM_REGISTER_GLOBAL("tvmjs.ndarray_cache.remove").set_body_typed(NDArrayCache::Remove);
+TVM_REGISTER_GLOBAL("tvmjs.ndarray_cache.clear").set_body_typed(NDArrayCache::Clear);
+
+// The tuple of the parameters <prefix>_0, ..., <prefix>_<num_params - 1>, e.g. to pass the
+// parameters of a model to its relax VM functions.
+TVM_REGISTER_GLOBAL("tvmjs.param_tuple_from_cache")
+    .set_body_typed([](String prefix, int num_params) {
+      std::vector<ObjectRef> params;
+      for (int i = 0; i < num_params; ++i) {
+        std::string name = prefix + "_" + std::to_string(i);
+        Optional<NDArray> param = NDArrayCache::Get(name);
+        CHECK(param.defined()) << "ValueError: Parameter " << name
+                               << " is not in the cache, it may not have been fetched yet";
+        params.push_back(param.value());
+      }
+      return ADT(0, params.begin(), params.end());
+    });
 }  // namespace runtime
 }  // namespace tvm
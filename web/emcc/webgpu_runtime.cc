@@ -67,6 +67,7 @@ class WebGPUDeviceAPI : public DeviceAPI {
     copy_to_gpu_ = getter("deviceCopyToGPU");
     copy_from_gpu_ = getter("deviceCopyFromGPU");
     copy_within_gpu_ = getter("deviceCopyWithinGPU");
+    flush_commands_ = getter("deviceFlushCommands");
   }
 
   void SetDevice(Device dev) final {}
@@ -120,7 +121,9 @@ class WebGPUDeviceAPI : public DeviceAPI {
     return;
   }
 
-  void StreamSync(Device dev, TVMStreamHandle stream) final { LOG(FATAL) << "Not implemented"; }
+  // The commands are batched on the JS side until the host reads data back. The wait for their
+  // completion is async, so this only submits them, and the JS side awaits them with sync().
+  void StreamSync(Device dev, TVMStreamHandle stream) final { flush_commands_(); }
 
   void SetStream(Device dev, TVMStreamHandle stream) final {
     LOG(FATAL) << "Not implemented";
@@ -149,6 +152,7 @@ class WebGPUDeviceAPI : public DeviceAPI {
   TypedPackedFunc<void(void* from, int64_t from_offset, void* to, int64_t to_offset,
                        int64_t nbytes)>
       copy_within_gpu_;
+  TypedPackedFunc<void()> flush_commands_;
 };
 
 typedef dmlc::ThreadLocalStore<WebGPUThreadEntry> WebGPUThreadStore;
@@ -120,6 +120,11 @@ export type FTVMArrayAlloc = (
  */
 export type FTVMArrayFree = (handle: Pointer) => number;
 
+/**
+ * int TVMObjectFree(TVMObjectHandle obj);
+ */
+export type FTVMObjectFree = (handle: Pointer) => number;
+
 /**
  * int TVMArrayCopyFromBytes(TVMArrayHandle handle,
  *                           void* data,
@@ -19,8 +19,8 @@
 
 export {
   Scalar, DLDevice, DLDataType,
-  PackedFunc, Module, NDArray, Instance,
-  instantiate
+  PackedFunc, Module, NDArray, TVMObject, VirtualMachine, Instance,
+  NDArrayCacheProgress, instantiate
 } from "./runtime";
 export { Disposable, LibraryProvider } from "./types";
 export { RPCServer } from "./rpc_server";
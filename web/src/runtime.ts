@@ -568,6 +568,30 @@ export class Module implements Disposable {
   }
 }
 
+/**
+ * Generic object in the TVM runtime, e.g. a tuple, which is only passed back to
+ * the packed functions.
+ */
+export class TVMObject implements Disposable {
+  /** Internal object handle. */
+  handle: Pointer;
+  private lib: FFILibrary;
+
+  constructor(handle: Pointer, lib: FFILibrary) {
+    this.handle = handle;
+    this.lib = lib;
+  }
+
+  dispose(): void {
+    if (this.handle != 0) {
+      this.lib.checkCall(
+        (this.lib.exports.TVMObjectFree as ctypes.FTVMObjectFree)(this.handle)
+      );
+      this.handle = 0;
+    }
+  }
+}
+
 /**
  *  Graph executor.
  *
@@ -670,6 +694,93 @@ class GraphExecutor implements Disposable {
   }
 }
 
+/**
+ * Relax virtual machine.
+ *
+ * This is a thin wrapper of the underlying VM module, whose functions
+ * are the functions of the executable.
+ */
+export class VirtualMachine implements Disposable {
+  private mod: Module;
+
+  /**
+   * Constructor
+   * @param mod The underlying VM module.
+   * @param device The main device of the VM, the CPU being the host device.
+   */
+  constructor(mod: Module, device: DLDevice) {
+    this.mod = mod;
+    // The pooled allocator, which reuses the buffers of the previous calls.
+    const pooledAllocator = 2;
+    const initArgs: Array<Scalar> = [
+      new Scalar(device.deviceType, "int32"),
+      new Scalar(device.deviceId, "int32"),
+      new Scalar(pooledAllocator, "int32")
+    ];
+    if (device.deviceType != DeviceStrToEnum.cpu) {
+      // The shape functions run on the CPU host.
+      initArgs.push(
+        new Scalar(DeviceStrToEnum.cpu, "int32"),
+        new Scalar(0, "int32"),
+        new Scalar(pooledAllocator, "int32")
+      );
+    }
+    const finit = this.mod.getFunction("vm_initialization");
+    finit(...initArgs);
+    finit.dispose();
+  }
+
+  dispose(): void {
+    this.mod.dispose();
+  }
+
+  /**
+   * Get a function of the executable.
+   * @param name The name of the function.
+   * @returns The result function.
+   */
+  getFunction(name: string): PackedFunc {
+    return this.mod.getFunction(name);
+  }
+
+  /**
+   * Get the underlying VM module.
+   */
+  getInternalModule(): Module {
+    return this.mod;
+  }
+}
+
+/** The progress of {@link Instance.fetchNDArrayCache}. */
+export interface NDArrayCacheProgress {
+  /** The number of shards uploaded so far. */
+  numLoadedShards: number;
+  /** The total number of shards. */
+  numShards: number;
+  /** The number of bytes uploaded so far. */
+  loadedBytes: number;
+  /** The total number of bytes. */
+  totalBytes: number;
+  /** The seconds elapsed since the start of the fetch. */
+  timeElapsed: number;
+}
+
+/** The record of a parameter in a shard of ndarray-cache.json. */
+interface NDArrayCacheEntry {
+  name: string;
+  shape: Array<number>;
+  dtype: string;
+  byteOffset: number;
+  nbytes: number;
+}
+
+/** The record of a shard in ndarray-cache.json. */
+interface NDArrayShardEntry {
+  dataPath: string;
+  nbytes: number;
+  records: Array<NDArrayCacheEntry>;
+}
+
 /** Code used as the first argument of the async callback. */
 const enum AyncCallbackCode {
   kReturn = 4,
@@ -1001,6 +1112,136 @@ export class Instance implements Disposable {
     return new GraphExecutor(module);
   }
 
+  /**
+   * Create a new relax virtual machine of the executable in the system library.
+   *
+   * @param dev The main device of the VM.
+   */
+  createVirtualMachine(dev: DLDevice): VirtualMachine {
+    const syslib = this.systemLib();
+    const fload = syslib.getFunction("vm_load_executable");
+    const mod = fload() as Module;
+    fload.dispose();
+    syslib.dispose();
+    return new VirtualMachine(mod, dev);
+  }
+
+  /**
+   * Fetch the parameters listed in ndarray-cache.json into the NDArray cache
+   * of the runtime, on the given device.
+   *
+   * The shards are uploaded in order, each one while the next one is fetched,
+   * so the functions needing only the parameters of the first shards can run
+   * before the others arrive. The fetched shards are kept in the Cache Storage
+   * of the browser when it is available, so repeated visits do not download
+   * them again.
+   *
+   * @param ndarrayCacheUrl The url of the directory of ndarray-cache.json.
+   * @param device The device to upload the parameters to.
+   * @param onProgress The callback run after each uploaded shard.
+   * @param cacheScope The name of the Cache Storage of the shards.
+   */
+  async fetchNDArrayCache(
+    ndarrayCacheUrl: string,
+    device: DLDevice,
+    onProgress?: (progress: NDArrayCacheProgress) => void,
+    cacheScope = "tvmjs"
+  ): Promise<void> {
+    const perf = compact.getPerformance();
+    const tstart = perf.now();
+    const baseUrl = new URL(
+      ndarrayCacheUrl, typeof location !== "undefined" ? location.href : undefined
+    );
+    const manifestUrl = new URL("ndarray-cache.json", baseUrl).href;
+    const manifest = JSON.parse(
+      new TextDecoder().decode(await this.fetchWithCache(manifestUrl, cacheScope))
+    );
+    const shards = manifest.records as Array<NDArrayShardEntry>;
+    let totalBytes = 0;
+    for (const shard of shards) {
+      totalBytes += shard.nbytes;
+    }
+    const fupdate = this.getGlobalFunc("tvmjs.ndarray_cache.update");
+    let loadedBytes = 0;
+    let next: Promise<ArrayBuffer> | undefined;
+    if (shards.length != 0) {
+      next = this.fetchWithCache(new URL(shards[0].dataPath, baseUrl).href, cacheScope);
+    }
+    for (let i = 0; i < shards.length; ++i) {
+      const buffer = await (next as Promise<ArrayBuffer>);
+      if (i + 1 < shards.length) {
+        next = this.fetchWithCache(new URL(shards[i + 1].dataPath, baseUrl).href, cacheScope);
+      }
+      for (const rec of shards[i].records) {
+        const arr = this.empty(rec.shape, rec.dtype, device);
+        arr.copyFromRawBytes(new Uint8Array(buffer, rec.byteOffset, rec.nbytes));
+        // The cache keeps its own reference to the array.
+        fupdate(rec.name, arr, this.scalar(1, "int32"));
+        arr.dispose();
+      }
+      // Wait for the upload, which releases its staging buffers.
+      await device.sync();
+      loadedBytes += shards[i].nbytes;
+      if (onProgress !== undefined) {
+        onProgress({
+          numLoadedShards: i + 1,
+          numShards: shards.length,
+          loadedBytes: loadedBytes,
+          totalBytes: totalBytes,
+          timeElapsed: (perf.now() - tstart) / 1000
+        });
+      }
+    }
+    fupdate.dispose();
+  }
+
+  /**
+   * Get the parameters prefix_0, ..., prefix_{numParams - 1} from the NDArray
+   * cache, as a tuple to pass to the functions of a {@link VirtualMachine}.
+   *
+   * @param prefix The prefix of the parameter names.
+   * @param numParams The number of parameters.
+   * @returns The tuple of the parameters.
+   */
+  getParamsFromCache(prefix: string, numParams: number): TVMObject {
+    const fget = this.getGlobalFunc("tvmjs.param_tuple_from_cache");
+    const ret = fget(prefix, this.scalar(numParams, "int32")) as TVMObject;
+    fget.dispose();
+    return ret;
+  }
+
+  /**
+   * Remove all the parameters from the NDArray cache.
+   */
+  clearNDArrayCache(): void {
+    const fclear = this.getGlobalFunc("tvmjs.ndarray_cache.clear");
+    fclear();
+    fclear.dispose();
+  }
+
+  /**
+   * Fetch the data of an url, from the Cache Storage when it is there.
+   */
+  private async fetchWithCache(url: string, cacheScope: string): Promise<ArrayBuffer> {
+    if (typeof caches === "undefined") {
+      const response = await fetch(url);
+      if (!response.ok) {
+        throw new Error("Cannot fetch " + url + ": " + response.statusText);
+      }
+      return await response.arrayBuffer();
+    }
+    const cache = await caches.open(cacheScope);
+    let response = await cache.match(url);
+    if (response === undefined) {
+      await cache.add(url);
+      response = await cache.match(url);
+      if (response === undefined) {
+        throw new Error("Cannot fetch " + url);
+      }
+    }
+    return await response.arrayBuffer();
+  }
+
 
   /**
    * Register an asyncfunction to be global function in the server.
@@ -1196,6 +1437,9 @@ export class Instance implements Disposable {
       } else if (val instanceof Module) {
         stack.storePtr(valueOffset, val.handle);
         stack.storeI32(codeOffset, ArgTypeCode.TVMModuleHandle);
+      } else if (val instanceof TVMObject) {
+        stack.storePtr(valueOffset, val.handle);
+        stack.storeI32(codeOffset, ArgTypeCode.TVMObjectHandle);
       } else {
         throw new Error("Unsupported argument type " + tp);
       }
@@ -1317,6 +1561,9 @@ export class Instance implements Disposable {
       case ArgTypeCode.TVMNDArrayHandle: {
         return new NDArray(this.memory.loadPointer(rvaluePtr), false, this.lib);
       }
+      case ArgTypeCode.TVMObjectHandle: {
+        return new TVMObject(this.memory.loadPointer(rvaluePtr), this.lib);
+      }
       case ArgTypeCode.TVMDLTensorHandle: {
         assert(callbackArg);
         return new NDArray(this.memory.loadPointer(rvaluePtr), true, this.lib);
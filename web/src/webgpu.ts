@@ -42,19 +42,52 @@ interface FunctionInfo {
   launch_param_tags: Array<string>;
 }
 
+/**
+ * The size of the pooled buffer of an allocation of nbytes.
+ *
+ * The sizes are rounded up to one of eight steps between two consecutive
+ * powers of two, so that a buffer is reused by the allocations of close
+ * sizes while wasting at most an eighth of the buffer.
+ */
+function pooledBufferSize(nbytes: number): number {
+  const minStep = 256;
+  let pow2 = 1;
+  while (pow2 * 2 <= nbytes) {
+    pow2 *= 2;
+  }
+  const step = Math.max(minStep, pow2 / 8);
+  return Math.max(step, Math.ceil(nbytes / step) * step);
+}
+
 /**
  * WebGPU context
  * Manages all the webgpu resources here.
+ *
+ * The kernel dispatches and the copies are recorded into a single command
+ * encoder, which is only submitted when the host reads data back or waits
+ * for the device, so that a whole function invocation costs one submission.
+ * The freed buffers are kept in a pool of size buckets, and reused by the
+ * next allocations of their bucket.
  */
 export class WebGPUContext {
   device: GPUDevice;
   memory: Memory;
+  /** The max total size of the free buffers kept in the pool. */
+  maxPooledBytes = 1 << 30;
 
   //private readBuffer:;
   private bufferTable: Array<GPUBuffer | undefined> = [undefined];
+  private bufferSizeTable: Array<number> = [0];
   private bufferTableFreeId: Array<number> = [];
   private pendingRead: Promise<void> = Promise.resolve();
   private numPendingReads = 0;
+  // The encoder of the commands not yet submitted.
+  private pendingEncoder: GPUCommandEncoder | undefined = undefined;
+  // The staging buffers of the pending commands, destroyed once they are submitted.
+  private pendingStagingBuffers: Array<GPUBuffer> = [];
+  // The free buffers, by their size bucket.
+  private bufferPool: Map<number, Array<GPUBuffer>> = new Map();
+  private pooledBytes = 0;
 
   constructor(memory: Memory, device: GPUDevice) {
     this.memory = memory;
@@ -65,6 +98,7 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushCommands();
     const fence = this.device.defaultQueue.createFence();
     this.device.defaultQueue.signal(fence, 1);
     if (this.numPendingReads != 0) {
@@ -130,8 +164,7 @@ export class WebGPUContext {
     }
 
     const submitShader = (...args: Array<GPUPointer | number>): void => {
-      const commandEncoder = this.device.createCommandEncoder();
-      const compute = commandEncoder.beginComputePass();
+      const compute = this.getCommandEncoder().beginComputePass();
       compute.setPipeline(pipeline);
       const bindGroupEntries: Array<GPUBindGroupEntry> = [];
       assert(args.length == layoutEntries.length + dispatchToDim.length);
@@ -155,8 +188,6 @@ export class WebGPUContext {
       }
       compute.dispatch(wl[0], wl[1], wl[2]);
       compute.endPass();
-      const command = commandEncoder.finish();
-      this.device.defaultQueue.submit([command]);
     };
 
     return submitShader;
@@ -194,6 +225,10 @@ export class WebGPUContext {
       ): void => {
         this.deviceCopyFromGPU(from, fromOffset, to, nbytes);
       };
+    } else if (name == "deviceFlushCommands") {
+      return (): void => {
+        this.flushCommands();
+      };
     } else if (name == "deviceCopyWithinGPU") {
       return (
         from: GPUPointer,
@@ -210,22 +245,78 @@ export class WebGPUContext {
 
   }
 
+  /**
+   * Submit the pending commands to the queue.
+   */
+  flushCommands(): void {
+    if (this.pendingEncoder === undefined) return;
+    const command = this.pendingEncoder.finish();
+    this.pendingEncoder = undefined;
+    this.device.defaultQueue.submit([command]);
+    for (const buffer of this.pendingStagingBuffers) {
+      buffer.destroy();
+    }
+    this.pendingStagingBuffers = [];
+  }
+
+  /**
+   * Destroy the free buffers of the pool.
+   */
+  releasePooledBuffers(): void {
+    // The pending commands may still use the buffers.
+    this.flushCommands();
+    for (const buffers of this.bufferPool.values()) {
+      for (const buffer of buffers) {
+        buffer.destroy();
+      }
+    }
+    this.bufferPool.clear();
+    this.pooledBytes = 0;
+  }
+
+  private getCommandEncoder(): GPUCommandEncoder {
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
+    }
+    return this.pendingEncoder;
+  }
+
   // DeviceAPI
   private deviceAllocDataSpace(nbytes: number): GPUPointer {
+    const size = pooledBufferSize(nbytes);
+    const pooled = this.bufferPool.get(size);
+    if (pooled !== undefined && pooled.length != 0) {
+      this.pooledBytes -= size;
+      return this.attachToBufferTable(pooled.pop() as GPUBuffer, size);
+    }
     const buffer = this.device.createBuffer({
-      size: nbytes,
+      size: size,
       usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
     });
-    return this.attachToBufferTable(buffer);
+    return this.attachToBufferTable(buffer, size);
   }
 
   private deviceFreeDataSpace(ptr: GPUPointer): void {
     const idx = ptr;
     const buffer = this.bufferTable[idx];
+    const size = this.bufferSizeTable[idx];
     this.bufferTable[idx] = undefined;
     assert(buffer !== undefined);
     this.bufferTableFreeId.push(idx);
-    buffer.destroy();
+    if (this.pooledBytes + size > this.maxPooledBytes) {
+      // The pending commands may still use the buffer.
+      this.flushCommands();
+      buffer.destroy();
+      return;
+    }
+    // The buffer is only reused by the commands recorded after the ones using it.
+    let pooled = this.bufferPool.get(size);
+    if (pooled === undefined) {
+      pooled = [];
+      this.bufferPool.set(size, pooled);
+    }
+    pooled.push(buffer);
+    this.pooledBytes += size;
   }
 
   private deviceCopyToGPU(
@@ -247,17 +338,14 @@ export class WebGPUContext {
     viewU8.set(this.memory.loadRawBytes(from, nbytes));
     gpuTemp.unmap();
 
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    this.getCommandEncoder().copyBufferToBuffer(
       gpuTemp,
       0,
       this.gpuBufferFromPtr(to),
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
-    gpuTemp.destroy();
+    this.pendingStagingBuffers.push(gpuTemp);
   }
 
   private deviceCopyFromGPU(
@@ -272,16 +360,15 @@ export class WebGPUContext {
       usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
     });
 
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    // The host reads the data back: submit it with all the commands computing it.
+    this.getCommandEncoder().copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
       gpuTemp,
       0,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
+    this.flushCommands();
 
     this.numPendingReads += 1;
 
@@ -309,16 +396,13 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    this.getCommandEncoder().copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
       this.gpuBufferFromPtr(to),
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
   }
 
   private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {
@@ -327,14 +411,16 @@ export class WebGPUContext {
     return buffer;
   }
 
-  private attachToBufferTable(buffer: GPUBuffer): GPUPointer {
+  private attachToBufferTable(buffer: GPUBuffer, size: number): GPUPointer {
     if (this.bufferTableFreeId.length != 0) {
       const idx = this.bufferTableFreeId.pop() as number;
       this.bufferTable[idx] = buffer;
+      this.bufferSizeTable[idx] = size;
       return idx;
     } else {
       const idx = this.bufferTable.length;
       this.bufferTable.push(buffer);
+      this.bufferSizeTable.push(size);
       return idx;
     }
   }